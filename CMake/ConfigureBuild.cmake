@@ -71,6 +71,11 @@ if (OGRE_CONFIG_THREADS)
 
 	if (OGRE_CONFIG_THREAD_PROVIDER STREQUAL "std")
 		set(OGRE_THREAD_PROVIDER 4)
+		# Decided once here, as it changes the layout of classes with an OGRE_RW_MUTEX
+		include(CheckCXXSourceCompiles)
+		check_cxx_source_compiles("#include <shared_mutex>
+			int main() { std::shared_timed_mutex m; std::shared_lock<std::shared_timed_mutex> l(m); return 0; }"
+			OGRE_USE_STD_SHARED_MUTEX)
 	endif ()
 
 endif()
@@ -109,6 +114,9 @@ endif()
 if (NOT OGRE_CONFIG_ENABLE_ETC)
   set(OGRE_NO_ETC_CODEC 1)
 endif()
+if (NOT OGRE_CONFIG_ENABLE_ASTC)
+  set(OGRE_NO_ASTC_CODEC 1)
+endif()
 if (NOT OGRE_CONFIG_ENABLE_STBI)
   set(OGRE_NO_STBI_CODEC 1)
 endif()
@@ -316,6 +316,10 @@ macro_log_feature(HLSL2GLSL_FOUND "HLSL2GLSL" "HLSL2GLSL" "http://hlsl2glslfork.
 find_package(OpenEXR)
 macro_log_feature(OPENEXR_FOUND "OpenEXR" "Load High dynamic range images" "http://www.openexr.com/" FALSE "" "")
 
+# Basis Universal
+find_package(BasisUniversal)
+macro_log_feature(BasisUniversal_FOUND "Basis Universal" "Transcode supercompressed .basis and KTX2 images" "https://github.com/BinomialLLC/basis_universal" FALSE "" "")
+
 # Python
 find_package(PythonLibs)
 find_package(PythonInterp)
@@ -72,6 +72,9 @@ endif ()
 if(OGRE_BUILD_PLUGIN_EXRCODEC)
 	set(_plugins "${_plugins}  + OpenEXR image codec\n")
 endif()
+if(OGRE_BUILD_PLUGIN_BASISCODEC)
+	set(_plugins "${_plugins}  + Basis Universal image codec\n")
+endif()
 if (OGRE_BUILD_PLUGIN_PCZ)
 	set(_plugins "${_plugins}  + Portal connected zone scene manager\n")
 endif ()
@@ -114,6 +117,9 @@ endif ()
 if (OGRE_BUILD_TESTS)
 	set(_programs "${_programs}  + Tests\n")
 endif ()
+if (OGRE_BUILD_BENCHMARKS)
+	set(_programs "${_programs}  + Benchmarks\n")
+endif ()
 if (OGRE_BUILD_TOOLS)
 	set(_programs "${_programs}  + Tools\n")
 endif ()
@@ -135,6 +141,9 @@ endif ()
 if (OGRE_CONFIG_ENABLE_ETC)
 	set(_core "${_core}  + ETC image codec\n")
 endif ()
+if (OGRE_CONFIG_ENABLE_ASTC)
+	set(_core "${_core}  + ASTC image codec\n")
+endif ()
 if (OGRE_CONFIG_ENABLE_FREEIMAGE)
 	set(_core "${_core}  + FreeImage codec\n")
 endif ()
@@ -105,6 +105,9 @@ endif ()
 if (NOT OGRE_BUILD_PLUGIN_EXRCODEC)
   set(OGRE_COMMENT_PLUGIN_EXRCODEC "#")
 endif ()
+if (NOT OGRE_BUILD_PLUGIN_BASISCODEC)
+  set(OGRE_COMMENT_PLUGIN_BASISCODEC "#")
+endif ()
 if (NOT OGRE_BUILD_COMPONENT_TERRAIN)
   set(OGRE_COMMENT_COMPONENT_TERRAIN "#")
 endif ()
@@ -0,0 +1,43 @@
+#-------------------------------------------------------------------
+# This file is part of the CMake build system for OGRE
+#     (Object-oriented Graphics Rendering Engine)
+# For the latest info, see http://www.ogre3d.org/
+#
+# The contents of this file are placed in the public domain. Feel
+# free to make use of it in any way you like.
+#-------------------------------------------------------------------
+
+# - Try to find the Basis Universal transcoder (version 1.16 or later)
+# The transcoder is distributed as source, so this looks for a checkout of
+# https://github.com/BinomialLLC/basis_universal rather than a library.
+# Once done, this will define
+#
+#  BasisUniversal_FOUND - the transcoder sources were found
+#  BasisUniversal_INCLUDE_DIR - the directory of basisu_transcoder.h
+#  BasisUniversal_SOURCES - the sources to build with the user of the transcoder
+#  BasisUniversal_DEFINITIONS - the definitions to build them with
+
+set(BasisUniversal_PREFIX_PATH ${BasisUniversal_HOME} $ENV{BasisUniversal_HOME}
+  ${OGRE_DEP_SEARCH_PATH})
+
+find_path(BasisUniversal_INCLUDE_DIR NAMES basisu_transcoder.h
+  HINTS ${BasisUniversal_PREFIX_PATH} PATH_SUFFIXES transcoder basis_universal/transcoder)
+find_file(BasisUniversal_TRANSCODER_SOURCE NAMES basisu_transcoder.cpp
+  HINTS ${BasisUniversal_INCLUDE_DIR} NO_DEFAULT_PATH)
+# Zstandard decoder for supercompressed KTX2 files, shipped alongside
+find_file(BasisUniversal_ZSTD_SOURCE NAMES zstddeclib.c
+  HINTS ${BasisUniversal_INCLUDE_DIR}/../zstd NO_DEFAULT_PATH)
+mark_as_advanced(BasisUniversal_INCLUDE_DIR BasisUniversal_TRANSCODER_SOURCE BasisUniversal_ZSTD_SOURCE)
+
+if (BasisUniversal_INCLUDE_DIR AND BasisUniversal_TRANSCODER_SOURCE)
+  set(BasisUniversal_FOUND TRUE)
+  set(BasisUniversal_SOURCES ${BasisUniversal_TRANSCODER_SOURCE})
+  if (BasisUniversal_ZSTD_SOURCE)
+    list(APPEND BasisUniversal_SOURCES ${BasisUniversal_ZSTD_SOURCE})
+    set(BasisUniversal_DEFINITIONS -DBASISD_SUPPORT_KTX2_ZSTD=1)
+  else ()
+    set(BasisUniversal_DEFINITIONS -DBASISD_SUPPORT_KTX2_ZSTD=0)
+  endif ()
+else ()
+  set(BasisUniversal_FOUND FALSE)
+endif ()
@@ -42,7 +42,7 @@ class ParamsPanel;
 
 /**
    - F:        Toggle frame rate stats on/off
-   - G:        Toggle advanced frame stats on/off
+   - G:        Toggle advanced frame stats and render system statistics on/off
    - R:        Render mode
                - Wireframe
                - Points
@@ -69,6 +69,7 @@ protected:
     Ogre::Camera* mCamera;      // main camera
     TrayManager* mTrayMgr;      // tray interface manager
     ParamsPanel* mDetailsPanel; // sample details panel
+    ParamsPanel* mRenderStatsPanel; // render system work of the last frame
 #ifdef OGRE_BUILD_COMPONENT_RTSHADERSYSTEM
     Ogre::RTShader::ShaderGenerator* mShaderGenerator;
 #endif
@@ -42,6 +42,29 @@ AdvancedRenderControls::AdvancedRenderControls(TrayManager* trayMgr, Ogre::Camer
     mDetailsPanel = mTrayMgr->createParamsPanel(TL_NONE, "DetailsPanel", 200, items);
     mDetailsPanel->hide();
 
+    // create a params panel for displaying the render system work of the main target
+    Ogre::StringVector stats;
+    stats.push_back("Program Binds");
+    stats.push_back("Texture Binds");
+    stats.push_back("Blend Changes");
+    stats.push_back("Depth Changes");
+    stats.push_back("Decl Changes");
+    stats.push_back("Target Changes");
+    stats.push_back("Constant KB");
+    stats.push_back("Locked KB");
+    stats.push_back("Lock Stalls");
+    stats.push_back("Lock Wait us");
+    stats.push_back("Prog. Compiles");
+    stats.push_back("Shadow Batches");
+    stats.push_back("Comp. Batches");
+    stats.push_back("Overlay Batches");
+    stats.push_back("");
+    stats.push_back("Res. CPU MB");
+    stats.push_back("Res. GPU MB");
+
+    mRenderStatsPanel = mTrayMgr->createParamsPanel(TL_NONE, "RenderStatsPanel", 200, stats);
+    mRenderStatsPanel->hide();
+
     mDetailsPanel->setParamValue(9, "Bilinear");
     mDetailsPanel->setParamValue(10, "Solid");
 
@@ -72,9 +95,13 @@ bool AdvancedRenderControls::keyPressed(const KeyboardEvent& evt) {
         if (mDetailsPanel->getTrayLocation() == TL_NONE) {
             mTrayMgr->moveWidgetToTray(mDetailsPanel, TL_TOPRIGHT, 0);
             mDetailsPanel->show();
+            mTrayMgr->moveWidgetToTray(mRenderStatsPanel, TL_TOPRIGHT, 1);
+            mRenderStatsPanel->show();
         } else {
             mTrayMgr->removeWidgetFromTray(mDetailsPanel);
             mDetailsPanel->hide();
+            mTrayMgr->removeWidgetFromTray(mRenderStatsPanel);
+            mRenderStatsPanel->hide();
         }
     } else if (key == 't') // cycle texture filtering mode
     {
@@ -243,6 +270,41 @@ void AdvancedRenderControls::frameRendered(const Ogre::FrameEvent& evt) {
         mDetailsPanel->setParamValue(15, Ogre::StringConverter::toString(mShaderGenerator->getFragmentShaderCount()));
 #endif
     }
+
+    if (!mTrayMgr->isDialogVisible() && mRenderStatsPanel->isVisible() && mCamera->getViewport())
+    {
+        const Ogre::RenderTarget::FrameStats& stats = mCamera->getViewport()->getTarget()->getStatistics();
+
+        Ogre::StringVector values;
+        values.push_back(Ogre::StringConverter::toString(stats.programBinds));
+        values.push_back(Ogre::StringConverter::toString(stats.textureBinds));
+        values.push_back(Ogre::StringConverter::toString(stats.blendChanges));
+        values.push_back(Ogre::StringConverter::toString(stats.depthChanges));
+        values.push_back(Ogre::StringConverter::toString(stats.vertexDeclarationChanges));
+        values.push_back(Ogre::StringConverter::toString(stats.renderTargetChanges));
+        values.push_back(Ogre::StringConverter::toString(stats.constantBytes / 1024));
+        values.push_back(Ogre::StringConverter::toString(stats.lockedBytes / 1024));
+        values.push_back(Ogre::StringConverter::toString(stats.lockStalls));
+        values.push_back(Ogre::StringConverter::toString(stats.lockWaitTime));
+        values.push_back(Ogre::StringConverter::toString(stats.programsCompiled));
+        values.push_back(Ogre::StringConverter::toString(stats.shadowBatchCount));
+        values.push_back(Ogre::StringConverter::toString(stats.compositorBatchCount));
+        values.push_back(Ogre::StringConverter::toString(stats.overlayBatchCount));
+        values.push_back("");
+
+        // memory of the loaded resources of every manager
+        size_t total = 0, gpu = 0;
+        Ogre::ResourceGroupManager::ResourceManagerIterator it =
+            Ogre::ResourceGroupManager::getSingleton().getResourceManagerIterator();
+        while (it.hasMoreElements()) {
+            Ogre::ResourceManager* mgr = it.getNext();
+            total += mgr->getMemoryUsage();
+            gpu += mgr->getGpuMemoryUsage();
+        }
+        values.push_back(Ogre::StringConverter::toString((total - gpu) / (1024 * 1024)));
+        values.push_back(Ogre::StringConverter::toString(gpu / (1024 * 1024)));
+        mRenderStatsPanel->setAllParamValues(values);
+    }
 }
 
 } /* namespace OgreBites */
@@ -66,10 +66,13 @@ namespace Ogre
 	protected:
 		typedef OGRE_HashMap<String, HlmsMaterialBase*> HlmsMatBindingMap;
 		typedef vector<Renderable*>::type RenderableVector;
+		// the material and constants version whose values the pass parameters currently hold
+		typedef map<const Pass*, std::pair<HlmsMaterialBase*, uint32> >::type PassConstantsMap;
 
 		SceneManager* mSceneManager;
 		ShaderManager* mShaderManager;
 		RenderableVector mBindedRenderables;
+		PassConstantsMap mPassConstants;
     };
 }
 
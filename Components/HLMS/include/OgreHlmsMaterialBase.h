@@ -58,12 +58,19 @@ namespace Ogre
 		// this is called once per frame if the shader has changed. (it is guaranteed that there are not texture units in the pass)
 		virtual void createTexturUnits(Pass* pass){}
 
-		// this is called for every renderable before it is renderd with the given pass
-		virtual void updateUniforms(const Pass* pass, const AutoParamDataSource* source, const LightList* pLightList) {}
+		// this is called for every renderable before it is renderd with the given pass.
+		// constantsChanged is false if the pass parameters still hold the constants this material
+		// uploaded for the current constants version, so only per draw values have to be written.
+		virtual void updateUniforms(const Pass* pass, const AutoParamDataSource* source, const LightList* pLightList, bool constantsChanged) {}
+
+		// incremented whenever a per material constant changes
+		uint32 getConstantsVersion() const { return mConstantsVersion; }
 
 		bool IsDirty;
 
 	protected:
+		uint32 mConstantsVersion;
+
 		HlmsDatablock mVertexDatablock;
 		HlmsDatablock mFragmentDatablock;
 
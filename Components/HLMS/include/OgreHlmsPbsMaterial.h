@@ -164,16 +164,16 @@ namespace Ogre
 		void setEnvironmentMap(TexturePtr tex, float intensityFactor = 1.0f);
 
 		ColourValue getAlbedo(){ return mAlbedo; }
-		void setAlbedo(ColourValue val){ mAlbedo = val; }
+		void setAlbedo(ColourValue val){ mAlbedo = val; mConstantsVersion++; }
 
 		ColourValue getF0(){ return mF0; }
-		void setF0(ColourValue val){ mF0 = val; }
+		void setF0(ColourValue val){ mF0 = val; mConstantsVersion++; }
 
 		Real getRoughness(){ return mRoughness; }
-		void setRoughness(Real val){ mRoughness = val; }
+		void setRoughness(Real val){ mRoughness = val; mConstantsVersion++; }
 
 		Real getLightRoughnessOffset(){ return mLightRoughnessOffset; }
-		void setLightRoughnessOffset(Real val){ mLightRoughnessOffset = val; }
+		void setLightRoughnessOffset(Real val){ mLightRoughnessOffset = val; mConstantsVersion++; }
 
 		void setAlbedoTexture(MapSlot mapSlot, TexturePtr tex, TextureAddressing textureAddressing = TextureAddressing(), BlendFunction blendFunc = BF_ALPHA, float blendFactor = 0);
 		void setNormalrTexture(MapSlot mapSlot, TexturePtr tex, TextureAddressing textureAddressing = TextureAddressing(), float normalBlendFactor = 0, float rBlendFactor = 0);
@@ -188,7 +188,7 @@ namespace Ogre
 		void createTexturUnits(Pass* pass);
 
 		// this is called for every renderable before it is renderd with the given pass
-		void updateUniforms(const Pass* pass, const AutoParamDataSource* source, const LightList* pLightList);
+		void updateUniforms(const Pass* pass, const AutoParamDataSource* source, const LightList* pLightList, bool constantsChanged);
 
 		void updateTexturUnits(TextureUnitState* textureUnitState, GpuProgramParametersSharedPtr fragmentParams, SamplerContainer& s, int index);
 
@@ -224,10 +224,16 @@ namespace Ogre
 
 		static const uint32 maxLightCount;
 
-		float mLightPositions_es[PBS_MAX_LIGHT_COUNT * 3];
-		float mLightDirections_es[PBS_MAX_LIGHT_COUNT * 3];
-		float mLightColors[PBS_MAX_LIGHT_COUNT * 3];
-		float mLightParameters[PBS_MAX_LIGHT_COUNT * 3];
+		float mLightPositions_es[PBS_MAX_LIGHT_COUNT * 4];
+		float mLightDirections_es[PBS_MAX_LIGHT_COUNT * 4];
+		float mLightColors[PBS_MAX_LIGHT_COUNT * 4];
+		float mLightParameters[PBS_MAX_LIGHT_COUNT * 4];
+
+		// the lights last uploaded, they only have to be written again if one of these changes
+		const Pass* mLightsPass;
+		const Camera* mLightsCamera;
+		unsigned long mLightsFrame;
+		uint32 mLightsHash;
 
 		void setTexture(SamplerType samplerType, TexturePtr tex, TextureAddressing uTextureAddr,
 			float blendFactor1 = 0, float blendFactor2 = 0, BlendFunction blendFunc = BF_ALPHA, float intensityFactor = 1.0);
@@ -53,9 +53,13 @@ namespace Ogre
 
 	protected:
 		typedef map<uint32, GpuProgramPtr>::type ShaderCacheMap;
+		// generated source by template, language, shader type and property map, so
+		// datablocks which only differ in their profiles don't run the preprocessor again
+		typedef map<uint32, String>::type SourceCacheMap;
 
 		SceneManager* mSceneManager;
 		ShaderCacheMap mShaderCache;
+		SourceCacheMap mSourceCache;
 		ShaderPiecesManager* mShaderPiecesManager;
     };
 }
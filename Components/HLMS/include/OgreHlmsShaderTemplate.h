@@ -52,10 +52,17 @@ namespace Ogre
 		const String& getTemplate();
 		uint32 getHash();
 
+		// forget the template files read so far, so they are read again on the next load
+		static void clearCache();
+
 	protected:
 		String mTemplateFileName;
 		String mTemplate;
 		uint32 mHash;
+
+		// template files are read and hashed once and shared by all datablocks using them
+		typedef map<String, std::pair<String, uint32> >::type TemplateCacheMap;
+		static TemplateCacheMap msTemplateCache;
 	};
 }
 
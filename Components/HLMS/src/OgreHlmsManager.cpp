@@ -158,6 +158,8 @@ namespace Ogre
 							// Recreate all texture unit states
 							if (HasShaderChanged)
 							{
+								// the new parameters do not hold any constants yet
+								mPassConstants.erase(pass);
 								hlmsMaterial->createTexturUnits(pass);
 							}
 						}
@@ -182,8 +184,15 @@ namespace Ogre
 		{
 			HlmsMaterialBase* material = bindingIt->second;
 
+			// draws sharing the pass with the same material only need their per draw values written
+			std::pair<HlmsMaterialBase*, uint32> constants(material, material->getConstantsVersion());
+			PassConstantsMap::iterator constantsIt = mPassConstants.find(pass);
+			bool constantsChanged = constantsIt == mPassConstants.end() || constantsIt->second != constants;
+			if (constantsChanged)
+				mPassConstants[pass] = constants;
+
 			// update the uniforms
-			material->updateUniforms(pass, source, pLightList);
+			material->updateUniforms(pass, source, pLightList, constantsChanged);
 		}
 	}
 	//-----------------------------------------------------------------------------------
@@ -214,6 +223,7 @@ namespace Ogre
 		{
 			HlmsMatBindingMap* hlmsMatMap = rend->getUserObjectBindings().getUserAny(HLMS_KEY).get<HlmsMatBindingMap*>();
 			hlmsMatMap->erase(passName);
+			mPassConstants.clear();
 
 			// if the hasmap is empty delete it
 			if (hlmsMatMap->size() <= 0)
@@ -247,6 +257,7 @@ namespace Ogre
 			}
 		}
 		mBindedRenderables.clear();
+		mPassConstants.clear();
 	}
 	//-----------------------------------------------------------------------------------
 	bool HlmsManager::hasBinding(Renderable* rend, String passName)
@@ -34,7 +34,7 @@ namespace Ogre
 	//-----------------------------------------------------------------------------------
 	PbsMaterial::PbsMaterial() : mAlbedo(1, 1, 1, 0), mF0(0.1f, 0.1f, 0.1f, 1.0f), mRoughness(0.1f), mLightRoughnessOffset(0.0f),
 	/*header initial values*/	mMainUvSetIndex(0), mD1UvSetIndex(0), mD2UvSetIndex(0), _hasSamplerListChanged(false), 
-								_hasSamplerChanged(false)
+								_hasSamplerChanged(false), mLightsPass(NULL), mLightsCamera(NULL), mLightsFrame(0), mLightsHash(0)
 	{
 		//Header initial values
 		mMainOffset = Vector2::ZERO;
@@ -137,6 +137,7 @@ namespace Ogre
 		default:
 			break;
 		}
+		mConstantsVersion++;
 	}
 	//-----------------------------------------------------------------------------------
 	void PbsMaterial::setUvSetIndex(MapSlot mapSlot, uint index)
@@ -293,38 +294,51 @@ namespace Ogre
 		_hasSamplerChanged = true;
 	}
 	//-----------------------------------------------------------------------------------
-	void PbsMaterial::updateUniforms(const Pass* pass, const AutoParamDataSource* source, const LightList* pLightList)
+	void PbsMaterial::updateUniforms(const Pass* pass, const AutoParamDataSource* source, const LightList* pLightList, bool constantsChanged)
 	{
-		// Vertex program
 		GpuProgramParametersSharedPtr vertexParams = pass->getVertexProgramParameters();
-		vertexParams->setIgnoreMissingParams(true);
+		GpuProgramParametersSharedPtr fragmentParams = pass->getFragmentProgramParameters();
 
-		vertexParams->setNamedAutoConstant("mvpMat", GpuProgramParameters::ACT_WORLDVIEWPROJ_MATRIX);
-		vertexParams->setNamedAutoConstant("mvMat", GpuProgramParameters::ACT_WORLDVIEW_MATRIX);
+		// The pass parameters keep their values between draws, the material constants
+		// and auto constants only have to be written if another material overwrote them
+		if (constantsChanged)
+		{
+			// Vertex program
+			vertexParams->setIgnoreMissingParams(true);
 
-		// Fragment program
-		GpuProgramParametersSharedPtr fragmentParams = pass->getFragmentProgramParameters();
-		
-		fragmentParams->setNamedAutoConstant("ivMat", GpuProgramParameters::ACT_INVERSE_VIEW_MATRIX);
-		
-		fragmentParams->setNamedConstant("in_albedo", mAlbedo);
-		fragmentParams->setNamedConstant("in_f0", mF0);
-		fragmentParams->setNamedConstant("in_roughness", mRoughness);
-		fragmentParams->setNamedConstant("in_light_roughness_offset", mLightRoughnessOffset);
+			vertexParams->setNamedAutoConstant("mvpMat", GpuProgramParameters::ACT_WORLDVIEWPROJ_MATRIX);
+			vertexParams->setNamedAutoConstant("mvMat", GpuProgramParameters::ACT_WORLDVIEW_MATRIX);
 
-		fragmentParams->setNamedConstant("in_offset_main", mMainOffset);
-		fragmentParams->setNamedConstant("in_scale_main", mMainScale);
+			// Fragment program
+			fragmentParams->setNamedAutoConstant("ivMat", GpuProgramParameters::ACT_INVERSE_VIEW_MATRIX);
 
-		fragmentParams->setNamedConstant("in_offset_d1", mD1Offset);
-		fragmentParams->setNamedConstant("in_scale_d1", mD1Scale);
+			fragmentParams->setNamedConstant("in_albedo", mAlbedo);
+			fragmentParams->setNamedConstant("in_f0", mF0);
+			fragmentParams->setNamedConstant("in_roughness", mRoughness);
+			fragmentParams->setNamedConstant("in_light_roughness_offset", mLightRoughnessOffset);
 
-		fragmentParams->setNamedConstant("in_offset_d2", mD2Offset);
-		fragmentParams->setNamedConstant("in_scale_d2", mD2Scale);
+			fragmentParams->setNamedConstant("in_offset_main", mMainOffset);
+			fragmentParams->setNamedConstant("in_scale_main", mMainScale);
 
-		// Set light uniforms
+			fragmentParams->setNamedConstant("in_offset_d1", mD1Offset);
+			fragmentParams->setNamedConstant("in_scale_d1", mD1Scale);
+
+			fragmentParams->setNamedConstant("in_offset_d2", mD2Offset);
+			fragmentParams->setNamedConstant("in_scale_d2", mD2Scale);
+		}
+
+		// Set light uniforms, skipped if the same lights were already written this frame
 		unsigned int count = std::min(mDirectionalLightCount + mPointLightCount + mSpotLightCount, maxLightCount);
-		if (count)
+		unsigned long frame = Root::getSingleton().getNextFrameNumber();
+		bool lightsChanged = constantsChanged || mLightsPass != pass || mLightsCamera != source->getCurrentCamera() ||
+			mLightsFrame != frame || mLightsHash != pLightList->getHash();
+		if (count && lightsChanged)
 		{
+			mLightsPass = pass;
+			mLightsCamera = source->getCurrentCamera();
+			mLightsFrame = frame;
+			mLightsHash = pLightList->getHash();
+
 			Matrix4 viewMatrix = source->getViewMatrix();
 			Quaternion viewMatrixQuat = viewMatrix.extractQuaternion();
 
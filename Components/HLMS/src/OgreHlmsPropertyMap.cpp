@@ -72,11 +72,17 @@ namespace Ogre
         Property p( key, value );
 		vector<Property>::iterator it = std::lower_bound(mProperties.begin(), mProperties.end(), p, orderPropertyByIdString);
 		if (it == mProperties.end() || it->keyName != p.keyName)
+		{
 			mProperties.insert(it, p);
-        else
-            *it = p;
-
-		mHash = 0;
+			mHash = 0;
+		}
+		else if (it->value != value)
+		{
+			// only invalidate the hash if the value really changed, most properties are
+			// set to the same value every frame
+			it->value = value;
+			mHash = 0;
+		}
     }
 	//-----------------------------------------------------------------------------------
 	bool PropertyMap::hasProperty(IdString key)
@@ -101,7 +107,10 @@ namespace Ogre
 		Property p(key, 0);
 		vector<Property>::iterator it = std::lower_bound(mProperties.begin(), mProperties.end(), p, orderPropertyByIdString);
 		if (it != mProperties.end() && it->keyName == p.keyName)
+		{
 			mProperties.erase(it);
+			mHash = 0;
+		}
 	}
 	//-----------------------------------------------------------------------------------
 	uint32 PropertyMap::getHash()
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgreHlmsShaderPiecesManager.h"
 #include "OgreHlmsDatablock.h"
 #include "OgreHlmsShaderCommon.h"
+#include "OgreHlmsShaderTemplate.h"
 
 namespace Ogre
 {
@@ -56,6 +57,8 @@ namespace Ogre
 			gpuPrg.setNull();
 		}
 		mShaderCache.clear();
+		mSourceCache.clear();
+		ShaderTemplate::clearCache();
 	}
 	//-----------------------------------------------------------------------------------
 	GpuProgramPtr ShaderManager::getGpuProgram(HlmsDatablock* dataBlock)
@@ -75,10 +78,22 @@ namespace Ogre
 
 		String name = hashString + typeStr;
 
-		// generate the shader code
-		String code = dataBlock->getTemplate()->getTemplate();
-		StringVectorPtr pieces = mShaderPiecesManager->getPieces(dataBlock->getLanguage(), dataBlock->getShaderType());
-		code = ShaderGenerator::parse(code, *(dataBlock->getPropertyMap()), pieces);
+		// generate the shader code, unless another datablock already generated it
+		uint32 sourceHash = dataBlock->getTemplate()->getHash() + dataBlock->getShaderType() +
+			calcHash(dataBlock->getLanguage()) + dataBlock->getPropertyMap()->getHash();
+		SourceCacheMap::iterator sourceIt = mSourceCache.find(sourceHash);
+		String code;
+		if (sourceIt != mSourceCache.end())
+		{
+			code = sourceIt->second;
+		}
+		else
+		{
+			code = dataBlock->getTemplate()->getTemplate();
+			StringVectorPtr pieces = mShaderPiecesManager->getPieces(dataBlock->getLanguage(), dataBlock->getShaderType());
+			code = ShaderGenerator::parse(code, *(dataBlock->getPropertyMap()), pieces);
+			mSourceCache[sourceHash] = code;
+		}
 
 		GpuProgramPtr gpuProgram = createGpuProgram(name, code, dataBlock);
 
@@ -31,6 +31,7 @@ THE SOFTWARE.
 
 namespace Ogre
 {
+	ShaderTemplate::TemplateCacheMap ShaderTemplate::msTemplateCache;
 	//-----------------------------------------------------------------------------------
 	ShaderTemplate::ShaderTemplate() : mHash(0)
 	{
@@ -72,12 +73,26 @@ namespace Ogre
 	{
 		if (mTemplateFileName.empty()) return;
 
+		TemplateCacheMap::iterator it = msTemplateCache.find(mTemplateFileName);
+		if (it != msTemplateCache.end())
+		{
+			mTemplate = it->second.first;
+			mHash = it->second.second;
+			return;
+		}
+
 		if (ResourceGroupManager::getSingletonPtr()->resourceExists(ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, mTemplateFileName))
 		{
 			DataStreamPtr logoCornersFile = ResourceGroupManager::getSingletonPtr()->openResource(mTemplateFileName);
 			mTemplate = logoCornersFile->getAsString();
 			mHash = calcHash(mTemplate);
+			msTemplateCache[mTemplateFileName] = std::make_pair(mTemplate, mHash);
 		}
 	}
 	//-----------------------------------------------------------------------------------
+	void ShaderTemplate::clearCache()
+	{
+		msTemplateCache.clear();
+	}
+	//-----------------------------------------------------------------------------------
 }
\ No newline at end of file
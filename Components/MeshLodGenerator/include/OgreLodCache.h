@@ -0,0 +1,97 @@
+/*
+ * -----------------------------------------------------------------------------
+ * This source file is part of OGRE
+ * (Object-oriented Graphics Rendering Engine)
+ * For the latest info, see http://www.ogre3d.org/
+ *
+ * Copyright (c) 2000-2014 Torus Knot Software Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+
+#ifndef _LodCache_H__
+#define _LodCache_H__
+
+#include "OgreLodPrerequisites.h"
+#include "OgreLodBuffer.h"
+#include "OgreDataStream.h"
+
+namespace Ogre
+{
+/** \addtogroup Optional
+*  @{
+*/
+/** \addtogroup MeshLodGenerator
+*  @{
+*/
+/**
+ * @brief Stores generated Lod levels, keyed by a hash of the mesh geometry and the LodConfig.
+ *
+ * Set it with MeshLodGenerator::setLodCache(). When a mesh and config are found in the cache,
+ * generateLodLevels() injects the stored index buffers instead of reducing the mesh. This is
+ * used for calls without custom components and without the background queue. Save the cache
+ * when it is dirty and load it on the next start to skip the generation entirely.
+ */
+class _OgreLodExport LodCache
+{
+public:
+    LodCache();
+
+    /// Computes the key of a config, which covers the geometry of its mesh and every setting affecting the output.
+    static uint32 computeHash(const LodConfig& lodConfig);
+
+    /**
+     * @brief Injects the cached Lod levels into the mesh of the config and configures its Lod usage.
+     *
+     * @return False if the cache has no entry for the hash.
+     */
+    bool inject(uint32 hash, LodConfig& lodConfig);
+
+    /// Stores the Lod levels of the mesh of the config. Call it after they have been injected.
+    void store(uint32 hash, const LodConfig& lodConfig);
+
+    /// Whether entries were stored since the cache was created, loaded or saved.
+    bool isDirty() const {return mDirty;}
+    size_t getEntryCount() const {return mEntries.size();}
+    void clear();
+
+    /// Writes all entries to a stream.
+    void save(const DataStreamPtr& stream);
+    /// Adds the entries of a stream written by save().
+    void load(const DataStreamPtr& stream);
+
+protected:
+    struct Entry {
+        LodOutputBuffer buffer;
+        vector<size_t>::type uniqueVertexCounts;
+        vector<bool>::type skipped;
+    };
+    typedef map<uint32, Entry>::type EntryMap;
+
+    static const uint32 CHUNK_ID;
+    static const uint16 CHUNK_VERSION;
+
+    EntryMap mEntries;
+    bool mDirty;
+};
+/** @} */
+/** @} */
+}
+#endif
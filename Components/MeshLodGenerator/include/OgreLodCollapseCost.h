@@ -45,7 +45,11 @@ class _OgreLodExport LodCollapseCost {
 public:
     virtual ~LodCollapseCost() {}
     /// This is called after the LodInputProvider has initialized LodData.
+    /// Meshes with more than PARALLEL_VERTEX_COUNT vertices are processed on the LodWorkQueueWorker threads too,
+    /// so computeVertexCollapseCost must not modify shared state.
     virtual void initCollapseCosts(LodData* data);
+    /// The amount of vertices one thread processes at a time in initCollapseCosts.
+    static const size_t PARALLEL_VERTEX_COUNT;
     /// Called from initCollapseCosts for every edge.
     virtual void initVertexCollapseCost(LodData* data, LodData::Vertex* vertex);
     /// Called when edge cost gets invalid.
@@ -160,6 +160,10 @@ struct _OgreLodExport LodConfig {
         /// If outsideWeight is enabled, this will set the angle how deep the algorithm can walk inside the mesh.
         /// This value is an acos number between -1 and 1. (by default it is 0 which means 90 degree)
         Ogre::Real outsideWalkAngle;
+        /// Re-order indexes and vertices of the mesh for the vertex cache, overdraw and vertex fetch
+        /// once the Lod levels are injected. See Mesh::optimiseIndexOrder.
+        /// (disabled by default)
+        bool optimiseIndexOrder;
         /// If the algorithm makes errors, you can fix it, by adding the edge to the profile.
         LodProfile profile;
         Advanced();
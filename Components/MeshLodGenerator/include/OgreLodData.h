@@ -59,11 +59,11 @@ struct _OgreLodExport LodData {
     struct Triangle;
     struct VertexHash;
     struct VertexEqual;
+    class CollapseCostHeap;
 
     typedef vector<Vertex>::type VertexList;
     typedef vector<Triangle>::type TriangleList;
     typedef OGRE_HashSet<Vertex*, VertexHash, VertexEqual> UniqueVertexSet;
-    typedef multimap<Real, Vertex*>::type CollapseCostHeap;
 
     typedef VectorSet<Edge, 8> VEdges;
     typedef VectorSet<Triangle*, 7> VTriangles;
@@ -103,7 +103,7 @@ struct _OgreLodExport LodData {
         Vector3 normal;
         Vertex* collapseTo;
         bool seam;
-        CollapseCostHeap::iterator costHeapPosition; /// Iterator pointing to the position in the mCollapseCostSet, which allows fast remove.
+        size_t costHeapPosition; /// Index of the vertex in mCollapseCostHeap, which allows fast update and remove.
 
         void addEdge(const Edge& edge);
         void removeEdge(const Edge& edge);
@@ -122,6 +122,48 @@ struct _OgreLodExport LodData {
         bool isMalformed();
     };
 
+    /// Indexed binary min-heap of the vertex collapse costs, stored in a flat array.
+    /// Every vertex knows its index in the heap, so its cost can be changed or it can be removed in place.
+    class _OgreLodExport CollapseCostHeap {
+    public:
+        struct Entry {
+            Real cost;
+            Vertex* vertex;
+        };
+        typedef vector<Entry>::type EntryList;
+
+        /// Value of Vertex::costHeapPosition for vertices which are not in the heap.
+        static const size_t NOT_IN_HEAP;
+
+        size_t size() const { return mEntries.size(); }
+        bool empty() const { return mEntries.empty(); }
+        /// Removes all entries. The vertices are not touched, as they may be gone already.
+        void clear() { mEntries.clear(); }
+        void reserve(size_t count) { mEntries.reserve(count); }
+        /// The entry with the smallest collapse cost.
+        const Entry& top() const { return mEntries.front(); }
+        /// All entries in heap order.
+        const EntryList& getEntries() const { return mEntries; }
+
+        bool contains(const Vertex* vertex) const { return vertex->costHeapPosition != NOT_IN_HEAP; }
+        Real getCost(const Vertex* vertex) const { return mEntries[vertex->costHeapPosition].cost; }
+
+        void push(Vertex* vertex, Real cost);
+        /// Changes the cost of a vertex in the heap.
+        void update(Vertex* vertex, Real cost);
+        void erase(Vertex* vertex);
+    protected:
+        void siftUp(size_t pos);
+        void siftDown(size_t pos);
+        void place(size_t pos, const Entry& entry)
+        {
+            mEntries[pos] = entry;
+            entry.vertex->costHeapPosition = pos;
+        }
+
+        EntryList mEntries;
+    };
+
     union IndexBufferPointer {
         unsigned short* pshort;
         unsigned int* pint;
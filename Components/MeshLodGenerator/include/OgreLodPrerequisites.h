@@ -54,10 +54,12 @@ namespace Ogre
     struct LodConfig;
     struct LodLevel;
     class LodConfigSerializer;
+    class LodCache;
     class MeshLodGenerator;
     class LodWorkQueueWorker;
     class LodWorkQueueInjector;
     struct LodWorkQueueRequest;
+    class LodParallelJob;
     class LodWorkQueueInjectorListener;
     struct LodData;
 
@@ -32,10 +32,38 @@
 #include "OgreLodPrerequisites.h"
 #include "OgreWorkQueue.h"
 #include "OgreSingleton.h"
+#include "OgreAtomicScalar.h"
 
 namespace Ogre
 {
 
+/**
+ * @brief Independent items of work, which idle worker threads can help processing.
+ *
+ * The job is deleted by the last thread done with it, so it must be created with new
+ * and must not reference data of the thread that created it outside of processItem.
+ */
+class _OgreLodExport LodParallelJob
+{
+public:
+    LodParallelJob(size_t itemCount) : mItemCount(itemCount), mNext(0), mDone(0), mRefs(0) {}
+    virtual ~LodParallelJob() {}
+
+    /// Processes one item. Called from several threads at once with different items.
+    virtual void processItem(size_t i) = 0;
+
+    size_t getItemCount() const {return mItemCount;}
+protected:
+    friend class LodWorkQueueWorker;
+    size_t mItemCount;
+    /// The next item to be taken by a thread.
+    AtomicScalar<uint32> mNext;
+    /// The amount of processed items.
+    AtomicScalar<uint32> mDone;
+    /// The amount of threads still referencing the job.
+    AtomicScalar<uint32> mRefs;
+};
+
 /**
  * @brief Processes requests.
  */
@@ -55,9 +83,22 @@ public:
 
     void clearPendingLodRequests();
 
+    /**
+     * @brief Processes all items of a job on the calling thread and on idle worker threads.
+     *
+     * Returns when every item is processed. The job is deleted when no thread uses it anymore.
+     */
+    void runParallel(LodParallelJob* job);
+
+    /// Request type of the requests helping with a LodParallelJob.
+    static const uint16 PARALLEL_JOB_REQUEST;
+
 protected:
     ushort mChannelID;
     WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
+
+    static void processItems(LodParallelJob* job);
+    static void releaseJob(LodParallelJob* job);
 };
 }
 #endif
@@ -35,6 +35,7 @@
 #include "OgreLodOutputProvider.h"
 #include "OgreLodCollapseCost.h"
 #include "OgreLodCollapser.h"
+#include "OgreLodConfig.h"
 #include "OgreSharedPtr.h"
 #include "OgreSingleton.h"
 
@@ -53,6 +54,7 @@ class _OgreLodExport MeshLodGenerator :
 public Singleton<MeshLodGenerator>
 {
 public:
+    typedef vector<LodConfig>::type LodConfigList;
 
     static MeshLodGenerator* getSingletonPtr();
     static MeshLodGenerator& getSingleton();
@@ -77,6 +79,25 @@ public:
      */
     void generateAutoconfiguredLodLevels(MeshPtr& mesh);
 
+    /**
+     * @brief Generates the Lod levels for many meshes at once.
+     *
+     * Every mesh gets its own LodData and default components, and the meshes are reduced
+     * concurrently on the calling thread and the WorkQueue worker threads. The Lod levels
+     * are injected on the calling thread before this returns, useBackgroundQueue is ignored.
+     *
+     * @param lodConfigs Specification of the requested Lod levels of each mesh.
+     */
+    void generateLodLevelsBatch(LodConfigList& lodConfigs);
+
+    /**
+     * @brief Sets a cache of generated Lod levels, which generateLodLevels() uses to skip the generation.
+     *
+     * The cache is not owned by the generator. Set it to NULL to disable caching (default).
+     */
+    void setLodCache(LodCache* cache) {mLodCache = cache;}
+    LodCache* getLodCache() const {return mLodCache;}
+
     /**
      * @brief Fills Lod Config with a config, which works on any mesh.
      *
@@ -100,6 +121,7 @@ protected:
 
     LodWorkQueueWorker* mWQWorker;
     LodWorkQueueInjector* mWQInjector;
+    LodCache* mLodCache;
 };
 /** @} */
 /** @} */
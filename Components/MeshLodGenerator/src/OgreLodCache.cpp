@@ -0,0 +1,283 @@
+/*
+ * -----------------------------------------------------------------------------
+ * This source file is part of OGRE
+ * (Object-oriented Graphics Rendering Engine)
+ * For the latest info, see http://www.ogre3d.org/
+ *
+ * Copyright (c) 2000-2014 Torus Knot Software Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+
+#include "OgreLodCache.h"
+#include "OgreLodConfig.h"
+#include "OgreLodOutputProviderBuffer.h"
+#include "OgreMeshLodGenerator.h"
+#include "OgreStreamSerialiser.h"
+#include "OgreMesh.h"
+#include "OgreSubMesh.h"
+
+namespace Ogre
+{
+    const uint32 LodCache::CHUNK_ID = StreamSerialiser::makeIdentifier("LODC");
+    const uint16 LodCache::CHUNK_VERSION = 1;
+
+    namespace
+    {
+        uint32 hashVertices(const LodVertexBuffer& buffer, bool useNormals, uint32 hash)
+        {
+            hash = HashCombine(hash, buffer.vertexCount);
+            if (buffer.vertexCount > 0) {
+                hash = FastHash((const char*) buffer.vertexBuffer.get(), int(buffer.vertexCount * sizeof(Vector3)), hash);
+                if (useNormals && buffer.vertexNormalBuffer.get()) {
+                    hash = FastHash((const char*) buffer.vertexNormalBuffer.get(), int(buffer.vertexCount * sizeof(Vector3)), hash);
+                }
+            }
+            return hash;
+        }
+
+        uint32 hashString(const String& str, uint32 hash)
+        {
+            return FastHash(str.c_str(), int(str.size()), hash);
+        }
+    }
+
+    LodCache::LodCache() :
+        mDirty(false)
+    {
+    }
+
+    uint32 LodCache::computeHash(const LodConfig& lodConfig)
+    {
+        LodInputBuffer input;
+        input.fillBuffer(lodConfig.mesh);
+        bool useNormals = lodConfig.advanced.useVertexNormals;
+
+        uint32 hash = HashCombine(0, input.submesh.size());
+        hash = hashVertices(input.sharedVertexBuffer, useNormals, hash);
+        for (size_t i = 0; i < input.submesh.size(); i++) {
+            const LodInputBuffer::Submesh& submesh = input.submesh[i];
+            hash = HashCombine(hash, submesh.useSharedVertexBuffer);
+            if (!submesh.useSharedVertexBuffer) {
+                hash = hashVertices(submesh.vertexBuffer, useNormals, hash);
+            }
+            const LodIndexBuffer& indices = submesh.indexBuffer;
+            hash = HashCombine(hash, indices.indexCount);
+            if (indices.indexCount > 0) {
+                hash = FastHash((const char*) indices.indexBuffer.get(), int(indices.indexCount * indices.indexSize), hash);
+            }
+        }
+
+        hash = hashString(lodConfig.strategy ? lodConfig.strategy->getName() : BLANKSTRING, hash);
+        for (size_t i = 0; i < lodConfig.levels.size(); i++) {
+            const LodLevel& level = lodConfig.levels[i];
+            hash = HashCombine(hash, level.distance);
+            hash = HashCombine(hash, level.reductionMethod);
+            hash = HashCombine(hash, level.reductionValue);
+            hash = hashString(level.manualMeshName, hash);
+        }
+
+        const LodConfig::Advanced& advanced = lodConfig.advanced;
+        hash = HashCombine(hash, advanced.useCompression);
+        hash = HashCombine(hash, advanced.useVertexNormals);
+        hash = HashCombine(hash, advanced.outsideWeight);
+        hash = HashCombine(hash, advanced.outsideWalkAngle);
+        for (size_t i = 0; i < advanced.profile.size(); i++) {
+            hash = HashCombine(hash, advanced.profile[i].src);
+            hash = HashCombine(hash, advanced.profile[i].dst);
+            hash = HashCombine(hash, advanced.profile[i].cost);
+        }
+        return hash;
+    }
+
+    bool LodCache::inject(uint32 hash, LodConfig& lodConfig)
+    {
+        EntryMap::iterator it = mEntries.find(hash);
+        if (it == mEntries.end() || it->second.skipped.size() != lodConfig.levels.size()
+            || it->second.buffer.submesh.size() != lodConfig.mesh->getNumSubMeshes()) {
+            return false;
+        }
+
+        LodOutputProviderBuffer output(lodConfig.mesh);
+        output.getBuffer() = it->second.buffer;
+        output.inject();
+        for (size_t i = 0; i < lodConfig.levels.size(); i++) {
+            lodConfig.levels[i].outUniqueVertexCount = it->second.uniqueVertexCounts[i];
+            lodConfig.levels[i].outSkipped = it->second.skipped[i];
+        }
+        MeshLodGenerator::_configureMeshLodUsage(lodConfig);
+        return true;
+    }
+
+    void LodCache::store(uint32 hash, const LodConfig& lodConfig)
+    {
+        Entry& entry = mEntries[hash];
+        entry.uniqueVertexCounts.clear();
+        entry.skipped.clear();
+        for (size_t i = 0; i < lodConfig.levels.size(); i++) {
+            entry.uniqueVertexCounts.push_back(lodConfig.levels[i].outUniqueVertexCount);
+            entry.skipped.push_back(lodConfig.levels[i].outSkipped);
+        }
+
+        // Read back the index buffers. Compressed Lod levels share a hardware buffer with the previous level.
+        unsigned short submeshCount = lodConfig.mesh->getNumSubMeshes();
+        entry.buffer.submesh.clear();
+        entry.buffer.submesh.resize(submeshCount);
+        for (unsigned short i = 0; i < submeshCount; i++) {
+            const SubMesh::LODFaceList& lods = lodConfig.mesh->getSubMesh(i)->mLodFaceList;
+            vector<LodIndexBuffer>::type& buffers = entry.buffer.submesh[i].genIndexBuffers;
+            for (size_t n = 0; n < lods.size(); n++) {
+                const IndexData* indexData = lods[n];
+                LodIndexBuffer buffer;
+                buffer.indexStart = indexData->indexStart;
+                buffer.indexCount = indexData->indexCount;
+                buffer.indexSize = 2;
+                buffer.indexBufferSize = 0;
+                const HardwareIndexBufferSharedPtr& hwBuffer = indexData->indexBuffer;
+                if (!hwBuffer.isNull()) {
+                    buffer.indexSize = hwBuffer->getIndexSize();
+                    buffer.indexBufferSize = hwBuffer->getNumIndexes();
+                    if (n > 0 && lods[n - 1]->indexBuffer == hwBuffer) {
+                        buffer.indexBuffer = buffers.back().indexBuffer;
+                    } else {
+                        size_t sizeInBytes = hwBuffer->getSizeInBytes();
+                        buffer.indexBuffer = Ogre::SharedPtr<unsigned char>(new unsigned char[sizeInBytes]);
+                        hwBuffer->readData(0, sizeInBytes, buffer.indexBuffer.get());
+                    }
+                }
+                buffers.push_back(buffer);
+            }
+        }
+        mDirty = true;
+    }
+
+    void LodCache::clear()
+    {
+        mEntries.clear();
+        mDirty = false;
+    }
+
+    void LodCache::save(const DataStreamPtr& stream)
+    {
+        StreamSerialiser ser(stream);
+        ser.writeChunkBegin(CHUNK_ID, CHUNK_VERSION);
+        uint32 entryCount = static_cast<uint32>(mEntries.size());
+        ser.write(&entryCount);
+        for (EntryMap::iterator it = mEntries.begin(); it != mEntries.end(); ++it) {
+            const Entry& entry = it->second;
+            ser.write(&it->first);
+
+            uint32 levelCount = static_cast<uint32>(entry.skipped.size());
+            ser.write(&levelCount);
+            for (uint32 i = 0; i < levelCount; i++) {
+                uint32 vertexCount = static_cast<uint32>(entry.uniqueVertexCounts[i]);
+                bool skipped = entry.skipped[i];
+                ser.write(&vertexCount);
+                ser.write(&skipped);
+            }
+
+            uint16 submeshCount = static_cast<uint16>(entry.buffer.submesh.size());
+            ser.write(&submeshCount);
+            for (uint16 s = 0; s < submeshCount; s++) {
+                const vector<LodIndexBuffer>::type& buffers = entry.buffer.submesh[s].genIndexBuffers;
+                uint32 bufferCount = static_cast<uint32>(buffers.size());
+                ser.write(&bufferCount);
+                for (uint32 n = 0; n < bufferCount; n++) {
+                    const LodIndexBuffer& buffer = buffers[n];
+                    uint32 values[4] = {
+                        static_cast<uint32>(buffer.indexSize),
+                        static_cast<uint32>(buffer.indexCount),
+                        static_cast<uint32>(buffer.indexStart),
+                        static_cast<uint32>(buffer.indexBufferSize)
+                    };
+                    ser.write(values, 4);
+                    // 0: no buffer, 1: same buffer as the previous level, 2: own buffer.
+                    uint8 storage = 0;
+                    if (buffer.indexBuffer.get()) {
+                        storage = (n > 0 && buffers[n - 1].indexBuffer == buffer.indexBuffer) ? 1 : 2;
+                    }
+                    ser.write(&storage);
+                    if (storage == 2) {
+                        ser.writeData(buffer.indexBuffer.get(), buffer.indexSize, buffer.indexBufferSize);
+                    }
+                }
+            }
+        }
+        ser.writeChunkEnd(CHUNK_ID);
+        mDirty = false;
+    }
+
+    void LodCache::load(const DataStreamPtr& stream)
+    {
+        StreamSerialiser ser(stream);
+        if (!ser.readChunkBegin(CHUNK_ID, CHUNK_VERSION, "LodCache")) {
+            return;
+        }
+        uint32 entryCount;
+        ser.read(&entryCount);
+        for (uint32 e = 0; e < entryCount; e++) {
+            uint32 hash;
+            ser.read(&hash);
+            Entry& entry = mEntries[hash];
+
+            uint32 levelCount;
+            ser.read(&levelCount);
+            entry.uniqueVertexCounts.resize(levelCount);
+            entry.skipped.resize(levelCount);
+            for (uint32 i = 0; i < levelCount; i++) {
+                uint32 vertexCount;
+                bool skipped;
+                ser.read(&vertexCount);
+                ser.read(&skipped);
+                entry.uniqueVertexCounts[i] = vertexCount;
+                entry.skipped[i] = skipped;
+            }
+
+            uint16 submeshCount;
+            ser.read(&submeshCount);
+            entry.buffer.submesh.clear();
+            entry.buffer.submesh.resize(submeshCount);
+            for (uint16 s = 0; s < submeshCount; s++) {
+                vector<LodIndexBuffer>::type& buffers = entry.buffer.submesh[s].genIndexBuffers;
+                uint32 bufferCount;
+                ser.read(&bufferCount);
+                for (uint32 n = 0; n < bufferCount; n++) {
+                    LodIndexBuffer buffer;
+                    uint32 values[4];
+                    ser.read(values, 4);
+                    buffer.indexSize = values[0];
+                    buffer.indexCount = values[1];
+                    buffer.indexStart = values[2];
+                    buffer.indexBufferSize = values[3];
+                    uint8 storage;
+                    ser.read(&storage);
+                    if (storage == 1 && !buffers.empty()) {
+                        buffer.indexBuffer = buffers.back().indexBuffer;
+                    } else if (storage == 2) {
+                        buffer.indexBuffer = Ogre::SharedPtr<unsigned char>(new unsigned char[buffer.indexSize * buffer.indexBufferSize]);
+                        ser.readData(buffer.indexBuffer.get(), buffer.indexSize, buffer.indexBufferSize);
+                    }
+                    buffers.push_back(buffer);
+                }
+            }
+        }
+        ser.readChunkEnd(CHUNK_ID);
+    }
+}
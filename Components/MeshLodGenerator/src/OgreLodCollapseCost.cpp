@@ -28,18 +28,71 @@
 
 #include "OgreLodCollapseCost.h"
 
+#include "OgreLodWorkQueueWorker.h"
 #include "OgreLogManager.h"
 
 namespace Ogre
 {
+    namespace
+    {
+        /// Computes the collapse costs of a range of vertices per item.
+        class VertexCollapseCostJob : public LodParallelJob
+        {
+        public:
+            VertexCollapseCostJob(LodCollapseCost* cost, LodData* data, Real* costs, size_t vertexCount) :
+                LodParallelJob((vertexCount + LodCollapseCost::PARALLEL_VERTEX_COUNT - 1) / LodCollapseCost::PARALLEL_VERTEX_COUNT),
+                mCost(cost), mData(data), mCosts(costs), mVertexCount(vertexCount) {}
+
+            void processItem(size_t i)
+            {
+                size_t begin = i * LodCollapseCost::PARALLEL_VERTEX_COUNT;
+                size_t end = std::min(begin + LodCollapseCost::PARALLEL_VERTEX_COUNT, mVertexCount);
+                for (size_t v = begin; v < end; v++) {
+                    LodData::Vertex* vertex = &mData->mVertexList[v];
+                    if (!vertex->edges.empty()) {
+                        Real collapseCost = LodData::UNINITIALIZED_COLLAPSE_COST;
+                        LodData::Vertex* collapseTo = NULL;
+                        mCost->computeVertexCollapseCost(mData, vertex, collapseCost, collapseTo);
+                        vertex->collapseTo = collapseTo;
+                        mCosts[v] = collapseCost;
+                    }
+                }
+            }
+        protected:
+            LodCollapseCost* mCost;
+            LodData* mData;
+            Real* mCosts;
+            size_t mVertexCount;
+        };
+    }
+
+    const size_t LodCollapseCost::PARALLEL_VERTEX_COUNT = 1024;
+
     void LodCollapseCost::initCollapseCosts( LodData* data )
     {
         data->mCollapseCostHeap.clear();
+        data->mCollapseCostHeap.reserve(data->mVertexList.size());
+
+        // The costs of the vertices are independent, so they can be computed on several threads.
+        // Only the insertion into the heap has to be serial.
+        vector<Real>::type costs;
+        LodWorkQueueWorker* worker = LodWorkQueueWorker::getSingletonPtr();
+        bool parallel = worker && data->mVertexList.size() > PARALLEL_VERTEX_COUNT;
+        if (parallel) {
+            costs.resize(data->mVertexList.size());
+            worker->runParallel(new VertexCollapseCostJob(this, data, &costs[0], data->mVertexList.size()));
+        }
+
         LodData::VertexList::iterator it = data->mVertexList.begin();
         LodData::VertexList::iterator itEnd = data->mVertexList.end();
         for (; it != itEnd; it++) {
             if (!it->edges.empty()) {
-                initVertexCollapseCost(data, &*it);
+                if (parallel) {
+                    Real collapseCost = costs[it - data->mVertexList.begin()];
+                    data->mCollapseCostHeap.push(&*it, collapseCost);
+                } else {
+                    initVertexCollapseCost(data, &*it);
+                }
             } else {
 #if OGRE_DEBUG_MODE
                 LogManager::getSingleton().stream() << "In " << data->mMeshName << " never used vertex found with ID: " << data->mCollapseCostHeap.size() << ". "
@@ -73,7 +126,7 @@ namespace Ogre
         computeVertexCollapseCost(data, vertex, collapseCost, collapseTo);
 
         vertex->collapseTo = collapseTo;
-        vertex->costHeapPosition = data->mCollapseCostHeap.insert(LodData::CollapseCostHeap::value_type(collapseCost, vertex));
+        data->mCollapseCostHeap.push(vertex, collapseCost);
     }
 
     void LodCollapseCost::updateVertexCollapseCost( LodData* data, LodData::Vertex* vertex )
@@ -82,16 +135,22 @@ namespace Ogre
         LodData::Vertex* collapseTo = NULL;
         computeVertexCollapseCost(data, vertex, collapseCost, collapseTo);
 
-        if (vertex->collapseTo != collapseTo || collapseCost != vertex->costHeapPosition->first) {
-            OgreAssert(vertex->costHeapPosition != data->mCollapseCostHeap.end(), "");
-            data->mCollapseCostHeap.erase(vertex->costHeapPosition);
+        LodData::CollapseCostHeap& heap = data->mCollapseCostHeap;
+        if (!heap.contains(vertex)) {
+            if (collapseCost != LodData::UNINITIALIZED_COLLAPSE_COST) {
+                vertex->collapseTo = collapseTo;
+                heap.push(vertex, collapseCost);
+            }
+            return;
+        }
+        if (vertex->collapseTo != collapseTo || collapseCost != heap.getCost(vertex)) {
             if (collapseCost != LodData::UNINITIALIZED_COLLAPSE_COST) {
                 vertex->collapseTo = collapseTo;
-                vertex->costHeapPosition = data->mCollapseCostHeap.insert(LodData::CollapseCostHeap::value_type(collapseCost, vertex));
+                heap.update(vertex, collapseCost);
             } else {
+                heap.erase(vertex);
 #if OGRE_DEBUG_MODE
                 vertex->collapseTo = NULL;
-                vertex->costHeapPosition = data->mCollapseCostHeap.end();
 #endif
             }
         }
@@ -39,10 +39,9 @@ namespace Ogre
         size_t vertexCount = data->mCollapseCostHeap.size();
         for (; static_cast<size_t>(vertexCountLimit) < vertexCount; vertexCount--)
         {
-            LodData::CollapseCostHeap::iterator nextVertex = data->mCollapseCostHeap.begin();
-            if (nextVertex != data->mCollapseCostHeap.end() && nextVertex->first < collapseCostLimit)
+            if (!data->mCollapseCostHeap.empty() && data->mCollapseCostHeap.top().cost < collapseCostLimit)
             {
-                mLastReducedVertex = nextVertex->second;
+                mLastReducedVertex = data->mCollapseCostHeap.top().vertex;
                 collapseVertex(data, cost, output, mLastReducedVertex);
             } else {
                 break;
@@ -56,10 +55,11 @@ namespace Ogre
         // Allows to find bugs in collapsing.
         //  size_t s1 = mUniqueVertexSet.size();
         //  size_t s2 = mCollapseCostHeap.size();
-        LodData::CollapseCostHeap::iterator it = data->mCollapseCostHeap.begin();
-        LodData::CollapseCostHeap::iterator itEnd = data->mCollapseCostHeap.end();
+        const LodData::CollapseCostHeap::EntryList& entries = data->mCollapseCostHeap.getEntries();
+        LodData::CollapseCostHeap::EntryList::const_iterator it = entries.begin();
+        LodData::CollapseCostHeap::EntryList::const_iterator itEnd = entries.end();
         while (it != itEnd) {
-            assertValidVertex(data, it->second);
+            assertValidVertex(data, it->vertex);
             it++;
         }
     }
@@ -72,7 +72,7 @@ namespace Ogre
         for (; it != itEnd; it++) {
             LodData::Triangle* t = *it;
             for (int i = 0; i < 3; i++) {
-                OgreAssert(t->vertex[i]->costHeapPosition != data->mCollapseCostHeap.end(), "");
+                OgreAssert(data->mCollapseCostHeap.contains(t->vertex[i]), "");
                 t->vertex[i]->edges.findExists(LodData::Edge(t->vertex[i]->collapseTo));
                 for (int n = 0; n < 3; n++) {
                     if (i != n) {
@@ -183,8 +183,8 @@ namespace Ogre
         assertValidVertex(data, dst);
         assertValidVertex(data, src);
 #endif
-        OgreAssert(src->costHeapPosition->first != LodData::NEVER_COLLAPSE_COST, "");
-        OgreAssert(src->costHeapPosition->first != LodData::UNINITIALIZED_COLLAPSE_COST, "");
+        OgreAssert(data->mCollapseCostHeap.getCost(src) != LodData::NEVER_COLLAPSE_COST, "");
+        OgreAssert(data->mCollapseCostHeap.getCost(src) != LodData::UNINITIALIZED_COLLAPSE_COST, "");
         OgreAssert(!src->edges.empty(), "");
         OgreAssert(!src->triangles.empty(), "");
         OgreAssert(src->edges.find(LodData::Edge(dst)) != src->edges.end(), "");
@@ -304,11 +304,10 @@ namespace Ogre
         assertOutdatedCollapseCost(data, cost, dst);
 #endif // ifndef OGRE_DEBUG_MODE
 #endif // ifndef MESHLOD_QUALITY
-        data->mCollapseCostHeap.erase(src->costHeapPosition); // Remove src from collapse costs.
+        data->mCollapseCostHeap.erase(src); // Remove src from collapse costs.
         src->edges.clear(); // Free memory
         src->triangles.clear(); // Free memory
 #if OGRE_DEBUG_MODE
-        src->costHeapPosition = data->mCollapseCostHeap.end();
         assertValidVertex(data, dst);
 #endif
     }
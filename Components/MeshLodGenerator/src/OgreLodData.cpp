@@ -32,6 +32,86 @@ namespace Ogre
 // Use float limits instead of Real limits, because LodConfigSerializer may convert them to float.
 const Real LodData::NEVER_COLLAPSE_COST = std::numeric_limits<float>::max();
 const Real LodData::UNINITIALIZED_COLLAPSE_COST = std::numeric_limits<float>::infinity();
+const size_t LodData::CollapseCostHeap::NOT_IN_HEAP = std::numeric_limits<size_t>::max();
+
+void LodData::CollapseCostHeap::push( Vertex* vertex, Real cost )
+{
+    OgreAssert(!contains(vertex), "");
+    Entry entry;
+    entry.cost = cost;
+    entry.vertex = vertex;
+    mEntries.push_back(entry);
+    vertex->costHeapPosition = mEntries.size() - 1;
+    siftUp(mEntries.size() - 1);
+}
+
+void LodData::CollapseCostHeap::update( Vertex* vertex, Real cost )
+{
+    size_t pos = vertex->costHeapPosition;
+    OgreAssert(pos < mEntries.size(), "");
+    Real oldCost = mEntries[pos].cost;
+    mEntries[pos].cost = cost;
+    if (cost < oldCost) {
+        siftUp(pos);
+    } else {
+        siftDown(pos);
+    }
+}
+
+void LodData::CollapseCostHeap::erase( Vertex* vertex )
+{
+    size_t pos = vertex->costHeapPosition;
+    OgreAssert(pos < mEntries.size(), "");
+    vertex->costHeapPosition = NOT_IN_HEAP;
+    size_t last = mEntries.size() - 1;
+    if (pos != last) {
+        Real oldCost = mEntries[pos].cost;
+        place(pos, mEntries[last]);
+        mEntries.pop_back();
+        if (mEntries[pos].cost < oldCost) {
+            siftUp(pos);
+        } else {
+            siftDown(pos);
+        }
+    } else {
+        mEntries.pop_back();
+    }
+}
+
+void LodData::CollapseCostHeap::siftUp( size_t pos )
+{
+    Entry entry = mEntries[pos];
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (!(entry.cost < mEntries[parent].cost)) {
+            break;
+        }
+        place(pos, mEntries[parent]);
+        pos = parent;
+    }
+    place(pos, entry);
+}
+
+void LodData::CollapseCostHeap::siftDown( size_t pos )
+{
+    Entry entry = mEntries[pos];
+    size_t count = mEntries.size();
+    for (;;) {
+        size_t child = 2 * pos + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && mEntries[child + 1].cost < mEntries[child].cost) {
+            child++;
+        }
+        if (!(mEntries[child].cost < entry.cost)) {
+            break;
+        }
+        place(pos, mEntries[child]);
+        pos = child;
+    }
+    place(pos, entry);
+}
 
 void LodData::Vertex::addEdge( const LodData::Edge& edge )
 {
@@ -134,9 +134,7 @@ namespace Ogre
                     pNormalOut++;
                 }
             } else {
-#if OGRE_DEBUG_MODE
-                v->costHeapPosition = data->mCollapseCostHeap.end();
-#endif
+                v->costHeapPosition = LodData::CollapseCostHeap::NOT_IN_HEAP;
                 v->seam = false;
                 if(data->mUseVertexNormals){
                     v->normal = *pNormalOut;
@@ -29,6 +29,7 @@
 #include "OgreLodWorkQueueInjector.h"
 #include "OgreLodWorkQueueInjectorListener.h"
 #include "OgreLodWorkQueueRequest.h"
+#include "OgreLodWorkQueueWorker.h"
 #include "OgreMeshLodGenerator.h"
 #include "OgreRoot.h"
 
@@ -67,6 +68,9 @@ namespace Ogre
 
     void LodWorkQueueInjector::handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
     {
+        if (res->getRequest()->getType() == LodWorkQueueWorker::PARALLEL_JOB_REQUEST) {
+            return;
+        }
         LodWorkQueueRequest* request = any_cast<LodWorkQueueRequest*>(res->getData());
 
         if(mInjectorListener){
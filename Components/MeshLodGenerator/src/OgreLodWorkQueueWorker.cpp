@@ -30,9 +30,12 @@
 #include "OgreMeshLodGenerator.h"
 #include "OgreLodWorkQueueRequest.h"
 #include "OgreRoot.h"
+#include "OgreDefaultWorkQueue.h"
 
 namespace Ogre
 {
+    const uint16 LodWorkQueueWorker::PARALLEL_JOB_REQUEST = 1;
+
     template<> LodWorkQueueWorker* Singleton<LodWorkQueueWorker>::msSingleton = 0;
     LodWorkQueueWorker* LodWorkQueueWorker::getSingletonPtr(void)
     {
@@ -85,9 +88,52 @@ namespace Ogre
         wq->abortPendingRequestsByChannel(mChannelID);
     }
 
+    void LodWorkQueueWorker::runParallel(LodParallelJob* job)
+    {
+        WorkQueue* wq = Root::getSingleton().getWorkQueue();
+        DefaultWorkQueueBase* defaultWQ = dynamic_cast<DefaultWorkQueueBase*>(wq);
+        size_t helpers = 0;
+        if (defaultWQ && job->mItemCount > 1) {
+            helpers = std::min<size_t>(defaultWQ->getWorkerThreadCount(), job->mItemCount - 1);
+        }
+        job->mRefs.set(static_cast<uint32>(helpers + 1));
+        for (size_t i = 0; i < helpers; i++) {
+            wq->addRequest(mChannelID, PARALLEL_JOB_REQUEST, Any(job));
+        }
+        processItems(job);
+
+        // Wait for the items other threads are still working on.
+        while (job->mDone.get() < job->mItemCount) {
+            OGRE_THREAD_SLEEP(0);
+        }
+        releaseJob(job);
+    }
+
+    void LodWorkQueueWorker::processItems(LodParallelJob* job)
+    {
+        uint32 i;
+        while ((i = job->mNext++) < job->mItemCount) {
+            job->processItem(i);
+            job->mDone++;
+        }
+    }
+
+    void LodWorkQueueWorker::releaseJob(LodParallelJob* job)
+    {
+        if (--job->mRefs == 0) {
+            delete job;
+        }
+    }
+
     WorkQueue::Response* LodWorkQueueWorker::handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
     {
         // Called on worker thread by WorkQueue.
+        if (req->getType() == PARALLEL_JOB_REQUEST) {
+            LodParallelJob* job = any_cast<LodParallelJob*>(req->getData());
+            processItems(job);
+            releaseJob(job);
+            return OGRE_NEW WorkQueue::Response(req, true, Any());
+        }
         LodWorkQueueRequest* request = any_cast<LodWorkQueueRequest*>(req->getData());
         MeshLodGenerator::getSingleton()._process(request->config, request->cost.get(), request->data.get(), request->input.get(), request->output.get(), request->collapser.get());
         return OGRE_NEW WorkQueue::Response(req, true, req->getData());
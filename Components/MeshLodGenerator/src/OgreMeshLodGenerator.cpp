@@ -44,11 +44,33 @@
 #include "OgreLodCollapseCostOutside.h"
 #include "OgreLodData.h"
 #include "OgreLodCollapser.h"
+#include "OgreLodWorkQueueRequest.h"
+#include "OgreLodCache.h"
+#include "OgreRoot.h"
 
 
 namespace Ogre
 {
 
+namespace
+{
+    /// Processes one mesh of a batch per item.
+    class BatchLodJob : public LodParallelJob
+    {
+    public:
+        BatchLodJob(LodWorkQueueRequest** requests, size_t count) :
+            LodParallelJob(count), mRequests(requests) {}
+
+        void processItem(size_t i)
+        {
+            LodWorkQueueRequest* req = mRequests[i];
+            MeshLodGenerator::getSingleton()._process(req->config, req->cost.get(), req->data.get(), req->input.get(), req->output.get(), req->collapser.get());
+        }
+    protected:
+        LodWorkQueueRequest** mRequests;
+    };
+}
+
 template<> MeshLodGenerator* Singleton<MeshLodGenerator>::msSingleton = 0;
 MeshLodGenerator* MeshLodGenerator::getSingletonPtr()
 {
@@ -122,13 +144,16 @@ void MeshLodGenerator::_configureMeshLodUsage(const LodConfig& lodConfig)
     }
     // Remove skipped Lod levels
     lodConfig.mesh->_setLodInfo(n + 1);
+    if(lodConfig.advanced.optimiseIndexOrder)
+        lodConfig.mesh->optimiseIndexOrder();
     if(edgeListWasBuilt)
         lodConfig.mesh->buildEdgeList();
 }
 
 MeshLodGenerator::MeshLodGenerator() :
     mWQWorker(NULL),
-    mWQInjector(NULL)
+    mWQInjector(NULL),
+    mLodCache(NULL)
 {
 
 }
@@ -223,18 +248,87 @@ void MeshLodGenerator::generateLodLevels(LodConfig& lodConfig,
         }
     }
     if(hasGeneratedLevels || (LodWorkQueueInjector::getSingletonPtr() && LodWorkQueueInjector::getSingletonPtr()->getInjectorListener())) {
+        // Custom components may change the output, so only the default ones are cached.
+        bool useCache = mLodCache && hasGeneratedLevels && !lodConfig.advanced.useBackgroundQueue &&
+            cost.isNull() && data.isNull() && input.isNull() && output.isNull() && collapser.isNull();
+        uint32 cacheHash = 0;
+        if(useCache) {
+            cacheHash = LodCache::computeHash(lodConfig);
+            if(mLodCache->inject(cacheHash, lodConfig)) {
+                return;
+            }
+        }
+
         _resolveComponents(lodConfig, cost, data, input, output, collapser);
         if(lodConfig.advanced.useBackgroundQueue) {
             _initWorkQueue();
             LodWorkQueueWorker::getSingleton().addRequestToQueue(lodConfig, cost, data, input, output, collapser);
         } else {
-            _process(lodConfig, cost.get(), data.get(), input.get(), output.get(), collapser.get());
+            // The worker threads help computing the initial collapse costs.
+            if(Root::getSingletonPtr() && Root::getSingletonPtr()->getWorkQueue()) {
+                _initWorkQueue();
+            }
+            if(useCache) {
+                // Cache the index buffers before the mesh is reordered, as they are injected into the original mesh.
+                bool optimiseIndexOrder = lodConfig.advanced.optimiseIndexOrder;
+                lodConfig.advanced.optimiseIndexOrder = false;
+                _process(lodConfig, cost.get(), data.get(), input.get(), output.get(), collapser.get());
+                lodConfig.advanced.optimiseIndexOrder = optimiseIndexOrder;
+                mLodCache->store(cacheHash, lodConfig);
+                if(optimiseIndexOrder) {
+                    _configureMeshLodUsage(lodConfig);
+                }
+            } else {
+                _process(lodConfig, cost.get(), data.get(), input.get(), output.get(), collapser.get());
+            }
         }
     } else {
         _generateManualLodLevels(lodConfig);
     }
 }
 
+void MeshLodGenerator::generateLodLevelsBatch(LodConfigList& lodConfigs)
+{
+    _initWorkQueue();
+
+    vector<LodWorkQueueRequest*>::type requests;
+    vector<size_t>::type configIndices;
+    for(size_t i = 0; i < lodConfigs.size(); i++) {
+        LodConfig& lodConfig = lodConfigs[i];
+        bool hasGeneratedLevels = false;
+        for(size_t j = 0; j < lodConfig.levels.size(); j++) {
+            if(lodConfig.levels[j].manualMeshName.empty()) {
+                hasGeneratedLevels = true;
+                break;
+            }
+        }
+        if(!hasGeneratedLevels) {
+            _generateManualLodLevels(lodConfig);
+            continue;
+        }
+
+        // Buffer providers, so the meshes are only touched on this thread.
+        LodWorkQueueRequest* req = new LodWorkQueueRequest();
+        req->config = lodConfig;
+        req->config.advanced.useBackgroundQueue = true;
+        _resolveComponents(req->config, req->cost, req->data, req->input, req->output, req->collapser);
+        requests.push_back(req);
+        configIndices.push_back(i);
+    }
+
+    if(!requests.empty()) {
+        LodWorkQueueWorker::getSingleton().runParallel(new BatchLodJob(&requests[0], requests.size()));
+    }
+
+    for(size_t i = 0; i < requests.size(); i++) {
+        LodWorkQueueRequest* req = requests[i];
+        req->output->inject();
+        _configureMeshLodUsage(req->config);
+        lodConfigs[configIndices[i]].levels = req->config.levels;
+        delete req;
+    }
+}
+
 void MeshLodGenerator::computeLods(LodConfig& lodConfig,
                                    LodData* data,
                                    LodCollapseCost* cost,
@@ -58,6 +58,12 @@ namespace Ogre
     using a truetype font. You can either create the texture manually in code, or you
     can use a .fontdef script to define it (probably more practical since you can reuse
     the definition more easily)
+    @par
+    A truetype font normally renders all the glyphs of its code point ranges into
+    the texture when it is loaded. For large character sets, such as CJK, a dynamic
+    atlas can be used instead (see setDynamicAtlasSize): glyphs are then rendered
+    on first use, packed into a texture of fixed size and uploaded one by one, and
+    the least recently used glyphs are evicted when the texture is full.
     @note
     This class extends both Resource and ManualResourceLoader since it is
     both a resource in it's own right, but it also provides the manual load
@@ -107,6 +113,13 @@ namespace Ogre
             String doGet(const void* target) const;
             void doSet(void* target, const String& val);
         };
+        /// Command object for Font - see ParamCommand 
+        class _OgreOverlayExport CmdAtlasSize : public ParamCommand
+        {
+        public:
+            String doGet(const void* target) const;
+            void doSet(void* target, const String& val);
+        };
 
         // Command object for setting / getting parameters
         static CmdType msTypeCmd;
@@ -115,6 +128,7 @@ namespace Ogre
         static CmdSize msSizeCmd;
         static CmdResolution msResolutionCmd;
         static CmdCodePoints msCodePointsCmd;
+        static CmdAtlasSize msAtlasSizeCmd;
 
         /// The type of font
         FontType mType;
@@ -133,6 +147,9 @@ namespace Ogre
         /// Max distance to baseline of this (truetype) font
         int mTtfMaxBearingY;
 
+        /// Width and height of the dynamic atlas, 0 if all glyphs are rendered at load
+        uint mAtlasSize;
+
 
     public:
         typedef Ogre::uint32 CodePoint;
@@ -173,6 +190,38 @@ namespace Ogre
         /// Internal method for loading from ttf
         void createTextureFromFont(void);
 
+        /// Top edge of a free area of the dynamic atlas
+        struct SkylineNode
+        {
+            uint x, y, width;
+        };
+        typedef vector<SkylineNode>::type Skyline;
+        /// Free space of the dynamic atlas, left to right
+        Skyline mSkyline;
+        /// Contents of the dynamic atlas, in PF_BYTE_LA
+        vector<uchar>::type mAtlasData;
+        /// Frame each glyph in the dynamic atlas was last used in
+        typedef map<CodePoint, unsigned long>::type GlyphUseMap;
+        GlyphUseMap mGlyphLastUsed;
+        /// Incremented when glyphs are evicted from the dynamic atlas
+        unsigned long mAtlasGeneration;
+        /// FreeType library and face (FT_Library, FT_Face) kept open for the dynamic atlas
+        void* mFtLibrary;
+        void* mFtFace;
+        /// Font file, which the face reads from
+        DataStreamPtr mTtfData;
+        /// Height of a glyph in the dynamic atlas, in pixels
+        uint mGlyphHeight;
+
+        /// Open the face and clear the atlas, for a dynamic atlas
+        void openDynamicFace(void);
+        /// Render a glyph into the dynamic atlas, returns false if it has no room
+        bool renderDynamicGlyph(CodePoint id, bool upload);
+        /// Evict the least recently used glyphs from the dynamic atlas
+        bool evictDynamicGlyphs(void);
+        /// Find room for a rectangle in the dynamic atlas
+        bool allocateAtlasRect(uint width, uint height, uint& x, uint& y);
+
         /// @copydoc Resource::loadImpl
         virtual void loadImpl();
         /// @copydoc Resource::unloadImpl
@@ -370,6 +419,37 @@ namespace Ogre
         {
             return mCodePointRangeList;
         }
+
+        /** Sets the size of the texture glyphs are rendered into on first use
+            (only for FT_TRUETYPE, must be set before loading).
+        @remarks
+            With a size of 0, the default, every glyph of the code point ranges
+            is rendered into a texture just big enough for them all when the
+            font is loaded. Otherwise the texture has this width and height,
+            and glyphs are only rendered when _useGlyph asks for them; the code
+            point ranges then only restrict which glyphs may be rendered, or
+            allow any if there are none. It should be large enough for all the
+            text visible at once, else glyphs are evicted and rendered again
+            every frame.
+        */
+        void setDynamicAtlasSize(uint size) { mAtlasSize = size; }
+        /** Gets the size of the texture glyphs are rendered into on first use,
+            or 0 if all glyphs are rendered when loading. */
+        uint getDynamicAtlasSize(void) const { return mAtlasSize; }
+
+        /** Makes sure the glyph of a code point is in the texture, and marks it
+            as used in the current frame.
+        @remarks
+            Only needed for fonts with a dynamic atlas, does nothing otherwise.
+            Call this for each code point before asking for its texture
+            coordinates or aspect ratio.
+        */
+        void _useGlyph(CodePoint id);
+
+        /** Gets a number which changes whenever glyphs are evicted from the
+            dynamic atlas, after which texture coordinates obtained before may
+            point at other glyphs. */
+        unsigned long getAtlasGeneration(void) const { return mAtlasGeneration; }
         /** Gets the material generated for this font, as a weak reference. 
         @remarks
             This will only be valid after the Font has been loaded. 
@@ -33,6 +33,8 @@ THE SOFTWARE.
 #include "OgreIteratorWrappers.h"
 #include "OgreMatrix4.h"
 #include "OgreViewport.h"
+#include "OgreRenderable.h"
+#include "OgreRenderOperation.h"
 
 namespace Ogre {
     class OverlayContainer;
@@ -68,6 +70,10 @@ namespace Ogre {
         have fullscreen viewports, but if you have picture-in-picture views, you probably
         don't want the overlay displayed in the smaller viewports. You turn this off for 
         a specific viewport by calling the Viewport::setDisplayOverlays method.
+    @par
+        Elements which share a material and z-order are merged into batches,
+        each rendered with a single render operation, unless
+        OverlayManager::setBatchingEnabled is used to turn this off.
     */
     class _OgreOverlayExport Overlay : public OverlayAlloc
     {
@@ -106,6 +112,52 @@ namespace Ogre {
         /** Internal method for updating container elements' Z-ordering */
         void assignZOrders(void);
 
+        /// Elements of equal material and z-order, merged into one render operation
+        class _OgreOverlayExport Batch : public Renderable, public OverlayAlloc
+        {
+        public:
+            Batch(Overlay* parent);
+            virtual ~Batch();
+
+            /// Whether an element can be added to this batch
+            bool accepts(OverlayElement* elem, const RenderOperation& op) const;
+            /// Start collecting elements with the material and layout of this one
+            void reset(OverlayElement* elem, const RenderOperation& op);
+            /// Copy the changed geometry into the buffers and queue for rendering
+            void flush(RenderQueue* queue);
+
+            const MaterialPtr& getMaterial(void) const { return mMaterial; }
+            void getRenderOperation(RenderOperation& op) { op = mRenderOp; }
+            void getWorldTransforms(Matrix4* xform) const;
+            Real getSquaredViewDepth(const Camera* cam) const;
+            const LightList& getLights(void) const;
+
+            typedef vector<OverlayElement*>::type ElementList;
+            /// Elements added this frame
+            ElementList mElements;
+            /// Vertices added this frame
+            size_t mVertexCount;
+        protected:
+            Overlay* mParent;
+            MaterialPtr mMaterial;
+            ushort mZOrder;
+            RenderOperation mRenderOp;
+            /// Number of vertices the buffers can hold
+            size_t mVertexCapacity;
+            /// Elements and their vertex counts, as last copied into the buffers
+            vector<std::pair<OverlayElement*, size_t> >::type mBuiltElements;
+
+            void ensureCapacity(size_t vertexCount, size_t indexCount);
+        };
+        typedef vector<Batch*>::type BatchList;
+        /// Batches, in the order they were first used
+        BatchList mBatches;
+        /// Number of batches used this frame
+        size_t mNumBatchesUsed;
+
+        /** Internal method to render all the batches of this frame */
+        void flushBatches(RenderQueue* queue);
+
     public:
         /// Constructor: do not call direct, use OverlayManager::create
         Overlay(const String& name);
@@ -251,6 +303,15 @@ namespace Ogre {
         /** Internal method to put the overlay contents onto the render queue. */
         void _findVisibleObjects(Camera* cam, RenderQueue* queue, Viewport* vp);
 
+        /** Internal method to merge an element into a batch with others of the
+            same material and z-order.
+        @return False if the element has to be rendered on its own
+        */
+        bool _addToBatch(OverlayElement* elem);
+
+        /** Internal method to destroy the hardware buffers of the batches. */
+        void _releaseManualHardwareResources(void);
+
         /** This returns a OverlayElement at position x,y. */
         virtual OverlayElement* findElementAt(Real x, Real y);
 
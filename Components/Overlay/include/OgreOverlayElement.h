@@ -163,6 +163,8 @@ namespace Ogre {
         bool mGeomPositionsOutOfDate;
         /// Flag indicating if the vertex uvs need recalculating
         bool mGeomUVsOutOfDate;
+        /// Flag indicating if the geometry changed since it was copied into a batch
+        bool mGeomBatchOutOfDate;
 
         /** Zorder for when sending to render queue.
             Derived from parent */
@@ -310,6 +312,19 @@ namespace Ogre {
         /** Internal method to update the element based on transforms applied. */
         virtual void _update(void);
 
+        /** Whether this element can be merged with others into one render operation.
+        @remarks
+            True by default if the geometry is a non-indexed triangle list or a
+            four vertex strip, held in buffers with a shadow buffer, and no custom
+            parameters are set. Subclasses which render in some other way
+            should return false.
+        */
+        virtual bool _isBatchable(void);
+        /** Whether the geometry changed since it was last copied into a batch. */
+        bool _isGeomBatchOutOfDate(void) const { return mGeomBatchOutOfDate; }
+        /** Internal method to notify the element that its geometry was copied into a batch. */
+        void _notifyGeomBatched(void) { mGeomBatchOutOfDate = false; }
+
         /** Updates this elements transform based on it's parent. */
         virtual void _updateFromParent(void);
 
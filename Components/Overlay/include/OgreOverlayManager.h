@@ -70,6 +70,7 @@ namespace Ogre {
 
         int mLastViewportWidth, mLastViewportHeight;
         OrientationMode mLastViewportOrientationMode;
+        bool mBatchingEnabled;
 
         bool parseChildren( DataStreamPtr& chunk, const String& line,
             Overlay* pOverlay, bool isTemplate, OverlayContainer* parent = NULL);
@@ -143,6 +144,20 @@ namespace Ogre {
         /** Gets the orientation mode of the destination viewport. */
         OrientationMode getViewportOrientationMode(void) const;
 
+        /** Sets whether elements of an overlay which share a material and
+            z-order are merged into one render operation (default true).
+        @remarks
+            Only elements whose geometry is a non-indexed triangle list or quad
+            strip held in shadowed buffers, and which have no custom parameters,
+            are merged; see OverlayElement::_isBatchable. The merged geometry is
+            kept between frames, and only the elements which changed are copied
+            into it again.
+        */
+        void setBatchingEnabled(bool enabled) { mBatchingEnabled = enabled; }
+        /** Gets whether elements of an overlay are merged into one render
+            operation where possible. */
+        bool isBatchingEnabled(void) const { return mBatchingEnabled; }
+
         /** Creates a new OverlayElement of the type requested.
         @remarks
         The type of element to create is passed in as a string because this
@@ -65,6 +65,17 @@ namespace Ogre
 
         virtual void setCaption(const DisplayString& text);
 
+        /** Reserves room for a number of characters in the vertex buffers.
+        @remarks
+            The buffers grow by themselves as the caption gets longer, but
+            text which is updated often should reserve its largest length up
+            front to avoid recreating them. Only the characters which change
+            are uploaded each time the caption is set.
+        */
+        void setCharacterCapacity( size_t numChars );
+        /** Gets the number of characters the vertex buffers have room for. */
+        size_t getCharacterCapacity() const { return mAllocSize; }
+
         void setCharHeight( Real height );
         Real getCharHeight() const;
 
@@ -242,6 +253,10 @@ namespace Ogre
         ushort mPixelSpaceWidth;
         size_t mAllocSize;
         Real mViewportAspectCoef;
+        /// Font::getAtlasGeneration when the positions were last updated
+        unsigned long mFontAtlasGeneration;
+        /// Whether the vertex buffer contents are unknown, so that no glyph can be kept
+        bool mGeomRewriteAll;
 
         /// Colours to use for the vertices
         ColourValue mColourBottom;
@@ -34,6 +34,11 @@ THE SOFTWARE
 #include "OgreTextureUnitState.h"
 #include "OgreTechnique.h"
 #include "OgreBitwise.h"
+#include "OgreRoot.h"
+#include "OgreHardwarePixelBuffer.h"
+
+#include <algorithm>
+#include <limits>
 
 #define generic _generic    // keyword for C++/CX
 #include <ft2build.h>
@@ -52,12 +57,15 @@ namespace Ogre
     Font::CmdSize Font::msSizeCmd;
     Font::CmdResolution Font::msResolutionCmd;
     Font::CmdCodePoints Font::msCodePointsCmd;
+    Font::CmdAtlasSize Font::msAtlasSizeCmd;
 
     //---------------------------------------------------------------------
     Font::Font(ResourceManager* creator, const String& name, ResourceHandle handle,
         const String& group, bool isManual, ManualResourceLoader* loader)
         :Resource (creator, name, handle, group, isManual, loader),
-        mType(FT_TRUETYPE), mCharacterSpacer(5), mTtfSize(0), mTtfResolution(0), mTtfMaxBearingY(0), mAntialiasColour(false)
+        mType(FT_TRUETYPE), mCharacterSpacer(5), mTtfSize(0), mTtfResolution(0), mTtfMaxBearingY(0),
+        mAtlasSize(0), mAntialiasColour(false), mAtlasGeneration(0), mFtLibrary(0), mFtFace(0),
+        mGlyphHeight(0)
     {
 
         if (createParamDictionary("Font"))
@@ -81,6 +89,10 @@ namespace Ogre
             dict->addParameter(
                 ParameterDef("code_points", "Add a range of code points", PT_STRING),
                 &msCodePointsCmd);
+            dict->addParameter(
+                ParameterDef("atlas_size", "Size of the texture glyphs are rendered into on first use, "
+                "0 to render all at load (truetype only)", PT_UNSIGNED_INT),
+                &msAtlasSizeCmd);
         }
 
     }
@@ -175,6 +187,8 @@ namespace Ogre
         bool blendByAlpha = true;
         if (mType == FT_TRUETYPE)
         {
+            if (mAtlasSize)
+                openDynamicFace();
             createTextureFromFont();
             texLayer = mMaterial->getTechnique(0)->getPass(0)->getTextureUnitState(0);
             // Always blend by alpha
@@ -221,6 +235,292 @@ namespace Ogre
             mTexture->unload();
             mTexture.setNull();
         }
+
+        if (mFtFace)
+        {
+            FT_Done_Face(static_cast<FT_Face>(mFtFace));
+            FT_Done_FreeType(static_cast<FT_Library>(mFtLibrary));
+            mFtFace = mFtLibrary = 0;
+            mTtfData.setNull();
+
+            // The glyphs have to be rendered again after reloading
+            for (GlyphUseMap::iterator i = mGlyphLastUsed.begin(); i != mGlyphLastUsed.end(); ++i)
+            {
+                mCodePointMap.erase(i->first);
+            }
+            mGlyphLastUsed.clear();
+            mAtlasData.clear();
+            mSkyline.clear();
+            ++mAtlasGeneration;
+        }
+    }
+    //---------------------------------------------------------------------
+    void Font::openDynamicFace(void)
+    {
+        FT_Library ftLibrary;
+        if( FT_Init_FreeType( &ftLibrary ) )
+            OGRE_EXCEPT( Exception::ERR_INTERNAL_ERROR, "Could not init FreeType library!",
+            "Font::openDynamicFace");
+
+        // The face reads from the font file for as long as it is open
+        DataStreamPtr dataStreamPtr =
+            ResourceGroupManager::getSingleton().openResource(
+                mSource, mGroup, true, this);
+        MemoryDataStream* ttfchunk = OGRE_NEW MemoryDataStream(dataStreamPtr);
+        mTtfData = DataStreamPtr(ttfchunk);
+
+        FT_Face face;
+        if( FT_New_Memory_Face( ftLibrary, ttfchunk->getPtr(), (FT_Long)ttfchunk->size() , 0, &face ) )
+        {
+            FT_Done_FreeType(ftLibrary);
+            OGRE_EXCEPT( Exception::ERR_INTERNAL_ERROR,
+            "Could not open font face!", "Font::openDynamicFace" );
+        }
+
+        // Convert our point size to freetype 26.6 fixed point format
+        FT_F26Dot6 ftSize = (FT_F26Dot6)(mTtfSize * (1 << 6));
+        if( FT_Set_Char_Size( face, ftSize, 0, mTtfResolution, mTtfResolution ) )
+        {
+            FT_Done_Face(face);
+            FT_Done_FreeType(ftLibrary);
+            OGRE_EXCEPT( Exception::ERR_INTERNAL_ERROR,
+            "Could not set char size!", "Font::openDynamicFace" );
+        }
+        mFtLibrary = ftLibrary;
+        mFtFace = face;
+
+        // Glyphs are not known in advance, so take the line metrics of the face
+        mTtfMaxBearingY = static_cast<int>(face->size->metrics.ascender);
+        mGlyphHeight = static_cast<uint>(
+            (face->size->metrics.ascender - face->size->metrics.descender) >> 6);
+
+        // Reset content (White, transparent)
+        mAtlasData.resize(mAtlasSize * mAtlasSize * 2);
+        for (size_t i = 0; i < mAtlasData.size(); i += 2)
+        {
+            mAtlasData[i + 0] = 0xFF; // luminance
+            mAtlasData[i + 1] = 0x00; // alpha
+        }
+        SkylineNode node = { 0, 0, mAtlasSize };
+        mSkyline.assign(1, node);
+
+        LogManager::getSingleton().logMessage("Font " + mName + " using dynamic atlas size " +
+            StringConverter::toString(mAtlasSize) + "x" + StringConverter::toString(mAtlasSize));
+    }
+    //---------------------------------------------------------------------
+    bool Font::allocateAtlasRect(uint width, uint height, uint& x, uint& y)
+    {
+        // Bottom left skyline: the lowest position, then the tightest fit
+        size_t bestIndex = mSkyline.size();
+        uint bestBottom = std::numeric_limits<uint>::max(), bestWidth = 0;
+        for (size_t i = 0; i < mSkyline.size(); ++i)
+        {
+            uint left = mSkyline[i].x;
+            if (left + width > mAtlasSize)
+                break;
+
+            // Rest on the highest node below the rectangle
+            uint top = 0;
+            for (size_t j = i; j < mSkyline.size() && mSkyline[j].x < left + width; ++j)
+            {
+                top = std::max(top, mSkyline[j].y);
+            }
+            if (top + height > mAtlasSize)
+                continue;
+
+            if (top + height < bestBottom ||
+                (top + height == bestBottom && mSkyline[i].width < bestWidth))
+            {
+                bestIndex = i;
+                bestBottom = top + height;
+                bestWidth = mSkyline[i].width;
+                x = left;
+                y = top;
+            }
+        }
+        if (bestIndex == mSkyline.size())
+            return false;
+
+        // The rectangle becomes a new node, covering those it spans
+        SkylineNode node = { x, bestBottom, width };
+        mSkyline.insert(mSkyline.begin() + bestIndex, node);
+        for (size_t i = bestIndex + 1; i < mSkyline.size(); )
+        {
+            SkylineNode& next = mSkyline[i];
+            uint right = x + width;
+            if (next.x >= right)
+                break;
+            uint nextRight = next.x + next.width;
+            if (nextRight <= right)
+            {
+                mSkyline.erase(mSkyline.begin() + i);
+            }
+            else
+            {
+                next.width = nextRight - right;
+                next.x = right;
+                break;
+            }
+        }
+
+        // Merge neighbours of equal height
+        for (size_t i = 0; i + 1 < mSkyline.size(); )
+        {
+            if (mSkyline[i].y == mSkyline[i + 1].y)
+            {
+                mSkyline[i].width += mSkyline[i + 1].width;
+                mSkyline.erase(mSkyline.begin() + i + 1);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+        return true;
+    }
+    //---------------------------------------------------------------------
+    bool Font::renderDynamicGlyph(CodePoint id, bool upload)
+    {
+        FT_Face face = static_cast<FT_Face>(mFtFace);
+        if (FT_Load_Char( face, id, FT_LOAD_RENDER ) || !face->glyph->bitmap.buffer)
+        {
+            // Nothing to render, remember so as not to try again
+            mCodePointMap.insert(CodePointMap::value_type(id,
+                GlyphInfo(id, UVRect(0.0, 0.0, 0.0, 0.0), 1.0)));
+            return true;
+        }
+
+        const FT_Bitmap& bitmap = face->glyph->bitmap;
+        int advance = static_cast<int>(face->glyph->advance.x >> 6);
+        int x_bearing = static_cast<int>(face->glyph->metrics.horiBearingX >> 6);
+        int y_bearing = ( mTtfMaxBearingY >> 6 ) - static_cast<int>( face->glyph->metrics.horiBearingY >> 6 );
+        uint cellWidth = static_cast<uint>(
+            std::max(1, std::max(advance, x_bearing + (int)bitmap.width)));
+
+        uint l, m;
+        if (!allocateAtlasRect(cellWidth + mCharacterSpacer, mGlyphHeight + mCharacterSpacer, l, m))
+            return false;
+
+        // Copy the bitmap into its cell, clipped to it
+        size_t data_width = mAtlasSize * 2;
+        for (int j = 0; j < (int)bitmap.rows; ++j)
+        {
+            int row = j + y_bearing;
+            if (row < 0 || row >= (int)mGlyphHeight)
+                continue;
+            const uchar* buffer = bitmap.buffer + j * bitmap.pitch;
+            for (int k = 0; k < (int)bitmap.width; ++k)
+            {
+                int col = k + x_bearing;
+                if (col < 0 || col >= (int)cellWidth)
+                    continue;
+                uchar* pDest = &mAtlasData[(m + row) * data_width + (l + col) * 2];
+                // As in loadResource
+                pDest[0] = mAntialiasColour ? buffer[k] : 0xFF;
+                pDest[1] = buffer[k];
+            }
+        }
+
+        setGlyphTexCoords(id,
+            (Real)l / (Real)mAtlasSize, (Real)m / (Real)mAtlasSize,
+            (Real)(l + std::max(advance, 1)) / (Real)mAtlasSize,
+            (Real)(m + mGlyphHeight) / (Real)mAtlasSize, 1.0);
+        mGlyphLastUsed[id] = Root::getSingleton().getNextFrameNumber();
+
+        if (upload && !mTexture.isNull() && mTexture->isLoaded())
+        {
+            PixelBox atlas(mAtlasSize, mAtlasSize, 1, PF_BYTE_LA, &mAtlasData[0]);
+            Box cell(l, m, l + cellWidth, m + mGlyphHeight);
+            mTexture->getBuffer()->blitFromMemory(atlas.getSubVolume(cell), cell);
+        }
+        return true;
+    }
+    //---------------------------------------------------------------------
+    bool Font::evictDynamicGlyphs(void)
+    {
+        unsigned long frame = Root::getSingleton().getNextFrameNumber();
+
+        // Most recently used first
+        typedef std::pair<unsigned long, CodePoint> GlyphUse;
+        vector<GlyphUse>::type byUse;
+        byUse.reserve(mGlyphLastUsed.size());
+        for (GlyphUseMap::iterator i = mGlyphLastUsed.begin(); i != mGlyphLastUsed.end(); ++i)
+        {
+            byUse.push_back(GlyphUse(i->second, i->first));
+        }
+        std::sort(byUse.begin(), byUse.end(), std::greater<GlyphUse>());
+
+        // Keep the more recent half, and whatever is used this frame
+        size_t keep = byUse.size() / 2;
+        while (keep < byUse.size() && byUse[keep].first == frame)
+            ++keep;
+        if (keep == byUse.size())
+            return false;
+
+        // A skyline can't free single rectangles, so pack the kept glyphs again
+        for (size_t i = 0; i < byUse.size(); ++i)
+        {
+            mCodePointMap.erase(byUse[i].second);
+        }
+        mGlyphLastUsed.clear();
+        for (size_t i = 0; i < mAtlasData.size(); i += 2)
+        {
+            mAtlasData[i + 0] = 0xFF;
+            mAtlasData[i + 1] = 0x00;
+        }
+        SkylineNode node = { 0, 0, mAtlasSize };
+        mSkyline.assign(1, node);
+        for (size_t i = 0; i < keep; ++i)
+        {
+            if (renderDynamicGlyph(byUse[i].second, false))
+                mGlyphLastUsed[byUse[i].second] = byUse[i].first;
+        }
+
+        if (!mTexture.isNull() && mTexture->isLoaded())
+        {
+            mTexture->getBuffer()->blitFromMemory(
+                PixelBox(mAtlasSize, mAtlasSize, 1, PF_BYTE_LA, &mAtlasData[0]));
+        }
+        ++mAtlasGeneration;
+
+        LogManager::getSingleton().logMessage("Font " + mName + " evicted " +
+            StringConverter::toString(byUse.size() - keep) + " glyphs from its atlas");
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void Font::_useGlyph(CodePoint id)
+    {
+        if (!mFtFace)
+            return;
+
+        GlyphUseMap::iterator i = mGlyphLastUsed.find(id);
+        if (i != mGlyphLastUsed.end())
+        {
+            i->second = Root::getSingleton().getNextFrameNumber();
+            return;
+        }
+        // Known not to render
+        if (mCodePointMap.find(id) != mCodePointMap.end())
+            return;
+
+        if (!mCodePointRangeList.empty())
+        {
+            bool inRange = false;
+            for (CodePointRangeList::const_iterator r = mCodePointRangeList.begin();
+                r != mCodePointRangeList.end() && !inRange; ++r)
+            {
+                inRange = id >= r->first && id <= r->second;
+            }
+            if (!inRange)
+                return;
+        }
+
+        if (!renderDynamicGlyph(id, true) &&
+            (!evictDynamicGlyphs() || !renderDynamicGlyph(id, true)))
+        {
+            LogManager::getSingleton().logMessage("Font " + mName + " has no room for character " +
+                StringConverter::toString(id) + " in its atlas, make it larger", LML_CRITICAL);
+        }
     }
     //---------------------------------------------------------------------
     void Font::createTextureFromFont(void)
@@ -244,6 +544,17 @@ namespace Ogre
     //---------------------------------------------------------------------
     void Font::loadResource(Resource* res)
     {
+        if (mFtFace)
+        {
+            // Dynamic atlas: glyphs are added on first use, upload those so far
+            Image img;
+            img.loadDynamicImage(&mAtlasData[0], mAtlasSize, mAtlasSize, 1, PF_BYTE_LA);
+            ConstImagePtrList imagePtrs;
+            imagePtrs.push_back(&img);
+            static_cast<Texture*>(res)->_loadImages( imagePtrs );
+            return;
+        }
+
         // ManualResourceLoader implementation - load the texture
         FT_Library ftLibrary;
         // Init freetype
@@ -537,5 +848,17 @@ namespace Ogre
         }
     }
 
+    //-----------------------------------------------------------------------
+    String Font::CmdAtlasSize::doGet(const void* target) const
+    {
+        const Font* f = static_cast<const Font*>(target);
+        return StringConverter::toString(f->getDynamicAtlasSize());
+    }
+    void Font::CmdAtlasSize::doSet(void* target, const String& val)
+    {
+        Font* f = static_cast<Font*>(target);
+        f->setDynamicAtlasSize(StringConverter::parseUnsignedInt(val));
+    }
+
 
 }
@@ -263,6 +263,17 @@ namespace Ogre
                 }
             }
         }
+        else if (attrib == "atlas_size")
+        {
+            // Check params
+            if (params.size() != 2)
+            {
+                logBadAttrib(line, pFont);
+                return;
+            }
+            // Set
+            pFont->setDynamicAtlasSize(StringConverter::parseUnsignedInt(params[1]));
+        }
 
     }
     //---------------------------------------------------------------------
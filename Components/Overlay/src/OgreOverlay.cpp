@@ -33,6 +33,8 @@ THE SOFTWARE.
 #include "OgreSceneNode.h"
 #include "OgreRenderQueue.h"
 #include "OgreCamera.h"
+#include "OgreHardwareBufferManager.h"
+#include "OgreMaterial.h"
 
 namespace Ogre {
 
@@ -44,7 +46,8 @@ namespace Ogre {
         mScaleX(1.0f), mScaleY(1.0f),
         mLastViewportWidth(0), mLastViewportHeight(0),
         mTransformOutOfDate(true), mTransformUpdated(true), 
-        mZOrder(100), mVisible(false), mInitialised(false)
+        mZOrder(100), mVisible(false), mInitialised(false),
+        mNumBatchesUsed(0)
 
     {
         mRootNode = OGRE_NEW SceneNode(NULL);
@@ -56,6 +59,7 @@ namespace Ogre {
         // remove children
 
         OGRE_DELETE mRootNode;
+        _releaseManualHardwareResources();
         
         for (OverlayContainerList::iterator i = m2DElements.begin(); 
              i != m2DElements.end(); ++i)
@@ -301,6 +305,7 @@ namespace Ogre {
             queue->setDefaultQueueGroup(oldgrp);
             queue->setDefaultRenderablePriority(oldPriority);
             // Add 2D elements
+            mNumBatchesUsed = 0;
             iend = m2DElements.end();
             for (i = m2DElements.begin(); i != iend; ++i)
             {
@@ -308,9 +313,260 @@ namespace Ogre {
 
                 (*i)->_updateRenderQueue(queue);
             }
+            flushBatches(queue);
         }
     }
     //---------------------------------------------------------------------
+    bool Overlay::_addToBatch(OverlayElement* elem)
+    {
+        RenderOperation op;
+        elem->getRenderOperation(op);
+
+        // Join a batch started this frame, if one matches
+        for (size_t i = 0; i < mNumBatchesUsed; ++i)
+        {
+            Batch* batch = mBatches[i];
+            if (batch->accepts(elem, op))
+            {
+                batch->mElements.push_back(elem);
+                batch->mVertexCount += op.vertexData->vertexCount;
+                return true;
+            }
+        }
+
+        // Reuse the batches of previous frames in the same order, so that
+        // unchanged elements usually land where they were copied before
+        if (mNumBatchesUsed == mBatches.size())
+            mBatches.push_back(OGRE_NEW Batch(this));
+        mBatches[mNumBatchesUsed++]->reset(elem, op);
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void Overlay::flushBatches(RenderQueue* queue)
+    {
+        for (size_t i = 0; i < mNumBatchesUsed; ++i)
+        {
+            mBatches[i]->flush(queue);
+        }
+    }
+    //---------------------------------------------------------------------
+    void Overlay::_releaseManualHardwareResources(void)
+    {
+        for (BatchList::iterator i = mBatches.begin(); i != mBatches.end(); ++i)
+        {
+            OGRE_DELETE *i;
+        }
+        mBatches.clear();
+        mNumBatchesUsed = 0;
+    }
+    //---------------------------------------------------------------------
+    Overlay::Batch::Batch(Overlay* parent)
+        : mVertexCount(0), mParent(parent), mZOrder(0), mVertexCapacity(0)
+    {
+        mRenderOp.vertexData = OGRE_NEW VertexData();
+        mRenderOp.vertexData->vertexStart = 0;
+        mRenderOp.indexData = OGRE_NEW IndexData();
+        mRenderOp.operationType = RenderOperation::OT_TRIANGLE_LIST;
+        mRenderOp.useIndexes = true;
+        mRenderOp.useGlobalInstancingVertexBufferIsAvailable = false;
+
+        // Same as the elements
+        mPolygonModeOverrideable = false;
+        mUseIdentityProjection = true;
+        mUseIdentityView = true;
+    }
+    //---------------------------------------------------------------------
+    Overlay::Batch::~Batch()
+    {
+        OGRE_DELETE mRenderOp.vertexData;
+        OGRE_DELETE mRenderOp.indexData;
+    }
+    //---------------------------------------------------------------------
+    bool Overlay::Batch::accepts(OverlayElement* elem, const RenderOperation& op) const
+    {
+        // Must stay addressable with 16 bit indexes
+        return elem->getZOrder() == mZOrder &&
+            elem->getMaterial() == mMaterial &&
+            mVertexCount + op.vertexData->vertexCount <= 0xFFFF &&
+            *op.vertexData->vertexDeclaration == *mRenderOp.vertexData->vertexDeclaration;
+    }
+    //---------------------------------------------------------------------
+    void Overlay::Batch::reset(OverlayElement* elem, const RenderOperation& op)
+    {
+        mElements.assign(1, elem);
+        mVertexCount = op.vertexData->vertexCount;
+        mMaterial = elem->getMaterial();
+        mZOrder = elem->getZOrder();
+
+        VertexDeclaration* decl = mRenderOp.vertexData->vertexDeclaration;
+        if (*decl != *op.vertexData->vertexDeclaration)
+        {
+            // Take over the layout of the element, the buffers no longer fit
+            decl->removeAllElements();
+            const VertexDeclaration::VertexElementList& elems =
+                op.vertexData->vertexDeclaration->getElements();
+            for (VertexDeclaration::VertexElementList::const_iterator i = elems.begin();
+                i != elems.end(); ++i)
+            {
+                decl->addElement(i->getSource(), i->getOffset(), i->getType(),
+                    i->getSemantic(), i->getIndex());
+            }
+            mRenderOp.vertexData->vertexBufferBinding->unsetAllBindings();
+            mVertexCapacity = 0;
+            mBuiltElements.clear();
+        }
+    }
+    //---------------------------------------------------------------------
+    void Overlay::Batch::ensureCapacity(size_t vertexCount, size_t indexCount)
+    {
+        if (vertexCount <= mVertexCapacity && !mRenderOp.indexData->indexBuffer.isNull() &&
+            indexCount <= mRenderOp.indexData->indexBuffer->getNumIndexes())
+            return;
+
+        mVertexCapacity = std::max(vertexCount, mVertexCapacity * 2);
+        HardwareBufferManager& mgr = HardwareBufferManager::getSingleton();
+        VertexDeclaration* decl = mRenderOp.vertexData->vertexDeclaration;
+        for (unsigned short s = 0; s <= decl->getMaxSource(); ++s)
+        {
+            // Shadowed so that only the changed elements are uploaded
+            mRenderOp.vertexData->vertexBufferBinding->setBinding(s,
+                mgr.createVertexBuffer(decl->getVertexSize(s), mVertexCapacity,
+                    HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY, true));
+        }
+        // At most 6 indexes for every 4 vertices, for strips
+        mRenderOp.indexData->indexBuffer = mgr.createIndexBuffer(HardwareIndexBuffer::IT_16BIT,
+            std::max(indexCount, mVertexCapacity * 3 / 2), HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
+        mBuiltElements.clear();
+    }
+    //---------------------------------------------------------------------
+    void Overlay::Batch::flush(RenderQueue* queue)
+    {
+        if (mElements.size() == 1)
+        {
+            // Nothing to merge with, render the element as it is
+            queue->addRenderable(mElements[0], RENDER_QUEUE_OVERLAY, mZOrder);
+            mBuiltElements.clear();
+            return;
+        }
+
+        // Strips of 4 vertices become 2 triangles
+        size_t indexCount = 0;
+        for (ElementList::iterator i = mElements.begin(); i != mElements.end(); ++i)
+        {
+            RenderOperation op;
+            (*i)->getRenderOperation(op);
+            indexCount += op.operationType == RenderOperation::OT_TRIANGLE_STRIP ?
+                6 : op.vertexData->vertexCount;
+        }
+        ensureCapacity(mVertexCount, indexCount);
+
+        // Unless elements came or went, only copy those which changed
+        bool sameLayout = mBuiltElements.size() == mElements.size();
+        bool anyChanged = !sameLayout;
+        for (size_t e = 0; e < mElements.size() && sameLayout; ++e)
+        {
+            RenderOperation op;
+            mElements[e]->getRenderOperation(op);
+            sameLayout = mBuiltElements[e].first == mElements[e] &&
+                mBuiltElements[e].second == op.vertexData->vertexCount;
+            anyChanged = anyChanged || !sameLayout || mElements[e]->_isGeomBatchOutOfDate();
+        }
+
+        if (anyChanged)
+        {
+            VertexBufferBinding* bind = mRenderOp.vertexData->vertexBufferBinding;
+            for (unsigned short s = 0; s <= mRenderOp.vertexData->vertexDeclaration->getMaxSource(); ++s)
+            {
+                const HardwareVertexBufferSharedPtr& dst = bind->getBuffer(s);
+                size_t vertexSize = dst->getVertexSize();
+                char* pDst = static_cast<char*>(dst->lock(
+                    sameLayout ? HardwareBuffer::HBL_NORMAL : HardwareBuffer::HBL_DISCARD));
+
+                size_t vertexStart = 0;
+                for (ElementList::iterator i = mElements.begin(); i != mElements.end(); ++i)
+                {
+                    RenderOperation op;
+                    (*i)->getRenderOperation(op);
+                    size_t count = op.vertexData->vertexCount;
+                    if (!sameLayout || (*i)->_isGeomBatchOutOfDate())
+                    {
+                        // Reads the shadow buffer of the element
+                        const HardwareVertexBufferSharedPtr& src =
+                            op.vertexData->vertexBufferBinding->getBuffer(s);
+                        const void* pSrc = src->lock(op.vertexData->vertexStart * vertexSize,
+                            count * vertexSize, HardwareBuffer::HBL_READ_ONLY);
+                        memcpy(pDst + vertexStart * vertexSize, pSrc, count * vertexSize);
+                        src->unlock();
+                        if (sameLayout)
+                            dst->markDirty(vertexStart * vertexSize, count * vertexSize);
+                    }
+                    vertexStart += count;
+                }
+                dst->unlock();
+            }
+
+            for (ElementList::iterator i = mElements.begin(); i != mElements.end(); ++i)
+            {
+                (*i)->_notifyGeomBatched();
+            }
+        }
+
+        if (!sameLayout)
+        {
+            uint16* pIdx = static_cast<uint16*>(
+                mRenderOp.indexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+            uint16 base = 0;
+            mBuiltElements.clear();
+            for (ElementList::iterator i = mElements.begin(); i != mElements.end(); ++i)
+            {
+                RenderOperation op;
+                (*i)->getRenderOperation(op);
+                uint16 count = static_cast<uint16>(op.vertexData->vertexCount);
+                if (op.operationType == RenderOperation::OT_TRIANGLE_STRIP)
+                {
+                    // 0-2, 1-3 quad as in PanelOverlayElement
+                    *pIdx++ = base;
+                    *pIdx++ = base + 1;
+                    *pIdx++ = base + 2;
+                    *pIdx++ = base + 2;
+                    *pIdx++ = base + 1;
+                    *pIdx++ = base + 3;
+                }
+                else
+                {
+                    for (uint16 v = 0; v < count; ++v)
+                        *pIdx++ = base + v;
+                }
+                base += count;
+                mBuiltElements.push_back(std::make_pair(*i, op.vertexData->vertexCount));
+            }
+            mRenderOp.indexData->indexBuffer->unlock();
+            mRenderOp.indexData->indexStart = 0;
+            mRenderOp.indexData->indexCount = indexCount;
+            mRenderOp.vertexData->vertexCount = mVertexCount;
+        }
+
+        queue->addRenderable(this, RENDER_QUEUE_OVERLAY, mZOrder);
+    }
+    //---------------------------------------------------------------------
+    void Overlay::Batch::getWorldTransforms(Matrix4* xform) const
+    {
+        mParent->_getWorldTransforms(xform);
+    }
+    //---------------------------------------------------------------------
+    Real Overlay::Batch::getSquaredViewDepth(const Camera* cam) const
+    {
+        (void)cam;
+        return 10000.0f - (Real)mZOrder;
+    }
+    //---------------------------------------------------------------------
+    const LightList& Overlay::Batch::getLights(void) const
+    {
+        // Not lit by the scene, as the elements
+        static LightList ll;
+        return ll;
+    }
+    //---------------------------------------------------------------------
     void Overlay::updateTransform(void) const
     {
         // Ordering:
@@ -76,6 +76,7 @@ namespace Ogre {
       , mDerivedOutOfDate(true)
       , mGeomPositionsOutOfDate(true)
       , mGeomUVsOutOfDate(true)
+      , mGeomBatchOutOfDate(true)
       , mZOrder(0)
       , mEnabled(true)
       , mInitialised(false)
@@ -404,6 +405,7 @@ namespace Ogre {
         if (mGeomPositionsOutOfDate && mInitialised)
         {
             updatePositionGeometry();
+            mGeomBatchOutOfDate = true;
 
             // Within updatePositionGeometry() of TextOverlayElements,
             // the needed pixel width is calculated and as a result a new 
@@ -421,6 +423,7 @@ namespace Ogre {
         {
             updateTextureGeometry();
             mGeomUVsOutOfDate = false;
+            mGeomBatchOutOfDate = true;
         } 
     }
     //---------------------------------------------------------------------
@@ -622,10 +625,40 @@ namespace Ogre {
     {
         if (mVisible)
         {
-            queue->addRenderable(this, RENDER_QUEUE_OVERLAY, mZOrder);
+            // Merge with elements of the same material and z-order if possible
+            if (!mOverlay || !OverlayManager::getSingleton().isBatchingEnabled() ||
+                !_isBatchable() || !mOverlay->_addToBatch(this))
+            {
+                queue->addRenderable(this, RENDER_QUEUE_OVERLAY, mZOrder);
+            }
         }      
     }
     //---------------------------------------------------------------------
+    bool OverlayElement::_isBatchable(void)
+    {
+        if (!mCustomParameters.empty() || getMaterial().isNull())
+            return false;
+
+        RenderOperation op;
+        getRenderOperation(op);
+        if (op.useIndexes || !op.vertexData || op.vertexData->vertexCount == 0)
+            return false;
+        if (op.operationType != RenderOperation::OT_TRIANGLE_LIST &&
+            (op.operationType != RenderOperation::OT_TRIANGLE_STRIP || op.vertexData->vertexCount != 4))
+            return false;
+
+        // Copying into the batch reads the buffers back
+        const VertexBufferBinding::VertexBufferBindingMap& bindings =
+            op.vertexData->vertexBufferBinding->getBindings();
+        for (VertexBufferBinding::VertexBufferBindingMap::const_iterator i = bindings.begin();
+            i != bindings.end(); ++i)
+        {
+            if (!i->second->hasShadowBuffer())
+                return false;
+        }
+        return true;
+    }
+    //---------------------------------------------------------------------
     void OverlayElement::visitRenderables(Renderable::Visitor* visitor, 
         bool debugRenderables)
     {
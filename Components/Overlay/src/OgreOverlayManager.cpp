@@ -52,7 +52,8 @@ namespace Ogre {
     OverlayManager::OverlayManager() 
       : mLastViewportWidth(0), 
         mLastViewportHeight(0), 
-        mLastViewportOrientationMode(OR_DEGREE_0)
+        mLastViewportOrientationMode(OR_DEGREE_0),
+        mBatchingEnabled(true)
     {
 
         // Scripting is supported by this manager
@@ -84,6 +85,8 @@ namespace Ogre {
             for(ElementMap::iterator i = elementMap.begin(), i_end = elementMap.end(); i != i_end; ++i)
                 i->second->_releaseManualHardwareResources();
         }
+        for(OverlayMap::iterator i = mOverlayMap.begin(); i != mOverlayMap.end(); ++i)
+            i->second->_releaseManualHardwareResources();
     }
     //---------------------------------------------------------------------
     void OverlayManager::_restoreManualHardwareResources()
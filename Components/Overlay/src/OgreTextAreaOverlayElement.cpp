@@ -73,6 +73,8 @@ namespace Ogre {
         mSpaceWidth = 0;
         mPixelSpaceWidth = 0;
         mViewportAspectCoef = 1;
+        mGeomRewriteAll = true;
+        mFontAtlasGeneration = 0;
 
         if (createParamDictionary("TextAreaOverlayElement"))
         {
@@ -106,7 +108,9 @@ namespace Ogre {
 
             mInitialised = true;
 
-            checkMemoryAllocation( DEFAULT_INITIAL_CHARS );
+            // Keep any capacity reserved before initialisation
+            mAllocSize = std::max(mAllocSize, static_cast<size_t>(DEFAULT_INITIAL_CHARS));
+            _restoreManualHardwareResources();
         }
 
     }
@@ -115,7 +119,9 @@ namespace Ogre {
     {
         if( mAllocSize < numChars)
         {
-            mAllocSize = numChars;
+            // Grow by half at least, so text growing a character at a time
+            // does not recreate the buffers every time
+            mAllocSize = std::max(numChars, mAllocSize + mAllocSize / 2);
 
             // Create and bind new buffers
             // Note that old buffers will be deleted automatically through reference counting
@@ -135,14 +141,15 @@ namespace Ogre {
         VertexDeclaration* decl = mRenderOp.vertexData->vertexDeclaration;
         VertexBufferBinding* bind = mRenderOp.vertexData->vertexBufferBinding;
 
-        // Create dynamic since text tends to change a lot
+        // Create dynamic since text tends to change a lot, shadowed so that
+        // the overlay can copy it into a batch
         // positions & texcoords
         HardwareVertexBufferSharedPtr vbuf = 
             HardwareBufferManager::getSingleton().
                 createVertexBuffer(
                     decl->getVertexSize(POS_TEX_BINDING), 
                     allocatedVertexCount,
-                    HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
+                    HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY, true);
         bind->setBinding(POS_TEX_BINDING, vbuf);
 
         // colours
@@ -150,11 +157,12 @@ namespace Ogre {
                 createVertexBuffer(
                     decl->getVertexSize(COLOUR_BINDING), 
                     allocatedVertexCount,
-                    HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
+                    HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY, true);
         bind->setBinding(COLOUR_BINDING, vbuf);
 
         // Buffers are restored, but with trash within
         mGeomPositionsOutOfDate = true;
+        mGeomRewriteAll = true;
         mGeomUVsOutOfDate = true;
         mColoursChanged = true;
     }
@@ -183,12 +191,31 @@ namespace Ogre {
         size_t charlen = mCaption.size();
         checkMemoryAllocation( charlen );
 
+        // Make sure a dynamic atlas has all the glyphs before asking for them
+        if (mFont->getDynamicAtlasSize())
+        {
+            if (!mSpaceWidthOverridden)
+                mFont->_useGlyph(UNICODE_ZERO);
+            for (DisplayString::iterator i = mCaption.begin(); i != mCaption.end(); ++i)
+            {
+                Font::CodePoint character = OGRE_DEREF_DISPLAYSTRING_ITERATOR(i);
+                if (character != UNICODE_SPACE && character != UNICODE_CR && character != UNICODE_LF)
+                    mFont->_useGlyph(character);
+            }
+            mFontAtlasGeneration = mFont->getAtlasGeneration();
+        }
+
         mRenderOp.vertexData->vertexCount = charlen * 6;
         // Get position / texcoord buffer
         const HardwareVertexBufferSharedPtr& vbuf = 
             mRenderOp.vertexData->vertexBufferBinding->getBuffer(POS_TEX_BINDING);
+        // The shadow buffer still holds the previous text, so keep it and compare
+        bool rewriteAll = mGeomRewriteAll || !vbuf->hasShadowBuffer();
         pVert = static_cast<float*>(
-            vbuf->lock(HardwareBuffer::HBL_DISCARD, Root::getSingleton().getFreqUpdatedBuffersUploadOption()) );
+            vbuf->lock(rewriteAll ? HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL,
+                Root::getSingleton().getFreqUpdatedBuffersUploadOption()) );
+        const float* pVertStart = pVert;
+        size_t dirtyStart = 0, dirtyEnd = 0;
 
         float largestWidth = 0;
         float left = _getDerivedLeft() * 2.0f - 1.0f;
@@ -275,66 +302,83 @@ namespace Ogre {
             const Font::UVRect& uvRect = mFont->getGlyphTexCoords(character);
 
             // each vert is (x, y, z, u, v)
+            float glyph[30];
+            float* pGlyph = glyph;
             //-------------------------------------------------------------------------------------
             // First tri
             //
             // Upper left
-            *pVert++ = left;
-            *pVert++ = top;
-            *pVert++ = -1.0;
-            *pVert++ = uvRect.left;
-            *pVert++ = uvRect.top;
+            *pGlyph++ = left;
+            *pGlyph++ = top;
+            *pGlyph++ = -1.0;
+            *pGlyph++ = uvRect.left;
+            *pGlyph++ = uvRect.top;
 
             top -= mCharHeight * 2.0f;
 
             // Bottom left
-            *pVert++ = left;
-            *pVert++ = top;
-            *pVert++ = -1.0;
-            *pVert++ = uvRect.left;
-            *pVert++ = uvRect.bottom;
+            *pGlyph++ = left;
+            *pGlyph++ = top;
+            *pGlyph++ = -1.0;
+            *pGlyph++ = uvRect.left;
+            *pGlyph++ = uvRect.bottom;
 
             top += mCharHeight * 2.0f;
             left += horiz_height * mCharHeight * 2.0f;
 
             // Top right
-            *pVert++ = left;
-            *pVert++ = top;
-            *pVert++ = -1.0;
-            *pVert++ = uvRect.right;
-            *pVert++ = uvRect.top;
+            *pGlyph++ = left;
+            *pGlyph++ = top;
+            *pGlyph++ = -1.0;
+            *pGlyph++ = uvRect.right;
+            *pGlyph++ = uvRect.top;
             //-------------------------------------------------------------------------------------
 
             //-------------------------------------------------------------------------------------
             // Second tri
             //
             // Top right (again)
-            *pVert++ = left;
-            *pVert++ = top;
-            *pVert++ = -1.0;
-            *pVert++ = uvRect.right;
-            *pVert++ = uvRect.top;
+            *pGlyph++ = left;
+            *pGlyph++ = top;
+            *pGlyph++ = -1.0;
+            *pGlyph++ = uvRect.right;
+            *pGlyph++ = uvRect.top;
 
             top -= mCharHeight * 2.0f;
             left -= horiz_height  * mCharHeight * 2.0f;
 
             // Bottom left (again)
-            *pVert++ = left;
-            *pVert++ = top;
-            *pVert++ = -1.0;
-            *pVert++ = uvRect.left;
-            *pVert++ = uvRect.bottom;
+            *pGlyph++ = left;
+            *pGlyph++ = top;
+            *pGlyph++ = -1.0;
+            *pGlyph++ = uvRect.left;
+            *pGlyph++ = uvRect.bottom;
 
             left += horiz_height  * mCharHeight * 2.0f;
 
             // Bottom right
-            *pVert++ = left;
-            *pVert++ = top;
-            *pVert++ = -1.0;
-            *pVert++ = uvRect.right;
-            *pVert++ = uvRect.bottom;
+            *pGlyph++ = left;
+            *pGlyph++ = top;
+            *pGlyph++ = -1.0;
+            *pGlyph++ = uvRect.right;
+            *pGlyph++ = uvRect.bottom;
             //-------------------------------------------------------------------------------------
 
+            // Only write and upload the glyphs which moved or changed
+            if (rewriteAll || memcmp(pVert, glyph, sizeof(glyph)) != 0)
+            {
+                memcpy(pVert, glyph, sizeof(glyph));
+                size_t offset = (pVert - pVertStart) * sizeof(float);
+                if (offset != dirtyEnd)
+                {
+                    if (dirtyEnd > dirtyStart)
+                        vbuf->markDirty(dirtyStart, dirtyEnd - dirtyStart);
+                    dirtyStart = offset;
+                }
+                dirtyEnd = offset + sizeof(glyph);
+            }
+            pVert += 30;
+
             // Go back up with top
             top += mCharHeight * 2.0f;
 
@@ -345,8 +389,11 @@ namespace Ogre {
 
             }
         }
-        // Unlock vertex buffer
+        // Unlock vertex buffer, uploading the changed glyphs only
+        if (!rewriteAll)
+            vbuf->markDirty(dirtyStart, dirtyEnd - dirtyStart);
         vbuf->unlock();
+        mGeomRewriteAll = false;
 
         if (mMetricsMode == GMM_PIXELS)
         {
@@ -361,6 +408,14 @@ namespace Ogre {
             setWidth(largestWidth);
     }
 
+    void TextAreaOverlayElement::setCharacterCapacity( size_t numChars )
+    {
+        if (mInitialised)
+            checkMemoryAllocation( numChars );
+        else
+            mAllocSize = std::max(mAllocSize, numChars);
+    }
+
     void TextAreaOverlayElement::updateTextureGeometry()
     {
         // Nothing to do, we combine positions and textures
@@ -368,6 +423,9 @@ namespace Ogre {
 
     void TextAreaOverlayElement::setCaption( const DisplayString& caption )
     {
+        if (caption == mCaption)
+            return;
+
         mCaption = caption;
         mGeomPositionsOutOfDate = true;
         mGeomUVsOutOfDate = true;
@@ -641,12 +699,20 @@ namespace Ogre {
             break;
         }
 
+        // Glyphs evicted from a dynamic atlas have moved
+        if (!mFont.isNull() && mFont->getDynamicAtlasSize() &&
+            mFont->getAtlasGeneration() != mFontAtlasGeneration)
+        {
+            mGeomPositionsOutOfDate = true;
+        }
+
         OverlayElement::_update();
 
         if (mColoursChanged && mInitialised)
         {
             updateColours();
             mColoursChanged = false;
+            mGeomBatchOutOfDate = true;
         }
     }
     //---------------------------------------------------------------------------------------------
@@ -137,6 +137,17 @@ namespace Ogre
         int32 mMaxCellX;
         int32 mMaxCellY;
 
+        /// Recent motion of a camera, in grid space
+        struct CameraMotion
+        {
+            Vector2 lastPos;
+            unsigned long lastTime;
+            Vector2 velocity;
+        };
+        typedef map<const Camera*, CameraMotion>::type CameraMotionMap;
+        /// Not saved, only used to predict where cameras are heading
+        CameraMotionMap mCameraMotion;
+
         void updateDerivedMetrics();
 
     public:
@@ -217,6 +228,10 @@ namespace Ogre
         PageID calculatePageID(int32 x, int32 y);
         void calculateCell(PageID inPageID, int32* x, int32* y);
 
+        /** Track the motion of a camera, returning its velocity in grid space 
+            units per second. */
+        Vector2 _updateCameraVelocity(const Camera* cam, const Vector2& gridpos);
+
     };
 
 
@@ -225,6 +240,12 @@ namespace Ogre
         The grid can be up to 65536 x 65536 cells in size. PageIDs are generated
         like this: (row * 65536) + col. The grid is centred around the grid origin, such 
         that the boundaries of the cell around that origin are [-CellSize/2, CellSize/2)
+    @par
+        Pages are also requested around the camera position predicted 
+        PageManager::getPageLoadLookAheadTime seconds ahead. New pages are 
+        requested in order of their estimated time until they are needed, 
+        from the camera velocity, distance and view direction, up to 
+        PageManager::getMaxConcurrentPageLoads pages loading at a time.
     */
     class _OgrePagingExport Grid2DPageStrategy : public PageStrategy
     {
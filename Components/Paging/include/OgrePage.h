@@ -57,7 +57,13 @@ namespace Ogre
         unsigned long mFrameLastHeld;
         ContentCollectionList mContentCollections;
         uint16 mWorkQueueChannel;
+        WorkQueue::RequestID mLoadRequestID;
         bool mDeferredProcessInProgress;
+        /// Whether the page is waiting in the PageManager to be loaded in steps
+        bool mLoadStepsPending;
+        /// Next collection and step within it to load, collection -1 is the procedural load
+        int mLoadCollection;
+        size_t mLoadCollectionStep;
         bool mModified;
 
         SceneNode* mDebugNode;
@@ -113,6 +119,9 @@ namespace Ogre
         virtual PageID getID() const { return mID; }
         /// Get the PagedWorldSection this page belongs to
         virtual PagedWorldSection* getParentSection() const { return mParent; }
+        /** Get the level of detail of this page in a hierarchical PageStrategy,
+            0 being the coarsest (see PageStrategy::getPageLevel). */
+        uint16 getLevel() const;
         /** Get the frame number in which this Page was last loaded or held.
         @remarks
             A Page that has not been requested to be loaded or held in the recent
@@ -138,6 +147,15 @@ namespace Ogre
         */
         virtual bool isHeld() const;
 
+        /** Perform the next step of the main thread loading of this page.
+        @remarks
+            Called by PageManager when a page load budget is set.
+        @return True if the page is completely loaded
+        */
+        virtual bool _loadNextStep();
+        /// Whether loading steps are still to be performed
+        bool _isLoadStepsPending() const { return mLoadStepsPending; }
+
         /// Save page data to an automatically generated file name
         virtual void save();
         /// Save page data to a file
@@ -51,6 +51,8 @@ namespace Ogre
         the collection of relevant PageContent instances to be modified at runtime
         if required. For example, potentially you might want to define Page-level LOD
         in which different collections of PageContent are loaded at different times.
+        With a hierarchical PageStrategy such as QuadTreePageStrategy, getLevel 
+        tells which level of detail the content should be loaded for.
     */
     class _OgrePagingExport PageContentCollection : public PageAlloc
     {
@@ -67,6 +69,8 @@ namespace Ogre
         PageManager* getManager() const;
         Page* getParentPage() const { return mParent; }
         SceneManager* getSceneManager() const;
+        /// Get the level of detail of the parent page, see Page::getLevel
+        uint16 getLevel() const;
 
         /// Get the type of the collection, which will match it's factory
         virtual const String& getType() const;
@@ -87,6 +91,13 @@ namespace Ogre
         virtual bool prepare(StreamSerialiser& ser) = 0;
         /// Load - will be called in main thread
         virtual void load() = 0;
+        /** Get the number of steps load() can be split into, to spread it over
+            several frames. The default is 1. */
+        virtual size_t getNumLoadSteps() const { return 1; }
+        /** Perform one step of load() - will be called in main thread, with
+            steps from 0 to getNumLoadSteps() - 1 in order. The default calls load().
+        */
+        virtual void loadStep(size_t step) { load(); }
         /// Unload - will be called in main thread
         virtual void unload() = 0;
         /// Unprepare data - may be called in the background
@@ -432,6 +432,45 @@ namespace Ogre
         /** Get whether paging operations are currently allowed to happen. */
         bool getPagingOperationsEnabled() const { return mPagingEnabled; }
 
+        /** Set the maximum number of pages of a section being prepared in the 
+            background at the same time, 0 (the default) for no limit.
+        @remarks
+            Strategies which rank their requests, such as Grid2DPageStrategy,
+            request the most urgent pages first and leave the others for later
+            frames, so that I/O goes to the pages needed soonest.
+        */
+        void setMaxConcurrentPageLoads(size_t loads) { mMaxConcurrentPageLoads = loads; }
+        /** Get the maximum number of pages of a section being prepared at the same time. */
+        size_t getMaxConcurrentPageLoads() const { return mMaxConcurrentPageLoads; }
+
+        /** Set how many seconds ahead strategies predict the camera position 
+            from its velocity, to load pages before it reaches them (default 0).
+        */
+        void setPageLoadLookAheadTime(Real seconds) { mPageLoadLookAheadTime = seconds; }
+        /** Get how many seconds ahead strategies predict the camera position. */
+        Real getPageLoadLookAheadTime() const { return mPageLoadLookAheadTime; }
+
+        /** Set the time in milliseconds to spend each frame on loading prepared 
+            pages in the main thread, 0 (the default) for no limit.
+        @remarks
+            By default, a page which has been prepared in the background is
+            loaded in full as soon as it is ready. When a budget is set, the
+            loading is split into steps (the procedural load, then each step of
+            each PageContentCollection, see PageContentCollection::loadStep), 
+            which are performed at the start of each frame until the budget is
+            used. At least one step is performed each frame.
+        */
+        void setPageLoadBudget(Real ms) { mPageLoadBudget = ms; }
+        /** Get the time in milliseconds to spend each frame on loading pages. */
+        Real getPageLoadBudget() const { return mPageLoadBudget; }
+
+        /// Queue a page whose loading steps are to be performed within the budget
+        void _queuePageLoadSteps(Page* page);
+        /// Remove a page from the queue of loading steps
+        void _cancelPageLoadSteps(Page* page);
+        /// Perform queued loading steps until the budget is used
+        void _processPageLoadSteps();
+
 
     protected:
 
@@ -466,9 +505,15 @@ namespace Ogre
         EventRouter mEventRouter;
         uint8 mDebugDisplayLvl;
         bool mPagingEnabled;
+        size_t mMaxConcurrentPageLoads;
+        Real mPageLoadLookAheadTime;
+        Real mPageLoadBudget;
+        typedef list<Page*>::type PageList;
+        PageList mPageLoadQueue;
 
         Grid2DPageStrategy* mGrid2DPageStrategy;
         Grid3DPageStrategy* mGrid3DPageStrategy;
+        QuadTreePageStrategy* mQuadTreePageStrategy;
         SimplePageContentCollectionFactory* mSimpleCollectionFactory;
     };
 
@@ -129,6 +129,13 @@ namespace Ogre
         @return The page ID
         */
         virtual PageID getPageID(const Vector3& worldPos, PagedWorldSection* section) = 0;
+
+        /** Get the level of detail of a page, for hierarchical strategies.
+        @remarks
+            0 is the coarsest level. Strategies with a single level of pages, 
+            such as the grid strategies, always return 0.
+        */
+        virtual uint16 getPageLevel(PageID pageID, PagedWorldSection* section) { return 0; }
     };
 
     /*@}*/
@@ -241,6 +241,9 @@ namespace Ogre
         */
         virtual void holdPage(PageID pageID);
 
+        /** Get the number of pages of this section being prepared in the background. */
+        virtual size_t getNumPagesLoading() const;
+
         /** Retrieves a Page.
         @remarks
             This method will only return Page instances that are already loaded. It
@@ -39,6 +39,7 @@ THE SOFTWARE.
 #include "OgrePagedWorldSection.h"
 #include "OgrePageManager.h"
 #include "OgrePageStrategy.h"
+#include "OgreQuadTreePageStrategy.h"
 #include "OgreSimplePageContentCollection.h"
 
 
@@ -36,6 +36,7 @@ namespace Ogre
     // forward decls
     class Grid2DPageStrategy;
     class Grid3DPageStrategy;
+    class QuadTreePageStrategy;
     class Page;
     class PageConnection;
     class PageContent;
@@ -0,0 +1,237 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __Ogre_QuadTreePageStrategy_H__
+#define __Ogre_QuadTreePageStrategy_H__
+
+#include "OgrePagingPrerequisites.h"
+#include "OgrePageStrategy.h"
+#include "OgreGrid2DPageStrategy.h"
+#include "OgreVector2.h"
+#include "OgreVector3.h"
+
+namespace Ogre
+{
+    /** \addtogroup Optional
+    *  @{
+    */
+    /** \addtogroup Paging
+    *  Some details on paging component
+    *  @{
+    */
+
+
+    /** Specialisation of PageStrategyData for QuadTreePageStrategy.
+    @remarks
+        The data defines a square root region, centred on the origin, which is
+        recursively divided into 4 child pages down to a maximum depth. A page
+        at level L covers RootSize / 2^L on each side and is addressed by its
+        level and its column and row within that level, both from 0 at the 
+        bottom-left. Pages closer to the camera than SplitFactor times their 
+        own size are replaced by their children, so the whole root region is 
+        always covered, with finer pages near the camera and a few coarse pages
+        far away.
+    @par
+        The data format for this in a file is:<br/>
+        <b>QuadTreePageStrategyData (Identifier 'QTDD')</b>\n
+        [Version 1]
+        <table>
+        <tr>
+            <td><b>Name</b></td>
+            <td><b>Type</b></td>
+            <td><b>Description</b></td>
+        </tr>
+        <tr>
+            <td>Grid orientation</td>
+            <td>uint8</td>
+            <td>The orientation of the grid; XZ = 0, XY = 1, YZ = 2</td>
+        </tr>
+        <tr>
+            <td>Grid origin</td>
+            <td>Vector3</td>
+            <td>World origin of the root page.</td>
+        </tr>
+        <tr>
+            <td>Root size</td>
+            <td>Real</td>
+            <td>The size of the root page</td>
+        </tr>
+        <tr>
+            <td>Maximum depth</td>
+            <td>uint16</td>
+            <td>The deepest level of pages</td>
+        </tr>
+        <tr>
+            <td>Split factor</td>
+            <td>Real</td>
+            <td>Distance at which a page is refined, relative to its size</td>
+        </tr>
+        <tr>
+            <td>Hold factor</td>
+            <td>Real</td>
+            <td>Distance at which the children of a page are held if already
+                loaded, relative to its size (should be larger than Split factor)</td>
+        </tr>
+        </table>
+    */
+    class _OgrePagingExport QuadTreePageStrategyData : public PageStrategyData
+    {
+    protected:
+        /// Orientation of the grid
+        Grid2DMode mMode;
+        /// Origin (world space)
+        Vector3 mWorldOrigin;
+        /// Origin (grid-aligned world space)
+        Vector2 mOrigin;
+        /// Size of the root page
+        Real mRootSize;
+        /// Deepest level
+        uint16 mMaxDepth;
+        /// Refine distance relative to page size
+        Real mSplitFactor;
+        /// Hold distance relative to page size
+        Real mHoldFactor;
+
+    public:
+        static const uint32 CHUNK_ID;
+        static const uint16 CHUNK_VERSION;
+        /// The deepest level which can be addressed by a PageID
+        static const uint16 MAX_DEPTH;
+
+        QuadTreePageStrategyData();
+        ~QuadTreePageStrategyData();
+
+        /// Set the grid alignment mode
+        virtual void setMode(Grid2DMode mode);
+        /// Get the grid alignment mode
+        virtual Grid2DMode getMode() const { return mMode; }
+        /// Set the origin (the centre of the root page) in world space
+        virtual void setOrigin(const Vector3& worldOrigin);
+        /// Get the origin in world space
+        virtual const Vector3& getOrigin() const { return mWorldOrigin; }
+        /// Set the size of the root page
+        virtual void setRootSize(Real sz);
+        /// Get the size of the root page
+        virtual Real getRootSize() const { return mRootSize; }
+        /// Set the deepest level of pages, at most MAX_DEPTH
+        virtual void setMaxDepth(uint16 depth);
+        /// Get the deepest level of pages
+        virtual uint16 getMaxDepth() const { return mMaxDepth; }
+        /** Set the distance from the camera, relative to the size of a page, 
+            under which the page is replaced by its 4 children (default 2). */
+        virtual void setSplitFactor(Real f);
+        /// Get the distance relative to page size under which a page is refined
+        virtual Real getSplitFactor() const { return mSplitFactor; }
+        /** Set the distance from the camera, relative to the size of a page,
+            under which the children of a page are held if they are already
+            loaded (default 3). */
+        virtual void setHoldFactor(Real f);
+        /// Get the distance relative to page size under which children are held
+        virtual Real getHoldFactor() const { return mHoldFactor; }
+
+        /// Convert a world point to grid space (not relative to origin)
+        virtual void convertWorldToGridSpace(const Vector3& world, Vector2& grid);
+        /// Convert a grid point to world space - note only 2 axes populated
+        virtual void convertGridToWorldSpace(const Vector2& grid, Vector3& world);
+
+        /// Get the size of the pages at a level
+        Real getPageSize(uint16 level) const;
+        /// Get the (grid space) bottom-left of a page
+        virtual void getBottomLeftGridSpace(uint16 level, int32 x, int32 y, Vector2& bl);
+        /// Get the (grid space) mid point of a page
+        virtual void getMidPointGridSpace(uint16 level, int32 x, int32 y, Vector2& mid);
+        /** Get the (grid space) corners of a page.
+        @remarks
+            Populates pFourPoints in anticlockwise order from the bottom left point.
+        */
+        virtual void getCornersGridSpace(uint16 level, int32 x, int32 y, Vector2* pFourPoints);
+        /// Get the (grid space) distance from a point to a page, 0 if inside
+        Real getDistanceGridSpace(const Vector2& gridpos, uint16 level, int32 x, int32 y);
+        /// Get the page at a level which contains a grid position
+        void determineGridLocation(const Vector2& gridpos, uint16 level, int32* x, int32* y);
+
+        /// Load this data from a stream (returns true if successful)
+        bool load(StreamSerialiser& stream);
+        /// Save this data to a stream
+        void save(StreamSerialiser& stream);
+
+        PageID calculatePageID(uint16 level, int32 x, int32 y);
+        void calculateCell(PageID inPageID, uint16* level, int32* x, int32* y);
+    };
+
+
+    /** Page strategy which loads pages from a quadtree, refining them near 
+        the camera.
+    @remarks
+        Unlike Grid2DPageStrategy, the number of pages loaded depends on the 
+        maximum depth rather than the extent of the world: distant regions are
+        covered by a few coarse pages, which are refined into child pages as 
+        the camera approaches. A coarse page stays loaded until all its children
+        have finished loading, and children stay loaded until their parent has
+        finished loading, so there are no holes while the tree changes. Page 
+        content can use Page::getLevel to load content suited to the level.
+    @par
+        PageIDs are generated like this: (level << 28) | (row << 14) | col. 
+        PageManager::setMaxConcurrentPageLoads is respected.
+    */
+    class _OgrePagingExport QuadTreePageStrategy : public PageStrategy
+    {
+    public:
+        QuadTreePageStrategy(PageManager* manager);
+
+        ~QuadTreePageStrategy();
+
+        // Overridden members
+        void notifyCamera(Camera* cam, PagedWorldSection* section);
+        PageStrategyData* createData();
+        void destroyData(PageStrategyData* d);
+        void updateDebugDisplay(Page* p, SceneNode* sn);
+        PageID getPageID(const Vector3& worldPos, PagedWorldSection* section);
+        uint16 getPageLevel(PageID pageID, PagedWorldSection* section);
+
+    protected:
+        /// Number of new page loads which may still be issued this update
+        size_t mLoadsAllowed;
+
+        /** Load or hold a page and its refined children.
+        @return Whether the area of the page is covered by loaded pages
+        */
+        bool processPage(PagedWorldSection* section, QuadTreePageStrategyData* data,
+            const Vector2& gridpos, uint16 level, int32 x, int32 y);
+        /// Hold any loaded pages below a page
+        void holdChildren(PagedWorldSection* section, QuadTreePageStrategyData* data,
+            const Vector2& gridpos, uint16 level, int32 x, int32 y);
+        /// Whether a page has finished loading
+        bool isPageReady(PagedWorldSection* section, PageID pageID);
+    };
+
+    /*@}*/
+    /*@}*/
+}
+
+#endif
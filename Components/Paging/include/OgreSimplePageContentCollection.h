@@ -96,6 +96,8 @@ namespace Ogre
         virtual void notifyCamera(Camera* cam);
         bool prepare(StreamSerialiser& stream);
         void load();
+        size_t getNumLoadSteps() const { return mContentList.size(); }
+        void loadStep(size_t step);
         void unload();
         void unprepare();
 
@@ -36,6 +36,8 @@ THE SOFTWARE.
 #include "OgreManualObject.h"
 #include "OgrePageManager.h"
 #include "OgreTechnique.h"
+#include "OgreRoot.h"
+#include "OgreTimer.h"
 
 namespace Ogre
 {
@@ -60,6 +62,30 @@ namespace Ogre
         
     }
     //---------------------------------------------------------------------
+    Vector2 Grid2DPageStrategyData::_updateCameraVelocity(const Camera* cam, const Vector2& gridpos)
+    {
+        unsigned long now = Root::getSingleton().getTimer()->getMilliseconds();
+        CameraMotionMap::iterator i = mCameraMotion.find(cam);
+        if (i == mCameraMotion.end())
+        {
+            CameraMotion motion;
+            motion.lastPos = gridpos;
+            motion.lastTime = now;
+            motion.velocity = Vector2::ZERO;
+            mCameraMotion[cam] = motion;
+            return Vector2::ZERO;
+        }
+
+        CameraMotion& motion = i->second;
+        if (now > motion.lastTime)
+        {
+            motion.velocity = (gridpos - motion.lastPos) * (1000.0f / (Real)(now - motion.lastTime));
+            motion.lastPos = gridpos;
+            motion.lastTime = now;
+        }
+        return motion.velocity;
+    }
+    //---------------------------------------------------------------------
     void Grid2DPageStrategyData::setCellRange(int32 minX, int32 minY, int32 maxX, int32 maxY)
     {
         mMinCellX = minX;
@@ -300,13 +326,23 @@ namespace Ogre
         int32 x, y;
         stratData->determineGridLocation(gridpos, &x, &y);
 
+        // where the camera is heading
+        Vector2 velocity = stratData->_updateCameraVelocity(cam, gridpos);
+        Vector2 predictedPos = gridpos + velocity * mManager->getPageLoadLookAheadTime();
+        int32 px, py;
+        stratData->determineGridLocation(predictedPos, &px, &py);
+        Vector2 lookDir;
+        stratData->convertWorldToGridSpace(pos + cam->getDerivedDirection(), lookDir);
+        lookDir -= gridpos;
+        lookDir.normalise();
+
         Real loadRadius = stratData->getLoadRadiusInCells();
         Real holdRadius = stratData->getHoldRadiusInCells();
         // scan the whole Hold range
-        Real fxmin = (Real)x - holdRadius;
-        Real fxmax = (Real)x + holdRadius;
-        Real fymin = (Real)y - holdRadius;
-        Real fymax = (Real)y + holdRadius;
+        Real fxmin = (Real)std::min(x, px) - holdRadius;
+        Real fxmax = (Real)std::max(x, px) + holdRadius;
+        Real fymin = (Real)std::min(y, py) - holdRadius;
+        Real fymax = (Real)std::max(y, py) + holdRadius;
 
         int32 xmin = stratData->getCellRangeMinX();
         int32 xmax = stratData->getCellRangeMaxX();
@@ -318,23 +354,33 @@ namespace Ogre
         xmax = fxmax > xmax ? xmax : (int32)ceil(fxmax);
         ymin = fymin < ymin ? ymin : (int32)floor(fymin);
         ymax = fymax > ymax ? ymax : (int32)ceil(fymax);
-        // the inner, active load range
-        fxmin = (Real)x - loadRadius;
-        fxmax = (Real)x + loadRadius;
-        fymin = (Real)y - loadRadius;
-        fymax = (Real)y + loadRadius;
-        // Round UP max, round DOWN min
-        int32 loadxmin = fxmin < xmin ? xmin : (int32)floor(fxmin);
-        int32 loadxmax = fxmax > xmax ? xmax : (int32)ceil(fxmax);
-        int32 loadymin = fymin < ymin ? ymin : (int32)floor(fymin);
-        int32 loadymax = fymax > ymax ? ymax : (int32)ceil(fymax);
+        // the inner, active load range, around both the current and predicted cells
+        int32 loadRadiusCells = (int32)ceil(loadRadius);
 
+        typedef std::pair<Real, PageID> PendingPage;
+        vector<PendingPage>::type pending;
+        Real cellSize = stratData->getCellSize();
         for (int32 cy = ymin; cy <= ymax; ++cy)
         {
             for (int32 cx = xmin; cx <= xmax; ++cx)
             {
                 PageID pageID = stratData->calculatePageID(cx, cy);
-                if (cx >= loadxmin && cx <= loadxmax && cy >= loadymin && cy <= loadymax)
+                bool inLoadRange = 
+                    (std::abs(cx - x) <= loadRadiusCells && std::abs(cy - y) <= loadRadiusCells) ||
+                    (std::abs(cx - px) <= loadRadiusCells && std::abs(cy - py) <= loadRadiusCells);
+                if (inLoadRange && !section->getPage(pageID))
+                {
+                    // in the 'load' range but not requested yet, rank it by 
+                    // the time until the camera gets there, favouring what's in view
+                    Vector2 mid;
+                    stratData->getMidPointGridSpace(cx, cy, mid);
+                    Vector2 toCell = mid - gridpos;
+                    Real dist = toCell.normalise();
+                    Real closingSpeed = std::max(velocity.dotProduct(toCell), (Real)0);
+                    Real facing = 1.5f - 0.5f * lookDir.dotProduct(toCell);
+                    pending.push_back(PendingPage(facing * dist / (closingSpeed + cellSize), pageID));
+                }
+                else if (inLoadRange)
                 {
                     // in the 'load' range, request it
                     section->loadPage(pageID);
@@ -348,6 +394,17 @@ namespace Ogre
             }
         }   
         
+        std::sort(pending.begin(), pending.end());
+        size_t maxLoads = mManager->getMaxConcurrentPageLoads();
+        size_t loading = maxLoads ? section->getNumPagesLoading() : 0;
+        for (vector<PendingPage>::type::iterator i = pending.begin(); i != pending.end(); ++i)
+        {
+            // the rest are requested again in later frames
+            if (maxLoads && loading >= maxLoads)
+                break;
+            section->loadPage(i->second);
+            ++loading;
+        }
 
 
     }
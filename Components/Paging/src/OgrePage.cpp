@@ -56,7 +56,11 @@ namespace Ogre
     Page::Page(PageID pageID, PagedWorldSection* parent)
         : mID(pageID)
         , mParent(parent)
+        , mLoadRequestID(0)
         , mDeferredProcessInProgress(false)
+        , mLoadStepsPending(false)
+        , mLoadCollection(-1)
+        , mLoadCollectionStep(0)
         , mModified(false)
         , mDebugNode(0)
     {
@@ -70,6 +74,11 @@ namespace Ogre
     Page::~Page()
     {
         WorkQueue* wq = Root::getSingleton().getWorkQueue();
+        // don't spend time preparing a page nobody wants any more
+        if (mDeferredProcessInProgress)
+            wq->abortRequest(mLoadRequestID);
+        if (mLoadStepsPending)
+            getManager()->_cancelPageLoadSteps(this);
         wq->removeRequestHandler(mWorkQueueChannel, this);
         wq->removeResponseHandler(mWorkQueueChannel, this);
 
@@ -102,6 +111,11 @@ namespace Ogre
         return mParent->getManager();
     }
     //---------------------------------------------------------------------
+    uint16 Page::getLevel() const
+    {
+        return mParent->getStrategy()->getPageLevel(mID, mParent);
+    }
+    //---------------------------------------------------------------------
     void Page::touch()
     {
         mFrameLastHeld = Root::getSingleton().getNextFrameNumber();
@@ -185,17 +199,27 @@ namespace Ogre
     {
         if (!mDeferredProcessInProgress)
         {
+            if (mLoadStepsPending)
+            {
+                getManager()->_cancelPageLoadSteps(this);
+                mLoadStepsPending = false;
+            }
             destroyAllContentCollections();
             PageRequest req(this);
             mDeferredProcessInProgress = true;
-            Root::getSingleton().getWorkQueue()->addRequest(mWorkQueueChannel, WORKQUEUE_PREPARE_REQUEST, 
-                Any(req), 0, synchronous);
+            mLoadRequestID = Root::getSingleton().getWorkQueue()->addRequest(mWorkQueueChannel, 
+                WORKQUEUE_PREPARE_REQUEST, Any(req), 0, synchronous);
         }
 
     }
     //---------------------------------------------------------------------
     void Page::unload()
     {
+        if (mLoadStepsPending)
+        {
+            getManager()->_cancelPageLoadSteps(this);
+            mLoadStepsPending = false;
+        }
         destroyAllContentCollections();
     }
     //---------------------------------------------------------------------
@@ -266,7 +290,16 @@ namespace Ogre
             if(!pres.pageData->collectionsToAdd.empty())
                 std::swap(mContentCollections, pres.pageData->collectionsToAdd);
 
-            loadImpl();
+            if (getManager()->getPageLoadBudget() > 0 && !res->getRequest()->getAborted())
+            {
+                // spread over the next frames
+                mLoadCollection = -1;
+                mLoadCollectionStep = 0;
+                mLoadStepsPending = true;
+                getManager()->_queuePageLoadSteps(this);
+            }
+            else
+                loadImpl();
         }
 
         OGRE_DELETE pres.pageData;
@@ -305,6 +338,30 @@ namespace Ogre
         }
     }
     //---------------------------------------------------------------------
+    bool Page::_loadNextStep()
+    {
+        if (mLoadCollection < 0)
+        {
+            mParent->_loadProceduralPage(this);
+            mLoadCollection = 0;
+            mLoadCollectionStep = 0;
+        }
+        else if ((size_t)mLoadCollection < mContentCollections.size())
+        {
+            PageContentCollection* coll = mContentCollections[mLoadCollection];
+            if (mLoadCollectionStep < coll->getNumLoadSteps())
+                coll->loadStep(mLoadCollectionStep++);
+            if (mLoadCollectionStep >= coll->getNumLoadSteps())
+            {
+                ++mLoadCollection;
+                mLoadCollectionStep = 0;
+            }
+        }
+
+        mLoadStepsPending = (size_t)mLoadCollection < mContentCollections.size();
+        return !mLoadStepsPending;
+    }
+    //---------------------------------------------------------------------
     void Page::save()
     {
         String filename = generateFilename();
@@ -66,6 +66,11 @@ namespace Ogre
     {
         return mParent->getSceneManager();
     }   
+    //---------------------------------------------------------------------
+    uint16 PageContentCollection::getLevel() const
+    {
+        return mParent->getLevel();
+    }
 
 
 }
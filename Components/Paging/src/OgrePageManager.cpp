@@ -34,10 +34,13 @@ THE SOFTWARE.
 #include "OgrePagedWorld.h"
 #include "OgreGrid2DPageStrategy.h"
 #include "OgreGrid3DPageStrategy.h"
+#include "OgreQuadTreePageStrategy.h"
 #include "OgreSimplePageContentCollection.h"
 #include "OgreStreamSerialiser.h"
 #include "OgreRoot.h"
 #include "OgrePageContent.h"
+#include "OgrePage.h"
+#include "OgreTimer.h"
 
 namespace Ogre
 {
@@ -48,8 +51,12 @@ namespace Ogre
         , mPageResourceGroup(ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME)
         , mDebugDisplayLvl(0)
         , mPagingEnabled(true)
+        , mMaxConcurrentPageLoads(0)
+        , mPageLoadLookAheadTime(0)
+        , mPageLoadBudget(0)
         , mGrid2DPageStrategy(0)
         , mGrid3DPageStrategy(0)
+        , mQuadTreePageStrategy(0)
         , mSimpleCollectionFactory(0)
     {
 
@@ -68,6 +75,7 @@ namespace Ogre
     {
         Root::getSingleton().removeFrameListener(&mEventRouter);
 
+        OGRE_DELETE mQuadTreePageStrategy;
         OGRE_DELETE mGrid3DPageStrategy;
         OGRE_DELETE mGrid2DPageStrategy;
         OGRE_DELETE mSimpleCollectionFactory;
@@ -80,6 +88,9 @@ namespace Ogre
 
         mGrid3DPageStrategy = OGRE_NEW Grid3DPageStrategy(this);
         addStrategy(mGrid3DPageStrategy);
+
+        mQuadTreePageStrategy = OGRE_NEW QuadTreePageStrategy(this);
+        addStrategy(mQuadTreePageStrategy);
     }
     //---------------------------------------------------------------------
     void PageManager::createStandardContentFactories()
@@ -510,11 +521,39 @@ namespace Ogre
         pManager->removeCamera(cam);
     }
     //---------------------------------------------------------------------
+    void PageManager::_queuePageLoadSteps(Page* page)
+    {
+        mPageLoadQueue.push_back(page);
+    }
+    //---------------------------------------------------------------------
+    void PageManager::_cancelPageLoadSteps(Page* page)
+    {
+        mPageLoadQueue.remove(page);
+    }
+    //---------------------------------------------------------------------
+    void PageManager::_processPageLoadSteps()
+    {
+        if (mPageLoadQueue.empty())
+            return;
+
+        Timer* timer = Root::getSingleton().getTimer();
+        unsigned long start = timer->getMicroseconds();
+        do
+        {
+            if (mPageLoadQueue.front()->_loadNextStep())
+                mPageLoadQueue.pop_front();
+        }
+        while (!mPageLoadQueue.empty() && 
+            (timer->getMicroseconds() - start) < mPageLoadBudget * 1000);
+    }
+    //---------------------------------------------------------------------
     bool PageManager::EventRouter::frameStarted(const FrameEvent& evt)
     {
         if(pWorldMap->empty())
             return true;
 
+        pManager->_processPageLoadSteps();
+
         for(WorldMap::iterator i = pWorldMap->begin(); i != pWorldMap->end(); ++i)
         {
             i->second->frameStart(evt.timeSinceLastFrame);
@@ -298,6 +298,17 @@ namespace Ogre
             i->second->touch();
     }
     //---------------------------------------------------------------------
+    size_t PagedWorldSection::getNumPagesLoading() const
+    {
+        size_t count = 0;
+        for (PageMap::const_iterator i = mPages.begin(); i != mPages.end(); ++i)
+        {
+            if (i->second->isDeferredProcessInProgress())
+                ++count;
+        }
+        return count;
+    }
+    //---------------------------------------------------------------------
     Page* PagedWorldSection::getPage(PageID pageID)
     {
         PageMap::iterator i = mPages.find(pageID);
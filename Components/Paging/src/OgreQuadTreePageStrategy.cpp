@@ -0,0 +1,444 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreQuadTreePageStrategy.h"
+#include "OgreStreamSerialiser.h"
+#include "OgreCamera.h"
+#include "OgrePagedWorldSection.h"
+#include "OgrePage.h"
+#include "OgreSceneNode.h"
+#include "OgreSceneManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreManualObject.h"
+#include "OgrePageManager.h"
+#include "OgreTechnique.h"
+
+namespace Ogre
+{
+    //---------------------------------------------------------------------
+    const uint32 QuadTreePageStrategyData::CHUNK_ID = StreamSerialiser::makeIdentifier("QTDD");
+    const uint16 QuadTreePageStrategyData::CHUNK_VERSION = 1;
+    const uint16 QuadTreePageStrategyData::MAX_DEPTH = 14;
+    //---------------------------------------------------------------------
+    QuadTreePageStrategyData::QuadTreePageStrategyData()
+        : PageStrategyData()
+        , mMode(G2D_X_Z)
+        , mWorldOrigin(Vector3::ZERO)
+        , mOrigin(Vector2::ZERO)
+        , mRootSize(65536)
+        , mMaxDepth(6)
+        , mSplitFactor(2)
+        , mHoldFactor(3)
+    {
+    }
+    //---------------------------------------------------------------------
+    QuadTreePageStrategyData::~QuadTreePageStrategyData()
+    {
+    }
+    //---------------------------------------------------------------------
+    void QuadTreePageStrategyData::setMode(Grid2DMode mode)
+    {
+        mMode = mode;
+        // reset origin
+        setOrigin(mWorldOrigin);
+    }
+    //---------------------------------------------------------------------
+    void QuadTreePageStrategyData::setOrigin(const Vector3& origin)
+    {
+        mWorldOrigin = origin;
+        convertWorldToGridSpace(mWorldOrigin, mOrigin);
+    }
+    //---------------------------------------------------------------------
+    void QuadTreePageStrategyData::setRootSize(Real sz)
+    {
+        mRootSize = sz;
+    }
+    //---------------------------------------------------------------------
+    void QuadTreePageStrategyData::setMaxDepth(uint16 depth)
+    {
+        mMaxDepth = std::min(depth, MAX_DEPTH);
+    }
+    //---------------------------------------------------------------------
+    void QuadTreePageStrategyData::setSplitFactor(Real f)
+    {
+        mSplitFactor = f;
+    }
+    //---------------------------------------------------------------------
+    void QuadTreePageStrategyData::setHoldFactor(Real f)
+    {
+        mHoldFactor = f;
+    }
+    //---------------------------------------------------------------------
+    void QuadTreePageStrategyData::convertWorldToGridSpace(const Vector3& world, Vector2& grid)
+    {
+        switch(mMode)
+        {
+        case G2D_X_Z:
+            grid.x = world.x;
+            grid.y = -world.z;
+            break;
+        case G2D_X_Y:
+            grid.x = world.x;
+            grid.y = world.y;
+            break;
+        case G2D_Y_Z:
+            grid.x = -world.z;
+            grid.y = world.y;
+            break;
+        }
+    }
+    //---------------------------------------------------------------------
+    void QuadTreePageStrategyData::convertGridToWorldSpace(const Vector2& grid, Vector3& world)
+    {
+        // Note that we don't set the 3rd coordinate, let the caller determine that
+        switch(mMode)
+        {
+        case G2D_X_Z:
+            world.x = grid.x;
+            world.z = -grid.y;
+            break;
+        case G2D_X_Y:
+            world.x = grid.x;
+            world.y = grid.y;
+            break;
+        case G2D_Y_Z:
+            world.z = -grid.x;
+            world.y = grid.y;
+            break;
+        }
+    }
+    //---------------------------------------------------------------------
+    Real QuadTreePageStrategyData::getPageSize(uint16 level) const
+    {
+        return mRootSize / (Real)(1 << level);
+    }
+    //---------------------------------------------------------------------
+    void QuadTreePageStrategyData::getBottomLeftGridSpace(uint16 level, int32 x, int32 y, Vector2& bl)
+    {
+        Real size = getPageSize(level);
+        bl.x = mOrigin.x - mRootSize * 0.5f + x * size;
+        bl.y = mOrigin.y - mRootSize * 0.5f + y * size;
+    }
+    //---------------------------------------------------------------------
+    void QuadTreePageStrategyData::getMidPointGridSpace(uint16 level, int32 x, int32 y, Vector2& mid)
+    {
+        getBottomLeftGridSpace(level, x, y, mid);
+        Real halfSize = getPageSize(level) * 0.5f;
+        mid.x += halfSize;
+        mid.y += halfSize;
+    }
+    //---------------------------------------------------------------------
+    void QuadTreePageStrategyData::getCornersGridSpace(uint16 level, int32 x, int32 y, Vector2* pFourPoints)
+    {
+        Real size = getPageSize(level);
+        getBottomLeftGridSpace(level, x, y, pFourPoints[0]);
+        pFourPoints[1] = pFourPoints[0] + Vector2(size, 0);
+        pFourPoints[2] = pFourPoints[0] + Vector2(size, size);
+        pFourPoints[3] = pFourPoints[0] + Vector2(0, size);
+    }
+    //---------------------------------------------------------------------
+    Real QuadTreePageStrategyData::getDistanceGridSpace(const Vector2& gridpos, uint16 level, int32 x, int32 y)
+    {
+        Real size = getPageSize(level);
+        Vector2 bl;
+        getBottomLeftGridSpace(level, x, y, bl);
+        Real dx = std::max(std::max(bl.x - gridpos.x, gridpos.x - (bl.x + size)), (Real)0);
+        Real dy = std::max(std::max(bl.y - gridpos.y, gridpos.y - (bl.y + size)), (Real)0);
+        return Math::Sqrt(dx * dx + dy * dy);
+    }
+    //---------------------------------------------------------------------
+    void QuadTreePageStrategyData::determineGridLocation(const Vector2& gridpos, uint16 level, int32* x, int32* y)
+    {
+        Real size = getPageSize(level);
+        int32 maxCell = (1 << level) - 1;
+        Vector2 relPos = gridpos - mOrigin + Vector2(mRootSize * 0.5f, mRootSize * 0.5f);
+
+        *x = Math::Clamp(static_cast<int32>(floor(relPos.x / size)), (int32)0, maxCell);
+        *y = Math::Clamp(static_cast<int32>(floor(relPos.y / size)), (int32)0, maxCell);
+    }
+    //---------------------------------------------------------------------
+    PageID QuadTreePageStrategyData::calculatePageID(uint16 level, int32 x, int32 y)
+    {
+        // level in the top 4 bits, 14 bits each for row and column
+        uint32 key = level & 15;
+        key = (key << 14) | (y & 16383);
+        key = (key << 14) | (x & 16383);
+        return (PageID)key;
+    }
+    //---------------------------------------------------------------------
+    void QuadTreePageStrategyData::calculateCell(PageID inPageID, uint16* level, int32* x, int32* y)
+    {
+        *x = inPageID & 16383; inPageID >>= 14;
+        *y = inPageID & 16383; inPageID >>= 14;
+        *level = static_cast<uint16>(inPageID & 15);
+    }
+    //---------------------------------------------------------------------
+    bool QuadTreePageStrategyData::load(StreamSerialiser& ser)
+    {
+        if (!ser.readChunkBegin(CHUNK_ID, CHUNK_VERSION, "QuadTreePageStrategyData"))
+            return false;
+
+        uint8 readMode;
+        ser.read(&readMode);
+        mMode = (Grid2DMode)readMode;
+
+        Vector3 origin;
+        ser.read(&origin);
+        setOrigin(origin);
+
+        ser.read(&mRootSize);
+        ser.read(&mMaxDepth);
+        ser.read(&mSplitFactor);
+        ser.read(&mHoldFactor);
+
+        ser.readChunkEnd(CHUNK_ID);
+
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void QuadTreePageStrategyData::save(StreamSerialiser& ser)
+    {
+        ser.writeChunkBegin(CHUNK_ID, CHUNK_VERSION);
+
+        uint8 readMode = (uint8)mMode;
+        ser.write(&readMode);
+
+        ser.write(&mWorldOrigin);
+        ser.write(&mRootSize);
+        ser.write(&mMaxDepth);
+        ser.write(&mSplitFactor);
+        ser.write(&mHoldFactor);
+
+        ser.writeChunkEnd(CHUNK_ID);
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    QuadTreePageStrategy::QuadTreePageStrategy(PageManager* manager)
+        : PageStrategy("QuadTree", manager)
+        , mLoadsAllowed(0)
+    {
+
+    }
+    //---------------------------------------------------------------------
+    QuadTreePageStrategy::~QuadTreePageStrategy()
+    {
+
+    }
+    //---------------------------------------------------------------------
+    void QuadTreePageStrategy::notifyCamera(Camera* cam, PagedWorldSection* section)
+    {
+        QuadTreePageStrategyData* stratData = static_cast<QuadTreePageStrategyData*>(section->getStrategyData());
+
+        const Vector3& pos = cam->getDerivedPosition();
+        Vector2 gridpos;
+        stratData->convertWorldToGridSpace(pos, gridpos);
+
+        mLoadsAllowed = std::numeric_limits<size_t>::max();
+        size_t maxLoads = mManager->getMaxConcurrentPageLoads();
+        if (maxLoads)
+        {
+            size_t loading = section->getNumPagesLoading();
+            mLoadsAllowed = maxLoads > loading ? maxLoads - loading : 0;
+        }
+
+        processPage(section, stratData, gridpos, 0, 0, 0);
+        // other pages will by inference be marked for unloading
+    }
+    //---------------------------------------------------------------------
+    bool QuadTreePageStrategy::processPage(PagedWorldSection* section, QuadTreePageStrategyData* data,
+        const Vector2& gridpos, uint16 level, int32 x, int32 y)
+    {
+        PageID pageID = data->calculatePageID(level, x, y);
+        Real size = data->getPageSize(level);
+        Real dist = data->getDistanceGridSpace(gridpos, level, x, y);
+
+        if (level < data->getMaxDepth() && dist < size * data->getSplitFactor())
+        {
+            // refine, nearest children first so they get the loads available
+            std::pair<Real, int> children[4];
+            for (int c = 0; c < 4; ++c)
+            {
+                children[c].first = data->getDistanceGridSpace(gridpos, level + 1,
+                    x * 2 + (c & 1), y * 2 + (c >> 1));
+                children[c].second = c;
+            }
+            std::sort(children, children + 4);
+
+            bool childrenReady = true;
+            for (int c = 0; c < 4; ++c)
+            {
+                int child = children[c].second;
+                childrenReady = processPage(section, data, gridpos, level + 1,
+                    x * 2 + (child & 1), y * 2 + (child >> 1)) && childrenReady;
+            }
+            if (childrenReady)
+                return true;
+
+            // keep this page, if we have it, until the children are ready
+            section->holdPage(pageID);
+            return isPageReady(section, pageID);
+        }
+
+        if (section->getPage(pageID))
+            section->loadPage(pageID);
+        else if (mLoadsAllowed)
+        {
+            section->loadPage(pageID);
+            --mLoadsAllowed;
+        }
+
+        bool ready = isPageReady(section, pageID);
+        // keep the children until this page is ready, and for a while longer
+        // to avoid repeatedly refining pages at the boundary
+        if (level < data->getMaxDepth() && (!ready || dist < size * data->getHoldFactor()))
+            holdChildren(section, data, gridpos, level, x, y);
+
+        return ready;
+    }
+    //---------------------------------------------------------------------
+    void QuadTreePageStrategy::holdChildren(PagedWorldSection* section, QuadTreePageStrategyData* data,
+        const Vector2& gridpos, uint16 level, int32 x, int32 y)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            int32 cx = x * 2 + (c & 1);
+            int32 cy = y * 2 + (c >> 1);
+            PageID pageID = data->calculatePageID(level + 1, cx, cy);
+            section->holdPage(pageID);
+
+            if (level + 1 < data->getMaxDepth() && 
+                data->getDistanceGridSpace(gridpos, level + 1, cx, cy) < 
+                    data->getPageSize(level + 1) * data->getHoldFactor())
+                holdChildren(section, data, gridpos, level + 1, cx, cy);
+        }
+    }
+    //---------------------------------------------------------------------
+    bool QuadTreePageStrategy::isPageReady(PagedWorldSection* section, PageID pageID)
+    {
+        Page* p = section->getPage(pageID);
+        return p && !p->isDeferredProcessInProgress() && !p->_isLoadStepsPending();
+    }
+    //---------------------------------------------------------------------
+    PageStrategyData* QuadTreePageStrategy::createData()
+    {
+        return OGRE_NEW QuadTreePageStrategyData();
+    }
+    //---------------------------------------------------------------------
+    void QuadTreePageStrategy::destroyData(PageStrategyData* d)
+    {
+        OGRE_DELETE d;
+    }
+    //---------------------------------------------------------------------
+    void QuadTreePageStrategy::updateDebugDisplay(Page* p, SceneNode* sn)
+    {
+        uint8 dbglvl = mManager->getDebugDisplayLevel();
+        if (dbglvl)
+        {
+            // update every time, as the other strategies do
+            uint16 level;
+            int32 x, y;
+            QuadTreePageStrategyData* data = static_cast<QuadTreePageStrategyData*>(
+                p->getParentSection()->getStrategyData());
+            data->calculateCell(p->getID(), &level, &x, &y);
+
+            Vector2 gridMidPoint;
+            Vector3 worldMidPoint = Vector3::ZERO;
+            data->getMidPointGridSpace(level, x, y, gridMidPoint);
+            data->convertGridToWorldSpace(gridMidPoint, worldMidPoint);
+
+            sn->setPosition(worldMidPoint);
+
+            Vector2 gridCorners[4];
+            Vector3 worldCorners[4];
+
+            data->getCornersGridSpace(level, x, y, gridCorners);
+            for (int i = 0; i < 4; ++i)
+            {
+                worldCorners[i] = Vector3::ZERO;
+                data->convertGridToWorldSpace(gridCorners[i], worldCorners[i]);
+                // make relative to mid point
+                worldCorners[i] -= worldMidPoint;
+            }
+
+            String matName = "Ogre/G2D/Debug";
+            MaterialPtr mat = MaterialManager::getSingleton().getByName(matName);
+            if (mat.isNull())
+            {
+                mat = MaterialManager::getSingleton().create(matName, ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+                Pass* pass = mat->getTechnique(0)->getPass(0);
+                pass->setLightingEnabled(false);
+                pass->setVertexColourTracking(TVC_AMBIENT);
+                pass->setDepthWriteEnabled(false);
+                mat->load();
+            }
+
+            ManualObject* mo = 0;
+            bool update = sn->numAttachedObjects() > 0;
+            if (update)
+            {
+                mo = static_cast<ManualObject*>(sn->getAttachedObject(0));
+                mo->beginUpdate(0);
+            }
+            else
+            {
+                mo = p->getParentSection()->getSceneManager()->createManualObject();
+                mo->begin(matName, RenderOperation::OT_LINE_STRIP);
+            }
+
+            // fade from red at the root to green at the deepest level
+            Real t = data->getMaxDepth() ? (Real)level / data->getMaxDepth() : 1;
+            ColourValue vcol(1 - t, t, 0);
+            for(int i = 0; i < 5; ++i)
+            {
+                mo->position(worldCorners[i%4]);
+                mo->colour(vcol);
+            }
+
+            mo->end();
+
+            if (!update)
+                sn->attachObject(mo);
+        }
+    }
+    //---------------------------------------------------------------------
+    PageID QuadTreePageStrategy::getPageID(const Vector3& worldPos, PagedWorldSection* section)
+    {
+        QuadTreePageStrategyData* stratData = static_cast<QuadTreePageStrategyData*>(section->getStrategyData());
+
+        // the deepest page containing the position
+        Vector2 gridpos;
+        stratData->convertWorldToGridSpace(worldPos, gridpos);
+        int32 x, y;
+        stratData->determineGridLocation(gridpos, stratData->getMaxDepth(), &x, &y);
+        return stratData->calculatePageID(stratData->getMaxDepth(), x, y);
+    }
+    //---------------------------------------------------------------------
+    uint16 QuadTreePageStrategy::getPageLevel(PageID pageID, PagedWorldSection* section)
+    {
+        return static_cast<uint16>(pageID >> 28);
+    }
+}
@@ -116,6 +116,11 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
+    void SimplePageContentCollection::loadStep(size_t step)
+    {
+        mContentList[step]->load();
+    }
+    //---------------------------------------------------------------------
     void SimplePageContentCollection::unload()
     {
         for (ContentList::iterator i = mContentList.begin(); i != mContentList.end(); ++i)
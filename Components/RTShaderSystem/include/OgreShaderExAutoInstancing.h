@@ -0,0 +1,143 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef _ShaderExAutoInstancing_
+#define _ShaderExAutoInstancing_
+
+#include "OgreShaderPrerequisites.h"
+#ifdef RTSHADER_SYSTEM_BUILD_EXT_SHADERS
+#include "OgreShaderSubRenderState.h"
+
+#define SGX_LIB_AUTO_INSTANCING                 "SGXLib_AutoInstancing"
+#define SGX_FUNC_AUTO_INSTANCING                "SGX_AutoInstancing"
+
+namespace Ogre {
+namespace RTShader {
+
+/** \addtogroup Optional
+*  @{
+*/
+/** \addtogroup RTShader
+*  @{
+*/
+
+/** Auto instancing sub render state.
+Applies the per instance world matrix of entities drawn with automatic
+instancing (see SceneManager::setAutoInstancingEnabled), before the
+transform stage. The object space position and normal are replaced by
+world space ones, and the SceneManager sets an identity world matrix, so
+the following stages work unchanged. Add it to the render state of the
+scheme the SceneManager uses for instanced draws.
+Derives from SubRenderState class.
+*/
+class _OgreRTSSExport AutoInstancing : public SubRenderState
+{
+public:
+    /** Class default constructor */
+    AutoInstancing();
+
+    /** 
+    @see SubRenderState::getType.
+    */
+    virtual const String& getType() const;
+
+    /** 
+    @see SubRenderState::getExecutionOrder.
+    */
+    virtual int getExecutionOrder() const;
+
+    /** 
+    @see SubRenderState::copyFrom.
+    */
+    virtual void copyFrom(const SubRenderState& rhs);
+
+    static String Type;
+
+protected:
+    /** 
+    @see SubRenderState::resolveParameters.
+    */
+    virtual bool resolveParameters(ProgramSet* programSet);
+
+    /** 
+    @see SubRenderState::resolveDependencies.
+    */
+    virtual bool resolveDependencies(ProgramSet* programSet);
+
+    /** 
+    @see SubRenderState::addFunctionInvocations.
+    */
+    virtual bool addFunctionInvocations(ProgramSet* programSet);
+
+    /// Vertex shader input position, replaced by the world space position.
+    ParameterPtr mVSInPosition;
+    /// Vertex shader input normal, replaced by the world space normal.
+    ParameterPtr mVSInNormal;
+    /// Vertex shader instance world matrix rows.
+    ParameterPtr mVSInWorldRows[3];
+};
+
+
+/** 
+A factory that enables creation of AutoInstancing instances.
+@remarks Sub class of SubRenderStateFactory
+*/
+class _OgreRTSSExport AutoInstancingFactory : public SubRenderStateFactory
+{
+public:
+
+    /** 
+    @see SubRenderStateFactory::getType.
+    */
+    virtual const String& getType() const;
+
+    /** 
+    @see SubRenderStateFactory::createInstance.
+    */
+    virtual SubRenderState* createInstance(ScriptCompiler* compiler, PropertyAbstractNode* prop, Pass* pass, SGScriptTranslator* translator);
+
+    /** 
+    @see SubRenderStateFactory::writeInstance.
+    */
+    virtual void writeInstance(MaterialSerializer* ser, SubRenderState* subRenderState, Pass* srcPass, Pass* dstPass);
+
+protected:
+
+    /** 
+    @see SubRenderStateFactory::createInstanceImpl.
+    */
+    virtual SubRenderState* createInstanceImpl();
+
+};
+
+/** @} */
+/** @} */
+
+}
+}
+
+#endif
+#endif
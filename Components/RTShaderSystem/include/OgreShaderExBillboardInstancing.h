@@ -0,0 +1,152 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef _ShaderExBillboardInstancing_
+#define _ShaderExBillboardInstancing_
+
+#include "OgreShaderPrerequisites.h"
+#ifdef RTSHADER_SYSTEM_BUILD_EXT_SHADERS
+#include "OgreShaderSubRenderState.h"
+
+#define SGX_LIB_BILLBOARD_INSTANCING            "SGXLib_BillboardInstancing"
+#define SGX_FUNC_BILLBOARD_INSTANCING           "SGX_BillboardInstancing"
+
+namespace Ogre {
+namespace RTShader {
+
+/** \addtogroup Optional
+*  @{
+*/
+/** \addtogroup RTShader
+*  @{
+*/
+
+/** Billboard instancing sub render state.
+Expands the billboards of a BillboardSet with instanced rendering enabled
+(see BillboardSet::setInstancedRenderingEnabled) to quads, before the
+transform stage. The object space position and texture coordinate 0 are
+replaced by those of the billboard corner, so the following stages work
+as they would on CPU generated billboard vertices.
+Derives from SubRenderState class.
+*/
+class _OgreRTSSExport BillboardInstancing : public SubRenderState
+{
+public:
+    /** Class default constructor */
+    BillboardInstancing();
+
+    /** 
+    @see SubRenderState::getType.
+    */
+    virtual const String& getType() const;
+
+    /** 
+    @see SubRenderState::getExecutionOrder.
+    */
+    virtual int getExecutionOrder() const;
+
+    /** 
+    @see SubRenderState::copyFrom.
+    */
+    virtual void copyFrom(const SubRenderState& rhs);
+
+    static String Type;
+
+protected:
+    /** 
+    @see SubRenderState::resolveParameters.
+    */
+    virtual bool resolveParameters(ProgramSet* programSet);
+
+    /** 
+    @see SubRenderState::resolveDependencies.
+    */
+    virtual bool resolveDependencies(ProgramSet* programSet);
+
+    /** 
+    @see SubRenderState::addFunctionInvocations.
+    */
+    virtual bool addFunctionInvocations(ProgramSet* programSet);
+
+    /// Vertex shader input quad corner, replaced by the object space position.
+    ParameterPtr mVSInPosition;
+    /// Vertex shader input quad corner, replaced by the texture coordinates.
+    ParameterPtr mVSInTexcoord;
+    /// Vertex shader instance position and rotation.
+    ParameterPtr mVSInPositionRotation;
+    /// Vertex shader instance dimensions.
+    ParameterPtr mVSInDimensions;
+    /// Vertex shader instance texture rectangle.
+    ParameterPtr mVSInTexcoordRect;
+    /// Vertex shader instance direction.
+    ParameterPtr mVSInDirection;
+    /// Billboard axes and origin offsets, set by the BillboardSet.
+    UniformParameterPtr mAxisX;
+    UniformParameterPtr mAxisY;
+    UniformParameterPtr mOffsets;
+};
+
+
+/** 
+A factory that enables creation of BillboardInstancing instances.
+@remarks Sub class of SubRenderStateFactory
+*/
+class _OgreRTSSExport BillboardInstancingFactory : public SubRenderStateFactory
+{
+public:
+
+    /** 
+    @see SubRenderStateFactory::getType.
+    */
+    virtual const String& getType() const;
+
+    /** 
+    @see SubRenderStateFactory::createInstance.
+    */
+    virtual SubRenderState* createInstance(ScriptCompiler* compiler, PropertyAbstractNode* prop, Pass* pass, SGScriptTranslator* translator);
+
+    /** 
+    @see SubRenderStateFactory::writeInstance.
+    */
+    virtual void writeInstance(MaterialSerializer* ser, SubRenderState* subRenderState, Pass* srcPass, Pass* dstPass);
+
+protected:
+
+    /** 
+    @see SubRenderStateFactory::createInstanceImpl.
+    */
+    virtual SubRenderState* createInstanceImpl();
+
+};
+
+/** @} */
+/** @} */
+
+}
+}
+
+#endif
+#endif
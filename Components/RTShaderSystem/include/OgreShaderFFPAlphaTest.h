@@ -88,6 +88,11 @@ public:
     */
     virtual bool preAddToRenderState (const RenderState* renderState, Pass* srcPass, Pass* dstPass);
 
+    /** 
+    @see SubRenderState::getHash.
+    */
+    virtual bool getHash(uint32& hash) const;
+
     /** 
     @see SubRenderState::copyFrom.
     */
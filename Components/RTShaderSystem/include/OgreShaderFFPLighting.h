@@ -82,6 +82,11 @@ public:
     */
     virtual bool preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass);
 
+    /** 
+    @see SubRenderState::getHash.
+    */
+    virtual bool getHash(uint32& hash) const;
+
 
     static String Type;
 
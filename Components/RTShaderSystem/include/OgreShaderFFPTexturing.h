@@ -83,6 +83,11 @@ public:
     @see SubRenderState::preAddToRenderState.
     */
     virtual bool preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass);
+
+    /** 
+    @see SubRenderState::getHash.
+    */
+    virtual bool getHash(uint32& hash) const;
     
     static void AddTextureSampleWrapperInvocation(UniformParameterPtr textureSampler,UniformParameterPtr textureSamplerState,
         GpuConstantType samplerType, Function* function, int groupOrder, int& internalCounter);
@@ -211,7 +216,7 @@ protected:
     /** 
     Determines if the given texture unit state need to use texture transformation matrix.
     */
-    bool needsTextureMatrix(TextureUnitState* textureUnitState);
+    bool needsTextureMatrix(TextureUnitState* textureUnitState) const;
 
     /** 
     Determines whether a given texture unit needs to be processed by this srs
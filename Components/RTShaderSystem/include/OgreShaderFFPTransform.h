@@ -66,6 +66,11 @@ public:
     */
     virtual void copyFrom(const SubRenderState& rhs);
 
+    /** 
+    @see SubRenderState::getHash.
+    */
+    virtual bool getHash(uint32& hash) const;
+
     /** 
     @see SubRenderState::createCpuSubPrograms.
     */
@@ -188,6 +188,10 @@ public:
     /** 
     Set the output shader cache path. Generated shader code will be written to this path.
     In case of empty cache path shaders will be generated directly from system memory.
+    Programs whose sub render states all provide SubRenderState::getHash are named from that
+    hash, so their files are reused on later runs without writing the source again. Unless
+    GpuProgramManager::setMicrocodeCacheDirectory was called, the compiled programs are
+    kept in this path as well.
     @param cachePath The cache path of the shader.  
     The default is empty cache path.
     */
@@ -487,6 +491,21 @@ public:
     */
     bool getCreateShaderOverProgrammablePass() const { return mCreateShaderOverProgrammablePass; }
 
+    /** Sets whether scheme validation generates the shader source of its passes in parallel.
+    @remarks
+    The CPU programs of each pass are generated and written out as shader source on the
+    WorkQueue threads, while the GPU programs are still created and compiled one by one
+    on the calling thread. All the custom sub render states in use must be able to create
+    their CPU programs from several threads at once, which is why this is off by default.
+    @param value The value to set this attribute.
+    */
+    void setParallelValidation(bool value) { mParallelValidation = value; }
+
+    /** Returns whether scheme validation generates the shader source of its passes in parallel.
+    @see setParallelValidation(). 
+    */
+    bool getParallelValidation() const { return mParallelValidation; }
+
 
     /** Returns the amount of schemes used in the for RT shader generation
     */
@@ -555,6 +574,10 @@ protected:
         /** Acquire the CPU/GPU programs for this pass. */
         void acquirePrograms();
 
+        /** Generate the CPU programs and shader source of this pass ahead of acquirePrograms.
+        Safe to call from a worker thread for different passes, each with its own writer. */
+        bool prepareProgramSources(ProgramWriter* programWriter);
+
         /** Release the CPU/GPU programs of this pass. */
         void releasePrograms();
 
@@ -630,6 +653,9 @@ protected:
         /** Acquire the CPU/GPU programs for this technique. */
         void acquirePrograms();
 
+        /** Append the passes which acquirePrograms builds programs for. */
+        void getPassList(SGPassList& passes);
+
 		/** Build the render state for illumination passes. */
 		void buildIlluminationTargetRenderState();
 
@@ -782,6 +808,12 @@ protected:
         RenderState* getRenderState(const String& materialName, const String& groupName, unsigned short passIndex);
 
     protected:
+        /** Generates the CPU programs and shader source of a range of passes on a worker. */
+        class PassSourceTask;
+
+        /** Write the shader source of the passes to build in parallel, ahead of acquiring their programs. */
+        void prepareProgramSources();
+
         /** Synchronize the current light settings of this scheme with the current settings of the scene. */
         void synchronizeWithLightSettings();
 
@@ -1075,6 +1107,8 @@ protected:
     VSOutputCompactPolicy mVSOutputCompactPolicy;
     // Tells whether shaders are created for passes with shaders
     bool mCreateShaderOverProgrammablePass;
+    // Tells whether scheme validation writes shader source in parallel
+    bool mParallelValidation;
     // A flag to indicate finalizing
     bool mIsFinalizing;
 private:
@@ -68,6 +68,7 @@ class Function;
 class FFPRenderStateBuilder;
 class ShaderGenerator;
 class SGMaterialSerializerListener;
+class ProgramWriter;
 class ProgramWriterFactory;
 class ProgramWriterManager;
 
@@ -98,6 +98,18 @@ public:
     */
     void acquirePrograms(Pass* pass, TargetRenderState* renderState);
 
+    /** Generate the CPU programs of the given render state and write their shader source,
+    ahead of acquirePrograms.
+    @remarks
+    Nothing is created in the render system, so this can be called from worker threads
+    for different render states at the same time, each with its own program writer.
+    acquirePrograms then only creates and compiles the GPU programs.
+    @param renderState The render state that describes the program that need to be generated.
+    @param programWriter The program writer instance to use.
+    @return false if the programs could not be generated; acquirePrograms will try again.
+    */
+    bool prepareProgramSources(TargetRenderState* renderState, ProgramWriter* programWriter);
+
     /** Release CPU/GPU programs set associated with the given render state and pass.
     @param pass The pass to release the programs from.
     @param renderState The render state holds the programs.
@@ -108,6 +120,13 @@ public:
     */
     void flushGpuProgramsCache();
 
+    /** Get the number of GPU programs which were found already created or in the
+    shader cache directory, rather than created from generated source. */
+    size_t getNumCacheHits() const { return mCacheHits; }
+
+    /** Get the number of GPU programs created from generated source. */
+    size_t getNumCacheMisses() const { return mCacheMisses; }
+
 protected:
 
     //-----------------------------------------------------------------------------
@@ -157,9 +176,43 @@ protected:
     void destroyCpuProgram(Program* shaderProgram);
 
     /** Create GPU programs for the given program set based on the CPU programs it contains.
+    @remarks
+    The shader source is written first unless writeSourceCode was already called for the set.
     @param programSet The program set container.
     */
     bool createGpuPrograms(ProgramSet* programSet);
+
+    /** Write the shader source of the CPU programs of the given program set.
+    @remarks
+    This only touches the program set, the program processor and the given writer, so
+    it can run on a worker thread for different program sets at the same time as long
+    as each thread uses its own writer.
+    @param programSet The program set container.
+    @param programWriter The program writer instance to use.
+    */
+    bool writeSourceCode(ProgramSet* programSet, ProgramWriter* programWriter);
+
+    /** Get the program processor of the given target language. */
+    ProgramProcessor* getProgramProcessor(const String& language);
+
+    /** Write the shader source of a single CPU program, timed under the given program name. */
+    void writeSourceCode(Program* shaderProgram, ProgramWriter* programWriter, String& source,
+        const String& programName);
+
+    /** Build the key naming the programs of a render state from its sub render states.
+    @remarks
+    The key is known before any source is written, so programs already created or found in
+    the shader cache directory are used without writing their source again.
+    @return The key, or an empty string if a sub render state can't provide a hash.
+    */
+    String generateProgramKey(TargetRenderState* renderState);
+
+    /** Get the name of the program of the given type for a program key. */
+    String getProgramName(const String& programKey, GpuProgramType type);
+
+    /** Tells whether the program of the given type for a program key already exists, either
+    created or as a file in the shader cache directory. */
+    bool isProgramCached(const String& programKey, GpuProgramType type);
         
     /** 
     Generates a unique guid value from a string
@@ -170,6 +223,8 @@ protected:
 
     /** Create GPU program based on the give CPU program.
     @param shaderProgram The CPU program instance.
+    @param source The shader source written from the CPU program, written here if still needed.
+    @param programKey The key of the program set, used as the program name if not empty.
     @param programWriter The program writer instance.
     @param language The target shader language.
     @param profiles The profiles string for program compilation.
@@ -177,6 +232,8 @@ protected:
     @param cachePath The output path to write the program into.
     */
     GpuProgramPtr createGpuProgram(Program* shaderProgram, 
+        String& source,
+        const String& programKey,
         ProgramWriter* programWriter,
         const String& language,
         const String& profiles,
@@ -224,6 +281,8 @@ protected:
 protected:
     // CPU programs list.                   
     ProgramList mCpuProgramsList;
+    // Guards the CPU programs list, which is written from parallel scheme validation.
+    OGRE_MUTEX(mCpuProgramsMutex);
     // Map between target language and shader program writer.                   
     ProgramWriterMap mProgramWritersMap;
     // Map between target language and shader program processor.    
@@ -238,6 +297,9 @@ protected:
     ProgramProcessorList mDefaultProgramProcessors;
     // map the source code of the shaders to a name for them
     ProgramSourceToNameMap mProgramSourceToNameMap;
+    // GPU programs reused and created, see getNumCacheHits.
+    size_t mCacheHits;
+    size_t mCacheMisses;
 
 private:
     friend class ProgramSet;
@@ -74,6 +74,9 @@ protected:
     void setGpuVertexProgram(GpuProgramPtr vsGpuProgram);
     void setGpuFragmentProgram(GpuProgramPtr psGpuProgram);
 
+    /** Whether the CPU programs are ready for the GPU programs to be created. */
+    bool isPrepared() const { return mPrepared; }
+
 
     // Attributes.
 protected:
@@ -85,6 +88,14 @@ protected:
     GpuProgramPtr mVSGpuProgram;
     // Fragment shader CPU program.
     GpuProgramPtr mPSGpuProgram;
+    // Vertex shader source written from the CPU program.
+    String mVSSource;
+    // Fragment shader source written from the CPU program.
+    String mPSSource;
+    // Name of the programs derived from the sub render states, empty if they can't provide one.
+    String mProgramKey;
+    // Whether the source of the programs which need it has been written.
+    bool mPrepared;
 
 private:
     friend class ProgramManager;
@@ -114,6 +114,18 @@ public:
     */
     virtual bool preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass) { return true; }
 
+    /** Combine a hash of everything that affects the shader code this sub render state generates.
+    @remarks
+    Called after preAddToRenderState. The type is hashed by the caller, so only settings which
+    change the generated code need to be added here; values passed as uniform parameters do not.
+    When every sub render state of a pass provides a hash, its programs are named from the
+    combined hash and taken from the program cache without writing their source again.
+    The default returns false, which keeps this sub render state out of that scheme.
+    @param hash The hash to combine the settings into.
+    @return true if the hash describes the generated code completely.
+    */
+    virtual bool getHash(uint32& hash) const { return false; }
+
     /** Return the accessor object to this sub render state.
     @see SubRenderStateAccessor.
     */
@@ -0,0 +1,152 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreShaderExAutoInstancing.h"
+#ifdef RTSHADER_SYSTEM_BUILD_EXT_SHADERS
+#include "OgreShaderFFPRenderState.h"
+#include "OgreShaderProgram.h"
+#include "OgreShaderParameter.h"
+#include "OgreShaderProgramSet.h"
+#include "OgreMaterialSerializer.h"
+#include "OgreSceneManager.h"
+
+namespace Ogre {
+namespace RTShader {
+
+/************************************************************************/
+/*                                                                      */
+/************************************************************************/
+String AutoInstancing::Type = "SGX_AutoInstancing";
+
+//-----------------------------------------------------------------------
+AutoInstancing::AutoInstancing()
+{
+}
+
+//-----------------------------------------------------------------------
+const String& AutoInstancing::getType() const
+{
+    return Type;
+}
+
+//-----------------------------------------------------------------------
+int AutoInstancing::getExecutionOrder() const
+{
+    // Just before the transform stage, which then sees world space data
+    return FFP_TRANSFORM - 1;
+}
+
+//-----------------------------------------------------------------------
+void AutoInstancing::copyFrom(const SubRenderState& rhs)
+{
+}
+
+//-----------------------------------------------------------------------
+bool AutoInstancing::resolveParameters(ProgramSet* programSet)
+{
+    Program* vsProgram = programSet->getCpuVertexProgram();
+    Function* vsMain = vsProgram->getEntryPointFunction();
+
+    mVSInPosition = vsMain->resolveInputParameter(Parameter::SPS_POSITION, 0, Parameter::SPC_POSITION_OBJECT_SPACE, GCT_FLOAT4);
+    mVSInNormal = vsMain->resolveInputParameter(Parameter::SPS_NORMAL, 0, Parameter::SPC_NORMAL_OBJECT_SPACE, GCT_FLOAT3);
+
+    // Instance data
+    bool valid = mVSInPosition.get() != NULL && mVSInNormal.get() != NULL;
+    for (int row = 0; row < 3; ++row)
+    {
+        int index = SceneManager::AUTO_INSTANCING_TEXCOORD_INDEX + row;
+        mVSInWorldRows[row] = vsMain->resolveInputParameter(Parameter::SPS_TEXTURE_COORDINATES, index,
+            Parameter::Content(Parameter::SPC_TEXTURE_COORDINATE0 + index), GCT_FLOAT4);
+        valid = valid && mVSInWorldRows[row].get() != NULL;
+    }
+
+    return valid;
+}
+
+//-----------------------------------------------------------------------
+bool AutoInstancing::resolveDependencies(ProgramSet* programSet)
+{
+    Program* vsProgram = programSet->getCpuVertexProgram();
+    vsProgram->addDependency(FFP_LIB_COMMON);
+    vsProgram->addDependency(SGX_LIB_AUTO_INSTANCING);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+bool AutoInstancing::addFunctionInvocations(ProgramSet* programSet)
+{
+    Program* vsProgram = programSet->getCpuVertexProgram();
+    Function* vsMain = vsProgram->getEntryPointFunction();
+
+    FunctionInvocation* curFuncInvocation = OGRE_NEW FunctionInvocation(SGX_FUNC_AUTO_INSTANCING, FFP_VS_PRE_PROCESS, 0);
+    curFuncInvocation->pushOperand(mVSInPosition, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mVSInNormal, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mVSInWorldRows[0], Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mVSInWorldRows[1], Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mVSInWorldRows[2], Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mVSInPosition, Operand::OPS_OUT);
+    curFuncInvocation->pushOperand(mVSInNormal, Operand::OPS_OUT);
+    vsMain->addAtomInstance(curFuncInvocation);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+const String& AutoInstancingFactory::getType() const
+{
+    return AutoInstancing::Type;
+}
+
+//-----------------------------------------------------------------------
+SubRenderState* AutoInstancingFactory::createInstance(ScriptCompiler* compiler, 
+                                                      PropertyAbstractNode* prop, Pass* pass, SGScriptTranslator* translator)
+{
+    if (prop->name == "auto_instancing")
+    {
+        return createOrRetrieveInstance(translator);
+    }
+
+    return NULL;
+}
+
+//-----------------------------------------------------------------------
+void AutoInstancingFactory::writeInstance(MaterialSerializer* ser, SubRenderState* subRenderState, 
+                                          Pass* srcPass, Pass* dstPass)
+{
+    ser->writeAttribute(4, "auto_instancing");
+}
+
+//-----------------------------------------------------------------------
+SubRenderState* AutoInstancingFactory::createInstanceImpl()
+{
+    return OGRE_NEW AutoInstancing;
+}
+
+}
+}
+
+#endif
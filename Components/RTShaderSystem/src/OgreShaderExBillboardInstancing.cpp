@@ -0,0 +1,159 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreShaderExBillboardInstancing.h"
+#ifdef RTSHADER_SYSTEM_BUILD_EXT_SHADERS
+#include "OgreShaderFFPRenderState.h"
+#include "OgreShaderProgram.h"
+#include "OgreShaderParameter.h"
+#include "OgreShaderProgramSet.h"
+#include "OgreMaterialSerializer.h"
+#include "OgreBillboardSet.h"
+
+namespace Ogre {
+namespace RTShader {
+
+/************************************************************************/
+/*                                                                      */
+/************************************************************************/
+String BillboardInstancing::Type = "SGX_BillboardInstancing";
+
+//-----------------------------------------------------------------------
+BillboardInstancing::BillboardInstancing()
+{
+}
+
+//-----------------------------------------------------------------------
+const String& BillboardInstancing::getType() const
+{
+    return Type;
+}
+
+//-----------------------------------------------------------------------
+int BillboardInstancing::getExecutionOrder() const
+{
+    // Just before the transform stage, which then sees the expanded quad
+    return FFP_TRANSFORM - 1;
+}
+
+//-----------------------------------------------------------------------
+void BillboardInstancing::copyFrom(const SubRenderState& rhs)
+{
+}
+
+//-----------------------------------------------------------------------
+bool BillboardInstancing::resolveParameters(ProgramSet* programSet)
+{
+    Program* vsProgram = programSet->getCpuVertexProgram();
+    Function* vsMain = vsProgram->getEntryPointFunction();
+
+    // Quad corner
+    mVSInPosition = vsMain->resolveInputParameter(Parameter::SPS_POSITION, 0, Parameter::SPC_POSITION_OBJECT_SPACE, GCT_FLOAT4);
+    mVSInTexcoord = vsMain->resolveInputParameter(Parameter::SPS_TEXTURE_COORDINATES, 0, Parameter::SPC_TEXTURE_COORDINATE0, GCT_FLOAT2);
+
+    // Instance data
+    mVSInPositionRotation = vsMain->resolveInputParameter(Parameter::SPS_TEXTURE_COORDINATES, 1, Parameter::SPC_TEXTURE_COORDINATE1, GCT_FLOAT4);
+    mVSInDimensions = vsMain->resolveInputParameter(Parameter::SPS_TEXTURE_COORDINATES, 2, Parameter::SPC_TEXTURE_COORDINATE2, GCT_FLOAT2);
+    mVSInTexcoordRect = vsMain->resolveInputParameter(Parameter::SPS_TEXTURE_COORDINATES, 3, Parameter::SPC_TEXTURE_COORDINATE3, GCT_FLOAT4);
+    mVSInDirection = vsMain->resolveInputParameter(Parameter::SPS_TEXTURE_COORDINATES, 4, Parameter::SPC_TEXTURE_COORDINATE4, GCT_FLOAT3);
+
+    mAxisX = vsProgram->resolveAutoParameterInt(GpuProgramParameters::ACT_CUSTOM, GCT_FLOAT4, BillboardSet::IP_AXIS_X);
+    mAxisY = vsProgram->resolveAutoParameterInt(GpuProgramParameters::ACT_CUSTOM, GCT_FLOAT4, BillboardSet::IP_AXIS_Y);
+    mOffsets = vsProgram->resolveAutoParameterInt(GpuProgramParameters::ACT_CUSTOM, GCT_FLOAT4, BillboardSet::IP_OFFSETS);
+
+    return mVSInPosition.get() != NULL && mVSInTexcoord.get() != NULL &&
+        mVSInPositionRotation.get() != NULL && mVSInDimensions.get() != NULL &&
+        mVSInTexcoordRect.get() != NULL && mVSInDirection.get() != NULL &&
+        mAxisX.get() != NULL && mAxisY.get() != NULL && mOffsets.get() != NULL;
+}
+
+//-----------------------------------------------------------------------
+bool BillboardInstancing::resolveDependencies(ProgramSet* programSet)
+{
+    Program* vsProgram = programSet->getCpuVertexProgram();
+    vsProgram->addDependency(FFP_LIB_COMMON);
+    vsProgram->addDependency(SGX_LIB_BILLBOARD_INSTANCING);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+bool BillboardInstancing::addFunctionInvocations(ProgramSet* programSet)
+{
+    Program* vsProgram = programSet->getCpuVertexProgram();
+    Function* vsMain = vsProgram->getEntryPointFunction();
+
+    FunctionInvocation* curFuncInvocation = OGRE_NEW FunctionInvocation(SGX_FUNC_BILLBOARD_INSTANCING, FFP_VS_PRE_PROCESS, 0);
+    curFuncInvocation->pushOperand(mVSInPosition, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mVSInPositionRotation, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mVSInDimensions, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mVSInTexcoordRect, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mVSInDirection, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mAxisX, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mAxisY, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mOffsets, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mVSInPosition, Operand::OPS_OUT);
+    curFuncInvocation->pushOperand(mVSInTexcoord, Operand::OPS_OUT);
+    vsMain->addAtomInstance(curFuncInvocation);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+const String& BillboardInstancingFactory::getType() const
+{
+    return BillboardInstancing::Type;
+}
+
+//-----------------------------------------------------------------------
+SubRenderState* BillboardInstancingFactory::createInstance(ScriptCompiler* compiler, 
+                                                           PropertyAbstractNode* prop, Pass* pass, SGScriptTranslator* translator)
+{
+    if (prop->name == "billboard_instancing")
+    {
+        return createOrRetrieveInstance(translator);
+    }
+
+    return NULL;
+}
+
+//-----------------------------------------------------------------------
+void BillboardInstancingFactory::writeInstance(MaterialSerializer* ser, SubRenderState* subRenderState, 
+                                               Pass* srcPass, Pass* dstPass)
+{
+    ser->writeAttribute(4, "billboard_instancing");
+}
+
+//-----------------------------------------------------------------------
+SubRenderState* BillboardInstancingFactory::createInstanceImpl()
+{
+    return OGRE_NEW BillboardInstancing;
+}
+
+}
+}
+
+#endif
@@ -80,6 +80,13 @@ namespace Ogre {
 	
 		//-----------------------------------------------------------------------
 	
+		bool FFPAlphaTest::getHash(uint32& hash) const
+		{
+			// The function and reference value are uniform parameters
+			return true;
+		}
+
+		//-----------------------------------------------------------------------
 		void FFPAlphaTest::copyFrom( const SubRenderState& rhs )
 		{
 
@@ -265,6 +265,13 @@ bool FFPColour::addFunctionInvocations(ProgramSet* programSet)
 }
 
 
+//-----------------------------------------------------------------------
+bool FFPColour::getHash(uint32& hash) const
+{
+    hash = HashCombine(hash, mResolveStageFlags);
+    return true;
+}
+
 //-----------------------------------------------------------------------
 void FFPColour::copyFrom(const SubRenderState& rhs)
 {
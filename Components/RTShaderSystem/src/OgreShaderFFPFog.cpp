@@ -286,6 +286,14 @@ bool FFPFog::addFunctionInvocations(ProgramSet* programSet)
     return true;
 }
 
+//-----------------------------------------------------------------------
+bool FFPFog::getHash(uint32& hash) const
+{
+    hash = HashCombine(hash, mCalcMode);
+    hash = HashCombine(hash, mFogMode);
+    return true;
+}
+
 //-----------------------------------------------------------------------
 void FFPFog::copyFrom(const SubRenderState& rhs)
 {
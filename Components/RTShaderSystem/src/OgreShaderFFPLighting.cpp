@@ -606,6 +606,17 @@ bool FFPLighting::addIlluminationInvocation(LightParams* curLightParams, Functio
 }
 
 
+//-----------------------------------------------------------------------
+bool FFPLighting::getHash(uint32& hash) const
+{
+    hash = HashCombine(hash, mTrackVertexColourType);
+    hash = HashCombine(hash, mSpecularEnable);
+    hash = HashCombine(hash, mLightParamsList.size());
+    for (LightParamsConstIterator it = mLightParamsList.begin(); it != mLightParamsList.end(); ++it)
+        hash = HashCombine(hash, it->mType);
+    return true;
+}
+
 //-----------------------------------------------------------------------
 void FFPLighting::copyFrom(const SubRenderState& rhs)
 {
@@ -829,7 +829,7 @@ TexCoordCalcMethod FFPTexturing::getTexCalcMethod(TextureUnitState* textureUnitS
 }
 
 //-----------------------------------------------------------------------
-bool FFPTexturing::needsTextureMatrix(TextureUnitState* textureUnitState)
+bool FFPTexturing::needsTextureMatrix(TextureUnitState* textureUnitState) const
 {
     const TextureUnitState::EffectMap&      effectMap = textureUnitState->getEffects(); 
     TextureUnitState::EffectMap::const_iterator effi;
@@ -860,6 +860,48 @@ bool FFPTexturing::needsTextureMatrix(TextureUnitState* textureUnitState)
 }
 
 
+//-----------------------------------------------------------------------
+namespace
+{
+    uint32 hashBlendMode(uint32 hash, const LayerBlendModeEx& blendMode)
+    {
+        hash = HashCombine(hash, blendMode.operation);
+        hash = HashCombine(hash, blendMode.source1);
+        hash = HashCombine(hash, blendMode.source2);
+        // Manual arguments and factors are written into the source as constants
+        hash = HashCombine(hash, blendMode.colourArg1);
+        hash = HashCombine(hash, blendMode.colourArg2);
+        hash = HashCombine(hash, blendMode.alphaArg1);
+        hash = HashCombine(hash, blendMode.alphaArg2);
+        hash = HashCombine(hash, blendMode.factor);
+        return hash;
+    }
+}
+
+//-----------------------------------------------------------------------
+bool FFPTexturing::getHash(uint32& hash) const
+{
+    hash = HashCombine(hash, mTextureUnitParamsList.size());
+    for (TextureUnitParamsConstIterator it = mTextureUnitParamsList.begin(); it != mTextureUnitParamsList.end(); ++it)
+    {
+        TextureUnitState* textureUnitState = it->mTextureUnitState;
+        if (textureUnitState == NULL)
+            return false;
+
+        hash = HashCombine(hash, it->mTextureSamplerIndex);
+        hash = HashCombine(hash, it->mTextureSamplerType);
+        hash = HashCombine(hash, it->mVSInTextureCoordinateType);
+        hash = HashCombine(hash, it->mVSOutTextureCoordinateType);
+        hash = HashCombine(hash, it->mTexCoordCalcMethod);
+        hash = HashCombine(hash, textureUnitState->getTextureCoordSet());
+        hash = HashCombine(hash, textureUnitState->getBindingType());
+        hash = HashCombine(hash, needsTextureMatrix(textureUnitState));
+        hash = hashBlendMode(hash, textureUnitState->getColourBlendMode());
+        hash = hashBlendMode(hash, textureUnitState->getAlphaBlendMode());
+    }
+    return true;
+}
+
 //-----------------------------------------------------------------------
 void FFPTexturing::copyFrom(const SubRenderState& rhs)
 {
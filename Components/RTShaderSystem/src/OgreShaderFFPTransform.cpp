@@ -90,6 +90,13 @@ bool FFPTransform::createCpuSubPrograms(ProgramSet* programSet)
 }
 
 
+//-----------------------------------------------------------------------
+bool FFPTransform::getHash(uint32& hash) const
+{
+    // Always the same code
+    return true;
+}
+
 //-----------------------------------------------------------------------
 void FFPTransform::copyFrom(const SubRenderState& rhs)
 {
@@ -39,11 +39,15 @@ THE SOFTWARE.
 #include "OgreShaderExHardwareSkinning.h"
 #include "OgreShaderMaterialSerializerListener.h"
 #include "OgreShaderProgramWriterManager.h"
+#include "OgreShaderProgramWriter.h"
 #include "OgreGpuProgramManager.h"
 #include "OgreHighLevelGpuProgramManager.h"
 #include "OgreShaderExTextureAtlasSampler.h"
 #include "OgreShaderExTriplanarTexturing.h"
+#include "OgreShaderExBillboardInstancing.h"
+#include "OgreShaderExAutoInstancing.h"
 #include "OgreRoot.h"
+#include "OgreWorkQueue.h"
 #include "OgreException.h"
 
 namespace Ogre {
@@ -79,7 +83,7 @@ ShaderGenerator::ShaderGenerator() :
     mActiveSceneMgr(NULL), mRenderObjectListener(NULL), mSceneManagerListener(NULL), mScriptTranslatorManager(NULL),
     mMaterialSerializerListener(NULL), mShaderLanguage(""), mProgramManager(NULL), mProgramWriterManager(NULL),
     mFSLayer(0), mFFPRenderStateBuilder(NULL),mActiveViewportValid(false), mVSOutputCompactPolicy(VSOCP_LOW),
-    mCreateShaderOverProgrammablePass(false), mIsFinalizing(false)
+    mCreateShaderOverProgrammablePass(false), mParallelValidation(false), mIsFinalizing(false)
 {
     mLightCount[0]              = 0;
     mLightCount[1]              = 0;
@@ -220,6 +224,14 @@ void ShaderGenerator::createSubRenderStateExFactories()
     curFactory = OGRE_NEW TriplanarTexturingFactory;
     addSubRenderStateFactory(curFactory);
     mSubRenderStateExFactories[curFactory->getType()] = (curFactory);
+
+    curFactory = OGRE_NEW BillboardInstancingFactory;
+    addSubRenderStateFactory(curFactory);
+    mSubRenderStateExFactories[curFactory->getType()] = (curFactory);
+
+    curFactory = OGRE_NEW AutoInstancingFactory;
+    addSubRenderStateFactory(curFactory);
+    mSubRenderStateExFactories[curFactory->getType()] = (curFactory);
 #endif
 }
 
@@ -1429,6 +1441,11 @@ void ShaderGenerator::setShaderCachePath( const String& cachePath )
             remove(outTestFileName.c_str());
 
             ResourceGroupManager::getSingleton().addResourceLocation(mShaderCachePath, "FileSystem", GENERATED_SHADERS_GROUP_NAME);                 
+
+            // Keep the compiled programs next to their source, unless the application chose a place.
+            GpuProgramManager& gpuProgramManager = GpuProgramManager::getSingleton();
+            if (gpuProgramManager.getMicrocodeCacheDirectory().empty())
+                gpuProgramManager.setMicrocodeCacheDirectory(mShaderCachePath);
         }
     }
 }
@@ -1585,6 +1602,12 @@ void ShaderGenerator::SGPass::acquirePrograms()
     ProgramManager::getSingleton().acquirePrograms(mDstPass, mTargetRenderState);
 }
 
+//-----------------------------------------------------------------------------
+bool ShaderGenerator::SGPass::prepareProgramSources(ProgramWriter* programWriter)
+{
+    return ProgramManager::getSingleton().prepareProgramSources(mTargetRenderState, programWriter);
+}
+
 //-----------------------------------------------------------------------------
 void ShaderGenerator::SGPass::releasePrograms()
 {
@@ -1819,6 +1842,14 @@ void ShaderGenerator::SGTechnique::acquirePrograms()
 			(*itPass)->acquirePrograms();
 }
 
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGTechnique::getPassList(SGPassList& passes)
+{
+    for (SGPassIterator itPass = mPassEntries.begin(); itPass != mPassEntries.end(); ++itPass)
+        if (!(*itPass)->isIlluminationPass())
+            passes.push_back(*itPass);
+}
+
 //-----------------------------------------------------------------------------
 void ShaderGenerator::SGTechnique::buildIlluminationTargetRenderState()
 {
@@ -1995,6 +2026,10 @@ void ShaderGenerator::SGScheme::validate()
             curTechEntry->buildTargetRenderState();     
     }
 
+    // Write the shader source of all passes up front when validating in parallel.
+    if (ShaderGenerator::getSingleton().getParallelValidation())
+        prepareProgramSources();
+
     // Acquire GPU programs for each technique.
     for (itTech = mTechniqueEntries.begin(); itTech != mTechniqueEntries.end(); ++itTech)
     {
@@ -2016,6 +2051,64 @@ void ShaderGenerator::SGScheme::validate()
     mOutOfDate = false;
 }
 
+//-----------------------------------------------------------------------------
+// Program writers keep state while writing, so each range gets its own.
+class ShaderGenerator::SGScheme::PassSourceTask : public WorkQueue::ParallelTask
+{
+public:
+    PassSourceTask(SGPass** passes, const String& language)
+        : mPasses(passes), mLanguage(language) {}
+
+    void execute(size_t begin, size_t end)
+    {
+        ProgramWriter* programWriter = NULL;
+        try
+        {
+            programWriter = ProgramWriterManager::getSingleton().createProgramWriter(mLanguage);
+            for (size_t i = begin; i < end; ++i)
+            {
+                try
+                {
+                    mPasses[i]->prepareProgramSources(programWriter);
+                }
+                catch (...)
+                {
+                    // Generated again by acquirePrograms, which reports it
+                }
+            }
+        }
+        catch (...)
+        {
+            // No writer; acquirePrograms generates everything
+        }
+        OGRE_DELETE programWriter;
+    }
+
+private:
+    SGPass** mPasses;
+    const String& mLanguage;
+};
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGScheme::prepareProgramSources()
+{
+    SGPassList passes;
+    for (SGTechniqueIterator itTech = mTechniqueEntries.begin(); itTech != mTechniqueEntries.end(); ++itTech)
+    {
+        SGTechnique* curTechEntry = *itTech;
+
+        if (curTechEntry->getBuildDestinationTechnique())
+            curTechEntry->getPassList(passes);
+    }
+
+    if (passes.size() < 2)
+        return;
+
+    PassSourceTask task(&passes[0], ShaderGenerator::getSingleton().getTargetLanguage());
+    // Creating a writer costs about as much as writing a few programs
+    Root::getSingleton().getWorkQueue()->parallelFor(passes.size(), 8, &task);
+}
+
 //-----------------------------------------------------------------------------
 void ShaderGenerator::SGScheme::synchronizeWithLightSettings()
 {
@@ -48,6 +48,8 @@ THE SOFTWARE.
 #endif
 #include "OgreShaderGLSLESProgramProcessor.h"
 #include "OgreGpuProgramManager.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
 
 
 namespace Ogre {
@@ -74,6 +76,7 @@ ProgramManager& ProgramManager::getSingleton()
 
 //-----------------------------------------------------------------------------
 ProgramManager::ProgramManager()
+    : mCacheHits(0), mCacheMisses(0)
 {
     createDefaultProgramProcessors();
     createDefaultProgramWriterFactories();
@@ -91,8 +94,10 @@ ProgramManager::~ProgramManager()
 //-----------------------------------------------------------------------------
 void ProgramManager::acquirePrograms(Pass* pass, TargetRenderState* renderState)
 {
-    // Create the CPU programs.
-    if (false == renderState->createCpuPrograms())
+    // Create the CPU programs, unless they were prepared by a parallel scheme validation.
+    ProgramSet* preparedSet = renderState->getProgramSet();
+    if ((preparedSet == NULL || !preparedSet->isPrepared()) &&
+        false == renderState->createCpuPrograms())
     {
         OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, 
             "Could not apply render state ", 
@@ -119,6 +124,20 @@ void ProgramManager::acquirePrograms(Pass* pass, TargetRenderState* renderState)
 
 }
 
+//-----------------------------------------------------------------------------
+bool ProgramManager::prepareProgramSources(TargetRenderState* renderState, ProgramWriter* programWriter)
+{
+    if (renderState->createCpuPrograms() &&
+        writeSourceCode(renderState->getProgramSet(), programWriter))
+    {
+        return true;
+    }
+
+    // Generated again by acquirePrograms, which reports the error
+    renderState->destroyProgramSet();
+    return false;
+}
+
 //-----------------------------------------------------------------------------
 void ProgramManager::releasePrograms(Pass* pass, TargetRenderState* renderState)
 {
@@ -253,6 +272,7 @@ Program* ProgramManager::createCpuProgram(GpuProgramType type)
 {
     Program* shaderProgram = OGRE_NEW Program(type);
 
+    OGRE_LOCK_MUTEX(mCpuProgramsMutex);
     mCpuProgramsList.insert(shaderProgram);
 
     return shaderProgram;
@@ -262,6 +282,7 @@ Program* ProgramManager::createCpuProgram(GpuProgramType type)
 //-----------------------------------------------------------------------------
 void ProgramManager::destroyCpuProgram(Program* shaderProgram)
 {
+    OGRE_LOCK_MUTEX(mCpuProgramsMutex);
     ProgramListIterator it    = mCpuProgramsList.find(shaderProgram);
     
     if (it != mCpuProgramsList.end())
@@ -274,19 +295,9 @@ void ProgramManager::destroyCpuProgram(Program* shaderProgram)
 //-----------------------------------------------------------------------------
 bool ProgramManager::createGpuPrograms(ProgramSet* programSet)
 {
-    // Before we start we need to make sure that the pixel shader input
-    //  parameters are the same as the vertex output, this required by 
-    //  shader models 4 and 5.
-    // This change may incrase the number of register used in older shader
-    //  models - this is why the check is present here.
-    bool isVs4 = GpuProgramManager::getSingleton().isSyntaxSupported("vs_4_0_level_9_1");
-    if (isVs4)
-    {
-        synchronizePixelnToBeVertexOut(programSet);
-    }
+    const String& language = ShaderGenerator::getSingleton().getTargetLanguage();
 
     // Grab the matching writer.
-    const String& language = ShaderGenerator::getSingleton().getTargetLanguage();
     ProgramWriterIterator itWriter = mProgramWritersMap.find(language);
     ProgramWriter* programWriter = NULL;
 
@@ -301,29 +312,18 @@ bool ProgramManager::createGpuPrograms(ProgramSet* programSet)
         programWriter = itWriter->second;
     }
 
-    ProgramProcessorIterator itProcessor = mProgramProcessorsMap.find(language);
-    ProgramProcessor* programProcessor = NULL;
-
-    if (itProcessor == mProgramProcessorsMap.end())
-    {
-        OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM,
-            "Could not find processor for language '" + language,
-            "ProgramManager::createGpuPrograms");       
-    }
-
-    programProcessor = itProcessor->second;
+    if (!programSet->isPrepared() && !writeSourceCode(programSet, programWriter))
+        return false;
 
+    ProgramProcessor* programProcessor = getProgramProcessor(language);
     bool success;
-    
-    // Call the pre creation of GPU programs method.
-    success = programProcessor->preCreateGpuPrograms(programSet);
-    if (success == false)   
-        return false;   
-    
+
     // Create the vertex shader program.
     GpuProgramPtr vsGpuProgram;
     
     vsGpuProgram = createGpuProgram(programSet->getCpuVertexProgram(), 
+        programSet->mVSSource,
+        programSet->mProgramKey,
         programWriter,
         language, 
         ShaderGenerator::getSingleton().getVertexShaderProfiles(),
@@ -342,6 +342,8 @@ bool ProgramManager::createGpuPrograms(ProgramSet* programSet)
     GpuProgramPtr psGpuProgram;
 
     psGpuProgram = createGpuProgram(programSet->getCpuFragmentProgram(), 
+        programSet->mPSSource,
+        programSet->mProgramKey,
         programWriter,
         language, 
         ShaderGenerator::getSingleton().getFragmentShaderProfiles(),
@@ -363,6 +365,137 @@ bool ProgramManager::createGpuPrograms(ProgramSet* programSet)
     
 }
 
+//-----------------------------------------------------------------------------
+ProgramProcessor* ProgramManager::getProgramProcessor(const String& language)
+{
+    ProgramProcessorIterator itProcessor = mProgramProcessorsMap.find(language);
+
+    if (itProcessor == mProgramProcessorsMap.end())
+    {
+        OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM,
+            "Could not find processor for language '" + language,
+            "ProgramManager::createGpuPrograms");       
+    }
+
+    return itProcessor->second;
+}
+
+//-----------------------------------------------------------------------------
+bool ProgramManager::writeSourceCode(ProgramSet* programSet, ProgramWriter* programWriter)
+{
+    // Before we start we need to make sure that the pixel shader input
+    //  parameters are the same as the vertex output, this required by 
+    //  shader models 4 and 5.
+    // This change may incrase the number of register used in older shader
+    //  models - this is why the check is present here.
+    bool isVs4 = GpuProgramManager::getSingleton().isSyntaxSupported("vs_4_0_level_9_1");
+    if (isVs4)
+    {
+        synchronizePixelnToBeVertexOut(programSet);
+    }
+
+    const String& language = ShaderGenerator::getSingleton().getTargetLanguage();
+    ProgramProcessor* programProcessor = getProgramProcessor(language);
+
+    // Call the pre creation of GPU programs method.
+    if (programProcessor->preCreateGpuPrograms(programSet) == false)
+        return false;
+
+    // Generate source code, unless the programs are known by their key already.
+    if (!isProgramCached(programSet->mProgramKey, GPT_VERTEX_PROGRAM))
+        writeSourceCode(programSet->getCpuVertexProgram(), programWriter, programSet->mVSSource,
+            getProgramName(programSet->mProgramKey, GPT_VERTEX_PROGRAM));
+
+    if (!isProgramCached(programSet->mProgramKey, GPT_FRAGMENT_PROGRAM))
+        writeSourceCode(programSet->getCpuFragmentProgram(), programWriter, programSet->mPSSource,
+            getProgramName(programSet->mProgramKey, GPT_FRAGMENT_PROGRAM));
+
+    programSet->mPrepared = true;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void ProgramManager::writeSourceCode(Program* shaderProgram, ProgramWriter* programWriter, String& source,
+                                     const String& programName)
+{
+    GpuProgramManager::CompileTimer timer(GpuProgramManager::CS_GENERATE, programName);
+    stringstream sourceCodeStringStream;
+    programWriter->writeSourceCode(sourceCodeStringStream, shaderProgram);
+    source = sourceCodeStringStream.str();
+}
+
+//-----------------------------------------------------------------------------
+String ProgramManager::getProgramName(const String& programKey, GpuProgramType type)
+{
+    return programKey + (type == GPT_VERTEX_PROGRAM ? "_VS" : "_FS");
+}
+
+//-----------------------------------------------------------------------------
+bool ProgramManager::isProgramCached(const String& programKey, GpuProgramType type)
+{
+    if (programKey.empty())
+        return false;
+
+    const String programName = getProgramName(programKey, type);
+    if (!HighLevelGpuProgramManager::getSingleton().getByName(programName).isNull())
+        return true;
+
+    const String& cachePath = ShaderGenerator::getSingleton().getShaderCachePath();
+    if (cachePath.empty())
+        return false;
+
+    std::ifstream programFile((cachePath + programName + "." +
+        ShaderGenerator::getSingleton().getTargetLanguage()).c_str());
+    return programFile.good();
+}
+
+//-----------------------------------------------------------------------------
+String ProgramManager::generateProgramKey(TargetRenderState* renderState)
+{
+#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
+    // Caching is disabled on android devices
+    return BLANKSTRING;
+#else
+    ShaderGenerator& shaderGenerator = ShaderGenerator::getSingleton();
+    RenderSystem* renderSystem = Root::getSingleton().getRenderSystem();
+
+    // Everything outside the sub render states that changes the generated code.
+    // Bump the version when the code generated for the same settings changes.
+    StringStream settings;
+    settings << "RTSS program key 1;"
+        << shaderGenerator.getTargetLanguage() << ";"
+        << shaderGenerator.getVertexShaderProfiles() << ";"
+        << shaderGenerator.getFragmentShaderProfiles() << ";"
+        << shaderGenerator.getVertexShaderOutputsCompactPolicy() << ";";
+    if (renderSystem)
+        settings << renderSystem->getName() << ";" << renderSystem->getNativeShadingLanguageVersion();
+    const String settingsString = settings.str();
+
+    // Two differently seeded hashes, 32 bits alone collide too easily over thousands of programs
+    uint32 hashes[2] = { 0x9e3779b9, 0x61C88646 };
+    const SubRenderStateList& subRenderStates = renderState->getTemplateSubRenderStateList();
+    for (int i = 0; i < 2; ++i)
+    {
+        hashes[i] = FastHash(settingsString.c_str(), (int)settingsString.size(), hashes[i]);
+        for (SubRenderStateListConstIterator it = subRenderStates.begin(); it != subRenderStates.end(); ++it)
+        {
+            const String& type = (*it)->getType();
+            hashes[i] = FastHash(type.c_str(), (int)type.size(), hashes[i]);
+            if (!(*it)->getHash(hashes[i]))
+                return BLANKSTRING;
+        }
+    }
+
+    StringStream key;
+    key << "RTSS_";
+    key.fill('0');
+    key.setf(std::ios::hex, std::ios::basefield);
+    key.width(8); key << hashes[0];
+    key.width(8); key << hashes[1];
+    return key.str();
+#endif
+}
+
 
 //-----------------------------------------------------------------------------
 void ProgramManager::bindUniformParameters(Program* pCpuProgram, const GpuProgramParametersSharedPtr& passParams)
@@ -380,39 +513,44 @@ void ProgramManager::bindUniformParameters(Program* pCpuProgram, const GpuProgra
 
 //-----------------------------------------------------------------------------
 GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram, 
+                                               String& source,
+                                               const String& programKey,
                                                ProgramWriter* programWriter,
                                                const String& language,
                                                const String& profiles,
                                                const StringVector& profilesList,
                                                const String& cachePath)
 {
-    stringstream sourceCodeStringStream;
     String programName;
 
-    // Generate source code.
-    programWriter->writeSourceCode(sourceCodeStringStream, shaderProgram);
-    String source = sourceCodeStringStream.str();
-
+    if (!programKey.empty())
+    {
+        // Named from the sub render states, so known before the source is written.
+        programName = getProgramName(programKey, shaderProgram->getType());
+    }
+    else
+    {
 #if OGRE_PLATFORM != OGRE_PLATFORM_ANDROID
     
-    // Generate program name.
-    programName = generateGUID(source);
+        // Generate program name.
+        programName = generateGUID(source);
 
 #else // Disable caching on android devices 
 
-    // Generate program name.
-    static int gpuProgramID = 0;
-    programName = "RTSS_"  + StringConverter::toString(++gpuProgramID);
+        // Generate program name.
+        static int gpuProgramID = 0;
+        programName = "RTSS_"  + StringConverter::toString(++gpuProgramID);
    
 #endif
     
-    if (shaderProgram->getType() == GPT_VERTEX_PROGRAM)
-    {
-        programName += "_VS";
-    }
-    else if (shaderProgram->getType() == GPT_FRAGMENT_PROGRAM)
-    {
-        programName += "_FS";
+        if (shaderProgram->getType() == GPT_VERTEX_PROGRAM)
+        {
+            programName += "_VS";
+        }
+        else if (shaderProgram->getType() == GPT_FRAGMENT_PROGRAM)
+        {
+            programName += "_FS";
+        }
     }
 
     // Try to get program by name.
@@ -441,16 +579,21 @@ GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram,
             if (!programFile)
             {           
                 writeFile = true;
+                ++mCacheMisses;
             }
             else
             {
                 writeFile = false;
+                ++mCacheHits;
                 programFile.close();
             }
 
             // Case we have to write the program to a file.
             if (writeFile)
             {
+                if (source.empty())
+                    writeSourceCode(shaderProgram, programWriter, source, programName);
+
                 std::ofstream outFile(programFileName.c_str());
 
                 if (!outFile)
@@ -466,6 +609,10 @@ GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram,
         // No cache directory specified -> create program from system memory.
         else
         {
+            ++mCacheMisses;
+            if (source.empty())
+                writeSourceCode(shaderProgram, programWriter, source, programName);
+
             pGpuProgram->setSource(source);
         }
         
@@ -511,6 +658,10 @@ GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram,
             mFragmentShaderMap[programName] = pGpuProgram;  
         }               
     }
+    else
+    {
+        ++mCacheHits;
+    }
     
     return GpuProgramPtr(pGpuProgram);
 }
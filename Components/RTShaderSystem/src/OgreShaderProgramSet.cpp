@@ -32,7 +32,7 @@ namespace Ogre {
 namespace RTShader {
 
 //-----------------------------------------------------------------------------
-ProgramSet::ProgramSet() : mVSCpuProgram(0), mPSCpuProgram(0)
+ProgramSet::ProgramSet() : mVSCpuProgram(0), mPSCpuProgram(0), mPrepared(false)
 {   
 }
 
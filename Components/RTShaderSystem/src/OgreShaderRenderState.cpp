@@ -167,6 +167,7 @@ bool TargetRenderState::createCpuPrograms()
     sortSubRenderStates();
 
     ProgramSet* programSet = createProgramSet();
+    programSet->mProgramKey = ProgramManager::getSingleton().generateProgramKey(this);
     Program* vsProgram = ProgramManager::getSingleton().createCpuProgram(GPT_VERTEX_PROGRAM);
     Program* psProgram = ProgramManager::getSingleton().createCpuProgram(GPT_FRAGMENT_PROGRAM);
     RTShader::Function* vsMainFunc = NULL;
@@ -568,10 +568,34 @@ namespace Ogre
             virtual void freeAllBuffers() = 0;
 
         };
-        /// Standard implementation of a buffer allocator which re-uses buffers
+        /** Standard implementation of a buffer allocator which re-uses buffers.
+        @remarks
+            Freed vertex buffers are kept in pools by size, and handed out again
+            to any terrain that needs a buffer of the same size. 
+        */
         class _OgreTerrainExport DefaultGpuBufferAllocator : public GpuBufferAllocator
         {
         public:
+            /// Usage counters of the vertex buffer pools
+            struct Statistics
+            {
+                /// Number of vertex buffers requested
+                size_t requests;
+                /// Number of requests served from the pools
+                size_t hits;
+                /// Number of vertex buffers created
+                size_t buffersCreated;
+                /// Size of the vertex buffers created, in bytes
+                size_t bytesCreated;
+                /// Number of vertex buffers currently in the pools
+                size_t freeBuffers;
+                /// Size of the vertex buffers currently in the pools, in bytes
+                size_t freeBytes;
+
+                Statistics() : requests(0), hits(0), buffersCreated(0), bytesCreated(0),
+                    freeBuffers(0), freeBytes(0) {}
+            };
+
             DefaultGpuBufferAllocator();
             virtual ~DefaultGpuBufferAllocator();
             void allocateVertexBuffers(Terrain* forTerrain, size_t numVertices, HardwareVertexBufferSharedPtr& destPos, HardwareVertexBufferSharedPtr& destDelta);
@@ -587,17 +611,26 @@ namespace Ogre
             void warmStart(size_t numInstances, uint16 terrainSize, uint16 maxBatchSize, 
                 uint16 minBatchSize);
 
+            /// Get the usage counters of the vertex buffer pools
+            const Statistics& getStatistics() const { return mStatistics; }
+            /// Reset the request and creation counters, keeping the pool sizes
+            void resetStatistics();
+
         protected:
             typedef list<HardwareVertexBufferSharedPtr>::type VBufList;
-            VBufList mFreePosBufList;
-            VBufList mFreeDeltaBufList;
+            /// Free buffers by size in bytes
+            typedef map<size_t, VBufList>::type VBufPool;
+            VBufPool mFreePosBufList;
+            VBufPool mFreeDeltaBufList;
+            Statistics mStatistics;
             typedef map<uint32, HardwareIndexBufferSharedPtr>::type IBufMap;
             IBufMap mSharedIBufMap;
 
             uint32 hashIndexBuffer(uint16 batchSize, 
                 uint16 vdatasize, size_t vertexIncrement, uint16 xoffset, uint16 yoffset, uint16 numSkirtRowsCols, 
                 uint16 skirtRowColSkip);
-            HardwareVertexBufferSharedPtr getVertexBuffer(VBufList& list, size_t vertexSize, size_t numVertices);
+            HardwareVertexBufferSharedPtr getVertexBuffer(VBufPool& pool, size_t vertexSize, size_t numVertices);
+            void freeVertexBuffer(VBufPool& pool, const HardwareVertexBufferSharedPtr& buf);
 
         };
 
@@ -1227,6 +1260,17 @@ namespace Ogre
         */
         void updateCompositeMapWithDelay(Real delay = 2);
 
+        /** Render pending tiles of the composite map.
+        @remarks
+            When TerrainGlobalOptions::setCompositeMapUpdateBudget is used, 
+            updateCompositeMap only queues the dirty tiles, and this is called
+            once per frame to render them. 
+        @param budget Time in milliseconds after which to stop rendering tiles, 
+            at least one tile is always rendered. A negative value renders all
+            pending tiles.
+        */
+        void updateCompositeMapTiles(Real budget = -1);
+
 
         /** The default size of 'skirts' used to hide terrain cracks
             (default 10, set for new Terrain using TerrainGlobalOptions)
@@ -1264,6 +1308,18 @@ namespace Ogre
         */
         PixelBox* calculateNormals(const Rect& rect, Rect& outFinalRect);
 
+        /** Calculate the area of the normal map affected by a change to the 
+            heights, in terrain point space.
+        @param rect Rectangle describing the area of heights that were changed
+        */
+        Rect calculateNormalsRect(const Rect& rect);
+
+        /** Calculate the normals of exactly the given area, without widening it.
+        @param rect Rectangle describing the area of normals to calculate
+        @return Pointer to a PixelBox full of normals (caller responsible for deletion)
+        */
+        PixelBox* calculateNormalsTile(const Rect& rect);
+
         /** Finalise the normals. 
         Calculated normals are kept in a separate calculation area to make
         them safe to perform in a background thread. This call promotes those
@@ -1282,6 +1338,21 @@ namespace Ogre
         */
         PixelBox* calculateLightmap(const Rect& rect, const Rect& extraTargetRect, Rect& outFinalRect);
 
+        /** Calculate the area of the lightmap affected by a change, in lightmap 
+            image space (not inverted in Y).
+        @param rect Rectangle describing the area of heights that were changed
+        @param extraTargetRect Rectangle describing a target area of the terrain that
+            needs to be calculated additionally (e.g. from a neighbour)
+        */
+        Rect calculateLightmapRect(const Rect& rect, const Rect& extraTargetRect);
+
+        /** Calculate the lighting of exactly the given area of the lightmap.
+        @param rect Rectangle describing the area in lightmap image space, as
+            returned by calculateLightmapRect
+        @return Pointer to a PixelBox full of lighting data (caller responsible for deletion)
+        */
+        PixelBox* calculateLightmapTile(const Rect& rect);
+
         /** Finalise the lightmap. 
         Calculating lightmaps is kept in a separate calculation area to make
         it safe to perform in a background thread. This call promotes those
@@ -1309,6 +1380,20 @@ namespace Ogre
          */
         std::pair<bool, Vector3> rayIntersects(const Ray& ray, 
             bool cascadeToNeighbours = false, Real distanceLimit = 0); //const;
+
+        /** Test for intersection of several rays with the terrain. 
+         @param rays Array of rays to test for intersection
+         @param count Number of rays
+         @param results Array of count results, receiving whether each ray hit
+            the terrain and, if so, where
+         @param cascadeToNeighbours Whether the rays will be projected onto neighbours if
+            no intersection is found
+         @param distanceLimit The distance from the ray origin at which we will stop looking,
+            0 indicates no limit
+         @see rayIntersects
+         */
+        void rayIntersects(const Ray* rays, size_t count, std::pair<bool, Vector3>* results,
+            bool cascadeToNeighbours = false, Real distanceLimit = 0);
         
         /// Get the AABB (local coords) of the entire terrain
         const AxisAlignedBox& getAABB() const;
@@ -1540,6 +1625,8 @@ namespace Ogre
 
         static const uint16 WORKQUEUE_DERIVED_DATA_REQUEST;
         static const uint16 WORKQUEUE_GENERATE_MATERIAL_REQUEST;
+        /// Number of tiles along each side of the composite map for time-sliced updates
+        static const long COMPOSITE_MAP_TILES;
 
         /// Utility method, get the first LOD Level at which this vertex is no longer included
         uint16 getLODLevelWhenVertexEliminated(long x, long y) const;
@@ -1687,6 +1774,8 @@ namespace Ogre
         void calculateCurrentLod(Viewport* vp);
         /// Test a single quad of the terrain for ray intersection.
         std::pair<bool, Vector3> checkQuadIntersection(int x, int y, const Ray& ray); //const;
+        /// Update the min/max height pyramid used by rayIntersects for the given point area
+        void updateRayHeightBounds(const Rect& rect);
 
         /// Delete blend maps for all layers >= lowIndex
         void deleteBlendMaps(uint8 lowIndex);
@@ -1730,6 +1819,11 @@ namespace Ogre
         float* mHeightData;
         /// The delta information defining how a vertex moves before it is removed at a lower LOD
         float* mDeltaData;
+        /** Min/max heights of square blocks of 2^level quads, level 0 first, 
+            used to skip empty space in rayIntersects */
+        vector<float>::type mRayHeightBounds;
+        /// Offset of each level in mRayHeightBounds
+        vector<size_t>::type mRayHeightBoundsOffsets;
         Alignment mAlign;
         Real mWorldSize;
         uint16 mSize;
@@ -1760,6 +1854,8 @@ namespace Ogre
         bool mDerivedDataUpdateInProgress;
         /// If another update is requested while one is already running
         uint8 mDerivedUpdatePendingMask;
+        /// Number of outstanding requests for the current derived data stage
+        size_t mDerivedDataTilesPending;
 
         bool mGenerateMaterialInProgress;
         /// Don't release Height/DeltaData when preparing
@@ -1772,6 +1868,8 @@ namespace Ogre
             uint8 typeMask;
             Rect dirtyRect;
             Rect lightmapExtraDirtyRect;
+            /// Part of the normal map or lightmap calculated by this request
+            Rect tileRect;
             _OgreTerrainExport friend std::ostream& operator<<(std::ostream& o, const DerivedDataRequest& r)
             { return o; }       
         };
@@ -1845,6 +1943,10 @@ namespace Ogre
         unsigned long mLastMillis;
         /// True if the updates included lightmap changes (widen)
         bool mCompositeMapDirtyRectLightmapUpdate;
+        /// Tiles of the composite map waiting to be rendered, row by row
+        vector<bool>::type mCompositeMapPendingTiles;
+        size_t mCompositeMapPendingTileCount;
+        unsigned long mCompositeMapTileFrame;
         mutable MaterialPtr mCompositeMapMaterial;
 
 
@@ -1891,6 +1993,8 @@ namespace Ogre
         int getHighestLodPrepared() const { return (mLodManager) ? mLodManager->getHighestLodPrepared() : -1; };
         int getHighestLodLoaded() const { return (mLodManager) ? mLodManager->getHighestLodLoaded() : -1; };
         int getTargetLodLevel() const { return (mLodManager) ? mLodManager->getTargetLodLevel() : -1; };
+        /// Whether a LOD level increase is being prepared in the background
+        bool isLodLoadInProgress() const { return (mLodManager) ? mLodManager->isLoadInProgress() : false; };
     };
 
 
@@ -1926,10 +2030,16 @@ namespace Ogre
         Real mCompositeMapDistance;
         String mResourceGroup;
         bool mUseVertexCompressionWhenAvailable;
+        bool mUseGpuDerivedData;
+        TerrainGpuDerivedData* mGpuDerivedData;
+        bool mUseQuantisedHeightData;
+        bool mUseSharedGpuBufferAllocator;
+        Terrain::DefaultGpuBufferAllocator mSharedGpuBufferAllocator;
+        Real mCompositeMapUpdateBudget;
 
     public:
         TerrainGlobalOptions();
-        virtual ~TerrainGlobalOptions() {}
+        virtual ~TerrainGlobalOptions();
 
 
         /** The default size of 'skirts' used to hide terrain cracks
@@ -1958,6 +2068,16 @@ namespace Ogre
         Real getCompositeMapDistance() const { return mCompositeMapDistance; }
         /// Set the distance at which to start using a composite map if present
         void setCompositeMapDistance(Real c) { mCompositeMapDistance = c; }
+        /// Get the time per frame to spend rendering composite map tiles, in milliseconds
+        Real getCompositeMapUpdateBudget() const { return mCompositeMapUpdateBudget; }
+        /** Set the time per frame to spend rendering composite map tiles, in milliseconds.
+        @remarks
+            By default (0) Terrain::updateCompositeMap renders the whole dirty
+            area at once. Otherwise the area is split into tiles, which each
+            terrain renders across the following frames until it has spent this
+            long in a frame, so that painting large areas doesn't stall a frame.
+        */
+        void setCompositeMapUpdateBudget(Real ms) { mCompositeMapUpdateBudget = ms; }
 
 
         /** Whether the terrain will be able to cast shadows (texture shadows
@@ -2106,6 +2226,63 @@ namespace Ogre
          */
         void setUseVertexCompressionWhenAvailable(bool enable) { mUseVertexCompressionWhenAvailable = enable; }
 
+        /** Whether to calculate normal maps and lightmaps on the GPU when 
+            supported.
+        @see TerrainGpuDerivedData
+        */
+        bool getUseGpuDerivedData() const { return mUseGpuDerivedData; }
+
+        /** Set whether to calculate normal maps and lightmaps on the GPU when 
+            supported.
+        @remarks
+            The GPU calculation is done on the render thread when the derived data
+            is updated, instead of in a background request, and is much faster 
+            for lightmaps. When it is not supported by the render system the CPU 
+            calculation is used. The default is false.
+        @note You should only call this before creating any terrain instances.
+        @see TerrainGpuDerivedData
+        */
+        void setUseGpuDerivedData(bool enable);
+
+        /** Internal method to get the GPU derived data calculator, or null if 
+            it is not enabled or not supported. */
+        TerrainGpuDerivedData* _getGpuDerivedData();
+
+        /** Whether terrain heights are saved as 16-bit values. */
+        bool getUseQuantisedHeightData() const { return mUseQuantisedHeightData; }
+
+        /** Set whether terrain heights are saved as 16-bit values.
+        @remarks
+            When enabled, Terrain::save stores the heights of each LOD level as 
+            16-bit steps between the lowest and highest point of the terrain, 
+            and the LOD deltas as signed 16-bit steps of the same range, which
+            halves the size of the geometry data on disk and the I/O needed to 
+            stream in finer LOD levels. The precision is the height range of the
+            terrain divided by 65535. Terrains saved either way can be loaded
+            regardless of this setting. The default is false.
+        */
+        void setUseQuantisedHeightData(bool enable) { mUseQuantisedHeightData = enable; }
+
+        /** Whether all terrains share one pool of GPU vertex buffers. */
+        bool getUseSharedGpuBufferAllocator() const { return mUseSharedGpuBufferAllocator; }
+
+        /** Set whether all terrains share one pool of GPU vertex buffers.
+        @remarks
+            By default each Terrain, or each TerrainGroup, keeps its own pool of
+            freed vertex buffers. When enabled, all terrains which don't have a
+            custom allocator use getSharedGpuBufferAllocator() instead, so that
+            buffers freed by terrains being unloaded are reused by the terrains 
+            being loaded anywhere, and the pool statistics cover every terrain.
+        @note You should only call this when no terrain instances are loaded.
+        */
+        void setUseSharedGpuBufferAllocator(bool enable) { mUseSharedGpuBufferAllocator = enable; }
+
+        /** Get the buffer allocator shared by all terrains. 
+        @remarks
+            Call freeAllBuffers() on it before shutting down the render system.
+        */
+        Terrain::DefaultGpuBufferAllocator& getSharedGpuBufferAllocator() { return mSharedGpuBufferAllocator; }
+
         /** Override standard Singleton retrieval.
         @remarks
         Why do we do this? Well, it's because the Singleton
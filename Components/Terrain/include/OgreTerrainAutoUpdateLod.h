@@ -30,6 +30,7 @@ THE SOFTWARE.
 #define __Ogre_TerrainAutoUpdateLod_H__
 
 #include "OgreTerrainPrerequisites.h"
+#include "OgreVector3.h"
 
 namespace Ogre
 {
@@ -60,14 +61,22 @@ namespace Ogre
             @param data Any user specific data.
         */
         virtual void autoUpdateLod(Terrain *terrain, bool synchronous, const Any &data) = 0;
+        /** Method to be called to change the LOD level of all terrains in a group.
+            @remarks The default implementation calls autoUpdateLod for each terrain.
+            @param group The group whose terrains' LOD levels are going to be changed
+            @param synchronous Run this as part of main thread or in background
+            @param data Any user specific data.
+        */
+        virtual void autoUpdateLodAll(TerrainGroup *group, bool synchronous, const Any &data);
         virtual uint32 getStrategyId() = 0;
     };
 
-    // other Strategy's id start from 2
+    // other Strategy's id start from 3
     enum TerrainAutoUpdateLodStrategy
     {
         NONE = 0,
-        BY_DISTANCE = 1
+        BY_DISTANCE = 1,
+        BY_SCREEN_ERROR = 2
     };
 
     /** Class implementing TerrainAutoUpdateLod interface. It does LOD level increase/decrease according to camera's
@@ -88,6 +97,50 @@ namespace Ogre
         int traverseTreeByDistance(TerrainQuadTreeNode *node, const Camera *cam, Real cFactor, const Real holdDistance);
     };
 
+    /** Class implementing TerrainAutoUpdateLod interface which schedules LOD level loads of a whole TerrainGroup.
+    @remarks
+        Target LOD levels are chosen by distance like TerrainAutoUpdateLodByDistance, and LOD decreases are 
+        applied at once. LOD increases of all terrains in the group are ranked by their estimated screen space 
+        error, using the camera position predicted from its velocity, and only a limited number of terrains 
+        load at the same time. Terrains whose load is in flight get their target updated, so loads which are 
+        no longer needed stop at the level that is wanted now.
+    @par
+        Call TerrainGroup::autoUpdateLodAll every frame with the hold distance as data, like BY_DISTANCE.
+    */
+    class _OgreTerrainExport TerrainAutoUpdateLodByScreenError : public TerrainAutoUpdateLodByDistance
+    {
+    public:
+        TerrainAutoUpdateLodByScreenError();
+        virtual void autoUpdateLodAll(TerrainGroup *group, bool synchronous, const Any &data);
+        virtual uint32 getStrategyId() { return BY_SCREEN_ERROR; }
+
+        /// Set the maximum number of terrains loading LOD levels at the same time (default 2)
+        void setMaxConcurrentLoads(size_t loads) { mMaxConcurrentLoads = loads; }
+        size_t getMaxConcurrentLoads() const { return mMaxConcurrentLoads; }
+        /// Set how many seconds ahead the camera position is predicted (default 1)
+        void setLookAheadTime(Real seconds) { mLookAheadTime = seconds; }
+        Real getLookAheadTime() const { return mLookAheadTime; }
+
+    protected:
+        struct PendingLoad
+        {
+            Terrain *terrain;
+            int lodLevel;
+            Real priority;
+
+            bool operator<(const PendingLoad& rhs) const { return priority > rhs.priority; }
+        };
+        typedef vector<PendingLoad>::type PendingLoadList;
+
+        size_t mMaxConcurrentLoads;
+        Real mLookAheadTime;
+        bool mHasLastPosition;
+        Vector3 mLastPosition;
+        unsigned long mLastTime;
+        Vector3 mVelocity;
+        PendingLoadList mPendingLoads;
+    };
+
     class _OgreTerrainExport TerrainAutoUpdateLodFactory
     {
     public:
@@ -97,6 +150,8 @@ namespace Ogre
             {
             case BY_DISTANCE:
                 return OGRE_NEW TerrainAutoUpdateLodByDistance;
+            case BY_SCREEN_ERROR:
+                return OGRE_NEW TerrainAutoUpdateLodByScreenError;
             case NONE:
             default:
                 return 0;
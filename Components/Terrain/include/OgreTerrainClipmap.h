@@ -0,0 +1,189 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __Ogre_TerrainClipmap_H__
+#define __Ogre_TerrainClipmap_H__
+
+#include "OgreTerrainPrerequisites.h"
+#include "OgreMovableObject.h"
+#include "OgreRenderable.h"
+#include "OgreSceneManager.h"
+#include "OgreMaterial.h"
+#include "OgreTexture.h"
+
+
+namespace Ogre
+{
+    /** \addtogroup Optional
+    *  @{
+    */
+    /** \addtogroup Terrain
+    *  Some details on the terrain
+    *  @{
+    */
+
+    /** Renders the terrains of a TerrainGroup as GPU geometry clipmaps.
+    @remarks
+        This is an alternative to the chunked LOD rendering of Terrain, for
+        very large view distances. A single grid mesh is drawn once per level,
+        each level having twice the point spacing of the one before and being
+        centred on the viewer, so the number of draw calls and the vertex data
+        stay constant however far the view reaches. Heights are read in the
+        vertex program from a float texture per level, which is addressed
+        toroidally: when the viewer moves, only the rows and columns that
+        came into range are sampled from the terrain group.
+    @par
+        Each level discards the area covered by the finer level inside it,
+        and morphs its heights towards the coarser level near its outer edge
+        to avoid cracks. The default material uses simple lighting from the
+        TerrainGlobalOptions lightmap direction and composite map colours.
+    @par
+        The terrains of the group should not be rendered themselves while a
+        clipmap is in use, for example by setting their visibility flags to 0.
+        Call dirty() after the heights of the group change. GLSL 1.50 or
+        Shader Model 4 HLSL with vertex texture fetch is required, see
+        isSupported().
+    */
+    class _OgreTerrainExport TerrainClipmap : public SceneManager::Listener, public TerrainAlloc
+    {
+    public:
+        /** Constructor.
+        @param group The terrain group to render
+        @param numLevels The number of clipmap levels
+        @param gridSize The number of quads along each side of a level, must
+            be a multiple of 4
+        */
+        TerrainClipmap(TerrainGroup* group, uint16 numLevels = 8, uint16 gridSize = 64);
+        virtual ~TerrainClipmap();
+
+        /** Whether the current render system can render clipmaps. */
+        static bool isSupported(void);
+
+        /** Centre the levels on a new view position, sampling the heights that
+            came into range. This is called automatically before each camera
+            renders the scene.
+        */
+        void update(const Vector3& viewPos);
+
+        /** Resample all the heights on the next update, after the heights of
+            the terrain group have changed. */
+        void dirty(void);
+
+        /** Set the material to render with.
+        @remarks
+            The material is cloned for each level, and the first texture unit
+            of each pass receives the height texture of the level. Vertex
+            programs should use the same custom parameters as the default
+            material: 0 for the level grid origin, spacing and texture size,
+            1 for the area covered by the finer level and 2 for the morph range.
+        */
+        void setMaterial(const MaterialPtr& mat);
+        /// Get the material used by the clipmap levels
+        const MaterialPtr& getMaterial(void) const { return mMaterial; }
+
+        /// Get the number of clipmap levels
+        uint16 getNumLevels(void) const { return static_cast<uint16>(mLevels.size()); }
+        /// Get the number of quads along each side of a level
+        uint16 getGridSize(void) const { return mGridSize; }
+        /// Get the point spacing of the finest level, in world units
+        Real getBaseSpacing(void) const { return mBaseSpacing; }
+        /// Get the scene node the clipmap is attached to
+        SceneNode* getSceneNode(void) const { return mNode; }
+
+        /// Overridden from SceneManager::Listener
+        void preFindVisibleObjects(SceneManager* source,
+            SceneManager::IlluminationRenderStage irs, Viewport* v);
+
+    protected:
+        /// One clipmap level
+        class _OgreTerrainExport Level : public Renderable, public TerrainAlloc
+        {
+        public:
+            Level(TerrainClipmap* parent, uint16 index);
+            virtual ~Level();
+
+            TerrainClipmap* mParent;
+            uint16 mIndex;
+            /// Point spacing in world units
+            Real mSpacing;
+            /// Grid coordinates of the first point, always even
+            long mOriginX, mOriginY;
+            bool mValid;
+            TexturePtr mHeightMap;
+            /// CPU copy of mHeightMap
+            vector<float>::type mHeights;
+            MaterialPtr mMaterial;
+
+            const MaterialPtr& getMaterial(void) const { return mMaterial; }
+            void getRenderOperation(RenderOperation& op);
+            void getWorldTransforms(Matrix4* xform) const;
+            Real getSquaredViewDepth(const Camera* cam) const;
+            const LightList& getLights(void) const;
+            bool getCastsShadows(void) const { return false; }
+        };
+        typedef vector<Level*>::type LevelList;
+
+        /// Hook to the render queue
+        class _OgreTerrainExport Movable : public MovableObject
+        {
+        protected:
+            TerrainClipmap* mParent;
+            AxisAlignedBox mBox;
+        public:
+            Movable(TerrainClipmap* parent);
+            virtual ~Movable();
+
+            const String& getMovableType(void) const;
+            const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+            Real getBoundingRadius(void) const { return 0; }
+            void _updateRenderQueue(RenderQueue* queue);
+            void visitRenderables(Renderable::Visitor* visitor, bool debugRenderables = false);
+        };
+
+        TerrainGroup* mGroup;
+        uint16 mGridSize;
+        Real mBaseSpacing;
+        String mName;
+        LevelList mLevels;
+        Movable* mMovable;
+        SceneNode* mNode;
+        VertexData* mVertexData;
+        IndexData* mIndexData;
+        MaterialPtr mMaterial;
+        bool mDefaultMaterial;
+
+        void createGeometry(void);
+        void createDefaultMaterial(void);
+        void updateLevel(Level* level, long originX, long originY);
+        float sampleHeight(Real x, Real y);
+    };
+    /** @} */
+    /** @} */
+}
+
+#endif
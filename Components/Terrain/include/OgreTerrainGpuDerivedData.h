@@ -0,0 +1,113 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __Ogre_TerrainGpuDerivedData_H__
+#define __Ogre_TerrainGpuDerivedData_H__
+
+#include "OgreTerrainPrerequisites.h"
+#include "OgreCommon.h"
+#include "OgreMaterial.h"
+#include "OgreTexture.h"
+
+
+namespace Ogre
+{
+    class Terrain;
+    /** \addtogroup Optional
+    *  @{
+    */
+    /** \addtogroup Terrain
+    *  Some details on the terrain
+    *  @{
+    */
+
+    /** Calculates terrain normal maps and lightmaps on the GPU.
+    @remarks
+        Terrain normal maps and lightmaps are normally calculated on the CPU
+        in a background request and then uploaded, which takes a long time for 
+        the lightmap in particular. When TerrainGlobalOptions::setUseGpuDerivedData
+        is enabled and this class is supported, they are instead rendered 
+        straight into the terrain textures on the render thread, from a height 
+        texture holding the terrain heights plus a border taken from the 
+        neighbouring terrains.
+    @par
+        This uses the same render-to-texture approach as composite map 
+        generation, with GLSL 1.50 or Shader Model 4 HLSL programs. Height 
+        deltas are still calculated on the CPU, since they are needed there 
+        for the LOD vertex data.
+    @note
+        Lightmap shadows are only cast by this terrain and its border, not by 
+        terrains further away as the CPU calculation does.
+    */
+    class _OgreTerrainExport TerrainGpuDerivedData : public TerrainAlloc
+    {
+    public:
+        TerrainGpuDerivedData();
+        virtual ~TerrainGpuDerivedData();
+
+        /** Whether the current render system can run the GPU calculations. */
+        static bool isSupported(void);
+
+        /** Calculates the normals of a region of the terrain into its normal map.
+        @param terrain The terrain, which must have its normal map created
+        @param rect The region to update in point space, right and bottom exclusive
+        */
+        void updateNormals(Terrain* terrain, const Rect& rect);
+
+        /** Calculates the lighting of a region of the terrain into its lightmap.
+        @param terrain The terrain, which must have its lightmap created
+        @param rect The region to update in lightmap image space, right and 
+            bottom exclusive
+        */
+        void updateLightmap(Terrain* terrain, const Rect& rect);
+
+    protected:
+        SceneManager* mSceneMgr;
+        Camera* mCamera;
+        ManualObject* mQuad;
+        /// Terrain heights with a one point border, as float
+        TexturePtr mHeightMap;
+        /// Staging for mHeightMap
+        vector<float>::type mHeightData;
+        MaterialPtr mNormalMaterial;
+        MaterialPtr mLightmapMaterial;
+        /// Render targets, used when the destination texture cannot be rendered to directly
+        TexturePtr mNormalRTT;
+        TexturePtr mLightmapRTT;
+        String mShaderLanguage;
+
+        void createScene(void);
+        void updateHeightMap(const Terrain* terrain);
+        MaterialPtr createMaterial(const String& name, const String& fpSource);
+        void render(const MaterialPtr& mat, const TexturePtr& dest, TexturePtr& rtt, const Rect& rect);
+    };
+    /** @} */
+    /** @} */
+}
+
+#endif
@@ -416,6 +416,17 @@ namespace Ogre
          the terrain data occurs.
          */
         RayResult rayIntersects(const Ray& ray, Real distanceLimit = 0) const; 
+
+        /** Test for intersection of several rays with any terrain in the group. 
+        @param rays Array of rays to test for intersection
+        @param count Number of rays
+        @param results Array of count results
+        @param distanceLimit The distance from the ray origin at which we will stop looking,
+            0 indicates no limit
+        @see rayIntersects
+        */
+        void rayIntersects(const Ray* rays, size_t count, RayResult* results, 
+            Real distanceLimit = 0) const;
         
         typedef vector<Terrain*>::type TerrainList; 
         /** Test intersection of a box with the terrain. 
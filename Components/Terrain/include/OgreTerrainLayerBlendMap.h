@@ -55,6 +55,11 @@ namespace Ogre
     floating point, which gives you full precision for updating, but in fact the
     values are packed into 8-bit integers in the actual blend map.
     @par
+    The CPU copy of the blend map is kept in the same 8-bit form. Full precision
+    values are only held for the tiles of the map which have been edited through
+    the floating point interface, or for the whole map once getBlendPointer has
+    been called. Only the edited tiles are uploaded by update().
+    @par
     You shouldn't construct this class directly, use Terrain::getLayerBlendMap().
     */
     class _OgreTerrainExport TerrainLayerBlendMap : public TerrainAlloc
@@ -67,10 +72,26 @@ namespace Ogre
         Box mDirtyBox;
         bool mDirty;
         HardwarePixelBuffer* mBuffer;
-        float* mData;
+        /// Blend values as stored in the blend texture, one byte per texel
+        uint8* mData;
+        /// Full precision copy of the whole map, only allocated by getBlendPointer
+        float* mFloatData;
+        typedef vector<float*>::type TileList;
+        /// Full precision copies of the edited tiles, null for the others
+        TileList mTiles;
+        vector<bool>::type mDirtyTiles;
+        size_t mTilesX;
+        size_t mTilesY;
+        /// Number of texels along each side of a tile
+        static const size_t TILE_SIZE;
 
         void download();
-        void upload();
+        /// Get the full precision copy of a tile, optionally creating it from the 8-bit data
+        float* getTile(size_t tileX, size_t tileY, bool create);
+        /// Update the full precision copies after the 8-bit data changed
+        void refreshFloatData(const Box& box);
+        /// Pack the full precision data of part of a tile into the 8-bit data
+        void packTile(size_t tileX, size_t tileY, const Box& box);
 
     public:
         /** Constructor
@@ -134,6 +155,28 @@ namespace Ogre
             if you want those changes to be recognised. 
         */
         float* getBlendPointer();
+        /** Get a pointer to the blend data in the form stored in the blend 
+            texture, one byte per texel (0 = transparent, 255 = solid).
+        @remarks
+            This is the cheapest way to make bulk changes, since no values are 
+            converted to floating point. Edits made through the floating point
+            interface are packed first. You must call dirtyRect manually for 
+            your changes to be recognised, and shouldn't combine this with 
+            getBlendPointer, whose data takes precedence.
+        */
+        uint8* getPackedBlendPointer();
+        /** Add a weighted amount to the blend values of a rectangle, clamping
+            the results between 0 and 1.
+        @remarks 
+            Only the tiles touched by the rectangle are kept in full precision, 
+            so that small amounts accumulated over many calls, as when painting
+            with a brush, are not lost to 8-bit rounding.
+        @param rect Rectangle in image space
+        @param weights One weight per texel of the rectangle, row by row, or null
+            to weight every texel by 1
+        @param amount The amount to add, negative to remove
+        */
+        void addBlendValues(const Rect& rect, const float* weights, float amount);
 
         /** Indicate that all of the blend data is dirty and needs updating.
         */
@@ -116,6 +116,7 @@ namespace Ogre
         int getHighestLodPrepared(){ return mHighestLodPrepared; }
         int getHighestLodLoaded(){ return mHighestLodLoaded; }
         int getTargetLodLevel(){ return mTargetLodLevel; }
+        bool isLoadInProgress() const { return mIncreaseLodLevelInProgress; }
 
         LodInfo& getLodInfo(uint lodLevel)
         {
@@ -35,9 +35,13 @@ namespace Ogre
 {
     // forward decls
     class Terrain;
+    class TerrainClipmap;
+    class TerrainGpuDerivedData;
+    class TerrainGroup;
     class TerrainPageContent;
     class TerrainPageContentFactory;
     class TerrainQuadTreeNode;
+    class TerrainTessellation;
 
 
     typedef GeneralAllocatedObject TerrainAlloc;
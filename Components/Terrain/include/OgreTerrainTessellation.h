@@ -0,0 +1,143 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __Ogre_TerrainTessellation_H__
+#define __Ogre_TerrainTessellation_H__
+
+#include "OgreTerrainPrerequisites.h"
+#include "OgreSimpleRenderable.h"
+#include "OgreMaterial.h"
+#include "OgreTexture.h"
+
+
+namespace Ogre
+{
+    /** \addtogroup Optional
+    *  @{
+    */
+    /** \addtogroup Terrain
+    *  Some details on the terrain
+    *  @{
+    */
+
+    /** Renders a Terrain with hardware tessellation.
+    @remarks
+        This is an alternative to the chunked LOD rendering of Terrain. The
+        terrain is submitted as a fixed grid of coarse quad patches, and the
+        hull (tessellation control) program subdivides each patch edge according
+        to its projected length on screen, so detail follows the view without
+        any LOD selection or vertex data on the CPU side. The domain
+        (tessellation evaluation) program displaces the generated vertices
+        with a float texture of the terrain heights.
+    @par
+        The default material lights the terrain with the terrain normal map and
+        the TerrainGlobalOptions lightmap direction, and colours it with the
+        composite map if the terrain has one. The terrain itself should not
+        be rendered while this is in use, for example by setting its visibility
+        flags to 0. Call updateHeights() after the heights of the terrain
+        change. GLSL 4.00 or Shader Model 5 HLSL is required, see isSupported().
+    */
+    class _OgreTerrainExport TerrainTessellation : public TerrainAlloc
+    {
+    public:
+        /** Constructor.
+        @param terrain The terrain to render, which must be loaded
+        @param patchesPerSide The number of patches along each side of the terrain
+        */
+        TerrainTessellation(Terrain* terrain, uint16 patchesPerSide = 32);
+        virtual ~TerrainTessellation();
+
+        /** Whether the current render system can render tessellated terrain. */
+        static bool isSupported(void);
+
+        /** Upload the heights of the terrain again, after they have changed. */
+        void updateHeights(void);
+
+        /** Set the material to render with.
+        @remarks
+            The material is cloned, and the first three texture units of each
+            pass receive the height texture (bound to the domain program), the
+            terrain normal map and the composite map. Programs should use the
+            same custom parameters as the default material: 0 for the terrain
+            base, world size and size in points, 1 for the target pixels per
+            patch edge, mean height and maximum tessellation factor.
+        */
+        void setMaterial(const MaterialPtr& mat);
+        /// Get the material used to render
+        const MaterialPtr& getMaterial(void) const { return mMaterial; }
+
+        /** Set the projected length of a tessellated edge to aim for, in pixels
+            (default 8). */
+        void setPixelsPerEdge(Real pixels);
+        /// Get the projected length of a tessellated edge to aim for, in pixels
+        Real getPixelsPerEdge(void) const { return mPixelsPerEdge; }
+
+        /// Get the number of patches along each side of the terrain
+        uint16 getPatchesPerSide(void) const { return mPatchesPerSide; }
+        /// Get the texture holding the terrain heights
+        const TexturePtr& getHeightMap(void) const { return mHeightMap; }
+        /// Get the scene node the patches are attached to
+        SceneNode* getSceneNode(void) const { return mNode; }
+
+    protected:
+        /// The patch grid, rendered in one call
+        class _OgreTerrainExport Patches : public SimpleRenderable
+        {
+        public:
+            Patches(TerrainTessellation* parent);
+            virtual ~Patches();
+
+            Real getSquaredViewDepth(const Camera* cam) const;
+            Real getBoundingRadius(void) const;
+            bool getCastsShadows(void) const { return false; }
+
+            TerrainTessellation* mParent;
+        };
+
+        Terrain* mTerrain;
+        uint16 mPatchesPerSide;
+        Real mPixelsPerEdge;
+        String mName;
+        Patches* mPatches;
+        SceneNode* mNode;
+        VertexData* mVertexData;
+        IndexData* mIndexData;
+        TexturePtr mHeightMap;
+        MaterialPtr mMaterial;
+        MaterialPtr mPatchMaterial;
+        bool mDefaultMaterial;
+
+        void createGeometry(void);
+        void createDefaultMaterial(void);
+        void updateParams(void);
+    };
+    /** @} */
+    /** @} */
+}
+
+#endif
@@ -48,6 +48,7 @@ THE SOFTWARE.
 #include "OgreMaterialManager.h"
 #include "OgreTimer.h"
 #include "OgreTerrainMaterialGeneratorA.h"
+#include "OgreTerrainGpuDerivedData.h"
 
 #if OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS
 #include "macUtils.h"
@@ -79,6 +80,7 @@ namespace Ogre
     const uint16 Terrain::WORKQUEUE_DERIVED_DATA_REQUEST = 1;
     const uint64 Terrain::TERRAIN_GENERATE_MATERIAL_INTERVAL_MS = 400;
     const uint16 Terrain::WORKQUEUE_GENERATE_MATERIAL_REQUEST = 2;
+    const long Terrain::COMPOSITE_MAP_TILES = 8;
     const size_t Terrain::LOD_MORPH_CUSTOM_PARAM = 1001;
     const uint8 Terrain::DERIVED_DATA_DELTAS = 1;
     const uint8 Terrain::DERIVED_DATA_NORMALS = 2;
@@ -115,9 +117,36 @@ namespace Ogre
         , mCompositeMapDistance(4000)
         , mResourceGroup(ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME)
         , mUseVertexCompressionWhenAvailable(true)
+        , mUseGpuDerivedData(false)
+        , mGpuDerivedData(0)
+        , mUseQuantisedHeightData(false)
+        , mUseSharedGpuBufferAllocator(false)
+        , mCompositeMapUpdateBudget(0)
     {
     }
     //---------------------------------------------------------------------
+    TerrainGlobalOptions::~TerrainGlobalOptions()
+    {
+        OGRE_DELETE mGpuDerivedData;
+    }
+    //---------------------------------------------------------------------
+    void TerrainGlobalOptions::setUseGpuDerivedData(bool enable)
+    {
+        mUseGpuDerivedData = enable;
+        if (!enable)
+        {
+            OGRE_DELETE mGpuDerivedData;
+            mGpuDerivedData = 0;
+        }
+    }
+    //---------------------------------------------------------------------
+    TerrainGpuDerivedData* TerrainGlobalOptions::_getGpuDerivedData()
+    {
+        if (mUseGpuDerivedData && !mGpuDerivedData && TerrainGpuDerivedData::isSupported())
+            mGpuDerivedData = OGRE_NEW TerrainGpuDerivedData();
+        return mGpuDerivedData;
+    }
+    //---------------------------------------------------------------------
     void TerrainGlobalOptions::setDefaultMaterialGenerator(TerrainMaterialGeneratorPtr gen)
     {
         mDefaultMaterialGenerator = gen;
@@ -167,6 +196,7 @@ namespace Ogre
         , mDirtyLightmapFromNeighboursRect(0, 0, 0, 0)
         , mDerivedDataUpdateInProgress(false)
         , mDerivedUpdatePendingMask(0)
+        , mDerivedDataTilesPending(0)
         , mGenerateMaterialInProgress(false)
         , mPrepareInProgress(false)
         , mMaterialGenerationCount(0)
@@ -187,6 +217,8 @@ namespace Ogre
         , mCompositeMapUpdateCountdown(0)
         , mLastMillis(0)
         , mCompositeMapDirtyRectLightmapUpdate(false)
+        , mCompositeMapPendingTileCount(0)
+        , mCompositeMapTileFrame(0)
         , mLodMorphRequired(false)
         , mNormalMapRequired(false)
         , mLightMapRequired(false)
@@ -301,6 +333,7 @@ namespace Ogre
     {
         // wait for any queued processes to finish
         waitForDerivedProcesses();
+        updateCompositeMapTiles();
 
         if (mHeightDataModified)
         {
@@ -778,6 +811,8 @@ namespace Ogre
 
         stream.readChunkEnd(TERRAIN_CHUNK_ID);
 
+        updateRayHeightBounds(Rect(0, 0, mSize, mSize));
+
         mModified = false;
         mHeightDataModified = false;
 
@@ -912,6 +947,7 @@ namespace Ogre
         rect.left = 0; rect.right = mSize;
         calculateHeightDeltas(rect);
         finaliseHeightDeltas(rect, true);
+        updateRayHeightBounds(rect);
 
         distributeVertexData();
 
@@ -1867,6 +1903,7 @@ namespace Ogre
         mDirtyGeometryRectForNeighbours.merge(rect);
         mDirtyDerivedDataRect.merge(rect);
         mCompositeMapDirtyRect.merge(rect);
+        updateRayHeightBounds(rect);
 
         mModified = true;
         mHeightDataModified = true;
@@ -1968,9 +2005,68 @@ namespace Ogre
         if (!mLightMapRequired)
             req.typeMask = req.typeMask & ~DERIVED_DATA_LIGHTMAP;
 
-        Root::getSingleton().getWorkQueue()->addRequest(
-            mWorkQueueChannel, WORKQUEUE_DERIVED_DATA_REQUEST, 
-            Any(req), 0, synchronous);
+        TerrainGpuDerivedData* gpuDerivedData = TerrainGlobalOptions::getSingleton()._getGpuDerivedData();
+        if (gpuDerivedData && (req.typeMask & (DERIVED_DATA_NORMALS | DERIVED_DATA_LIGHTMAP)))
+        {
+            // Render straight into the textures here instead of in the background
+            if (req.typeMask & DERIVED_DATA_NORMALS)
+            {
+                createOrDestroyGPUNormalMap();
+                if (!mTerrainNormalMap.isNull())
+                    gpuDerivedData->updateNormals(this, calculateNormalsRect(rect));
+                mCompositeMapDirtyRect.merge(rect);
+            }
+            if (req.typeMask & DERIVED_DATA_LIGHTMAP)
+            {
+                createOrDestroyGPULightmap();
+                if (!mLightmap.isNull())
+                    gpuDerivedData->updateLightmap(this, calculateLightmapRect(rect, lightmapExtraRect));
+                mCompositeMapDirtyRect.merge(rect);
+                mCompositeMapDirtyRectLightmapUpdate = true;
+            }
+            req.typeMask &= ~(DERIVED_DATA_NORMALS | DERIVED_DATA_LIGHTMAP);
+
+            if (!req.typeMask)
+            {
+                mDerivedDataUpdateInProgress = false;
+                if (mCompositeMapRequired)
+                    updateCompositeMap();
+                return;
+            }
+        }
+
+        // The normals and lightmap stages only read the heights, so split them
+        // into horizontal strips calculated on all the workers at once. Deltas
+        // update the quadtree and stay in a single request.
+        Rect stageRect(0, 0, 0, 0);
+        if (!(req.typeMask & DERIVED_DATA_DELTAS))
+        {
+            if (req.typeMask & DERIVED_DATA_NORMALS)
+                stageRect = calculateNormalsRect(rect);
+            else if (req.typeMask & DERIVED_DATA_LIGHTMAP)
+                stageRect = calculateLightmapRect(rect, lightmapExtraRect);
+        }
+
+        WorkQueue* wq = Root::getSingleton().getWorkQueue();
+        long tileCount = 1;
+        DefaultWorkQueueBase* defaultWq = dynamic_cast<DefaultWorkQueueBase*>(wq);
+        if (defaultWq && !synchronous)
+        {
+            const long minTileRows = 16;
+            tileCount = std::min((long)defaultWq->getWorkerThreadCount(), 
+                stageRect.height() / minTileRows);
+            tileCount = std::max(1L, tileCount);
+        }
+
+        mDerivedDataTilesPending = tileCount;
+        for (long i = 0; i < tileCount; ++i)
+        {
+            req.tileRect = stageRect;
+            req.tileRect.top = stageRect.top + stageRect.height() * i / tileCount;
+            req.tileRect.bottom = stageRect.top + stageRect.height() * (i + 1) / tileCount;
+            wq->addRequest(mWorkQueueChannel, WORKQUEUE_DERIVED_DATA_REQUEST, 
+                Any(req), 0, synchronous);
+        }
 
     }
     //---------------------------------------------------------------------
@@ -1993,6 +2089,9 @@ namespace Ogre
         OGRE_FREE(mDeltaData, MEMCATEGORY_GEOMETRY);
         mDeltaData = 0;
 
+        mRayHeightBounds.clear();
+        mRayHeightBoundsOffsets.clear();
+
         OGRE_DELETE mQuadTree;
         mQuadTree = 0;
 
@@ -2281,9 +2380,14 @@ namespace Ogre
                 updateCompositeMap();
         }
         mLastMillis = currMillis;
+        unsigned long frameNum = Root::getSingleton().getNextFrameNumber();
+        if (mCompositeMapPendingTileCount && mCompositeMapTileFrame != frameNum)
+        {
+            mCompositeMapTileFrame = frameNum;
+            updateCompositeMapTiles(TerrainGlobalOptions::getSingleton().getCompositeMapUpdateBudget());
+        }
         // only calculate LOD once per LOD camera, per frame, per viewport height
         const Camera* lodCamera = v->getCamera()->getLodCamera();
-        unsigned long frameNum = Root::getSingleton().getNextFrameNumber();
         int vpHeight = v->getActualHeight();
         if (mLastLODCamera != lodCamera || frameNum != mLastLODFrame
             || mLastViewportHeight != vpHeight)
@@ -2402,13 +2506,64 @@ namespace Ogre
 
         Result result(true, Vector3::ZERO);
         Real dummyHighValue = (Real)mSize * 10000.0f;
+        int numQuads = (int)mSize - 1;
+        int numBoundsLevels = (int)mRayHeightBoundsOffsets.size();
 
 
         while (cur.y >= (minHeight - 1e-3) && cur.y <= (maxHeight + 1e-3))
         {
-            if (quadX < 0 || quadX >= (int)mSize-1 || quadZ < 0 || quadZ >= (int)mSize-1)
+            if (quadX < 0 || quadX >= numQuads || quadZ < 0 || quadZ >= numQuads)
                 break;
 
+            // find the largest block around this quad which the ray passes 
+            // entirely above or below; if a block is missed, so are the 
+            // blocks inside it
+            int skipLevel = -1;
+            bool skipX = false;
+            Real skipDist = 0;
+            for (int level = 0; level < numBoundsLevels; ++level)
+            {
+                int blockSize = 1 << level;
+                int blockX = quadX >> level;
+                int blockZ = quadZ >> level;
+                const float* bounds = &mRayHeightBounds[mRayHeightBoundsOffsets[level] + 
+                    (blockZ * (numQuads >> level) + blockX) * 2];
+                Real xDist = Math::RealEqual(rayDirection.x, 0.0) ? dummyHighValue : 
+                    ((blockX + flipX) * blockSize - cur.x) / rayDirection.x;
+                Real zDist = Math::RealEqual(rayDirection.z, 0.0) ? dummyHighValue : 
+                    ((blockZ + flipZ) * blockSize - cur.z) / rayDirection.z;
+                Real dist = std::min(xDist, zDist);
+                Real exitY = cur.y + rayDirection.y * dist;
+                if (std::min(cur.y, exitY) <= bounds[1] + 1e-3 && 
+                    std::max(cur.y, exitY) >= bounds[0] - 1e-3)
+                    break;
+                skipLevel = level;
+                skipX = xDist < zDist;
+                skipDist = dist;
+            }
+
+            if (skipLevel >= 0)
+            {
+                // move to the quad after the block
+                int blockSize = 1 << skipLevel;
+                int blockX = (quadX >> skipLevel) * blockSize;
+                int blockZ = (quadZ >> skipLevel) * blockSize;
+                cur += rayDirection * skipDist;
+                if (skipX)
+                {
+                    quadX = xDir > 0 ? blockX + blockSize : blockX - 1;
+                    quadZ = std::min(std::max(static_cast<int>(cur.z), blockZ), 
+                        std::min(blockZ + blockSize, numQuads) - 1);
+                }
+                else
+                {
+                    quadZ = zDir > 0 ? blockZ + blockSize : blockZ - 1;
+                    quadX = std::min(std::max(static_cast<int>(cur.x), blockX), 
+                        std::min(blockX + blockSize, numQuads) - 1);
+                }
+                continue;
+            }
+
             result = checkQuadIntersection(quadX, quadZ, localRay);
             if (result.first)
                 break;
@@ -2465,6 +2620,75 @@ namespace Ogre
         return result;
     }
     //---------------------------------------------------------------------
+    void Terrain::rayIntersects(const Ray* rays, size_t count, std::pair<bool, Vector3>* results,
+        bool cascadeToNeighbours /* = false */, Real distanceLimit /* = 0 */)
+    {
+        for (size_t i = 0; i < count; ++i)
+            results[i] = rayIntersects(rays[i], cascadeToNeighbours, distanceLimit);
+    }
+    //---------------------------------------------------------------------
+    void Terrain::updateRayHeightBounds(const Rect& rect)
+    {
+        if (!mHeightData)
+            return;
+
+        long numQuads = mSize - 1;
+        if (mRayHeightBoundsOffsets.empty())
+        {
+            size_t total = 0;
+            for (long w = numQuads; w > 0; w >>= 1)
+            {
+                mRayHeightBoundsOffsets.push_back(total);
+                total += w * w * 2;
+            }
+            mRayHeightBounds.resize(total);
+            updateRayHeightBounds(Rect(0, 0, mSize, mSize));
+            return;
+        }
+
+        // quads touching the changed points
+        long left = std::max(0L, rect.left - 1L);
+        long top = std::max(0L, rect.top - 1L);
+        long right = std::min(numQuads, rect.right);
+        long bottom = std::min(numQuads, rect.bottom);
+
+        float* pBounds = &mRayHeightBounds[0];
+        for (long z = top; z < bottom; ++z)
+        {
+            for (long x = left; x < right; ++x)
+            {
+                const float* h = mHeightData + z * mSize + x;
+                float* pDst = pBounds + (z * numQuads + x) * 2;
+                pDst[0] = std::min(std::min(h[0], h[1]), std::min(h[mSize], h[mSize + 1]));
+                pDst[1] = std::max(std::max(h[0], h[1]), std::max(h[mSize], h[mSize + 1]));
+            }
+        }
+
+        // merge 2x2 blocks into the level above
+        for (size_t level = 1; level < mRayHeightBoundsOffsets.size(); ++level)
+        {
+            long srcWidth = numQuads >> (level - 1);
+            long width = numQuads >> level;
+            left >>= 1;
+            top >>= 1;
+            right = (right + 1) >> 1;
+            bottom = (bottom + 1) >> 1;
+            const float* pSrc = pBounds + mRayHeightBoundsOffsets[level - 1];
+            float* pDst = pBounds + mRayHeightBoundsOffsets[level];
+            for (long z = top; z < bottom; ++z)
+            {
+                for (long x = left; x < right; ++x)
+                {
+                    const float* s0 = pSrc + ((z * 2) * srcWidth + x * 2) * 2;
+                    const float* s1 = s0 + srcWidth * 2;
+                    float* d = pDst + (z * width + x) * 2;
+                    d[0] = std::min(std::min(s0[0], s0[2]), std::min(s1[0], s1[2]));
+                    d[1] = std::max(std::max(s0[1], s0[3]), std::max(s1[1], s1[3]));
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
     std::pair<bool, Vector3> Terrain::checkQuadIntersection(int x, int z, const Ray& ray)
     {
         // build the two planes belonging to the quad's triangles
@@ -2971,7 +3195,10 @@ namespace Ogre
             // create
             mTerrainNormalMap = TextureManager::getSingleton().createManual(
                 mMaterialName + "/nm", _getDerivedResourceGroup(), 
-                TEX_TYPE_2D, mSize, mSize, 1, 0, PF_BYTE_RGB, TU_STATIC);
+                TEX_TYPE_2D, mSize, mSize, 1, 0, 
+                // RGB cannot be rendered to on all render systems
+                TerrainGlobalOptions::getSingleton()._getGpuDerivedData() ? PF_BYTE_RGBA : PF_BYTE_RGB,
+                TU_STATIC);
 
             // Upload loaded normal data if present
             if (mCpuTerrainNormalMap)
@@ -3164,8 +3391,8 @@ namespace Ogre
 
         // Do only ONE type of task per background iteration, in order of priority
         // this means we return faster, can abort faster and we repeat less redundant calcs
-        // we don't do this as separate requests, because we only want one background
-        // task per Terrain instance in flight at once
+        // we don't do this as separate requests, because we only want one stage
+        // per Terrain instance in flight at once (split into tiles of tileRect)
         if (ddr.typeMask & DERIVED_DATA_DELTAS)
         {
             ddres.deltaUpdateRect = calculateHeightDeltas(ddr.dirtyRect);
@@ -3173,12 +3400,14 @@ namespace Ogre
         }
         else if (ddr.typeMask & DERIVED_DATA_NORMALS)
         {
-            ddres.normalMapBox = calculateNormals(ddr.dirtyRect, ddres.normalUpdateRect);
+            ddres.normalMapBox = calculateNormalsTile(ddr.tileRect);
+            ddres.normalUpdateRect = ddr.tileRect;
             ddres.remainingTypeMask &= ~ DERIVED_DATA_NORMALS;
         }
         else if (ddr.typeMask & DERIVED_DATA_LIGHTMAP)
         {
-            ddres.lightMapBox = calculateLightmap(ddr.dirtyRect, ddr.lightmapExtraDirtyRect, ddres.lightmapUpdateRect);
+            ddres.lightMapBox = calculateLightmapTile(ddr.tileRect);
+            ddres.lightmapUpdateRect = ddr.tileRect;
             ddres.remainingTypeMask &= ~ DERIVED_DATA_LIGHTMAP;
         }
 
@@ -3219,6 +3448,10 @@ namespace Ogre
             mCompositeMapDirtyRect.merge(ddreq.dirtyRect);
             mCompositeMapDirtyRectLightmapUpdate = true;
         }
+
+        // wait for the other tiles of this stage
+        if (--mDerivedDataTilesPending)
+            return;
         
         mDerivedDataUpdateInProgress = false;
 
@@ -3318,15 +3551,25 @@ namespace Ogre
     }
     //---------------------------------------------------------------------
     PixelBox* Terrain::calculateNormals(const Rect &rect, Rect& finalRect)
+    {
+        finalRect = calculateNormalsRect(rect);
+        return calculateNormalsTile(finalRect);
+    }
+    //---------------------------------------------------------------------
+    Rect Terrain::calculateNormalsRect(const Rect& rect)
     {
         // Widen the rectangle by 1 element in all directions since height
         // changes affect neighbours normals
-        Rect widenedRect(
+        return Rect(
             std::max(0L, rect.left - 1L), 
             std::max(0L, rect.top - 1L), 
             std::min((long)mSize, rect.right + 1L), 
             std::min((long)mSize, rect.bottom + 1L)
             );
+    }
+    //---------------------------------------------------------------------
+    PixelBox* Terrain::calculateNormalsTile(const Rect& widenedRect)
+    {
         // allocate memory for RGB
         uint8* pData = static_cast<uint8*>(
             OGRE_MALLOC(widenedRect.width() * widenedRect.height() * 3, MEMCATEGORY_GENERAL));
@@ -3384,8 +3627,6 @@ namespace Ogre
             }
         }
 
-        finalRect = widenedRect;
-
         return pixbox;
     }
     //---------------------------------------------------------------------
@@ -3480,7 +3721,7 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
-    PixelBox* Terrain::calculateLightmap(const Rect& rect, const Rect& extraTargetRect, Rect& outFinalRect)
+    Rect Terrain::calculateLightmapRect(const Rect& rect, const Rect& extraTargetRect)
     {
         // as well as calculating the lighting changes for the area that is
         // dirty, we also need to calculate the effect on casting shadow on
@@ -3509,7 +3750,18 @@ namespace Ogre
         widenedRect.right = std::min((long)mLightmapSizeActual, widenedRect.right);
         widenedRect.bottom = std::min((long)mLightmapSizeActual, widenedRect.bottom);
 
-        outFinalRect = widenedRect;
+        return widenedRect;
+    }
+    //---------------------------------------------------------------------
+    PixelBox* Terrain::calculateLightmap(const Rect& rect, const Rect& extraTargetRect, Rect& outFinalRect)
+    {
+        outFinalRect = calculateLightmapRect(rect, extraTargetRect);
+        return calculateLightmapTile(outFinalRect);
+    }
+    //---------------------------------------------------------------------
+    PixelBox* Terrain::calculateLightmapTile(const Rect& widenedRect)
+    {
+        const Vector3& lightVec = TerrainGlobalOptions::getSingleton().getLightMapDirection();
 
         // allocate memory (L8)
         uint8* pData = static_cast<uint8*>(
@@ -3599,21 +3851,40 @@ namespace Ogre
         {
             mModified = true;
             createOrDestroyGPUCompositeMap();
+            Rect updateRect = mCompositeMapDirtyRect;
             if (mCompositeMapDirtyRectLightmapUpdate &&
                 (mCompositeMapDirtyRect.width() < mSize || mCompositeMapDirtyRect.height() < mSize))
             {
                 // widen the dirty rectangle since lighting makes it wider
-                Rect widenedRect;
-                widenRectByVector(TerrainGlobalOptions::getSingleton().getLightMapDirection(), mCompositeMapDirtyRect, widenedRect);
+                widenRectByVector(TerrainGlobalOptions::getSingleton().getLightMapDirection(), mCompositeMapDirtyRect, updateRect);
                 // clamp
-                widenedRect.left = std::max(widenedRect.left, 0L);
-                widenedRect.top = std::max(widenedRect.top, 0L);
-                widenedRect.right = std::min(widenedRect.right, (long)mSize);
-                widenedRect.bottom = std::min(widenedRect.bottom, (long)mSize);
-                mMaterialGenerator->updateCompositeMap(this, widenedRect);  
+                updateRect.left = std::max(updateRect.left, 0L);
+                updateRect.top = std::max(updateRect.top, 0L);
+                updateRect.right = std::min(updateRect.right, (long)mSize);
+                updateRect.bottom = std::min(updateRect.bottom, (long)mSize);
+            }
+
+            if (TerrainGlobalOptions::getSingleton().getCompositeMapUpdateBudget() > 0)
+            {
+                // queue the tiles, they are rendered over the next frames
+                long step = (mSize - 1) / COMPOSITE_MAP_TILES;
+                mCompositeMapPendingTiles.resize(COMPOSITE_MAP_TILES * COMPOSITE_MAP_TILES, false);
+                long right = std::min(COMPOSITE_MAP_TILES, (updateRect.right - 1) / step + 1);
+                long bottom = std::min(COMPOSITE_MAP_TILES, (updateRect.bottom - 1) / step + 1);
+                for (long y = updateRect.top / step; y < bottom; ++y)
+                {
+                    for (long x = updateRect.left / step; x < right; ++x)
+                    {
+                        if (!mCompositeMapPendingTiles[y * COMPOSITE_MAP_TILES + x])
+                        {
+                            mCompositeMapPendingTiles[y * COMPOSITE_MAP_TILES + x] = true;
+                            ++mCompositeMapPendingTileCount;
+                        }
+                    }
+                }
             }
             else
-                mMaterialGenerator->updateCompositeMap(this, mCompositeMapDirtyRect);
+                mMaterialGenerator->updateCompositeMap(this, updateRect);
 
             mCompositeMapDirtyRectLightmapUpdate = false;
             mCompositeMapDirtyRect.setNull();
@@ -3622,6 +3893,39 @@ namespace Ogre
         }
     }
     //---------------------------------------------------------------------
+    void Terrain::updateCompositeMapTiles(Real budget)
+    {
+        if (!mCompositeMapPendingTileCount)
+            return;
+        if (!mCompositeMapRequired || mCompositeMap.isNull())
+        {
+            mCompositeMapPendingTiles.clear();
+            mCompositeMapPendingTileCount = 0;
+            return;
+        }
+
+        Timer* timer = Root::getSingleton().getTimer();
+        unsigned long start = timer->getMicroseconds();
+        long step = (mSize - 1) / COMPOSITE_MAP_TILES;
+        for (long i = 0; i < COMPOSITE_MAP_TILES * COMPOSITE_MAP_TILES && mCompositeMapPendingTileCount; ++i)
+        {
+            if (!mCompositeMapPendingTiles[i])
+                continue;
+
+            // tiles share their edge points
+            long x = i % COMPOSITE_MAP_TILES;
+            long y = i / COMPOSITE_MAP_TILES;
+            Rect rect(x * step, y * step, 
+                std::min((long)mSize, (x + 1) * step + 1), std::min((long)mSize, (y + 1) * step + 1));
+            mMaterialGenerator->updateCompositeMap(this, rect);
+            mCompositeMapPendingTiles[i] = false;
+            --mCompositeMapPendingTileCount;
+
+            if (budget >= 0 && (timer->getMicroseconds() - start) >= budget * 1000)
+                break;
+        }
+    }
+    //---------------------------------------------------------------------
     void Terrain::updateCompositeMapWithDelay(Real delay)
     {
         mCompositeMapUpdateCountdown = (long)(delay * 1000);
@@ -4326,6 +4630,8 @@ namespace Ogre
     {
         if (mCustomGpuBufferAllocator)
             return mCustomGpuBufferAllocator;
+        else if (TerrainGlobalOptions::getSingleton().getUseSharedGpuBufferAllocator())
+            return &TerrainGlobalOptions::getSingleton().getSharedGpuBufferAllocator();
         else
             return &mDefaultGpuBufferAllocator;
     }
@@ -4588,6 +4894,7 @@ namespace Ogre
             rect.left = 0; rect.right = mSize;
             calculateHeightDeltas(rect);
             finaliseHeightDeltas(rect, true);
+            updateRayHeightBounds(rect);
 
             if(mIsLoaded)
             {
@@ -4618,19 +4925,23 @@ namespace Ogre
     }
     //---------------------------------------------------------------------
     HardwareVertexBufferSharedPtr Terrain::DefaultGpuBufferAllocator::getVertexBuffer(
-        VBufList& list, size_t vertexSize, size_t numVertices)
+        VBufPool& pool, size_t vertexSize, size_t numVertices)
     {
         size_t sz = vertexSize * numVertices;
-        for (VBufList::iterator i = list.begin(); i != list.end(); ++i)
-        {
-            if ((*i)->getSizeInBytes() == sz)
-            {
-                HardwareVertexBufferSharedPtr ret = *i;
-                list.erase(i);
-                return ret;
-            }
+        ++mStatistics.requests;
+        VBufPool::iterator i = pool.find(sz);
+        if (i != pool.end() && !i->second.empty())
+        {
+            HardwareVertexBufferSharedPtr ret = i->second.front();
+            i->second.pop_front();
+            ++mStatistics.hits;
+            --mStatistics.freeBuffers;
+            mStatistics.freeBytes -= sz;
+            return ret;
         }
         // Didn't find one?
+        ++mStatistics.buffersCreated;
+        mStatistics.bytesCreated += sz;
         return HardwareBufferManager::getSingleton()
             .createVertexBuffer(vertexSize, numVertices, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
 
@@ -4640,8 +4951,24 @@ namespace Ogre
     void Terrain::DefaultGpuBufferAllocator::freeVertexBuffers(
         const HardwareVertexBufferSharedPtr& posbuf, const HardwareVertexBufferSharedPtr& deltabuf)
     {
-        mFreePosBufList.push_back(posbuf);
-        mFreeDeltaBufList.push_back(deltabuf);
+        freeVertexBuffer(mFreePosBufList, posbuf);
+        freeVertexBuffer(mFreeDeltaBufList, deltabuf);
+    }
+    //---------------------------------------------------------------------
+    void Terrain::DefaultGpuBufferAllocator::freeVertexBuffer(
+        VBufPool& pool, const HardwareVertexBufferSharedPtr& buf)
+    {
+        pool[buf->getSizeInBytes()].push_back(buf);
+        ++mStatistics.freeBuffers;
+        mStatistics.freeBytes += buf->getSizeInBytes();
+    }
+    //---------------------------------------------------------------------
+    void Terrain::DefaultGpuBufferAllocator::resetStatistics()
+    {
+        mStatistics.requests = 0;
+        mStatistics.hits = 0;
+        mStatistics.buffersCreated = 0;
+        mStatistics.bytesCreated = 0;
     }
     //---------------------------------------------------------------------
     HardwareIndexBufferSharedPtr Terrain::DefaultGpuBufferAllocator::getSharedIndexBuffer(uint16 batchSize, 
@@ -4676,6 +5003,8 @@ namespace Ogre
         mFreePosBufList.clear();
         mFreeDeltaBufList.clear();
         mSharedIBufMap.clear();
+        mStatistics.freeBuffers = 0;
+        mStatistics.freeBytes = 0;
     }
     //---------------------------------------------------------------------
     void Terrain::DefaultGpuBufferAllocator::warmStart(size_t numInstances, uint16 terrainSize, uint16 maxBatchSize, 
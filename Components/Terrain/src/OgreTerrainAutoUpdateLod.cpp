@@ -32,9 +32,11 @@ THE SOFTWARE.
 #include "OgreViewport.h"
 #include "OgreLogManager.h"
 #include "OgreRoot.h"
+#include "OgreTimer.h"
 #include "OgreRenderSystem.h"
 #include "OgreRay.h"
 #include "OgreTerrainAutoUpdateLod.h"
+#include "OgreTerrainGroup.h"
 
 /*
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
@@ -45,6 +47,13 @@ THE SOFTWARE.
 
 namespace Ogre
 {
+    void TerrainAutoUpdateLod::autoUpdateLodAll(TerrainGroup *group, bool synchronous, const Any &data)
+    {
+        TerrainGroup::TerrainIterator ti = group->getTerrainIterator();
+        while (ti.hasMoreElements())
+            autoUpdateLod(ti.getNext()->instance, synchronous, data);
+    }
+
     void TerrainAutoUpdateLodByDistance::autoUpdateLod(Terrain *terrain, bool synchronous, const Any &data)
     {
         if( terrain )
@@ -146,4 +155,85 @@ namespace Ogre
 
         return -1;
     }
+
+    TerrainAutoUpdateLodByScreenError::TerrainAutoUpdateLodByScreenError()
+        : mMaxConcurrentLoads(2)
+        , mLookAheadTime(1)
+        , mHasLastPosition(false)
+        , mLastPosition(Vector3::ZERO)
+        , mLastTime(0)
+        , mVelocity(Vector3::ZERO)
+    {
+    }
+
+    void TerrainAutoUpdateLodByScreenError::autoUpdateLodAll(TerrainGroup *group, bool synchronous, const Any &data)
+    {
+        const Viewport* vp = group->getSceneManager()->getCurrentViewport();
+        if(!vp)
+            return;
+        const Camera* cam = vp->getCamera()->getLodCamera();
+        Real holdDistance = any_cast<Real>(data);
+
+        // track camera velocity to predict where it is heading
+        Vector3 camPos = cam->getDerivedPosition();
+        unsigned long now = Root::getSingleton().getTimer()->getMilliseconds();
+        if (mHasLastPosition && now > mLastTime)
+            mVelocity = (camPos - mLastPosition) * (1000.0f / (Real)(now - mLastTime));
+        mHasLastPosition = true;
+        mLastPosition = camPos;
+        mLastTime = now;
+        Vector3 predictedPos = camPos + mVelocity * mLookAheadTime;
+
+        // same error terms as TerrainAutoUpdateLodByDistance
+        Real A = 1.0f / Math::Tan(cam->getFOVy() * 0.5f);
+        Real maxPixelError = TerrainGlobalOptions::getSingleton().getMaxPixelError() * cam->_getLodBiasInverse();
+        Real T = 2.0f * maxPixelError / (Real)vp->getActualHeight();
+        Real cFactor = A / T;
+
+        size_t loadsInFlight = 0;
+        mPendingLoads.clear();
+        TerrainGroup::TerrainIterator ti = group->getTerrainIterator();
+        while (ti.hasMoreElements())
+        {
+            Terrain* terrain = ti.getNext()->instance;
+            if (!terrain || !terrain->isLoaded())
+                continue;
+
+            int targetLod = traverseTreeByDistance(terrain->getQuadTree(), cam, cFactor, holdDistance);
+            if (targetLod < 0)
+                continue;
+
+            int loadedLod = terrain->getHighestLodLoaded();
+            if (loadedLod < 0)
+                loadedLod = terrain->getNumLodLevels();
+
+            if (targetLod >= loadedLod || terrain->isLodLoadInProgress())
+            {
+                // decreases are cheap, and in flight loads just retarget
+                if (terrain->isLodLoadInProgress())
+                    ++loadsInFlight;
+                if (targetLod != terrain->getTargetLodLevel())
+                    terrain->load(targetLod, synchronous);
+                continue;
+            }
+
+            // the error of each missing level roughly doubles that of the next
+            Real dist = std::min(terrain->getWorldAABB().distance(camPos),
+                terrain->getWorldAABB().distance(predictedPos));
+            PendingLoad load;
+            load.terrain = terrain;
+            load.lodLevel = targetLod;
+            load.priority = (Real)((1 << (loadedLod - targetLod)) - 1) / std::max(dist, (Real)1);
+            mPendingLoads.push_back(load);
+        }
+
+        std::sort(mPendingLoads.begin(), mPendingLoads.end());
+        for (PendingLoadList::iterator i = mPendingLoads.begin(); i != mPendingLoads.end(); ++i)
+        {
+            if (!synchronous && loadsInFlight >= mMaxConcurrentLoads)
+                break;
+            i->terrain->load(i->lodLevel, synchronous);
+            ++loadsInFlight;
+        }
+    }
 }
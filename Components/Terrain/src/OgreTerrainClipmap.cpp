@@ -0,0 +1,542 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreTerrainClipmap.h"
+#include "OgreTerrainGroup.h"
+#include "OgreRoot.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "OgreViewport.h"
+#include "OgreRenderQueue.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreTextureUnitState.h"
+#include "OgreTextureManager.h"
+#include "OgreHardwarePixelBuffer.h"
+#include "OgreHardwareBufferManager.h"
+#include "OgreHighLevelGpuProgram.h"
+#include "OgreHighLevelGpuProgramManager.h"
+#include "OgreGpuProgramManager.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        const char* GLSL_VP =
+            "#version 150\n"
+            "in vec4 vertex;\n"
+            "uniform mat4 worldViewProj;\n"
+            "uniform vec4 levelParams;\n"
+            "uniform vec4 morphParams;\n"
+            "uniform sampler2D heightMap;\n"
+            "out vec3 terrainPos;\n"
+            "float heightAt(vec2 g)\n"
+            "{\n"
+            "    return texelFetch(heightMap, ivec2(mod(g, levelParams.w)), 0).r;\n"
+            "}\n"
+            "void main()\n"
+            "{\n"
+            "    vec2 g = levelParams.xy + vertex.xy;\n"
+            "    vec2 d = abs(vertex.xy - morphParams.x) / morphParams.x;\n"
+            "    float morph = clamp((max(d.x, d.y) - morphParams.y) * morphParams.z, 0.0, 1.0);\n"
+            "    vec2 odd = mod(g, 2.0);\n"
+            "    float h = mix(heightAt(g), 0.5 * (heightAt(g - odd) + heightAt(g + odd)), morph);\n"
+            "    terrainPos = vec3(g * levelParams.z, h);\n"
+            "    gl_Position = worldViewProj * vec4(terrainPos, 1.0);\n"
+            "}\n";
+
+        const char* GLSL_FP =
+            "#version 150\n"
+            "in vec3 terrainPos;\n"
+            "uniform vec4 innerRegion;\n"
+            "uniform vec3 lightDir;\n"
+            "uniform vec4 ambient;\n"
+            "uniform vec4 diffuse;\n"
+            "out vec4 fragColour;\n"
+            "void main()\n"
+            "{\n"
+            "    if (all(greaterThan(terrainPos.xy, innerRegion.xy)) && all(lessThan(terrainPos.xy, innerRegion.zw)))\n"
+            "        discard;\n"
+            "    vec3 n = normalize(cross(dFdx(terrainPos), dFdy(terrainPos)));\n"
+            "    if (n.z < 0.0)\n"
+            "        n = -n;\n"
+            "    fragColour = ambient + diffuse * max(dot(n, lightDir), 0.0);\n"
+            "}\n";
+
+        const char* HLSL_VP =
+            "Texture2D heightMap : register(t0);\n"
+            "float heightAt(float2 g, float size)\n"
+            "{\n"
+            "    return heightMap.Load(int3(g - size * floor(g / size), 0)).r;\n"
+            "}\n"
+            "void main_vp(float4 vertex : POSITION,\n"
+            "    out float4 oPos : SV_POSITION,\n"
+            "    out float3 terrainPos : TEXCOORD0,\n"
+            "    uniform float4x4 worldViewProj,\n"
+            "    uniform float4 levelParams,\n"
+            "    uniform float4 morphParams)\n"
+            "{\n"
+            "    float2 g = levelParams.xy + vertex.xy;\n"
+            "    float2 d = abs(vertex.xy - morphParams.x) / morphParams.x;\n"
+            "    float morph = saturate((max(d.x, d.y) - morphParams.y) * morphParams.z);\n"
+            "    float2 odd = g - 2.0 * floor(g * 0.5);\n"
+            "    float h = lerp(heightAt(g, levelParams.w),\n"
+            "        0.5 * (heightAt(g - odd, levelParams.w) + heightAt(g + odd, levelParams.w)), morph);\n"
+            "    terrainPos = float3(g * levelParams.z, h);\n"
+            "    oPos = mul(worldViewProj, float4(terrainPos, 1.0));\n"
+            "}\n";
+
+        const char* HLSL_FP =
+            "float4 main_fp(float4 pos : SV_POSITION,\n"
+            "    float3 terrainPos : TEXCOORD0,\n"
+            "    uniform float4 innerRegion,\n"
+            "    uniform float3 lightDir,\n"
+            "    uniform float4 ambient,\n"
+            "    uniform float4 diffuse) : SV_TARGET\n"
+            "{\n"
+            "    if (all(terrainPos.xy > innerRegion.xy) && all(terrainPos.xy < innerRegion.zw))\n"
+            "        discard;\n"
+            "    float3 n = normalize(cross(ddx(terrainPos), ddy(terrainPos)));\n"
+            "    if (n.z < 0.0)\n"
+            "        n = -n;\n"
+            "    return ambient + diffuse * max(dot(n, lightDir), 0.0);\n"
+            "}\n";
+
+        String getShaderLanguage(void)
+        {
+            HighLevelGpuProgramManager& hmgr = HighLevelGpuProgramManager::getSingleton();
+            if (hmgr.isLanguageSupported("hlsl") &&
+                GpuProgramManager::getSingleton().isSyntaxSupported("vs_4_0"))
+                return "hlsl";
+            else if (hmgr.isLanguageSupported("glsl") &&
+                Root::getSingleton().getRenderSystem()->getNativeShadingLanguageVersion() >= 150)
+                return "glsl";
+            return BLANKSTRING;
+        }
+
+        /// Index of a grid coordinate in a toroidally addressed row
+        inline long wrap(long g, long size)
+        {
+            long r = g % size;
+            return r < 0 ? r + size : r;
+        }
+
+        /// Start and end of the morph to the coarser level, as a fraction of
+        /// half the level size
+        const float MORPH_START = 0.7f;
+        const float MORPH_END = 0.95f;
+    }
+    //---------------------------------------------------------------------
+    TerrainClipmap::TerrainClipmap(TerrainGroup* group, uint16 numLevels, uint16 gridSize)
+        : mGroup(group)
+        , mGridSize(gridSize)
+        , mBaseSpacing(group->getTerrainWorldSize() / (group->getTerrainSize() - 1))
+        , mMovable(0)
+        , mNode(0)
+        , mVertexData(0)
+        , mIndexData(0)
+        , mDefaultMaterial(false)
+    {
+        if (gridSize < 4 || gridSize % 4)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Clipmap grid size must be a multiple of 4",
+                "TerrainClipmap::TerrainClipmap");
+        }
+
+        // use our own pointer as identifier, as Terrain does for its material
+        TerrainClipmap* pThis = this;
+        mName = "OgreTerrainClipmap/" + StringConverter::toString(FastHash((const char*)&pThis, sizeof(TerrainClipmap*)));
+
+        createGeometry();
+
+        for (uint16 i = 0; i < numLevels; ++i)
+            mLevels.push_back(OGRE_NEW Level(this, i));
+
+        createDefaultMaterial();
+
+        // Terrain space has heights along Z
+        Vector3 axes[3];
+        Terrain::convertTerrainToWorldAxes(group->getAlignment(), Vector3::UNIT_X, &axes[0]);
+        Terrain::convertTerrainToWorldAxes(group->getAlignment(), Vector3::UNIT_Y, &axes[1]);
+        Terrain::convertTerrainToWorldAxes(group->getAlignment(), Vector3::UNIT_Z, &axes[2]);
+
+        SceneManager* sm = group->getSceneManager();
+        mMovable = OGRE_NEW Movable(this);
+        mNode = sm->getRootSceneNode()->createChildSceneNode(
+            group->getOrigin(), Quaternion(axes[0], axes[1], axes[2]));
+        mNode->attachObject(mMovable);
+        sm->addListener(this);
+    }
+    //---------------------------------------------------------------------
+    TerrainClipmap::~TerrainClipmap()
+    {
+        SceneManager* sm = mGroup->getSceneManager();
+        sm->removeListener(this);
+        mNode->detachAllObjects();
+        sm->destroySceneNode(mNode);
+        OGRE_DELETE mMovable;
+
+        for (LevelList::iterator i = mLevels.begin(); i != mLevels.end(); ++i)
+        {
+            Level* level = *i;
+            TextureManager::getSingleton().remove(level->mHeightMap->getHandle());
+            MaterialManager::getSingleton().remove(level->mMaterial->getHandle());
+            OGRE_DELETE level;
+        }
+        if (mDefaultMaterial)
+            MaterialManager::getSingleton().remove(mMaterial->getHandle());
+
+        OGRE_DELETE mVertexData;
+        OGRE_DELETE mIndexData;
+    }
+    //---------------------------------------------------------------------
+    bool TerrainClipmap::isSupported(void)
+    {
+        RenderSystem* rsys = Root::getSingleton().getRenderSystem();
+        return rsys && rsys->getCapabilities()->hasCapability(RSC_VERTEX_TEXTURE_FETCH) &&
+            rsys->getCapabilities()->hasCapability(RSC_TEXTURE_FLOAT) &&
+            !getShaderLanguage().empty();
+    }
+    //---------------------------------------------------------------------
+    void TerrainClipmap::createGeometry(void)
+    {
+        // One grid of points, shared by all the levels
+        size_t verts = mGridSize + 1;
+        mVertexData = OGRE_NEW VertexData();
+        mVertexData->vertexStart = 0;
+        mVertexData->vertexCount = verts * verts;
+        mVertexData->vertexDeclaration->addElement(0, 0, VET_FLOAT2, VES_POSITION);
+        HardwareVertexBufferSharedPtr vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+            sizeof(float) * 2, mVertexData->vertexCount, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        mVertexData->vertexBufferBinding->setBinding(0, vbuf);
+        float* pPos = static_cast<float*>(vbuf->lock(HardwareBuffer::HBL_DISCARD));
+        for (size_t y = 0; y < verts; ++y)
+        {
+            for (size_t x = 0; x < verts; ++x)
+            {
+                *pPos++ = (float)x;
+                *pPos++ = (float)y;
+            }
+        }
+        vbuf->unlock();
+
+        // Counter-clockwise seen from above, always split along the same diagonal
+        // so that odd points lie on the edges of the coarser level's triangles
+        bool use32 = mVertexData->vertexCount > 65535;
+        mIndexData = OGRE_NEW IndexData();
+        mIndexData->indexStart = 0;
+        mIndexData->indexCount = (size_t)mGridSize * mGridSize * 6;
+        mIndexData->indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+            use32 ? HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT,
+            mIndexData->indexCount, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        void* pIndexes = mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD);
+        uint16* p16 = static_cast<uint16*>(pIndexes);
+        uint32* p32 = static_cast<uint32*>(pIndexes);
+        for (size_t y = 0; y < mGridSize; ++y)
+        {
+            for (size_t x = 0; x < mGridSize; ++x)
+            {
+                uint32 i00 = static_cast<uint32>(y * verts + x);
+                uint32 i10 = i00 + 1;
+                uint32 i01 = i00 + static_cast<uint32>(verts);
+                uint32 i11 = i01 + 1;
+                uint32 tris[6] = { i00, i10, i11, i00, i11, i01 };
+                for (int t = 0; t < 6; ++t)
+                {
+                    if (use32)
+                        *p32++ = tris[t];
+                    else
+                        *p16++ = static_cast<uint16>(tris[t]);
+                }
+            }
+        }
+        mIndexData->indexBuffer->unlock();
+    }
+    //---------------------------------------------------------------------
+    void TerrainClipmap::createDefaultMaterial(void)
+    {
+        String lang = getShaderLanguage();
+        bool hlsl = lang == "hlsl";
+        HighLevelGpuProgramManager& hmgr = HighLevelGpuProgramManager::getSingleton();
+        String group = ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME;
+
+        HighLevelGpuProgramPtr vp = hmgr.getByName("OgreTerrainClipmap/VP", group);
+        if (vp.isNull())
+        {
+            vp = hmgr.createProgram("OgreTerrainClipmap/VP", group, lang, GPT_VERTEX_PROGRAM);
+            vp->setSource(hlsl ? HLSL_VP : GLSL_VP);
+            if (hlsl)
+            {
+                vp->setParameter("target", "vs_4_0");
+                vp->setParameter("entry_point", "main_vp");
+            }
+            GpuProgramParametersSharedPtr params = vp->getDefaultParameters();
+            params->setNamedAutoConstant("worldViewProj", GpuProgramParameters::ACT_WORLDVIEWPROJ_MATRIX);
+            params->setNamedAutoConstant("levelParams", GpuProgramParameters::ACT_CUSTOM, 0);
+            params->setNamedAutoConstant("morphParams", GpuProgramParameters::ACT_CUSTOM, 2);
+            if (!hlsl)
+                params->setNamedConstant("heightMap", 0);
+        }
+
+        HighLevelGpuProgramPtr fp = hmgr.getByName("OgreTerrainClipmap/FP", group);
+        if (fp.isNull())
+        {
+            fp = hmgr.createProgram("OgreTerrainClipmap/FP", group, lang, GPT_FRAGMENT_PROGRAM);
+            fp->setSource(hlsl ? HLSL_FP : GLSL_FP);
+            if (hlsl)
+            {
+                fp->setParameter("target", "ps_4_0");
+                fp->setParameter("entry_point", "main_fp");
+            }
+            fp->getDefaultParameters()->setNamedAutoConstant(
+                "innerRegion", GpuProgramParameters::ACT_CUSTOM, 1);
+        }
+
+        MaterialPtr mat = MaterialManager::getSingleton().create(mName, group);
+        Pass* pass = mat->getTechnique(0)->getPass(0);
+        pass->setVertexProgram(vp->getName());
+        pass->setFragmentProgram(fp->getName());
+        pass->createTextureUnitState();
+
+        setMaterial(mat);
+        mDefaultMaterial = true;
+    }
+    //---------------------------------------------------------------------
+    void TerrainClipmap::setMaterial(const MaterialPtr& mat)
+    {
+        if (mDefaultMaterial && mat != mMaterial)
+        {
+            MaterialManager::getSingleton().remove(mMaterial->getHandle());
+            mDefaultMaterial = false;
+        }
+        mMaterial = mat;
+
+        for (LevelList::iterator i = mLevels.begin(); i != mLevels.end(); ++i)
+        {
+            Level* level = *i;
+            String name = mName + "/" + StringConverter::toString(level->mIndex);
+            if (!level->mMaterial.isNull())
+                MaterialManager::getSingleton().remove(level->mMaterial->getHandle());
+            level->mMaterial = mat->clone(name);
+            level->mMaterial->load();
+
+            Technique* tech = level->mMaterial->getBestTechnique();
+            for (unsigned short p = 0; tech && p < tech->getNumPasses(); ++p)
+            {
+                Pass* pass = tech->getPass(p);
+                if (!pass->getNumTextureUnitStates())
+                    continue;
+                TextureUnitState* tu = pass->getTextureUnitState(0);
+                tu->setTexture(level->mHeightMap);
+                tu->setBindingType(TextureUnitState::BT_VERTEX);
+                tu->setTextureFiltering(TFO_NONE);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void TerrainClipmap::dirty(void)
+    {
+        for (LevelList::iterator i = mLevels.begin(); i != mLevels.end(); ++i)
+            (*i)->mValid = false;
+    }
+    //---------------------------------------------------------------------
+    void TerrainClipmap::preFindVisibleObjects(SceneManager* source,
+        SceneManager::IlluminationRenderStage irs, Viewport* v)
+    {
+        // shadow cameras see the same levels as the main camera
+        if (irs != SceneManager::IRS_RENDER_TO_TEXTURE)
+            update(v->getCamera()->getLodCamera()->getDerivedPosition());
+    }
+    //---------------------------------------------------------------------
+    void TerrainClipmap::update(const Vector3& viewPos)
+    {
+        Vector3 pos;
+        Terrain::convertWorldToTerrainAxes(mGroup->getAlignment(), viewPos - mGroup->getOrigin(), &pos);
+
+        long half = mGridSize / 2;
+        for (LevelList::iterator i = mLevels.begin(); i != mLevels.end(); ++i)
+        {
+            Level* level = *i;
+            // keep the origin on even points, which are shared with the coarser level
+            long originX = static_cast<long>(Math::Floor((pos.x / level->mSpacing - half) * 0.5f)) * 2;
+            long originY = static_cast<long>(Math::Floor((pos.y / level->mSpacing - half) * 0.5f)) * 2;
+            updateLevel(level, originX, originY);
+
+            level->setCustomParameter(0, Vector4((Real)originX, (Real)originY,
+                level->mSpacing, (Real)(mGridSize + 1)));
+            level->setCustomParameter(2, Vector4((Real)half, MORPH_START,
+                1.0f / (MORPH_END - MORPH_START), 0));
+            if (level->mIndex == 0)
+            {
+                // nothing inside the finest level
+                level->setCustomParameter(1, Vector4(1, 1, 0, 0));
+            }
+            else
+            {
+                Level* inner = mLevels[level->mIndex - 1];
+                level->setCustomParameter(1, Vector4(
+                    inner->mOriginX * inner->mSpacing, inner->mOriginY * inner->mSpacing,
+                    (inner->mOriginX + mGridSize) * inner->mSpacing,
+                    (inner->mOriginY + mGridSize) * inner->mSpacing));
+            }
+        }
+
+        if (mDefaultMaterial)
+        {
+            TerrainGlobalOptions& opts = TerrainGlobalOptions::getSingleton();
+            Vector3 lightDir;
+            Terrain::convertWorldToTerrainAxes(mGroup->getAlignment(), -opts.getLightMapDirection(), &lightDir);
+            lightDir.normalise();
+            for (LevelList::iterator i = mLevels.begin(); i != mLevels.end(); ++i)
+            {
+                GpuProgramParametersSharedPtr params =
+                    (*i)->mMaterial->getTechnique(0)->getPass(0)->getFragmentProgramParameters();
+                params->setNamedConstant("lightDir", lightDir);
+                params->setNamedConstant("ambient", opts.getCompositeMapAmbient());
+                params->setNamedConstant("diffuse", opts.getCompositeMapDiffuse());
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void TerrainClipmap::updateLevel(Level* level, long originX, long originY)
+    {
+        if (level->mValid && level->mOriginX == originX && level->mOriginY == originY)
+            return;
+
+        long size = mGridSize + 1;
+        bool refill = !level->mValid ||
+            std::abs(originX - level->mOriginX) >= size ||
+            std::abs(originY - level->mOriginY) >= size;
+
+        for (long y = originY; y < originY + size; ++y)
+        {
+            bool newRow = refill || y < level->mOriginY || y >= level->mOriginY + size;
+            float* pRow = &level->mHeights[wrap(y, size) * size];
+            for (long x = originX; x < originX + size; ++x)
+            {
+                // only points that came into range
+                if (newRow || x < level->mOriginX || x >= level->mOriginX + size)
+                    pRow[wrap(x, size)] = sampleHeight(x * level->mSpacing, y * level->mSpacing);
+            }
+        }
+
+        level->mOriginX = originX;
+        level->mOriginY = originY;
+        level->mValid = true;
+
+        PixelBox src(static_cast<uint32>(size), static_cast<uint32>(size), 1,
+            PF_FLOAT32_R, &level->mHeights[0]);
+        level->mHeightMap->getBuffer()->blitFromMemory(src);
+    }
+    //---------------------------------------------------------------------
+    float TerrainClipmap::sampleHeight(Real x, Real y)
+    {
+        Vector3 worldPos;
+        Terrain::convertTerrainToWorldAxes(mGroup->getAlignment(), Vector3(x, y, 0), &worldPos);
+        return mGroup->getHeightAtWorldPosition(worldPos + mGroup->getOrigin());
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    TerrainClipmap::Level::Level(TerrainClipmap* parent, uint16 index)
+        : mParent(parent)
+        , mIndex(index)
+        , mSpacing(parent->getBaseSpacing() * (1 << index))
+        , mOriginX(0)
+        , mOriginY(0)
+        , mValid(false)
+    {
+        uint32 size = parent->getGridSize() + 1;
+        mHeights.resize(size * size);
+        mHeightMap = TextureManager::getSingleton().createManual(
+            parent->mName + "/heights" + StringConverter::toString(index),
+            ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME,
+            TEX_TYPE_2D, size, size, 0, PF_FLOAT32_R, TU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+    }
+    //---------------------------------------------------------------------
+    TerrainClipmap::Level::~Level()
+    {
+    }
+    //---------------------------------------------------------------------
+    void TerrainClipmap::Level::getRenderOperation(RenderOperation& op)
+    {
+        op.operationType = RenderOperation::OT_TRIANGLE_LIST;
+        op.srcRenderable = this;
+        op.useIndexes = true;
+        op.vertexData = mParent->mVertexData;
+        op.indexData = mParent->mIndexData;
+    }
+    //---------------------------------------------------------------------
+    void TerrainClipmap::Level::getWorldTransforms(Matrix4* xform) const
+    {
+        *xform = mParent->mNode->_getFullTransform();
+    }
+    //---------------------------------------------------------------------
+    Real TerrainClipmap::Level::getSquaredViewDepth(const Camera* cam) const
+    {
+        return mParent->mNode->getSquaredViewDepth(cam);
+    }
+    //---------------------------------------------------------------------
+    const LightList& TerrainClipmap::Level::getLights(void) const
+    {
+        return mParent->mMovable->queryLights();
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    TerrainClipmap::Movable::Movable(TerrainClipmap* parent)
+        : mParent(parent)
+    {
+        // levels follow the viewer, so are always in view
+        mBox.setInfinite();
+        setCastShadows(false);
+        setRenderQueueGroup(TerrainGlobalOptions::getSingleton().getRenderQueueGroup());
+    }
+    //---------------------------------------------------------------------
+    TerrainClipmap::Movable::~Movable()
+    {
+    }
+    //---------------------------------------------------------------------
+    const String& TerrainClipmap::Movable::getMovableType(void) const
+    {
+        static String stype("OgreTerrainClipmap");
+
+        return stype;
+    }
+    //---------------------------------------------------------------------
+    void TerrainClipmap::Movable::_updateRenderQueue(RenderQueue* queue)
+    {
+        for (LevelList::iterator i = mParent->mLevels.begin(); i != mParent->mLevels.end(); ++i)
+            queue->addRenderable(*i, mRenderQueueID, mRenderQueuePriority);
+    }
+    //---------------------------------------------------------------------
+    void TerrainClipmap::Movable::visitRenderables(Renderable::Visitor* visitor, bool debugRenderables)
+    {
+        for (LevelList::iterator i = mParent->mLevels.begin(); i != mParent->mLevels.end(); ++i)
+            visitor->visit(*i, 0, false);
+    }
+}
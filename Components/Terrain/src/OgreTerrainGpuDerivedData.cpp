@@ -0,0 +1,514 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreTerrainGpuDerivedData.h"
+#include "OgreTerrain.h"
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "OgreViewport.h"
+#include "OgreManualObject.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreTextureUnitState.h"
+#include "OgreTextureManager.h"
+#include "OgreHardwarePixelBuffer.h"
+#include "OgreRenderTexture.h"
+#include "OgreHighLevelGpuProgram.h"
+#include "OgreHighLevelGpuProgramManager.h"
+#include "OgreGpuProgramManager.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        const char* GLSL_VP =
+            "#version 150\n"
+            "in vec4 position;\n"
+            "in vec2 uv0;\n"
+            "uniform mat4 worldViewProj;\n"
+            "out vec2 oUV;\n"
+            "void main()\n"
+            "{\n"
+            "    gl_Position = worldViewProj * position;\n"
+            "    oUV = uv0;\n"
+            "}\n";
+
+        const char* GLSL_HEIGHT =
+            "#version 150\n"
+            "uniform sampler2D heightMap;\n"
+            "in vec2 oUV;\n"
+            "out vec4 fragColour;\n"
+            // Heights of points -1 to size, the map has a one point border
+            "float height(ivec2 p, int size)\n"
+            "{\n"
+            "    p = clamp(p, ivec2(-1), ivec2(size));\n"
+            "    return texelFetch(heightMap, p + ivec2(1), 0).r;\n"
+            "}\n";
+
+        const char* GLSL_NORMALS_FP =
+            // x = terrain size, y = distance between points
+            "uniform vec4 params;\n"
+            // Terrain axes in object space
+            "uniform vec3 axisX;\n"
+            "uniform vec3 axisY;\n"
+            "uniform vec3 axisZ;\n"
+            "vec3 pointAt(ivec2 p, int size)\n"
+            "{\n"
+            "    return vec3(vec2(p) * params.y, height(p, size));\n"
+            "}\n"
+            "void main()\n"
+            "{\n"
+            "    int size = int(params.x);\n"
+            // Image rows run from the far edge of the terrain
+            "    ivec2 p = ivec2(int(oUV.x * params.x), size - 1 - int(oUV.y * params.x));\n"
+            "    p = clamp(p, ivec2(0), ivec2(size - 1));\n"
+            // Sum the normals of the 8 triangles around the point, as the CPU version
+            "    ivec2 offsets[8] = ivec2[8](ivec2(1, 0), ivec2(1, 1), ivec2(0, 1), ivec2(-1, 1),\n"
+            "        ivec2(-1, 0), ivec2(-1, -1), ivec2(0, -1), ivec2(1, -1));\n"
+            "    vec3 centre = pointAt(p, size);\n"
+            "    vec3 n = vec3(0.0);\n"
+            "    for (int i = 0; i < 8; ++i)\n"
+            "    {\n"
+            "        vec3 a = pointAt(p + offsets[i], size) - centre;\n"
+            "        vec3 b = pointAt(p + offsets[(i + 1) % 8], size) - centre;\n"
+            "        n += normalize(cross(a, b));\n"
+            "    }\n"
+            "    n = normalize(axisX * n.x + axisY * n.y + axisZ * n.z);\n"
+            "    fragColour = vec4(n * 0.5 + 0.5, 1.0);\n"
+            "}\n";
+
+        const char* GLSL_LIGHTMAP_FP =
+            // x = terrain size, y = lightmap size, z = height padding, w = maximum height
+            "uniform vec4 params;\n"
+            // xyz = one step towards the light in points and height, w = number of steps
+            "uniform vec4 lightStep;\n"
+            "float heightAt(vec2 pos, int size)\n"
+            "{\n"
+            "    ivec2 p = ivec2(floor(pos));\n"
+            "    vec2 f = pos - vec2(p);\n"
+            "    return mix(mix(height(p, size), height(p + ivec2(1, 0), size), f.x),\n"
+            "        mix(height(p + ivec2(0, 1), size), height(p + ivec2(1, 1), size), f.x), f.y);\n"
+            "}\n"
+            "void main()\n"
+            "{\n"
+            "    int size = int(params.x);\n"
+            "    float edge = params.x - 1.0;\n"
+            "    ivec2 texel = ivec2(oUV * params.y);\n"
+            "    vec2 pos = vec2(float(texel.x), params.y - 1.0 - float(texel.y)) / (params.y - 1.0) * edge;\n"
+            "    vec3 ray = vec3(pos, heightAt(pos, size) + params.z);\n"
+            "    float lit = 1.0;\n"
+            "    int steps = int(lightStep.w);\n"
+            "    for (int i = 0; i < steps; ++i)\n"
+            "    {\n"
+            "        ray += lightStep.xyz;\n"
+            "        if (ray.z > params.w || ray.x < 0.0 || ray.y < 0.0 || ray.x > edge || ray.y > edge)\n"
+            "            break;\n"
+            "        if (heightAt(ray.xy, size) > ray.z)\n"
+            "        {\n"
+            "            lit = 0.0;\n"
+            "            break;\n"
+            "        }\n"
+            "    }\n"
+            "    fragColour = vec4(lit, lit, lit, 1.0);\n"
+            "}\n";
+
+        const char* HLSL_VP =
+            "void main_vp(float4 position : POSITION, float2 uv0 : TEXCOORD0,\n"
+            "    uniform float4x4 worldViewProj,\n"
+            "    out float4 oPos : SV_POSITION, out float2 oUV : TEXCOORD0)\n"
+            "{\n"
+            "    oPos = mul(worldViewProj, position);\n"
+            "    oUV = uv0;\n"
+            "}\n";
+
+        const char* HLSL_HEIGHT =
+            "Texture2D<float> heightMap : register(t0);\n"
+            "float height(int2 p, int size)\n"
+            "{\n"
+            "    p = clamp(p, int2(-1, -1), int2(size, size));\n"
+            "    return heightMap.Load(int3(p + int2(1, 1), 0));\n"
+            "}\n";
+
+        const char* HLSL_NORMALS_FP =
+            "uniform float4 params;\n"
+            "uniform float3 axisX;\n"
+            "uniform float3 axisY;\n"
+            "uniform float3 axisZ;\n"
+            "float3 pointAt(int2 p, int size)\n"
+            "{\n"
+            "    return float3(float2(p) * params.y, height(p, size));\n"
+            "}\n"
+            "float4 main_fp(float4 pos : SV_POSITION, float2 uv : TEXCOORD0) : SV_Target\n"
+            "{\n"
+            "    int size = int(params.x);\n"
+            "    int2 p = int2(int(uv.x * params.x), size - 1 - int(uv.y * params.x));\n"
+            "    p = clamp(p, int2(0, 0), int2(size - 1, size - 1));\n"
+            "    const int2 offsets[8] = { int2(1, 0), int2(1, 1), int2(0, 1), int2(-1, 1),\n"
+            "        int2(-1, 0), int2(-1, -1), int2(0, -1), int2(1, -1) };\n"
+            "    float3 centre = pointAt(p, size);\n"
+            "    float3 n = float3(0, 0, 0);\n"
+            "    for (int i = 0; i < 8; ++i)\n"
+            "    {\n"
+            "        float3 a = pointAt(p + offsets[i], size) - centre;\n"
+            "        float3 b = pointAt(p + offsets[(i + 1) % 8], size) - centre;\n"
+            "        n += normalize(cross(a, b));\n"
+            "    }\n"
+            "    n = normalize(axisX * n.x + axisY * n.y + axisZ * n.z);\n"
+            "    return float4(n * 0.5 + 0.5, 1.0);\n"
+            "}\n";
+
+        const char* HLSL_LIGHTMAP_FP =
+            "uniform float4 params;\n"
+            "uniform float4 lightStep;\n"
+            "float heightAt(float2 pos, int size)\n"
+            "{\n"
+            "    int2 p = int2(floor(pos));\n"
+            "    float2 f = pos - float2(p);\n"
+            "    return lerp(lerp(height(p, size), height(p + int2(1, 0), size), f.x),\n"
+            "        lerp(height(p + int2(0, 1), size), height(p + int2(1, 1), size), f.x), f.y);\n"
+            "}\n"
+            "float4 main_fp(float4 pos : SV_POSITION, float2 uv : TEXCOORD0) : SV_Target\n"
+            "{\n"
+            "    int size = int(params.x);\n"
+            "    float edge = params.x - 1.0;\n"
+            "    int2 texel = int2(uv * params.y);\n"
+            "    float2 p = float2(float(texel.x), params.y - 1.0 - float(texel.y)) / (params.y - 1.0) * edge;\n"
+            "    float3 ray = float3(p, heightAt(p, size) + params.z);\n"
+            "    float lit = 1.0;\n"
+            "    int steps = int(lightStep.w);\n"
+            "    for (int i = 0; i < steps; ++i)\n"
+            "    {\n"
+            "        ray += lightStep.xyz;\n"
+            "        if (ray.z > params.w || ray.x < 0.0 || ray.y < 0.0 || ray.x > edge || ray.y > edge)\n"
+            "            break;\n"
+            "        if (heightAt(ray.xy, size) > ray.z)\n"
+            "        {\n"
+            "            lit = 0.0;\n"
+            "            break;\n"
+            "        }\n"
+            "    }\n"
+            "    return float4(lit, lit, lit, 1.0);\n"
+            "}\n";
+
+        String getShaderLanguage(void)
+        {
+            HighLevelGpuProgramManager& hmgr = HighLevelGpuProgramManager::getSingleton();
+            if (hmgr.isLanguageSupported("hlsl") &&
+                GpuProgramManager::getSingleton().isSyntaxSupported("ps_4_0"))
+                return "hlsl";
+            else if (hmgr.isLanguageSupported("glsl") &&
+                Root::getSingleton().getRenderSystem()->getNativeShadingLanguageVersion() >= 150)
+                return "glsl";
+            return BLANKSTRING;
+        }
+    }
+    //---------------------------------------------------------------------
+    TerrainGpuDerivedData::TerrainGpuDerivedData()
+        : mSceneMgr(0)
+        , mCamera(0)
+        , mQuad(0)
+        , mShaderLanguage(getShaderLanguage())
+    {
+    }
+    //---------------------------------------------------------------------
+    TerrainGpuDerivedData::~TerrainGpuDerivedData()
+    {
+        if (TextureManager::getSingletonPtr())
+        {
+            if (!mNormalRTT.isNull())
+                TextureManager::getSingleton().remove(mNormalRTT->getHandle());
+            if (!mLightmapRTT.isNull())
+                TextureManager::getSingleton().remove(mLightmapRTT->getHandle());
+            if (!mHeightMap.isNull())
+                TextureManager::getSingleton().remove(mHeightMap->getHandle());
+        }
+        if (MaterialManager::getSingletonPtr())
+        {
+            if (!mNormalMaterial.isNull())
+                MaterialManager::getSingleton().remove(mNormalMaterial->getHandle());
+            if (!mLightmapMaterial.isNull())
+                MaterialManager::getSingleton().remove(mLightmapMaterial->getHandle());
+        }
+        if (mSceneMgr && Root::getSingletonPtr())
+        {
+            // will also delete cam and objects
+            Root::getSingleton().destroySceneManager(mSceneMgr);
+        }
+    }
+    //---------------------------------------------------------------------
+    bool TerrainGpuDerivedData::isSupported(void)
+    {
+        RenderSystem* rsys = Root::getSingleton().getRenderSystem();
+        return rsys && rsys->getCapabilities()->hasCapability(RSC_TEXTURE_FLOAT) &&
+            !getShaderLanguage().empty();
+    }
+    //---------------------------------------------------------------------
+    MaterialPtr TerrainGpuDerivedData::createMaterial(const String& name, const String& fpSource)
+    {
+        HighLevelGpuProgramManager& hmgr = HighLevelGpuProgramManager::getSingleton();
+        bool hlsl = mShaderLanguage == "hlsl";
+        String group = ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME;
+
+        String vpName = mSceneMgr->getName() + "/VP";
+        HighLevelGpuProgramPtr vp = hmgr.getByName(vpName, group);
+        if (vp.isNull())
+        {
+            vp = hmgr.createProgram(vpName, group, mShaderLanguage, GPT_VERTEX_PROGRAM);
+            vp->setSource(hlsl ? HLSL_VP : GLSL_VP);
+            if (hlsl)
+            {
+                vp->setParameter("target", "vs_4_0");
+                vp->setParameter("entry_point", "main_vp");
+            }
+            vp->getDefaultParameters()->setNamedAutoConstant(
+                "worldViewProj", GpuProgramParameters::ACT_WORLDVIEWPROJ_MATRIX);
+        }
+
+        HighLevelGpuProgramPtr fp = hmgr.createProgram(
+            mSceneMgr->getName() + "/" + name + "FP", group, mShaderLanguage, GPT_FRAGMENT_PROGRAM);
+        fp->setSource((hlsl ? HLSL_HEIGHT : GLSL_HEIGHT) + fpSource);
+        if (hlsl)
+        {
+            fp->setParameter("target", "ps_4_0");
+            fp->setParameter("entry_point", "main_fp");
+        }
+        else
+        {
+            fp->getDefaultParameters()->setNamedConstant("heightMap", 0);
+        }
+
+        MaterialPtr mat = MaterialManager::getSingleton().create(
+            mSceneMgr->getName() + "/" + name, group);
+        Pass* pass = mat->getTechnique(0)->getPass(0);
+        pass->setLightingEnabled(false);
+        pass->setDepthCheckEnabled(false);
+        pass->setDepthWriteEnabled(false);
+        pass->setCullingMode(CULL_NONE);
+        pass->setVertexProgram(vp->getName());
+        pass->setFragmentProgram(fp->getName());
+        TextureUnitState* tu = pass->createTextureUnitState();
+        tu->setTexture(mHeightMap);
+        tu->setTextureFiltering(TFO_NONE);
+        tu->setTextureAddressingMode(TextureUnitState::TAM_CLAMP);
+        mat->load();
+
+        return mat;
+    }
+    //---------------------------------------------------------------------
+    void TerrainGpuDerivedData::createScene(void)
+    {
+        // dedicated SceneManager, as for the composite map
+        mSceneMgr = Root::getSingleton().createSceneManager(DefaultSceneManagerFactory::FACTORY_TYPE_NAME);
+        float camDist = 100;
+        float halfCamDist = camDist * 0.5f;
+        mCamera = mSceneMgr->createCamera("cam");
+        mCamera->setPosition(0, 0, camDist);
+        mCamera->lookAt(Vector3::ZERO);
+        mCamera->setProjectionType(PT_ORTHOGRAPHIC);
+        mCamera->setNearClipDistance(10);
+        mCamera->setFarClipDistance(500);
+        mCamera->setOrthoWindow(camDist, camDist);
+
+        // Materials need the height map to exist
+        mHeightMap = TextureManager::getSingleton().createManual(
+            mSceneMgr->getName() + "/heights", ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME,
+            TEX_TYPE_2D, 1, 1, 0, PF_FLOAT32_R, TU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+        mNormalMaterial = createMaterial("normals", mShaderLanguage == "hlsl" ? HLSL_NORMALS_FP : GLSL_NORMALS_FP);
+        mLightmapMaterial = createMaterial("lightmap", mShaderLanguage == "hlsl" ? HLSL_LIGHTMAP_FP : GLSL_LIGHTMAP_FP);
+
+        // Image space quad, texture coordinates run from the top left
+        mQuad = mSceneMgr->createManualObject();
+        mQuad->begin(mNormalMaterial->getName(), RenderOperation::OT_TRIANGLE_LIST,
+            ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+        mQuad->position(-halfCamDist, halfCamDist, 0);
+        mQuad->textureCoord(0, 0);
+        mQuad->position(-halfCamDist, -halfCamDist, 0);
+        mQuad->textureCoord(0, 1);
+        mQuad->position(halfCamDist, -halfCamDist, 0);
+        mQuad->textureCoord(1, 1);
+        mQuad->position(halfCamDist, halfCamDist, 0);
+        mQuad->textureCoord(1, 0);
+        mQuad->quad(0, 1, 2, 3);
+        mQuad->end();
+        mSceneMgr->getRootSceneNode()->attachObject(mQuad);
+    }
+    //---------------------------------------------------------------------
+    void TerrainGpuDerivedData::updateHeightMap(const Terrain* terrain)
+    {
+        long size = terrain->getSize();
+        uint32 mapSize = static_cast<uint32>(size + 2);
+        if (mHeightMap->getWidth() != mapSize)
+        {
+            mHeightMap->freeInternalResources();
+            mHeightMap->setWidth(mapSize);
+            mHeightMap->setHeight(mapSize);
+            mHeightMap->createInternalResources();
+        }
+
+        mHeightData.resize(mapSize * mapSize);
+        const float* heights = terrain->getHeightData();
+        Terrain::Alignment align = terrain->getAlignment();
+        float* pDst = &mHeightData[0];
+        for (long y = -1; y <= size; ++y)
+        {
+            for (long x = -1; x <= size; ++x)
+            {
+                if (x >= 0 && y >= 0 && x < size && y < size)
+                {
+                    *pDst++ = heights[y * size + x];
+                }
+                else
+                {
+                    // Border from the neighbours, relative to this terrain
+                    Vector3 pos, terrainPos;
+                    terrain->getPointFromSelfOrNeighbour(x, y, &pos);
+                    Terrain::convertWorldToTerrainAxes(align, pos, &terrainPos);
+                    *pDst++ = terrainPos.z;
+                }
+            }
+        }
+        PixelBox src(mapSize, mapSize, 1, PF_FLOAT32_R, &mHeightData[0]);
+        mHeightMap->getBuffer()->blitFromMemory(src);
+    }
+    //---------------------------------------------------------------------
+    void TerrainGpuDerivedData::render(const MaterialPtr& mat, const TexturePtr& dest, 
+        TexturePtr& rtt, const Rect& rect)
+    {
+        TextureManager& tmgr = TextureManager::getSingleton();
+        uint32 size = dest->getWidth();
+        PixelFormat format = dest->getFormat();
+        if (!tmgr.isFormatSupported(TEX_TYPE_2D, format, TU_RENDERTARGET))
+            format = PF_BYTE_RGBA;
+
+        // check for size change
+        if (!rtt.isNull() && (rtt->getWidth() != size || rtt->getFormat() != format))
+        {
+            tmgr.remove(rtt->getHandle());
+            rtt.setNull();
+        }
+        if (rtt.isNull())
+        {
+            rtt = tmgr.createManual(
+                mat->getName() + "/RTT", ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME,
+                TEX_TYPE_2D, size, size, 0, format, TU_RENDERTARGET);
+            RenderTarget* target = rtt->getBuffer()->getRenderTarget();
+            // don't render all the time, only on demand
+            target->setAutoUpdated(false);
+            Viewport* vp = target->addViewport(mCamera);
+            // don't render overlays
+            vp->setOverlaysEnabled(false);
+        }
+
+        mQuad->setMaterialName(0, mat->getName(), ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+        mCamera->setWindow((Real)rect.left / (Real)size, (Real)rect.top / (Real)size,
+            (Real)rect.right / (Real)size, (Real)rect.bottom / (Real)size);
+        rtt->getBuffer()->getRenderTarget()->update();
+
+        Image::Box box(static_cast<uint32>(rect.left), static_cast<uint32>(rect.top),
+                       static_cast<uint32>(rect.right), static_cast<uint32>(rect.bottom));
+        if (rtt->getFormat() == dest->getFormat())
+        {
+            dest->getBuffer()->blit(rtt->getBuffer(), box, box);
+        }
+        else
+        {
+            // The destination format cannot be rendered to, convert through memory
+            PixelBox data(box, dest->getFormat());
+            data.data = OGRE_MALLOC(data.getConsecutiveSize(), MEMCATEGORY_GENERAL);
+            rtt->getBuffer()->blitToMemory(box, data);
+            dest->getBuffer()->blitFromMemory(data, box);
+            OGRE_FREE(data.data, MEMCATEGORY_GENERAL);
+        }
+    }
+    //---------------------------------------------------------------------
+    void TerrainGpuDerivedData::updateNormals(Terrain* terrain, const Rect& rect)
+    {
+        if (!mSceneMgr)
+            createScene();
+        updateHeightMap(terrain);
+
+        Real size = terrain->getSize();
+        Vector3 axes[3];
+        Terrain::convertTerrainToWorldAxes(terrain->getAlignment(), Vector3::UNIT_X, &axes[0]);
+        Terrain::convertTerrainToWorldAxes(terrain->getAlignment(), Vector3::UNIT_Y, &axes[1]);
+        Terrain::convertTerrainToWorldAxes(terrain->getAlignment(), Vector3::UNIT_Z, &axes[2]);
+
+        GpuProgramParametersSharedPtr params = 
+            mNormalMaterial->getTechnique(0)->getPass(0)->getFragmentProgramParameters();
+        params->setNamedConstant("params", Vector4(size, terrain->getWorldSize() / (size - 1), 0, 0));
+        params->setNamedConstant("axisX", axes[0]);
+        params->setNamedConstant("axisY", axes[1]);
+        params->setNamedConstant("axisZ", axes[2]);
+
+        // normal map rows are inverted relative to terrain space
+        Rect imgRect(rect.left, terrain->getSize() - rect.bottom, 
+            rect.right, terrain->getSize() - rect.top);
+        render(mNormalMaterial, terrain->getTerrainNormalMap(), mNormalRTT, imgRect);
+    }
+    //---------------------------------------------------------------------
+    void TerrainGpuDerivedData::updateLightmap(Terrain* terrain, const Rect& rect)
+    {
+        if (!mSceneMgr)
+            createScene();
+        updateHeightMap(terrain);
+
+        const TexturePtr& lightmap = terrain->getLightmap();
+        Real size = terrain->getSize();
+        Real lightmapSize = lightmap->getWidth();
+        Real pointSpacing = terrain->getWorldSize() / (size - 1);
+        Real heightPad = (terrain->getMaxHeight() - terrain->getMinHeight()) * 1.0e-3f;
+
+        // Step one point horizontally towards the light per iteration
+        Vector3 toLight;
+        Terrain::convertWorldToTerrainAxes(terrain->getAlignment(),
+            -TerrainGlobalOptions::getSingleton().getLightMapDirection(), &toLight);
+        toLight.x /= pointSpacing;
+        toLight.y /= pointSpacing;
+        Real horizontal = Math::Sqrt(toLight.x * toLight.x + toLight.y * toLight.y);
+        Vector4 lightStep(0, 0, 0, 0);
+        if (horizontal > 1e-6f)
+        {
+            // a light straight above never casts shadows, leave no steps
+            lightStep = Vector4(toLight.x / horizontal, toLight.y / horizontal, 
+                toLight.z / horizontal, Math::Ceil(size * 1.5f));
+        }
+
+        GpuProgramParametersSharedPtr params = 
+            mLightmapMaterial->getTechnique(0)->getPass(0)->getFragmentProgramParameters();
+        params->setNamedConstant("params", 
+            Vector4(size, lightmapSize, heightPad, terrain->getMaxHeight() + heightPad));
+        params->setNamedConstant("lightStep", lightStep);
+
+        // lightmap rows are inverted relative to terrain space
+        long lmSize = static_cast<long>(lightmap->getWidth());
+        Rect imgRect(rect.left, lmSize - rect.bottom, rect.right, lmSize - rect.top);
+        render(mLightmapMaterial, lightmap, mLightmapRTT, imgRect);
+    }
+}
@@ -303,8 +303,9 @@ namespace Ogre
             // Allocate in main thread so no race conditions
             slot->instance = OGRE_NEW Terrain(mSceneManager);
             slot->instance->setResourceGroup(mResourceGroup);
-            // Use shared pool of buffers
-            slot->instance->setGpuBufferAllocator(&mBufferAllocator);
+            // Use shared pool of buffers, unless all terrains share one
+            if (!TerrainGlobalOptions::getSingleton().getUseSharedGpuBufferAllocator())
+                slot->instance->setGpuBufferAllocator(&mBufferAllocator);
 
             LoadRequest req;
             req.slot = slot;
@@ -356,13 +357,7 @@ namespace Ogre
     void TerrainGroup::autoUpdateLodAll(bool synchronous, const Any &data)
     {
         if(mAutoUpdateLod)
-        {
-            for (TerrainSlotMap::iterator i = mTerrainSlots.begin(); i != mTerrainSlots.end(); ++i)
-            {
-                TerrainSlot* slot = i->second;
-                mAutoUpdateLod->autoUpdateLod(slot->instance, synchronous, data);
-            }
-        }
+            mAutoUpdateLod->autoUpdateLodAll(this, synchronous, data);
     }
     //---------------------------------------------------------------------
     void TerrainGroup::unloadTerrain(long x, long y)
@@ -580,6 +575,13 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
+    void TerrainGroup::rayIntersects(const Ray* rays, size_t count, RayResult* results, 
+        Real distanceLimit /* = 0*/) const
+    {
+        for (size_t i = 0; i < count; ++i)
+            results[i] = rayIntersects(rays[i], distanceLimit);
+    }
+    //---------------------------------------------------------------------
     void TerrainGroup::boxIntersects(const AxisAlignedBox& box, TerrainList* resultList) const
     {
         resultList->clear();
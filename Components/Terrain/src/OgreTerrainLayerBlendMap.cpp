@@ -37,6 +37,7 @@ THE SOFTWARE.
 
 namespace Ogre
 {
+    const size_t TerrainLayerBlendMap::TILE_SIZE = 64;
     //---------------------------------------------------------------------
     TerrainLayerBlendMap::TerrainLayerBlendMap(Terrain* parent, uint8 layerIndex, 
         HardwarePixelBuffer* buf)
@@ -46,8 +47,13 @@ namespace Ogre
         , mDirty(false)
         , mBuffer(buf)
         , mData(0)
+        , mFloatData(0)
     {
-        mData = static_cast<float*>(OGRE_MALLOC(mBuffer->getWidth() * mBuffer->getHeight() * sizeof(float), MEMCATEGORY_RESOURCE));
+        mData = static_cast<uint8*>(OGRE_MALLOC(mBuffer->getWidth() * mBuffer->getHeight(), MEMCATEGORY_RESOURCE));
+        mTilesX = (mBuffer->getWidth() + TILE_SIZE - 1) / TILE_SIZE;
+        mTilesY = (mBuffer->getHeight() + TILE_SIZE - 1) / TILE_SIZE;
+        mTiles.resize(mTilesX * mTilesY, 0);
+        mDirtyTiles.resize(mTilesX * mTilesY, false);
 
         // we know which of RGBA we need to look at, now find it in the format
         // because we can't guarantee what precise format the RS gives us
@@ -67,11 +73,16 @@ namespace Ogre
     {
         OGRE_FREE(mData, MEMCATEGORY_RESOURCE);
         mData = 0;
+        OGRE_FREE(mFloatData, MEMCATEGORY_RESOURCE);
+        mFloatData = 0;
+        for (TileList::iterator i = mTiles.begin(); i != mTiles.end(); ++i)
+            OGRE_FREE(*i, MEMCATEGORY_RESOURCE);
+        mTiles.clear();
     }
     //---------------------------------------------------------------------
     void TerrainLayerBlendMap::download()
     {
-        float* pDst = mData;
+        uint8* pDst = mData;
         // Download data
         Image::Box box(0, 0, mBuffer->getWidth(), mBuffer->getHeight());
         uint8* pSrc = static_cast<uint8*>(mBuffer->lock(box, HardwareBuffer::HBL_READ_ONLY).data);
@@ -81,7 +92,7 @@ namespace Ogre
         {
             for (size_t x = box.left; x < box.right; ++x)
             {
-                *pDst++ = static_cast<float>(*pSrc) / 255.0f;
+                *pDst++ = *pSrc;
                 pSrc += srcInc;
             }
         }
@@ -127,21 +138,142 @@ namespace Ogre
     //---------------------------------------------------------------------
     float TerrainLayerBlendMap::getBlendValue(size_t x, size_t y)
     {
-        return *(mData + y * mBuffer->getWidth() + x);
+        if (mFloatData)
+            return *(mFloatData + y * mBuffer->getWidth() + x);
+
+        float* pTile = getTile(x / TILE_SIZE, y / TILE_SIZE, false);
+        if (pTile)
+            return pTile[(y % TILE_SIZE) * TILE_SIZE + x % TILE_SIZE];
+        else
+            return *(mData + y * mBuffer->getWidth() + x) / 255.0f;
     }
     //---------------------------------------------------------------------
     void TerrainLayerBlendMap::setBlendValue(size_t x, size_t y, float val)
     {
-        *(mData + y * mBuffer->getWidth() + x) = val;
+        if (mFloatData)
+            *(mFloatData + y * mBuffer->getWidth() + x) = val;
+        else
+            getTile(x / TILE_SIZE, y / TILE_SIZE, true)[(y % TILE_SIZE) * TILE_SIZE + x % TILE_SIZE] = val;
         dirtyRect(Rect(x, y, x+1, y+1));
 
     }
     //---------------------------------------------------------------------
     float* TerrainLayerBlendMap::getBlendPointer()
     {
+        if (!mFloatData)
+        {
+            size_t width = mBuffer->getWidth();
+            size_t height = mBuffer->getHeight();
+            mFloatData = static_cast<float*>(OGRE_MALLOC(width * height * sizeof(float), MEMCATEGORY_RESOURCE));
+            for (size_t y = 0; y < height; ++y)
+            {
+                for (size_t x = 0; x < width; ++x)
+                    mFloatData[y * width + x] = getBlendValue(x, y);
+            }
+            // the whole map is held in full precision from now on
+            for (TileList::iterator i = mTiles.begin(); i != mTiles.end(); ++i)
+            {
+                OGRE_FREE(*i, MEMCATEGORY_RESOURCE);
+                *i = 0;
+            }
+        }
+        return mFloatData;
+    }
+    //---------------------------------------------------------------------
+    uint8* TerrainLayerBlendMap::getPackedBlendPointer()
+    {
+        // pack pending edits, then drop the tiles so the 8-bit data is authoritative
+        for (size_t ty = 0; ty < mTilesY; ++ty)
+        {
+            for (size_t tx = 0; tx < mTilesX; ++tx)
+            {
+                float*& pTile = mTiles[ty * mTilesX + tx];
+                if (pTile)
+                {
+                    packTile(tx, ty, Box(0, 0, mBuffer->getWidth(), mBuffer->getHeight()));
+                    OGRE_FREE(pTile, MEMCATEGORY_RESOURCE);
+                    pTile = 0;
+                }
+            }
+        }
         return mData;
     }
     //---------------------------------------------------------------------
+    void TerrainLayerBlendMap::addBlendValues(const Rect& rect, const float* weights, float amount)
+    {
+        long width = rect.right - rect.left;
+        for (long y = rect.top; y < rect.bottom; ++y)
+        {
+            for (long x = rect.left; x < rect.right; ++x)
+            {
+                float w = weights ? weights[(y - rect.top) * width + x - rect.left] : 1.0f;
+                float* pVal = mFloatData ? mFloatData + y * mBuffer->getWidth() + x :
+                    getTile(x / TILE_SIZE, y / TILE_SIZE, true) + (y % TILE_SIZE) * TILE_SIZE + x % TILE_SIZE;
+                *pVal = Math::Clamp(*pVal + w * amount, 0.0f, 1.0f);
+            }
+        }
+        dirtyRect(rect);
+    }
+    //---------------------------------------------------------------------
+    float* TerrainLayerBlendMap::getTile(size_t tileX, size_t tileY, bool create)
+    {
+        float*& pTile = mTiles[tileY * mTilesX + tileX];
+        if (!pTile && create)
+        {
+            pTile = static_cast<float*>(OGRE_MALLOC(TILE_SIZE * TILE_SIZE * sizeof(float), MEMCATEGORY_RESOURCE));
+            memset(pTile, 0, TILE_SIZE * TILE_SIZE * sizeof(float));
+            size_t right = std::min((tileX + 1) * TILE_SIZE, (size_t)mBuffer->getWidth());
+            size_t bottom = std::min((tileY + 1) * TILE_SIZE, (size_t)mBuffer->getHeight());
+            for (size_t y = tileY * TILE_SIZE; y < bottom; ++y)
+            {
+                const uint8* pSrc = mData + y * mBuffer->getWidth();
+                float* pDst = pTile + (y % TILE_SIZE) * TILE_SIZE;
+                for (size_t x = tileX * TILE_SIZE; x < right; ++x)
+                    pDst[x % TILE_SIZE] = pSrc[x] / 255.0f;
+            }
+        }
+        return pTile;
+    }
+    //---------------------------------------------------------------------
+    void TerrainLayerBlendMap::refreshFloatData(const Box& box)
+    {
+        size_t width = mBuffer->getWidth();
+        for (size_t y = box.top; y < box.bottom; ++y)
+        {
+            for (size_t x = box.left; x < box.right; ++x)
+            {
+                float val = mData[y * width + x] / 255.0f;
+                if (mFloatData)
+                    mFloatData[y * width + x] = val;
+                float* pTile = getTile(x / TILE_SIZE, y / TILE_SIZE, false);
+                if (pTile)
+                    pTile[(y % TILE_SIZE) * TILE_SIZE + x % TILE_SIZE] = val;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void TerrainLayerBlendMap::packTile(size_t tileX, size_t tileY, const Box& box)
+    {
+        const float* pTile = mTiles[tileY * mTilesX + tileX];
+        if (!mFloatData && !pTile)
+            return; // the 8-bit data is up to date
+
+        size_t width = mBuffer->getWidth();
+        size_t left = std::max(tileX * TILE_SIZE, (size_t)box.left);
+        size_t top = std::max(tileY * TILE_SIZE, (size_t)box.top);
+        size_t right = std::min((tileX + 1) * TILE_SIZE, (size_t)box.right);
+        size_t bottom = std::min((tileY + 1) * TILE_SIZE, (size_t)box.bottom);
+        for (size_t y = top; y < bottom; ++y)
+        {
+            for (size_t x = left; x < right; ++x)
+            {
+                float val = mFloatData ? mFloatData[y * width + x] : 
+                    pTile[(y % TILE_SIZE) * TILE_SIZE + x % TILE_SIZE];
+                mData[y * width + x] = static_cast<uint8>(Math::Clamp(val, 0.0f, 1.0f) * 255 + 0.5f);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
     void TerrainLayerBlendMap::dirty()
     {
         Rect rect;
@@ -168,25 +300,52 @@ namespace Ogre
             mDirtyBox.bottom = static_cast<uint32>(rect.bottom);
             mDirty = true;
         }
+
+        if (rect.right > rect.left && rect.bottom > rect.top)
+        {
+            for (size_t ty = rect.top / TILE_SIZE; ty <= (rect.bottom - 1) / TILE_SIZE; ++ty)
+            {
+                for (size_t tx = rect.left / TILE_SIZE; tx <= (rect.right - 1) / TILE_SIZE; ++tx)
+                    mDirtyTiles[ty * mTilesX + tx] = true;
+            }
+        }
     }
     //---------------------------------------------------------------------
     void TerrainLayerBlendMap::update()
     {
         if (mData && mDirty)
         {
-            // Upload data
-            float* pSrcBase = mData + mDirtyBox.top * mBuffer->getWidth() + mDirtyBox.left;
-            uint8* pDstBase = static_cast<uint8*>(mBuffer->lock(mDirtyBox, HardwarePixelBuffer::HBL_NORMAL).data);
+            // Upload data, the other channels belong to other layers so only
+            // the dirty tiles within the dirty box are written
+            const PixelBox& lockBox = mBuffer->lock(mDirtyBox, HardwarePixelBuffer::HBL_NORMAL);
+            uint8* pDstBase = static_cast<uint8*>(lockBox.data);
             pDstBase += mChannelOffset;
             size_t dstInc = PixelUtil::getNumElemBytes(mBuffer->getFormat());
-            for (size_t y = 0; y < mDirtyBox.getHeight(); ++y)
+            size_t dstRowPitch = lockBox.rowPitch * dstInc;
+            for (size_t ty = 0; ty < mTilesY; ++ty)
             {
-                float* pSrc = pSrcBase + y * mBuffer->getWidth();
-                uint8* pDst = pDstBase + y * mBuffer->getWidth() * dstInc;
-                for (size_t x = 0; x < mDirtyBox.getWidth(); ++x)
+                for (size_t tx = 0; tx < mTilesX; ++tx)
                 {
-                    *pDst = static_cast<uint8>(*pSrc++ * 255);
-                    pDst += dstInc;
+                    if (!mDirtyTiles[ty * mTilesX + tx])
+                        continue;
+                    mDirtyTiles[ty * mTilesX + tx] = false;
+
+                    packTile(tx, ty, mDirtyBox);
+                    size_t left = std::max(tx * TILE_SIZE, (size_t)mDirtyBox.left);
+                    size_t top = std::max(ty * TILE_SIZE, (size_t)mDirtyBox.top);
+                    size_t right = std::min((tx + 1) * TILE_SIZE, (size_t)mDirtyBox.right);
+                    size_t bottom = std::min((ty + 1) * TILE_SIZE, (size_t)mDirtyBox.bottom);
+                    for (size_t y = top; y < bottom; ++y)
+                    {
+                        const uint8* pSrc = mData + y * mBuffer->getWidth() + left;
+                        uint8* pDst = pDstBase + (y - mDirtyBox.top) * dstRowPitch + 
+                            (left - mDirtyBox.left) * dstInc;
+                        for (size_t x = left; x < right; ++x)
+                        {
+                            *pDst = *pSrc++;
+                            pDst += dstInc;
+                        }
+                    }
                 }
             }
             mBuffer->unlock();
@@ -222,7 +381,10 @@ namespace Ogre
 
         // pixel conversion
         PixelBox dstMemBox(dstBox, PF_L8, mData);
+        dstMemBox.rowPitch = mBuffer->getWidth();
+        dstMemBox.slicePitch = mBuffer->getWidth() * mBuffer->getHeight();
         PixelUtil::bulkPixelConversion(*srcBox, dstMemBox);
+        refreshFloatData(dstBox);
 
         if (srcBox != &src)
         {
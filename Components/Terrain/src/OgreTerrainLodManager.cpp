@@ -36,7 +36,7 @@ namespace Ogre
 {
     const uint16 TerrainLodManager::WORKQUEUE_LOAD_LOD_DATA_REQUEST = 1;
     const uint32 TerrainLodManager::TERRAINLODDATA_CHUNK_ID = StreamSerialiser::makeIdentifier("TLDA");
-    const uint16 TerrainLodManager::TERRAINLODDATA_CHUNK_VERSION = 1;
+    const uint16 TerrainLodManager::TERRAINLODDATA_CHUNK_VERSION = 2;
 
     TerrainLodManager::TerrainLodManager(Terrain* t, DataStreamPtr& stream)
         : mTerrain(t)
@@ -298,11 +298,49 @@ namespace Ogre
         separateData(terrain->mHeightData, terrain->getSize(), numLodLevels, lods);
         separateData(terrain->mDeltaData, terrain->getSize(), numLodLevels, lods);
 
+        bool quantise = TerrainGlobalOptions::getSingleton().getUseQuantisedHeightData();
+        float minHeight = 0, heightRange = 0;
+        if (quantise)
+        {
+            size_t numVertices = (size_t)terrain->getSize() * terrain->getSize();
+            const float* heights = terrain->mHeightData;
+            minHeight = *std::min_element(heights, heights + numVertices);
+            heightRange = *std::max_element(heights, heights + numVertices) - minHeight;
+        }
+        vector<uint16>::type quantHeights;
+        vector<int16>::type quantDeltas;
+
         for (int level = numLodLevels - 1; level >=0; level--)
         {
             stream.writeChunkBegin(TERRAINLODDATA_CHUNK_ID, TERRAINLODDATA_CHUNK_VERSION);
             stream.startDeflate();
-            stream.write(&(lods[level][0]), lods[level].size());
+            stream.write(&quantise);
+            if (quantise)
+            {
+                // heights first, then deltas (see separateData)
+                const LodData& lod = lods[level];
+                size_t count = lod.size() / 2;
+                float heightScale = heightRange > 0 ? 65535.0f / heightRange : 0;
+                float deltaScale = heightRange > 0 ? 32767.0f / heightRange : 0;
+                quantHeights.resize(count);
+                quantDeltas.resize(count);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    float h = (lod[i] - minHeight) * heightScale + 0.5f;
+                    float d = lod[count + i] * deltaScale;
+                    quantHeights[i] = static_cast<uint16>(Math::Clamp(h, 0.0f, 65535.0f));
+                    d = Math::Clamp(d, -32767.0f, 32767.0f);
+                    quantDeltas[i] = static_cast<int16>(d < 0 ? d - 0.5f : d + 0.5f);
+                }
+                stream.write(&minHeight);
+                stream.write(&heightRange);
+                stream.write(&quantHeights[0], count);
+                stream.write(&quantDeltas[0], count);
+            }
+            else
+            {
+                stream.write(&(lods[level][0]), lods[level].size());
+            }
             stream.stopDeflate();
             stream.writeChunkEnd(TERRAINLODDATA_CHUNK_ID);
         }
@@ -335,6 +373,8 @@ namespace Ogre
             // uncompress
             uint maxSize = 2 * mTerrain->getGeoDataSizeAtLod(higherLodBound);
             float *lodData = OGRE_ALLOC_T(float, maxSize, MEMCATEGORY_GENERAL);
+            vector<uint16>::type quantHeights;
+            vector<int16>::type quantDeltas;
 
             for(int level=lowerLodBound; level>=higherLodBound; level-- )
             {
@@ -345,13 +385,38 @@ namespace Ogre
                 const StreamSerialiser::Chunk *c = stream.readChunkBegin(TERRAINLODDATA_CHUNK_ID,
                         TERRAINLODDATA_CHUNK_VERSION);
                 stream.startDeflate(c->length);
-                stream.read(lodData, dataSize);
+                bool quantised = false;
+                if (c->version > 1)
+                    stream.read(&quantised);
+                if (quantised)
+                {
+                    uint count = dataSize / 2;
+                    float minHeight, heightRange;
+                    stream.read(&minHeight);
+                    stream.read(&heightRange);
+                    quantHeights.resize(count);
+                    quantDeltas.resize(count);
+                    stream.read(&quantHeights[0], count);
+                    stream.read(&quantDeltas[0], count);
+                    float heightStep = heightRange / 65535.0f;
+                    float deltaStep = heightRange / 32767.0f;
+                    for (uint i = 0; i < count; ++i)
+                    {
+                        lodData[i] = minHeight + quantHeights[i] * heightStep;
+                        lodData[count + i] = quantDeltas[i] * deltaStep;
+                    }
+                }
+                else
+                {
+                    stream.read(lodData, dataSize);
+                }
                 stream.stopDeflate();
                 stream.readChunkEnd(TERRAINLODDATA_CHUNK_ID);
 
                 fillBufferAtLod(level, lodData, dataSize);
             }
             stream.readChunkEnd(Terrain::TERRAIN_CHUNK_ID);
+            mTerrain->updateRayHeightBounds(Rect(0, 0, mTerrain->getSize(), mTerrain->getSize()));
 
             OGRE_FREE(lodData, MEMCATEGORY_GENERAL);
         }
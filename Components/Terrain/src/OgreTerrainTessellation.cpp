@@ -0,0 +1,535 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreTerrainTessellation.h"
+#include "OgreTerrain.h"
+#include "OgreRoot.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreTextureUnitState.h"
+#include "OgreTextureManager.h"
+#include "OgreHardwarePixelBuffer.h"
+#include "OgreHardwareBufferManager.h"
+#include "OgreHighLevelGpuProgram.h"
+#include "OgreHighLevelGpuProgramManager.h"
+#include "OgreGpuProgramManager.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        const char* GLSL_VP =
+            "#version 400\n"
+            "in vec4 vertex;\n"
+            "out vec2 vPos;\n"
+            "void main()\n"
+            "{\n"
+            "    vPos = vertex.xy;\n"
+            "}\n";
+
+        const char* GLSL_HP =
+            "#version 400\n"
+            "layout(vertices = 4) out;\n"
+            "in vec2 vPos[];\n"
+            "out vec2 tcPos[];\n"
+            "uniform mat4 worldView;\n"
+            "uniform mat4 projection;\n"
+            "uniform vec4 viewportSize;\n"
+            "uniform vec4 tessParams;\n"
+            "float edgeFactor(vec2 a, vec2 b)\n"
+            "{\n"
+            "    vec4 c = worldView * vec4(0.5 * (a + b), tessParams.y, 1.0);\n"
+            "    float pixels = length(b - a) * projection[1][1] * 0.5 * viewportSize.y / max(-c.z, 0.0001);\n"
+            "    return clamp(pixels / tessParams.x, 1.0, tessParams.z);\n"
+            "}\n"
+            "void main()\n"
+            "{\n"
+            "    tcPos[gl_InvocationID] = vPos[gl_InvocationID];\n"
+            "    if (gl_InvocationID == 0)\n"
+            "    {\n"
+            "        gl_TessLevelOuter[0] = edgeFactor(vPos[3], vPos[0]);\n"
+            "        gl_TessLevelOuter[1] = edgeFactor(vPos[0], vPos[1]);\n"
+            "        gl_TessLevelOuter[2] = edgeFactor(vPos[1], vPos[2]);\n"
+            "        gl_TessLevelOuter[3] = edgeFactor(vPos[2], vPos[3]);\n"
+            "        gl_TessLevelInner[0] = max(gl_TessLevelOuter[1], gl_TessLevelOuter[3]);\n"
+            "        gl_TessLevelInner[1] = max(gl_TessLevelOuter[0], gl_TessLevelOuter[2]);\n"
+            "    }\n"
+            "}\n";
+
+        const char* GLSL_DP =
+            "#version 400\n"
+            "layout(quads, fractional_even_spacing, ccw) in;\n"
+            "in vec2 tcPos[];\n"
+            "out vec2 uv;\n"
+            "uniform mat4 worldViewProj;\n"
+            "uniform vec4 terrainParams;\n"
+            "uniform sampler2D heightMap;\n"
+            "void main()\n"
+            "{\n"
+            "    vec2 t = gl_TessCoord.xy;\n"
+            "    vec2 p = mix(mix(tcPos[0], tcPos[1], t.x), mix(tcPos[3], tcPos[2], t.x), t.y);\n"
+            "    vec2 f = (p - terrainParams.x) / terrainParams.y;\n"
+            "    uv = vec2(f.x, 1.0 - f.y);\n"
+            "    vec2 texel = (uv * (terrainParams.z - 1.0) + 0.5) / terrainParams.z;\n"
+            "    float h = textureLod(heightMap, texel, 0.0).r;\n"
+            "    gl_Position = worldViewProj * vec4(p, h, 1.0);\n"
+            "}\n";
+
+        const char* GLSL_FP =
+            "#version 400\n"
+            "in vec2 uv;\n"
+            "uniform sampler2D normalMap;\n"
+            "uniform sampler2D colourMap;\n"
+            "uniform vec3 lightDir;\n"
+            "uniform vec4 ambient;\n"
+            "uniform vec4 diffuse;\n"
+            "uniform float colourWeight;\n"
+            "out vec4 fragColour;\n"
+            "void main()\n"
+            "{\n"
+            "    vec3 n = normalize(texture(normalMap, uv).rgb * 2.0 - 1.0);\n"
+            "    vec3 c = mix(vec3(1.0), texture(colourMap, uv).rgb, colourWeight);\n"
+            "    fragColour = vec4(c * (ambient.rgb + diffuse.rgb * max(dot(n, lightDir), 0.0)), 1.0);\n"
+            "}\n";
+
+        const char* HLSL_COMMON =
+            "struct ControlPoint\n"
+            "{\n"
+            "    float2 pos : TEXCOORD0;\n"
+            "};\n"
+            "struct PatchTess\n"
+            "{\n"
+            "    float edges[4] : SV_TessFactor;\n"
+            "    float inside[2] : SV_InsideTessFactor;\n"
+            "};\n";
+
+        const char* HLSL_VP =
+            "ControlPoint main_vp(float4 vertex : POSITION)\n"
+            "{\n"
+            "    ControlPoint o;\n"
+            "    o.pos = vertex.xy;\n"
+            "    return o;\n"
+            "}\n";
+
+        const char* HLSL_HP =
+            "float4x4 worldView;\n"
+            "float4x4 projection;\n"
+            "float4 viewportSize;\n"
+            "float4 tessParams;\n"
+            "float edgeFactor(float2 a, float2 b)\n"
+            "{\n"
+            "    float4 c = mul(worldView, float4(0.5 * (a + b), tessParams.y, 1.0));\n"
+            "    float pixels = length(b - a) * projection[1][1] * 0.5 * viewportSize.y / max(-c.z, 0.0001);\n"
+            "    return clamp(pixels / tessParams.x, 1.0, tessParams.z);\n"
+            "}\n"
+            "PatchTess patchConstants(InputPatch<ControlPoint, 4> p)\n"
+            "{\n"
+            "    PatchTess o;\n"
+            "    o.edges[0] = edgeFactor(p[3].pos, p[0].pos);\n"
+            "    o.edges[1] = edgeFactor(p[0].pos, p[1].pos);\n"
+            "    o.edges[2] = edgeFactor(p[1].pos, p[2].pos);\n"
+            "    o.edges[3] = edgeFactor(p[2].pos, p[3].pos);\n"
+            "    o.inside[0] = max(o.edges[1], o.edges[3]);\n"
+            "    o.inside[1] = max(o.edges[0], o.edges[2]);\n"
+            "    return o;\n"
+            "}\n"
+            "[domain(\"quad\")]\n"
+            "[partitioning(\"fractional_even\")]\n"
+            "[outputtopology(\"triangle_ccw\")]\n"
+            "[outputcontrolpoints(4)]\n"
+            "[patchconstantfunc(\"patchConstants\")]\n"
+            "ControlPoint main_hp(InputPatch<ControlPoint, 4> p, uint i : SV_OutputControlPointID)\n"
+            "{\n"
+            "    return p[i];\n"
+            "}\n";
+
+        const char* HLSL_DP =
+            "Texture2D heightMap : register(t0);\n"
+            "SamplerState heightSampler : register(s0);\n"
+            "float4x4 worldViewProj;\n"
+            "float4 terrainParams;\n"
+            "struct DomainOut\n"
+            "{\n"
+            "    float4 pos : SV_POSITION;\n"
+            "    float2 uv : TEXCOORD0;\n"
+            "};\n"
+            "[domain(\"quad\")]\n"
+            "DomainOut main_dp(PatchTess tess, float2 t : SV_DomainLocation,\n"
+            "    const OutputPatch<ControlPoint, 4> p)\n"
+            "{\n"
+            "    DomainOut o;\n"
+            "    float2 pos = lerp(lerp(p[0].pos, p[1].pos, t.x), lerp(p[3].pos, p[2].pos, t.x), t.y);\n"
+            "    float2 f = (pos - terrainParams.x) / terrainParams.y;\n"
+            "    o.uv = float2(f.x, 1.0 - f.y);\n"
+            "    float2 texel = (o.uv * (terrainParams.z - 1.0) + 0.5) / terrainParams.z;\n"
+            "    float h = heightMap.SampleLevel(heightSampler, texel, 0).r;\n"
+            "    o.pos = mul(worldViewProj, float4(pos, h, 1.0));\n"
+            "    return o;\n"
+            "}\n";
+
+        const char* HLSL_FP =
+            "Texture2D normalMap : register(t0);\n"
+            "SamplerState normalSampler : register(s0);\n"
+            "Texture2D colourMap : register(t1);\n"
+            "SamplerState colourSampler : register(s1);\n"
+            "float4 main_fp(float4 pos : SV_POSITION,\n"
+            "    float2 uv : TEXCOORD0,\n"
+            "    uniform float3 lightDir,\n"
+            "    uniform float4 ambient,\n"
+            "    uniform float4 diffuse,\n"
+            "    uniform float colourWeight) : SV_TARGET\n"
+            "{\n"
+            "    float3 n = normalize(normalMap.Sample(normalSampler, uv).rgb * 2.0 - 1.0);\n"
+            "    float3 c = lerp(float3(1, 1, 1), colourMap.Sample(colourSampler, uv).rgb, colourWeight);\n"
+            "    return float4(c * (ambient.rgb + diffuse.rgb * max(dot(n, lightDir), 0.0)), 1.0);\n"
+            "}\n";
+
+        String getShaderLanguage(void)
+        {
+            HighLevelGpuProgramManager& hmgr = HighLevelGpuProgramManager::getSingleton();
+            if (hmgr.isLanguageSupported("hlsl") &&
+                GpuProgramManager::getSingleton().isSyntaxSupported("hs_5_0"))
+                return "hlsl";
+            else if (hmgr.isLanguageSupported("glsl") &&
+                Root::getSingleton().getRenderSystem()->getNativeShadingLanguageVersion() >= 400)
+                return "glsl";
+            return BLANKSTRING;
+        }
+
+        HighLevelGpuProgramPtr createProgram(const String& name, GpuProgramType type, 
+            const char* glslSource, const char* hlslSource, const char* target, const char* entry)
+        {
+            String lang = getShaderLanguage();
+            HighLevelGpuProgramManager& hmgr = HighLevelGpuProgramManager::getSingleton();
+            String group = ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME;
+
+            HighLevelGpuProgramPtr prog = hmgr.getByName(name, group);
+            if (prog.isNull())
+            {
+                prog = hmgr.createProgram(name, group, lang, type);
+                if (lang == "hlsl")
+                {
+                    // vertex and fragment programs don't need the patch structures
+                    prog->setSource((type == GPT_HULL_PROGRAM || type == GPT_DOMAIN_PROGRAM ||
+                        type == GPT_VERTEX_PROGRAM) ? String(HLSL_COMMON) + hlslSource : String(hlslSource));
+                    prog->setParameter("target", target);
+                    prog->setParameter("entry_point", entry);
+                }
+                else
+                    prog->setSource(glslSource);
+            }
+            return prog;
+        }
+
+        /// Highest tessellation factor supported by both APIs
+        const Real MAX_TESS_FACTOR = 64;
+    }
+    //---------------------------------------------------------------------
+    TerrainTessellation::TerrainTessellation(Terrain* terrain, uint16 patchesPerSide)
+        : mTerrain(terrain)
+        , mPatchesPerSide(patchesPerSide)
+        , mPixelsPerEdge(8)
+        , mPatches(0)
+        , mNode(0)
+        , mVertexData(0)
+        , mIndexData(0)
+        , mDefaultMaterial(false)
+    {
+        if (!patchesPerSide || (size_t)(patchesPerSide + 1) * (patchesPerSide + 1) > 65535)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "The number of patches per side must be between 1 and 254",
+                "TerrainTessellation::TerrainTessellation");
+        }
+
+        // use our own pointer as identifier, as Terrain does for its material
+        TerrainTessellation* pThis = this;
+        mName = "OgreTerrainTessellation/" + StringConverter::toString(FastHash((const char*)&pThis, sizeof(TerrainTessellation*)));
+
+        uint16 size = terrain->getSize();
+        mHeightMap = TextureManager::getSingleton().createManual(
+            mName + "/heights", ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME,
+            TEX_TYPE_2D, size, size, 0, PF_FLOAT32_R, TU_DYNAMIC_WRITE_ONLY);
+
+        mPatches = OGRE_NEW Patches(this);
+        createGeometry();
+
+        // Terrain space has heights along Z
+        Vector3 axes[3];
+        Terrain::convertTerrainToWorldAxes(terrain->getAlignment(), Vector3::UNIT_X, &axes[0]);
+        Terrain::convertTerrainToWorldAxes(terrain->getAlignment(), Vector3::UNIT_Y, &axes[1]);
+        Terrain::convertTerrainToWorldAxes(terrain->getAlignment(), Vector3::UNIT_Z, &axes[2]);
+
+        mNode = terrain->getSceneManager()->getRootSceneNode()->createChildSceneNode(
+            terrain->getPosition(), Quaternion(axes[0], axes[1], axes[2]));
+        mNode->attachObject(mPatches);
+
+        updateHeights();
+        createDefaultMaterial();
+    }
+    //---------------------------------------------------------------------
+    TerrainTessellation::~TerrainTessellation()
+    {
+        mNode->detachAllObjects();
+        mTerrain->getSceneManager()->destroySceneNode(mNode);
+        OGRE_DELETE mPatches;
+
+        if (!mPatchMaterial.isNull())
+            MaterialManager::getSingleton().remove(mPatchMaterial->getHandle());
+        if (mDefaultMaterial)
+            MaterialManager::getSingleton().remove(mMaterial->getHandle());
+        TextureManager::getSingleton().remove(mHeightMap->getHandle());
+
+        OGRE_DELETE mVertexData;
+        OGRE_DELETE mIndexData;
+    }
+    //---------------------------------------------------------------------
+    bool TerrainTessellation::isSupported(void)
+    {
+        RenderSystem* rsys = Root::getSingleton().getRenderSystem();
+        return rsys && rsys->getCapabilities()->hasCapability(RSC_TESSELLATION_HULL_PROGRAM) &&
+            rsys->getCapabilities()->hasCapability(RSC_TESSELLATION_DOMAIN_PROGRAM) &&
+            rsys->getCapabilities()->hasCapability(RSC_TEXTURE_FLOAT) &&
+            !getShaderLanguage().empty();
+    }
+    //---------------------------------------------------------------------
+    void TerrainTessellation::createGeometry(void)
+    {
+        // One control point per patch corner, in terrain space
+        size_t verts = mPatchesPerSide + 1;
+        Real base = -mTerrain->getWorldSize() * 0.5f;
+        Real spacing = mTerrain->getWorldSize() / mPatchesPerSide;
+        mVertexData = OGRE_NEW VertexData();
+        mVertexData->vertexStart = 0;
+        mVertexData->vertexCount = verts * verts;
+        mVertexData->vertexDeclaration->addElement(0, 0, VET_FLOAT2, VES_POSITION);
+        HardwareVertexBufferSharedPtr vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+            sizeof(float) * 2, mVertexData->vertexCount, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        mVertexData->vertexBufferBinding->setBinding(0, vbuf);
+        float* pPos = static_cast<float*>(vbuf->lock(HardwareBuffer::HBL_DISCARD));
+        for (size_t y = 0; y < verts; ++y)
+        {
+            for (size_t x = 0; x < verts; ++x)
+            {
+                *pPos++ = static_cast<float>(base + x * spacing);
+                *pPos++ = static_cast<float>(base + y * spacing);
+            }
+        }
+        vbuf->unlock();
+
+        // Counter-clockwise seen from above
+        mIndexData = OGRE_NEW IndexData();
+        mIndexData->indexStart = 0;
+        mIndexData->indexCount = (size_t)mPatchesPerSide * mPatchesPerSide * 4;
+        mIndexData->indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+            HardwareIndexBuffer::IT_16BIT, mIndexData->indexCount, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        uint16* pIndexes = static_cast<uint16*>(mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+        for (size_t y = 0; y < mPatchesPerSide; ++y)
+        {
+            for (size_t x = 0; x < mPatchesPerSide; ++x)
+            {
+                uint16 i00 = static_cast<uint16>(y * verts + x);
+                *pIndexes++ = i00;
+                *pIndexes++ = static_cast<uint16>(i00 + 1);
+                *pIndexes++ = static_cast<uint16>(i00 + verts + 1);
+                *pIndexes++ = static_cast<uint16>(i00 + verts);
+            }
+        }
+        mIndexData->indexBuffer->unlock();
+
+        RenderOperation op;
+        op.operationType = RenderOperation::OT_PATCH_4_CONTROL_POINT;
+        op.useIndexes = true;
+        op.vertexData = mVertexData;
+        op.indexData = mIndexData;
+        mPatches->setRenderOperation(op);
+    }
+    //---------------------------------------------------------------------
+    void TerrainTessellation::createDefaultMaterial(void)
+    {
+        HighLevelGpuProgramPtr vp = createProgram("OgreTerrainTessellation/VP", GPT_VERTEX_PROGRAM,
+            GLSL_VP, HLSL_VP, "vs_5_0", "main_vp");
+
+        HighLevelGpuProgramPtr hp = createProgram("OgreTerrainTessellation/HP", GPT_HULL_PROGRAM,
+            GLSL_HP, HLSL_HP, "hs_5_0", "main_hp");
+        GpuProgramParametersSharedPtr params = hp->getDefaultParameters();
+        params->setNamedAutoConstant("worldView", GpuProgramParameters::ACT_WORLDVIEW_MATRIX);
+        params->setNamedAutoConstant("projection", GpuProgramParameters::ACT_PROJECTION_MATRIX);
+        params->setNamedAutoConstant("viewportSize", GpuProgramParameters::ACT_VIEWPORT_SIZE);
+        params->setNamedAutoConstant("tessParams", GpuProgramParameters::ACT_CUSTOM, 1);
+
+        HighLevelGpuProgramPtr dp = createProgram("OgreTerrainTessellation/DP", GPT_DOMAIN_PROGRAM,
+            GLSL_DP, HLSL_DP, "ds_5_0", "main_dp");
+        params = dp->getDefaultParameters();
+        params->setNamedAutoConstant("worldViewProj", GpuProgramParameters::ACT_WORLDVIEWPROJ_MATRIX);
+        params->setNamedAutoConstant("terrainParams", GpuProgramParameters::ACT_CUSTOM, 0);
+
+        HighLevelGpuProgramPtr fp = createProgram("OgreTerrainTessellation/FP", GPT_FRAGMENT_PROGRAM,
+            GLSL_FP, HLSL_FP, "ps_5_0", "main_fp");
+
+        if (vp->getLanguage() == "glsl")
+        {
+            dp->getDefaultParameters()->setNamedConstant("heightMap", 0);
+            fp->getDefaultParameters()->setNamedConstant("normalMap", 1);
+            fp->getDefaultParameters()->setNamedConstant("colourMap", 2);
+        }
+
+        MaterialPtr mat = MaterialManager::getSingleton().create(mName, 
+            ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+        Pass* pass = mat->getTechnique(0)->getPass(0);
+        pass->setVertexProgram(vp->getName());
+        pass->setTessellationHullProgram(hp->getName());
+        pass->setTessellationDomainProgram(dp->getName());
+        pass->setFragmentProgram(fp->getName());
+        pass->createTextureUnitState();
+        pass->createTextureUnitState();
+        pass->createTextureUnitState();
+
+        setMaterial(mat);
+        mDefaultMaterial = true;
+        updateParams();
+    }
+    //---------------------------------------------------------------------
+    void TerrainTessellation::setMaterial(const MaterialPtr& mat)
+    {
+        if (mDefaultMaterial && mat != mMaterial)
+        {
+            MaterialManager::getSingleton().remove(mMaterial->getHandle());
+            mDefaultMaterial = false;
+        }
+        mMaterial = mat;
+
+        if (!mPatchMaterial.isNull())
+            MaterialManager::getSingleton().remove(mPatchMaterial->getHandle());
+        mPatchMaterial = mat->clone(mName + "/patches");
+        mPatchMaterial->load();
+
+        Technique* tech = mPatchMaterial->getBestTechnique();
+        for (unsigned short p = 0; tech && p < tech->getNumPasses(); ++p)
+        {
+            Pass* pass = tech->getPass(p);
+            if (pass->getNumTextureUnitStates() > 0)
+            {
+                TextureUnitState* tu = pass->getTextureUnitState(0);
+                tu->setTexture(mHeightMap);
+                tu->setBindingType(TextureUnitState::BT_TESSELLATION_DOMAIN);
+                tu->setTextureAddressingMode(TextureUnitState::TAM_CLAMP);
+                tu->setTextureFiltering(TFO_BILINEAR);
+            }
+            if (pass->getNumTextureUnitStates() > 1)
+            {
+                TextureUnitState* tu = pass->getTextureUnitState(1);
+                tu->setTexture(mTerrain->getTerrainNormalMap());
+                tu->setTextureAddressingMode(TextureUnitState::TAM_CLAMP);
+            }
+            if (pass->getNumTextureUnitStates() > 2)
+            {
+                // without a composite map the colour is ignored by the default material
+                TextureUnitState* tu = pass->getTextureUnitState(2);
+                tu->setTexture(mTerrain->getCompositeMap().isNull() ? 
+                    mTerrain->getTerrainNormalMap() : mTerrain->getCompositeMap());
+                tu->setTextureAddressingMode(TextureUnitState::TAM_CLAMP);
+            }
+        }
+        mPatches->setMaterial(mPatchMaterial->getName());
+        mPatches->setCustomParameter(1, Vector4(mPixelsPerEdge, 
+            (mTerrain->getMinHeight() + mTerrain->getMaxHeight()) * 0.5f, MAX_TESS_FACTOR, 0));
+    }
+    //---------------------------------------------------------------------
+    void TerrainTessellation::setPixelsPerEdge(Real pixels)
+    {
+        mPixelsPerEdge = pixels;
+        mPatches->setCustomParameter(1, Vector4(mPixelsPerEdge, 
+            (mTerrain->getMinHeight() + mTerrain->getMaxHeight()) * 0.5f, MAX_TESS_FACTOR, 0));
+    }
+    //---------------------------------------------------------------------
+    void TerrainTessellation::updateHeights(void)
+    {
+        // rows are flipped to match the terrain texture coordinates
+        uint16 size = mTerrain->getSize();
+        const float* pHeights = mTerrain->getHeightData();
+        HardwarePixelBufferSharedPtr buf = mHeightMap->getBuffer();
+        const PixelBox& box = buf->lock(Image::Box(0, 0, size, size), HardwareBuffer::HBL_DISCARD);
+        float* pDst = static_cast<float*>(box.data);
+        for (uint16 r = 0; r < size; ++r)
+        {
+            memcpy(pDst + (size_t)r * box.rowPitch, pHeights + (size_t)(size - 1 - r) * size,
+                sizeof(float) * size);
+        }
+        buf->unlock();
+
+        Real half = mTerrain->getWorldSize() * 0.5f;
+        mPatches->setBoundingBox(AxisAlignedBox(-half, -half, mTerrain->getMinHeight(),
+            half, half, mTerrain->getMaxHeight()));
+        mPatches->setCustomParameter(0, Vector4(-half, mTerrain->getWorldSize(), (Real)size, 0));
+        mPatches->setCustomParameter(1, Vector4(mPixelsPerEdge, 
+            (mTerrain->getMinHeight() + mTerrain->getMaxHeight()) * 0.5f, MAX_TESS_FACTOR, 0));
+        if (mNode)
+            mNode->needUpdate();
+    }
+    //---------------------------------------------------------------------
+    void TerrainTessellation::updateParams(void)
+    {
+        TerrainGlobalOptions& opts = TerrainGlobalOptions::getSingleton();
+        Vector3 lightDir;
+        Terrain::convertWorldToTerrainAxes(mTerrain->getAlignment(), -opts.getLightMapDirection(), &lightDir);
+        lightDir.normalise();
+        GpuProgramParametersSharedPtr params =
+            mPatchMaterial->getTechnique(0)->getPass(0)->getFragmentProgramParameters();
+        params->setNamedConstant("lightDir", lightDir);
+        params->setNamedConstant("ambient", opts.getCompositeMapAmbient());
+        params->setNamedConstant("diffuse", opts.getCompositeMapDiffuse());
+        params->setNamedConstant("colourWeight", mTerrain->getCompositeMap().isNull() ? 0.0f : 1.0f);
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    TerrainTessellation::Patches::Patches(TerrainTessellation* parent)
+        : mParent(parent)
+    {
+        setCastShadows(false);
+        setRenderQueueGroup(TerrainGlobalOptions::getSingleton().getRenderQueueGroup());
+        setVisibilityFlags(TerrainGlobalOptions::getSingleton().getVisibilityFlags());
+        setQueryFlags(TerrainGlobalOptions::getSingleton().getQueryFlags());
+    }
+    //---------------------------------------------------------------------
+    TerrainTessellation::Patches::~Patches()
+    {
+    }
+    //---------------------------------------------------------------------
+    Real TerrainTessellation::Patches::getSquaredViewDepth(const Camera* cam) const
+    {
+        return mParentNode ? mParentNode->getSquaredViewDepth(cam) : 0;
+    }
+    //---------------------------------------------------------------------
+    Real TerrainTessellation::Patches::getBoundingRadius(void) const
+    {
+        return mBox.getHalfSize().length();
+    }
+}
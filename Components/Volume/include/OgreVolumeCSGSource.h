@@ -66,6 +66,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Vector3 *positions, Real *values, size_t count) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const;
     };
 
     /** A plane.
@@ -97,6 +105,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Vector3 *positions, Real *values, size_t count) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const;
     };
 
     /** A not rotated cube.
@@ -161,6 +177,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Vector3 *positions, Real *values, size_t count) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const;
     };
 
     /** Abstract operation volume source holding two sources as operants.
@@ -239,6 +263,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Vector3 *positions, Real *values, size_t count) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const;
     };
 
     /** Builds the union between two sources.
@@ -266,6 +298,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Vector3 *positions, Real *values, size_t count) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const;
     };
 
     /** Builds the difference between two sources.
@@ -294,6 +334,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Vector3 *positions, Real *values, size_t count) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const;
     };
 
     /** Source which does a unary operation to another one.
@@ -354,6 +402,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Vector3 *positions, Real *values, size_t count) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const;
     };
 
     /** Scales the given volume source.
@@ -381,6 +437,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Vector3 *positions, Real *values, size_t count) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const;
     };
 
     class _OgreVolumeExport CSGNoiseSource: public CSGUnarySource
@@ -459,6 +523,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Vector3 *positions, Real *values, size_t count) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const;
         
         /** Gets the initial seed.
         @return
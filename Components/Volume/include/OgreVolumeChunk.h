@@ -91,12 +91,15 @@ namespace Volume {
         /// Whether to load the chunks async. if set to false, the call to load waits for the whole chunk. false is the default.
         bool async;
 
+        /// The camera whose distance decides the order in which chunks are generated. 0 is the default and generates the coarse levels first.
+        const Camera *loadPriorityCamera;
+
         /** Constructor.
         */
         ChunkParameters(void) :
             sceneManager(0), src(0), baseError((Real)0.0), errorMultiplicator((Real)1.0), createOctreeVisualization(false),
             createDualGridVisualization(false), skirtFactor(0), lodCallback(0), scale((Real)1.0), maxScreenSpaceError(0), createGeometryFromLevel(0),
-            updateFrom(Vector3::ZERO), updateTo(Vector3::ZERO), async(false)
+            updateFrom(Vector3::ZERO), updateTo(Vector3::ZERO), async(false), loadPriorityCamera(0)
         {
         }
     } ChunkParameters;
@@ -120,9 +123,19 @@ namespace Volume {
         /// The parameters with which the chunktree got loaded.
         ChunkParameters *parameters;
 
+        /// The back lower left corner of the loaded tree.
+        Vector3 rootFrom;
+
+        /// The front upper right corner of the loaded tree.
+        Vector3 rootTo;
+
+        /// The amount of LOD levels of the loaded tree.
+        size_t maxLevels;
+
         /** Constructor.
         */
-        ChunkTreeSharedData(const ChunkParameters *params) : octreeVisible(false), dualGridVisible(false), volumeVisible(true), chunksBeingProcessed(0)
+        ChunkTreeSharedData(const ChunkParameters *params) : octreeVisible(false), dualGridVisible(false), volumeVisible(true), chunksBeingProcessed(0),
+            rootFrom(Vector3::ZERO), rootTo(Vector3::ZERO), maxLevels(0)
         {
             this->parameters = new ChunkParameters(*params);
         }
@@ -170,6 +183,9 @@ namespace Volume {
         /// Whether this chunk is the root of the tree.
         bool isRoot;
 
+        /// Counts the geometry requests of this chunk, so results of superseded requests can be dropped.
+        size_t mGeneration;
+
         /// Holds some shared data among all chunks of the tree.
         ChunkTreeSharedData *mShared;
 
@@ -347,6 +363,19 @@ namespace Volume {
         */
         virtual void load(SceneNode *parent, const Vector3 &from, const Vector3 &to, size_t level, const ChunkParameters *parameters);
 
+        /** Regenerates the chunks intersecting an area of changed density, for
+            example after combining the source with a CSG operation. Only callable
+            on the loaded root chunk. The current meshes stay visible until the
+            new ones are ready and are then swapped in, so with async loading
+            this can be called every frame while editing. Results of earlier
+            updates still in progress for the same chunks are discarded.
+        @param from
+            The back lower left corner of the changed area.
+        @param to
+            The front upper right corner of the changed area.
+        */
+        virtual void update(const Vector3 &from, const Vector3 &to);
+
         /** Loads a TextureSource volume scene from a config file.
         @param parent
             The parent scene node for the volume.
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #define __Ogre_Volume_Chunk_Handler_H__
 
 #include "OgreWorkQueue.h"
+#include "OgreAtomicScalar.h"
 
 #include "OgreVolumePrerequisites.h"
 
@@ -41,6 +42,8 @@ namespace Volume {
     class MeshBuilder;
     class DualGridGenerator;
     class OctreeNode;
+    class OctreeNodeSplitPolicy;
+    class Source;
 
     /** Data being passed around while loading.
     */
@@ -73,6 +76,9 @@ namespace Volume {
 
         /// Whether this is an update of an existing tree
         bool isUpdate;
+
+        /// The request count of the chunk when this was made, to detect superseded requests.
+        size_t generation;
         
         /** Stream operator <<.
         @param o
@@ -83,6 +89,49 @@ namespace Volume {
         _OgreVolumeExport friend std::ostream& operator<<(std::ostream& o, const ChunkRequest& r)
         { return o; }
     } ChunkRequest;
+
+    /** Octree subtrees of one chunk to be split by several threads.
+    */
+    typedef struct SplitJob
+    {
+        /// The subtrees to split.
+        vector<OctreeNode*>::type nodes;
+
+        /// The split policy to use.
+        const OctreeNodeSplitPolicy *policy;
+
+        /// The volume source.
+        const Source *src;
+
+        /// The accepted geometric error.
+        Real geometricError;
+
+        /// The index of the next subtree to be taken by a thread.
+        AtomicScalar<uint32> next;
+
+        /// The amount of split subtrees.
+        AtomicScalar<uint32> done;
+
+        /// The amount of threads still referencing the job, the last one deletes it.
+        AtomicScalar<uint32> refs;
+    } SplitJob;
+
+    /** Request data of a thread helping with a SplitJob.
+    */
+    typedef struct SplitRequest
+    {
+        /// The job to help with.
+        SplitJob *job;
+
+        /** Stream operator <<.
+        @param o
+            The used stream.
+        @param r
+            The streamed SplitRequest.
+        */
+        _OgreVolumeExport friend std::ostream& operator<<(std::ostream& o, const SplitRequest& r)
+        { return o; }
+    } SplitRequest;
     
     /** Handles the WorkQueue management of the chunks.
     */
@@ -93,16 +142,56 @@ namespace Volume {
         /// The workqueue load request.
         static const uint16 WORKQUEUE_LOAD_REQUEST;
 
+        /// The workqueue request helping to split an octree.
+        static const uint16 WORKQUEUE_SPLIT_REQUEST;
+
+        /// The amount of octree levels split before distributing the subtrees to threads.
+        static const size_t SPLIT_JOB_DEPTH;
+
         /// The workqueue.
         WorkQueue* mWQ;
 
         /// The workqueue channel.
         uint16 mWorkQueueChannel;
+
+        /// The requests not handed to the WorkQueue yet.
+        typedef vector<ChunkRequest>::type ChunkRequestList;
+        ChunkRequestList mPendingRequests;
+
+        /// The amount of requests handed to the WorkQueue and not answered yet.
+        size_t mRequestsInProgress;
         
         /** Initializes the WorkQueue (once).
         */
         void init(void);
 
+        /** Hands the most important pending requests to the WorkQueue, keeping
+            as many in progress as there are worker threads, so the order can
+            still follow the camera.
+        */
+        void submitRequests(void);
+
+        /** Gets the importance of a request, lower values are more important.
+        @param req
+            The ChunkRequest.
+        @return
+            The distance from the camera relative to the chunk size if the
+            chunk parameters name a loadPriorityCamera, else the level from the top.
+        */
+        Real getRequestPriority(const ChunkRequest &req) const;
+
+        /** Splits subtrees of a SplitJob until there are none left.
+        @param job
+            The job.
+        */
+        static void runSplitJob(SplitJob *job);
+
+        /** Releases a reference to a SplitJob, deleting it with the last one.
+        @param job
+            The job.
+        */
+        static void releaseSplitJob(SplitJob *job);
+
     public:
         
         /** Constructor
@@ -123,6 +212,20 @@ namespace Volume {
         */
         void processWorkQueue(void);
 
+        /** Splits an octree, spreading independent subtrees over the worker
+            threads. The calling thread takes part and returns when the whole
+            tree is split, so this is safe to call from within a worker thread.
+        @param root
+            The root of the octree.
+        @param splitPolicy
+            Defines the policy deciding whether to split a node or not.
+        @param src
+            The volume source.
+        @param geometricError
+            The accepted geometric error.
+        */
+        void splitOctree(OctreeNode *root, const OctreeNodeSplitPolicy *splitPolicy, const Source *src, const Real geometricError);
+
         /// Implementation for WorkQueue::RequestHandler
         WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
         
@@ -75,8 +75,38 @@ namespace Volume {
         /// Starting node to generate the grid from.
         OctreeNode const* mRoot;
         
-        /// Holds the generated dual cells of the grid.
-        VecDualCell mDualCells;
+        /** Strict weak ordering of positions so they can be used as map keys.
+        */
+        struct PositionLess
+        {
+            inline bool operator()(const Vector3 &a, const Vector3 &b) const
+            {
+                if (a.x != b.x)
+                {
+                    return a.x < b.x;
+                }
+                if (a.y != b.y)
+                {
+                    return a.y < b.y;
+                }
+                return a.z < b.z;
+            }
+        };
+
+        typedef map<Vector3, Vector4, PositionLess>::type CornerValueMap;
+        typedef map<Vector3, uint32, PositionLess>::type CornerIndexMap;
+
+        /// Density and gradient of the corners which aren't octree node centers, shared between neighbouring dual cells.
+        CornerValueMap mCornerValues;
+
+        /// The distinct corners of the saved dual cells.
+        vector<Vector3>::type mDualCellCorners;
+
+        /// Eight indices into mDualCellCorners per saved dual cell.
+        vector<uint32>::type mDualCellIndices;
+
+        /// Looks up the index of a corner in mDualCellCorners while generating.
+        CornerIndexMap mDualCellCornerIndices;
 
         /// Whether to store the dualcells for later visualization.
         bool mSaveDualCells;
@@ -140,12 +170,6 @@ namespace Volume {
         inline void addDualCell(const Vector3 &c0, const Vector3 &c1, const Vector3 &c2, const Vector3 &c3, const Vector3 &c4, const Vector3 &c5, const Vector3 &c6, const Vector3 &c7,
             Vector4 *values)
         {
-
-            if (mSaveDualCells)
-            {
-                mDualCells.push_back(DualCell(c0, c1, c2, c3, c4, c5, c6, c7));
-            }
-
             Vector3 corners[8];
             corners[0] = c0;
             corners[1] = c1;
@@ -155,6 +179,19 @@ namespace Volume {
             corners[5] = c5;
             corners[6] = c6;
             corners[7] = c7;
+
+            if (mSaveDualCells)
+            {
+                saveDualCell(corners);
+            }
+
+            Vector4 cachedValues[8];
+            if (!values)
+            {
+                getCornerValues(corners, cachedValues);
+                values = cachedValues;
+            }
+
             mIs->addMarchingCubesTriangles(corners, values, mMb);
             Vector3 from = mRoot->getFrom();
             Vector3 to = mRoot->getTo();
@@ -184,6 +221,22 @@ namespace Volume {
             }
         }
 
+        /** Gets the density and gradient of the corners of a dual cell from the cache,
+            evaluating the missing ones in one batch.
+        @param corners
+            The eight corners.
+        @param values
+            Receives the eight values.
+        */
+        void getCornerValues(const Vector3 *corners, Vector4 *values);
+
+        /** Stores a dual cell for the debug visualization, sharing the corners with
+            the cells stored before.
+        @param corners
+            The eight corners.
+        */
+        void saveDualCell(const Vector3 *corners);
+
         /* Startpoint for the creation recursion.
         @param n
             The node to start with.
@@ -331,7 +384,7 @@ namespace Volume {
         */
         inline size_t getDualCellCount(void) const
         {
-            return mDualCells.size();
+            return mDualCellIndices.size() / 8;
         }
 
         /** Gets a dual cell.
@@ -342,7 +395,9 @@ namespace Volume {
         */
         inline DualCell getDualCell(size_t i) const
         {
-            return mDualCells[i];
+            const uint32 *indices = &mDualCellIndices[i * 8];
+            return DualCell(mDualCellCorners[indices[0]], mDualCellCorners[indices[1]], mDualCellCorners[indices[2]], mDualCellCorners[indices[3]],
+                mDualCellCorners[indices[4]], mDualCellCorners[indices[5]], mDualCellCorners[indices[6]], mDualCellCorners[indices[7]]);
         }
     };
 }
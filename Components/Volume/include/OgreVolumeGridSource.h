@@ -137,6 +137,64 @@ namespace Volume {
                 getVolumeGridValue(x, y, z + 1) - getVolumeGridValue(x, y, z - 1));
         }
 
+        /** Gets the trilinear interpolated density at a position in grid space.
+        @param scaledPosition
+            The position, already scaled to grid coordinates.
+        @return
+            The density.
+        */
+        inline Real getTrilinearValue(const Vector3 &scaledPosition) const
+        {
+            size_t x0 = (size_t)scaledPosition.x;
+            size_t x1 = (size_t)ceil(scaledPosition.x);
+            size_t y0 = (size_t)scaledPosition.y;
+            size_t y1 = (size_t)ceil(scaledPosition.y);
+            size_t z0 = (size_t)scaledPosition.z;
+            size_t z1 = (size_t)ceil(scaledPosition.z);
+
+            Real dX = scaledPosition.x - (Real)x0;
+            Real dY = scaledPosition.y - (Real)y0;
+            Real dZ = scaledPosition.z - (Real)z0;
+
+            Real f000 = getVolumeGridValue(x0, y0, z0);
+            Real f100 = getVolumeGridValue(x1, y0, z0);
+            Real f010 = getVolumeGridValue(x0, y1, z0);
+            Real f001 = getVolumeGridValue(x0, y0, z1);
+            Real f101 = getVolumeGridValue(x1, y0, z1);
+            Real f011 = getVolumeGridValue(x0, y1, z1);
+            Real f110 = getVolumeGridValue(x1, y1, z0);
+            Real f111 = getVolumeGridValue(x1, y1, z1);
+
+            Real oneMinX = (Real)1.0 - dX;
+            Real oneMinY = (Real)1.0 - dY;
+            Real oneMinZ = (Real)1.0 - dZ;
+            Real oneMinXoneMinY = oneMinX * oneMinY;
+            Real dXOneMinY = dX * oneMinY;
+
+            return oneMinZ * (f000 * oneMinXoneMinY
+                + f100 * dXOneMinY
+                + f010 * oneMinX * dY)
+                + dZ * (f001 * oneMinXoneMinY
+                + f101 * dXOneMinY
+                + f011 * oneMinX * dY)
+                + dX * dY * (f110 * oneMinZ
+                + f111 * dZ);
+        }
+
+        /** Gets the density of the nearest grid point to a position in grid space.
+        @param scaledPosition
+            The position, already scaled to grid coordinates.
+        @return
+            The density.
+        */
+        inline Real getNearestValue(const Vector3 &scaledPosition) const
+        {
+            size_t x = (size_t)(scaledPosition.x + (Real)0.5);
+            size_t y = (size_t)(scaledPosition.y + (Real)0.5);
+            size_t z = (size_t)(scaledPosition.z + (Real)0.5);
+            return (Real)getVolumeGridValue(x, y, z);
+        }
+
     public:
 
         GridSource(bool trilinearValue, bool trilinearGradient, bool sobelGradient);
@@ -153,6 +211,10 @@ namespace Volume {
         */
         virtual Real getValue(const Vector3 &position) const;
 
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Vector3 *positions, Real *values, size_t count) const;
+
         /** Gets the width of the texture.
         @return
             The width of the texture.
@@ -76,6 +76,15 @@ namespace Volume {
         static const size_t MS_CORNERS_BOTTOM[4];
 
         virtual ~IsoSurface(void);
+
+        /** Gets the source the isosurface is extracted from.
+        @return
+            The source.
+        */
+        inline const Source* getSource(void) const
+        {
+            return mSrc;
+        }
         
         /** Adds triangles to a MeshBuilder via Marching Cubes.
         @param corners
@@ -60,8 +60,8 @@ namespace Volume {
         /// The front upper right corner of the cell.
         Vector3 mTo;
 
-        /// The children of this node.
-        OctreeNode **mChildren;
+        /// The children of this node, allocated as one contiguous block.
+        OctreeNode *mChildren;
 
         /// Holds the debug visualization of the octree. Just set in the root.
         Entity* mOctreeGrid;
@@ -121,7 +121,9 @@ namespace Volume {
         */
         virtual ~OctreeNode(void);
 
-        /** Factory method to create octree nodes.
+        /** Factory method to create octree nodes. The children of a split node
+            are constructed in place in one block of OCTREE_CHILDREN_COUNT nodes
+            instead, to keep siblings together in memory.
         @param from
             The back lower left corner of the cell.
         @param to
@@ -141,6 +143,19 @@ namespace Volume {
         */
         void split(const OctreeNodeSplitPolicy *splitPolicy, const Source *src, const Real geometricError);
 
+        /** Splits this cell if the split policy says so, without splitting the
+            created children. Used to distribute the children to several threads.
+        @param splitPolicy
+            Defines the policy deciding whether to split this node or not.
+        @param src
+            The volume source.
+        @param geometricError
+            The accepted geometric error.
+        @return
+            Whether the cell got split.
+        */
+        bool splitOnce(const OctreeNodeSplitPolicy *splitPolicy, const Source *src, const Real geometricError);
+
         /** Getter for the octree debug visualization of the octree starting with
             this node.
         @param sceneManager
@@ -189,7 +204,18 @@ namespace Volume {
          */
         inline const OctreeNode* getChild(const size_t i) const
         {
-            return mChildren[i];
+            return &mChildren[i];
+        }
+
+        /** Gets a child of this node, non-const version.
+        @param i
+            The child index.
+        @return
+            The child.
+        */
+        inline OctreeNode* getChild(const size_t i)
+        {
+            return &mChildren[i];
         }
         
         /** Gets the center of this cell.
@@ -108,6 +108,20 @@ namespace Volume {
             The noise value.
         */
         Real noise(Real xIn, Real yIn, Real zIn) const;
+
+        /** Adds an octave of 3D noise to several values at once.
+        @param positions
+            The positions to get the noise at.
+        @param frequency
+            The factor to scale the positions with.
+        @param amplitude
+            The factor to scale the noise with.
+        @param values
+            The values to add the noise to.
+        @param count
+            The amount of positions.
+        */
+        void addNoise(const Vector3 *positions, Real frequency, Real amplitude, Real *values, size_t count) const;
         
         /** Gets the current seed.
         @return
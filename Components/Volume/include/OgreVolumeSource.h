@@ -72,6 +72,9 @@ namespace Volume {
 
         /// The amount of items being written as one chunk during serialization.
         static const size_t SERIALIZATION_CHUNK_SIZE;
+
+        /// The amount of positions evaluated at once by operations needing temporary results.
+        static const size_t BATCH_SIZE;
         
         /** Destructor.
         */
@@ -93,6 +96,31 @@ namespace Volume {
         */
         virtual Real getValue(const Vector3 &position) const = 0;
 
+        /** Gets the density values at several positions at once. Sources
+        override this to work through the positions in tight loops and CSG
+        operations evaluate each operand once per batch instead of once per
+        position. The default implementation calls getValue for each position.
+        @param positions
+            The positions.
+        @param values
+            Receives the densities.
+        @param count
+            The amount of positions.
+        */
+        virtual void getValues(const Vector3 *positions, Real *values, size_t count) const;
+
+        /** Gets the density values and gradients at several positions at once,
+        see getValues. The default implementation calls getValueAndGradient for
+        each position.
+        @param positions
+            The positions.
+        @param values
+            Receives vectors with x, y, z containing the gradient and w containing the density.
+        @param count
+            The amount of positions.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const;
+
         /** Serializes a volume source to a discrete grid file with deflated
         compression. To achieve better compression, all density values are clamped
         within a maximum absolute value of (to - from).length() / 16.0. The values
@@ -69,6 +69,29 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGSphereSource::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            Real dX = positions[i].x - mCenter.x;
+            Real dY = positions[i].y - mCenter.y;
+            Real dZ = positions[i].z - mCenter.z;
+            values[i] = mR - Math::Sqrt(dX * dX + dY * dY + dZ * dZ);
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGSphereSource::getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = CSGSphereSource::getValueAndGradient(positions[i]);
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGPlaneSource::CSGPlaneSource(const Real d, const Vector3 &normal) : mD(d), mNormal(normal.normalisedCopy())
     {
     }
@@ -96,6 +119,27 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGPlaneSource::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = mD - (mNormal.x * positions[i].x + mNormal.y * positions[i].y + mNormal.z * positions[i].z);
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGPlaneSource::getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = Vector4(mNormal.x, mNormal.y, mNormal.z,
+                mD - (mNormal.x * positions[i].x + mNormal.y * positions[i].y + mNormal.z * positions[i].z));
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGCubeSource::CSGCubeSource(const Vector3 &min, const Vector3 &max)
     {
         mBox.setExtents(min, max);
@@ -127,6 +171,26 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGCubeSource::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = distanceTo(positions[i]);
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGCubeSource::getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = CSGCubeSource::getValueAndGradient(positions[i]);
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGOperationSource::CSGOperationSource(const Source *a, const Source *b) : mA(a), mB(b)
     {
     }
@@ -205,6 +269,43 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGIntersectionSource::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        Real valuesB[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            size_t n = std::min(count - start, BATCH_SIZE);
+            mA->getValues(positions + start, values + start, n);
+            mB->getValues(positions + start, valuesB, n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                values[start + i] = std::min(values[start + i], valuesB[i]);
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGIntersectionSource::getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const
+    {
+        Vector4 valuesB[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            size_t n = std::min(count - start, BATCH_SIZE);
+            mA->getValuesAndGradients(positions + start, values + start, n);
+            mB->getValuesAndGradients(positions + start, valuesB, n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (!(values[start + i].w < valuesB[i].w))
+                {
+                    values[start + i] = valuesB[i];
+                }
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGUnionSource::CSGUnionSource(const Source *a, const Source *b) : CSGOperationSource(a, b)
     {
     }
@@ -243,6 +344,43 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGUnionSource::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        Real valuesB[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            size_t n = std::min(count - start, BATCH_SIZE);
+            mA->getValues(positions + start, values + start, n);
+            mB->getValues(positions + start, valuesB, n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                values[start + i] = std::max(values[start + i], valuesB[i]);
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGUnionSource::getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const
+    {
+        Vector4 valuesB[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            size_t n = std::min(count - start, BATCH_SIZE);
+            mA->getValuesAndGradients(positions + start, values + start, n);
+            mB->getValuesAndGradients(positions + start, valuesB, n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (!(values[start + i].w > valuesB[i].w))
+                {
+                    values[start + i] = valuesB[i];
+                }
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGDifferenceSource::CSGDifferenceSource(const Source *a, const Source *b) : CSGOperationSource(a, b)
     {
     }
@@ -281,6 +419,44 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGDifferenceSource::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        Real valuesB[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            size_t n = std::min(count - start, BATCH_SIZE);
+            mA->getValues(positions + start, values + start, n);
+            mB->getValues(positions + start, valuesB, n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                values[start + i] = std::min(values[start + i], (Real)-1.0 * valuesB[i]);
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGDifferenceSource::getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const
+    {
+        Vector4 valuesB[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            size_t n = std::min(count - start, BATCH_SIZE);
+            mA->getValuesAndGradients(positions + start, values + start, n);
+            mB->getValuesAndGradients(positions + start, valuesB, n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                valuesB[i] = (Real)-1.0 * valuesB[i];
+                if (!(values[start + i].w < valuesB[i].w))
+                {
+                    values[start + i] = valuesB[i];
+                }
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGUnarySource::CSGUnarySource(const Source *src) : mSrc(src)
     {
     }
@@ -333,6 +509,28 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGNegateSource::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        mSrc->getValues(positions, values, count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = -values[i];
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGNegateSource::getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const
+    {
+        mSrc->getValuesAndGradients(positions, values, count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = (Real)-1.0 * values[i];
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGScaleSource::CSGScaleSource(const Source *src, const Real scale) : CSGUnarySource(src), mScale(scale)
     {
     }
@@ -353,6 +551,48 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGScaleSource::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        Vector3 scaled[BATCH_SIZE];
+        Real invScale = (Real)1.0 / mScale;
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            size_t n = std::min(count - start, BATCH_SIZE);
+            for (size_t i = 0; i < n; ++i)
+            {
+                scaled[i] = positions[start + i] * invScale;
+            }
+            mSrc->getValues(scaled, values + start, n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                values[start + i] *= mScale;
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGScaleSource::getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const
+    {
+        Vector3 scaled[BATCH_SIZE];
+        Real invScale = (Real)1.0 / mScale;
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            size_t n = std::min(count - start, BATCH_SIZE);
+            for (size_t i = 0; i < n; ++i)
+            {
+                scaled[i] = positions[start + i] * invScale;
+            }
+            mSrc->getValuesAndGradients(scaled, values + start, n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                values[start + i] *= mScale;
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     void CSGNoiseSource::setData(void)
     {
         mGradientOff = fabs(mFrequencies[0]);
@@ -403,6 +643,51 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGNoiseSource::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        mSrc->getValues(positions, values, count);
+        for (size_t i = 0; i < mNumOctaves; ++i)
+        {
+            mNoise.addNoise(positions, mFrequencies[i], mAmplitudes[i], values, count);
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGNoiseSource::getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const
+    {
+        // The gradient is the central difference of the values at six offset positions.
+        static const size_t SAMPLES = 7;
+        Vector3 samples[BATCH_SIZE];
+        Real sampleValues[BATCH_SIZE];
+        const Vector3 offsets[SAMPLES] = {
+            Vector3::ZERO,
+            Vector3(mGradientOff, 0, 0), Vector3(-mGradientOff, 0, 0),
+            Vector3(0, mGradientOff, 0), Vector3(0, -mGradientOff, 0),
+            Vector3(0, 0, mGradientOff), Vector3(0, 0, -mGradientOff)
+        };
+        const size_t perBatch = BATCH_SIZE / SAMPLES;
+        for (size_t start = 0; start < count; start += perBatch)
+        {
+            size_t n = std::min(count - start, perBatch);
+            for (size_t i = 0; i < n; ++i)
+            {
+                for (size_t s = 0; s < SAMPLES; ++s)
+                {
+                    samples[i * SAMPLES + s] = positions[start + i] + offsets[s];
+                }
+            }
+            getValues(samples, sampleValues, n * SAMPLES);
+            for (size_t i = 0; i < n; ++i)
+            {
+                const Real *v = sampleValues + i * SAMPLES;
+                values[start + i] = Vector4(-(v[1] - v[2]), -(v[3] - v[4]), -(v[5] - v[6]), v[0]);
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     long CSGNoiseSource::getSeed(void) const
     {
         return mSeed;
@@ -68,6 +68,7 @@ namespace Volume {
             req.level = level;
             req.maxLevels = maxLevels;
             req.isUpdate = mShared->parameters->updateFrom != Vector3::ZERO || mShared->parameters->updateTo != Vector3::ZERO;
+            req.generation = ++mGeneration;
 
             req.origin = this;
             req.root = OGRE_NEW OctreeNode(from, to);
@@ -158,17 +159,31 @@ namespace Volume {
             {
                 return;
             }
-            // Free memory from old mesh version
-            if (mRenderOp.vertexData)
+
+            // The old mesh stays visible until the new one is swapped in by loadGeometry.
+            if (!contributesToVolumeMesh(from, to))
             {
+                // Nothing left here, drop the old mesh and any pending one.
+                ++mGeneration;
+                if (isAttached())
+                {
+                    mNode->detachObject(this);
+                }
                 OGRE_DELETE mRenderOp.vertexData;
                 mRenderOp.vertexData = 0;
-            }
-            if (mRenderOp.indexData)
-            {
                 OGRE_DELETE mRenderOp.indexData;
                 mRenderOp.indexData = 0;
+                mInvisible = true;
+                if (mChildren)
+                {
+                    loadChildren(parent, from, to, totalFrom, totalTo, level, maxLevels);
+                }
+                return;
             }
+
+            loadChunk(parent, from, to, totalFrom, totalTo, level, maxLevels);
+            loadChildren(parent, from, to, totalFrom, totalTo, level, maxLevels);
+            return;
         }
 
         // Set to invisible for now.
@@ -193,7 +208,7 @@ namespace Volume {
         OctreeNodeSplitPolicy policy(mShared->parameters->src,
             mShared->parameters->errorMultiplicator * mShared->parameters->baseError);
         mError = (Real)level * mShared->parameters->errorMultiplicator * mShared->parameters->baseError;
-        root->split(&policy, mShared->parameters->src, mError);
+        mChunkHandler.splitOctree(root, &policy, mShared->parameters->src, mError);
         Real maxMSDistance = (Real)level * mShared->parameters->errorMultiplicator * mShared->parameters->baseError * mShared->parameters->skirtFactor;
         IsoSurface *is = OGRE_NEW IsoSurfaceMC(mShared->parameters->src);
         dualGridGenerator->generateDualGrid(root, is, meshBuilder, maxMSDistance, totalFrom, totalTo,
@@ -205,7 +220,14 @@ namespace Volume {
 
     void Chunk::loadGeometry(MeshBuilder *meshBuilder, DualGridGenerator *dualGridGenerator, OctreeNode *root, size_t level, bool isUpdate)
     {
+        // Swap the new buffers in, the old ones were kept for rendering until now.
+        VertexData *oldVertexData = mRenderOp.vertexData;
+        IndexData *oldIndexData = mRenderOp.indexData;
+        mRenderOp.vertexData = 0;
+        mRenderOp.indexData = 0;
         size_t chunkTriangles = meshBuilder->generateBuffers(mRenderOp);
+        OGRE_DELETE oldVertexData;
+        OGRE_DELETE oldIndexData;
         mInvisible = chunkTriangles == 0;
 
         if (mShared->parameters->lodCallback)
@@ -217,14 +239,34 @@ namespace Volume {
 
         if (!mInvisible)
         {
-            if (isUpdate)
+            if (!isAttached())
             {
-                mNode->detachObject(this);
+                mNode->attachObject(this);
             }
-            mNode->attachObject(this);
+        }
+        else if (isAttached())
+        {
+            mNode->detachObject(this);
         }
 
-        mVisible = false;
+        // Keep an updated chunk visible, frameStarted decides on the next frame.
+        if (!isUpdate)
+        {
+            mVisible = false;
+        }
+
+        if (isUpdate && mDualGrid)
+        {
+            mNode->detachObject(mDualGrid);
+            mShared->parameters->sceneManager->destroyEntity(mDualGrid);
+            mDualGrid = 0;
+        }
+        if (isUpdate && mOctree)
+        {
+            mNode->detachObject(mOctree);
+            mShared->parameters->sceneManager->destroyEntity(mOctree);
+            mOctree = 0;
+        }
 
         if (mShared->parameters->createDualGridVisualization)
         {
@@ -248,7 +290,7 @@ namespace Volume {
     //-----------------------------------------------------------------------
 
     Chunk::Chunk(void) : mNode(0), mError(false), mDualGrid(0), mOctree(0), mChildren(0),
-        mInvisible(false), isRoot(false), mShared(0)
+        mInvisible(false), isRoot(false), mGeneration(0), mShared(0)
     {
     }
     
@@ -325,10 +367,11 @@ namespace Volume {
         if (parameters->updateFrom == Vector3::ZERO && parameters->updateTo == Vector3::ZERO)
         {
             mShared = new ChunkTreeSharedData(parameters);
+            mShared->rootFrom = from;
+            mShared->rootTo = to;
+            mShared->maxLevels = level;
             parent->scale(Vector3(parameters->scale));
         }
-
-        mShared->chunksBeingProcessed = 0;
         
         doLoad(parent, from, to, from, to, level, level);
 
@@ -672,5 +715,23 @@ namespace Volume {
     {
         return mShared->parameters;
     }
+    
+    //-----------------------------------------------------------------------
+
+    void Chunk::update(const Vector3 &from, const Vector3 &to)
+    {
+        if (!isRoot || !mShared || !mNode)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, 
+                "Only a loaded root chunk can be updated!",
+                __FUNCTION__);
+        }
+        ChunkParameters *parameters = mShared->parameters;
+        parameters->updateFrom = from;
+        parameters->updateTo = to;
+        load(mNode->getParentSceneNode(), mShared->rootFrom, mShared->rootTo, mShared->maxLevels, parameters);
+        parameters->updateFrom = Vector3::ZERO;
+        parameters->updateTo = Vector3::ZERO;
+    }
 }
 }
\ No newline at end of file
@@ -31,11 +31,14 @@ THE SOFTWARE.
 #include "OgreVolumeMeshBuilder.h"
 #include "OgreVolumeOctreeNode.h"
 #include "OgreVolumeDualGridGenerator.h"
+#include "OgreCamera.h"
 
 namespace Ogre {
 namespace Volume {
 
     const uint16 ChunkHandler::WORKQUEUE_LOAD_REQUEST = 1;
+    const uint16 ChunkHandler::WORKQUEUE_SPLIT_REQUEST = 2;
+    const size_t ChunkHandler::SPLIT_JOB_DEPTH = 2;
     
     //-----------------------------------------------------------------------
     
@@ -52,7 +55,7 @@ namespace Volume {
 
     //-----------------------------------------------------------------------
     
-    ChunkHandler::ChunkHandler(void) : mWQ(0), mWorkQueueChannel(0)
+    ChunkHandler::ChunkHandler(void) : mWQ(0), mWorkQueueChannel(0), mRequestsInProgress(0)
     {
     }
 
@@ -73,7 +76,149 @@ namespace Volume {
     void ChunkHandler::addRequest(const ChunkRequest &req)
     {
         init();
-        mWQ->addRequest(mWorkQueueChannel, WORKQUEUE_LOAD_REQUEST, Any(req));
+        // A request for the same chunk not handed to the WorkQueue yet is superseded.
+        for (ChunkRequestList::iterator it = mPendingRequests.begin(); it != mPendingRequests.end(); ++it)
+        {
+            if (it->origin == req.origin)
+            {
+                it->origin->mShared->chunksBeingProcessed--;
+                OGRE_DELETE it->root;
+                OGRE_DELETE it->dualGridGenerator;
+                OGRE_DELETE it->meshBuilder;
+                mPendingRequests.erase(it);
+                break;
+            }
+        }
+        mPendingRequests.push_back(req);
+        submitRequests();
+    }
+
+    //-----------------------------------------------------------------------
+  
+    void ChunkHandler::submitRequests(void)
+    {
+        size_t maxInProgress = 1;
+        DefaultWorkQueueBase* defaultWQ = dynamic_cast<DefaultWorkQueueBase*>(mWQ);
+        if (defaultWQ && defaultWQ->getWorkerThreadCount() > 1)
+        {
+            maxInProgress = defaultWQ->getWorkerThreadCount();
+        }
+
+        while (mRequestsInProgress < maxInProgress && !mPendingRequests.empty())
+        {
+            ChunkRequestList::iterator best = mPendingRequests.begin();
+            Real bestPriority = getRequestPriority(*best);
+            for (ChunkRequestList::iterator it = best + 1; it != mPendingRequests.end(); ++it)
+            {
+                Real priority = getRequestPriority(*it);
+                if (priority < bestPriority)
+                {
+                    best = it;
+                    bestPriority = priority;
+                }
+            }
+            mRequestsInProgress++;
+            mWQ->addRequest(mWorkQueueChannel, WORKQUEUE_LOAD_REQUEST, Any(*best));
+            mPendingRequests.erase(best);
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+  
+    Real ChunkHandler::getRequestPriority(const ChunkRequest &req) const
+    {
+        const ChunkParameters *parameters = req.origin->getChunkParameters();
+        if (!parameters->loadPriorityCamera)
+        {
+            return (Real)(req.maxLevels - req.level);
+        }
+        Vector3 from = req.root->getFrom() * parameters->scale;
+        Vector3 to = req.root->getTo() * parameters->scale;
+        AxisAlignedBox box(from, to);
+        Real distance = box.distance(parameters->loadPriorityCamera->getDerivedPosition());
+        return distance / (to.x - from.x);
+    }
+    
+    //-----------------------------------------------------------------------
+  
+    void ChunkHandler::splitOctree(OctreeNode *root, const OctreeNodeSplitPolicy *splitPolicy, const Source *src, const Real geometricError)
+    {
+        DefaultWorkQueueBase* defaultWQ = dynamic_cast<DefaultWorkQueueBase*>(mWQ);
+        if (!defaultWQ || defaultWQ->getWorkerThreadCount() < 2)
+        {
+            root->split(splitPolicy, src, geometricError);
+            return;
+        }
+
+        // Split the top levels here to get independent subtrees.
+        SplitJob *job = OGRE_NEW_T(SplitJob, MEMCATEGORY_GENERAL)();
+        job->nodes.push_back(root);
+        for (size_t depth = 0; depth < SPLIT_JOB_DEPTH; ++depth)
+        {
+            vector<OctreeNode*>::type children;
+            for (size_t i = 0; i < job->nodes.size(); ++i)
+            {
+                if (job->nodes[i]->splitOnce(splitPolicy, src, geometricError))
+                {
+                    for (size_t c = 0; c < OctreeNode::OCTREE_CHILDREN_COUNT; ++c)
+                    {
+                        children.push_back(job->nodes[i]->getChild(c));
+                    }
+                }
+            }
+            job->nodes.swap(children);
+        }
+        if (job->nodes.empty())
+        {
+            OGRE_DELETE_T(job, SplitJob, MEMCATEGORY_GENERAL);
+            return;
+        }
+
+        job->policy = splitPolicy;
+        job->src = src;
+        job->geometricError = geometricError;
+        job->next.set(0);
+        job->done.set(0);
+
+        // Idle workers take subtrees too, the rest is done by this thread.
+        size_t helpers = std::min(defaultWQ->getWorkerThreadCount() - 1, job->nodes.size() - 1);
+        job->refs.set(static_cast<uint32>(helpers + 1));
+        for (size_t i = 0; i < helpers; ++i)
+        {
+            SplitRequest req;
+            req.job = job;
+            mWQ->addRequest(mWorkQueueChannel, WORKQUEUE_SPLIT_REQUEST, Any(req));
+        }
+        runSplitJob(job);
+
+        // Wait for the subtrees other threads are still working on.
+        while (job->done.get() < job->nodes.size())
+        {
+            OGRE_THREAD_SLEEP(0);
+        }
+        releaseSplitJob(job);
+    }
+    
+    //-----------------------------------------------------------------------
+  
+    void ChunkHandler::runSplitJob(SplitJob *job)
+    {
+        uint32 i;
+        while ((i = job->next++) < job->nodes.size())
+        {
+            job->nodes[i]->split(job->policy, job->src, job->geometricError);
+            job->done++;
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+  
+    void ChunkHandler::releaseSplitJob(SplitJob *job)
+    {
+        if (--job->refs == 0)
+        {
+            OGRE_DELETE_T(job, SplitJob, MEMCATEGORY_GENERAL);
+        }
     }
     
     //-----------------------------------------------------------------------
@@ -87,6 +232,14 @@ namespace Volume {
   
     WorkQueue::Response* ChunkHandler::handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
     {
+        if (req->getType() == WORKQUEUE_SPLIT_REQUEST)
+        {
+            SplitRequest sReq = any_cast<SplitRequest>(req->getData());
+            runSplitJob(sReq.job);
+            releaseSplitJob(sReq.job);
+            return OGRE_NEW WorkQueue::Response(req, true, Any());
+        }
+
         ChunkRequest cReq = any_cast<ChunkRequest>(req->getData());
         cReq.origin->prepareGeometry(cReq.level, cReq.root, cReq.dualGridGenerator, cReq.meshBuilder, cReq.totalFrom, cReq.totalTo);
         return OGRE_NEW WorkQueue::Response(req, true, Any());
@@ -96,10 +249,25 @@ namespace Volume {
 
     void ChunkHandler::handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
     {
+        if (res->getRequest()->getType() == WORKQUEUE_SPLIT_REQUEST)
+        {
+            return;
+        }
+
+        mRequestsInProgress--;
+        submitRequests();
         if (res->succeeded())
         {
             ChunkRequest cReq = any_cast<ChunkRequest>(res->getRequest()->getData());
-            cReq.origin->loadGeometry(cReq.meshBuilder, cReq.dualGridGenerator, cReq.root, cReq.level, cReq.isUpdate);
+            if (cReq.generation == cReq.origin->mGeneration)
+            {
+                cReq.origin->loadGeometry(cReq.meshBuilder, cReq.dualGridGenerator, cReq.root, cReq.level, cReq.isUpdate);
+            }
+            else
+            {
+                // A later update of the chunk is on its way.
+                cReq.origin->mShared->chunksBeingProcessed--;
+            }
             OGRE_DELETE cReq.root;
             OGRE_DELETE cReq.dualGridGenerator;
             OGRE_DELETE cReq.meshBuilder;
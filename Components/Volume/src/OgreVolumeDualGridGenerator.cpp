@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreManualObject.h"
 #include "OgreSceneManager.h"
 #include "OgreVolumeMeshBuilder.h"
+#include "OgreVolumeSource.h"
 
 namespace Ogre {
 namespace Volume {
@@ -480,6 +481,8 @@ namespace Volume {
         mTotalTo = totalTo;
         mSaveDualCells = saveDualCells;
 
+        mCornerValues.clear();
+
         nodeProc(root);
 
         // Build up a minimal dualgrid for octrees without children.
@@ -503,33 +506,89 @@ namespace Volume {
             addDualCell(root->getCenterLeft(), root->getCenter(), root->getCenterFront(), root->getCenterFrontLeft(),
                 root->getCenterLeftTop(), root->getCenterTop(), root->getCenterFrontTop(), root->getCorner7());
         }
+
+        // The lookups are only needed while generating.
+        mCornerValues.clear();
+        mDualCellCornerIndices.clear();
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void DualGridGenerator::getCornerValues(const Vector3 *corners, Vector4 *values)
+    {
+        Vector3 missing[8];
+        size_t missingIndices[8];
+        size_t missingCount = 0;
+        for (size_t i = 0; i < 8; ++i)
+        {
+            CornerValueMap::const_iterator it = mCornerValues.find(corners[i]);
+            if (it != mCornerValues.end())
+            {
+                values[i] = it->second;
+            }
+            else
+            {
+                missing[missingCount] = corners[i];
+                missingIndices[missingCount] = i;
+                ++missingCount;
+            }
+        }
+
+        if (missingCount > 0)
+        {
+            Vector4 missingValues[8];
+            mIs->getSource()->getValuesAndGradients(missing, missingValues, missingCount);
+            for (size_t i = 0; i < missingCount; ++i)
+            {
+                values[missingIndices[i]] = missingValues[i];
+                mCornerValues.insert(CornerValueMap::value_type(missing[i], missingValues[i]));
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void DualGridGenerator::saveDualCell(const Vector3 *corners)
+    {
+        for (size_t i = 0; i < 8; ++i)
+        {
+            std::pair<CornerIndexMap::iterator, bool> inserted = mDualCellCornerIndices.insert(
+                CornerIndexMap::value_type(corners[i], static_cast<uint32>(mDualCellCorners.size())));
+            if (inserted.second)
+            {
+                mDualCellCorners.push_back(corners[i]);
+            }
+            mDualCellIndices.push_back(inserted.first->second);
+        }
     }
     
     //-----------------------------------------------------------------------
 
     Entity* DualGridGenerator::getDualGrid(SceneManager *sceneManager)
     {
-        if (!mDualGrid && mDualCells.size() > 0)
+        size_t cellCount = getDualCellCount();
+        if (!mDualGrid && cellCount > 0)
         {
             ManualObject* manual = sceneManager->createManualObject();
             manual->begin("BaseWhiteNoLighting", RenderOperation::OT_LINE_LIST);
             manual->colour((Real)0.0, (Real)1.0, (Real)0.0);
-            manual->estimateVertexCount(mDualCells.size() * 8);
-            manual->estimateIndexCount(mDualCells.size() * 24);
+            manual->estimateVertexCount(cellCount * 8);
+            manual->estimateIndexCount(cellCount * 24);
 
             uint32 baseIndex = 0;
-            for (VecDualCell::iterator it = mDualCells.begin(); it != mDualCells.end(); ++it)
+            for (size_t i = 0; i < cellCount; ++i)
             {
+                const uint32 *indices = &mDualCellIndices[i * 8];
                 MeshBuilder::addCubeToManualObject(
                     manual,
-                    it->mC0,
-                    it->mC1,
-                    it->mC2,
-                    it->mC3,
-                    it->mC4,
-                    it->mC5,
-                    it->mC6,
-                    it->mC7,
+                    mDualCellCorners[indices[0]],
+                    mDualCellCorners[indices[1]],
+                    mDualCellCorners[indices[2]],
+                    mDualCellCorners[indices[3]],
+                    mDualCellCorners[indices[4]],
+                    mDualCellCorners[indices[5]],
+                    mDualCellCorners[indices[6]],
+                    mDualCellCorners[indices[7]],
                     baseIndex);
             }
 
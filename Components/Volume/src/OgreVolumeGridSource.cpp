@@ -146,54 +146,33 @@ namespace Volume {
     Real GridSource::getValue(const Vector3 &position) const
     {
         Vector3 scaledPosition(position.x * mPosXScale, position.y * mPosYScale, position.z * mPosZScale);
-        Real value;
         if (mTrilinearValue)
         {
-            size_t x0 = (size_t)scaledPosition.x;
-            size_t x1 = (size_t)ceil(scaledPosition.x);
-            size_t y0 = (size_t)scaledPosition.y;
-            size_t y1 = (size_t)ceil(scaledPosition.y);
-            size_t z0 = (size_t)scaledPosition.z;
-            size_t z1 = (size_t)ceil(scaledPosition.z);
-
-            Real dX = scaledPosition.x - (Real)x0;
-            Real dY = scaledPosition.y - (Real)y0;
-            Real dZ = scaledPosition.z - (Real)z0;
-
-            Real f000 = getVolumeGridValue(x0, y0, z0);
-            Real f100 = getVolumeGridValue(x1, y0, z0);
-            Real f010 = getVolumeGridValue(x0, y1, z0);
-            Real f001 = getVolumeGridValue(x0, y0, z1);
-            Real f101 = getVolumeGridValue(x1, y0, z1);
-            Real f011 = getVolumeGridValue(x0, y1, z1);
-            Real f110 = getVolumeGridValue(x1, y1, z0);
-            Real f111 = getVolumeGridValue(x1, y1, z1);
-
-            Real oneMinX = (Real)1.0 - dX;
-            Real oneMinY = (Real)1.0 - dY;
-            Real oneMinZ = (Real)1.0 - dZ;
-            Real oneMinXoneMinY = oneMinX * oneMinY;
-            Real dXOneMinY = dX * oneMinY;
+            return getTrilinearValue(scaledPosition);
+        }
+        // Nearest neighbour else
+        return getNearestValue(scaledPosition);
+    }
+    
+    //-----------------------------------------------------------------------
 
-            value = oneMinZ * (f000 * oneMinXoneMinY
-                + f100 * dXOneMinY
-                + f010 * oneMinX * dY)
-                + dZ * (f001 * oneMinXoneMinY
-                + f101 * dXOneMinY
-                + f011 * oneMinX * dY)
-                + dX * dY * (f110 * oneMinZ
-                + f111 * dZ);
-        
+    void GridSource::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        Vector3 scale(mPosXScale, mPosYScale, mPosZScale);
+        if (mTrilinearValue)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                values[i] = getTrilinearValue(positions[i] * scale);
+            }
         }
         else
         {
-            // Nearest neighbour else
-            size_t x = (size_t)(scaledPosition.x + (Real)0.5);
-            size_t y = (size_t)(scaledPosition.y + (Real)0.5);
-            size_t z = (size_t)(scaledPosition.z + (Real)0.5);
-            value = (Real)getVolumeGridValue(x, y, z);
+            for (size_t i = 0; i < count; ++i)
+            {
+                values[i] = getNearestValue(positions[i] * scale);
+            }
         }
-        return value;
     }
     
     //-----------------------------------------------------------------------
@@ -45,18 +45,21 @@ namespace Volume {
     {
         unsigned char cubeIndex = 0;
         Vector4 values[8];
-
-        // Find out the case.
-        for (size_t i = 0; i < 8; ++i)
+        if (volumeValues)
         {
-            if (volumeValues)
+            for (size_t i = 0; i < 8; ++i)
             {
                 values[i] = volumeValues[i];
             }
-            else
-            {
-                values[i] = mSrc->getValueAndGradient(corners[i]);
-            }
+        }
+        else
+        {
+            mSrc->getValuesAndGradients(corners, values, 8);
+        }
+
+        // Find out the case.
+        for (size_t i = 0; i < 8; ++i)
+        {
             if (values[i].w >= ISO_LEVEL)
             {
                 cubeIndex |= 1 << i;
@@ -144,7 +147,7 @@ namespace Volume {
         {
             if (volumeValues)
             {
-                values[i] = volumeValues[indices[i]].w;
+                values[i] = volumeValues[indices[i]];
             }
             else
             {
@@ -62,14 +62,10 @@ namespace Volume {
         }
         else
         {
-            mChildren[0]->buildOctreeGridLines(manual);
-            mChildren[1]->buildOctreeGridLines(manual);
-            mChildren[2]->buildOctreeGridLines(manual);
-            mChildren[3]->buildOctreeGridLines(manual);
-            mChildren[4]->buildOctreeGridLines(manual);
-            mChildren[5]->buildOctreeGridLines(manual);
-            mChildren[6]->buildOctreeGridLines(manual);
-            mChildren[7]->buildOctreeGridLines(manual);
+            for (size_t i = 0; i < OCTREE_CHILDREN_COUNT; ++i)
+            {
+                mChildren[i].buildOctreeGridLines(manual);
+            }
         }
     }
     
@@ -88,9 +84,9 @@ namespace Volume {
         {
             for (size_t i = 0; i < OCTREE_CHILDREN_COUNT; ++i)
             {
-                OGRE_DELETE mChildren[i];
+                mChildren[i].~OctreeNode();
             }
-            delete[] mChildren;
+            OGRE_FREE(mChildren, MEMCATEGORY_GENERAL);
         }
     }
     
@@ -104,6 +100,19 @@ namespace Volume {
     //-----------------------------------------------------------------------
 
     void OctreeNode::split(const OctreeNodeSplitPolicy *splitPolicy, const Source *src, const Real geometricError)
+    {
+        if (splitOnce(splitPolicy, src, geometricError))
+        {
+            for (size_t i = 0; i < OCTREE_CHILDREN_COUNT; ++i)
+            {
+                mChildren[i].split(splitPolicy, src, geometricError);
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    bool OctreeNode::splitOnce(const OctreeNodeSplitPolicy *splitPolicy, const Source *src, const Real geometricError)
     {
         if (splitPolicy->doSplit(this, geometricError))
         {
@@ -117,31 +126,23 @@ namespace Volume {
               0 == from
               6 == to
             */
-            mChildren = new OctreeNode*[OCTREE_CHILDREN_COUNT];
-            mChildren[0] = createInstance(mFrom, newCenter);
-            mChildren[0]->split(splitPolicy, src, geometricError);
-            mChildren[1] = createInstance(mFrom + xWidth, newCenter + xWidth);
-            mChildren[1]->split(splitPolicy, src, geometricError);
-            mChildren[2] = createInstance(mFrom + xWidth + zWidth, newCenter + xWidth + zWidth);
-            mChildren[2]->split(splitPolicy, src, geometricError);
-            mChildren[3] = createInstance(mFrom + zWidth, newCenter + zWidth);
-            mChildren[3]->split(splitPolicy, src, geometricError);
-            mChildren[4] = createInstance(mFrom + yWidth, newCenter + yWidth);
-            mChildren[4]->split(splitPolicy, src, geometricError);
-            mChildren[5] = createInstance(mFrom + yWidth + xWidth, newCenter + yWidth + xWidth);
-            mChildren[5]->split(splitPolicy, src, geometricError);
-            mChildren[6] = createInstance(mFrom + yWidth + xWidth + zWidth, newCenter + yWidth + xWidth + zWidth);
-            mChildren[6]->split(splitPolicy, src, geometricError);
-            mChildren[7] = createInstance(mFrom + yWidth + zWidth, newCenter + yWidth + zWidth);
-            mChildren[7]->split(splitPolicy, src, geometricError);
+            // One allocation for all siblings, the nodes are constructed in place.
+            mChildren = OGRE_ALLOC_T(OctreeNode, OCTREE_CHILDREN_COUNT, MEMCATEGORY_GENERAL);
+            new (&mChildren[0]) OctreeNode(mFrom, newCenter);
+            new (&mChildren[1]) OctreeNode(mFrom + xWidth, newCenter + xWidth);
+            new (&mChildren[2]) OctreeNode(mFrom + xWidth + zWidth, newCenter + xWidth + zWidth);
+            new (&mChildren[3]) OctreeNode(mFrom + zWidth, newCenter + zWidth);
+            new (&mChildren[4]) OctreeNode(mFrom + yWidth, newCenter + yWidth);
+            new (&mChildren[5]) OctreeNode(mFrom + yWidth + xWidth, newCenter + yWidth + xWidth);
+            new (&mChildren[6]) OctreeNode(mFrom + yWidth + xWidth + zWidth, newCenter + yWidth + xWidth + zWidth);
+            new (&mChildren[7]) OctreeNode(mFrom + yWidth + zWidth, newCenter + yWidth + zWidth);
+            return true;
         }
-        else
+        if (mCenterValue.x == (Real)0.0 && mCenterValue.y == (Real)0.0 && mCenterValue.z == (Real)0.0 && mCenterValue.w == (Real)0.0)
         {
-            if (mCenterValue.x == (Real)0.0 && mCenterValue.y == (Real)0.0 && mCenterValue.z == (Real)0.0 && mCenterValue.w == (Real)0.0)
-            {
-                setCenterValue(src->getValueAndGradient(getCenter()));
-            }
+            setCenterValue(src->getValueAndGradient(getCenter()));
         }
+        return false;
     }
     
     //-----------------------------------------------------------------------
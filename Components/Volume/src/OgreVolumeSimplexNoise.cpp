@@ -232,6 +232,16 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
     
+    void SimplexNoise::addNoise(const Vector3 *positions, Real frequency, Real amplitude, Real *values, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] += noise(positions[i].x * frequency, positions[i].y * frequency, positions[i].z * frequency) * amplitude;
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+    
     long SimplexNoise::getSeed(void) const
     {
         return mSeed;
@@ -29,7 +29,7 @@ THE SOFTWARE.
 #include "OgreRoot.h"
 #include "OgreDeflate.h"
 #include "OgreStreamSerialiser.h"
-#include "OgreBitwise.h"
+#include "OgreOptimisedUtil.h"
 
 namespace Ogre {
 namespace Volume {
@@ -37,6 +37,7 @@ namespace Volume {
     const uint32 Source::VOLUME_CHUNK_ID = StreamSerialiser::makeIdentifier("VOLU");
     const uint16 Source::VOLUME_CHUNK_VERSION = 1;
     const size_t Source::SERIALIZATION_CHUNK_SIZE = 1000;
+    const size_t Source::BATCH_SIZE = 64;
 
     //-----------------------------------------------------------------------
 
@@ -94,26 +95,34 @@ namespace Volume {
         ser.write<size_t>(&gridDepth);
 
         // Go over the volume and write the density data.
-        Vector3 pos;
         Real realVal;
         size_t x;
         size_t y;
+        // Values are gathered and converted to half floats a chunk at a time
+        float values[SERIALIZATION_CHUNK_SIZE];
         uint16 buffer[SERIALIZATION_CHUNK_SIZE];
         size_t bufferI = 0;
+        OptimisedUtil* util = OptimisedUtil::getImplementation();
+        // The densities of a column are evaluated as one batch
+        vector<Vector3>::type column(std::max(gridHeight, (size_t)1));
+        vector<Real>::type columnValues(column.size());
         for (size_t z = 0; z < gridDepth; ++z)
         {
             for (x = 0; x < gridWidth; ++x)
             {
                 for (y = 0; y < gridHeight; ++y)
                 {
-                    pos.x = x * voxelWidth + from.x;
-                    pos.y = y * voxelWidth + from.y;
-                    pos.z = z * voxelWidth + from.z;
-                    realVal = Math::Clamp<Real>(getValue(pos), -maxClampedAbsoluteDensity, maxClampedAbsoluteDensity);
-                    buffer[bufferI] = Bitwise::floatToHalf(realVal);
+                    column[y] = Vector3(x * voxelWidth + from.x, y * voxelWidth + from.y, z * voxelWidth + from.z);
+                }
+                getValues(&column[0], &columnValues[0], gridHeight);
+                for (y = 0; y < gridHeight; ++y)
+                {
+                    realVal = Math::Clamp<Real>(columnValues[y], -maxClampedAbsoluteDensity, maxClampedAbsoluteDensity);
+                    values[bufferI] = static_cast<float>(realVal);
                     bufferI++;
                     if (bufferI == SERIALIZATION_CHUNK_SIZE)
                     {
+                        util->convertFloatToHalf(values, buffer, SERIALIZATION_CHUNK_SIZE);
                         ser.write<uint16>(buffer, SERIALIZATION_CHUNK_SIZE);
                         bufferI = 0;
                     }
@@ -122,6 +131,7 @@ namespace Volume {
         }
         if (bufferI > 0)
         {
+            util->convertFloatToHalf(values, buffer, bufferI);
             ser.write<uint16>(buffer, bufferI);
         }
         ser.writeChunkEnd(VOLUME_CHUNK_ID);
@@ -191,5 +201,25 @@ namespace Volume {
     {
         return (Real)1.0;
     }
+    
+    //-----------------------------------------------------------------------
+
+    void Source::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = getValue(positions[i]);
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void Source::getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = getValueAndGradient(positions[i]);
+        }
+    }
 }
 }
\ No newline at end of file
@@ -81,6 +81,127 @@
 %ignore Ogre::Matrix3::operator[];
 %ignore Ogre::Matrix4::operator[];
 
+// expose memory through the buffer protocol, so memoryview and numpy can map it without copies.
+// The views are bytes; they keep the wrapper alive, but not a buffer that is unlocked or freed.
+%{
+static int fillBufferView(Py_buffer* view, PyObject* self, void* data, size_t size, bool readOnly, int flags)
+{
+    if (!data)
+    {
+        PyErr_SetString(PyExc_BufferError, "no data");
+        view->obj = NULL;
+        return -1;
+    }
+    return PyBuffer_FillInfo(view, self, data, size, readOnly ? 1 : 0, flags);
+}
+
+static int Image_getbuffer(PyObject* self, Py_buffer* view, int flags)
+{
+    void* argp = 0;
+    if (!SWIG_IsOK(SWIG_ConvertPtr(self, &argp, SWIGTYPE_p_Ogre__Image, 0)))
+    {
+        PyErr_SetString(PyExc_BufferError, "not an Image");
+        view->obj = NULL;
+        return -1;
+    }
+    Ogre::Image* img = reinterpret_cast<Ogre::Image*>(argp);
+    return fillBufferView(view, self, img->getData(), img->getSize(), false, flags);
+}
+
+static int MemoryDataStream_getbuffer(PyObject* self, Py_buffer* view, int flags)
+{
+    void* argp = 0;
+    if (!SWIG_IsOK(SWIG_ConvertPtr(self, &argp, SWIGTYPE_p_Ogre__MemoryDataStream, 0)))
+    {
+        PyErr_SetString(PyExc_BufferError, "not a MemoryDataStream");
+        view->obj = NULL;
+        return -1;
+    }
+    Ogre::MemoryDataStream* stream = reinterpret_cast<Ogre::MemoryDataStream*>(argp);
+    return fillBufferView(view, self, stream->getPtr(), stream->size(), !stream->isWriteable(), flags);
+}
+
+static int PixelBox_getbuffer(PyObject* self, Py_buffer* view, int flags)
+{
+    void* argp = 0;
+    if (!SWIG_IsOK(SWIG_ConvertPtr(self, &argp, SWIGTYPE_p_Ogre__PixelBox, 0)))
+    {
+        PyErr_SetString(PyExc_BufferError, "not a PixelBox");
+        view->obj = NULL;
+        return -1;
+    }
+    Ogre::PixelBox* box = reinterpret_cast<Ogre::PixelBox*>(argp);
+    void* data = box->data ? box->getTopLeftFrontPixelPtr() : NULL;
+    if (box->isConsecutive())
+        return fillBufferView(view, self, data, box->getConsecutiveSize(), false, flags);
+
+    // rows or slices have gaps: a 3D strided view of depth x height x row bytes
+    if (Ogre::PixelUtil::isCompressed(box->format) || (flags & PyBUF_STRIDES) != PyBUF_STRIDES)
+    {
+        PyErr_SetString(PyExc_BufferError, "PixelBox is not consecutive");
+        view->obj = NULL;
+        return -1;
+    }
+    if (fillBufferView(view, self, data, box->getConsecutiveSize(), false, flags) != 0)
+        return -1;
+    // shape and strides, freed by PixelBox_releasebuffer
+    Py_ssize_t* dims = static_cast<Py_ssize_t*>(PyMem_Malloc(6 * sizeof(Py_ssize_t)));
+    if (!dims)
+    {
+        PyBuffer_Release(view);
+        PyErr_NoMemory();
+        return -1;
+    }
+    size_t pixelSize = Ogre::PixelUtil::getNumElemBytes(box->format);
+    dims[0] = box->getDepth();
+    dims[1] = box->getHeight();
+    dims[2] = box->getWidth() * pixelSize;
+    dims[3] = box->slicePitch * pixelSize;
+    dims[4] = box->rowPitch * pixelSize;
+    dims[5] = 1;
+    view->ndim = 3;
+    view->shape = dims;
+    view->strides = dims + 3;
+    view->internal = dims;
+    return 0;
+}
+
+static void PixelBox_releasebuffer(PyObject* self, Py_buffer* view)
+{
+    PyMem_Free(view->internal);
+}
+%}
+%feature("python:bf_getbuffer") Ogre::Image "Image_getbuffer";
+%feature("python:bf_getbuffer") Ogre::MemoryDataStream "MemoryDataStream_getbuffer";
+%feature("python:bf_getbuffer") Ogre::PixelBox "PixelBox_getbuffer";
+%feature("python:bf_releasebuffer") Ogre::PixelBox "PixelBox_releasebuffer";
+
+// HardwareBuffer::lock returns a raw pointer, return a memoryview of the locked range instead.
+// It must not be used after unlock.
+%{
+static PyObject* lockedMemoryView(void* data, size_t size, Ogre::HardwareBuffer::LockOptions options)
+{
+#if PY_VERSION_HEX >= 0x03030000
+    return PyMemoryView_FromMemory(static_cast<char*>(data), size,
+        options == Ogre::HardwareBuffer::HBL_READ_ONLY ? PyBUF_READ : PyBUF_WRITE);
+#else
+    if (options == Ogre::HardwareBuffer::HBL_READ_ONLY)
+        return PyBuffer_FromMemory(data, size);
+    return PyBuffer_FromReadWriteMemory(data, size);
+#endif
+}
+%}
+%extend Ogre::HardwareBuffer {
+    PyObject* lockView(size_t offset, size_t length, Ogre::HardwareBuffer::LockOptions options)
+    {
+        return lockedMemoryView($self->lock(offset, length, options), length, options);
+    }
+    PyObject* lockView(Ogre::HardwareBuffer::LockOptions options)
+    {
+        return lockedMemoryView($self->lock(options), $self->getSizeInBytes(), options);
+    }
+}
+
 /* these are ordered by dependancy */
 %include "OgreBuildSettings.h"
 %include "OgrePrerequisites.h"
@@ -0,0 +1,86 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __OgreASTCCodec_H__
+#define __OgreASTCCodec_H__
+
+#include "OgreImageCodec.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Image
+    *  @{
+    */
+
+    /** Codec specialized in loading ASTC (ARM Adaptive Scalable Texture Compression) images.
+    @remarks
+        The .astc files written by the ARM encoder hold a single level of 2D
+        blocks of any of the LDR block footprints, which is kept compressed
+        for the GPU. There is no software decoder, so the texture can only be
+        used where RSC_TEXTURE_COMPRESSION_ASTC is supported. KTX files holding
+        ASTC data are loaded by ETCCodec.
+    */
+    class _OgreExport ASTCCodec : public ImageCodec
+    {
+    protected:
+        String mType;
+
+        /// Single registered codec instance
+        static ASTCCodec* msInstance;
+
+    public:
+        ASTCCodec();
+        virtual ~ASTCCodec() { }
+
+        /// @copydoc Codec::encode
+        DataStreamPtr encode(MemoryDataStreamPtr& input, CodecDataPtr& pData) const;
+        /// @copydoc Codec::encodeToFile
+        void encodeToFile(MemoryDataStreamPtr& input, const String& outFileName, CodecDataPtr& pData) const;
+        /// @copydoc Codec::decode
+        DecodeResult decode(DataStreamPtr& input) const;
+        /// @copydoc Codec::magicNumberToFileExt
+        String magicNumberToFileExt(const char *magicNumberPtr, size_t maxbytes) const;
+
+        virtual String getType() const;
+
+        /// Static method to startup and register the ASTC codec
+        static void startup(void);
+        /// Static method to shutdown and unregister the ASTC codec
+        static void shutdown(void);
+
+        /** Gets the pixel format of a block footprint, or PF_UNKNOWN if it is
+            not one of the 2D footprints of the standard. */
+        static PixelFormat getPixelFormat(uint32 blockWidth, uint32 blockHeight);
+    };
+    /** @} */
+    /** @} */
+
+} // namespace
+
+#endif
@@ -423,6 +423,11 @@ namespace Ogre {
         */
         void optimise(bool discardIdentityNodeTracks = true);
 
+        /** Compresses the keyframes of all node tracks for playback.
+        @see NodeAnimationTrack::compress
+        */
+        void compressNodeTracks(void);
+
         /// A list of track handles
         typedef set<ushort>::type TrackHandleList;
 
@@ -500,6 +505,44 @@ namespace Ogre {
         
         /// Internal method to adjust keyframes relative to a base keyframe (@see setUseBaseKeyFrame) */
         void _applyBaseKeyFrame();
+
+        /** Internal method bringing the lazily built data of this animation up
+            to date, such as the base keyframe adjustment, the global keyframe
+            time list and the interpolation splines.
+        @remarks
+            Applying an animation updates this data on demand, so call this
+            before the animation is applied from several threads at once.
+        */
+        void _prepareForApply(void);
+
+        /** The node track transforms of this animation sampled at a time position,
+            which can be blended into a skeleton any number of times, with any weight.
+        @see Skeleton::setAnimationSampleCaching
+        */
+        struct SkeletonSample
+        {
+            /// The time position the tracks were sampled at
+            Real timePos;
+            /// Bone handle of each sampled track
+            vector<unsigned short>::type handles;
+            /// Interpolated keyframe rotations, packed as w, x, y, z
+            vector<float>::type rotations;
+            vector<Vector3>::type translates;
+            vector<Vector3>::type scales;
+            /// Tracks which can't be sampled ahead, they're applied as usual
+            vector<NodeAnimationTrack*>::type liveTracks;
+        };
+
+        /** Internal method sampling the node tracks of this animation at the given
+            time position, into sample. */
+        void _sampleSkeleton(Real timePos, SkeletonSample& sample);
+
+        /** Internal method blending node tracks sampled with _sampleSkeleton into a
+            skeleton, exactly like apply would at the sample time position.
+        @param blendMask Per bone weights, multiplied by weight, or null.
+        */
+        void _applySkeletonSample(Skeleton* skel, const SkeletonSample& sample, Real weight,
+            const AnimationState::BoneBlendMask* blendMask, Real scale = 1.0f);
         
         void _notifyContainer(AnimationContainer* c);
         /** Retrieve the container of this animation. */
@@ -538,6 +581,15 @@ namespace Ogre {
 
         /// Internal method to build global keyframe time list
         void buildKeyFrameTimeList(void) const;
+
+        /** Internal method applying the node tracks to a skeleton.
+        @remarks
+            The keyframe rotations of the tracks which allow it are interpolated
+            a block of tracks at a time, using OptimisedUtil::nlerpQuaternions.
+        @param blendMask Per bone weights, multiplied by weight, or null.
+        */
+        void applyToSkeleton(Skeleton* skel, const TimeIndex& timeIndex, Real weight,
+            const AnimationState::BoneBlendMask* blendMask, Real scale);
     };
 
     /** @} */
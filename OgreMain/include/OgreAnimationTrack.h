@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "OgreSimpleSpline.h"
 #include "OgreRotationalSpline.h"
 #include "OgrePose.h"
+#include "OgreAtomicScalar.h"
 
 namespace Ogre 
 {
@@ -251,9 +252,19 @@ namespace Ogre
         typedef vector<ushort>::type KeyFrameIndexMap;
         KeyFrameIndexMap mKeyFrameIndexMap;
 
+        /// Index of the key found by the last search by time, tried first by the next search
+        mutable AtomicScalar<ushort> mKeyCursor;
+
         /// Create a keyframe implementation - must be overridden
         virtual KeyFrame* createKeyFrameImpl(Real time) = 0;
 
+        /** Internal method finding the indexes of the keyframes active at the
+            time given, as getKeyFramesAtTime.
+        @return The parametric value between the two keyframes.
+        */
+        virtual Real getKeyIndexesAtTime(const TimeIndex& timeIndex,
+            unsigned short* firstKeyIndex, unsigned short* secondKeyIndex) const;
+
         /// Internal method for clone implementation
         virtual void populateClone(AnimationTrack* clone) const;
         
@@ -334,6 +345,28 @@ namespace Ogre
             Node* targetNode);
         /// Destructor
         virtual ~NodeAnimationTrack();
+
+        /** Keyframe data of a compressed track.
+        @remarks
+            Rotations are quantised to 3 values per key by dropping the largest
+            component, which is recovered from the others as the rotation is
+            of unit length. The largest component is always positive, and its
+            index (w, x, y, z) is kept in the top bits of the first two values.
+            The other components are stored in the low 15 bits, mapped from
+            [-1/sqrt(2), 1/sqrt(2)].
+        */
+        struct CompressedKeyFrames
+        {
+            /// Key times, in order
+            vector<Real>::type times;
+            /// Quantised rotations, 3 values per key
+            vector<uint16>::type rotations;
+            /// Translations, or empty if no key is translated
+            vector<Vector3>::type translates;
+            /// Scales, or empty if no key is scaled
+            vector<Vector3>::type scales;
+        };
+
         /** Creates a new KeyFrame and adds it to this animation at the given time index.
         @remarks
             It is better to create KeyFrames in time order. Creating them out of order can result 
@@ -367,9 +400,86 @@ namespace Ogre
         /// @copydoc AnimationTrack::_keyFrameDataChanged
         void _keyFrameDataChanged(void) const;
 
-        /** Returns the KeyFrame at the specified index. */
+        /** Returns the KeyFrame at the specified index.
+        @note Not available on a compressed track, see getKeyFrame.
+        */
         virtual TransformKeyFrame* getNodeKeyFrame(unsigned short index) const;
 
+        /** Returns the time of the key at the index given, whether or not the
+            track is compressed. */
+        Real getKeyTime(unsigned short index) const;
+
+        /** Gets the transform of the key at the index given, whether or not the
+            track is compressed. */
+        void getKeyTransform(unsigned short index, Quaternion& rotate,
+            Vector3& translate, Vector3& scale) const;
+
+        /// @copydoc AnimationTrack::getNumKeyFrames
+        unsigned short getNumKeyFrames(void) const;
+
+        /** @copydoc AnimationTrack::getKeyFrame
+        @note A compressed track has no keyframe objects, so this throws
+            unless decompress() is called first. getKeyTime and getKeyTransform
+            work on either kind of track.
+        */
+        KeyFrame* getKeyFrame(unsigned short index) const;
+
+        /** @copydoc AnimationTrack::getKeyFramesAtTime
+        @note Throws on a compressed track, as getKeyFrame does.
+        */
+        Real getKeyFramesAtTime(const TimeIndex& timeIndex, KeyFrame** keyFrame1, KeyFrame** keyFrame2,
+            unsigned short* firstKeyIndex = 0) const;
+
+        /// @copydoc AnimationTrack::createKeyFrame
+        KeyFrame* createKeyFrame(Real timePos);
+
+        /// @copydoc AnimationTrack::removeKeyFrame
+        void removeKeyFrame(unsigned short index);
+
+        /// @copydoc AnimationTrack::removeAllKeyFrames
+        void removeAllKeyFrames(void);
+
+        /** Compresses the keyframes of this track for playback.
+        @remarks
+            The keyframe objects are replaced by arrays of key times, quantised
+            rotations and, where the track uses them, translations and scales
+            (see CompressedKeyFrames). This takes several times less memory
+            and keyframes are found without following a pointer per key.
+            The quantised rotations are accurate to about 1e-4.
+        @par
+            Compressed tracks are meant for playback. Their keyframe objects
+            can't be accessed; use getKeyTime and getKeyTransform, or call
+            decompress() first. Adding or removing keyframes and
+            _applyBaseKeyFrame decompress the track, which is left that way so
+            the rotations aren't quantised again. optimise keeps the track
+            compressed.
+        */
+        void compress(void);
+
+        /** Turns a compressed track back into keyframe objects.
+        @see compress
+        */
+        void decompress(void);
+
+        /** Returns whether the track is compressed.
+        @see compress
+        */
+        bool isCompressed(void) const { return mCompressed != 0; }
+
+        /** Internal method returning the compressed keyframes, or null if the
+            track is not compressed. */
+        const CompressedKeyFrames* _getCompressedKeyFrames(void) const { return mCompressed; }
+
+        /** Internal method replacing the keyframes of this track with the
+            compressed keyframes given, e.g. when loading a track. */
+        void _setCompressedKeyFrames(const CompressedKeyFrames& keyFrames);
+
+        /// @copydoc AnimationTrack::_collectKeyFrameTimes
+        void _collectKeyFrameTimes(vector<Real>::type& keyFrameTimes);
+
+        /// @copydoc AnimationTrack::_buildKeyFrameIndexMap
+        void _buildKeyFrameIndexMap(const vector<Real>::type& keyFrameTimes);
+
 
         /** Method to determine if this track has any KeyFrames which are
             doing anything useful - can be used to determine if this track
@@ -384,10 +494,50 @@ namespace Ogre
         NodeAnimationTrack* _clone(Animation* newParent) const;
         
         void _applyBaseKeyFrame(const KeyFrame* base);
+
+        /** Internal method telling whether the rotations of this track can be
+            interpolated along with those of other tracks by
+            OptimisedUtil::nlerpQuaternions, which is the case when they are
+            interpolated linearly along the shortest path and no listener
+            overrides the keyframes.
+        */
+        bool _isBatchInterpolated(void) const;
+
+        /** Internal method adding an interpolated transform to a node, as
+            applyToNode does.
+        @param node The node to apply the transform to.
+        @param translate, scale The interpolated translation and scale.
+        @param rotate The interpolated rotation, already weighted.
+        @param weight, scl As for applyToNode.
+        */
+        static void _applyTransformToNode(Node* node, const Vector3& translate,
+            const Quaternion& rotate, const Vector3& scale, Real weight, Real scl);
+
+        /** Internal method getting the rotations of the keyframes active at the
+            time given, with the translation and scale interpolated linearly
+            between them. Used when interpolating the rotations of several
+            tracks together, see _isBatchInterpolated.
+        @return The parametric value between the two keyframes, as getKeyFramesAtTime.
+        */
+        Real _getKeyFrameTransformsAtTime(const TimeIndex& timeIndex, Quaternion& rotate1,
+            Quaternion& rotate2, Vector3& translate, Vector3& scale) const;
+
+        /** Internal method building the interpolation splines now if they are
+            out of date, rather than on the next spline interpolation.
+        @remarks
+            The splines are built lazily from const methods, so this must be called
+            before the track is interpolated from several threads at once.
+        */
+        void _prepareInterpolationSplines(void) const;
         
     protected:
         /// Specialised keyframe creation
         KeyFrame* createKeyFrameImpl(Real time);
+
+        /// @copydoc AnimationTrack::getKeyIndexesAtTime
+        Real getKeyIndexesAtTime(const TimeIndex& timeIndex,
+            unsigned short* firstKeyIndex, unsigned short* secondKeyIndex) const;
+
         // Flag indicating we need to rebuild the splines next time
         virtual void buildInterpolationSplines(void) const;
 
@@ -403,6 +553,8 @@ namespace Ogre
         // Prebuilt splines, must be mutable since lazy-update in const method
         mutable Splines* mSplines;
         mutable bool mSplineBuildNeeded;
+        /// Keyframes when the track is compressed, replacing mKeyFrames
+        CompressedKeyFrames* mCompressed;
         /// Defines if rotation is done using shortest path
         mutable bool mUseShortestRotationPath ;
     };
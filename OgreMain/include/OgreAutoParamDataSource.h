@@ -68,6 +68,8 @@ namespace Ogre {
         mutable Matrix4 mInverseWorldMatrix;
         mutable Matrix4 mInverseWorldViewMatrix;
         mutable Matrix4 mInverseViewMatrix;
+        mutable Matrix4 mInverseViewProjMatrix;
+        mutable Matrix4 mInverseProjMatrix;
         mutable Matrix4 mInverseTransposeWorldMatrix;
         mutable Matrix4 mInverseTransposeWorldViewMatrix;
         mutable Vector4 mCameraPosition;
@@ -92,6 +94,8 @@ namespace Ogre {
         mutable bool mInverseWorldMatrixDirty;
         mutable bool mInverseWorldViewMatrixDirty;
         mutable bool mInverseViewMatrixDirty;
+        mutable bool mInverseViewProjMatrixDirty;
+        mutable bool mInverseProjMatrixDirty;
         mutable bool mInverseTransposeWorldMatrixDirty;
         mutable bool mInverseTransposeWorldViewMatrixDirty;
         mutable bool mCameraPositionDirty;
@@ -111,18 +115,31 @@ namespace Ogre {
         mutable bool mLodCameraPositionObjectSpaceDirty;
 
         const Renderable* mCurrentRenderable;
+        /// Identity flags of the current renderable, the camera matrices depend on them
+        bool mUseIdentityView;
+        bool mUseIdentityProjection;
         const Camera* mCurrentCamera;
         bool mCameraRelativeRendering;
         Vector3 mCameraRelativePosition;
         const LightList* mCurrentLightList;
         const Frustum* mCurrentTextureProjector[OGRE_MAX_SIMULTANEOUS_LIGHTS];
+        /// Maps the whole texture of each projector to the tile it renders into
+        Matrix4 mTextureProjectorTile[OGRE_MAX_SIMULTANEOUS_LIGHTS];
         const RenderTarget* mCurrentRenderTarget;
         const Viewport* mCurrentViewport;
         const SceneManager* mCurrentSceneManager;
         const VisibleObjectsBoundsInfo* mMainCamBoundsInfo;
         const Pass* mCurrentPass;
 
+        /// Input versions for GPV_GLOBAL, GPV_PER_OBJECT and GPV_LIGHTS
+        uint32 mVersions[3];
+        /// Versions are unique across all data sources
+        static uint32 msNextVersion;
+
         Light mBlankLight;
+
+        /// Marks the matrices depending only on camera, render target and identity flags dirty
+        void invalidateCameraMatrices(void);
     public:
         AutoParamDataSource();
         virtual ~AutoParamDataSource();
@@ -134,8 +151,14 @@ namespace Ogre {
         virtual void setCurrentCamera(const Camera* cam, bool useCameraRelative);
         /** Sets the light list that should be used, and it's base index from the global list */
         virtual void setCurrentLightList(const LightList* ll);
-        /** Sets the current texture projector for a index */
-        virtual void setTextureProjector(const Frustum* frust, size_t index);
+        /** Sets the current texture projector for a index
+        @param frust The projector
+        @param index The index of the projector
+        @param tile The part of the texture the projector renders into, as
+            left, top, right and bottom texture coordinates, for shadow atlases
+        */
+        virtual void setTextureProjector(const Frustum* frust, size_t index,
+            const RealRect& tile = RealRect(0, 0, 1, 1));
         /** Sets the current render target */
         virtual void setCurrentRenderTarget(const RenderTarget* target);
         /** Sets the current viewport */
@@ -257,6 +280,22 @@ namespace Ogre {
         virtual void setPassNumber(const int passNumber);
         virtual void incPassNumber(void);
         virtual void updateLightCustomGpuParameter(const GpuProgramParameters::AutoConstantEntry& constantEntry, GpuProgramParameters *params) const;
+
+        /** Gets the version of the inputs of auto constants with the given variability.
+        @remarks
+            The version changes whenever an input of that variability may have changed,
+            so GpuProgramParameters::_updateAutoParams can skip the constants which were
+            already computed from the current inputs. Only GPV_GLOBAL, GPV_PER_OBJECT
+            and GPV_LIGHTS are versioned; pass dependent global inputs are identified by
+            the current pass instead.
+        */
+        uint32 getVersion(GpuParamVariability variability) const;
+        /** Marks the inputs of the given variabilities as changed.
+        @remarks
+            Call this if data read by auto constants changed without going through this
+            class, e.g. a light was modified in a render object listener.
+        */
+        void _invalidateVersions(uint16 mask);
     };
     /** @} */
     /** @} */
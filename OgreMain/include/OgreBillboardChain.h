@@ -73,6 +73,12 @@ namespace Ogre {
         time - you have to do all this yourself as a user of the class. 
         Subclasses can however be used to provide this kind of behaviour 
         automatically. @see RibbonTrail
+    @par
+        The vertex buffer is shadowed in system memory, and only the vertices
+        of elements which changed since the last frame (and their neighbours,
+        whose tangents depend on them) are uploaded, unless the view has moved
+        for a camera facing chain or a setting changed which affects every
+        element.
     */
     class _OgreExport BillboardChain : public MovableObject, public Renderable
     {
@@ -300,8 +306,14 @@ namespace Ogre {
         mutable bool mBoundsDirty;
         /// Is the index buffer dirty?
         bool mIndexContentDirty;
-        /// Is the vertex buffer dirty?
+        /// Does the whole vertex buffer need rebuilding?
         bool mVertexContentDirty;
+        /// Are any elements flagged in mElementDirty?
+        bool mElementsDirty;
+        /// Elements whose vertices need rebuilding, parallel to mChainElementList
+        vector<uint8>::type mElementDirty;
+        /// Eye position in local space the vertex buffer was last built for
+        Vector3 mVertexEyePosition;
         /// AABB
         mutable AxisAlignedBox mAABB;
         /// Bounding radius
@@ -355,6 +367,15 @@ namespace Ogre {
         virtual void updateVertexBuffer(Camera* cam);
         /// Update the contents of the index buffer
         virtual void updateIndexBuffer(void);
+        /** Flag an element of a chain, and the neighbours whose tangents depend
+            on it, for upload on the next vertex buffer update.
+        @param chainIndex The index of the chain
+        @param e The index of the element within the buffer subset of the
+            chain, as head and tail of ChainSegment
+        */
+        void markElementDirty(size_t chainIndex, size_t e);
+        /// Flag every element of a chain for upload on the next vertex buffer update
+        void markChainDirty(size_t chainIndex);
         virtual void updateBoundingBox(void) const;
 
         /// Chain segment has no elements
@@ -100,6 +100,13 @@ namespace Ogre {
             String doGet(const void* target) const;
             void doSet(void* target, const String& val);
         };
+        /** Command object for instanced rendering (see ParamCommand).*/
+        class _OgrePrivate CmdInstancedRendering : public ParamCommand
+        {
+        public:
+            String doGet(const void* target) const;
+            void doSet(void* target, const String& val);
+        };
         /** Command object for accurate facing(see ParamCommand).*/
         class _OgrePrivate CmdAccurateFacing : public ParamCommand
         {
@@ -196,13 +203,19 @@ namespace Ogre {
         /// @copydoc BillboardSet::isPointRenderingEnabled
         bool isPointRenderingEnabled(void) const;
 
+        /// @copydoc BillboardSet::setInstancedRenderingEnabled
+        void setInstancedRenderingEnabled(bool enabled);
+
+        /// @copydoc BillboardSet::isInstancedRenderingEnabled
+        bool isInstancedRenderingEnabled(void) const;
+
 
 
         /// @copydoc ParticleSystemRenderer::getType
         const String& getType(void) const;
         /// @copydoc ParticleSystemRenderer::_updateRenderQueue
         void _updateRenderQueue(RenderQueue* queue, 
-            list<Particle*>::type& currentParticles, bool cullIndividually);
+            vector<Particle*>::type& currentParticles, bool cullIndividually);
         /// @copydoc ParticleSystemRenderer::visitRenderables
         void visitRenderables(Renderable::Visitor* visitor, 
             bool debugRenderables = false);
@@ -239,6 +252,7 @@ namespace Ogre {
         static CmdCommonDirection msCommonDirectionCmd;
         static CmdCommonUpVector msCommonUpVectorCmd;
         static CmdPointRendering msPointRenderingCmd;
+        static CmdInstancedRendering msInstancedRenderingCmd;
         static CmdAccurateFacing msAccurateFacingCmd;
 
 
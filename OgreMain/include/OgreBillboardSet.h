@@ -286,6 +286,8 @@ namespace Ogre {
 
         /// Use point rendering?
         bool mPointRendering;
+        /// Expand billboards from instance data in the vertex program?
+        bool mInstancedRendering;
 
 
 
@@ -833,6 +835,51 @@ namespace Ogre {
         /** Returns whether point rendering is enabled. */
         virtual bool isPointRenderingEnabled(void) const
         { return mPointRendering; }
+
+        /// Indexes of the custom parameters set for instanced rendering
+        enum InstancingParameter
+        {
+            /// Billboard x axis, w is 0 for common axes, 1 for BBT_ORIENTED_SELF
+            /// (xyz then holds the camera direction) and 2 for BBT_PERPENDICULAR_SELF
+            /// (xyz then holds the common up vector)
+            IP_AXIS_X = 0,
+            /// Billboard y axis, w is the BillboardRotationType
+            IP_AXIS_Y = 1,
+            /// Parametric offsets of the origin: left, right, top and bottom
+            IP_OFFSETS = 2
+        };
+
+        /** Set whether or not the BillboardSet will expand billboards in the
+            vertex program from hardware instance data.
+        @remarks
+            Rather than generating 4 vertices per billboard, a single quad is
+            drawn once per billboard, and only the position, rotation,
+            dimensions, texture coordinates, direction and colour of each
+            billboard are uploaded each frame, in a vertex buffer with
+            instance data. This cuts the vertex data written by the CPU by
+            almost half, and moves the corner calculations to the GPU.
+        @par
+            The material must use a vertex program which does the expansion,
+            such as the one generated by the RTShader system with the
+            BillboardInstancing sub render state. The quad vertices hold their
+            corner (0 to 1 from left to right and top to bottom) in the
+            position and texture coordinate 0, and each instance holds the
+            position and rotation in texture coordinate 1, the dimensions in
+            texture coordinate 2, the texture rectangle in texture coordinate
+            3, the direction in texture coordinate 4 and the colour. The
+            billboard axes and origin are set as the custom parameters listed
+            by InstancingParameter.
+        @par
+            Accurate facing is not supported with instanced rendering. This
+            cannot be used together with point rendering, and is ignored if
+            the render system has no vertex instance data support.
+        @param enabled True to enable instanced rendering, false otherwise
+        */
+        virtual void setInstancedRenderingEnabled(bool enabled);
+
+        /** Returns whether instanced rendering is enabled. */
+        virtual bool isInstancedRenderingEnabled(void) const
+        { return mInstancedRendering; }
         
         /// Override to return specific type flag
         uint32 getTypeFlags(void) const;
@@ -178,6 +178,8 @@ namespace Ogre {
 
         typedef vector<Listener*>::type ListenerList;
         ListenerList mListeners;
+        /// Temporary copy of the listeners made while firing events
+        typedef std::vector<Listener*, STLAllocator<Listener*, FrameAllocPolicy> > ListenerListCopy;
 
 
         // Internal functions for calcs
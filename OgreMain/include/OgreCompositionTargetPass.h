@@ -76,6 +76,34 @@ namespace Ogre {
         /** Get "only initial" flag.
         */
         bool getOnlyInitial();
+
+        /** Set the number of frames between renders of this target pass (default 1).
+        @remarks
+            The target keeps its contents from its last render in the frames in
+            between, which suits inputs which change slowly, such as an
+            environment map convolution. Values below 1 are treated as 1. This
+            does not apply to the output target pass.
+        */
+        void setUpdateInterval(uint32 frames);
+        /** Get the number of frames between renders of this target pass.
+        */
+        uint32 getUpdateInterval() const { return mUpdateInterval; }
+
+        /** Set whether this target pass is only rendered when its inputs changed.
+        @remarks
+            The target pass is then rendered the first time, whenever a texture
+            read by its render_quad passes was rendered earlier in the same frame,
+            and when it is invalidated with CompositorInstance::invalidateTarget,
+            for example after changing material parameters. The scene, including
+            the scene rendered by the first compositor of the chain for an input
+            previous target, is not tracked. If an update interval above 1 is also
+            set, the target is rendered at least that often. This does not apply
+            to the output target pass.
+        */
+        void setOnlyWhenDirty(bool value);
+        /** Get whether this target pass is only rendered when its inputs changed.
+        */
+        bool getOnlyWhenDirty() const { return mOnlyWhenDirty; }
         
         /** Set the scene visibility mask used by this pass 
         */
@@ -158,6 +186,10 @@ namespace Ogre {
         /// This target pass is only executed initially after the effect
         /// has been enabled.
         bool mOnlyInitial;
+        /// Number of frames between renders of this target pass
+        uint32 mUpdateInterval;
+        /// This target pass is only rendered when its inputs changed
+        bool mOnlyWhenDirty;
         /// Visibility mask for this render
         uint32 mVisibilityMask;
         /// LOD bias of this render
@@ -142,6 +142,11 @@ namespace Ogre {
         */
         void _removeInstance(CompositorInstance *i);
 
+        /** Render the target operations to a target on the next frame, for
+            internal use. @see CompositorInstance::invalidateTarget
+        */
+        void _invalidateTarget(RenderTarget* target);
+
         /** Internal method for registering a queued operation for deletion later **/
         void _queuedOperation(CompositorInstance::RenderSystemOperation* op);
 
@@ -177,6 +182,10 @@ namespace Ogre {
         /// Compiled state (updated with _compile)
         CompositorInstance::CompiledState mCompiledState;
         CompositorInstance::TargetOperation mOutputOperation;
+        /// Targets rendered so far this frame, for the target operations only rendered when dirty
+        vector<RenderTarget*>::type mUpdatedTargets;
+        /// Targets to render on the next frame whatever their update settings
+        vector<RenderTarget*>::type mInvalidatedTargets;
         /// Render System operations queued by last compile, these are created by this
         /// instance thus managed and deleted by it. The list is cleared with 
         /// clearCompilationState()
@@ -121,7 +121,8 @@ namespace Ogre {
             TargetOperation(RenderTarget *inTarget):
                 target(inTarget), currentQueueGroupID(0), visibilityMask(0xFFFFFFFF),
                 lodBias(1.0f),
-                onlyInitial(false), hasBeenRendered(false), findVisibleObjects(false), 
+                onlyInitial(false), hasBeenRendered(false), updateInterval(1), onlyWhenDirty(false),
+                framesSinceUpdate(0), findVisibleObjects(false), 
                 materialScheme(MaterialManager::DEFAULT_SCHEME_NAME), shadowsEnabled(true)
             { 
             }
@@ -157,6 +158,16 @@ namespace Ogre {
                 onlyInitial to determine whether to skip this target operation.
             */
             bool hasBeenRendered;
+            /** @see CompositionTargetPass::mUpdateInterval
+            */
+            uint32 updateInterval;
+            /** @see CompositionTargetPass::mOnlyWhenDirty
+            */
+            bool onlyWhenDirty;
+            /// Frames since this target operation was last rendered
+            uint32 framesSinceUpdate;
+            /// Targets of the textures read by this operation
+            vector<RenderTarget*>::type inputTargets;
             /** Whether this op needs to find visible scene objects or not 
             */
             bool findVisibleObjects;
@@ -227,6 +238,13 @@ namespace Ogre {
         */
         RenderTarget* getRenderTarget(const String& name);
 
+        /** Render a target pass again on the next frame, even if it would be
+            skipped because of its update interval or only when dirty setting.
+        @param name
+            The name of the texture the target pass renders to.
+        */
+        void invalidateTarget(const String& name);
+
        
         /** Recursively collect target states (except for final Pass).
         @param compiledState
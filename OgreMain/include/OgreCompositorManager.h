@@ -152,6 +152,47 @@ namespace Ogre {
         */
         void freePooledTextures(bool onlyIfUnreferenced = true);
 
+        /** Sets whether local textures of a chain whose lifetimes don't overlap
+            share memory (default false).
+        @remarks
+            Each compositor instance works out which of its non pooled, local
+            scope, single surface textures are only used within one frame: written
+            by a target pass which replaces their contents before anything reads
+            them, and not written by an only_initial target pass. Such textures of
+            the same size and format share one texture with others in the same
+            chain whose first to last uses don't overlap, including the transient
+            textures of the other compositors of the chain.
+        @par
+            Only enable this if no material or listener reads these textures
+            outside of the compositor that owns them, for example through a
+            texture unit referencing the compositor, since their contents are
+            overwritten by other passes. Techniques with custom composition
+            passes are never aliased. The setting applies to resources created
+            afterwards.
+        */
+        void setTextureAliasingEnabled(bool enabled) { mTextureAliasing = enabled; }
+        /// Gets whether local textures with non overlapping lifetimes share memory
+        bool getTextureAliasingEnabled(void) const { return mTextureAliasing; }
+
+        /** Gets a texture shared by the transient textures of a chain, for internal use.
+        @remarks
+            The texture is not shared with another use whose pass range overlaps
+            [firstPass, lastPass] in the same instance, nor with any use of another
+            instance when either use is written from the previous compositor.
+        @param inputPrevious Whether the texture is written with input previous,
+            which renders the output pass of the previous instance into it
+        */
+        TexturePtr _getAliasedTexture(const String& name, const String& localName,
+            size_t w, size_t h, PixelFormat f, uint aa, const String& aaHint, bool srgb,
+            uint16 depthBufferId, CompositorInstance* inst, size_t firstPass, size_t lastPass,
+            bool inputPrevious);
+
+        /** Releases a use of a texture returned by _getAliasedTexture, for internal use.
+        @return Whether the local texture was aliased, the texture itself is
+            destroyed once it has no uses left
+        */
+        bool _releaseAliasedTexture(CompositorInstance* inst, const String& localName);
+
         /** Register a compositor logic for listening in to expecting composition
             techniques.
         */
@@ -308,6 +349,29 @@ namespace Ogre {
         
         ChainTexturesByDef mChainTexturesByDef;
 
+        /// A use of an aliased texture
+        struct AliasUse
+        {
+            CompositorInstance* instance;
+            String localName;
+            size_t firstPass, lastPass;
+            bool inputPrevious;
+        };
+        typedef vector<AliasUse>::type AliasUseList;
+        struct AliasedTexture
+        {
+            TexturePtr texture;
+            TextureDef def;
+            uint16 depthBufferId;
+            AliasUseList uses;
+
+            AliasedTexture(const TextureDef& d) : def(d), depthBufferId(0) {}
+        };
+        typedef list<AliasedTexture>::type AliasedTextureList;
+        typedef map<CompositorChain*, AliasedTextureList>::type AliasedTexturesByChain;
+        AliasedTexturesByChain mAliasedTextures;
+        bool mTextureAliasing;
+
         bool isInputPreviousTarget(CompositorInstance* inst, const Ogre::String& localName);
         bool isInputPreviousTarget(CompositorInstance* inst, TexturePtr tex);
         bool isInputToOutputTarget(CompositorInstance* inst, const Ogre::String& localName);
@@ -59,6 +59,11 @@ namespace Ogre {
         typedef set<Controller<Real>*>::type ControllerList;
         ControllerList mControllers;
 
+        /// mControllers in a contiguous list for updating, rebuilt when dirty
+        typedef vector<Controller<Real>*>::type ControllerUpdateList;
+        ControllerUpdateList mUpdateList;
+        bool mUpdateListDirty;
+
         /// Global predefined controller
         ControllerValueRealPtr mFrameTimeController;
         
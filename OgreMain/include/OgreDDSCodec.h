@@ -66,6 +66,13 @@ namespace Ogre {
         void unpackDXTAlpha(const DXTExplicitAlphaBlock& block, ColourValue* pCol) const;
         /// Unpack DXT alphas into array of 16 colour values
         void unpackDXTAlpha(const DXTInterpolatedAlphaBlock& block, ColourValue* pCol) const;
+        /** Unpack the rows of 4x4 blocks [begin, end) of a DXT image, counting the
+            rows of every slice one after the other */
+        void unpackDXTBlockRows(PixelFormat sourceFormat, const uchar* src, PixelFormat destFormat,
+            uchar* dest, uint32 width, uint32 height, size_t begin, size_t end) const;
+
+        /// Unpacks the block rows of a DXT image on the workers
+        class DXTUnpackTask;
 
         /// Single registered codec instance
         static DDSCodec* msInstance;
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #define __EdgeListBuilder_H__
 
 #include "OgrePrerequisites.h"
+#include "OgreCommon.h"
 #include "OgreRenderOperation.h"
 #include "OgreVector3.h"
 #include "OgreVector4.h"
@@ -231,17 +232,28 @@ namespace Ogre {
                 return a.indexSet < b.indexSet;
             }
         };
-        /** Comparator for unique vertex list */
-        struct vectorLess {
-            bool operator()(const Vector3& a, const Vector3& b) const
+        /** Hash for unique vertex list */
+        struct vectorHash {
+            size_t operator()(const Vector3& v) const
             {
-                if (a.x < b.x) return true;
-                if (a.x > b.x) return false;
-                if (a.y < b.y) return true;
-                if (a.y > b.y) return false;
-                return a.z < b.z;
+                // Positions are compared exactly, -0 must hash like 0
+                Real c[3] = { v.x == 0 ? 0 : v.x, v.y == 0 ? 0 : v.y, v.z == 0 ? 0 : v.z };
+                return FastHash(reinterpret_cast<const char*>(c), sizeof(c));
             }
         };
+        /** Hash for edges by their shared vertices */
+        struct edgeHash {
+            size_t operator()(const std::pair<size_t, size_t>& e) const
+            {
+                return (e.first * 2654435761u) ^ e.second;
+            }
+        };
+        /** An edge created by a triangle, which no other triangle connected to yet */
+        struct OpenEdge {
+            size_t vertexSet;   /// The edge group of the edge
+            size_t edgeIndex;   /// Place of the edge in its edge group
+            size_t next;        /// The next open edge on the same vertices, or ~0
+        };
 
         typedef vector<const VertexData*>::type VertexDataList;
         typedef vector<Geometry>::type GeometryList;
@@ -252,13 +264,16 @@ namespace Ogre {
         CommonVertexList mVertices;
         EdgeData* mEdgeData;
         /// Map for identifying common vertices
-        typedef map<Vector3, size_t, vectorLess>::type CommonVertexMap;
+        typedef OGRE_HashMap<Vector3, size_t, vectorHash> CommonVertexMap;
         CommonVertexMap mCommonVertexMap;
-        /** Edge map, used to connect edges. Note we allow many triangles on an edge,
-        after connected an existing edge, we will remove it and never used again.
+        /** Edge map, used to connect edges, giving the first and last open edges
+        on the shared vertices in mOpenEdges. Note we allow many triangles on an edge,
+        they are connected in the order they were created, and after connected an
+        existing edge, we will remove it and never used again.
         */
-        typedef multimap< std::pair<size_t, size_t>, std::pair<size_t, size_t> >::type EdgeMap;
+        typedef OGRE_HashMap<std::pair<size_t, size_t>, std::pair<size_t, size_t>, edgeHash> EdgeMap;
         EdgeMap mEdgeMap;
+        vector<OpenEdge>::type mOpenEdges;
 
         void buildTrianglesEdges(const Geometry &geometry);
 
@@ -33,6 +33,7 @@ THE SOFTWARE.
 
 #include "OgreMovableObject.h"
 #include "OgreQuaternion.h"
+#include "OgreDualQuaternion.h"
 #include "OgreVector3.h"
 #include "OgreHardwareBufferManager.h"
 #include "OgreRenderable.h"
@@ -178,6 +179,8 @@ namespace Ogre {
         /// Cached bone matrices in skeleton local space, might shares with other entity instances.
         Matrix4 *mBoneMatrices;
         unsigned short mNumBoneMatrices;
+        /// Bone dual quaternions converted from mBoneMatrices for software skinning.
+        vector<DualQuaternion>::type mBoneDualQuaternions;
         /// Records the last frame in which animation was updated.
         unsigned long mFrameAnimationLastUpdated;
 
@@ -196,10 +199,13 @@ namespace Ogre {
         EntitySet* mSharedSkeletonEntities;
 
         /** Private method to cache bone matrices from skeleton.
+        @param allowSharedPose
+            Whether the matrices may be copied from another entity which evaluated
+            the same pose this frame (@see SceneManager::setSkeletonPoseSharing).
         @return
             True if the bone matrices cache has been updated. False if note.
         */
-        bool cacheBoneMatrices(void);
+        bool cacheBoneMatrices(bool allowSharedPose = true);
 
         /// Flag determines whether or not to display skeleton.
         bool mDisplaySkeleton;
@@ -225,6 +231,29 @@ namespace Ogre {
         bool mAlwaysUpdateMainSkeleton;
         /// Flag indicating whether to update the bounding box from the bones of the skeleton.
         bool mUpdateBoundingBoxFromSkeleton;
+        /// Flag indicating whether software skinning blends dual quaternions rather than matrices.
+        bool mDualQuaternionSkinning;
+        /// Flag indicating whether the triangle clusters of the submeshes are culled.
+        bool mClusterCulling;
+        /// The camera the clusters are culled for, from _notifyCurrentCamera.
+        Camera* mClusterCamera;
+
+        /// Animation LOD values set by setAnimationLodLevels.
+        vector<Real>::type mAnimationLodUserValues;
+        /// Animation LOD values transformed by mAnimationLodStrategy, after its base value.
+        vector<Real>::type mAnimationLodValues;
+        /// LOD strategy mAnimationLodValues were transformed by.
+        const LodStrategy* mAnimationLodStrategy;
+        /// Animation LOD index, calculated by _notifyCurrentCamera.
+        ushort mAnimationLodIndex;
+        /// Flag indicating whether the animation is not evaluated at the last animation LOD.
+        bool mFreezeLastAnimationLod;
+        /// Flag indicating whether the animation is not evaluated at the current animation LOD.
+        bool mAnimationLodFrozen;
+
+        /** Returns whether the animation LOD skips evaluating the animation
+            this frame, reusing the results of the last evaluation. */
+        bool isAnimationLodSkipped(void) const;
 
 #if !OGRE_NO_MESHLOD
         /// The LOD number of the mesh to use, calculated by _notifyCurrentCamera.
@@ -263,6 +292,14 @@ namespace Ogre {
         const ushort mMinMaterialLodIndex;
         const ushort mMaxMaterialLodIndex;
 #endif
+        /// Fraction of the LOD value by which a mesh LOD threshold must be passed to change LOD
+        Real mMeshLodHysteresis;
+        /// LOD camera the LOD indexes were last computed for, see SceneManager::setShareLodAcrossCameras
+        const Camera* mLodCamera;
+        /// Frame the LOD indexes were last computed in
+        unsigned long mLodFrame;
+        /// Transform version of the parent node the LOD indexes were last computed with
+        unsigned long mLodTransformVersion;
         /** This Entity's personal copy of the skeleton, if skeletally animated.
         */
         SkeletonInstance* mSkeletonInstance;
@@ -272,6 +309,10 @@ namespace Ogre {
 
         /// Last parent transform.
         Matrix4 mLastParentXform;
+        /// Parent transform _updateBoneMatrices updated the child objects for, ZERO if none
+        Matrix4 mChildTransformsXform;
+        /// Frame number _updateBoneMatrices updated the child objects in
+        unsigned long mFrameChildTransformsUpdated;
 
         /// Mesh state count, used to detect differences.
         size_t mMeshStateCount;
@@ -303,6 +344,8 @@ namespace Ogre {
         void applyVertexAnimation(bool hardwareAnimation, bool stencilShadows);
         /// Initialise the hardware animation elements for given vertex data.
         ushort initHardwareAnimationElements(VertexData* vdata, ushort numberOfElements, bool animateNormals);
+        /// Binds the pose texture coordinates of the mesh target to vdata and resets its pose weights
+        void initHardwarePoseTextureElements(VertexData* vdata, ushort target);
         /// Are software vertex animation temp buffers bound?
         bool tempVertexAnimBuffersBound(void) const;
         /// Are software skeleton animation temp buffers bound?
@@ -317,6 +360,13 @@ namespace Ogre {
 
         /// Bounding box that 'contains' all the mesh of each child entity.
         mutable AxisAlignedBox mFullBoundingBox;  // note: this exists only so that getBoundingBox() can return an AAB by reference
+        /// Bones which have vertices weighted to them, used to bound the skeleton
+        vector<ushort>::type mWeightedBones;
+
+        /// Triangle hierarchy refitted to the animated positions, see getBVH
+        MeshBVH* mBVH;
+        /// Animation frame mBVH was refitted to
+        unsigned long mBVHFrame;
 
         ShadowRenderableList mShadowRenderables;
 
@@ -518,6 +568,19 @@ namespace Ogre {
         */
         void setMeshLodBias(Real factor, ushort maxDetailIndex = 0, ushort minDetailIndex = 99);
 
+        /** Sets how far past a mesh LOD threshold the LOD value must go before
+            this entity changes its mesh LOD.
+        @remarks
+            Without hysteresis an entity moving back and forth around a threshold
+            switches LOD every time it crosses it, which is visible as popping.
+        @param fraction
+            Fraction of the LOD value, 0 (the default) changes LOD exactly at the
+            thresholds, 0.1 for example needs the value to be 10% past them.
+        */
+        void setMeshLodHysteresis(Real fraction) { mMeshLodHysteresis = fraction; }
+        /// Gets the fraction set by setMeshLodHysteresis
+        Real getMeshLodHysteresis(void) const { return mMeshLodHysteresis; }
+
         /** Sets a level-of-detail bias for the material detail of this entity.
         @remarks
             Level of detail reduction is normally applied automatically based on the Material
@@ -689,6 +752,16 @@ namespace Ogre {
         */
         void removeSoftwareAnimationRequest(bool normalsAlso);
 
+        /** Gets the bounding volume hierarchy of the triangles of this entity, for
+            exact ray tests.
+        @remarks
+            This is the hierarchy of the mesh (see Mesh::getBVH), unless the entity
+            is animated, in which case a copy is refitted to the positions of the
+            last animation applied in software. Request software animation with
+            addSoftwareAnimationRequest for hardware animated entities.
+        */
+        const MeshBVH* getBVH(void);
+
         /** Shares the SkeletonInstance with the supplied entity.
             Note that in order for this to work, both entities must have the same
             Skeleton.
@@ -735,6 +808,39 @@ namespace Ogre {
         */
         void _updateAnimation(void);
 
+        /** Internal method telling whether the bone matrices of this entity can be
+            cached by _updateBoneMatrices concurrently with other entities.
+        @remarks
+            This must be called from the main thread, since it also brings the
+            lazily built data of the enabled skeletal animations up to date. It
+            returns false if the bones were already cached this frame, or if caching
+            them touches state outside the entity: when the skeleton instance is
+            shared with other entities, or when an object attached to a bone has a
+            listener to notify of its move.
+        */
+        bool _prepareConcurrentBoneUpdate(void);
+
+        /** Internal method caching the bone matrices of this entity for the
+            current frame, along with the transforms of the objects attached to its
+            bones, so that updating its animation later in the frame only needs to
+            blend the vertices.
+        @remarks
+            This may be called from a worker thread, provided
+            _prepareConcurrentBoneUpdate returned true for this entity.
+        */
+        void _updateBoneMatrices(void);
+
+        /** Internal method bringing the bones up to date ahead of rendering when the
+            bounding box follows the skeleton and the animation has changed.
+        @remarks
+            The bones are evaluated at most once per frame; when rendered later in the
+            frame only the vertices remain to be blended.
+        @return
+            True if the bones were evaluated, in which case the parent node is queued
+            for an update so that its bounds follow.
+        */
+        bool _updateSkeletonBounds(void);
+
         /** Tests if any animation applied to this entity.
         @remarks
             An entity is animated if any animation state is enabled, or any manual bone
@@ -867,6 +973,73 @@ namespace Ogre {
             return mAlwaysUpdateMainSkeleton;
         }
 
+        /** Sets whether the triangle clusters of the submeshes which have them are
+            culled for each camera, so only the clusters which may be seen are drawn
+            (default true).
+        @remarks
+            See SubMesh::clusters and SubEntity::_cullClusters. Clusters are not
+            culled for animated entities, whose triangles move, nor at lower
+            levels of detail. Clusters facing away are kept when rendering
+            shadow textures, and for materials not culling back faces.
+        */
+        void setClusterCulling(bool cull) { mClusterCulling = cull; }
+
+        /** Gets whether the triangle clusters of the submeshes are culled. */
+        bool getClusterCulling() const { return mClusterCulling; }
+
+        /** Sets the LOD values past which the animation of this entity is
+            updated less often.
+        @remarks
+            The values are in the units of the LOD strategy of the mesh, e.g.
+            distances for DistanceLodStrategy or pixel counts for
+            PixelCountLodStrategy, in order of decreasing detail. They are
+            compared with the value used to pick the mesh LOD, including the
+            mesh LOD bias. Past the first value the skeletal and vertex
+            animation are evaluated every 2nd frame, past the second value
+            every 4th frame and so on, and the bone matrices and blended
+            vertices of the last evaluation are reused in between. Entities
+            evaluate on different frames, so that not all of them update at
+            once. Manually controlled bones that were moved are always applied.
+        @param lodValues The LOD values, or an empty list to evaluate the
+            animation every frame.
+        @param freezeLastLevel If true, past the last value the animation is
+            not evaluated at all, which also skips software skinning. The
+            entity keeps the pose it had when it got there.
+        */
+        void setAnimationLodLevels(const vector<Real>::type& lodValues, bool freezeLastLevel = false);
+
+        /** Gets the LOD values set by setAnimationLodLevels. */
+        const vector<Real>::type& getAnimationLodLevels(void) const {
+            return mAnimationLodUserValues;
+        }
+
+        /** Gets the current animation LOD index, calculated by _notifyCurrentCamera.
+        @remarks
+            0 means the animation is evaluated every frame, n every 2^n-th frame.
+        @see setAnimationLodLevels
+        */
+        ushort getCurrentAnimationLodIndex(void) const {
+            return mAnimationLodIndex;
+        }
+
+        /** Sets whether software skinning blends the bones as dual quaternions.
+        @remarks
+            Linear blending of bone matrices loses volume where joints twist,
+            the "candy wrapper" effect; blending dual quaternions doesn't, at
+            a little extra cost per vertex. Bone scaling is ignored when this
+            is enabled. This only affects skinning done in software, hardware
+            skinning is chosen by the vertex program of the material.
+        */
+        void setDualQuaternionSkinning(bool enabled) {
+            mDualQuaternionSkinning = enabled;
+        }
+
+        /** Gets whether software skinning blends the bones as dual quaternions.
+        */
+        bool getDualQuaternionSkinning() const {
+            return mDualQuaternionSkinning;
+        }
+
         /** If true, the skeleton of the entity will be used to update the bounding box for culling.
             Useful if you have skeletal animations that move the bones away from the root.  Otherwise, the
             bounding box of the mesh in the binding pose will be used.
@@ -121,6 +121,52 @@ namespace Ogre {
         }
 
         static bool msIgnoreHidden;
+
+        /** Set whether read only files are opened as memory mapped streams.
+        @remarks
+            The MappedFileDataStream returned is a MemoryDataStream, which meshes,
+            scripts and the image codecs read in place instead of copying the file
+            to memory first. Files can't be replaced or truncated
+            while mapped, so this is off by default. Only supported on Windows
+            desktop and POSIX platforms, others keep using file streams.
+        */
+        static void setUseMemoryMapping(bool useMapping)
+        {
+            msUseMemoryMapping = useMapping;
+        }
+
+        /// Get whether read only files are opened as memory mapped streams.
+        static bool getUseMemoryMapping()
+        {
+            return msUseMemoryMapping;
+        }
+
+        static bool msUseMemoryMapping;
+    };
+
+    /** A read only MemoryDataStream over a memory mapped file.
+    @remarks
+        Pages are mapped copy-on-write, so writing through getPtr() doesn't
+        change the file. @see FileSystemArchive::setUseMemoryMapping
+    */
+    class _OgreExport MappedFileDataStream : public MemoryDataStream
+    {
+    protected:
+        /// Platform handle of the mapping, if the platform needs one
+        void* mMapping;
+
+        MappedFileDataStream(const String& name, void* data, size_t size, void* mapping);
+    public:
+        ~MappedFileDataStream();
+
+        /** Maps the file at the given path, named name.
+        @return The stream, or null if the file couldn't be mapped (empty files
+            included), in which case it has to be opened another way.
+        */
+        static MappedFileDataStream* open(const String& name, const String& path);
+
+        /// @copydoc DataStream::close
+        void close(void);
     };
 
     /** Specialisation of ArchiveFactory for FileSystem files. */
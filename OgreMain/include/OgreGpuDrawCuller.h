@@ -0,0 +1,130 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __GpuDrawCuller_H__
+#define __GpuDrawCuller_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreMatrix4.h"
+#include "OgreVector4.h"
+#include "OgreRenderOperation.h"
+#include "OgreHardwareVertexBuffer.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup RenderSystem
+    *  @{
+    */
+    /** Culls draws or instances against a camera on the GPU, and writes the
+        draw arguments of those which remain for an indirect draw.
+    @remarks
+        The bounds are uploaded once, after which culling costs the CPU the
+        same whatever the number of draws or instances: the render system
+        runs a compute pass right before drawing a render operation whose
+        gpuDrawCuller is set, and draws from the arguments it wrote.
+    @par
+        Bounding spheres are tested against the frustum of the camera given
+        to cull, and against the depth hierarchy of the SoftwareOcclusionCuller
+        of its scene manager when it was updated for that camera.
+    @par
+        Created by RenderSystem::createGpuDrawCuller, and deleted with
+        OGRE_DELETE.
+    */
+    class _OgreExport GpuDrawCuller : public RenderSysAlloc
+    {
+    public:
+        GpuDrawCuller();
+        virtual ~GpuDrawCuller();
+
+        /** Sets draws culled one by one.
+        @remarks
+            Every command keeps its slot in the draw arguments, culled ones
+            with no instance, so all the draws must share the vertex and
+            index data of the render operation.
+        @param commands The draws
+        @param bounds World space bounding sphere of each draw, centre in
+            xyz and radius in w
+        @param count Number of draws
+        */
+        virtual void setDraws(const IndirectDrawCommand* commands, const Vector4* bounds,
+            size_t count) = 0;
+
+        /** Sets the instances of a single instanced draw, culled one by one.
+        @remarks
+            The data of the visible instances is packed at the start of
+            instanceBuffer, and the instance count of the draw set to their
+            number.
+        @param command The draw, whose instance count is ignored
+        @param bounds World space bounding sphere of each instance
+        @param instanceData The data of each instance, the vertex size of
+            instanceBuffer apiece, which must be a multiple of 4 bytes
+        @param count Number of instances
+        @param instanceBuffer The per instance vertex buffer the draw reads,
+            which is only written by the culling from now on
+        */
+        virtual void setInstances(const IndirectDrawCommand& command, const Vector4* bounds,
+            const void* instanceData, size_t count, const HardwareVertexBufferSharedPtr& instanceBuffer) = 0;
+
+        /** Replaces the bounds of the draws or instances [first, first + count). */
+        virtual void updateBounds(size_t first, size_t count, const Vector4* bounds) = 0;
+
+        /** Sets the camera the next draw is culled against.
+        @remarks
+            Cheap, the culling itself only runs when the render operation
+            is drawn. Call it each time the owner is queued for a camera.
+        */
+        void cull(const Camera* cam);
+
+        /** Gets the number of draws or instances culled. */
+        size_t getNumItems(void) const { return mNumItems; }
+        /** Gets whether instances of a single draw are culled, rather than draws. */
+        bool isInstanced(void) const { return mInstanced; }
+
+    protected:
+        size_t mNumItems;
+        bool mInstanced;
+
+        /// Whether cull was called since the last culling pass
+        bool mCullPending;
+        /// World space frustum planes (normal, d) of the camera, the far plane
+        /// never culling for an infinite far distance
+        Vector4 mPlanes[6];
+        /// The view projection the depth hierarchy was rendered with
+        Matrix4 mViewProj;
+        /// The depth hierarchy to test against, if up to date for the camera
+        const SoftwareOcclusionCuller* mOcclusion;
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -248,6 +248,14 @@ namespace Ogre {
     virtual const String& getSourceFile(void) const { return mFilename; }
     /** Gets the assembler source for this program. */
     virtual const String& getSource(void) const { return mSource; }
+    /** Gets a hash of everything the compiled program depends on.
+    @remarks
+        Covers the source, type, syntax code and all parameters, such as the
+        preprocessor defines, entry point and target of high level programs.
+        Render systems add it to the names of microcode cache entries, so
+        changed programs are compiled again.
+    */
+    virtual uint32 _getHash(uint32 hashSoFar = 0) const;
     /// Set the program type (only valid before load)
     virtual void setType(GpuProgramType t);
     /// Get the program type
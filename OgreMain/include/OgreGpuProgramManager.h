@@ -59,15 +59,70 @@ namespace Ogre {
         typedef MemoryDataStreamPtr Microcode;
         typedef map<String, Microcode>::type MicrocodeMap;
 
+        /// The work timed by a CompileTimer
+        enum CompileStage
+        {
+            /// Compiling the source of a program
+            CS_COMPILE,
+            /// Linking programs together
+            CS_LINK,
+            /// Generating the source of a program, e.g. by the RTShader system
+            CS_GENERATE
+        };
+        /// The time spent on one program
+        struct CompileTiming
+        {
+            String name;
+            CompileStage stage;
+            unsigned long microseconds;
+            /// When it began, on the timer of Root and the Profiler
+            unsigned long startTime;
+            /// The frame it happened in, see Root::getNextFrameNumber
+            unsigned long frameNumber;
+        };
+        typedef vector<CompileTiming>::type CompileTimingList;
+
+        /** Times the compilation, linking or generation of a program until it
+            goes out of scope, see _notifyCompiled. */
+        class _OgreExport CompileTimer
+        {
+        public:
+            CompileTimer(CompileStage stage, const String& name);
+            ~CompileTimer();
+        private:
+            CompileStage mStage;
+            String mName;
+            unsigned long mStart;
+        };
+
     protected:
 
         SharedParametersMap mSharedParametersMap;
         MicrocodeMap mMicrocodeCache;
         bool mSaveMicrocodesToCache;
         bool mCacheDirty;           // When this is true the cache is 'dirty' and should be resaved to disk.
+        /// Directory the microcode cache is kept in automatically, if any
+        String mMicrocodeCacheDirectory;
+        /// File in mMicrocodeCacheDirectory new microcodes are appended to
+        String mMicrocodeCacheFile;
+        /// Whether the cache file has been read, which waits for a render system
+        bool mMicrocodeCacheOpened;
+        /// Lookups of the microcode cache, counted by isMicrocodeAvailableInCache
+        mutable size_t mMicrocodeCacheHits;
+        mutable size_t mMicrocodeCacheMisses;
+
+        CompileTimingList mCompileTimings;
+        size_t mCompileCount[CS_GENERATE + 1];
+        unsigned long mCompileTime[CS_GENERATE + 1];
+        OGRE_MUTEX(mCompileTimingsMutex);
             
         static String addRenderSystemToName( const String &  name );
 
+        /// Reads the cache file in mMicrocodeCacheDirectory, once the render system is up
+        void openMicrocodeCache();
+        /// Appends a microcode to the cache file
+        void appendMicrocodeToCacheFile( const String & name, const Microcode & microcode );
+
         /// Specialised create method with specific parameters
         virtual Resource* createImpl(const String& name, ResourceHandle handle, 
             const String& group, bool isManual, ManualResourceLoader* loader,
@@ -202,6 +257,23 @@ namespace Ogre {
         */
         bool isCacheDirty(void) const;
 
+        /** Keep the microcode cache in a directory automatically.
+        @remarks
+            Once the render system is initialised, saving microcodes to the cache
+            is turned on and the cache file for that render system is read. Every
+            program compiled afterwards is appended to the file as soon as it is
+            added, so there is no need to call saveMicrocodeCache. Entries are
+            named after the render system, device and driver version, and render
+            systems add GpuProgram::_getHash to the program names, so binaries are
+            never used for changed programs or on another driver. Stale entries
+            stay in the file until it is deleted.
+        @param path The directory, which is created if needed. An empty path
+            stops the automatic cache.
+        */
+        void setMicrocodeCacheDirectory( const String & path );
+        /// Get the directory the microcode cache is kept in automatically.
+        const String & getMicrocodeCacheDirectory(void) const { return mMicrocodeCacheDirectory; }
+
         bool canGetCompiledShaderBuffer();
         /** Check if a microcode is available for a program in the microcode cache.
         @param name The name of the program.
@@ -235,6 +307,30 @@ namespace Ogre {
         @param stream The source stream
         */
         virtual void loadMicrocodeCache( DataStreamPtr stream );
+
+        /// Gets the number of programs found in the microcode cache since startup
+        size_t getMicrocodeCacheHits(void) const { return mMicrocodeCacheHits; }
+        /// Gets the number of programs not found in the microcode cache since startup
+        size_t getMicrocodeCacheMisses(void) const { return mMicrocodeCacheMisses; }
+
+        /** Records the time spent compiling, linking or generating a program.
+        @remarks
+            Called by CompileTimer, which the program loading code of OgreMain,
+            the render systems and the RTShader system use.
+        */
+        void _notifyCompiled(CompileStage stage, const String& name, unsigned long microseconds);
+        /** Gets the time spent on every program since startup or the last
+            clearCompileTimings, in order.
+        @remarks
+            Programs compiled after the first frame show the warm-up missed them.
+        */
+        CompileTimingList getCompileTimings(void) const;
+        /// Clears the list of getCompileTimings, but not the totals
+        void clearCompileTimings(void);
+        /// Gets the number of programs compiled, linked or generated since startup
+        size_t getTotalCompileCount(CompileStage stage) const;
+        /// Gets the time spent compiling, linking or generating programs since startup, in microseconds
+        unsigned long getTotalCompileTime(CompileStage stage) const;
         
 
 
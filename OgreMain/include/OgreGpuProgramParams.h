@@ -811,15 +811,15 @@ namespace Ogre {
         };
         typedef vector<CopyDataEntry>::type CopyDataList;
 
-        CopyDataList mCopyDataList;
+        mutable CopyDataList mCopyDataList;
 
         // Optional data the rendersystem might want to store
         mutable Any mRenderSystemData;
 
         /// Version of shared params we based the copydata on
-        unsigned long mCopyDataVersion;
+        mutable unsigned long mCopyDataVersion;
 
-        void initCopyData();
+        void initCopyData() const;
 
 
     public:
@@ -834,7 +834,7 @@ namespace Ogre {
             which case the values should not be copied out of the shared area
             into the individual parameter set, but bound separately.
         */
-        void _copySharedParamsToTargetParams();
+        void _copySharedParamsToTargetParams() const;
 
         /// Get the name of the shared parameter set
         const String& getName() const { return mSharedParams->getName(); }
@@ -1497,6 +1497,13 @@ namespace Ogre {
         bool mIgnoreMissingParams;
         /// physical index for active pass iteration parameter real constant entry;
         size_t mActivePassIterationIndex;
+        /// AutoParamDataSource versions the GPV_GLOBAL, GPV_PER_OBJECT and GPV_LIGHTS autos were computed from
+        uint32 mAutoParamVersions[3];
+        /// The pass the pass dependent global autos were computed for
+        const Pass* mAutoParamPass;
+
+        /// Forces the next _updateAutoParams to recompute all autos
+        void resetAutoParamVersions(void);
 
         /// Return the variability for an auto constant
         uint16 deriveVariability(AutoConstantType act);
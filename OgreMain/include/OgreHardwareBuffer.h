@@ -34,6 +34,8 @@ THE SOFTWARE.
 
 namespace Ogre {
 
+    class HardwareBufferLockListener;
+
     /** \addtogroup Core
     *  @{
     */
@@ -168,18 +170,77 @@ namespace Ogre {
             HardwareBuffer* mShadowBuffer;
             bool mShadowUpdated;
             bool mSuppressHardwareUpdate;
+            /// Byte ranges (start, end) of the shadow buffer not yet uploaded, sorted and disjoint
+            typedef vector<std::pair<size_t, size_t> >::type DirtyRangeList;
+            DirtyRangeList mDirtyRanges;
+            /// Whether the current lock range still has to be added to mDirtyRanges on unlock
+            bool mLockRangeDirty;
+            /// What created the buffer, see setOwnerName
+            String mOwnerName;
             
             /// Internal implementation of lock()
             virtual void* lockImpl(size_t offset, size_t length, LockOptions options) = 0;
             /// Internal implementation of unlock()
             virtual void unlockImpl(void) = 0;
 
+            /// Adds a range of the shadow buffer to the ranges uploaded by _updateFromShadow
+            void addDirtyRange(size_t offset, size_t length)
+            {
+                // Beyond this many ranges the per-upload overhead outweighs the bytes saved
+                const size_t maxRanges = 16;
+
+                size_t start = offset, end = offset + length;
+                DirtyRangeList::iterator i = mDirtyRanges.begin();
+                while (i != mDirtyRanges.end() && i->second < start)
+                    ++i;
+                // Merge with every range it overlaps or touches
+                while (i != mDirtyRanges.end() && i->first <= end)
+                {
+                    start = std::min(start, i->first);
+                    end = std::max(end, i->second);
+                    i = mDirtyRanges.erase(i);
+                }
+                mDirtyRanges.insert(i, std::make_pair(start, end));
+
+                if (mDirtyRanges.size() > maxRanges)
+                {
+                    std::pair<size_t, size_t> bounds(mDirtyRanges.front().first, mDirtyRanges.back().second);
+                    mDirtyRanges.assign(1, bounds);
+                }
+                mShadowUpdated = true;
+            }
+
+            /** Uploads one range of the shadow buffer to the hardware buffer.
+            @remarks
+                Called by _updateFromShadow for every dirty range; render systems
+                override it when they have a cheaper path than lockImpl and memcpy.
+            */
+            virtual void uploadFromShadow(size_t offset, size_t length)
+            {
+                // Do this manually to avoid locking problems
+                const void *srcData = mShadowBuffer->lockImpl(
+                    offset, length, HBL_READ_ONLY);
+                // Lock with discard if the whole buffer is dirty, otherwise normal
+                LockOptions lockOpt;
+                if (offset == 0 && length == mSizeInBytes)
+                    lockOpt = HBL_DISCARD;
+                else
+                    lockOpt = HBL_NORMAL;
+                
+                void *destData = this->lockImpl(
+                    offset, length, lockOpt);
+                // Copy shadow to real
+                memcpy(destData, srcData, length);
+                this->unlockImpl();
+                mShadowBuffer->unlockImpl();
+            }
+
     public:
             /// Constructor, to be called by HardwareBufferManager only
             HardwareBuffer(Usage usage, bool systemMemory, bool useShadowBuffer) 
                 : mSizeInBytes(0), mUsage(usage), mIsLocked(false), mLockStart(0), mLockSize(0), mSystemMemory(systemMemory),
                 mUseShadowBuffer(useShadowBuffer), mShadowBuffer(NULL), mShadowUpdated(false), 
-                mSuppressHardwareUpdate(false) 
+                mSuppressHardwareUpdate(false), mLockRangeDirty(false) 
             {
                 // If use shadow buffer, upgrade to WRITE_ONLY on hardware side
                 if (useShadowBuffer && usage == HBU_DYNAMIC)
@@ -215,8 +276,9 @@ namespace Ogre {
                     if (options != HBL_READ_ONLY)
                     {
                         // we have to assume a read / write lock so we use the shadow buffer
-                        // and tag for sync on unlock()
-                        mShadowUpdated = true;
+                        // and tag the locked range for sync on unlock(), unless markDirty
+                        // narrows it down first
+                        mLockRangeDirty = true;
                     }
 
                     ret = mShadowBuffer->lock(offset, length, options, uploadOpt);
@@ -226,6 +288,8 @@ namespace Ogre {
                     // Lock the real buffer if there is no shadow buffer 
                     ret = lockImpl(offset, length, options);
                     mIsLocked = true;
+                    if (!mSystemMemory)
+                        _notifyLocked(length, options);
                 }
                 mLockStart = offset;
                 mLockSize = length;
@@ -261,6 +325,11 @@ namespace Ogre {
                 if (mUseShadowBuffer && mShadowBuffer->isLocked())
                 {
                     mShadowBuffer->unlock();
+                    if (mLockRangeDirty)
+                    {
+                        addDirtyRange(mLockStart, mLockSize);
+                        mLockRangeDirty = false;
+                    }
                     // Potentially update the 'real' buffer from the shadow buffer
                     _updateFromShadow();
                 }
@@ -273,6 +342,29 @@ namespace Ogre {
 
             }
 
+            /** Marks part of a shadow-buffered lock as modified.
+            @remarks
+                By default unlocking a shadow-buffered buffer uploads the whole
+                locked range. If only a few regions of a large lock were written,
+                call this for each of them before unlock() and only those regions
+                are uploaded. Has no effect on buffers without a shadow buffer.
+                A length of 0 marks nothing, so that nothing is uploaded.
+            @param offset The byte offset from the start of the buffer
+            @param length The size of the modified region, in bytes
+            */
+            void markDirty(size_t offset, size_t length)
+            {
+                assert(isLocked() && "Cannot mark a range dirty, the buffer is not locked!");
+                assert(offset + length <= mSizeInBytes && "Dirty range out of bounds!");
+
+                if (mUseShadowBuffer)
+                {
+                    mLockRangeDirty = false;
+                    if (length > 0)
+                        addDirtyRange(offset, length);
+                }
+            }
+
             /** Reads data from the buffer and places it in the memory pointed to by pDest.
             @param offset The byte offset from the start of the buffer to read
             @param length The size of the area to read, in bytes
@@ -326,26 +418,80 @@ namespace Ogre {
             {
                 if (mUseShadowBuffer && mShadowUpdated && !mSuppressHardwareUpdate)
                 {
-                    // Do this manually to avoid locking problems
-                    const void *srcData = mShadowBuffer->lockImpl(
-                        mLockStart, mLockSize, HBL_READ_ONLY);
-                    // Lock with discard if the whole buffer was locked, otherwise normal
-                    LockOptions lockOpt;
-                    if (mLockStart == 0 && mLockSize == mSizeInBytes)
-                        lockOpt = HBL_DISCARD;
-                    else
-                        lockOpt = HBL_NORMAL;
-                    
-                    void *destData = this->lockImpl(
-                        mLockStart, mLockSize, lockOpt);
-                    // Copy shadow to real
-                    memcpy(destData, srcData, mLockSize);
-                    this->unlockImpl();
-                    mShadowBuffer->unlockImpl();
+                    for (DirtyRangeList::iterator i = mDirtyRanges.begin(); i != mDirtyRanges.end(); ++i)
+                    {
+                        uploadFromShadow(i->first, i->second - i->first);
+                        _notifyLocked(i->second - i->first,
+                            i->second - i->first == mSizeInBytes ? HBL_DISCARD : HBL_NORMAL);
+                    }
+                    mDirtyRanges.clear();
                     mShadowUpdated = false;
                 }
             }
 
+            /** Counts an access to the memory of a hardware buffer in the lock statistics.
+            @remarks
+                Called by lock() for buffers without a shadow buffer, and for every
+                range uploaded from a shadow buffer.
+            */
+            static void _notifyLocked(size_t length, LockOptions options);
+            /** Gets the number of bytes of hardware buffers locked or uploaded from
+                shadow buffers, since startup. */
+            static size_t getTotalLockedBytes(void);
+            /** Gets the number of hardware buffer locks which may have waited for the
+                GPU to finish with the buffer (neither HBL_DISCARD nor HBL_NO_OVERWRITE),
+                since startup. */
+            static size_t getTotalLockStalls(void);
+
+            /** Measures the time the CPU is blocked in a lock of a hardware buffer.
+            @remarks
+                Render systems place one on the stack around the driver calls of
+                lockImpl which may wait for the GPU, such as mapping a buffer which
+                is still being read. The time is reported to _notifyLockWait when it
+                goes out of scope. Locks of system memory buffers are not timed.
+            */
+            class _OgreExport LockWaitTimer
+            {
+            public:
+                LockWaitTimer(const HardwareBuffer* buffer, size_t length, LockOptions options);
+                ~LockWaitTimer();
+            private:
+                const HardwareBuffer* mBuffer;
+                size_t mLength;
+                LockOptions mOptions;
+                unsigned long mStart;
+            };
+
+            /** Counts the time spent waiting in a lock of a hardware buffer.
+            @remarks
+                Waits of at least the lock wait threshold are reported to the lock
+                listener, if any.
+            */
+            static void _notifyLockWait(const HardwareBuffer* buffer, size_t length,
+                LockOptions options, unsigned long microseconds);
+            /** Gets the time spent waiting in locks of hardware buffers since startup,
+                in microseconds. */
+            static unsigned long getTotalLockWaitTime(void);
+            /** Gets the number of locks of hardware buffers which waited for at least
+                the lock wait threshold, since startup. */
+            static size_t getTotalLockWaits(void);
+            /** Sets the listener which is told about the locks which waited for at
+                least the lock wait threshold, or null for none. */
+            static void setLockListener(HardwareBufferLockListener* listener);
+            /// Gets the lock listener
+            static HardwareBufferLockListener* getLockListener(void);
+            /** Sets the time a lock has to wait before it is reported, in microseconds
+                (default 100). */
+            static void setLockWaitThreshold(unsigned long microseconds);
+            /// Gets the time a lock has to wait before it is reported, in microseconds
+            static unsigned long getLockWaitThreshold(void);
+
+            /** Sets a description of what created the buffer, such as the name of a
+                mesh or the subsystem, to tell whose locks wait for the GPU. */
+            virtual void setOwnerName(const String& name) { mOwnerName = name; }
+            /// Gets the description of what created the buffer
+            const String& getOwnerName(void) const { return mOwnerName; }
+
             /// Returns the size of this buffer in bytes
             size_t getSizeInBytes(void) const { return mSizeInBytes; }
             /// Returns the Usage flags with which this buffer was created
@@ -373,6 +519,28 @@ namespace Ogre {
     /** @} */
     /** @} */
 
+    /** Listener which is told about the locks of hardware buffers which blocked
+        the CPU while the GPU finished with the buffer.
+    @remarks
+        Frequent waits on the same buffer suggest locking it with HBL_DISCARD or
+        HBL_NO_OVERWRITE, or cycling between several buffers.
+    @see HardwareBuffer::setLockListener
+    */
+    class _OgreExport HardwareBufferLockListener
+    {
+    public:
+        virtual ~HardwareBufferLockListener() {}
+        /** Called after a lock waited for at least the lock wait threshold.
+        @param buffer The locked buffer, see HardwareBuffer::getOwnerName
+        @param length The number of bytes locked
+        @param options The lock options
+        @param microseconds The time spent waiting
+        @note Called from the thread which locked the buffer.
+        */
+        virtual void lockWaited(const HardwareBuffer* buffer, size_t length,
+            HardwareBuffer::LockOptions options, unsigned long microseconds) = 0;
+    };
+
     /** Locking helper. Guaranteed unlocking even in case of exception. */
     template <typename T> struct HardwareBufferLockGuard
     {
@@ -216,6 +216,62 @@ namespace Ogre {
             const HardwareVertexBufferSharedPtr& source, 
             HardwareBuffer::Usage usage, bool useShadowBuffer);
 
+        /** Struct holding details of an idle staging buffer. */
+        struct StagingBufferEntry
+        {
+            HardwareBuffer* buffer;
+            /// Number of frames elapsed since the buffer was released.
+            size_t idleFrames;
+        };
+        /// Map from size to idle staging buffers, sizes are powers of two.
+        typedef multimap<size_t, StagingBufferEntry>::type FreeStagingBufferMap;
+        /// Map of current available staging buffers.
+        FreeStagingBufferMap mFreeStagingBuffers;
+        /// Total size of the buffers in mFreeStagingBuffers.
+        size_t mFreeStagingBufferBytes;
+        /// Maximum total size of the idle staging buffers kept.
+        size_t mStagingBufferBudget;
+        /// Size of the smallest staging buffers.
+        static const size_t STAGING_BUFFER_MIN_SIZE;
+        /// Number of frames to wait before destroying an idle staging buffer.
+        static const size_t STAGING_BUFFER_EXPIRED_FRAME_THRESHOLD;
+        OGRE_MUTEX(mStagingBuffersMutex);
+
+        /** Creates a staging buffer, may be overridden by certain rendering APIs.
+        @remarks
+            The default buffer lives in system memory.
+        */
+        virtual HardwareBuffer* createStagingBufferImpl(size_t sizeInBytes);
+
+        /// Map from first element to number of elements of the free ranges of an arena.
+        typedef map<size_t, size_t>::type FreeRangeMap;
+        /** Struct holding the shared buffers of a vertex sub-allocation arena. */
+        struct VertexArena : public BufferAlloc
+        {
+            /// One buffer per source of the vertex format.
+            vector<HardwareVertexBufferSharedPtr>::type buffers;
+            /// Number of vertices in each buffer.
+            size_t capacity;
+            FreeRangeMap freeRanges;
+        };
+        /** Struct holding the shared buffer of an index sub-allocation arena. */
+        struct IndexArena : public BufferAlloc
+        {
+            HardwareIndexBufferSharedPtr buffer;
+            /// Number of indexes in the buffer.
+            size_t capacity;
+            FreeRangeMap freeRanges;
+        };
+        /// Usage, shadow buffer flag and vertex sizes or index type which arenas must match.
+        typedef vector<size_t>::type ArenaKey;
+        typedef multimap<ArenaKey, VertexArena*>::type VertexArenaMap;
+        typedef multimap<ArenaKey, IndexArena*>::type IndexArenaMap;
+        VertexArenaMap mVertexArenas;
+        IndexArenaMap mIndexArenas;
+        /// Size of the buffers of newly created arenas.
+        size_t mArenaSize;
+        OGRE_MUTEX(mArenasMutex);
+
     public:
         HardwareBufferManagerBase();
         virtual ~HardwareBufferManagerBase();
@@ -371,6 +427,87 @@ namespace Ogre {
         */
         virtual void touchVertexBufferCopy(const HardwareVertexBufferSharedPtr& bufferCopy);
 
+        /** Allocates a buffer to stage data through.
+        @remarks
+            Used by rendering APIs when transferring data to or from buffers which
+            can't be accessed directly, e.g. when locking a static buffer. Staging
+            buffers are pooled by size, so frequent locks and bulk loading don't create
+            and destroy buffers over and over. Released buffers are kept for a few
+            hundred frames, within the budget set by setStagingBufferBudget.
+        @param sizeInBytes
+            The minimum size of the buffer, it is rounded up to a power of two.
+        @return
+            A buffer no other user has access to until it is given back with
+            releaseStagingBuffer.
+        */
+        virtual HardwareBuffer* allocateStagingBuffer(size_t sizeInBytes);
+
+        /** Gives back a buffer allocated with allocateStagingBuffer, for others to use.
+        @remarks
+            The buffer must be unlocked. It is destroyed if keeping it would exceed the
+            staging buffer budget.
+        */
+        virtual void releaseStagingBuffer(HardwareBuffer* buffer);
+
+        /** Sets the maximum total size of the idle staging buffers kept for reuse.
+        @remarks
+            Staging buffers in use don't count, releasing them beyond the budget
+            destroys them. Defaults to 16MB.
+        */
+        virtual void setStagingBufferBudget(size_t sizeInBytes);
+
+        /** Gets the maximum total size of the idle staging buffers kept for reuse. */
+        virtual size_t getStagingBufferBudget(void) const { return mStagingBufferBudget; }
+
+        /** Sub-allocates the vertex buffers of a VertexData from buffers shared
+            with other vertex data of the same format.
+        @remarks
+            Small meshes each owning their own buffers cost a buffer switch per
+            draw. Instead, this binds shared arena buffers, one per source, and sets
+            vertexStart to the vertices reserved for this data; render systems then
+            draw them with a base vertex. The vertex declaration and vertexCount
+            must already be set and the binding must be empty; sources must be
+            numbered from 0 without gaps. The data must be written with
+            HardwareBuffer::writeData at offset vertexStart * vertex size, the
+            shared buffers must never be locked with HBL_DISCARD. The vertices are
+            given back when the VertexData is destroyed.
+        @param vertexData
+            The vertex data to set up.
+        @param usage
+            The usage of the shared buffers, data is only shared between vertex
+            data with the same usage.
+        @param useShadowBuffer
+            Whether the shared buffers have shadow buffers.
+        @return
+            false if the vertex data is too large to share an arena, in which
+            case the caller should create its own buffers as usual.
+        */
+        virtual bool subAllocateVertexData(VertexData* vertexData,
+            HardwareBuffer::Usage usage, bool useShadowBuffer = false);
+
+        /** Sub-allocates the index buffer of an IndexData from a buffer shared
+            with other index data of the same type.
+        @remarks
+            As subAllocateVertexData, indexStart is set to the indexes reserved
+            for this data, indexCount must already be set.
+        */
+        virtual bool subAllocateIndexData(IndexData* indexData, HardwareIndexBuffer::IndexType itype,
+            HardwareBuffer::Usage usage, bool useShadowBuffer = false);
+
+        /** Sets the size of the buffers of new sub-allocation arenas.
+        @remarks
+            Only data up to a quarter of this size is sub-allocated. Defaults to 4MB.
+        */
+        virtual void setSubAllocationArenaSize(size_t sizeInBytes);
+
+        /** Gets the size of the buffers of new sub-allocation arenas. */
+        virtual size_t getSubAllocationArenaSize(void) const { return mArenaSize; }
+
+        /// Gives back the vertices reserved by subAllocateVertexData; is called by VertexData.
+        virtual void _freeSubAllocatedVertexData(VertexData* vertexData);
+        /// Gives back the indexes reserved by subAllocateIndexData; is called by IndexData.
+        virtual void _freeSubAllocatedIndexData(IndexData* indexData);
+
         /** Free all unused vertex buffer copies.
         @remarks
             This method free all temporary vertex buffers that not in used.
@@ -521,6 +658,58 @@ namespace Ogre {
             mImpl->touchVertexBufferCopy(bufferCopy);
         }
 
+        /** @copydoc HardwareBufferManagerBase::allocateStagingBuffer */
+        virtual HardwareBuffer* allocateStagingBuffer(size_t sizeInBytes)
+        {
+            return mImpl->allocateStagingBuffer(sizeInBytes);
+        }
+        /** @copydoc HardwareBufferManagerBase::releaseStagingBuffer */
+        virtual void releaseStagingBuffer(HardwareBuffer* buffer)
+        {
+            mImpl->releaseStagingBuffer(buffer);
+        }
+        /** @copydoc HardwareBufferManagerBase::setStagingBufferBudget */
+        virtual void setStagingBufferBudget(size_t sizeInBytes)
+        {
+            mImpl->setStagingBufferBudget(sizeInBytes);
+        }
+        /** @copydoc HardwareBufferManagerBase::getStagingBufferBudget */
+        virtual size_t getStagingBufferBudget(void) const
+        {
+            return mImpl->getStagingBufferBudget();
+        }
+        /** @copydoc HardwareBufferManagerBase::subAllocateVertexData */
+        virtual bool subAllocateVertexData(VertexData* vertexData,
+            HardwareBuffer::Usage usage, bool useShadowBuffer = false)
+        {
+            return mImpl->subAllocateVertexData(vertexData, usage, useShadowBuffer);
+        }
+        /** @copydoc HardwareBufferManagerBase::subAllocateIndexData */
+        virtual bool subAllocateIndexData(IndexData* indexData, HardwareIndexBuffer::IndexType itype,
+            HardwareBuffer::Usage usage, bool useShadowBuffer = false)
+        {
+            return mImpl->subAllocateIndexData(indexData, itype, usage, useShadowBuffer);
+        }
+        /** @copydoc HardwareBufferManagerBase::setSubAllocationArenaSize */
+        virtual void setSubAllocationArenaSize(size_t sizeInBytes)
+        {
+            mImpl->setSubAllocationArenaSize(sizeInBytes);
+        }
+        /** @copydoc HardwareBufferManagerBase::getSubAllocationArenaSize */
+        virtual size_t getSubAllocationArenaSize(void) const
+        {
+            return mImpl->getSubAllocationArenaSize();
+        }
+        /** @copydoc HardwareBufferManagerBase::_freeSubAllocatedVertexData */
+        virtual void _freeSubAllocatedVertexData(VertexData* vertexData)
+        {
+            mImpl->_freeSubAllocatedVertexData(vertexData);
+        }
+        /** @copydoc HardwareBufferManagerBase::_freeSubAllocatedIndexData */
+        virtual void _freeSubAllocatedIndexData(IndexData* indexData)
+        {
+            mImpl->_freeSubAllocatedIndexData(indexData);
+        }
         /** @copydoc HardwareBufferManagerBase::_freeUnusedBufferCopies */
         virtual void _freeUnusedBufferCopies(void)
         {
@@ -152,7 +152,13 @@ namespace Ogre {
         VET_UINT1 = 24,
         VET_UINT2 = 25,
         VET_UINT3 = 26,
-        VET_UINT4 = 27
+        VET_UINT4 = 27,
+        /// 16-bit floats, expanded to float by the GPU
+        VET_HALF2 = 28,
+        VET_HALF4 = 29,
+        /// signed shorts mapped to [-1, 1] by the GPU
+        VET_SHORT2_NORM = 30,
+        VET_SHORT4_NORM = 31
     };
 
     /** This class declares the usage of a single vertex buffer as a component
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgrePrerequisites.h"
 #include "OgreCommon.h"
 #include "OgrePixelFormat.h"
+#include "OgreDataStream.h"
 
 namespace Ogre {
     /** \addtogroup Core
@@ -296,6 +297,25 @@ namespace Ogre {
         */
         Image & load(DataStreamPtr& stream, const String& type = BLANKSTRING );
 
+        /** Loads several images, decoding them in parallel.
+            @remarks
+                Streams which are not in memory are read one after the other by
+                the calling thread, since archives need not support reading from
+                several threads at once. The images are then decoded on the
+                workers of the WorkQueue of Root, or one after the other if there
+                is no Root. This is useful for the faces of a cube map kept in
+                separate files, or for the slices of a texture array.
+            @param
+                images Receives one image per stream, appended in the order of
+                the streams.
+            @param
+                streams The source data of each image.
+            @param
+                type The type of the images, see load.
+        */
+        static void loadParallel(vector<Image>::type& images,
+            const vector<DataStreamPtr>::type& streams, const String& type = BLANKSTRING);
+
         /** Utility method to combine 2 separate images into this one, with the first
         image source supplying the RGB channels, and the second image supplying the 
         alpha channel (as luminance or separate alpha). 
@@ -453,19 +473,39 @@ namespace Ogre {
             FILTER_BILINEAR,
             FILTER_BOX,
             FILTER_TRIANGLE,
-            FILTER_BICUBIC
+            FILTER_BICUBIC,
+            FILTER_LANCZOS,
+            FILTER_KAISER
         };
         /** Scale a 1D, 2D or 3D image volume. 
             @param  src         PixelBox containing the source pointer, dimensions and format
             @param  dst         PixelBox containing the destination pointer, dimensions and format
             @param  filter      Which filter to use
             @remarks    This function can do pixel format conversion in the process.
+            @par
+                Apart from FILTER_NEAREST, 1D and 2D images are resampled with
+                separable filters, with the rows spread over the threads of the
+                Root's WorkQueue if there is one. FILTER_BOX, FILTER_TRIANGLE,
+                FILTER_BICUBIC (Catmull-Rom), FILTER_LANCZOS (3 lobes) and
+                FILTER_KAISER (windowed sinc) widen as the image shrinks, so
+                they average every source pixel, while FILTER_LINEAR and
+                FILTER_BILINEAR only sample the nearest four. 3D images are
+                resampled trilinearly with all of these.
             @note   dst and src can point to the same PixelBox object without any problem
         */
         static void scale(const PixelBox &src, const PixelBox &dst, Filter filter = FILTER_BILINEAR);
         
         /** Resize a 2D image, applying the appropriate filter. */
         void resize(ushort width, ushort height, Filter filter = FILTER_BILINEAR);
+
+        /** Generate a full chain of mipmaps from the top level of each face.
+            @remarks
+                Any existing mipmaps are replaced. Each level is scaled down from
+                the one above it with Image::scale, so the image must not be
+                compressed.
+            @param  filter      Which filter to use, FILTER_BOX averages 2x2 blocks
+        */
+        void generateMipmaps(Filter filter = FILTER_BOX);
         
         /// Static function to calculate size in bytes from the number of mipmaps, faces and the dimensions
         static size_t calculateSize(size_t mipmaps, size_t faces, uint32 width, uint32 height, uint32 depth, PixelFormat format);
@@ -496,6 +536,8 @@ namespace Ogre {
 
         /// A bool to determine if we delete the buffer or the calling app does
         bool mAutoDelete;
+        /// The stream mBuffer points into, if a codec decoded the image in place
+        DataStreamPtr mBufferSource;
     };
 
     typedef vector<Image*>::type ImagePtrList;
@@ -68,6 +68,9 @@ namespace Ogre {
 
             PixelFormat format;
 
+            /// The stream the pixel data points into, if it was not copied out of it
+            DataStreamPtr source;
+
         public:
             String dataType() const
             {
@@ -80,6 +83,16 @@ namespace Ogre {
         {
             return "ImageData";
         }
+
+    protected:
+        /** Gets the next size bytes of a stream as decoded pixel data.
+        @remarks
+            Memory mapped files are not copied: the result points straight into
+            the mapping, which imgData->source keeps alive for the image. Other
+            streams are read into a new buffer.
+        */
+        static MemoryDataStreamPtr readPixelData(DataStreamPtr& stream, size_t size,
+            ImageData* imgData);
     };
 
     /** @} */
@@ -0,0 +1,75 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef _ImageCompressor_H__
+#define _ImageCompressor_H__
+
+#include "OgrePrerequisites.h"
+#include "OgrePixelFormat.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Image
+    *  @{
+    */
+    /** Encodes uncompressed pixel data to block compressed formats on the CPU.
+        @remarks
+            This lets textures be shipped in a plain format and compressed to
+            whatever the hardware supports when they are loaded, see
+            TextureManager::setCompressOnLoad. The encoders favour speed over
+            quality; content that can be compressed offline should be.
+        @par
+            Supported formats are PF_DXT1, PF_DXT3, PF_DXT5, PF_BC4_UNORM,
+            PF_BC5_UNORM, PF_ETC1_RGB8, PF_ETC2_RGB8 and PF_ETC2_RGBA8. DXT1 is
+            always encoded without punch-through alpha, and ETC2 blocks only use
+            the modes shared with ETC1.
+        @par
+            Rows of blocks are spread over the WorkQueue threads when a Root
+            exists.
+    */
+    class _OgreExport ImageCompressor
+    {
+    public:
+        /// Returns whether pixel data can be compressed to the given format
+        static bool isFormatSupported(PixelFormat format);
+
+        /** Compresses pixel data.
+        @param src The pixels to compress, in any uncompressed format.
+        @param dst The destination for the compressed blocks. Its format must be
+            supported by this class and its extents must match src. Blocks that
+            hang over the right or bottom edge repeat the last column or row.
+        */
+        static void compress(const PixelBox& src, const PixelBox& dst);
+    };
+    /** @} */
+    /** @} */
+
+} // namespace
+
+#endif
@@ -159,6 +159,9 @@ namespace Ogre
 
         void updateVisibility(void);
 
+        /// Returns true as soon as one instance is visible from currentCamera
+        bool hasVisibleInstances( Camera *currentCamera ) const;
+
         /** @see _defragmentBatch */
         void defragmentBatchNoCull( InstancedEntityVec &usedEntities, CustomParamsVec &usedParams );
 
@@ -298,6 +301,20 @@ namespace Ogre
         */
         virtual bool isStatic() const                       { return false; }
 
+        /** Called by the InstanceManager before the instances of this batch get culled and
+            written from a worker thread. Locks the buffers they're written to. Currently only
+            InstanceBatchHW & InstanceBatchHW_VTF support it. @see InstanceManager::setParallelUpdates
+        */
+        virtual void _prepareConcurrentInstanceUpdate(void) {}
+
+        /** Culls the instances against the current camera and writes the visible ones to the
+            buffers locked by _prepareConcurrentInstanceUpdate. May run in a worker thread.
+        */
+        virtual void _concurrentInstanceUpdate(void)        {}
+
+        /** Unlocks the buffers once _concurrentInstanceUpdate is done. */
+        virtual void _finishConcurrentInstanceUpdate(void)  {}
+
         /** Returns a pointer to a new InstancedEntity ready to use
             Note it's actually preallocated, so no memory allocation happens at
             this point.
@@ -61,6 +61,14 @@ namespace Ogre
     class _OgreExport InstanceBatchHW : public InstanceBatch
     {
         bool    mKeepStatic;
+        /// True while this batch carries the packed draw of its material (@see InstanceManager::setPackedIndirectDraws)
+        bool    mPackedLeader;
+        /// True while the instances wait to be written in parallel (@see InstanceManager::setParallelUpdates)
+        bool    mUpdatePending;
+        /// The instance buffer, locked for _concurrentInstanceUpdate
+        float   *mConcurrentDest;
+        /// Culls the instances while static (@see InstanceManager::setGpuCulling)
+        GpuDrawCuller *mGpuCuller;
 
         void setupVertices( const SubMesh* baseSubMesh );
         void setupIndices( const SubMesh* baseSubMesh );
@@ -70,6 +78,13 @@ namespace Ogre
 
         size_t updateVertexBuffer( Camera *currentCamera );
 
+        /** Writes the transforms & custom params of the instances visible from currentCamera,
+            and their world bounding spheres to pBounds if not null */
+        size_t writeVisibleInstances( float *pDest, Camera *currentCamera, Vector4 *pBounds = 0 );
+
+        /// Uploads all the instances in the scene to the GPU culler, returns false if there's none
+        bool setupGpuCulling(void);
+
     public:
         InstanceBatchHW( InstanceManager *creator, MeshPtr &meshReference, const MaterialPtr &material,
                             size_t instancesPerBatch, const Mesh::IndexMap *indexToBoneMap,
@@ -97,6 +112,13 @@ namespace Ogre
 
         bool isStatic() const                       { return mKeepStatic; }
 
+        /** @see InstanceBatch::_prepareConcurrentInstanceUpdate */
+        void _prepareConcurrentInstanceUpdate(void);
+        /** @see InstanceBatch::_concurrentInstanceUpdate */
+        void _concurrentInstanceUpdate(void);
+        /** @see InstanceBatch::_finishConcurrentInstanceUpdate */
+        void _finishConcurrentInstanceUpdate(void);
+
         //Renderable overloads
         void getWorldTransforms( Matrix4* xform ) const;
         unsigned short getNumWorldTransforms(void) const;
@@ -104,6 +126,19 @@ namespace Ogre
         /** Overloaded to avoid updating skeletons (which we don't support), check visibility on a
             per unit basis and finally updated the vertex buffer */
         virtual void _updateRenderQueue( RenderQueue* queue );
+
+        /** Overloaded so the batch leading a packed draw hands out the shared instance buffer
+            and one indirect command per packed batch. @see InstanceManager::setPackedIndirectDraws
+            Also writes the instances of every batch waiting for a parallel update, the first
+            time one of them is rendered. @see InstanceManager::setParallelUpdates
+        */
+        virtual void getRenderOperation( RenderOperation& op );
+
+        /** Called by the InstanceManager when building a packed draw. Writes the instances of this
+            batch that are visible from the current camera.
+        @return Number of instances written
+        */
+        size_t _writePackedInstances( float *pDest )    { return writeVisibleInstances( pDest, mCurrentCamera ); }
     };
 }
 
@@ -60,10 +60,30 @@ namespace Ogre
     {
     protected:
         bool    mKeepStatic;
+        /// True while the instances wait to be written in parallel (@see InstanceManager::setParallelUpdates)
+        bool    mUpdatePending;
+        /// mInstanceVertexBuffer, locked for _concurrentInstanceUpdate
+        float   *mConcurrentDest;
 
         //Pointer to the buffer containing the per instance vertex data
         HardwareVertexBufferSharedPtr mInstanceVertexBuffer;
 
+        /// Names of the skeleton animations baked into the vertex texture
+        StringVector mBakedAnimations;
+        /// Sampling rate used when baking the animations
+        Real mBakedFramesPerSecond;
+        /// Where each baked animation lives in the vertex texture
+        struct BakedAnimation
+        {
+            size_t firstSlot;
+            size_t numFrames;
+            Real length;
+        };
+        typedef vector<BakedAnimation>::type BakedAnimationVec;
+        BakedAnimationVec mBakedAnimationRanges;
+        /// Total number of baked frames (sum of all the ranges)
+        size_t mNumBakedFrames;
+
         void setupVertices( const SubMesh* baseSubMesh );
         void setupIndices( const SubMesh* baseSubMesh );
 
@@ -78,6 +98,12 @@ namespace Ogre
         */
         virtual size_t updateInstanceDataBuffer(bool isFirstTime, Camera* currentCamera);
 
+        /** Writes the texture offsets (and world transforms when using bone matrix lookup)
+            of the instances to the locked per instance vertex buffer
+        @return The number of instances written
+        */
+        size_t writeInstanceData( float *thisVec, Camera *currentCamera );
+
 
         virtual bool checkSubMeshCompatibility( const SubMesh* baseSubMesh );
 
@@ -87,6 +113,22 @@ namespace Ogre
         size_t updateVertexTexture( Camera *currentCamera );
 
         virtual bool matricesTogetherPerRow() const { return true; }
+
+        /** @copydoc BaseInstanceBatchVTF::getNumTextureTransformSlots
+            Overloaded to reserve one slot per baked frame when baking animations */
+        virtual size_t getNumTextureTransformSlots() const;
+
+        /** Samples every frame of the baked animations and writes the resulting bone transforms
+            into the vertex texture. Called once, when the batch is built */
+        void bakeAnimations();
+
+        /** Returns the vertex texture slot holding the frame the given instance is playing */
+        size_t getBakedFrameSlot( const InstancedEntity *entity ) const;
+
+        /** @copydoc BaseInstanceBatchVTF::generateInstancedEntity
+            Overloaded so that instances of a baked batch share a single skeleton instance,
+            since the skeleton is never evaluated on the CPU */
+        virtual InstancedEntity* generateInstancedEntity( size_t num );
     public:
         InstanceBatchHW_VTF( InstanceManager *creator, MeshPtr &meshReference, const MaterialPtr &material,
                             size_t instancesPerBatch, const Mesh::IndexMap *indexToBoneMap,
@@ -103,6 +145,41 @@ namespace Ogre
 
         bool isStatic() const { return mKeepStatic; }
 
+        /** @see InstanceBatch::_prepareConcurrentInstanceUpdate
+            Only batches with baked animations are updated in parallel */
+        void _prepareConcurrentInstanceUpdate(void);
+        /** @see InstanceBatch::_concurrentInstanceUpdate */
+        void _concurrentInstanceUpdate(void);
+        /** @see InstanceBatch::_finishConcurrentInstanceUpdate */
+        void _finishConcurrentInstanceUpdate(void);
+
+        /** Overloaded to write the instances of every batch waiting for a parallel update,
+            the first time one of them is rendered. @see InstanceManager::setParallelUpdates */
+        void getRenderOperation( RenderOperation& op );
+
+        /** Pre-bakes every frame of the given skeleton animations into the vertex texture.
+        @remarks
+            Bone transforms are then never calculated on the CPU: each instance only carries
+            the baked animation it plays and its time position (see InstancedEntity::setBakedAnimation)
+            which are turned into a texture offset and sent in the per instance vertex data, along
+            with the instance's world transform. Existing bone matrix lookup shaders can be used
+            unmodified, since baking implies setBoneMatrixLookup( true ).
+        @par
+            Approx VRAM usage is 16 bytes * 3 * numBones * sum( animLength * framesPerSecond + 1 );
+            all frames must fit in a single 4096x4096 texture.
+            This value needs to be set before adding any instanced entities
+        @param animationNames Animations of the mesh's skeleton to bake. Their position in this
+            list is the index passed to InstancedEntity::setBakedAnimation. Empty to disable baking
+        @param framesPerSecond Sampling rate. Playback snaps to the nearest baked frame
+        */
+        void setBakedAnimations( const StringVector &animationNames, Real framesPerSecond );
+
+        /// Returns the animations baked into the vertex texture
+        const StringVector& getBakedAnimations() const { return mBakedAnimations; }
+
+        /// Tells whether skeleton animations are baked into the vertex texture
+        bool useBakedAnimations() const { return !mBakedAnimations.empty(); }
+
         /** Overloaded to visibility on a per unit basis and finally updated the vertex texture */
         virtual void _updateRenderQueue( RenderQueue* queue );
     };
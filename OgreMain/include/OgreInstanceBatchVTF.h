@@ -124,6 +124,10 @@ namespace Ogre
         /** Creates the vertex texture */
         void createVertexTexture( const SubMesh* baseSubMesh );
 
+        /** Number of sets of bone transforms the vertex texture has room for (one per instance,
+            or one per unique animation when using bone matrix lookup) */
+        virtual size_t getNumTextureTransformSlots() const;
+
         /** Creates 2 TEXCOORD semantics that will be used to sample the vertex texture */
         virtual void createVertexSemantics( VertexData *thisVertexData, VertexData *baseVertexData,
                                     const HWBoneIdxVec &hwBoneIdx, const HWBoneWgtVec &hwBoneWgt) = 0;
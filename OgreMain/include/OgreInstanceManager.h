@@ -100,6 +100,34 @@ namespace Ogre
 
         typedef map<String, BatchSettings>::type    BatchSettingsMap;
 
+        /// All batches of one material drawn with a single multi-draw indirect call
+        struct PackedDraw
+        {
+            InstanceBatchVec    batches;        //Batches registered during the current render queue fill
+            const Camera        *camera;        //Camera & frame of the current render queue fill
+            unsigned long       frameNumber;
+            bool                built;          //True once the instances & commands were written
+            VertexData          *vertexData;    //Batch geometry + the shared instance buffer
+            size_t              capacity;       //Number of instances the shared buffer holds
+            vector<IndirectDrawCommand>::type commands;
+
+            PackedDraw() : camera( 0 ), frameNumber( 0 ), built( false ),
+                vertexData( 0 ), capacity( 0 ) {}
+        };
+
+        typedef map<String, PackedDraw>::type       PackedDrawMap;
+
+        /// Batches whose instances get written in parallel (@see setParallelUpdates)
+        struct PendingUpdates
+        {
+            InstanceBatchVec    batches;        //Batches registered during the current render queue fill
+            const Camera        *camera;        //Camera & frame of the current render queue fill
+            unsigned long       frameNumber;
+            bool                built;          //True once the instances were written
+
+            PendingUpdates() : camera( 0 ), frameNumber( 0 ), built( false ) {}
+        };
+
         const String            mName;                  //Not the name of the mesh
         MeshPtr                 mMeshReference;
         InstanceBatchMap        mInstanceBatches;
@@ -118,8 +146,18 @@ namespace Ogre
         SceneManager*           mSceneManager;
 
         size_t                  mMaxLookupTableInstances;
+        StringVector            mBakedAnimations;       //Animations baked by HWInstancingVTF batches
+        Real                    mBakedFramesPerSecond;
         unsigned char           mNumCustomParams;       //Number of custom params per instance.
 
+        bool                    mPackedIndirectDraws;
+        PackedDrawMap           mPackedDraws;           //map[materialName] = PackedDraw
+
+        bool                    mParallelUpdates;
+        PendingUpdates          mPendingUpdates;
+
+        bool                    mGpuCulling;
+
         /** Finds a batch with at least one free instanced entity we can use.
             If none found, creates one.
         */
@@ -152,6 +190,17 @@ namespace Ogre
         */
         void unshareVertices(const Ogre::MeshPtr &mesh);
 
+        /** Forgets the batches registered for packed draws and parallel updates. Must be called
+            whenever batches get destroyed or moved around, to avoid dangling pointers
+        */
+        void resetPackedDraws(void);
+
+        /** Writes the visible instances of every batch registered to the packed draw into its
+            shared instance buffer, and builds the indirect commands to render them.
+        */
+        void buildPackedDraw( PackedDraw &packedDraw, const String &materialName,
+                              const RenderOperation &batchOperation );
+
     public:
         InstanceManager( const String &customName, SceneManager *sceneManager,
                          const String &meshName, const String &groupName,
@@ -180,6 +229,16 @@ namespace Ogre
         */
         void setMaxLookupTableInstances( size_t maxLookupTableInstances );
 
+        /** Bakes the given skeleton animations into the vertex texture of HWInstancingVTF batches,
+            so bone transforms are no longer calculated on the CPU. Instances select what they play
+            through InstancedEntity::setBakedAnimation. Ignored by other techniques.
+            Raises an exception if trying to change it after creating the first InstancedEntity.
+        @see InstanceBatchHW_VTF::setBakedAnimations
+        @param animationNames Animations to bake. Empty to disable baking
+        @param framesPerSecond Sampling rate of the baked animations
+        */
+        void setBakedAnimations( const StringVector &animationNames, Real framesPerSecond );
+
         /** Sets the number of custom parameters per instance. Some techniques (i.e. HWInstancingBasic)
             support this, but not all of them. They also may have limitations to the max number. All
             instancing implementations assume each instance param is a Vector4 (4 floats).
@@ -203,6 +262,64 @@ namespace Ogre
         unsigned char getNumCustomParams() const
         { return mNumCustomParams; }
 
+        /** Packs all dynamic batches sharing a material into a single multi-draw indirect
+            submission, instead of issuing one draw call per batch.
+        @remarks
+            Every frame, the batches only cull their instances. The first batch with visible
+            instances then writes the instances of all the others to one shared buffer, and
+            renders them all with one call. The per batch render queue ID & priority of the
+            others are thus ignored.
+            Static batches (@see setBatchesAsStaticAndUpdate) are still drawn individually.
+            Only HWInstancingBasic supports this, and it needs RSC_MULTI_DRAW_INDIRECT. When
+            the render system lacks it, this mode stays disabled.
+        @param enabled True to pack batches. Default: false
+        */
+        void setPackedIndirectDraws( bool enabled );
+
+        /// Returns true if batches are being packed. @see setPackedIndirectDraws
+        bool getPackedIndirectDraws() const
+        { return mPackedIndirectDraws; }
+
+        /** Culls and writes the instance data of all visible dynamic batches in parallel,
+            across the threads of the Root's WorkQueue.
+        @remarks
+            During the render queue fill, the batches only check whether any of their instances
+            is visible. The first time one of them is rendered, the buffers of all those queued
+            are locked, the per instance culling and writing is spread over the workers, and the
+            buffers are unlocked again. Packed draws (@see setPackedIndirectDraws) write their
+            batches in parallel too.
+            HWInstancingBasic batches support this, and HWInstancingVTF batches with baked
+            animations (@see InstanceBatchHW_VTF::setBakedAnimations); the others are updated
+            as usual. Per instance buffers are created HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, so
+            render systems which map such buffers persistently hand them out directly.
+        @param enabled True to update batches in parallel. Default: false
+        */
+        void setParallelUpdates( bool enabled )
+        { mParallelUpdates = enabled; resetPackedDraws(); }
+
+        /// Returns true if batches are updated in parallel. @see setParallelUpdates
+        bool getParallelUpdates() const
+        { return mParallelUpdates; }
+
+        /** Culls the instances of static batches on the GPU.
+        @remarks
+            When batches are made static (@see setBatchesAsStaticAndUpdate), the bounds and data
+            of their instances are uploaded once. Every frame, a compute pass then culls the
+            instances of each visible batch against the camera and the occlusion culler of the
+            scene manager, packs the visible ones into the instance buffer and writes the
+            instance count of the indirect draw, so the CPU work per batch doesn't depend on
+            its number of instances. Static batches are otherwise never culled per instance.
+            Only HWInstancingBasic supports this. Where the render system can't create a
+            GpuDrawCuller, static batches are drawn as usual.
+            Takes effect the next time the batches are made static.
+        @param enabled True to cull static batches on the GPU. Default: false
+        */
+        void setGpuCulling( bool enabled );
+
+        /// Returns true if static batches are culled on the GPU. @see setGpuCulling
+        bool getGpuCulling() const
+        { return mGpuCulling; }
+
         /** @return Instancing technique this manager was created for. Can't be changed after creation */
         InstancingTechnique getInstancingTechnique() const
         { return mInstancingTechnique; }
@@ -293,6 +410,27 @@ namespace Ogre
         /** Called by SceneManager when we told it we have at least one dirty batch */
         void _updateDirtyBatches(void);
 
+        /** Called by a batch with visible instances while packing draws. Registers it to the
+            packed draw of its material for the current render queue fill.
+        @return True if the batch is the first one registered, and thus renders all of them
+        */
+        bool _addPackedBatch( InstanceBatchHW *batch, const Camera *camera );
+
+        /** Called by the batch leading a packed draw to turn its render operation into the
+            packed one. The instances are written the first time it's called in each fill.
+        */
+        void _setupPackedRenderOperation( InstanceBatchHW *leader, RenderOperation &op );
+
+        /** Called by a batch with visible instances while updating in parallel. Registers it
+            for the current render queue fill. @see setParallelUpdates
+        */
+        void _addPendingBatch( InstanceBatch *batch, const Camera *camera );
+
+        /** Called by a registered batch when rendered. Writes the instances of all the batches
+            registered during the fill in parallel, the first time it's called in each fill.
+        */
+        void _updatePendingBatches(void);
+
         typedef ConstMapIterator<InstanceBatchMap> InstanceBatchMapIterator;
         typedef ConstVectorIterator<InstanceBatchVec> InstanceBatchIterator;
 
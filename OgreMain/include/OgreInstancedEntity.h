@@ -98,6 +98,11 @@ namespace Ogre
             as arranged in the vertex texture */
         uint16 mTransformLookupNumber;
 
+        /** Used when the batch bakes its animations into the vertex texture. Tells which
+            baked animation is played, and at which time position */
+        uint16 mBakedAnimationIndex;
+        Real mBakedAnimationTime;
+
         /// Stores the master when we're the slave, store our slaves when we're the master
         typedef vector<InstancedEntity*>::type InstancedEntityVec;
         InstancedEntityVec mSharingPartners;
@@ -226,6 +231,20 @@ namespace Ogre
         /** Sets the transformation look up number */
         void setTransformLookupNumber(uint16 num) { mTransformLookupNumber = num;}
 
+        /** Selects the animation played by this instance when its batch bakes skeleton animations
+            into the vertex texture (@see InstanceBatchHW_VTF::setBakedAnimations). The skeleton is
+            not evaluated on the CPU; regular animation states are ignored in that mode.
+        @param animationIndex Index of the animation in the list given to the batch
+        @param timePosition Time position in the animation. Wraps around the animation's length
+        */
+        void setBakedAnimation(uint16 animationIndex, Real timePosition)
+        { mBakedAnimationIndex = animationIndex; mBakedAnimationTime = timePosition; }
+
+        /** @see setBakedAnimation */
+        uint16 getBakedAnimationIndex() const { return mBakedAnimationIndex; }
+        /** @see setBakedAnimation */
+        Real getBakedAnimationTime() const { return mBakedAnimationTime; }
+
         /** Retrieve the position */
         const Vector3& getPosition() const { return mPosition; }
         /** Set the position or the offset from the parent node if a parent node exists */ 
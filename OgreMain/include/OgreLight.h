@@ -433,6 +433,20 @@ namespace Ogre {
         Real getShadowFarDistance(void) const;
         Real getShadowFarDistanceSquared(void) const;
 
+        /** Sets how many frames apart the shadow textures of this light are rendered
+            (default 1, every frame).
+        @remarks
+            In between, the shadow textures keep what they were rendered with,
+            including the shadow camera, so the shadows of moving casters, or of
+            a moving light, lag behind by up to this many frames. Textures are
+            rendered again straight away when they are assigned to another light
+            or viewed from another camera. See also
+            SceneManager::setShadowTextureUpdateBudget.
+        */
+        void setShadowUpdateInterval(uint32 frames) { mShadowUpdateInterval = std::max(frames, 1u); }
+        /** Gets how many frames apart the shadow textures of this light are rendered. */
+        uint32 getShadowUpdateInterval(void) const { return mShadowUpdateInterval; }
+
         /** Set the near clip plane distance to be used by the shadow camera, if
             this light casts texture shadows.
         @param nearClip
@@ -575,6 +589,7 @@ namespace Ogre {
         
         Real mShadowNearClipDist;
         Real mShadowFarClipDist;
+        uint32 mShadowUpdateInterval;
 
 
         mutable Vector3 mDerivedPosition;
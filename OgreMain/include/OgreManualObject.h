@@ -279,6 +279,37 @@ namespace Ogre
         */
         virtual ManualObjectSection* end(void);
 
+        /** Start an update of a part of the object which writes its vertices and
+            indices straight into the hardware buffers.
+        @remarks
+            This is a faster alternative to beginUpdate for sections rebuilt often
+            with many vertices, since nothing is staged per vertex. The vertices must
+            be written in the layout of the vertex declaration of the section, which
+            was set up by the first definition with begin() and can be found through
+            ManualObjectSection::getRenderOperation. The buffers are reused when they
+            are large enough, otherwise they are recreated with at least the estimated
+            counts (see estimateVertexCount), so sections updated this way should
+            generally be dynamic (see setDynamic).
+        @par
+            Nothing but the writes to the returned pointers may happen until
+            endDirectUpdate is called.
+        @param sectionIndex The index of the section to update
+        @param vertexCount The number of vertices which will be written
+        @param indexCount The number of indices which will be written, 0 for
+            non indexed geometry
+        @param indices If indexCount is not 0, receives where to write the indices,
+            as uint32 if ManualObjectSection::get32BitIndices is true, otherwise as uint16
+        @return Where to write the vertices, or NULL if vertexCount is 0
+        */
+        virtual void* beginDirectUpdate(size_t sectionIndex, size_t vertexCount,
+            size_t indexCount = 0, void** indices = 0);
+
+        /** Finish an update started with beginDirectUpdate.
+        @param bounds The bounds of the vertices which were written, merged into
+            the bounds of the object
+        */
+        virtual void endDirectUpdate(const AxisAlignedBox& bounds);
+
         /** Alter the material for a subsection of this object after it has been
             specified.
         @remarks
@@ -488,6 +519,8 @@ namespace Ogre
         ManualObjectSection* mCurrentSection;
         /// Are we updating?
         bool mCurrentUpdating;
+        /// Are we updating with beginDirectUpdate?
+        bool mCurrentDirect;
         /// Temporary vertex structure
         struct TempVertex
         {
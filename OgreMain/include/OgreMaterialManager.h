@@ -117,6 +117,43 @@ namespace Ogre {
 			virtual bool beforeIlluminationPassesCleared(Technique* technique) { return false; }
         };
 
+        /// A material / scheme combination whose programs should be compiled upfront
+        struct WarmUpEntry
+        {
+            String material;
+            String group;
+            String scheme;
+
+            WarmUpEntry() {}
+            WarmUpEntry(const String& mat, const String& grp, const String& sch)
+                : material(mat), group(grp), scheme(sch) {}
+
+            bool operator<(const WarmUpEntry& rhs) const
+            {
+                if (scheme != rhs.scheme)
+                    return scheme < rhs.scheme;
+                if (group != rhs.group)
+                    return group < rhs.group;
+                return material < rhs.material;
+            }
+        };
+        typedef vector<WarmUpEntry>::type WarmUpList;
+
+        /** Listener notified about the progress of a warm-up.
+        @see MaterialManager::warmUp
+        */
+        class WarmUpListener
+        {
+        public:
+            virtual ~WarmUpListener() { }
+            /** Called after the programs of an entry were compiled.
+            @param entry The entry which was processed
+            @param done The number of entries processed so far, including this one
+            @param total The number of entries in the warm-up
+            */
+            virtual void warmUpProgress(const WarmUpEntry& entry, size_t done, size_t total) = 0;
+        };
+
     protected:
 
         /// Default Texture filtering - minification
@@ -157,6 +194,28 @@ namespace Ogre {
         typedef map<String, ListenerList>::type ListenerMap;
         ListenerMap mListenerMap;
 
+        /// An incremental warm-up being processed by _updateWarmUp
+        struct PendingWarmUp
+        {
+            WarmUpList entries;
+            size_t next;
+            WarmUpListener* listener;
+        };
+        typedef deque<PendingWarmUp>::type PendingWarmUpList;
+        PendingWarmUpList mPendingWarmUps;
+        /// Time in ms _updateWarmUp may spend per call
+        unsigned long mWarmUpTimeBudget;
+        /// Whether a warm-up is currently compiling, so it is not recorded
+        bool mWarmingUp;
+        /// Whether lazily compiled materials are recorded into the manifest
+        bool mRecordWarmUpManifest;
+        typedef set<WarmUpEntry>::type WarmUpEntrySet;
+        WarmUpEntrySet mRecordedWarmUps;
+        OGRE_MUTEX(mWarmUpMutex);
+
+        /// Compile the programs of a single entry, returns false if the material was not found
+        bool warmUpEntry(const WarmUpEntry& entry);
+
     public:
         /// Default material scheme
         static String DEFAULT_SCHEME_NAME;
@@ -296,6 +355,75 @@ namespace Ogre {
 		/// Internal method for sorting out illumination passes for a scheme
 		virtual void _notifyBeforeIlluminationPassesCleared(Technique* mat);
 
+        /** Compile every program needed to render the given materials in the
+            given schemes upfront, instead of lazily on first use.
+        @remarks
+            For each entry the material is loaded, the active scheme switched to
+            the entry's scheme and the best technique of every LOD looked up. This
+            gives scheme listeners (e.g. the RTSS technique resolver) the chance to
+            generate their techniques, whose programs are then loaded as well.
+            The active scheme is restored afterwards. An empty scheme means
+            the default scheme.
+        @param entries The material / scheme combinations to compile
+        @param listener Optional listener notified after each entry
+        */
+        void warmUp(const WarmUpList& entries, WarmUpListener* listener = 0);
+
+        /** Queue a warm-up to be processed incrementally at the end of each
+            frame, spending at most the warm-up time budget per frame.
+        @see MaterialManager::warmUp, MaterialManager::setWarmUpTimeBudget
+        */
+        void queueWarmUp(const WarmUpList& entries, WarmUpListener* listener = 0);
+
+        /** Sets the time in milliseconds queued warm-ups may spend per frame.
+        @remarks
+            At least one entry is processed per frame, so a large material can
+            exceed the budget. 0 processes all queued entries at once.
+            The default is 5ms.
+        */
+        void setWarmUpTimeBudget(unsigned long ms) { mWarmUpTimeBudget = ms; }
+        /// Gets the time in milliseconds queued warm-ups may spend per frame
+        unsigned long getWarmUpTimeBudget() const { return mWarmUpTimeBudget; }
+
+        /// Gets the number of queued warm-up entries which were not processed yet
+        size_t getPendingWarmUpCount() const;
+
+        /// Internal method processing queued warm-ups, called by Root at frame end
+        void _updateWarmUp();
+
+        /** Sets whether materials and schemes compiled lazily at runtime are recorded.
+        @remarks
+            While enabled, every material loaded and every technique requested for
+            a scheme the material does not define outside of a warm-up is recorded.
+            Save the recording with saveWarmUpManifest and pass it to warmUp on the
+            next run to avoid compiling these programs while rendering.
+        */
+        void setWarmUpManifestRecording(bool enabled) { mRecordWarmUpManifest = enabled; }
+        /// Gets whether lazily compiled materials are recorded
+        bool getWarmUpManifestRecording() const { return mRecordWarmUpManifest; }
+
+        /// Gets the entries recorded so far
+        WarmUpList getRecordedWarmUpList() const;
+
+        /// Clears the entries recorded so far
+        void clearRecordedWarmUpList();
+
+        /** Saves the recorded entries to a manifest file.
+        @remarks
+            The manifest is a text file with one tab separated
+            "scheme group material" entry per line.
+        */
+        void saveWarmUpManifest(const String& filename) const;
+
+        /** Reads a manifest written by saveWarmUpManifest.
+        @remarks
+            The returned entries can be passed to warmUp or queueWarmUp.
+        */
+        WarmUpList loadWarmUpManifest(const DataStreamPtr& stream) const;
+
+        /// Internal method recording a material compiled at runtime for the active scheme
+        void _notifyMaterialCompiledLazily(const Material* mat);
+
 
         /** Override standard Singleton retrieval.
         @remarks
@@ -197,9 +197,9 @@ namespace Ogre
     // in your allocators you might choose to create different policies per category
 
     // configurable category, for general malloc
-    // notice how we ignore the category here, you could specialise
-    template <MemoryCategory Cat> class CategorisedAllocPolicy : public NedPoolingPolicy{};
-    template <MemoryCategory Cat, size_t align = 0> class CategorisedAlignAllocPolicy : public NedPoolingAlignedPolicy<align>{};
+    // each category allocates from its own pools
+    template <MemoryCategory Cat> class CategorisedAllocPolicy : public NedPoolingCategorisedPolicy<Cat>{};
+    template <MemoryCategory Cat, size_t align = 0> class CategorisedAlignAllocPolicy : public NedPoolingAlignedPolicy<align, Cat>{};
 }
 
 #elif OGRE_MEMORY_ALLOCATOR == OGRE_MEMORY_ALLOCATOR_NED
@@ -244,6 +244,9 @@ namespace Ogre
 
 #endif
 
+#include "OgreMemoryFrameAlloc.h"
+#include "OgreMemorySmallObjectAlloc.h"
+
 namespace Ogre
 {
     // Useful shortcuts
@@ -265,6 +268,7 @@ namespace Ogre
     typedef AllocatedObject<ResourceAllocPolicy> ResourceAllocatedObject;
     typedef AllocatedObject<ScriptingAllocPolicy> ScriptingAllocatedObject;
     typedef AllocatedObject<RenderSysAllocPolicy> RenderSysAllocatedObject;
+    typedef AllocatedObject<SmallObjectAllocPolicy> SmallObjectAllocatedObject;
 
 
     // Per-class allocators defined here
@@ -319,6 +323,7 @@ namespace Ogre
     typedef SceneCtlAllocatedObject     LodAlloc;
     typedef GeneralAllocatedObject      FileSystemLayerAlloc;
     typedef GeneralAllocatedObject      StereoDriverAlloc;
+    typedef SmallObjectAllocatedObject  WorkQueueMessageAlloc;
 
     // Containers (by-value only)
     // Will  be of the form:
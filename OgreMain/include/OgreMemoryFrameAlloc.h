@@ -0,0 +1,122 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __MemoryFrameAlloc_H__
+#define __MemoryFrameAlloc_H__
+
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Memory
+    *  @{
+    */
+    /** Non-templated utility class holding the frame arena.
+    @remarks
+        Memory is handed out by bumping a pointer through large blocks, and
+        is only reclaimed all at once, when the last live allocation is 
+        freed or by _reset, which Root calls at the end of each frame. The 
+        blocks are kept for the next frame, so once the arena has grown to 
+        the size a frame needs no more system allocations are made.
+    @par
+        The arena is not thread safe, and belongs to the thread which first
+        uses it, normally the one calling Root::renderOneFrame, which also
+        resets it. In debug builds with thread support, using it from any
+        other thread, such as the WorkQueue tasks of a parallel update, fails
+        an assertion. Ownership is given up by _release.
+    */
+    class _OgreExport FrameAllocImpl
+    {
+    public:
+        static void* allocBytes(size_t count);
+        static void deallocBytes(void* ptr);
+
+        /** Makes all memory handed out since the last reset available again,
+            unless some of it is still in use.
+        @note Internal method, called by Root at the end of each frame.
+        */
+        static void _reset(void);
+
+        /** Frees all the blocks of the arena.
+        @note Internal method, called by Root on shutdown.
+        */
+        static void _release(void);
+
+        /// Gets the number of bytes handed out since the last reset
+        static size_t getBytesAllocated(void);
+    };
+
+    /** An allocation policy for use with STLAllocator, for memory which 
+        only lives until the end of the current frame.
+    @remarks
+        Memory isn't reclaimed when it is freed, but all at once when nothing 
+        allocated from the arena is in use any more, and at the latest at the
+        end of the frame (see Root::_fireFrameEnded). This makes it suitable 
+        for temporary containers which are rebuilt every frame and would 
+        otherwise make many small allocations. A container using this policy 
+        shouldn't be kept across the end of a frame, since the arena then 
+        keeps growing until it is freed, and the arena isn't thread safe, so 
+        it must only be used from the rendering thread, never from WorkQueue
+        tasks (see FrameAllocImpl).
+    @par
+        All allocations are aligned to 16 bytes.
+    */
+    class _OgreExport FrameAllocPolicy
+    {
+    public:
+        static inline void* allocateBytes(size_t count, 
+            const char* = 0, int = 0, const char* = 0)
+        {
+            return FrameAllocImpl::allocBytes(count);
+        }
+        static inline void deallocateBytes(void* ptr)
+        {
+            FrameAllocImpl::deallocBytes(ptr);
+        }
+        /// Get the maximum size of a single allocation
+        static inline size_t getMaxAllocationSize()
+        {
+            return std::numeric_limits<size_t>::max();
+        }
+
+    private:
+        // No instantiation
+        FrameAllocPolicy()
+        { }
+    };
+
+    /** @} */
+    /** @} */
+
+}// namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif // __MemoryFrameAlloc_H__
@@ -49,9 +49,15 @@ namespace Ogre
     public:
         static void* allocBytes(size_t count, 
             const char* file, int line, const char* func);
+        /// Allocates from the pools of the given category
+        static void* allocBytes(size_t count, MemoryCategory category,
+            const char* file, int line, const char* func);
         static void deallocBytes(void* ptr);
         static void* allocBytesAligned(size_t align, size_t count, 
             const char* file, int line, const char* func);
+        /// Allocates from the aligned pools of the given category
+        static void* allocBytesAligned(size_t align, size_t count, MemoryCategory category,
+            const char* file, int line, const char* func);
         static void deallocBytesAligned(size_t align, void* ptr);
 
     };
@@ -88,6 +94,34 @@ namespace Ogre
         { }
     };
 
+    /** As NedPoolingPolicy, but allocating from pools reserved for a memory
+        category, so that allocations of other categories don't fragment them.
+    */
+    template <MemoryCategory Cat>
+    class NedPoolingCategorisedPolicy
+    {
+    public:
+        static inline void* allocateBytes(size_t count, 
+            const char* file = 0, int line = 0, const char* func = 0)
+        {
+            return NedPoolingImpl::allocBytes(count, Cat, file, line, func);
+        }
+        static inline void deallocateBytes(void* ptr)
+        {
+            NedPoolingImpl::deallocBytes(ptr);
+        }
+        /// Get the maximum size of a single allocation
+        static inline size_t getMaxAllocationSize()
+        {
+            return std::numeric_limits<size_t>::max();
+        }
+
+    private:
+        // No instantiation
+        NedPoolingCategorisedPolicy()
+        { }
+    };
+
 
     /** An allocation policy for use with AllocatedObject and 
     STLAllocator, which aligns memory at a given boundary (which should be
@@ -99,9 +133,10 @@ namespace Ogre
         (http://nedprod.com/programs/portable/nedmalloc/index.html). 
     @note
         template parameter Alignment equal to zero means use default
-        platform dependent alignment.
+        platform dependent alignment. Allocations are made from the
+        pools of the memory category Cat.
     */
-    template <size_t Alignment = 0>
+    template <size_t Alignment = 0, MemoryCategory Cat = MEMCATEGORY_GENERAL>
     class NedPoolingAlignedPolicy
     {
     public:
@@ -112,7 +147,7 @@ namespace Ogre
         static inline void* allocateBytes(size_t count, 
             const char* file = 0, int line = 0, const char* func = 0)
         {
-            return NedPoolingImpl::allocBytesAligned(Alignment, count, file, line, func);
+            return NedPoolingImpl::allocBytesAligned(Alignment, count, Cat, file, line, func);
         }
 
         static inline void deallocateBytes(void* ptr)
@@ -0,0 +1,119 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __MemorySmallObjectAlloc_H__
+#define __MemorySmallObjectAlloc_H__
+
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Memory
+    *  @{
+    */
+    /** Non-templated utility class holding the small object caches.
+    @remarks
+        Each thread allocates from its own free lists, one per size class of
+        16 bytes up to MAX_SIZE, which it refills by carving blocks out of 
+        chunks taken from the general allocator. No lock is taken while a
+        thread allocates and frees its own blocks. A block freed by another
+        thread is queued to its owner under a lock, and taken back by the
+        owner the next time the free list of that size runs out.
+    @par
+        The cache of a thread which exits should be handed over with
+        _releaseThreadCache, so that the next thread needing one reuses it;
+        the DefaultWorkQueue worker threads do. Chunks go back to the general
+        allocator only when Root shuts down, see _freeCaches.
+    */
+    class _OgreExport SmallObjectAllocImpl
+    {
+    public:
+        /// Largest allocation served from the caches, bigger ones go to the general allocator
+        static const size_t MAX_SIZE = 256;
+
+        static void* allocBytes(size_t count, 
+            const char* file, int line, const char* func);
+        static void deallocBytes(void* ptr);
+
+        /** Hands the cache of the calling thread over to the next thread which
+            needs one.
+        @note Internal method, call it before a thread which allocated small 
+            objects exits. Blocks still in use stay valid.
+        */
+        static void _releaseThreadCache(void);
+
+        /** Frees the cache of the calling thread and the caches other threads
+            have released, with all their chunks.
+        @note Internal method, called by Root once the work queue is gone. No
+            block from these caches may still be in use. Caches still held by 
+            running threads are left alone.
+        */
+        static void _freeCaches(void);
+    };
+
+    /** An allocation policy for use with AllocatedObject, for small objects 
+        which are created and destroyed often, possibly by different threads.
+    @remarks
+        See SmallObjectAllocImpl. Allocations have the alignment of the general
+        allocator, up to 16 bytes.
+    */
+    class _OgreExport SmallObjectAllocPolicy
+    {
+    public:
+        static inline void* allocateBytes(size_t count, 
+            const char* file = 0, int line = 0, const char* func = 0)
+        {
+            return SmallObjectAllocImpl::allocBytes(count, file, line, func);
+        }
+        static inline void deallocateBytes(void* ptr)
+        {
+            SmallObjectAllocImpl::deallocBytes(ptr);
+        }
+        /// Get the maximum size of a single allocation
+        static inline size_t getMaxAllocationSize()
+        {
+            return std::numeric_limits<size_t>::max();
+        }
+
+    private:
+        // No instantiation
+        SmallObjectAllocPolicy()
+        { }
+    };
+
+    /** @} */
+    /** @} */
+
+}// namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif // __MemorySmallObjectAlloc_H__
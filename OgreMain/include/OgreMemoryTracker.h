@@ -66,18 +66,46 @@ namespace Ogre
     *  @{
     */
 
-#if OGRE_MEMORY_TRACKER
-
     /** This class tracks the allocations and deallocations made, and
         is able to report memory statistics and leaks.
     @note
-        This class is only available in debug builds.
+        Tracking individual allocations is only available in debug builds,
+        the statistics per memory category are always kept.
     */
     class _OgreExport MemoryTracker
     {
+    public:
+        /// Statistics of the memory currently allocated in a MemoryCategory
+        struct CategoryStats
+        {
+            /// Bytes allocated, including the allocator's rounding
+            size_t bytes;
+            /// Number of allocations
+            size_t allocations;
+        };
+
+        /** Gets the statistics of the memory currently allocated in a category.
+        @remarks
+            These are kept by allocators which know the size and category of
+            freed memory, currently the nedmalloc pooling allocator; they are
+            zero with other allocators.
+        */
+        static CategoryStats getCategoryStats(MemoryCategory category);
+
+        /** Record an allocation in a category. Only to be called by the memory
+            management subsystem, with the same size as when deallocating.
+        */
+        static void _recordCategoryAlloc(MemoryCategory category, size_t sz);
+        /** Record the deallocation of memory in a category. */
+        static void _recordCategoryDealloc(MemoryCategory category, size_t sz);
+
+#if OGRE_MEMORY_TRACKER
     protected:
             OGRE_AUTO_MUTEX;
 
+        /// Maximum number of frames of the call stacks of sampled allocations
+        static const size_t MAX_STACK_DEPTH = 16;
+
         // Allocation record
         struct Alloc
         {
@@ -86,10 +114,14 @@ namespace Ogre
             std::string filename;
             size_t line;
             std::string function;
+            /// Number of allocations this one stands for, the sampling rate when it was made
+            size_t weight;
+            void* stack[MAX_STACK_DEPTH];
+            size_t stackDepth;
 
-            Alloc() :bytes(0), line(0) {}
+            Alloc() :bytes(0), line(0), weight(1), stackDepth(0) {}
             Alloc(size_t sz, unsigned int p, const char* file, size_t ln, const char* func)
-                :bytes(sz), pool(p), line(ln)
+                :bytes(sz), pool(p), line(ln), weight(1), stackDepth(0)
             {
                 if (file)
                     filename = file;
@@ -108,12 +140,28 @@ namespace Ogre
         AllocationsByPool mAllocationsByPool;
         bool mRecordEnable;
 
+        size_t mSamplingRate;
+        std::string mSampleFileName;
+        unsigned long mSampleDumpInterval;
+        unsigned long mLastSampleDump;
+
+        /// Live sampled allocations sharing a call stack
+        struct SampleSite
+        {
+            const Alloc* alloc;
+            size_t bytes;
+            size_t count;
+        };
+
         void reportLeaks();
+        void writeSamples(std::ostream& os);
 
         // protected ctor
         MemoryTracker()
             : mLeakFileName("OgreLeaks.log"), mDumpToStdOut(true),
-            mTotalAllocations(0), mRecordEnable(true)
+            mTotalAllocations(0), mRecordEnable(true),
+            mSamplingRate(1), mSampleFileName("OgreMemorySamples.log"),
+            mSampleDumpInterval(0), mLastSampleDump(0)
         {
         }
     public:
@@ -141,11 +189,48 @@ namespace Ogre
 
         
 
-        /// Get the total amount of memory allocated currently.
+        /// Get the total amount of memory allocated currently, estimated when sampling.
         size_t getTotalMemoryAllocated() const;
-        /// Get the amount of memory allocated in a given pool
+        /// Get the amount of memory allocated in a given pool, estimated when sampling.
         size_t getMemoryAllocatedForPool(unsigned int pool) const;
 
+        /** Sets the tracker to record only one in a number of allocations.
+        @remarks
+            Recording every allocation takes a lock and a hash map insertion each
+            time, which is too slow for release builds. When sampling, each thread
+            counts its own allocations and only every Nth one is recorded, along
+            with its call stack; frees of allocations which weren't recorded are
+            filtered out without taking the lock. Sizes and leaks reported are then
+            statistical: each sample stands for N allocations. Best set once at
+            startup, before the allocations to watch are made.
+        @param rate
+            1 records every allocation, the default.
+        */
+        void setSamplingRate(size_t rate);
+        /// Gets the sampling rate, 1 when every allocation is recorded.
+        size_t getSamplingRate() const { return mSamplingRate; }
+
+        /** Sets the interval at which the live sampled allocations are dumped.
+        @remarks
+            Dumps are written to the sample report file, overwriting the previous
+            one, and list the live samples grouped by call stack, the largest
+            first. Useful to find leaks and allocation hot spots on long running
+            processes. 0, the default, disables periodic dumps.
+        @param seconds
+            Minimum number of seconds between dumps.
+        */
+        void setSampleDumpInterval(unsigned long seconds) { mSampleDumpInterval = seconds; }
+        /// Gets the interval at which the live sampled allocations are dumped.
+        unsigned long getSampleDumpInterval() const { return mSampleDumpInterval; }
+
+        /// Sets the name of the file sampled allocations are dumped to.
+        void setSampleReportFileName(const std::string& name) { mSampleFileName = name; }
+        /// Gets the name of the file sampled allocations are dumped to.
+        const std::string& getSampleReportFileName() const { return mSampleFileName; }
+
+        /// Dumps the live sampled allocations to the sample report file now.
+        void dumpSamples();
+
 
         /** Record an allocation that has been made. Only to be called by
             the memory management subsystem.
@@ -184,12 +269,9 @@ namespace Ogre
         /// Static utility method to get the memory tracker instance
         static MemoryTracker& get();
 
-
+#endif
     };
 
-
-
-#endif
     /** @} */
     /** @} */
 
@@ -155,6 +155,9 @@ namespace Ogre {
             unsigned short numBlendWeightsPerVertex, 
             IndexMap& blendIndexToBoneIndexMap,
             VertexData* targetVertexData);
+        /** Optimise the index order of one vertex data set and the SubMeshes which use it. */
+        void optimiseIndexOrder(VertexData* vertexData, const vector<SubMesh*>::type& subMeshes,
+            VertexBoneAssignmentList& boneAssignments, bool reorderVertices, bool overdraw);
 #if !OGRE_NO_MESHLOD
         const LodStrategy *mLodStrategy;
         bool mHasManualLodLevel;
@@ -170,6 +173,7 @@ namespace Ogre {
         HardwareBuffer::Usage mIndexBufferUsage;
         bool mVertexBufferShadowBuffer;
         bool mIndexBufferShadowBuffer;
+        bool mSubAllocateBuffers;
 
 
         bool mPreparedForShadowVolumes;
@@ -190,6 +194,28 @@ namespace Ogre {
         PoseList mPoseList;
         mutable bool mPosesIncludeNormals;
 
+        /// Whether the poses are also stored in textures, see setUsePoseTexture
+        bool mUsePoseTexture;
+
+        /// Hierarchy of the triangles for ray tests, see getBVH
+        MeshBVH* mBVH;
+        bool mAutoBuildBVH;
+        /// Whether the triangle clusters are built at load, see setAutoBuildClusters
+        bool mAutoBuildClusters;
+        /// The pose texture of a target, and the texture coordinates of each vertex in it
+        struct PoseTexture
+        {
+            TexturePtr texture;
+            HardwareVertexBufferSharedPtr texCoordBuffer;
+        };
+        typedef map<ushort, PoseTexture>::type PoseTextureMap;
+        PoseTextureMap mPoseTextures;
+
+        /// Stores the vertex offsets (and normals) of every pose in a texture per target
+        void buildPoseTextures(void);
+        /// Destroys the pose textures
+        void destroyPoseTextures(void);
+
 
         /** Loads the mesh from disk.  This call only performs IO, it
             does not parse the bytestream or check for any errors therein.
@@ -208,6 +234,15 @@ namespace Ogre {
         void unloadImpl(void);
         /// @copydoc Resource::calculateSize
         size_t calculateSize(void) const;
+        /// @copydoc Resource::calculateGpuSize
+        size_t calculateGpuSize(void) const;
+        /** Gets the sizes of the vertex and index buffers of the mesh, LOD levels
+            included, in CPU and GPU memory; shadow buffers count on the CPU side. */
+        void calculateBufferSizes(size_t& cpu, size_t& gpu) const;
+        /// Sets the owner name of the vertex buffers of some vertex data
+        static void setBufferOwnerName(VertexData* vertexData, const String& owner);
+        /// Gives sub-allocated vertex data buffers of its own, see setSubAllocateBuffers
+        void releaseSubAllocatedBuffers(void);
 
         void mergeAdjacentTexcoords( unsigned short finalTexCoordSet,
                                      unsigned short texCoordSetToDestroy, VertexData *vertexData );
@@ -574,6 +609,25 @@ namespace Ogre {
         bool isVertexBufferShadowed(void) const { return mVertexBufferShadowBuffer; }
         /** Gets whether or not this meshes index buffers are shadowed. */
         bool isIndexBufferShadowed(void) const { return mIndexBufferShadowBuffer; }
+        /** Sets whether the buffers of this Mesh are sub-allocated from buffers
+            shared with other meshes when loading.
+        @remarks
+            Small meshes then share a few large buffers, see
+            HardwareBufferManagerBase::subAllocateVertexData, saving buffer switches
+            when rendering many of them. It only takes effect after the Mesh has been
+            reloaded, and is ignored when meshes are prepared for shadow volumes.
+            Meshes with poses or vertex animation, and meshes whose edge list is
+            built later on, get vertex buffers of their own again.
+        @par
+            The vertex and index data of such meshes start at an offset within their
+            buffers, and the buffers must not be locked with HBL_DISCARD. Only enable
+            it for static meshes which aren't modified, animated in software or saved
+            again after loading. You usually enable it for whole resource groups
+            through MeshManager::setSubAllocateBuffers.
+        */
+        void setSubAllocateBuffers(bool subAllocate) { mSubAllocateBuffers = subAllocate; }
+        /** Gets whether the buffers of this Mesh are sub-allocated from shared buffers. */
+        bool getSubAllocateBuffers(void) const { return mSubAllocateBuffers; }
        
 
         /** Rationalises the passed in bone assignment list.
@@ -687,6 +741,23 @@ namespace Ogre {
         bool suggestTangentVectorBuildParams(VertexElementSemantic targetSemantic,
             unsigned short& outSourceCoordSet, unsigned short& outIndex);
 
+        /** Re-order the indexes and vertices of this mesh for faster rendering.
+        @remarks
+            The triangles of every triangle list, including generated LOD levels, are
+            first re-ordered for the post-transform vertex cache (see
+            IndexData::optimiseVertexCache). Clusters of triangles are then optionally
+            sorted to reduce overdraw, and the vertices re-ordered into the order the
+            indexes first use them, so that vertex fetches are sequential.
+        @par
+            Vertices are not re-ordered for vertex data used by morph or pose
+            animation, since those refer to vertices by position in the buffer, nor
+            once the mesh has been prepared for shadow volumes. Edge lists which were
+            already built are rebuilt.
+        @param overdraw Whether to sort triangle clusters to reduce overdraw
+        @param vertexFetch Whether to re-order vertices for fetch locality
+        */
+        void optimiseIndexOrder(bool overdraw = true, bool vertexFetch = true);
+
         /** Builds an edge list for this mesh, which can be used for generating a shadow volume
             among other things.
         */
@@ -756,6 +827,21 @@ namespace Ogre {
         static void prepareMatricesForVertexBlend(const Matrix4** blendMatrices,
             const Matrix4* boneMatrices, const IndexMap& indexMap);
 
+        /** Prepare dual quaternions for software indexed vertex blend.
+        @remarks
+            The dual quaternion counterpart of prepareMatricesForVertexBlend.
+        @param blendDualQuaternions
+            Pointer to an array of dual quaternion pointers to store
+            prepared results, which indexed by blend index.
+        @param boneDualQuaternions
+            Pointer to an array of dual quaternions to be used to blend,
+            which indexed by bone index.
+        @param indexMap
+            The index map used to translate blend index to bone index.
+        */
+        static void prepareDualQuaternionsForVertexBlend(const DualQuaternion** blendDualQuaternions,
+            const DualQuaternion* boneDualQuaternions, const IndexMap& indexMap);
+
         /** Performs a software indexed vertex blend, of the kind used for
             skeletal animation although it can be used for other purposes. 
         @remarks
@@ -784,6 +870,23 @@ namespace Ogre {
             const Matrix4* const* blendMatrices, size_t numMatrices,
             bool blendNormals);
 
+        /** Performs a software indexed vertex blend with dual quaternions.
+        @remarks
+            As the other softwareVertexBlend, but blending bone dual quaternions
+            rather than matrices, which keeps the volume of twisted joints.
+            Bone scaling is not applied.
+        @param blendDualQuaternions
+            Pointer to an array of dual quaternion pointers to be used to blend,
+            indexed by blend indices in the sourceVertexData
+        @param numDualQuaternions
+            Number of dual quaternions in the blendDualQuaternions, it might
+            be used as a hint for optimisation.
+        */
+        static void softwareVertexBlend(const VertexData* sourceVertexData, 
+            const VertexData* targetVertexData,
+            const DualQuaternion* const* blendDualQuaternions, size_t numDualQuaternions,
+            bool blendNormals);
+
         /** Performs a software vertex morph, of the kind used for
             morph animation although it can be used for other purposes. 
         @remarks
@@ -848,6 +951,49 @@ namespace Ogre {
         */
         bool getAutoBuildEdgeLists(void) const { return mAutoBuildEdgeLists; }
 
+        /** Gets the bounding volume hierarchy of the triangles of this mesh, used
+            for exact ray tests, building it if required.
+        @remarks
+            Building reads the vertex and index buffers, so they should have shadow
+            buffers or be readable, unless the hierarchy is built at load time (see
+            setAutoBuildBVH). The hierarchy is destroyed when the mesh is unloaded.
+        */
+        const MeshBVH* getBVH(void);
+        /** Builds the bounding volume hierarchy of the triangles of this mesh again. */
+        void buildBVH(void);
+        /** Destroys the bounding volume hierarchy of the triangles of this mesh. */
+        void freeBVH(void);
+        /** Returns whether the bounding volume hierarchy has been built. */
+        bool isBVHBuilt(void) const { return mBVH != 0; }
+        /** Sets whether the bounding volume hierarchy is built as soon as the mesh
+            is loaded, rather than by the first ray test (default false). */
+        void setAutoBuildBVH(bool autobuild) { mAutoBuildBVH = autobuild; }
+        /** Gets whether the bounding volume hierarchy is built as soon as the mesh
+            is loaded. */
+        bool getAutoBuildBVH(void) const { return mAutoBuildBVH; }
+
+        /** Splits the full detail triangle lists of all submeshes into clusters,
+            which entities cull separately, see SubMesh::clusters.
+        @remarks
+            Building reads the vertex and index buffers, so they should have shadow
+            buffers or be readable, unless the clusters are built at load time (see
+            setAutoBuildClusters). Clusters are saved with the mesh, so building
+            them once with the MeshUpgrader is cheaper. The triangle order should
+            be optimised first, see optimiseIndexOrder.
+        @param maxTriangles Most triangles in a cluster
+        */
+        void buildClusters(size_t maxTriangles = 128);
+        /** Removes the triangle clusters of all submeshes. */
+        void freeClusters(void);
+        /** Returns whether any submesh has triangle clusters. */
+        bool hasClusters(void) const;
+        /** Sets whether the triangle clusters are built as soon as the mesh is
+            loaded, if the file did not hold them (default false). */
+        void setAutoBuildClusters(bool autobuild) { mAutoBuildClusters = autobuild; }
+        /** Gets whether the triangle clusters are built as soon as the mesh is
+            loaded. */
+        bool getAutoBuildClusters(void) const { return mAutoBuildClusters; }
+
         /** Gets the type of vertex animation the shared vertex data of this mesh supports.
         */
         virtual VertexAnimationType getSharedVertexDataAnimationType(void) const;
@@ -957,6 +1103,37 @@ namespace Ogre {
         /** Get pose list. */
         const PoseList& getPoseList(void) const;
 
+        /** Sets whether the poses are also stored in floating point textures, so that
+            hardware pose animation isn't limited by the number of free vertex streams.
+        @remarks
+            Hardware pose animation normally binds each active pose as an extra vertex
+            stream, which limits it to a handful of poses at once. When enabled, the
+            offsets of all the poses of each target are stored in a PF_FLOAT32_RGBA texture
+            named getPoseTextureName(target). Entities then bind a single float2 texture
+            coordinate set per vertex instead (its location in the texture) and the
+            animation_parametric auto constants hold, for each active pose, the V offset
+            of the pose in the texture and its influence: 2 poses per float4, as
+            (offset0, influence0, offset1, influence1). The vertex program samples
+            texture coordinate + (0, offset) and accumulates the offsets weighted by the
+            influences; when the poses include normals, these are at V + 0.5.
+        @par
+            The vertex program still has to declare includes_pose_animation, and the
+            material must reference the pose texture by name in a vertex texture unit,
+            so this must be enabled before the material is loaded. Poses created or
+            modified afterwards are only taken into account after enabling it again.
+            The number of poses * ceil(vertexCount / 4096) (twice that with normals)
+            must not exceed 4096 per target.
+        */
+        void setUsePoseTexture(bool usePoseTexture);
+        /** Gets whether the poses are also stored in floating point textures. */
+        bool getUsePoseTexture(void) const { return mUsePoseTexture; }
+        /** Gets the name of the pose texture of the given target (0 for the shared
+            geometry, 1+ for the dedicated geometry of submesh index + 1). */
+        String getPoseTextureName(ushort target) const;
+        /** Internal method returning the buffer holding the pose texture coordinates
+            of each vertex of the given target, or null if there is none. */
+        HardwareVertexBufferSharedPtr _getPoseTextureCoordBuffer(ushort target) const;
+
         /** Get LOD strategy used by this mesh. */
         const LodStrategy *getLodStrategy() const;
 #if !OGRE_NO_MESHLOD
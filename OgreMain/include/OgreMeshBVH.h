@@ -0,0 +1,167 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __MeshBVH_H__
+#define __MeshBVH_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreVector3.h"
+#include "OgreAxisAlignedBox.h"
+#include "OgreRay.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Resources
+    *  @{
+    */
+    /** Bounding volume hierarchy of the triangles of a Mesh, for exact ray tests.
+    @remarks
+        The positions of the full detail triangle lists of the mesh are copied
+        when the hierarchy is built, so no hardware buffer is locked by ray
+        tests. Triangles are hit from both sides.
+    @par
+        The hierarchy of a mesh is built by Mesh::getBVH. Animated entities
+        keep a copy which is refitted to their animated positions, see
+        Entity::getBVH.
+    */
+    class _OgreExport MeshBVH : public GeometryAllocatedObject
+    {
+    public:
+        /// The nearest triangle hit by a ray
+        struct Hit
+        {
+            /// Distance along the ray, or infinity when nothing was hit
+            Real distance;
+            /// Index of the submesh the triangle belongs to
+            ushort subMesh;
+            /// Index of the triangle in the index data of the submesh
+            uint32 triangle;
+            /// Weights of the three corners of the triangle at the hit point
+            Vector3 barycentric;
+        };
+
+        /** Builds the hierarchy of the triangle lists of a mesh, at full detail. */
+        MeshBVH(const Mesh* mesh);
+        ~MeshBVH();
+
+        /** Finds the nearest triangle hit by a ray in the space of the mesh.
+        @param ray The ray
+        @param hit Receives the nearest hit
+        @param maxDistance Triangles further along the ray are ignored
+        @return Whether a triangle was hit
+        */
+        bool intersects(const Ray& ray, Hit& hit, Real maxDistance = Math::POS_INFINITY) const;
+
+        /** Finds the nearest triangle hit by each of several rays.
+        @remarks
+            The hierarchy is walked once for all the rays, each node being tested
+            against the rays which reached its parent, so rays close to each
+            other share most of the traversal.
+        @param rays The rays, in the space of the mesh
+        @param numRays The number of rays
+        @param hits Receives the nearest hit of each ray
+        @return The number of rays which hit a triangle
+        */
+        size_t intersects(const Ray* rays, size_t numRays, Hit* hits) const;
+
+        /** Updates the positions from the vertex data an entity renders with,
+            and refits the bounds of the hierarchy to them.
+        @remarks
+            The structure of the hierarchy is kept, so it stays valid but becomes
+            slower to traverse as the animation moves away from the original pose.
+            Only software animation is reflected; hardware skinned or morphed
+            entities should request software animation, see
+            Entity::addSoftwareAnimationRequest.
+        */
+        void refit(Entity* entity);
+
+        /** Refits the bounds of the hierarchy after the positions were changed
+            through getPositions. */
+        void refit(void);
+
+        /** Gets the positions of the vertices, shared vertex data first then the
+            vertex data of each submesh in turn. */
+        vector<Vector3>::type& getPositions(void) { return mPositions; }
+        /** Gets the number of triangles. */
+        size_t getNumTriangles(void) const { return mTriangles.size(); }
+        /** Gets the number of nodes of the hierarchy. */
+        size_t getNumNodes(void) const { return mNodes.size(); }
+        /** Gets the bounds of all the triangles. */
+        AxisAlignedBox getBounds(void) const;
+
+    protected:
+        struct Node
+        {
+            Vector3 min, max;
+            /// First triangle of a leaf, or second child of an inner node (the first follows it)
+            uint32 index;
+            /// Number of triangles of a leaf, 0 for an inner node
+            uint32 count;
+        };
+        struct Triangle
+        {
+            uint32 v[3];
+            ushort subMesh;
+            uint32 index;
+        };
+        /// Where the positions of a vertex data start in mPositions
+        struct VertexSource
+        {
+            /// Submesh the vertex data belongs to, or -1 for the shared vertex data
+            int subMesh;
+            uint32 start;
+            size_t count;
+        };
+
+        vector<Node>::type mNodes;
+        vector<Triangle>::type mTriangles;
+        vector<Vector3>::type mPositions;
+        vector<VertexSource>::type mVertexSources;
+
+        /// Builds the subtree of the triangles mTriangles[order[begin, end)]
+        void build(uint32 begin, uint32 end, vector<uint32>::type& order,
+            const vector<Vector3>::type& centres);
+        void refitNode(uint32 node);
+        /// Tests a ray against a node, returning the distance it enters the node
+        bool intersects(const Node& node, const Ray& ray, const Vector3& invDir, Real maxDistance,
+            Real& distance) const;
+        /// Tests a ray against a triangle, returning the distance and the weights of corners 1 and 2
+        bool intersects(const Ray& ray, const Triangle& tri, Real& t, Real& u, Real& v) const;
+        /// Tests the rays active[begin, begin + count) against a subtree
+        void intersectsPacket(uint32 node, const Ray* rays, const Vector3* invDirs,
+            vector<uint32>::type& active, size_t begin, size_t count, Hit* hits) const;
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
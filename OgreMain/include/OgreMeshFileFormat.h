@@ -208,6 +208,14 @@ namespace Ogre {
             // unsigned short submesh_index;
             // float extremes [n_extremes][3];
 
+            // Optional submesh triangle clusters, see SubMesh::clusters
+            M_SUBMESH_CLUSTERS = 0xF000,
+            // unsigned short submesh_index;
+            // repeat for each cluster:
+                // unsigned int indexStart, indexCount
+                // float centre[3], radius
+                // float coneAxis[3], coneCos, coneSin
+
     /* Version 1.2 of the .mesh format (deprecated)
     enum MeshChunkID {
         M_HEADER                = 0x1000,
@@ -383,6 +383,16 @@ namespace Ogre {
         /** Retrieves whether all Meshes should prepare themselves for shadow volumes. */
         bool getPrepareAllMeshesForShadowVolumes(void);
 
+        /** Sets whether meshes of a resource group have their buffers sub-allocated
+            from buffers shared with other meshes.
+        @remarks
+            Worth it for groups of many small static meshes, see
+            Mesh::setSubAllocateBuffers. Affects meshes created after this call.
+        */
+        void setSubAllocateBuffers(const String& groupName, bool subAllocate);
+        /** Gets whether meshes of a resource group have their buffers sub-allocated. */
+        bool getSubAllocateBuffers(const String& groupName) const;
+
         /** Override standard Singleton retrieval.
         @remarks
         Why do we do this? Well, it's because the Singleton
@@ -494,6 +504,9 @@ namespace Ogre {
         void loadManualCurvedIllusionPlane(Mesh* pMesh, MeshBuildParams& params);
 
         bool mPrepAllMeshesForShadowVolumes;
+
+        /// Resource groups whose meshes have their buffers sub-allocated
+        set<String>::type mSubAllocatedGroups;
     
         //the factor by which the bounding box of an entity is padded   
         Real mBoundsPaddingFactor;
@@ -112,6 +112,8 @@ namespace Ogre {
         virtual void writePoseKeyframePoseRef(const VertexPoseKeyFrame::PoseRef& poseRef);
         virtual void writeExtremes(const Mesh *pMesh);
         virtual void writeSubMeshExtremes(unsigned short idx, const SubMesh* s);
+        virtual void writeClusters(const Mesh* pMesh);
+        virtual void writeSubMeshClusters(unsigned short idx, const SubMesh* s);
 
         virtual size_t calcMeshSize(const Mesh* pMesh);
         virtual size_t calcSubMeshSize(const SubMesh* pSub);
@@ -140,6 +142,8 @@ namespace Ogre {
         virtual size_t calcBoundsInfoSize(const Mesh* pMesh);
         virtual size_t calcExtremesSize(const Mesh* pMesh);
         virtual size_t calcSubMeshExtremesSize(unsigned short idx, const SubMesh* s);
+        virtual size_t calcClustersSize(const Mesh* pMesh);
+        virtual size_t calcSubMeshClustersSize(const SubMesh* s);
 
         virtual void readTextureLayer(DataStreamPtr& stream, Mesh* pMesh, MaterialPtr& pMat);
         virtual void readSubMeshNameTable(DataStreamPtr& stream, Mesh* pMesh);
@@ -151,6 +155,14 @@ namespace Ogre {
         virtual void readGeometryVertexDeclaration(DataStreamPtr& stream, Mesh* pMesh, VertexData* dest);
         virtual void readGeometryVertexElement(DataStreamPtr& stream, Mesh* pMesh, VertexData* dest);
         virtual void readGeometryVertexBuffer(DataStreamPtr& stream, Mesh* pMesh, VertexData* dest);
+        /// Whether the buffers of a mesh being read are sub-allocated from shared buffers
+        bool subAllocateBuffers(Mesh* pMesh);
+        /** Skip over the next count bytes of a stream held in memory and return
+            them, so they can be written to a hardware buffer without staging.
+            Returns 0 without reading if the stream isn't in memory or the data
+            needs its endianness flipping.
+        */
+        const void* readInPlace(DataStreamPtr& stream, size_t count);
 
         virtual void readSkeletonLink(DataStreamPtr& stream, Mesh* pMesh, MeshSerializerListener *listener);
         virtual void readMeshBoneAssignment(DataStreamPtr& stream, Mesh* pMesh);
@@ -173,6 +185,7 @@ namespace Ogre {
         virtual void readMorphKeyFrame(DataStreamPtr& stream, VertexAnimationTrack* track);
         virtual void readPoseKeyFrame(DataStreamPtr& stream, VertexAnimationTrack* track);
         virtual void readExtremes(DataStreamPtr& stream, Mesh *pMesh);
+        virtual void readClusters(DataStreamPtr& stream, Mesh *pMesh);
 
 
         /// Flip an entire vertex buffer from little endian
@@ -219,6 +232,9 @@ namespace Ogre {
 #endif
         virtual void readMeshLodLevel(DataStreamPtr& stream, Mesh* pMesh);
         virtual void enableValidation();
+        // Clusters are newer than this format
+        virtual void writeClusters(const Mesh*) {}
+        virtual size_t calcClustersSize(const Mesh*) { return 0; }
     };
 
     /** Class for providing backwards-compatibility for loading version 1.41 of the .mesh format. 
@@ -138,6 +138,10 @@ namespace Ogre {
         uint32 mVisibilityFlags;
         /// Cached world AABB of this object
         mutable AxisAlignedBox mWorldAABB;
+        /// Local AABB mWorldAABB was derived from
+        mutable AxisAlignedBox mWorldAABBSource;
+        /// Transform version of the parent node mWorldAABB was derived with, 0 if out of date
+        mutable unsigned long mWorldAABBVersion;
         // Cached world bounding sphere
         mutable Sphere mWorldBoundingSphere;
         /// World space AABB of this object's dark cap
@@ -164,7 +168,9 @@ namespace Ogre {
         /// Default visibility flags
         static uint32 msDefaultVisibilityFlags;
 
-
+        /** Marks the cached world AABB out of date, for subclasses which write
+            mWorldAABB themselves. */
+        void invalidateWorldBoundingBox(void) const { mWorldAABBVersion = 0; }
 
     public:
         /// Constructor
@@ -264,7 +270,11 @@ namespace Ogre {
         */
         virtual Real getBoundingRadius(void) const = 0;
 
-        /** Retrieves the axis-aligned bounding box for this object in world coordinates. */
+        /** Retrieves the axis-aligned bounding box for this object in world coordinates.
+        @param derive Whether to update the box from the local one first. It is
+            only transformed again if the local box or the transform of the
+            parent node changed since the last update.
+        */
         virtual const AxisAlignedBox& getWorldBoundingBox(bool derive = false) const;
         /** Retrieves the worldspace bounding sphere for this object. */
         virtual const Sphere& getWorldBoundingSphere(bool derive = false) const;
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgreMatrix4.h"
 #include "OgreRenderable.h"
 #include "OgreUserObjectBindings.h"
+#include "Threading/OgreThreadHeaders.h"
 #include "OgreHeaderPrefix.h"
 
 namespace Ogre {
@@ -218,6 +219,8 @@ namespace Ogre {
         /// Cached derived transform as a 4x4 matrix
         mutable Matrix4 mCachedTransform;
         mutable bool mCachedTransformOutOfDate;
+        /// Incremented each time mCachedTransform is recomputed
+        mutable unsigned long mTransformVersion;
 
         /** Node listener - only one allowed (no list) for size & performance reasons. */
         Listener* mListener;
@@ -225,6 +228,12 @@ namespace Ogre {
         typedef vector<Node*>::type QueuedUpdates;
         static QueuedUpdates msQueuedUpdates;
 
+        typedef vector<const Node*>::type DeferredListenerNodes;
+        /// Nodes whose Listener::nodeUpdated call is waiting to be made
+        static DeferredListenerNodes msDeferredListenerNodes;
+        static bool msDeferListenerCallbacks;
+        OGRE_STATIC_MUTEX(msDeferredListenerMutex);
+
         DebugRenderable* mDebug;
 
         /// User objects binding.
@@ -638,6 +647,13 @@ namespace Ogre {
         */
         virtual const Matrix4& _getFullTransform(void) const;
 
+        /** Gets a number which changes each time the full transformation matrix
+            is recomputed, so that values derived from it can be cached.
+        @remarks
+            Call _getFullTransform first, the number is only updated by it.
+        */
+        unsigned long _getTransformVersion(void) const { return mTransformVersion; }
+
         /** Internal method to update the Node.
         @note
             Updates this node and any relevant children to incorporate transforms etc.
@@ -652,6 +668,35 @@ namespace Ogre {
         */
         virtual void _update(bool updateChildren, bool parentHasChanged);
 
+        /// List of children together with the parentHasChanged flag to update them with,
+        /// only used temporarily so it lives in the frame arena
+        typedef std::vector<std::pair<Node*, bool>, 
+            STLAllocator<std::pair<Node*, bool>, FrameAllocPolicy> > ChildUpdateList;
+
+        /** Internal method to update the Node without cascading to its children.
+        @remarks
+            Does the part of _update(true, parentHasChanged) which concerns this node
+            only, and appends the children _update would have descended into to
+            @a children, each paired with the parentHasChanged flag to pass to its own
+            _update call. This allows a SceneManager to process the children
+            separately, for instance from several threads.
+        */
+        void _updateAndGetChildren(bool parentHasChanged, ChildUpdateList& children);
+
+        /** Internal method to update the Node as part of a linear scene graph sweep.
+        @remarks
+            Does the part of _update(true, parentHasChanged) which concerns this node
+            only, leaving it to the caller to visit the children afterwards. A child
+            must be visited if this method returned true, in which case it is passed
+            parentHasChanged = true, or if its _isParentNotified returns true.
+        @return
+            Whether all children need to be updated
+        */
+        bool _updateSelf(bool parentHasChanged);
+
+        /** Internal method, whether this node has asked its parent to update it. */
+        bool _isParentNotified(void) const { return mParentNotified; }
+
         /** Sets a listener for this Node.
         @remarks
             Note for size and performance reasons only one listener per node is
@@ -731,6 +776,10 @@ namespace Ogre {
         /** Called by children to notify their parent that they no longer need an update. */
         virtual void cancelUpdate(Node* child);
 
+        /** Whether this node or any of its descendants is waiting for an update, internal use. */
+        bool _isUpdatePending(void) const
+        { return mNeedParentUpdate || mNeedChildUpdate || !mChildrenToUpdate.empty(); }
+
         /** Get a debug renderable for rendering the Node.  */
         virtual DebugRenderable* getDebugRenderable(Real scaling);
 
@@ -745,6 +794,18 @@ namespace Ogre {
         /** Process queued 'needUpdate' calls. */
         static void processQueuedUpdates(void);
 
+        /** Set whether Listener::nodeUpdated calls are deferred.
+        @remarks
+            While enabled, nodes record that they have been updated instead of
+            calling their listener straight away, which allows the scene graph to
+            be updated from several threads without the listeners having to be
+            thread safe. The recorded calls are made by
+            _processDeferredListenerCallbacks.
+        */
+        static void _setDeferListenerCallbacks(bool defer) { msDeferListenerCallbacks = defer; }
+        /** Make the Listener::nodeUpdated calls recorded while they were deferred. */
+        static void _processDeferredListenerCallbacks(void);
+
 
         /** @deprecated use UserObjectBindings::setUserAny via getUserObjectBindings() instead.
             Sets any kind of user value on this object.
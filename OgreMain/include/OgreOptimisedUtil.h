@@ -107,6 +107,29 @@ namespace Ogre {
             size_t numWeightsPerVertex,
             size_t numVertices) = 0;
 
+        /** Performs software vertex skinning with dual quaternions.
+        @remarks
+            The bone dual quaternions of each vertex are blended, flipping any
+            which lie in the opposite hemisphere to the first, then normalised
+            and applied to the position and normal. Unlike linear blending this
+            doesn't collapse volume at twisted joints, and it matches the dual
+            quaternion skinning done in shaders. Bone scaling is not applied.
+            Vertices whose weights are all zero keep their source position.
+        @param blendDualQuaternions An array of pointers to the bone dual
+            quaternions, indexed by blend index.
+        @see softwareVertexSkinning for the other parameters.
+        */
+        virtual void softwareVertexSkinningDualQuaternion(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const DualQuaternion* const* blendDualQuaternions,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices) = 0;
+
         /** Performs a software vertex morph, of the kind used for
             morph animation although it can be used for other purposes. 
         @remarks
@@ -144,6 +167,38 @@ namespace Ogre {
             Matrix4* dstMatrices,
             size_t numMatrices) = 0;
 
+        /** Transform an array of points by an affine matrix.
+        @remarks
+            The points may be interleaved with other vertex data, as in a
+            vertex buffer, and may be transformed in place.
+        @param matrix The affine matrix to transform by.
+        @param srcPtr Pointer to the first source point, (x, y, z) floats.
+        @param destPtr Pointer to the first destination point.
+        @param srcStride The stride in bytes between source points.
+        @param destStride The stride in bytes between destination points.
+        @param numPoints Number of points to transform.
+        */
+        virtual void transformPoints(
+            const Matrix4& matrix,
+            const float* srcPtr, float* destPtr,
+            size_t srcStride, size_t destStride,
+            size_t numPoints) = 0;
+
+        /** Transform an array of directions, such as normals and tangents,
+            by the upper 3x3 part of a matrix.
+        @remarks
+            The translation of the matrix is ignored. Otherwise the layout
+            is as for transformPoints.
+        @param normalise Whether to normalise the transformed directions,
+            zero length directions are left alone like Vector3::normalise.
+        @see transformPoints for the other parameters.
+        */
+        virtual void transformDirections(
+            const Matrix4& matrix,
+            const float* srcPtr, float* destPtr,
+            size_t srcStride, size_t destStride,
+            size_t numDirections, bool normalise) = 0;
+
         /** Calculate the face normals for the triangles based on position
             information.
         @param positions Pointer to position information, which packed in
@@ -203,6 +258,180 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices) = 0;
+
+        /** Test an array of axis aligned boxes against a set of planes.
+        @remarks
+            A box passes the test unless it lies entirely on the negative side of
+            one of the planes, so for the planes of a frustum this tells whether
+            each box is at least partly visible. The box components are passed as
+            separate arrays so that several boxes can be tested at once. No
+            alignment requirements, but the arrays shouldn't overlap.
+        @param planes Array of planes, e.g. from Frustum::getFrustumPlanes.
+        @param numPlanes Number of planes in the array.
+        @param centreX, centreY, centreZ Arrays of box centre components.
+        @param halfSizeX, halfSizeY, halfSizeZ Arrays of box half size components.
+        @param results Array receiving 1 for each box which passes the test, and
+            0 for each box which doesn't.
+        @param numBoxes Number of boxes in the arrays.
+        */
+        virtual void cullBoxes(
+            const Plane* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes) = 0;
+
+        /** Test an array of spheres against a set of planes.
+        @remarks
+            The sphere version of cullBoxes, a sphere passes the test unless it
+            lies entirely on the negative side of one of the planes.
+        @param planes Array of planes, e.g. from Frustum::getFrustumPlanes.
+        @param numPlanes Number of planes in the array.
+        @param centreX, centreY, centreZ Arrays of sphere centre components.
+        @param radius Array of sphere radii.
+        @param results Array receiving 1 for each sphere which passes the test,
+            and 0 for each sphere which doesn't.
+        @param numSpheres Number of spheres in the arrays.
+        */
+        virtual void cullSpheres(
+            const Plane* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* radius,
+            uint8* results, size_t numSpheres) = 0;
+
+        /** Test an array of axis aligned boxes for intersection with a box.
+        @remarks
+            Boxes which only touch count as intersecting, like
+            AxisAlignedBox::intersects. The arrays are laid out as for cullBoxes.
+        @param box The box to test against, must be finite.
+        @param centreX, centreY, centreZ Arrays of box centre components.
+        @param halfSizeX, halfSizeY, halfSizeZ Arrays of box half size components.
+        @param results Array receiving 1 for each box which intersects, 0 otherwise.
+        @param numBoxes Number of boxes in the arrays.
+        */
+        virtual void intersectBoxes(
+            const AxisAlignedBox& box,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes) = 0;
+
+        /** Test an array of axis aligned boxes for intersection with a sphere.
+        @param sphere The sphere to test against.
+        @param centreX, centreY, centreZ Arrays of box centre components.
+        @param halfSizeX, halfSizeY, halfSizeZ Arrays of box half size components.
+        @param results Array receiving 1 for each box which intersects, 0 otherwise.
+        @param numBoxes Number of boxes in the arrays.
+        */
+        virtual void intersectBoxes(
+            const Sphere& sphere,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes) = 0;
+
+        /** Test an array of axis aligned boxes for intersection with a ray.
+        @remarks
+            Like Math::intersects(const Ray&, const AxisAlignedBox&), the distance
+            is that along the ray to where it enters the box, or 0 if the ray
+            starts inside the box.
+        @param ray The ray to test against.
+        @param centreX, centreY, centreZ Arrays of box centre components.
+        @param halfSizeX, halfSizeY, halfSizeZ Arrays of box half size components.
+        @param distances Array receiving the distance along the ray for each box,
+            only meaningful for the boxes which are hit.
+        @param results Array receiving 1 for each box which is hit, 0 otherwise.
+        @param numBoxes Number of boxes in the arrays.
+        */
+        virtual void intersectBoxes(
+            const Ray& ray,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            float* distances, uint8* results, size_t numBoxes) = 0;
+
+        /** Test an array of spheres for intersection with a sphere.
+        @param sphere The sphere to test against.
+        @param centreX, centreY, centreZ Arrays of sphere centre components.
+        @param radius Array of sphere radii.
+        @param results Array receiving 1 for each sphere which intersects, 0 otherwise.
+        @param numSpheres Number of spheres in the arrays.
+        */
+        virtual void intersectSpheres(
+            const Sphere& sphere,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* radius,
+            uint8* results, size_t numSpheres) = 0;
+
+        /** Normalised linear interpolation of an array of quaternion pairs.
+        @remarks
+            Each result is that of Quaternion::nlerp with shortestPath set. The
+            quaternions are packed as 4 floats each, in w, x, y, z order.
+        @param t Array of interpolation factors, one per pair.
+        @param src1 Array of quaternions to interpolate from.
+        @param src2 Array of quaternions to interpolate to.
+        @param dest Array receiving the interpolated quaternions, may be the same
+            as src1 or src2.
+        @param numQuaternions Number of quaternion pairs to interpolate.
+        */
+        virtual void nlerpQuaternions(
+            const float* t,
+            const float* src1, const float* src2,
+            float* dest, size_t numQuaternions) = 0;
+
+        /** Reorder the channels of an array of pixels with 8 bits per channel.
+        @remarks
+            This is the conversion between any two pixel formats made of whole
+            bytes, e.g. PF_R8G8B8 to PF_A8B8G8R8 or PF_L8 to PF_A8R8G8B8.
+        @param src Array of source pixels.
+        @param srcPixelSize Size of a source pixel in bytes, from 1 to 4.
+        @param dest Array of destination pixels, mustn't overlap the source.
+        @param destPixelSize Size of a destination pixel in bytes, from 1 to 4.
+        @param shuffle For each byte of a destination pixel, the index of the
+            byte of the source pixel it is copied from, or -1 to set it to 0xFF.
+        @param numPixels Number of pixels to convert.
+        */
+        virtual void shufflePixels(
+            const uint8* src, size_t srcPixelSize,
+            uint8* dest, size_t destPixelSize,
+            const int8* shuffle, size_t numPixels) = 0;
+
+        /** Convert an array of half floats to floats, as Bitwise::halfToFloat does.
+        @param src Array of half floats.
+        @param dest Array receiving the floats.
+        @param count Number of values to convert.
+        */
+        virtual void convertHalfToFloat(
+            const uint16* src, float* dest, size_t count) = 0;
+
+        /** Convert an array of floats to half floats, as Bitwise::floatToHalf does.
+        @param src Array of floats.
+        @param dest Array receiving the half floats.
+        @param count Number of values to convert.
+        */
+        virtual void convertFloatToHalf(
+            const float* src, uint16* dest, size_t count) = 0;
+
+        /** Sum rows of floats scaled by a weight per row.
+        @remarks
+            This is the vertical pass of a separable image filter, computing
+            dest[i] = weights[0] * rows[0][i] + ... + weights[numRows - 1] * rows[numRows - 1][i].
+        @param rows Array of pointers to the rows to sum.
+        @param weights Array of the weights of the rows.
+        @param numRows Number of rows to sum, at least 1.
+        @param dest Array receiving the sums, may be one of the rows.
+        @param count Number of values in each row.
+        */
+        virtual void sumWeightedRows(
+            const float* const* rows, const float* weights, size_t numRows,
+            float* dest, size_t count) = 0;
+
+        /** Convert an array of floats in the range [0, 255] to bytes.
+        @remarks
+            Values are rounded to nearest, ties away from zero, and clamped to
+            the range first, with NaNs becoming zero.
+        @param src Array of floats.
+        @param dest Array receiving the bytes.
+        @param count Number of values to convert.
+        */
+        virtual void convertFloatToByte(
+            const float* src, uint8* dest, size_t count) = 0;
     };
 
     /** Returns raw offseted of the given pointer.
@@ -184,6 +184,11 @@ namespace Ogre {
         /** Internal utility method for generating an emission count based on a constant emission rate. */
         virtual unsigned short genConstantEmissionCount(Real timeElapsed);
 
+        /** Internal utility method for generating the colour, direction, velocity and time-to-live
+            of particles whose positions are already set, as _initParticle implementations do.
+        */
+        void genEmissionAttributes(Particle** particles, size_t count);
+
         /** Internal method for setting up the basic parameter definitions for a subclass. 
         @remarks
             Because StringInterface holds a dictionary of parameters per class, subclasses need to
@@ -421,6 +426,20 @@ namespace Ogre {
             pParticle->resetDimensions();
         }
 
+        /** Initialises a number of particles at once.
+        @remarks
+            The ParticleSystem calls this once with all the particles an emitter emits in a frame,
+            rather than _initParticle for each. The default implementation calls _initParticle for
+            each particle; emitters override it to avoid the per particle virtual calls and to
+            generate the positions of the whole batch in one loop.
+        @param particles Pointers to the particles to initialise
+        @param count The number of particles
+        */
+        virtual void _initParticles(Particle** particles, size_t count) {
+            for (size_t i = 0; i < count; ++i)
+                _initParticle(particles[i]);
+        }
+
 
         /** Returns the name of the type of emitter. 
         @remarks
@@ -347,6 +347,30 @@ namespace Ogre {
         */
         void _update(Real timeElapsed);
 
+        /** Prepare an update which will run on another thread.
+        @remarks
+            Used by ParticleSystemManager when parallel updates are enabled. This
+            does the work of _update which is not safe to run concurrently with
+            other systems, like configuring the renderer and reading the node
+            transforms, and applies the non-visible update timeout.
+        @param
+            timeElapsed The amount of time, in seconds, since the last frame.
+        @return
+            Whether _updateConcurrent() should be called for this frame.
+        */
+        bool _prepareConcurrentUpdate(Real timeElapsed);
+
+        /** Update the particles and bounds after _prepareConcurrentUpdate.
+        @remarks
+            This may be called on a worker thread, concurrently with other
+            systems, so emitters and affectors must not modify state shared
+            between systems.
+        */
+        void _updateConcurrent(void);
+
+        /** Complete an update done by _updateConcurrent, on the main thread. */
+        void _finishConcurrentUpdate(void);
+
         /** Returns an iterator for stepping through all particles in this system.
         @remarks
             This method is designed to be used by people providing new ParticleAffector subclasses,
@@ -705,10 +729,15 @@ namespace Ogre {
         bool mEmittedEmitterPoolInitialised;
         /// Used to control if the particle system should emit particles or not.
         bool mIsEmitting;
+        /// Scaled time of the update prepared by _prepareConcurrentUpdate
+        Real mConcurrentUpdateTime;
+        /// Whether _updateConcurrent changed the bounds, so the node must be told
+        bool mConcurrentBoundsChanged;
 
-        typedef list<Particle*>::type ActiveParticleList;
-        typedef list<Particle*>::type FreeParticleList;
+        typedef vector<Particle*>::type ActiveParticleList;
+        typedef vector<Particle*>::type FreeParticleList;
         typedef vector<Particle*>::type ParticlePool;
+        typedef vector<Particle*>::type ParticleBlockList;
 
         /** Sort by direction functor */
         struct SortByDirectionFunctor
@@ -734,11 +763,12 @@ namespace Ogre {
 
         /** Active particle list.
             @remarks
-                This is a linked list of pointers to particles in the particle pool.
+                This is a contiguous array of pointers to particles in the particle pool.
             @par
-                This allows very fast insertions and deletions from anywhere in 
-                the list to activate / deactivate particles as well as reuse of 
-                Particle instances in the pool without construction & destruction 
+                Particles are appended when emitted, and expired particles are
+                removed by compacting the array in a single pass, so iteration
+                by the affectors and the renderer is cache friendly and Particle
+                instances in the pool are reused without construction & destruction
                 which avoids memory thrashing.
         */
         ActiveParticleList mActiveParticles;
@@ -748,9 +778,9 @@ namespace Ogre {
                 This contains a list of the particles free for use as new instances
                 as required by the set. Particle instances are preconstructed up 
                 to the estimated size in the mParticlePool vector and are 
-                referenced on this deque at startup. As they get used this list
+                referenced on this stack at startup. As they get used this list
                 reduces, as they get released back to to the set they get added
-                back to the list.
+                back to the end of the list, to be reused first.
         */
         FreeParticleList mFreeParticles;
 
@@ -760,8 +790,11 @@ namespace Ogre {
         */
         ParticlePool mParticlePool;
 
-        typedef list<ParticleEmitter*>::type FreeEmittedEmitterList;
-        typedef list<ParticleEmitter*>::type ActiveEmittedEmitterList;
+        /// Contiguous arrays of Particle instances referenced by mParticlePool, one per pool increase
+        ParticleBlockList mParticleBlocks;
+
+        typedef vector<ParticleEmitter*>::type FreeEmittedEmitterList;
+        typedef vector<ParticleEmitter*>::type ActiveEmittedEmitterList;
         typedef vector<ParticleEmitter*>::type EmittedEmitterList;
         typedef map<String, FreeEmittedEmitterList>::type FreeEmittedEmitterMap;
         typedef map<String, EmittedEmitterList>::type EmittedEmitterPool;
@@ -778,13 +811,15 @@ namespace Ogre {
 
         /** Free emitted emitter list.
             @remarks
-                This contains a list of the emitters free for use as new instances as required by the set.
+                This contains, for each name, a stack of the emitters free for use as new instances as
+                required by the set.
         */
         FreeEmittedEmitterMap mFreeEmittedEmitters;
 
         /** Active emitted emitter list.
             @remarks
-                This is a linked list of pointers to emitters in the emitted emitter pool.
+                This is an array of pointers to emitters in the emitted emitter pool, rebuilt from
+                mActiveParticles when emitted emitters expire.
                 Emitters that are used are stored (their pointers) in both the list with active particles and in 
                 the list with active emitted emitters.        */
         ActiveEmittedEmitterList mActiveEmittedEmitters;
@@ -797,6 +832,13 @@ namespace Ogre {
         /// List of particle affectors, ie modifiers of particles
         ParticleAffectorList mAffectors;
 
+        /// Emission counts requested by each emitter in _triggerEmitters
+        vector<unsigned>::type mEmitterRequests;
+        /// Emission counts requested by each active emitted emitter in _triggerEmitters
+        vector<unsigned>::type mEmittedEmitterRequests;
+        /// Particles created by _executeTriggerEmitters, initialised by the emitter in one call
+        vector<Particle*>::type mEmitBatch;
+
         /// The renderer used to render this particle system
         ParticleSystemRenderer* mRenderer;
 
@@ -823,6 +865,19 @@ namespace Ogre {
         /** Internal method used to expire dead particles. */
         void _expire(Real timeElapsed);
 
+        /** Apply the non-visible timeout and make sure the system is ready to update.
+        @return False if the update should be skipped
+        */
+        bool prepareUpdate(Real timeElapsed);
+
+        /** Expire, affect, move and emit particles for an update of scaled time. */
+        void updateParticles(Real timeElapsed);
+
+        /** Calculate the bounds as _updateBounds does, without telling the node.
+        @return Whether the parent node needs to be told of an update
+        */
+        bool calculateBounds(void);
+
         /** Spawn new particles based on free quota and emitter requirements. */
         void _triggerEmitters(Real timeElapsed);
 
@@ -885,6 +940,11 @@ namespace Ogre {
         */
         FreeEmittedEmitterList* findFreeEmittedEmitter (const String& name);
 
+        /** Takes an emitter from a list of free emitted emitters and makes it an active particle.
+            @return The emitter, or 0 if the list is empty.
+        */
+        Particle* popFreeEmittedEmitter (FreeEmittedEmitterList* fee);
+
         /** Removes an emitter from the active emitted emitter list.
             @remarks
                 The emitter will not be destroyed!
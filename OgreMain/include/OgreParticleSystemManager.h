@@ -99,6 +99,14 @@ namespace Ogre {
         // Factory instance
         ParticleSystemFactory* mFactory;
 
+        /// Whether systems are updated in parallel, see setParallelUpdate
+        bool mParallelUpdate;
+        typedef vector<std::pair<ParticleSystem*, Real> >::type QueuedUpdateList;
+        /// Updates requested by the time controllers, run by _updateQueuedSystems
+        QueuedUpdateList mQueuedUpdates;
+        /// Systems prepared for the update running in _updateQueuedSystems
+        vector<ParticleSystem*>::type mUpdatingSystems;
+
         /** Internal script parsing method. */
         void parseNewEmitter(const String& type, DataStreamPtr& chunk, ParticleSystem* sys);
         /** Internal script parsing method. */
@@ -341,6 +349,31 @@ namespace Ogre {
                 mSystemTemplates.begin(), mSystemTemplates.end());
         } 
 
+        /** Sets whether particle systems are updated in parallel.
+        @remarks
+            When enabled, the time controllers of particle systems only queue their
+            updates, and the scene manager runs them all at once after the
+            controllers have been updated, spreading the systems over the threads
+            of the Root's WorkQueue via WorkQueue::parallelFor. The non-visible
+            update timeout is applied as before. Emitters, affectors and renderers
+            must then only touch the state of their own system while updating,
+            and a Math random number provider, if set, must be thread safe.
+            The default is false.
+        */
+        void setParallelUpdate(bool parallel);
+        /// Gets whether particle systems are updated in parallel
+        bool getParallelUpdate(void) const { return mParallelUpdate; }
+
+        /** Queue an update of a particle system for _updateQueuedSystems (internal use). */
+        void _queueUpdate(ParticleSystem* sys, Real timeElapsed);
+        /** Remove any queued update of a particle system which is going away (internal use). */
+        void _cancelUpdate(ParticleSystem* sys);
+        /** Run the queued particle system updates (internal use).
+        @remarks
+            Called by SceneManager after the controllers have been updated.
+        */
+        void _updateQueuedSystems(void);
+
         /** Get an instance of ParticleSystemFactory (internal use). */
         ParticleSystemFactory* _getFactory(void) { return mFactory; }
         
@@ -63,7 +63,7 @@ namespace Ogre {
             instance(s) it wishes.
         */
         virtual void _updateRenderQueue(RenderQueue* queue, 
-            list<Particle*>::type& currentParticles, bool cullIndividually) = 0;
+            vector<Particle*>::type& currentParticles, bool cullIndividually) = 0;
 
         /** Sets the material this renderer must use; called by ParticleSystem. */
         virtual void _setMaterial(MaterialPtr& mat) = 0;
@@ -84,9 +84,9 @@ namespace Ogre {
         /** Optional callback notified when particle expired */
         virtual void _notifyParticleExpired(Particle* particle) {}
         /** Optional callback notified when particles moved */
-        virtual void _notifyParticleMoved(list<Particle*>::type& currentParticles) {}
+        virtual void _notifyParticleMoved(vector<Particle*>::type& currentParticles) {}
         /** Optional callback notified when particles cleared */
-        virtual void _notifyParticleCleared(list<Particle*>::type& currentParticles) {}
+        virtual void _notifyParticleCleared(vector<Particle*>::type& currentParticles) {}
         /** Create a new ParticleVisualData instance for attachment to a particle.
         @remarks
             If this renderer needs additional data in each particle, then this should
@@ -104,6 +104,26 @@ namespace Ogre {
         */
         virtual void _destroyVisualData(ParticleVisualData* vis) { assert (vis == 0); }
 
+        /** Whether this renderer simulates the particles itself, for example on the GPU.
+        @remarks
+            If so, the ParticleSystem allocates no particles of its own and calls
+            _simulateParticles instead of expiring, affecting and emitting particles
+            on the CPU. The emitters and affectors of the system then only describe
+            the simulation, and the renderer is responsible for the bounds of the
+            system. The default is false.
+        */
+        virtual bool _simulatesParticles(void) const { return false; }
+
+        /** Advance the simulation of a system whose particles this renderer simulates.
+        @remarks
+            Called by ParticleSystem instead of its own update when _simulatesParticles
+            returns true. This may be called on a worker thread when particle systems
+            are updated in parallel, so it must not touch the render system.
+        @param sys The system being updated
+        @param timeElapsed The time since the last update, scaled by the speed factor
+        */
+        virtual void _simulateParticles(ParticleSystem* sys, Real timeElapsed) {}
+
         /** Sets which render queue group this renderer should target with it's
             output.
         */
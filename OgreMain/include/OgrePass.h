@@ -99,6 +99,7 @@ namespace Ogre {
         unsigned short mIndex; /// Pass index
         String mName; /// Optional name for the pass
         uint32 mHash; /// Pass hash
+        uint64 mSortKey; /// Pass state sorting key
         bool mHashDirtyQueued; /// Needs to be dirtied when next loaded
         //-------------------------------------------------------------------------
         // Colour properties, only applicable in fixed-function passes
@@ -1500,6 +1501,26 @@ namespace Ogre {
             by the textures which it's TextureUnitState instances are using.
         */
         uint32 getHash(void) const { return mHash; }
+
+        /** Gets the state sorting key of this pass, calculated along with the hash.
+        @remarks
+            Unlike the hash, which only has room for a few bits of the first
+            texture names or program names, the sort key covers all the state
+            which is expensive to change. From the most significant bit down:
+            <table>
+            <tr><th>bits</th><th>purpose</th></tr>
+            <tr><td>4</td><td>Pass index (i.e. max 16 passes!)</td></tr>
+            <tr><td>16</td><td>Hash of the names of all GPU programs</td></tr>
+            <tr><td>16</td><td>Hash of the texture names of all texture units</td></tr>
+            <tr><td>7</td><td>Hash of the scene blending factors and operations</td></tr>
+            <tr><td>5</td><td>Depth check, depth write and depth function</td></tr>
+            <tr><td>16</td><td>Zero, for the render queue to order renderables using the same pass</td></tr>
+            </table>
+            Passes which share programs and textures therefore sort next to each
+            other. The key is used by the QueuedRenderableCollection::OM_SORT_KEY
+            organisation mode; it does not depend on the hash function set.
+        */
+        uint64 getSortKey(void) const { return mSortKey; }
         /// Mark the hash as dirty
         void _dirtyHash(void);
         /** Internal method for recalculating the hash.
@@ -256,8 +256,36 @@ namespace Ogre {
         PF_ATC_RGBA_EXPLICIT_ALPHA = 93,
         /// ATC (AMD_compressed_ATC_texture)
         PF_ATC_RGBA_INTERPOLATED_ALPHA = 94,
+        /// ASTC (ARM Adaptive Scalable Texture Compression), 4x4 blocks of 128 bits, low dynamic range
+        PF_ASTC_RGBA_4X4_LDR = 95,
+        /// ASTC (ARM Adaptive Scalable Texture Compression), 5x4 blocks of 128 bits, low dynamic range
+        PF_ASTC_RGBA_5X4_LDR = 96,
+        /// ASTC (ARM Adaptive Scalable Texture Compression), 5x5 blocks of 128 bits, low dynamic range
+        PF_ASTC_RGBA_5X5_LDR = 97,
+        /// ASTC (ARM Adaptive Scalable Texture Compression), 6x5 blocks of 128 bits, low dynamic range
+        PF_ASTC_RGBA_6X5_LDR = 98,
+        /// ASTC (ARM Adaptive Scalable Texture Compression), 6x6 blocks of 128 bits, low dynamic range
+        PF_ASTC_RGBA_6X6_LDR = 99,
+        /// ASTC (ARM Adaptive Scalable Texture Compression), 8x5 blocks of 128 bits, low dynamic range
+        PF_ASTC_RGBA_8X5_LDR = 100,
+        /// ASTC (ARM Adaptive Scalable Texture Compression), 8x6 blocks of 128 bits, low dynamic range
+        PF_ASTC_RGBA_8X6_LDR = 101,
+        /// ASTC (ARM Adaptive Scalable Texture Compression), 8x8 blocks of 128 bits, low dynamic range
+        PF_ASTC_RGBA_8X8_LDR = 102,
+        /// ASTC (ARM Adaptive Scalable Texture Compression), 10x5 blocks of 128 bits, low dynamic range
+        PF_ASTC_RGBA_10X5_LDR = 103,
+        /// ASTC (ARM Adaptive Scalable Texture Compression), 10x6 blocks of 128 bits, low dynamic range
+        PF_ASTC_RGBA_10X6_LDR = 104,
+        /// ASTC (ARM Adaptive Scalable Texture Compression), 10x8 blocks of 128 bits, low dynamic range
+        PF_ASTC_RGBA_10X8_LDR = 105,
+        /// ASTC (ARM Adaptive Scalable Texture Compression), 10x10 blocks of 128 bits, low dynamic range
+        PF_ASTC_RGBA_10X10_LDR = 106,
+        /// ASTC (ARM Adaptive Scalable Texture Compression), 12x10 blocks of 128 bits, low dynamic range
+        PF_ASTC_RGBA_12X10_LDR = 107,
+        /// ASTC (ARM Adaptive Scalable Texture Compression), 12x12 blocks of 128 bits, low dynamic range
+        PF_ASTC_RGBA_12X12_LDR = 108,
         // Number of pixel formats currently defined
-        PF_COUNT = 95
+        PF_COUNT = 109
     };
     typedef vector<PixelFormat>::type PixelFormatList;
 
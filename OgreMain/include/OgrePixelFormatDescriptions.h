@@ -1350,6 +1350,188 @@ namespace Ogre {
             0, 0, 0, 0,
             /* Masks and shifts */
             0, 0, 0, 0, 0, 0, 0, 0
+        },
+        //-----------------------------------------------------------------------
+        {"PF_ASTC_RGBA_4X4_LDR",
+            /* Bytes per element */
+            0,
+            /* Flags */
+            PFF_COMPRESSED | PFF_HASALPHA,
+            /* Component type and count */
+            PCT_BYTE, 4,
+            /* rbits, gbits, bbits, abits */
+            0, 0, 0, 0,
+            /* Masks and shifts */
+            0, 0, 0, 0, 0, 0, 0, 0
+        },
+        //-----------------------------------------------------------------------
+        {"PF_ASTC_RGBA_5X4_LDR",
+            /* Bytes per element */
+            0,
+            /* Flags */
+            PFF_COMPRESSED | PFF_HASALPHA,
+            /* Component type and count */
+            PCT_BYTE, 4,
+            /* rbits, gbits, bbits, abits */
+            0, 0, 0, 0,
+            /* Masks and shifts */
+            0, 0, 0, 0, 0, 0, 0, 0
+        },
+        //-----------------------------------------------------------------------
+        {"PF_ASTC_RGBA_5X5_LDR",
+            /* Bytes per element */
+            0,
+            /* Flags */
+            PFF_COMPRESSED | PFF_HASALPHA,
+            /* Component type and count */
+            PCT_BYTE, 4,
+            /* rbits, gbits, bbits, abits */
+            0, 0, 0, 0,
+            /* Masks and shifts */
+            0, 0, 0, 0, 0, 0, 0, 0
+        },
+        //-----------------------------------------------------------------------
+        {"PF_ASTC_RGBA_6X5_LDR",
+            /* Bytes per element */
+            0,
+            /* Flags */
+            PFF_COMPRESSED | PFF_HASALPHA,
+            /* Component type and count */
+            PCT_BYTE, 4,
+            /* rbits, gbits, bbits, abits */
+            0, 0, 0, 0,
+            /* Masks and shifts */
+            0, 0, 0, 0, 0, 0, 0, 0
+        },
+        //-----------------------------------------------------------------------
+        {"PF_ASTC_RGBA_6X6_LDR",
+            /* Bytes per element */
+            0,
+            /* Flags */
+            PFF_COMPRESSED | PFF_HASALPHA,
+            /* Component type and count */
+            PCT_BYTE, 4,
+            /* rbits, gbits, bbits, abits */
+            0, 0, 0, 0,
+            /* Masks and shifts */
+            0, 0, 0, 0, 0, 0, 0, 0
+        },
+        //-----------------------------------------------------------------------
+        {"PF_ASTC_RGBA_8X5_LDR",
+            /* Bytes per element */
+            0,
+            /* Flags */
+            PFF_COMPRESSED | PFF_HASALPHA,
+            /* Component type and count */
+            PCT_BYTE, 4,
+            /* rbits, gbits, bbits, abits */
+            0, 0, 0, 0,
+            /* Masks and shifts */
+            0, 0, 0, 0, 0, 0, 0, 0
+        },
+        //-----------------------------------------------------------------------
+        {"PF_ASTC_RGBA_8X6_LDR",
+            /* Bytes per element */
+            0,
+            /* Flags */
+            PFF_COMPRESSED | PFF_HASALPHA,
+            /* Component type and count */
+            PCT_BYTE, 4,
+            /* rbits, gbits, bbits, abits */
+            0, 0, 0, 0,
+            /* Masks and shifts */
+            0, 0, 0, 0, 0, 0, 0, 0
+        },
+        //-----------------------------------------------------------------------
+        {"PF_ASTC_RGBA_8X8_LDR",
+            /* Bytes per element */
+            0,
+            /* Flags */
+            PFF_COMPRESSED | PFF_HASALPHA,
+            /* Component type and count */
+            PCT_BYTE, 4,
+            /* rbits, gbits, bbits, abits */
+            0, 0, 0, 0,
+            /* Masks and shifts */
+            0, 0, 0, 0, 0, 0, 0, 0
+        },
+        //-----------------------------------------------------------------------
+        {"PF_ASTC_RGBA_10X5_LDR",
+            /* Bytes per element */
+            0,
+            /* Flags */
+            PFF_COMPRESSED | PFF_HASALPHA,
+            /* Component type and count */
+            PCT_BYTE, 4,
+            /* rbits, gbits, bbits, abits */
+            0, 0, 0, 0,
+            /* Masks and shifts */
+            0, 0, 0, 0, 0, 0, 0, 0
+        },
+        //-----------------------------------------------------------------------
+        {"PF_ASTC_RGBA_10X6_LDR",
+            /* Bytes per element */
+            0,
+            /* Flags */
+            PFF_COMPRESSED | PFF_HASALPHA,
+            /* Component type and count */
+            PCT_BYTE, 4,
+            /* rbits, gbits, bbits, abits */
+            0, 0, 0, 0,
+            /* Masks and shifts */
+            0, 0, 0, 0, 0, 0, 0, 0
+        },
+        //-----------------------------------------------------------------------
+        {"PF_ASTC_RGBA_10X8_LDR",
+            /* Bytes per element */
+            0,
+            /* Flags */
+            PFF_COMPRESSED | PFF_HASALPHA,
+            /* Component type and count */
+            PCT_BYTE, 4,
+            /* rbits, gbits, bbits, abits */
+            0, 0, 0, 0,
+            /* Masks and shifts */
+            0, 0, 0, 0, 0, 0, 0, 0
+        },
+        //-----------------------------------------------------------------------
+        {"PF_ASTC_RGBA_10X10_LDR",
+            /* Bytes per element */
+            0,
+            /* Flags */
+            PFF_COMPRESSED | PFF_HASALPHA,
+            /* Component type and count */
+            PCT_BYTE, 4,
+            /* rbits, gbits, bbits, abits */
+            0, 0, 0, 0,
+            /* Masks and shifts */
+            0, 0, 0, 0, 0, 0, 0, 0
+        },
+        //-----------------------------------------------------------------------
+        {"PF_ASTC_RGBA_12X10_LDR",
+            /* Bytes per element */
+            0,
+            /* Flags */
+            PFF_COMPRESSED | PFF_HASALPHA,
+            /* Component type and count */
+            PCT_BYTE, 4,
+            /* rbits, gbits, bbits, abits */
+            0, 0, 0, 0,
+            /* Masks and shifts */
+            0, 0, 0, 0, 0, 0, 0, 0
+        },
+        //-----------------------------------------------------------------------
+        {"PF_ASTC_RGBA_12X12_LDR",
+            /* Bytes per element */
+            0,
+            /* Flags */
+            PFF_COMPRESSED | PFF_HASALPHA,
+            /* Component type and count */
+            PCT_BYTE, 4,
+            /* rbits, gbits, bbits, abits */
+            0, 0, 0, 0,
+            /* Masks and shifts */
+            0, 0, 0, 0, 0, 0, 0, 0
         }
     };
     /** @} */
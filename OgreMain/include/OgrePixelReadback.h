@@ -0,0 +1,88 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __PixelReadback_H__
+#define __PixelReadback_H__
+
+#include "OgrePrerequisites.h"
+#include "OgrePixelFormat.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup RenderSystem
+    *  @{
+    */
+    /** Pending copy of the contents of a render target to memory.
+    @remarks
+        Created by RenderTarget::copyContentsToMemoryAsync. The copy is queued on the GPU
+        together with the rendering commands, so that the CPU carries on while the GPU
+        catches up. Poll isReady, typically once per frame, and call read once it
+        returns true.
+    @note
+        Readbacks hold render system resources, release them before shutting down
+        the render system.
+    */
+    class _OgreExport PixelReadback : public RenderSysAlloc
+    {
+    public:
+        PixelReadback(uint32 width, uint32 height, PixelFormat format)
+            : mWidth(width), mHeight(height), mFormat(format) {}
+        virtual ~PixelReadback() {}
+
+        /** Tells whether the GPU has finished the copy, never waits for it. */
+        virtual bool isReady(void) = 0;
+
+        /** Copies the read back pixels to memory.
+        @remarks
+            Waits for the GPU if the copy isn't ready yet. The pixels are converted if
+            the format of dst differs from getFormat.
+        @param dst Destination, with the same dimensions as the copied box
+        */
+        virtual void read(const PixelBox& dst) = 0;
+
+        /** Width of the copied box. */
+        uint32 getWidth(void) const { return mWidth; }
+        /** Height of the copied box. */
+        uint32 getHeight(void) const { return mHeight; }
+        /** Format the pixels were read back in. */
+        PixelFormat getFormat(void) const { return mFormat; }
+
+    protected:
+        uint32 mWidth;
+        uint32 mHeight;
+        PixelFormat mFormat;
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
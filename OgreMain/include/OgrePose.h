@@ -115,6 +115,13 @@ namespace Ogre {
         /** Get a hardware vertex buffer version of the vertex offsets. */
         const HardwareVertexBufferSharedPtr& _getHardwareVertexBuffer(const VertexData* origData) const;
 
+        /** Internal method setting the V texture coordinate offset of this pose
+            in the pose texture of its target, @see Mesh::setUsePoseTexture. */
+        void _setTextureOffset(Real offset) { mTextureOffset = offset; }
+        /** Internal method getting the V texture coordinate offset of this pose
+            in the pose texture of its target, @see Mesh::setUsePoseTexture. */
+        Real _getTextureOffset(void) const { return mTextureOffset; }
+
         /** Clone this pose and create another one configured exactly the same
             way (only really useful for cloning holders of this class).
         */
@@ -130,6 +137,8 @@ namespace Ogre {
         NormalsMap mNormalsMap;
         /// Derived hardware buffer, covers all vertices
         mutable HardwareVertexBufferSharedPtr mBuffer;
+        /// Where the pose starts in the pose texture of its target
+        Real mTextureOffset;
     };
     typedef vector<Pose*>::type PoseList;
 
@@ -163,6 +163,7 @@ namespace Ogre {
     class DataStream;
     class DefaultWorkQueue;
     class Degree;
+    class DualQuaternion;
     class DepthBuffer;
     class DynLib;
     class DynLibManager;
@@ -175,6 +176,7 @@ namespace Ogre {
     struct FrameEvent;
     class FrameListener;
     class Frustum;
+    class GpuDrawCuller;
     struct GpuLogicalBufferStruct;
     struct GpuNamedConstants;
     class GpuProgramParameters;
@@ -220,6 +222,7 @@ namespace Ogre {
     class MeshSerializer;
     class MeshSerializerImpl;
     class MeshManager;
+    class MeshBVH;
     class MovableObject;
     class MovablePlane;
     class Node;
@@ -240,11 +243,14 @@ namespace Ogre {
     class Pass;
     class PatchMesh;
     class PixelBox;
+    class PixelReadback;
     class Plane;
     class PlaneBoundedVolume;
     class Plugin;
     class Pose;
     class Profile;
+    class ProfileSpikeCapture;
+    class ProfileTraceListener;
     class Profiler;
     class Quaternion;
     class Radian;
@@ -254,6 +260,7 @@ namespace Ogre {
     class Renderable;
     class RenderPriorityGroup;
     class RenderQueue;
+    class RenderQueueDiagnostics;
     class RenderQueueGroup;
     class RenderQueueInvocation;
     class RenderQueueInvocationSequence;
@@ -273,6 +280,7 @@ namespace Ogre {
     class Resource;
     class ResourceBackgroundQueue;
     class ResourceGroupManager;
+    class ResourceLoadTrace;
     class ResourceManager;
     class RibbonTrail;
     class Root;
@@ -294,6 +302,7 @@ namespace Ogre {
     class Skeleton;
     class SkeletonInstance;
     class SkeletonManager;
+    class SoftwareOcclusionCuller;
     class Sphere;
     class SphereSceneQuery;
     class StaticGeometry;
@@ -347,6 +356,7 @@ namespace Ogre {
     typedef SharedPtr<MemoryDataStream> MemoryDataStreamPtr;
     typedef SharedPtr<Mesh> MeshPtr;
     typedef SharedPtr<PatchMesh> PatchMeshPtr;
+    typedef SharedPtr<PixelReadback> PixelReadbackPtr;
     typedef SharedPtr<RenderToVertexBuffer> RenderToVertexBufferSharedPtr;
     typedef SharedPtr<Resource> ResourcePtr;
     typedef SharedPtr<ShadowCameraSetup> ShadowCameraSetupPtr;
@@ -0,0 +1,187 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __ProfileSpikeCapture_H__
+#define __ProfileSpikeCapture_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreProfileTraceListener.h"
+#include "OgreRenderTarget.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+    /** ProfileTraceListener which writes the timeline around frames taking
+        longer than a threshold, so rare hitches come with evidence.
+    @remarks
+        The timeline is recorded all the time, like ProfileTraceListener does,
+        along with the start and duration of the last frames. A frame is the
+        outermost profile, usually the one wrapping Root::renderOneFrame. When
+        a frame exceeds the threshold, the capture waits for the frames
+        following it, then writes the frames before and after the spike to a
+        trace file in the capture directory. Next to the profiles, the file
+        holds:
+        - the frames themselves, with the statistics of the render target set
+          by setRenderTarget
+        - the GPU programs compiled, linked or generated meanwhile, see
+          GpuProgramManager::getCompileTimings
+        - the resources loaded meanwhile, if a ResourceLoadTrace records to
+          this listener
+    @par
+        The ring buffer must be large enough to hold the events of all the
+        frames written, or the oldest ones are missing from the file. Only
+        setMaxCaptures files are written, so a game running badly does not
+        fill the disk.
+    */
+    class _OgreExport ProfileSpikeCapture : public ProfileTraceListener
+    {
+    public:
+        /** Constructor.
+        @param capacity The number of events the ring buffer holds
+        @param numFrames The number of frames whose start, duration and
+            statistics are kept, which limits the frames written around a spike
+        */
+        ProfileSpikeCapture(size_t capacity = 65536, size_t numFrames = 128);
+        virtual ~ProfileSpikeCapture();
+
+        /// @see ProfileSessionListener::initializeSession
+        virtual void initializeSession();
+
+        /// @see ProfileSessionListener::profileStarted
+        virtual void profileStarted(const String& profileName, ulong startTime);
+
+        /// @see ProfileSessionListener::profileEnded
+        virtual void profileEnded(const String& profileName, ulong startTime, ulong endTime);
+
+        /** Sets the frame time above which a frame is a spike, in microseconds
+            (default 50000). */
+        void setThreshold(ulong microseconds) { mThreshold = microseconds; }
+        /// Gets the frame time above which a frame is a spike, in microseconds
+        ulong getThreshold(void) const { return mThreshold; }
+
+        /** Sets how many frames before and after a spike are written (default
+            30 and 10).
+        @remarks
+            Their sum is limited by the number of frames given to the constructor.
+        */
+        void setFramesAround(size_t before, size_t after);
+        /// Gets how many frames before a spike are written
+        size_t getFramesBefore(void) const { return mFramesBefore; }
+        /// Gets how many frames after a spike are written
+        size_t getFramesAfter(void) const { return mFramesAfter; }
+
+        /** Sets the render target whose statistics are kept with each frame, or 0. */
+        void setRenderTarget(RenderTarget* target) { mRenderTarget = target; }
+        /// Gets the render target whose statistics are kept with each frame
+        RenderTarget* getRenderTarget(void) const { return mRenderTarget; }
+
+        /** Sets the directory capture files are written to (default the
+            current directory). */
+        void setCaptureDirectory(const String& directory) { mCaptureDirectory = directory; }
+        /// Gets the directory capture files are written to
+        const String& getCaptureDirectory(void) const { return mCaptureDirectory; }
+
+        /** Sets the number of capture files written at most (default 10), 0 to
+            only count spikes. */
+        void setMaxCaptures(size_t count) { mMaxCaptures = count; }
+        /// Gets the number of capture files written at most
+        size_t getMaxCaptures(void) const { return mMaxCaptures; }
+
+        /// Gets the number of frames which exceeded the threshold
+        size_t getNumSpikes(void) const { return mNumSpikes; }
+        /// Gets the files written so far
+        const StringVector& getCaptureFiles(void) const { return mCaptureFiles; }
+
+        /** Writes the last frames as if the last one was a spike, regardless
+            of the threshold and the number of captures.
+        @return The name of the file written
+        */
+        String captureNow(void);
+
+        /** Writes the timeline of the kept frames from first to last, oldest
+            first, as a Chrome trace event JSON document.
+        @param stream The stream to write to
+        @param first Index of the first frame written, 0 being the oldest kept
+        @param count Number of frames written
+        */
+        void writeFrames(std::ostream& stream, size_t first, size_t count) const;
+
+        /** Gets the number of frames currently kept. */
+        size_t getNumFrames(void) const { return std::min(mFrameCount, mFrames.size()); }
+
+    protected:
+        struct Frame
+        {
+            ulong startTime;
+            ulong duration;
+            /// See Root::getNextFrameNumber
+            unsigned long frameNumber;
+            /// The statistics of mRenderTarget when the frame ended
+            RenderTarget::FrameStats stats;
+            bool hasStats;
+        };
+        typedef vector<Frame>::type FrameList;
+        /// Ring buffer of the last frames, the next frame goes to mFrameCount % size
+        FrameList mFrames;
+        size_t mFrameCount;
+        /// Depth of the profile being run, 0 between frames
+        size_t mDepth;
+
+        ulong mThreshold;
+        size_t mFramesBefore;
+        size_t mFramesAfter;
+        RenderTarget* mRenderTarget;
+        String mCaptureDirectory;
+        size_t mMaxCaptures;
+        size_t mNumSpikes;
+        StringVector mCaptureFiles;
+        /// Frames still to run before the pending capture is written, 0 if none
+        size_t mPendingFrames;
+        /// Number of the frame the pending capture is about
+        size_t mPendingSpike;
+
+        /// Adds a frame and checks it against the threshold
+        virtual void frameEnded(ulong startTime, ulong endTime);
+        /** Writes the kept frames around a spike to a new file in the capture
+            directory, and summarises them in the log. */
+        String capture(size_t spike, size_t before, size_t after);
+        /// Gets a kept frame by its number since the session began
+        const Frame& getFrame(size_t number) const { return mFrames[number % mFrames.size()]; }
+    };
+    /** @} */
+    /** @} */
+
+} // end namespace
+
+#include "OgreHeaderSuffix.h"
+
+#endif
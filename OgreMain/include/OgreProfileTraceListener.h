@@ -0,0 +1,142 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __ProfileTraceListener_H__
+#define __ProfileTraceListener_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreProfiler.h"
+#include "OgreAtomicScalar.h"
+#include "Threading/OgreThreadHeaders.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+    /** ProfileSessionListener which records a timeline of the profiles and
+        writes it in the Chrome trace event format.
+    @remarks
+        Every profile call is stored as one event, holding its name, thread,
+        start time and duration, in a ring buffer of a fixed number of events.
+        Once the buffer is full the oldest events are overwritten, so the
+        buffer always holds the most recent part of the timeline. The result
+        can be loaded into chrome://tracing or any other viewer understanding
+        the trace event format, which shows frame spikes and the work of
+        other threads far better than per frame averages.
+    @par
+        The Profiler itself may only be used from one thread, but recordEvent
+        can be called from any thread, for example by background loading or
+        worker threads timing their own work with the profiler's timer. Slots
+        are claimed through an atomic counter, so recording never locks.
+    */
+    class _OgreExport ProfileTraceListener : public ProfileSessionListener, public ProfilerAlloc
+    {
+    public:
+        /** Constructor.
+        @param capacity The number of events the ring buffer holds
+        */
+        ProfileTraceListener(size_t capacity = 16384);
+        virtual ~ProfileTraceListener();
+
+        /// @see ProfileSessionListener::initializeSession
+        virtual void initializeSession();
+
+        /// @see ProfileSessionListener::finializeSession
+        virtual void finializeSession();
+
+        /// @see ProfileSessionListener::profileEnded
+        virtual void profileEnded(const String& profileName, ulong startTime, ulong endTime);
+
+        /** Records an event on the calling thread's timeline.
+        @remarks
+            Safe to call from any thread. Names longer than the space of an
+            event are truncated.
+        @param name The name of the event
+        @param startTime The time the event began, in microseconds
+        @param endTime The time the event ended, in microseconds
+        @param bytes Amount of data the event processed, written as an argument
+            of the event unless 0
+        */
+        void recordEvent(const String& name, ulong startTime, ulong endTime, size_t bytes = 0);
+
+        /** Discards all recorded events. */
+        void clear(void);
+
+        /** Returns the number of events currently held by the ring buffer. */
+        size_t getNumEvents(void) const;
+
+        /** Writes the recorded events as a Chrome trace event JSON document.
+        @remarks
+            Events recorded while this runs may be left out.
+        */
+        void writeTrace(std::ostream& stream) const;
+
+        /** Writes the recorded events as a Chrome trace event JSON file. */
+        void writeTrace(const String& filename) const;
+
+    protected:
+        /// Longest event name stored, including the terminator
+        static const size_t MAX_NAME_LENGTH = 48;
+
+        struct Event
+        {
+            /// Index of the event + 1 once it's completely written, 0 while writing
+            volatile uint32 sequence;
+            char name[MAX_NAME_LENGTH];
+            ulong startTime;
+            ulong duration;
+            size_t bytes;
+#if OGRE_THREAD_SUPPORT
+            OGRE_THREAD_ID_TYPE threadId;
+#endif
+        };
+        typedef vector<Event>::type EventList;
+        EventList mEvents;
+
+        /** Writes the recorded events starting between beginTime and endTime as
+            elements of a trace event array.
+        @param firstEvent Whether nothing was written to the array yet, updated
+        */
+        void writeEvents(std::ostream& stream, ulong beginTime, ulong endTime, bool& firstEvent) const;
+        /// Writes a string escaped for JSON, without quotes
+        static void writeEscaped(std::ostream& stream, const char* str);
+
+        /// Total number of events recorded, the next event goes to mCount % capacity
+        AtomicScalar<uint32> mCount;
+    };
+    /** @} */
+    /** @} */
+
+} // end namespace
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -52,6 +52,8 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 #   define OgreProfileGroup( a, g ) Ogre::Profile _OgreProfileInstance( (a), (g) )
 #   define OgreProfileBeginGroup( a, g ) Ogre::Profiler::getSingleton().beginProfile( (a), (g) )
 #   define OgreProfileEndGroup( a, g ) Ogre::Profiler::getSingleton().endProfile( (a), (g) )
+#   define OgreProfileFast( a ) static const Ogre::ProfileScope _OgreProfileScope( (a) ); Ogre::Profile _OgreProfileInstance( _OgreProfileScope )
+#   define OgreProfileFastGroup( a, g ) static const Ogre::ProfileScope _OgreProfileScope( (a), (g) ); Ogre::Profile _OgreProfileInstance( _OgreProfileScope )
 #   define OgreProfileBeginGPUEvent( g ) Ogre::Profiler::getSingleton().beginGPUEvent(g)
 #   define OgreProfileEndGPUEvent( g ) Ogre::Profiler::getSingleton().endGPUEvent(g)
 #   define OgreProfileMarkGPUEvent( e ) Ogre::Profiler::getSingleton().markGPUEvent(e)
@@ -62,6 +64,8 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 #   define OgreProfileGroup( a, g ) 
 #   define OgreProfileBeginGroup( a, g ) 
 #   define OgreProfileEndGroup( a, g ) 
+#   define OgreProfileFast( a )
+#   define OgreProfileFastGroup( a, g )
 #   define OgreProfileBeginGPUEvent( e )
 #   define OgreProfileEndGPUEvent( e )
 #   define OgreProfileMarkGPUEvent( e )
@@ -90,6 +94,32 @@ namespace Ogre {
         OGREPROF_RENDERING = 0x20000000
     };
 
+    /** A profile name registered once, for profiles in performance critical code
+        @remarks
+            Every ProfileScope gets a unique id when it is constructed, which the
+            Profiler uses to find the profile without creating or comparing strings.
+            Use the macro OgreProfileFast(name), which declares a static ProfileScope,
+            or declare a static ProfileScope yourself and pass it to the Profile
+            constructor or to Profiler::beginProfile and Profiler::endProfile.
+    */
+    class _OgreExport ProfileScope : public ProfilerAlloc
+    {
+        public:
+            ProfileScope(const String& profileName, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT);
+
+            /// Gets the name of this profile
+            const String& getName(void) const { return mName; }
+            /// Gets the group ID of this profile
+            uint32 getGroupID(void) const { return mGroupID; }
+            /// Gets the unique id of this profile scope
+            uint32 getId(void) const { return mId; }
+
+        protected:
+            String mName;
+            uint32 mGroupID;
+            uint32 mId;
+    };
+
     /** An individual profile that will be processed by the Profiler
         @remarks
             Use the macro OgreProfile(name) instead of instantiating this profile directly
@@ -106,6 +136,8 @@ namespace Ogre {
 
         public:
             Profile(const String& profileName, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT);
+            /// Constructor for a profile registered through a ProfileScope
+            Profile(const ProfileScope& scope);
             ~Profile();
 
         protected:
@@ -114,6 +146,8 @@ namespace Ogre {
             String mName;
             /// The group ID
             uint32 mGroupID;
+            /// The scope of this profile, null if profiled by name
+            const ProfileScope* mScope;
             
     };
 
@@ -167,6 +201,17 @@ namespace Ogre {
         /// The hierarchical level of this profile, 0 being the root profile
         uint    hierarchicalLvl;
 
+        /// The GPU time this profile has taken in the latest frame whose GPU timings are known, in milliseconds
+        Real    currentGpuTimeMillisecs;
+        /// The maximum GPU time this profile has taken in a frame, in milliseconds
+        Real    maxGpuTimeMillisecs;
+        /// The minimum GPU time this profile has taken in a frame, in milliseconds
+        Real    minGpuTimeMillisecs;
+        /// The total GPU time this profile has taken, in milliseconds
+        Real    totalGpuTimeMillisecs;
+        /// The number of frames the GPU time was measured in (used to calculate average)
+        ulong   totalGpuFrames;
+
     };
 
     /// Represents an individual profile call
@@ -178,6 +223,7 @@ namespace Ogre {
         virtual ~ProfileInstance(void);
 
         typedef Ogre::map<String,ProfileInstance*>::type ProfileChildren;
+        typedef Ogre::vector<std::pair<uint32, ProfileInstance*> >::type ProfileScopeChildren;
 
         void logResults();
         void reset();
@@ -204,9 +250,15 @@ namespace Ogre {
 
         ProfileChildren children;
 
+        /// The children started through a ProfileScope, by scope id
+        ProfileScopeChildren scopeChildren;
+
         ProfileFrame frame;
         ulong frameNumber;
 
+        /// The GPU time (in nanoseconds) of a profile started by a GPU event, accumulated as results come in
+        ProfileFrame gpuFrame;
+
         ProfileHistory history;
 
         /// The time this profile was started
@@ -254,6 +306,22 @@ namespace Ogre {
         /// Here we get the real profiling information which we can use 
         virtual void displayResults(const ProfileInstance& instance, ulong maxTotalFrameTime) {};
 
+        /** Called when a profile which passed the group mask and isn't disabled begins.
+        @param profileName The name of the profile
+        @param startTime The time the profile began, in microseconds of the profiler's timer
+        */
+        virtual void profileStarted(const String& profileName, ulong startTime) {}
+
+        /** Called when a profile which passed the group mask and isn't disabled ends.
+        @remarks
+            Unlike displayResults, this is called for every single call of a profile,
+            so it can be used to record a timeline of the profiles.
+        @param profileName The name of the profile
+        @param startTime The time the profile began, in microseconds of the profiler's timer
+        @param endTime The time the profile ended, in microseconds of the profiler's timer
+        */
+        virtual void profileEnded(const String& profileName, ulong startTime, ulong endTime) {}
+
         /// Set the display mode for the overlay. 
         void setDisplayMode(DisplayMode d) { mDisplayMode = d; }
     
@@ -321,8 +389,28 @@ namespace Ogre {
             */
             void endProfile(const String& profileName, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT);
 
+            /** Begins a profile registered through a ProfileScope
+            @remarks
+                Behaves like beginProfile(scope.getName(), scope.getGroupID()), but
+                finds the profile by the scope id instead of its name, so it's cheap
+                enough for tight loops. Profiles begun by name and by scope can be
+                mixed freely.
+            */
+            void beginProfile(const ProfileScope& scope);
+
+            /** Ends a profile registered through a ProfileScope
+            @see beginProfile(const ProfileScope&)
+            */
+            void endProfile(const ProfileScope& scope);
+
             /** Mark the beginning of a GPU event group
              @remarks Can be safely called in the middle of the profile.
+             @remarks
+                If the profiler is enabled, the event is inside a profile and the render
+                system supports GPU timers, the event is also profiled as a child of the
+                current profile with the OGREPROF_RENDERING group. Its GPU time shows up in
+                the GPU fields of ProfileHistory, a few frames late since the timers are
+                never waited upon.
              */
             void beginGPUEvent(const String& event);
 
@@ -465,9 +553,22 @@ namespace Ogre {
             /** Processes specific ProfileInstance and it's children recursively.*/
             void processFrameStats(ProfileInstance* instance, Real& maxFrameTime);
 
+            /** Collects the GPU timers whose results have become available */
+            void processGpuSamples(void);
+            /** Records the GPU time accumulated for the frame being resolved in the history */
+            void commitGpuFrame(void);
+            /** Drops all the GPU timers waiting for their result */
+            void releaseGpuSamples(void);
+
             /** Handles a change of the profiler's enabled state*/
             void changeEnableState();
 
+            /** Returns the child of the current profile with the given name, creating it if needed */
+            ProfileInstance* getCurrentChild(const String& profileName);
+
+            /** Makes the given child of the current profile current and starts timing it */
+            void startProfile(ProfileInstance* instance);
+
             // lol. Uses typedef; put's original container type in name.
             typedef set<String>::type DisabledProfileMap;
             typedef ProfileInstance::ProfileChildren ProfileChildren;
@@ -479,6 +580,25 @@ namespace Ogre {
             /// Holds the names of disabled profiles
             DisabledProfileMap mDisabledProfiles;
 
+            /// A GPU timer of a profile
+            struct GpuSample
+            {
+                ProfileInstance* instance;
+                /// The render system timer, 0 if not timed
+                uint32 timer;
+                uint frameNumber;
+            };
+            typedef deque<GpuSample>::type GpuSampleList;
+
+            /// The open GPU events, innermost last
+            vector<GpuSample>::type mGpuEvents;
+            /// The timers of the ended GPU events waiting for their result, in issue order
+            GpuSampleList mPendingGpuSamples;
+            /// The profiles whose GPU time was accumulated for mGpuFrameNumber
+            vector<ProfileInstance*>::type mGpuFrameInstances;
+            /// The frame whose GPU results are being accumulated
+            uint mGpuFrameNumber;
+
             /// Whether the GUI elements have been initialized
             bool mInitialized;
 
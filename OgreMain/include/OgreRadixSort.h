@@ -77,6 +77,12 @@ namespace Ogre {
     @endcode
         You should try to reuse RadixSort instances, since repeated allocation of the 
         internal storage is then avoided.
+    @par
+        Containers which are already sorted are left untouched, and containers
+        which are nearly sorted, such as the particles of a system seen by a
+        camera which moved little since the last frame, are finished with an
+        insertion sort rather than the radix passes (see setCoherentSorting).
+        Radix passes over a byte which is the same in all the keys are skipped.
     @note
         Radix sorting is often associated with just unsigned integer values. Our
         implementation can handle both unsigned and signed integers, as well as
@@ -91,8 +97,8 @@ namespace Ogre {
         typedef typename TContainer::iterator ContainerIter;
     protected:
         /// Alpha-pass counters of values (histogram)
-        /// 4 of them so we can radix sort a maximum of a 32bit value
-        int mCounters[4][256];
+        /// 8 of them so we can radix sort a maximum of a 64bit value
+        int mCounters[8][256];
         /// Beta-pass offsets 
         int mOffsets[256];
         /// Sort area size
@@ -103,10 +109,9 @@ namespace Ogre {
         struct SortEntry
         {
             TCompValueType key;
-            ContainerIter iter;
-            SortEntry() {}
-            SortEntry(TCompValueType k, ContainerIter it)
-                : key(k), iter(it) {}
+            TContainerValueType value;
+            SortEntry(TCompValueType k, const TContainerValueType& v)
+                : key(k), value(v) {}
 
         };
         /// Temp sort storage
@@ -115,7 +120,36 @@ namespace Ogre {
         SortVector mSortArea2;
         SortVector* mSrc;
         SortVector* mDest;
-        TContainer mTmpContainer; // initial copy
+        /// Whether nearly sorted input is finished with an insertion sort
+        bool mCoherentSorting;
+
+        /** Insertion sort of mSortArea1, giving up after a number of moves.
+        @return True if the area was sorted, false if it is only partly sorted
+        */
+        bool insertionSort(size_t maxMoves)
+        {
+            size_t moves = 0;
+            for (int i = 1; i < mSortSize; ++i)
+            {
+                if (!(mSortArea1[i].key < mSortArea1[i-1].key))
+                    continue;
+
+                SortEntry entry = mSortArea1[i];
+                int j = i;
+                do
+                {
+                    mSortArea1[j] = mSortArea1[j-1];
+                    --j;
+                }
+                while (j > 0 && entry.key < mSortArea1[j-1].key);
+                mSortArea1[j] = entry;
+
+                moves += i - j;
+                if (moves > maxMoves)
+                    return false;
+            }
+            return true;
+        }
 
 
         void sortPass(int byteIndex)
@@ -234,9 +268,21 @@ namespace Ogre {
 
     public:
 
-        RadixSort() {}
+        RadixSort() : mCoherentSorting(true) {}
         ~RadixSort() {}
 
+        /** Sets whether nearly sorted containers are finished with an insertion
+            sort rather than radix passes (default true).
+        @remarks
+            Containers with only a few keys out of order are typical of
+            objects sorted each frame by depth, since the order changes little
+            between frames. The insertion sort gives up and the radix passes
+            take over if the container turns out to need many moves.
+        */
+        void setCoherentSorting(bool coherent) { mCoherentSorting = coherent; }
+        /// Gets whether nearly sorted containers are finished with an insertion sort
+        bool getCoherentSorting(void) const { return mCoherentSorting; }
+
         /** Main sort function
         @param container A container of the type you declared when declaring
         @param func A functor which returns the value for comparison when given
@@ -250,11 +296,11 @@ namespace Ogre {
 
             // Set up the sort areas
             mSortSize = static_cast<int>(container.size());
-            mSortArea1.resize(container.size());
-            mSortArea2.resize(container.size());
-
-            // Copy data now (we need constant iterators for sorting)
-            mTmpContainer = container;
+            // Values need not be default constructible, so fill with copies
+            // of the first one
+            SortEntry proto(TCompValueType(), container.front());
+            mSortArea1.resize(container.size(), proto);
+            mSortArea2.resize(container.size(), proto);
 
             mNumPasses = sizeof(TCompValueType);
 
@@ -265,20 +311,20 @@ namespace Ogre {
                 memset(mCounters[p], 0, sizeof(int) * 256);
 
             // Perform alpha pass to count
-            ContainerIter i = mTmpContainer.begin();
+            ContainerIter i = container.begin();
             TCompValueType prevValue = func.operator()(*i); 
-            bool needsSorting = false;
-            for (int u = 0; i != mTmpContainer.end(); ++i, ++u)
+            int numDescents = 0;
+            for (int u = 0; i != container.end(); ++i, ++u)
             {
                 // get sort value
                 TCompValueType val = func.operator()(*i);
                 // cheap check to see if needs sorting (temporal coherence)
-                if (!needsSorting && val < prevValue)
-                    needsSorting = true;
+                if (val < prevValue)
+                    ++numDescents;
 
                 // Create a sort entry
                 mSortArea1[u].key = val;
-                mSortArea1[u].iter = i;
+                mSortArea1[u].value = *i;
 
                 // increase counters
                 for (p = 0; p < mNumPasses; ++p)
@@ -292,31 +338,45 @@ namespace Ogre {
             }
 
             // early exit if already sorted
-            if (!needsSorting)
+            if (numDescents == 0)
                 return;
 
-
-            // Sort passes
-            mSrc = &mSortArea1;
-            mDest = &mSortArea2;
-
-            for (p = 0; p < mNumPasses - 1; ++p)
+            // Nearly sorted, as it usually is from one frame to the next; an
+            // insertion sort is cheaper than the radix passes unless some
+            // keys have to move far
+            if (mCoherentSorting && numDescents <= mSortSize / 16 + 1 &&
+                insertionSort(static_cast<size_t>(mSortSize) * 4))
             {
-                sortPass(p);
-                // flip src/dst
-                SortVector* tmp = mSrc;
-                mSrc = mDest;
-                mDest = tmp;
+                mDest = &mSortArea1;
+            }
+            else
+            {
+                // Sort passes
+                mSrc = &mSortArea1;
+                mDest = &mSortArea2;
+
+                for (p = 0; p < mNumPasses - 1; ++p)
+                {
+                    // Nothing to do if all the keys have the same value for this byte
+                    if (mCounters[p][getByte(p, mSortArea1[0].key)] == mSortSize)
+                        continue;
+
+                    sortPass(p);
+                    // flip src/dst
+                    SortVector* tmp = mSrc;
+                    mSrc = mDest;
+                    mDest = tmp;
+                }
+                // Final pass may differ, make polymorphic
+                finalPass(p, prevValue);
             }
-            // Final pass may differ, make polymorphic
-            finalPass(p, prevValue);
 
             // Copy everything back
             int c = 0;
             for (i = container.begin(); 
                 i != container.end(); ++i, ++c)
             {
-                *i = *((*mDest)[c].iter);
+                *i = (*mDest)[c].value;
             }
         }
 
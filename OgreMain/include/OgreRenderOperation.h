@@ -41,6 +41,21 @@ namespace Ogre {
     /** \addtogroup RenderSystem
      *  @{
      */
+    /** Parameters of one draw inside a multi-draw indirect submission.
+    @remarks
+        The layout matches both GL's DrawElementsIndirectCommand and the argument
+        buffer of D3D11's DrawIndexedInstancedIndirect, so an array of these can be
+        uploaded to the GPU as is.
+    */
+    struct IndirectDrawCommand
+    {
+        uint32 indexCount;
+        uint32 instanceCount;
+        uint32 firstIndex;
+        int32  baseVertex;
+        uint32 baseInstance;
+    };
+
     /** 'New' rendering operation using vertex buffers. */
     class _OgrePrivate RenderOperation {
     public:
@@ -121,11 +136,34 @@ namespace Ogre {
             vertex instance buffer if available.*/
         bool useGlobalInstancingVertexBufferIsAvailable;
 
+        /** Optional list of draws submitted with a single multi-draw indirect call.
+        @remarks
+            Only valid if useIndexes is true and the render system reports
+            RSC_MULTI_DRAW_INDIRECT. When set, the index range of indexData, the
+            vertexStart of vertexData and numberOfInstances are ignored; each command
+            carries its own. The memory is owned by the caller and must stay valid
+            until _render returns.
+        */
+        const IndirectDrawCommand* indirectCommands;
+        /// Number of entries in indirectCommands. 0 means a regular draw
+        size_t numIndirectCommands;
+
+        /** Optional culler whose draw arguments are used instead, after it culled
+            them on the GPU.
+        @remarks
+            Only valid if useIndexes is true, with a culler created by the render
+            system drawing the operation. The index range of indexData, the
+            vertexStart of vertexData and numberOfInstances are ignored, as with
+            indirectCommands.
+        */
+        GpuDrawCuller* gpuDrawCuller;
+
     RenderOperation() :
         vertexData(0), operationType(OT_TRIANGLE_LIST), useIndexes(true),
             indexData(0), srcRenderable(0), numberOfInstances(1),
             renderToVertexBuffer(false),
-            useGlobalInstancingVertexBufferIsAvailable(true)
+            useGlobalInstancingVertexBufferIsAvailable(true),
+            indirectCommands(0), numIndirectCommands(0), gpuDrawCuller(0)
             {}
 
 
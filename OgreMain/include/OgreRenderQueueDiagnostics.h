@@ -0,0 +1,148 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __RenderQueueDiagnostics_H__
+#define __RenderQueueDiagnostics_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup RenderSystem
+    *  @{
+    */
+    /** Statistics of how well the render queue batches, gathered over a frame.
+    @remarks
+        The contents of the render queue are counted per queue group and
+        priority every time a camera renders the scene, and the renderables
+        drawn through the queue are followed in the order they are drawn in,
+        after sorting. A pass switch is counted whenever a renderable is drawn
+        with another pass than the one before it. A draw is counted as
+        instanceable when the renderable before it was drawn with the same pass
+        and the same vertex and index data, so both could have been drawn with
+        one instanced call.
+    @par
+        Created and used by the SceneManager, see
+        SceneManager::setRenderQueueDiagnosticsEnabled. Statistics are cleared
+        when the first camera of a frame renders, so they cover all the
+        viewports and shadow textures rendered during the last frame.
+    */
+    class _OgreExport RenderQueueDiagnostics : public RenderQueueAlloc
+    {
+    public:
+        /// Contents of one priority of one queue group
+        struct PriorityStats
+        {
+            uint8 queueGroup;
+            ushort priority;
+            /// Renderables queued, summed over the cameras rendered
+            size_t renderables;
+            /// Distinct passes among them, summed over the cameras rendered
+            size_t passes;
+        };
+        typedef vector<PriorityStats>::type PriorityStatsList;
+
+        /// Draws of the renderables of one material
+        struct MaterialStats
+        {
+            String material;
+            size_t draws;
+            /// Draws which switched to a pass of this material
+            size_t passSwitches;
+            /// Draws which could have been instanced with the draw before them
+            size_t instanceableDraws;
+        };
+        typedef vector<MaterialStats>::type MaterialStatsList;
+
+        RenderQueueDiagnostics();
+
+        /** Counts the contents of a render queue, before it is rendered.
+        @param queue The queue
+        @param frameNumber The current frame; statistics of older frames are cleared
+        */
+        void _countQueue(RenderQueue* queue, unsigned long frameNumber);
+        /** Counts the draw of a renderable through the render queue.
+        @param pass The pass it is drawn with
+        @param rend The renderable
+        */
+        void _notifyDraw(const Pass* pass, Renderable* rend);
+        /** Counts a renderable which was drawn with automatic instancing. */
+        void _notifyAutoInstanced(void) { ++mAutoInstanced; }
+
+        /** Gets the contents of the render queue per queue group and priority, in
+            ascending order. */
+        PriorityStatsList getPriorityStats(void) const;
+        /** Gets the draws per material, those with the most instanceable draws and
+            pass switches first. */
+        MaterialStatsList getMaterialStats(void) const;
+        /// Gets the number of distinct passes in the render queue
+        size_t getNumUniquePasses(void) const { return mUniquePasses.size(); }
+        /// Gets the number of renderables drawn one by one
+        size_t getNumDraws(void) const { return mDraws; }
+        /// Gets the number of draws which switched pass
+        size_t getNumPassSwitches(void) const { return mPassSwitches; }
+        /// Gets the number of draws which could have been instanced with the draw before them
+        size_t getNumInstanceableDraws(void) const { return mInstanceableDraws; }
+        /// Gets the number of renderables drawn with automatic instancing
+        size_t getNumAutoInstanced(void) const { return mAutoInstanced; }
+
+        /** Writes the totals and the materials with the most instanceable draws
+            and pass switches to the log.
+        @param count The number of materials to list
+        */
+        void logWorstMaterials(size_t count = 10) const;
+
+        /// Clears the statistics
+        void clear(void);
+
+    protected:
+        typedef map<uint32, PriorityStats>::type PriorityStatsMap;
+        typedef map<const Material*, MaterialStats>::type MaterialStatsMap;
+
+        unsigned long mFrameNumber;
+        PriorityStatsMap mPriorityStats;
+        MaterialStatsMap mMaterialStats;
+        set<const Pass*>::type mUniquePasses;
+        size_t mDraws;
+        size_t mPassSwitches;
+        size_t mInstanceableDraws;
+        size_t mAutoInstanced;
+        /// The last draw, to find pass switches and instanceable draws
+        const Pass* mLastPass;
+        const VertexData* mLastVertexData;
+        const IndexData* mLastIndexData;
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
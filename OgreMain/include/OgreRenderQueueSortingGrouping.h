@@ -127,7 +127,21 @@ namespace Ogre {
             /** Sort ascending camera distance 
                 Note value overlaps with descending since both use same sort
             */
-            OM_SORT_ASCENDING = 6
+            OM_SORT_ASCENDING = 6,
+            /** Group by pass, using a flat list sorted by a 64-bit key
+                instead of a map of lists.
+            @remarks
+                The key holds the pass sort key (see Pass::getSortKey) in the
+                upper 48 bits, so passes sharing programs, textures, blending
+                and depth state are adjacent, then bits of the pass address to
+                separate passes with the same sort key, then the view depth, so
+                renderables using the same pass are ordered front to back. A
+                visitor requesting OM_PASS_GROUP is given this ordering when
+                OM_PASS_GROUP itself was not requested. Adding a renderable is
+                then just an append, which avoids the map lookups and list
+                allocations of OM_PASS_GROUP.
+            */
+            OM_SORT_KEY = 8
         };
 
     protected:
@@ -228,6 +242,32 @@ namespace Ogre {
         /// Radix sorter for sort value 2 (distance)
         static RadixSort<RenderablePassList, RenderablePass, float> msRadixSorter2;
 
+        /// Functor for 64-bit sort key for radix sort (pass, then ascending distance)
+        struct RadixSortFunctorKey
+        {
+            const Camera* camera;
+
+            RadixSortFunctorKey(const Camera* cam)
+                : camera(cam)
+            {
+            }
+
+            uint64 operator()(const RenderablePass& p) const
+            {
+                // Bit pattern of a positive float orders the same way as its value,
+                // the upper 10 bits are enough for a coarse front to back order
+                union { float f; uint32 u; } depth;
+                depth.f = static_cast<float>(p.renderable->getSquaredViewDepth(camera));
+                // Different passes can have the same sort key, so keep them apart
+                // with some bits of the pass address
+                uint32 passBits = static_cast<uint32>(reinterpret_cast<size_t>(p.pass) >> 4) & 0x3F;
+                return p.pass->getSortKey() | (passBits << 10) | (depth.u >> 22);
+            }
+        };
+
+        /// Radix sorter for the 64-bit sort key
+        static RadixSort<RenderablePassList, RenderablePass, uint64> msRadixSorterKey;
+
         /// Bitmask of the organisation modes requested
         uint8 mOrganisationMode;
 
@@ -235,6 +275,8 @@ namespace Ogre {
         PassGroupRenderableMap mGrouped;
         /// Sorted descending (can iterate backwards to get ascending)
         RenderablePassList mSortedDescending;
+        /// Sorted by 64-bit key
+        RenderablePassList mSortedByKey;
 
         /// Internal visitor implementation
         void acceptVisitorGrouped(QueuedRenderableVisitor* visitor) const;
@@ -242,6 +284,8 @@ namespace Ogre {
         void acceptVisitorDescending(QueuedRenderableVisitor* visitor) const;
         /// Internal visitor implementation
         void acceptVisitorAscending(QueuedRenderableVisitor* visitor) const;
+        /// Internal visitor implementation
+        void acceptVisitorSortKey(QueuedRenderableVisitor* visitor) const;
 
     public:
         QueuedRenderableCollection();
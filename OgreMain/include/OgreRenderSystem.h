@@ -39,6 +39,7 @@ THE SOFTWARE.
 #include "OgreGpuProgram.h"
 #include "OgrePlane.h"
 #include "OgreHardwareVertexBuffer.h"
+#include "OgreRenderTarget.h"
 #include "OgreHeaderPrefix.h"
 
 namespace Ogre
@@ -91,6 +92,19 @@ namespace Ogre
         SOP_INVERT
     };
 
+    /// The kinds of draws whose batches RenderSystem::RenderStatistics counts separately
+    enum DrawCategory
+    {
+        /// Objects of the scene, and anything not otherwise categorised
+        DC_SCENE,
+        /// Shadow casters rendered to shadow textures, and stencil shadow volumes
+        DC_SHADOW,
+        /// Passes injected by compositors, such as full screen quads
+        DC_COMPOSITOR,
+        /// The overlay render queue
+        DC_OVERLAY,
+        DC_COUNT
+    };
 
     /** Defines the functionality of a 3D API
     @remarks
@@ -182,6 +196,12 @@ namespace Ogre
         */
         virtual void destroyHardwareOcclusionQuery(HardwareOcclusionQuery *hq);
 
+        /** Create an object culling draws or instances on the GPU.
+        @return The culler, to be deleted with OGRE_DELETE, or null if the
+            render system can't cull on the GPU.
+        */
+        virtual GpuDrawCuller* createGpuDrawCuller(void) { return 0; }
+
         /** Validates the options set for the rendering system, returning a message if there are problems.
         @note
         If the returned string is empty, there are no problems.
@@ -1074,6 +1094,46 @@ namespace Ogre
         /** Reports the number of vertices passed to the renderer since the last _beginGeometryCount call. */
         virtual unsigned int _getVertexCount(void) const;
 
+        /** Counters of the work submitted to the render system since it was created.
+        @remarks
+            The counters only ever grow; RenderTarget::FrameStats reports how far
+            they advanced during the last update of a target. State changes are
+            counted once they reach the render system, so the changes filtered out
+            by SceneManager::setRedundantStateFiltering are not included.
+        */
+        struct RenderStatistics
+        {
+            /// GPU programs bound
+            size_t programBinds;
+            /// Texture units set
+            size_t textureBinds;
+            /// Scene blending changes
+            size_t blendChanges;
+            /// Depth function, depth check or depth write changes
+            size_t depthChanges;
+            /// Draws using another vertex declaration than the previous draw
+            size_t vertexDeclarationChanges;
+            /// Draws to another render target than the previous draw
+            size_t renderTargetChanges;
+            /// Bytes of GPU program constants bound, dirty or not
+            size_t constantBytes;
+            /// Batches rendered for each DrawCategory
+            size_t categoryBatches[DC_COUNT];
+
+            RenderStatistics() { memset(this, 0, sizeof(RenderStatistics)); }
+        };
+
+        /** Gets the counters of the work submitted to the render system. */
+        const RenderStatistics& getRenderStatistics(void) const { return mStatistics; }
+        /** Gets the counters of the work submitted to the render system, for the
+            callers which filter state changes before they reach it. */
+        RenderStatistics& _getRenderStatistics(void) { return mStatistics; }
+
+        /** Sets the category the batches rendered from now on are counted under. */
+        void _setDrawCategory(DrawCategory category) { mDrawCategory = category; }
+        /** Gets the category the batches are currently counted under. */
+        DrawCategory _getDrawCategory(void) const { return mDrawCategory; }
+
         /** Generates a packed data version of the passed in ColourValue suitable for
         use as with this RenderSystem.
         @remarks
@@ -1342,6 +1402,33 @@ namespace Ogre
         if _updateAllRenderTargets was called with a 'false' parameter. */
         virtual void _swapAllRenderTargetBuffers();
 
+        /** Sets whether the viewports of all the render targets are culled up front.
+        @remarks
+            When enabled, _updateAllRenderTargets first hands the cameras of the
+            auto updated viewports of the active targets to their SceneManager
+            (see SceneManager::_prepareCameras), which culls them all in a single
+            parallel pass before any target is updated. Targets are then updated
+            and submitted to the GPU one after the other as before, reusing the
+            culling results. Only scene managers with batch culling enabled
+            take part. The default is false.
+        */
+        void setParallelTargetPreparation(bool parallel) { mParallelTargetPreparation = parallel; }
+        /** Gets whether the viewports of all the render targets are culled up front. */
+        bool getParallelTargetPreparation(void) const { return mParallelTargetPreparation; }
+
+        /** Sets the maximum number of frames the CPU may queue ahead of the GPU.
+        @remarks
+            Drivers usually let the CPU run 2 or 3 frames ahead, which keeps the
+            GPU busy but delays the display of the input read by each frame.
+            With a limit, _swapAllRenderTargetBuffers marks the end of each frame
+            with a GPU fence, and waits for the fence of the frame this many
+            frames earlier. 1 gives the lowest latency, 0 (the default) leaves
+            it to the driver. Render systems without fences ignore the limit.
+        */
+        virtual void setMaxFrameLatency(uint16 frames) { mMaxFrameLatency = frames; }
+        /** Gets the maximum number of frames the CPU may queue ahead of the GPU. */
+        uint16 getMaxFrameLatency(void) const { return mMaxFrameLatency; }
+
         /** Sets whether or not vertex windings set should be inverted; this can be important
         for rendering reflections. */
         virtual void setInvertVertexWinding(bool invert);
@@ -1561,6 +1648,52 @@ namespace Ogre
         */
         virtual void markProfileEvent( const String &event ) = 0;
 
+        /// Status of a GPU timer, @see _getGpuTimerResult
+        enum GpuTimerStatus
+        {
+            /// The GPU hasn't got past the end of the timer yet
+            GTS_PENDING,
+            /// The elapsed time is available
+            GTS_AVAILABLE,
+            /// The timestamps are unreliable (e.g. the GPU clock changed), the timer is discarded
+            GTS_INVALID
+        };
+
+        /** Starts measuring the GPU time taken by the commands issued until the matching
+            _endGpuTimer call.
+        @remarks
+            Timers may be nested. They are backed by a pool of timestamp queries which are never
+            waited upon, so results only become available a few frames later.
+        @return
+            A handle to the timer, or 0 if the render system can't measure GPU time.
+        */
+        virtual uint32 _beginGpuTimer(void) { return 0; }
+
+        /** Stops measuring the GPU time of a timer started with _beginGpuTimer. */
+        virtual void _endGpuTimer(uint32 timer) {}
+
+        /** Gets the GPU time measured by a timer, without stalling.
+        @remarks
+            Unless GTS_PENDING is returned the timer is released, and its handle
+            mustn't be used anymore.
+        @param elapsedNanosecs Receives the GPU time between the beginning and the end
+            of the timer, if GTS_AVAILABLE is returned
+        */
+        virtual GpuTimerStatus _getGpuTimerResult(uint32 timer, uint64& elapsedNanosecs) { return GTS_INVALID; }
+
+        /** Releases a timer whose result isn't needed anymore. */
+        virtual void _releaseGpuTimer(uint32 timer) {}
+
+        /** Starts copying the contents of a render target to memory without stalling.
+        @remarks
+            Used by RenderTarget::copyContentsToMemoryAsync, the box has been validated.
+        @return
+            The pending readback, or a null pointer if the render system can't read
+            back the target asynchronously.
+        */
+        virtual PixelReadbackPtr _copyContentsToMemoryAsync(RenderTarget* target, const Box& src,
+            PixelFormat format, RenderTarget::FrameBuffer buffer) { return PixelReadbackPtr(); }
+
         /** Determines if the system has anisotropic mip map filter support
         */
         virtual bool hasAnisotropicMipMapFilter() const = 0;
@@ -1619,6 +1752,12 @@ namespace Ogre
         size_t mFaceCount;
         size_t mVertexCount;
 
+        RenderStatistics mStatistics;
+        DrawCategory mDrawCategory;
+        /// Vertex declaration and render target of the last draw, to count switches
+        const VertexDeclaration* mLastDrawDeclaration;
+        const RenderTarget* mLastDrawTarget;
+
         /// Saved manual colour blends
         ColourValue mManualBlendColours[OGRE_MAX_TEXTURE_LAYERS][2];
 
@@ -1646,6 +1785,21 @@ namespace Ogre
         /// is fixed pipeline enabled
         bool mEnableFixedPipeline;
 
+        /// frames the CPU may queue ahead of the GPU, 0 for no limit
+        uint16 mMaxFrameLatency;
+
+        /// cull the viewports of all targets up front, see setParallelTargetPreparation
+        bool mParallelTargetPreparation;
+        /// hands the cameras of the targets about to be updated to their scene managers
+        void prepareRenderTargets(void);
+
+        /** Marks the end of the commands of a frame, and waits until at most
+            mMaxFrameLatency frames are queued. Called at the end of
+            _swapAllRenderTargetBuffers, also when there is no limit so that
+            fences left over can be released.
+        */
+        virtual void limitFrameLatency(void) {}
+
         /** updates pass iteration rendering state including bound gpu program parameter
         pass iteration auto constant entry
         @return True if more iterations are required
@@ -63,8 +63,9 @@ namespace Ogre
         CAPS_CATEGORY_COMMON_2 = 1,
         CAPS_CATEGORY_D3D9 = 2,
         CAPS_CATEGORY_GL = 3,
+        CAPS_CATEGORY_COMMON_3 = 4,
         /// Placeholder for max value
-        CAPS_CATEGORY_COUNT = 4
+        CAPS_CATEGORY_COUNT = 5
     };
 
     /// Enum describing the different hardware capabilities we want to check for
@@ -87,6 +88,8 @@ namespace Ogre
         RSC_CUBEMAPPING             = OGRE_CAPS_VALUE(CAPS_CATEGORY_COMMON, 4),
         /// Supports hardware stencil buffer
         RSC_HWSTENCIL               = OGRE_CAPS_VALUE(CAPS_CATEGORY_COMMON, 5),
+        /// Supports submitting several indexed draws with one indirect call
+        RSC_MULTI_DRAW_INDIRECT     = OGRE_CAPS_VALUE(CAPS_CATEGORY_COMMON, 6),
         /// Supports hardware vertex and index buffers
         /// @deprecated All targetted APIs by Ogre support this feature
         RSC_VBO                     = OGRE_CAPS_VALUE(CAPS_CATEGORY_COMMON, 7),
@@ -193,6 +196,8 @@ namespace Ogre
         RSC_READ_BACK_AS_TEXTURE = OGRE_CAPS_VALUE(CAPS_CATEGORY_COMMON_2, 26),
         /// Supports HW gamma, both in the framebuffer and as texture.
         RSC_HW_GAMMA = OGRE_CAPS_VALUE(CAPS_CATEGORY_COMMON_2, 27),
+        /// Supports compressed textures in the ASTC format, low dynamic range profile
+        RSC_TEXTURE_COMPRESSION_ASTC = OGRE_CAPS_VALUE(CAPS_CATEGORY_COMMON_3, 0),
         // ***** DirectX specific caps *****
         /// Is DirectX feature "per stage constants" supported
         RSC_PERSTAGECONSTANT = OGRE_CAPS_VALUE(CAPS_CATEGORY_D3D9, 0),
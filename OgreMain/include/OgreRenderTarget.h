@@ -84,6 +84,37 @@ namespace Ogre {
             size_t triangleCount;
             size_t batchCount;
             int vBlankMissCount; // -1 means that the value is not applicable
+
+            /** @name Render system work during the last update
+                Counted from the start to the end of the update, so this includes
+                the targets updated meanwhile, such as shadow textures. See
+                RenderSystem::RenderStatistics.
+            */
+            /// @{
+            size_t programBinds;
+            size_t textureBinds;
+            size_t blendChanges;
+            size_t depthChanges;
+            size_t vertexDeclarationChanges;
+            size_t renderTargetChanges;
+            size_t constantBytes;
+            /// Bytes of hardware buffers locked or uploaded from shadow buffers
+            size_t lockedBytes;
+            /// Hardware buffer locks which may have waited for the GPU
+            size_t lockStalls;
+            /// Time spent waiting in hardware buffer locks, in microseconds
+            unsigned long lockWaitTime;
+            /// Hardware buffer locks which waited for at least the lock wait threshold
+            size_t lockWaits;
+            /// GPU programs compiled, a cause of hitches the warm-up should have avoided
+            size_t programsCompiled;
+            /** Time spent compiling, linking and generating GPU programs, in
+                microseconds, see GpuProgramManager::getCompileTimings */
+            unsigned long programCompileTime;
+            size_t shadowBatchCount;
+            size_t compositorBatchCount;
+            size_t overlayBatchCount;
+            /// @}
         };
 
         enum FrameBuffer
@@ -342,6 +373,18 @@ namespace Ogre {
         */
         OGRE_DEPRECATED void copyContentsToMemory(const PixelBox &dst, FrameBuffer buffer = FB_AUTO) { copyContentsToMemory(Box(0, 0, mWidth, mHeight), dst, buffer); }
 
+        /** Starts copying the current contents of the render target to memory,
+            without waiting for the GPU.
+        @remarks
+            The returned readback is polled for completion, see PixelReadback. Render
+            systems unable to read back asynchronously copy right away, the readback
+            is then ready immediately.
+        @param src Box of the render target to copy
+        @param format Format to read the pixels back in, see suggestPixelFormat
+        @param buffer Which buffer to copy, for render windows
+        */
+        virtual PixelReadbackPtr copyContentsToMemoryAsync(const Box& src, PixelFormat format, FrameBuffer buffer = FB_AUTO);
+
         /** Suggests a pixel format to use for extracting the data in this target, 
             when calling copyContentsToMemory.
         */
@@ -494,6 +537,8 @@ namespace Ogre {
 
         // Stats
         FrameStats mStats;
+        /// Render system counters at the start of the current update
+        FrameStats mUpdateStartStats;
         
         Timer* mTimer ;
         unsigned long mLastSecond;
@@ -30,6 +30,7 @@ THE SOFTWARE.
 
 #include "OgrePrerequisites.h"
 #include "OgreAtomicScalar.h"
+#include "OgreSharedPtr.h"
 #include "OgreStringInterface.h"
 #include "OgreHeaderPrefix.h"
 #include "Threading/OgreThreadHeaders.h"
@@ -168,6 +169,8 @@ namespace Ogre {
         volatile bool mIsBackgroundLoaded;
         /// The size of the resource in bytes
         size_t mSize;
+        /// The part of mSize held in GPU memory
+        size_t mGpuSize;
         /// Is this file manually loaded?
         bool mIsManual;
         /// Origin of this resource (e.g. script name) - optional
@@ -176,16 +179,22 @@ namespace Ogre {
         ManualResourceLoader* mLoader;
         /// State count, the number of times this resource has changed state
         size_t mStateCount;
+        /// Frame number in which the resource was last used, see ResourceGroupManager::setMemoryBudget
+        unsigned long mLastUsedFrame;
 
         typedef set<Listener*>::type ListenerList;
         ListenerList mListenerList;
         OGRE_MUTEX(mListenerListMutex);
 
+        /// Reference count shared by all the ResourcePtr to this resource
+        SharedPtrInfoIntrusive<Resource> mSharedPtrInfo;
+
         /** Protected unnamed constructor to prevent default construction. 
         */
         Resource() 
             : mCreator(0), mHandle(0), mLoadingState(LOADSTATE_UNLOADED), 
-            mIsBackgroundLoaded(false), mSize(0), mIsManual(0), mLoader(0), mStateCount(0)
+            mIsBackgroundLoaded(false), mSize(0), mGpuSize(0), mIsManual(0), mLoader(0), mStateCount(0),
+            mLastUsedFrame(0), mSharedPtrInfo(this)
         { 
         }
 
@@ -256,6 +265,16 @@ namespace Ogre {
         */
         virtual ~Resource();
 
+        /** Gets the reference count stored in this resource.
+        @remarks
+            ResourcePtr made with it share a single count without allocating a
+            separate block, and any number of them can be made from a plain
+            pointer: ResourcePtr(res, res->_getSharedPtrInfo()). The resource is
+            deleted when the last of them is gone. ResourceManager creates
+            resources this way.
+        */
+        SharedPtrInfoIntrusive<Resource>* _getSharedPtrInfo() { return &mSharedPtrInfo; }
+
         /** Prepares the resource for load, if it is not already.  One can call prepare()
             before load(), but this is not required as load() will call prepare() 
             itself, if needed.  When OGRE_THREAD_SUPPORT==1 both load() and prepare() 
@@ -325,10 +344,31 @@ namespace Ogre {
             return mSize; 
         }
 
+        /** Retrieves the part of the size of the resource held in GPU memory,
+            for example in textures or hardware buffers.
+        @remarks
+            The rest, getSize() - getGpuSize(), is held in CPU memory.
+        */
+        size_t getGpuSize(void) const
+        {
+            return mGpuSize;
+        }
+
         /** 'Touches' the resource to indicate it has been used.
         */
         virtual void touch(void);
 
+        /** Records that the resource was used in the current frame.
+        @remarks
+            Unlike touch() this does not load the resource. The frame number is
+            used to pick the least recently used resources when the global memory
+            budget is exceeded, see ResourceGroupManager::setMemoryBudget.
+        */
+        void _notifyUsed(void);
+
+        /// Gets the frame number in which the resource was last used
+        unsigned long getLastUsedFrame(void) const { return mLastUsedFrame; }
+
         /** Gets resource name.
         */
         virtual const String& getName(void) const 
@@ -498,6 +538,10 @@ namespace Ogre {
         /** Calculate the size of a resource; this will only be called after 'load' */
         virtual size_t calculateSize(void) const;
 
+        /** Calculate the part of the size of a resource held in GPU memory, which
+            calculateSize must include; this will only be called after 'load' */
+        virtual size_t calculateGpuSize(void) const { return 0; }
+
     };
 
     /** Interface describing a manual resource loader.
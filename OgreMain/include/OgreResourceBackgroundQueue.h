@@ -77,6 +77,12 @@ namespace Ogre {
         performed, and once finished the ticket will be marked as complete. 
         You can check the status of tickets by calling isProcessComplete() 
         from your queueing thread. 
+    @par
+        If you limit the number of requests in flight with setMaxRequestsInFlight,
+        the remaining requests wait in this class and are started in order of
+        priority (see setRequestPriority), so that urgent resources are not stuck
+        behind a burst of less important ones. Completed requests can also be
+        finalised under a per frame time budget, see setFinaliseTimeBudget.
     */
     class _OgreExport ResourceBackgroundQueue : public Singleton<ResourceBackgroundQueue>, public ResourceAlloc, 
         public WorkQueue::RequestHandler, public WorkQueue::ResponseHandler
@@ -133,6 +139,10 @@ namespace Ogre {
             NameValuePairList* loadParams;
             Listener* listener;
             BackgroundProcessResult result;
+            BackgroundProcessTicket ticket;
+            Real priority;
+            /// When the request was queued, see ResourceLoadTrace::getTime; only set while tracing
+            ulong queueTime;
 
             _OgreExport friend std::ostream& operator<<(std::ostream& o, const ResourceRequest& r)
             { (void)r; return o; }
@@ -141,6 +151,16 @@ namespace Ogre {
         typedef set<BackgroundProcessTicket>::type OutstandingRequestSet;   
         OutstandingRequestSet mOutstandingRequestSet;
 
+        /// Requests waiting for a free slot, started in order of priority
+        typedef vector<ResourceRequest>::type PendingRequestList;
+        PendingRequestList mPendingRequests;
+        /// WorkQueue request ids of the requests in flight, by ticket
+        typedef map<BackgroundProcessTicket, WorkQueue::RequestID>::type InFlightRequestMap;
+        InFlightRequestMap mInFlightRequests;
+        BackgroundProcessTicket mNextTicket;
+        size_t mMaxRequestsInFlight;
+        unsigned long mFinaliseTimeBudget;
+
         /// Struct that holds details of queued notifications
         struct ResourceResponse
         {
@@ -155,7 +175,17 @@ namespace Ogre {
             { (void)r; return o; }
         };
 
+        /// Completed requests waiting to be finalised in the main thread
+        typedef deque<ResourceResponse>::type ResourceResponseQueue;
+        ResourceResponseQueue mCompletedResponses;
+
         BackgroundProcessTicket addRequest(ResourceRequest& req);
+        /// Start pending requests while there are free slots
+        void startPendingRequests(void);
+        /// Complete a request in the main thread and notify the listeners
+        void finaliseResponse(ResourceResponse& resresp);
+        /// Free the copied load parameters of a request
+        static void destroyLoadParams(ResourceRequest& req);
 
     public:
         ResourceBackgroundQueue();
@@ -304,9 +334,56 @@ namespace Ogre {
         virtual bool isProcessComplete(BackgroundProcessTicket ticket);
 
         /** Aborts background process.
+        @remarks
+            A request that has not started yet is simply dropped. A request that
+            is already running is flagged, so the worker skips any work it has not
+            begun and the result is discarded instead of being finalised in the
+            main thread. No listener is called for an aborted request.
         */
         void abortRequest( BackgroundProcessTicket ticket );
 
+        /** Sets the priority of a request which has not started yet.
+        @remarks
+            Requests with a higher priority are started first; requests of equal
+            priority start in the order they were made. New requests have a
+            priority of 0. This can be called every frame to re-evaluate the
+            priorities, for example from the distance to the camera. It has no
+            effect on requests which are already running.
+        */
+        void setRequestPriority(BackgroundProcessTicket ticket, Real priority);
+
+        /** Sets the maximum number of requests handed to the WorkQueue at once.
+        @remarks
+            The remaining requests wait here and are started by priority as the
+            running ones complete, which also limits how much IO the background
+            queue generates at a time. 0 (the default) means no limit, in which
+            case requests start as soon as they are made.
+        */
+        void setMaxRequestsInFlight(size_t count);
+        /// Gets the maximum number of requests handed to the WorkQueue at once
+        size_t getMaxRequestsInFlight(void) const { return mMaxRequestsInFlight; }
+
+        /** Sets the time in milliseconds to spend per frame finalising completed requests.
+        @remarks
+            Finalising is the part of a request done in the main thread: firing
+            the resource and queue listeners and, when the background threads
+            cannot access the render system, loading the prepared resource. With
+            a budget, completed requests are queued and finalised in _update until
+            the budget is spent, with at least one per frame. 0 (the default)
+            finalises each request as soon as its response arrives.
+        */
+        void setFinaliseTimeBudget(unsigned long ms) { mFinaliseTimeBudget = ms; }
+        /// Gets the time in milliseconds to spend per frame finalising completed requests
+        unsigned long getFinaliseTimeBudget(void) const { return mFinaliseTimeBudget; }
+
+        /// Gets the number of requests waiting to be started
+        size_t getPendingRequestCount(void) const { return mPendingRequests.size(); }
+
+        /** Finalises completed requests within the time budget.
+        @note Called automatically by Root once per frame.
+        */
+        void _update(void);
+
         /// Implementation for WorkQueue::RequestHandler
         bool canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
         /// Implementation for WorkQueue::RequestHandler
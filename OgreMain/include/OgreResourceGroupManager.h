@@ -358,6 +358,9 @@ namespace Ogre {
         /// Map from resource group names to groups
         typedef map<String, ResourceGroup*>::type ResourceGroupMap;
         ResourceGroupMap mResourceGroupMap;
+        /** Guards mResourceGroupMap, so that finding a group only takes a shared lock.
+            Changes are made while also holding the auto mutex. */
+        OGRE_RW_MUTEX(mResourceGroupMapMutex);
 
         /// Group name for world resources
         String mWorldGroupName;
@@ -422,6 +425,28 @@ namespace Ogre {
 
         /// Stored current group - optimisation for when bulk loading a group
         ResourceGroup* mCurrentGroup;
+
+        /// Incremented once per rendered frame by _updateResidency
+        unsigned long mFrameNumber;
+        /// Global memory budget across all resource managers, 0 for none
+        size_t mMemoryBudget;
+        /// Frames a resource must go unused before it can be evicted
+        unsigned long mEvictionIdleFrames;
+        /// Maximum bytes unloaded per call to _updateResidency, 0 for no limit
+        size_t mMaxEvictionPerFrame;
+
+        /// Whether the resources of a group are prepared on the WorkQueue threads
+        bool mParallelPrepare;
+        /// Whether the scripts of a group are parsed on the WorkQueue threads
+        bool mParallelScriptParsing;
+        /// Receives the timing events of resource loading, if set
+        ResourceLoadTrace* mLoadTrace;
+
+        /** Prepares the resources of a group across the WorkQueue threads, one
+            loading order after the other. Resources which fail are left for the
+            serial pass to prepare again, so that it reports the error.
+        */
+        void prepareResourcesParallel(const String& name);
     public:
         ResourceGroupManager();
         virtual ~ResourceGroupManager();
@@ -552,6 +577,44 @@ namespace Ogre {
         void loadResourceGroup(const String& name, bool loadMainResources = true, 
             bool loadWorldGeom = true);
 
+        /** Sets whether prepareResourceGroup and loadResourceGroup first prepare
+            the resources of the group on the threads of the Root WorkQueue.
+        @remarks
+            Preparing reads the resource files and, depending on the resource type,
+            decodes them (e.g. texture images), which doesn't need the render system.
+            When enabled, the resources of each loading order (see
+            ResourceManager::getLoadingOrder) are prepared in parallel, then the
+            group is loaded on the calling thread as usual, which only has the
+            remaining work such as creating the GPU objects. Listener events are
+            still fired on the calling thread, in the usual order.
+        @par
+            Manually loaded resources and resources of the autodetect group are
+            still prepared on the calling thread. ResourceLoadingListener::resourceLoading
+            may be called from the worker threads. This requires OGRE_THREAD_SUPPORT
+            and must not be used while the calling thread holds the mutex of this class,
+            since the workers need it to open the resources.
+        */
+        void setParallelPrepare(bool parallel) { mParallelPrepare = parallel; }
+        /** Gets whether resource groups are prepared on the WorkQueue threads. */
+        bool getParallelPrepare(void) const { return mParallelPrepare; }
+
+        /** Sets whether initialising a resource group first lexes and parses its
+            scripts on the threads of the Root WorkQueue.
+        @remarks
+            This applies to the scripts handled by the ScriptCompilerManager (materials,
+            programs, compositors, particle systems...) stored in FileSystem archives.
+            Their text is read and parsed in parallel, then compiled into resources on
+            the calling thread in the usual order, so imports and the order resources
+            are defined in are unaffected. ResourceLoadingListener::resourceStreamOpened
+            is called for all these scripts before the first ResourceGroupListener
+            scriptParseStarted event, and for skipped scripts too. A script which fails
+            to parse is parsed again in the serial pass, which reports the error.
+            Requires OGRE_THREAD_SUPPORT to make a difference.
+        */
+        void setParallelScriptParsing(bool parallel) { mParallelScriptParsing = parallel; }
+        /** Gets whether the scripts of resource groups are parsed on the WorkQueue threads. */
+        bool getParallelScriptParsing(void) const { return mParallelScriptParsing; }
+
         /** Unloads a resource group.
         @remarks
             This method unloads all the resources that have been declared as
@@ -1058,11 +1121,95 @@ namespace Ogre {
         */      
         const LocationList& getResourceLocationList(const String& groupName);
 
+        /** Sets a memory budget shared by all registered resource managers.
+        @remarks
+            Unlike ResourceManager::setMemoryBudget, which only looks at one manager
+            and only when a new resource of that manager loads, this budget covers
+            the combined usage of textures, meshes and every other resource type. It
+            is enforced once per frame by _updateResidency, which unloads the least
+            recently used resources until usage is back within the budget.
+        @par
+            Resources are candidates for eviction when they are loaded, reloadable
+            and have not been used for getEvictionIdleFrames frames. Resources still
+            referenced outside the resource system are only evicted if their manager
+            reloads them on next use (see ResourceManager::getEvictReferenced), which
+            is the case for textures.
+        @param bytes The budget in bytes, or 0 (the default) to disable it.
+        */
+        void setMemoryBudget(size_t bytes) { mMemoryBudget = bytes; }
+        /// Gets the global memory budget, see setMemoryBudget
+        size_t getMemoryBudget(void) const { return mMemoryBudget; }
+
+        /** Gets the memory used by all registered resource managers, in bytes. */
+        size_t getMemoryUsage(void);
+
+        /** Gets the memory used by the loaded resources in one group, in bytes. */
+        size_t getResourceGroupMemoryUsage(const String& name);
+
+        /// Memory used by the loaded resources of one type in one group
+        struct ResourceMemoryUsage
+        {
+            String group;
+            /// See ResourceManager::getResourceType
+            String resourceType;
+            /// Number of loaded resources
+            size_t count;
+            /// Bytes held in CPU memory
+            size_t cpuBytes;
+            /// Bytes held in GPU memory, see Resource::getGpuSize
+            size_t gpuBytes;
+        };
+        typedef vector<ResourceMemoryUsage>::type ResourceMemoryUsageList;
+
+        /** Takes a snapshot of the memory used by the loaded resources, per group
+            and resource type.
+        @remarks
+            Entries are sorted by group then resource type, and types with no
+            loaded resource in a group are left out. Summing the entries of a type
+            gives the usage of its manager, see ResourceManager::getMemoryUsage and
+            ResourceManager::getGpuMemoryUsage.
+        */
+        ResourceMemoryUsageList getMemoryUsageSnapshot(void);
+
+        /** Writes a memory usage snapshot as comma separated values, with a header
+            line then one line per entry. */
+        static void exportMemoryUsage(const ResourceMemoryUsageList& usage, std::ostream& os);
+
+        /** Sets how many frames a resource must go unused before the memory budget
+            may evict it (default 3). Keeps resources which are still in flight on
+            the GPU, or only used every other frame, from being thrashed. */
+        void setEvictionIdleFrames(unsigned long frames) { mEvictionIdleFrames = frames; }
+        /// Gets the number of idle frames before eviction, see setEvictionIdleFrames
+        unsigned long getEvictionIdleFrames(void) const { return mEvictionIdleFrames; }
+
+        /** Limits how many bytes _updateResidency unloads per frame, spreading the
+            cost of a large budget overrun across several frames (default 0, no limit). */
+        void setMaxEvictionPerFrame(size_t bytes) { mMaxEvictionPerFrame = bytes; }
+        /// Gets the per-frame eviction limit, see setMaxEvictionPerFrame
+        size_t getMaxEvictionPerFrame(void) const { return mMaxEvictionPerFrame; }
+
+        /** Internal method called by Root at the end of every frame; advances the
+            frame counter and evicts resources if the memory budget is exceeded. */
+        void _updateResidency(void);
+
+        /// Gets the current frame number used for Resource::getLastUsedFrame
+        unsigned long _getFrameNumber(void) const { return mFrameNumber; }
+
         /// Sets a new loading listener
         void setLoadingListener(ResourceLoadingListener *listener);
         /// Returns the current loading listener
         ResourceLoadingListener *getLoadingListener();
 
+        /** Sets the trace receiving the timing events of resource loading, or 0
+            (the default) to disable them.
+        @remarks
+            The trace is used from the threads loading resources, so only change
+            it while no resource is loading. It is not owned by this class.
+        */
+        void setLoadTrace(ResourceLoadTrace* trace) { mLoadTrace = trace; }
+        /// Gets the trace receiving the timing events of resource loading, see setLoadTrace
+        ResourceLoadTrace* getLoadTrace(void) const { return mLoadTrace; }
+
         /** Override standard Singleton retrieval.
         @remarks
         Why do we do this? Well, it's because the Singleton
@@ -0,0 +1,160 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __ResourceLoadTrace_H__
+#define __ResourceLoadTrace_H__
+
+#include "OgrePrerequisites.h"
+#include "Threading/OgreThreadHeaders.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Resources
+    *  @{
+    */
+    /// The steps of resource loading timed by ResourceLoadTrace
+    enum ResourceLoadPhase
+    {
+        /// Waiting in the ResourceBackgroundQueue for a worker thread
+        RLP_QUEUE,
+        /// Opening a resource stream from its archive, which reads and inflates zipped files
+        RLP_OPEN,
+        /// Decoding an image with its codec
+        RLP_DECODE,
+        /// Parsing a serialised mesh or skeleton, or a script
+        RLP_PARSE,
+        /// Resource::prepare
+        RLP_PREPARE,
+        /// Resource::load, which includes preparing if that was not done before
+        RLP_LOAD,
+        /// Uploading texture images to the GPU
+        RLP_UPLOAD,
+        /// Compiling a GPU program
+        RLP_COMPILE,
+        RLP_COUNT
+    };
+
+    /** Collects timing events of resource loading.
+    @remarks
+        Once registered with ResourceGroupManager::setLoadTrace, the resource
+        system reports every step of loading listed in ResourceLoadPhase, from
+        whichever thread runs it. Steps nest, for example a texture load covers
+        opening, decoding and uploading its image.
+    @par
+        Events are forwarded to a ProfileTraceListener if one is given, which
+        places them on the timeline of their thread next to the profiles, and
+        are summed per resource name for getSlowestResources.
+    */
+    class _OgreExport ResourceLoadTrace : public ResourceAlloc
+    {
+    public:
+        /// Time spent loading one resource, in microseconds
+        struct ResourceTiming
+        {
+            String name;
+            /// Total time of the events of each phase
+            ulong time[RLP_COUNT];
+            /// Largest amount of data reported by the events
+            size_t bytes;
+
+            /// Time spent preparing and loading, which covers the nested phases
+            ulong getTotalTime(void) const { return time[RLP_PREPARE] + time[RLP_LOAD]; }
+        };
+        typedef vector<ResourceTiming>::type ResourceTimingList;
+
+        /** Constructor.
+        @param traceListener Listener whose timeline the events are recorded to, or 0
+        */
+        ResourceLoadTrace(ProfileTraceListener* traceListener = 0);
+        virtual ~ResourceLoadTrace();
+
+        /** Gets the current time in microseconds, on the timer of Root and the Profiler. */
+        ulong getTime(void) const;
+
+        /** Records a timing event.
+        @remarks
+            Called from any thread.
+        @param phase The step of loading
+        @param resource The name of the resource, or of the file being read
+        @param bytes Amount of data processed, 0 if unknown
+        @param startTime The time the step began, see getTime
+        @param endTime The time the step ended, see getTime
+        */
+        virtual void recordEvent(ResourceLoadPhase phase, const String& resource, size_t bytes,
+            ulong startTime, ulong endTime);
+
+        /** Gets the resources which took the longest to prepare and load, slowest first. */
+        ResourceTimingList getSlowestResources(size_t count) const;
+
+        /** Writes the slowest resources, with the time of each phase, to the log. */
+        void logSlowestResources(size_t count = 10) const;
+
+        /** Discards the timings summed so far. */
+        void clear(void);
+
+        /** Gets the name of a phase as used in the events. */
+        static const char* getPhaseName(ResourceLoadPhase phase);
+
+    protected:
+        ProfileTraceListener* mTraceListener;
+        Timer* mTimer;
+
+        typedef map<String, ResourceTiming>::type ResourceTimingMap;
+        ResourceTimingMap mTimings;
+        OGRE_MUTEX(mTimingsMutex);
+    };
+
+    /** Times a step of resource loading for the lifetime of the object, reporting it
+        to the ResourceLoadTrace registered with ResourceGroupManager, if any. */
+    class _OgreExport ResourceLoadTraceScope
+    {
+    public:
+        ResourceLoadTraceScope(ResourceLoadPhase phase, const String& resource, size_t bytes = 0);
+        ~ResourceLoadTraceScope();
+
+        /// Sets the amount of data processed, when it is only known at the end
+        void setBytes(size_t bytes) { mBytes = bytes; }
+
+    private:
+        ResourceLoadTrace* mTrace;
+        ResourceLoadPhase mPhase;
+        /// Only copied while tracing
+        String mResource;
+        size_t mBytes;
+        ulong mStartTime;
+    };
+    /** @} */
+    /** @} */
+
+} // end namespace
+
+#include "OgreHeaderSuffix.h"
+
+#endif
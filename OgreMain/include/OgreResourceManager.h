@@ -32,6 +32,7 @@ THE SOFTWARE.
 
 #include "OgreResource.h"
 #include "OgreResourceGroupManager.h"
+#include "OgreIdString.h"
 #include "OgreCommon.h"
 #include "OgreStringVector.h"
 #include "OgreScriptLoader.h"
@@ -115,7 +116,9 @@ namespace Ogre {
         but they can only be removed (and thus eventually destroyed) using
         their parent ResourceManager.
     @note
-        If OGRE_THREAD_SUPPORT is 1, this class is thread-safe.
+        If OGRE_THREAD_SUPPORT is 1, this class is thread-safe. Lookups by
+        name, handle or id only take a shared lock, so they run concurrently
+        and do not wait for other threads creating or loading resources.
     */
     class _OgreExport ResourceManager : public ScriptLoader, public ResourceAlloc
     {
@@ -182,6 +185,10 @@ namespace Ogre {
         /** Gets the current memory usage, in bytes. */
         virtual size_t getMemoryUsage(void) const { return mMemoryUsage.get(); }
 
+        /** Gets the part of the current memory usage held in GPU memory, in bytes,
+            see Resource::getGpuSize. */
+        size_t getGpuMemoryUsage(void) const { return mGpuMemoryUsage.get(); }
+
         /** Unloads a single resource by name.
         @remarks
             Unloaded resources are not removed, they simply free up their memory
@@ -373,6 +380,19 @@ namespace Ogre {
         /** Retrieves a pointer to a resource by name, or null if the resource does not exist.
         */
         virtual ResourcePtr getResourceByName(const String& name, const String& groupName = ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME);
+        /** Retrieves a pointer to a resource by hashed name, or null if the resource does not exist.
+        @remarks
+            This is a cheaper alternative to getResourceByName for code which looks
+            resources up every frame: callers can build the IdString once and keep
+            it, and the lookup only hashes an integer and takes a shared read lock
+            rather than the manager mutex.
+        @par
+            If groupName is given, the grouped pool for that group is searched first
+            and the global pool second. If it is left unspecified only the global pool
+            is searched; unlike AUTODETECT_RESOURCE_GROUP_NAME this does not scan every
+            group.
+        */
+        virtual ResourcePtr getResourceById(IdString name, IdString groupName = IdString());
         /** Retrieves a pointer to a resource by handle, or null if the resource does not exist.
         */
         virtual ResourcePtr getByHandle(ResourceHandle handle);
@@ -493,6 +513,14 @@ namespace Ogre {
         /** Gets whether this manager and its resources habitually produce log output */
         virtual bool getVerbose(void) { return mVerbose; }
 
+        /** Gets whether resources of this manager which are still referenced may be
+            unloaded to stay within the global memory budget.
+        @remarks
+            Only managers whose resources are transparently reloaded on next use
+            return true, see ResourceGroupManager::setMemoryBudget.
+        */
+        bool getEvictReferenced(void) const { return mEvictReferenced; }
+
         /** Definition of a pool of resources, which users can use to reuse similar
             resources many times without destroying and recreating them.
         @remarks
@@ -556,6 +584,8 @@ namespace Ogre {
         virtual void addImpl( ResourcePtr& res );
         /** Remove a resource from this manager; remove it from the lists. */
         virtual void removeImpl(const ResourcePtr& res );
+        /// Inserts a resource in the lists, returns false if its name is taken
+        bool insertResource(ResourcePtr& res, bool inGlobalPool);
         /** Checks memory usage and pages out if required. This is automatically done after a new resource is loaded.
         */
         virtual void checkUsage(void);
@@ -565,15 +595,41 @@ namespace Ogre {
         typedef OGRE_HashMap< String, ResourcePtr > ResourceMap;
         typedef OGRE_HashMap< String, ResourceMap > ResourceWithGroupMap;
         typedef map<ResourceHandle, ResourcePtr>::type ResourceHandleMap;
+        /// Entry of mResourcesById. groupHash is 0 for resources in the global pool.
+        struct ResourceIdEntry
+        {
+            Resource* resource;
+            uint32 nameHash;
+            uint32 groupHash;
+        };
+        typedef OGRE_HashMultiMap< uint32, ResourceIdEntry > ResourceIdMap;
     protected:
         ResourceHandleMap mResourcesByHandle;
         ResourceMap mResources;
         ResourceWithGroupMap mResourcesWithGroup;
+        /** Hashed index over mResources and mResourcesWithGroup. Global pool entries
+            are keyed by IdString(name), grouped ones by IdString(group) + IdString(name).
+            Several resources may share a key, so hits are checked against the
+            name and group hashes kept in the entry.
+            Holds weak pointers so the index doesn't count towards
+            ResourceGroupManager::RESOURCE_SYSTEM_NUM_REFERENCE_COUNTS.
+        */
+        ResourceIdMap mResourcesById;
+        /** Guards the lists above, so that lookups only take a shared lock.
+        @remarks
+            Changes to the lists are made while also holding the auto mutex,
+            so code holding the auto mutex can iterate them without this lock.
+            Nothing is called out to while holding it, as it is not recursive.
+        */
+        OGRE_RW_MUTEX(mResourcesMutex);
         size_t mMemoryBudget; /// In bytes
         AtomicScalar<ResourceHandle> mNextHandle;
         AtomicScalar<size_t> mMemoryUsage; /// In bytes
+        AtomicScalar<size_t> mGpuMemoryUsage; /// In bytes
 
         bool mVerbose;
+        /// See getEvictReferenced
+        bool mEvictReferenced;
 
         // IMPORTANT - all subclasses must populate the fields below
 
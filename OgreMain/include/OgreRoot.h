@@ -113,6 +113,15 @@ namespace Ogre
         CompositorManager* mCompositorManager;      
         unsigned long mNextFrame;
         Real mFrameSmoothingTime;
+        bool mFramePipelining;
+        /// Whether the buffers of the last frame still have to be swapped
+        bool mSwapPending;
+        /// Time between frame starts to pace renderOneFrame to, 0 for none
+        Real mTargetFrameTime;
+        /// Timer microseconds at which the next frame should start
+        unsigned long mNextFrameStart;
+        /// Running average of how many microseconds sleeps overrun
+        long mSleepOvershoot;
         bool mRemoveQueueStructuresOnClear;
         Real mDefaultMinPixelSize;
         HardwareBuffer::UploadOptions mFreqUpdatedBuffersUploadOption;
@@ -992,6 +1001,55 @@ namespace Ogre
         /** Gets the period over which OGRE smooths out fluctuations in frame times. */
         Real getFrameSmoothingPeriod(void) const { return mFrameSmoothingTime; }
 
+        /** Sets whether the update of a frame overlaps the rendering of the previous one
+            (default false).
+        @remarks
+            Swapping the buffers of the render windows usually blocks until the GPU
+            has caught up with the commands of the frame. With pipelining, the
+            buffers rendered by _updateAllRenderTargets are only swapped by the next
+            call, after the frameEnded and frameStarted events, so the CPU work of
+            the listeners and the scene logic of the next frame runs while the GPU
+            still renders the previous one. Each frame is then presented about one
+            frame update later, which adds to the input latency.
+        @par
+            Buffers still pending are swapped when pipelining is disabled, when
+            startRendering returns and on shutdown; call _swapPendingBuffers to
+            present them earlier, for example before leaving a custom render loop.
+        */
+        void setFramePipelining(bool enabled);
+        /** Gets whether the update of a frame overlaps the rendering of the previous one. */
+        bool getFramePipelining(void) const { return mFramePipelining; }
+
+        /** Swaps the buffers of the last frame if frame pipelining left them pending.
+        @see setFramePipelining
+        */
+        void _swapPendingBuffers(void);
+
+        /** Sets the time between the starts of frames renderOneFrame aims for, in
+            seconds (default 0, no pacing).
+        @remarks
+            Rendering as fast as possible makes frame times uneven and lets the
+            CPU run ahead of the display. With a target, renderOneFrame waits
+            before starting a frame until the target time since the previous
+            one has passed, so frames start at a steady rate. The wait sleeps
+            for the bulk of the time, shortened by how much the sleeps of the
+            previous frames overran, and spins for the rest. A frame later than
+            the target starts right away, without trying to catch up.
+        @par
+            Combine with RenderSystem::setMaxFrameLatency to keep the GPU from
+            queueing frames behind the paced CPU.
+        */
+        void setTargetFrameTime(Real seconds);
+        /** Gets the time between the starts of frames renderOneFrame aims for, in seconds. */
+        Real getTargetFrameTime(void) const { return mTargetFrameTime; }
+
+        /** Waits until the next frame should start, if a target frame time is set.
+        @remarks
+            Called by renderOneFrame, call it at the start of custom render loops.
+        @see setTargetFrameTime
+        */
+        void _paceFrame(void);
+
         /** Register a new MovableObjectFactory which will create new MovableObject
             instances of a particular type, as identified by the getType() method.
         @remarks
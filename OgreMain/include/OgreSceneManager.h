@@ -353,6 +353,8 @@ namespace Ogre {
         protected:
             /// Pass that was actually used at the grouping level
             const Pass* mUsedPass;
+            /// Pass of the grouping level, before it was derived for shadows
+            const Pass* mSourcePass;
         public:
             SceneMgrQueuedRenderableVisitor() 
                 :transparentShadowCastersMode(false) {}
@@ -530,6 +532,48 @@ namespace Ogre {
         ulong mLightsDirtyCounter;
         LightList mShadowTextureCurrentCasterLightList;
 
+        /** Uniform grid over the point and spot lights of mLightsAffectingFrustum.
+        @remarks
+            Each cell holds the indexes of the lights whose range overlaps it, packed
+            into one array. Directional lights, and lights whose range covers too many
+            cells, are kept in a separate list which every query returns.
+        */
+        struct LightGrid
+        {
+            /// Value of mLightsDirtyCounter the grid was built for
+            ulong dirtyCounter;
+            /// Number of frustum lights the grid was built for
+            size_t lightCount;
+            bool built;
+            Vector3 origin;
+            Real invCellSize;
+            int dims[3];
+            /// Offset of each cell's lights in cellLights, one extra entry at the end
+            vector<uint32>::type cellStart;
+            vector<uint32>::type cellLights;
+            /// Lights which are tested by every query
+            vector<uint32>::type globalLights;
+            /// Per light stamp of the last query which returned it
+            vector<uint32>::type stamps;
+            uint32 currentStamp;
+            /// Light indexes returned by the last query, in ascending order
+            vector<uint32>::type results;
+        };
+        LightGrid mLightGrid;
+        /// Number of frustum lights from which _populateLightList uses the grid, 0 to never use it
+        size_t mLightGridThreshold;
+
+        /// Rebuilds mLightGrid if mLightsAffectingFrustum changed since it was built
+        void updateLightGrid(void);
+        /// Gathers the indexes of the frustum lights which may affect the given sphere into mLightGrid.results
+        void queryLightGrid(const Vector3& position, Real radius);
+        /// Index of the mLightGrid cell containing the given coordinate along an axis, clamped to the grid
+        int getLightGridCell(Real coord, int axis) const
+        {
+            Real cell = Math::Floor((coord - mLightGrid.origin[axis]) * mLightGrid.invCellSize);
+            return static_cast<int>(Math::Clamp<Real>(cell, 0, Real(mLightGrid.dims[axis] - 1)));
+        }
+
         typedef map<String, MovableObject*>::type MovableObjectMap;
         /// Simple structure to hold MovableObject map and a mutex to go with it.
         struct MovableObjectCollection
@@ -581,6 +625,39 @@ namespace Ogre {
         for passes with vertex programs. 
         */
         virtual const Pass* deriveShadowReceiverPass(const Pass* pass);
+
+        /// What the opaque passes of a queue group are rendered for
+        enum DepthPrePassStage
+        {
+            /// Normally, no depth pre-pass
+            DPS_NONE,
+            /// Depth only, with deriveDepthPrePass
+            DPS_DEPTH,
+            /// Colour only, where the depth equals the pre-pass depth
+            DPS_EQUAL
+        };
+        bool mDepthPrePass;
+        DepthPrePassStage mDepthPrePassStage;
+        /// The depth only pass returned by deriveDepthPrePass
+        Pass* mDepthPrePassPass;
+
+        /** Internal method telling whether a pass is rendered in the depth pre-pass.
+        @remarks
+            Only the first pass of opaque techniques writing depth and colour with
+            a less or less equal depth test qualifies; alpha rejected, per light
+            iterated and wireframe passes, and passes with geometry or tessellation
+            programs, render normally.
+        */
+        virtual bool isDepthPrePassCandidate(const Pass* pass) const;
+        /** Internal method for turning a regular pass into a depth only pass.
+        @remarks
+            The vertex program and its parameters, the culling and the depth bias
+            of the pass are kept so that the depth matches the later colour pass
+            exactly; there is no fragment program and colour writes are disabled.
+        */
+        virtual const Pass* deriveDepthPrePass(const Pass* pass);
+        /** Renders the depth of the opaque passes of a queue group. */
+        virtual void renderDepthPrePass(RenderQueueGroup* pGroup);
     
         /** Internal method to validate whether a Pass should be allowed to render.
         @remarks
@@ -649,6 +726,8 @@ namespace Ogre {
         RenderObjectListenerList mRenderObjectListeners;
         typedef vector<Listener*>::type ListenerList;
         ListenerList mListeners;
+        /// Temporary copy of the listeners made while firing events
+        typedef std::vector<Listener*, STLAllocator<Listener*, FrameAllocPolicy> > ListenerListCopy;
         /// Internal method for firing the queue start event
         virtual void firePreRenderQueues();
         /// Internal method for firing the queue end event
@@ -671,6 +750,31 @@ namespace Ogre {
         virtual void firePreUpdateSceneGraph(Camera* camera);
         /// Internal method for firing post update scene graph event
         virtual void firePostUpdateSceneGraph(Camera* camera);
+        /// Internal method for updating the scene graph from several threads
+        void updateSceneGraphParallel(void);
+        /// Internal method for updating the scene graph as a linear sweep
+        void updateSceneGraphLinear(void);
+        /// Internal method for rebuilding mLinearUpdateNodes from the scene graph
+        void buildLinearUpdateNodes(void);
+        /// Internal method for caching the bones of the entities visible to a camera from several threads
+        void updateSkeletonsParallel(Camera* cam);
+
+        /** Brings the bones of entities whose bounds follow their skeleton up to date
+            when their animation changed, before the scene graph is updated.
+        @remarks
+            Other entities only evaluate their skeleton when they are reached by a camera
+            or a shadow caster query, but the bounds of these are needed to find out
+            whether they are reached at all, so they're evaluated beforehand, whether on
+            screen or not. Each is still evaluated at most once per frame.
+        */
+        void updateSkeletonBounds(void);
+        /// Internal method for finding visible objects by batched culling
+        void findVisibleObjectsBatched(Camera* cam, VisibleObjectsBoundsInfo* visibleBounds,
+            bool onlyShadowCasters);
+        /// Internal method for gathering the planes batched culling tests a camera with, returns their number
+        size_t getBatchCullPlanes(Camera* cam, bool onlyShadowCasters, Plane* planes);
+        /// Internal method for updating controllers and applying animations, once per frame
+        void updateSceneForFrame(void);
         /// Internal method for firing find visible objects event
         virtual void firePreFindVisibleObjects(Viewport* v);
         /// Internal method for firing find visible objects event
@@ -709,6 +813,107 @@ namespace Ogre {
         virtual void renderSingleObject(Renderable* rend, const Pass* pass, 
             bool lightScissoringClipping, bool doLightIteration, const LightList* manualLightList = 0);
 
+        /// Stands in for the instances of an automatically instanced draw
+        class _OgreExport AutoInstanceBatch : public Renderable, public SceneMgtAlloc
+        {
+        public:
+            AutoInstanceBatch() : mFirst(0) {}
+
+            /// The first instance, whose material and lights are used
+            Renderable* mFirst;
+            RenderOperation mRenderOp;
+
+            const MaterialPtr& getMaterial(void) const { return mFirst->getMaterial(); }
+            void getRenderOperation(RenderOperation& op) { op = mRenderOp; }
+            /// The world matrix comes from the instance data
+            void getWorldTransforms(Matrix4* xform) const { *xform = Matrix4::IDENTITY; }
+            Real getSquaredViewDepth(const Camera* cam) const { return mFirst->getSquaredViewDepth(cam); }
+            const LightList& getLights(void) const { return mFirst->getLights(); }
+            void _updateCustomGpuParameter(const GpuProgramParameters::AutoConstantEntry& constantEntry,
+                GpuProgramParameters* params) const
+            {
+                mFirst->_updateCustomGpuParameter(constantEntry, params);
+            }
+        };
+
+        /// Identical renderables waiting to be drawn instanced
+        struct AutoInstanceGroup
+        {
+            Renderable* first;
+            const VertexData* vertexData;
+            const IndexData* indexData;
+            RenderOperation::OperationType operationType;
+            vector<Renderable*>::type renderables;
+            /// Rows of the world matrices, 12 floats per renderable
+            vector<float>::type transforms;
+        };
+        typedef vector<AutoInstanceGroup>::type AutoInstanceGroupList;
+        /// Copy of a vertex data with the instance buffer bound as well
+        struct AutoInstanceVertexData
+        {
+            VertexData* data;
+            unsigned short instanceBinding;
+        };
+        typedef map<const VertexData*, AutoInstanceVertexData>::type AutoInstanceVertexDataMap;
+
+        bool mAutoInstancing;
+        String mAutoInstancingScheme;
+        size_t mAutoInstancingMinCount;
+        /// Groups of the current pass, only the first mNumAutoInstanceGroups are in use
+        AutoInstanceGroupList mAutoInstanceGroups;
+        size_t mNumAutoInstanceGroups;
+        /// The pass being collected for, and the pass of the instancing scheme to draw with
+        const Pass* mAutoInstanceSourcePass;
+        const Pass* mAutoInstanceTargetPass;
+        /// The pass renderables too few to instance are drawn with
+        const Pass* mAutoInstanceUsedPass;
+        HardwareVertexBufferSharedPtr mAutoInstanceBuffer;
+        AutoInstanceVertexDataMap mAutoInstanceVertexData;
+        AutoInstanceBatch mAutoInstanceBatch;
+        /// Occlusion culler, if enabled
+        SoftwareOcclusionCuller* mOcclusionCuller;
+        /// Render queue statistics, if enabled
+        RenderQueueDiagnostics* mRenderQueueDiagnostics;
+
+        /// Cameras sharing one visibility pass per frame, see addCameraGroup
+        struct CameraGroup
+        {
+            /// The cameras of the group, the first one culls for all of them
+            vector<Camera*>::type cameras;
+            /// Frustum enclosing the frustums of all the cameras
+            Frustum* cullFrustum;
+        };
+        typedef map<const Camera*, CameraGroup*>::type CameraGroupMap;
+        /// The group of each grouped camera
+        CameraGroupMap mCameraGroups;
+        /// Group leader whose visible objects are in the render queue, if any
+        Camera* mSharedQueueCamera;
+        /// Frame number the shared render queue was built in
+        unsigned long mSharedQueueFrame;
+
+        /** Fits the culling frustum of a camera group around the frustums of its cameras.
+        @return False if they can't be enclosed by one perspective frustum
+        */
+        bool updateCameraGroupFrustum(CameraGroup* group);
+
+        /** Collects a renderable to draw instanced with others later.
+        @param pass The pass of the renderable, before any shadow caster derivation
+        @param usedPass The pass it would be rendered with on its own
+        @param rend The renderable
+        @return False if the renderable can't be instanced and has to be rendered now
+        */
+        bool queueAutoInstance(const Pass* pass, const Pass* usedPass, Renderable* rend);
+        /** Draws the renderables collected by queueAutoInstance, instanced if there are enough
+            of them. Called before another pass is set and after a collection is rendered. */
+        void flushAutoInstances(bool lightScissoringClipping, bool doLightIteration,
+            const LightList* manualLightList);
+        /// Finds the pass of the instancing scheme matching a pass, or 0
+        const Pass* findAutoInstancePass(const Pass* pass) const;
+        /// Gets the instanced copy of a vertex data, or 0 if it can't be instanced
+        const AutoInstanceVertexData* getAutoInstanceVertexData(const VertexData* vertexData);
+        /// Destroys the instanced copies of vertex data
+        void clearAutoInstanceVertexData(void);
+
         /** Internal method for creating the AutoParamDataSource instance. */
         virtual AutoParamDataSource* createAutoParamDataSource(void) const
         {
@@ -741,6 +946,92 @@ namespace Ogre {
         typedef vector<Camera*>::type ShadowTextureCameraList;
         ShadowTextureCameraList mShadowTextureCameras;
         Texture* mCurrentShadowTexture;
+
+        /// The static casters rendered into a shadow texture, kept between frames
+        struct StaticShadowCache
+        {
+            /// Copy of the shadow texture holding only the static casters
+            TexturePtr texture;
+            /// Whether the copy holds static casters rendered as described below
+            bool valid;
+            /// The light, and the index among its textures, it was rendered for
+            const Light* light;
+            size_t lightTextureIndex;
+            /// The matrices of the shadow camera it was rendered with
+            Matrix4 viewMatrix;
+            Matrix4 projMatrix;
+        };
+        typedef vector<StaticShadowCache>::type StaticShadowCacheList;
+        /// One cache per shadow texture
+        StaticShadowCacheList mStaticShadowCaches;
+        bool mStaticShadowCaching;
+        uint32 mStaticShadowCasterMask;
+        Real mStaticShadowCacheMargin;
+        /// Whether dynamic casters are being blended over cached static casters
+        bool mShadowCasterCompositing;
+
+        /** Renders the casters into a shadow texture, reusing its cached static
+            casters when the shadow camera still fits in the one they were rendered with.
+        @param index The index of the shadow texture
+        @param light The light the texture is for
+        @param lightTextureIndex The index of the texture among those of the light
+        */
+        void updateShadowTexture(size_t index, const Light* light, size_t lightTextureIndex);
+        /** Destroys the textures holding cached static shadow casters. */
+        void destroyStaticShadowCaches(void);
+
+        /// What a shadow texture was last rendered for, and when
+        struct ShadowTextureUpdate
+        {
+            /// The light, and the index among its textures, or no light if never rendered
+            const Light* light;
+            size_t lightTextureIndex;
+            /// The main camera it was rendered for
+            const Camera* camera;
+            /// The frame it was rendered in
+            unsigned long frame;
+            /// Whether it is rendered this frame
+            bool scheduled;
+        };
+        vector<ShadowTextureUpdate>::type mShadowTextureUpdates;
+        size_t mShadowTextureUpdateBudget;
+
+        /** Decides which shadow textures are rendered this frame, from the update
+            interval of their lights and the shadow texture update budget. */
+        void scheduleShadowTextureUpdates(const Camera* cam, const LightList* lightList);
+
+        bool mShadowCasterReceiverCulling;
+        /// Bounds of the shadow receivers visible from the main camera
+        AxisAlignedBox mShadowReceiverBounds;
+        /// The volume shadow casters of the current light must touch to be rendered
+        PlaneBoundedVolume mShadowCasterCullVolume;
+        bool mShadowCasterCullVolumeActive;
+
+        /** Finds the bounds of the shadow receivers a camera sees. */
+        void findShadowReceiverBounds(Camera* cam);
+        /** Sets the shadow caster cull volume to the convex hull of the receiver
+            bounds and the light, or extruded towards a directional light. */
+        void setupShadowCasterCullVolume(const Light* light);
+
+        /// The texture all shadow textures are tiles of, in atlas mode
+        TexturePtr mShadowAtlas;
+        unsigned int mShadowAtlasSize;
+        unsigned int mShadowAtlasMinTileSize;
+        /// The tile of each shadow texture, in texture coordinates of the atlas
+        vector<RealRect>::type mShadowAtlasTiles;
+        /// The size of the tile of each shadow texture, in minimum tiles
+        vector<size_t>::type mShadowAtlasTileUnits;
+
+        /** Sizes the tile of each shadow texture by the screen coverage of its
+            light, and packs the tiles into the atlas. */
+        void allocateShadowAtlasTiles(const Camera* cam, const LightList* lightList);
+        /** Gets the viewport a shadow texture is rendered through. */
+        Viewport* getShadowTextureViewport(size_t index) const;
+        /** Gets the part of its texture a shadow texture covers. */
+        RealRect getShadowTextureTile(size_t index) const
+        {
+            return mShadowAtlas.isNull() ? RealRect(0, 0, 1, 1) : mShadowAtlasTiles[index];
+        }
         bool mShadowUseInfiniteFarPlane;
         bool mShadowCasterRenderBackFaces;
         bool mShadowAdditiveLightClip;
@@ -870,6 +1161,79 @@ namespace Ogre {
         /// Visibility mask used to show / hide objects
         uint32 mVisibilityMask;
         bool mFindVisibleObjects;
+        /// Update the children of the root node from the WorkQueue threads?
+        bool mParallelUpdateSceneGraph;
+
+        /// Update the scene graph with a sweep over a depth ordered node array?
+        bool mLinearUpdateSceneGraph;
+        /// Whether the node hierarchy changed since mLinearUpdateNodes was built
+        bool mLinearUpdateNodesDirty;
+        typedef vector<SceneNode*>::type LinearUpdateNodeList;
+        /// Nodes of the scene graph ordered by depth, so parents precede children
+        LinearUpdateNodeList mLinearUpdateNodes;
+        /// Index of each node's parent in mLinearUpdateNodes
+        vector<uint32>::type mLinearUpdateParents;
+        /// Per node LinearUpdateFlags of the current sweep
+        vector<uint8>::type mLinearUpdateFlags;
+        enum LinearUpdateFlags
+        {
+            LUF_VISITED = 1,
+            LUF_UPDATE_CHILDREN = 2
+        };
+
+        /// Cull the scene nodes in batches rather than recursively?
+        bool mBatchCulling;
+        /// Per node visibility result of batched culling, indexed like mLinearUpdateNodes
+        vector<uint8>::type mBatchCullResults;
+        /// Batched culling of a camera done ahead by _prepareCameras
+        struct PreparedCulling
+        {
+            unsigned long frameNumber;
+            /// mSceneGraphVersion the results are valid for
+            size_t sceneGraphVersion;
+            Plane planes[6];
+            size_t numPlanes;
+            vector<uint8>::type results;
+        };
+        typedef map<const Camera*, PreparedCulling>::type PreparedCullingMap;
+        PreparedCullingMap mPreparedCulling;
+        /// Changed whenever an update of the scene graph may have moved node bounds
+        size_t mSceneGraphVersion;
+
+        /// Cache the bones of visible entities from the WorkQueue threads?
+        bool mParallelUpdateSkeletons;
+        /// Entities whose bones are cached by updateSkeletonsParallel, reused between frames
+        vector<Entity*>::type mParallelSkeletonEntities;
+
+        /// Let entities with matching animation states reuse one evaluated pose?
+        bool mSkeletonPoseSharing;
+        Real mSkeletonPoseTimeStep;
+        Real mSkeletonPoseWeightStep;
+        /// Identifies a skeleton pose, with animation times and weights quantised
+        struct SkeletonPoseKey
+        {
+            struct State
+            {
+                const Animation* animation;
+                long time;
+                long weight;
+                bool operator<(const State& rhs) const;
+            };
+            typedef vector<State>::type StateList;
+
+            const Skeleton* skeleton;
+            int blendMode;
+            StateList states;
+
+            bool operator<(const SkeletonPoseKey& rhs) const;
+        };
+        typedef map<SkeletonPoseKey, Entity*>::type SkeletonPoseMap;
+        /// Entity which evaluated each pose in the current frame
+        SkeletonPoseMap mSkeletonPoses;
+        unsigned long mSkeletonPosesFrame;
+
+        /// Entities whose bounds follow their skeleton, @see Entity::setUpdateBoundingBoxFromSkeleton
+        set<Entity*>::type mSkeletonBoundsEntities;
 
         /// Suppress render state changes?
         bool mSuppressRenderStateChanges;
@@ -914,6 +1278,49 @@ namespace Ogre {
 
         ShadowCasterSceneQueryListener* mShadowCasterQueryListener;
 
+        /// Inner class to use as callback for gathering the objects of a shadow caster scene query
+        class _OgreExport ShadowCasterGatherListener : public SceneQueryListener, public SceneMgtAlloc
+        {
+        protected:
+            vector<MovableObject*>::type* mObjects;
+        public:
+            ShadowCasterGatherListener(vector<MovableObject*>::type* objects) : mObjects(objects) {}
+            bool queryResult(MovableObject* object) { mObjects->push_back(object); return true; }
+            bool queryResult(SceneQuery::WorldFragment* fragment) { return true; }
+        };
+
+        /// Objects a shadow caster query found for a light, and the volume it was run for
+        struct ShadowCasterCacheEntry
+        {
+            /// Value of mShadowCasterCacheCounter when the query was run
+            ulong counter;
+            /// Whether the query was a sphere query rather than a box query
+            bool isSphere;
+            Sphere sphere;
+            AxisAlignedBox box;
+            vector<MovableObject*>::type objects;
+        };
+        typedef map<const Light*, ShadowCasterCacheEntry>::type ShadowCasterCache;
+        ShadowCasterCache mShadowCasterCache;
+        /// Reuse the shadow caster query results of lights?
+        bool mShadowCasterCaching;
+        /// Incremented whenever objects which shadow caster queries may return changed,
+        /// also from the worker threads of a parallel scene graph update
+        AtomicScalar<ulong> mShadowCasterCacheCounter;
+
+        /** Executes a shadow caster query through mShadowCasterQueryListener.
+        @remarks
+            When shadow caster caching is enabled, and the objects found the last time
+            the light's query was executed are still valid for the same volume, the
+            query is skipped and those objects are passed to the listener instead.
+        @param light The light the query is for
+        @param query The sphere or box query, already set to the volume
+        @param sphere The volume of a sphere query, or 0
+        @param box The volume of a box query, or 0
+        */
+        void executeShadowCasterQuery(const Light* light, RegionSceneQuery* query,
+            const Sphere* sphere, const AxisAlignedBox* box);
+
         /** Internal method for locating a list of shadow casters which 
             could be affecting the frustum for a given light. 
         @remarks
@@ -983,6 +1390,8 @@ namespace Ogre {
 
         /// Whether to use camera-relative rendering
         bool mCameraRelativeRendering;
+        /// Whether objects compute their LOD once per frame for each LOD camera
+        bool mShareLodAcrossCameras;
         Matrix4 mCachedViewMatrix;
         Vector3 mCameraRelativePosition;
 
@@ -993,6 +1402,89 @@ namespace Ogre {
         /// Gpu params that need rebinding (mask of GpuParamVariability)
         uint16 mGpuParamsDirty;
 
+        /// Texture binding and sampler state last applied to a texture unit
+        struct TextureUnitCache
+        {
+            /// Whether this entry reflects the state of the texture unit
+            bool valid;
+            Texture* texture;
+            TextureUnitState::BindingType bindingType;
+            unsigned int coordSet;
+            bool compareEnabled;
+            CompareFunction compareFunction;
+            FilterOptions minFilter;
+            FilterOptions magFilter;
+            FilterOptions mipFilter;
+            unsigned int anisotropy;
+            float mipmapBias;
+            LayerBlendModeEx colourBlend;
+            LayerBlendModeEx alphaBlend;
+            TextureUnitState::UVWAddressingMode addressing;
+            ColourValue borderColour;
+            Matrix4 transform;
+
+            /** Captures the state of a texture unit.
+            @return False if the state depends on more than the captured values
+                (texture coordinate generation, or a texture which is not loaded)
+                and must always be passed on to the render system
+            */
+            bool set(const TextureUnitState& tus);
+            bool operator==(const TextureUnitCache& rhs) const;
+        };
+
+        /// Render states last applied by _setPass, used to filter redundant changes
+        struct RenderStateCache
+        {
+            GpuProgram* programs[GPT_COMPUTE_PROGRAM + 1];
+            SceneBlendFactor sourceFactor;
+            SceneBlendFactor destFactor;
+            SceneBlendFactor sourceFactorAlpha;
+            SceneBlendFactor destFactorAlpha;
+            SceneBlendOperation blendOperation;
+            SceneBlendOperation blendOperationAlpha;
+            CompareFunction depthFunction;
+            bool depthCheck;
+            bool depthWrite;
+            CompareFunction alphaRejectFunction;
+            unsigned char alphaRejectValue;
+            bool alphaToCoverage;
+            bool colourWrite;
+            bool lightingEnabled;
+            ShadeOptions shading;
+            TextureUnitCache textureUnits[OGRE_MAX_TEXTURE_LAYERS];
+        };
+        RenderStateCache mRenderStateCache;
+        /// Whether redundant render state changes are filtered
+        bool mRedundantStateFiltering;
+        /// Whether mRenderStateCache reflects the state of the render system
+        bool mRenderStateCacheValid;
+        /// Render state changes passed on to the render system
+        size_t mRenderStateChangesIssued;
+        /// Render state changes filtered out as redundant
+        size_t mRenderStateChangesSkipped;
+        /// Passes applied by _setPass
+        size_t mPassChanges;
+
+        /** Internal method to check whether a cached render state needs to be changed.
+        @param unchanged Whether the new value is the same as the cached one
+        @return True if the render system needs to be called
+        */
+        bool isRenderStateChangeNeeded(bool unchanged)
+        {
+            if (unchanged && mRenderStateCacheValid)
+            {
+                ++mRenderStateChangesSkipped;
+                return false;
+            }
+            ++mRenderStateChangesIssued;
+            return true;
+        }
+
+        /** Internal method to apply a texture unit, skipping the render system
+            when the unit already holds the same texture and sampler state.
+        */
+        void setTextureUnitSettings(size_t unit, TextureUnitState& tus);
+
         virtual void useLights(const LightList& lights, unsigned short limit);
         virtual void setViewMatrix(const Matrix4& m);
         virtual void useLightsGpuProgram(const Pass* pass, const LightList* lights);
@@ -3379,6 +3871,294 @@ namespace Ogre {
         */
         virtual bool getFindVisibleObjects(void) { return mFindVisibleObjects; }
 
+        /** Sets whether the scene graph is updated using several threads.
+        @remarks
+            When enabled, _updateSceneGraph hands the subtrees below the root node
+            to the threads of the Root's WorkQueue via WorkQueue::parallelFor, and
+            waits for them all to finish before returning. Node::Listener::nodeUpdated
+            calls are deferred and made afterwards on the calling thread.
+        @par
+            Only enable this when node updates do not modify state shared between
+            subtrees, which is the case for the SceneNode, but not for scene managers
+            which reorganise their spatial structures as nodes move (such as the
+            octree, portal and BSP scene managers). The default is false.
+        */
+        virtual void setParallelUpdateSceneGraph(bool parallel) { mParallelUpdateSceneGraph = parallel; }
+
+        /** Gets whether the scene graph is updated using several threads. */
+        virtual bool getParallelUpdateSceneGraph(void) const { return mParallelUpdateSceneGraph; }
+
+        /** Sets whether the scene graph is updated by a linear sweep instead of recursively.
+        @remarks
+            When enabled, the SceneManager keeps the nodes of the scene graph in a
+            depth ordered array together with the index of each node's parent, and
+            _updateSceneGraph walks this array first forwards to update transforms,
+            then backwards to update bounds. This avoids the recursion and the
+            iteration of every node's child map, which pays off in large scenes where
+            a lot of nodes move every frame; the array itself is only rebuilt when
+            the hierarchy changes.
+        @par
+            Nodes are updated through Node::_updateSelf and SceneNode::_updateBounds,
+            so scene node classes which override SceneNode::_update (such as those of
+            the portal and BSP scene managers) must not be used with this option.
+            Parallel updates take precedence if both are enabled. The default is false.
+        */
+        virtual void setLinearUpdateSceneGraph(bool linear);
+
+        /** Gets whether the scene graph is updated by a linear sweep. */
+        virtual bool getLinearUpdateSceneGraph(void) const { return mLinearUpdateSceneGraph; }
+
+        /** Sets whether scene nodes are culled in batches rather than recursively.
+        @remarks
+            When enabled, _findVisibleObjects gathers the world bounds of the scene
+            nodes into packed arrays and tests them against the camera frustum
+            several at a time using OptimisedUtil::cullBoxes, split across the
+            threads of the Root's WorkQueue via WorkQueue::parallelFor. The objects
+            of the nodes which pass are then queued on the calling thread as usual.
+        @par
+            This gives the same results as the recursive culling, because the bounds
+            of a node include those of its children, but tests the nodes against the
+            frustum planes directly, so custom isVisible implementations of Camera
+            subclasses and SceneNode::_findVisibleObjects overrides are bypassed.
+            The default is false.
+        */
+        virtual void setBatchCulling(bool batch) { mBatchCulling = batch; }
+
+        /** Gets whether scene nodes are culled in batches rather than recursively. */
+        virtual bool getBatchCulling(void) const { return mBatchCulling; }
+
+        /** Culls several cameras ahead of rendering them, in one parallel pass.
+        @remarks
+            Applies the per frame updates and updates the scene graph, then tests
+            the scene nodes against the frustums of all the cameras at once on the
+            threads of the Root's WorkQueue. When a camera is rendered later in
+            the frame, _findVisibleObjects reuses its results, unless the scene
+            graph or the camera changed in between (for example in a
+            RenderTargetListener), in which case it culls again as usual.
+        @par
+            Does nothing unless batch culling is enabled. Called by
+            RenderSystem::_updateAllRenderTargets, see
+            RenderSystem::setParallelTargetPreparation.
+        */
+        virtual void _prepareCameras(const vector<Camera*>::type& cameras);
+
+        /** Sets whether the skeletons of visible entities are evaluated using several threads.
+        @remarks
+            When enabled, after the scene graph has been updated for a camera the
+            SceneManager gathers the skeletally animated entities whose bounds the
+            camera can see, applies their animation states and caches their bone
+            matrices on the threads of the Root's WorkQueue via WorkQueue::parallelFor.
+            When the entities are queued for rendering afterwards, their bones are
+            already up to date for the frame, so only the vertices remain to be blended.
+        @par
+            Entities which share their skeleton instance with others (including
+            manual LOD levels) or have objects attached to their bones are left to
+            be updated when they are queued, as before. Since animations are applied
+            from several threads at once, AnimationTrack::Listener and bone
+            Node::Listener implementations must be thread safe when this is
+            enabled. The default is false.
+        */
+        virtual void setParallelUpdateSkeletons(bool parallel) { mParallelUpdateSkeletons = parallel; }
+
+        /** Gets whether the skeletons of visible entities are evaluated using several threads. */
+        virtual bool getParallelUpdateSkeletons(void) const { return mParallelUpdateSkeletons; }
+
+        /** Sets whether entities with matching animation states share one evaluated pose.
+        @remarks
+            When enabled, entities using the same skeleton whose enabled animation states
+            have equal time positions and weights, within the given quantisation steps
+            (e.g. crowds playing a synchronised idle loop), evaluate the pose only once
+            per frame: the first entity to update its bones evaluates it, and the others
+            copy its bone matrices. Unlike Entity::shareSkeletonInstanceWith this is
+            decided again each frame, so entities drift in and out of groups freely.
+        @par
+            Since the skeleton instance of an entity reusing another's pose isn't updated,
+            entities with manual bones, blend masks, objects attached to bones, bounds
+            updated from the skeleton or skipped animation state updates always evaluate
+            their own pose. The default is false.
+        @param enabled Whether to share poses
+        @param timeStep Animation time positions closer than this are considered equal
+        @param weightStep Animation weights closer than this are considered equal
+        */
+        virtual void setSkeletonPoseSharing(bool enabled, Real timeStep = 0.001f, Real weightStep = 0.01f);
+
+        /** Gets whether entities with matching animation states share one evaluated pose. */
+        virtual bool getSkeletonPoseSharing(void) const { return mSkeletonPoseSharing; }
+
+        /** Internal method used by entities to find out whether another entity has
+            already evaluated the same skeleton pose this frame.
+        @return
+            The entity which evaluated the pose, or the given entity if it has to
+            evaluate it itself (it is then registered as the pose's owner).
+            Null if pose sharing is disabled or the entity can't take part in it.
+        */
+        Entity* _claimSkeletonPose(Entity* entity);
+
+        /** Internal method called when an entity is destroyed, so it no longer
+            provides its pose to other entities. */
+        void _notifySkeletonPoseOwnerDestroyed(Entity* entity);
+
+        /** Internal method registering or unregistering an entity whose bounds
+            follow its skeleton, @see Entity::setUpdateBoundingBoxFromSkeleton */
+        void _notifySkeletonBoundsEntity(Entity* entity, bool fromSkeleton);
+
+        /** Sets whether the shadow caster queries of each light are cached.
+        @remarks
+            Each frame, every shadow casting light runs a sphere query, or for
+            directional lights a box query around the camera frustum, to find its
+            shadow casters. When caching is enabled, the objects a light's query
+            returned are kept and reused as long as the query volume is unchanged and
+            no scene node holding objects other than lights was moved, attached,
+            detached or destroyed since. Only the cheap per object caster tests are then repeated, so lights
+            in static parts of the scene skip their queries entirely.
+        @par
+            Changes which alter what a query returns without a scene node changing,
+            such as new query flags or the bounds of an object changing in place,
+            must be followed by a call to _notifyShadowCastersChanged. The default
+            is false.
+        */
+        virtual void setShadowCasterCaching(bool caching);
+
+        /** Gets whether the shadow caster queries of each light are cached. */
+        virtual bool getShadowCasterCaching(void) const { return mShadowCasterCaching; }
+
+        /** Internal method, notifies the SceneManager that objects which shadow
+            caster queries may return have changed, invalidating their cached results.
+        */
+        void _notifyShadowCastersChanged(void)
+        {
+            if (mShadowCasterCaching)
+                ++mShadowCasterCacheCounter;
+        }
+
+        /** Sets whether static shadow casters are cached in texture shadows.
+        @remarks
+            Objects whose visibility flags match the static shadow caster mask are
+            then rendered into a copy of each shadow texture, which is kept between
+            frames and only rendered again when the shadow camera of the texture
+            no longer fits in the one the copy was rendered with, or its light changed.
+            Each frame the copy is blitted back to the shadow texture and the other
+            casters are blended over it, keeping the nearest (or darkest) value, so
+            the caster materials must write values where lower means closer, as
+            depth shadow maps and modulative shadows do.
+        @par
+            To make the copies last, they are rendered with a shadow camera widened
+            by the cache margin, and the cascades of directional lights are moved
+            by whole texels so that the shadows do not shimmer as they scroll with
+            the view. Call invalidateStaticShadowCache after static casters changed.
+        @par
+            This needs RSC_ADVANCED_BLEND_OPERATIONS, shadow textures are updated
+            normally without it. The default is false.
+        */
+        virtual void setStaticShadowCaching(bool caching);
+        /** Gets whether static shadow casters are cached in texture shadows. */
+        virtual bool getStaticShadowCaching(void) const { return mStaticShadowCaching; }
+
+        /** Sets the visibility flags of the objects cached as static shadow casters
+            (default 0, none). */
+        virtual void setStaticShadowCasterMask(uint32 mask);
+        /** Gets the visibility flags of the objects cached as static shadow casters. */
+        virtual uint32 getStaticShadowCasterMask(void) const { return mStaticShadowCasterMask; }
+
+        /** Sets how much wider than needed, as a fraction of its size, the shadow
+            camera of cached static casters is, so the view can move before they
+            are rendered again (default 0.1). */
+        virtual void setStaticShadowCacheMargin(Real margin);
+        /** Gets how much wider than needed the shadow camera of cached static casters is. */
+        virtual Real getStaticShadowCacheMargin(void) const { return mStaticShadowCacheMargin; }
+
+        /** Makes the cached static shadow casters be rendered again next frame. */
+        virtual void invalidateStaticShadowCache(void);
+
+        /** Sets the size of a single texture which all shadow textures are packed
+            into as tiles, or 0 to use a texture each (the default).
+        @remarks
+            With many shadowed lights, rendering each shadow texture to its own
+            render target costs a target switch each. In atlas mode every shadow
+            texture is instead a viewport of one texture, using the format and
+            FSAA of the first shadow texture configuration. Each frame the tile of
+            a light's textures is sized by how much of the screen the light covers
+            (directional lights always getting the largest size), up to the size
+            configured for the shadow texture, and shrunk from the largest tiles down
+            when they do not all fit, the tiles of the lights sorted last being shrunk first.
+        @par
+            Receivers get the tile through the texture projection matrices, so
+            programmable receivers, including the RTSS shadow sub-render states,
+            work unchanged, but fixed-function projective texturing does not.
+            Filtering near the edges of a tile may read from its neighbours.
+            Static shadow caster caching is not used with an atlas.
+        @param size The size of the square atlas, rounded down to a power of two
+        */
+        virtual void setShadowAtlasSize(unsigned int size);
+        /** Gets the size of the texture shadow textures are packed into, or 0. */
+        virtual unsigned int getShadowAtlasSize(void) const { return mShadowAtlasSize; }
+
+        /** Sets the smallest size of a tile of the shadow atlas, rounded down to a
+            power of two (default 64).
+        @remarks
+            The atlas must be able to hold a tile of this size for each shadow texture.
+        */
+        virtual void setShadowAtlasMinTileSize(unsigned int size);
+        /** Gets the smallest size of a tile of the shadow atlas. */
+        virtual unsigned int getShadowAtlasMinTileSize(void) const { return mShadowAtlasMinTileSize; }
+
+        /** Sets the largest number of shadow textures rendered in a frame, or 0 for
+            no limit (the default).
+        @remarks
+            Shadow textures which are due, by the shadow update interval of their
+            light (see Light::setShadowUpdateInterval), are rendered in order of
+            how many frames overdue they are, then in the order of the lights, which
+            are sorted closest first. Those left out are rendered in a later frame,
+            so with many shadowed lights they take turns. Textures assigned to
+            another light or camera than last rendered for are always rendered, and
+            count towards the budget.
+        @par
+            Textures are not kept between frames in atlas mode, where the tiles are
+            packed again every frame, so intervals and the budget are ignored then.
+        */
+        virtual void setShadowTextureUpdateBudget(size_t textures) { mShadowTextureUpdateBudget = textures; }
+        /** Gets the largest number of shadow textures rendered in a frame, or 0 for no limit. */
+        virtual size_t getShadowTextureUpdateBudget(void) const { return mShadowTextureUpdateBudget; }
+
+        /** Sets whether shadow casters are culled against the shadow receivers
+            visible from the main camera, when rendering shadow textures.
+        @remarks
+            The bounds of the visible receivers are found before the shadow textures
+            are rendered, and casters outside the convex hull of those bounds and the
+            light (or the bounds extruded towards a directional light) are left out
+            of the shadow textures, since their shadows cannot fall on anything seen.
+            In open scenes this removes many casters which are in the light frustum
+            but behind the view. It costs an extra pass over the visible scene nodes
+            per camera. The default is false.
+        */
+        virtual void setShadowCasterReceiverCulling(bool culling) { mShadowCasterReceiverCulling = culling; }
+        /** Gets whether shadow casters are culled against the visible shadow receivers. */
+        virtual bool getShadowCasterReceiverCulling(void) const { return mShadowCasterReceiverCulling; }
+        /** Gets the volume shadow casters must intersect to be rendered into the
+            current shadow texture, or null when casters are not culled by it. */
+        const PlaneBoundedVolume* _getShadowCasterCullVolume(void) const
+        {
+            return mShadowCasterCullVolumeActive ? &mShadowCasterCullVolume : 0;
+        }
+
+        /** Sets the number of lights affecting the frustum from which per object
+            light lists are gathered through a spatial index.
+        @remarks
+            With many point and spot lights in view, _populateLightList testing every
+            one of them for every object becomes expensive. From this number of lights
+            on, the lights are inserted into a uniform grid whenever the set of lights
+            affecting the frustum changes, and only the lights sharing a cell with the
+            object are tested. The resulting lists are the same. The default is 16, 0
+            disables the grid.
+        */
+        virtual void setLightGridThreshold(size_t count) { mLightGridThreshold = count; }
+
+        /** Gets the number of lights from which per object light lists use a spatial index. */
+        virtual size_t getLightGridThreshold(void) const { return mLightGridThreshold; }
+
+        /** Internal method, notifies the SceneManager that the node hierarchy changed. */
+        void _notifySceneGraphChanged(void) { mLinearUpdateNodesDirty = true; }
+
         /** Set whether to automatically normalise normals on objects whenever they
             are scaled.
         @remarks
@@ -3467,6 +4247,64 @@ namespace Ogre {
         */
         virtual void _markGpuParamsDirty(uint16 mask);
 
+        /** Sets whether render state changes made by _setPass which match the 
+            state applied by the previous _setPass are skipped.
+        @remarks
+            Consecutive passes often share their blending, depth, alpha rejection, 
+            colour write, lighting and shading settings, GPU programs and 
+            texture units (texture binding and sampler state), but by 
+            default these are passed on to the render system for every pass, 
+            relying on the render system to filter redundant changes, which not 
+            all of them do. When this option is enabled, the SceneManager keeps 
+            the settings it last applied and only passes on those which changed.
+        @par
+            The cached settings are discarded at the start of each scene render
+            and around render queue and render object listener callbacks, so 
+            that state changed outside of _setPass is picked up. If you change
+            any of these settings directly on the render system in other places,
+            call _invalidateRenderStateCache afterwards. The default is false.
+        */
+        virtual void setRedundantStateFiltering(bool filter);
+
+        /** Gets whether redundant render state changes made by _setPass are skipped. */
+        virtual bool getRedundantStateFiltering(void) const { return mRedundantStateFiltering; }
+
+        /** Discards the render state cached for redundant state filtering, so that
+            the next _setPass applies all of its settings.
+        */
+        virtual void _invalidateRenderStateCache(void) { mRenderStateCacheValid = false; }
+
+        /** Gets the number of render state changes which _setPass passed on to
+            the render system since the counts were last reset.
+        @see setRedundantStateFiltering
+        */
+        size_t getRenderStateChangesIssued(void) const { return mRenderStateChangesIssued; }
+
+        /** Gets the number of redundant render state changes which _setPass 
+            skipped since the counts were last reset.
+        @see setRedundantStateFiltering
+        */
+        size_t getRenderStateChangesSkipped(void) const { return mRenderStateChangesSkipped; }
+
+        /** Gets the number of pass transitions, i.e. passes applied by _setPass,
+            since the counts were last reset.
+        @remarks
+            This is a measure of how well the render queue groups renderables by
+            pass state. Reset the counts at the start of each frame (e.g. from
+            FrameListener::frameStarted) to get per-frame figures.
+        @see Pass::getSortKey
+        */
+        size_t getPassChanges(void) const { return mPassChanges; }
+
+        /** Resets the counts of pass transitions and issued and skipped render 
+            state changes. */
+        void resetRenderStateChangeCounts(void)
+        {
+            mRenderStateChangesIssued = 0;
+            mRenderStateChangesSkipped = 0;
+            mPassChanges = 0;
+        }
+
 
         /** Indicates to the SceneManager whether it should suppress the 
             active shadow rendering technique until told otherwise.
@@ -3548,6 +4386,128 @@ namespace Ogre {
         */
         virtual bool getCameraRelativeRendering() const { return mCameraRelativeRendering; }
 
+        /** Sets whether entities compute their level of detail only once per frame
+            for all the cameras sharing the same LOD camera (see Camera::setLodCamera).
+        @remarks
+            Texture shadow cameras use the camera they are rendered for as their
+            LOD camera, so with this enabled shadow casters use the LOD selected
+            for the main view instead of selecting it again for each shadow
+            texture. It is disabled by default, since a LOD camera rendered to
+            several viewports in a frame may need a different LOD for each.
+        */
+        virtual void setShareLodAcrossCameras(bool share) { mShareLodAcrossCameras = share; }
+        /** Gets whether entities compute their level of detail only once per frame
+            for each LOD camera. */
+        virtual bool getShareLodAcrossCameras() const { return mShareLodAcrossCameras; }
+
+        /// First texture coordinate set of the instance world matrix rows in automatic instancing
+        static const unsigned short AUTO_INSTANCING_TEXCOORD_INDEX = 5;
+
+        /** Set whether to draw identical entities with hardware instancing automatically.
+        @remarks
+            When enabled, sub entities rendered with the same pass, which share vertex data,
+            index data and lights and are neither skeletally nor vertex animated, are collected
+            while the render queue is rendered and drawn with a single instanced call. Their
+            world matrices are written to a per-draw instance buffer, as three rows in the
+            texture coordinates from AUTO_INSTANCING_TEXCOORD_INDEX on, so meshes using those
+            are rendered normally.
+        @par
+            The instanced draws use the technique of the material with the given scheme and
+            the same LOD index, at the same pass index; materials without one are rendered
+            normally. Its vertex program must apply the instance matrix and take the world
+            matrix as identity; the RTShader system generates such programs when the
+            "auto_instancing" sub render state is added to the render state of the scheme.
+            Shadow texture casters are instanced too when the pass of the instancing
+            scheme has a shadow caster vertex program, or its technique a shadow caster
+            material, applying the instance matrix, since the caster pass derived from
+            it is used; the RTShader system does not generate those. Stencil shadow
+            passes are not instanced.
+        @param enabled Whether to instance automatically
+        @param schemeName The material scheme of the instanced techniques
+        */
+        void setAutoInstancingEnabled(bool enabled, const String& schemeName = "AutoInstancing");
+        /** Get whether identical entities are drawn with hardware instancing automatically. */
+        bool isAutoInstancingEnabled(void) const { return mAutoInstancing; }
+        /** Get the material scheme of the automatically instanced techniques. */
+        const String& getAutoInstancingScheme(void) const { return mAutoInstancingScheme; }
+        /** Set the number of identical entities below which they are rendered one by one
+            (default 4). */
+        void setAutoInstancingMinCount(size_t count) { mAutoInstancingMinCount = std::max<size_t>(count, 2); }
+        /** Get the number of identical entities below which they are rendered one by one. */
+        size_t getAutoInstancingMinCount(void) const { return mAutoInstancingMinCount; }
+
+        /** Enables or disables a depth pre-pass of opaque objects.
+        @remarks
+            When enabled, the opaque passes of each render queue group are first
+            rendered depth only, with a pass derived from each of them like shadow
+            caster passes are, and then rendered with an equal depth test and depth
+            writes disabled, so that expensive fragment programs only run once per
+            pixel whatever the overdraw. See isDepthPrePassCandidate for the passes
+            this applies to. The pre-pass is only used for the regular render stage,
+            with the default render queue invocation sequence, and not with additive
+            shadow techniques. Automatically instanced passes are drawn one by one in
+            queue groups with a pre-pass. The default is false.
+        */
+        void setDepthPrePassEnabled(bool enabled) { mDepthPrePass = enabled; }
+        /** Gets whether opaque objects are rendered in a depth pre-pass. */
+        bool isDepthPrePassEnabled(void) const { return mDepthPrePass; }
+
+        /** Enables or disables software occlusion culling.
+        @remarks
+            When enabled, the occluders added to getOcclusionCuller() are rasterised
+            on the CPU before the visible objects of each camera are found, and
+            objects whose bounds lie entirely behind them are not rendered. Shadow
+            texture cameras are not occlusion culled. Disabling destroys the culler
+            along with its occluders.
+        */
+        void setOcclusionCullingEnabled(bool enabled);
+        /** Gets whether software occlusion culling is enabled. */
+        bool isOcclusionCullingEnabled(void) const { return mOcclusionCuller != 0; }
+        /** Gets the occlusion culler, or null if occlusion culling is disabled. */
+        SoftwareOcclusionCuller* getOcclusionCuller(void) const { return mOcclusionCuller; }
+
+        /** Groups cameras so that they share one visibility pass each frame.
+        @remarks
+            Meant for the eyes of a stereo rig or the views of a split or tiled
+            display, which see nearly the same objects. When the first camera of the
+            group is rendered, the lights and visible objects are found once against
+            a perspective frustum enclosing the frustums of all the cameras, and the
+            render queue built is then rendered as is to the viewports of the other
+            cameras rendered after it in the same frame, with their own view,
+            projection and automatic parameters. Transparent objects are still sorted
+            for each camera, but level of detail, skies and shadow textures are those
+            of the first camera, and the viewports should use the same render queue
+            invocation sequence.
+        @par
+            The cameras must use a perspective projection and look in directions
+            close enough for one frustum to enclose theirs, as the eyes of a stereo
+            rig do; otherwise, or when another camera rendered in between rebuilt
+            the render queue, each camera is culled as usual. Software occlusion
+            culling is not applied to the first camera of a group.
+        @param cameras The cameras of the group, which are removed from any previous
+            group. The first one must be rendered first in each frame, so for the
+            viewports of one render target it should have the lowest Z order.
+        */
+        void addCameraGroup(const vector<Camera*>::type& cameras);
+        /** Removes the group the given camera belongs to, if any. */
+        void removeCameraGroup(Camera* camera);
+        /** Gets the first camera of the group the given camera belongs to, or null. */
+        Camera* getCameraGroupLeader(const Camera* camera) const;
+
+        /** Enables or disables gathering statistics of how well the render queue batches.
+        @remarks
+            When enabled, the renderables queued per queue group and priority, the
+            distinct passes, the pass switches after sorting and the consecutive
+            draws which could have been instanced are counted every frame, see
+            RenderQueueDiagnostics. This costs some time per draw, so it is meant
+            for profiling content rather than for shipping.
+        */
+        void setRenderQueueDiagnosticsEnabled(bool enabled);
+        /** Gets whether render queue statistics are gathered. */
+        bool isRenderQueueDiagnosticsEnabled(void) const { return mRenderQueueDiagnostics != 0; }
+        /** Gets the render queue statistics of the last frame, or null if disabled. */
+        RenderQueueDiagnostics* getRenderQueueDiagnostics(void) const { return mRenderQueueDiagnostics; }
+
 
         /** Add a level of detail listener. */
         void addLodListener(LodListener *listener);
@@ -357,6 +357,19 @@ namespace Ogre {
         MovableObject* movable;
         /// The world fragment, or NULL if this is not a fragment result
         SceneQuery::WorldFragment* worldFragment;
+        /// Whether the triangles of the movable were hit rather than its bounds,
+        /// see RaySceneQuery::setTriangleAccurate
+        bool triangleHit;
+        /// The submesh of the triangle hit, if triangleHit
+        ushort subMesh;
+        /// The index of the triangle hit in the index data of the submesh, if triangleHit
+        uint32 triangle;
+        /// The weights of the three corners of the triangle at the hit point, if triangleHit
+        Vector3 barycentric;
+
+        RaySceneQueryResultEntry()
+            : distance(0), movable(0), worldFragment(0), triangleHit(false), subMesh(0), triangle(0),
+              barycentric(Vector3::ZERO) {}
         /// Comparison operator for sorting
         bool operator < (const RaySceneQueryResultEntry& rhs) const
         {
@@ -373,6 +386,7 @@ namespace Ogre {
         Ray mRay;
         bool mSortByDistance;
         ushort mMaxResults;
+        bool mTriangleAccurate;
         RaySceneQueryResult mResult;
 
     public:
@@ -406,6 +420,26 @@ namespace Ogre {
         /** Gets the maximum number of results returned from the query (only relevant if 
         results are being sorted) */
         virtual ushort getMaxResults(void) const;
+        /** Sets whether entities are tested against their triangles rather than their bounds.
+        @remarks
+            When enabled, the version of execute returning a collection only reports the
+            entities whose triangles are hit by the ray, at the distance of the nearest
+            triangle, with the triangle and the barycentric coordinates of the hit filled
+            in. The triangles are found through a bounding volume hierarchy, see
+            Entity::getBVH. Other objects are still tested against their bounds. Listeners
+            of the other version of execute receive bounds hits, which they can test with
+            getTriangleHit.
+        */
+        virtual void setTriangleAccurate(bool accurate);
+        /** Gets whether entities are tested against their triangles. */
+        virtual bool getTriangleAccurate(void) const;
+        /** Finds the nearest triangle of an entity hit by a ray.
+        @param ray The ray in world space
+        @param entity The entity, which must be attached to a node
+        @param result Receives the hit, with distance in units of the ray direction
+        @return Whether a triangle was hit
+        */
+        static bool getTriangleHit(const Ray& ray, Entity* entity, RaySceneQueryResultEntry& result);
         /** Executes the query, returning the results back in one list.
         @remarks
             This method executes the scene query as configured, gathers the results
@@ -418,6 +418,24 @@ namespace Ogre
 
         // A pointer to the specific compiler instance used
         OGRE_THREAD_POINTER(ScriptCompiler, mScriptCompiler);
+
+        /// A parsed script, along with the hash of the text it was parsed from
+        struct ParsedScript
+        {
+            uint32 hash;
+            ConcreteNodeListPtr nodes;
+        };
+        typedef map<String, ParsedScript>::type ParsedScriptCache;
+        // Parsed scripts by source name, see setSaveParsedScriptsToCache
+        ParsedScriptCache mParsedScriptCache;
+        bool mSaveParsedScriptsToCache;
+        bool mParsedScriptCacheDirty;
+        OGRE_MUTEX(mParsedScriptCacheMutex);
+
+        /// Lexes and parses a script, or returns its cached nodes if the text didn't change
+        ConcreteNodeListPtr parseScriptNodes(const String& script, const String& source);
+        static void writeNodes(const ConcreteNodeList& nodes, const DataStreamPtr& stream);
+        static void readNodes(ConcreteNodeList& nodes, ConcreteNode* parent, const DataStreamPtr& stream);
     public:
         ScriptCompilerManager();
         virtual ~ScriptCompilerManager();
@@ -455,9 +473,39 @@ namespace Ogre
         const StringVector& getScriptPatterns(void) const;
         /// @copydoc ScriptLoader::parseScript
         void parseScript(DataStreamPtr& stream, const String& groupName);
+        /** Lexes and parses a script into its concrete nodes, without compiling them.
+        @remarks
+            This is thread safe, so several scripts can be parsed at once from different
+            threads, then compiled in order with _compileScriptNodes. Uses the parsed
+            script cache, see setSaveParsedScriptsToCache.
+        */
+        ConcreteNodeListPtr _parseScriptNodes(const String& script, const String& source);
+        /** Compiles the concrete nodes of a script parsed with _parseScriptNodes, like
+            parseScript would. */
+        void _compileScriptNodes(const ConcreteNodeListPtr& nodes, const String& groupName);
         /// @copydoc ScriptLoader::getLoadingOrder
         Real getLoadingOrder(void) const;
 
+        /** Sets whether the scripts parsed are kept in the parsed script cache, to
+            be saved with saveParsedScriptCache.
+        @remarks
+            Scripts found in the cache with the same text are not lexed and parsed
+            again, whether this is set or not. Only the parsing is cached: compiling
+            the scripts into resources (imports, inheritance, translation) still
+            happens every time.
+        */
+        void setSaveParsedScriptsToCache(bool save) { mSaveParsedScriptsToCache = save; }
+        /** Gets whether the scripts parsed are kept in the parsed script cache. */
+        bool getSaveParsedScriptsToCache(void) const { return mSaveParsedScriptsToCache; }
+        /** Saves the parsed script cache to a stream, e.g. a file in a writable
+            archive, if it has changed since it was loaded. */
+        void saveParsedScriptCache(DataStreamPtr stream) const;
+        /** Loads a parsed script cache saved by saveParsedScriptCache, replacing the
+            current one. Caches saved by a different version are ignored. */
+        void loadParsedScriptCache(DataStreamPtr stream);
+        /** Clears the parsed script cache. */
+        void clearParsedScriptCache(void);
+
         /** Override standard Singleton retrieval.
         @remarks
         Why do we do this? Well, it's because the Singleton
@@ -897,6 +945,10 @@ namespace Ogre
         // Support for subroutine
         ID_SUBROUTINE,
 
+        // Compositor target pass updates
+        ID_UPDATE_INTERVAL,
+        ID_ONLY_WHEN_DIRTY,
+
         ID_END_BUILTIN_IDS
     };
     /** @} */
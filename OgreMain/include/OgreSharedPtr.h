@@ -59,6 +59,14 @@ namespace Ogre {
 
         virtual ~SharedPtrInfo() {}
 
+        /// Destroys the object once its last reference is gone, along with this block.
+        virtual void destroy()
+        {
+            // What OGRE_DELETE_T does, without its null check on this
+            this->~SharedPtrInfo();
+            CategorisedAllocPolicy<MEMCATEGORY_GENERAL>::deallocateBytes(this);
+        }
+
         AtomicScalar<unsigned>  useCount;
     };
 
@@ -92,6 +100,35 @@ namespace Ogre {
         }
     };
 
+    /** Reference count stored as a member of the object it counts.
+    @remarks
+        Saves allocating a separate block per object, and lets any number of
+        SharedPtr be made from a plain pointer to the object, see the SharedPtr
+        constructor taking one of these. The object is deleted with OGRE_DELETE
+        when the last of them is gone. Like the other counts, it is only atomic
+        if OGRE_THREAD_SUPPORT is enabled.
+    */
+    template <class T>
+    class SharedPtrInfoIntrusive : public SharedPtrInfo
+    {
+        T* mObject;
+
+        SharedPtrInfoIntrusive(const SharedPtrInfoIntrusive&); /* do not use */
+    public:
+        inline explicit SharedPtrInfoIntrusive(T* o) : mObject(o)
+        {
+            useCount = 0;
+        }
+
+        /// Assigning the owning object must not copy its count
+        SharedPtrInfoIntrusive& operator=(const SharedPtrInfoIntrusive&) { return *this; }
+
+        virtual void destroy()
+        {
+            OGRE_DELETE mObject;
+        }
+    };
+
     template <class T>
     class SharedPtrInfoFree : public SharedPtrInfo
     {
@@ -170,6 +207,24 @@ namespace Ogre {
         {
         }
 
+        /** Constructor sharing the reference count stored in the object itself.
+        @remarks
+            Unlike the constructors taking ownership, this may be used any number
+            of times on the same object.
+        @param rep The object to reference
+        @param info The reference count member of rep
+        */
+        template<class Y, class Z>
+        SharedPtr(Y* rep, SharedPtrInfoIntrusive<Z>* info)
+            : pRep(rep)
+            , pInfo(rep ? info : 0)
+        {
+            if (pRep)
+            {
+                ++pInfo->useCount;
+            }
+        }
+
         SharedPtr(const SharedPtr& r)
             : pRep(r.pRep)
             , pInfo(r.pInfo)
@@ -340,7 +395,7 @@ namespace Ogre {
         inline void destroy(void)
         {
             assert(pRep && pInfo);
-            OGRE_DELETE_T(pInfo, SharedPtrInfo, MEMCATEGORY_GENERAL);
+            pInfo->destroy();
         }
 
         inline void swap(SharedPtr<T> &other) 
@@ -254,6 +254,22 @@ namespace Ogre {
         */
         virtual void setAnimationState(const AnimationStateSet& animSet);
 
+        /** Sets whether setAnimationState keeps the node tracks of each enabled
+            animation sampled at its time position, so that only the animations whose
+            time position changed since the previous call are sampled again.
+        @remarks
+            Blending several animations then only costs weighting the kept samples
+            into the bones for the animations which didn't advance, e.g. paused or
+            masked layers; a change of weight or blend mask doesn't need to sample
+            anything again. The samples are only kept for the animations enabled at
+            the last call. Keyframes edited while this is enabled are only taken into
+            account once the time position of the animation changes, or after
+            disabling this. Most useful on skeleton instances, where it's per entity.
+        */
+        virtual void setAnimationSampleCaching(bool enabled);
+        /** Gets whether setAnimationState keeps the sampled node tracks of the animations. */
+        virtual bool getAnimationSampleCaching(void) const { return mAnimationSampleCaching; }
+
 
         /** Initialise an animation set suitable for use with this skeleton. 
         @remarks
@@ -438,6 +454,21 @@ namespace Ogre {
         /// List of references to other skeletons to use animations from 
         mutable LinkedSkeletonAnimSourceList mLinkedSkeletonAnimSourceList;
 
+        /// Whether the sampled node tracks of the animations are kept, see setAnimationSampleCaching
+        bool mAnimationSampleCaching;
+        struct CachedAnimationSample
+        {
+            /// The animation sampled, in case another one replaced it under the same name
+            Animation* animation;
+            Animation::SkeletonSample sample;
+            /// Whether the animation was enabled at the last setAnimationState
+            bool used;
+
+            CachedAnimationSample() : animation(0), used(false) {}
+        };
+        typedef map<String, CachedAnimationSample>::type AnimationSampleCache;
+        AnimationSampleCache mAnimationSamples;
+
         /** Internal method which parses the bones to derive the root bone. 
         @remarks
             Must be const because called in getRootBone but mRootBone is mutable
@@ -101,6 +101,18 @@ namespace Ogre {
                     // Quaternion rotate            : Rotation to apply at this keyframe
                     // Vector3 translate            : Translation to apply at this keyframe
                     // Vector3 scale                : Scale to apply at this keyframe
+
+                SKELETON_ANIMATION_TRACK_COMPRESSED = 0x4120,
+                // [Optional, Serializer_v1.100+] All the keyframes of a compressed
+                // track, instead of SKELETON_ANIMATION_TRACK_KEYFRAME chunks
+                // (see NodeAnimationTrack::CompressedKeyFrames)
+
+                    // unsigned short numKeyFrames
+                    // unsigned short flags         : 1 if translations follow, 2 if scales follow
+                    // float times[numKeyFrames]
+                    // unsigned short rotations[numKeyFrames * 3]
+                    // Vector3 translates[numKeyFrames]
+                    // Vector3 scales[numKeyFrames]
         SKELETON_ANIMATION_LINK         = 0x5000
         // Link to another skeleton, to re-use its animations
 
@@ -0,0 +1,183 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SoftwareOcclusionCuller_H__
+#define __SoftwareOcclusionCuller_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreAxisAlignedBox.h"
+#include "OgreMatrix4.h"
+#include "OgreVector4.h"
+#include "OgreMesh.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Culls objects hidden behind designated occluders, on the CPU.
+    @remarks
+        Before the visible objects of a camera are found, the triangles of the
+        occluders in view are rasterised into a small depth buffer, from which a
+        hierarchy of maximum depths is built. The world bounding box of every
+        object in the frustum is then tested against it, and objects entirely
+        behind the occluders are not queued for rendering. Rasterisation is split
+        into bands of rows across the threads of the Root's WorkQueue.
+    @par
+        Occluders should be large, closed and simple, and must never extend
+        beyond the geometry they stand for, or objects which are partially
+        visible get culled. A simplified mesh fitting inside the rendered one is
+        ideal. Created and used by the SceneManager, see
+        SceneManager::setOcclusionCullingEnabled.
+    */
+    class _OgreExport SoftwareOcclusionCuller : public SceneMgtAlloc
+    {
+    public:
+        /** Constructor.
+        @param width Width of the depth buffer in pixels
+        @param height Height of the depth buffer in pixels
+        */
+        SoftwareOcclusionCuller(uint32 width = 256, uint32 height = 128);
+        ~SoftwareOcclusionCuller();
+
+        /** Adds an occluder.
+        @param object The object whose parent node places the occluder
+        @param mesh The geometry to rasterise. If null, object must be an
+            Entity, and the lowest LOD of its mesh is used.
+        @note
+            The occluder must be removed before the object is destroyed.
+        */
+        void addOccluder(MovableObject* object, const MeshPtr& mesh = MeshPtr());
+        /** Removes an occluder added with addOccluder. */
+        void removeOccluder(MovableObject* object);
+        /** Removes all occluders. */
+        void removeAllOccluders(void);
+        /** Gets the number of occluders. */
+        size_t getNumOccluders(void) const { return mOccluders.size(); }
+
+        /** Sets the size of the depth buffer.
+        @remarks
+            Larger buffers cull more accurately, smaller ones rasterise faster.
+        */
+        void setResolution(uint32 width, uint32 height);
+        /** Gets the width of the depth buffer in pixels. */
+        uint32 getWidth(void) const { return mWidth; }
+        /** Gets the height of the depth buffer in pixels. */
+        uint32 getHeight(void) const { return mHeight; }
+
+        /** Rasterises the occluders visible from a camera and builds the depth
+            hierarchy. Called by the SceneManager before finding visible objects.
+        */
+        void update(const Camera* cam);
+
+        /** Tells whether a world space box is entirely hidden by the occluders.
+        @remarks
+            Always false unless update was last called with the same camera in
+            the current frame. May be called from several threads at once.
+        */
+        bool isOccluded(const AxisAlignedBox& box, const Camera* cam) const;
+
+        /** Tells whether update was last called with a camera in the current
+            frame, and rasterised some occluders. */
+        bool isUpToDate(const Camera* cam) const;
+
+        /** Gets the number of occluder triangles rasterised by the last update. */
+        size_t getNumRasterisedTriangles(void) const { return mTriangles.size(); }
+
+        /** Gets a level of the depth hierarchy, for debugging.
+        @remarks
+            Level 0 is the full resolution depth buffer, each following level
+            holds the maximum of 2x2 pixels of the previous one. Depths are
+            post projection z / w, in rows from the top of the view.
+        */
+        const float* getDepthLevel(size_t level, uint32& width, uint32& height) const;
+        /** Gets the number of levels of the depth hierarchy. */
+        size_t getNumDepthLevels(void) const { return mLevels.size(); }
+
+        /// A triangle in depth buffer coordinates
+        struct Triangle
+        {
+            float x[3], y[3], z[3];
+        };
+        typedef vector<Triangle>::type TriangleList;
+
+        /// Internal method rasterising the triangles into rows [beginRow, endRow)
+        void _rasteriseRows(uint32 beginRow, uint32 endRow);
+
+    protected:
+        /// Positions and indices of an occluder mesh, in object space
+        struct OccluderGeometry
+        {
+            vector<Vector3>::type positions;
+            vector<uint32>::type indices;
+            AxisAlignedBox bounds;
+        };
+        typedef map<String, OccluderGeometry*>::type OccluderGeometryMap;
+
+        struct Occluder
+        {
+            MovableObject* object;
+            OccluderGeometry* geometry;
+        };
+        typedef vector<Occluder>::type OccluderList;
+
+        struct Level
+        {
+            uint32 width, height;
+            vector<float>::type depths;
+        };
+        typedef vector<Level>::type LevelList;
+
+        uint32 mWidth;
+        uint32 mHeight;
+        OccluderList mOccluders;
+        OccluderGeometryMap mGeometries;
+        LevelList mLevels;
+        TriangleList mTriangles;
+        /// Camera and frame of the last update
+        const Camera* mCamera;
+        unsigned long mFrameNumber;
+        Matrix4 mViewProj;
+        bool mFlipWinding;
+        /// Scratch space for the clip space positions of an occluder
+        vector<Vector4>::type mClipPositions;
+
+        OccluderGeometry* createGeometry(const MeshPtr& mesh, ushort lod);
+        void addTriangles(const OccluderGeometry& geom, const Matrix4& worldViewProj);
+        void addClippedTriangle(const Vector4* clip);
+        void buildLevels(void);
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreMovableObject.h"
 #include "OgreRenderable.h"
 #include "OgreMesh.h"
+#include "OgreRenderOperation.h"
 #include "OgreHeaderPrefix.h"
 
 namespace Ogre {
@@ -177,6 +178,8 @@ namespace Ogre {
             Vector3 scale;
         };
         typedef vector<QueuedGeometry*>::type QueuedGeometryList;
+        /// Source buffers locked for reading while geometry buckets are filled
+        typedef map<HardwareBuffer*, uchar*>::type BufferLockMap;
         
         // forward declarations
         class LODBucket;
@@ -206,6 +209,28 @@ namespace Ogre {
             HardwareIndexBuffer::IndexType mIndexType;
             /// Maximum vertex indexable
             size_t mMaxVertexIndex;
+            /// Destination buffers, locked between build and _finishBuild
+            vector<uchar*>::type mDestBufferLocks;
+            void* mDestIndexLock;
+
+            /// The indexes and region relative bounds of one queued geometry
+            struct SubRange
+            {
+                AxisAlignedBox bounds;
+                uint32 indexStart;
+                uint32 indexCount;
+            };
+            typedef vector<SubRange>::type SubRangeList;
+            /// Empty unless StaticGeometry::setSubRangeCulling was enabled
+            SubRangeList mSubRanges;
+            /// Visible runs of sub-ranges for the current camera
+            vector<IndirectDrawCommand>::type mVisibleDraws;
+            /// Spans the visible sub-ranges for the current camera
+            IndexData* mVisibleIndexData;
+            /// Culls the sub-ranges on the GPU instead, if StaticGeometry::setGpuCulling was enabled
+            GpuDrawCuller* mGpuCuller;
+            /// Transform version of the region's node the culler's bounds were placed with
+            unsigned long mGpuCullerTransformVersion;
 
             template<typename T>
             void copyIndexes(const T* src, T* dst, size_t count, size_t indexOffset)
@@ -244,8 +269,29 @@ namespace Ogre {
             @return false if there is no room left in this bucket
             */
             bool assign(QueuedGeometry* qsm);
-            /// Build
+            /** Create and lock the buffers, the first stage of the build.
+            @remarks
+                StaticGeometry::build follows this with _fillBuffers and
+                _finishBuild.
+            */
             void build(bool stencilShadows);
+            /// Lock the source buffers of the queued geometry which are not in @a locks
+            void _lockSourceBuffers(BufferLockMap& locks) const;
+            /** Copy the queued geometry into the locked buffers.
+            @remarks
+                Only the state of this bucket is modified, so several buckets
+                may be filled at once from different threads.
+            @param sourceLocks The locked contents of every source buffer
+            @param keepSubRanges Whether to record the bounds of each queued
+                geometry for culling
+            */
+            void _fillBuffers(const BufferLockMap& sourceLocks, bool keepSubRanges);
+            /// Unlock the buffers, the last stage of the build
+            void _finishBuild(bool stencilShadows);
+            /** Cull the sub-ranges of this bucket against a camera.
+            @return false if no part of the bucket is visible
+            */
+            bool _updateVisibleRanges(const Camera* cam);
             /// Dump contents for diagnostics
             void dump(std::ofstream& of) const;
         };
@@ -359,8 +405,10 @@ namespace Ogre {
             Real getLodValue(void) const { return mLodValue; }
             /// Assign a queued submesh to this bucket, using specified mesh LOD
             void assign(QueuedSubMesh* qsm, ushort atLod);
-            /// Build
+            /// Build the material buckets, see GeometryBucket::build
             void build(bool stencilShadows);
+            /// Build the edge list once the geometry buckets are filled
+            void _finishBuild(bool stencilShadows);
             /// Add children to the render queue
             void addRenderables(RenderQueue* queue, uint8 group, 
                 Real lodValue);
@@ -439,8 +487,10 @@ namespace Ogre {
             StaticGeometry* getParent(void) const { return mParent;}
             /// Assign a queued mesh to this region, read for final build
             void assign(QueuedSubMesh* qmesh);
-            /// Build this region
+            /// Build this region, see GeometryBucket::build
             void build(bool stencilShadows);
+            /// Finish building once the geometry buckets are filled
+            void _finishBuild(bool stencilShadows);
             /// Get the region ID of this region
             uint32 getID(void) const { return mRegionID; }
             /// Get the centre point of the region
@@ -504,6 +554,8 @@ namespace Ogre {
         bool mRenderQueueIDSet;
         /// Stores the visibility flags for the regions
         uint32 mVisibilityFlags;
+        bool mSubRangeCulling;
+        bool mGpuCulling;
 
         QueuedSubMeshList mQueuedSubMeshes;
 
@@ -726,6 +778,36 @@ namespace Ogre {
         }
         /** Gets the size of a single batch of geometry. */
         virtual const Vector3& getRegionDimensions(void) const { return mRegionDimensions; }
+
+        /** Sets whether each batch keeps the bounds of the objects it was built from.
+        @remarks
+            Normally a whole batch is drawn whenever its region is visible.
+            With this enabled, the objects in a batch are also culled against
+            the camera, and only the index ranges of the visible ones are
+            drawn, in one multi-draw indirect call where the render system
+            supports it, or else as the single range spanning them. This costs
+            some CPU time per visible batch, so suits large regions with many
+            small objects. The default is false.
+        @note Must be called before 'build'.
+        */
+        virtual void setSubRangeCulling(bool enabled) { mSubRangeCulling = enabled; }
+        /** Gets whether each batch keeps the bounds of the objects it was built from. */
+        virtual bool getSubRangeCulling(void) const { return mSubRangeCulling; }
+
+        /** Sets whether the objects in each batch are culled on the GPU.
+        @remarks
+            Like setSubRangeCulling, but the bounds of the objects of a batch
+            are uploaded once, and every frame a compute pass culls them
+            against the camera and the occlusion culler of the scene manager,
+            writing the draw arguments the batch is then drawn from. This takes
+            no CPU time per object. Batches fall back to sub-range culling on
+            the CPU where the render system can't create a GpuDrawCuller.
+            The default is false.
+        @note Must be called before 'build'.
+        */
+        virtual void setGpuCulling(bool enabled) { mGpuCulling = enabled; }
+        /** Gets whether the objects in each batch are culled on the GPU. */
+        virtual bool getGpuCulling(void) const { return mGpuCulling; }
         /** Sets the origin of the geometry.
         @remarks
             This method allows you to configure the world centre of the geometry,
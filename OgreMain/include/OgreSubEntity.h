@@ -125,6 +125,14 @@ namespace Ogre {
         mutable Real mCachedCameraDist;
         /// The camera for which the cached distance is valid
         mutable const Camera *mCachedCamera;
+        /// The index ranges of the clusters left by _cullClusters, merged where contiguous
+        vector<IndirectDrawCommand>::type mClusterDraws;
+        /// Whether mClusterDraws replaces the index range of the submesh
+        bool mClusterDrawsUsed;
+        /// Whether mClusterDraws is drawn indirect, rather than as the range spanning it
+        bool mClusterDrawIndirect;
+        /// The index range spanning mClusterDraws, if not drawn indirect
+        IndexData* mClusterSpanIndexData;
 
         /** Internal method for preparing this Entity for use in animation. */
         void prepareTempBlendBuffers(void);
@@ -134,6 +142,24 @@ namespace Ogre {
         */
         const String& getMaterialName() const;
 
+        /** Culls the triangle clusters of the submesh for a camera, see SubMesh::clusters.
+        @remarks
+            Called by Entity::_updateRenderQueue. The clusters outside the camera
+            frustum, hidden by the occluders of the SceneManager or facing away
+            are dropped, and the rest is drawn with a multi-draw indirect call
+            if the render system can, or as one draw spanning them otherwise.
+            Clusters are only culled at full detail.
+        @param cam The camera the entity is rendered for
+        @param cullBackFacing Whether clusters facing away from the camera can be dropped
+        @return false if no cluster is left, so nothing needs to be drawn
+        */
+        bool _cullClusters(const Camera* cam, bool cullBackFacing);
+        /** Stops drawing only the clusters left by the last _cullClusters. */
+        void _resetClusters(void) { mClusterDrawsUsed = false; }
+        /** Gets the number of index ranges the clusters left by the last culling
+            are drawn as, 0 if the whole submesh is drawn. */
+        size_t getNumClusterDraws(void) const { return mClusterDrawsUsed ? mClusterDraws.size() : 0; }
+
         /** Sets the name of the Material to be used.
             @remarks
                 By default a SubEntity uses the default Material that the SubMesh
@@ -132,6 +132,35 @@ namespace Ogre {
          */
         vector<Vector3>::type extremityPoints;
 
+        /// A run of triangles of the index data, culled as a whole
+        struct TriangleCluster
+        {
+            /// First index of the cluster, relative to indexData->indexStart
+            uint32 indexStart;
+            /// Number of indices of the cluster
+            uint32 indexCount;
+            /// Bounding sphere of the triangles, in the space of the mesh
+            Vector3 centre;
+            Real radius;
+            /// Axis of the cone holding the normals of the triangles
+            Vector3 coneAxis;
+            /** Cosine and sine of the half angle of the cone. The cosine is 0 or
+                less if the normals spread too far for the cluster to ever face
+                away as a whole. */
+            Real coneCos;
+            Real coneSin;
+        };
+        typedef vector<TriangleCluster>::type TriangleClusterList;
+        /** Clusters of the full detail triangle list (optional).
+            @remarks
+                Entities cull the clusters of their submeshes against the camera
+                frustum, the occlusion culler and the direction they face, and
+                draw only the ones left, see Entity::setClusterCulling. They can
+                be stored in the .mesh file, or generated at runtime (see
+                buildClusters()).
+        */
+        TriangleClusterList clusters;
+
         /// Reference to parent Mesh (not a smart pointer so child does not keep parent alive).
         Mesh* parent;
 
@@ -248,6 +277,35 @@ namespace Ogre {
         */
         void generateExtremes(size_t count);
 
+        /** Splits the full detail triangle list into clusters (@see clusters).
+        @remarks
+            Consecutive triangles of the index data are grouped, so clusters are
+            only compact if the triangle order is, as it is after
+            Mesh::optimiseIndexOrder. Reads the vertex and index buffers, see
+            Mesh::buildClusters. Submeshes other than triangle lists get no
+            clusters.
+        @param maxTriangles
+            Most triangles in a cluster.
+        */
+        void buildClusters(size_t maxTriangles = 128);
+
+        /** Tells whether all the triangles of a cluster face away from a position,
+            in the space of the mesh. */
+        static bool isClusterBackFacing(const TriangleCluster& cluster, const Vector3& position)
+        {
+            if (cluster.coneCos <= 0)
+                return false;
+            // the triangles face away if the direction from the position is
+            // within 90 degrees of all the normals, for all points of the sphere
+            Vector3 dir = cluster.centre - position;
+            Real dist = dir.length();
+            if (dist <= cluster.radius)
+                return false;
+            Real cosDir = cluster.coneAxis.dotProduct(dir) / dist;
+            Real sinDir = Math::Sqrt(std::max(Real(0), 1 - cosDir * cosDir));
+            return cosDir * cluster.coneCos - sinDir * cluster.coneSin >= cluster.radius / dist;
+        }
+
         /** Returns true(by default) if the submesh should be included in the mesh EdgeList, otherwise returns false.
         */      
         bool isBuildEdgesEnabled(void) const { return mBuildEdgesEnabled; }
@@ -135,6 +135,22 @@ namespace Ogre {
         */
         virtual void setNumMipmaps(uint32 num) {mNumRequestedMipmaps = mNumMipmaps = num;}
 
+        /** Sets how many of the top mip levels are left out when loading.
+        @remarks
+            Only applies to images carrying their own mipmaps, such as DDS files;
+            the texture is created at the size of the first level loaded and the
+            smallest level is always kept. Defaults to
+            TextureManager::getDefaultMipSkip.
+            @see TextureManager::requestMipSkip
+            @note
+                Must be set before calling any 'load' method.
+        */
+        virtual void setMipSkip(uint32 levels) { mMipSkip = levels; }
+
+        /** Gets how many of the top mip levels are left out when loading.
+        */
+        virtual uint32 getMipSkip(void) const { return mMipSkip; }
+
         /** Are mipmaps hardware generated?
         @remarks
             Will only be accurate after texture load, or createInternalResources
@@ -300,6 +316,23 @@ namespace Ogre {
         */
         virtual void _loadImages( const ConstImagePtrList& images );
 
+        /** Internal method to tell whether the texture was loaded from the
+            single file _readSourceImage decodes, rather than being manual or
+            a cube map made of six images.
+        */
+        virtual bool _hasSingleSourceImage(void) const;
+
+        /** Internal method to decode the single source file of this texture.
+        @note Safe to call from a background thread.
+        */
+        virtual void _readSourceImage(Image& dest) const;
+
+        /** Internal method to replace the levels of a loaded texture with
+            those of an image, leaving out the given number of top mip levels.
+        @note Main thread only. @see TextureManager::requestMipSkip
+        */
+        virtual void _applyMipSkip(const Image& img, uint32 mipSkip);
+
         /** Returns the pixel format for the texture surface. */
         virtual PixelFormat getFormat() const
         {
@@ -413,6 +446,7 @@ namespace Ogre {
 
         uint32 mNumRequestedMipmaps;
         uint32 mNumMipmaps;
+        uint32 mMipSkip;
         bool mMipmapsHardwareGenerated;
         float mGamma;
         bool mHwGamma;
@@ -435,6 +469,8 @@ namespace Ogre {
 
         /// @copydoc Resource::calculateSize
         size_t calculateSize(void) const;
+        /// @copydoc Resource::calculateGpuSize
+        size_t calculateGpuSize(void) const;
         
 
         /** Implementation of creating internal texture resources 
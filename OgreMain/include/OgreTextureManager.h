@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "OgreResourceManager.h"
 #include "OgreTexture.h"
 #include "OgreSingleton.h"
+#include "OgreWorkQueue.h"
 
 
 namespace Ogre {
@@ -57,7 +58,8 @@ namespace Ogre {
             created at least one window - this may be done at the
             same time as part a if you allow Ogre to autocreate one.
      */
-    class _OgreExport TextureManager : public ResourceManager, public Singleton<TextureManager>
+    class _OgreExport TextureManager : public ResourceManager, public Singleton<TextureManager>,
+        public WorkQueue::RequestHandler, public WorkQueue::ResponseHandler
     {
     public:
 
@@ -480,6 +482,111 @@ namespace Ogre {
             return mDefaultNumMipmaps;
         }
 
+        /** Sets whether textures are compressed on the CPU as they are loaded.
+        @remarks
+            When enabled, textures loaded from 8 bit RGB(A) or luminance images are
+            encoded with ImageCompressor to a format the render system supports:
+            PF_DXT1 or PF_DXT5 where available, otherwise PF_ETC2_RGB8, PF_ETC2_RGBA8
+            or, for opaque images, PF_ETC1_RGB8. This saves video memory and
+            bandwidth at the cost of some quality and load time.
+        @par
+            Textures with a desired format, gamma adjustment, luminance as alpha or
+            render target usage are left alone, as are images whose width or height
+            is not a multiple of 4. Mipmaps are generated on the CPU, since the
+            hardware cannot generate them for compressed textures.
+        @note
+            The default is false.
+        @see setCompressionCacheDirectory
+        */
+        virtual void setCompressOnLoad(bool compress);
+
+        /** Gets whether textures are compressed on the CPU as they are loaded.
+        */
+        virtual bool getCompressOnLoad(void) const
+        {
+            return mCompressOnLoad;
+        }
+
+        /** Sets a directory to keep textures compressed on load in.
+        @remarks
+            Each compressed image is written to a file named after a hash of the
+            source pixels and the compression settings, and is read back instead of
+            being compressed again the next time the same image is loaded. The
+            directory is created when needed. An empty path disables the cache.
+        @note
+            The default is an empty path.
+        */
+        virtual void setCompressionCacheDirectory(const String& path);
+
+        /** Gets the directory textures compressed on load are kept in.
+        */
+        virtual const String& getCompressionCacheDirectory(void) const
+        {
+            return mCompressionCacheDirectory;
+        }
+
+        /** Compresses an image which is about to be loaded into a texture.
+        @note
+            Internal method called by Texture::_loadImages when compression on load
+            is enabled.
+        @param src The image to compress
+        @param ttype The type of the texture being loaded
+        @param usage The usage of the texture being loaded
+        @param numMipmaps The number of mipmaps to generate if src has none
+        @param dest Receives the compressed image, with mipmaps
+        @return true if src was compressed, false if it should be loaded as is
+        */
+        virtual bool _compressImage(const Image& src, TextureType ttype, int usage,
+            uint32 numMipmaps, Image& dest);
+
+        /** Sets how many top mip levels textures leave out when first loaded.
+        @remarks
+            Textures whose images carry their own mipmaps, such as DDS files, are
+            then usable as soon as their low resolution mip tail is uploaded.
+            Higher levels are streamed in later with requestMipSkip.
+        @note
+            The default is 0. Only affects textures created afterwards.
+            @see Texture::setMipSkip
+        */
+        virtual void setDefaultMipSkip(uint32 levels) { mDefaultMipSkip = levels; }
+
+        /** Gets how many top mip levels textures leave out when first loaded.
+        */
+        virtual uint32 getDefaultMipSkip(void) const { return mDefaultMipSkip; }
+
+        /** Queues a change of how many top mip levels a loaded texture leaves out.
+        @remarks
+            A lower count streams in higher resolution levels for textures close
+            to the camera, a higher one drops them for textures out of view. The
+            source file is decoded on the WorkQueue and the texture recreated on
+            the main thread when the response is processed; until then the current
+            levels stay in use. Requests are started highest priority first, a
+            few at a time, and a new request for a texture replaces any of its
+            requests not yet started.
+        @param tex The texture, which must be loaded from a single file. Manual
+            textures and cube maps made of six images are rejected with an
+            ERR_INVALIDPARAMS exception.
+        @param mipSkip The number of top mip levels to leave out
+        @param priority Higher priorities are streamed first, for example the
+            screen space size of the largest object using the texture
+        */
+        virtual void requestMipSkip(const TexturePtr& tex, uint32 mipSkip, Real priority = 0);
+
+        /** Sets how many mip streaming requests can be in the WorkQueue at once.
+        @note
+            The default is 2.
+        */
+        virtual void setMaxMipStreamRequests(size_t count) { mMaxMipStreamRequests = count; }
+
+        /** Gets how many mip streaming requests can be in the WorkQueue at once.
+        */
+        virtual size_t getMaxMipStreamRequests(void) const { return mMaxMipStreamRequests; }
+
+        /// @copydoc WorkQueue::RequestHandler::handleRequest
+        WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
+        /// @copydoc WorkQueue::ResponseHandler::handleResponse
+        void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ);
+
         /** Override standard Singleton retrieval.
         @remarks
         Why do we do this? Well, it's because the Singleton
@@ -518,6 +625,37 @@ namespace Ogre {
         ushort mPreferredIntegerBitDepth;
         ushort mPreferredFloatBitDepth;
         size_t mDefaultNumMipmaps;
+        bool mCompressOnLoad;
+        String mCompressionCacheDirectory;
+
+        /// A change of the mip levels of a texture, waiting or being decoded
+        struct MipStreamRequest
+        {
+            TexturePtr texture;
+            uint32 mipSkip;
+            Real priority;
+            /// The decoded source, filled in by the WorkQueue
+            SharedPtr<Image> image;
+
+            _OgreExport friend std::ostream& operator<<(std::ostream& o, const MipStreamRequest& r)
+            { (void)r; return o; }
+        };
+        typedef vector<MipStreamRequest>::type MipStreamRequestList;
+        /// Requests not yet added to the WorkQueue
+        MipStreamRequestList mPendingMipStreams;
+        uint32 mDefaultMipSkip;
+        size_t mMaxMipStreamRequests;
+        size_t mMipStreamRequestsInFlight;
+        uint16 mMipStreamChannel;
+        bool mMipStreamHandlersAdded;
+
+        /// Adds the highest priority pending requests to the WorkQueue
+        void startMipStreamRequests();
+
+        /// Picks the compressed format to load an image of the given format as
+        PixelFormat getCompressedFormat(TextureType ttype, PixelFormat srcFormat, int usage);
+        /// Gets the path of the cache file for compressing an image
+        String getCompressionCachePath(const Image& src, PixelFormat format, uint32 numMipmaps) const;
     };
     /** @} */
     /** @} */
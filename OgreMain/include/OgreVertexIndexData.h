@@ -88,6 +88,8 @@ namespace Ogre {
         size_t vertexStart;
         /// The number of vertices used in this operation
         size_t vertexCount;
+        /// Whether the buffers are shared, see HardwareBufferManagerBase::subAllocateVertexData
+        bool subAllocated;
 
 
         /// Struct used to hold hardware morph / pose vertex data information
@@ -101,6 +103,11 @@ namespace Ogre {
         HardwareAnimationDataList hwAnimationDataList;
         /// Number of hardware animation data items used
         size_t hwAnimDataItemsUsed;
+        /// Whether hardware pose animation samples the poses from a pose texture, see Mesh::setUsePoseTexture
+        bool hwPoseTexture;
+        /// Pose texture offset & influence of each pose applied this frame, when using a pose texture
+        typedef vector<std::pair<Real, Real> >::type HardwarePoseWeightList;
+        HardwarePoseWeightList hwPoseWeights;
         
         /** Clones this vertex data, potentially including replicating any vertex buffers.
         @param copyData Whether to create new vertex buffers too or just reference the existing ones
@@ -130,6 +137,14 @@ namespace Ogre {
         */
         void prepareForShadowVolume(void);
 
+        /** Gives sub-allocated vertex data buffers of its own again.
+        @remarks
+            The vertices are copied out of the buffers shared with other vertex
+            data, see HardwareBufferManagerBase::subAllocateVertexData, and
+            vertexStart is reset to 0. Does nothing if the data isn't sub-allocated.
+        */
+        void releaseSubAllocation(void);
+
         /** Additional shadow volume vertex buffer storage. 
         @remarks
             This additional buffer is only used where we have prepared this VertexData for
@@ -216,6 +231,36 @@ namespace Ogre {
         */
         void convertPackedColour(VertexElementType srcType, VertexElementType destType);
 
+        /** Convert float vertex elements to more compact quantised types.
+        @remarks
+            Normals, tangents and binormals become VET_SHORT4_NORM, and 2D / 4D
+            texture coordinates become VET_HALF2 / VET_HALF4. The GPU expands both
+            back to floats when fetching the vertex, so shaders and the fixed
+            function pipeline need no changes. Positions and every other element
+            are left alone. Buffers holding converted elements are replaced with
+            new, smaller buffers of the same usage.
+        @par
+            CPU-side code which reads vertex data as floats (software skinning,
+            software morph and pose animation, TangentSpaceCalc, edge list
+            building from normals) cannot process the converted elements, so only
+            quantise normals of meshes which will be animated on the GPU, and do
+            it after building tangents. Half precision texture coordinates lose
+            accuracy beyond a range of about +/-2048.
+        @param normals Whether to convert normals, tangents and binormals
+        @param texCoords Whether to convert texture coordinates
+        */
+        void quantise(bool normals, bool texCoords);
+
+        /** Re-order the vertices held in every buffer bound to this vertex data.
+        @remarks
+            Only the vertexCount vertices starting at vertexStart are moved. Index
+            data, bone assignments and anything else which refers to vertices by
+            index must be remapped by the caller.
+        @param vertexRemap For each vertex (relative to vertexStart), its new
+            position; must be a permutation of 0 to vertexCount - 1.
+        */
+        void reorderVertices(const vector<uint32>::type& vertexRemap);
+
 
         /** Allocate elements to serve a holder of morph / pose target data 
             for hardware morphing / pose blending.
@@ -258,6 +303,9 @@ namespace Ogre {
         /// The number of indexes to use from the buffer
         size_t indexCount;
 
+        /// Whether the buffer is shared, see HardwareBufferManagerBase::subAllocateIndexData
+        bool subAllocated;
+
         /** Clones this index data, potentially including replicating the index buffer.
         @param copyData Whether to create new buffers too or just reference the existing ones
         @param mgr If supplied, the buffer manager through which copies should be made
@@ -274,6 +322,33 @@ namespace Ogre {
             in any case.
         */
         void optimiseVertexCacheTriList(void);
+
+        /** Re-order the triangles in this index data to make best use of the
+            post-transform vertex cache.
+        @remarks
+            Uses Tom Forsyth's linear-speed vertex cache optimisation, which scores
+            triangles by the position of their vertices in a simulated LRU cache and
+            by how many triangles still use each vertex. Unlike
+            optimiseVertexCacheTriList it performs well across the cache sizes of
+            different GPUs. Can only be used for index data which consists of
+            triangle lists.
+        @param cacheSize The size of the simulated cache
+        */
+        void optimiseVertexCache(unsigned int cacheSize = 32);
+
+        /** Re-order clusters of triangles so that those facing away from the
+            centre of the mesh are drawn first, which reduces overdraw.
+        @remarks
+            Should be called after optimiseVertexCache. The triangles are split
+            into clusters wherever a triangle misses the cache with all of its
+            vertices, so moving whole clusters keeps the vertex cache efficiency
+            almost unchanged. Can only be used for index data which consists of
+            triangle lists.
+        @param vertexData The vertex data the indexes refer to, which must hold
+            VET_FLOAT3 positions
+        @param cacheSize The size of the simulated FIFO cache used to find clusters
+        */
+        void optimiseOverdraw(const VertexData* vertexData, unsigned int cacheSize = 16);
     
     };
 
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreAny.h"
 #include "OgreSharedPtr.h"
 #include "OgreCommon.h"
+#include "OgreAtomicScalar.h"
 #include "Threading/OgreThreadHeaders.h"
 #include "OgreHeaderPrefix.h"
 
@@ -81,7 +82,7 @@ namespace Ogre
 
         /** General purpose request structure. 
         */
-        class _OgreExport Request : public UtilityAlloc
+        class _OgreExport Request : public WorkQueueMessageAlloc
         {
             friend class WorkQueue;
         protected:
@@ -97,6 +98,8 @@ namespace Ogre
             RequestID mID;
             /// Abort Flag
             mutable bool mAborted;
+            /// Time the request was queued at, or 0 if not measured (see DefaultWorkQueueBase::getStatistics)
+            unsigned long mQueueTime;
 
         public:
             /// Constructor 
@@ -116,11 +119,15 @@ namespace Ogre
             RequestID getID() const { return mID; }
             /// Get the abort flag
             bool getAborted() const { return mAborted; }
+            /// Get the time the request was queued at, in microseconds, or 0 if not measured
+            unsigned long getQueueTime() const { return mQueueTime; }
+            /// Set the time the request was queued at, internal use only
+            void _setQueueTime(unsigned long us) { mQueueTime = us; }
         };
 
         /** General purpose response structure. 
         */
-        struct _OgreExport Response : public UtilityAlloc
+        struct _OgreExport Response : public WorkQueueMessageAlloc
         {
             /// Pointer to the request that this response is in relation to
             const Request* mRequest;
@@ -130,6 +137,8 @@ namespace Ogre
             String mMessages;
             /// Data associated with the result of the process
             Any mData;
+            /// Next response in the list of finished responses of a DefaultWorkQueueBase
+            Response* mNext;
 
         public:
             Response(const Request* rq, bool success, const Any& data, const String& msg = BLANKSTRING);
@@ -219,6 +228,90 @@ namespace Ogre
             virtual void handleResponse(const Response* res, const WorkQueue* srcQ) = 0;
         };
 
+        /** Interface to a data-parallel piece of work which can be split across threads.
+        @remarks
+            Used with parallelFor. execute() is called with disjoint ranges, possibly
+            from several threads at the same time, so implementations must not modify
+            state shared between ranges without synchronising it themselves.
+        */
+        class _OgreExport ParallelTask
+        {
+        public:
+            virtual ~ParallelTask() {}
+            /// Process the items in the half-open range [begin, end)
+            virtual void execute(size_t begin, size_t end) = 0;
+        };
+
+        /** Interface to a single piece of work, run with addTask or as part of a
+            TaskGroup.
+        */
+        class _OgreExport Task
+        {
+        public:
+            virtual ~Task() {}
+            /// Do the work; may be called from any thread
+            virtual void execute() = 0;
+        };
+        typedef SharedPtr<Task> TaskPtr;
+
+        /** A set of tasks with dependencies between them, run on the threads of
+            a WorkQueue.
+        @remarks
+            Tasks are added with add(), and addDependency() makes a task wait until
+            another has finished. run() starts every task which waits for nothing,
+            and each finished task starts the tasks waiting only for it, so
+            independent branches of the graph run in parallel on the workers. wait()
+            makes the calling thread take part as well, until every task has run.
+        @par
+            The tasks are not owned by the group and must stay valid until wait()
+            returns. Once it has, the group can be run again, or cleared and
+            filled with other tasks. Like parallelFor, the tasks only go through
+            the request queue to wake the workers, no response is queued for
+            processResponses.
+        */
+        class _OgreExport TaskGroup : public UtilityAlloc
+        {
+        public:
+            /// Index of a task in the group
+            typedef size_t TaskID;
+
+            /** Constructor.
+            @param queue The queue whose threads run the tasks
+            */
+            TaskGroup(WorkQueue* queue);
+            /// Waits for the tasks still running
+            ~TaskGroup();
+
+            /// Add a task to the group, which must not be running
+            TaskID add(Task* task);
+            /// Make a task wait until another one has finished
+            void addDependency(TaskID task, TaskID prerequisite);
+            /// Remove all the tasks, which must not be running
+            void clear();
+            /// Get the number of tasks in the group
+            size_t getNumTasks() const;
+
+            /** Start the tasks which do not wait for any other.
+            @remarks
+                Throws if the dependencies form a cycle.
+            */
+            void run();
+            /** Run tasks on the calling thread until all of them have finished.
+            @remarks
+                Calls run() first if it was not called. If a task threw an
+                exception, the others still run, and an exception with its
+                description is thrown once all of them have finished.
+            */
+            void wait();
+
+            /// Internal state, shared with the helpers running on the workers
+            struct State;
+        private:
+            WorkQueue* mQueue;
+            SharedPtr<State> mState;
+            bool mRunning;
+        };
+
         WorkQueue() : mNextChannel(0) {}
         virtual ~WorkQueue() {}
 
@@ -354,6 +447,31 @@ namespace Ogre
         */
         virtual uint16 getChannel(const String& channelName);
 
+        /** Process a range of items with a ParallelTask, spreading the work over
+            the worker threads where possible.
+        @remarks
+            The range [0, count) is split into chunks of grainSize items, which are
+            picked up by the calling thread and by any idle workers. The calling
+            thread always takes part, and the call only returns once every item
+            has been processed, so this can be used to fork and join work in the
+            middle of a frame. The default implementation runs the whole range on
+            the calling thread.
+        @param count The number of items to process
+        @param grainSize The number of items to hand out at once; at least 1
+        @param task The task to execute for each chunk
+        */
+        virtual void parallelFor(size_t count, size_t grainSize, ParallelTask* task);
+
+        /** Run a task on a worker thread, without a response.
+        @remarks
+            This is a lightweight alternative to addRequest for engine internals,
+            such as the helpers of TaskGroup: nothing is queued for
+            processResponses and the task cannot be aborted. The queue keeps a
+            reference to the task until it has run. The default implementation
+            runs the task immediately on the calling thread.
+        */
+        virtual void addTask(const TaskPtr& task);
+
     };
 
     /** Base for a general purpose request / response style background work queue.
@@ -361,6 +479,14 @@ namespace Ogre
     class _OgreExport DefaultWorkQueueBase : public WorkQueue
     {
     public:
+        /// Priority of the requests of a channel, see setChannelPriority
+        enum RequestPriority
+        {
+            RP_LOW,
+            RP_NORMAL,
+            RP_HIGH,
+            RP_COUNT
+        };
 
         /** Constructor.
             Call startup() to initialise.
@@ -407,6 +533,43 @@ namespace Ogre
         */
         virtual void setWorkersCanAccessRenderSystem(bool access);
 
+        /** Set whether each worker thread gets a request queue of its own (default false).
+        @remarks
+            By default all workers take requests from one shared queue. With work
+            stealing, requests are spread over a queue per worker, each with its own
+            lock, and a worker whose queue is empty takes the oldest requests of
+            the others, so many short requests contend much less. Request IDs are
+            handed out without a lock either way. Requests are then processed in
+            order only within each queue.
+            Calling this will have no effect unless the queue is shut down and
+            restarted.
+        */
+        virtual void setWorkStealingEnabled(bool enabled) { mWorkStealing = enabled; }
+        /// Get whether each worker thread gets a request queue of its own
+        virtual bool getWorkStealingEnabled() const { return mWorkStealing; }
+
+        /** Set the priority of the requests of a channel (default RP_NORMAL).
+        @remarks
+            Workers take the queued requests of higher priority first, whichever
+            queue they are in.
+        */
+        virtual void setChannelPriority(uint16 channel, RequestPriority priority);
+        /// Get the priority of the requests of a channel
+        virtual RequestPriority getChannelPriority(uint16 channel) const;
+
+        /** Set the worker whose queue the requests of a channel go to, with work
+            stealing enabled.
+        @remarks
+            Requests are otherwise spread over the queues in turn. Keeping a
+            channel on one worker keeps its data in that worker's caches; other
+            workers still take its requests when they run out of their own.
+        @param channel The channel
+        @param worker The index of the worker, or -1 for none (the default)
+        */
+        virtual void setChannelAffinity(uint16 channel, size_t worker);
+        /// Get the worker whose queue the requests of a channel go to, or -1 for none
+        virtual size_t getChannelAffinity(uint16 channel) const;
+
         /** Process the next request on the queue. 
         @remarks
             This method is public, but only intended for advanced users to call. 
@@ -416,6 +579,11 @@ namespace Ogre
         */
         virtual void _processNextRequest();
 
+        /** Process the next request, looking in the queue of the given worker first.
+        @see setWorkStealingEnabled
+        */
+        virtual void _processNextRequest(size_t worker);
+
         /// Main function for each thread spawned.
         virtual void _threadMain() = 0;
 
@@ -456,6 +624,95 @@ namespace Ogre
         virtual unsigned long getResponseProcessingTimeLimit() const { return mResposeTimeLimitMS; }
         /// @copydoc WorkQueue::setResponseProcessingTimeLimit
         virtual void setResponseProcessingTimeLimit(unsigned long ms) { mResposeTimeLimitMS = ms; }
+        /// @copydoc WorkQueue::parallelFor
+        virtual void parallelFor(size_t count, size_t grainSize, ParallelTask* task);
+        /// @copydoc WorkQueue::addTask
+        virtual void addTask(const TaskPtr& task);
+
+        /** Histogram of durations, see getStatistics.
+        @remarks
+            Bucket 0 counts durations below 2 microseconds, bucket i those from
+            2^i to 2^(i+1) microseconds, and the last bucket everything longer.
+        */
+        struct _OgreExport TimeHistogram
+        {
+            static const size_t NUM_BUCKETS = 20;
+            size_t buckets[NUM_BUCKETS];
+            /// Number of durations added
+            size_t count;
+            /// Sum of the durations, in microseconds
+            uint64 total;
+            /// Longest duration, in microseconds
+            unsigned long max;
+
+            TimeHistogram();
+            void add(unsigned long us);
+            /// Get the mean duration, in microseconds
+            unsigned long getMean() const { return count ? (unsigned long)(total / count) : 0; }
+        };
+
+        /// Statistics of the requests of one channel
+        struct _OgreExport ChannelStatistics
+        {
+            /// Number of requests currently waiting to be processed
+            size_t queued;
+            /// Number of requests currently being processed
+            size_t inFlight;
+            /// Number of requests processed
+            size_t processed;
+            /// Number of requests which were aborted
+            size_t aborted;
+            /// Time from queuing a request to starting to process it
+            TimeHistogram waitTime;
+            /// Time spent processing a request in its RequestHandler
+            TimeHistogram processTime;
+
+            ChannelStatistics();
+        };
+        typedef map<uint16, ChannelStatistics>::type ChannelStatisticsMap;
+
+        /// Snapshot of the statistics of the queue, see getStatistics
+        struct _OgreExport Statistics
+        {
+            /// Statistics by channel
+            ChannelStatisticsMap channels;
+            /// Fraction of the time each worker spent processing requests
+            vector<Real>::type workerUtilisation;
+            /// Number of responses currently waiting for processResponses
+            size_t responseBacklog;
+            /// Number of responses waiting when processResponses was last called
+            size_t lastResponseBacklog;
+            /// Number of calls to processResponses
+            size_t processResponsesCalls;
+            /// Time spent in the last and longest call to processResponses, in microseconds
+            unsigned long lastProcessResponsesTime, maxProcessResponsesTime;
+            /// Time spent in all calls to processResponses, in microseconds
+            uint64 totalProcessResponsesTime;
+
+            Statistics();
+        };
+
+        /** Set whether statistics about the requests and responses are gathered
+            (default false).
+        @remarks
+            Statistics cost a few timer reads and a lock per request, which is
+            why they are off by default. Only requests queued while they are
+            enabled are measured. processResponses shows up in the Profiler
+            whether or not statistics are enabled.
+        @see getStatistics
+        */
+        void setStatisticsEnabled(bool enabled);
+        /// Get whether statistics about the requests and responses are gathered
+        bool getStatisticsEnabled() const { return mStatisticsEnabled; }
+        /** Get a snapshot of the statistics gathered since they were enabled or
+            last reset.
+        @remarks
+            The queued and in flight counts and the response backlog are the
+            current values, everything else accumulates until resetStatistics.
+        */
+        Statistics getStatistics() const;
+        /// Reset the accumulated statistics
+        void resetStatistics();
     protected:
         String mName;
         size_t mWorkerThreadCount;
@@ -465,9 +722,56 @@ namespace Ogre
 
         typedef deque<Request*>::type RequestQueue;
         typedef deque<Response*>::type ResponseQueue;
-        RequestQueue mRequestQueue; // Guarded by mRequestMutex
-        RequestQueue mProcessQueue; // Guarded by mProcessMutex
         ResponseQueue mResponseQueue; // Guarded by mResponseMutex
+        /** Responses finished by the workers, newest first, linked by Response::mNext.
+        @remarks
+            Workers push to this list without locking, and it is moved over to
+            mResponseQueue in one go by collectResponses. Holds a Response*.
+        */
+        AtomicScalar<size_t> mFinishedResponses;
+
+        /// The queued requests of one worker, or of all of them without work stealing
+        struct RequestShard : public UtilityAlloc
+        {
+            OGRE_MUTEX(mutex);
+            /// Requests waiting, by priority
+            RequestQueue requests[RP_COUNT];
+            /// Requests taken from this shard and being processed
+            RequestQueue processing;
+        };
+        typedef vector<RequestShard*>::type RequestShardList;
+        /// Only resized by startup, while no worker is running
+        RequestShardList mRequestShards;
+        /// Number of requests waiting in all shards, by priority
+        AtomicScalar<size_t> mQueuedRequests[RP_COUNT];
+        /// The shard the next request without affinity goes to
+        AtomicScalar<size_t> mNextShard;
+        /// The shard the next worker looks in first
+        AtomicScalar<size_t> mNextWorkerShard;
+        bool mWorkStealing;
+
+        struct ChannelSettings
+        {
+            RequestPriority priority;
+            size_t affinity;
+        };
+        typedef map<uint16, ChannelSettings>::type ChannelSettingsMap;
+        ChannelSettingsMap mChannelSettings; // Guarded by mChannelSettingsMutex
+        bool mHasChannelSettings;
+        OGRE_RW_MUTEX(mChannelSettingsMutex);
+
+        /** Create the request shards for the worker thread count, moving any
+            queued requests over. Called by startup. */
+        void setupRequestShards();
+        /// Queue a request in the shard of its channel
+        void pushRequest(Request* req);
+        /** Take the next request, of highest priority first, from the given shard
+            or else from the others.
+        @param shard Receives the shard the request was taken from
+        */
+        Request* popRequest(size_t home, RequestShard*& shard);
+        /// Whether any request is waiting in a shard
+        bool hasQueuedRequests() const;
 
         /// Thread function
         struct _OgreExport WorkerFunc OGRE_THREAD_WORKER_INHERIT
@@ -537,11 +841,12 @@ namespace Ogre
         typedef list<RequestHandlerHolderPtr>::type RequestHandlerList;
         typedef list<ResponseHandler*>::type ResponseHandlerList;
         typedef map<uint16, RequestHandlerList>::type RequestHandlerListByChannel;
-        typedef map<uint16, ResponseHandlerList>::type ResponseHandlerListByChannel;
+        /// Indexed by channel, as channels are allocated in sequence
+        typedef vector<ResponseHandlerList>::type ResponseHandlerListByChannel;
 
         RequestHandlerListByChannel mRequestHandlers;
         ResponseHandlerListByChannel mResponseHandlers;
-        RequestID mRequestCount; // Guarded by mRequestMutex
+        AtomicScalar<RequestID> mRequestCount;
         bool mPaused;
         bool mAcceptRequests;
         bool mShuttingDown;
@@ -557,9 +862,16 @@ namespace Ogre
         OGRE_RW_MUTEX(mRequestHandlerMutex);
 
 
-        void processRequestResponse(Request* r, bool synchronous);
+        /** Process a request and queue or handle its response.
+        @param shard The shard the request was taken from, if any
+        */
+        void processRequestResponse(Request* r, bool synchronous, RequestShard* shard = 0);
         Response* processRequest(Request* r);
         void processResponse(Response* r);
+        /// Add a response to the finished responses, from any thread without locking
+        void pushResponse(Response* r);
+        /// Move the finished responses to the end of mResponseQueue. Lock mResponseMutex first.
+        void collectResponses();
         /// Notify workers about a new request. 
         virtual void notifyWorkers() = 0;
         /// Put a Request on the queue with a specific RequestID.
@@ -571,6 +883,48 @@ namespace Ogre
         
 
         bool processIdleRequests();
+
+        /// Handler running the chunks of parallelFor calls on the worker threads
+        class _OgreExport ParallelForHandler : public RequestHandler
+        {
+        public:
+            Response* handleRequest(const Request* req, const WorkQueue* srcQ);
+        };
+        ParallelForHandler mParallelForHandler;
+        uint16 mParallelForChannel;
+
+        /// Handler running the tasks given to addTask
+        class _OgreExport TaskHandler : public RequestHandler
+        {
+        public:
+            Response* handleRequest(const Request* req, const WorkQueue* srcQ);
+        };
+        TaskHandler mTaskHandler;
+        uint16 mTaskChannel;
+
+        /// Whether the responses of a channel are only used internally and can be dropped
+        bool isInternalChannel(uint16 channel) const
+        { return channel == mParallelForChannel || channel == mTaskChannel; }
+
+        bool mStatisticsEnabled;
+        OGRE_MUTEX(mStatisticsMutex);
+        // All guarded by mStatisticsMutex, which is never held while locking another
+        Timer* mStatisticsTimer;
+        unsigned long mStatisticsStart;
+        ChannelStatisticsMap mChannelStatistics;
+        /// Time each worker spent processing requests, in microseconds
+        vector<uint64>::type mWorkerBusyTime;
+        /// Only the processResponses fields are used
+        Statistics mResponseStatistics;
+
+        /// Current statistics time in microseconds, never 0. Lock mStatisticsMutex first.
+        unsigned long getStatisticsTime() const;
+        /// Count a request as queued and remember when
+        void statisticsRequestQueued(Request* r);
+        /// Count a request as started, returning the time it started at or 0 if not measured
+        unsigned long statisticsRequestStarted(const Request* r);
+        void statisticsRequestProcessed(const Request* r, unsigned long start);
+        void statisticsRequestAborted(const Request* r);
     };
 
 
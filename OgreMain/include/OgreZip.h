@@ -66,10 +66,52 @@ namespace Ogre {
         /// A pointer to file io alternative implementation 
         zzip_plugin_io_handlers* mPluginIo;
 
+        /// Location of a file's data inside the mapped archive
+        struct MappedEntry
+        {
+            size_t offset;
+            size_t compressedSize;
+            size_t uncompressedSize;
+            bool deflated;
+        };
+        typedef map<String, MappedEntry>::type MappedEntryMap;
+        /// The whole archive mapped into memory, if memory mapping is used
+        MemoryDataStreamPtr mMapping;
+        /// Files readable straight from mMapping, keyed by lower case path
+        MappedEntryMap mMappedEntries;
+
+        /// Map the archive and index the files which can be read from the mapping
+        void indexMappedEntries();
+        /// Open a file from the mapping, returns null if it has to go through zziplib
+        DataStreamPtr openMapped(const String& filename);
+
+        static bool msUseMemoryMapping;
+
         OGRE_AUTO_MUTEX;
     public:
         ZipArchive(const String& name, const String& archType, zzip_plugin_io_handlers* pluginIo = NULL);
         ~ZipArchive();
+
+        /** Set whether zip files on disk are memory mapped when loaded.
+        @remarks
+            The central directory of a mapped archive is indexed once on load.
+            Stored files are then opened as streams over the mapping without any
+            copy, and deflated files are inflated straight from it, each open using
+            its own zlib state and without holding the archive lock. Encrypted or
+            zip64 entries, and embedded archives, still go through zziplib.
+            Only takes effect for archives loaded afterwards. Off by default,
+            @see FileSystemArchive::setUseMemoryMapping
+        */
+        static void setUseMemoryMapping(bool useMapping)
+        {
+            msUseMemoryMapping = useMapping;
+        }
+
+        /// Get whether zip files on disk are memory mapped when loaded.
+        static bool getUseMemoryMapping()
+        {
+            return msUseMemoryMapping;
+        }
         /// @copydoc Archive::isCaseSensitive
         bool isCaseSensitive(void) const { return false; }
 
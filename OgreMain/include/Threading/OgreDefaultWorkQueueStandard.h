@@ -70,6 +70,8 @@ namespace Ogre
         OGRE_THREAD_SYNCHRONISER(mInitSync);
 
         OGRE_THREAD_SYNCHRONISER(mRequestCondition);
+        /// Number of threads waiting on mRequestCondition
+        AtomicScalar<size_t> mSleepingWorkers;
 #if OGRE_THREAD_SUPPORT
         typedef vector<OGRE_THREAD_TYPE*>::type WorkerThreadList;
         WorkerThreadList mWorkers;
@@ -64,6 +64,12 @@ namespace Ogre
         virtual void notifyWorkers();
 
     private:
+        /// Hands the small object cache of a worker thread over when it leaves the scheduler
+        struct CacheReleaseObserver : public tbb::task_scheduler_observer
+        {
+            virtual void on_scheduler_exit(bool isWorker);
+        };
+
 #if OGRE_NO_TBB_SCHEDULER == 0
         tbb::task_scheduler_init mTaskScheduler;
 #endif
@@ -71,6 +77,7 @@ namespace Ogre
         /// Synchronise registering threads with the RenderSystem
         OGRE_MUTEX(mRegisterRSMutex);
         std::set<tbb::tbb_thread::id> mRegisteredThreads;
+        CacheReleaseObserver mCacheReleaseObserver;
     };
 
 
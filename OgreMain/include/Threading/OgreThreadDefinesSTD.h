@@ -109,10 +109,16 @@ namespace Ogre
 #define OGRE_THREAD_NOTIFY_ONE(sync) sync.notify_one()
 #define OGRE_THREAD_NOTIFY_ALL(sync) sync.notify_all()
 
-// Read-write mutex
+// Read-write mutex, shared if OGRE was configured with C++14 support, see OgreBuildSettings.h
+#if OGRE_USE_STD_SHARED_MUTEX
+#define OGRE_RW_MUTEX(name) mutable std::shared_timed_mutex name
+#define OGRE_LOCK_RW_MUTEX_READ(name) std::shared_lock<std::shared_timed_mutex> OGRE_TOKEN_PASTE_EXTRA(ogrenameLock, __LINE__) (name)
+#define OGRE_LOCK_RW_MUTEX_WRITE(name) std::unique_lock<std::shared_timed_mutex> OGRE_TOKEN_PASTE_EXTRA(ogrenameLock, __LINE__) (name)
+#else
 #define OGRE_RW_MUTEX(name) mutable std::recursive_mutex name
 #define OGRE_LOCK_RW_MUTEX_READ(name) std::unique_lock<std::recursive_mutex> OGRE_TOKEN_PASTE_EXTRA(ogrenameLock, __LINE__) (name)
 #define OGRE_LOCK_RW_MUTEX_WRITE(name) std::unique_lock<std::recursive_mutex> OGRE_TOKEN_PASTE_EXTRA(ogrenameLock, __LINE__) (name)
+#endif
 
 // Thread-local pointer
 #define OGRE_THREAD_POINTER(T, var) Ogre::ThreadLocalPtr<T> var
@@ -30,5 +30,8 @@ THE SOFTWARE
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#if OGRE_USE_STD_SHARED_MUTEX
+#include <shared_mutex>
+#endif
 
 #endif
@@ -29,6 +29,7 @@ THE SOFTWARE
 #include <tbb/recursive_mutex.h>
 #include <tbb/task_group.h>
 #include <tbb/task_scheduler_init.h>
+#include <tbb/task_scheduler_observer.h>
 #include <tbb/queuing_rw_mutex.h>
 #include <tbb/enumerable_thread_specific.h>
 #include <tbb/tbb_thread.h>
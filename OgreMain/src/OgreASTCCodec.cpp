@@ -0,0 +1,181 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreStableHeaders.h"
+
+#include "OgreASTCCodec.h"
+#include "OgreImage.h"
+#include "OgreException.h"
+#include "OgreLogManager.h"
+
+namespace Ogre {
+
+    const uint32 ASTC_MAGIC = 0x5CA1AB13;
+
+    // Sizes are 24 bit little endian values, whatever the platform
+    typedef struct
+    {
+        uint8 magic[4];
+        uint8 blockdim_x;
+        uint8 blockdim_y;
+        uint8 blockdim_z;
+        uint8 xsize[3];
+        uint8 ysize[3];
+        uint8 zsize[3];
+    } ASTCHeader;
+
+    static inline uint32 readSize(const uint8* size)
+    {
+        return size[0] | (size[1] << 8) | (size[2] << 16);
+    }
+
+    static inline uint32 readMagic(const uint8* magic)
+    {
+        return readSize(magic) | (static_cast<uint32>(magic[3]) << 24);
+    }
+
+    //---------------------------------------------------------------------
+    ASTCCodec* ASTCCodec::msInstance = 0;
+    //---------------------------------------------------------------------
+    void ASTCCodec::startup(void)
+    {
+        if (!msInstance)
+        {
+            LogManager::getSingleton().logMessage(
+                LML_NORMAL,
+                "ASTC codec registering");
+
+            msInstance = OGRE_NEW ASTCCodec();
+            Codec::registerCodec(msInstance);
+        }
+    }
+    //---------------------------------------------------------------------
+    void ASTCCodec::shutdown(void)
+    {
+        if(msInstance)
+        {
+            Codec::unregisterCodec(msInstance);
+            OGRE_DELETE msInstance;
+            msInstance = 0;
+        }
+    }
+    //---------------------------------------------------------------------
+    ASTCCodec::ASTCCodec():
+        mType("astc")
+    {
+    }
+    //---------------------------------------------------------------------
+    DataStreamPtr ASTCCodec::encode(MemoryDataStreamPtr& input, Codec::CodecDataPtr& pData) const
+    {
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+                    "ASTC encoding not supported",
+                    "ASTCCodec::encode" ) ;
+    }
+    //---------------------------------------------------------------------
+    void ASTCCodec::encodeToFile(MemoryDataStreamPtr& input,
+        const String& outFileName, Codec::CodecDataPtr& pData) const
+    {
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+                    "ASTC encoding not supported",
+                    "ASTCCodec::encodeToFile" ) ;
+    }
+    //---------------------------------------------------------------------
+    PixelFormat ASTCCodec::getPixelFormat(uint32 blockWidth, uint32 blockHeight)
+    {
+        // In the order of the pixel formats
+        static const uint32 blockSizes[][2] = {
+            {4, 4}, {5, 4}, {5, 5}, {6, 5}, {6, 6}, {8, 5}, {8, 6},
+            {8, 8}, {10, 5}, {10, 6}, {10, 8}, {10, 10}, {12, 10}, {12, 12}
+        };
+
+        for (size_t i = 0; i < sizeof(blockSizes) / sizeof(blockSizes[0]); ++i)
+        {
+            if (blockSizes[i][0] == blockWidth && blockSizes[i][1] == blockHeight)
+                return static_cast<PixelFormat>(PF_ASTC_RGBA_4X4_LDR + i);
+        }
+        return PF_UNKNOWN;
+    }
+    //---------------------------------------------------------------------
+    Codec::DecodeResult ASTCCodec::decode(DataStreamPtr& stream) const
+    {
+        ASTCHeader header;
+        if (stream->read(&header, sizeof(ASTCHeader)) != sizeof(ASTCHeader) ||
+            readMagic(header.magic) != ASTC_MAGIC)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "This is not an ASTC file!", "ASTCCodec::decode");
+        }
+
+        PixelFormat format = getPixelFormat(header.blockdim_x, header.blockdim_y);
+        if (format == PF_UNKNOWN || header.blockdim_z != 1)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Unsupported ASTC block size " +
+                StringConverter::toString(header.blockdim_x) + "x" +
+                StringConverter::toString(header.blockdim_y) + "x" +
+                StringConverter::toString(header.blockdim_z) + " in " + stream->getName(),
+                "ASTCCodec::decode");
+        }
+
+        ImageData* imgData = OGRE_NEW ImageData();
+        imgData->format = format;
+        imgData->width = readSize(header.xsize);
+        imgData->height = readSize(header.ysize);
+        imgData->depth = std::max<uint32>(readSize(header.zsize), 1);
+        // The file holds a single level
+        imgData->num_mipmaps = 0;
+        // Kept compressed, there is no software decoder
+        imgData->flags |= IF_COMPRESSED;
+        imgData->size = PixelUtil::getMemorySize(imgData->width, imgData->height,
+            imgData->depth, imgData->format);
+
+        DecodeResult ret;
+        ret.first = readPixelData(stream, imgData->size, imgData);
+        ret.second = CodecDataPtr(imgData);
+        return ret;
+    }
+    //---------------------------------------------------------------------
+    String ASTCCodec::getType() const
+    {
+        return mType;
+    }
+    //---------------------------------------------------------------------
+    String ASTCCodec::magicNumberToFileExt(const char *magicNumberPtr, size_t maxbytes) const
+    {
+        if (maxbytes >= sizeof(uint32))
+        {
+            const uint8* magic = reinterpret_cast<const uint8*>(magicNumberPtr);
+            if (readMagic(magic) == ASTC_MAGIC)
+            {
+                return String("astc");
+            }
+        }
+
+        return BLANKSTRING;
+    }
+}
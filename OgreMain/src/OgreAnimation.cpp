@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgreSkeleton.h"
 #include "OgreBone.h"
 #include "OgreMesh.h"
+#include "OgreOptimisedUtil.h"
 
 #include "OgreSubEntity.h"
 
@@ -355,32 +356,198 @@ namespace Ogre {
         // Calculate time index for fast keyframe search
         TimeIndex timeIndex = _getTimeIndex(timePos);
 
-        NodeTrackList::iterator i;
-        for (i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+        applyToSkeleton(skel, timeIndex, weight, 0, scale);
+    }
+    //---------------------------------------------------------------------
+    void Animation::apply(Skeleton* skel, Real timePos, float weight,
+      const AnimationState::BoneBlendMask* blendMask, Real scale)
+    {
+        _applyBaseKeyFrame();
+
+        // Calculate time index for fast keyframe search
+        TimeIndex timeIndex = _getTimeIndex(timePos);
+
+        applyToSkeleton(skel, timeIndex, weight, blendMask, scale);
+    }
+    //---------------------------------------------------------------------
+    void Animation::applyToSkeleton(Skeleton* skel, const TimeIndex& timeIndex, Real weight,
+        const AnimationState::BoneBlendMask* blendMask, Real scale)
+    {
+        // Tracks whose rotations are interpolated together, packed as w, x, y, z
+        // for OptimisedUtil. Translation and scale are cheap enough as they are.
+        const size_t BLOCK_SIZE = 64;
+        Bone* bones[BLOCK_SIZE];
+        Real weights[BLOCK_SIZE];
+        Vector3 translates[BLOCK_SIZE];
+        Vector3 scales[BLOCK_SIZE];
+        float t[BLOCK_SIZE];
+        float boneWeights[BLOCK_SIZE];
+        float identities[BLOCK_SIZE * 4];
+        float from[BLOCK_SIZE * 4];
+        float to[BLOCK_SIZE * 4];
+        for (size_t b = 0; b < BLOCK_SIZE; ++b)
         {
-            // get bone to apply to 
-            Bone* b = skel->getBone(i->first);
-            i->second->applyToNode(b, timeIndex, weight, scale);
+            identities[b * 4 + 0] = 1.0f;
+            identities[b * 4 + 1] = identities[b * 4 + 2] = identities[b * 4 + 3] = 0.0f;
         }
 
+        OptimisedUtil* util = OptimisedUtil::getImplementation();
+        NodeTrackList::iterator i = mNodeTrackList.begin();
+        while (i != mNodeTrackList.end())
+        {
+            size_t count = 0;
+            for (; i != mNodeTrackList.end() && count < BLOCK_SIZE; ++i)
+            {
+                // get bone to apply to 
+                Bone* b = skel->getBone(i->first);
+                NodeAnimationTrack* track = i->second;
+                Real boneWeight = blendMask ? (*blendMask)[b->getHandle()] * weight : weight;
+
+                if (!track->_isBatchInterpolated())
+                {
+                    track->applyToNode(b, timeIndex, boneWeight, scale);
+                    continue;
+                }
+                // Nothing to do if no keyframes or zero weight, like applyToNode
+                if (!track->getNumKeyFrames() || !boneWeight)
+                    continue;
+
+                Quaternion q1, q2;
+                Real kt = track->_getKeyFrameTransformsAtTime(timeIndex, q1, q2,
+                    translates[count], scales[count]);
+
+                float* pFrom = from + count * 4;
+                float* pTo = to + count * 4;
+                pFrom[0] = q1.w; pFrom[1] = q1.x; pFrom[2] = q1.y; pFrom[3] = q1.z;
+                pTo[0] = q2.w; pTo[1] = q2.x; pTo[2] = q2.y; pTo[3] = q2.z;
+                t[count] = kt;
+
+                bones[count] = b;
+                weights[count] = boneWeight;
+                boneWeights[count] = boneWeight;
+                ++count;
+            }
+
+            // Interpolate between the keyframes, then from no rotation by the weight
+            util->nlerpQuaternions(t, from, to, from, count);
+            util->nlerpQuaternions(boneWeights, identities, from, from, count);
 
+            for (size_t b = 0; b < count; ++b)
+            {
+                const float* q = from + b * 4;
+                NodeAnimationTrack::_applyTransformToNode(bones[b], translates[b],
+                    Quaternion(q[0], q[1], q[2], q[3]), scales[b], weights[b], scale);
+            }
+        }
     }
     //---------------------------------------------------------------------
-    void Animation::apply(Skeleton* skel, Real timePos, float weight,
-      const AnimationState::BoneBlendMask* blendMask, Real scale)
+    void Animation::_sampleSkeleton(Real timePos, SkeletonSample& sample)
     {
         _applyBaseKeyFrame();
 
-        // Calculate time index for fast keyframe search
-      TimeIndex timeIndex = _getTimeIndex(timePos);
+        TimeIndex timeIndex = _getTimeIndex(timePos);
+
+        sample.timePos = timePos;
+        sample.handles.clear();
+        sample.rotations.clear();
+        sample.translates.clear();
+        sample.scales.clear();
+        sample.liveTracks.clear();
+
+        vector<float>::type t, to;
+        for (NodeTrackList::iterator i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+        {
+            NodeAnimationTrack* track = i->second;
+            // Listeners may override the keyframes at any time
+            if (!track->_isBatchInterpolated())
+            {
+                sample.liveTracks.push_back(track);
+                continue;
+            }
+            if (!track->getNumKeyFrames())
+                continue;
+
+            Quaternion q1, q2;
+            Vector3 translate, scale;
+            t.push_back(track->_getKeyFrameTransformsAtTime(timeIndex, q1, q2, translate, scale));
+            sample.handles.push_back(i->first);
+            sample.translates.push_back(translate);
+            sample.scales.push_back(scale);
+            sample.rotations.push_back(q1.w);
+            sample.rotations.push_back(q1.x);
+            sample.rotations.push_back(q1.y);
+            sample.rotations.push_back(q1.z);
+            to.push_back(q2.w);
+            to.push_back(q2.x);
+            to.push_back(q2.y);
+            to.push_back(q2.z);
+        }
 
-      NodeTrackList::iterator i;
-      for (i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
-      {
-        // get bone to apply to 
-        Bone* b = skel->getBone(i->first);
-        i->second->applyToNode(b, timeIndex, (*blendMask)[b->getHandle()] * weight, scale);
-      }
+        if (!t.empty())
+        {
+            OptimisedUtil::getImplementation()->nlerpQuaternions(&t[0], &sample.rotations[0],
+                &to[0], &sample.rotations[0], t.size());
+        }
+    }
+    //---------------------------------------------------------------------
+    void Animation::_applySkeletonSample(Skeleton* skel, const SkeletonSample& sample, Real weight,
+        const AnimationState::BoneBlendMask* blendMask, Real scale)
+    {
+        if (!sample.liveTracks.empty())
+        {
+            TimeIndex timeIndex = _getTimeIndex(sample.timePos);
+            for (vector<NodeAnimationTrack*>::type::const_iterator i = sample.liveTracks.begin();
+                i != sample.liveTracks.end(); ++i)
+            {
+                Bone* b = skel->getBone((*i)->getHandle());
+                Real boneWeight = blendMask ? (*blendMask)[b->getHandle()] * weight : weight;
+                (*i)->applyToNode(b, timeIndex, boneWeight, scale);
+            }
+        }
+
+        // Same blocks as applyToSkeleton, only the weighting remains to be done
+        const size_t BLOCK_SIZE = 64;
+        size_t indices[BLOCK_SIZE];
+        float boneWeights[BLOCK_SIZE];
+        float identities[BLOCK_SIZE * 4];
+        float from[BLOCK_SIZE * 4];
+        float rotations[BLOCK_SIZE * 4];
+        for (size_t b = 0; b < BLOCK_SIZE; ++b)
+        {
+            identities[b * 4 + 0] = 1.0f;
+            identities[b * 4 + 1] = identities[b * 4 + 2] = identities[b * 4 + 3] = 0.0f;
+        }
+
+        OptimisedUtil* util = OptimisedUtil::getImplementation();
+        size_t i = 0;
+        const size_t numTracks = sample.handles.size();
+        while (i < numTracks)
+        {
+            size_t count = 0;
+            for (; i < numTracks && count < BLOCK_SIZE; ++i)
+            {
+                Real boneWeight = blendMask ? (*blendMask)[sample.handles[i]] * weight : weight;
+                // Nothing to do for a zero weight, like applyToNode
+                if (!boneWeight)
+                    continue;
+
+                memcpy(from + count * 4, &sample.rotations[i * 4], sizeof(float) * 4);
+                boneWeights[count] = boneWeight;
+                indices[count] = i;
+                ++count;
+            }
+
+            util->nlerpQuaternions(boneWeights, identities, from, rotations, count);
+
+            for (size_t b = 0; b < count; ++b)
+            {
+                const float* q = rotations + b * 4;
+                const size_t index = indices[b];
+                NodeAnimationTrack::_applyTransformToNode(skel->getBone(sample.handles[index]),
+                    sample.translates[index], Quaternion(q[0], q[1], q[2], q[3]),
+                    sample.scales[index], boneWeights[b], scale);
+            }
+        }
     }
     //---------------------------------------------------------------------
     void Animation::apply(Entity* entity, Real timePos, Real weight, 
@@ -525,6 +692,14 @@ namespace Ogre {
         
     }
     //-----------------------------------------------------------------------
+    void Animation::compressNodeTracks(void)
+    {
+        for (NodeTrackList::iterator i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+        {
+            i->second->compress();
+        }
+    }
+    //-----------------------------------------------------------------------
     void Animation::_collectIdentityNodeTracks(TrackHandleList& tracks) const
     {
         NodeTrackList::const_iterator i, iend;
@@ -778,6 +953,25 @@ namespace Ogre {
         
     }
     //-----------------------------------------------------------------------
+    void Animation::_prepareForApply(void)
+    {
+        // Rebasing changes the keyframes, so do it first
+        _applyBaseKeyFrame();
+
+        if (mKeyFrameTimesDirty)
+        {
+            buildKeyFrameTimeList();
+        }
+
+        if (mInterpolationMode == IM_SPLINE)
+        {
+            for (NodeTrackList::iterator i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+            {
+                i->second->_prepareInterpolationSplines();
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
     void Animation::_notifyContainer(AnimationContainer* c)
     {
         mContainer = c;
@@ -44,11 +44,139 @@ namespace Ogre {
                 return kf->getTime() < kf2->getTime();
             }
         };
+
+        // Key time accessors for the key searches below
+        struct KeyFrameTime
+        {
+            Real operator() (const KeyFrame* kf) const { return kf->getTime(); }
+        };
+        struct KeyTime
+        {
+            Real operator() (Real time) const { return time; }
+        };
+
+        // Find the first key after or on the time given, as std::lower_bound.
+        // The key found by the last search and the one after it are tried
+        // first, since sequential playback mostly stays on or moves on by one key.
+        template <typename Iterator, typename GetTime>
+        size_t seekKey(Iterator begin, size_t numKeys, Real timePos, size_t cursor,
+            GetTime getTime)
+        {
+            for (size_t i = cursor; i <= numKeys && i <= cursor + 1; ++i)
+            {
+                if ((i == 0 || getTime(begin[i - 1]) < timePos) &&
+                    (i == numKeys || !(getTime(begin[i]) < timePos)))
+                {
+                    return i;
+                }
+            }
+
+            size_t first = 0, count = numKeys;
+            while (count > 0)
+            {
+                size_t step = count / 2;
+                if (getTime(begin[first + step]) < timePos)
+                {
+                    first += step + 1;
+                    count -= step + 1;
+                }
+                else
+                {
+                    count = step;
+                }
+            }
+            return first;
+        }
+
+        // Insert the key times not already in the ordered, unique list of times
+        template <typename Iterator, typename GetTime>
+        void collectKeyTimes(Iterator begin, Iterator end, GetTime getTime,
+            vector<Real>::type& keyFrameTimes)
+        {
+            for (Iterator i = begin; i != end; ++i)
+            {
+                Real timePos = getTime(*i);
+
+                vector<Real>::type::iterator it =
+                    std::lower_bound(keyFrameTimes.begin(), keyFrameTimes.end(), timePos);
+                if (it == keyFrameTimes.end() || *it != timePos)
+                {
+                    keyFrameTimes.insert(it, timePos);
+                }
+            }
+        }
+
+        // Map the lower bound indexes of the global key times to the local keys
+        template <typename Iterator, typename GetTime>
+        void buildKeyIndexMap(Iterator begin, size_t numKeys, GetTime getTime,
+            const vector<Real>::type& keyFrameTimes, vector<ushort>::type& indexMap)
+        {
+            // Pre-allocate memory
+            indexMap.resize(keyFrameTimes.size() + 1);
+
+            size_t i = 0, j = 0;
+            while (j <= keyFrameTimes.size())
+            {
+                indexMap[j] = static_cast<ushort>(i);
+                while (i < numKeys && getTime(begin[i]) <= keyFrameTimes[j])
+                    ++i;
+                ++j;
+            }
+        }
+
+        // Range of the 3 smallest components of a unit quaternion
+        const Real ROTATION_COMPONENT_RANGE = 0.70710678f;
+        const Real ROTATION_COMPONENT_STEPS = 32767.0f;
+
+        // Quantise a rotation to 3 values, see NodeAnimationTrack::CompressedKeyFrames
+        void compressRotation(const Quaternion& rotate, uint16* packed)
+        {
+            Quaternion q = rotate;
+            q.normalise();
+
+            size_t largest = 0;
+            for (size_t i = 1; i < 4; ++i)
+            {
+                if (Math::Abs(q[i]) > Math::Abs(q[largest]))
+                    largest = i;
+            }
+            // q and -q are the same rotation, keep the largest component positive
+            Real sign = q[largest] < 0 ? -1.0f : 1.0f;
+
+            for (size_t i = 0, c = 0; i < 4; ++i)
+            {
+                if (i == largest)
+                    continue;
+                Real v = (q[i] * sign / ROTATION_COMPONENT_RANGE) * 0.5f + 0.5f;
+                v = Math::Clamp<Real>(v * ROTATION_COMPONENT_STEPS + 0.5f, 0.0f, ROTATION_COMPONENT_STEPS);
+                packed[c++] = static_cast<uint16>(v);
+            }
+            packed[0] |= static_cast<uint16>((largest & 1) << 15);
+            packed[1] |= static_cast<uint16>((largest >> 1) << 15);
+        }
+
+        Quaternion decompressRotation(const uint16* packed)
+        {
+            size_t largest = (packed[0] >> 15) | ((packed[1] >> 15) << 1);
+
+            Quaternion q;
+            Real sumSquares = 0;
+            for (size_t i = 0, c = 0; i < 4; ++i)
+            {
+                if (i == largest)
+                    continue;
+                Real v = (packed[c++] & 0x7fff) / ROTATION_COMPONENT_STEPS;
+                q[i] = (v * 2.0f - 1.0f) * ROTATION_COMPONENT_RANGE;
+                sumSquares += q[i] * q[i];
+            }
+            q[largest] = Math::Sqrt(std::max(Real(0), 1.0f - sumSquares));
+            return q;
+        }
     }
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     AnimationTrack::AnimationTrack(Animation* parent, unsigned short handle) :
-        mParent(parent), mHandle(handle), mListener(0)
+        mParent(parent), mHandle(handle), mListener(0), mKeyCursor(0)
     {
     }
     //---------------------------------------------------------------------
@@ -72,6 +200,23 @@ namespace Ogre {
     //---------------------------------------------------------------------
     Real AnimationTrack::getKeyFramesAtTime(const TimeIndex& timeIndex, KeyFrame** keyFrame1, KeyFrame** keyFrame2,
         unsigned short* firstKeyIndex) const
+    {
+        unsigned short key1, key2;
+        Real t = getKeyIndexesAtTime(timeIndex, &key1, &key2);
+
+        // Fill index of the first key
+        if (firstKeyIndex)
+        {
+            *firstKeyIndex = key1;
+        }
+
+        *keyFrame1 = mKeyFrames[key1];
+        *keyFrame2 = mKeyFrames[key2];
+        return t;
+    }
+    //---------------------------------------------------------------------
+    Real AnimationTrack::getKeyIndexesAtTime(const TimeIndex& timeIndex,
+        unsigned short* firstKeyIndex, unsigned short* secondKeyIndex) const
     {
         // Parametric time
         // t1 = time of previous keyframe
@@ -79,17 +224,17 @@ namespace Ogre {
         Real t1, t2;
 
         Real timePos = timeIndex.getTimePos();
+        size_t numKeys = mKeyFrames.size();
 
         // Find first keyframe after or on current time
-        KeyFrameList::const_iterator i;
+        size_t i;
         if (timeIndex.hasKeyIndex())
         {
             // Global keyframe index available, map to local keyframe index directly.
             assert(timeIndex.getKeyIndex() < mKeyFrameIndexMap.size());
-            i = mKeyFrames.begin() + mKeyFrameIndexMap[timeIndex.getKeyIndex()];
+            i = mKeyFrameIndexMap[timeIndex.getKeyIndex()];
 #if OGRE_DEBUG_MODE
-            KeyFrame timeKey(0, timePos);
-            if (i != std::lower_bound(mKeyFrames.begin(), mKeyFrames.end(), &timeKey, KeyFrameTimeLess()))
+            if (i != seekKey(mKeyFrames.begin(), numKeys, timePos, 0, KeyFrameTime()))
             {
                 OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
                     "Optimised key frame search failed",
@@ -107,40 +252,34 @@ namespace Ogre {
                 timePos = fmod( timePos, totalAnimationLength );
 
             // No global keyframe index, need to search with local keyframes.
-            KeyFrame timeKey(0, timePos);
-            i = std::lower_bound(mKeyFrames.begin(), mKeyFrames.end(), &timeKey, KeyFrameTimeLess());
+            i = seekKey(mKeyFrames.begin(), numKeys, timePos, mKeyCursor.get(), KeyFrameTime());
+            mKeyCursor.set(static_cast<ushort>(i));
         }
 
-        if (i == mKeyFrames.end())
+        if (i == numKeys)
         {
             // There is no keyframe after this time, wrap back to first
-            *keyFrame2 = mKeyFrames.front();
-            t2 = mParent->getLength() + (*keyFrame2)->getTime();
+            *secondKeyIndex = 0;
+            t2 = mParent->getLength() + mKeyFrames.front()->getTime();
 
             // Use last keyframe as previous keyframe
             --i;
         }
         else
         {
-            *keyFrame2 = *i;
-            t2 = (*keyFrame2)->getTime();
+            *secondKeyIndex = static_cast<unsigned short>(i);
+            t2 = mKeyFrames[i]->getTime();
 
             // Find last keyframe before or on current time
-            if (i != mKeyFrames.begin() && timePos < (*i)->getTime())
+            if (i != 0 && timePos < t2)
             {
                 --i;
             }
         }
 
-        // Fill index of the first key
-        if (firstKeyIndex)
-        {
-            *firstKeyIndex = static_cast<unsigned short>(std::distance(mKeyFrames.begin(), i));
-        }
-
-        *keyFrame1 = *i;
+        *firstKeyIndex = static_cast<unsigned short>(i);
 
-        t1 = (*keyFrame1)->getTime();
+        t1 = mKeyFrames[i]->getTime();
 
         if (t1 == t2)
         {
@@ -206,32 +345,13 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void AnimationTrack::_collectKeyFrameTimes(vector<Real>::type& keyFrameTimes)
     {
-        for (KeyFrameList::const_iterator i = mKeyFrames.begin(); i != mKeyFrames.end(); ++i)
-        {
-            Real timePos = (*i)->getTime();
-
-            vector<Real>::type::iterator it =
-                std::lower_bound(keyFrameTimes.begin(), keyFrameTimes.end(), timePos);
-            if (it == keyFrameTimes.end() || *it != timePos)
-            {
-                keyFrameTimes.insert(it, timePos);
-            }
-        }
+        collectKeyTimes(mKeyFrames.begin(), mKeyFrames.end(), KeyFrameTime(), keyFrameTimes);
     }
     //---------------------------------------------------------------------
     void AnimationTrack::_buildKeyFrameIndexMap(const vector<Real>::type& keyFrameTimes)
     {
-        // Pre-allocate memory
-        mKeyFrameIndexMap.resize(keyFrameTimes.size() + 1);
-
-        size_t i = 0, j = 0;
-        while (j <= keyFrameTimes.size())
-        {
-            mKeyFrameIndexMap[j] = static_cast<ushort>(i);
-            while (i < mKeyFrames.size() && mKeyFrames[i]->getTime() <= keyFrameTimes[j])
-                ++i;
-            ++j;
-        }
+        buildKeyIndexMap(mKeyFrames.begin(), mKeyFrames.size(), KeyFrameTime(),
+            keyFrameTimes, mKeyFrameIndexMap);
     }
     //--------------------------------------------------------------------------
     void AnimationTrack::_applyBaseKeyFrame(const KeyFrame*)
@@ -357,7 +477,7 @@ namespace Ogre {
     NodeAnimationTrack::NodeAnimationTrack(Animation* parent, unsigned short handle)
         : AnimationTrack(parent, handle), mTargetNode(0)
         , mSplines(0), mSplineBuildNeeded(false)
-        , mUseShortestRotationPath(true)
+        , mCompressed(0), mUseShortestRotationPath(true)
     {
     }
     //---------------------------------------------------------------------
@@ -365,13 +485,14 @@ namespace Ogre {
         Node* targetNode)
         : AnimationTrack(parent, handle), mTargetNode(targetNode)
         , mSplines(0), mSplineBuildNeeded(false)
-        , mUseShortestRotationPath(true)
+        , mCompressed(0), mUseShortestRotationPath(true)
     {
     }
     //---------------------------------------------------------------------
     NodeAnimationTrack::~NodeAnimationTrack()
     {
         OGRE_DELETE_T(mSplines, Splines, MEMCATEGORY_ANIMATION);
+        OGRE_DELETE_T(mCompressed, CompressedKeyFrames, MEMCATEGORY_ANIMATION);
     }
     //---------------------------------------------------------------------
     void NodeAnimationTrack::getInterpolatedKeyFrame(const TimeIndex& timeIndex, KeyFrame* kf) const
@@ -384,21 +505,19 @@ namespace Ogre {
 
         TransformKeyFrame* kret = static_cast<TransformKeyFrame*>(kf);
 
-        // Keyframe pointers
-        KeyFrame *kBase1, *kBase2;
-        TransformKeyFrame *k1, *k2;
-        unsigned short firstKeyIndex;
+        unsigned short firstKeyIndex, secondKeyIndex;
+        Quaternion rotate1;
+        Vector3 translate1, scale1;
 
-        Real t = this->getKeyFramesAtTime(timeIndex, &kBase1, &kBase2, &firstKeyIndex);
-        k1 = static_cast<TransformKeyFrame*>(kBase1);
-        k2 = static_cast<TransformKeyFrame*>(kBase2);
+        Real t = getKeyIndexesAtTime(timeIndex, &firstKeyIndex, &secondKeyIndex);
+        getKeyTransform(firstKeyIndex, rotate1, translate1, scale1);
 
         if (t == 0.0)
         {
             // Just use k1
-            kret->setRotation(k1->getRotation());
-            kret->setTranslate(k1->getTranslate());
-            kret->setScale(k1->getScale());
+            kret->setRotation(rotate1);
+            kret->setTranslate(translate1);
+            kret->setScale(scale1);
         }
         else
         {
@@ -406,31 +525,32 @@ namespace Ogre {
             Animation::InterpolationMode im = mParent->getInterpolationMode();
             Animation::RotationInterpolationMode rim =
                 mParent->getRotationInterpolationMode();
-            Vector3 base;
+            Quaternion rotate2;
+            Vector3 translate2, scale2;
             switch(im)
             {
             case Animation::IM_LINEAR:
                 // Interpolate linearly
+                getKeyTransform(secondKeyIndex, rotate2, translate2, scale2);
+
                 // Rotation
                 // Interpolate to nearest rotation if mUseShortestRotationPath set
                 if (rim == Animation::RIM_LINEAR)
                 {
-                    kret->setRotation( Quaternion::nlerp(t, k1->getRotation(),
-                        k2->getRotation(), mUseShortestRotationPath) );
+                    kret->setRotation( Quaternion::nlerp(t, rotate1,
+                        rotate2, mUseShortestRotationPath) );
                 }
                 else //if (rim == Animation::RIM_SPHERICAL)
                 {
-                    kret->setRotation( Quaternion::Slerp(t, k1->getRotation(),
-                        k2->getRotation(), mUseShortestRotationPath) );
+                    kret->setRotation( Quaternion::Slerp(t, rotate1,
+                        rotate2, mUseShortestRotationPath) );
                 }
 
                 // Translation
-                base = k1->getTranslate();
-                kret->setTranslate( base + ((k2->getTranslate() - base) * t) );
+                kret->setTranslate( translate1 + ((translate2 - translate1) * t) );
 
                 // Scale
-                base = k1->getScale();
-                kret->setScale( base + ((k2->getScale() - base) * t) );
+                kret->setScale( scale1 + ((scale2 - scale1) * t) );
                 break;
 
             case Animation::IM_SPLINE:
@@ -478,16 +598,12 @@ namespace Ogre {
         Real scl)
     {
         // Nothing to do if no keyframes or zero weight or no node
-        if (mKeyFrames.empty() || !weight || !node)
+        if (!getNumKeyFrames() || !weight || !node)
             return;
 
         TransformKeyFrame kf(0, timeIndex.getTimePos());
         getInterpolatedKeyFrame(timeIndex, &kf);
 
-        // add to existing. Weights are not relative, but treated as absolute multipliers for the animation
-        Vector3 translate = kf.getTranslate() * weight * scl;
-        node->translate(translate);
-
         // interpolate between no-rotation and full rotation, to point 'weight', so 0 = no rotate, 1 = full
         Quaternion rotate;
         Animation::RotationInterpolationMode rim =
@@ -500,19 +616,36 @@ namespace Ogre {
         {
             rotate = Quaternion::Slerp(weight, Quaternion::IDENTITY, kf.getRotation(), mUseShortestRotationPath);
         }
+
+        _applyTransformToNode(node, kf.getTranslate(), rotate, kf.getScale(), weight, scl);
+    }
+    //---------------------------------------------------------------------
+    bool NodeAnimationTrack::_isBatchInterpolated(void) const
+    {
+        return !mListener && mUseShortestRotationPath &&
+            mParent->getInterpolationMode() == Animation::IM_LINEAR &&
+            mParent->getRotationInterpolationMode() == Animation::RIM_LINEAR;
+    }
+    //---------------------------------------------------------------------
+    void NodeAnimationTrack::_applyTransformToNode(Node* node, const Vector3& translate,
+        const Quaternion& rotate, const Vector3& scale, Real weight, Real scl)
+    {
+        // add to existing. Weights are not relative, but treated as absolute multipliers for the animation
+        node->translate(translate * weight * scl);
+
         node->rotate(rotate);
 
-        Vector3 scale = kf.getScale();
+        Vector3 adjustedScale = scale;
         // Not sure how to modify scale for cumulative anims... leave it alone
         //scale = ((Vector3::UNIT_SCALE - kf.getScale()) * weight) + Vector3::UNIT_SCALE;
-        if (scale != Vector3::UNIT_SCALE)
+        if (adjustedScale != Vector3::UNIT_SCALE)
         {
             if (scl != 1.0f)
-                scale = Vector3::UNIT_SCALE + (scale - Vector3::UNIT_SCALE) * scl;
+                adjustedScale = Vector3::UNIT_SCALE + (adjustedScale - Vector3::UNIT_SCALE) * scl;
             else if (weight != 1.0f)
-                scale = Vector3::UNIT_SCALE + (scale - Vector3::UNIT_SCALE) * weight;
+                adjustedScale = Vector3::UNIT_SCALE + (adjustedScale - Vector3::UNIT_SCALE) * weight;
         }
-        node->scale(scale);
+        node->scale(adjustedScale);
 
     }
     //---------------------------------------------------------------------
@@ -536,14 +669,15 @@ namespace Ogre {
         splines->rotationSpline.clear();
         splines->scaleSpline.clear();
 
-        KeyFrameList::const_iterator i, iend;
-        iend = mKeyFrames.end(); // precall to avoid overhead
-        for (i = mKeyFrames.begin(); i != iend; ++i)
+        unsigned short numKeyFrames = getNumKeyFrames();
+        for (unsigned short i = 0; i < numKeyFrames; ++i)
         {
-            TransformKeyFrame* kf = static_cast<TransformKeyFrame*>(*i);
-            splines->positionSpline.addPoint(kf->getTranslate());
-            splines->rotationSpline.addPoint(kf->getRotation());
-            splines->scaleSpline.addPoint(kf->getScale());
+            Quaternion rotate;
+            Vector3 translate, scale;
+            getKeyTransform(i, rotate, translate, scale);
+            splines->positionSpline.addPoint(translate);
+            splines->rotationSpline.addPoint(rotate);
+            splines->scaleSpline.addPoint(scale);
         }
 
         splines->positionSpline.recalcTangents();
@@ -553,6 +687,14 @@ namespace Ogre {
 
         mSplineBuildNeeded = false;
     }
+    //---------------------------------------------------------------------
+    void NodeAnimationTrack::_prepareInterpolationSplines(void) const
+    {
+        if (mSplineBuildNeeded)
+        {
+            buildInterpolationSplines();
+        }
+    }
 
     //---------------------------------------------------------------------
     void NodeAnimationTrack::setUseShortestRotationPath(bool useShortestPath)
@@ -573,18 +715,18 @@ namespace Ogre {
     //---------------------------------------------------------------------
     bool NodeAnimationTrack::hasNonZeroKeyFrames(void) const
     {
-        KeyFrameList::const_iterator i = mKeyFrames.begin();
-        for (; i != mKeyFrames.end(); ++i)
+        unsigned short numKeyFrames = getNumKeyFrames();
+        for (unsigned short i = 0; i < numKeyFrames; ++i)
         {
             // look for keyframes which have any component which is non-zero
             // Since exporters can be a little inaccurate sometimes we use a
             // tolerance value rather than looking for nothing
-            TransformKeyFrame* kf = static_cast<TransformKeyFrame*>(*i);
-            Vector3 trans = kf->getTranslate();
-            Vector3 scale = kf->getScale();
+            Quaternion rotate;
+            Vector3 trans, scale;
+            getKeyTransform(i, rotate, trans, scale);
             Vector3 axis;
             Radian angle;
-            kf->getRotation().ToAngleAxis(angle, axis);
+            rotate.ToAngleAxis(angle, axis);
             Real tolerance = 1e-3f;
             if (!trans.positionEquals(Vector3::ZERO, tolerance) ||
                 !scale.positionEquals(Vector3::UNIT_SCALE, tolerance) ||
@@ -607,20 +749,18 @@ namespace Ogre {
         Vector3 lasttrans = Vector3::ZERO;
         Vector3 lastscale = Vector3::ZERO;
         Quaternion lastorientation;
-        KeyFrameList::iterator i = mKeyFrames.begin();
         Radian quatTolerance(1e-3f);
         list<unsigned short>::type removeList;
-        unsigned short k = 0;
+        unsigned short numKeyFrames = getNumKeyFrames();
         ushort dupKfCount = 0;
-        for (; i != mKeyFrames.end(); ++i, ++k)
+        for (unsigned short k = 0; k < numKeyFrames; ++k)
         {
-            TransformKeyFrame* kf = static_cast<TransformKeyFrame*>(*i);
-            Vector3 newtrans = kf->getTranslate();
-            Vector3 newscale = kf->getScale();
-            Quaternion neworientation = kf->getRotation();
+            Vector3 newtrans, newscale;
+            Quaternion neworientation;
+            getKeyTransform(k, neworientation, newtrans, newscale);
             // Ignore first keyframe; now include the last keyframe as we eliminate
             // only k-2 in a group of 5 to ensure we only eliminate middle keys
-            if (i != mKeyFrames.begin() &&
+            if (k != 0 &&
                 newtrans.positionEquals(lasttrans) &&
                 newscale.positionEquals(lastscale) &&
                 neworientation.equals(lastorientation, quatTolerance))
@@ -645,6 +785,28 @@ namespace Ogre {
             }
         }
 
+        if (mCompressed)
+        {
+            if (removeList.empty())
+                return;
+
+            // Remove the keys from the arrays, so the rotations aren't quantised again
+            CompressedKeyFrames keyFrames = *mCompressed;
+            list<unsigned short>::type::reverse_iterator r = removeList.rbegin();
+            for (; r != removeList.rend(); ++r)
+            {
+                keyFrames.times.erase(keyFrames.times.begin() + *r);
+                keyFrames.rotations.erase(keyFrames.rotations.begin() + *r * 3,
+                    keyFrames.rotations.begin() + *r * 3 + 3);
+                if (!keyFrames.translates.empty())
+                    keyFrames.translates.erase(keyFrames.translates.begin() + *r);
+                if (!keyFrames.scales.empty())
+                    keyFrames.scales.erase(keyFrames.scales.begin() + *r);
+            }
+            _setCompressedKeyFrames(keyFrames);
+            return;
+        }
+
         // Now remove keyframes, in reverse order to avoid index revocation
         list<unsigned short>::type::reverse_iterator r = removeList.rbegin();
         for (; r!= removeList.rend(); ++r)
@@ -675,12 +837,19 @@ namespace Ogre {
         NodeAnimationTrack* newTrack = 
             newParent->createNodeTrack(mHandle, mTargetNode);
         newTrack->mUseShortestRotationPath = mUseShortestRotationPath;
-        populateClone(newTrack);
+        if (mCompressed)
+            newTrack->_setCompressedKeyFrames(*mCompressed);
+        else
+            populateClone(newTrack);
         return newTrack;
     }
     //--------------------------------------------------------------------------
     void NodeAnimationTrack::_applyBaseKeyFrame(const KeyFrame* b)
     {
+        // Every key changes, so leave the track decompressed rather than
+        // quantising its rotations a second time
+        decompress();
+
         const TransformKeyFrame* base = static_cast<const TransformKeyFrame*>(b);
         
         for (KeyFrameList::iterator i = mKeyFrames.begin(); i != mKeyFrames.end(); ++i)
@@ -693,6 +862,250 @@ namespace Ogre {
             
     }
     //--------------------------------------------------------------------------
+    unsigned short NodeAnimationTrack::getNumKeyFrames(void) const
+    {
+        if (mCompressed)
+            return static_cast<unsigned short>(mCompressed->times.size());
+        return AnimationTrack::getNumKeyFrames();
+    }
+    //--------------------------------------------------------------------------
+    KeyFrame* NodeAnimationTrack::getKeyFrame(unsigned short index) const
+    {
+        if (mCompressed)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE,
+                "The keyframes of a compressed track can't be accessed, call decompress() first",
+                "NodeAnimationTrack::getKeyFrame");
+        }
+        return AnimationTrack::getKeyFrame(index);
+    }
+    //--------------------------------------------------------------------------
+    Real NodeAnimationTrack::getKeyFramesAtTime(const TimeIndex& timeIndex, KeyFrame** keyFrame1,
+        KeyFrame** keyFrame2, unsigned short* firstKeyIndex) const
+    {
+        if (mCompressed)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE,
+                "The keyframes of a compressed track can't be accessed, call decompress() first",
+                "NodeAnimationTrack::getKeyFramesAtTime");
+        }
+        return AnimationTrack::getKeyFramesAtTime(timeIndex, keyFrame1, keyFrame2, firstKeyIndex);
+    }
+    //--------------------------------------------------------------------------
+    KeyFrame* NodeAnimationTrack::createKeyFrame(Real timePos)
+    {
+        decompress();
+        return AnimationTrack::createKeyFrame(timePos);
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::removeKeyFrame(unsigned short index)
+    {
+        decompress();
+        AnimationTrack::removeKeyFrame(index);
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::removeAllKeyFrames(void)
+    {
+        OGRE_DELETE_T(mCompressed, CompressedKeyFrames, MEMCATEGORY_ANIMATION);
+        mCompressed = 0;
+        AnimationTrack::removeAllKeyFrames();
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::compress(void)
+    {
+        if (mCompressed)
+            return;
+
+        CompressedKeyFrames keyFrames;
+        size_t numKeyFrames = mKeyFrames.size();
+        keyFrames.times.resize(numKeyFrames);
+        keyFrames.rotations.resize(numKeyFrames * 3);
+
+        bool translated = false, scaled = false;
+        for (size_t i = 0; i < numKeyFrames; ++i)
+        {
+            const TransformKeyFrame* kf = static_cast<const TransformKeyFrame*>(mKeyFrames[i]);
+            keyFrames.times[i] = kf->getTime();
+            compressRotation(kf->getRotation(), &keyFrames.rotations[i * 3]);
+            translated = translated || kf->getTranslate() != Vector3::ZERO;
+            scaled = scaled || kf->getScale() != Vector3::UNIT_SCALE;
+        }
+
+        if (translated)
+        {
+            keyFrames.translates.resize(numKeyFrames);
+            for (size_t i = 0; i < numKeyFrames; ++i)
+                keyFrames.translates[i] = static_cast<const TransformKeyFrame*>(mKeyFrames[i])->getTranslate();
+        }
+        if (scaled)
+        {
+            keyFrames.scales.resize(numKeyFrames);
+            for (size_t i = 0; i < numKeyFrames; ++i)
+                keyFrames.scales[i] = static_cast<const TransformKeyFrame*>(mKeyFrames[i])->getScale();
+        }
+
+        _setCompressedKeyFrames(keyFrames);
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::decompress(void)
+    {
+        if (!mCompressed)
+            return;
+
+        CompressedKeyFrames* keyFrames = mCompressed;
+        mCompressed = 0;
+
+        size_t numKeyFrames = keyFrames->times.size();
+        mKeyFrames.reserve(numKeyFrames);
+        for (size_t i = 0; i < numKeyFrames; ++i)
+        {
+            TransformKeyFrame* kf = static_cast<TransformKeyFrame*>(
+                createKeyFrameImpl(keyFrames->times[i]));
+            kf->setRotation(decompressRotation(&keyFrames->rotations[i * 3]));
+            if (!keyFrames->translates.empty())
+                kf->setTranslate(keyFrames->translates[i]);
+            if (!keyFrames->scales.empty())
+                kf->setScale(keyFrames->scales[i]);
+            mKeyFrames.push_back(kf);
+        }
+        OGRE_DELETE_T(keyFrames, CompressedKeyFrames, MEMCATEGORY_ANIMATION);
+
+        _keyFrameDataChanged();
+        mParent->_keyFrameListChanged();
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::_setCompressedKeyFrames(const CompressedKeyFrames& keyFrames)
+    {
+        assert(keyFrames.rotations.size() == keyFrames.times.size() * 3);
+        assert(keyFrames.translates.empty() || keyFrames.translates.size() == keyFrames.times.size());
+        assert(keyFrames.scales.empty() || keyFrames.scales.size() == keyFrames.times.size());
+
+        AnimationTrack::removeAllKeyFrames();
+        if (!mCompressed)
+            mCompressed = OGRE_NEW_T(CompressedKeyFrames, MEMCATEGORY_ANIMATION);
+        *mCompressed = keyFrames;
+        mKeyCursor.set(0);
+
+        _keyFrameDataChanged();
+        mParent->_keyFrameListChanged();
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::_collectKeyFrameTimes(vector<Real>::type& keyFrameTimes)
+    {
+        if (mCompressed)
+            collectKeyTimes(mCompressed->times.begin(), mCompressed->times.end(), KeyTime(), keyFrameTimes);
+        else
+            AnimationTrack::_collectKeyFrameTimes(keyFrameTimes);
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::_buildKeyFrameIndexMap(const vector<Real>::type& keyFrameTimes)
+    {
+        if (mCompressed)
+        {
+            buildKeyIndexMap(mCompressed->times.begin(), mCompressed->times.size(), KeyTime(),
+                keyFrameTimes, mKeyFrameIndexMap);
+        }
+        else
+        {
+            AnimationTrack::_buildKeyFrameIndexMap(keyFrameTimes);
+        }
+    }
+    //--------------------------------------------------------------------------
+    Real NodeAnimationTrack::getKeyIndexesAtTime(const TimeIndex& timeIndex,
+        unsigned short* firstKeyIndex, unsigned short* secondKeyIndex) const
+    {
+        if (!mCompressed)
+            return AnimationTrack::getKeyIndexesAtTime(timeIndex, firstKeyIndex, secondKeyIndex);
+
+        // As AnimationTrack::getKeyIndexesAtTime, on the compressed key times
+        const vector<Real>::type& times = mCompressed->times;
+        Real timePos = timeIndex.getTimePos();
+        size_t numKeys = times.size();
+
+        size_t i;
+        if (timeIndex.hasKeyIndex())
+        {
+            assert(timeIndex.getKeyIndex() < mKeyFrameIndexMap.size());
+            i = mKeyFrameIndexMap[timeIndex.getKeyIndex()];
+        }
+        else
+        {
+            Real totalAnimationLength = mParent->getLength();
+            assert(totalAnimationLength > 0.0f && "Invalid animation length!");
+
+            if( timePos > totalAnimationLength && totalAnimationLength > 0.0f )
+                timePos = fmod( timePos, totalAnimationLength );
+
+            i = seekKey(times.begin(), numKeys, timePos, mKeyCursor.get(), KeyTime());
+            mKeyCursor.set(static_cast<ushort>(i));
+        }
+
+        Real t1, t2;
+        if (i == numKeys)
+        {
+            // Wrap back to the first key
+            *secondKeyIndex = 0;
+            t2 = mParent->getLength() + times.front();
+            --i;
+        }
+        else
+        {
+            *secondKeyIndex = static_cast<unsigned short>(i);
+            t2 = times[i];
+            if (i != 0 && timePos < t2)
+            {
+                --i;
+            }
+        }
+
+        *firstKeyIndex = static_cast<unsigned short>(i);
+        t1 = times[i];
+
+        return t1 == t2 ? 0.0f : (timePos - t1) / (t2 - t1);
+    }
+    //--------------------------------------------------------------------------
+    Real NodeAnimationTrack::getKeyTime(unsigned short index) const
+    {
+        if (mCompressed)
+            return mCompressed->times[index];
+        return mKeyFrames[index]->getTime();
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::getKeyTransform(unsigned short index, Quaternion& rotate,
+        Vector3& translate, Vector3& scale) const
+    {
+        if (mCompressed)
+        {
+            rotate = decompressRotation(&mCompressed->rotations[index * 3]);
+            translate = mCompressed->translates.empty() ?
+                Vector3::ZERO : mCompressed->translates[index];
+            scale = mCompressed->scales.empty() ?
+                Vector3::UNIT_SCALE : mCompressed->scales[index];
+        }
+        else
+        {
+            const TransformKeyFrame* kf = static_cast<const TransformKeyFrame*>(mKeyFrames[index]);
+            rotate = kf->getRotation();
+            translate = kf->getTranslate();
+            scale = kf->getScale();
+        }
+    }
+    //--------------------------------------------------------------------------
+    Real NodeAnimationTrack::_getKeyFrameTransformsAtTime(const TimeIndex& timeIndex,
+        Quaternion& rotate1, Quaternion& rotate2, Vector3& translate, Vector3& scale) const
+    {
+        unsigned short key1, key2;
+        Real t = getKeyIndexesAtTime(timeIndex, &key1, &key2);
+
+        Vector3 translate2, scale2;
+        getKeyTransform(key1, rotate1, translate, scale);
+        getKeyTransform(key2, rotate2, translate2, scale2);
+
+        translate += (translate2 - translate) * t;
+        scale += (scale2 - scale) * t;
+        return t;
+    }
+    //--------------------------------------------------------------------------
     VertexAnimationTrack::VertexAnimationTrack(Animation* parent,
         unsigned short handle, VertexAnimationType animType)
         : AnimationTrack(parent, handle)
@@ -950,7 +1363,13 @@ namespace Ogre {
     void VertexAnimationTrack::applyPoseToVertexData(const Pose* pose,
         VertexData* data, Real influence)
     {
-        if (mTargetMode == TM_HARDWARE)
+        if (mTargetMode == TM_HARDWARE && data->hwPoseTexture)
+        {
+            // The poses are all in a texture already, just pass on which one
+            // is used and how much
+            data->hwPoseWeights.push_back(std::make_pair(pose->_getTextureOffset(), influence));
+        }
+        else if (mTargetMode == TM_HARDWARE)
         {
             // Hardware
             // If target mode is hardware, need to bind our pose buffer
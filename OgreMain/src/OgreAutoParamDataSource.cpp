@@ -48,6 +48,7 @@ namespace Ogre {
         0,      0,    1,    0,
         0,      0,    0,    1);
 
+    uint32 AutoParamDataSource::msNextVersion = 0;
     //-----------------------------------------------------------------------------
     AutoParamDataSource::AutoParamDataSource()
         : mWorldMatrixCount(0),
@@ -61,6 +62,8 @@ namespace Ogre {
          mInverseWorldMatrixDirty(true),
          mInverseWorldViewMatrixDirty(true),
          mInverseViewMatrixDirty(true),
+         mInverseViewProjMatrixDirty(true),
+         mInverseProjMatrixDirty(true),
          mInverseTransposeWorldMatrixDirty(true),
          mInverseTransposeWorldViewMatrixDirty(true),
          mCameraPositionDirty(true),
@@ -70,6 +73,8 @@ namespace Ogre {
          mLodCameraPositionDirty(true),
          mLodCameraPositionObjectSpaceDirty(true),
          mCurrentRenderable(0),
+         mUseIdentityView(false),
+         mUseIdentityProjection(false),
          mCurrentCamera(0), 
          mCameraRelativeRendering(false),
          mCurrentLightList(0),
@@ -89,9 +94,11 @@ namespace Ogre {
             mSpotlightViewProjMatrixDirty[i] = true;
             mSpotlightWorldViewProjMatrixDirty[i] = true;
             mCurrentTextureProjector[i] = 0;
+            mTextureProjectorTile[i] = Matrix4::IDENTITY;
             mShadowCamDepthRangesDirty[i] = false;
         }
 
+        _invalidateVersions(GPV_GLOBAL | GPV_PER_OBJECT | GPV_LIGHTS);
     }
     //-----------------------------------------------------------------------------
     AutoParamDataSource::~AutoParamDataSource()
@@ -118,15 +125,27 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentRenderable(const Renderable* rend)
     {
+        // the view and projection matrices only depend on the renderable's identity
+        // flags, keep them across renderables sharing the flags
+        bool useIdentityView = rend && rend->getUseIdentityView();
+        bool useIdentityProjection = rend && rend->getUseIdentityProjection();
+        if (useIdentityView != mUseIdentityView || useIdentityProjection != mUseIdentityProjection)
+        {
+            mUseIdentityView = useIdentityView;
+            mUseIdentityProjection = useIdentityProjection;
+            invalidateCameraMatrices();
+            _invalidateVersions(GPV_GLOBAL | GPV_PER_OBJECT | GPV_LIGHTS);
+        }
+        else
+        {
+            _invalidateVersions(GPV_PER_OBJECT);
+        }
+
         mCurrentRenderable = rend;
         mWorldMatrixDirty = true;
-        mViewMatrixDirty = true;
-        mProjMatrixDirty = true;
         mWorldViewMatrixDirty = true;
-        mViewProjMatrixDirty = true;
         mWorldViewProjMatrixDirty = true;
         mInverseWorldMatrixDirty = true;
-        mInverseViewMatrixDirty = true;
         mInverseWorldViewMatrixDirty = true;
         mInverseTransposeWorldMatrixDirty = true;
         mInverseTransposeWorldViewMatrixDirty = true;
@@ -140,17 +159,27 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------------
+    void AutoParamDataSource::invalidateCameraMatrices(void)
+    {
+        mViewMatrixDirty = true;
+        mProjMatrixDirty = true;
+        mViewProjMatrixDirty = true;
+        mInverseViewMatrixDirty = true;
+        mInverseViewProjMatrixDirty = true;
+        mInverseProjMatrixDirty = true;
+    }
+    //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentCamera(const Camera* cam, bool useCameraRelative)
     {
+        // a new camera starts a new render, anything may have changed since the last one
+        _invalidateVersions(GPV_GLOBAL | GPV_PER_OBJECT | GPV_LIGHTS);
+
         mCurrentCamera = cam;
         mCameraRelativeRendering = useCameraRelative;
         mCameraRelativePosition = cam->getDerivedPosition();
-        mViewMatrixDirty = true;
-        mProjMatrixDirty = true;
+        invalidateCameraMatrices();
         mWorldViewMatrixDirty = true;
-        mViewProjMatrixDirty = true;
         mWorldViewProjMatrixDirty = true;
-        mInverseViewMatrixDirty = true;
         mInverseWorldViewMatrixDirty = true;
         mInverseTransposeWorldViewMatrixDirty = true;
         mCameraPositionObjectSpaceDirty = true;
@@ -161,6 +190,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentLightList(const LightList* ll)
     {
+        _invalidateVersions(GPV_LIGHTS);
+
         mCurrentLightList = ll;
         for(size_t i = 0; i < ll->size() && i < OGRE_MAX_SIMULTANEOUS_LIGHTS; ++i)
         {
@@ -265,17 +296,20 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setMainCamBoundsInfo(VisibleObjectsBoundsInfo* info)
     {
+        _invalidateVersions(GPV_GLOBAL);
         mMainCamBoundsInfo = info;
         mSceneDepthRangeDirty = true;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentSceneManager(const SceneManager* sm)
     {
+        _invalidateVersions(GPV_GLOBAL);
         mCurrentSceneManager = sm;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setWorldMatrices(const Matrix4* m, size_t count)
     {
+        _invalidateVersions(GPV_PER_OBJECT);
         mWorldMatrixArray = m;
         mWorldMatrixCount = count;
         mWorldMatrixDirty = false;
@@ -318,7 +352,7 @@ namespace Ogre {
     {
         if (mViewMatrixDirty)
         {
-            if (mCurrentRenderable && mCurrentRenderable->getUseIdentityView())
+            if (mUseIdentityView)
                 mViewMatrix = Matrix4::IDENTITY;
             else
             {
@@ -350,7 +384,7 @@ namespace Ogre {
         {
             // NB use API-independent projection matrix since GPU programs
             // bypass the API-specific handedness and use right-handed coords
-            if (mCurrentRenderable && mCurrentRenderable->getUseIdentityProjection())
+            if (mUseIdentityProjection)
             {
                 // Use identity projection matrix, still need to take RS depth into account.
                 RenderSystem* rs = Root::getSingleton().getRenderSystem();
@@ -521,6 +555,9 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setAmbientLightColour(const ColourValue& ambient)
     {
+        if (mAmbientLight != ambient)
+            _invalidateVersions(GPV_GLOBAL);
+
         mAmbientLight = ambient;
     }
     //---------------------------------------------------------------------
@@ -627,11 +664,13 @@ namespace Ogre {
         Real expDensity, Real linearStart, Real linearEnd)
     {
         (void)mode; // ignored
+        Vector4 fogParams(expDensity, linearStart, linearEnd,
+            linearEnd != linearStart ? 1 / (linearEnd - linearStart) : 0);
+        if (mFogColour != colour || mFogParams != fogParams)
+            _invalidateVersions(GPV_GLOBAL);
+
         mFogColour = colour;
-        mFogParams.x = expDensity;
-        mFogParams.y = linearStart;
-        mFogParams.z = linearEnd;
-        mFogParams.w = linearEnd != linearStart ? 1 / (linearEnd - linearStart) : 0;
+        mFogParams = fogParams;
     }
     //-----------------------------------------------------------------------------
     const ColourValue& AutoParamDataSource::getFogColour(void) const
@@ -644,11 +683,21 @@ namespace Ogre {
         return mFogParams;
     }
     //-----------------------------------------------------------------------------
-    void AutoParamDataSource::setTextureProjector(const Frustum* frust, size_t index = 0)
+    void AutoParamDataSource::setTextureProjector(const Frustum* frust, size_t index,
+        const RealRect& tile)
     {
         if (index < OGRE_MAX_SIMULTANEOUS_LIGHTS)
         {
+            Matrix4 tileMatrix(
+                tile.width(), 0, 0, tile.left,
+                0, tile.height(), 0, tile.top,
+                0, 0, 1, 0,
+                0, 0, 0, 1);
+            // projectors only move between renders, which invalidate everything anyway
+            if (mCurrentTextureProjector[index] != frust || mTextureProjectorTile[index] != tileMatrix)
+                _invalidateVersions(GPV_GLOBAL | GPV_PER_OBJECT | GPV_LIGHTS);
             mCurrentTextureProjector[index] = frust;
+            mTextureProjectorTile[index] = tileMatrix;
             mTextureViewProjMatrixDirty[index] = true;
             mTextureWorldViewProjMatrixDirty[index] = true;
             mShadowCamDepthRangesDirty[index] = true;
@@ -669,14 +718,14 @@ namespace Ogre {
                     Matrix4 viewMatrix;
                     mCurrentTextureProjector[index]->calcViewMatrixRelative(
                         mCurrentCamera->getDerivedPosition(), viewMatrix);
-                    mTextureViewProjMatrix[index] = 
+                    mTextureViewProjMatrix[index] = mTextureProjectorTile[index] *
                         PROJECTIONCLIPSPACE2DTOIMAGESPACE_PERSPECTIVE * 
                         mCurrentTextureProjector[index]->getProjectionMatrixWithRSDepth() * 
                         viewMatrix;
                 }
                 else
                 {
-                    mTextureViewProjMatrix[index] = 
+                    mTextureViewProjMatrix[index] = mTextureProjectorTile[index] *
                         PROJECTIONCLIPSPACE2DTOIMAGESPACE_PERSPECTIVE * 
                         mCurrentTextureProjector[index]->getProjectionMatrixWithRSDepth() * 
                         mCurrentTextureProjector[index]->getViewMatrix();
@@ -801,6 +850,13 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentRenderTarget(const RenderTarget* target)
     {
+        _invalidateVersions(GPV_GLOBAL);
+        // the projection matrix is flipped for render targets requiring it
+        if (mCurrentRenderTarget != target)
+        {
+            invalidateCameraMatrices();
+            mWorldViewProjMatrixDirty = true;
+        }
         mCurrentRenderTarget = target;
     }
     //-----------------------------------------------------------------------------
@@ -811,11 +867,13 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentViewport(const Viewport* viewport)
     {
+        _invalidateVersions(GPV_GLOBAL);
         mCurrentViewport = viewport;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setShadowDirLightExtrusionDistance(Real dist)
     {
+        _invalidateVersions(GPV_GLOBAL | GPV_LIGHTS);
         mDirLightExtrusionDistance = dist;
     }
     //-----------------------------------------------------------------------------
@@ -843,7 +901,12 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     Matrix4 AutoParamDataSource::getInverseViewProjMatrix(void) const
     {
-        return this->getViewProjectionMatrix().inverse();
+        if (mInverseViewProjMatrixDirty)
+        {
+            mInverseViewProjMatrix = getViewProjectionMatrix().inverse();
+            mInverseViewProjMatrixDirty = false;
+        }
+        return mInverseViewProjMatrix;
     }
     //-----------------------------------------------------------------------------
     Matrix4 AutoParamDataSource::getInverseTransposeViewProjMatrix(void) const
@@ -873,7 +936,12 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     Matrix4 AutoParamDataSource::getInverseProjectionMatrix(void) const 
     {
-        return this->getProjectionMatrix().inverse();
+        if (mInverseProjMatrixDirty)
+        {
+            mInverseProjMatrix = getProjectionMatrix().inverse();
+            mInverseProjMatrixDirty = false;
+        }
+        return mInverseProjMatrix;
     }
     //-----------------------------------------------------------------------------
     Matrix4 AutoParamDataSource::getInverseTransposeProjectionMatrix(void) const
@@ -1056,11 +1124,15 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setPassNumber(const int passNumber)
     {
+        if (mPassNumber != passNumber)
+            _invalidateVersions(GPV_GLOBAL);
+
         mPassNumber = passNumber;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::incPassNumber(void)
     {
+        _invalidateVersions(GPV_GLOBAL);
         ++mPassNumber;
     }
     //-----------------------------------------------------------------------------
@@ -1144,5 +1216,31 @@ namespace Ogre {
         }
     }
 
+    //-----------------------------------------------------------------------------
+    uint32 AutoParamDataSource::getVersion(GpuParamVariability variability) const
+    {
+        switch (variability)
+        {
+        case GPV_GLOBAL:
+            return mVersions[0];
+        case GPV_PER_OBJECT:
+            return mVersions[1];
+        case GPV_LIGHTS:
+            return mVersions[2];
+        default:
+            // not versioned, always report a change
+            return ++msNextVersion;
+        }
+    }
+    //-----------------------------------------------------------------------------
+    void AutoParamDataSource::_invalidateVersions(uint16 mask)
+    {
+        if (mask & GPV_GLOBAL)
+            mVersions[0] = ++msNextVersion;
+        if (mask & GPV_PER_OBJECT)
+            mVersions[1] = ++msNextVersion;
+        if (mask & GPV_LIGHTS)
+            mVersions[2] = ++msNextVersion;
+    }
 }
 
@@ -75,6 +75,8 @@ namespace Ogre {
         mBoundsDirty(true),
         mIndexContentDirty(true),
         mVertexContentDirty(true),
+        mElementsDirty(false),
+        mVertexEyePosition(Vector3::ZERO),
         mRadius(0.0f),
         mTexCoordDir(TCD_U),
         mVertexCameraUsed(0),
@@ -107,6 +109,8 @@ namespace Ogre {
         // Allocate enough space for everything
         mChainElementList.resize(mChainCount * mMaxElementsPerChain);
         mVertexData->vertexCount = mChainElementList.size() * 2;
+        mElementDirty.assign(mChainElementList.size(), 0);
+        mElementsDirty = false;
 
         // Configure chains
         mChainSegmentList.resize(mChainCount);
@@ -161,12 +165,14 @@ namespace Ogre {
         setupVertexDeclaration();
         if (mBuffersNeedRecreating)
         {
-            // Create the vertex buffer (always dynamic due to the camera adjust)
+            // Create the vertex buffer (always dynamic due to the camera adjust),
+            // shadowed so that changed elements can be uploaded on their own
             HardwareVertexBufferSharedPtr pBuffer =
                 HardwareBufferManager::getSingleton().createVertexBuffer(
                 mVertexData->vertexDeclaration->getVertexSize(0),
                 mVertexData->vertexCount,
-                HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+                HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY, true);
+            pBuffer->setOwnerName("BillboardChain: " + mName);
 
             // (re)Bind the buffer
             // Any existing buffer will lose its reference count and be destroyed
@@ -269,13 +275,15 @@ namespace Ogre {
                     seg.tail = mMaxElementsPerChain - 1;
                 else
                     --seg.tail;
+                // which is now the end of the chain
+                markElementDirty(chainIndex, seg.tail);
             }
         }
 
         // Set the details
         mChainElementList[seg.start + seg.head] = dtls;
 
-        mVertexContentDirty = true;
+        markElementDirty(chainIndex, seg.head);
         mIndexContentDirty = true;
         mBoundsDirty = true;
         // tell parent node to update bounds
@@ -310,9 +318,10 @@ namespace Ogre {
         {
             --seg.tail;
         }
+        if (seg.head != SEGMENT_EMPTY)
+            markElementDirty(chainIndex, seg.tail);
 
         // we removed an entry so indexes need updating
-        mVertexContentDirty = true;
         mIndexContentDirty = true;
         mBoundsDirty = true;
         // tell parent node to update bounds
@@ -335,7 +344,6 @@ namespace Ogre {
         seg.tail = seg.head = SEGMENT_EMPTY;
 
         // we removed an entry so indexes need updating
-        mVertexContentDirty = true;
         mIndexContentDirty = true;
         mBoundsDirty = true;
         // tell parent node to update bounds
@@ -377,13 +385,11 @@ namespace Ogre {
                 "BillboardChain::updateChainElement");
         }
 
-        size_t idx = seg.head + elementIndex;
-        // adjust for the edge and start
-        idx = (idx % mMaxElementsPerChain) + seg.start;
+        size_t e = (seg.head + elementIndex) % mMaxElementsPerChain;
 
-        mChainElementList[idx] = dtls;
+        mChainElementList[e + seg.start] = dtls;
 
-        mVertexContentDirty = true;
+        markElementDirty(chainIndex, e);
         mBoundsDirty = true;
         // tell parent node to update bounds
         if (mParentNode)
@@ -488,16 +494,24 @@ namespace Ogre {
         // The contents of the vertex buffer are correct if they are not dirty
         // and the camera used to build the vertex buffer is still the current 
         // camera.
-        if (!mVertexContentDirty && mVertexCameraUsed == cam)
+        if (!mVertexContentDirty && !mElementsDirty && mVertexCameraUsed == cam)
             return;
 
-        HardwareVertexBufferSharedPtr pBuffer =
-            mVertexData->vertexBufferBinding->getBuffer(0);
-        void* pBufferStart = pBuffer->lock(HardwareBuffer::HBL_DISCARD);
-
         const Vector3& camPos = cam->getDerivedPosition();
         Vector3 eyePos = mParentNode->convertWorldToLocalPosition(camPos);
 
+        // Only the changed elements need writing, unless the vertices of the
+        // others would no longer match them
+        bool rebuildAll = mVertexContentDirty || mVertexCameraUsed != cam ||
+            (mFaceCamera && eyePos != mVertexEyePosition);
+
+        HardwareVertexBufferSharedPtr pBuffer =
+            mVertexData->vertexBufferBinding->getBuffer(0);
+        void* pBufferStart = pBuffer->lock(
+            rebuildAll ? HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL);
+        size_t elemSize = pBuffer->getVertexSize() * 2;
+        bool anyWritten = false;
+
         Vector3 chainTangent;
         for (ChainSegmentList::iterator segi = mChainSegmentList.begin();
             segi != mChainSegmentList.end(); ++segi)
@@ -518,16 +532,28 @@ namespace Ogre {
                     assert (((e + seg.start) * 2) < 65536 && "Too many elements!");
                     uint16 baseIdx = static_cast<uint16>((e + seg.start) * 2);
 
-                    // Determine base pointer to vertex #1
-                    void* pBase = static_cast<void*>(
-                        static_cast<char*>(pBufferStart) +
-                            pBuffer->getVertexSize() * baseIdx);
-
                     // Get index of next item
                     size_t nexte = e + 1;
                     if (nexte == mMaxElementsPerChain)
                         nexte = 0;
 
+                    if (!rebuildAll && !mElementDirty[e + seg.start])
+                    {
+                        if (e == seg.tail)
+                            break; // last one
+
+                        laste = e;
+                        continue;
+                    }
+
+                    // Determine base pointer to vertex #1
+                    void* pBase = static_cast<void*>(
+                        static_cast<char*>(pBufferStart) +
+                            pBuffer->getVertexSize() * baseIdx);
+                    if (!rebuildAll)
+                        pBuffer->markDirty(elemSize * (e + seg.start), elemSize);
+                    anyWritten = true;
+
                     if (e == seg.head)
                     {
                         // No laste, use next item
@@ -631,14 +657,47 @@ namespace Ogre {
 
         } // each segment
 
-
+        // Nothing visible changed; don't let the lock upload the whole buffer
+        if (!rebuildAll && !anyWritten)
+            pBuffer->markDirty(0, 0);
 
         pBuffer->unlock();
         mVertexCameraUsed = cam;
+        mVertexEyePosition = eyePos;
         mVertexContentDirty = false;
+        if (mElementsDirty)
+        {
+            std::fill(mElementDirty.begin(), mElementDirty.end(), 0);
+            mElementsDirty = false;
+        }
 
     }
     //-----------------------------------------------------------------------
+    void BillboardChain::markElementDirty(size_t chainIndex, size_t e)
+    {
+        const ChainSegment& seg = mChainSegmentList[chainIndex];
+        if (seg.head == SEGMENT_EMPTY)
+            return;
+
+        // Offsets from the head, of the tail and of this element
+        size_t last = (seg.tail + mMaxElementsPerChain - seg.head) % mMaxElementsPerChain;
+        size_t offset = (e + mMaxElementsPerChain - seg.head) % mMaxElementsPerChain;
+        size_t end = std::min(offset + 1, last);
+        for (size_t i = offset > 0 ? offset - 1 : 0; i <= end; ++i)
+        {
+            mElementDirty[seg.start + (seg.head + i) % mMaxElementsPerChain] = 1;
+        }
+        mElementsDirty = true;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChain::markChainDirty(size_t chainIndex)
+    {
+        const ChainSegment& seg = mChainSegmentList[chainIndex];
+        std::fill(mElementDirty.begin() + seg.start,
+            mElementDirty.begin() + seg.start + mMaxElementsPerChain, 1);
+        mElementsDirty = true;
+    }
+    //-----------------------------------------------------------------------
     void BillboardChain::updateIndexBuffer(void)
     {
 
@@ -43,6 +43,7 @@ namespace Ogre {
     BillboardParticleRenderer::CmdCommonDirection BillboardParticleRenderer::msCommonDirectionCmd;
     BillboardParticleRenderer::CmdCommonUpVector BillboardParticleRenderer::msCommonUpVectorCmd;
     BillboardParticleRenderer::CmdPointRendering BillboardParticleRenderer::msPointRenderingCmd;
+    BillboardParticleRenderer::CmdInstancedRendering BillboardParticleRenderer::msInstancedRenderingCmd;
     BillboardParticleRenderer::CmdAccurateFacing BillboardParticleRenderer::msAccurateFacingCmd;
     //-----------------------------------------------------------------------
     BillboardParticleRenderer::BillboardParticleRenderer()
@@ -96,6 +97,13 @@ namespace Ogre {
                 "Possible values are 'true' or 'false'.",
                 PT_BOOL),
                 &msPointRenderingCmd);
+            dict->addParameter(ParameterDef("instanced_rendering",
+                "Set whether or not particles will be expanded to quads by the "
+                "vertex program from hardware instance data, which requires a "
+                "material whose vertex program does the expansion. "
+                "Possible values are 'true' or 'false'.",
+                PT_BOOL),
+                &msInstancedRenderingCmd);
             dict->addParameter(ParameterDef("accurate_facing",
                 "Set whether or not particles will be oriented to the camera "
                 "based on the relative position to the camera rather than just "
@@ -126,7 +134,7 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     void BillboardParticleRenderer::_updateRenderQueue(RenderQueue* queue, 
-        list<Particle*>::type& currentParticles, bool cullIndividually)
+        vector<Particle*>::type& currentParticles, bool cullIndividually)
     {
         mBillboardSet->setCullIndividually(cullIndividually);
 
@@ -141,7 +149,7 @@ namespace Ogre {
         if (mBillboardSet->getBillboardsInWorldSpace() && mBillboardSet->getParentSceneNode())
             invWorld = mBillboardSet->getParentSceneNode()->_getFullTransform().inverse();
 
-        for (list<Particle*>::type::iterator i = currentParticles.begin();
+        for (vector<Particle*>::type::iterator i = currentParticles.begin();
             i != currentParticles.end(); ++i)
         {
             Particle* p = *i;
@@ -307,6 +315,16 @@ namespace Ogre {
         return mBillboardSet->isPointRenderingEnabled();
     }
     //-----------------------------------------------------------------------
+    void BillboardParticleRenderer::setInstancedRenderingEnabled(bool enabled)
+    {
+        mBillboardSet->setInstancedRenderingEnabled(enabled);
+    }
+    //-----------------------------------------------------------------------
+    bool BillboardParticleRenderer::isInstancedRenderingEnabled(void) const
+    {
+        return mBillboardSet->isInstancedRenderingEnabled();
+    }
+    //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     const String& BillboardParticleRendererFactory::getType() const
@@ -503,6 +521,17 @@ namespace Ogre {
             StringConverter::parseBool(val));
     }
     //-----------------------------------------------------------------------
+    String BillboardParticleRenderer::CmdInstancedRendering::doGet(const void* target) const
+    {
+        return StringConverter::toString(
+            static_cast<const BillboardParticleRenderer*>(target)->isInstancedRenderingEnabled() );
+    }
+    void BillboardParticleRenderer::CmdInstancedRendering::doSet(void* target, const String& val)
+    {
+        static_cast<BillboardParticleRenderer*>(target)->setInstancedRenderingEnabled(
+            StringConverter::parseBool(val));
+    }
+    //-----------------------------------------------------------------------
     String BillboardParticleRenderer::CmdAccurateFacing::doGet(const void* target) const
     {
         return StringConverter::toString(
@@ -64,6 +64,7 @@ namespace Ogre {
         mCommonDirection(Ogre::Vector3::UNIT_Z),
         mCommonUpVector(Vector3::UNIT_Y),
         mPointRendering(false),
+        mInstancedRendering(false),
         mBuffersCreated(false),
         mPoolSize(0),
         mExternalData(false),
@@ -98,6 +99,7 @@ namespace Ogre {
         mCommonDirection(Ogre::Vector3::UNIT_Z),
         mCommonUpVector(Vector3::UNIT_Y),
         mPointRendering(false),
+        mInstancedRendering(false),
         mBuffersCreated(false),
         mPoolSize(poolSize),
         mExternalData(externalData),
@@ -416,8 +418,35 @@ namespace Ogre {
         if(!mBuffersCreated)
             _createBuffers();
 
+        if (mInstancedRendering)
+        {
+            // The vertex program applies the offsets, it only needs the axes and origin
+            getParametricOffsets(mLeftOff, mRightOff, mTopOff, mBottomOff);
+
+            Real axesType = 0;
+            if (mBillboardType == BBT_ORIENTED_SELF)
+            {
+                axesType = 1;
+                mCamX = mCamDir;
+                mCamY = Vector3::ZERO;
+            }
+            else if (mBillboardType == BBT_PERPENDICULAR_SELF)
+            {
+                axesType = 2;
+                mCamX = mCommonUpVector;
+                mCamY = Vector3::ZERO;
+            }
+            else
+            {
+                genBillboardAxes(&mCamX, &mCamY);
+            }
+
+            setCustomParameter(IP_AXIS_X, Vector4(mCamX.x, mCamX.y, mCamX.z, axesType));
+            setCustomParameter(IP_AXIS_Y, Vector4(mCamY.x, mCamY.y, mCamY.z, (Real)mRotationType));
+            setCustomParameter(IP_OFFSETS, Vector4(mLeftOff, mRightOff, mTopOff, mBottomOff));
+        }
         // Only calculate vertex offets et al if we're not point rendering
-        if (!mPointRendering)
+        else if (!mPointRendering)
         {
 
             // Get offsets for origin type
@@ -450,9 +479,9 @@ namespace Ogre {
             numBillboards = std::min(mPoolSize, numBillboards);
 
             size_t billboardSize;
-            if (mPointRendering)
+            if (mPointRendering || mInstancedRendering)
             {
-                // just one vertex per billboard (this also excludes texcoords)
+                // just one vertex or instance per billboard
                 billboardSize = mMainBuf->getVertexSize();
             }
             else
@@ -484,6 +513,14 @@ namespace Ogre {
         // Skip if not visible (NB always true if not bounds checking individual billboards)
         if (!billboardVisible(mCurrentCamera, bb)) return;
 
+        if (mInstancedRendering)
+        {
+            // Offsets are generated by the vertex program
+            genVertices(0, bb);
+            mNumVisibleBillboards++;
+            return;
+        }
+
         if (!mPointRendering &&
             (mBillboardType == BBT_ORIENTED_SELF ||
             mBillboardType == BBT_PERPENDICULAR_SELF ||
@@ -685,6 +722,20 @@ namespace Ogre {
             op.indexData = 0;
             op.vertexData->vertexCount = mNumVisibleBillboards;
         }
+        else if (mInstancedRendering)
+        {
+            // A single quad, drawn once per visible billboard
+            op.operationType = RenderOperation::OT_TRIANGLE_LIST;
+            op.useIndexes = true;
+            op.useGlobalInstancingVertexBufferIsAvailable = false;
+            op.numberOfInstances = mNumVisibleBillboards;
+
+            op.vertexData->vertexCount = mNumVisibleBillboards ? 4 : 0;
+
+            op.indexData = mIndexData;
+            op.indexData->indexCount = mNumVisibleBillboards ? 6 : 0;
+            op.indexData->indexStart = 0;
+        }
         else
         {
             op.operationType = RenderOperation::OT_TRIANGLE_LIST;
@@ -784,10 +835,18 @@ namespace Ogre {
                 "other than BBT_POINT, this may not give you the results you "
                 "expect.", LML_CRITICAL);
         }
+        if (mInstancedRendering && mAccurateFacing)
+        {
+            LogManager::getSingleton().logMessage("Warning: BillboardSet " +
+                mName + " has instanced rendering enabled, which does not "
+                "support accurate facing.", LML_CRITICAL);
+        }
 
         mVertexData = OGRE_NEW VertexData();
         if (mPointRendering)
             mVertexData->vertexCount = mPoolSize;
+        else if (mInstancedRendering)
+            mVertexData->vertexCount = 4;
         else
             mVertexData->vertexCount = mPoolSize * 4;
 
@@ -798,31 +857,79 @@ namespace Ogre {
         VertexBufferBinding* binding = mVertexData->vertexBufferBinding;
 
         size_t offset = 0;
-        decl->addElement(0, offset, VET_FLOAT3, VES_POSITION);
-        offset += VertexElement::getTypeSize(VET_FLOAT3);
-        decl->addElement(0, offset, VET_COLOUR, VES_DIFFUSE);
-        offset += VertexElement::getTypeSize(VET_COLOUR);
-        // Texture coords irrelevant when enabled point rendering (generated
-        // in point sprite mode, and unused in standard point mode)
-        if (!mPointRendering)
+        if (mInstancedRendering)
         {
+            // Static quad, with the corner as both position and texture coords
+            decl->addElement(0, offset, VET_FLOAT3, VES_POSITION);
+            offset += VertexElement::getTypeSize(VET_FLOAT3);
             decl->addElement(0, offset, VET_FLOAT2, VES_TEXTURE_COORDINATES, 0);
+
+            static const float quad[] = {
+                0, 0, 0, 0, 0,
+                1, 0, 0, 1, 0,
+                0, 1, 0, 0, 1,
+                1, 1, 0, 1, 1 };
+            HardwareVertexBufferSharedPtr quadBuf =
+                HardwareBufferManager::getSingleton().createVertexBuffer(
+                    decl->getVertexSize(0), 4, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+            quadBuf->writeData(0, quadBuf->getSizeInBytes(), quad, true);
+            binding->setBinding(0, quadBuf);
+
+            // Position and rotation, dimensions, texture rectangle, direction
+            // and colour per billboard
+            offset = 0;
+            decl->addElement(1, offset, VET_FLOAT4, VES_TEXTURE_COORDINATES, 1);
+            offset += VertexElement::getTypeSize(VET_FLOAT4);
+            decl->addElement(1, offset, VET_FLOAT2, VES_TEXTURE_COORDINATES, 2);
+            offset += VertexElement::getTypeSize(VET_FLOAT2);
+            decl->addElement(1, offset, VET_FLOAT4, VES_TEXTURE_COORDINATES, 3);
+            offset += VertexElement::getTypeSize(VET_FLOAT4);
+            decl->addElement(1, offset, VET_FLOAT3, VES_TEXTURE_COORDINATES, 4);
+            offset += VertexElement::getTypeSize(VET_FLOAT3);
+            decl->addElement(1, offset, VET_COLOUR, VES_DIFFUSE);
+
+            mMainBuf =
+                HardwareBufferManager::getSingleton().createVertexBuffer(
+                    decl->getVertexSize(1),
+                    mPoolSize,
+                    mAutoUpdate ? HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE : 
+                    HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+            mMainBuf->setIsInstanceData(true);
+            mMainBuf->setInstanceDataStepRate(1);
+            binding->setBinding(1, mMainBuf);
         }
+        else
+        {
+            decl->addElement(0, offset, VET_FLOAT3, VES_POSITION);
+            offset += VertexElement::getTypeSize(VET_FLOAT3);
+            decl->addElement(0, offset, VET_COLOUR, VES_DIFFUSE);
+            offset += VertexElement::getTypeSize(VET_COLOUR);
+            // Texture coords irrelevant when enabled point rendering (generated
+            // in point sprite mode, and unused in standard point mode)
+            if (!mPointRendering)
+            {
+                decl->addElement(0, offset, VET_FLOAT2, VES_TEXTURE_COORDINATES, 0);
+            }
 
-        mMainBuf =
-            HardwareBufferManager::getSingleton().createVertexBuffer(
-                decl->getVertexSize(0),
-                mVertexData->vertexCount,
-                mAutoUpdate ? HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE : 
-                HardwareBuffer::HBU_STATIC_WRITE_ONLY);
-        // bind position and diffuses
-        binding->setBinding(0, mMainBuf);
+            mMainBuf =
+                HardwareBufferManager::getSingleton().createVertexBuffer(
+                    decl->getVertexSize(0),
+                    mVertexData->vertexCount,
+                    mAutoUpdate ? HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE : 
+                    HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+            // bind position and diffuses
+            binding->setBinding(0, mMainBuf);
+        }
+        mMainBuf->setOwnerName("BillboardSet: " + mName);
 
         if (!mPointRendering)
         {
+            // Instanced rendering draws the same quad for every billboard
+            size_t numQuads = mInstancedRendering ? 1 : mPoolSize;
+
             mIndexData  = OGRE_NEW IndexData();
             mIndexData->indexStart = 0;
-            mIndexData->indexCount = mPoolSize * 6;
+            mIndexData->indexCount = numQuads * 6;
 
             mIndexData->indexBuffer = HardwareBufferManager::getSingleton().
                 createIndexBuffer(HardwareIndexBuffer::IT_16BIT,
@@ -848,7 +955,7 @@ namespace Ogre {
 
             for(
                 size_t idx, idxOff, bboard = 0;
-                bboard < mPoolSize;
+                bboard < numQuads;
                 ++bboard )
             {
                 // Do indexes
@@ -1029,7 +1136,7 @@ namespace Ogre {
     void BillboardSet::genBillboardAxes(Vector3* pX, Vector3 *pY, const Billboard* bb)
     {
         // If we're using accurate facing, recalculate camera direction per BB
-        if (mAccurateFacing && 
+        if (mAccurateFacing && !mInstancedRendering &&
             (mBillboardType == BBT_POINT || 
             mBillboardType == BBT_ORIENTED_COMMON ||
             mBillboardType == BBT_ORIENTED_SELF))
@@ -1043,7 +1150,7 @@ namespace Ogre {
         switch (mBillboardType)
         {
         case BBT_POINT:
-            if (mAccurateFacing)
+            if (mAccurateFacing && !mInstancedRendering)
             {
                 // Point billboards will have 'up' based on but not equal to cameras
                 // Use pY temporarily to avoid allocation
@@ -1142,7 +1249,34 @@ namespace Ogre {
         const Ogre::FloatRect & r =
             bb.mUseTexcoordRect ? bb.mTexcoordRect : mTextureCoords[bb.mTexcoordIndex];
 
-        if (mPointRendering)
+        if (mInstancedRendering)
+        {
+            // Single instance per billboard, ignore offsets
+            // position and rotation
+            *mLockPtr++ = bb.mPosition.x;
+            *mLockPtr++ = bb.mPosition.y;
+            *mLockPtr++ = bb.mPosition.z;
+            *mLockPtr++ = mAllDefaultRotation ? 0.0f : bb.mRotation.valueRadians();
+            // dimensions
+            *mLockPtr++ = bb.mOwnDimensions ? bb.mWidth : mDefaultWidth;
+            *mLockPtr++ = bb.mOwnDimensions ? bb.mHeight : mDefaultHeight;
+            // Texture coords
+            *mLockPtr++ = r.left;
+            *mLockPtr++ = r.top;
+            *mLockPtr++ = r.right;
+            *mLockPtr++ = r.bottom;
+            // direction
+            *mLockPtr++ = bb.mDirection.x;
+            *mLockPtr++ = bb.mDirection.y;
+            *mLockPtr++ = bb.mDirection.z;
+            // Colour
+            // Convert float* to RGBA*
+            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            *pCol++ = colour;
+            // Update lock pointer
+            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+        }
+        else if (mPointRendering)
         {
             // Single vertex per billboard, ignore offsets
             // position
@@ -1483,10 +1617,30 @@ namespace Ogre {
         if (enabled != mPointRendering)
         {
             mPointRendering = enabled;
+            if (enabled)
+                mInstancedRendering = false;
             // Different buffer structure (1 or 4 verts per billboard)
             _destroyBuffers();
         }
     }
+    //-----------------------------------------------------------------------
+    void BillboardSet::setInstancedRenderingEnabled(bool enabled)
+    {
+        // Override instanced rendering if not supported
+        if (enabled && !Root::getSingleton().getRenderSystem()->getCapabilities()->hasCapability(RSC_VERTEX_BUFFER_INSTANCE_DATA))
+        {
+            enabled = false;
+        }
+
+        if (enabled != mInstancedRendering)
+        {
+            mInstancedRendering = enabled;
+            if (enabled)
+                mPointRendering = false;
+            // Different buffer structure (1 instance or 4 verts per billboard)
+            _destroyBuffers();
+        }
+    }
 
     //-----------------------------------------------------------------------
     void BillboardSet::setAutoUpdate(bool autoUpdate)
@@ -412,8 +412,8 @@ namespace Ogre {
         }
 
         //notify prerender scene
-        ListenerList listenersCopy = mListeners;
-        for (ListenerList::iterator i = listenersCopy.begin(); i != listenersCopy.end(); ++i)
+        ListenerListCopy listenersCopy(mListeners.begin(), mListeners.end());
+        for (ListenerListCopy::iterator i = listenersCopy.begin(); i != listenersCopy.end(); ++i)
         {
             (*i)->cameraPreRenderScene(this);
         }
@@ -422,10 +422,10 @@ namespace Ogre {
         mSceneMgr->_renderScene(this, vp, includeOverlays);
 
         // Listener list may have change
-        listenersCopy = mListeners;
+        listenersCopy.assign(mListeners.begin(), mListeners.end());
 
         //notify postrender scene
-        for (ListenerList::iterator i = listenersCopy.begin(); i != listenersCopy.end(); ++i)
+        for (ListenerListCopy::iterator i = listenersCopy.begin(); i != listenersCopy.end(); ++i)
         {
             (*i)->cameraPostRenderScene(this);
         }
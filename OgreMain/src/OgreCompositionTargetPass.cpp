@@ -37,6 +37,8 @@ CompositionTargetPass::CompositionTargetPass(CompositionTechnique *parent):
     mParent(parent),
     mInputMode(IM_NONE),
     mOnlyInitial(false),
+    mUpdateInterval(1),
+    mOnlyWhenDirty(false),
     mVisibilityMask(0xFFFFFFFF),
     mLodBias(1.0f),
     mMaterialScheme(MaterialManager::DEFAULT_SCHEME_NAME), 
@@ -83,6 +85,16 @@ bool CompositionTargetPass::getOnlyInitial()
     return mOnlyInitial;
 }
 //-----------------------------------------------------------------------
+void CompositionTargetPass::setUpdateInterval(uint32 frames)
+{
+    mUpdateInterval = std::max(frames, (uint32)1);
+}
+//-----------------------------------------------------------------------
+void CompositionTargetPass::setOnlyWhenDirty(bool value)
+{
+    mOnlyWhenDirty = value;
+}
+//-----------------------------------------------------------------------
 void CompositionTargetPass::setVisibilityMask(uint32 mask)
 {
     mVisibilityMask = mask;
@@ -309,18 +309,50 @@ void CompositorChain::preRenderTargetUpdate(const RenderTargetEvent& evt)
     }
 
     /// Iterate over compiled state
+    mUpdatedTargets.clear();
     CompositorInstance::CompiledState::iterator i;
     for(i=mCompiledState.begin(); i!=mCompiledState.end(); ++i)
     {
-        /// Skip if this is a target that should only be initialised initially
-        if(i->onlyInitial && i->hasBeenRendered)
-            continue;
+        if(i->hasBeenRendered &&
+            std::find(mInvalidatedTargets.begin(), mInvalidatedTargets.end(), i->target) == mInvalidatedTargets.end())
+        {
+            /// Skip if this is a target that should only be initialised initially
+            if(i->onlyInitial)
+                continue;
+
+            /// Skip until the update interval elapsed, or until an input changed
+            ++i->framesSinceUpdate;
+            bool update;
+            if(i->onlyWhenDirty)
+            {
+                update = i->updateInterval > 1 && i->framesSinceUpdate >= i->updateInterval;
+                for(size_t n = 0; n < i->inputTargets.size() && !update; ++n)
+                {
+                    update = std::find(mUpdatedTargets.begin(), mUpdatedTargets.end(),
+                        i->inputTargets[n]) != mUpdatedTargets.end();
+                }
+            }
+            else
+            {
+                update = i->framesSinceUpdate >= i->updateInterval;
+            }
+            if(!update)
+                continue;
+        }
         i->hasBeenRendered = true;
+        i->framesSinceUpdate = 0;
+        mUpdatedTargets.push_back(i->target);
         /// Setup and render
         preTargetOperation(*i, i->target->getViewport(0), cam);
         i->target->update();
         postTargetOperation(*i, i->target->getViewport(0), cam);
     }
+    mInvalidatedTargets.clear();
+}
+//-----------------------------------------------------------------------
+void CompositorChain::_invalidateTarget(RenderTarget* target)
+{
+    mInvalidatedTargets.push_back(target);
 }
 //-----------------------------------------------------------------------
 void CompositorChain::postRenderTargetUpdate(const RenderTargetEvent& evt)
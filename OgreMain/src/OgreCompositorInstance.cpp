@@ -424,6 +424,14 @@ void CompositorInstance::collectPasses(TargetOperation &finalState, CompositionT
             rsQuadOperation->setQuadFarCorners(pass->getQuadFarCorners(), pass->getQuadFarCornersViewSpace());
             
             queueRenderSystemOp(finalState,rsQuadOperation);
+
+            /// Record the inputs, to know when the target has to be rendered again
+            for(size_t x=0; x<pass->getNumInputs(); ++x)
+            {
+                const String& inputName = pass->getInput(x).name;
+                if(!inputName.empty())
+                    finalState.inputTargets.push_back(getTargetForTex(inputName));
+            }
             }
             break;
         case CompositionPass::PT_RENDERCUSTOM:
@@ -452,6 +460,8 @@ void CompositorInstance::_compileTargetOperations(CompiledState &compiledState)
         TargetOperation ts(getTargetForTex(target->getOutputName()));
         /// Set "only initial" flag, visibilityMask and lodBias according to CompositionTargetPass.
         ts.onlyInitial = target->getOnlyInitial();
+        ts.updateInterval = target->getUpdateInterval();
+        ts.onlyWhenDirty = target->getOnlyWhenDirty();
         ts.visibilityMask = target->getVisibilityMask();
         ts.lodBias = target->getLodBias();
         ts.shadowsEnabled = target->getShadowsEnabled();
@@ -609,9 +619,100 @@ void CompositorInstance::notifyResized()
     mChain->_markDirty();
 }
 //-----------------------------------------------------------------------
+namespace
+{
+    /// Range of target passes a local texture is used by within one frame
+    struct TextureLifetime
+    {
+        size_t firstPass, lastPass;
+        bool inputPrevious;
+        bool transient;
+    };
+    typedef map<String, TextureLifetime>::type TextureLifetimeMap;
+
+    /** Works out the target passes using each texture written by a technique,
+        the output target pass counting as the last one. Textures read before
+        they are written keep their contents from the previous frame, so they
+        are not transient.
+    */
+    void findTextureLifetimes(CompositionTechnique* tech, TextureLifetimeMap& lifetimes)
+    {
+        vector<CompositionTargetPass*>::type targets;
+        CompositionTechnique::TargetPassIterator it = tech->getTargetPassIterator();
+        while (it.hasMoreElements())
+            targets.push_back(it.getNext());
+        targets.push_back(tech->getOutputTargetPass());
+
+        bool custom = false;
+        set<String>::type read;
+        for (size_t t = 0; t < targets.size(); ++t)
+        {
+            CompositionTargetPass* target = targets[t];
+            bool overwrites = target->getInputMode() == CompositionTargetPass::IM_PREVIOUS;
+
+            CompositionTargetPass::PassIterator pit = target->getPassIterator();
+            while (pit.hasMoreElements())
+            {
+                CompositionPass* pass = pit.getNext();
+                if (pass->getType() == CompositionPass::PT_RENDERCUSTOM)
+                    custom = true;
+                else if ((pass->getType() == CompositionPass::PT_CLEAR &&
+                    (pass->getClearBuffers() & FBT_COLOUR)) ||
+                    pass->getType() == CompositionPass::PT_RENDERQUAD)
+                    overwrites = true;
+
+                for (size_t i = 0; i < pass->getNumInputs(); ++i)
+                {
+                    const String& name = pass->getInput(i).name;
+                    TextureLifetimeMap::iterator l = lifetimes.find(name);
+                    if (l != lifetimes.end())
+                        l->second.lastPass = t;
+                    else
+                        read.insert(name);
+                }
+            }
+
+            // The output target pass renders to the viewport or the next instance
+            if (t == targets.size() - 1)
+                break;
+
+            const String& name = target->getOutputName();
+            TextureLifetimeMap::iterator l = lifetimes.find(name);
+            if (l == lifetimes.end())
+            {
+                TextureLifetime& lifetime = lifetimes[name];
+                lifetime.firstPass = t;
+                lifetime.lastPass = t;
+                lifetime.inputPrevious = target->getInputMode() == CompositionTargetPass::IM_PREVIOUS;
+                lifetime.transient = overwrites && !target->getOnlyInitial() &&
+                    target->getUpdateInterval() == 1 && !target->getOnlyWhenDirty() &&
+                    read.find(name) == read.end();
+            }
+            else
+            {
+                l->second.lastPass = t;
+                if (target->getOnlyInitial() || target->getUpdateInterval() != 1 ||
+                    target->getOnlyWhenDirty())
+                    l->second.transient = false;
+            }
+        }
+
+        // Custom passes may use any texture of the instance
+        if (custom)
+        {
+            for (TextureLifetimeMap::iterator l = lifetimes.begin(); l != lifetimes.end(); ++l)
+                l->second.transient = false;
+        }
+    }
+}
+//-----------------------------------------------------------------------
 void CompositorInstance::createResources(bool forResizeOnly)
 {
     static size_t dummyCounter = 0;
+    CompositorManager& compMgr = CompositorManager::getSingleton();
+    TextureLifetimeMap lifetimes;
+    if (compMgr.getTextureAliasingEnabled())
+        findTextureLifetimes(mTechnique, lifetimes);
     /// Create temporary textures
     /// In principle, temporary textures could be shared between multiple viewports
     /// (CompositorChains). This will save a lot of memory in case more viewports
@@ -739,6 +840,7 @@ void CompositorInstance::createResources(bool forResizeOnly)
                 std::replace( texName.begin(), texName.end(), ' ', '_' ); 
                 
                 TexturePtr tex;
+                TextureLifetimeMap::const_iterator lifetime = lifetimes.find(def->name);
                 if (def->pooled)
                 {
                     // get / create pooled texture
@@ -747,6 +849,15 @@ void CompositorInstance::createResources(bool forResizeOnly)
                                                                              hwGamma && !PixelUtil::isFloatingPoint(def->formatList[0]), assignedTextures, 
                                                                              this, def->scope);
                 }
+                else if (def->scope == CompositionTechnique::TS_LOCAL &&
+                         lifetime != lifetimes.end() && lifetime->second.transient)
+                {
+                    // share with other textures of the chain not in use at the same time
+                    tex = compMgr._getAliasedTexture(texName, def->name, width, height, def->formatList[0],
+                                                     fsaa, fsaaHint, hwGamma && !PixelUtil::isFloatingPoint(def->formatList[0]),
+                                                     def->depthBufferId, this, lifetime->second.firstPass,
+                                                     lifetime->second.lastPass, lifetime->second.inputPrevious);
+                }
                 else
                 {
                     tex = TextureManager::getSingleton().createManual(
@@ -913,9 +1024,11 @@ void CompositorInstance::freeResources(bool forResizeOnly, bool clearReserveText
                 LocalTextureMap::iterator i = mLocalTextures.find(texName);
                 if (i != mLocalTextures.end())
                 {
-                    if (!def->pooled && def->scope != CompositionTechnique::TS_GLOBAL)
+                    if (!def->pooled && def->scope != CompositionTechnique::TS_GLOBAL &&
+                        !CompositorManager::getSingleton()._releaseAliasedTexture(this, texName))
                     {
-                        // remove myself from central only if not pooled and not global
+                        // remove myself from central only if not pooled, not global
+                        // and not shared with other textures of the chain
                         TextureManager::getSingleton().remove(i->second->getName());
                     }
 
@@ -980,6 +1093,11 @@ RenderTarget* CompositorInstance::getRenderTarget(const String& name)
     return getTargetForTex(name);
 }
 //-----------------------------------------------------------------------
+void CompositorInstance::invalidateTarget(const String& name)
+{
+    mChain->_invalidateTarget(getTargetForTex(name));
+}
+//-----------------------------------------------------------------------
 RenderTarget *CompositorInstance::getTargetForTex(const String &name)
 {
     // try simple texture
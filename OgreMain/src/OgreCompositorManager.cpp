@@ -50,7 +50,7 @@ CompositorManager& CompositorManager::getSingleton(void)
     assert( msSingleton );  return ( *msSingleton );  
 }//-----------------------------------------------------------------------
 CompositorManager::CompositorManager():
-    mRectangle(0)
+    mRectangle(0), mTextureAliasing(false)
 {
     initialise();
 
@@ -339,6 +339,90 @@ TexturePtr CompositorManager::getPooledTexture(const String& name,
     return ret;
 }
 //---------------------------------------------------------------------
+TexturePtr CompositorManager::_getAliasedTexture(const String& name, const String& localName,
+    size_t w, size_t h, PixelFormat f, uint aa, const String& aaHint, bool srgb,
+    uint16 depthBufferId, CompositorInstance* inst, size_t firstPass, size_t lastPass,
+    bool inputPrevious)
+{
+    TextureDef def(w, h, f, aa, aaHint, srgb);
+    TextureDefLess less;
+    AliasedTextureList& texList = mAliasedTextures[inst->getChain()];
+
+    AliasedTextureList::iterator t;
+    for (t = texList.begin(); t != texList.end(); ++t)
+    {
+        if (t->depthBufferId != depthBufferId || less(t->def, def) || less(def, t->def))
+            continue;
+
+        bool overlaps = false;
+        for (AliasUseList::const_iterator u = t->uses.begin(); u != t->uses.end() && !overlaps; ++u)
+        {
+            if (u->instance == inst)
+            {
+                overlaps = u->firstPass <= lastPass && firstPass <= u->lastPass;
+            }
+            else
+            {
+                // The output pass of the previous instance renders into a texture
+                // written with input previous, while its own textures are in use
+                overlaps = u->inputPrevious || inputPrevious;
+            }
+        }
+        if (!overlaps)
+            break;
+    }
+
+    if (t == texList.end())
+    {
+        texList.push_back(AliasedTexture(def));
+        t = --texList.end();
+        t->depthBufferId = depthBufferId;
+        t->texture = TextureManager::getSingleton().createManual(
+            name, 
+            ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME, TEX_TYPE_2D, 
+            (uint)w, (uint)h, 0, f, TU_RENDERTARGET, 0,
+            srgb, aa, aaHint);
+    }
+
+    AliasUse use;
+    use.instance = inst;
+    use.localName = localName;
+    use.firstPass = firstPass;
+    use.lastPass = lastPass;
+    use.inputPrevious = inputPrevious;
+    t->uses.push_back(use);
+
+    return t->texture;
+}
+//---------------------------------------------------------------------
+bool CompositorManager::_releaseAliasedTexture(CompositorInstance* inst, const String& localName)
+{
+    AliasedTexturesByChain::iterator c = mAliasedTextures.find(inst->getChain());
+    if (c == mAliasedTextures.end())
+        return false;
+
+    AliasedTextureList& texList = c->second;
+    for (AliasedTextureList::iterator t = texList.begin(); t != texList.end(); ++t)
+    {
+        for (AliasUseList::iterator u = t->uses.begin(); u != t->uses.end(); ++u)
+        {
+            if (u->instance == inst && u->localName == localName)
+            {
+                t->uses.erase(u);
+                if (t->uses.empty())
+                {
+                    TextureManager::getSingleton().remove(t->texture->getHandle());
+                    texList.erase(t);
+                    if (texList.empty())
+                        mAliasedTextures.erase(c);
+                }
+                return true;
+            }
+        }
+    }
+    return false;
+}
+//---------------------------------------------------------------------
 bool CompositorManager::isInputPreviousTarget(CompositorInstance* inst, const Ogre::String& localName)
 {
     CompositionTechnique::TargetPassIterator tpit = inst->getTechnique()->getTargetPassIterator();
@@ -462,6 +546,7 @@ void CompositorManager::freePooledTextures(bool onlyIfUnreferenced)
         }
         mTexturesByDef.clear();
         mChainTexturesByDef.clear();
+        mAliasedTextures.clear();
     }
 
 }
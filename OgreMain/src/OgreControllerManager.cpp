@@ -44,7 +44,8 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     ControllerManager::ControllerManager()
-        : mFrameTimeController(OGRE_NEW FrameTimeControllerValue())
+        : mUpdateListDirty(false)
+        , mFrameTimeController(OGRE_NEW FrameTimeControllerValue())
         , mPassthroughFunction(OGRE_NEW PassthroughControllerFunction())
         , mLastFrameNumber(0)
     {
@@ -63,6 +64,7 @@ namespace Ogre {
         Controller<Real>* c = OGRE_NEW Controller<Real>(src, dest, func);
 
         mControllers.insert(c);
+        mUpdateListDirty = true;
         return c;
     }
     //-----------------------------------------------------------------------
@@ -78,10 +80,33 @@ namespace Ogre {
         unsigned long thisFrameNumber = Root::getSingleton().getNextFrameNumber();
         if (thisFrameNumber != mLastFrameNumber)
         {
-            ControllerList::const_iterator ci;
-            for (ci = mControllers.begin(); ci != mControllers.end(); ++ci)
+            if (mUpdateListDirty)
             {
-                (*ci)->update();
+                mUpdateList.assign(mControllers.begin(), mControllers.end());
+                mUpdateListDirty = false;
+            }
+
+            // Most controllers are driven by the frame time, only query it once
+            const ControllerValue<Real>* frameTimeSource = mFrameTimeController.get();
+            const Real frameTime = frameTimeSource->getValue();
+
+            ControllerUpdateList::const_iterator ci, ciend = mUpdateList.end();
+            for (ci = mUpdateList.begin(); ci != ciend; ++ci)
+            {
+                Controller<Real>* c = *ci;
+                // A controller updated before may have destroyed this one
+                if (mUpdateListDirty && mControllers.find(c) == mControllers.end())
+                    continue;
+
+                if (c->getSource().get() == frameTimeSource)
+                {
+                    if (c->getEnabled())
+                        c->getDestination()->setValue(c->getFunction()->calculate(frameTime));
+                }
+                else
+                {
+                    c->update();
+                }
             }
             mLastFrameNumber = thisFrameNumber;
         }
@@ -95,6 +120,8 @@ namespace Ogre {
             OGRE_DELETE *ci;
         }
         mControllers.clear();
+        mUpdateList.clear();
+        mUpdateListDirty = false;
     }
     //-----------------------------------------------------------------------
     const ControllerValueRealPtr& ControllerManager::getFrameTimeSource(void) const
@@ -240,6 +267,7 @@ namespace Ogre {
         if (i != mControllers.end())
         {
             mControllers.erase(i);
+            mUpdateListDirty = true;
             OGRE_DELETE controller;
         }
     }
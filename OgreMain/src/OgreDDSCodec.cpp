@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "OgreException.h"
 #include "OgreLogManager.h"
 #include "OgreBitwise.h"
+#include "OgreWorkQueue.h"
 
 namespace Ogre {
     // Internal DDS structure definitions
@@ -651,6 +652,96 @@ namespace Ogre {
             pCol[i].a = derivedAlphas[dw & 0x7];
     }
     //---------------------------------------------------------------------
+    void DDSCodec::unpackDXTBlockRows(PixelFormat sourceFormat, const uchar* src,
+        PixelFormat destFormat, uchar* dest, uint32 width, uint32 height, size_t begin, size_t end) const
+    {
+        const size_t blockSize = sourceFormat == PF_DXT1 ? 8 : 16;
+        const size_t blocksPerRow = (width + 3) / 4;
+        const size_t rowsPerSlice = (height + 3) / 4;
+        const size_t destBpp = PixelUtil::getNumElemBytes(destFormat);
+        const size_t dstPitch = width * destBpp;
+
+        DXTColourBlock col;
+        DXTInterpolatedAlphaBlock iAlpha;
+        DXTExplicitAlphaBlock eAlpha;
+        // 4x4 block of decompressed colour
+        ColourValue tempColours[16];
+
+        for (size_t row = begin; row < end; ++row)
+        {
+            const size_t z = row / rowsPerSlice;
+            const size_t y = (row % rowsPerSlice) * 4;
+            const size_t sy = std::min<size_t>(height - y, 4);
+            const uchar* pSrc = src + row * blocksPerRow * blockSize;
+            uchar* pDestRow = dest + (z * height + y) * dstPitch;
+
+            for (size_t x = 0; x < width; x += 4)
+            {
+                const size_t sx = std::min<size_t>(width - x, 4);
+
+                if (sourceFormat == PF_DXT2 ||
+                    sourceFormat == PF_DXT3)
+                {
+                    // explicit alpha
+                    memcpy(&eAlpha, pSrc, sizeof(DXTExplicitAlphaBlock));
+                    pSrc += sizeof(DXTExplicitAlphaBlock);
+                    flipEndian(eAlpha.alphaRow, sizeof(uint16), 4);
+                    unpackDXTAlpha(eAlpha, tempColours) ;
+                }
+                else if (sourceFormat == PF_DXT4 ||
+                    sourceFormat == PF_DXT5)
+                {
+                    // interpolated alpha
+                    memcpy(&iAlpha, pSrc, sizeof(DXTInterpolatedAlphaBlock));
+                    pSrc += sizeof(DXTInterpolatedAlphaBlock);
+                    flipEndian(&(iAlpha.alpha_0), sizeof(uint16));
+                    flipEndian(&(iAlpha.alpha_1), sizeof(uint16));
+                    unpackDXTAlpha(iAlpha, tempColours) ;
+                }
+                // always read colour
+                memcpy(&col, pSrc, sizeof(DXTColourBlock));
+                pSrc += sizeof(DXTColourBlock);
+                flipEndian(&(col.colour_0), sizeof(uint16));
+                flipEndian(&(col.colour_1), sizeof(uint16));
+                unpackDXTColour(sourceFormat, col, tempColours);
+
+                // write 4x4 block to uncompressed version
+                for (size_t by = 0; by < sy; ++by)
+                {
+                    uchar* pDest = pDestRow + by * dstPitch + x * destBpp;
+                    for (size_t bx = 0; bx < sx; ++bx)
+                    {
+                        PixelUtil::packColour(tempColours[by*4+bx], destFormat, pDest);
+                        pDest += destBpp;
+                    }
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    class DDSCodec::DXTUnpackTask : public WorkQueue::ParallelTask
+    {
+        const DDSCodec* mCodec;
+        PixelFormat mSourceFormat;
+        const uchar* mSrc;
+        PixelFormat mDestFormat;
+        uchar* mDest;
+        uint32 mWidth, mHeight;
+    public:
+        DXTUnpackTask(const DDSCodec* codec, PixelFormat sourceFormat, const uchar* src,
+            PixelFormat destFormat, uchar* dest, uint32 width, uint32 height)
+            : mCodec(codec), mSourceFormat(sourceFormat), mSrc(src), mDestFormat(destFormat)
+            , mDest(dest), mWidth(width), mHeight(height)
+        {
+        }
+
+        void execute(size_t begin, size_t end)
+        {
+            mCodec->unpackDXTBlockRows(mSourceFormat, mSrc, mDestFormat, mDest,
+                mWidth, mHeight, begin, end);
+        }
+    };
+    //---------------------------------------------------------------------
     Codec::DecodeResult DDSCodec::decode(DataStreamPtr& stream) const
     {
         // Read 4 character code
@@ -809,7 +900,17 @@ namespace Ogre {
         imgData->size = Image::calculateSize(imgData->num_mipmaps, numFaces, 
             imgData->width, imgData->height, imgData->depth, imgData->format);
 
-        // Bind output buffer
+        if (!decompressDXT)
+        {
+            // The file holds all mips for a face, then each face, just as Image
+            // does, so take the data as it is
+            DecodeResult ret;
+            ret.first = readPixelData(stream, imgData->size, imgData);
+            ret.second = CodecDataPtr(imgData);
+            return ret;
+        }
+
+        // Decompress into the output buffer
         output.bind(OGRE_NEW MemoryDataStream(imgData->size));
 
 
@@ -826,121 +927,25 @@ namespace Ogre {
             for(size_t mip = 0; mip <= imgData->num_mipmaps; ++mip)
             {
                 size_t dstPitch = width * PixelUtil::getNumElemBytes(imgData->format);
-                
-                if (PixelUtil::isCompressed(sourceFormat))
-                {
-                    // Compressed data
-                    if (decompressDXT)
-                    {
-                        DXTColourBlock col;
-                        DXTInterpolatedAlphaBlock iAlpha;
-                        DXTExplicitAlphaBlock eAlpha;
-                        // 4x4 block of decompressed colour
-                        ColourValue tempColours[16];
-                        size_t destBpp = PixelUtil::getNumElemBytes(imgData->format);
-
-                        // slices are done individually
-                        for(size_t z = 0; z < depth; ++z)
-                        {
-                            size_t remainingHeight = height;
-
-                            // 4x4 blocks in x/y
-                            for (size_t y = 0; y < height; y += 4)
-                            {
-                                size_t sy = std::min<size_t>( remainingHeight, 4u );
-                                remainingHeight -= sy;
-
-                                size_t remainingWidth = width;
-
-                                for (size_t x = 0; x < width; x += 4)
-                                {
-                                    size_t sx = std::min<size_t>( remainingWidth, 4u );
-                                    size_t destPitchMinus4 = dstPitch - destBpp * sx;
-
-                                    remainingWidth -= sx;
-
-                                    if (sourceFormat == PF_DXT2 || 
-                                        sourceFormat == PF_DXT3)
-                                    {
-                                        // explicit alpha
-                                        stream->read(&eAlpha, sizeof(DXTExplicitAlphaBlock));
-                                        flipEndian(eAlpha.alphaRow, sizeof(uint16), 4);
-                                        unpackDXTAlpha(eAlpha, tempColours) ;
-                                    }
-                                    else if (sourceFormat == PF_DXT4 || 
-                                        sourceFormat == PF_DXT5)
-                                    {
-                                        // interpolated alpha
-                                        stream->read(&iAlpha, sizeof(DXTInterpolatedAlphaBlock));
-                                        flipEndian(&(iAlpha.alpha_0), sizeof(uint16));
-                                        flipEndian(&(iAlpha.alpha_1), sizeof(uint16));
-                                        unpackDXTAlpha(iAlpha, tempColours) ;
-                                    }
-                                    // always read colour
-                                    stream->read(&col, sizeof(DXTColourBlock));
-                                    flipEndian(&(col.colour_0), sizeof(uint16));
-                                    flipEndian(&(col.colour_1), sizeof(uint16));
-                                    unpackDXTColour(sourceFormat, col, tempColours);
-
-                                    // write 4x4 block to uncompressed version
-                                    for (size_t by = 0; by < sy; ++by)
-                                    {
-                                        for (size_t bx = 0; bx < sx; ++bx)
-                                        {
-                                            PixelUtil::packColour(tempColours[by*4+bx],
-                                                imgData->format, destPtr);
-                                            destPtr = static_cast<void*>(
-                                                static_cast<uchar*>(destPtr) + destBpp);
-                                        }
-                                        // advance to next row
-                                        destPtr = static_cast<void*>(
-                                            static_cast<uchar*>(destPtr) + destPitchMinus4);
-                                    }
-                                    // next block. Our dest pointer is 4 lines down
-                                    // from where it started
-                                    if (x + 4 >= width)
-                                    {
-                                        // Jump back to the start of the line
-                                        destPtr = static_cast<void*>(
-                                            static_cast<uchar*>(destPtr) - destPitchMinus4);
-                                    }
-                                    else
-                                    {
-                                        // Jump back up 4 rows and 4 pixels to the
-                                        // right to be at the next block to the right
-                                        destPtr = static_cast<void*>(
-                                            static_cast<uchar*>(destPtr) - dstPitch * sy + destBpp * sx);
-
-                                    }
-
-                                }
-
-                            }
-                        }
 
-                    }
-                    else
-                    {
-                        // load directly
-                        // DDS format lies! sizeOrPitch is not always set for DXT!!
-                        size_t dxtSize = PixelUtil::getMemorySize(width, height, depth, imgData->format);
-                        stream->read(destPtr, dxtSize);
-                        destPtr = static_cast<void*>(static_cast<uchar*>(destPtr) + dxtSize);
-                    }
-
-                }
+                // Read the whole level, then unpack its rows of blocks in
+                // parallel since they do not depend on each other
+                size_t dxtSize = PixelUtil::getMemorySize(width, height, depth, sourceFormat);
+                MemoryDataStream compressed(dxtSize);
+                stream->read(compressed.getPtr(), dxtSize);
+
+                DXTUnpackTask task(this, sourceFormat, compressed.getPtr(), imgData->format,
+                    static_cast<uchar*>(destPtr), width, height);
+                const size_t numRows = ((height + 3) / 4) * depth;
+                Root* root = Root::getSingletonPtr();
+                WorkQueue* queue = root ? root->getWorkQueue() : 0;
+                if (queue)
+                    queue->parallelFor(numRows, 4, &task);
                 else
-                {
-                    // Note: We assume the source and destination have the same pitch
-                    for (size_t z = 0; z < depth; ++z)
-                    {
-                        for (size_t y = 0; y < height; ++y)
-                        {
-                            stream->read(destPtr, dstPitch);
-                            destPtr = static_cast<void*>(static_cast<uchar*>(destPtr) + dstPitch);
-                        }
-                    }
-                }
+                    task.execute(0, numRows);
+
+                destPtr = static_cast<void*>(
+                    static_cast<uchar*>(destPtr) + dstPitch * height * depth);
 
                 /// Next mip
                 if(width!=1) width /= 2;
@@ -28,8 +28,105 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 #include "OgreSceneManager.h"
 #include "OgreRoot.h"
+#include "OgreOptimisedUtil.h"
 
 namespace Ogre {
+    namespace {
+        /** Movable objects waiting to be tested against a query volume.
+        @remarks
+            The bounds are kept in the layout OptimisedUtil tests, and the
+            objects are reported in the order they were added so listeners see
+            the same sequence as with one test per object.
+        */
+        struct MovableBlock
+        {
+            enum { SIZE = 64 };
+
+            MovableObject* objects[SIZE];
+            float centreX[SIZE], centreY[SIZE], centreZ[SIZE];
+            /// Half sizes of boxes, spheres only use extentX as their radius
+            float extentX[SIZE], extentY[SIZE], extentZ[SIZE];
+            float distances[SIZE];
+            uint8 results[SIZE];
+            size_t count;
+
+            MovableBlock() : count(0) {}
+
+            bool isFull(void) const { return count == SIZE; }
+
+            void addBox(MovableObject* obj, const AxisAlignedBox& box)
+            {
+                Vector3 centre = box.getCenter();
+                Vector3 halfSize = box.getHalfSize();
+                objects[count] = obj;
+                centreX[count] = centre.x;
+                centreY[count] = centre.y;
+                centreZ[count] = centre.z;
+                extentX[count] = halfSize.x;
+                extentY[count] = halfSize.y;
+                extentZ[count] = halfSize.z;
+                ++count;
+            }
+
+            void addSphere(MovableObject* obj, const Vector3& centre, Real radius)
+            {
+                objects[count] = obj;
+                centreX[count] = centre.x;
+                centreY[count] = centre.y;
+                centreZ[count] = centre.z;
+                extentX[count] = radius;
+                ++count;
+            }
+
+            /// Report the objects which passed, returns false if the listener stopped the query
+            bool report(SceneQueryListener* listener)
+            {
+                size_t n = count;
+                count = 0;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    if (results[i] && !listener->queryResult(objects[i]))
+                        return false;
+                }
+                return true;
+            }
+
+            /// Report the objects which were hit, returns false if the listener stopped the query
+            bool report(RaySceneQueryListener* listener)
+            {
+                size_t n = count;
+                count = 0;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    if (results[i] && !listener->queryResult(objects[i], distances[i]))
+                        return false;
+                }
+                return true;
+            }
+
+            bool testAndReport(const AxisAlignedBox& box, SceneQueryListener* listener)
+            {
+                OptimisedUtil::getImplementation()->intersectBoxes(box,
+                    centreX, centreY, centreZ, extentX, extentY, extentZ, results, count);
+                return report(listener);
+            }
+
+            bool testAndReport(const Ray& ray, RaySceneQueryListener* listener)
+            {
+                OptimisedUtil::getImplementation()->intersectBoxes(ray,
+                    centreX, centreY, centreZ, extentX, extentY, extentZ,
+                    distances, results, count);
+                return report(listener);
+            }
+
+            bool testAndReport(const Sphere& sphere, SceneQueryListener* listener)
+            {
+                OptimisedUtil::getImplementation()->intersectSpheres(sphere,
+                    centreX, centreY, centreZ, extentX, results, count);
+                return report(listener);
+            }
+        };
+    }
     //---------------------------------------------------------------------
     DefaultIntersectionSceneQuery::DefaultIntersectionSceneQuery(SceneManager* creator)
     : IntersectionSceneQuery(creator)
@@ -134,6 +231,10 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultAxisAlignedBoxSceneQuery::execute(SceneQueryListener* listener)
     {
+        // Finite boxes are tested a block at a time
+        const bool batch = mAABB.isFinite();
+        MovableBlock block;
+
         // Iterate over all movable types
         Root::MovableObjectFactoryIterator factIt = 
             Root::getSingleton().getMovableObjectFactoryIterator();
@@ -149,14 +250,24 @@ namespace Ogre {
                 if (!(a->getTypeFlags() & mQueryTypeMask))
                     break;
 
-                if ((a->getQueryFlags() & mQueryMask) && 
-                    a->isInScene() &&
-                    mAABB.intersects(a->getWorldBoundingBox()))
+                if (!(a->getQueryFlags() & mQueryMask) || !a->isInScene())
+                    continue;
+
+                const AxisAlignedBox& box = a->getWorldBoundingBox();
+                if (batch && box.isFinite())
                 {
+                    block.addBox(a, box);
+                    if (block.isFull() && !block.testAndReport(mAABB, listener)) return;
+                }
+                else if (mAABB.intersects(box))
+                {
+                    // Keep the results in order
+                    if (!block.testAndReport(mAABB, listener)) return;
                     if (!listener->queryResult(a)) return;
                 }
             }
         }
+        block.testAndReport(mAABB, listener);
     }
     //---------------------------------------------------------------------
     DefaultRaySceneQuery::
@@ -177,6 +288,7 @@ namespace Ogre {
         // requested; smarter scene manager queries can utilise the paritioning 
         // of the scene in order to reduce the number of intersection tests 
         // required to fulfil the query
+        MovableBlock block;
 
         // Iterate over all movable types
         Root::MovableObjectFactoryIterator factIt = 
@@ -196,17 +308,23 @@ namespace Ogre {
                 if( (a->getQueryFlags() & mQueryMask) &&
                     a->isInScene())
                 {
-                    // Do ray / box test
-                    std::pair<bool, Real> result =
-                        mRay.intersects(a->getWorldBoundingBox());
-
-                    if (result.first)
+                    // Do ray / box test, finite boxes a block at a time
+                    const AxisAlignedBox& box = a->getWorldBoundingBox();
+                    if (box.isFinite())
                     {
-                        if (!listener->queryResult(a, result.second)) return;
+                        block.addBox(a, box);
+                        if (block.isFull() && !block.testAndReport(mRay, listener)) return;
+                    }
+                    else if (box.isInfinite())
+                    {
+                        // Keep the results in order
+                        if (!block.testAndReport(mRay, listener)) return;
+                        if (!listener->queryResult(a, 0)) return;
                     }
                 }
             }
         }
+        block.testAndReport(mRay, listener);
 
     }
     //---------------------------------------------------------------------
@@ -223,7 +341,7 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultSphereSceneQuery::execute(SceneQueryListener* listener)
     {
-        Sphere testSphere;
+        MovableBlock block;
 
         // Iterate over all movable types
         Root::MovableObjectFactoryIterator factIt = 
@@ -244,15 +362,13 @@ namespace Ogre {
                     !(a->getQueryFlags() & mQueryMask))
                     continue;
 
-                // Do sphere / sphere test
-                testSphere.setCenter(a->getParentNode()->_getDerivedPosition());
-                testSphere.setRadius(a->getBoundingRadius());
-                if (mSphere.intersects(testSphere))
-                {
-                    if (!listener->queryResult(a)) return;
-                }
+                // Do sphere / sphere test, a block at a time
+                block.addSphere(a, a->getParentNode()->_getDerivedPosition(),
+                    a->getBoundingRadius());
+                if (block.isFull() && !block.testAndReport(mSphere, listener)) return;
             }
         }
+        block.testAndReport(mSphere, listener);
     }
     //---------------------------------------------------------------------
     DefaultPlaneBoundedVolumeListSceneQuery::
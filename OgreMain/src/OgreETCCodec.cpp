@@ -193,7 +193,9 @@ namespace Ogre {
             if (PKM_MAGIC == fileType)
                 return String("pkm");
         
-            if (KTX_MAGIC == fileType)
+            // KTX 2 files start the same, check the version too
+            if (KTX_MAGIC == fileType &&
+                (maxbytes < 7 || memcmp(magicNumberPtr + 4, " 11", 3) == 0))
                 return String("ktx");
         }
 
@@ -263,18 +265,9 @@ namespace Ogre {
         // Calculate total size from number of mipmaps, faces and size
         imgData->size = (paddedWidth * paddedHeight) >> 1;
 
-        // Bind output buffer
-        MemoryDataStreamPtr output;
-        output.bind(OGRE_NEW MemoryDataStream(imgData->size));
-
         // Now deal with the data
-        void *destPtr = output->getPtr();
-        stream->read(destPtr, imgData->size);
-        destPtr = static_cast<void*>(static_cast<uchar*>(destPtr));
-        
-        DecodeResult ret;
-        ret.first = output;
-        ret.second = CodecDataPtr(imgData);
+        result.first = readPixelData(stream, imgData->size, imgData);
+        result.second = CodecDataPtr(imgData);
 
         return true;
     }
@@ -327,8 +320,14 @@ namespace Ogre {
         case 33779: // DXT 5
             imgData->format = PF_DXT5;
             break;
-        default:        
-            imgData->format = PF_ETC1_RGB8;
+        default:
+            // GL_COMPRESSED_RGBA_ASTC_4x4_KHR to GL_COMPRESSED_RGBA_ASTC_12x12_KHR,
+            // in the order of the ASTC pixel formats
+            if (header.glInternalFormat >= 0x93B0 && header.glInternalFormat <= 0x93BD)
+                imgData->format = static_cast<PixelFormat>(
+                    PF_ASTC_RGBA_4X4_LDR + (header.glInternalFormat - 0x93B0));
+            else
+                imgData->format = PF_ETC1_RGB8;
             break;
         }
         
@@ -343,6 +342,16 @@ namespace Ogre {
 
         stream->skip(header.bytesOfKeyValueData);
 
+        if (header.numberOfMipmapLevels <= 1)
+        {
+            // A single level follows its size, take it as it is
+            uint32 imageSize = 0;
+            stream->read(&imageSize, sizeof(uint32));
+            result.first = readPixelData(stream, imgData->size, imgData);
+            result.second = CodecDataPtr(imgData);
+            return true;
+        }
+
         // Bind output buffer
         MemoryDataStreamPtr output;
         output.bind(OGRE_NEW MemoryDataStream(imgData->size));
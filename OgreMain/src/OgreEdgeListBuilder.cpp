@@ -30,6 +30,8 @@ THE SOFTWARE.
 #include "OgreVertexIndexData.h"
 #include "OgreException.h"
 #include "OgreOptimisedUtil.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
 
 namespace Ogre {
 
@@ -75,6 +77,99 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    namespace
+    {
+        /// Triangles processed at once by the tasks below
+        const size_t TRIANGLE_GRAIN_SIZE = 4096;
+
+        /// Runs a task over [0, count), spread over the work queue if there is one
+        void runTriangleTask(size_t count, WorkQueue::ParallelTask* task)
+        {
+            Root* root = Root::getSingletonPtr();
+            if (count > TRIANGLE_GRAIN_SIZE && root && root->getWorkQueue())
+            {
+                // Make sure the implementation is chosen before the threads use it
+                OptimisedUtil::getImplementation();
+                root->getWorkQueue()->parallelFor(count, TRIANGLE_GRAIN_SIZE, task);
+            }
+            else if (count)
+            {
+                task->execute(0, count);
+            }
+        }
+
+        /// Reads the positions of a range of triangles and calculates their face normals
+        class TriangleGatherTask : public WorkQueue::ParallelTask
+        {
+        public:
+            TriangleGatherTask(const unsigned int* indexes, const unsigned char* pBaseVertex,
+                size_t vertexSize, const VertexElement* posElem, Vector3* positions, Vector4* normals)
+                : mIndexes(indexes), mBaseVertex(pBaseVertex), mVertexSize(vertexSize),
+                mPosElem(posElem), mPositions(positions), mNormals(normals) {}
+
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t t = begin; t < end; ++t)
+                {
+                    Vector3* v = mPositions + t * 3;
+                    for (size_t i = 0; i < 3; ++i)
+                    {
+                        const unsigned char* pVertex = mBaseVertex + mIndexes[t * 3 + i] * mVertexSize;
+                        float* pFloat;
+                        mPosElem->baseVertexPointerToElement(const_cast<unsigned char*>(pVertex), &pFloat);
+                        v[i].x = pFloat[0];
+                        v[i].y = pFloat[1];
+                        v[i].z = pFloat[2];
+                    }
+                    mNormals[t] = Math::calculateFaceNormalWithoutNormalize(v[0], v[1], v[2]);
+                }
+            }
+        private:
+            const unsigned int* mIndexes;
+            const unsigned char* mBaseVertex;
+            size_t mVertexSize;
+            const VertexElement* mPosElem;
+            Vector3* mPositions;
+            Vector4* mNormals;
+        };
+
+        /// Determines which of a range of triangles face a light
+        class LightFacingTask : public WorkQueue::ParallelTask
+        {
+        public:
+            LightFacingTask(const Vector4& lightPos, const Vector4* faceNormals, char* lightFacings)
+                : mLightPos(lightPos), mFaceNormals(faceNormals), mLightFacings(lightFacings) {}
+
+            void execute(size_t begin, size_t end)
+            {
+                OptimisedUtil::getImplementation()->calculateLightFacing(
+                    mLightPos, mFaceNormals + begin, mLightFacings + begin, end - begin);
+            }
+        private:
+            Vector4 mLightPos;
+            const Vector4* mFaceNormals;
+            char* mLightFacings;
+        };
+
+        /// Calculates the face normals of a range of triangles
+        class FaceNormalsTask : public WorkQueue::ParallelTask
+        {
+        public:
+            FaceNormalsTask(const float* positions, const EdgeData::Triangle* triangles, Vector4* faceNormals)
+                : mPositions(positions), mTriangles(triangles), mFaceNormals(faceNormals) {}
+
+            void execute(size_t begin, size_t end)
+            {
+                OptimisedUtil::getImplementation()->calculateFaceNormals(
+                    mPositions, mTriangles + begin, mFaceNormals + begin, end - begin);
+            }
+        private:
+            const float* mPositions;
+            const EdgeData::Triangle* mTriangles;
+            Vector4* mFaceNormals;
+        };
+    }
+    //---------------------------------------------------------------------
     EdgeListBuilder::EdgeListBuilder()
         : mEdgeData(0)
     {
@@ -219,7 +314,7 @@ namespace Ogre {
             break;
         case RenderOperation::OT_TRIANGLE_FAN:
         case RenderOperation::OT_TRIANGLE_STRIP:
-            iterations = indexData->indexCount - 2;
+            iterations = indexData->indexCount < 3 ? 0 : indexData->indexCount - 2;
             break;
         default:
             return; // Just in case
@@ -258,26 +353,12 @@ namespace Ogre {
             static_cast<char*>(pIndex) + indexData->indexStart * indexSize);
 #endif
 
-        // Iterate over all the groups of 3 indexes
-        unsigned int index[3];
-        // Get the triangle start, if we have more than one index set then this
-        // will not be zero
-        size_t triangleIndex = mEdgeData->triangles.size();
-        // If it's first time dealing with the edge group, setup triStart for it.
-        // Note that we are assume geometries sorted by vertex set.
-        if (!eg.triCount)
-        {
-            eg.triStart = triangleIndex;
-        }
-        // Pre-reserve memory for less thrashing
-        mEdgeData->triangles.reserve(triangleIndex + iterations);
-        mEdgeData->triangleFaceNormals.reserve(triangleIndex + iterations);
-        for (size_t t = 0; t < iterations; ++t)
+        // Read the indexes of all the triangles first, strips and fans depend
+        // on the triangle before
+        vector<unsigned int>::type triIndexes(iterations * 3);
+        unsigned int* index = iterations ? &triIndexes[0] : 0;
+        for (size_t t = 0; t < iterations; ++t, index += 3)
         {
-            EdgeData::Triangle tri;
-            tri.indexSet = indexSet;
-            tri.vertexSet = vertexSet;
-
             if (opType == RenderOperation::OT_TRIANGLE_LIST || t == 0)
             {
                 // Standard 3-index read for tri list or first tri in strip / fan
@@ -304,30 +385,56 @@ namespace Ogre {
                 // one index and the current one for triangles after the first.
                 // We also make sure that all the triangles are process in the
                 // _anti_ clockwise orientation
-                index[(opType == RenderOperation::OT_TRIANGLE_STRIP) && (t & 1) ? 0 : 1] = index[2];
+                index[0] = index[-3];
+                index[1] = index[-2];
+                index[(opType == RenderOperation::OT_TRIANGLE_STRIP) && (t & 1) ? 0 : 1] = index[-1];
                 // Read for the last tri index
                 if (idx32bit)
                     index[2] = *p32Idx++;
                 else
                     index[2] = *p16Idx++;
             }
+        }
+
+        // Retrieve the vertex positions and calculate the triangle normals (NB
+        // will require recalculation for skeletally animated meshes), which
+        // do not depend on each other
+        vector<Vector3>::type positions(iterations * 3);
+        vector<Vector4>::type normals(iterations);
+        if (iterations)
+        {
+            TriangleGatherTask task(&triIndexes[0], pBaseVertex, vbuf->getVertexSize(),
+                posElem, &positions[0], &normals[0]);
+            runTriangleTask(iterations, &task);
+        }
+
+        // Get the triangle start, if we have more than one index set then this
+        // will not be zero
+        size_t triangleIndex = mEdgeData->triangles.size();
+        // If it's first time dealing with the edge group, setup triStart for it.
+        // Note that we are assume geometries sorted by vertex set.
+        if (!eg.triCount)
+        {
+            eg.triStart = triangleIndex;
+        }
+        // Pre-reserve memory for less thrashing
+        mEdgeData->triangles.reserve(triangleIndex + iterations);
+        mEdgeData->triangleFaceNormals.reserve(triangleIndex + iterations);
+        // Weld and connect in turn, since the common vertices and edges are
+        // numbered in the order they are found
+        for (size_t t = 0; t < iterations; ++t)
+        {
+            EdgeData::Triangle tri;
+            tri.indexSet = indexSet;
+            tri.vertexSet = vertexSet;
 
-            Vector3 v[3];
             for (size_t i = 0; i < 3; ++i)
             {
                 // Populate tri original vertex index
-                tri.vertIndex[i] = index[i];
-
-                // Retrieve the vertex position
-                unsigned char* pVertex = pBaseVertex + (index[i] * vbuf->getVertexSize());
-                float* pFloat;
-                posElem->baseVertexPointerToElement(pVertex, &pFloat);
-                v[i].x = *pFloat++;
-                v[i].y = *pFloat++;
-                v[i].z = *pFloat++;
+                tri.vertIndex[i] = triIndexes[t * 3 + i];
                 // find this vertex in the existing vertex map, or create it
-                tri.sharedVertIndex[i] = 
-                    findOrCreateCommonVertex(v[i], vertexSet, indexSet, index[i]);
+                tri.sharedVertIndex[i] = findOrCreateCommonVertex(
+                    positions[t * 3 + i], vertexSet, indexSet, tri.vertIndex[i]);
             }
 
             // Ignore degenerate triangle
@@ -335,10 +442,7 @@ namespace Ogre {
                 tri.sharedVertIndex[1] != tri.sharedVertIndex[2] &&
                 tri.sharedVertIndex[2] != tri.sharedVertIndex[0])
             {
-                // Calculate triangle normal (NB will require recalculation for 
-                // skeletally animated meshes)
-                mEdgeData->triangleFaceNormals.push_back(
-                    Math::calculateFaceNormalWithoutNormalize(v[0], v[1], v[2]));
+                mEdgeData->triangleFaceNormals.push_back(normals[t]);
                 // Add triangle to list
                 mEdgeData->triangles.push_back(tri);
                 // Connect or create edges from common list
@@ -367,25 +471,41 @@ namespace Ogre {
         size_t vertIndex0, size_t vertIndex1, size_t sharedVertIndex0, 
         size_t sharedVertIndex1)
     {
+        const size_t noEdge = static_cast<size_t>(~0);
         // Find the existing edge (should be reversed order) on shared vertices
         EdgeMap::iterator emi = mEdgeMap.find(std::pair<size_t, size_t>(sharedVertIndex1, sharedVertIndex0));
         if (emi != mEdgeMap.end())
         {
             // The edge already exist, connect it
-            EdgeData::Edge& e = mEdgeData->edgeGroups[emi->second.first].edges[emi->second.second];
+            const OpenEdge& open = mOpenEdges[emi->second.first];
+            EdgeData::Edge& e = mEdgeData->edgeGroups[open.vertexSet].edges[open.edgeIndex];
             // update with second side
             e.triIndex[1] = triangleIndex;
             e.degenerate = false;
 
             // Remove from the edge map, so we never supplied to connect edge again
-            mEdgeMap.erase(emi);
+            if (open.next == noEdge)
+                mEdgeMap.erase(emi);
+            else
+                emi->second.first = open.next;
         }
         else
         {
-            // Not found, create new edge
-            mEdgeMap.insert(EdgeMap::value_type(
+            // Not found, create new edge, after any other open one on the same vertices
+            OpenEdge open;
+            open.vertexSet = vertexSet;
+            open.edgeIndex = mEdgeData->edgeGroups[vertexSet].edges.size();
+            open.next = noEdge;
+            size_t openIndex = mOpenEdges.size();
+            mOpenEdges.push_back(open);
+            std::pair<EdgeMap::iterator, bool> inserted = mEdgeMap.insert(EdgeMap::value_type(
                 std::pair<size_t, size_t>(sharedVertIndex0, sharedVertIndex1),
-                std::pair<size_t, size_t>(vertexSet, mEdgeData->edgeGroups[vertexSet].edges.size())));
+                std::pair<size_t, size_t>(openIndex, openIndex)));
+            if (!inserted.second)
+            {
+                mOpenEdges[inserted.first->second.second].next = openIndex;
+                inserted.first->second.second = openIndex;
+            }
             EdgeData::Edge e;
             e.degenerate = true; // initialise as degenerate
 
@@ -433,11 +553,8 @@ namespace Ogre {
         // Use optimised util to determine if triangle's face normal are light facing
         if(!triangleFaceNormals.empty())
         {
-            OptimisedUtil::getImplementation()->calculateLightFacing(
-                lightPos,
-                &triangleFaceNormals.front(),
-                &triangleLightFacings.front(),
-                triangleLightFacings.size());
+            LightFacingTask task(lightPos, &triangleFaceNormals.front(), &triangleLightFacings.front());
+            runTriangleTask(triangleLightFacings.size(), &task);
         }
     }
     //---------------------------------------------------------------------
@@ -458,11 +575,8 @@ namespace Ogre {
         const EdgeData::EdgeGroup& eg = edgeGroups[vertexSet];
         if (eg.triCount != 0) 
         {
-            OptimisedUtil::getImplementation()->calculateFaceNormals(
-                pVert,
-                &triangles[eg.triStart],
-                &triangleFaceNormals[eg.triStart],
-                eg.triCount);
+            FaceNormalsTask task(pVert, &triangles[eg.triStart], &triangleFaceNormals[eg.triStart]);
+            runTriangleTask(eg.triCount, &task);
         }
 
         // unlock the buffer
@@ -50,6 +50,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreLodStrategy.h"
 #include "OgreLodListener.h"
 #include "OgreMaterialManager.h"
+#include "OgreMeshBVH.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -77,6 +78,13 @@ namespace Ogre {
         mSkipAnimStateUpdates(false),
         mAlwaysUpdateMainSkeleton(false),
           mUpdateBoundingBoxFromSkeleton(false),
+        mDualQuaternionSkinning(false),
+        mClusterCulling(true),
+        mClusterCamera(0),
+        mAnimationLodStrategy(0),
+        mAnimationLodIndex(0),
+        mFreezeLastAnimationLod(false),
+        mAnimationLodFrozen(false),
         mMeshLodIndex(0),
         mMeshLodFactorTransformed(1.0f),
         mMinMeshLodIndex(99),
@@ -85,11 +93,19 @@ namespace Ogre {
         mMaterialLodFactorTransformed(1.0f),
         mMinMaterialLodIndex(99),
         mMaxMaterialLodIndex(0),        // Backwards, remember low value = high detail
+        mMeshLodHysteresis(0),
+        mLodCamera(0),
+        mLodFrame(0),
+        mLodTransformVersion(0),
         mSkeletonInstance(0),
         mInitialised(false),
         mLastParentXform(Matrix4::ZERO),
+        mChildTransformsXform(Matrix4::ZERO),
+        mFrameChildTransformsUpdated(std::numeric_limits<unsigned long>::max()),
         mMeshStateCount(0),
-        mFullBoundingBox()
+        mFullBoundingBox(),
+        mBVH(0),
+        mBVHFrame(0)
     {
     }
     //-----------------------------------------------------------------------
@@ -116,6 +132,13 @@ namespace Ogre {
         mSkipAnimStateUpdates(false),
         mAlwaysUpdateMainSkeleton(false),
         mUpdateBoundingBoxFromSkeleton(false),
+        mDualQuaternionSkinning(false),
+        mClusterCulling(true),
+        mClusterCamera(0),
+        mAnimationLodStrategy(0),
+        mAnimationLodIndex(0),
+        mFreezeLastAnimationLod(false),
+        mAnimationLodFrozen(false),
         mMeshLodIndex(0),
         mMeshLodFactorTransformed(1.0f),
         mMinMeshLodIndex(99),
@@ -124,11 +147,19 @@ namespace Ogre {
         mMaterialLodFactorTransformed(1.0f),
         mMinMaterialLodIndex(99),
         mMaxMaterialLodIndex(0),        // Backwards, remember low value = high detail
+        mMeshLodHysteresis(0),
+        mLodCamera(0),
+        mLodFrame(0),
+        mLodTransformVersion(0),
         mSkeletonInstance(0),
         mInitialised(false),
         mLastParentXform(Matrix4::ZERO),
+        mChildTransformsXform(Matrix4::ZERO),
+        mFrameChildTransformsUpdated(std::numeric_limits<unsigned long>::max()),
         mMeshStateCount(0),
-        mFullBoundingBox()
+        mFullBoundingBox(),
+        mBVH(0),
+        mBVHFrame(0)
     {
         _initialise();
     }
@@ -175,6 +206,30 @@ namespace Ogre {
             {
                 mMesh->_computeBoneBoundingRadius();
             }
+
+            // record which bones have vertices weighted to them, for the bounding box
+            vector<bool>::type boneHasVerts(mSkeletonInstance->getNumBones(), false);
+            for (size_t iBlend = 0; iBlend < mMesh->sharedBlendIndexToBoneIndexMap.size(); ++iBlend)
+            {
+                boneHasVerts[mMesh->sharedBlendIndexToBoneIndexMap[iBlend]] = true;
+            }
+            for (uint16 iSubMesh = 0; iSubMesh < mMesh->getNumSubMeshes(); ++iSubMesh)
+            {
+                SubMesh* submesh = mMesh->getSubMesh(iSubMesh);
+                if (!submesh->useSharedVertices)
+                {
+                    for (size_t iBlend = 0; iBlend < submesh->blendIndexToBoneIndexMap.size(); ++iBlend)
+                    {
+                        boneHasVerts[submesh->blendIndexToBoneIndexMap[iBlend]] = true;
+                    }
+                }
+            }
+            mWeightedBones.clear();
+            for (ushort iBone = 0; iBone < boneHasVerts.size(); ++iBone)
+            {
+                if (boneHasVerts[iBone])
+                    mWeightedBones.push_back(iBone);
+            }
         }
 
         // Build main subentity list
@@ -253,6 +308,7 @@ namespace Ogre {
             *i = 0;
         }
         mSubEntityList.clear();
+        mWeightedBones.clear();
 
 #if !OGRE_NO_MESHLOD
         // Delete LOD entities
@@ -314,12 +370,19 @@ namespace Ogre {
         OGRE_DELETE mSkelAnimVertexData; mSkelAnimVertexData = 0;
         OGRE_DELETE mSoftwareVertexAnimVertexData; mSoftwareVertexAnimVertexData = 0;
         OGRE_DELETE mHardwareVertexAnimVertexData; mHardwareVertexAnimVertexData = 0;
+        OGRE_DELETE mBVH; mBVH = 0;
 
         mInitialised = false;
     }
     //-----------------------------------------------------------------------
     Entity::~Entity()
     {
+        if (mManager)
+        {
+            mManager->_notifySkeletonPoseOwnerDestroyed(this);
+            if (mUpdateBoundingBoxFromSkeleton)
+                mManager->_notifySkeletonBoundsEntity(this, false);
+        }
         _deinitialise();
         // Unregister our listener
         mMesh->removeListener(this);
@@ -418,83 +481,134 @@ namespace Ogre {
     void Entity::_notifyCurrentCamera(Camera* cam)
     {
         MovableObject::_notifyCurrentCamera(cam);
+        mClusterCamera = cam;
 
         // Calculate the LOD
         if (mParentNode)
         {
 #if !OGRE_NO_MESHLOD
+            // The LOD only depends on the LOD camera, so it may be shared with the
+            // cameras using the same one this frame (shadow cameras)
+            const Camera* lodCamera = cam->getLodCamera();
+            unsigned long frame = Root::getSingleton().getNextFrameNumber();
+            mParentNode->_getFullTransform();
+            unsigned long transformVersion = mParentNode->_getTransformVersion();
+            bool computeLod = !cam->getSceneManager()->getShareLodAcrossCameras() ||
+                lodCamera != mLodCamera || frame != mLodFrame || transformVersion != mLodTransformVersion;
+            mLodCamera = lodCamera;
+            mLodFrame = frame;
+            mLodTransformVersion = transformVersion;
+
             // Get mesh lod strategy
             const LodStrategy *meshStrategy = mMesh->getLodStrategy();
-            // Get the appropriate LOD value
-            Real lodValue = meshStrategy->getValue(this, cam);
-            // Bias the LOD value
-            Real biasedMeshLodValue = lodValue * mMeshLodFactorTransformed;
-
-
-            // Get the index at this biased depth
-            ushort newMeshLodIndex = mMesh->getLodIndex(biasedMeshLodValue);
-            // Apply maximum detail restriction (remember lower = higher detail)
-            newMeshLodIndex = std::max<ushort>(mMaxMeshLodIndex, newMeshLodIndex);
-            // Apply minimum detail restriction (remember higher = lower detail)
-            newMeshLodIndex = std::min<ushort>(mMinMeshLodIndex, newMeshLodIndex);
-
-            // Construct event object
-            EntityMeshLodChangedEvent evt;
-            evt.entity = this;
-            evt.camera = cam;
-            evt.lodValue = biasedMeshLodValue;
-            evt.previousLodIndex = mMeshLodIndex;
-            evt.newLodIndex = newMeshLodIndex;
-
-            // Notify LOD event listeners
-            cam->getSceneManager()->_notifyEntityMeshLodChanged(evt);
-
-            // Change LOD index
-            mMeshLodIndex = evt.newLodIndex;
-
-            // Now do material LOD
-            lodValue *= mMaterialLodFactorTransformed;
-#endif
-
-
-            SubEntityList::iterator i, iend;
-            iend = mSubEntityList.end();
-            for (i = mSubEntityList.begin(); i != iend; ++i)
+            Real lodValue = 0;
+            if (computeLod)
             {
-#if !OGRE_NO_MESHLOD
-                // Get sub-entity material
-                const MaterialPtr& material = (*i)->getMaterial();
-                
-                // Get material LOD strategy
-                const LodStrategy *materialStrategy = material->getLodStrategy();
-                
-                // Recalculate LOD value if strategies do not match
-                Real biasedMaterialLodValue;
-                if (meshStrategy == materialStrategy)
-                    biasedMaterialLodValue = lodValue;
-                else
-                    biasedMaterialLodValue = materialStrategy->getValue(this, cam) * materialStrategy->transformBias(mMaterialLodFactor);
+                // Get the appropriate LOD value
+                lodValue = meshStrategy->getValue(this, cam);
+                // Bias the LOD value
+                Real biasedMeshLodValue = lodValue * mMeshLodFactorTransformed;
+
 
                 // Get the index at this biased depth
-                unsigned short idx = material->getLodIndex(biasedMaterialLodValue);
+                ushort newMeshLodIndex = mMesh->getLodIndex(biasedMeshLodValue);
+                if (mMeshLodHysteresis > 0 && newMeshLodIndex != mMeshLodIndex && mMesh->getNumLodLevels() > 1)
+                {
+                    // Only change if the value is still past the threshold when pulled back
+                    // towards the current LOD, values grow with the index for distance strategies
+                    bool ascending = mMesh->getLodLevel(mMesh->getNumLodLevels() - 1).value >
+                        mMesh->getLodLevel(0).value;
+                    bool lowerDetail = newMeshLodIndex > mMeshLodIndex;
+                    Real pulledBack = biasedMeshLodValue *
+                        (lowerDetail == ascending ? 1 - mMeshLodHysteresis : 1 + mMeshLodHysteresis);
+                    ushort pulledBackIndex = mMesh->getLodIndex(pulledBack);
+                    if (lowerDetail ? pulledBackIndex > mMeshLodIndex : pulledBackIndex < mMeshLodIndex)
+                        newMeshLodIndex = pulledBackIndex;
+                    else
+                        newMeshLodIndex = mMeshLodIndex;
+                }
                 // Apply maximum detail restriction (remember lower = higher detail)
-                idx = std::max(mMaxMaterialLodIndex, idx);
+                newMeshLodIndex = std::max<ushort>(mMaxMeshLodIndex, newMeshLodIndex);
                 // Apply minimum detail restriction (remember higher = lower detail)
-                idx = std::min(mMinMaterialLodIndex, idx);
+                newMeshLodIndex = std::min<ushort>(mMinMeshLodIndex, newMeshLodIndex);
 
                 // Construct event object
-                EntityMaterialLodChangedEvent subEntEvt;
-                subEntEvt.subEntity = (*i);
-                subEntEvt.camera = cam;
-                subEntEvt.lodValue = biasedMaterialLodValue;
-                subEntEvt.previousLodIndex = (*i)->mMaterialLodIndex;
-                subEntEvt.newLodIndex = idx;
+                EntityMeshLodChangedEvent evt;
+                evt.entity = this;
+                evt.camera = cam;
+                evt.lodValue = biasedMeshLodValue;
+                evt.previousLodIndex = mMeshLodIndex;
+                evt.newLodIndex = newMeshLodIndex;
 
                 // Notify LOD event listeners
-                cam->getSceneManager()->_notifyEntityMaterialLodChanged(subEntEvt);
+                cam->getSceneManager()->_notifyEntityMeshLodChanged(evt);
 
                 // Change LOD index
-                (*i)->mMaterialLodIndex = subEntEvt.newLodIndex;
+                mMeshLodIndex = evt.newLodIndex;
+
+                // Animation LOD, on the same value as the mesh LOD
+                if (!mAnimationLodUserValues.empty())
+                {
+                    if (mAnimationLodStrategy != meshStrategy)
+                    {
+                        mAnimationLodStrategy = meshStrategy;
+                        mAnimationLodValues.clear();
+                        mAnimationLodValues.push_back(meshStrategy->getBaseValue());
+                        for (size_t l = 0; l < mAnimationLodUserValues.size(); ++l)
+                            mAnimationLodValues.push_back(meshStrategy->transformUserValue(mAnimationLodUserValues[l]));
+                    }
+                    mAnimationLodIndex = meshStrategy->getIndex(biasedMeshLodValue, mAnimationLodValues);
+                    mAnimationLodFrozen = mFreezeLastAnimationLod &&
+                        mAnimationLodIndex == mAnimationLodUserValues.size();
+                }
+
+                // Now do material LOD
+                lodValue *= mMaterialLodFactorTransformed;
+            }
+#endif
+
+
+            SubEntityList::iterator i, iend;
+            iend = mSubEntityList.end();
+            for (i = mSubEntityList.begin(); i != iend; ++i)
+            {
+#if !OGRE_NO_MESHLOD
+                if (computeLod)
+                {
+                    // Get sub-entity material
+                    const MaterialPtr& material = (*i)->getMaterial();
+                
+                    // Get material LOD strategy
+                    const LodStrategy *materialStrategy = material->getLodStrategy();
+                
+                    // Recalculate LOD value if strategies do not match
+                    Real biasedMaterialLodValue;
+                    if (meshStrategy == materialStrategy)
+                        biasedMaterialLodValue = lodValue;
+                    else
+                        biasedMaterialLodValue = materialStrategy->getValue(this, cam) * materialStrategy->transformBias(mMaterialLodFactor);
+
+                    // Get the index at this biased depth
+                    unsigned short idx = material->getLodIndex(biasedMaterialLodValue);
+                    // Apply maximum detail restriction (remember lower = higher detail)
+                    idx = std::max(mMaxMaterialLodIndex, idx);
+                    // Apply minimum detail restriction (remember higher = lower detail)
+                    idx = std::min(mMinMaterialLodIndex, idx);
+
+                    // Construct event object
+                    EntityMaterialLodChangedEvent subEntEvt;
+                    subEntEvt.subEntity = (*i);
+                    subEntEvt.camera = cam;
+                    subEntEvt.lodValue = biasedMaterialLodValue;
+                    subEntEvt.previousLodIndex = (*i)->mMaterialLodIndex;
+                    subEntEvt.newLodIndex = idx;
+
+                    // Notify LOD event listeners
+                    cam->getSceneManager()->_notifyEntityMaterialLodChanged(subEntEvt);
+
+                    // Change LOD index
+                    (*i)->mMaterialLodIndex = subEntEvt.newLodIndex;
+                }
 #endif
                 // Also invalidate any camera distance cache
                 (*i)->_invalidateCameraCache ();
@@ -511,8 +625,35 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void Entity::setAnimationLodLevels(const vector<Real>::type& lodValues, bool freezeLastLevel)
+    {
+        mAnimationLodUserValues = lodValues;
+        mFreezeLastAnimationLod = freezeLastLevel;
+        // Transformed by the mesh LOD strategy on the next LOD update
+        mAnimationLodStrategy = 0;
+        mAnimationLodIndex = 0;
+        mAnimationLodFrozen = false;
+    }
+    //-----------------------------------------------------------------------
+    bool Entity::isAnimationLodSkipped(void) const
+    {
+        // Always evaluate until there is a result to reuse
+        if (!mAnimationLodIndex || mFrameAnimationLastUpdated == std::numeric_limits<unsigned long>::max())
+            return false;
+
+        if (mAnimationLodFrozen)
+            return true;
+
+        // Spread entities over the frames by their address
+        unsigned long interval = 1ul << std::min<ushort>(mAnimationLodIndex, 16);
+        unsigned long phase = static_cast<unsigned long>(reinterpret_cast<size_t>(this) / sizeof(Entity));
+        return ((Root::getSingleton().getNextFrameNumber() + phase) & (interval - 1)) != 0;
+    }
+    //-----------------------------------------------------------------------
     void Entity::setUpdateBoundingBoxFromSkeleton(bool update)
     {
+        if (mManager && update != mUpdateBoundingBoxFromSkeleton)
+            mManager->_notifySkeletonBoundsEntity(this, update);
         mUpdateBoundingBoxFromSkeleton = update;
         if (mMesh->isLoaded() && mMesh->getBoneBoundingRadius() == Real(0))
         {
@@ -532,48 +673,17 @@ namespace Ogre {
                 AxisAlignedBox bbox;
                 bbox.setNull();
                 Real maxScale = Real(0);
-                bool boneHasVerts[ OGRE_MAX_NUM_BONES ];
-                uint16 numBones = mSkeletonInstance->getNumBones();
-                for (size_t iBone = 0; iBone < numBones; ++iBone)
+                // for each bone that has vertices weighted to it, found by _initialise
+                for (size_t i = 0; i < mWeightedBones.size(); ++i)
                 {
-                    boneHasVerts[ iBone ] = false;
-                }
-                // for each bone that has vertices weighted to it,
-                for (size_t iBlend = 0; iBlend < mMesh->sharedBlendIndexToBoneIndexMap.size(); ++iBlend)
-                {
-                    // record which bones have vertices assigned
-                    size_t iBone = mMesh->sharedBlendIndexToBoneIndexMap[ iBlend ];
-                    boneHasVerts[ iBone ] = true;
-                }
-                // for each submesh,
-                for (uint16 iSubMesh = 0; iSubMesh < mMesh->getNumSubMeshes(); ++iSubMesh)
-                {
-                    SubMesh* submesh = mMesh->getSubMesh( iSubMesh );
-                    // if the submesh has own vertices,
-                    if ( ! submesh->useSharedVertices )
+                    const Bone* bone = mSkeletonInstance->getBone( mWeightedBones[i] );
+                    Vector3 scaleVec = bone->_getDerivedScale();
+                    Real scale = std::max( std::max( Math::Abs(scaleVec.x), Math::Abs(scaleVec.y)), Math::Abs(scaleVec.z) );
+                    maxScale = std::max( maxScale, scale );
+                    // only include bones that aren't scaled to zero
+                    if (scale > Real(0))
                     {
-                        // record which bones have vertices assigned
-                        for (size_t iBlend = 0; iBlend < submesh->blendIndexToBoneIndexMap.size(); ++iBlend)
-                        {
-                            size_t iBone = submesh->blendIndexToBoneIndexMap[ iBlend ];
-                            boneHasVerts[ iBone ] = true;
-                        }
-                    }
-                }
-                // for each bone that has vertices weighted to it,
-                for (uint16 iBone = 0; iBone < numBones; ++iBone)
-                {
-                    if ( boneHasVerts[ iBone ] )
-                    {
-                        const Bone* bone = mSkeletonInstance->getBone( iBone );
-                        Vector3 scaleVec = bone->_getDerivedScale();
-                        Real scale = std::max( std::max( Math::Abs(scaleVec.x), Math::Abs(scaleVec.y)), Math::Abs(scaleVec.z) );
-                        maxScale = std::max( maxScale, scale );
-                        // only include bones that aren't scaled to zero
-                        if (scale > Real(0))
-                        {
-                            bbox.merge( bone->_getDerivedPosition() );
-                        }
+                        bbox.merge( bone->_getDerivedPosition() );
                     }
                 }
                 // unless all bones were scaled to zero,
@@ -695,9 +805,20 @@ namespace Ogre {
                         mAnimationState->copyMatchingState(targetState);
                 }
             }
+            // The LOD entity animates at the rate of this one
+            displayEntity->mAnimationLodIndex = mAnimationLodIndex;
+            displayEntity->mAnimationLodFrozen = mAnimationLodFrozen;
         }
 #endif
 
+        // Triangles of animated entities move, so their clusters can't be culled,
+        // and manual LOD entities are not attached to our node
+        const bool cullClusters = mClusterCulling && mClusterCamera && mParentNode &&
+            displayEntity == this && !hasSkeleton() && !hasVertexAnimation();
+        // Shadow casters may be drawn from behind
+        const bool cullBackFacing = mManager &&
+            mManager->_getCurrentRenderStage() != SceneManager::IRS_RENDER_TO_TEXTURE;
+
         // Add each visible SubEntity to the queue
         SubEntityList::iterator i, iend;
         iend = displayEntity->mSubEntityList.end();
@@ -705,6 +826,11 @@ namespace Ogre {
         {
             if((*i)->isVisible())
             {
+                if (!cullClusters)
+                    (*i)->_resetClusters();
+                else if (!(*i)->_cullClusters(mClusterCamera, cullBackFacing))
+                    continue;
+
                 // Order: first use subentity queue settings, if available
                 //        if not then use entity queue settings, if available
                 //        finally fall back on default queue settings
@@ -894,7 +1020,8 @@ namespace Ogre {
         bool blendNormals = !hwAnimation || forcedNormals;
         // Animation dirty if animation state modified or manual bones modified
         bool animationDirty =
-            (mFrameAnimationLastUpdated != mAnimationState->getDirtyFrameNumber()) ||
+            (mFrameAnimationLastUpdated != mAnimationState->getDirtyFrameNumber() &&
+             !isAnimationLodSkipped()) ||
             (hasSkeleton() && getSkeleton()->getManualBonesDirty());
         
         //update the current hardware animation state
@@ -951,6 +1078,17 @@ namespace Ogre {
                 if (softwareAnimation)
                 {
                     const Matrix4* blendMatrices[256];
+                    const DualQuaternion* blendDualQuaternions[256];
+
+                    if (mDualQuaternionSkinning)
+                    {
+                        // Convert each bone once rather than once per vertex
+                        mBoneDualQuaternions.resize(mNumBoneMatrices);
+                        for (unsigned short b = 0; b < mNumBoneMatrices; ++b)
+                        {
+                            mBoneDualQuaternions[b].fromTransformationMatrix(mBoneMatrices[b]);
+                        }
+                    }
 
                     // Ok, we need to do a software blend
                     // Firstly, check out working vertex buffers
@@ -963,16 +1101,27 @@ namespace Ogre {
                         mTempSkelAnimInfo.checkoutTempCopies(true, blendNormals);
                         mTempSkelAnimInfo.bindTempCopies(mSkelAnimVertexData,
                                                          hwAnimation);
-                        // Prepare blend matrices, TODO: Move out of here
-                        Mesh::prepareMatricesForVertexBlend(blendMatrices,
-                                                            mBoneMatrices, mMesh->sharedBlendIndexToBoneIndexMap);
-                        // Blend, taking source from either mesh data or morph data
-                        Mesh::softwareVertexBlend(
+                        const VertexData* sourceVertexData =
                             (mMesh->getSharedVertexDataAnimationType() != VAT_NONE) ?
-                            mSoftwareVertexAnimVertexData : mMesh->sharedVertexData,
-                            mSkelAnimVertexData,
-                            blendMatrices, mMesh->sharedBlendIndexToBoneIndexMap.size(),
-                            blendNormals);
+                            mSoftwareVertexAnimVertexData : mMesh->sharedVertexData;
+                        if (mDualQuaternionSkinning)
+                        {
+                            Mesh::prepareDualQuaternionsForVertexBlend(blendDualQuaternions,
+                                                                       &mBoneDualQuaternions[0], mMesh->sharedBlendIndexToBoneIndexMap);
+                            Mesh::softwareVertexBlend(sourceVertexData, mSkelAnimVertexData,
+                                blendDualQuaternions, mMesh->sharedBlendIndexToBoneIndexMap.size(),
+                                blendNormals);
+                        }
+                        else
+                        {
+                            // Prepare blend matrices, TODO: Move out of here
+                            Mesh::prepareMatricesForVertexBlend(blendMatrices,
+                                                                mBoneMatrices, mMesh->sharedBlendIndexToBoneIndexMap);
+                            // Blend, taking source from either mesh data or morph data
+                            Mesh::softwareVertexBlend(sourceVertexData, mSkelAnimVertexData,
+                                blendMatrices, mMesh->sharedBlendIndexToBoneIndexMap.size(),
+                                blendNormals);
+                        }
                     }
                     SubEntityList::iterator i, iend;
                     iend = mSubEntityList.end();
@@ -985,16 +1134,27 @@ namespace Ogre {
                             se->mTempSkelAnimInfo.checkoutTempCopies(true, blendNormals);
                             se->mTempSkelAnimInfo.bindTempCopies(se->mSkelAnimVertexData,
                                                                  hwAnimation);
-                            // Prepare blend matrices, TODO: Move out of here
-                            Mesh::prepareMatricesForVertexBlend(blendMatrices,
-                                                                mBoneMatrices, se->mSubMesh->blendIndexToBoneIndexMap);
-                            // Blend, taking source from either mesh data or morph data
-                            Mesh::softwareVertexBlend(
+                            const VertexData* sourceVertexData =
                                 (se->getSubMesh()->getVertexAnimationType() != VAT_NONE)?
-                                se->mSoftwareVertexAnimVertexData : se->mSubMesh->vertexData,
-                                se->mSkelAnimVertexData,
-                                blendMatrices, se->mSubMesh->blendIndexToBoneIndexMap.size(),
-                                blendNormals);
+                                se->mSoftwareVertexAnimVertexData : se->mSubMesh->vertexData;
+                            if (mDualQuaternionSkinning)
+                            {
+                                Mesh::prepareDualQuaternionsForVertexBlend(blendDualQuaternions,
+                                                                           &mBoneDualQuaternions[0], se->mSubMesh->blendIndexToBoneIndexMap);
+                                Mesh::softwareVertexBlend(sourceVertexData, se->mSkelAnimVertexData,
+                                    blendDualQuaternions, se->mSubMesh->blendIndexToBoneIndexMap.size(),
+                                    blendNormals);
+                            }
+                            else
+                            {
+                                // Prepare blend matrices, TODO: Move out of here
+                                Mesh::prepareMatricesForVertexBlend(blendMatrices,
+                                                                    mBoneMatrices, se->mSubMesh->blendIndexToBoneIndexMap);
+                                // Blend, taking source from either mesh data or morph data
+                                Mesh::softwareVertexBlend(sourceVertexData, se->mSkelAnimVertexData,
+                                    blendMatrices, se->mSubMesh->blendIndexToBoneIndexMap.size(),
+                                    blendNormals);
+                            }
                         }
 
                     }
@@ -1018,12 +1178,17 @@ namespace Ogre {
             // Cache last parent transform for next frame use too.
             mLastParentXform = _getParentNodeFullTransform();
 
-            //--- Update the child object's transforms
-            ChildObjectList::iterator child_itr = mChildObjectList.begin();
-            ChildObjectList::iterator child_itr_end = mChildObjectList.end();
-            for( ; child_itr != child_itr_end; ++child_itr)
+            //--- Update the child object's transforms, unless already done along
+            // with the bone matrices
+            if (mChildTransformsXform != mLastParentXform ||
+                mFrameChildTransformsUpdated != root.getNextFrameNumber())
             {
-                (*child_itr).second->getParentNode()->_update(true, true);
+                ChildObjectList::iterator child_itr = mChildObjectList.begin();
+                ChildObjectList::iterator child_itr_end = mChildObjectList.end();
+                for( ; child_itr != child_itr_end; ++child_itr)
+                {
+                    (*child_itr).second->getParentNode()->_update(true, true);
+                }
             }
 
             // Also calculate bone world matrices, since are used as replacement world matrices,
@@ -1045,6 +1210,7 @@ namespace Ogre {
                     mNumBoneMatrices);
             }
         }
+        mChildTransformsXform = Matrix4::ZERO;
     }
     //-----------------------------------------------------------------------
     ushort Entity::initHardwareAnimationElements(VertexData* vdata,
@@ -1068,6 +1234,30 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void Entity::initHardwarePoseTextureElements(VertexData* vdata, ushort target)
+    {
+        if (!vdata->hwPoseTexture)
+        {
+            HardwareVertexBufferSharedPtr texCoordBuffer = mMesh->_getPoseTextureCoordBuffer(target);
+            if (texCoordBuffer.isNull())
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALID_STATE, "Mesh '" + mMesh->getName() +
+                    "' has no pose texture for its target " + StringConverter::toString(target),
+                    "Entity::initHardwarePoseTextureElements");
+            }
+
+            unsigned short texCoord = 0;
+            while (vdata->vertexDeclaration->findElementBySemantic(VES_TEXTURE_COORDINATES, texCoord))
+                ++texCoord;
+            unsigned short source = vdata->vertexBufferBinding->getNextIndex();
+            vdata->vertexDeclaration->addElement(source, 0, VET_FLOAT2, VES_TEXTURE_COORDINATES, texCoord);
+            vdata->vertexBufferBinding->setBinding(source, texCoordBuffer);
+            vdata->hwPoseTexture = true;
+        }
+        // Filled again by the pose tracks
+        vdata->hwPoseWeights.clear();
+    }
+    //-----------------------------------------------------------------------
     void Entity::applyVertexAnimation(bool hardwareAnimation, bool stencilShadows)
     {
         const MeshPtr& msh = getMesh();
@@ -1077,6 +1267,12 @@ namespace Ogre {
         if (hardwareAnimation)
         {
             if (mHardwareVertexAnimVertexData
+                && msh->getSharedVertexDataAnimationType() == VAT_POSE
+                && msh->getUsePoseTexture())
+            {
+                initHardwarePoseTextureElements(mHardwareVertexAnimVertexData, 0);
+            }
+            else if (mHardwareVertexAnimVertexData
                 && msh->getSharedVertexDataAnimationType() != VAT_NONE)
             {
                 ushort supportedCount =
@@ -1101,7 +1297,13 @@ namespace Ogre {
                 si != mSubEntityList.end(); ++si)
             {
                 SubEntity* sub = *si;
-                if (sub->getSubMesh()->getVertexAnimationType() != VAT_NONE &&
+                if (sub->getSubMesh()->getVertexAnimationType() == VAT_POSE &&
+                    !sub->getSubMesh()->useSharedVertices && msh->getUsePoseTexture())
+                {
+                    initHardwarePoseTextureElements(sub->_getHardwareVertexAnimVertexData(),
+                        static_cast<ushort>(si - mSubEntityList.begin() + 1));
+                }
+                else if (sub->getSubMesh()->getVertexAnimationType() != VAT_NONE &&
                     !sub->getSubMesh()->useSharedVertices)
                 {
                     ushort supportedCount = initHardwareAnimationElements(
@@ -1416,6 +1618,84 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    bool Entity::_prepareConcurrentBoneUpdate(void)
+    {
+        if (!mInitialised || !hasSkeleton() || sharesSkeletonInstance())
+            return false;
+
+        // Attached objects notify their listener when moved
+        for (ChildObjectList::iterator i = mChildObjectList.begin(); i != mChildObjectList.end(); ++i)
+        {
+            if (i->second->getListener())
+                return false;
+        }
+
+        unsigned long currentFrameNumber = Root::getSingleton().getNextFrameNumber();
+        if ((*mFrameBonesLastUpdated == currentFrameNumber || isAnimationLodSkipped()) &&
+            !getSkeleton()->getManualBonesDirty())
+        {
+            return false;
+        }
+
+        // Another entity evaluates the same pose, copy it afterwards rather than
+        // evaluating it twice
+        Entity* poseOwner = mManager ? mManager->_claimSkeletonPose(this) : 0;
+        if (poseOwner && poseOwner != this)
+            return false;
+
+        // The tag points derive from the parent node, bring its transform up to date
+        // here rather than from several threads
+        if (!mChildObjectList.empty())
+            _getParentNodeFullTransform();
+
+        if (!mSkipAnimStateUpdates)
+        {
+            // The animations live in the shared Skeleton, so update their
+            // lazily built data before several entities apply them at once
+            ConstEnabledAnimationStateIterator it = mAnimationState->getEnabledAnimationStateIterator();
+            while (it.hasMoreElements())
+            {
+                Animation* anim = mSkeletonInstance->_getAnimationImpl(it.getNext()->getAnimationName());
+                if (anim)
+                    anim->_prepareForApply();
+            }
+        }
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void Entity::_updateBoneMatrices(void)
+    {
+        // The pose was already claimed by _prepareConcurrentBoneUpdate
+        cacheBoneMatrices(false);
+
+        if (!mChildObjectList.empty())
+        {
+            // Same as updateAnimation would do, which then skips it
+            mChildTransformsXform = _getParentNodeFullTransform();
+            mFrameChildTransformsUpdated = *mFrameBonesLastUpdated;
+            for (ChildObjectList::iterator i = mChildObjectList.begin(); i != mChildObjectList.end(); ++i)
+                i->second->getParentNode()->_update(true, true);
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool Entity::_updateSkeletonBounds(void)
+    {
+        if (!mInitialised || !hasSkeleton() || !isInScene())
+            return false;
+
+        // Only for changed animation states: evaluating clears the manual bones dirty
+        // flag, which updateAnimation relies on to blend the vertices afterwards
+        if (mFrameAnimationLastUpdated == mAnimationState->getDirtyFrameNumber())
+            return false;
+
+        if (!cacheBoneMatrices())
+            return false;
+
+        // getBoundingBox reads the derived bone positions
+        Node::queueNeedUpdate(mParentNode);
+        return true;
+    }
+    //-----------------------------------------------------------------------
     bool Entity::_isAnimated(void) const
     {
         return (mAnimationState && mAnimationState->hasEnabledAnimationState()) ||
@@ -1456,17 +1736,29 @@ namespace Ogre {
         return &mTempVertexAnimInfo;
     }
     //-----------------------------------------------------------------------
-    bool Entity::cacheBoneMatrices(void)
+    bool Entity::cacheBoneMatrices(bool allowSharedPose)
     {
         Root& root = Root::getSingleton();
         unsigned long currentFrameNumber = root.getNextFrameNumber();
-        if ((*mFrameBonesLastUpdated != currentFrameNumber) ||
+        if ((*mFrameBonesLastUpdated != currentFrameNumber && !isAnimationLodSkipped()) ||
             (hasSkeleton() && getSkeleton()->getManualBonesDirty()))
         {
-            if ((!mSkipAnimStateUpdates) && (*mFrameBonesLastUpdated != currentFrameNumber))
-                mSkeletonInstance->setAnimationState(*mAnimationState);
-            mSkeletonInstance->_getBoneMatrices(mBoneMatrices);
+            Entity* poseOwner = (allowSharedPose && mManager) ? mManager->_claimSkeletonPose(this) : 0;
+            if (poseOwner && poseOwner != this)
+            {
+                // Same skeleton, so the same number of bones
+                std::copy(poseOwner->mBoneMatrices, poseOwner->mBoneMatrices + mNumBoneMatrices,
+                          mBoneMatrices);
+            }
+            else
+            {
+                if ((!mSkipAnimStateUpdates) && (*mFrameBonesLastUpdated != currentFrameNumber))
+                    mSkeletonInstance->setAnimationState(*mAnimationState);
+                mSkeletonInstance->_getBoneMatrices(mBoneMatrices);
+            }
             *mFrameBonesLastUpdated  = currentFrameNumber;
+            // The child objects follow the new bones
+            mChildTransformsXform = Matrix4::ZERO;
 
             return true;
         }
@@ -1511,6 +1803,8 @@ namespace Ogre {
         mMeshLodFactorTransformed = mMesh->getLodStrategy()->transformBias(factor);
         mMaxMeshLodIndex = maxDetailIndex;
         mMinMeshLodIndex = minDetailIndex;
+        // Recompute the LOD on the next camera notification
+        mLodCamera = 0;
     }
     //-----------------------------------------------------------------------
     void Entity::setMaterialLodBias(Real factor, ushort maxDetailIndex, ushort minDetailIndex)
@@ -1519,6 +1813,7 @@ namespace Ogre {
         mMaterialLodFactorTransformed = mMesh->getLodStrategy()->transformBias(factor);
         mMaxMaterialLodIndex = maxDetailIndex;
         mMinMaterialLodIndex = minDetailIndex;
+        mLodCamera = 0;
     }
 #endif
     //-----------------------------------------------------------------------
@@ -2218,6 +2513,25 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    const MeshBVH* Entity::getBVH(void)
+    {
+        if (!hasSkeleton() && !hasVertexAnimation())
+            return mMesh->getBVH();
+
+        // Refit a copy of the hierarchy of the mesh to the animated positions
+        if (!mBVH)
+        {
+            mBVH = OGRE_NEW MeshBVH(*mMesh->getBVH());
+            mBVHFrame = mFrameAnimationLastUpdated - 1;
+        }
+        if (mBVHFrame != mFrameAnimationLastUpdated)
+        {
+            mBVH->refit(this);
+            mBVHFrame = mFrameAnimationLastUpdated;
+        }
+        return mBVH;
+    }
+    //-----------------------------------------------------------------------
     void Entity::_notifyAttached(Node* parent, bool isTagPoint)
     {
         MovableObject::_notifyAttached(parent, isTagPoint);
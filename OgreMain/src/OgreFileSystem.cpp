@@ -42,6 +42,14 @@ THE SOFTWARE.
 #   define MAX_PATH MAXPATHLEN
 #endif
 
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX || OGRE_PLATFORM == OGRE_PLATFORM_APPLE || \
+    OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS || OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
+#   include <sys/mman.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#   define OGRE_FILESYSTEM_MMAP 1
+#endif
+
 #if OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || OGRE_PLATFORM == OGRE_PLATFORM_WINRT
 #  define WIN32_LEAN_AND_MEAN
 #  if !defined(NOMINMAX) && defined(_MSC_VER)
@@ -55,6 +63,7 @@ THE SOFTWARE.
 namespace Ogre {
 
     bool FileSystemArchive::msIgnoreHidden = true;
+    bool FileSystemArchive::msUseMemoryMapping = false;
 
     //-----------------------------------------------------------------------
     FileSystemArchive::FileSystemArchive(const String& name, const String& archType, bool readOnly )
@@ -225,6 +234,14 @@ namespace Ogre {
                         "FileSystemArchive::open");
         }
 
+        if (readOnly && msUseMemoryMapping)
+        {
+            // Falls back to a file stream if mapping fails
+            MappedFileDataStream* mapped = MappedFileDataStream::open(filename, full_path);
+            if (mapped)
+                return DataStreamPtr(mapped);
+        }
+
         if (!readOnly)
         {
             mode |= std::ios::out;
@@ -407,4 +424,75 @@ namespace Ogre {
         return name;
     }
 
+    //-----------------------------------------------------------------------
+    MappedFileDataStream::MappedFileDataStream(const String& name, void* data, size_t size, void* mapping)
+        : MemoryDataStream(name, data, size, false, true)
+        , mMapping(mapping)
+    {
+    }
+    //-----------------------------------------------------------------------
+    MappedFileDataStream::~MappedFileDataStream()
+    {
+        close();
+    }
+    //-----------------------------------------------------------------------
+    MappedFileDataStream* MappedFileDataStream::open(const String& name, const String& path)
+    {
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+        if (file == INVALID_HANDLE_VALUE)
+            return 0;
+
+        LARGE_INTEGER size;
+        HANDLE mapping = 0;
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0 && (ULONGLONG)size.QuadPart <= (size_t)-1)
+            mapping = CreateFileMappingA(file, 0, PAGE_WRITECOPY, 0, 0, 0);
+        // The mapping keeps the file open
+        CloseHandle(file);
+        if (!mapping)
+            return 0;
+
+        void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+        if (!data)
+        {
+            CloseHandle(mapping);
+            return 0;
+        }
+        return OGRE_NEW MappedFileDataStream(name, data, (size_t)size.QuadPart, mapping);
+#elif defined(OGRE_FILESYSTEM_MMAP)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+            return 0;
+
+        struct stat tagStat;
+        void* data = MAP_FAILED;
+        if (fstat(fd, &tagStat) == 0 && tagStat.st_size > 0)
+            data = mmap(0, (size_t)tagStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        // The mapping keeps the file open
+        ::close(fd);
+        if (data == MAP_FAILED)
+            return 0;
+
+        return OGRE_NEW MappedFileDataStream(name, data, (size_t)tagStat.st_size, 0);
+#else
+        return 0;
+#endif
+    }
+    //-----------------------------------------------------------------------
+    void MappedFileDataStream::close(void)
+    {
+        if (!mData)
+            return;
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        UnmapViewOfFile(mData);
+        CloseHandle(mMapping);
+#elif defined(OGRE_FILESYSTEM_MMAP)
+        munmap(mData, mSize);
+#endif
+        mData = mPos = mEnd = 0;
+        mMapping = 0;
+    }
+
 }
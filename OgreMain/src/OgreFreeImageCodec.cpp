@@ -398,11 +398,22 @@ namespace Ogre {
     //---------------------------------------------------------------------
     Codec::DecodeResult FreeImageCodec::decode(DataStreamPtr& input) const
     {
-        // Buffer stream into memory (TODO: override IO functions instead?)
-        MemoryDataStream memStream(input, true);
+        // Buffer stream into memory (TODO: override IO functions instead?),
+        // unless already there (e.g. memory mapped)
+        MemoryDataStreamPtr memStream;
+        if (MemoryDataStream* inMemory = dynamic_cast<MemoryDataStream*>(input.get()))
+        {
+            // Just the remainder of the stream, like copying it would
+            memStream.bind(OGRE_NEW MemoryDataStream(inMemory->getCurrentPtr(),
+                inMemory->size() - inMemory->tell(), false, true));
+        }
+        else
+        {
+            memStream.bind(OGRE_NEW MemoryDataStream(input, true));
+        }
 
         FIMEMORY* fiMem = 
-            FreeImage_OpenMemory(memStream.getPtr(), static_cast<DWORD>(memStream.size()));
+            FreeImage_OpenMemory(memStream->getPtr(), static_cast<DWORD>(memStream->size()));
 
         FIBITMAP* fiBitmap = FreeImage_LoadFromMemory(
             (FREE_IMAGE_FORMAT)mFreeImageType, fiMem);
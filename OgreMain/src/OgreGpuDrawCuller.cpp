@@ -0,0 +1,63 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreGpuDrawCuller.h"
+#include "OgreSoftwareOcclusionCuller.h"
+#include "OgreCamera.h"
+#include "OgreSceneManager.h"
+
+namespace Ogre {
+    //---------------------------------------------------------------------
+    GpuDrawCuller::GpuDrawCuller()
+        : mNumItems(0), mInstanced(false), mCullPending(false), mOcclusion(0)
+    {
+    }
+    //---------------------------------------------------------------------
+    GpuDrawCuller::~GpuDrawCuller()
+    {
+    }
+    //---------------------------------------------------------------------
+    void GpuDrawCuller::cull(const Camera* cam)
+    {
+        // Same planes as Camera::isVisible would use
+        const Frustum* frustum = cam->getCullingFrustum() ? cam->getCullingFrustum() : cam;
+        const Plane* planes = frustum->getFrustumPlanes();
+        for (int i = 0; i < 6; ++i)
+        {
+            if (i == FRUSTUM_PLANE_FAR && frustum->getFarClipDistance() == 0)
+                mPlanes[i] = Vector4(0, 0, 0, 1e30f);
+            else
+                mPlanes[i] = Vector4(planes[i].normal.x, planes[i].normal.y, planes[i].normal.z, planes[i].d);
+        }
+
+        SoftwareOcclusionCuller* occlusion = cam->getSceneManager()->getOcclusionCuller();
+        mOcclusion = occlusion && occlusion->isUpToDate(cam) ? occlusion : 0;
+        mViewProj = cam->getProjectionMatrix() * cam->getViewMatrix();
+        mCullPending = true;
+    }
+}
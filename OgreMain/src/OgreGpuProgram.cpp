@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgreRenderSystemCapabilities.h"
 #include "OgreStringConverter.h"
 #include "OgreLogManager.h"
+#include "OgreResourceLoadTrace.h"
 
 namespace Ogre
 {
@@ -125,7 +126,11 @@ namespace Ogre
         // Call polymorphic load
         try 
         {
-            loadFromSource();
+            ResourceLoadTraceScope trace(RLP_COMPILE, mName, mSource.size());
+            {
+                GpuProgramManager::CompileTimer timer(GpuProgramManager::CS_COMPILE, mName);
+                loadFromSource();
+            }
 
             if (!mDefaultParams.isNull())
             {
@@ -382,6 +387,21 @@ namespace Ogre
         return language;
     }
     //-----------------------------------------------------------------------
+    uint32 GpuProgram::_getHash(uint32 hashSoFar) const
+    {
+        uint32 hash = FastHash(mSource.c_str(), static_cast<int>(mSource.size()), hashSoFar);
+        hash = FastHash(mSyntaxCode.c_str(), static_cast<int>(mSyntaxCode.size()), hash);
+        hash = HashCombine(hash, mType);
+
+        const ParameterList& params = getParameters();
+        for (ParameterList::const_iterator i = params.begin(); i != params.end(); ++i)
+        {
+            String value = i->name + "=" + getParameter(i->name);
+            hash = FastHash(value.c_str(), static_cast<int>(value.size()), hash);
+        }
+        return hash;
+    }
+    //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     String GpuProgram::CmdType::doGet(const void* target) const
     {
@@ -30,9 +30,17 @@ THE SOFTWARE.
 #include "OgreHighLevelGpuProgramManager.h"
 #include "OgreRoot.h"
 #include "OgreRenderSystem.h"
+#include "OgreFileSystemLayer.h"
+#include "OgreLogManager.h"
+#include "OgreTimer.h"
+#include <fstream>
 
 
 namespace Ogre {
+    /// Identifies automatic microcode cache files
+    static const uint32 MICROCODE_CACHE_MAGIC = 0x434D474F; // 'OGMC'
+    /// Bump when the file layout changes
+    static const uint32 MICROCODE_CACHE_VERSION = 1;
     //-----------------------------------------------------------------------
     template<> GpuProgramManager* Singleton<GpuProgramManager>::msSingleton = 0;
     GpuProgramManager* GpuProgramManager::getSingletonPtr(void)
@@ -57,6 +65,14 @@ namespace Ogre {
         mResourceType = "GpuProgram";
         mSaveMicrocodesToCache = false;
         mCacheDirty = false;
+        mMicrocodeCacheOpened = false;
+        mMicrocodeCacheHits = 0;
+        mMicrocodeCacheMisses = 0;
+        for (int i = 0; i <= CS_GENERATE; ++i)
+        {
+            mCompileCount[i] = 0;
+            mCompileTime[i] = 0;
+        }
 
         // subclasses should register with resource group manager
     }
@@ -106,9 +122,9 @@ namespace Ogre {
         GpuProgramType gptype, const String& syntaxCode, bool isManual, 
         ManualResourceLoader* loader)
     {
-        // Call creation implementation
-        ResourcePtr ret = ResourcePtr(
-            createImpl(name, getNextHandle(), group, isManual, loader, gptype, syntaxCode));
+        // Call creation implementation, the resource holds its own reference count
+        Resource* res = createImpl(name, getNextHandle(), group, isManual, loader, gptype, syntaxCode);
+        ResourcePtr ret = ResourcePtr(res, res->_getSharedPtrInfo());
 
         addImpl(ret);
         // Tell resource group manager
@@ -209,6 +225,8 @@ namespace Ogre {
     //---------------------------------------------------------------------
     bool GpuProgramManager::getSaveMicrocodesToCache()
     {
+        if (!mMicrocodeCacheOpened && !mMicrocodeCacheDirectory.empty())
+            openMicrocodeCache();
         return mSaveMicrocodesToCache;
     }
     //---------------------------------------------------------------------
@@ -235,17 +253,113 @@ namespace Ogre {
         return mCacheDirty;     
     }
     //---------------------------------------------------------------------
+    void GpuProgramManager::setMicrocodeCacheDirectory( const String & path )
+    {
+        mMicrocodeCacheDirectory = path;
+        mMicrocodeCacheFile.clear();
+        mMicrocodeCacheOpened = false;
+    }
+    //---------------------------------------------------------------------
+    void GpuProgramManager::openMicrocodeCache()
+    {
+        // Capabilities are only known once the render system is initialised
+        RenderSystem* rs = Root::getSingleton().getRenderSystem();
+        if (!rs || !rs->getCapabilities())
+            return;
+        mMicrocodeCacheOpened = true;
+
+        setSaveMicrocodesToCache(true);
+        if (!mSaveMicrocodesToCache)
+            return;
+
+        String fileName = rs->getName();
+        for (String::iterator i = fileName.begin(); i != fileName.end(); ++i)
+        {
+            if (!isalnum(static_cast<unsigned char>(*i)))
+                *i = '_';
+        }
+        FileSystemLayer::createDirectory(mMicrocodeCacheDirectory);
+        mMicrocodeCacheFile = mMicrocodeCacheDirectory + "/" + fileName + ".microcode";
+
+        std::ifstream in(mMicrocodeCacheFile.c_str(), std::ios_base::binary | std::ios_base::in);
+        uint32 header[2] = { 0, 0 };
+        bool valid = in.read(reinterpret_cast<char*>(header), sizeof(header)) &&
+            header[0] == MICROCODE_CACHE_MAGIC && header[1] == MICROCODE_CACHE_VERSION;
+        size_t count = 0;
+        while (valid)
+        {
+            // Later entries replace earlier ones with the same name
+            uint32 length = 0;
+            if (!in.read(reinterpret_cast<char*>(&length), sizeof(uint32)))
+                break;
+            String name(length, '\0');
+            if (length && !in.read(&name[0], length))
+                break;
+            if (!in.read(reinterpret_cast<char*>(&length), sizeof(uint32)))
+                break;
+            Microcode microcode(OGRE_NEW MemoryDataStream(name, length));
+            if (length && !in.read(reinterpret_cast<char*>(microcode->getPtr()), length))
+                break;
+            mMicrocodeCache[name] = microcode;
+            ++count;
+        }
+        in.close();
+
+        if (!valid)
+        {
+            // Missing or from another version, start it again
+            std::ofstream out(mMicrocodeCacheFile.c_str(),
+                std::ios_base::binary | std::ios_base::out | std::ios_base::trunc);
+            header[0] = MICROCODE_CACHE_MAGIC;
+            header[1] = MICROCODE_CACHE_VERSION;
+            out.write(reinterpret_cast<const char*>(header), sizeof(header));
+            if (!out)
+            {
+                LogManager::getSingleton().logMessage("Unable to write microcode cache " +
+                    mMicrocodeCacheFile, LML_CRITICAL);
+                mMicrocodeCacheFile.clear();
+            }
+        }
+
+        LogManager::getSingleton().logMessage("Microcode cache " + mMicrocodeCacheDirectory +
+            ": " + StringConverter::toString(count) + " programs read");
+    }
+    //---------------------------------------------------------------------
+    void GpuProgramManager::appendMicrocodeToCacheFile( const String & name, const Microcode & microcode )
+    {
+        std::ofstream out(mMicrocodeCacheFile.c_str(),
+            std::ios_base::binary | std::ios_base::out | std::ios_base::app);
+        uint32 length = static_cast<uint32>(name.size());
+        out.write(reinterpret_cast<const char*>(&length), sizeof(uint32));
+        out.write(name.c_str(), length);
+        length = static_cast<uint32>(microcode->size());
+        out.write(reinterpret_cast<const char*>(&length), sizeof(uint32));
+        out.write(reinterpret_cast<const char*>(microcode->getPtr()), length);
+    }
+    //---------------------------------------------------------------------
     String GpuProgramManager::addRenderSystemToName( const String & name )
     {
         // Use the current render system
         RenderSystem* rs = Root::getSingleton().getRenderSystem();
 
+        // Binaries are only valid for the device and driver they were made with
+        const RenderSystemCapabilities* caps = rs->getCapabilities();
+        if (caps)
+            return rs->getName() + "_" + caps->getDeviceName() + "_" +
+                caps->getDriverVersion().toString() + "_" + name;
         return rs->getName() + "_" + name;
     }
     //---------------------------------------------------------------------
     bool GpuProgramManager::isMicrocodeAvailableInCache( const String & name ) const
     {
-        return mMicrocodeCache.find(addRenderSystemToName(name)) != mMicrocodeCache.end();
+        if (!mMicrocodeCacheOpened && !mMicrocodeCacheDirectory.empty())
+            const_cast<GpuProgramManager*>(this)->openMicrocodeCache();
+        bool found = mMicrocodeCache.find(addRenderSystemToName(name)) != mMicrocodeCache.end();
+        if (found)
+            ++mMicrocodeCacheHits;
+        else
+            ++mMicrocodeCacheMisses;
+        return found;
     }
     //---------------------------------------------------------------------
     const GpuProgramManager::Microcode & GpuProgramManager::getMicrocodeFromCache( const String & name ) const
@@ -253,6 +367,58 @@ namespace Ogre {
         return mMicrocodeCache.find(addRenderSystemToName(name))->second;
     }
     //---------------------------------------------------------------------
+    GpuProgramManager::CompileTimer::CompileTimer(CompileStage stage, const String& name)
+        : mStage(stage), mName(name)
+    {
+        mStart = Root::getSingleton().getTimer()->getMicroseconds();
+    }
+    //---------------------------------------------------------------------
+    GpuProgramManager::CompileTimer::~CompileTimer()
+    {
+        unsigned long end = Root::getSingleton().getTimer()->getMicroseconds();
+        GpuProgramManager::getSingleton()._notifyCompiled(mStage, mName, end - mStart);
+    }
+    //---------------------------------------------------------------------
+    void GpuProgramManager::_notifyCompiled(CompileStage stage, const String& name,
+        unsigned long microseconds)
+    {
+        CompileTiming timing;
+        timing.name = name;
+        timing.stage = stage;
+        timing.microseconds = microseconds;
+        timing.startTime = Root::getSingleton().getTimer()->getMicroseconds() - microseconds;
+        timing.frameNumber = Root::getSingleton().getNextFrameNumber();
+
+        OGRE_LOCK_MUTEX(mCompileTimingsMutex);
+        mCompileTimings.push_back(timing);
+        ++mCompileCount[stage];
+        mCompileTime[stage] += microseconds;
+    }
+    //---------------------------------------------------------------------
+    GpuProgramManager::CompileTimingList GpuProgramManager::getCompileTimings(void) const
+    {
+        OGRE_LOCK_MUTEX(mCompileTimingsMutex);
+        return mCompileTimings;
+    }
+    //---------------------------------------------------------------------
+    void GpuProgramManager::clearCompileTimings(void)
+    {
+        OGRE_LOCK_MUTEX(mCompileTimingsMutex);
+        mCompileTimings.clear();
+    }
+    //---------------------------------------------------------------------
+    size_t GpuProgramManager::getTotalCompileCount(CompileStage stage) const
+    {
+        OGRE_LOCK_MUTEX(mCompileTimingsMutex);
+        return mCompileCount[stage];
+    }
+    //---------------------------------------------------------------------
+    unsigned long GpuProgramManager::getTotalCompileTime(CompileStage stage) const
+    {
+        OGRE_LOCK_MUTEX(mCompileTimingsMutex);
+        return mCompileTime[stage];
+    }
+    //---------------------------------------------------------------------
     GpuProgramManager::Microcode GpuProgramManager::createMicrocode( const uint32 size ) const
     {   
         return Microcode(OGRE_NEW MemoryDataStream(size));  
@@ -273,6 +439,9 @@ namespace Ogre {
             foundIter->second = microcode;
 
         }       
+
+        if (!mMicrocodeCacheFile.empty())
+            appendMicrocodeToCacheFile(nameWithRenderSystem, microcode);
     }
     //---------------------------------------------------------------------
     void GpuProgramManager::removeMicrocodeFromCache( const String & name )
@@ -707,7 +707,7 @@ namespace Ogre
         initCopyData();
     }
     //---------------------------------------------------------------------
-    void GpuSharedParametersUsage::initCopyData()
+    void GpuSharedParametersUsage::initCopyData() const
     {
 
         mCopyDataList.clear();
@@ -737,19 +737,22 @@ namespace Ogre
         mCopyDataVersion = mSharedParams->getVersion();
     }
     //---------------------------------------------------------------------
-    void GpuSharedParametersUsage::_copySharedParamsToTargetParams()
+    void GpuSharedParametersUsage::_copySharedParamsToTargetParams() const
     {
         // check copy data version
         if (mCopyDataVersion != mSharedParams->getVersion())
             initCopyData();
 
-        for (CopyDataList::iterator i = mCopyDataList.begin(); i != mCopyDataList.end(); ++i)
+        // Read through a const reference so copying doesn't mark the shared set dirty
+        const GpuSharedParameters& sharedParams = *mSharedParams;
+
+        for (CopyDataList::const_iterator i = mCopyDataList.begin(); i != mCopyDataList.end(); ++i)
         {
-            CopyDataEntry& e = *i;
+            const CopyDataEntry& e = *i;
 
             if (e.dstDefinition->isFloat())
             {
-                const float* pSrc = mSharedParams->getFloatPointer(e.srcDefinition->physicalIndex);
+                const float* pSrc = sharedParams.getFloatPointer(e.srcDefinition->physicalIndex);
                 float* pDst = mParams->getFloatPointer(e.dstDefinition->physicalIndex);
 
                 // Deal with matrix transposition here!!!
@@ -792,7 +795,7 @@ namespace Ogre
             }
             else if (e.dstDefinition->isDouble())
             {
-                const double* pSrc = mSharedParams->getDoublePointer(e.srcDefinition->physicalIndex);
+                const double* pSrc = sharedParams.getDoublePointer(e.srcDefinition->physicalIndex);
                 double* pDst = mParams->getDoublePointer(e.dstDefinition->physicalIndex);
 
                 // Deal with matrix transposition here!!!
@@ -837,7 +840,7 @@ namespace Ogre
                      e.dstDefinition->isSampler() ||
                      e.dstDefinition->isSubroutine())
             {
-                const int* pSrc = mSharedParams->getIntPointer(e.srcDefinition->physicalIndex);
+                const int* pSrc = sharedParams.getIntPointer(e.srcDefinition->physicalIndex);
                 int* pDst = mParams->getIntPointer(e.dstDefinition->physicalIndex);
 
                 if (e.dstDefinition->elementSize == e.srcDefinition->elementSize)
@@ -863,7 +866,7 @@ namespace Ogre
             }
             else if (e.dstDefinition->isUnsignedInt() || e.dstDefinition->isBool()) 
             {
-                const uint* pSrc = mSharedParams->getUnsignedIntPointer(e.srcDefinition->physicalIndex);
+                const uint* pSrc = sharedParams.getUnsignedIntPointer(e.srcDefinition->physicalIndex);
                 uint* pDst = mParams->getUnsignedIntPointer(e.dstDefinition->physicalIndex);
 
                 if (e.dstDefinition->elementSize == e.srcDefinition->elementSize)
@@ -930,6 +933,7 @@ namespace Ogre
         , mIgnoreMissingParams(false)
         , mActivePassIterationIndex(std::numeric_limits<size_t>::max())
     {
+        resetAutoParamVersions();
     }
     //-----------------------------------------------------------------------------
 
@@ -961,10 +965,17 @@ namespace Ogre
         mTransposeMatrices = oth.mTransposeMatrices;
         mIgnoreMissingParams  = oth.mIgnoreMissingParams;
         mActivePassIterationIndex = oth.mActivePassIterationIndex;
+        resetAutoParamVersions();
 
         return *this;
     }
     //---------------------------------------------------------------------
+    void GpuProgramParameters::resetAutoParamVersions(void)
+    {
+        mAutoParamVersions[0] = mAutoParamVersions[1] = mAutoParamVersions[2] = 0;
+        mAutoParamPass = 0;
+    }
+    //---------------------------------------------------------------------
     void GpuProgramParameters::copySharedParamSetUsage(const GpuSharedParamUsageList& srcList)
     {
         mSharedParamSets.clear();
@@ -1282,11 +1293,20 @@ namespace Ogre
         // remember, raw content access uses raw float count rather than float4
         if (mTransposeMatrices)
         {
+            // write the transposed arrays straight into the buffer, skinned and
+            // instanced batches can pass hundreds of matrices here
+            assert(physicalIndex + 16 * numEntries <= mFloatConstants.size());
+            float* pDest = &mFloatConstants[physicalIndex];
             for (size_t i = 0; i < numEntries; ++i)
             {
-                Matrix4 t = pMatrix[i].transpose();
-                _writeRawConstants(physicalIndex, t[0], 16);
-                physicalIndex += 16;
+                const Matrix4& m = pMatrix[i];
+                for (size_t col = 0; col < 4; ++col)
+                {
+                    *pDest++ = static_cast<float>(m[0][col]);
+                    *pDest++ = static_cast<float>(m[1][col]);
+                    *pDest++ = static_cast<float>(m[2][col]);
+                    *pDest++ = static_cast<float>(m[3][col]);
+                }
             }
         }
         else
@@ -2266,6 +2286,7 @@ namespace Ogre
             mAutoConstants.push_back(AutoConstantEntry(acType, physicalIndex, extraInfo, variability, elementSize));
 
         mCombinedVariability |= variability;
+        resetAutoParamVersions();
 
 
     }
@@ -2316,6 +2337,7 @@ namespace Ogre
             mAutoConstants.push_back(AutoConstantEntry(acType, physicalIndex, rData, variability, elementSize));
 
         mCombinedVariability |= variability;
+        resetAutoParamVersions();
     }
     //-----------------------------------------------------------------------------
     void GpuProgramParameters::clearAutoConstant(size_t index)
@@ -2404,6 +2426,27 @@ namespace Ogre
         if (!(mask & mCombinedVariability))
             return;
 
+        // skip the variabilities whose inputs did not change since these autos were computed
+        static const GpuParamVariability versioned[3] = { GPV_GLOBAL, GPV_PER_OBJECT, GPV_LIGHTS };
+        for (int v = 0; v < 3; ++v)
+        {
+            if (!(mask & versioned[v]))
+                continue;
+
+            uint32 version = source->getVersion(versioned[v]);
+            bool passChanged = versioned[v] == GPV_GLOBAL && mAutoParamPass != source->getCurrentPass();
+            if (version == mAutoParamVersions[v] && !passChanged)
+            {
+                mask &= ~versioned[v];
+            }
+            else
+            {
+                mAutoParamVersions[v] = version;
+                if (versioned[v] == GPV_GLOBAL)
+                    mAutoParamPass = source->getCurrentPass();
+            }
+        }
+
         size_t index;
         size_t numMatrices;
         const Matrix4* pMatrix;
@@ -3434,6 +3477,7 @@ namespace Ogre
         mAutoConstants = source.getAutoConstantList();
         mCombinedVariability = source.mCombinedVariability;
         copySharedParamSetUsage(source.mSharedParamSets);
+        resetAutoParamVersions();
     }
     //---------------------------------------------------------------------
     void GpuProgramParameters::copyMatchingNamedConstantsFrom(const GpuProgramParameters& source)
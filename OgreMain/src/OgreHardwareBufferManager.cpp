@@ -27,12 +27,100 @@ THE SOFTWARE.
 */
 #include "OgreStableHeaders.h"
 #include "OgreHardwareBufferManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
 #include "OgreVertexIndexData.h"
 #include "OgreLogManager.h"
+#include "OgreAtomicScalar.h"
+#include "OgreRoot.h"
+#include "OgreTimer.h"
 
 
 namespace Ogre {
 
+    //-----------------------------------------------------------------------
+    static AtomicScalar<size_t> gLockedBytes(0);
+    static AtomicScalar<size_t> gLockStalls(0);
+    static AtomicScalar<unsigned long> gLockWaitTime(0);
+    static AtomicScalar<size_t> gLockWaits(0);
+    static HardwareBufferLockListener* gLockListener = 0;
+    static unsigned long gLockWaitThreshold = 100;
+    //-----------------------------------------------------------------------
+    void HardwareBuffer::_notifyLocked(size_t length, LockOptions options)
+    {
+        gLockedBytes += length;
+        if (options != HBL_DISCARD && options != HBL_NO_OVERWRITE)
+            ++gLockStalls;
+    }
+    //-----------------------------------------------------------------------
+    size_t HardwareBuffer::getTotalLockedBytes(void)
+    {
+        return gLockedBytes.get();
+    }
+    //-----------------------------------------------------------------------
+    size_t HardwareBuffer::getTotalLockStalls(void)
+    {
+        return gLockStalls.get();
+    }
+    //-----------------------------------------------------------------------
+    HardwareBuffer::LockWaitTimer::LockWaitTimer(const HardwareBuffer* buffer, size_t length,
+        LockOptions options)
+        : mBuffer(buffer), mLength(length), mOptions(options), mStart(0)
+    {
+        if (!mBuffer->isSystemMemory())
+            mStart = Root::getSingleton().getTimer()->getMicroseconds();
+    }
+    //-----------------------------------------------------------------------
+    HardwareBuffer::LockWaitTimer::~LockWaitTimer()
+    {
+        if (!mBuffer->isSystemMemory())
+        {
+            unsigned long end = Root::getSingleton().getTimer()->getMicroseconds();
+            _notifyLockWait(mBuffer, mLength, mOptions, end - mStart);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void HardwareBuffer::_notifyLockWait(const HardwareBuffer* buffer, size_t length,
+        LockOptions options, unsigned long microseconds)
+    {
+        gLockWaitTime += microseconds;
+        if (microseconds < gLockWaitThreshold)
+            return;
+
+        ++gLockWaits;
+        if (gLockListener)
+            gLockListener->lockWaited(buffer, length, options, microseconds);
+    }
+    //-----------------------------------------------------------------------
+    unsigned long HardwareBuffer::getTotalLockWaitTime(void)
+    {
+        return gLockWaitTime.get();
+    }
+    //-----------------------------------------------------------------------
+    size_t HardwareBuffer::getTotalLockWaits(void)
+    {
+        return gLockWaits.get();
+    }
+    //-----------------------------------------------------------------------
+    void HardwareBuffer::setLockListener(HardwareBufferLockListener* listener)
+    {
+        gLockListener = listener;
+    }
+    //-----------------------------------------------------------------------
+    HardwareBufferLockListener* HardwareBuffer::getLockListener(void)
+    {
+        return gLockListener;
+    }
+    //-----------------------------------------------------------------------
+    void HardwareBuffer::setLockWaitThreshold(unsigned long microseconds)
+    {
+        gLockWaitThreshold = microseconds;
+    }
+    //-----------------------------------------------------------------------
+    unsigned long HardwareBuffer::getLockWaitThreshold(void)
+    {
+        return gLockWaitThreshold;
+    }
+
     //-----------------------------------------------------------------------
     template<> HardwareBufferManager* Singleton<HardwareBufferManager>::msSingleton = 0;
     HardwareBufferManager* HardwareBufferManager::getSingletonPtr(void)
@@ -59,14 +147,25 @@ namespace Ogre {
     // Free temporary vertex buffers every 5 minutes on 100fps
     const size_t HardwareBufferManagerBase::UNDER_USED_FRAME_THRESHOLD = 30000;
     const size_t HardwareBufferManagerBase::EXPIRED_DELAY_FRAME_THRESHOLD = 5;
+    const size_t HardwareBufferManagerBase::STAGING_BUFFER_MIN_SIZE = 4096;
+    const size_t HardwareBufferManagerBase::STAGING_BUFFER_EXPIRED_FRAME_THRESHOLD = 300;
     //-----------------------------------------------------------------------
     HardwareBufferManagerBase::HardwareBufferManagerBase()
         : mUnderUsedFrameCount(0)
+        , mFreeStagingBufferBytes(0)
+        , mStagingBufferBudget(16 * 1024 * 1024)
+        , mArenaSize(4 * 1024 * 1024)
     {
     }
     //-----------------------------------------------------------------------
     HardwareBufferManagerBase::~HardwareBufferManagerBase()
     {
+        // Arenas still in use keep their buffers alive through the vertex / index data
+        for (VertexArenaMap::iterator i = mVertexArenas.begin(); i != mVertexArenas.end(); ++i)
+            OGRE_DELETE i->second;
+        for (IndexArenaMap::iterator i = mIndexArenas.begin(); i != mIndexArenas.end(); ++i)
+            OGRE_DELETE i->second;
+
         // Clear vertex/index buffer list first, avoid destroyed notify do
         // unnecessary work, and we'll destroy everything here.
         mVertexBuffers.clear();
@@ -80,6 +179,9 @@ namespace Ogre {
         // No need to destroy main buffers - they will be destroyed by removal of bindings
 
         // No need to destroy temp buffers - they will be destroyed automatically.
+
+        for (FreeStagingBufferMap::iterator i = mFreeStagingBuffers.begin(); i != mFreeStagingBuffers.end(); ++i)
+            OGRE_DELETE i->second.buffer;
     }
     //-----------------------------------------------------------------------
     VertexDeclaration* HardwareBufferManagerBase::createVertexDeclaration(void)
@@ -304,6 +406,22 @@ namespace Ogre {
             }
         }
 
+        // Destroy the staging buffers which have been idle for too long
+        {
+            OGRE_LOCK_MUTEX(mStagingBuffersMutex);
+            FreeStagingBufferMap::iterator s = mFreeStagingBuffers.begin();
+            while (s != mFreeStagingBuffers.end())
+            {
+                FreeStagingBufferMap::iterator scur = s++;
+                if (forceFreeUnused || ++scur->second.idleFrames >= STAGING_BUFFER_EXPIRED_FRAME_THRESHOLD)
+                {
+                    mFreeStagingBufferBytes -= scur->first;
+                    OGRE_DELETE scur->second.buffer;
+                    mFreeStagingBuffers.erase(scur);
+                }
+            }
+        }
+
         // Check whether or not free unused temporary vertex buffers.
         if (forceFreeUnused)
         {
@@ -331,6 +449,261 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    HardwareBuffer* HardwareBufferManagerBase::allocateStagingBuffer(size_t sizeInBytes)
+    {
+        size_t size = STAGING_BUFFER_MIN_SIZE;
+        while (size < sizeInBytes)
+            size <<= 1;
+
+        {
+            OGRE_LOCK_MUTEX(mStagingBuffersMutex);
+            FreeStagingBufferMap::iterator i = mFreeStagingBuffers.find(size);
+            if (i != mFreeStagingBuffers.end())
+            {
+                HardwareBuffer* buffer = i->second.buffer;
+                mFreeStagingBuffers.erase(i);
+                mFreeStagingBufferBytes -= size;
+                return buffer;
+            }
+        }
+
+        return createStagingBufferImpl(size);
+    }
+    //-----------------------------------------------------------------------
+    void HardwareBufferManagerBase::releaseStagingBuffer(HardwareBuffer* buffer)
+    {
+        size_t size = buffer->getSizeInBytes();
+
+        {
+            OGRE_LOCK_MUTEX(mStagingBuffersMutex);
+            if (mFreeStagingBufferBytes + size <= mStagingBufferBudget)
+            {
+                StagingBufferEntry entry;
+                entry.buffer = buffer;
+                entry.idleFrames = 0;
+                mFreeStagingBuffers.insert(FreeStagingBufferMap::value_type(size, entry));
+                mFreeStagingBufferBytes += size;
+                return;
+            }
+        }
+
+        OGRE_DELETE buffer;
+    }
+    //-----------------------------------------------------------------------
+    void HardwareBufferManagerBase::setStagingBufferBudget(size_t sizeInBytes)
+    {
+        OGRE_LOCK_MUTEX(mStagingBuffersMutex);
+        mStagingBufferBudget = sizeInBytes;
+
+        // Destroy the largest buffers first, they are the least likely to be reused
+        while (mFreeStagingBufferBytes > mStagingBufferBudget)
+        {
+            FreeStagingBufferMap::iterator i = --mFreeStagingBuffers.end();
+            mFreeStagingBufferBytes -= i->first;
+            OGRE_DELETE i->second.buffer;
+            mFreeStagingBuffers.erase(i);
+        }
+    }
+    //-----------------------------------------------------------------------
+    HardwareBuffer* HardwareBufferManagerBase::createStagingBufferImpl(size_t sizeInBytes)
+    {
+        return OGRE_NEW DefaultHardwareVertexBuffer(1, sizeInBytes, HardwareBuffer::HBU_DYNAMIC);
+    }
+    //-----------------------------------------------------------------------
+    namespace
+    {
+        typedef map<size_t, size_t>::type RangeMap;
+
+        /// Reserves a range of count elements, first fit.
+        bool allocateRange(RangeMap& freeRanges, size_t count, size_t& start)
+        {
+            for (RangeMap::iterator i = freeRanges.begin(); i != freeRanges.end(); ++i)
+            {
+                if (i->second >= count)
+                {
+                    start = i->first;
+                    if (i->second > count)
+                        freeRanges[start + count] = i->second - count;
+                    freeRanges.erase(i);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /// Gives back a range, merging it with the adjacent free ranges.
+        void freeRange(RangeMap& freeRanges, size_t start, size_t count)
+        {
+            RangeMap::iterator next = freeRanges.lower_bound(start);
+            if (next != freeRanges.end() && start + count == next->first)
+            {
+                count += next->second;
+                freeRanges.erase(next++);
+            }
+            if (next != freeRanges.begin())
+            {
+                RangeMap::iterator prev = next;
+                --prev;
+                if (prev->first + prev->second == start)
+                {
+                    prev->second += count;
+                    return;
+                }
+            }
+            freeRanges.insert(next, RangeMap::value_type(start, count));
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool HardwareBufferManagerBase::subAllocateVertexData(VertexData* vertexData,
+        HardwareBuffer::Usage usage, bool useShadowBuffer)
+    {
+        assert(vertexData->vertexBufferBinding->getBufferCount() == 0 &&
+            "Vertex data to sub-allocate must not have buffers bound");
+
+        VertexDeclaration* decl = vertexData->vertexDeclaration;
+        if (decl->getElementCount() == 0 || vertexData->vertexCount == 0)
+            return false;
+
+        ArenaKey key;
+        key.push_back(usage);
+        key.push_back(useShadowBuffer);
+        size_t vertexSize = 0;
+        unsigned short numSources = decl->getMaxSource() + 1;
+        for (unsigned short s = 0; s < numSources; ++s)
+        {
+            size_t sourceSize = decl->getVertexSize(s);
+            // Gaps between sources would leave unbound buffers
+            if (sourceSize == 0)
+                return false;
+            key.push_back(sourceSize);
+            vertexSize += sourceSize;
+        }
+
+        if (vertexData->vertexCount * vertexSize * 4 > mArenaSize)
+            return false;
+
+        OGRE_LOCK_MUTEX(mArenasMutex);
+        size_t start = 0;
+        VertexArena* arena = 0;
+        std::pair<VertexArenaMap::iterator, VertexArenaMap::iterator> range = mVertexArenas.equal_range(key);
+        for (VertexArenaMap::iterator i = range.first; i != range.second && !arena; ++i)
+        {
+            if (allocateRange(i->second->freeRanges, vertexData->vertexCount, start))
+                arena = i->second;
+        }
+
+        if (!arena)
+        {
+            arena = OGRE_NEW VertexArena();
+            arena->capacity = mArenaSize / vertexSize;
+            for (unsigned short s = 0; s < numSources; ++s)
+            {
+                arena->buffers.push_back(createVertexBuffer(
+                    key[s + 2], arena->capacity, usage, useShadowBuffer));
+            }
+            arena->freeRanges[0] = arena->capacity;
+            allocateRange(arena->freeRanges, vertexData->vertexCount, start);
+            mVertexArenas.insert(VertexArenaMap::value_type(key, arena));
+        }
+
+        for (unsigned short s = 0; s < numSources; ++s)
+            vertexData->vertexBufferBinding->setBinding(s, arena->buffers[s]);
+        vertexData->vertexStart = start;
+        vertexData->subAllocated = true;
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    bool HardwareBufferManagerBase::subAllocateIndexData(IndexData* indexData,
+        HardwareIndexBuffer::IndexType itype, HardwareBuffer::Usage usage, bool useShadowBuffer)
+    {
+        size_t indexSize = itype == HardwareIndexBuffer::IT_32BIT ? sizeof(uint32) : sizeof(uint16);
+        if (indexData->indexCount == 0 || indexData->indexCount * indexSize * 4 > mArenaSize)
+            return false;
+
+        ArenaKey key;
+        key.push_back(usage);
+        key.push_back(useShadowBuffer);
+        key.push_back(itype);
+
+        OGRE_LOCK_MUTEX(mArenasMutex);
+        size_t start = 0;
+        IndexArena* arena = 0;
+        std::pair<IndexArenaMap::iterator, IndexArenaMap::iterator> range = mIndexArenas.equal_range(key);
+        for (IndexArenaMap::iterator i = range.first; i != range.second && !arena; ++i)
+        {
+            if (allocateRange(i->second->freeRanges, indexData->indexCount, start))
+                arena = i->second;
+        }
+
+        if (!arena)
+        {
+            arena = OGRE_NEW IndexArena();
+            arena->capacity = mArenaSize / indexSize;
+            arena->buffer = createIndexBuffer(itype, arena->capacity, usage, useShadowBuffer);
+            arena->freeRanges[0] = arena->capacity;
+            allocateRange(arena->freeRanges, indexData->indexCount, start);
+            mIndexArenas.insert(IndexArenaMap::value_type(key, arena));
+        }
+
+        indexData->indexBuffer = arena->buffer;
+        indexData->indexStart = start;
+        indexData->subAllocated = true;
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void HardwareBufferManagerBase::setSubAllocationArenaSize(size_t sizeInBytes)
+    {
+        OGRE_LOCK_MUTEX(mArenasMutex);
+        mArenaSize = sizeInBytes;
+    }
+    //-----------------------------------------------------------------------
+    void HardwareBufferManagerBase::_freeSubAllocatedVertexData(VertexData* vertexData)
+    {
+        if (!vertexData->vertexBufferBinding->isBufferBound(0))
+            return;
+        HardwareVertexBuffer* buffer = vertexData->vertexBufferBinding->getBuffer(0).get();
+
+        OGRE_LOCK_MUTEX(mArenasMutex);
+        for (VertexArenaMap::iterator i = mVertexArenas.begin(); i != mVertexArenas.end(); ++i)
+        {
+            VertexArena* arena = i->second;
+            if (arena->buffers[0].get() == buffer)
+            {
+                freeRange(arena->freeRanges, vertexData->vertexStart, vertexData->vertexCount);
+                vertexData->subAllocated = false;
+                // Destroy arenas no longer used, the vertex data still holds the buffers
+                if (arena->freeRanges.begin()->second == arena->capacity)
+                {
+                    OGRE_DELETE arena;
+                    mVertexArenas.erase(i);
+                }
+                return;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void HardwareBufferManagerBase::_freeSubAllocatedIndexData(IndexData* indexData)
+    {
+        HardwareIndexBuffer* buffer = indexData->indexBuffer.get();
+
+        OGRE_LOCK_MUTEX(mArenasMutex);
+        for (IndexArenaMap::iterator i = mIndexArenas.begin(); i != mIndexArenas.end(); ++i)
+        {
+            IndexArena* arena = i->second;
+            if (arena->buffer.get() == buffer)
+            {
+                freeRange(arena->freeRanges, indexData->indexStart, indexData->indexCount);
+                indexData->subAllocated = false;
+                if (arena->freeRanges.begin()->second == arena->capacity)
+                {
+                    OGRE_DELETE arena;
+                    mIndexArenas.erase(i);
+                }
+                return;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
     void HardwareBufferManagerBase::_forceReleaseBufferCopies(
         const HardwareVertexBufferSharedPtr& sourceBuffer)
     {
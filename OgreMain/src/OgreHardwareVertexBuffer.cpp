@@ -182,6 +182,12 @@ namespace Ogre {
             return sizeof(unsigned int)*4;
         case VET_UBYTE4:
             return sizeof(unsigned char)*4;
+        case VET_HALF2:
+        case VET_SHORT2_NORM:
+            return sizeof(short)*2;
+        case VET_HALF4:
+        case VET_SHORT4_NORM:
+            return sizeof(short)*4;
         }
         return 0;
     }
@@ -206,6 +212,8 @@ namespace Ogre {
         case VET_UINT2:
         case VET_INT2:
         case VET_DOUBLE2:
+        case VET_HALF2:
+        case VET_SHORT2_NORM:
             return 2;
         case VET_FLOAT3:
         case VET_SHORT3:
@@ -221,6 +229,8 @@ namespace Ogre {
         case VET_INT4:
         case VET_DOUBLE4:
         case VET_UBYTE4:
+        case VET_HALF4:
+        case VET_SHORT4_NORM:
             return 4;
         }
         OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid type", 
@@ -262,6 +272,28 @@ namespace Ogre {
                 break;
             }
             break;
+        case VET_HALF2:
+            switch(count)
+            {
+            case 2:
+                return VET_HALF2;
+            case 4:
+                return VET_HALF4;
+            default:
+                break;
+            }
+            break;
+        case VET_SHORT2_NORM:
+            switch(count)
+            {
+            case 2:
+                return VET_SHORT2_NORM;
+            case 4:
+                return VET_SHORT4_NORM;
+            default:
+                break;
+            }
+            break;
         default:
             break;
         }
@@ -361,6 +393,13 @@ namespace Ogre {
                 return VET_USHORT1;
             case VET_UBYTE4:
                 return VET_UBYTE4;
+            // No single component variants; the pair is the smallest unit
+            case VET_HALF2:
+            case VET_HALF4:
+                return VET_HALF2;
+            case VET_SHORT2_NORM:
+            case VET_SHORT4_NORM:
+                return VET_SHORT2_NORM;
         };
         // To keep compiler happy
         return VET_FLOAT1;
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "OgreException.h"
 #include "OgreGpuProgramManager.h"
 #include "OgreLogManager.h"
+#include "OgreResourceLoadTrace.h"
 
 namespace Ogre
 {
@@ -46,8 +47,12 @@ namespace Ogre
     {
         if (isSupported())
         {
+            ResourceLoadTraceScope trace(RLP_COMPILE, mName);
             // load self 
-            loadHighLevel();
+            {
+                GpuProgramManager::CompileTimer timer(GpuProgramManager::CS_COMPILE, mName);
+                loadHighLevel();
+            }
 
             // create low-level implementation
             createLowLevelImpl();
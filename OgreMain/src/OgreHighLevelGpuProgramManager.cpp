@@ -195,9 +195,9 @@ namespace Ogre {
             const String& name, const String& groupName, 
             const String& language, GpuProgramType gptype)
     {
-        ResourcePtr ret = ResourcePtr(
-            getFactory(language)->create(this, name, getNextHandle(), 
-            groupName, false, 0));
+        Resource* res = getFactory(language)->create(this, name, getNextHandle(), 
+            groupName, false, 0);
+        ResourcePtr ret = ResourcePtr(res, res->_getSharedPtrInfo());
 
         HighLevelGpuProgramPtr prg = ret.staticCast<HighLevelGpuProgram>();
         prg->setType(gptype);
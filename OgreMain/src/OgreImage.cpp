@@ -31,12 +31,35 @@ THE SOFTWARE.
 #include "OgreImageCodec.h"
 #include "OgreColourValue.h"
 #include "OgreMath.h"
+#include "OgreOptimisedUtil.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
 #include "OgreImageResampler.h"
 #include "OgreResourceGroupManager.h"
+#include "OgreFileSystem.h"
+#include "OgreResourceLoadTrace.h"
 
 namespace Ogre {
     ImageCodec::~ImageCodec() {
     }
+    //-----------------------------------------------------------------------------
+    MemoryDataStreamPtr ImageCodec::readPixelData(DataStreamPtr& stream, size_t size,
+        ImageData* imgData)
+    {
+        // Only mappings: other memory streams may be wrapping memory the caller frees
+        MappedFileDataStream* mapped = dynamic_cast<MappedFileDataStream*>(stream.get());
+        if (mapped && mapped->size() - mapped->tell() >= size)
+        {
+            MemoryDataStreamPtr view(OGRE_NEW MemoryDataStream(mapped->getCurrentPtr(), size));
+            mapped->skip(static_cast<long>(size));
+            imgData->source = stream;
+            return view;
+        }
+
+        MemoryDataStreamPtr output(OGRE_NEW MemoryDataStream(size));
+        stream->read(output->getPtr(), size);
+        return output;
+    }
 
     //-----------------------------------------------------------------------------
     Image::Image()
@@ -75,7 +98,7 @@ namespace Ogre {
             OGRE_FREE(mBuffer, MEMCATEGORY_GENERAL);
             mBuffer = NULL;
         }
-
+        mBufferSource.setNull();
     }
 
     //-----------------------------------------------------------------------------
@@ -91,6 +114,7 @@ namespace Ogre {
         mPixelSize = img.mPixelSize;
         mNumMipmaps = img.mNumMipmaps;
         mAutoDelete = img.mAutoDelete;
+        mBufferSource = img.mBufferSource;
         //Only create/copy when previous data was not dynamic data
         if( mAutoDelete )
         {
@@ -406,6 +430,7 @@ namespace Ogre {
         "Image::load" );
         }
 
+        ResourceLoadTraceScope trace(RLP_DECODE, stream->getName(), stream->size());
         Codec::DecodeResult res = pCodec->decode(stream);
 
         ImageCodec::ImageData* pData = 
@@ -425,11 +450,60 @@ namespace Ogre {
         mBuffer = res.first->getPtr();
         // Make sure stream does not delete
         res.first->setFreeOnClose(false);
-        // make sure we delete
-        mAutoDelete = true;
+        // make sure we delete, unless the codec read the source in place
+        mBufferSource = pData->source;
+        mAutoDelete = mBufferSource.isNull();
 
         return *this;
     }
+    //-----------------------------------------------------------------------------
+    namespace
+    {
+        /// Decodes images from streams in memory
+        class ImageDecodeTask : public WorkQueue::ParallelTask
+        {
+            Image* mImages;
+            DataStreamPtr* mStreams;
+            const String& mType;
+        public:
+            ImageDecodeTask(Image* images, DataStreamPtr* streams, const String& type)
+                : mImages(images), mStreams(streams), mType(type) {}
+
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                    mImages[i].load(mStreams[i], mType);
+            }
+        };
+    }
+    void Image::loadParallel(vector<Image>::type& images,
+        const vector<DataStreamPtr>::type& streams, const String& type)
+    {
+        if (streams.empty())
+            return;
+
+        vector<DataStreamPtr>::type memStreams;
+        memStreams.reserve(streams.size());
+        for (vector<DataStreamPtr>::type::const_iterator i = streams.begin(); i != streams.end(); ++i)
+        {
+            DataStreamPtr stream = *i;
+            if (!dynamic_cast<MemoryDataStream*>(stream.get()))
+                stream.bind(OGRE_NEW MemoryDataStream(stream->getName(), stream));
+            memStreams.push_back(stream);
+        }
+
+        size_t first = images.size();
+        images.resize(first + memStreams.size());
+
+        ImageDecodeTask task(&images[first], &memStreams[0], type);
+        Root* root = Root::getSingletonPtr();
+        WorkQueue* queue = root ? root->getWorkQueue() : 0;
+        // Images vary a lot in size, hand them out one at a time
+        if (queue)
+            queue->parallelFor(memStreams.size(), 1, &task);
+        else
+            task.execute(0, memStreams.size());
+    }
     //---------------------------------------------------------------------
     String Image::getFileExtFromMagic(DataStreamPtr stream)
     {
@@ -558,13 +632,16 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void Image::resize(ushort width, ushort height, Filter filter)
     {
-        // resizing dynamic images is not supported
-        assert(mAutoDelete);
+        // resizing dynamic images is not supported, unless decoded in place
+        assert(mAutoDelete || !mBufferSource.isNull());
         assert(mDepth == 1);
 
-        // reassign buffer to temp image, make sure auto-delete is true
+        // reassign buffer to temp image, which deletes it if we owned it
         Image temp;
-        temp.loadDynamicImage(mBuffer, mWidth, mHeight, 1, mFormat, true);
+        temp.loadDynamicImage(mBuffer, mWidth, mHeight, 1, mFormat, mAutoDelete);
+        temp.mBufferSource = mBufferSource;
+        mBufferSource.setNull();
+        mAutoDelete = true;
         // do not delete[] mBuffer!  temp will destroy it
 
         // set new dimensions, allocate new buffer
@@ -624,56 +701,63 @@ namespace Ogre {
 
         case FILTER_LINEAR:
         case FILTER_BILINEAR:
-            switch (src.format) 
-            {
-            case PF_L8: case PF_A8: case PF_BYTE_LA:
-            case PF_R8G8B8: case PF_B8G8R8:
-            case PF_R8G8B8A8: case PF_B8G8R8A8:
-            case PF_A8B8G8R8: case PF_A8R8G8B8:
-            case PF_X8B8G8R8: case PF_X8R8G8B8:
-                if(src.format == scaled.format) 
-                {
-                    // No intermediate buffer needed
-                    temp = scaled;
-                }
-                else
-                {
-                    // Allocate temp buffer of destination size in source format 
-                    temp = PixelBox(scaled.getWidth(), scaled.getHeight(), scaled.getDepth(), src.format);
-                    buf.bind(OGRE_NEW MemoryDataStream(temp.getConsecutiveSize()));
-                    temp.data = buf->getPtr();
-                }
-                // super-optimized: byte-oriented math, no conversion
-                switch (PixelUtil::getNumElemBytes(src.format)) 
-                {
-                case 1: LinearResampler_Byte<1>::scale(src, temp); break;
-                case 2: LinearResampler_Byte<2>::scale(src, temp); break;
-                case 3: LinearResampler_Byte<3>::scale(src, temp); break;
-                case 4: LinearResampler_Byte<4>::scale(src, temp); break;
-                default:
-                    // never reached
-                    assert(false);
-                }
-                if(temp.data != scaled.data)
-                {
-                    // Blit temp buffer
-                    PixelUtil::bulkPixelConversion(temp, scaled);
-                }
+            // 2D: separable, multithreaded and with SIMD for 8-bit and float32 channels
+            if(SeparableResampler::scale(src, scaled, filter))
                 break;
-            case PF_FLOAT32_RGB:
-            case PF_FLOAT32_RGBA:
-                if (scaled.format == PF_FLOAT32_RGB || scaled.format == PF_FLOAT32_RGBA)
-                {
-                    // float32 to float32, avoid unpack/repack overhead
-                    LinearResampler_Float32::scale(src, scaled);
-                    break;
-                }
-                // else, fall through
-            default:
+            if((src.format == PF_FLOAT32_RGB || src.format == PF_FLOAT32_RGBA) &&
+               (scaled.format == PF_FLOAT32_RGB || scaled.format == PF_FLOAT32_RGBA))
+            {
+                // float32 to float32, avoid unpack/repack overhead
+                LinearResampler_Float32::scale(src, scaled);
+            }
+            else
+            {
                 // non-optimized: floating-point math, performs conversion but always works
                 LinearResampler::scale(src, scaled);
             }
             break;
+
+        case FILTER_BOX:
+        case FILTER_TRIANGLE:
+        case FILTER_BICUBIC:
+        case FILTER_LANCZOS:
+        case FILTER_KAISER:
+            // 3D volumes are only filtered linearly
+            if(!SeparableResampler::scale(src, scaled, filter))
+                LinearResampler::scale(src, scaled);
+            break;
+        }
+    }
+    //-----------------------------------------------------------------------------
+    void Image::generateMipmaps(Filter filter)
+    {
+        if(PixelUtil::isCompressed(mFormat))
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+            "Mipmaps can not be generated for compressed images",
+            "Image::generateMipmaps");
+
+        // A level for each halving of the largest dimension, down to 1x1x1
+        uint32 numMips = 0;
+        for(uint32 size = std::max(std::max(mWidth, mHeight), mDepth); size > 1; size /= 2)
+            ++numMips;
+
+        // Hand the current buffer to temp, which deletes it if we owned it
+        size_t numFaces = getNumFaces();
+        Image temp;
+        temp.loadDynamicImage(mBuffer, mWidth, mHeight, mDepth, mFormat, mAutoDelete, numFaces, mNumMipmaps);
+        temp.mBufferSource = mBufferSource;
+        mBufferSource.setNull();
+
+        mNumMipmaps = numMips;
+        mBufSize = calculateSize(mNumMipmaps, numFaces, mWidth, mHeight, mDepth, mFormat);
+        mBuffer = OGRE_ALLOC_T(uchar, mBufSize, MEMCATEGORY_GENERAL);
+        mAutoDelete = true;
+
+        for(size_t face = 0; face < numFaces; ++face)
+        {
+            PixelUtil::bulkPixelConversion(temp.getPixelBox(face, 0), getPixelBox(face, 0));
+            for(uint32 mip = 1; mip <= mNumMipmaps; ++mip)
+                Image::scale(getPixelBox(face, mip - 1), getPixelBox(face, mip), filter);
         }
     }
 
@@ -0,0 +1,634 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreImageCompressor.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
+#include <climits>
+
+namespace Ogre {
+    // All block encoders take a 4x4 block of RGBA bytes in row order
+
+    /// ETC1 intensity modifiers, indexed by table and pixel index
+    static const int ETC_MODIFIERS[8][4] =
+    {
+        { 2, 8, -2, -8 }, { 5, 17, -5, -17 }, { 9, 29, -9, -29 }, { 13, 42, -13, -42 },
+        { 18, 60, -18, -60 }, { 24, 80, -24, -80 }, { 33, 106, -33, -106 }, { 47, 183, -47, -183 }
+    };
+    /// EAC alpha modifiers, indexed by table and pixel index
+    static const int EAC_MODIFIERS[16][8] =
+    {
+        { -3, -6, -9, -15, 2, 5, 8, 14 }, { -3, -7, -10, -13, 2, 6, 9, 12 },
+        { -2, -5, -8, -13, 1, 4, 7, 12 }, { -2, -4, -6, -13, 1, 3, 5, 12 },
+        { -3, -6, -8, -12, 2, 5, 7, 11 }, { -3, -7, -9, -11, 2, 6, 8, 10 },
+        { -4, -7, -8, -11, 3, 6, 7, 10 }, { -3, -5, -8, -11, 2, 4, 7, 10 },
+        { -2, -6, -8, -10, 1, 5, 7, 9 }, { -2, -5, -8, -10, 1, 4, 7, 9 },
+        { -2, -4, -8, -10, 1, 3, 7, 9 }, { -2, -5, -7, -10, 1, 4, 6, 9 },
+        { -3, -4, -7, -10, 2, 3, 6, 9 }, { -1, -2, -3, -10, 0, 1, 2, 9 },
+        { -4, -6, -8, -9, 3, 5, 7, 8 }, { -3, -5, -7, -9, 2, 4, 6, 8 }
+    };
+    //-----------------------------------------------------------------------
+    static inline int clampByte(int v)
+    {
+        return v < 0 ? 0 : (v > 255 ? 255 : v);
+    }
+    //-----------------------------------------------------------------------
+    static inline uint16 packColour565(const float* c)
+    {
+        int r = std::min(std::max(int(c[0] * (31.0f / 255.0f) + 0.5f), 0), 31);
+        int g = std::min(std::max(int(c[1] * (63.0f / 255.0f) + 0.5f), 0), 63);
+        int b = std::min(std::max(int(c[2] * (31.0f / 255.0f) + 0.5f), 0), 31);
+        return static_cast<uint16>((r << 11) | (g << 5) | b);
+    }
+    //-----------------------------------------------------------------------
+    static inline void unpackColour565(uint16 c, int* rgb)
+    {
+        int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+        rgb[0] = (r << 3) | (r >> 2);
+        rgb[1] = (g << 2) | (g >> 4);
+        rgb[2] = (b << 3) | (b >> 2);
+    }
+    //-----------------------------------------------------------------------
+    /** Quantises a pair of colour endpoints and picks the nearest of the four
+        palette entries for each pixel. Returns the squared error.
+    */
+    static int fitColourEndpoints(const uint8* block, const float* a, const float* b,
+        uint16& c0, uint16& c1, uint32& indices)
+    {
+        c0 = packColour565(a);
+        c1 = packColour565(b);
+        // Four colour mode needs c0 > c1, which swapping the ends keeps
+        if (c0 < c1)
+            std::swap(c0, c1);
+
+        int palette[4][3];
+        unpackColour565(c0, palette[0]);
+        unpackColour565(c1, palette[1]);
+        for (int c = 0; c < 3; ++c)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        // Equal ends select three colour mode, where only index 0 is safe
+        const int numEntries = c0 == c1 ? 1 : 4;
+
+        int error = 0;
+        indices = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            const uint8* p = block + i * 4;
+            int best = INT_MAX;
+            uint32 bestIndex = 0;
+            for (int e = 0; e < numEntries; ++e)
+            {
+                int dr = palette[e][0] - p[0], dg = palette[e][1] - p[1], db = palette[e][2] - p[2];
+                int d = dr * dr + dg * dg + db * db;
+                if (d < best)
+                {
+                    best = d;
+                    bestIndex = e;
+                }
+            }
+            indices |= bestIndex << (i * 2);
+            error += best;
+        }
+        return error;
+    }
+    //-----------------------------------------------------------------------
+    /// Encodes the colour half of a DXT block, always in four colour mode
+    static void encodeColourBlock(const uint8* block, uint8* out)
+    {
+        float mean[3] = { 0, 0, 0 };
+        for (int i = 0; i < 16; ++i)
+            for (int c = 0; c < 3; ++c)
+                mean[c] += block[i * 4 + c];
+        for (int c = 0; c < 3; ++c)
+            mean[c] /= 16.0f;
+
+        // Principal axis of the colours by power iteration on their covariance
+        float cov[3][3] = { { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 } };
+        for (int i = 0; i < 16; ++i)
+        {
+            float d[3];
+            for (int c = 0; c < 3; ++c)
+                d[c] = block[i * 4 + c] - mean[c];
+            for (int r = 0; r < 3; ++r)
+                for (int c = 0; c < 3; ++c)
+                    cov[r][c] += d[r] * d[c];
+        }
+        float axis[3] = { 1, 1, 1 };
+        for (int iter = 0; iter < 8; ++iter)
+        {
+            float v[3];
+            for (int r = 0; r < 3; ++r)
+                v[r] = cov[r][0] * axis[0] + cov[r][1] * axis[1] + cov[r][2] * axis[2];
+            float len = std::max(std::max(std::abs(v[0]), std::abs(v[1])), std::abs(v[2]));
+            if (len < 1e-6f)
+                break;
+            for (int r = 0; r < 3; ++r)
+                axis[r] = v[r] / len;
+        }
+        float lenSq = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+        float tmin = 0, tmax = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            float t = 0;
+            for (int c = 0; c < 3; ++c)
+                t += (block[i * 4 + c] - mean[c]) * axis[c];
+            tmin = std::min(tmin, t);
+            tmax = std::max(tmax, t);
+        }
+        // Pull the ends in slightly, as the extremes are rarely worth an exact match
+        float inset = (tmax - tmin) / 16.0f;
+        tmin = (tmin + inset) / lenSq;
+        tmax = (tmax - inset) / lenSq;
+
+        float a[3], b[3];
+        for (int c = 0; c < 3; ++c)
+        {
+            a[c] = mean[c] + axis[c] * tmax;
+            b[c] = mean[c] + axis[c] * tmin;
+        }
+        uint16 c0, c1;
+        uint32 indices;
+        int error = fitColourEndpoints(block, a, b, c0, c1, indices);
+
+        // Refine the ends with a least squares fit to the chosen indices
+        if (error > 0 && c0 != c1)
+        {
+            static const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+            float aa = 0, ab = 0, bb = 0, ax[3] = { 0, 0, 0 }, bx[3] = { 0, 0, 0 };
+            for (int i = 0; i < 16; ++i)
+            {
+                float wa = weights[(indices >> (i * 2)) & 3], wb = 1.0f - wa;
+                aa += wa * wa;
+                ab += wa * wb;
+                bb += wb * wb;
+                for (int c = 0; c < 3; ++c)
+                {
+                    ax[c] += wa * block[i * 4 + c];
+                    bx[c] += wb * block[i * 4 + c];
+                }
+            }
+            float det = aa * bb - ab * ab;
+            if (std::abs(det) > 1e-6f)
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    a[c] = (ax[c] * bb - bx[c] * ab) / det;
+                    b[c] = (bx[c] * aa - ax[c] * ab) / det;
+                }
+                uint16 r0, r1;
+                uint32 refined;
+                if (fitColourEndpoints(block, a, b, r0, r1, refined) < error)
+                {
+                    c0 = r0;
+                    c1 = r1;
+                    indices = refined;
+                }
+            }
+        }
+
+        out[0] = static_cast<uint8>(c0);
+        out[1] = static_cast<uint8>(c0 >> 8);
+        out[2] = static_cast<uint8>(c1);
+        out[3] = static_cast<uint8>(c1 >> 8);
+        for (int i = 0; i < 4; ++i)
+            out[4 + i] = static_cast<uint8>(indices >> (i * 8));
+    }
+    //-----------------------------------------------------------------------
+    /// Encodes one channel as a BC4 block, which is also the DXT5 alpha block
+    static void encodeChannelBlock(const uint8* block, uint8* out)
+    {
+        int lo = 255, hi = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            lo = std::min(lo, int(block[i * 4]));
+            hi = std::max(hi, int(block[i * 4]));
+        }
+        out[0] = static_cast<uint8>(hi);
+        out[1] = static_cast<uint8>(lo);
+
+        // Eight value mode: the ends, then six steps from hi towards lo
+        uint64 bits = 0;
+        if (hi > lo)
+        {
+            int palette[8];
+            palette[0] = hi;
+            palette[1] = lo;
+            for (int e = 2; e < 8; ++e)
+                palette[e] = ((8 - e) * hi + (e - 1) * lo) / 7;
+
+            for (int i = 0; i < 16; ++i)
+            {
+                int v = block[i * 4], best = INT_MAX;
+                uint64 bestIndex = 0;
+                for (int e = 0; e < 8; ++e)
+                {
+                    int d = std::abs(palette[e] - v);
+                    if (d < best)
+                    {
+                        best = d;
+                        bestIndex = e;
+                    }
+                }
+                bits |= bestIndex << (i * 3);
+            }
+        }
+        for (int i = 0; i < 6; ++i)
+            out[2 + i] = static_cast<uint8>(bits >> (i * 8));
+    }
+    //-----------------------------------------------------------------------
+    /// Encodes alpha as explicit four bit values, for DXT3
+    static void encodeExplicitAlphaBlock(const uint8* block, uint8* out)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            int a0 = (block[i * 8 + 3] * 15 + 127) / 255;
+            int a1 = (block[i * 8 + 7] * 15 + 127) / 255;
+            out[i] = static_cast<uint8>(a0 | (a1 << 4));
+        }
+    }
+    //-----------------------------------------------------------------------
+    /** Picks the modifier table and pixel indices that best match one ETC
+        sub-block to a base colour. Returns the squared error, or bestError if
+        no table does better than that.
+    */
+    static int fitEtcSubblock(const uint8* block, const int* pixels, const int* base,
+        int bestError, uint32& table, uint8* indices)
+    {
+        int tableError = bestError;
+        for (uint32 t = 0; t < 8; ++t)
+        {
+            int error = 0;
+            uint8 chosen[8];
+            for (int i = 0; i < 8 && error < tableError; ++i)
+            {
+                const uint8* p = block + pixels[i] * 4;
+                int best = INT_MAX;
+                for (int m = 0; m < 4; ++m)
+                {
+                    int dr = clampByte(base[0] + ETC_MODIFIERS[t][m]) - p[0];
+                    int dg = clampByte(base[1] + ETC_MODIFIERS[t][m]) - p[1];
+                    int db = clampByte(base[2] + ETC_MODIFIERS[t][m]) - p[2];
+                    int d = dr * dr + dg * dg + db * db;
+                    if (d < best)
+                    {
+                        best = d;
+                        chosen[i] = static_cast<uint8>(m);
+                    }
+                }
+                error += best;
+            }
+            if (error < tableError)
+            {
+                tableError = error;
+                table = t;
+                memcpy(indices, chosen, sizeof(chosen));
+            }
+        }
+        return tableError;
+    }
+    //-----------------------------------------------------------------------
+    /** Encodes colour as an ETC1 block, which is also a valid ETC2 block since
+        differential mode is only used when the second base colour fits.
+    */
+    static void encodeEtcBlock(const uint8* block, uint8* out)
+    {
+        int bestError = INT_MAX;
+        uint32 bestHigh = 0, bestLow = 0;
+
+        for (uint32 flip = 0; flip < 2; ++flip)
+        {
+            // Without flip the sub-blocks are 2x4 side by side, with it 4x2 stacked
+            int pixels[2][8];
+            for (int i = 0; i < 8; ++i)
+            {
+                int u = i & 1, v = i >> 1;
+                pixels[0][i] = flip ? u * 4 + v : v * 4 + u;
+                pixels[1][i] = flip ? (u + 2) * 4 + v : v * 4 + u + 2;
+            }
+
+            float mean[2][3];
+            for (int s = 0; s < 2; ++s)
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    int sum = 0;
+                    for (int i = 0; i < 8; ++i)
+                        sum += block[pixels[s][i] * 4 + c];
+                    mean[s][c] = sum / 8.0f;
+                }
+            }
+
+            int q5[2][3];
+            bool canDiff = true;
+            for (int c = 0; c < 3; ++c)
+            {
+                q5[0][c] = std::min(int(mean[0][c] * (31.0f / 255.0f) + 0.5f), 31);
+                q5[1][c] = std::min(int(mean[1][c] * (31.0f / 255.0f) + 0.5f), 31);
+                int delta = q5[1][c] - q5[0][c];
+                canDiff = canDiff && delta >= -4 && delta <= 3;
+            }
+
+            // Try differential mode first when it fits, then individual mode
+            for (uint32 mode = canDiff ? 0 : 1; mode < 2; ++mode)
+            {
+                const uint32 diff = mode == 0 ? 1 : 0;
+                int quant[2][3], base[2][3];
+                for (int s = 0; s < 2; ++s)
+                {
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        if (diff)
+                        {
+                            quant[s][c] = q5[s][c];
+                            base[s][c] = (quant[s][c] << 3) | (quant[s][c] >> 2);
+                        }
+                        else
+                        {
+                            quant[s][c] = std::min(int(mean[s][c] * (15.0f / 255.0f) + 0.5f), 15);
+                            base[s][c] = quant[s][c] * 17;
+                        }
+                    }
+                }
+
+                uint32 tables[2];
+                uint8 indices[2][8];
+                int error = fitEtcSubblock(block, pixels[0], base[0], bestError, tables[0], indices[0]);
+                if (error >= bestError)
+                    continue;
+                error += fitEtcSubblock(block, pixels[1], base[1], bestError - error, tables[1], indices[1]);
+                if (error >= bestError)
+                    continue;
+
+                bestError = error;
+                if (diff)
+                {
+                    bestHigh = (quant[0][0] << 27) | (((quant[1][0] - quant[0][0]) & 7) << 24) |
+                        (quant[0][1] << 19) | (((quant[1][1] - quant[0][1]) & 7) << 16) |
+                        (quant[0][2] << 11) | (((quant[1][2] - quant[0][2]) & 7) << 8);
+                }
+                else
+                {
+                    bestHigh = (quant[0][0] << 28) | (quant[1][0] << 24) |
+                        (quant[0][1] << 20) | (quant[1][1] << 16) |
+                        (quant[0][2] << 12) | (quant[1][2] << 8);
+                }
+                bestHigh |= (tables[0] << 5) | (tables[1] << 2) | (diff << 1) | flip;
+
+                // Index bits run down the columns, MSBs in the upper half
+                bestLow = 0;
+                for (int s = 0; s < 2; ++s)
+                {
+                    for (int i = 0; i < 8; ++i)
+                    {
+                        int p = pixels[s][i];
+                        uint32 bit = (p & 3) * 4 + (p >> 2);
+                        bestLow |= ((indices[s][i] >> 1) << (bit + 16)) | ((indices[s][i] & 1u) << bit);
+                    }
+                }
+            }
+        }
+
+        for (int i = 0; i < 4; ++i)
+        {
+            out[i] = static_cast<uint8>(bestHigh >> (24 - i * 8));
+            out[4 + i] = static_cast<uint8>(bestLow >> (24 - i * 8));
+        }
+    }
+    //-----------------------------------------------------------------------
+    /// Encodes alpha as an ETC2 EAC block
+    static void encodeEacAlphaBlock(const uint8* block, uint8* out)
+    {
+        int lo = 255, hi = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            lo = std::min(lo, int(block[i * 4 + 3]));
+            hi = std::max(hi, int(block[i * 4 + 3]));
+        }
+
+        // Table 13 has a zero modifier, which reproduces flat alpha exactly
+        int bestBase = lo, bestMul = 1, bestTable = 13, bestError = INT_MAX;
+        uint64 bestBits = 0;
+        if (hi == lo)
+        {
+            for (int i = 0; i < 16; ++i)
+                bestBits |= uint64(4) << (45 - i * 3);
+        }
+        else
+        {
+            for (int t = 0; t < 16; ++t)
+            {
+                const int* mods = EAC_MODIFIERS[t];
+                int range = mods[7] - mods[3];
+                int guess = std::min(std::max((hi - lo + range / 2) / range, 1), 15);
+                for (int mul = std::max(guess - 1, 1); mul <= std::min(guess + 1, 15); ++mul)
+                {
+                    int centre = (lo + hi - (mods[3] + mods[7]) * mul) / 2;
+                    for (int base = clampByte(centre - 1); base <= clampByte(centre + 1); ++base)
+                    {
+                        int error = 0;
+                        uint64 bits = 0;
+                        for (int i = 0; i < 16 && error < bestError; ++i)
+                        {
+                            // Pixels are numbered down the columns
+                            int v = block[((i & 3) * 4 + (i >> 2)) * 4 + 3], best = INT_MAX;
+                            uint64 bestIndex = 0;
+                            for (int m = 0; m < 8; ++m)
+                            {
+                                int d = clampByte(base + mods[m] * mul) - v;
+                                d *= d;
+                                if (d < best)
+                                {
+                                    best = d;
+                                    bestIndex = m;
+                                }
+                            }
+                            error += best;
+                            bits |= bestIndex << (45 - i * 3);
+                        }
+                        if (error < bestError)
+                        {
+                            bestError = error;
+                            bestBase = base;
+                            bestMul = mul;
+                            bestTable = t;
+                            bestBits = bits;
+                        }
+                    }
+                }
+            }
+        }
+
+        out[0] = static_cast<uint8>(bestBase);
+        out[1] = static_cast<uint8>((bestMul << 4) | bestTable);
+        for (int i = 0; i < 6; ++i)
+            out[2 + i] = static_cast<uint8>(bestBits >> (40 - i * 8));
+    }
+    //-----------------------------------------------------------------------
+    static size_t getBlockSize(PixelFormat format)
+    {
+        switch (format)
+        {
+        case PF_DXT1:
+        case PF_BC4_UNORM:
+        case PF_ETC1_RGB8:
+        case PF_ETC2_RGB8:
+            return 8;
+        case PF_DXT3:
+        case PF_DXT5:
+        case PF_BC5_UNORM:
+        case PF_ETC2_RGBA8:
+            return 16;
+        default:
+            return 0;
+        }
+    }
+    //-----------------------------------------------------------------------
+    static void encodeBlock(PixelFormat format, const uint8* block, uint8* out)
+    {
+        switch (format)
+        {
+        case PF_DXT1:
+            encodeColourBlock(block, out);
+            break;
+        case PF_DXT3:
+            encodeExplicitAlphaBlock(block, out);
+            encodeColourBlock(block, out + 8);
+            break;
+        case PF_DXT5:
+            encodeChannelBlock(block + 3, out);
+            encodeColourBlock(block, out + 8);
+            break;
+        case PF_BC4_UNORM:
+            encodeChannelBlock(block, out);
+            break;
+        case PF_BC5_UNORM:
+            encodeChannelBlock(block, out);
+            encodeChannelBlock(block + 1, out + 8);
+            break;
+        case PF_ETC1_RGB8:
+        case PF_ETC2_RGB8:
+            encodeEtcBlock(block, out);
+            break;
+        case PF_ETC2_RGBA8:
+            encodeEacAlphaBlock(block, out);
+            encodeEtcBlock(block, out + 8);
+            break;
+        default:
+            break;
+        }
+    }
+    //-----------------------------------------------------------------------
+    /// Compresses rows of blocks from RGBA bytes, slice after slice
+    class BlockCompressTask : public WorkQueue::ParallelTask
+    {
+    public:
+        BlockCompressTask(const uint8* src, size_t width, size_t height, PixelFormat format, uint8* dest)
+            : mSrc(src), mWidth(width), mHeight(height), mFormat(format), mDest(dest)
+            , mBlockSize(getBlockSize(format)), mBlocksX((width + 3) / 4), mBlocksY((height + 3) / 4) {}
+
+        size_t getNumRows() const { return mBlocksY; }
+
+        void execute(size_t begin, size_t end)
+        {
+            uint8 block[64];
+            for (size_t row = begin; row < end; ++row)
+            {
+                size_t z = row / mBlocksY, by = row % mBlocksY;
+                const uint8* slice = mSrc + z * mWidth * mHeight * 4;
+                uint8* out = mDest + row * mBlocksX * mBlockSize;
+                for (size_t bx = 0; bx < mBlocksX; ++bx, out += mBlockSize)
+                {
+                    for (size_t y = 0; y < 4; ++y)
+                    {
+                        size_t sy = std::min(by * 4 + y, mHeight - 1);
+                        for (size_t x = 0; x < 4; ++x)
+                        {
+                            size_t sx = std::min(bx * 4 + x, mWidth - 1);
+                            memcpy(block + (y * 4 + x) * 4, slice + (sy * mWidth + sx) * 4, 4);
+                        }
+                    }
+                    encodeBlock(mFormat, block, out);
+                }
+            }
+        }
+
+    private:
+        const uint8* mSrc;
+        size_t mWidth, mHeight;
+        PixelFormat mFormat;
+        uint8* mDest;
+        size_t mBlockSize, mBlocksX, mBlocksY;
+    };
+    //-----------------------------------------------------------------------
+    bool ImageCompressor::isFormatSupported(PixelFormat format)
+    {
+        return getBlockSize(format) != 0;
+    }
+    //-----------------------------------------------------------------------
+    void ImageCompressor::compress(const PixelBox& src, const PixelBox& dst)
+    {
+        if (!isFormatSupported(dst.format))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Cannot compress to " + PixelUtil::getFormatName(dst.format),
+                "ImageCompressor::compress");
+        }
+        if (PixelUtil::isCompressed(src.format))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Source pixels are already compressed",
+                "ImageCompressor::compress");
+        }
+        if (src.getWidth() != dst.getWidth() || src.getHeight() != dst.getHeight() ||
+            src.getDepth() != dst.getDepth())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Source and destination sizes do not match",
+                "ImageCompressor::compress");
+        }
+
+        // Work from plain RGBA bytes whatever the source format
+        const size_t width = src.getWidth(), height = src.getHeight(), depth = src.getDepth();
+        MemoryDataStreamPtr buf; // for scoped deletion of conversion buffer
+        buf.bind(OGRE_NEW MemoryDataStream(width * height * depth * 4));
+        PixelBox rgba(width, height, depth, PF_BYTE_RGBA, buf->getPtr());
+        PixelUtil::bulkPixelConversion(src, rgba);
+
+        BlockCompressTask task(buf->getPtr(), width, height, dst.format, static_cast<uint8*>(dst.data));
+        const size_t numRows = task.getNumRows() * depth;
+        Root* root = Root::getSingletonPtr();
+        WorkQueue* queue = root ? root->getWorkQueue() : 0;
+        if (queue)
+            queue->parallelFor(numRows, 4, &task);
+        else
+            task.execute(0, numRows);
+    }
+}
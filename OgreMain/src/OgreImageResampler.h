@@ -275,66 +275,292 @@ struct LinearResampler_Float32 {
 
 
 
-// byte linear resampler, does not do any format conversions.
-// only handles pixel formats that use 1 byte per color channel.
-// 2D only; punts 3D pixelboxes to default LinearResampler (slow).
-// templated on bytes-per-pixel to allow compiler optimizations, such
-// as unrolling loops and replacing multiplies with bitshifts
-template<unsigned int channels> struct LinearResampler_Byte {
-    static void scale(const PixelBox& src, const PixelBox& dst) {
-        // assert(src.format == dst.format);
+// filter kernels for the separable resampler, as a function of the
+// distance from the centre of the destination pixel in source pixels
+inline float boxFilter(float x) {
+    return (x >= -0.5f && x < 0.5f) ? 1.0f : 0.0f;
+}
+
+inline float triangleFilter(float x) {
+    x = std::fabs(x);
+    return (x < 1.0f) ? 1.0f - x : 0.0f;
+}
+
+// Catmull-Rom spline, the usual bicubic
+inline float cubicFilter(float x) {
+    x = std::fabs(x);
+    if (x < 1.0f)
+        return (1.5f*x - 2.5f)*x*x + 1.0f;
+    if (x < 2.0f)
+        return ((-0.5f*x + 2.5f)*x - 4.0f)*x + 2.0f;
+    return 0.0f;
+}
+
+inline float sinc(float x) {
+    if (std::fabs(x) < 1e-4f)
+        return 1.0f;
+    x *= Math::PI;
+    return std::sin(x) / x;
+}
+
+inline float lanczosFilter(float x) {
+    return (x > -3.0f && x < 3.0f) ? sinc(x) * sinc(x / 3.0f) : 0.0f;
+}
+
+// zeroth order modified Bessel function of the first kind
+inline float besselI0(float x) {
+    float sum = 1.0f, term = 1.0f;
+    const float halfx = 0.5f * x;
+    for (int k = 1; k < 32 && term > sum * 1e-8f; k++) {
+        term *= (halfx / k) * (halfx / k);
+        sum += term;
+    }
+    return sum;
+}
+
+// windowed sinc, with a Kaiser window of width 3 and alpha 4
+inline float kaiserFilter(float x) {
+    const float width = 3.0f, alpha = 4.0f;
+    if (std::fabs(x) >= width)
+        return 0.0f;
+    float t = x / width;
+    return sinc(x) * besselI0(alpha * std::sqrt(1.0f - t*t)) / besselI0(alpha);
+}
 
-        // only optimized for 2D
-        if (src.getDepth() > 1 || dst.getDepth() > 1) {
-            LinearResampler::scale(src, dst);
-            return;
+struct ResampleFilter {
+    float (*weight)(float x);
+    // half width of the kernel, in source pixels
+    float radius;
+    // widen the kernel by the scale factor when downsampling, which
+    // low-pass filters the image; bilinear sampling doesn't
+    bool stretch;
+};
+
+inline ResampleFilter getResampleFilter(Image::Filter filter) {
+    ResampleFilter f;
+    f.stretch = true;
+    switch (filter) {
+    case Image::FILTER_BOX:
+        f.weight = boxFilter; f.radius = 0.5f; break;
+    case Image::FILTER_TRIANGLE:
+        f.weight = triangleFilter; f.radius = 1.0f; break;
+    case Image::FILTER_BICUBIC:
+        f.weight = cubicFilter; f.radius = 2.0f; break;
+    case Image::FILTER_LANCZOS:
+        f.weight = lanczosFilter; f.radius = 3.0f; break;
+    case Image::FILTER_KAISER:
+        f.weight = kaiserFilter; f.radius = 3.0f; break;
+    default:
+        f.weight = triangleFilter; f.radius = 1.0f; f.stretch = false; break;
+    }
+    return f;
+}
+
+// weights of the source pixels contributing to each destination pixel
+// along one axis. samples beyond the edges are clamped to the edge pixel,
+// and every destination pixel's weights are normalised to sum to one.
+struct ResampleWeights {
+    vector<uint32>::type first;     // first contributing source pixel
+    vector<uint32>::type count;     // number of contributing source pixels
+    vector<float>::type weights;    // maxCount weights per destination pixel
+    size_t maxCount;
+
+    void build(uint32 srcSize, uint32 dstSize, const ResampleFilter& filter) {
+        float scale = (float)srcSize / dstSize;
+        float stretch = (filter.stretch && scale > 1.0f)? scale : 1.0f;
+        float support = filter.radius * stretch;
+
+        maxCount = std::min((size_t)std::ceil(support) * 2 + 2, (size_t)srcSize);
+        first.resize(dstSize);
+        count.resize(dstSize);
+        weights.assign(dstSize * maxCount, 0.0f);
+
+        for (uint32 i = 0; i < dstSize; i++) {
+            float centre = (i + 0.5f) * scale;
+            int left = (int)std::floor(centre - support);
+            int right = (int)std::ceil(centre + support);
+            int lo = Math::Clamp(left, 0, (int)srcSize - 1);
+            int hi = Math::Clamp(right, 0, (int)srcSize - 1);
+
+            float* w = &weights[i * maxCount];
+            float total = 0.0f;
+            for (int j = left; j <= right; j++) {
+                float v = filter.weight((j + 0.5f - centre) / stretch);
+                w[Math::Clamp(j, lo, hi) - lo] += v;
+                total += v;
+            }
+            if (total == 0.0f) {
+                // kernel fell between samples, take the nearest
+                w[Math::Clamp((int)centre, lo, hi) - lo] = total = 1.0f;
+            }
+
+            // drop zero weights at the ends, and normalise the rest
+            uint32 start = 0, end = hi - lo + 1;
+            while (end > start + 1 && w[end - 1] == 0.0f) end--;
+            while (start + 1 < end && w[start] == 0.0f) start++;
+            for (uint32 k = start; k < end; k++)
+                w[k - start] = w[k] / total;
+            for (uint32 k = end - start; k < maxCount; k++)
+                w[k] = 0.0f;
+
+            first[i] = lo + start;
+            count[i] = end - start;
         }
+    }
+};
 
-        // srcdata stays at beginning of slice, pdst is a moving pointer
-        uchar* srcdata = (uchar*)src.getTopLeftFrontPixelPtr();
-        uchar* pdst = (uchar*)dst.getTopLeftFrontPixelPtr();
+// horizontal pass of the separable resampler, filters a row of pixels
+// with 8-bit or float channels into a row of floats
+template<typename T>
+inline void resampleRow(const T* src, float* dst, size_t channels,
+    const ResampleWeights& wx, size_t dstWidth) {
+    for (size_t x = 0; x < dstWidth; x++) {
+        const T* psrc = src + wx.first[x] * channels;
+        const float* w = &wx.weights[x * wx.maxCount];
+        const uint32 n = wx.count[x];
+        for (size_t c = 0; c < channels; c++) {
+            float sum = 0.0f;
+            for (uint32 k = 0; k < n; k++)
+                sum += w[k] * psrc[k * channels + c];
+            *dst++ = sum;
+        }
+    }
+}
 
-        // sx_48,sy_48 represent current position in source
-        // using 16/48-bit fixed precision, incremented by steps
-        uint64 stepx = ((uint64)src.getWidth() << 48) / dst.getWidth();
-        uint64 stepy = ((uint64)src.getHeight() << 48) / dst.getHeight();
-        
-        uint64 sy_48 = (stepy >> 1) - 1;
-        for (size_t y = dst.top; y < dst.bottom; y++, sy_48+=stepy) {
-            // bottom 28 bits of temp are 16/12 bit fixed precision, used to
-            // adjust a source coordinate backwards by half a pixel so that the
-            // integer bits represent the first sample (eg, sx1) and the
-            // fractional bits are the blend weight of the second sample
-            unsigned int temp = static_cast<unsigned int>(sy_48 >> 36);
-            temp = (temp > 0x800)? temp - 0x800: 0;
-            unsigned int syf = temp & 0xFFF;
-            uint32 sy1 = temp >> 12;
-            uint32 sy2 = std::min(sy1+1, src.bottom-src.top-1);
-            size_t syoff1 = sy1 * src.rowPitch;
-            size_t syoff2 = sy2 * src.rowPitch;
-
-            uint64 sx_48 = (stepx >> 1) - 1;
-            for (size_t x = dst.left; x < dst.right; x++, sx_48+=stepx) {
-                temp = static_cast<unsigned int>(sx_48 >> 36);
-                temp = (temp > 0x800)? temp - 0x800 : 0;
-                unsigned int sxf = temp & 0xFFF;
-                uint32 sx1 = temp >> 12;
-                uint32 sx2 = std::min(sx1+1, src.right-src.left-1);
-
-                unsigned int sxfsyf = sxf*syf;
-                for (unsigned int k = 0; k < channels; k++) {
-                    unsigned int accum =
-                        srcdata[(sx1 + syoff1)*channels+k]*(0x1000000-(sxf<<12)-(syf<<12)+sxfsyf) +
-                        srcdata[(sx2 + syoff1)*channels+k]*((sxf<<12)-sxfsyf) +
-                        srcdata[(sx1 + syoff2)*channels+k]*((syf<<12)-sxfsyf) +
-                        srcdata[(sx2 + syoff2)*channels+k]*sxfsyf;
-                    // accum is computed using 8/24-bit fixed-point math
-                    // (maximum is 0xFF000000; rounding will not cause overflow)
-                    *pdst++ = static_cast<uchar>((accum + 0x800000) >> 24);
+// resamples a band of destination rows; the source rows they need are
+// filtered horizontally into a float buffer, then summed vertically
+class SeparableResampleTask : public WorkQueue::ParallelTask {
+public:
+    SeparableResampleTask(const PixelBox& src, const PixelBox& dst, size_t channels,
+        bool isByte, const ResampleWeights& wx, const ResampleWeights& wy)
+        : mSrc(src), mDst(dst), mChannels(channels), mIsByte(isByte), mWx(wx), mWy(wy) {}
+
+    void execute(size_t begin, size_t end) {
+        size_t elemsize = PixelUtil::getNumElemBytes(mSrc.format);
+        uchar* srcdata = (uchar*)mSrc.getTopLeftFrontPixelPtr();
+        uchar* dstdata = (uchar*)mDst.getTopLeftFrontPixelPtr();
+
+        // source rows used by this band
+        uint32 sy1 = mWy.first[begin], sy2 = 0;
+        for (size_t y = begin; y < end; y++) {
+            sy1 = std::min(sy1, mWy.first[y]);
+            sy2 = std::max(sy2, mWy.first[y] + mWy.count[y]);
+        }
+
+        // byte formats need one more row to sum into before converting back
+        const size_t rowlen = mDst.getWidth() * mChannels;
+        vector<float>::type rows((sy2 - sy1 + (mIsByte? 1 : 0)) * rowlen);
+        for (uint32 sy = sy1; sy < sy2; sy++) {
+            uchar* psrc = srcdata + sy * mSrc.rowPitch * elemsize;
+            float* prow = &rows[(sy - sy1) * rowlen];
+            if (mIsByte)
+                resampleRow(psrc, prow, mChannels, mWx, mDst.getWidth());
+            else
+                resampleRow((float*)psrc, prow, mChannels, mWx, mDst.getWidth());
+        }
+
+        OptimisedUtil* util = OptimisedUtil::getImplementation();
+        vector<const float*>::type rowptrs(mWy.maxCount);
+        float* sum = mIsByte? &rows[(sy2 - sy1) * rowlen] : 0;
+        for (size_t y = begin; y < end; y++) {
+            const uint32 n = mWy.count[y];
+            for (uint32 k = 0; k < n; k++)
+                rowptrs[k] = &rows[(mWy.first[y] + k - sy1) * rowlen];
+
+            uchar* pdst = dstdata + y * mDst.rowPitch * elemsize;
+            const float* w = &mWy.weights[y * mWy.maxCount];
+            if (mIsByte) {
+                util->sumWeightedRows(&rowptrs[0], w, n, sum, rowlen);
+                util->convertFloatToByte(sum, pdst, rowlen);
+            } else {
+                util->sumWeightedRows(&rowptrs[0], w, n, (float*)pdst, rowlen);
+            }
+        }
+    }
+
+private:
+    const PixelBox& mSrc;
+    const PixelBox& mDst;
+    size_t mChannels;
+    bool mIsByte;
+    const ResampleWeights& mWx;
+    const ResampleWeights& mWy;
+};
+
+// separable filter resampler, does format conversion.
+// 2D only; returns false for 3D pixelboxes, which are left to the
+// linear resamplers. formats with 8-bit or float32 channels are filtered
+// directly, everything else goes through PF_FLOAT32_RGBA. bands of rows
+// are spread over the WorkQueue threads when there is a Root.
+struct SeparableResampler {
+    static bool scale(const PixelBox& src, const PixelBox& dst, Image::Filter filter) {
+        if (src.getDepth() > 1 || dst.getDepth() > 1)
+            return false;
+
+        size_t channels;
+        bool isByte;
+        switch (src.format) {
+        case PF_L8: case PF_A8: case PF_BYTE_LA:
+        case PF_R8G8B8: case PF_B8G8R8:
+        case PF_R8G8B8A8: case PF_B8G8R8A8:
+        case PF_A8B8G8R8: case PF_A8R8G8B8:
+        case PF_X8B8G8R8: case PF_X8R8G8B8:
+            channels = PixelUtil::getNumElemBytes(src.format);
+            isByte = true;
+            break;
+        case PF_FLOAT32_R: case PF_FLOAT32_GR:
+        case PF_FLOAT32_RGB: case PF_FLOAT32_RGBA:
+            channels = PixelUtil::getNumElemBytes(src.format) / sizeof(float);
+            isByte = false;
+            break;
+        default:
+            {
+                // filter in float, converting on the way in and out
+                MemoryDataStreamPtr srcbuf, dstbuf;
+                PixelBox srctemp(src.getWidth(), src.getHeight(), 1, PF_FLOAT32_RGBA);
+                srcbuf.bind(OGRE_NEW MemoryDataStream(srctemp.getConsecutiveSize()));
+                srctemp.data = srcbuf->getPtr();
+                PixelUtil::bulkPixelConversion(src, srctemp);
+
+                PixelBox dsttemp(dst.getWidth(), dst.getHeight(), 1, PF_FLOAT32_RGBA);
+                if (dst.format == PF_FLOAT32_RGBA) {
+                    dsttemp = dst;
+                } else {
+                    dstbuf.bind(OGRE_NEW MemoryDataStream(dsttemp.getConsecutiveSize()));
+                    dsttemp.data = dstbuf->getPtr();
                 }
+                scale(srctemp, dsttemp, filter);
+                if (dsttemp.data != dst.data)
+                    PixelUtil::bulkPixelConversion(dsttemp, dst);
+                return true;
             }
-            pdst += channels*dst.getRowSkip();
         }
+
+        // resample in the source format, then convert
+        MemoryDataStreamPtr buf;
+        PixelBox temp = dst;
+        if (dst.format != src.format) {
+            temp = PixelBox(dst.getWidth(), dst.getHeight(), 1, src.format);
+            buf.bind(OGRE_NEW MemoryDataStream(temp.getConsecutiveSize()));
+            temp.data = buf->getPtr();
+        }
+
+        ResampleFilter f = getResampleFilter(filter);
+        ResampleWeights wx, wy;
+        wx.build(src.getWidth(), dst.getWidth(), f);
+        wy.build(src.getHeight(), dst.getHeight(), f);
+
+        SeparableResampleTask task(src, temp, channels, isByte, wx, wy);
+        Root* root = Root::getSingletonPtr();
+        WorkQueue* queue = root? root->getWorkQueue() : 0;
+        if (queue)
+            queue->parallelFor(temp.getHeight(), 16, &task);
+        else
+            task.execute(0, temp.getHeight());
+
+        if (temp.data != dst.data)
+            PixelUtil::bulkPixelConversion(temp, dst);
+        return true;
     }
 };
 /** @} */
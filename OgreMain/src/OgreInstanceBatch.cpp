@@ -181,6 +181,21 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------
+    bool InstanceBatch::hasVisibleInstances( Camera *currentCamera ) const
+    {
+        InstancedEntityVec::const_iterator itor = mInstancedEntities.begin();
+        InstancedEntityVec::const_iterator end  = mInstancedEntities.end();
+
+        while( itor != end )
+        {
+            if( (*itor)->findVisible( currentCamera ) )
+                return true;
+            ++itor;
+        }
+
+        return false;
+    }
+    //-----------------------------------------------------------------------
     void InstanceBatch::createAllInstancedEntities()
     {
         mInstancedEntities.reserve( mInstancesPerBatch );
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreHardwareBufferManager.h"
 #include "OgreInstancedEntity.h"
 #include "OgreRoot.h"
+#include "OgreGpuDrawCuller.h"
 
 namespace Ogre
 {
@@ -40,7 +41,11 @@ namespace Ogre
                                         const Mesh::IndexMap *indexToBoneMap, const String &batchName ) :
                 InstanceBatch( creator, meshReference, material, instancesPerBatch,
                                 indexToBoneMap, batchName ),
-                mKeepStatic( false )
+                mKeepStatic( false ),
+                mPackedLeader( false ),
+                mUpdatePending( false ),
+                mConcurrentDest( 0 ),
+                mGpuCuller( 0 )
     {
         //Override defaults, so that InstancedEntities don't create a skeleton instance
         mTechnSupportsSkeletal = false;
@@ -48,6 +53,7 @@ namespace Ogre
 
     InstanceBatchHW::~InstanceBatchHW()
     {
+        OGRE_DELETE mGpuCuller;
     }
 
     //-----------------------------------------------------------------------
@@ -80,7 +86,7 @@ namespace Ogre
                                         HardwareBufferManager::getSingleton().createVertexBuffer(
                                         thisVertexData->vertexDeclaration->getVertexSize(lastSource),
                                         mInstancesPerBatch,
-                                        HardwareBuffer::HBU_STATIC_WRITE_ONLY );
+                                        HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE );
         thisVertexData->vertexBufferBinding->setBinding( lastSource, vertexBuffer );
         vertexBuffer->setIsInstanceData( true );
         vertexBuffer->setInstanceDataStepRate( 1 );
@@ -112,7 +118,7 @@ namespace Ogre
                                         HardwareBufferManager::getSingleton().createVertexBuffer(
                                         thisVertexData->vertexDeclaration->getVertexSize(newSource),
                                         mInstancesPerBatch,
-                                        HardwareBuffer::HBU_STATIC_WRITE_ONLY );
+                                        HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE );
         thisVertexData->vertexBufferBinding->setBinding( newSource, vertexBuffer );
         vertexBuffer->setIsInstanceData( true );
         vertexBuffer->setInstanceDataStepRate( 1 );
@@ -180,13 +186,22 @@ namespace Ogre
     //-----------------------------------------------------------------------
     size_t InstanceBatchHW::updateVertexBuffer( Camera *currentCamera )
     {
-        size_t retVal = 0;
-
         //Now lock the vertex buffer and copy the 4x3 matrices, only those who need it!
         const ushort bufferIdx = ushort(mRenderOperation.vertexData->vertexBufferBinding->getBufferCount()-1);
         float *pDest = static_cast<float*>(mRenderOperation.vertexData->vertexBufferBinding->
                                             getBuffer(bufferIdx)->lock( HardwareBuffer::HBL_DISCARD ));
 
+        size_t retVal = writeVisibleInstances( pDest, currentCamera );
+
+        mRenderOperation.vertexData->vertexBufferBinding->getBuffer(bufferIdx)->unlock();
+
+        return retVal;
+    }
+    //-----------------------------------------------------------------------
+    size_t InstanceBatchHW::writeVisibleInstances( float *pDest, Camera *currentCamera, Vector4 *pBounds )
+    {
+        size_t retVal = 0;
+
         InstancedEntityVec::const_iterator itor = mInstancedEntities.begin();
         InstancedEntityVec::const_iterator end  = mInstancedEntities.end();
 
@@ -215,6 +230,13 @@ namespace Ogre
                     *pDest++ = mCustomParams[customParamIdx+i].w;
                 }
 
+                if( pBounds )
+                {
+                    const Vector3 &position = (*itor)->_getDerivedPosition();
+                    *pBounds++ = Vector4( position.x, position.y, position.z,
+                                          (*itor)->getBoundingRadius() );
+                }
+
                 ++retVal;
             }
             ++itor;
@@ -222,11 +244,28 @@ namespace Ogre
             customParamIdx += numCustomParams;
         }
 
-        mRenderOperation.vertexData->vertexBufferBinding->getBuffer(bufferIdx)->unlock();
-
         return retVal;
     }
     //-----------------------------------------------------------------------
+    void InstanceBatchHW::_prepareConcurrentInstanceUpdate(void)
+    {
+        const ushort bufferIdx = ushort(mRenderOperation.vertexData->vertexBufferBinding->getBufferCount()-1);
+        mConcurrentDest = static_cast<float*>(mRenderOperation.vertexData->vertexBufferBinding->
+                                            getBuffer(bufferIdx)->lock( HardwareBuffer::HBL_DISCARD ));
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatchHW::_concurrentInstanceUpdate(void)
+    {
+        mRenderOperation.numberOfInstances = writeVisibleInstances( mConcurrentDest, mCurrentCamera );
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatchHW::_finishConcurrentInstanceUpdate(void)
+    {
+        const ushort bufferIdx = ushort(mRenderOperation.vertexData->vertexBufferBinding->getBufferCount()-1);
+        mRenderOperation.vertexData->vertexBufferBinding->getBuffer(bufferIdx)->unlock();
+        mConcurrentDest = 0;
+    }
+    //-----------------------------------------------------------------------
     void InstanceBatchHW::_boundsDirty(void)
     {
         //Don't update if we're static, but still mark we're dirty
@@ -248,8 +287,44 @@ namespace Ogre
             //(except further calls to this function). Pass NULL because
             //we want to include only those who were added to the scene
             //but we don't want to perform culling
+            if( mCreator->getGpuCulling() && setupGpuCulling() )
+                return;
             mRenderOperation.numberOfInstances = updateVertexBuffer( 0 );
         }
+
+        OGRE_DELETE mGpuCuller;
+        mGpuCuller = 0;
+        mRenderOperation.gpuDrawCuller = 0;
+    }
+    //-----------------------------------------------------------------------
+    bool InstanceBatchHW::setupGpuCulling(void)
+    {
+        if( !mGpuCuller )
+        {
+            mGpuCuller = Root::getSingleton().getRenderSystem()->createGpuDrawCuller();
+            if( !mGpuCuller )
+                return false;
+        }
+
+        //From now on the GPU culls these and packs the visible ones into the instance buffer
+        const ushort bufferIdx = ushort(mRenderOperation.vertexData->vertexBufferBinding->getBufferCount()-1);
+        const HardwareVertexBufferSharedPtr &instanceBuffer = mRenderOperation.vertexData->
+                                                                vertexBufferBinding->getBuffer(bufferIdx);
+        vector<float>::type instanceData( instanceBuffer->getSizeInBytes() / sizeof(float) );
+        vector<Vector4>::type bounds( mInstancedEntities.size() );
+        const size_t numInstances = writeVisibleInstances( &instanceData[0], 0, &bounds[0] );
+
+        IndirectDrawCommand command;
+        command.indexCount      = static_cast<uint32>( mRenderOperation.indexData->indexCount );
+        command.instanceCount   = 0;
+        command.firstIndex      = static_cast<uint32>( mRenderOperation.indexData->indexStart );
+        command.baseVertex      = 0;
+        command.baseInstance    = 0;
+        mGpuCuller->setInstances( command, &bounds[0], &instanceData[0], numInstances, instanceBuffer );
+
+        mRenderOperation.numberOfInstances = numInstances;
+        mRenderOperation.gpuDrawCuller = mGpuCuller;
+        return true;
     }
     //-----------------------------------------------------------------------
     void InstanceBatchHW::getWorldTransforms( Matrix4* xform ) const
@@ -264,11 +339,35 @@ namespace Ogre
     //-----------------------------------------------------------------------
     void InstanceBatchHW::_updateRenderQueue( RenderQueue* queue )
     {
+        mPackedLeader = false;
+        mUpdatePending = false;
+
         if( !mKeepStatic )
         {
             //Completely override base functionality, since we don't cull on an "all-or-nothing" basis
             //and we don't support skeletal animation
-            if( (mRenderOperation.numberOfInstances = updateVertexBuffer( mCurrentCamera )) )
+            if( mCreator->getPackedIndirectDraws() )
+            {
+                //Only find out whether we're needed. The visible instances of every packed batch
+                //get written at once by the first batch registered, which alone is rendered
+                if( hasVisibleInstances( mCurrentCamera ) &&
+                    (mPackedLeader = mCreator->_addPackedBatch( this, mCurrentCamera )) )
+                {
+                    queue->addRenderable( this, mRenderQueueID, mRenderQueuePriority );
+                }
+            }
+            else if( mCreator->getParallelUpdates() )
+            {
+                //Same as above, the visible instances get written along with those of the other
+                //batches in worker threads, the first time one of them is rendered
+                if( hasVisibleInstances( mCurrentCamera ) )
+                {
+                    mCreator->_addPendingBatch( this, mCurrentCamera );
+                    mUpdatePending = true;
+                    queue->addRenderable( this, mRenderQueueID, mRenderQueuePriority );
+                }
+            }
+            else if( (mRenderOperation.numberOfInstances = updateVertexBuffer( mCurrentCamera )) )
                 queue->addRenderable( this, mRenderQueueID, mRenderQueuePriority );
         }
         else
@@ -282,7 +381,25 @@ namespace Ogre
 
             //Don't update when we're static
             if( mRenderOperation.numberOfInstances )
+            {
+                if( mGpuCuller )
+                    mGpuCuller->cull( mCurrentCamera );
                 queue->addRenderable( this, mRenderQueueID, mRenderQueuePriority );
+            }
         }
     }
+    //-----------------------------------------------------------------------
+    void InstanceBatchHW::getRenderOperation( RenderOperation& op )
+    {
+        if( mUpdatePending )
+        {
+            mCreator->_updatePendingBatches();
+            mUpdatePending = false;
+        }
+
+        op = mRenderOperation;
+
+        if( mPackedLeader )
+            mCreator->_setupPackedRenderOperation( this, op );
+    }
 }
@@ -33,6 +33,8 @@ THE SOFTWARE.
 #include "OgreInstancedEntity.h"
 #include "OgreCamera.h"
 #include "OgreRoot.h"
+#include "OgreSkeletonInstance.h"
+#include "OgreAnimation.h"
 
 namespace Ogre
 {
@@ -45,7 +47,11 @@ namespace Ogre
         const Mesh::IndexMap *indexToBoneMap, const String &batchName )
             : BaseInstanceBatchVTF( creator, meshReference, material, 
                                     instancesPerBatch, indexToBoneMap, batchName),
-              mKeepStatic( false )
+              mKeepStatic( false ),
+              mUpdatePending( false ),
+              mConcurrentDest( 0 ),
+              mBakedFramesPerSecond( 0 ),
+              mNumBakedFrames( 0 )
     {
     }
     //-----------------------------------------------------------------------
@@ -125,8 +131,49 @@ namespace Ogre
             }
         }
 
+        if( useBakedAnimations() )
+        {
+            if( !mMeshReference->hasSkeleton() || mMeshReference->getSkeleton().isNull() )
+            {
+                OGRE_EXCEPT( Exception::ERR_INVALID_STATE, "Baked animations require a mesh with "
+                            "a skeleton. Mesh: " + mMeshReference->getName(),
+                            "InstanceBatchHW_VTF::setupVertices" );
+            }
+
+            //Reserve one texture slot per baked frame
+            const SkeletonPtr &skeleton = mMeshReference->getSkeleton();
+            mBakedAnimationRanges.clear();
+            mNumBakedFrames = 0;
+
+            StringVector::const_iterator animItor = mBakedAnimations.begin();
+            StringVector::const_iterator animEnd  = mBakedAnimations.end();
+            while( animItor != animEnd )
+            {
+                BakedAnimation baked;
+                baked.firstSlot = mNumBakedFrames;
+                baked.length    = skeleton->getAnimation( *animItor )->getLength();
+                baked.numFrames = static_cast<size_t>( Math::Ceil( baked.length *
+                                                                    mBakedFramesPerSecond ) ) + 1;
+                mBakedAnimationRanges.push_back( baked );
+                mNumBakedFrames += baked.numFrames;
+                ++animItor;
+            }
+
+            const size_t numBones = std::max<size_t>( 1, baseSubMesh->blendIndexToBoneIndexMap.size() );
+            const size_t maxUsableWidth = c_maxTexWidthHW - (c_maxTexWidthHW % (numBones * mRowLength));
+            if( mNumBakedFrames * numBones * mRowLength > maxUsableWidth * c_maxTexHeightHW )
+            {
+                OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, "The baked animations don't fit in the "
+                            "vertex texture. Bake fewer animations or use a lower frame rate",
+                            "InstanceBatchHW_VTF::setupVertices" );
+            }
+        }
+
         createVertexTexture( baseSubMesh );
         createVertexSemantics( thisVertexData, baseVertexData, hwBoneIdx, hwBoneWgt);
+
+        if( useBakedAnimations() )
+            bakeAnimations();
     }
     //-----------------------------------------------------------------------
     void InstanceBatchHW_VTF::setupIndices( const SubMesh* baseSubMesh )
@@ -246,11 +293,13 @@ namespace Ogre
 
         }
 
-        //Create our own vertex buffer
+        //Create our own vertex buffer. It's rewritten every frame when using bone matrix lookup
         mInstanceVertexBuffer = HardwareBufferManager::getSingleton().createVertexBuffer(
                                         thisVertexData->vertexDeclaration->getVertexSize(newSource),
                                         mInstancesPerBatch,
-                                        HardwareBuffer::HBU_STATIC_WRITE_ONLY );
+                                        useBoneMatrixLookup() ?
+                                            HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE :
+                                            HardwareBuffer::HBU_STATIC_WRITE_ONLY );
         thisVertexData->vertexBufferBinding->setBinding( newSource, mInstanceVertexBuffer );
 
         //Mark this buffer as instanced
@@ -270,74 +319,113 @@ namespace Ogre
             //update the mTransformLookupNumber value in the entities if needed 
             updateSharedLookupIndexes();
 
-            const float texWidth  = static_cast<float>(mMatrixTexture->getWidth());
-            const float texHeight = static_cast<float>(mMatrixTexture->getHeight());
+            float *thisVec = static_cast<float*>(mInstanceVertexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+            visibleEntityCount = writeInstanceData(thisVec, currentCamera);
+            mInstanceVertexBuffer->unlock();
+        }
+        else
+        {
+            visibleEntityCount = mInstancedEntities.size();
+        }
+        return visibleEntityCount;
+    }
+    //-----------------------------------------------------------------------
+    size_t InstanceBatchHW_VTF::writeInstanceData( float *thisVec, Camera *currentCamera )
+    {
+        size_t visibleEntityCount = 0;
+        bool useMatrixLookup = useBoneMatrixLookup();
 
-            //Calculate the texel offsets to correct them offline
-            //Awkwardly enough, the offset is needed in OpenGL too
-            Vector2 texelOffsets;
-            //RenderSystem *renderSystem = Root::getSingleton().getRenderSystem();
-            texelOffsets.x = /*renderSystem->getHorizontalTexelOffset()*/ -0.5f / texWidth;
-            texelOffsets.y = /*renderSystem->getHorizontalTexelOffset()*/ -0.5f / texHeight;
+        const float texWidth  = static_cast<float>(mMatrixTexture->getWidth());
+        const float texHeight = static_cast<float>(mMatrixTexture->getHeight());
 
-            float *thisVec = static_cast<float*>(mInstanceVertexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+        //Calculate the texel offsets to correct them offline
+        //Awkwardly enough, the offset is needed in OpenGL too
+        Vector2 texelOffsets;
+        //RenderSystem *renderSystem = Root::getSingleton().getRenderSystem();
+        texelOffsets.x = /*renderSystem->getHorizontalTexelOffset()*/ -0.5f / texWidth;
+        texelOffsets.y = /*renderSystem->getHorizontalTexelOffset()*/ -0.5f / texHeight;
 
-            const size_t maxPixelsPerLine = std::min( static_cast<size_t>(mMatrixTexture->getWidth()), mMaxFloatsPerLine >> 2 );
+        const size_t maxPixelsPerLine = std::min( static_cast<size_t>(mMatrixTexture->getWidth()), mMaxFloatsPerLine >> 2 );
 
-            //Calculate UV offsets, which change per instance
-            for( size_t i=0; i<mInstancesPerBatch; ++i )
+        //Calculate UV offsets, which change per instance
+        for( size_t i=0; i<mInstancesPerBatch; ++i )
+        {
+            InstancedEntity* entity = useMatrixLookup ? mInstancedEntities[i] : NULL;
+            if  //Update if we are not using a lookup bone matrix method. In this case the function will 
+                //be called only once
+                (!useMatrixLookup || 
+                //Update if we are in the visible range of the camera (for look up bone matrix method
+                //and static mode).
+                (entity->findVisible(currentCamera)))
             {
-                InstancedEntity* entity = useMatrixLookup ? mInstancedEntities[i] : NULL;
-                if  //Update if we are not using a lookup bone matrix method. In this case the function will 
-                    //be called only once
-                    (!useMatrixLookup || 
-                    //Update if we are in the visible range of the camera (for look up bone matrix method
-                    //and static mode).
-                    (entity->findVisible(currentCamera)))
-                {
-                    size_t matrixIndex = useMatrixLookup ? entity->mTransformLookupNumber : i;
-                    size_t instanceIdx = matrixIndex * mMatricesPerInstance * mRowLength;
-                    *thisVec = ((instanceIdx % maxPixelsPerLine) / texWidth) - (float)(texelOffsets.x);
-                    *(thisVec + 1) = ((instanceIdx / maxPixelsPerLine) / texHeight) - (float)(texelOffsets.y);
-                    thisVec += 2;
+                size_t matrixIndex = i;
+                if( useBakedAnimations() )
+                    matrixIndex = getBakedFrameSlot( entity );
+                else if( useMatrixLookup )
+                    matrixIndex = entity->mTransformLookupNumber;
+                size_t instanceIdx = matrixIndex * mMatricesPerInstance * mRowLength;
+                *thisVec = ((instanceIdx % maxPixelsPerLine) / texWidth) - (float)(texelOffsets.x);
+                *(thisVec + 1) = ((instanceIdx / maxPixelsPerLine) / texHeight) - (float)(texelOffsets.y);
+                thisVec += 2;
 
-                    if (useMatrixLookup)
+                if (useMatrixLookup)
+                {
+                    const Matrix4& mat =  entity->_getParentNodeFullTransform();
+                    *(thisVec)     = static_cast<float>( mat[0][0] );
+                    *(thisVec + 1) = static_cast<float>( mat[0][1] );
+                    *(thisVec + 2) = static_cast<float>( mat[0][2] );
+                    *(thisVec + 3) = static_cast<float>( mat[0][3] );
+                    *(thisVec + 4) = static_cast<float>( mat[1][0] );
+                    *(thisVec + 5) = static_cast<float>( mat[1][1] );
+                    *(thisVec + 6) = static_cast<float>( mat[1][2] );
+                    *(thisVec + 7) = static_cast<float>( mat[1][3] );
+                    *(thisVec + 8) = static_cast<float>( mat[2][0] );
+                    *(thisVec + 9) = static_cast<float>( mat[2][1] );
+                    *(thisVec + 10)= static_cast<float>( mat[2][2] );
+                    *(thisVec + 11)= static_cast<float>( mat[2][3] );
+                    if(currentCamera && mManager->getCameraRelativeRendering()) // && useMatrixLookup
                     {
-                        const Matrix4& mat =  entity->_getParentNodeFullTransform();
-                        *(thisVec)     = static_cast<float>( mat[0][0] );
-                        *(thisVec + 1) = static_cast<float>( mat[0][1] );
-                        *(thisVec + 2) = static_cast<float>( mat[0][2] );
-                        *(thisVec + 3) = static_cast<float>( mat[0][3] );
-                        *(thisVec + 4) = static_cast<float>( mat[1][0] );
-                        *(thisVec + 5) = static_cast<float>( mat[1][1] );
-                        *(thisVec + 6) = static_cast<float>( mat[1][2] );
-                        *(thisVec + 7) = static_cast<float>( mat[1][3] );
-                        *(thisVec + 8) = static_cast<float>( mat[2][0] );
-                        *(thisVec + 9) = static_cast<float>( mat[2][1] );
-                        *(thisVec + 10)= static_cast<float>( mat[2][2] );
-                        *(thisVec + 11)= static_cast<float>( mat[2][3] );
-                        if(currentCamera && mManager->getCameraRelativeRendering()) // && useMatrixLookup
-                        {
-                            const Vector3 &cameraRelativePosition = currentCamera->getDerivedPosition();
-                            *(thisVec + 3) -= static_cast<float>( cameraRelativePosition.x );
-                            *(thisVec + 7) -= static_cast<float>( cameraRelativePosition.y );
-                            *(thisVec + 11) -=  static_cast<float>( cameraRelativePosition.z );
-                        }
-                        thisVec += 12;
+                        const Vector3 &cameraRelativePosition = currentCamera->getDerivedPosition();
+                        *(thisVec + 3) -= static_cast<float>( cameraRelativePosition.x );
+                        *(thisVec + 7) -= static_cast<float>( cameraRelativePosition.y );
+                        *(thisVec + 11) -=  static_cast<float>( cameraRelativePosition.z );
                     }
-                    ++visibleEntityCount;
+                    thisVec += 12;
                 }
+                ++visibleEntityCount;
             }
-
-            mInstanceVertexBuffer->unlock();
         }
-        else
+
+        return visibleEntityCount;
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatchHW_VTF::_prepareConcurrentInstanceUpdate(void)
+    {
+        updateSharedLookupIndexes();
+        mConcurrentDest = static_cast<float*>(mInstanceVertexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatchHW_VTF::_concurrentInstanceUpdate(void)
+    {
+        mRenderOperation.numberOfInstances = writeInstanceData( mConcurrentDest, mCurrentCamera );
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatchHW_VTF::_finishConcurrentInstanceUpdate(void)
+    {
+        mInstanceVertexBuffer->unlock();
+        mConcurrentDest = 0;
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatchHW_VTF::getRenderOperation( RenderOperation& op )
+    {
+        if( mUpdatePending )
         {
-            visibleEntityCount = mInstancedEntities.size();
+            mCreator->_updatePendingBatches();
+            mUpdatePending = false;
         }
-        return visibleEntityCount;
+
+        op = mRenderOperation;
     }
-    
     //-----------------------------------------------------------------------
     bool InstanceBatchHW_VTF::checkSubMeshCompatibility( const SubMesh* baseSubMesh )
     {
@@ -371,6 +459,10 @@ namespace Ogre
         if( capabilities->hasCapability( RSC_VERTEX_BUFFER_INSTANCE_DATA ) &&
             capabilities->hasCapability( RSC_VERTEX_TEXTURE_FETCH ) )
         {
+            //The vertex texture holds the baked frames, it doesn't limit the number of instances
+            if( useBakedAnimations() )
+                return 65535;
+
             //TODO: Check PF_FLOAT32_RGBA is supported (should be, since it was the 1st one)
             const size_t numBones = std::max<size_t>( 1, baseSubMesh->blendIndexToBoneIndexMap.size() );
 
@@ -403,6 +495,13 @@ namespace Ogre
     //-----------------------------------------------------------------------
     size_t InstanceBatchHW_VTF::updateVertexTexture( Camera *currentCamera )
     {
+        if( useBakedAnimations() )
+        {
+            //The vertex texture never changes once baked, only the per instance data does
+            mDirtyAnimation = false;
+            return updateInstanceDataBuffer( false, currentCamera );
+        }
+
         size_t renderedInstances = 0;
         bool useMatrixLookup = useBoneMatrixLookup();
         if (useMatrixLookup)
@@ -426,7 +525,8 @@ namespace Ogre
         
         InstancedEntityVec::const_iterator itor = mInstancedEntities.begin();
         
-        vector<bool>::type writtenPositions(getMaxLookupTableInstances(), false);
+        std::vector<bool, STLAllocator<bool, FrameAllocPolicy> > 
+            writtenPositions(getMaxLookupTableInstances(), false);
 
         size_t floatPerEntity = mMatricesPerInstance * mRowLength * 4;
         size_t entitiesPerPadding = (size_t)(mMaxFloatsPerLine / floatPerEntity);
@@ -500,6 +600,113 @@ namespace Ogre
         return renderedInstances;
     }
     //-----------------------------------------------------------------------
+    size_t InstanceBatchHW_VTF::getNumTextureTransformSlots() const
+    {
+        if( useBakedAnimations() )
+            return mNumBakedFrames;
+
+        return BaseInstanceBatchVTF::getNumTextureTransformSlots();
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatchHW_VTF::bakeAnimations()
+    {
+        //Use our own skeleton so the instances' (and other users') bone states are left untouched
+        SkeletonInstance skeleton( mMeshReference->getSkeleton() );
+        skeleton.load();
+
+        Matrix4Vec boneMatrices( skeleton.getNumBones() );
+
+        mMatrixTexture->getBuffer()->lock( HardwareBuffer::HBL_DISCARD );
+        const PixelBox &pixelBox = mMatrixTexture->getBuffer()->getCurrentLock();
+
+        float *pSource = static_cast<float*>(pixelBox.data);
+
+        const size_t floatPerEntity = mMatricesPerInstance * mRowLength * 4;
+        const size_t entitiesPerPadding = (size_t)(mMaxFloatsPerLine / floatPerEntity);
+
+        //If using dual quaternions, write 3x4 matrices to a temporary buffer, then convert to dual quaternions
+        float *transforms = mTempTransformsArray3x4;
+
+        for( size_t i=0; i<mBakedAnimations.size(); ++i )
+        {
+            Animation *animation = skeleton.getAnimation( mBakedAnimations[i] );
+            const BakedAnimation &baked = mBakedAnimationRanges[i];
+
+            for( size_t j=0; j<baked.numFrames; ++j )
+            {
+                const size_t slot = baked.firstSlot + j;
+                float *pDest = pSource + floatPerEntity * slot + (slot / entitiesPerPadding) * mWidthFloatsPadding;
+
+                if( !mUseBoneDualQuaternions )
+                    transforms = pDest;
+
+                skeleton.reset( true );
+                animation->apply( &skeleton, std::min( j / mBakedFramesPerSecond, baked.length ) );
+                skeleton._getBoneMatrices( &boneMatrices[0] );
+
+                //Same layout as InstancedEntity::getTransforms3x4
+                float *xform = transforms;
+                Mesh::IndexMap::const_iterator itor = mIndexToBoneMap->begin();
+                Mesh::IndexMap::const_iterator end  = mIndexToBoneMap->end();
+                while( itor != end )
+                {
+                    const Matrix4 &mat = boneMatrices[*itor++];
+                    for( int r=0; r<3; ++r )
+                    {
+                        Real const *row = mat[r];
+                        for( int c=0; c<4; ++c )
+                            *xform++ = static_cast<float>( *row++ );
+                    }
+                }
+
+                if( mUseBoneDualQuaternions )
+                    convert3x4MatricesToDualQuaternions( transforms, mIndexToBoneMap->size(), pDest );
+            }
+        }
+
+        mMatrixTexture->getBuffer()->unlock();
+    }
+    //-----------------------------------------------------------------------
+    size_t InstanceBatchHW_VTF::getBakedFrameSlot( const InstancedEntity *entity ) const
+    {
+        const size_t animationIdx = entity->getBakedAnimationIndex();
+        assert( animationIdx < mBakedAnimationRanges.size() && "Animation wasn't baked" );
+        const BakedAnimation &baked = mBakedAnimationRanges[animationIdx];
+
+        //Baked animations always loop
+        Real timePos = 0;
+        if( baked.length > 0 )
+        {
+            timePos = std::fmod( entity->getBakedAnimationTime(), baked.length );
+            if( timePos < 0 )
+                timePos += baked.length;
+        }
+
+        const size_t frame = static_cast<size_t>( timePos * mBakedFramesPerSecond + 0.5f );
+        return baked.firstSlot + std::min( frame, baked.numFrames - 1 );
+    }
+    //-----------------------------------------------------------------------
+    InstancedEntity* InstanceBatchHW_VTF::generateInstancedEntity( size_t num )
+    {
+        if( useBakedAnimations() && num > 0 )
+            return OGRE_NEW InstancedEntity( this, static_cast<uint32>(num), mInstancedEntities[0] );
+
+        return BaseInstanceBatchVTF::generateInstancedEntity( num );
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatchHW_VTF::setBakedAnimations( const StringVector &animationNames, Real framesPerSecond )
+    {
+        assert( mInstancedEntities.empty() );
+        assert( (animationNames.empty() || framesPerSecond > 0) && "Invalid bake frame rate" );
+
+        mBakedAnimations        = animationNames;
+        mBakedFramesPerSecond   = framesPerSecond;
+
+        //Each instance still needs its own world transform in the per instance data
+        if( useBakedAnimations() )
+            mUseBoneMatrixLookup = true;
+    }
+    //-----------------------------------------------------------------------
     void InstanceBatchHW_VTF::_boundsDirty(void)
     {
         //Don't update if we're static, but still mark we're dirty
@@ -527,10 +734,25 @@ namespace Ogre
     //-----------------------------------------------------------------------
     void InstanceBatchHW_VTF::_updateRenderQueue( RenderQueue* queue )
     {
+        mUpdatePending = false;
+
         if( !mKeepStatic )
         {
             //Completely override base functionality, since we don't cull on an "all-or-nothing" basis
-            if( (mRenderOperation.numberOfInstances = updateVertexTexture( mCurrentCamera )) )
+            if( mCreator->getParallelUpdates() && useBakedAnimations() )
+            {
+                //Baked batches only write per instance data. Find out whether we're needed, the
+                //visible instances get written along with those of the other batches in worker
+                //threads, the first time one of them is rendered
+                mDirtyAnimation = false;
+                if( hasVisibleInstances( mCurrentCamera ) )
+                {
+                    mCreator->_addPendingBatch( this, mCurrentCamera );
+                    mUpdatePending = true;
+                    queue->addRenderable( this, mRenderQueueID, mRenderQueuePriority );
+                }
+            }
+            else if( (mRenderOperation.numberOfInstances = updateVertexTexture( mCurrentCamera )) )
                 queue->addRenderable( this, mRenderQueueID, mRenderQueuePriority );
         }
         else
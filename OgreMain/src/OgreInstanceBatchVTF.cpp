@@ -249,11 +249,7 @@ namespace Ogre
 
         Currently assuming it's 4096x4096, which is a safe bet for any hardware with decent VTF*/
         
-        size_t uniqueAnimations = mInstancesPerBatch;
-        if (useBoneMatrixLookup())
-        {
-            uniqueAnimations = std::min<size_t>(getMaxLookupTableInstances(), uniqueAnimations);
-        }
+        size_t uniqueAnimations = getNumTextureTransformSlots();
         mMatricesPerInstance = std::max<size_t>( 1, baseSubMesh->blendIndexToBoneIndexMap.size() );
 
         if(mUseBoneDualQuaternions && !mTempTransformsArray3x4)
@@ -304,6 +300,17 @@ namespace Ogre
         setupMaterialToUseVTF( texType, mMaterial );
     }
 
+    //-----------------------------------------------------------------------
+    size_t BaseInstanceBatchVTF::getNumTextureTransformSlots() const
+    {
+        size_t uniqueAnimations = mInstancesPerBatch;
+        if (useBoneMatrixLookup())
+        {
+            uniqueAnimations = std::min<size_t>(getMaxLookupTableInstances(), uniqueAnimations);
+        }
+        return uniqueAnimations;
+    }
+
     //-----------------------------------------------------------------------
     size_t BaseInstanceBatchVTF::convert3x4MatricesToDualQuaternions(float* matrices, size_t numOfMatrices, float* outDualQuaternions)
     {
@@ -399,7 +406,8 @@ namespace Ogre
                 // 1. All entities sharing the same transformation will share the same unique number
                 // 2. "transform lookup number" will be numbered from 0 up to getMaxLookupTableInstances
                 uint16 lookupCounter = 0;
-                typedef map<Matrix4*,uint16>::type MapTransformId;
+                typedef std::map<Matrix4*, uint16, std::less<Matrix4*>, 
+                    STLAllocator<std::pair<Matrix4* const, uint16>, FrameAllocPolicy> > MapTransformId;
                 MapTransformId transformToId;
                 InstancedEntityVec::const_iterator itEnt = mInstancedEntities.begin(),
                     itEntEnd = mInstancedEntities.end();
@@ -39,9 +39,55 @@ THE SOFTWARE.
 #include "OgreHardwareBufferManager.h"
 #include "OgreSceneNode.h"
 #include "OgreIteratorWrappers.h"
+#include "OgreRoot.h"
+#include "OgreLogManager.h"
+#include "OgreWorkQueue.h"
+#include "OgreCamera.h"
 
 namespace Ogre
 {
+    namespace
+    {
+        /// Culls & writes the instances of a range of batches, see InstanceManager::setParallelUpdates
+        class InstanceBatchUpdateTask : public WorkQueue::ParallelTask
+        {
+        public:
+            InstanceBatchUpdateTask( InstanceBatch **batches ) : mBatches( batches ) {}
+
+            void execute( size_t begin, size_t end )
+            {
+                for( size_t i=begin; i<end; ++i )
+                    mBatches[i]->_concurrentInstanceUpdate();
+            }
+        private:
+            InstanceBatch **mBatches;
+        };
+
+        /// Writes the instances of a range of packed batches, each to its own slot
+        class PackedInstancesTask : public WorkQueue::ParallelTask
+        {
+        public:
+            PackedInstancesTask( InstanceBatch **batches, float *pDest, size_t floatsPerBatch,
+                                 size_t *numInstances ) :
+                mBatches( batches ), mDest( pDest ), mFloatsPerBatch( floatsPerBatch ),
+                mNumInstances( numInstances ) {}
+
+            void execute( size_t begin, size_t end )
+            {
+                for( size_t i=begin; i<end; ++i )
+                {
+                    mNumInstances[i] = static_cast<InstanceBatchHW*>( mBatches[i] )->
+                                                _writePackedInstances( mDest + i * mFloatsPerBatch );
+                }
+            }
+        private:
+            InstanceBatch **mBatches;
+            float *mDest;
+            size_t mFloatsPerBatch;
+            size_t *mNumInstances;
+        };
+    }
+    //-----------------------------------------------------------------------
     InstanceManager::InstanceManager( const String &customName, SceneManager *sceneManager,
                                         const String &meshName, const String &groupName,
                                         InstancingTechnique instancingTechnique, uint16 instancingFlags,
@@ -54,7 +100,11 @@ namespace Ogre
                 mSubMeshIdx( subMeshIdx ),
                 mSceneManager( sceneManager ),
                 mMaxLookupTableInstances(16),
-                mNumCustomParams( 0 )
+                mBakedFramesPerSecond(0),
+                mNumCustomParams( 0 ),
+                mPackedIndirectDraws( false ),
+                mParallelUpdates( false ),
+                mGpuCulling( false )
     {
         mMeshReference = MeshManager::getSingleton().load( meshName, groupName );
 
@@ -81,6 +131,15 @@ namespace Ogre
 
             ++itor;
         }
+
+        PackedDrawMap::const_iterator itPacked = mPackedDraws.begin();
+        PackedDrawMap::const_iterator enPacked = mPackedDraws.end();
+
+        while( itPacked != enPacked )
+        {
+            OGRE_DELETE itPacked->second.vertexData;
+            ++itPacked;
+        }
     }
     //----------------------------------------------------------------------
     void InstanceManager::setInstancesPerBatch( size_t instancesPerBatch )
@@ -106,6 +165,19 @@ namespace Ogre
         mMaxLookupTableInstances = maxLookupTableInstances;
     }
     
+    //----------------------------------------------------------------------
+    void InstanceManager::setBakedAnimations( const StringVector &animationNames, Real framesPerSecond )
+    {
+        if( !mInstanceBatches.empty() )
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE, "Baked animations can only be changed before"
+                " building the batch.", "InstanceManager::setBakedAnimations");
+        }
+
+        mBakedAnimations        = animationNames;
+        mBakedFramesPerSecond   = framesPerSecond;
+    }
+    
     //----------------------------------------------------------------------
     void InstanceManager::setNumCustomParams( unsigned char numCustomParams )
     {
@@ -118,6 +190,39 @@ namespace Ogre
         mNumCustomParams = numCustomParams;
     }
     //----------------------------------------------------------------------
+    void InstanceManager::setPackedIndirectDraws( bool enabled )
+    {
+        if( enabled && mInstancingTechnique != HWInstancingBasic )
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Packed indirect draws are only supported by"
+                        " the HWInstancingBasic technique.", "InstanceManager::setPackedIndirectDraws");
+        }
+
+        const RenderSystemCapabilities *capabilities = Root::getSingleton().getRenderSystem()->
+                                                                                getCapabilities();
+        if( enabled && !capabilities->hasCapability( RSC_MULTI_DRAW_INDIRECT ) )
+        {
+            LogManager::getSingleton().logMessage( "InstanceManager " + mName + ": render system"
+                                                   " lacks multi-draw indirect support, batches"
+                                                   " won't be packed." );
+            enabled = false;
+        }
+
+        mPackedIndirectDraws = enabled;
+        resetPackedDraws();
+    }
+    //----------------------------------------------------------------------
+    void InstanceManager::setGpuCulling( bool enabled )
+    {
+        if( enabled && mInstancingTechnique != HWInstancingBasic )
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "GPU culling is only supported by"
+                        " the HWInstancingBasic technique.", "InstanceManager::setGpuCulling");
+        }
+
+        mGpuCulling = enabled;
+    }
+    //----------------------------------------------------------------------
     size_t InstanceManager::getMaxOrBestNumInstancesPerBatch( const String &materialName, size_t suggestedSize,
                                                                 uint16 flags )
     {
@@ -154,6 +259,7 @@ namespace Ogre
             static_cast<InstanceBatchHW_VTF*>(batch)->setBoneDualQuaternions((mInstancingFlags & IM_USEBONEDUALQUATERNIONS) != 0);
             static_cast<InstanceBatchHW_VTF*>(batch)->setUseOneWeight((mInstancingFlags & IM_USEONEWEIGHT) != 0);
             static_cast<InstanceBatchHW_VTF*>(batch)->setForceOneWeight((mInstancingFlags & IM_FORCEONEWEIGHT) != 0);
+            static_cast<InstanceBatchHW_VTF*>(batch)->setBakedAnimations(mBakedAnimations, mBakedFramesPerSecond);
             break;
         default:
             OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
@@ -243,6 +349,7 @@ namespace Ogre
             static_cast<InstanceBatchHW_VTF*>(batch)->setBoneDualQuaternions((mInstancingFlags & IM_USEBONEDUALQUATERNIONS) != 0);
             static_cast<InstanceBatchHW_VTF*>(batch)->setUseOneWeight((mInstancingFlags & IM_USEONEWEIGHT) != 0);
             static_cast<InstanceBatchHW_VTF*>(batch)->setForceOneWeight((mInstancingFlags & IM_FORCEONEWEIGHT) != 0);
+            static_cast<InstanceBatchHW_VTF*>(batch)->setBakedAnimations(mBakedAnimations, mBakedFramesPerSecond);
             break;
         default:
             OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
@@ -292,6 +399,7 @@ namespace Ogre
     {
         //Do this now to avoid any dangling pointer inside mDirtyBatches
         _updateDirtyBatches();
+        resetPackedDraws();
 
         InstanceBatchMap::iterator itor = mInstanceBatches.begin();
         InstanceBatchMap::iterator end  = mInstanceBatches.end();
@@ -374,6 +482,7 @@ namespace Ogre
     {
         //Do this now to avoid any dangling pointer inside mDirtyBatches
         _updateDirtyBatches();
+        resetPackedDraws();
 
         //Do this for every material
         InstanceBatchMap::iterator itor = mInstanceBatches.begin();
@@ -511,6 +620,208 @@ namespace Ogre
         mDirtyBatches.clear();
     }
     //-----------------------------------------------------------------------
+    void InstanceManager::resetPackedDraws(void)
+    {
+        PackedDrawMap::iterator itor = mPackedDraws.begin();
+        PackedDrawMap::iterator end  = mPackedDraws.end();
+
+        while( itor != end )
+        {
+            itor->second.batches.clear();
+            itor->second.built = false;
+            ++itor;
+        }
+
+        mPendingUpdates.batches.clear();
+        mPendingUpdates.built = false;
+    }
+    //-----------------------------------------------------------------------
+    bool InstanceManager::_addPackedBatch( InstanceBatchHW *batch, const Camera *camera )
+    {
+        PackedDraw &packedDraw = mPackedDraws[batch->getMaterial()->getName()];
+        const unsigned long frameNumber = Root::getSingleton().getNextFrameNumber();
+
+        //Once built (or with another camera or frame) a new render queue fill started
+        if( packedDraw.built || packedDraw.camera != camera || packedDraw.frameNumber != frameNumber )
+        {
+            packedDraw.batches.clear();
+            packedDraw.built        = false;
+            packedDraw.camera       = camera;
+            packedDraw.frameNumber  = frameNumber;
+        }
+
+        packedDraw.batches.push_back( batch );
+
+        return packedDraw.batches.size() == 1;
+    }
+    //-----------------------------------------------------------------------
+    void InstanceManager::_setupPackedRenderOperation( InstanceBatchHW *leader, RenderOperation &op )
+    {
+        const String &materialName = leader->getMaterial()->getName();
+        PackedDraw &packedDraw = mPackedDraws[materialName];
+
+        //Render operations get requested once per pass, only write the instances once
+        if( !packedDraw.built )
+        {
+            buildPackedDraw( packedDraw, materialName, op );
+            packedDraw.built = true;
+        }
+
+        op.vertexData           = packedDraw.vertexData;
+        op.indirectCommands     = packedDraw.commands.empty() ? 0 : &packedDraw.commands[0];
+        op.numIndirectCommands  = packedDraw.commands.size();
+    }
+    //-----------------------------------------------------------------------
+    void InstanceManager::_addPendingBatch( InstanceBatch *batch, const Camera *camera )
+    {
+        const unsigned long frameNumber = Root::getSingleton().getNextFrameNumber();
+
+        //Once built (or with another camera or frame) a new render queue fill started
+        if( mPendingUpdates.built || mPendingUpdates.camera != camera ||
+            mPendingUpdates.frameNumber != frameNumber )
+        {
+            mPendingUpdates.batches.clear();
+            mPendingUpdates.built       = false;
+            mPendingUpdates.camera      = camera;
+            mPendingUpdates.frameNumber = frameNumber;
+        }
+
+        mPendingUpdates.batches.push_back( batch );
+    }
+    //-----------------------------------------------------------------------
+    void InstanceManager::_updatePendingBatches(void)
+    {
+        if( mPendingUpdates.built )
+            return;
+        mPendingUpdates.built = true;
+
+        InstanceBatchVec &batches = mPendingUpdates.batches;
+        if( batches.empty() )
+            return;
+
+        //A batch queued twice in the same fill must not be written by two threads
+        std::sort( batches.begin(), batches.end() );
+        batches.erase( std::unique( batches.begin(), batches.end() ), batches.end() );
+
+        //Buffers are only locked & unlocked in this thread
+        InstanceBatchVec::const_iterator itor = batches.begin();
+        InstanceBatchVec::const_iterator end  = batches.end();
+        while( itor != end )
+            (*itor++)->_prepareConcurrentInstanceUpdate();
+
+        //Bring the lazily updated camera state up to date here rather than racing on it.
+        //The frustum planes already were, by the visibility checks of the fill
+        mPendingUpdates.camera->getDerivedPosition();
+
+        InstanceBatchUpdateTask task( &batches[0] );
+        Root::getSingleton().getWorkQueue()->parallelFor( batches.size(), 1, &task );
+
+        itor = batches.begin();
+        while( itor != end )
+            (*itor++)->_finishConcurrentInstanceUpdate();
+    }
+    //-----------------------------------------------------------------------
+    void InstanceManager::buildPackedDraw( PackedDraw &packedDraw, const String &materialName,
+                                           const RenderOperation &batchOperation )
+    {
+        //All batches share the geometry buffers, only the instance buffer (last source) differs
+        const unsigned short lastSource = batchOperation.vertexData->vertexDeclaration->getMaxSource();
+
+        if( !packedDraw.vertexData )
+            packedDraw.vertexData = batchOperation.vertexData->clone( false );
+
+        //Make room for every batch of this material being fully visible
+        const size_t neededCapacity = mInstanceBatches[materialName].size() * mInstancesPerBatch;
+        if( packedDraw.capacity < neededCapacity )
+        {
+            HardwareVertexBufferSharedPtr vertexBuffer =
+                                        HardwareBufferManager::getSingleton().createVertexBuffer(
+                                        packedDraw.vertexData->vertexDeclaration->getVertexSize( lastSource ),
+                                        neededCapacity,
+                                        HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE );
+            vertexBuffer->setIsInstanceData( true );
+            vertexBuffer->setInstanceDataStepRate( 1 );
+            packedDraw.vertexData->vertexBufferBinding->setBinding( lastSource, vertexBuffer );
+            packedDraw.capacity = neededCapacity;
+        }
+
+        HardwareVertexBufferSharedPtr instanceBuffer =
+                                    packedDraw.vertexData->vertexBufferBinding->getBuffer( lastSource );
+        const size_t floatsPerInstance = instanceBuffer->getVertexSize() / sizeof(float);
+        float *pDest = static_cast<float*>( instanceBuffer->lock( HardwareBuffer::HBL_DISCARD ) );
+
+        packedDraw.commands.clear();
+
+        if( mParallelUpdates && packedDraw.batches.size() > 1 )
+        {
+            //Each batch writes to the slot it would take if all instances were visible, so they
+            //don't depend on each other. The commands then skip over the unused space
+            vector<size_t>::type numInstances( packedDraw.batches.size() );
+            packedDraw.camera->getDerivedPosition();
+            PackedInstancesTask task( &packedDraw.batches[0], pDest,
+                                      mInstancesPerBatch * floatsPerInstance, &numInstances[0] );
+            Root::getSingleton().getWorkQueue()->parallelFor( packedDraw.batches.size(), 1, &task );
+
+            for( size_t i=0; i<numInstances.size(); ++i )
+            {
+                if( !numInstances[i] )
+                    continue;
+
+                const uint32 slot = static_cast<uint32>( i * mInstancesPerBatch );
+                if( !packedDraw.commands.empty() &&
+                    packedDraw.commands.back().baseInstance + packedDraw.commands.back().instanceCount == slot )
+                {
+                    packedDraw.commands.back().instanceCount += static_cast<uint32>( numInstances[i] );
+                }
+                else
+                {
+                    IndirectDrawCommand command;
+                    command.indexCount      = static_cast<uint32>( batchOperation.indexData->indexCount );
+                    command.instanceCount   = static_cast<uint32>( numInstances[i] );
+                    command.firstIndex      = static_cast<uint32>( batchOperation.indexData->indexStart );
+                    command.baseVertex      = static_cast<int32>( batchOperation.vertexData->vertexStart );
+                    command.baseInstance    = slot;
+                    packedDraw.commands.push_back( command );
+                }
+            }
+
+            instanceBuffer->unlock();
+            return;
+        }
+
+        uint32 baseInstance = 0;
+        InstanceBatchVec::const_iterator itor = packedDraw.batches.begin();
+        InstanceBatchVec::const_iterator end  = packedDraw.batches.end();
+
+        while( itor != end )
+        {
+            const size_t numInstances = static_cast<InstanceBatchHW*>(*itor)->_writePackedInstances( pDest );
+            pDest += numInstances * floatsPerInstance;
+
+            //Batches share the same index range, so the instances of consecutive batches
+            //just extend the previous command
+            if( !packedDraw.commands.empty() )
+            {
+                packedDraw.commands.back().instanceCount += static_cast<uint32>( numInstances );
+            }
+            else if( numInstances )
+            {
+                IndirectDrawCommand command;
+                command.indexCount      = static_cast<uint32>( batchOperation.indexData->indexCount );
+                command.instanceCount   = static_cast<uint32>( numInstances );
+                command.firstIndex      = static_cast<uint32>( batchOperation.indexData->indexStart );
+                command.baseVertex      = static_cast<int32>( batchOperation.vertexData->vertexStart );
+                command.baseInstance    = baseInstance;
+                packedDraw.commands.push_back( command );
+            }
+
+            baseInstance += static_cast<uint32>( numInstances );
+            ++itor;
+        }
+
+        instanceBuffer->unlock();
+    }
+    //-----------------------------------------------------------------------
     // Helper functions to unshare the vertices
     //-----------------------------------------------------------------------
     typedef map<uint32, uint32>::type IndicesMap;
@@ -51,6 +51,8 @@ namespace Ogre
                 mFrameAnimationLastUpdated(std::numeric_limits<unsigned long>::max() - 1),
                 mSharedTransformEntity( 0 ),
                 mTransformLookupNumber(instanceID),
+                mBakedAnimationIndex(0),
+                mBakedAnimationTime(0),
                 mPosition(Vector3::ZERO),
                 mDerivedLocalPosition(Vector3::ZERO),
                 mOrientation(Quaternion::IDENTITY),
@@ -444,6 +446,8 @@ namespace Ogre
         mNeedTransformUpdate = true;
         mNeedAnimTransformUpdate = true; 
         mBatchOwner->_boundsDirty();
+        // The cached world box only follows the parent node's transform version
+        invalidateWorldBoundingBox();
     }
 
     //---------------------------------------------------------------------------
@@ -510,6 +514,7 @@ namespace Ogre
                 mFullLocalTransform.makeTransform(mPosition,mScale,mOrientation);
             }
             mNeedTransformUpdate = false;
+            invalidateWorldBoundingBox();
         }
     }
 
@@ -519,6 +524,7 @@ namespace Ogre
         mInUse = used;
         //Remove the use of local transform if the object is deleted
         mUseLocalTransform &= used;
+        invalidateWorldBoundingBox();
     }
     //---------------------------------------------------------------------------
     void InstancedEntity::setCustomParam( unsigned char idx, const Vector4 &newParam )
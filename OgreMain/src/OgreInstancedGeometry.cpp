@@ -39,6 +39,7 @@ THE SOFTWARE.
 #include "OgreMaterialManager.h"
 #include "OgreSkeletonInstance.h"
 #include "OgreLodStrategy.h"
+#include "OgreOptimisedUtil.h"
 
 namespace Ogre {
 
@@ -278,32 +279,39 @@ namespace Ogre {
             static_cast<unsigned char*>(
                 vbuf->lock(HardwareBuffer::HBL_READ_ONLY));
         float* pFloat;
+        size_t vertexSize = vbuf->getVertexSize();
 
         Vector3 min = Vector3::ZERO, max = Vector3::UNIT_SCALE;
         bool first = true;
 
-        for(size_t j = 0; j < vertexData->vertexCount; ++j, vertex += vbuf->getVertexSize())
+        // Transform to world (scale, rotate, translate) a batch at a time
+        Matrix4 xform;
+        xform.makeTransform(position, scale, orientation);
+        const size_t batchSize = 256;
+        float transformed[batchSize * 3];
+
+        for(size_t j = 0; j < vertexData->vertexCount; j += batchSize)
         {
+            size_t count = std::min(batchSize, vertexData->vertexCount - j);
             posElem->baseVertexPointerToElement(vertex, &pFloat);
+            OptimisedUtil::getImplementation()->transformPoints(xform,
+                pFloat, transformed, vertexSize, 3 * sizeof(float), count);
+            vertex += count * vertexSize;
 
-            Vector3 pt;
-
-            pt.x = (*pFloat++);
-            pt.y = (*pFloat++);
-            pt.z = (*pFloat++);
-            // Transform to world (scale, rotate, translate)
-            pt = (orientation * (pt * scale)) + position;
-            if (first)
-            {
-                min = max = pt;
-                first = false;
-            }
-            else
+            for (size_t k = 0; k < count; ++k)
             {
-                min.makeFloor(pt);
-                max.makeCeil(pt);
+                Vector3 pt(transformed[k * 3 + 0], transformed[k * 3 + 1], transformed[k * 3 + 2]);
+                if (first)
+                {
+                    min = max = pt;
+                    first = false;
+                }
+                else
+                {
+                    min.makeFloor(pt);
+                    max.makeCeil(pt);
+                }
             }
-
         }
         vbuf->unlock();
         return AxisAlignedBox(min, max);
@@ -55,6 +55,7 @@ namespace Ogre {
           mShadowFarDistSquared(0),
           mShadowNearClipDist(-1),
           mShadowFarClipDist(-1),
+          mShadowUpdateInterval(1),
           mDerivedPosition(Vector3::ZERO),
           mDerivedDirection(Vector3::UNIT_Z),
           mDerivedCamRelativePosition(Vector3::ZERO),
@@ -88,6 +89,7 @@ namespace Ogre {
         mShadowFarDistSquared(0),
         mShadowNearClipDist(-1),
         mShadowFarClipDist(-1),
+        mShadowUpdateInterval(1),
         mDerivedPosition(Vector3::ZERO),
         mDerivedDirection(Vector3::UNIT_Z),
         mDerivedCamRelativeDirty(false),
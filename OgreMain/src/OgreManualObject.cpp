@@ -48,7 +48,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     ManualObject::ManualObject(const String& name)
         : MovableObject(name),
-          mDynamic(false), mCurrentSection(0), mCurrentUpdating(false), mFirstVertex(true),
+          mDynamic(false), mCurrentSection(0), mCurrentUpdating(false), mCurrentDirect(false), mFirstVertex(true),
           mTempVertexPending(false),
           mTempVertexBuffer(0), mTempVertexSize(TEMP_INITIAL_VERTEX_SIZE),
           mTempIndexBuffer(0), mTempIndexSize(TEMP_INITIAL_INDEX_SIZE),
@@ -651,6 +651,12 @@ namespace Ogre {
                 "You cannot call end() until after you call begin()",
                 "ManualObject::end");
         }
+        if (mCurrentDirect)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "You must call endDirectUpdate() after beginDirectUpdate()",
+                "ManualObject::end");
+        }
         if (mTempVertexPending)
         {
             // bake current vertex
@@ -721,6 +727,7 @@ namespace Ogre {
                         vertexCount,
                         mDynamic? HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY : 
                             HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+                vbuf->setOwnerName("ManualObject: " + mName);
                 rop->vertexData->vertexBufferBinding->setBinding(0, vbuf);
             }
             if (ibufNeedsCreating)
@@ -735,6 +742,7 @@ namespace Ogre {
                         indexCount,
                         mDynamic? HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY : 
                             HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+                rop->indexData->indexBuffer->setOwnerName("ManualObject: " + mName);
             }
             // Write vertex data
             vbuf->writeData(
@@ -771,7 +779,9 @@ namespace Ogre {
         } // empty section check
 
         mCurrentSection = 0;
-        resetTempAreas();
+        // Dynamic objects keep the temp areas for their next update
+        if (!mDynamic)
+            resetTempAreas();
 
         // Tell parent if present
         if (mParentNode)
@@ -784,6 +794,112 @@ namespace Ogre {
         return result;
     }
     //-----------------------------------------------------------------------------
+    void* ManualObject::beginDirectUpdate(size_t sectionIndex, size_t vertexCount,
+        size_t indexCount, void** indices)
+    {
+        if (mCurrentSection)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "You cannot call begin() again until after you call end()",
+                "ManualObject::beginDirectUpdate");
+        }
+        if (sectionIndex >= mSectionList.size())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Invalid section index - out of range.",
+                "ManualObject::beginDirectUpdate");
+        }
+        if (indexCount && !indices)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Indices are written but no pointer was given to receive them",
+                "ManualObject::beginDirectUpdate");
+        }
+        ManualObjectSection* section = mSectionList[sectionIndex];
+        RenderOperation* rop = section->getRenderOperation();
+        size_t vertexSize = rop->vertexData->vertexDeclaration->getVertexSize(0);
+
+        // Vertices, the buffer is reused if large enough
+        HardwareVertexBufferSharedPtr vbuf;
+        if (rop->vertexData->vertexBufferBinding->isBufferBound(0))
+            vbuf = rop->vertexData->vertexBufferBinding->getBuffer(0);
+        if (vbuf.isNull() || vbuf->getNumVertices() < vertexCount)
+        {
+            vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+                vertexSize,
+                std::max(vertexCount, mEstVertexCount),
+                mDynamic? HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY :
+                    HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+            vbuf->setOwnerName("ManualObject: " + mName);
+            rop->vertexData->vertexBufferBinding->setBinding(0, vbuf);
+        }
+
+        // Indices, the same way
+        rop->useIndexes = indexCount != 0;
+        if (rop->useIndexes)
+        {
+            if (!rop->indexData)
+            {
+                rop->indexData = OGRE_NEW IndexData();
+                rop->indexData->indexCount = 0;
+            }
+            HardwareIndexBuffer::IndexType indexType = section->get32BitIndices()?
+                HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT;
+            HardwareIndexBufferSharedPtr& ibuf = rop->indexData->indexBuffer;
+            if (ibuf.isNull() || ibuf->getNumIndexes() < indexCount || ibuf->getType() != indexType)
+            {
+                ibuf = HardwareBufferManager::getSingleton().createIndexBuffer(
+                    indexType,
+                    std::max(indexCount, mEstIndexCount),
+                    mDynamic? HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY :
+                        HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+                ibuf->setOwnerName("ManualObject: " + mName);
+            }
+            *indices = ibuf->lock(0, indexCount * ibuf->getIndexSize(), HardwareBuffer::HBL_DISCARD);
+            rop->indexData->indexCount = indexCount;
+        }
+        else if (rop->indexData)
+        {
+            rop->indexData->indexCount = 0;
+        }
+
+        mCurrentSection = section;
+        mCurrentUpdating = true;
+        mCurrentDirect = true;
+        rop->vertexData->vertexCount = vertexCount;
+        if (!vertexCount)
+            return 0;
+        return vbuf->lock(0, vertexCount * vertexSize, HardwareBuffer::HBL_DISCARD);
+    }
+    //-----------------------------------------------------------------------------
+    void ManualObject::endDirectUpdate(const AxisAlignedBox& bounds)
+    {
+        if (!mCurrentDirect)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "You cannot call endDirectUpdate() until after you call beginDirectUpdate()",
+                "ManualObject::endDirectUpdate");
+        }
+        RenderOperation* rop = mCurrentSection->getRenderOperation();
+        if (rop->vertexData->vertexCount)
+            rop->vertexData->vertexBufferBinding->getBuffer(0)->unlock();
+        if (rop->useIndexes)
+            rop->indexData->indexBuffer->unlock();
+
+        mAABB.merge(bounds);
+        if (mAABB.isFinite())
+            mRadius = std::max(mRadius, Math::boundingRadiusFromAABB(mAABB));
+
+        mCurrentSection = 0;
+        mCurrentDirect = false;
+
+        // Tell parent if present
+        if (mParentNode)
+        {
+            mParentNode->needUpdate();
+        }
+    }
+    //-----------------------------------------------------------------------------
     void ManualObject::setMaterialName(size_t idx, const String& name, const String& group)
     {
         if (idx >= mSectionList.size())
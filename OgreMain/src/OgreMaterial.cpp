@@ -157,6 +157,7 @@ namespace Ogre {
             (*i)->_load();
         }
 
+        MaterialManager::getSingleton()._notifyMaterialCompiledLazily(this);
     }
     //-----------------------------------------------------------------------
     void Material::unloadImpl(void)
@@ -32,6 +32,12 @@ THE SOFTWARE.
 #include "OgreTechnique.h"
 #include "OgreScriptCompiler.h"
 #include "OgreLodStrategyManager.h"
+#include "OgreLogManager.h"
+#include "OgreTimer.h"
+#include "OgreRoot.h"
+#include "OgreStringConverter.h"
+
+#include <fstream>
 
 
 namespace Ogre {
@@ -77,6 +83,9 @@ namespace Ogre {
         mActiveSchemeName = DEFAULT_SCHEME_NAME;
         mSchemes[mActiveSchemeName] = 0;
 
+        mWarmUpTimeBudget = 5;
+        mWarmingUp = false;
+        mRecordWarmUpManifest = false;
     }
     //-----------------------------------------------------------------------
     MaterialManager::~MaterialManager()
@@ -275,7 +284,10 @@ namespace Ogre {
                 Technique* t = (*i)->handleSchemeNotFound(mActiveSchemeIndex, 
                     mActiveSchemeName, mat, lodIndex, rend);
                 if (t)
+                {
+                    _notifyMaterialCompiledLazily(mat);
                     return t;
+                }
             }
         }
 
@@ -289,7 +301,10 @@ namespace Ogre {
                 Technique* t = (*i)->handleSchemeNotFound(mActiveSchemeIndex, 
                     mActiveSchemeName, mat, lodIndex, rend);
                 if (t)
+                {
+                    _notifyMaterialCompiledLazily(mat);
                     return t;
+                }
             }
         }
         
@@ -356,4 +371,157 @@ namespace Ogre {
 		}
 	}
 
+    //---------------------------------------------------------------------
+    bool MaterialManager::warmUpEntry(const WarmUpEntry& entry)
+    {
+        MaterialPtr mat = getByName(entry.material, entry.group.empty() ?
+            ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME : entry.group);
+        if (mat.isNull())
+        {
+            LogManager::getSingleton().logMessage("Warm-up: material '" + entry.material +
+                "' not found, skipping");
+            return false;
+        }
+
+        const String& scheme = entry.scheme.empty() ? DEFAULT_SCHEME_NAME : entry.scheme;
+        String previousScheme = mActiveSchemeName;
+        mWarmingUp = true;
+        try
+        {
+            mat->load();
+
+            // Looking up the best technique lets scheme listeners generate theirs
+            setActiveScheme(scheme);
+            unsigned short numLods = std::max<unsigned short>(1, mat->getNumLodLevels(scheme));
+            for (unsigned short lod = 0; lod < numLods; ++lod)
+            {
+                Technique* t = mat->getBestTechnique(lod);
+                if (t && t->isSupported())
+                    t->_load();
+            }
+        }
+        catch (Exception& e)
+        {
+            LogManager::getSingleton().logMessage("Warm-up of material '" + entry.material +
+                "' for scheme '" + scheme + "' failed: " + e.getFullDescription(), LML_CRITICAL);
+        }
+        setActiveScheme(previousScheme);
+        mWarmingUp = false;
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void MaterialManager::warmUp(const WarmUpList& entries, WarmUpListener* listener)
+    {
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            warmUpEntry(entries[i]);
+            if (listener)
+                listener->warmUpProgress(entries[i], i + 1, entries.size());
+        }
+    }
+    //---------------------------------------------------------------------
+    void MaterialManager::queueWarmUp(const WarmUpList& entries, WarmUpListener* listener)
+    {
+        if (entries.empty())
+            return;
+
+        PendingWarmUp pending;
+        pending.entries = entries;
+        pending.next = 0;
+        pending.listener = listener;
+        mPendingWarmUps.push_back(pending);
+    }
+    //---------------------------------------------------------------------
+    size_t MaterialManager::getPendingWarmUpCount() const
+    {
+        size_t count = 0;
+        for (PendingWarmUpList::const_iterator i = mPendingWarmUps.begin();
+            i != mPendingWarmUps.end(); ++i)
+        {
+            count += i->entries.size() - i->next;
+        }
+        return count;
+    }
+    //---------------------------------------------------------------------
+    void MaterialManager::_updateWarmUp()
+    {
+        if (mPendingWarmUps.empty())
+            return;
+
+        Timer* timer = Root::getSingleton().getTimer();
+        unsigned long start = timer->getMilliseconds();
+        do
+        {
+            PendingWarmUp& pending = mPendingWarmUps.front();
+            const WarmUpEntry& entry = pending.entries[pending.next++];
+            warmUpEntry(entry);
+            if (pending.listener)
+                pending.listener->warmUpProgress(entry, pending.next, pending.entries.size());
+
+            if (pending.next == pending.entries.size())
+                mPendingWarmUps.pop_front();
+        }
+        while (!mPendingWarmUps.empty() &&
+            (mWarmUpTimeBudget == 0 || timer->getMilliseconds() - start < mWarmUpTimeBudget));
+    }
+    //---------------------------------------------------------------------
+    void MaterialManager::_notifyMaterialCompiledLazily(const Material* mat)
+    {
+        if (!mRecordWarmUpManifest || mWarmingUp)
+            return;
+
+        OGRE_LOCK_MUTEX(mWarmUpMutex);
+        mRecordedWarmUps.insert(WarmUpEntry(mat->getName(), mat->getGroup(), mActiveSchemeName));
+    }
+    //---------------------------------------------------------------------
+    MaterialManager::WarmUpList MaterialManager::getRecordedWarmUpList() const
+    {
+        OGRE_LOCK_MUTEX(mWarmUpMutex);
+        return WarmUpList(mRecordedWarmUps.begin(), mRecordedWarmUps.end());
+    }
+    //---------------------------------------------------------------------
+    void MaterialManager::clearRecordedWarmUpList()
+    {
+        OGRE_LOCK_MUTEX(mWarmUpMutex);
+        mRecordedWarmUps.clear();
+    }
+    //---------------------------------------------------------------------
+    void MaterialManager::saveWarmUpManifest(const String& filename) const
+    {
+        std::ofstream file(filename.c_str());
+        if (!file)
+        {
+            OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+                "Cannot open '" + filename + "' for writing",
+                "MaterialManager::saveWarmUpManifest");
+        }
+
+        WarmUpList entries = getRecordedWarmUpList();
+        for (WarmUpList::const_iterator i = entries.begin(); i != entries.end(); ++i)
+        {
+            file << i->scheme << '\t' << i->group << '\t' << i->material << '\n';
+        }
+    }
+    //---------------------------------------------------------------------
+    MaterialManager::WarmUpList MaterialManager::loadWarmUpManifest(const DataStreamPtr& stream) const
+    {
+        WarmUpList entries;
+        while (!stream->eof())
+        {
+            String line = stream->getLine();
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            StringVector fields = StringUtil::split(line, "\t", 2);
+            if (fields.size() != 3)
+            {
+                LogManager::getSingleton().logMessage("Warm-up manifest " + stream->getName() +
+                    ": skipping malformed line '" + line + "'");
+                continue;
+            }
+            entries.push_back(WarmUpEntry(fields[2], fields[1], fields[0]));
+        }
+        return entries;
+    }
+
 }
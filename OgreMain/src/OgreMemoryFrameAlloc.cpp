@@ -0,0 +1,155 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreMemoryFrameAlloc.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        /// Size of the blocks the arena is made of, bigger allocations get their own block
+        const size_t FRAME_ALLOC_BLOCK_SIZE = 256 * 1024;
+        /// Alignment of every allocation
+        const size_t FRAME_ALLOC_ALIGNMENT = 16;
+
+        struct FrameAllocBlock
+        {
+            uchar* data;
+            size_t size;
+        };
+        typedef vector<FrameAllocBlock>::type FrameAllocBlockList;
+
+        FrameAllocBlockList gFrameAllocBlocks;
+        /// Block currently allocated from, and the offset of its free space
+        size_t gFrameAllocCurrentBlock = 0;
+        size_t gFrameAllocOffset = 0;
+        size_t gFrameAllocBytes = 0;
+        /// Number of allocations not freed yet
+        size_t gFrameAllocLive = 0;
+
+        void rewindFrameAlloc()
+        {
+            gFrameAllocCurrentBlock = 0;
+            gFrameAllocOffset = 0;
+            gFrameAllocBytes = 0;
+        }
+
+#if OGRE_DEBUG_MODE && OGRE_THREAD_SUPPORT
+        /// Thread the arena was first used from, which must then be the only one using it
+        OGRE_THREAD_ID_TYPE gFrameAllocOwner;
+        bool gFrameAllocOwned = false;
+
+        void checkFrameAllocThread()
+        {
+            if (!gFrameAllocOwned)
+            {
+                gFrameAllocOwner = OGRE_THREAD_CURRENT_ID;
+                gFrameAllocOwned = true;
+            }
+            assert(gFrameAllocOwner == OGRE_THREAD_CURRENT_ID &&
+                "The frame arena may only be used from the thread rendering the frames");
+        }
+        void releaseFrameAllocThread()
+        {
+            gFrameAllocOwned = false;
+        }
+#else
+        inline void checkFrameAllocThread() {}
+        inline void releaseFrameAllocThread() {}
+#endif
+    }
+    //---------------------------------------------------------------------
+    void* FrameAllocImpl::allocBytes(size_t count)
+    {
+        checkFrameAllocThread();
+        count = (count + FRAME_ALLOC_ALIGNMENT - 1) & ~(FRAME_ALLOC_ALIGNMENT - 1);
+
+        // Find a block with enough space left, the remainder of the blocks 
+        // passed over is wasted until the next reset
+        while (gFrameAllocCurrentBlock < gFrameAllocBlocks.size() &&
+            gFrameAllocOffset + count > gFrameAllocBlocks[gFrameAllocCurrentBlock].size)
+        {
+            ++gFrameAllocCurrentBlock;
+            gFrameAllocOffset = 0;
+        }
+
+        if (gFrameAllocCurrentBlock == gFrameAllocBlocks.size())
+        {
+            FrameAllocBlock block;
+            block.size = std::max(count, FRAME_ALLOC_BLOCK_SIZE);
+            block.data = static_cast<uchar*>(OGRE_MALLOC_SIMD(block.size, MEMCATEGORY_GENERAL));
+            gFrameAllocBlocks.push_back(block);
+        }
+
+        void* ptr = gFrameAllocBlocks[gFrameAllocCurrentBlock].data + gFrameAllocOffset;
+        gFrameAllocOffset += count;
+        gFrameAllocBytes += count;
+        ++gFrameAllocLive;
+        return ptr;
+    }
+    //---------------------------------------------------------------------
+    void FrameAllocImpl::deallocBytes(void* ptr)
+    {
+        // deal with null
+        if (!ptr)
+            return;
+
+        checkFrameAllocThread();
+        assert(gFrameAllocLive > 0 && "Freeing memory not allocated from the frame arena");
+        // Nothing is reclaimed until the whole arena is unused
+        if (--gFrameAllocLive == 0)
+            rewindFrameAlloc();
+    }
+    //---------------------------------------------------------------------
+    void FrameAllocImpl::_reset(void)
+    {
+        checkFrameAllocThread();
+        // Memory still in use was kept across the frame, so it can't be reused
+        // until it is freed
+        if (gFrameAllocLive == 0)
+            rewindFrameAlloc();
+    }
+    //---------------------------------------------------------------------
+    void FrameAllocImpl::_release(void)
+    {
+        for (FrameAllocBlockList::iterator i = gFrameAllocBlocks.begin(); 
+            i != gFrameAllocBlocks.end(); ++i)
+        {
+            OGRE_FREE_SIMD(i->data, MEMCATEGORY_GENERAL);
+        }
+        FrameAllocBlockList().swap(gFrameAllocBlocks);
+        gFrameAllocLive = 0;
+        rewindFrameAlloc();
+        releaseFrameAllocThread();
+    }
+    //---------------------------------------------------------------------
+    size_t FrameAllocImpl::getBytesAllocated(void)
+    {
+        return gFrameAllocBytes;
+    }
+}
@@ -46,15 +46,19 @@ namespace Ogre
     namespace _NedPoolingIntern
     {
         const size_t s_poolCount = 14; // Needs to be greater than 4
-        void* s_poolFootprint = reinterpret_cast<void*>(0xBB1AA45A);
-        nedalloc::nedpool* s_pools[s_poolCount + 1] = { 0 };
-        nedalloc::nedpool* s_poolsAligned[s_poolCount + 1] = { 0 };
+        // Pools are stamped with the address of their category's footprint, so that
+        // freed memory can be traced back to its pool and category.
+        char s_poolFootprints[MEMCATEGORY_COUNT];
+        // Each category has its own pools, so that churn in one category doesn't
+        // fragment the others; the last pool takes the requests too large for the others.
+        nedalloc::nedpool* s_pools[MEMCATEGORY_COUNT][s_poolCount + 1] = { { 0 } };
+        nedalloc::nedpool* s_poolsAligned[MEMCATEGORY_COUNT][s_poolCount + 1] = { { 0 } };
 
         size_t poolIDFromSize(size_t a_reqSize)
         {
             // Requests size 16 or smaller are allocated at a 4 byte granularity.
             // Requests size 17 or larger are allocated at a 16 byte granularity.
-            // With a s_poolCount of 14, requests size 177 or larger go in the default pool.
+            // With a s_poolCount of 14, requests size 177 or larger go in the large pool.
 
             // spreadsheet style =IF(B35<=16; FLOOR((B35-1)/4;1); MIN(FLOOR((B35-1)/16; 1) + 3; 14))
 
@@ -75,46 +79,35 @@ namespace Ogre
             return poolID;
         }
 
-        void* internalAlloc(size_t a_reqSize)
+        nedalloc::nedpool* getPool(nedalloc::nedpool** pools, MemoryCategory a_category, size_t a_reqSize)
         {
             size_t poolID = poolIDFromSize(a_reqSize);
-            nedalloc::nedpool* pool(0); // A pool pointer of 0 means the default pool.
 
-            if (poolID < s_poolCount)
+            if (pools[poolID] == 0)
             {
-                if (s_pools[poolID] == 0)
-                {
-                    // Init pool if first use
-
-                    s_pools[poolID] = nedalloc::nedcreatepool(0, 8);
-                    nedalloc::nedpsetvalue(s_pools[poolID], s_poolFootprint); // All pools are stamped with a footprint
-                }
+                // Init pool if first use
 
-                pool = s_pools[poolID];
+                pools[poolID] = nedalloc::nedcreatepool(0, 8);
+                nedalloc::nedpsetvalue(pools[poolID], &s_poolFootprints[a_category]); // All pools are stamped with a footprint
             }
 
-            return nedalloc::nedpmalloc(pool, a_reqSize);
+            return pools[poolID];
         }
 
-        void* internalAllocAligned(size_t a_align, size_t a_reqSize)
+        void* internalAlloc(MemoryCategory a_category, size_t a_reqSize)
         {
-            size_t poolID = poolIDFromSize(a_reqSize);
-            nedalloc::nedpool* pool(0); // A pool pointer of 0 means the default pool.
-
-            if (poolID < s_poolCount)
-            {
-                if (s_poolsAligned[poolID] == 0)
-                {
-                    // Init pool if first use
-
-                    s_poolsAligned[poolID] = nedalloc::nedcreatepool(0, 8);
-                    nedalloc::nedpsetvalue(s_poolsAligned[poolID], s_poolFootprint); // All pools are stamped with a footprint
-                }
-
-                pool = s_poolsAligned[poolID];
-            }
+            void* ptr = nedalloc::nedpmalloc(getPool(s_pools[a_category], a_category, a_reqSize), a_reqSize);
+            if (ptr)
+                MemoryTracker::_recordCategoryAlloc(a_category, nedalloc::nedblksize(ptr));
+            return ptr;
+        }
 
-            return nedalloc::nedpmemalign(pool, a_align, a_reqSize);
+        void* internalAllocAligned(MemoryCategory a_category, size_t a_align, size_t a_reqSize)
+        {
+            void* ptr = nedalloc::nedpmemalign(getPool(s_poolsAligned[a_category], a_category, a_reqSize), a_align, a_reqSize);
+            if (ptr)
+                MemoryTracker::_recordCategoryAlloc(a_category, nedalloc::nedblksize(ptr));
+            return ptr;
         }
 
         void internalFree(void* a_mem)
@@ -124,12 +117,14 @@ namespace Ogre
                 nedalloc::nedpool* pool(0);
 
                 // nedalloc lets us get the pool pointer from the memory pointer
-                void* footprint = nedalloc::nedgetvalue(&pool, a_mem);
+                char* footprint = static_cast<char*>(nedalloc::nedgetvalue(&pool, a_mem));
 
                 // Check footprint
-                if (footprint == s_poolFootprint)
+                if (footprint >= s_poolFootprints && footprint < s_poolFootprints + MEMCATEGORY_COUNT)
                 {
                     // If we allocated the pool, deallocate from this pool...
+                    MemoryTracker::_recordCategoryDealloc(
+                        static_cast<MemoryCategory>(footprint - s_poolFootprints), nedalloc::nedblksize(a_mem));
                     nedalloc::nedpfree(pool, a_mem);
                 }
                 else
@@ -145,9 +140,15 @@ namespace Ogre
     void* NedPoolingImpl::allocBytes(size_t count, 
         const char* file, int line, const char* func)
     {
-        void* ptr = _NedPoolingIntern::internalAlloc(count);
+        return allocBytes(count, MEMCATEGORY_GENERAL, file, line, func);
+    }
+    //---------------------------------------------------------------------
+    void* NedPoolingImpl::allocBytes(size_t count, MemoryCategory category,
+        const char* file, int line, const char* func)
+    {
+        void* ptr = _NedPoolingIntern::internalAlloc(category, count);
 #if OGRE_MEMORY_TRACKER
-        MemoryTracker::get()._recordAlloc(ptr, count, 0, file, line, func);
+        MemoryTracker::get()._recordAlloc(ptr, count, category, file, line, func);
 #else
         // avoid unused params warning
         file = func = "";
@@ -169,12 +170,17 @@ namespace Ogre
     //---------------------------------------------------------------------
     void* NedPoolingImpl::allocBytesAligned(size_t align, size_t count, 
         const char* file, int line, const char* func)
+    {
+        return allocBytesAligned(align, count, MEMCATEGORY_GENERAL, file, line, func);
+    }
+    //---------------------------------------------------------------------
+    void* NedPoolingImpl::allocBytesAligned(size_t align, size_t count, MemoryCategory category,
+        const char* file, int line, const char* func)
     {
         // default to platform SIMD alignment if none specified
-        void* ptr =  align ? _NedPoolingIntern::internalAllocAligned(align, count)
-            : _NedPoolingIntern::internalAllocAligned(OGRE_SIMD_ALIGNMENT, count);
+        void* ptr = _NedPoolingIntern::internalAllocAligned(category, align ? align : OGRE_SIMD_ALIGNMENT, count);
 #if OGRE_MEMORY_TRACKER
-        MemoryTracker::get()._recordAlloc(ptr, count, 0, file, line, func);
+        MemoryTracker::get()._recordAlloc(ptr, count, category, file, line, func);
 #else
         // avoid unused params warning
         file = func = "";
@@ -194,7 +200,6 @@ namespace Ogre
         _NedPoolingIntern::internalFree(ptr);
     }
 
-
 }
 
 
@@ -0,0 +1,258 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreMemorySmallObjectAlloc.h"
+#include "OgreAtomicScalar.h"
+
+#if OGRE_THREAD_SUPPORT
+#   if OGRE_COMPILER == OGRE_COMPILER_MSVC
+#       define OGRE_SMALL_OBJECT_THREAD_LOCAL __declspec(thread)
+#   else
+#       define OGRE_SMALL_OBJECT_THREAD_LOCAL __thread
+#   endif
+#else
+#   define OGRE_SMALL_OBJECT_THREAD_LOCAL
+#endif
+
+namespace Ogre
+{
+    namespace
+    {
+        /// Difference between the block sizes of consecutive size classes
+        const size_t SMALL_OBJECT_SIZE_STEP = 16;
+        const size_t SMALL_OBJECT_NUM_SIZES = SmallObjectAllocImpl::MAX_SIZE / SMALL_OBJECT_SIZE_STEP;
+        /// Size of the chunks the blocks are carved out of
+        const size_t SMALL_OBJECT_CHUNK_SIZE = 64 * 1024;
+        /// Space before each block, keeps the blocks 16 byte aligned
+        const size_t SMALL_OBJECT_HEADER_SIZE = 16;
+        /// Space at the start of each chunk, links the chunks of a cache
+        const size_t SMALL_OBJECT_CHUNK_HEADER_SIZE = 16;
+
+        struct SmallObjectCache;
+
+        /// Written in front of each block when it is carved
+        struct SmallObjectHeader
+        {
+            /// Cache the block belongs to, 0 for allocations too big for the caches
+            SmallObjectCache* owner;
+            size_t sizeClass;
+        };
+
+        /// Overlays a free block
+        struct SmallObjectBlock
+        {
+            SmallObjectBlock* next;
+        };
+
+        struct SmallObjectCache
+        {
+            /// Free blocks of each size class, only touched by the owning thread
+            SmallObjectBlock* freeLists[SMALL_OBJECT_NUM_SIZES];
+            /// Blocks freed by other threads, under remoteMutex
+            SmallObjectBlock* remoteLists[SMALL_OBJECT_NUM_SIZES];
+            /// Number of blocks in remoteLists, read by the owner without locking
+            AtomicScalar<uint32> numRemote;
+            OGRE_MUTEX(remoteMutex);
+            /// Next cache released by its thread
+            SmallObjectCache* nextReleased;
+            /// Chunks carved by this cache, each one starts with the next
+            uchar* chunks;
+
+            SmallObjectCache() : numRemote(0), nextReleased(0), chunks(0)
+            {
+                memset(freeLists, 0, sizeof(freeLists));
+                memset(remoteLists, 0, sizeof(remoteLists));
+            }
+        };
+
+        OGRE_SMALL_OBJECT_THREAD_LOCAL SmallObjectCache* gThreadCache = 0;
+        /// Caches released by threads, waiting for a new owner
+        SmallObjectCache* gReleasedCaches = 0;
+        OGRE_STATIC_MUTEX(gReleasedMutex);
+
+        /** Puts a cache released by its thread aside, or if released is null,
+            gets one for the calling thread. */
+        SmallObjectCache* exchangeCache(SmallObjectCache* released)
+        {
+            OGRE_LOCK_MUTEX(gReleasedMutex);
+
+            if (released)
+            {
+                released->nextReleased = gReleasedCaches;
+                gReleasedCaches = released;
+                return 0;
+            }
+
+            if (!gReleasedCaches)
+                return OGRE_NEW_T(SmallObjectCache, MEMCATEGORY_GENERAL)();
+
+            SmallObjectCache* cache = gReleasedCaches;
+            gReleasedCaches = cache->nextReleased;
+            cache->nextReleased = 0;
+            return cache;
+        }
+
+        inline SmallObjectHeader* getHeader(void* ptr)
+        {
+            return reinterpret_cast<SmallObjectHeader*>(static_cast<uchar*>(ptr) - SMALL_OBJECT_HEADER_SIZE);
+        }
+
+        /// Fills the empty free list of a size class
+        void refill(SmallObjectCache* cache, size_t sizeClass)
+        {
+            // Take back the blocks other threads freed
+            if (cache->numRemote.get())
+            {
+                OGRE_LOCK_MUTEX(cache->remoteMutex);
+                for (size_t i = 0; i < SMALL_OBJECT_NUM_SIZES; ++i)
+                {
+                    while (SmallObjectBlock* block = cache->remoteLists[i])
+                    {
+                        cache->remoteLists[i] = block->next;
+                        block->next = cache->freeLists[i];
+                        cache->freeLists[i] = block;
+                    }
+                }
+                cache->numRemote.set(0);
+            }
+
+            if (cache->freeLists[sizeClass])
+                return;
+
+            // Carve a new chunk
+            const size_t blockSize = SMALL_OBJECT_HEADER_SIZE + (sizeClass + 1) * SMALL_OBJECT_SIZE_STEP;
+            uchar* chunk = OGRE_ALLOC_T(uchar, SMALL_OBJECT_CHUNK_SIZE, MEMCATEGORY_GENERAL);
+            *reinterpret_cast<uchar**>(chunk) = cache->chunks;
+            cache->chunks = chunk;
+            for (size_t offset = SMALL_OBJECT_CHUNK_HEADER_SIZE; offset + blockSize <= SMALL_OBJECT_CHUNK_SIZE; offset += blockSize)
+            {
+                SmallObjectHeader* header = reinterpret_cast<SmallObjectHeader*>(chunk + offset);
+                header->owner = cache;
+                header->sizeClass = sizeClass;
+
+                SmallObjectBlock* block = reinterpret_cast<SmallObjectBlock*>(chunk + offset + SMALL_OBJECT_HEADER_SIZE);
+                block->next = cache->freeLists[sizeClass];
+                cache->freeLists[sizeClass] = block;
+            }
+        }
+
+        /// Returns the chunks of a cache to the general allocator and deletes it
+        void destroyCache(SmallObjectCache* cache)
+        {
+            while (uchar* chunk = cache->chunks)
+            {
+                cache->chunks = *reinterpret_cast<uchar**>(chunk);
+                OGRE_FREE(chunk, MEMCATEGORY_GENERAL);
+            }
+            OGRE_DELETE_T(cache, SmallObjectCache, MEMCATEGORY_GENERAL);
+        }
+    }
+    //---------------------------------------------------------------------
+    void* SmallObjectAllocImpl::allocBytes(size_t count, 
+        const char* file, int line, const char* func)
+    {
+        if (count > MAX_SIZE)
+        {
+            uchar* mem = static_cast<uchar*>(GeneralAllocPolicy::allocateBytes(
+                count + SMALL_OBJECT_HEADER_SIZE, file, line, func));
+            SmallObjectHeader* header = reinterpret_cast<SmallObjectHeader*>(mem);
+            header->owner = 0;
+            header->sizeClass = 0;
+            return mem + SMALL_OBJECT_HEADER_SIZE;
+        }
+
+        if (!gThreadCache)
+            gThreadCache = exchangeCache(0);
+
+        const size_t sizeClass = count ? (count - 1) / SMALL_OBJECT_SIZE_STEP : 0;
+        SmallObjectBlock* block = gThreadCache->freeLists[sizeClass];
+        if (!block)
+        {
+            refill(gThreadCache, sizeClass);
+            block = gThreadCache->freeLists[sizeClass];
+        }
+
+        gThreadCache->freeLists[sizeClass] = block->next;
+        return block;
+    }
+    //---------------------------------------------------------------------
+    void SmallObjectAllocImpl::deallocBytes(void* ptr)
+    {
+        if (!ptr)
+            return;
+
+        SmallObjectHeader* header = getHeader(ptr);
+        SmallObjectCache* owner = header->owner;
+        if (!owner)
+        {
+            GeneralAllocPolicy::deallocateBytes(header);
+            return;
+        }
+
+        SmallObjectBlock* block = static_cast<SmallObjectBlock*>(ptr);
+        const size_t sizeClass = header->sizeClass;
+        if (owner == gThreadCache)
+        {
+            block->next = owner->freeLists[sizeClass];
+            owner->freeLists[sizeClass] = block;
+        }
+        else
+        {
+            OGRE_LOCK_MUTEX(owner->remoteMutex);
+            block->next = owner->remoteLists[sizeClass];
+            owner->remoteLists[sizeClass] = block;
+            ++owner->numRemote;
+        }
+    }
+    //---------------------------------------------------------------------
+    void SmallObjectAllocImpl::_releaseThreadCache(void)
+    {
+        if (gThreadCache)
+        {
+            exchangeCache(gThreadCache);
+            gThreadCache = 0;
+        }
+    }
+    //---------------------------------------------------------------------
+    void SmallObjectAllocImpl::_freeCaches(void)
+    {
+        OGRE_LOCK_MUTEX(gReleasedMutex);
+
+        if (gThreadCache)
+        {
+            destroyCache(gThreadCache);
+            gThreadCache = 0;
+        }
+
+        while (SmallObjectCache* cache = gReleasedCaches)
+        {
+            gReleasedCaches = cache->nextReleased;
+            destroyCache(cache);
+        }
+    }
+}
@@ -30,7 +30,9 @@ THE SOFTWARE.
 #include "OgrePlatform.h"
 #include "OgrePrerequisites.h"
 #include "OgreMemoryTracker.h"
+#include "OgreAtomicScalar.h"
 #include <iostream>
+#include <ctime>
 
 #if OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || OGRE_PLATFORM == OGRE_PLATFORM_WINRT
 #   include <windows.h>
@@ -41,10 +43,81 @@ THE SOFTWARE.
 #   define Ogre_OutputWString(str) std::cerr << str
 #endif
 
+#if OGRE_MEMORY_TRACKER
+#   if OGRE_PLATFORM == OGRE_PLATFORM_LINUX || OGRE_PLATFORM == OGRE_PLATFORM_APPLE
+#       include <execinfo.h>
+#   endif
+#   if OGRE_COMPILER == OGRE_COMPILER_MSVC
+#       define OGRE_TRACKER_THREAD_LOCAL __declspec(thread)
+#   else
+#       define OGRE_TRACKER_THREAD_LOCAL __thread
+#   endif
+#endif
+
 namespace Ogre
 {
+    namespace
+    {
+        // Only default constructed, so they are zero before static initialisation
+        // and allocations made by other static initialisers are counted
+        AtomicScalar<size_t> sCategoryBytes[MEMCATEGORY_COUNT];
+        AtomicScalar<size_t> sCategoryAllocations[MEMCATEGORY_COUNT];
+    }
+    //--------------------------------------------------------------------------
+    MemoryTracker::CategoryStats MemoryTracker::getCategoryStats(MemoryCategory category)
+    {
+        CategoryStats stats;
+        stats.bytes = sCategoryBytes[category].get();
+        stats.allocations = sCategoryAllocations[category].get();
+        return stats;
+    }
+    //--------------------------------------------------------------------------
+    void MemoryTracker::_recordCategoryAlloc(MemoryCategory category, size_t sz)
+    {
+        sCategoryBytes[category] += sz;
+        ++sCategoryAllocations[category];
+    }
+    //--------------------------------------------------------------------------
+    void MemoryTracker::_recordCategoryDealloc(MemoryCategory category, size_t sz)
+    {
+        sCategoryBytes[category] -= sz;
+        --sCategoryAllocations[category];
+    }
     
 #if OGRE_MEMORY_TRACKER
+    namespace
+    {
+        /** Number of recorded allocations per pointer hash. A free whose slot is
+            empty can't be of a recorded allocation, so it is skipped without locking.
+            Only modified under the tracker's lock.
+        */
+        const size_t SAMPLE_FILTER_SIZE = 65536;
+        volatile uint16 sSampleFilter[SAMPLE_FILTER_SIZE];
+
+        size_t sampleFilterSlot(void* ptr)
+        {
+            size_t p = reinterpret_cast<size_t>(ptr);
+            // Low bits are mostly alignment
+            return ((p >> 4) ^ (p >> 20)) & (SAMPLE_FILTER_SIZE - 1);
+        }
+
+        /// Allocations left to skip on this thread before the next sample
+        OGRE_TRACKER_THREAD_LOCAL size_t tSampleCountdown = 0;
+
+        size_t captureStack(void** stack, size_t maxDepth)
+        {
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX || OGRE_PLATFORM == OGRE_PLATFORM_APPLE
+            int depth = backtrace(stack, static_cast<int>(maxDepth));
+            return depth > 0 ? static_cast<size_t>(depth) : 0;
+#elif OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+            return CaptureStackBackTrace(0, static_cast<DWORD>(maxDepth), stack, NULL);
+#else
+            (void)stack;
+            (void)maxDepth;
+            return 0;
+#endif
+        }
+    }
     //--------------------------------------------------------------------------
     MemoryTracker& MemoryTracker::get()
     {
@@ -57,17 +130,42 @@ namespace Ogre
     {
         if (mRecordEnable)
         {
+            Alloc alloc(sz, pool, file, ln, func);
+            if (mSamplingRate > 1)
+            {
+                if (tSampleCountdown > 1)
+                {
+                    --tSampleCountdown;
+                    return;
+                }
+                tSampleCountdown = mSamplingRate;
+                alloc.weight = mSamplingRate;
+                alloc.stackDepth = captureStack(alloc.stack, MAX_STACK_DEPTH);
+            }
+
                     OGRE_LOCK_AUTO_MUTEX;
 
                 assert(mAllocations.find(ptr) == mAllocations.end() && "Double allocation with same address - "
                 "this probably means you have a mismatched allocation / deallocation style, "
                 "check if you're are using OGRE_ALLOC_T / OGRE_FREE and OGRE_NEW_T / OGRE_DELETE_T consistently");
 
-            mAllocations[ptr] = Alloc(sz, pool, file, ln, func);
+            mAllocations[ptr] = alloc;
+            ++sSampleFilter[sampleFilterSlot(ptr)];
             if(pool >= mAllocationsByPool.size())
                 mAllocationsByPool.resize(pool+1, 0);
-            mAllocationsByPool[pool] += sz;
-            mTotalAllocations += sz;
+            mAllocationsByPool[pool] += sz * alloc.weight;
+            mTotalAllocations += sz * alloc.weight;
+
+            if (mSampleDumpInterval && alloc.weight > 1)
+            {
+                unsigned long now = static_cast<unsigned long>(std::time(0));
+                if (now - mLastSampleDump >= mSampleDumpInterval)
+                {
+                    mLastSampleDump = now;
+                    std::ofstream of(mSampleFileName.c_str());
+                    writeSamples(of);
+                }
+            }
         }
     
     }
@@ -80,20 +178,88 @@ namespace Ogre
             if (!ptr)
                 return;
 
+            // Most frees are of allocations which weren't sampled
+            if (mSamplingRate > 1 && sSampleFilter[sampleFilterSlot(ptr)] == 0)
+                return;
+
             OGRE_LOCK_AUTO_MUTEX;
 
             AllocationMap::iterator i = mAllocations.find(ptr);
-            assert(i != mAllocations.end() && "Unable to locate allocation unit - "
-                "this probably means you have a mismatched allocation / deallocation style, "
-                "check if you're are using OGRE_ALLOC_T / OGRE_FREE and OGRE_NEW_T / OGRE_DELETE_T consistently");
+            if (i == mAllocations.end())
+            {
+                assert(mSamplingRate > 1 && "Unable to locate allocation unit - "
+                    "this probably means you have a mismatched allocation / deallocation style, "
+                    "check if you're are using OGRE_ALLOC_T / OGRE_FREE and OGRE_NEW_T / OGRE_DELETE_T consistently");
+                return;
+            }
+            --sSampleFilter[sampleFilterSlot(ptr)];
             // update category stats
-            mAllocationsByPool[i->second.pool] -= i->second.bytes;
+            mAllocationsByPool[i->second.pool] -= i->second.bytes * i->second.weight;
             // global stats
-            mTotalAllocations -= i->second.bytes;
+            mTotalAllocations -= i->second.bytes * i->second.weight;
             mAllocations.erase(i);
         }
     }   
     //--------------------------------------------------------------------------
+    void MemoryTracker::setSamplingRate(size_t rate)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        mSamplingRate = rate ? rate : 1;
+    }
+    //--------------------------------------------------------------------------
+    void MemoryTracker::dumpSamples()
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        std::ofstream of(mSampleFileName.c_str());
+        writeSamples(of);
+    }
+    //--------------------------------------------------------------------------
+    void MemoryTracker::writeSamples(std::ostream& os)
+    {
+        // Group the live allocations by call site
+        typedef SampleSite Site;
+        typedef std::map<std::vector<void*>, Site> SiteMap;
+        SiteMap sites;
+        for (AllocationMap::const_iterator i = mAllocations.begin(); i != mAllocations.end(); ++i)
+        {
+            const Alloc& alloc = i->second;
+            std::vector<void*> key(alloc.stack, alloc.stack + alloc.stackDepth);
+            if (key.empty())
+                key.push_back(reinterpret_cast<void*>(alloc.line));
+            SiteMap::iterator site = sites.find(key);
+            if (site == sites.end())
+            {
+                Site newSite = { &alloc, 0, 0 };
+                site = sites.insert(SiteMap::value_type(key, newSite)).first;
+            }
+            site->second.bytes += alloc.bytes * alloc.weight;
+            site->second.count += alloc.weight;
+        }
+
+        std::multimap<size_t, const Site*> bySize;
+        for (SiteMap::const_iterator i = sites.begin(); i != sites.end(); ++i)
+            bySize.insert(std::make_pair(i->second.bytes, &i->second));
+
+        os << "Ogre Memory: " << mTotalAllocations << " bytes live, estimated from 1 in "
+            << mSamplingRate << " allocations, at " << sites.size() << " site(s)." << std::endl;
+        for (std::multimap<size_t, const Site*>::reverse_iterator i = bySize.rbegin(); i != bySize.rend(); ++i)
+        {
+            const Alloc& alloc = *i->second->alloc;
+            os << "{" << i->second->bytes << " bytes in " << i->second->count << " allocation(s)} "
+                << (alloc.filename.empty() ? "(unknown source)" : alloc.filename.c_str())
+                << "(" << alloc.line << ") function: " << alloc.function << std::endl;
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX || OGRE_PLATFORM == OGRE_PLATFORM_APPLE
+            char** symbols = backtrace_symbols(alloc.stack, static_cast<int>(alloc.stackDepth));
+            for (size_t f = 0; symbols && f < alloc.stackDepth; ++f)
+                os << "    " << symbols[f] << std::endl;
+            free(symbols);
+#else
+            for (size_t f = 0; f < alloc.stackDepth; ++f)
+                os << "    " << alloc.stack[f] << std::endl;
+#endif
+        }
+    }
+    //--------------------------------------------------------------------------
     size_t MemoryTracker::getTotalMemoryAllocated() const
     {
         return mTotalAllocations;
@@ -118,6 +284,8 @@ namespace Ogre
             {           
                 os << "Ogre Memory: Detected memory leaks !!! " << std::endl;
                 os << "Ogre Memory: (" << mAllocations.size() << ") Allocation(s) with total " << mTotalAllocations << " bytes." << std::endl;
+                if (mSamplingRate > 1)
+                    os << "Ogre Memory: Only 1 in " << mSamplingRate << " allocations were tracked, sizes are estimated." << std::endl;
                 os << "Ogre Memory: Dumping allocations -> " << std::endl;
 
 
@@ -42,10 +42,14 @@ THE SOFTWARE.
 #include "OgreAnimationTrack.h"
 #include "OgreBone.h"
 #include "OgreOptimisedUtil.h"
+#include "OgreDualQuaternion.h"
 #include "OgreSkeleton.h"
 #include "OgreTangentSpaceCalc.h"
 #include "OgreLodStrategyManager.h"
 #include "OgrePixelCountLodStrategy.h"
+#include "OgreMeshBVH.h"
+#include "OgreTextureManager.h"
+#include "OgreHardwarePixelBuffer.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -62,6 +66,7 @@ namespace Ogre {
         mIndexBufferUsage(HardwareBuffer::HBU_STATIC_WRITE_ONLY),
         mVertexBufferShadowBuffer(true),
         mIndexBufferShadowBuffer(true),
+        mSubAllocateBuffers(false),
         mPreparedForShadowVolumes(false),
         mEdgeListsBuilt(false),
         mAutoBuildEdgeLists(true), // will be set to false by serializers of 1.30 and above
@@ -69,6 +74,10 @@ namespace Ogre {
         mSharedVertexDataAnimationIncludesNormals(false),
         mAnimationTypesDirty(true),
         mPosesIncludeNormals(false),
+        mUsePoseTexture(false),
+        mBVH(0),
+        mAutoBuildBVH(false),
+        mAutoBuildClusters(false),
         sharedVertexData(0)
     {
         // Init first (manual) lod
@@ -217,6 +226,57 @@ namespace Ogre {
         // Rewrite first value
         mMeshLodUsageList[0].value = mLodStrategy->getBaseValue();
 #endif
+
+        // Poses and morphs address the vertices from 0
+        if (getPoseCount() || hasVertexAnimation())
+            releaseSubAllocatedBuffers();
+
+        if (mUsePoseTexture)
+            buildPoseTextures();
+
+        if (mAutoBuildBVH)
+            buildBVH();
+
+        if (mAutoBuildClusters && !hasClusters())
+            buildClusters();
+
+        // Name the buffers after the mesh, to tell whose locks wait for the GPU
+        const String owner = "Mesh: " + mName;
+        if (sharedVertexData)
+            setBufferOwnerName(sharedVertexData, owner);
+        for (SubMeshList::iterator si = mSubMeshList.begin(); si != mSubMeshList.end(); ++si)
+        {
+            if (!(*si)->useSharedVertices)
+                setBufferOwnerName((*si)->vertexData, owner);
+            if (!(*si)->indexData->indexBuffer.isNull())
+                (*si)->indexData->indexBuffer->setOwnerName(owner);
+            SubMesh::LODFaceList::iterator li;
+            for (li = (*si)->mLodFaceList.begin(); li != (*si)->mLodFaceList.end(); ++li)
+            {
+                if (*li && !(*li)->indexBuffer.isNull())
+                    (*li)->indexBuffer->setOwnerName(owner);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Mesh::setBufferOwnerName(VertexData* vertexData, const String& owner)
+    {
+        const VertexBufferBinding::VertexBufferBindingMap& bindings =
+            vertexData->vertexBufferBinding->getBindings();
+        VertexBufferBinding::VertexBufferBindingMap::const_iterator i;
+        for (i = bindings.begin(); i != bindings.end(); ++i)
+            i->second->setOwnerName(owner);
+    }
+    //-----------------------------------------------------------------------
+    void Mesh::releaseSubAllocatedBuffers(void)
+    {
+        if (sharedVertexData)
+            sharedVertexData->releaseSubAllocation();
+        for (SubMeshList::iterator i = mSubMeshList.begin(); i != mSubMeshList.end(); ++i)
+        {
+            if (!(*i)->useSharedVertices)
+                (*i)->vertexData->releaseSubAllocation();
+        }
     }
     //-----------------------------------------------------------------------
     void Mesh::prepareImpl()
@@ -229,8 +289,9 @@ namespace Ogre {
             ResourceGroupManager::getSingleton().openResource(
                 mName, mGroup, true, this);
  
-        // fully prebuffer into host RAM
-        mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
+        // fully prebuffer into host RAM, unless already there (e.g. memory mapped)
+        if (!dynamic_cast<MemoryDataStream*>(mFreshFromDisk.get()))
+            mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
     }
     //-----------------------------------------------------------------------
     void Mesh::unprepareImpl()
@@ -288,7 +349,10 @@ namespace Ogre {
 #endif
         mPreparedForShadowVolumes = false;
 
+        freeBVH();
+
         // remove all poses & animations
+        destroyPoseTextures();
         removeAllAnimations();
         removeAllPoses();
 
@@ -361,6 +425,8 @@ namespace Ogre {
         newMesh->mBoneBoundingRadius = mBoneBoundingRadius;
         newMesh->mAutoBuildEdgeLists = mAutoBuildEdgeLists;
         newMesh->mEdgeListsBuilt = mEdgeListsBuilt;
+        newMesh->mAutoBuildBVH = mAutoBuildBVH;
+        newMesh->mAutoBuildClusters = mAutoBuildClusters;
 
 #if !OGRE_NO_MESHLOD
         newMesh->mHasManualLodLevel = mHasManualLodLevel;
@@ -409,6 +475,7 @@ namespace Ogre {
         }
         newMesh->mSharedVertexDataAnimationType = mSharedVertexDataAnimationType;
         newMesh->mAnimationTypesDirty = true;
+        newMesh->mUsePoseTexture = mUsePoseTexture;
 
         newMesh->load();
         newMesh->touch();
@@ -1621,10 +1688,221 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    template <typename T>
+    static bool numberVerticesByFirstUse(const T* pIndex, size_t count,
+        vector<uint32>::type& vertexRemap, uint32& nextVertex)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (pIndex[i] >= vertexRemap.size())
+                return false;
+            if (vertexRemap[pIndex[i]] == ~static_cast<uint32>(0))
+                vertexRemap[pIndex[i]] = nextVertex++;
+        }
+        return true;
+    }
+    //---------------------------------------------------------------------
+    template <typename T>
+    static void remapIndexes(T* pIndex, size_t count, const vector<uint32>::type& vertexRemap)
+    {
+        for (size_t i = 0; i < count; ++i)
+            pIndex[i] = static_cast<T>(vertexRemap[pIndex[i]]);
+    }
+    //---------------------------------------------------------------------
+    void Mesh::optimiseIndexOrder(bool overdraw, bool vertexFetch)
+    {
+        bool edgeListWasBuilt = mEdgeListsBuilt;
+        freeEdgeList();
+
+        // Poses refer to vertices by position in the buffer
+        set<ushort>::type posedTargets;
+        for (PoseList::const_iterator p = mPoseList.begin(); p != mPoseList.end(); ++p)
+            posedTargets.insert((*p)->getTarget());
+
+        bool reorderVertices = vertexFetch && !mPreparedForShadowVolumes;
+        vector<SubMesh*>::type sharedSubMeshes;
+        for (ushort i = 0; i < mSubMeshList.size(); ++i)
+        {
+            SubMesh* sm = mSubMeshList[i];
+            if (sm->useSharedVertices)
+            {
+                sharedSubMeshes.push_back(sm);
+            }
+            else
+            {
+                optimiseIndexOrder(sm->vertexData, vector<SubMesh*>::type(1, sm), sm->mBoneAssignments,
+                    reorderVertices && sm->getVertexAnimationType() == VAT_NONE &&
+                    posedTargets.find(i + 1) == posedTargets.end(), overdraw);
+            }
+        }
+        optimiseIndexOrder(sharedVertexData, sharedSubMeshes, mBoneAssignments,
+            reorderVertices && getSharedVertexDataAnimationType() == VAT_NONE &&
+            posedTargets.find(0) == posedTargets.end(), overdraw);
+
+        if (edgeListWasBuilt)
+            buildEdgeList();
+
+        // the clusters are runs of the old triangle order
+        for (SubMeshList::iterator i = mSubMeshList.begin(); i != mSubMeshList.end(); ++i)
+        {
+            if (!(*i)->clusters.empty())
+                (*i)->buildClusters((*i)->clusters.front().indexCount / 3);
+        }
+    }
+    //---------------------------------------------------------------------
+    void Mesh::optimiseIndexOrder(VertexData* vertexData, const vector<SubMesh*>::type& subMeshes,
+        VertexBoneAssignmentList& boneAssignments, bool reorderVertices, bool overdraw)
+    {
+        if (!vertexData || subMeshes.empty())
+            return;
+
+        // Gather the index data using this vertex data, full detail first so
+        // that it decides the vertex order
+        vector<IndexData*>::type indexDataList;
+        vector<bool>::type triangleList;
+        vector<SubMesh*>::type::const_iterator si;
+        for (si = subMeshes.begin(); si != subMeshes.end(); ++si)
+        {
+            indexDataList.push_back((*si)->indexData);
+            triangleList.push_back((*si)->operationType == RenderOperation::OT_TRIANGLE_LIST);
+        }
+#if !OGRE_NO_MESHLOD
+        for (si = subMeshes.begin(); si != subMeshes.end(); ++si)
+        {
+            const SubMesh::LODFaceList& lods = (*si)->mLodFaceList;
+            for (SubMesh::LODFaceList::const_iterator l = lods.begin(); l != lods.end(); ++l)
+            {
+                indexDataList.push_back(*l);
+                triangleList.push_back((*si)->operationType == RenderOperation::OT_TRIANGLE_LIST);
+            }
+        }
+#endif
+        size_t i, j;
+        for (i = 0; i < indexDataList.size(); )
+        {
+            // Manual LOD levels leave empty placeholders
+            if (indexDataList[i]->indexBuffer.isNull() || indexDataList[i]->indexCount == 0)
+            {
+                indexDataList.erase(indexDataList.begin() + i);
+                triangleList.erase(triangleList.begin() + i);
+            }
+            else
+                ++i;
+        }
+
+        const VertexElement* posElem =
+            vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        overdraw = overdraw && posElem && posElem->getType() == VET_FLOAT3;
+
+        for (i = 0; i < indexDataList.size(); ++i)
+        {
+            if (!triangleList[i])
+                continue;
+            IndexData* indexData = indexDataList[i];
+
+            // Compressed LOD levels share overlapping ranges of one buffer,
+            // re-ordering either of them would corrupt the other
+            bool overlapping = false;
+            for (j = 0; j < indexDataList.size() && !overlapping; ++j)
+            {
+                const IndexData* other = indexDataList[j];
+                overlapping = j != i && other->indexBuffer == indexData->indexBuffer &&
+                    other->indexStart < indexData->indexStart + indexData->indexCount &&
+                    indexData->indexStart < other->indexStart + other->indexCount;
+            }
+            if (overlapping)
+                continue;
+
+            indexData->optimiseVertexCache();
+            if (overdraw)
+                indexData->optimiseOverdraw(vertexData);
+        }
+
+        if (!reorderVertices)
+            return;
+
+        // Number the vertices in the order the indexes first use them, unused
+        // vertices go at the end
+        vector<uint32>::type vertexRemap(vertexData->vertexCount, ~static_cast<uint32>(0));
+        uint32 nextVertex = 0;
+        for (i = 0; i < indexDataList.size(); ++i)
+        {
+            const IndexData* indexData = indexDataList[i];
+            const HardwareIndexBufferSharedPtr& ibuf = indexData->indexBuffer;
+            void* pData = ibuf->lock(indexData->indexStart * ibuf->getIndexSize(),
+                indexData->indexCount * ibuf->getIndexSize(), HardwareBuffer::HBL_READ_ONLY);
+            bool valid = ibuf->getType() == HardwareIndexBuffer::IT_16BIT ?
+                numberVerticesByFirstUse(static_cast<const uint16*>(pData), indexData->indexCount,
+                    vertexRemap, nextVertex) :
+                numberVerticesByFirstUse(static_cast<const uint32*>(pData), indexData->indexCount,
+                    vertexRemap, nextVertex);
+            ibuf->unlock();
+            if (!valid)
+            {
+                LogManager::getSingleton().logMessage("Mesh '" + mName + "' has indexes out of "
+                    "range of its vertex data, vertices will not be re-ordered.");
+                return;
+            }
+        }
+        for (i = 0; i < vertexRemap.size(); ++i)
+        {
+            if (vertexRemap[i] == ~static_cast<uint32>(0))
+                vertexRemap[i] = nextVertex++;
+        }
+
+        vertexData->reorderVertices(vertexRemap);
+
+        // Remap each index buffer range once, merging the overlapping ranges
+        // of compressed LOD levels
+        typedef std::pair<size_t, size_t> IndexRange;
+        typedef map<HardwareIndexBuffer*, vector<IndexRange>::type>::type IndexRangeMap;
+        IndexRangeMap ranges;
+        for (i = 0; i < indexDataList.size(); ++i)
+        {
+            const IndexData* indexData = indexDataList[i];
+            ranges[indexData->indexBuffer.get()].push_back(
+                IndexRange(indexData->indexStart, indexData->indexStart + indexData->indexCount));
+        }
+        for (IndexRangeMap::iterator r = ranges.begin(); r != ranges.end(); ++r)
+        {
+            HardwareIndexBuffer* ibuf = r->first;
+            vector<IndexRange>::type& bufRanges = r->second;
+            std::sort(bufRanges.begin(), bufRanges.end());
+            for (i = 0; i < bufRanges.size(); )
+            {
+                size_t start = bufRanges[i].first, end = bufRanges[i].second;
+                for (++i; i < bufRanges.size() && bufRanges[i].first < end; ++i)
+                    end = std::max(end, bufRanges[i].second);
+
+                void* pData = ibuf->lock(start * ibuf->getIndexSize(),
+                    (end - start) * ibuf->getIndexSize(), HardwareBuffer::HBL_NORMAL);
+                if (ibuf->getType() == HardwareIndexBuffer::IT_16BIT)
+                    remapIndexes(static_cast<uint16*>(pData), end - start, vertexRemap);
+                else
+                    remapIndexes(static_cast<uint32*>(pData), end - start, vertexRemap);
+                ibuf->unlock();
+            }
+        }
+
+        VertexBoneAssignmentList remappedAssignments;
+        VertexBoneAssignmentList::iterator bi;
+        for (bi = boneAssignments.begin(); bi != boneAssignments.end(); ++bi)
+        {
+            VertexBoneAssignment assignment = bi->second;
+            if (assignment.vertexIndex < vertexRemap.size())
+                assignment.vertexIndex = vertexRemap[assignment.vertexIndex];
+            remappedAssignments.insert(
+                VertexBoneAssignmentList::value_type(assignment.vertexIndex, assignment));
+        }
+        boneAssignments.swap(remappedAssignments);
+    }
+    //---------------------------------------------------------------------
     void Mesh::buildEdgeList(void)
     {
         if (mEdgeListsBuilt)
             return;
+        // EdgeListBuilder and the shadow renderables need vertexStart to be 0
+        releaseSubAllocatedBuffers();
 #if !OGRE_NO_MESHLOD
         // Loop over LODs
         for (unsigned short lodIndex = 0; lodIndex < (unsigned short)mMeshLodUsageList.size(); ++lodIndex)
@@ -1772,6 +2050,47 @@ namespace Ogre {
         mEdgeListsBuilt = true;
     }
     //---------------------------------------------------------------------
+    const MeshBVH* Mesh::getBVH(void)
+    {
+        if (!mBVH)
+            buildBVH();
+        return mBVH;
+    }
+    //---------------------------------------------------------------------
+    void Mesh::buildBVH(void)
+    {
+        freeBVH();
+        mBVH = OGRE_NEW MeshBVH(this);
+    }
+    //---------------------------------------------------------------------
+    void Mesh::freeBVH(void)
+    {
+        OGRE_DELETE mBVH;
+        mBVH = 0;
+    }
+    //---------------------------------------------------------------------
+    void Mesh::buildClusters(size_t maxTriangles)
+    {
+        for (SubMeshList::iterator i = mSubMeshList.begin(); i != mSubMeshList.end(); ++i)
+            (*i)->buildClusters(maxTriangles);
+    }
+    //---------------------------------------------------------------------
+    void Mesh::freeClusters(void)
+    {
+        for (SubMeshList::iterator i = mSubMeshList.begin(); i != mSubMeshList.end(); ++i)
+            (*i)->clusters.clear();
+    }
+    //---------------------------------------------------------------------
+    bool Mesh::hasClusters(void) const
+    {
+        for (SubMeshList::const_iterator i = mSubMeshList.begin(); i != mSubMeshList.end(); ++i)
+        {
+            if (!(*i)->clusters.empty())
+                return true;
+        }
+        return false;
+    }
+    //---------------------------------------------------------------------
     void Mesh::freeEdgeList(void)
     {
         if (!mEdgeListsBuilt)
@@ -1805,6 +2124,7 @@ namespace Ogre {
         if (mPreparedForShadowVolumes)
             return;
 
+        releaseSubAllocatedBuffers();
         if (sharedVertexData)
         {
             sharedVertexData->prepareForShadowVolume();
@@ -1862,9 +2182,26 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
-    void Mesh::softwareVertexBlend(const VertexData* sourceVertexData,
+    void Mesh::prepareDualQuaternionsForVertexBlend(const DualQuaternion** blendDualQuaternions,
+        const DualQuaternion* boneDualQuaternions, const IndexMap& indexMap)
+    {
+        assert(indexMap.size() <= 256);
+        IndexMap::const_iterator it, itend;
+        itend = indexMap.end();
+        for (it = indexMap.begin(); it != itend; ++it)
+        {
+            *blendDualQuaternions++ = boneDualQuaternions + *it;
+        }
+    }
+    //---------------------------------------------------------------------
+    /** Locks the buffers of a software vertex blend and skins them with
+        either the blend matrices or the blend dual quaternions, whichever is
+        given.
+    */
+    static void softwareVertexBlendImpl(const VertexData* sourceVertexData,
         const VertexData* targetVertexData,
-        const Matrix4* const* blendMatrices, size_t numMatrices,
+        const Matrix4* const* blendMatrices,
+        const DualQuaternion* const* blendDualQuaternions,
         bool blendNormals)
     {
         float *pSrcPos = 0;
@@ -1975,16 +2312,32 @@ namespace Ogre {
             destElemNorm->baseVertexPointerToElement(pBuffer, &pDestNorm);
         }
 
-        OptimisedUtil::getImplementation()->softwareVertexSkinning(
-            pSrcPos, pDestPos,
-            pSrcNorm, pDestNorm,
-            pBlendWeight, pBlendIdx,
-            blendMatrices,
-            srcPosStride, destPosStride,
-            srcNormStride, destNormStride,
-            blendWeightStride, blendIdxStride,
-            numWeightsPerVertex,
-            targetVertexData->vertexCount);
+        if (blendDualQuaternions)
+        {
+            OptimisedUtil::getImplementation()->softwareVertexSkinningDualQuaternion(
+                pSrcPos, pDestPos,
+                pSrcNorm, pDestNorm,
+                pBlendWeight, pBlendIdx,
+                blendDualQuaternions,
+                srcPosStride, destPosStride,
+                srcNormStride, destNormStride,
+                blendWeightStride, blendIdxStride,
+                numWeightsPerVertex,
+                targetVertexData->vertexCount);
+        }
+        else
+        {
+            OptimisedUtil::getImplementation()->softwareVertexSkinning(
+                pSrcPos, pDestPos,
+                pSrcNorm, pDestNorm,
+                pBlendWeight, pBlendIdx,
+                blendMatrices,
+                srcPosStride, destPosStride,
+                srcNormStride, destNormStride,
+                blendWeightStride, blendIdxStride,
+                numWeightsPerVertex,
+                targetVertexData->vertexCount);
+        }
 
         // Unlock source buffers
         srcPosBuf->unlock();
@@ -2006,6 +2359,24 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    void Mesh::softwareVertexBlend(const VertexData* sourceVertexData,
+        const VertexData* targetVertexData,
+        const Matrix4* const* blendMatrices, size_t numMatrices,
+        bool blendNormals)
+    {
+        softwareVertexBlendImpl(sourceVertexData, targetVertexData,
+            blendMatrices, 0, blendNormals);
+    }
+    //---------------------------------------------------------------------
+    void Mesh::softwareVertexBlend(const VertexData* sourceVertexData,
+        const VertexData* targetVertexData,
+        const DualQuaternion* const* blendDualQuaternions, size_t numDualQuaternions,
+        bool blendNormals)
+    {
+        softwareVertexBlendImpl(sourceVertexData, targetVertexData,
+            0, blendDualQuaternions, blendNormals);
+    }
+    //---------------------------------------------------------------------
     void Mesh::softwareVertexMorph(Real t,
         const HardwareVertexBufferSharedPtr& b1,
         const HardwareVertexBufferSharedPtr& b2,
@@ -2121,10 +2492,30 @@ namespace Ogre {
         destBuf->unlock();
     }
     //---------------------------------------------------------------------
-    size_t Mesh::calculateSize(void) const
+    /// Adds the size of a buffer to the CPU or GPU total, once per buffer
+    static void addBufferSize(const HardwareBuffer* buf, set<const HardwareBuffer*>::type& counted,
+        size_t& cpu, size_t& gpu)
+    {
+        if (!buf || !counted.insert(buf).second)
+            return;
+
+        if (buf->isSystemMemory())
+        {
+            cpu += buf->getSizeInBytes();
+        }
+        else
+        {
+            gpu += buf->getSizeInBytes();
+            if (buf->hasShadowBuffer())
+                cpu += buf->getSizeInBytes();
+        }
+    }
+    //---------------------------------------------------------------------
+    void Mesh::calculateBufferSizes(size_t& cpu, size_t& gpu) const
     {
-        // calculate GPU size
-        size_t ret = 0;
+        cpu = gpu = 0;
+        // LOD levels may share their buffers with the full detail level
+        set<const HardwareBuffer*>::type counted;
         unsigned short i;
         // Shared vertices
         if (sharedVertexData)
@@ -2133,8 +2524,8 @@ namespace Ogre {
                 i < sharedVertexData->vertexBufferBinding->getBufferCount();
                 ++i)
             {
-                ret += sharedVertexData->vertexBufferBinding
-                    ->getBuffer(i)->getSizeInBytes();
+                addBufferSize(sharedVertexData->vertexBufferBinding->getBuffer(i).get(),
+                    counted, cpu, gpu);
             }
         }
 
@@ -2148,18 +2539,33 @@ namespace Ogre {
                     i < (*si)->vertexData->vertexBufferBinding->getBufferCount();
                     ++i)
                 {
-                    ret += (*si)->vertexData->vertexBufferBinding
-                        ->getBuffer(i)->getSizeInBytes();
+                    addBufferSize((*si)->vertexData->vertexBufferBinding->getBuffer(i).get(),
+                        counted, cpu, gpu);
                 }
             }
-            if (!(*si)->indexData->indexBuffer.isNull())
+            // Index data, full detail then LOD levels
+            addBufferSize((*si)->indexData->indexBuffer.get(), counted, cpu, gpu);
+            SubMesh::LODFaceList::const_iterator li;
+            for (li = (*si)->mLodFaceList.begin(); li != (*si)->mLodFaceList.end(); ++li)
             {
-                // Index data
-                ret += (*si)->indexData->indexBuffer->getSizeInBytes();
+                if (*li)
+                    addBufferSize((*li)->indexBuffer.get(), counted, cpu, gpu);
             }
-
         }
-        return ret;
+    }
+    //---------------------------------------------------------------------
+    size_t Mesh::calculateSize(void) const
+    {
+        size_t cpu, gpu;
+        calculateBufferSizes(cpu, gpu);
+        return Resource::calculateSize() + cpu + gpu;
+    }
+    //---------------------------------------------------------------------
+    size_t Mesh::calculateGpuSize(void) const
+    {
+        size_t cpu, gpu;
+        calculateBufferSizes(cpu, gpu);
+        return gpu;
     }
     //-----------------------------------------------------------------------------
     bool Mesh::hasVertexAnimation(void) const
@@ -2467,6 +2873,133 @@ namespace Ogre {
         return mPoseList;
     }
     //---------------------------------------------------------------------
+    void Mesh::setUsePoseTexture(bool usePoseTexture)
+    {
+        mUsePoseTexture = usePoseTexture;
+        if (!isLoaded())
+            return;
+
+        if (mUsePoseTexture)
+            buildPoseTextures();
+        else
+            destroyPoseTextures();
+    }
+    //---------------------------------------------------------------------
+    String Mesh::getPoseTextureName(ushort target) const
+    {
+        return mName + "/PoseTexture/" + StringConverter::toString(target);
+    }
+    //---------------------------------------------------------------------
+    HardwareVertexBufferSharedPtr Mesh::_getPoseTextureCoordBuffer(ushort target) const
+    {
+        PoseTextureMap::const_iterator i = mPoseTextures.find(target);
+        if (i == mPoseTextures.end())
+            return HardwareVertexBufferSharedPtr();
+        return i->second.texCoordBuffer;
+    }
+    //---------------------------------------------------------------------
+    void Mesh::buildPoseTextures(void)
+    {
+        destroyPoseTextures();
+
+        // Assuming 4096x4096 is supported, like the VTF instancing does
+        const size_t maxTexSize = 4096;
+
+        typedef map<ushort, PoseList>::type PosesByTarget;
+        PosesByTarget posesByTarget;
+        for (PoseList::const_iterator i = mPoseList.begin(); i != mPoseList.end(); ++i)
+            posesByTarget[(*i)->getTarget()].push_back(*i);
+
+        for (PosesByTarget::const_iterator t = posesByTarget.begin(); t != posesByTarget.end(); ++t)
+        {
+            const ushort target = t->first;
+            const PoseList& poses = t->second;
+            const VertexData* vertexData = target == 0 ?
+                sharedVertexData : getSubMesh(target - 1)->vertexData;
+            if (!vertexData || !vertexData->vertexCount)
+                continue;
+
+            bool includesNormals = false;
+            for (PoseList::const_iterator p = poses.begin(); p != poses.end(); ++p)
+                includesNormals |= (*p)->getIncludesNormals();
+
+            // Each pose takes as many rows as needed to hold one texel per vertex,
+            // normals follow in the bottom half
+            const size_t width = std::min(vertexData->vertexCount, maxTexSize);
+            const size_t rowsPerPose = (vertexData->vertexCount + width - 1) / width;
+            const size_t positionRows = poses.size() * rowsPerPose;
+            const size_t height = includesNormals ? positionRows * 2 : positionRows;
+            if (height > maxTexSize)
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Too many poses or vertices to fit in a "
+                    "pose texture in mesh " + mName, "Mesh::buildPoseTextures");
+            }
+
+            PoseTexture& poseTexture = mPoseTextures[target];
+            poseTexture.texture = TextureManager::getSingleton().createManual(
+                getPoseTextureName(target), mGroup, TEX_TYPE_2D, (uint)width, (uint)height,
+                0, PF_FLOAT32_RGBA, TU_STATIC_WRITE_ONLY);
+
+            HardwarePixelBufferSharedPtr pixelBuffer = poseTexture.texture->getBuffer();
+            pixelBuffer->lock(HardwareBuffer::HBL_DISCARD);
+            const PixelBox& pixelBox = pixelBuffer->getCurrentLock();
+            float* pBase = static_cast<float*>(pixelBox.data);
+            const size_t rowFloats = pixelBox.rowPitch * 4;
+            memset(pBase, 0, rowFloats * height * sizeof(float));
+
+            for (size_t p = 0; p < poses.size(); ++p)
+            {
+                Pose* pose = poses[p];
+                const size_t firstRow = p * rowsPerPose;
+                pose->_setTextureOffset(Real(firstRow) / height);
+
+                const Pose::VertexOffsetMap& offsets = pose->getVertexOffsets();
+                for (Pose::VertexOffsetMap::const_iterator v = offsets.begin(); v != offsets.end(); ++v)
+                {
+                    float* pTexel = pBase + (firstRow + v->first / width) * rowFloats +
+                        (v->first % width) * 4;
+                    *pTexel++ = v->second.x;
+                    *pTexel++ = v->second.y;
+                    *pTexel   = v->second.z;
+                }
+
+                const Pose::NormalsMap& normals = pose->getNormals();
+                for (Pose::NormalsMap::const_iterator n = normals.begin(); n != normals.end(); ++n)
+                {
+                    float* pTexel = pBase + (positionRows + firstRow + n->first / width) * rowFloats +
+                        (n->first % width) * 4;
+                    *pTexel++ = n->second.x;
+                    *pTexel++ = n->second.y;
+                    *pTexel   = n->second.z;
+                }
+            }
+            pixelBuffer->unlock();
+
+            // Where each vertex lives in the rows of a pose. Drawn from vertexStart
+            // like the other sources, so the vertices before it are left unused
+            poseTexture.texCoordBuffer = HardwareBufferManager::getSingleton().createVertexBuffer(
+                sizeof(float) * 2, vertexData->vertexStart + vertexData->vertexCount,
+                HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+            float* pTexCoord = static_cast<float*>(
+                poseTexture.texCoordBuffer->lock(HardwareBuffer::HBL_DISCARD));
+            memset(pTexCoord, 0, sizeof(float) * 2 * vertexData->vertexStart);
+            pTexCoord += 2 * vertexData->vertexStart;
+            for (size_t v = 0; v < vertexData->vertexCount; ++v)
+            {
+                *pTexCoord++ = (float(v % width) + 0.5f) / width;
+                *pTexCoord++ = (float(v / width) + 0.5f) / height;
+            }
+            poseTexture.texCoordBuffer->unlock();
+        }
+    }
+    //---------------------------------------------------------------------
+    void Mesh::destroyPoseTextures(void)
+    {
+        for (PoseTextureMap::iterator i = mPoseTextures.begin(); i != mPoseTextures.end(); ++i)
+            TextureManager::getSingleton().remove(i->second.texture->getHandle());
+        mPoseTextures.clear();
+    }
+    //---------------------------------------------------------------------
     void Mesh::updateMaterialForAllSubMeshes(void)
     {
         // iterate through each sub mesh and request the submesh to update its material
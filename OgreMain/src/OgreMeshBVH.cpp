@@ -0,0 +1,409 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreMeshBVH.h"
+#include "OgreMesh.h"
+#include "OgreSubMesh.h"
+#include "OgreEntity.h"
+#include "OgreSubEntity.h"
+#include "OgreHardwareBufferManager.h"
+
+namespace Ogre {
+    namespace
+    {
+        /// Most triangles in a leaf
+        const uint32 MAX_LEAF_TRIANGLES = 4;
+
+        void readPositions(const VertexData* vdata, Vector3* positions)
+        {
+            const VertexElement* posElem =
+                vdata->vertexDeclaration->findElementBySemantic(VES_POSITION);
+            HardwareVertexBufferSharedPtr vbuf =
+                vdata->vertexBufferBinding->getBuffer(posElem->getSource());
+            unsigned char* pVertex = static_cast<unsigned char*>(
+                vbuf->lock(HardwareBuffer::HBL_READ_ONLY));
+            pVertex += vdata->vertexStart * vbuf->getVertexSize();
+            for (size_t v = 0; v < vdata->vertexCount; ++v)
+            {
+                float* pReal;
+                posElem->baseVertexPointerToElement(pVertex, &pReal);
+                positions[v] = Vector3(pReal[0], pReal[1], pReal[2]);
+                pVertex += vbuf->getVertexSize();
+            }
+            vbuf->unlock();
+        }
+
+        struct CentreLess
+        {
+            const vector<Vector3>::type& centres;
+            int axis;
+            CentreLess(const vector<Vector3>::type& c, int a) : centres(c), axis(a) {}
+            bool operator()(uint32 a, uint32 b) const
+            {
+                return centres[a][axis] < centres[b][axis];
+            }
+        };
+    }
+    //---------------------------------------------------------------------
+    MeshBVH::MeshBVH(const Mesh* mesh)
+    {
+        map<const VertexData*, uint32>::type vertexStarts;
+
+        for (ushort s = 0; s < mesh->getNumSubMeshes(); ++s)
+        {
+            SubMesh* sm = mesh->getSubMesh(s);
+            if (sm->operationType != RenderOperation::OT_TRIANGLE_LIST)
+                continue;
+            const VertexData* vdata = sm->useSharedVertices ? mesh->sharedVertexData : sm->vertexData;
+            const IndexData* idata = sm->indexData;
+            if (!vdata || !vdata->vertexCount || !idata || !idata->indexCount)
+                continue;
+
+            // Copy the positions of each vertex data once
+            uint32 vertexStart;
+            map<const VertexData*, uint32>::type::iterator vi = vertexStarts.find(vdata);
+            if (vi != vertexStarts.end())
+            {
+                vertexStart = vi->second;
+            }
+            else
+            {
+                vertexStart = static_cast<uint32>(mPositions.size());
+                vertexStarts[vdata] = vertexStart;
+                VertexSource source;
+                source.subMesh = sm->useSharedVertices ? -1 : s;
+                source.start = vertexStart;
+                source.count = vdata->vertexCount;
+                mVertexSources.push_back(source);
+                mPositions.resize(vertexStart + vdata->vertexCount);
+                readPositions(vdata, &mPositions[vertexStart]);
+            }
+
+            HardwareIndexBufferSharedPtr ibuf = idata->indexBuffer;
+            bool use32 = ibuf->getType() == HardwareIndexBuffer::IT_32BIT;
+            const void* pIndex = ibuf->lock(idata->indexStart * ibuf->getIndexSize(),
+                idata->indexCount * ibuf->getIndexSize(), HardwareBuffer::HBL_READ_ONLY);
+            for (size_t n = 0; n + 2 < idata->indexCount; n += 3)
+            {
+                Triangle tri;
+                for (int c = 0; c < 3; ++c)
+                {
+                    tri.v[c] = vertexStart + (use32 ? static_cast<const uint32*>(pIndex)[n + c] :
+                        static_cast<const uint16*>(pIndex)[n + c]);
+                }
+                tri.subMesh = s;
+                tri.index = static_cast<uint32>(n / 3);
+                mTriangles.push_back(tri);
+            }
+            ibuf->unlock();
+        }
+
+        if (mTriangles.empty())
+            return;
+
+        // Split the triangles at the median of their centres, along the longest
+        // axis of the centres, until few enough are left
+        vector<Vector3>::type centres(mTriangles.size());
+        vector<uint32>::type order(mTriangles.size());
+        for (uint32 i = 0; i < mTriangles.size(); ++i)
+        {
+            const Triangle& tri = mTriangles[i];
+            centres[i] = (mPositions[tri.v[0]] + mPositions[tri.v[1]] + mPositions[tri.v[2]]) / 3;
+            order[i] = i;
+        }
+        mNodes.reserve(2 * mTriangles.size() / MAX_LEAF_TRIANGLES + 1);
+        build(0, static_cast<uint32>(mTriangles.size()), order, centres);
+
+        // Store the triangles in leaf order
+        vector<Triangle>::type sorted(mTriangles.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            sorted[i] = mTriangles[order[i]];
+        mTriangles.swap(sorted);
+
+        refit();
+    }
+    //---------------------------------------------------------------------
+    MeshBVH::~MeshBVH()
+    {
+    }
+    //---------------------------------------------------------------------
+    void MeshBVH::build(uint32 begin, uint32 end, vector<uint32>::type& order,
+        const vector<Vector3>::type& centres)
+    {
+        uint32 nodeIndex = static_cast<uint32>(mNodes.size());
+        mNodes.push_back(Node());
+
+        uint32 count = end - begin;
+        Vector3 cmin = centres[order[begin]], cmax = cmin;
+        for (uint32 i = begin + 1; i < end; ++i)
+        {
+            cmin.makeFloor(centres[order[i]]);
+            cmax.makeCeil(centres[order[i]]);
+        }
+        Vector3 extent = cmax - cmin;
+        if (count <= MAX_LEAF_TRIANGLES || extent == Vector3::ZERO)
+        {
+            mNodes[nodeIndex].index = begin;
+            mNodes[nodeIndex].count = count;
+            return;
+        }
+
+        int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+        uint32 mid = begin + count / 2;
+        std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+            CentreLess(centres, axis));
+
+        build(begin, mid, order, centres);
+        uint32 second = static_cast<uint32>(mNodes.size());
+        build(mid, end, order, centres);
+        mNodes[nodeIndex].index = second;
+        mNodes[nodeIndex].count = 0;
+    }
+    //---------------------------------------------------------------------
+    void MeshBVH::refit(void)
+    {
+        if (!mNodes.empty())
+            refitNode(0);
+    }
+    //---------------------------------------------------------------------
+    void MeshBVH::refitNode(uint32 nodeIndex)
+    {
+        Node& node = mNodes[nodeIndex];
+        if (node.count)
+        {
+            const Triangle& first = mTriangles[node.index];
+            node.min = node.max = mPositions[first.v[0]];
+            for (uint32 t = node.index; t < node.index + node.count; ++t)
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    node.min.makeFloor(mPositions[mTriangles[t].v[c]]);
+                    node.max.makeCeil(mPositions[mTriangles[t].v[c]]);
+                }
+            }
+        }
+        else
+        {
+            refitNode(nodeIndex + 1);
+            refitNode(node.index);
+            const Node& a = mNodes[nodeIndex + 1];
+            const Node& b = mNodes[node.index];
+            node.min = a.min;
+            node.min.makeFloor(b.min);
+            node.max = a.max;
+            node.max.makeCeil(b.max);
+        }
+    }
+    //---------------------------------------------------------------------
+    void MeshBVH::refit(Entity* entity)
+    {
+        for (size_t i = 0; i < mVertexSources.size(); ++i)
+        {
+            const VertexSource& source = mVertexSources[i];
+            const VertexData* vdata = source.subMesh < 0 ? entity->getVertexDataForBinding() :
+                entity->getSubEntity(source.subMesh)->getVertexDataForBinding();
+            if (vdata && vdata->vertexCount == source.count)
+                readPositions(vdata, &mPositions[source.start]);
+        }
+        refit();
+    }
+    //---------------------------------------------------------------------
+    AxisAlignedBox MeshBVH::getBounds(void) const
+    {
+        if (mNodes.empty())
+            return AxisAlignedBox::BOX_NULL;
+        return AxisAlignedBox(mNodes[0].min, mNodes[0].max);
+    }
+    //---------------------------------------------------------------------
+    bool MeshBVH::intersects(const Node& node, const Ray& ray, const Vector3& invDir,
+        Real maxDistance, Real& distance) const
+    {
+        // Slab test
+        const Vector3& origin = ray.getOrigin();
+        Real tmin = 0, tmax = maxDistance;
+        for (int a = 0; a < 3; ++a)
+        {
+            Real t0 = (node.min[a] - origin[a]) * invDir[a];
+            Real t1 = (node.max[a] - origin[a]) * invDir[a];
+            if (t0 > t1)
+                std::swap(t0, t1);
+            tmin = std::max(tmin, t0);
+            tmax = std::min(tmax, t1);
+        }
+        distance = tmin;
+        return tmin <= tmax;
+    }
+    //---------------------------------------------------------------------
+    bool MeshBVH::intersects(const Ray& ray, const Triangle& tri, Real& t, Real& u, Real& v) const
+    {
+        const Vector3& a = mPositions[tri.v[0]];
+        Vector3 e1 = mPositions[tri.v[1]] - a;
+        Vector3 e2 = mPositions[tri.v[2]] - a;
+        Vector3 p = ray.getDirection().crossProduct(e2);
+        Real det = e1.dotProduct(p);
+        if (det == 0)
+            return false;
+        Real invDet = 1 / det;
+        Vector3 s = ray.getOrigin() - a;
+        u = s.dotProduct(p) * invDet;
+        if (u < 0 || u > 1)
+            return false;
+        Vector3 q = s.crossProduct(e1);
+        v = ray.getDirection().dotProduct(q) * invDet;
+        if (v < 0 || u + v > 1)
+            return false;
+        t = e2.dotProduct(q) * invDet;
+        return t >= 0;
+    }
+    //---------------------------------------------------------------------
+    bool MeshBVH::intersects(const Ray& ray, Hit& hit, Real maxDistance) const
+    {
+        hit.distance = Math::POS_INFINITY;
+        if (mNodes.empty())
+            return false;
+
+        const Vector3& dir = ray.getDirection();
+        Vector3 invDir(1 / dir.x, 1 / dir.y, 1 / dir.z);
+        Real best = maxDistance;
+        Real dist;
+        if (!intersects(mNodes[0], ray, invDir, best, dist))
+            return false;
+
+        // Depth first, nearer child first
+        uint32 stack[64];
+        size_t top = 0;
+        stack[top++] = 0;
+        while (top)
+        {
+            const Node& node = mNodes[stack[--top]];
+            if (node.count)
+            {
+                for (uint32 i = node.index; i < node.index + node.count; ++i)
+                {
+                    Real t, u, v;
+                    if (intersects(ray, mTriangles[i], t, u, v) && t < best)
+                    {
+                        best = t;
+                        hit.distance = t;
+                        hit.subMesh = mTriangles[i].subMesh;
+                        hit.triangle = mTriangles[i].index;
+                        hit.barycentric = Vector3(1 - u - v, u, v);
+                    }
+                }
+                continue;
+            }
+
+            uint32 first = static_cast<uint32>(&node - &mNodes[0]) + 1;
+            uint32 second = node.index;
+            Real d0, d1;
+            bool hit0 = intersects(mNodes[first], ray, invDir, best, d0);
+            bool hit1 = intersects(mNodes[second], ray, invDir, best, d1);
+            if (hit0 && hit1)
+            {
+                // Push the further child first so the nearer one is visited first
+                if (d0 < d1)
+                    std::swap(first, second);
+                stack[top++] = first;
+                stack[top++] = second;
+            }
+            else if (hit0)
+                stack[top++] = first;
+            else if (hit1)
+                stack[top++] = second;
+        }
+        return hit.distance != Math::POS_INFINITY;
+    }
+    //---------------------------------------------------------------------
+    size_t MeshBVH::intersects(const Ray* rays, size_t numRays, Hit* hits) const
+    {
+        vector<Vector3>::type invDirs(numRays);
+        vector<uint32>::type active;
+        active.reserve(numRays * 4);
+        for (size_t r = 0; r < numRays; ++r)
+        {
+            const Vector3& dir = rays[r].getDirection();
+            invDirs[r] = Vector3(1 / dir.x, 1 / dir.y, 1 / dir.z);
+            hits[r].distance = Math::POS_INFINITY;
+            active.push_back(static_cast<uint32>(r));
+        }
+        if (!mNodes.empty() && numRays)
+            intersectsPacket(0, rays, &invDirs[0], active, 0, numRays, hits);
+
+        size_t numHits = 0;
+        for (size_t r = 0; r < numRays; ++r)
+        {
+            if (hits[r].distance != Math::POS_INFINITY)
+                ++numHits;
+        }
+        return numHits;
+    }
+    //---------------------------------------------------------------------
+    void MeshBVH::intersectsPacket(uint32 nodeIndex, const Ray* rays, const Vector3* invDirs,
+        vector<uint32>::type& active, size_t begin, size_t count, Hit* hits) const
+    {
+        // Gather the rays reaching this node after the ones of the parent
+        const Node& node = mNodes[nodeIndex];
+        size_t childBegin = active.size();
+        Real dist;
+        for (size_t i = begin; i < begin + count; ++i)
+        {
+            uint32 r = active[i];
+            if (intersects(node, rays[r], invDirs[r], hits[r].distance, dist))
+                active.push_back(r);
+        }
+        size_t childCount = active.size() - childBegin;
+
+        if (childCount)
+        {
+            if (node.count)
+            {
+                for (size_t i = childBegin; i < childBegin + childCount; ++i)
+                {
+                    uint32 r = active[i];
+                    for (uint32 t = node.index; t < node.index + node.count; ++t)
+                    {
+                        Real d, u, v;
+                        if (intersects(rays[r], mTriangles[t], d, u, v) && d < hits[r].distance)
+                        {
+                            hits[r].distance = d;
+                            hits[r].subMesh = mTriangles[t].subMesh;
+                            hits[r].triangle = mTriangles[t].index;
+                            hits[r].barycentric = Vector3(1 - u - v, u, v);
+                        }
+                    }
+                }
+            }
+            else
+            {
+                intersectsPacket(nodeIndex + 1, rays, invDirs, active, childBegin, childCount, hits);
+                intersectsPacket(node.index, rays, invDirs, active, childBegin, childCount, hits);
+            }
+        }
+        active.resize(childBegin);
+    }
+}
@@ -949,7 +949,7 @@ namespace Ogre
             uMaxSubdivisionLevel, vMaxSubdivisionLevel, visibleSide, vbUsage, ibUsage,
             vbUseShadow, ibUseShadow);
         pm->load();
-        ResourcePtr res(pm);
+        ResourcePtr res(pm, pm->_getSharedPtrInfo());
         addImpl(res);
 
         return res.staticCast<PatchMesh>();
@@ -965,6 +965,19 @@ namespace Ogre
         return mPrepAllMeshesForShadowVolumes;
     }
     //-----------------------------------------------------------------------
+    void MeshManager::setSubAllocateBuffers(const String& groupName, bool subAllocate)
+    {
+        if (subAllocate)
+            mSubAllocatedGroups.insert(groupName);
+        else
+            mSubAllocatedGroups.erase(groupName);
+    }
+    //-----------------------------------------------------------------------
+    bool MeshManager::getSubAllocateBuffers(const String& groupName) const
+    {
+        return mSubAllocatedGroups.find(groupName) != mSubAllocatedGroups.end();
+    }
+    //-----------------------------------------------------------------------
     Real MeshManager::getBoundsPaddingFactor(void)
     {
         return mBoundsPaddingFactor;
@@ -980,7 +993,9 @@ namespace Ogre
         const NameValuePairList* createParams)
     {
         // no use for createParams here
-        return OGRE_NEW Mesh(this, name, handle, group, isManual, loader);
+        Mesh* mesh = OGRE_NEW Mesh(this, name, handle, group, isManual, loader);
+        mesh->setSubAllocateBuffers(getSubAllocateBuffers(group));
+        return mesh;
     }
     //-----------------------------------------------------------------------
 
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgreMesh.h"
 #include "OgreException.h"
 #include "OgreLogManager.h"
+#include "OgreResourceLoadTrace.h"
 
 
 namespace Ogre {
@@ -152,6 +153,7 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void MeshSerializer::importMesh(DataStreamPtr& stream, Mesh* pDest)
     {
+        ResourceLoadTraceScope trace(RLP_PARSE, pDest->getName(), stream->size());
         determineEndianness(stream);
 
         // Read header and determine the version
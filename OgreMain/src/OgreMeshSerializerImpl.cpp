@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreMeshSerializer.h"
 #include "OgreMesh.h"
 #include "OgreSubMesh.h"
+#include "OgreMeshManager.h"
 #include "OgreBitwise.h"
 #include "OgreException.h"
 #include "OgreLogManager.h"
@@ -213,6 +214,9 @@ namespace Ogre {
 
         // Write submesh extremes
         writeExtremes(pMesh);
+
+        // Write submesh triangle clusters
+        writeClusters(pMesh);
             popInnerChunk(mStream);
         }
     }
@@ -367,6 +371,51 @@ namespace Ogre {
         return MSTREAM_OVERHEAD_SIZE + sizeof (unsigned short) +
             s->extremityPoints.size() * sizeof (float)* 3;
     }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::writeClusters(const Mesh* pMesh)
+    {
+        for (unsigned short i = 0; i < pMesh->getNumSubMeshes(); ++i)
+        {
+            const SubMesh* sm = pMesh->getSubMesh(i);
+            if (!sm->clusters.empty())
+                writeSubMeshClusters(i, sm);
+        }
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl::calcClustersSize(const Mesh* pMesh)
+    {
+        size_t size = 0;
+        for (unsigned short i = 0; i < pMesh->getNumSubMeshes(); ++i)
+        {
+            const SubMesh* sm = pMesh->getSubMesh(i);
+            if (!sm->clusters.empty())
+                size += calcSubMeshClustersSize(sm);
+        }
+        return size;
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::writeSubMeshClusters(unsigned short idx, const SubMesh* s)
+    {
+        writeChunkHeader(M_SUBMESH_CLUSTERS, calcSubMeshClustersSize(s));
+
+        writeShorts(&idx, 1);
+        for (SubMesh::TriangleClusterList::const_iterator i = s->clusters.begin();
+             i != s->clusters.end(); ++i)
+        {
+            uint32 range[2] = { i->indexStart, i->indexCount };
+            writeInts(range, 2);
+            float bounds[9] = { float(i->centre.x), float(i->centre.y), float(i->centre.z),
+                float(i->radius), float(i->coneAxis.x), float(i->coneAxis.y), float(i->coneAxis.z),
+                float(i->coneCos), float(i->coneSin) };
+            writeFloats(bounds, 9);
+        }
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl::calcSubMeshClustersSize(const SubMesh* s)
+    {
+        return MSTREAM_OVERHEAD_SIZE + sizeof(unsigned short) +
+            s->clusters.size() * (sizeof(uint32) * 2 + sizeof(float) * 9);
+    }
 
 
     //---------------------------------------------------------------------
@@ -578,6 +627,8 @@ namespace Ogre {
 
         size += calcExtremesSize(pMesh);
 
+        size += calcClustersSize(pMesh);
+
         return size;
     }
     //---------------------------------------------------------------------
@@ -790,6 +841,26 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    bool MeshSerializerImpl::subAllocateBuffers(Mesh* pMesh)
+    {
+        // Preparing for shadow volumes replaces the vertex buffers
+        return pMesh->getSubAllocateBuffers() &&
+            !MeshManager::getSingleton().getPrepareAllMeshesForShadowVolumes();
+    }
+    //---------------------------------------------------------------------
+    const void* MeshSerializerImpl::readInPlace(DataStreamPtr& stream, size_t count)
+    {
+        if (mFlipEndian)
+            return 0;
+        // Mesh::prepareImpl leaves the file in memory, mapped or buffered
+        MemoryDataStream* memStream = dynamic_cast<MemoryDataStream*>(stream.get());
+        if (!memStream || memStream->size() - memStream->tell() < count)
+            return 0;
+        const void* data = memStream->getCurrentPtr();
+        memStream->skip(static_cast<long>(count));
+        return data;
+    }
+    //---------------------------------------------------------------------
     void MeshSerializerImpl::readGeometryVertexBuffer(DataStreamPtr& stream,
         Mesh* pMesh, VertexData* dest)
     {
@@ -815,6 +886,39 @@ namespace Ogre {
                 "MeshSerializerImpl::readGeometryVertexBuffer");
         }
 
+        // Reserve vertices in shared buffers for all sources on the first one
+        if (dest->vertexBufferBinding->getBufferCount() == 0 && subAllocateBuffers(pMesh))
+        {
+            HardwareBufferManager::getSingleton().subAllocateVertexData(
+                dest, pMesh->mVertexBufferUsage, pMesh->mVertexBufferShadowBuffer);
+        }
+
+        size_t sizeInBytes = dest->vertexCount * vertexSize;
+        const void* pSrc = readInPlace(stream, sizeInBytes);
+        if (dest->subAllocated)
+        {
+            if (pSrc)
+            {
+                dest->vertexBufferBinding->getBuffer(bindIndex)->writeData(
+                    dest->vertexStart * vertexSize, sizeInBytes, pSrc);
+                popInnerChunk(stream);
+                return;
+            }
+            // Shared buffers can't be discarded, stage the data and write it in place
+            unsigned char* pBuf = OGRE_ALLOC_T(unsigned char, sizeInBytes, MEMCATEGORY_GEOMETRY);
+            stream->read(pBuf, sizeInBytes);
+            flipFromLittleEndian(
+                pBuf,
+                dest->vertexCount,
+                vertexSize,
+                dest->vertexDeclaration->findElementsBySource(bindIndex));
+            dest->vertexBufferBinding->getBuffer(bindIndex)->writeData(
+                dest->vertexStart * vertexSize, sizeInBytes, pBuf);
+            OGRE_FREE(pBuf, MEMCATEGORY_GEOMETRY);
+            popInnerChunk(stream);
+            return;
+        }
+
         // Create / populate vertex buffer
         HardwareVertexBufferSharedPtr vbuf;
         vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
@@ -822,16 +926,23 @@ namespace Ogre {
             dest->vertexCount,
             pMesh->mVertexBufferUsage,
             pMesh->mVertexBufferShadowBuffer);
-        void* pBuf = vbuf->lock(HardwareBuffer::HBL_DISCARD);
-        stream->read(pBuf, dest->vertexCount * vertexSize);
-
-        // endian conversion for OSX
-        flipFromLittleEndian(
-            pBuf,
-            dest->vertexCount,
-            vertexSize,
-            dest->vertexDeclaration->findElementsBySource(bindIndex));
-        vbuf->unlock();
+        if (pSrc)
+        {
+            vbuf->writeData(0, sizeInBytes, pSrc, true);
+        }
+        else
+        {
+            void* pBuf = vbuf->lock(HardwareBuffer::HBL_DISCARD);
+            stream->read(pBuf, sizeInBytes);
+
+            // endian conversion for OSX
+            flipFromLittleEndian(
+                pBuf,
+                dest->vertexCount,
+                vertexSize,
+                dest->vertexDeclaration->findElementsBySource(bindIndex));
+            vbuf->unlock();
+        }
 
         // Set binding
         dest->vertexBufferBinding->setBinding(bindIndex, vbuf);
@@ -919,7 +1030,8 @@ namespace Ogre {
                  streamID == M_EDGE_LISTS ||
                  streamID == M_POSES ||
                  streamID == M_ANIMATIONS ||
-                 streamID == M_TABLE_EXTREMES))
+                 streamID == M_TABLE_EXTREMES ||
+                 streamID == M_SUBMESH_CLUSTERS))
             {
                 switch(streamID)
                 {
@@ -974,6 +1086,9 @@ namespace Ogre {
                 case M_TABLE_EXTREMES:
                     readExtremes(stream, pMesh);
                     break;
+                case M_SUBMESH_CLUSTERS:
+                    readClusters(stream, pMesh);
+                    break;
                 }
 
                 if (!stream->eof())
@@ -1018,7 +1133,42 @@ namespace Ogre {
         readBools(stream, &idx32bit, 1);
         if (indexCount > 0)
         {
-            if (idx32bit)
+            if (subAllocateBuffers(pMesh) && HardwareBufferManager::getSingleton().subAllocateIndexData(
+                sm->indexData,
+                idx32bit ? HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT,
+                pMesh->mIndexBufferUsage,
+                pMesh->mIndexBufferShadowBuffer))
+            {
+                ibuf = sm->indexData->indexBuffer;
+                size_t sizeInBytes = sm->indexData->indexCount * ibuf->getIndexSize();
+                if (const void* pSrc = readInPlace(stream, sizeInBytes))
+                {
+                    ibuf->writeData(sm->indexData->indexStart * ibuf->getIndexSize(), sizeInBytes, pSrc);
+                }
+                else
+                {
+                    // Shared buffers can't be discarded, stage the data and write it in place
+                    void* pIdx = OGRE_MALLOC(sizeInBytes, MEMCATEGORY_GEOMETRY);
+                    if (idx32bit)
+                        readInts(stream, static_cast<unsigned int*>(pIdx), sm->indexData->indexCount);
+                    else
+                        readShorts(stream, static_cast<unsigned short*>(pIdx), sm->indexData->indexCount);
+                    ibuf->writeData(sm->indexData->indexStart * ibuf->getIndexSize(), sizeInBytes, pIdx);
+                    OGRE_FREE(pIdx, MEMCATEGORY_GEOMETRY);
+                }
+            }
+            else if (const void* pSrc = readInPlace(stream,
+                sm->indexData->indexCount * (idx32bit ? sizeof(uint32) : sizeof(uint16))))
+            {
+                ibuf = HardwareBufferManager::getSingleton().
+                    createIndexBuffer(
+                        idx32bit ? HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT,
+                        sm->indexData->indexCount,
+                        pMesh->mIndexBufferUsage,
+                        pMesh->mIndexBufferShadowBuffer);
+                ibuf->writeData(0, ibuf->getSizeInBytes(), pSrc, true);
+            }
+            else if (idx32bit)
             {
                 ibuf = HardwareBufferManager::getSingleton().
                     createIndexBuffer(
@@ -1666,6 +1816,8 @@ namespace Ogre {
                         typeSize = sizeof(double);
                         break;
                     case VET_SHORT1:
+                    case VET_HALF2:
+                    case VET_SHORT2_NORM:
                         typeSize = sizeof(short);
                         break;
                     case VET_USHORT1:
@@ -2754,6 +2906,33 @@ namespace Ogre {
         OGRE_FREE(vert, MEMCATEGORY_GEOMETRY);
     }
 
+    void MeshSerializerImpl::readClusters(DataStreamPtr& stream, Mesh *pMesh)
+    {
+        unsigned short idx;
+        readShorts(stream, &idx, 1);
+
+        SubMesh *sm = pMesh->getSubMesh(idx);
+
+        size_t count = (mCurrentstreamLen - MSTREAM_OVERHEAD_SIZE - sizeof(unsigned short)) /
+            (sizeof(uint32) * 2 + sizeof(float) * 9);
+        sm->clusters.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            SubMesh::TriangleCluster& cluster = sm->clusters[i];
+            uint32 range[2];
+            readInts(stream, range, 2);
+            float bounds[9];
+            readFloats(stream, bounds, 9);
+            cluster.indexStart = range[0];
+            cluster.indexCount = range[1];
+            cluster.centre = Vector3(bounds[0], bounds[1], bounds[2]);
+            cluster.radius = bounds[3];
+            cluster.coneAxis = Vector3(bounds[4], bounds[5], bounds[6]);
+            cluster.coneCos = bounds[7];
+            cluster.coneSin = bounds[8];
+        }
+    }
+
     void MeshSerializerImpl::enableValidation()
     {
 #if OGRE_SERIALIZER_VALIDATE_CHUNKSIZE
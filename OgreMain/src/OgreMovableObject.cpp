@@ -61,6 +61,7 @@ namespace Ogre {
         , mRenderQueuePrioritySet(false)
         , mQueryFlags(msDefaultQueryFlags)
         , mVisibilityFlags(msDefaultVisibilityFlags)
+        , mWorldAABBVersion(0)
         , mCastShadows(true)
         , mRenderingDisabled(false)
         , mListener(0)
@@ -89,6 +90,7 @@ namespace Ogre {
         , mRenderQueuePrioritySet(false)
         , mQueryFlags(msDefaultQueryFlags)
         , mVisibilityFlags(msDefaultVisibilityFlags)
+        , mWorldAABBVersion(0)
         , mCastShadows(true)
         , mRenderingDisabled(false)
         , mListener(0)
@@ -133,6 +135,7 @@ namespace Ogre {
 
         mParentNode = parent;
         mParentIsTagPoint = isTagPoint;
+        mWorldAABBVersion = 0;
 
         // Mark light list being dirty, simply decrease
         // counter by one for minimise overhead
@@ -354,8 +357,17 @@ namespace Ogre {
     {
         if (derive)
         {
-            mWorldAABB = this->getBoundingBox();
-            mWorldAABB.transformAffine(_getParentNodeFullTransform());
+            const AxisAlignedBox& box = this->getBoundingBox();
+            const Matrix4& xform = _getParentNodeFullTransform();
+            // The version is only meaningful once the transform is up to date
+            unsigned long version = mParentNode ? mParentNode->_getTransformVersion() : 0;
+            if (version == 0 || version != mWorldAABBVersion || box != mWorldAABBSource)
+            {
+                mWorldAABB = box;
+                mWorldAABB.transformAffine(xform);
+                mWorldAABBSource = box;
+                mWorldAABBVersion = version;
+            }
         }
 
         return mWorldAABB;
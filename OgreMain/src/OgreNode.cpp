@@ -45,6 +45,9 @@ namespace Ogre {
 
     NameGenerator Node::msNameGenerator("Unnamed_");
     Node::QueuedUpdates Node::msQueuedUpdates;
+    Node::DeferredListenerNodes Node::msDeferredListenerNodes;
+    bool Node::msDeferListenerCallbacks = false;
+    OGRE_STATIC_MUTEX_INSTANCE(Node::msDeferredListenerMutex);
     //-----------------------------------------------------------------------
     Node::Node()
         :mParent(0),
@@ -64,6 +67,7 @@ namespace Ogre {
         mInitialOrientation(Quaternion::IDENTITY),
         mInitialScale(Vector3::UNIT_SCALE),
         mCachedTransformOutOfDate(true),
+        mTransformVersion(1),
         mListener(0), 
         mDebug(0)
     {
@@ -94,6 +98,7 @@ namespace Ogre {
         mInitialOrientation(Quaternion::IDENTITY),
         mInitialScale(Vector3::UNIT_SCALE),
         mCachedTransformOutOfDate(true),
+        mTransformVersion(1),
         mListener(0), 
         mDebug(0)
 
@@ -113,6 +118,11 @@ namespace Ogre {
         if (mListener)
         {
             mListener->nodeDestroyed(this);
+
+            // Cancel any pending nodeUpdated call
+            OGRE_LOCK_MUTEX(msDeferredListenerMutex);
+            std::replace(msDeferredListenerNodes.begin(), msDeferredListenerNodes.end(),
+                static_cast<const Node*>(this), static_cast<const Node*>(0));
         }
 
         removeAllChildren();
@@ -202,6 +212,7 @@ namespace Ogre {
                 _getDerivedOrientation());
 #endif
             mCachedTransformOutOfDate = false;
+            ++mTransformVersion;
         }
         return mCachedTransform;
     }
@@ -248,6 +259,55 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void Node::_updateAndGetChildren(bool parentHasChanged, ChildUpdateList& children)
+    {
+        // Same sequence as _update, but hand back the children instead of
+        // descending into them
+        mParentNotified = false;
+
+        if (mNeedParentUpdate || parentHasChanged)
+        {
+            _updateFromParent();
+        }
+
+        if (mNeedChildUpdate || parentHasChanged)
+        {
+            ChildNodeMap::iterator it, itend;
+            itend = mChildren.end();
+            for (it = mChildren.begin(); it != itend; ++it)
+            {
+                children.push_back(std::make_pair(it->second, true));
+            }
+        }
+        else
+        {
+            ChildUpdateSet::iterator it, itend;
+            itend = mChildrenToUpdate.end();
+            for(it = mChildrenToUpdate.begin(); it != itend; ++it)
+            {
+                children.push_back(std::make_pair(*it, false));
+            }
+        }
+
+        mChildrenToUpdate.clear();
+        mNeedChildUpdate = false;
+    }
+    //-----------------------------------------------------------------------
+    bool Node::_updateSelf(bool parentHasChanged)
+    {
+        mParentNotified = false;
+
+        if (mNeedParentUpdate || parentHasChanged)
+        {
+            _updateFromParent();
+        }
+
+        bool updateAllChildren = mNeedChildUpdate || parentHasChanged;
+        mChildrenToUpdate.clear();
+        mNeedChildUpdate = false;
+        return updateAllChildren;
+    }
+    //-----------------------------------------------------------------------
     void Node::_updateFromParent(void) const
     {
         updateFromParentImpl();
@@ -255,7 +315,15 @@ namespace Ogre {
         // Call listener (note, this method only called if there's something to do)
         if (mListener)
         {
-            mListener->nodeUpdated(this);
+            if (msDeferListenerCallbacks)
+            {
+                OGRE_LOCK_MUTEX(msDeferredListenerMutex);
+                msDeferredListenerNodes.push_back(this);
+            }
+            else
+            {
+                mListener->nodeUpdated(this);
+            }
         }
     }
     //-----------------------------------------------------------------------
@@ -907,6 +975,19 @@ namespace Ogre {
         }
         msQueuedUpdates.clear();
     }
+    //-----------------------------------------------------------------------
+    void Node::_processDeferredListenerCallbacks(void)
+    {
+        // Iterate by index, listeners are allowed to destroy nodes which
+        // cancels their entry
+        for (size_t i = 0; i < msDeferredListenerNodes.size(); ++i)
+        {
+            const Node* n = msDeferredListenerNodes[i];
+            if (n && n->mListener)
+                n->mListener->nodeUpdated(n);
+        }
+        msDeferredListenerNodes.clear();
+    }
     //---------------------------------------------------------------------
     Node::DebugRenderable* Node::getDebugRenderable(Real scaling)
     {
@@ -43,8 +43,9 @@ namespace Ogre {
     extern OptimisedUtil* _getOptimisedUtilGeneral(void);
 #if __OGRE_HAVE_SSE
     extern OptimisedUtil* _getOptimisedUtilSSE(void);
-//#elif __OGRE_HAVE_NEON
-//    extern OptimisedUtil* _getOptimisedUtilNEON(void);
+    extern OptimisedUtil* _getOptimisedUtilAVX2(void);
+#elif __OGRE_HAVE_NEON
+    extern OptimisedUtil* _getOptimisedUtilNEON(void);
 //#elif __OGRE_HAVE_VFP
 //    extern OptimisedUtil* _getOptimisedUtilVFP(void);
 #endif
@@ -86,8 +87,9 @@ namespace Ogre {
             IMPL_DEFAULT,
 #if __OGRE_HAVE_SSE
             IMPL_SSE,
-//#elif __OGRE_HAVE_NEON
-//            IMPL_NEON,
+            IMPL_AVX2,
+#elif __OGRE_HAVE_NEON
+            IMPL_NEON,
 //#elif __OGRE_HAVE_VFP
 //            IMPL_VFP,
 #endif
@@ -137,16 +139,23 @@ namespace Ogre {
             {
                 mOptimisedUtils.push_back(_getOptimisedUtilSSE());
             }
+            const uint avx2Features =
+                PlatformInformation::CPU_FEATURE_AVX2 | PlatformInformation::CPU_FEATURE_FMA;
+            if ((PlatformInformation::getCpuFeatures() & avx2Features) == avx2Features &&
+                _getOptimisedUtilAVX2())
+            {
+                mOptimisedUtils.push_back(_getOptimisedUtilAVX2());
+            }
+#elif __OGRE_HAVE_NEON
+            if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_NEON)
+            {
+                mOptimisedUtils.push_back(_getOptimisedUtilNEON());
+            }
 //#elif __OGRE_HAVE_VFP
 //            if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_VFP)
 //            {
 //                mOptimisedUtils.push_back(_getOptimisedUtilVFP());
 //            }
-//#elif __OGRE_HAVE_NEON
-//            if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_NEON)
-//            {
-//                mOptimisedUtils.push_back(_getOptimisedUtilNEON());
-//            }
 #endif
         }
 
@@ -185,6 +194,42 @@ namespace Ogre {
             ++index;    // So we can put break point here even if in release build
         }
 
+        /// @copydoc OptimisedUtil::softwareVertexSkinningDualQuaternion
+        virtual void softwareVertexSkinningDualQuaternion(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const DualQuaternion* const* blendDualQuaternions,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->softwareVertexSkinningDualQuaternion(
+                srcPosPtr, destPosPtr,
+                srcNormPtr, destNormPtr,
+                blendWeightPtr, blendIndexPtr,
+                blendDualQuaternions,
+                srcPosStride, destPosStride,
+                srcNormStride, destNormStride,
+                blendWeightStride, blendIndexStride,
+                numWeightsPerVertex,
+                numVertices);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
         virtual void softwareVertexMorph(
             Real t,
             const float *srcPos1, const float *srcPos2,
@@ -239,6 +284,58 @@ namespace Ogre {
             ++index;    // So we can put break point here even if in release build
         }
 
+        /// @copydoc OptimisedUtil::transformPoints
+        virtual void transformPoints(
+            const Matrix4& matrix,
+            const float* srcPtr, float* destPtr,
+            size_t srcStride, size_t destStride,
+            size_t numPoints)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->transformPoints(
+                matrix,
+                srcPtr, destPtr,
+                srcStride, destStride,
+                numPoints);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        /// @copydoc OptimisedUtil::transformDirections
+        virtual void transformDirections(
+            const Matrix4& matrix,
+            const float* srcPtr, float* destPtr,
+            size_t srcStride, size_t destStride,
+            size_t numDirections, bool normalise)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->transformDirections(
+                matrix,
+                srcPtr, destPtr,
+                srcStride, destStride,
+                numDirections, normalise);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
         /// @copydoc OptimisedUtil::calculateFaceNormals
         virtual void calculateFaceNormals(
             const float *positions,
@@ -348,6 +445,275 @@ namespace Ogre {
             ++index;    // So we can put break point here even if in release build
         }
 
+        virtual void cullBoxes(
+            const Plane* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes)
+        {
+            static ProfileItems results_;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results_[index];
+
+            profile.begin();
+            impl->cullBoxes(
+                planes, numPlanes,
+                centreX, centreY, centreZ,
+                halfSizeX, halfSizeY, halfSizeZ,
+                results, numBoxes);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void cullSpheres(
+            const Plane* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* radius,
+            uint8* results, size_t numSpheres)
+        {
+            static ProfileItems results_;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results_[index];
+
+            profile.begin();
+            impl->cullSpheres(
+                planes, numPlanes,
+                centreX, centreY, centreZ,
+                radius,
+                results, numSpheres);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void intersectBoxes(
+            const AxisAlignedBox& box,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes)
+        {
+            static ProfileItems results_;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results_[index];
+
+            profile.begin();
+            impl->intersectBoxes(
+                box,
+                centreX, centreY, centreZ,
+                halfSizeX, halfSizeY, halfSizeZ,
+                results, numBoxes);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void intersectBoxes(
+            const Sphere& sphere,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes)
+        {
+            static ProfileItems results_;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results_[index];
+
+            profile.begin();
+            impl->intersectBoxes(
+                sphere,
+                centreX, centreY, centreZ,
+                halfSizeX, halfSizeY, halfSizeZ,
+                results, numBoxes);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void intersectBoxes(
+            const Ray& ray,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            float* distances, uint8* results, size_t numBoxes)
+        {
+            static ProfileItems results_;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results_[index];
+
+            profile.begin();
+            impl->intersectBoxes(
+                ray,
+                centreX, centreY, centreZ,
+                halfSizeX, halfSizeY, halfSizeZ,
+                distances, results, numBoxes);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void intersectSpheres(
+            const Sphere& sphere,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* radius,
+            uint8* results, size_t numSpheres)
+        {
+            static ProfileItems results_;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results_[index];
+
+            profile.begin();
+            impl->intersectSpheres(
+                sphere,
+                centreX, centreY, centreZ,
+                radius,
+                results, numSpheres);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void nlerpQuaternions(
+            const float* t,
+            const float* src1, const float* src2,
+            float* dest, size_t numQuaternions)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->nlerpQuaternions(
+                t,
+                src1, src2,
+                dest, numQuaternions);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void shufflePixels(
+            const uint8* src, size_t srcPixelSize,
+            uint8* dest, size_t destPixelSize,
+            const int8* shuffle, size_t numPixels)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->shufflePixels(
+                src, srcPixelSize,
+                dest, destPixelSize,
+                shuffle, numPixels);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void convertHalfToFloat(
+            const uint16* src, float* dest, size_t count)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->convertHalfToFloat(src, dest, count);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void convertFloatToHalf(
+            const float* src, uint16* dest, size_t count)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->convertFloatToHalf(src, dest, count);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void sumWeightedRows(
+            const float* const* rows, const float* weights, size_t numRows,
+            float* dest, size_t count)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->sumWeightedRows(rows, weights, numRows, dest, count);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void convertFloatToByte(
+            const float* src, uint8* dest, size_t count)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->convertFloatToByte(src, dest, count);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
     };
 #endif // __DO_PROFILE__
 
@@ -404,21 +770,29 @@ namespace Ogre {
 #if __OGRE_HAVE_SSE
         if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE)
         {
+            // The AVX2 implementation is null if the compiler couldn't build it
+            const uint avx2Features =
+                PlatformInformation::CPU_FEATURE_AVX2 | PlatformInformation::CPU_FEATURE_FMA;
+            if ((PlatformInformation::getCpuFeatures() & avx2Features) == avx2Features &&
+                _getOptimisedUtilAVX2())
+            {
+                return _getOptimisedUtilAVX2();
+            }
             return _getOptimisedUtilSSE();
         }
         else
+#elif __OGRE_HAVE_NEON
+        if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_NEON)
+        {
+            return _getOptimisedUtilNEON();
+        }
+        else
 //#elif __OGRE_HAVE_VFP
 //        if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_VFP)
 //        {
 //            return _getOptimisedUtilVFP();
 //        }
 //        else
-//#elif __OGRE_HAVE_NEON
-//        if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_NEON)
-//        {
-//            return _getOptimisedUtilNEON();
-//        }
-//        else
 #endif  // __OGRE_HAVE_SSE
         {
 #if __OGRE_HAVE_DIRECTXMATH
@@ -0,0 +1,1348 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgreOptimisedUtil.h"
+#include "OgrePlatformInformation.h"
+
+#if __OGRE_HAVE_SSE
+
+#include "OgreMatrix4.h"
+#include "OgreDualQuaternion.h"
+#include "OgrePlane.h"
+#include "OgreSIMDHelper.h"
+
+// Like the SSE version, this file has to be compiled with its own code
+// generation flags (-mavx2 -mfma with gcc and clang), so the rest of Ogre
+// still runs on CPUs without AVX2. MSVC accepts the intrinsics regardless.
+#if (defined(__AVX2__) && defined(__FMA__)) || \
+    (OGRE_COMPILER == OGRE_COMPILER_MSVC && OGRE_COMP_VER >= 1700)
+#   define __OGRE_HAVE_AVX2 1
+#   include <immintrin.h>
+#endif
+
+// Half float conversions also need -mf16c, every AVX2 CPU has F16C
+#if defined(__F16C__) || (OGRE_COMPILER == OGRE_COMPILER_MSVC && OGRE_COMP_VER >= 1700)
+#   define __OGRE_HAVE_F16C 1
+#endif
+
+namespace Ogre {
+
+    extern OptimisedUtil* _getOptimisedUtilSSE(void);
+
+#if __OGRE_HAVE_AVX2
+
+//-------------------------------------------------------------------------
+// Local classes
+//-------------------------------------------------------------------------
+
+    /** AVX2 implementation of OptimisedUtil.
+    @remarks
+        Every routine works on eight elements at a time, converting vertex
+        data to one register per component with gather loads and using fused
+        multiply-add for the arithmetic. Left over elements, and data with
+        strides which aren't whole floats, are handed to the SSE version.
+    @note
+        Don't use this class directly, use OptimisedUtil instead.
+    */
+    class _OgrePrivate OptimisedUtilAVX2 : public OptimisedUtil
+    {
+    protected:
+        /// Implementation for the elements we don't handle
+        OptimisedUtil* mFallback;
+        /// Whether the CPU has the F16C half float conversions
+        bool mHasF16C;
+
+    public:
+        /// Constructor
+        OptimisedUtilAVX2(void)
+            : mFallback(_getOptimisedUtilSSE())
+            , mHasF16C(PlatformInformation::hasCpuFeature(PlatformInformation::CPU_FEATURE_F16C))
+        {
+        }
+
+        /// @copydoc OptimisedUtil::softwareVertexSkinning
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE softwareVertexSkinning(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const Matrix4* const* blendMatrices,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices);
+
+        /// @copydoc OptimisedUtil::softwareVertexSkinningDualQuaternion
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE softwareVertexSkinningDualQuaternion(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const DualQuaternion* const* blendDualQuaternions,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices);
+
+        /// @copydoc OptimisedUtil::softwareVertexMorph
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE softwareVertexMorph(
+            Real t,
+            const float *srcPos1, const float *srcPos2,
+            float *dstPos,
+            size_t pos1VSize, size_t pos2VSize, size_t dstVSize, 
+            size_t numVertices,
+            bool morphNormals);
+
+        /// @copydoc OptimisedUtil::concatenateAffineMatrices
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE concatenateAffineMatrices(
+            const Matrix4& baseMatrix,
+            const Matrix4* srcMatrices,
+            Matrix4* dstMatrices,
+            size_t numMatrices);
+
+        /// @copydoc OptimisedUtil::transformPoints
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE transformPoints(
+            const Matrix4& matrix,
+            const float* srcPtr, float* destPtr,
+            size_t srcStride, size_t destStride,
+            size_t numPoints);
+
+        /// @copydoc OptimisedUtil::transformDirections
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE transformDirections(
+            const Matrix4& matrix,
+            const float* srcPtr, float* destPtr,
+            size_t srcStride, size_t destStride,
+            size_t numDirections, bool normalise);
+
+        /// @copydoc OptimisedUtil::calculateFaceNormals
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE calculateFaceNormals(
+            const float *positions,
+            const EdgeData::Triangle *triangles,
+            Vector4 *faceNormals,
+            size_t numTriangles);
+
+        /// @copydoc OptimisedUtil::calculateLightFacing
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE calculateLightFacing(
+            const Vector4& lightPos,
+            const Vector4* faceNormals,
+            char* lightFacings,
+            size_t numFaces);
+
+        /// @copydoc OptimisedUtil::extrudeVertices
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE extrudeVertices(
+            const Vector4& lightPos,
+            Real extrudeDist,
+            const float* srcPositions,
+            float* destPositions,
+            size_t numVertices);
+
+        /// @copydoc OptimisedUtil::cullBoxes
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE cullBoxes(
+            const Plane* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes);
+
+        // The bounding volume tests below are cheap next to gathering their
+        // inputs, the SSE versions are used as they are
+
+        /// @copydoc OptimisedUtil::cullSpheres
+        virtual void cullSpheres(
+            const Plane* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* radius,
+            uint8* results, size_t numSpheres)
+        {
+            mFallback->cullSpheres(planes, numPlanes,
+                centreX, centreY, centreZ, radius, results, numSpheres);
+        }
+
+        /// @copydoc OptimisedUtil::intersectBoxes(const AxisAlignedBox&,const float*,const float*,const float*,const float*,const float*,const float*,uint8*,size_t)
+        virtual void intersectBoxes(
+            const AxisAlignedBox& box,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes)
+        {
+            mFallback->intersectBoxes(box,
+                centreX, centreY, centreZ, halfSizeX, halfSizeY, halfSizeZ,
+                results, numBoxes);
+        }
+
+        /// @copydoc OptimisedUtil::intersectBoxes(const Sphere&,const float*,const float*,const float*,const float*,const float*,const float*,uint8*,size_t)
+        virtual void intersectBoxes(
+            const Sphere& sphere,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes)
+        {
+            mFallback->intersectBoxes(sphere,
+                centreX, centreY, centreZ, halfSizeX, halfSizeY, halfSizeZ,
+                results, numBoxes);
+        }
+
+        /// @copydoc OptimisedUtil::intersectBoxes(const Ray&,const float*,const float*,const float*,const float*,const float*,const float*,float*,uint8*,size_t)
+        virtual void intersectBoxes(
+            const Ray& ray,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            float* distances, uint8* results, size_t numBoxes)
+        {
+            mFallback->intersectBoxes(ray,
+                centreX, centreY, centreZ, halfSizeX, halfSizeY, halfSizeZ,
+                distances, results, numBoxes);
+        }
+
+        /// @copydoc OptimisedUtil::intersectSpheres
+        virtual void intersectSpheres(
+            const Sphere& sphere,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* radius,
+            uint8* results, size_t numSpheres)
+        {
+            mFallback->intersectSpheres(sphere,
+                centreX, centreY, centreZ, radius, results, numSpheres);
+        }
+
+        /// @copydoc OptimisedUtil::nlerpQuaternions
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE nlerpQuaternions(
+            const float* t,
+            const float* src1, const float* src2,
+            float* dest, size_t numQuaternions);
+
+        /// @copydoc OptimisedUtil::shufflePixels
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE shufflePixels(
+            const uint8* src, size_t srcPixelSize,
+            uint8* dest, size_t destPixelSize,
+            const int8* shuffle, size_t numPixels);
+
+        /// @copydoc OptimisedUtil::convertHalfToFloat
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE convertHalfToFloat(
+            const uint16* src, float* dest, size_t count);
+
+        /// @copydoc OptimisedUtil::convertFloatToHalf
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE convertFloatToHalf(
+            const float* src, uint16* dest, size_t count);
+
+        /// @copydoc OptimisedUtil::sumWeightedRows
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE sumWeightedRows(
+            const float* const* rows, const float* weights, size_t numRows,
+            float* dest, size_t count);
+
+        /// @copydoc OptimisedUtil::convertFloatToByte
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE convertFloatToByte(
+            const float* src, uint8* dest, size_t count);
+    };
+
+//-------------------------------------------------------------------------
+// Local functions
+//-------------------------------------------------------------------------
+
+    /// Can a stride in bytes be used for gather loads?
+    static OGRE_FORCE_INLINE bool isGatherStride(size_t stride)
+    {
+        return (stride % sizeof(float)) == 0;
+    }
+    //---------------------------------------------------------------------
+    /// Offsets in floats of eight consecutive elements with the given stride in bytes
+    static OGRE_FORCE_INLINE __m256i gatherOffsets(size_t stride)
+    {
+        int s = static_cast<int>(stride / sizeof(float));
+        return _mm256_setr_epi32(0, s, 2*s, 3*s, 4*s, 5*s, 6*s, 7*s);
+    }
+    //---------------------------------------------------------------------
+    /// Load eight packed xyz vectors into one register per component
+    static OGRE_FORCE_INLINE void loadVector3x8(const float* p, __m256i offsets,
+        __m256& x, __m256& y, __m256& z)
+    {
+        x = _mm256_i32gather_ps(p, offsets, 4);
+        y = _mm256_i32gather_ps(p + 1, offsets, 4);
+        z = _mm256_i32gather_ps(p + 2, offsets, 4);
+    }
+    //---------------------------------------------------------------------
+    /// Store eight xyz vectors held one register per component, there is no scatter in AVX2
+    static OGRE_FORCE_INLINE void storeVector3x8(float* p, size_t stride,
+        __m256 x, __m256 y, __m256 z)
+    {
+        float tx[8], ty[8], tz[8];
+        _mm256_storeu_ps(tx, x);
+        _mm256_storeu_ps(ty, y);
+        _mm256_storeu_ps(tz, z);
+        for (size_t i = 0; i < 8; ++i)
+        {
+            p[0] = tx[i];
+            p[1] = ty[i];
+            p[2] = tz[i];
+            advanceRawPointer(p, stride);
+        }
+    }
+    //---------------------------------------------------------------------
+    /// Normalise eight vectors, leaving zero length ones alone like Vector3::normalise
+    static OGRE_FORCE_INLINE void normaliseVector3x8(__m256& x, __m256& y, __m256& z)
+    {
+        const __m256 one = _mm256_set1_ps(1.0f);
+        __m256 length = _mm256_sqrt_ps(
+            _mm256_fmadd_ps(x, x, _mm256_fmadd_ps(y, y, _mm256_mul_ps(z, z))));
+        __m256 scale = _mm256_blendv_ps(one, _mm256_div_ps(one, length),
+            _mm256_cmp_ps(length, _mm256_setzero_ps(), _CMP_GT_OQ));
+        x = _mm256_mul_ps(x, scale);
+        y = _mm256_mul_ps(y, scale);
+        z = _mm256_mul_ps(z, scale);
+    }
+    //---------------------------------------------------------------------
+    /** Transpose the 4x4 matrices held in each 128-bit half of four registers.
+    @remarks
+        Loading eight packed quaternions as four registers and transposing
+        gives one register per component, with the even quaternions in the
+        lower half and the odd ones in the upper half.
+    */
+    static OGRE_FORCE_INLINE void transposeLanes4x4(__m256& r0, __m256& r1, __m256& r2, __m256& r3)
+    {
+        __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+        __m256 t1 = _mm256_unpacklo_ps(r2, r3);
+        __m256 t2 = _mm256_unpackhi_ps(r0, r1);
+        __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+        r0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+        r1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+        r2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        r3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::softwareVertexSkinning(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Matrix4* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        size_t numIterations = 0;
+        if (isGatherStride(srcPosStride) && (!pSrcNorm || isGatherStride(srcNormStride)))
+        {
+            numIterations = numVertices / 8;
+            numVertices &= 7;
+        }
+
+        const __m256i srcPosOffsets = gatherOffsets(srcPosStride);
+        const __m256i srcNormOffsets = gatherOffsets(srcNormStride);
+        // Blended matrices are built as 3x4 rows, eight after another
+        const __m256i matrixOffsets = _mm256_setr_epi32(0, 12, 24, 36, 48, 60, 72, 84);
+        float blended[12 * 8];
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            // Blend the matrices of each vertex, two rows in one register
+            for (size_t v = 0; v < 8; ++v)
+            {
+                __m256 m01 = _mm256_setzero_ps();
+                __m128 m2 = _mm_setzero_ps();
+                for (size_t b = 0; b < numWeightsPerVertex; ++b)
+                {
+                    // NB weights must be normalised!!
+                    float weight = pBlendWeight[b];
+                    if (weight)
+                    {
+                        const float* mat = (*blendMatrices[pBlendIndex[b]])[0];
+                        __m256 w = _mm256_set1_ps(weight);
+                        m01 = _mm256_fmadd_ps(w, _mm256_loadu_ps(mat), m01);
+                        m2 = _mm_fmadd_ps(_mm256_castps256_ps128(w), _mm_loadu_ps(mat + 8), m2);
+                    }
+                }
+                _mm256_storeu_ps(blended + v * 12, m01);
+                _mm_storeu_ps(blended + v * 12 + 8, m2);
+
+                advanceRawPointer(pBlendWeight, blendWeightStride);
+                advanceRawPointer(pBlendIndex, blendIndexStride);
+            }
+
+            // One register per matrix element, lane n for vertex n
+            __m256 m[12];
+            for (size_t e = 0; e < 12; ++e)
+                m[e] = _mm256_i32gather_ps(blended + e, matrixOffsets, 4);
+
+            __m256 x, y, z;
+            loadVector3x8(pSrcPos, srcPosOffsets, x, y, z);
+            storeVector3x8(pDestPos, destPosStride,
+                _mm256_fmadd_ps(m[0], x, _mm256_fmadd_ps(m[1], y, _mm256_fmadd_ps(m[2], z, m[3]))),
+                _mm256_fmadd_ps(m[4], x, _mm256_fmadd_ps(m[5], y, _mm256_fmadd_ps(m[6], z, m[7]))),
+                _mm256_fmadd_ps(m[8], x, _mm256_fmadd_ps(m[9], y, _mm256_fmadd_ps(m[10], z, m[11]))));
+            advanceRawPointer(pSrcPos, 8 * srcPosStride);
+            advanceRawPointer(pDestPos, 8 * destPosStride);
+
+            if (pSrcNorm)
+            {
+                // Rotational part only, assumes no non-uniform scaling
+                loadVector3x8(pSrcNorm, srcNormOffsets, x, y, z);
+                __m256 nx = _mm256_fmadd_ps(m[0], x, _mm256_fmadd_ps(m[1], y, _mm256_mul_ps(m[2], z)));
+                __m256 ny = _mm256_fmadd_ps(m[4], x, _mm256_fmadd_ps(m[5], y, _mm256_mul_ps(m[6], z)));
+                __m256 nz = _mm256_fmadd_ps(m[8], x, _mm256_fmadd_ps(m[9], y, _mm256_mul_ps(m[10], z)));
+                normaliseVector3x8(nx, ny, nz);
+                storeVector3x8(pDestNorm, destNormStride, nx, ny, nz);
+                advanceRawPointer(pSrcNorm, 8 * srcNormStride);
+                advanceRawPointer(pDestNorm, 8 * destNormStride);
+            }
+        }
+        _mm256_zeroupper();
+
+        if (numVertices)
+        {
+            mFallback->softwareVertexSkinning(
+                pSrcPos, pDestPos,
+                pSrcNorm, pDestNorm,
+                pBlendWeight, pBlendIndex,
+                blendMatrices,
+                srcPosStride, destPosStride,
+                srcNormStride, destNormStride,
+                blendWeightStride, blendIndexStride,
+                numWeightsPerVertex,
+                numVertices);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::softwareVertexSkinningDualQuaternion(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const DualQuaternion* const* blendDualQuaternions,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        size_t numIterations = 0;
+        if (isGatherStride(srcPosStride) && (!pSrcNorm || isGatherStride(srcNormStride)))
+        {
+            numIterations = numVertices / 8;
+            numVertices &= 7;
+        }
+
+        const __m256i srcPosOffsets = gatherOffsets(srcPosStride);
+        const __m256i srcNormOffsets = gatherOffsets(srcNormStride);
+        // Blended dual quaternions are built eight after another
+        const __m256i dqOffsets = _mm256_setr_epi32(0, 8, 16, 24, 32, 40, 48, 56);
+        const __m256 minLengthSq = _mm256_set1_ps(1e-30f);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        float blended[8 * 8];
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            // Blend the dual quaternions of each vertex, flipping those in the
+            // opposite hemisphere to the first so the shortest rotation is taken
+            for (size_t v = 0; v < 8; ++v)
+            {
+                const DualQuaternion& first = *blendDualQuaternions[pBlendIndex[0]];
+                __m256 dq8 = _mm256_setzero_ps();
+                for (size_t b = 0; b < numWeightsPerVertex; ++b)
+                {
+                    // NB weights must be normalised!!
+                    float weight = pBlendWeight[b];
+                    if (weight)
+                    {
+                        const DualQuaternion& dq = *blendDualQuaternions[pBlendIndex[b]];
+                        if (dq.w * first.w + dq.x * first.x + dq.y * first.y + dq.z * first.z < 0)
+                            weight = -weight;
+                        dq8 = _mm256_fmadd_ps(_mm256_set1_ps(weight), _mm256_loadu_ps(&dq.w), dq8);
+                    }
+                }
+                _mm256_storeu_ps(blended + v * 8, dq8);
+
+                advanceRawPointer(pBlendWeight, blendWeightStride);
+                advanceRawPointer(pBlendIndex, blendIndexStride);
+            }
+
+            // One register per component, lane n for vertex n
+            __m256 rw = _mm256_i32gather_ps(blended + 0, dqOffsets, 4);
+            __m256 rx = _mm256_i32gather_ps(blended + 1, dqOffsets, 4);
+            __m256 ry = _mm256_i32gather_ps(blended + 2, dqOffsets, 4);
+            __m256 rz = _mm256_i32gather_ps(blended + 3, dqOffsets, 4);
+            __m256 dw = _mm256_i32gather_ps(blended + 4, dqOffsets, 4);
+            __m256 dx = _mm256_i32gather_ps(blended + 5, dqOffsets, 4);
+            __m256 dy = _mm256_i32gather_ps(blended + 6, dqOffsets, 4);
+            __m256 dz = _mm256_i32gather_ps(blended + 7, dqOffsets, 4);
+
+            // Normalise by the length of the rotation part
+            __m256 invLength = _mm256_div_ps(one, _mm256_sqrt_ps(_mm256_max_ps(
+                _mm256_fmadd_ps(rw, rw, _mm256_fmadd_ps(rx, rx,
+                    _mm256_fmadd_ps(ry, ry, _mm256_mul_ps(rz, rz)))), minLengthSq)));
+            rw = _mm256_mul_ps(rw, invLength);
+            rx = _mm256_mul_ps(rx, invLength);
+            ry = _mm256_mul_ps(ry, invLength);
+            rz = _mm256_mul_ps(rz, invLength);
+            dw = _mm256_mul_ps(dw, invLength);
+            dx = _mm256_mul_ps(dx, invLength);
+            dy = _mm256_mul_ps(dy, invLength);
+            dz = _mm256_mul_ps(dz, invLength);
+
+            // Rotate the position, p + 2 r x (r x p + w p), then translate
+            // by 2 (w d - dw r + r x d)
+            __m256 x, y, z;
+            loadVector3x8(pSrcPos, srcPosOffsets, x, y, z);
+            __m256 tx = _mm256_fmadd_ps(rw, x, _mm256_fmsub_ps(ry, z, _mm256_mul_ps(rz, y)));
+            __m256 ty = _mm256_fmadd_ps(rw, y, _mm256_fmsub_ps(rz, x, _mm256_mul_ps(rx, z)));
+            __m256 tz = _mm256_fmadd_ps(rw, z, _mm256_fmsub_ps(rx, y, _mm256_mul_ps(ry, x)));
+            __m256 ox = _mm256_fmsub_ps(ry, tz, _mm256_mul_ps(rz, ty));
+            __m256 oy = _mm256_fmsub_ps(rz, tx, _mm256_mul_ps(rx, tz));
+            __m256 oz = _mm256_fmsub_ps(rx, ty, _mm256_mul_ps(ry, tx));
+            ox = _mm256_add_ps(ox, _mm256_fmadd_ps(rw, dx, _mm256_fnmadd_ps(dw, rx,
+                _mm256_fmsub_ps(ry, dz, _mm256_mul_ps(rz, dy)))));
+            oy = _mm256_add_ps(oy, _mm256_fmadd_ps(rw, dy, _mm256_fnmadd_ps(dw, ry,
+                _mm256_fmsub_ps(rz, dx, _mm256_mul_ps(rx, dz)))));
+            oz = _mm256_add_ps(oz, _mm256_fmadd_ps(rw, dz, _mm256_fnmadd_ps(dw, rz,
+                _mm256_fmsub_ps(rx, dy, _mm256_mul_ps(ry, dx)))));
+            storeVector3x8(pDestPos, destPosStride,
+                _mm256_add_ps(x, _mm256_add_ps(ox, ox)),
+                _mm256_add_ps(y, _mm256_add_ps(oy, oy)),
+                _mm256_add_ps(z, _mm256_add_ps(oz, oz)));
+            advanceRawPointer(pSrcPos, 8 * srcPosStride);
+            advanceRawPointer(pDestPos, 8 * destPosStride);
+
+            if (pSrcNorm)
+            {
+                // Rotation only, which keeps unit normals unit length
+                loadVector3x8(pSrcNorm, srcNormOffsets, x, y, z);
+                tx = _mm256_fmadd_ps(rw, x, _mm256_fmsub_ps(ry, z, _mm256_mul_ps(rz, y)));
+                ty = _mm256_fmadd_ps(rw, y, _mm256_fmsub_ps(rz, x, _mm256_mul_ps(rx, z)));
+                tz = _mm256_fmadd_ps(rw, z, _mm256_fmsub_ps(rx, y, _mm256_mul_ps(ry, x)));
+                ox = _mm256_fmsub_ps(ry, tz, _mm256_mul_ps(rz, ty));
+                oy = _mm256_fmsub_ps(rz, tx, _mm256_mul_ps(rx, tz));
+                oz = _mm256_fmsub_ps(rx, ty, _mm256_mul_ps(ry, tx));
+                storeVector3x8(pDestNorm, destNormStride,
+                    _mm256_add_ps(x, _mm256_add_ps(ox, ox)),
+                    _mm256_add_ps(y, _mm256_add_ps(oy, oy)),
+                    _mm256_add_ps(z, _mm256_add_ps(oz, oz)));
+                advanceRawPointer(pSrcNorm, 8 * srcNormStride);
+                advanceRawPointer(pDestNorm, 8 * destNormStride);
+            }
+        }
+        _mm256_zeroupper();
+
+        if (numVertices)
+        {
+            mFallback->softwareVertexSkinningDualQuaternion(
+                pSrcPos, pDestPos,
+                pSrcNorm, pDestNorm,
+                pBlendWeight, pBlendIndex,
+                blendDualQuaternions,
+                srcPosStride, destPosStride,
+                srcNormStride, destNormStride,
+                blendWeightStride, blendIndexStride,
+                numWeightsPerVertex,
+                numVertices);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::softwareVertexMorph(
+        Real t,
+        const float *pSrc1, const float *pSrc2,
+        float *pDst,
+        size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+        size_t numVertices,
+        bool morphNormals)
+    {
+        size_t numIterations = 0;
+        if (isGatherStride(pos1VSize) && isGatherStride(pos2VSize))
+        {
+            numIterations = numVertices / 8;
+            numVertices &= 7;
+        }
+
+        const __m256i src1Offsets = gatherOffsets(pos1VSize);
+        const __m256i src2Offsets = gatherOffsets(pos2VSize);
+        const __m256 vt = _mm256_set1_ps(t);
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m256 x1, y1, z1, x2, y2, z2;
+            loadVector3x8(pSrc1, src1Offsets, x1, y1, z1);
+            loadVector3x8(pSrc2, src2Offsets, x2, y2, z2);
+            storeVector3x8(pDst, dstVSize,
+                _mm256_fmadd_ps(vt, _mm256_sub_ps(x2, x1), x1),
+                _mm256_fmadd_ps(vt, _mm256_sub_ps(y2, y1), y1),
+                _mm256_fmadd_ps(vt, _mm256_sub_ps(z2, z1), z1));
+
+            if (morphNormals)
+            {
+                // Normals follow positions in the same buffer, nlerp them
+                loadVector3x8(pSrc1 + 3, src1Offsets, x1, y1, z1);
+                loadVector3x8(pSrc2 + 3, src2Offsets, x2, y2, z2);
+                __m256 nx = _mm256_fmadd_ps(vt, _mm256_sub_ps(x2, x1), x1);
+                __m256 ny = _mm256_fmadd_ps(vt, _mm256_sub_ps(y2, y1), y1);
+                __m256 nz = _mm256_fmadd_ps(vt, _mm256_sub_ps(z2, z1), z1);
+                normaliseVector3x8(nx, ny, nz);
+                storeVector3x8(pDst + 3, dstVSize, nx, ny, nz);
+            }
+
+            advanceRawPointer(pSrc1, 8 * pos1VSize);
+            advanceRawPointer(pSrc2, 8 * pos2VSize);
+            advanceRawPointer(pDst, 8 * dstVSize);
+        }
+        _mm256_zeroupper();
+
+        if (numVertices)
+        {
+            mFallback->softwareVertexMorph(t, pSrc1, pSrc2, pDst,
+                pos1VSize, pos2VSize, dstVSize, numVertices, morphNormals);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::concatenateAffineMatrices(
+        const Matrix4& baseMatrix,
+        const Matrix4* pSrcMat,
+        Matrix4* pDstMat,
+        size_t numMatrices)
+    {
+        const Matrix4& m = baseMatrix;
+
+        // Each destination row is the base matrix row applied to the source
+        // rows, computed two rows per register. Row 3 is always (0, 0, 0, 1).
+        const __m256 c0_01 = _mm256_setr_ps(
+            m[0][0], m[0][0], m[0][0], m[0][0], m[1][0], m[1][0], m[1][0], m[1][0]);
+        const __m256 c1_01 = _mm256_setr_ps(
+            m[0][1], m[0][1], m[0][1], m[0][1], m[1][1], m[1][1], m[1][1], m[1][1]);
+        const __m256 c2_01 = _mm256_setr_ps(
+            m[0][2], m[0][2], m[0][2], m[0][2], m[1][2], m[1][2], m[1][2], m[1][2]);
+        const __m256 t_01 = _mm256_setr_ps(0, 0, 0, m[0][3], 0, 0, 0, m[1][3]);
+        const __m256 c0_23 = _mm256_setr_ps(m[2][0], m[2][0], m[2][0], m[2][0], 0, 0, 0, 0);
+        const __m256 c1_23 = _mm256_setr_ps(m[2][1], m[2][1], m[2][1], m[2][1], 0, 0, 0, 0);
+        const __m256 c2_23 = _mm256_setr_ps(m[2][2], m[2][2], m[2][2], m[2][2], 0, 0, 0, 0);
+        const __m256 t_23 = _mm256_setr_ps(0, 0, 0, m[2][3], 0, 0, 0, 1);
+
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            const Matrix4& s = *pSrcMat;
+            Matrix4& d = *pDstMat;
+
+            __m256 s0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(s[0]));
+            __m256 s1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(s[1]));
+            __m256 s2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(s[2]));
+
+            _mm256_storeu_ps(d[0],
+                _mm256_fmadd_ps(c0_01, s0, _mm256_fmadd_ps(c1_01, s1, _mm256_fmadd_ps(c2_01, s2, t_01))));
+            _mm256_storeu_ps(d[2],
+                _mm256_fmadd_ps(c0_23, s0, _mm256_fmadd_ps(c1_23, s1, _mm256_fmadd_ps(c2_23, s2, t_23))));
+
+            ++pSrcMat;
+            ++pDstMat;
+        }
+        _mm256_zeroupper();
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::transformPoints(
+        const Matrix4& m,
+        const float* pSrc, float* pDest,
+        size_t srcStride, size_t destStride,
+        size_t numPoints)
+    {
+        size_t numIterations = 0;
+        if (isGatherStride(srcStride))
+        {
+            numIterations = numPoints / 8;
+            numPoints &= 7;
+        }
+
+        const __m256i srcOffsets = gatherOffsets(srcStride);
+        __m256 e[12];
+        for (size_t r = 0; r < 3; ++r)
+        {
+            for (size_t c = 0; c < 4; ++c)
+                e[r * 4 + c] = _mm256_set1_ps(m[r][c]);
+        }
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m256 x, y, z;
+            loadVector3x8(pSrc, srcOffsets, x, y, z);
+            storeVector3x8(pDest, destStride,
+                _mm256_fmadd_ps(e[0], x, _mm256_fmadd_ps(e[1], y, _mm256_fmadd_ps(e[2], z, e[3]))),
+                _mm256_fmadd_ps(e[4], x, _mm256_fmadd_ps(e[5], y, _mm256_fmadd_ps(e[6], z, e[7]))),
+                _mm256_fmadd_ps(e[8], x, _mm256_fmadd_ps(e[9], y, _mm256_fmadd_ps(e[10], z, e[11]))));
+
+            advanceRawPointer(pSrc, 8 * srcStride);
+            advanceRawPointer(pDest, 8 * destStride);
+        }
+        _mm256_zeroupper();
+
+        if (numPoints)
+        {
+            mFallback->transformPoints(m,
+                pSrc, pDest, srcStride, destStride, numPoints);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::transformDirections(
+        const Matrix4& m,
+        const float* pSrc, float* pDest,
+        size_t srcStride, size_t destStride,
+        size_t numDirections, bool normalise)
+    {
+        size_t numIterations = 0;
+        if (isGatherStride(srcStride))
+        {
+            numIterations = numDirections / 8;
+            numDirections &= 7;
+        }
+
+        const __m256i srcOffsets = gatherOffsets(srcStride);
+        __m256 e[9];
+        for (size_t r = 0; r < 3; ++r)
+        {
+            for (size_t c = 0; c < 3; ++c)
+                e[r * 3 + c] = _mm256_set1_ps(m[r][c]);
+        }
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m256 x, y, z;
+            loadVector3x8(pSrc, srcOffsets, x, y, z);
+            __m256 dx = _mm256_fmadd_ps(e[0], x, _mm256_fmadd_ps(e[1], y, _mm256_mul_ps(e[2], z)));
+            __m256 dy = _mm256_fmadd_ps(e[3], x, _mm256_fmadd_ps(e[4], y, _mm256_mul_ps(e[5], z)));
+            __m256 dz = _mm256_fmadd_ps(e[6], x, _mm256_fmadd_ps(e[7], y, _mm256_mul_ps(e[8], z)));
+            if (normalise)
+                normaliseVector3x8(dx, dy, dz);
+            storeVector3x8(pDest, destStride, dx, dy, dz);
+
+            advanceRawPointer(pSrc, 8 * srcStride);
+            advanceRawPointer(pDest, 8 * destStride);
+        }
+        _mm256_zeroupper();
+
+        if (numDirections)
+        {
+            mFallback->transformDirections(m,
+                pSrc, pDest, srcStride, destStride, numDirections, normalise);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::calculateFaceNormals(
+        const float *positions,
+        const EdgeData::Triangle *triangles,
+        Vector4 *faceNormals,
+        size_t numTriangles)
+    {
+        size_t numIterations = numTriangles / 8;
+        numTriangles &= 7;
+
+        // Vertex indexes are read as their low 32 bits
+        const __m256i triangleOffsets = gatherOffsets(sizeof(EdgeData::Triangle));
+        const __m256i three = _mm256_set1_epi32(3);
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m256 x[3], y[3], z[3];
+            for (size_t v = 0; v < 3; ++v)
+            {
+                __m256i index = _mm256_i32gather_epi32(
+                    reinterpret_cast<const int*>(&triangles->vertIndex[v]), triangleOffsets, 4);
+                __m256i offsets = _mm256_mullo_epi32(index, three);
+                x[v] = _mm256_i32gather_ps(positions, offsets, 4);
+                y[v] = _mm256_i32gather_ps(positions + 1, offsets, 4);
+                z[v] = _mm256_i32gather_ps(positions + 2, offsets, 4);
+            }
+
+            // normal = (v1 - v0) x (v2 - v0), w = -(normal . v0)
+            __m256 ax = _mm256_sub_ps(x[1], x[0]), ay = _mm256_sub_ps(y[1], y[0]), az = _mm256_sub_ps(z[1], z[0]);
+            __m256 bx = _mm256_sub_ps(x[2], x[0]), by = _mm256_sub_ps(y[2], y[0]), bz = _mm256_sub_ps(z[2], z[0]);
+            __m256 nx = _mm256_fmsub_ps(ay, bz, _mm256_mul_ps(az, by));
+            __m256 ny = _mm256_fmsub_ps(az, bx, _mm256_mul_ps(ax, bz));
+            __m256 nz = _mm256_fmsub_ps(ax, by, _mm256_mul_ps(ay, bx));
+            __m256 nw = _mm256_fnmsub_ps(nx, x[0], _mm256_fmadd_ps(ny, y[0], _mm256_mul_ps(nz, z[0])));
+
+            // Transpose to eight xyzw vectors
+            __m256 t0 = _mm256_unpacklo_ps(nx, ny);
+            __m256 t1 = _mm256_unpackhi_ps(nx, ny);
+            __m256 t2 = _mm256_unpacklo_ps(nz, nw);
+            __m256 t3 = _mm256_unpackhi_ps(nz, nw);
+            __m256 r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+            float* pDest = &faceNormals->x;
+            _mm256_storeu_ps(pDest + 0, _mm256_permute2f128_ps(r0, r1, 0x20));
+            _mm256_storeu_ps(pDest + 8, _mm256_permute2f128_ps(r2, r3, 0x20));
+            _mm256_storeu_ps(pDest + 16, _mm256_permute2f128_ps(r0, r1, 0x31));
+            _mm256_storeu_ps(pDest + 24, _mm256_permute2f128_ps(r2, r3, 0x31));
+
+            triangles += 8;
+            faceNormals += 8;
+        }
+        _mm256_zeroupper();
+
+        if (numTriangles)
+        {
+            mFallback->calculateFaceNormals(positions, triangles, faceNormals, numTriangles);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::calculateLightFacing(
+        const Vector4& lightPos,
+        const Vector4* faceNormals,
+        char* lightFacings,
+        size_t numFaces)
+    {
+        size_t numIterations = numFaces / 8;
+        numFaces &= 7;
+
+        const __m256 light = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&lightPos.x));
+        // The horizontal adds below leave the dot products in the order
+        // 0 2 4 6 1 3 5 7, this puts them back
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            const float* pSrc = &faceNormals->x;
+            __m256 p0 = _mm256_mul_ps(_mm256_loadu_ps(pSrc + 0), light);
+            __m256 p1 = _mm256_mul_ps(_mm256_loadu_ps(pSrc + 8), light);
+            __m256 p2 = _mm256_mul_ps(_mm256_loadu_ps(pSrc + 16), light);
+            __m256 p3 = _mm256_mul_ps(_mm256_loadu_ps(pSrc + 24), light);
+            __m256 dots = _mm256_hadd_ps(_mm256_hadd_ps(p0, p1), _mm256_hadd_ps(p2, p3));
+            dots = _mm256_permutevar8x32_ps(dots, order);
+
+            int mask = _mm256_movemask_ps(_mm256_cmp_ps(dots, _mm256_setzero_ps(), _CMP_GT_OQ));
+            for (size_t f = 0; f < 8; ++f)
+                lightFacings[f] = static_cast<char>((mask >> f) & 1);
+
+            faceNormals += 8;
+            lightFacings += 8;
+        }
+        _mm256_zeroupper();
+
+        if (numFaces)
+        {
+            mFallback->calculateLightFacing(lightPos, faceNormals, lightFacings, numFaces);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::extrudeVertices(
+        const Vector4& lightPos,
+        Real extrudeDist,
+        const float* pSrcPos,
+        float* pDestPos,
+        size_t numVertices)
+    {
+        size_t numIterations = numVertices / 8;
+        numVertices &= 7;
+
+        if (lightPos.w == 0.0f)
+        {
+            // Directional light, extrusion is along light direction
+            Vector3 extrusionDir(-lightPos.x, -lightPos.y, -lightPos.z);
+            extrusionDir.normalise();
+            extrusionDir *= extrudeDist;
+            const float ex = extrusionDir.x, ey = extrusionDir.y, ez = extrusionDir.z;
+
+            // Eight packed vertices are three registers, the direction
+            // repeats with the same period
+            const __m256 d0 = _mm256_setr_ps(ex, ey, ez, ex, ey, ez, ex, ey);
+            const __m256 d1 = _mm256_setr_ps(ez, ex, ey, ez, ex, ey, ez, ex);
+            const __m256 d2 = _mm256_setr_ps(ey, ez, ex, ey, ez, ex, ey, ez);
+
+            for (size_t i = 0; i < numIterations; ++i)
+            {
+                _mm256_storeu_ps(pDestPos + 0, _mm256_add_ps(_mm256_loadu_ps(pSrcPos + 0), d0));
+                _mm256_storeu_ps(pDestPos + 8, _mm256_add_ps(_mm256_loadu_ps(pSrcPos + 8), d1));
+                _mm256_storeu_ps(pDestPos + 16, _mm256_add_ps(_mm256_loadu_ps(pSrcPos + 16), d2));
+
+                pSrcPos += 24;
+                pDestPos += 24;
+            }
+        }
+        else
+        {
+            // Point light, calculate extrusionDir for every vertex
+            assert(lightPos.w == 1.0f);
+
+            const __m256i offsets = gatherOffsets(3 * sizeof(float));
+            const __m256 lx = _mm256_set1_ps(lightPos.x);
+            const __m256 ly = _mm256_set1_ps(lightPos.y);
+            const __m256 lz = _mm256_set1_ps(lightPos.z);
+            const __m256 dist = _mm256_set1_ps(extrudeDist);
+
+            for (size_t i = 0; i < numIterations; ++i)
+            {
+                __m256 x, y, z;
+                loadVector3x8(pSrcPos, offsets, x, y, z);
+                __m256 dx = _mm256_sub_ps(x, lx);
+                __m256 dy = _mm256_sub_ps(y, ly);
+                __m256 dz = _mm256_sub_ps(z, lz);
+                normaliseVector3x8(dx, dy, dz);
+                storeVector3x8(pDestPos, 3 * sizeof(float),
+                    _mm256_fmadd_ps(dx, dist, x),
+                    _mm256_fmadd_ps(dy, dist, y),
+                    _mm256_fmadd_ps(dz, dist, z));
+
+                pSrcPos += 24;
+                pDestPos += 24;
+            }
+        }
+        _mm256_zeroupper();
+
+        if (numVertices)
+        {
+            mFallback->extrudeVertices(lightPos, extrudeDist, pSrcPos, pDestPos, numVertices);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::cullBoxes(
+        const Plane* planes, size_t numPlanes,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+        uint8* results, size_t numBoxes)
+    {
+        // Mask clearing the sign bit, for absolute values
+        const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+
+        size_t numIterations = numBoxes / 8;
+        numBoxes &= 7;
+
+        // Eight boxes per iteration, against one plane at a time
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m256 cx = _mm256_loadu_ps(centreX);
+            __m256 cy = _mm256_loadu_ps(centreY);
+            __m256 cz = _mm256_loadu_ps(centreZ);
+            __m256 hx = _mm256_loadu_ps(halfSizeX);
+            __m256 hy = _mm256_loadu_ps(halfSizeY);
+            __m256 hz = _mm256_loadu_ps(halfSizeZ);
+
+            __m256 outside = _mm256_setzero_ps();
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                const Plane& plane = planes[p];
+                __m256 nx = _mm256_set1_ps(plane.normal.x);
+                __m256 ny = _mm256_set1_ps(plane.normal.y);
+                __m256 nz = _mm256_set1_ps(plane.normal.z);
+
+                // dist = n . centre + d
+                __m256 dist = _mm256_fmadd_ps(nx, cx, _mm256_fmadd_ps(ny, cy,
+                    _mm256_fmadd_ps(nz, cz, _mm256_set1_ps(plane.d))));
+                // maxAbsDist = |n| . halfSize, half sizes are never negative
+                __m256 maxAbsDist = _mm256_fmadd_ps(_mm256_and_ps(nx, absMask), hx,
+                    _mm256_fmadd_ps(_mm256_and_ps(ny, absMask), hy,
+                    _mm256_mul_ps(_mm256_and_ps(nz, absMask), hz)));
+
+                outside = _mm256_or_ps(outside, _mm256_cmp_ps(dist,
+                    _mm256_sub_ps(_mm256_setzero_ps(), maxAbsDist), _CMP_LT_OQ));
+            }
+
+            int mask = _mm256_movemask_ps(outside);
+            for (size_t b = 0; b < 8; ++b)
+                results[b] = !(mask & (1 << b));
+
+            centreX += 8; centreY += 8; centreZ += 8;
+            halfSizeX += 8; halfSizeY += 8; halfSizeZ += 8;
+            results += 8;
+        }
+        _mm256_zeroupper();
+
+        // Left over boxes
+        if (numBoxes)
+        {
+            mFallback->cullBoxes(planes, numPlanes,
+                centreX, centreY, centreZ, halfSizeX, halfSizeY, halfSizeZ,
+                results, numBoxes);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::nlerpQuaternions(
+        const float* t,
+        const float* src1, const float* src2,
+        float* dest, size_t numQuaternions)
+    {
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        const __m256 half = _mm256_set1_ps(0.5f);
+        const __m256 three = _mm256_set1_ps(3.0f);
+        // Order of the quaternions once transposed, see transposeLanes4x4
+        const __m256i evenOdd = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+
+        size_t numIterations = numQuaternions / 8;
+        numQuaternions &= 7;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m256 w1 = _mm256_loadu_ps(src1 + 0);
+            __m256 x1 = _mm256_loadu_ps(src1 + 8);
+            __m256 y1 = _mm256_loadu_ps(src1 + 16);
+            __m256 z1 = _mm256_loadu_ps(src1 + 24);
+            transposeLanes4x4(w1, x1, y1, z1);
+
+            __m256 w2 = _mm256_loadu_ps(src2 + 0);
+            __m256 x2 = _mm256_loadu_ps(src2 + 8);
+            __m256 y2 = _mm256_loadu_ps(src2 + 16);
+            __m256 z2 = _mm256_loadu_ps(src2 + 24);
+            transposeLanes4x4(w2, x2, y2, z2);
+
+            // Flip the second to the nearest rotation, by the sign of the dot product
+            __m256 dot = _mm256_fmadd_ps(w1, w2, _mm256_fmadd_ps(x1, x2,
+                _mm256_fmadd_ps(y1, y2, _mm256_mul_ps(z1, z2))));
+            __m256 flip = _mm256_and_ps(dot, signMask);
+            w2 = _mm256_xor_ps(w2, flip);
+            x2 = _mm256_xor_ps(x2, flip);
+            y2 = _mm256_xor_ps(y2, flip);
+            z2 = _mm256_xor_ps(z2, flip);
+
+            __m256 f = _mm256_permutevar8x32_ps(_mm256_loadu_ps(t), evenOdd);
+            __m256 w = _mm256_fmadd_ps(f, _mm256_sub_ps(w2, w1), w1);
+            __m256 x = _mm256_fmadd_ps(f, _mm256_sub_ps(x2, x1), x1);
+            __m256 y = _mm256_fmadd_ps(f, _mm256_sub_ps(y2, y1), y1);
+            __m256 z = _mm256_fmadd_ps(f, _mm256_sub_ps(z2, z1), z1);
+
+            // rsqrt with a Newton-Raphson step, like __mm_rsqrt_nr_ps
+            __m256 len = _mm256_fmadd_ps(w, w, _mm256_fmadd_ps(x, x,
+                _mm256_fmadd_ps(y, y, _mm256_mul_ps(z, z))));
+            __m256 r = _mm256_rsqrt_ps(len);
+            __m256 factor = _mm256_mul_ps(_mm256_mul_ps(half, r),
+                _mm256_fnmadd_ps(_mm256_mul_ps(len, r), r, three));
+            w = _mm256_mul_ps(w, factor);
+            x = _mm256_mul_ps(x, factor);
+            y = _mm256_mul_ps(y, factor);
+            z = _mm256_mul_ps(z, factor);
+
+            transposeLanes4x4(w, x, y, z);
+            _mm256_storeu_ps(dest + 0, w);
+            _mm256_storeu_ps(dest + 8, x);
+            _mm256_storeu_ps(dest + 16, y);
+            _mm256_storeu_ps(dest + 24, z);
+
+            t += 8;
+            src1 += 32;
+            src2 += 32;
+            dest += 32;
+        }
+        _mm256_zeroupper();
+
+        // Left over quaternions
+        if (numQuaternions)
+        {
+            mFallback->nlerpQuaternions(t, src1, src2, dest, numQuaternions);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::shufflePixels(
+        const uint8* src, size_t srcPixelSize,
+        uint8* dest, size_t destPixelSize,
+        const int8* shuffle, size_t numPixels)
+    {
+        // Byte shuffle controls for as many pixels as fit in 16 bytes on both
+        // sides, 0x80 clears a byte, which the fill then sets
+        uint8 control[16], fill[16];
+        size_t pixelsPerShuffle = 16 / std::max(srcPixelSize, destPixelSize);
+        for (size_t i = 0; i < 16; ++i)
+        {
+            control[i] = 0x80;
+            fill[i] = 0;
+        }
+        for (size_t p = 0; p < pixelsPerShuffle; ++p)
+        {
+            for (size_t b = 0; b < destPixelSize; ++b)
+            {
+                if (shuffle[b] < 0)
+                    fill[p * destPixelSize + b] = 0xFF;
+                else
+                    control[p * destPixelSize + b] = static_cast<uint8>(p * srcPixelSize + shuffle[b]);
+            }
+        }
+        __m128i control128 = _mm_loadu_si128((const __m128i*)control);
+        __m128i fill128 = _mm_loadu_si128((const __m128i*)fill);
+
+        if (srcPixelSize == 4 && destPixelSize == 4)
+        {
+            // Shuffles stay within 128-bit lanes, so the same control does for both
+            __m256i control256 = _mm256_broadcastsi128_si256(control128);
+            __m256i fill256 = _mm256_broadcastsi128_si256(fill128);
+            size_t numIterations = numPixels / 8;
+            numPixels &= 7;
+
+            for (size_t i = 0; i < numIterations; ++i)
+            {
+                __m256i x = _mm256_loadu_si256((const __m256i*)src);
+                _mm256_storeu_si256((__m256i*)dest,
+                    _mm256_or_si256(_mm256_shuffle_epi8(x, control256), fill256));
+                src += 32;
+                dest += 32;
+            }
+            _mm256_zeroupper();
+        }
+        else if (srcPixelSize == 1 && destPixelSize == 4)
+        {
+            // Widened to 32 bits each pixel is a 4 byte one with its value in the first byte
+            for (size_t i = 0; i < 16; ++i)
+            {
+                if (control[i] != 0x80)
+                    control[i] = static_cast<uint8>(i & ~3);
+            }
+            __m256i control256 = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128((const __m128i*)control));
+            __m256i fill256 = _mm256_broadcastsi128_si256(fill128);
+            size_t numIterations = numPixels / 8;
+            numPixels &= 7;
+
+            for (size_t i = 0; i < numIterations; ++i)
+            {
+                __m256i x = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)src));
+                _mm256_storeu_si256((__m256i*)dest,
+                    _mm256_or_si256(_mm256_shuffle_epi8(x, control256), fill256));
+                src += 8;
+                dest += 32;
+            }
+            _mm256_zeroupper();
+        }
+        else if (srcPixelSize == 3 && destPixelSize == 4)
+        {
+            // Four pixels from 12 of the 16 bytes loaded, stopping while the
+            // loads are still within the source
+            while (numPixels >= 6)
+            {
+                __m128i x = _mm_loadu_si128((const __m128i*)src);
+                _mm_storeu_si128((__m128i*)dest,
+                    _mm_or_si128(_mm_shuffle_epi8(x, control128), fill128));
+                src += 12;
+                dest += 16;
+                numPixels -= 4;
+            }
+        }
+        else if (srcPixelSize == 4 && destPixelSize == 3)
+        {
+            // Four pixels to 12 bytes, stored as 8 then 4 so nothing past them is touched
+            while (numPixels >= 4)
+            {
+                __m128i x = _mm_or_si128(_mm_shuffle_epi8(
+                    _mm_loadu_si128((const __m128i*)src), control128), fill128);
+                _mm_storel_epi64((__m128i*)dest, x);
+                *(int*)(dest + 8) = _mm_cvtsi128_si32(_mm_srli_si128(x, 8));
+                src += 16;
+                dest += 12;
+                numPixels -= 4;
+            }
+        }
+
+        // Left over pixels, or other pixel sizes
+        if (numPixels)
+        {
+            mFallback->shufflePixels(src, srcPixelSize,
+                dest, destPixelSize, shuffle, numPixels);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::convertHalfToFloat(
+        const uint16* src, float* dest, size_t count)
+    {
+#if __OGRE_HAVE_F16C
+        if (mHasF16C)
+        {
+            const __m256i expMantMask = _mm256_set1_epi32(0x7FFF);
+            const __m256i infinity = _mm256_set1_epi32(0x7C00);
+            const __m256i quietBit = _mm256_set1_epi32(0x00400000);
+
+            size_t numIterations = count / 8;
+            count &= 7;
+
+            for (size_t i = 0; i < numIterations; ++i)
+            {
+                __m128i h = _mm_loadu_si128((const __m128i*)src);
+                __m256i f = _mm256_castps_si256(_mm256_cvtph_ps(h));
+
+                // The conversion sets the quiet bit of NaNs, Bitwise::halfToFloat
+                // copies it from the half instead
+                __m256i h32 = _mm256_cvtepu16_epi32(h);
+                __m256i isNaN = _mm256_cmpgt_epi32(_mm256_and_si256(h32, expMantMask), infinity);
+                __m256i fix = _mm256_and_si256(isNaN, quietBit);
+                f = _mm256_andnot_si256(fix, f);
+                f = _mm256_or_si256(f, _mm256_and_si256(fix, _mm256_slli_epi32(h32, 13)));
+                _mm256_storeu_ps(dest, _mm256_castsi256_ps(f));
+
+                src += 8;
+                dest += 8;
+            }
+        }
+#endif
+
+        // Left over values, or no F16C
+        if (count)
+        {
+            mFallback->convertHalfToFloat(src, dest, count);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::convertFloatToHalf(
+        const float* src, uint16* dest, size_t count)
+    {
+#if __OGRE_HAVE_F16C
+        if (mHasF16C)
+        {
+            const __m256i absMask = _mm256_set1_epi32(0x7FFFFFFF);
+            const __m256i smallest = _mm256_set1_epi32(0x33000000);
+            const __m256i largest = _mm256_set1_epi32(0x477FFFFF);
+            const __m256i infinity = _mm256_set1_epi32(0x7F800000);
+            const __m256i halfInfinity = _mm256_set1_epi32(0x7C00);
+            const __m256i signMask = _mm256_set1_epi32(0x8000);
+            const __m256i mantMask = _mm256_set1_epi32(0x03FF);
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i one = _mm256_set1_epi32(1);
+
+            size_t numIterations = count / 8;
+            count &= 7;
+
+            for (size_t i = 0; i < numIterations; ++i)
+            {
+                __m256 f = _mm256_loadu_ps(src);
+                // Truncating, like Bitwise::floatToHalf
+                __m128i h = _mm256_cvtps_ph(f, _MM_FROUND_TO_ZERO);
+
+                // Patch up the cases where truncation differs from Bitwise:
+                // overflow gives infinity rather than the largest half, tiny
+                // values lose their sign, and NaNs keep their quiet bit
+                __m256i x = _mm256_castps_si256(f);
+                __m256i absX = _mm256_and_si256(x, absMask);
+                __m256i isTiny = _mm256_cmpgt_epi32(smallest, absX);
+                __m256i isLarge = _mm256_cmpgt_epi32(absX, largest);
+                __m256i isNaN = _mm256_cmpgt_epi32(absX, infinity);
+
+                __m256i mant = _mm256_and_si256(_mm256_srli_epi32(x, 13), mantMask);
+                mant = _mm256_or_si256(mant, _mm256_and_si256(_mm256_cmpeq_epi32(mant, zero), one));
+                __m256i fix = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(x, 16), signMask),
+                    _mm256_or_si256(halfInfinity, _mm256_and_si256(isNaN, mant)));
+                fix = _mm256_and_si256(fix, isLarge);
+                __m256i useFix = _mm256_or_si256(isTiny, isLarge);
+
+                __m128i fix16 = _mm_packus_epi32(
+                    _mm256_castsi256_si128(fix), _mm256_extracti128_si256(fix, 1));
+                __m128i useFix16 = _mm_packs_epi32(
+                    _mm256_castsi256_si128(useFix), _mm256_extracti128_si256(useFix, 1));
+                _mm_storeu_si128((__m128i*)dest, _mm_blendv_epi8(h, fix16, useFix16));
+
+                src += 8;
+                dest += 8;
+            }
+        }
+#endif
+
+        // Left over values, or no F16C
+        if (count)
+        {
+            mFallback->convertFloatToHalf(src, dest, count);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::sumWeightedRows(
+        const float* const* rows, const float* weights, size_t numRows,
+        float* dest, size_t count)
+    {
+        size_t numIterations = count / 16;
+        size_t i = 0;
+
+        for (size_t n = 0; n < numIterations; ++n, i += 16)
+        {
+            __m256 w = _mm256_broadcast_ss(weights);
+            __m256 sum0 = _mm256_mul_ps(w, _mm256_loadu_ps(rows[0] + i));
+            __m256 sum1 = _mm256_mul_ps(w, _mm256_loadu_ps(rows[0] + i + 8));
+            for (size_t k = 1; k < numRows; ++k)
+            {
+                w = _mm256_broadcast_ss(weights + k);
+                sum0 = _mm256_fmadd_ps(w, _mm256_loadu_ps(rows[k] + i), sum0);
+                sum1 = _mm256_fmadd_ps(w, _mm256_loadu_ps(rows[k] + i + 8), sum1);
+            }
+            _mm256_storeu_ps(dest + i, sum0);
+            _mm256_storeu_ps(dest + i + 8, sum1);
+        }
+
+        // Left over values, the rows can't be offset for the fallback
+        for (; i < count; ++i)
+        {
+            float sum = weights[0] * rows[0][i];
+            for (size_t k = 1; k < numRows; ++k)
+                sum += weights[k] * rows[k][i];
+            dest[i] = sum;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::convertFloatToByte(
+        const float* src, uint8* dest, size_t count)
+    {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 maximum = _mm256_set1_ps(255.0f);
+        const __m256 half = _mm256_set1_ps(0.5f);
+        // Packing works within 128-bit lanes, this puts the groups of four back in order
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+        size_t numIterations = count / 32;
+        count &= 31;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m256i v[4];
+            for (size_t j = 0; j < 4; ++j)
+            {
+                // max returns its second operand for NaNs, so they become zero
+                __m256 f = _mm256_max_ps(_mm256_loadu_ps(src + j * 8), zero);
+                f = _mm256_add_ps(_mm256_min_ps(f, maximum), half);
+                v[j] = _mm256_cvttps_epi32(f);
+            }
+            __m256i shorts0 = _mm256_packs_epi32(v[0], v[1]);
+            __m256i shorts1 = _mm256_packs_epi32(v[2], v[3]);
+            __m256i bytes = _mm256_packus_epi16(shorts0, shorts1);
+            _mm256_storeu_si256((__m256i*)dest, _mm256_permutevar8x32_epi32(bytes, order));
+
+            src += 32;
+            dest += 32;
+        }
+
+        // Left over values
+        if (count)
+        {
+            mFallback->convertFloatToByte(src, dest, count);
+        }
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    extern OptimisedUtil* _getOptimisedUtilAVX2(void)
+    {
+        static OptimisedUtilAVX2 msOptimisedUtilAVX2;
+        return &msOptimisedUtilAVX2;
+    }
+
+#else // !__OGRE_HAVE_AVX2
+
+    extern OptimisedUtil* _getOptimisedUtilAVX2(void)
+    {
+        // Not built with AVX2 code generation, the SSE version is used instead
+        return 0;
+    }
+
+#endif // __OGRE_HAVE_AVX2
+
+}
+
+#endif // __OGRE_HAVE_SSE
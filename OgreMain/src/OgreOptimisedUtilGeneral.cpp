@@ -31,6 +31,12 @@ THE SOFTWARE.
 
 #include "OgreVector3.h"
 #include "OgreMatrix4.h"
+#include "OgreDualQuaternion.h"
+#include "OgrePlane.h"
+#include "OgreAxisAlignedBox.h"
+#include "OgreSphere.h"
+#include "OgreRay.h"
+#include "OgreBitwise.h"
 
 namespace Ogre {
 
@@ -57,6 +63,18 @@ namespace Ogre {
             size_t numWeightsPerVertex,
             size_t numVertices);
 
+        /// @copydoc OptimisedUtil::softwareVertexSkinningDualQuaternion
+        virtual void softwareVertexSkinningDualQuaternion(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const DualQuaternion* const* blendDualQuaternions,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices);
+
         /// @copydoc OptimisedUtil::softwareVertexMorph
         virtual void softwareVertexMorph(
             Real t,
@@ -73,6 +91,20 @@ namespace Ogre {
             Matrix4* dstMatrices,
             size_t numMatrices);
 
+        /// @copydoc OptimisedUtil::transformPoints
+        virtual void transformPoints(
+            const Matrix4& matrix,
+            const float* srcPtr, float* destPtr,
+            size_t srcStride, size_t destStride,
+            size_t numPoints);
+
+        /// @copydoc OptimisedUtil::transformDirections
+        virtual void transformDirections(
+            const Matrix4& matrix,
+            const float* srcPtr, float* destPtr,
+            size_t srcStride, size_t destStride,
+            size_t numDirections, bool normalise);
+
         /// @copydoc OptimisedUtil::calculateFaceNormals
         virtual void calculateFaceNormals(
             const float *positions,
@@ -94,6 +126,77 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::cullBoxes
+        virtual void cullBoxes(
+            const Plane* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::cullSpheres
+        virtual void cullSpheres(
+            const Plane* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* radius,
+            uint8* results, size_t numSpheres);
+
+        /// @copydoc OptimisedUtil::intersectBoxes(const AxisAlignedBox&,const float*,const float*,const float*,const float*,const float*,const float*,uint8*,size_t)
+        virtual void intersectBoxes(
+            const AxisAlignedBox& box,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::intersectBoxes(const Sphere&,const float*,const float*,const float*,const float*,const float*,const float*,uint8*,size_t)
+        virtual void intersectBoxes(
+            const Sphere& sphere,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::intersectBoxes(const Ray&,const float*,const float*,const float*,const float*,const float*,const float*,float*,uint8*,size_t)
+        virtual void intersectBoxes(
+            const Ray& ray,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            float* distances, uint8* results, size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::intersectSpheres
+        virtual void intersectSpheres(
+            const Sphere& sphere,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* radius,
+            uint8* results, size_t numSpheres);
+
+        /// @copydoc OptimisedUtil::nlerpQuaternions
+        virtual void nlerpQuaternions(
+            const float* t,
+            const float* src1, const float* src2,
+            float* dest, size_t numQuaternions);
+
+        /// @copydoc OptimisedUtil::shufflePixels
+        virtual void shufflePixels(
+            const uint8* src, size_t srcPixelSize,
+            uint8* dest, size_t destPixelSize,
+            const int8* shuffle, size_t numPixels);
+
+        /// @copydoc OptimisedUtil::convertHalfToFloat
+        virtual void convertHalfToFloat(
+            const uint16* src, float* dest, size_t count);
+
+        /// @copydoc OptimisedUtil::convertFloatToHalf
+        virtual void convertFloatToHalf(
+            const float* src, uint16* dest, size_t count);
+
+        /// @copydoc OptimisedUtil::sumWeightedRows
+        virtual void sumWeightedRows(
+            const float* const* rows, const float* weights, size_t numRows,
+            float* dest, size_t count);
+
+        /// @copydoc OptimisedUtil::convertFloatToByte
+        virtual void convertFloatToByte(
+            const float* src, uint8* dest, size_t count);
     };
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
@@ -221,6 +324,88 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::softwareVertexSkinningDualQuaternion(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const DualQuaternion* const* blendDualQuaternions,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        for (size_t vertIdx = 0; vertIdx < numVertices; ++vertIdx)
+        {
+            // Blend the dual quaternions, flipping those in the opposite
+            // hemisphere to the first so the shortest rotation is taken
+            const DualQuaternion& first = *blendDualQuaternions[pBlendIndex[0]];
+            Real rw = 0, rx = 0, ry = 0, rz = 0, dw = 0, dx = 0, dy = 0, dz = 0;
+            for (size_t blendIdx = 0; blendIdx < numWeightsPerVertex; ++blendIdx)
+            {
+                // NB weights must be normalised!!
+                Real weight = pBlendWeight[blendIdx];
+                if (weight)
+                {
+                    const DualQuaternion& dq = *blendDualQuaternions[pBlendIndex[blendIdx]];
+                    if (dq.w * first.w + dq.x * first.x + dq.y * first.y + dq.z * first.z < 0)
+                        weight = -weight;
+                    rw += dq.w * weight;
+                    rx += dq.x * weight;
+                    ry += dq.y * weight;
+                    rz += dq.z * weight;
+                    dw += dq.dw * weight;
+                    dx += dq.dx * weight;
+                    dy += dq.dy * weight;
+                    dz += dq.dz * weight;
+                }
+            }
+
+            // Normalise by the length of the rotation part
+            Real invLength = 1 / Math::Sqrt(std::max(rw * rw + rx * rx + ry * ry + rz * rz, Real(1e-30)));
+            rw *= invLength;
+            rx *= invLength;
+            ry *= invLength;
+            rz *= invLength;
+            dw *= invLength;
+            dx *= invLength;
+            dy *= invLength;
+            dz *= invLength;
+
+            // Rotate the position, p + 2 r x (r x p + w p), then translate
+            // by 2 (w d - dw r + r x d)
+            Real px = pSrcPos[0], py = pSrcPos[1], pz = pSrcPos[2];
+            Real tx = ry * pz - rz * py + rw * px;
+            Real ty = rz * px - rx * pz + rw * py;
+            Real tz = rx * py - ry * px + rw * pz;
+            Real ox = ry * tz - rz * ty + rw * dx - dw * rx + ry * dz - rz * dy;
+            Real oy = rz * tx - rx * tz + rw * dy - dw * ry + rz * dx - rx * dz;
+            Real oz = rx * ty - ry * tx + rw * dz - dw * rz + rx * dy - ry * dx;
+            pDestPos[0] = static_cast<float>(px + 2 * ox);
+            pDestPos[1] = static_cast<float>(py + 2 * oy);
+            pDestPos[2] = static_cast<float>(pz + 2 * oz);
+
+            if (pSrcNorm)
+            {
+                // Rotation only, which keeps unit normals unit length
+                Real nx = pSrcNorm[0], ny = pSrcNorm[1], nz = pSrcNorm[2];
+                tx = ry * nz - rz * ny + rw * nx;
+                ty = rz * nx - rx * nz + rw * ny;
+                tz = rx * ny - ry * nx + rw * nz;
+                pDestNorm[0] = static_cast<float>(nx + 2 * (ry * tz - rz * ty));
+                pDestNorm[1] = static_cast<float>(ny + 2 * (rz * tx - rx * tz));
+                pDestNorm[2] = static_cast<float>(nz + 2 * (rx * ty - ry * tx));
+                advanceRawPointer(pSrcNorm, srcNormStride);
+                advanceRawPointer(pDestNorm, destNormStride);
+            }
+
+            advanceRawPointer(pSrcPos, srcPosStride);
+            advanceRawPointer(pDestPos, destPosStride);
+            advanceRawPointer(pBlendWeight, blendWeightStride);
+            advanceRawPointer(pBlendIndex, blendIndexStride);
+        }
+    }
+    //---------------------------------------------------------------------
     void OptimisedUtilGeneral::concatenateAffineMatrices(
         const Matrix4& baseMatrix,
         const Matrix4* pSrcMat,
@@ -310,6 +495,56 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::transformPoints(
+        const Matrix4& m,
+        const float* pSrc, float* pDest,
+        size_t srcStride, size_t destStride,
+        size_t numPoints)
+    {
+        for (size_t i = 0; i < numPoints; ++i)
+        {
+            Real x = pSrc[0], y = pSrc[1], z = pSrc[2];
+            pDest[0] = static_cast<float>(m[0][0] * x + m[0][1] * y + m[0][2] * z + m[0][3]);
+            pDest[1] = static_cast<float>(m[1][0] * x + m[1][1] * y + m[1][2] * z + m[1][3]);
+            pDest[2] = static_cast<float>(m[2][0] * x + m[2][1] * y + m[2][2] * z + m[2][3]);
+
+            advanceRawPointer(pSrc, srcStride);
+            advanceRawPointer(pDest, destStride);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::transformDirections(
+        const Matrix4& m,
+        const float* pSrc, float* pDest,
+        size_t srcStride, size_t destStride,
+        size_t numDirections, bool normalise)
+    {
+        for (size_t i = 0; i < numDirections; ++i)
+        {
+            Real x = pSrc[0], y = pSrc[1], z = pSrc[2];
+            Real dx = m[0][0] * x + m[0][1] * y + m[0][2] * z;
+            Real dy = m[1][0] * x + m[1][1] * y + m[1][2] * z;
+            Real dz = m[2][0] * x + m[2][1] * y + m[2][2] * z;
+            if (normalise)
+            {
+                Real length = Math::Sqrt(dx * dx + dy * dy + dz * dz);
+                if (length > 0)
+                {
+                    Real invLength = 1 / length;
+                    dx *= invLength;
+                    dy *= invLength;
+                    dz *= invLength;
+                }
+            }
+            pDest[0] = static_cast<float>(dx);
+            pDest[1] = static_cast<float>(dy);
+            pDest[2] = static_cast<float>(dz);
+
+            advanceRawPointer(pSrc, srcStride);
+            advanceRawPointer(pDest, destStride);
+        }
+    }
+    //---------------------------------------------------------------------
     void OptimisedUtilGeneral::calculateFaceNormals(
         const float *positions,
         const EdgeData::Triangle *triangles,
@@ -392,6 +627,239 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::cullBoxes(
+        const Plane* planes, size_t numPlanes,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+        uint8* results, size_t numBoxes)
+    {
+        for (size_t i = 0; i < numBoxes; ++i)
+        {
+            uint8 result = 1;
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                const Plane& plane = planes[p];
+                // Same test as Plane::getSide(centre, halfSize)
+                Real dist = plane.normal.x * centreX[i] + plane.normal.y * centreY[i] +
+                    plane.normal.z * centreZ[i] + plane.d;
+                Real maxAbsDist = Math::Abs(plane.normal.x * halfSizeX[i]) +
+                    Math::Abs(plane.normal.y * halfSizeY[i]) +
+                    Math::Abs(plane.normal.z * halfSizeZ[i]);
+                if (dist < -maxAbsDist)
+                {
+                    result = 0;
+                    break;
+                }
+            }
+            results[i] = result;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::cullSpheres(
+        const Plane* planes, size_t numPlanes,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* radius,
+        uint8* results, size_t numSpheres)
+    {
+        for (size_t i = 0; i < numSpheres; ++i)
+        {
+            uint8 result = 1;
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                const Plane& plane = planes[p];
+                // Same test as Frustum::isVisible(const Sphere&)
+                Real dist = plane.normal.x * centreX[i] + plane.normal.y * centreY[i] +
+                    plane.normal.z * centreZ[i] + plane.d;
+                if (dist < -radius[i])
+                {
+                    result = 0;
+                    break;
+                }
+            }
+            results[i] = result;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::intersectBoxes(
+        const AxisAlignedBox& box,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+        uint8* results, size_t numBoxes)
+    {
+        const Vector3 centre = box.getCenter();
+        const Vector3 halfSize = box.getHalfSize();
+
+        for (size_t i = 0; i < numBoxes; ++i)
+        {
+            // Separated on no axis
+            results[i] =
+                Math::Abs(centreX[i] - centre.x) <= halfSizeX[i] + halfSize.x &&
+                Math::Abs(centreY[i] - centre.y) <= halfSizeY[i] + halfSize.y &&
+                Math::Abs(centreZ[i] - centre.z) <= halfSizeZ[i] + halfSize.z;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::intersectBoxes(
+        const Sphere& sphere,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+        uint8* results, size_t numBoxes)
+    {
+        const Vector3& centre = sphere.getCenter();
+        const Real radiusSq = Math::Sqr(sphere.getRadius());
+
+        for (size_t i = 0; i < numBoxes; ++i)
+        {
+            // Distance from the sphere centre to the box along each axis
+            Real dx = std::max(Math::Abs(centreX[i] - centre.x) - halfSizeX[i], Real(0));
+            Real dy = std::max(Math::Abs(centreY[i] - centre.y) - halfSizeY[i], Real(0));
+            Real dz = std::max(Math::Abs(centreZ[i] - centre.z) - halfSizeZ[i], Real(0));
+            results[i] = dx * dx + dy * dy + dz * dz <= radiusSq;
+        }
+    }
+    //---------------------------------------------------------------------
+    /// Clip the ray interval [tNear, tFar] against one slab of a box
+    static inline void clipRaySlab(Real centre, Real halfSize, Real origin, Real invDir,
+        Real& tNear, Real& tFar)
+    {
+        Real t1 = (centre - halfSize - origin) * invDir;
+        Real t2 = (centre + halfSize - origin) * invDir;
+        if (t1 > t2)
+            std::swap(t1, t2);
+        // A ray lying in a slab face gives NaN, which fails both tests
+        if (t1 > tNear)
+            tNear = t1;
+        if (t2 < tFar)
+            tFar = t2;
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::intersectBoxes(
+        const Ray& ray,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+        float* distances, uint8* results, size_t numBoxes)
+    {
+        const Vector3& origin = ray.getOrigin();
+        const Vector3& dir = ray.getDirection();
+        // Axes the ray is parallel to give infinities, which the slab test handles
+        const Vector3 invDir(1 / dir.x, 1 / dir.y, 1 / dir.z);
+
+        for (size_t i = 0; i < numBoxes; ++i)
+        {
+            Real tNear = 0;
+            Real tFar = std::numeric_limits<Real>::infinity();
+            clipRaySlab(centreX[i], halfSizeX[i], origin.x, invDir.x, tNear, tFar);
+            clipRaySlab(centreY[i], halfSizeY[i], origin.y, invDir.y, tNear, tFar);
+            clipRaySlab(centreZ[i], halfSizeZ[i], origin.z, invDir.z, tNear, tFar);
+            distances[i] = tNear;
+            results[i] = tNear <= tFar;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::intersectSpheres(
+        const Sphere& sphere,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* radius,
+        uint8* results, size_t numSpheres)
+    {
+        const Vector3& centre = sphere.getCenter();
+
+        for (size_t i = 0; i < numSpheres; ++i)
+        {
+            // Same test as Sphere::intersects(const Sphere&)
+            Real dx = centreX[i] - centre.x;
+            Real dy = centreY[i] - centre.y;
+            Real dz = centreZ[i] - centre.z;
+            results[i] = dx * dx + dy * dy + dz * dz <= Math::Sqr(radius[i] + sphere.getRadius());
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::nlerpQuaternions(
+        const float* t,
+        const float* src1, const float* src2,
+        float* dest, size_t numQuaternions)
+    {
+        for (size_t i = 0; i < numQuaternions; ++i)
+        {
+            // Same as Quaternion::nlerp, interpolating to the nearest rotation
+            float w1 = src1[0], x1 = src1[1], y1 = src1[2], z1 = src1[3];
+            float w2 = src2[0], x2 = src2[1], y2 = src2[2], z2 = src2[3];
+            if (w1 * w2 + x1 * x2 + y1 * y2 + z1 * z2 < 0.0f)
+            {
+                w2 = -w2; x2 = -x2; y2 = -y2; z2 = -z2;
+            }
+
+            float w = w1 + t[i] * (w2 - w1);
+            float x = x1 + t[i] * (x2 - x1);
+            float y = y1 + t[i] * (y2 - y1);
+            float z = z1 + t[i] * (z2 - z1);
+            float factor = 1.0f / Math::Sqrt(w * w + x * x + y * y + z * z);
+
+            dest[0] = w * factor;
+            dest[1] = x * factor;
+            dest[2] = y * factor;
+            dest[3] = z * factor;
+
+            src1 += 4;
+            src2 += 4;
+            dest += 4;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::shufflePixels(
+        const uint8* src, size_t srcPixelSize,
+        uint8* dest, size_t destPixelSize,
+        const int8* shuffle, size_t numPixels)
+    {
+        for (size_t i = 0; i < numPixels; ++i)
+        {
+            for (size_t b = 0; b < destPixelSize; ++b)
+                dest[b] = shuffle[b] < 0 ? 0xFF : src[shuffle[b]];
+
+            src += srcPixelSize;
+            dest += destPixelSize;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::convertHalfToFloat(
+        const uint16* src, float* dest, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            dest[i] = Bitwise::halfToFloat(src[i]);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::convertFloatToHalf(
+        const float* src, uint16* dest, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            dest[i] = Bitwise::floatToHalf(src[i]);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::sumWeightedRows(
+        const float* const* rows, const float* weights, size_t numRows,
+        float* dest, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            float sum = weights[0] * rows[0][i];
+            for (size_t k = 1; k < numRows; ++k)
+                sum += weights[k] * rows[k][i];
+            dest[i] = sum;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::convertFloatToByte(
+        const float* src, uint8* dest, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            // Written so that NaNs fail both tests and end up as zero
+            float v = src[i] > 0.0f ? src[i] : 0.0f;
+            v = v < 255.0f ? v : 255.0f;
+            dest[i] = static_cast<uint8>(v + 0.5f);
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilGeneral(void)
@@ -0,0 +1,1378 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgreOptimisedUtil.h"
+#include "OgrePlatformInformation.h"
+
+#if __OGRE_HAVE_NEON
+
+#include "OgreMatrix4.h"
+#include "OgreDualQuaternion.h"
+#include "OgrePlane.h"
+#include "OgreAxisAlignedBox.h"
+#include "OgreSphere.h"
+#include "OgreRay.h"
+
+#include <arm_neon.h>
+
+namespace Ogre {
+
+    extern OptimisedUtil* _getOptimisedUtilGeneral(void);
+
+//-------------------------------------------------------------------------
+// Local classes
+//-------------------------------------------------------------------------
+
+    /** NEON implementation of OptimisedUtil.
+    @remarks
+        Every routine works on four elements at a time. Vertex data is
+        converted to one register per component with the structure
+        load/store instructions (vld3/vst3), so packed positions need no
+        shuffling at all. Left over elements are handed to the general
+        version.
+    @note
+        Don't use this class directly, use OptimisedUtil instead.
+    */
+    class _OgrePrivate OptimisedUtilNEON : public OptimisedUtil
+    {
+    protected:
+        /// Implementation for the elements we don't handle
+        OptimisedUtil* mFallback;
+
+    public:
+        /// Constructor
+        OptimisedUtilNEON(void) : mFallback(_getOptimisedUtilGeneral()) {}
+
+        /// @copydoc OptimisedUtil::softwareVertexSkinning
+        virtual void softwareVertexSkinning(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const Matrix4* const* blendMatrices,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices);
+
+        /// @copydoc OptimisedUtil::softwareVertexSkinningDualQuaternion
+        virtual void softwareVertexSkinningDualQuaternion(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const DualQuaternion* const* blendDualQuaternions,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices);
+
+        /// @copydoc OptimisedUtil::softwareVertexMorph
+        virtual void softwareVertexMorph(
+            Real t,
+            const float *srcPos1, const float *srcPos2,
+            float *dstPos,
+            size_t pos1VSize, size_t pos2VSize, size_t dstVSize, 
+            size_t numVertices,
+            bool morphNormals);
+
+        /// @copydoc OptimisedUtil::concatenateAffineMatrices
+        virtual void concatenateAffineMatrices(
+            const Matrix4& baseMatrix,
+            const Matrix4* srcMatrices,
+            Matrix4* dstMatrices,
+            size_t numMatrices);
+
+        /// @copydoc OptimisedUtil::transformPoints
+        virtual void transformPoints(
+            const Matrix4& matrix,
+            const float* srcPtr, float* destPtr,
+            size_t srcStride, size_t destStride,
+            size_t numPoints);
+
+        /// @copydoc OptimisedUtil::transformDirections
+        virtual void transformDirections(
+            const Matrix4& matrix,
+            const float* srcPtr, float* destPtr,
+            size_t srcStride, size_t destStride,
+            size_t numDirections, bool normalise);
+
+        /// @copydoc OptimisedUtil::calculateFaceNormals
+        virtual void calculateFaceNormals(
+            const float *positions,
+            const EdgeData::Triangle *triangles,
+            Vector4 *faceNormals,
+            size_t numTriangles);
+
+        /// @copydoc OptimisedUtil::calculateLightFacing
+        virtual void calculateLightFacing(
+            const Vector4& lightPos,
+            const Vector4* faceNormals,
+            char* lightFacings,
+            size_t numFaces);
+
+        /// @copydoc OptimisedUtil::extrudeVertices
+        virtual void extrudeVertices(
+            const Vector4& lightPos,
+            Real extrudeDist,
+            const float* srcPositions,
+            float* destPositions,
+            size_t numVertices);
+
+        /// @copydoc OptimisedUtil::cullBoxes
+        virtual void cullBoxes(
+            const Plane* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::cullSpheres
+        virtual void cullSpheres(
+            const Plane* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* radius,
+            uint8* results, size_t numSpheres);
+
+        /// @copydoc OptimisedUtil::intersectBoxes(const AxisAlignedBox&,const float*,const float*,const float*,const float*,const float*,const float*,uint8*,size_t)
+        virtual void intersectBoxes(
+            const AxisAlignedBox& box,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::intersectBoxes(const Sphere&,const float*,const float*,const float*,const float*,const float*,const float*,uint8*,size_t)
+        virtual void intersectBoxes(
+            const Sphere& sphere,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::intersectBoxes(const Ray&,const float*,const float*,const float*,const float*,const float*,const float*,float*,uint8*,size_t)
+        virtual void intersectBoxes(
+            const Ray& ray,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            float* distances, uint8* results, size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::intersectSpheres
+        virtual void intersectSpheres(
+            const Sphere& sphere,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* radius,
+            uint8* results, size_t numSpheres);
+
+        /// @copydoc OptimisedUtil::nlerpQuaternions
+        virtual void nlerpQuaternions(
+            const float* t,
+            const float* src1, const float* src2,
+            float* dest, size_t numQuaternions);
+
+        /// @copydoc OptimisedUtil::shufflePixels
+        virtual void shufflePixels(
+            const uint8* src, size_t srcPixelSize,
+            uint8* dest, size_t destPixelSize,
+            const int8* shuffle, size_t numPixels);
+
+        /// @copydoc OptimisedUtil::convertHalfToFloat
+        virtual void convertHalfToFloat(
+            const uint16* src, float* dest, size_t count);
+
+        /// @copydoc OptimisedUtil::convertFloatToHalf
+        virtual void convertFloatToHalf(
+            const float* src, uint16* dest, size_t count);
+
+        /// @copydoc OptimisedUtil::sumWeightedRows
+        virtual void sumWeightedRows(
+            const float* const* rows, const float* weights, size_t numRows,
+            float* dest, size_t count);
+
+        /// @copydoc OptimisedUtil::convertFloatToByte
+        virtual void convertFloatToByte(
+            const float* src, uint8* dest, size_t count);
+    };
+
+//-------------------------------------------------------------------------
+// Local functions
+//-------------------------------------------------------------------------
+
+    /// Load four xyz vectors with the given stride in bytes into one register per component
+    static OGRE_FORCE_INLINE float32x4x3_t loadVector3x4(const float* p, size_t stride)
+    {
+        if (stride == 3 * sizeof(float))
+            return vld3q_f32(p);
+
+        float packed[12];
+        for (size_t i = 0; i < 12; i += 3)
+        {
+            packed[i + 0] = p[0];
+            packed[i + 1] = p[1];
+            packed[i + 2] = p[2];
+            advanceRawPointer(p, stride);
+        }
+        return vld3q_f32(packed);
+    }
+    //---------------------------------------------------------------------
+    /// Store four xyz vectors held one register per component with the given stride in bytes
+    static OGRE_FORCE_INLINE void storeVector3x4(float* p, size_t stride, float32x4x3_t v)
+    {
+        if (stride == 3 * sizeof(float))
+        {
+            vst3q_f32(p, v);
+            return;
+        }
+
+        float packed[12];
+        vst3q_f32(packed, v);
+        for (size_t i = 0; i < 12; i += 3)
+        {
+            p[0] = packed[i + 0];
+            p[1] = packed[i + 1];
+            p[2] = packed[i + 2];
+            advanceRawPointer(p, stride);
+        }
+    }
+    //---------------------------------------------------------------------
+    /// Normalise four vectors, leaving zero length ones alone like Vector3::normalise
+    static OGRE_FORCE_INLINE void normaliseVector3x4(float32x4x3_t& v)
+    {
+        float32x4_t lengthSq = vmlaq_f32(vmlaq_f32(
+            vmulq_f32(v.val[0], v.val[0]), v.val[1], v.val[1]), v.val[2], v.val[2]);
+
+        // Reciprocal square root estimate refined by two Newton-Raphson steps
+        float32x4_t rsqrt = vrsqrteq_f32(lengthSq);
+        rsqrt = vmulq_f32(rsqrt, vrsqrtsq_f32(vmulq_f32(lengthSq, rsqrt), rsqrt));
+        rsqrt = vmulq_f32(rsqrt, vrsqrtsq_f32(vmulq_f32(lengthSq, rsqrt), rsqrt));
+
+        float32x4_t scale = vbslq_f32(
+            vcgtq_f32(lengthSq, vdupq_n_f32(0.0f)), rsqrt, vdupq_n_f32(1.0f));
+        v.val[0] = vmulq_f32(v.val[0], scale);
+        v.val[1] = vmulq_f32(v.val[1], scale);
+        v.val[2] = vmulq_f32(v.val[2], scale);
+    }
+    //---------------------------------------------------------------------
+    /// Cross product of four pairs of vectors held one register per component
+    static OGRE_FORCE_INLINE float32x4x3_t crossVector3x4(
+        float32x4_t ax, float32x4_t ay, float32x4_t az, const float32x4x3_t& b)
+    {
+        float32x4x3_t c;
+        c.val[0] = vmlsq_f32(vmulq_f32(ay, b.val[2]), az, b.val[1]);
+        c.val[1] = vmlsq_f32(vmulq_f32(az, b.val[0]), ax, b.val[2]);
+        c.val[2] = vmlsq_f32(vmulq_f32(ax, b.val[1]), ay, b.val[0]);
+        return c;
+    }
+    //---------------------------------------------------------------------
+    /// Store the four lanes of a comparison result as 0 or 1 bytes
+    static OGRE_FORCE_INLINE void storeMask4(uint32x4_t mask, uint8* dst)
+    {
+        dst[0] = static_cast<uint8>(vgetq_lane_u32(mask, 0) & 1);
+        dst[1] = static_cast<uint8>(vgetq_lane_u32(mask, 1) & 1);
+        dst[2] = static_cast<uint8>(vgetq_lane_u32(mask, 2) & 1);
+        dst[3] = static_cast<uint8>(vgetq_lane_u32(mask, 3) & 1);
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::softwareVertexSkinning(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Matrix4* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        size_t numIterations = numVertices / 4;
+        numVertices &= 3;
+
+        // Blended 3x4 matrices, stored row by row with the four vertices of
+        // each row together, so vld4 gives one register per matrix element
+        float blended[3 * 16];
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            for (size_t v = 0; v < 4; ++v)
+            {
+                float32x4_t r0 = vdupq_n_f32(0.0f);
+                float32x4_t r1 = vdupq_n_f32(0.0f);
+                float32x4_t r2 = vdupq_n_f32(0.0f);
+                for (size_t b = 0; b < numWeightsPerVertex; ++b)
+                {
+                    // NB weights must be normalised!!
+                    float weight = pBlendWeight[b];
+                    if (weight)
+                    {
+                        const Matrix4& mat = *blendMatrices[pBlendIndex[b]];
+                        r0 = vmlaq_n_f32(r0, vld1q_f32(mat[0]), weight);
+                        r1 = vmlaq_n_f32(r1, vld1q_f32(mat[1]), weight);
+                        r2 = vmlaq_n_f32(r2, vld1q_f32(mat[2]), weight);
+                    }
+                }
+                vst1q_f32(blended + v * 4, r0);
+                vst1q_f32(blended + 16 + v * 4, r1);
+                vst1q_f32(blended + 32 + v * 4, r2);
+
+                advanceRawPointer(pBlendWeight, blendWeightStride);
+                advanceRawPointer(pBlendIndex, blendIndexStride);
+            }
+
+            // m[r].val[c] holds element [r][c] of the four blended matrices
+            float32x4x4_t m[3];
+            m[0] = vld4q_f32(blended);
+            m[1] = vld4q_f32(blended + 16);
+            m[2] = vld4q_f32(blended + 32);
+
+            float32x4x3_t src = loadVector3x4(pSrcPos, srcPosStride);
+            float32x4x3_t dst;
+            for (size_t r = 0; r < 3; ++r)
+            {
+                dst.val[r] = vmlaq_f32(vmlaq_f32(vmlaq_f32(m[r].val[3],
+                    m[r].val[0], src.val[0]), m[r].val[1], src.val[1]), m[r].val[2], src.val[2]);
+            }
+            storeVector3x4(pDestPos, destPosStride, dst);
+            advanceRawPointer(pSrcPos, 4 * srcPosStride);
+            advanceRawPointer(pDestPos, 4 * destPosStride);
+
+            if (pSrcNorm)
+            {
+                // Rotational part only, assumes no non-uniform scaling
+                src = loadVector3x4(pSrcNorm, srcNormStride);
+                for (size_t r = 0; r < 3; ++r)
+                {
+                    dst.val[r] = vmlaq_f32(vmlaq_f32(vmulq_f32(
+                        m[r].val[0], src.val[0]), m[r].val[1], src.val[1]), m[r].val[2], src.val[2]);
+                }
+                normaliseVector3x4(dst);
+                storeVector3x4(pDestNorm, destNormStride, dst);
+                advanceRawPointer(pSrcNorm, 4 * srcNormStride);
+                advanceRawPointer(pDestNorm, 4 * destNormStride);
+            }
+        }
+
+        if (numVertices)
+        {
+            mFallback->softwareVertexSkinning(
+                pSrcPos, pDestPos,
+                pSrcNorm, pDestNorm,
+                pBlendWeight, pBlendIndex,
+                blendMatrices,
+                srcPosStride, destPosStride,
+                srcNormStride, destNormStride,
+                blendWeightStride, blendIndexStride,
+                numWeightsPerVertex,
+                numVertices);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::softwareVertexSkinningDualQuaternion(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const DualQuaternion* const* blendDualQuaternions,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        size_t numIterations = numVertices / 4;
+        numVertices &= 3;
+
+        // Blended real parts of the four vertices then the dual parts, so
+        // vld4 gives one register per component
+        float blended[2 * 16];
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            // Blend the dual quaternions of each vertex, flipping those in the
+            // opposite hemisphere to the first so the shortest rotation is taken
+            for (size_t v = 0; v < 4; ++v)
+            {
+                const DualQuaternion& first = *blendDualQuaternions[pBlendIndex[0]];
+                float32x4_t real = vdupq_n_f32(0.0f);
+                float32x4_t dual = vdupq_n_f32(0.0f);
+                for (size_t b = 0; b < numWeightsPerVertex; ++b)
+                {
+                    // NB weights must be normalised!!
+                    float weight = pBlendWeight[b];
+                    if (weight)
+                    {
+                        const DualQuaternion& dq = *blendDualQuaternions[pBlendIndex[b]];
+                        if (dq.w * first.w + dq.x * first.x + dq.y * first.y + dq.z * first.z < 0)
+                            weight = -weight;
+                        real = vmlaq_n_f32(real, vld1q_f32(&dq.w), weight);
+                        dual = vmlaq_n_f32(dual, vld1q_f32(&dq.dw), weight);
+                    }
+                }
+                vst1q_f32(blended + v * 4, real);
+                vst1q_f32(blended + 16 + v * 4, dual);
+
+                advanceRawPointer(pBlendWeight, blendWeightStride);
+                advanceRawPointer(pBlendIndex, blendIndexStride);
+            }
+
+            float32x4x4_t r = vld4q_f32(blended);
+            float32x4x4_t d = vld4q_f32(blended + 16);
+
+            // Normalise by the length of the rotation part, with the reciprocal
+            // square root estimate refined by two Newton-Raphson steps
+            float32x4_t lengthSq = vmaxq_f32(vmlaq_f32(vmlaq_f32(vmlaq_f32(
+                vmulq_f32(r.val[0], r.val[0]), r.val[1], r.val[1]),
+                r.val[2], r.val[2]), r.val[3], r.val[3]), vdupq_n_f32(1e-30f));
+            float32x4_t rsqrt = vrsqrteq_f32(lengthSq);
+            rsqrt = vmulq_f32(rsqrt, vrsqrtsq_f32(vmulq_f32(lengthSq, rsqrt), rsqrt));
+            rsqrt = vmulq_f32(rsqrt, vrsqrtsq_f32(vmulq_f32(lengthSq, rsqrt), rsqrt));
+            for (size_t c = 0; c < 4; ++c)
+            {
+                r.val[c] = vmulq_f32(r.val[c], rsqrt);
+                d.val[c] = vmulq_f32(d.val[c], rsqrt);
+            }
+
+            // Rotate the position, p + 2 r x (r x p + w p), then translate
+            // by 2 (w d - dw r + r x d)
+            float32x4x3_t src = loadVector3x4(pSrcPos, srcPosStride);
+            float32x4x3_t t = crossVector3x4(r.val[1], r.val[2], r.val[3], src);
+            for (size_t c = 0; c < 3; ++c)
+                t.val[c] = vmlaq_f32(t.val[c], r.val[0], src.val[c]);
+            float32x4x3_t o = crossVector3x4(r.val[1], r.val[2], r.val[3], t);
+            float32x4x3_t dv;
+            dv.val[0] = d.val[1];
+            dv.val[1] = d.val[2];
+            dv.val[2] = d.val[3];
+            float32x4x3_t rd = crossVector3x4(r.val[1], r.val[2], r.val[3], dv);
+            float32x4x3_t dst;
+            for (size_t c = 0; c < 3; ++c)
+            {
+                o.val[c] = vaddq_f32(o.val[c], vmlsq_f32(vmlaq_f32(rd.val[c],
+                    r.val[0], dv.val[c]), d.val[0], r.val[c + 1]));
+                dst.val[c] = vaddq_f32(src.val[c], vaddq_f32(o.val[c], o.val[c]));
+            }
+            storeVector3x4(pDestPos, destPosStride, dst);
+            advanceRawPointer(pSrcPos, 4 * srcPosStride);
+            advanceRawPointer(pDestPos, 4 * destPosStride);
+
+            if (pSrcNorm)
+            {
+                // Rotation only, which keeps unit normals unit length
+                src = loadVector3x4(pSrcNorm, srcNormStride);
+                t = crossVector3x4(r.val[1], r.val[2], r.val[3], src);
+                for (size_t c = 0; c < 3; ++c)
+                    t.val[c] = vmlaq_f32(t.val[c], r.val[0], src.val[c]);
+                o = crossVector3x4(r.val[1], r.val[2], r.val[3], t);
+                for (size_t c = 0; c < 3; ++c)
+                    dst.val[c] = vaddq_f32(src.val[c], vaddq_f32(o.val[c], o.val[c]));
+                storeVector3x4(pDestNorm, destNormStride, dst);
+                advanceRawPointer(pSrcNorm, 4 * srcNormStride);
+                advanceRawPointer(pDestNorm, 4 * destNormStride);
+            }
+        }
+
+        if (numVertices)
+        {
+            mFallback->softwareVertexSkinningDualQuaternion(
+                pSrcPos, pDestPos,
+                pSrcNorm, pDestNorm,
+                pBlendWeight, pBlendIndex,
+                blendDualQuaternions,
+                srcPosStride, destPosStride,
+                srcNormStride, destNormStride,
+                blendWeightStride, blendIndexStride,
+                numWeightsPerVertex,
+                numVertices);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::softwareVertexMorph(
+        Real t,
+        const float *pSrc1, const float *pSrc2,
+        float *pDst,
+        size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+        size_t numVertices,
+        bool morphNormals)
+    {
+        size_t numIterations = numVertices / 4;
+        numVertices &= 3;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            float32x4x3_t a = loadVector3x4(pSrc1, pos1VSize);
+            float32x4x3_t b = loadVector3x4(pSrc2, pos2VSize);
+            for (size_t c = 0; c < 3; ++c)
+                a.val[c] = vmlaq_n_f32(a.val[c], vsubq_f32(b.val[c], a.val[c]), t);
+            storeVector3x4(pDst, dstVSize, a);
+
+            if (morphNormals)
+            {
+                // Normals follow positions in the same buffer, nlerp them
+                a = loadVector3x4(pSrc1 + 3, pos1VSize);
+                b = loadVector3x4(pSrc2 + 3, pos2VSize);
+                for (size_t c = 0; c < 3; ++c)
+                    a.val[c] = vmlaq_n_f32(a.val[c], vsubq_f32(b.val[c], a.val[c]), t);
+                normaliseVector3x4(a);
+                storeVector3x4(pDst + 3, dstVSize, a);
+            }
+
+            advanceRawPointer(pSrc1, 4 * pos1VSize);
+            advanceRawPointer(pSrc2, 4 * pos2VSize);
+            advanceRawPointer(pDst, 4 * dstVSize);
+        }
+
+        if (numVertices)
+        {
+            mFallback->softwareVertexMorph(t, pSrc1, pSrc2, pDst,
+                pos1VSize, pos2VSize, dstVSize, numVertices, morphNormals);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::concatenateAffineMatrices(
+        const Matrix4& baseMatrix,
+        const Matrix4* pSrcMat,
+        Matrix4* pDstMat,
+        size_t numMatrices)
+    {
+        const Matrix4& m = baseMatrix;
+
+        // Destination row r is the source rows weighted by base row r, plus
+        // its translation in w. Row 3 is always (0, 0, 0, 1).
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        const float32x4_t t0 = vsetq_lane_f32(m[0][3], zero, 3);
+        const float32x4_t t1 = vsetq_lane_f32(m[1][3], zero, 3);
+        const float32x4_t t2 = vsetq_lane_f32(m[2][3], zero, 3);
+        const float32x4_t row3 = vsetq_lane_f32(1.0f, zero, 3);
+
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            const Matrix4& s = *pSrcMat;
+            Matrix4& d = *pDstMat;
+
+            float32x4_t s0 = vld1q_f32(s[0]);
+            float32x4_t s1 = vld1q_f32(s[1]);
+            float32x4_t s2 = vld1q_f32(s[2]);
+
+            vst1q_f32(d[0], vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(t0,
+                s0, m[0][0]), s1, m[0][1]), s2, m[0][2]));
+            vst1q_f32(d[1], vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(t1,
+                s0, m[1][0]), s1, m[1][1]), s2, m[1][2]));
+            vst1q_f32(d[2], vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(t2,
+                s0, m[2][0]), s1, m[2][1]), s2, m[2][2]));
+            vst1q_f32(d[3], row3);
+
+            ++pSrcMat;
+            ++pDstMat;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::transformPoints(
+        const Matrix4& m,
+        const float* pSrc, float* pDest,
+        size_t srcStride, size_t destStride,
+        size_t numPoints)
+    {
+        size_t numIterations = numPoints / 4;
+        numPoints &= 3;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            float32x4x3_t src = loadVector3x4(pSrc, srcStride);
+            float32x4x3_t dst;
+            for (size_t r = 0; r < 3; ++r)
+            {
+                dst.val[r] = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(m[r][3]),
+                    src.val[0], m[r][0]), src.val[1], m[r][1]), src.val[2], m[r][2]);
+            }
+            storeVector3x4(pDest, destStride, dst);
+
+            advanceRawPointer(pSrc, 4 * srcStride);
+            advanceRawPointer(pDest, 4 * destStride);
+        }
+
+        if (numPoints)
+        {
+            mFallback->transformPoints(m,
+                pSrc, pDest, srcStride, destStride, numPoints);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::transformDirections(
+        const Matrix4& m,
+        const float* pSrc, float* pDest,
+        size_t srcStride, size_t destStride,
+        size_t numDirections, bool normalise)
+    {
+        size_t numIterations = numDirections / 4;
+        numDirections &= 3;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            float32x4x3_t src = loadVector3x4(pSrc, srcStride);
+            float32x4x3_t dst;
+            for (size_t r = 0; r < 3; ++r)
+            {
+                dst.val[r] = vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(
+                    src.val[0], m[r][0]), src.val[1], m[r][1]), src.val[2], m[r][2]);
+            }
+            if (normalise)
+                normaliseVector3x4(dst);
+            storeVector3x4(pDest, destStride, dst);
+
+            advanceRawPointer(pSrc, 4 * srcStride);
+            advanceRawPointer(pDest, 4 * destStride);
+        }
+
+        if (numDirections)
+        {
+            mFallback->transformDirections(m,
+                pSrc, pDest, srcStride, destStride, numDirections, normalise);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::calculateFaceNormals(
+        const float *positions,
+        const EdgeData::Triangle *triangles,
+        Vector4 *faceNormals,
+        size_t numTriangles)
+    {
+        size_t numIterations = numTriangles / 4;
+        numTriangles &= 3;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            // Collect the corners of four triangles, packed per corner
+            float packed[3][12];
+            for (size_t t = 0; t < 4; ++t)
+            {
+                for (size_t v = 0; v < 3; ++v)
+                {
+                    const float* pos = positions + triangles[t].vertIndex[v] * 3;
+                    packed[v][t * 3 + 0] = pos[0];
+                    packed[v][t * 3 + 1] = pos[1];
+                    packed[v][t * 3 + 2] = pos[2];
+                }
+            }
+            float32x4x3_t v0 = vld3q_f32(packed[0]);
+            float32x4x3_t v1 = vld3q_f32(packed[1]);
+            float32x4x3_t v2 = vld3q_f32(packed[2]);
+
+            // normal = (v1 - v0) x (v2 - v0), w = -(normal . v0)
+            float32x4_t ax = vsubq_f32(v1.val[0], v0.val[0]);
+            float32x4_t ay = vsubq_f32(v1.val[1], v0.val[1]);
+            float32x4_t az = vsubq_f32(v1.val[2], v0.val[2]);
+            float32x4_t bx = vsubq_f32(v2.val[0], v0.val[0]);
+            float32x4_t by = vsubq_f32(v2.val[1], v0.val[1]);
+            float32x4_t bz = vsubq_f32(v2.val[2], v0.val[2]);
+
+            float32x4x4_t n;
+            n.val[0] = vmlsq_f32(vmulq_f32(ay, bz), az, by);
+            n.val[1] = vmlsq_f32(vmulq_f32(az, bx), ax, bz);
+            n.val[2] = vmlsq_f32(vmulq_f32(ax, by), ay, bx);
+            n.val[3] = vnegq_f32(vmlaq_f32(vmlaq_f32(vmulq_f32(
+                n.val[0], v0.val[0]), n.val[1], v0.val[1]), n.val[2], v0.val[2]));
+
+            // vst4 interleaves back to four xyzw vectors
+            vst4q_f32(&faceNormals->x, n);
+
+            triangles += 4;
+            faceNormals += 4;
+        }
+
+        if (numTriangles)
+        {
+            mFallback->calculateFaceNormals(positions, triangles, faceNormals, numTriangles);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::calculateLightFacing(
+        const Vector4& lightPos,
+        const Vector4* faceNormals,
+        char* lightFacings,
+        size_t numFaces)
+    {
+        size_t numIterations = numFaces / 4;
+        numFaces &= 3;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            // One register per component of four face normals
+            float32x4x4_t n = vld4q_f32(&faceNormals->x);
+            float32x4_t dot = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(
+                n.val[0], lightPos.x), n.val[1], lightPos.y), n.val[2], lightPos.z), n.val[3], lightPos.w);
+
+            storeMask4(vcgtq_f32(dot, vdupq_n_f32(0.0f)), reinterpret_cast<uint8*>(lightFacings));
+
+            faceNormals += 4;
+            lightFacings += 4;
+        }
+
+        if (numFaces)
+        {
+            mFallback->calculateLightFacing(lightPos, faceNormals, lightFacings, numFaces);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::extrudeVertices(
+        const Vector4& lightPos,
+        Real extrudeDist,
+        const float* pSrcPos,
+        float* pDestPos,
+        size_t numVertices)
+    {
+        size_t numIterations = numVertices / 4;
+        numVertices &= 3;
+
+        if (lightPos.w == 0.0f)
+        {
+            // Directional light, extrusion is along light direction
+            Vector3 extrusionDir(-lightPos.x, -lightPos.y, -lightPos.z);
+            extrusionDir.normalise();
+            extrusionDir *= extrudeDist;
+
+            float32x4x3_t dir;
+            dir.val[0] = vdupq_n_f32(extrusionDir.x);
+            dir.val[1] = vdupq_n_f32(extrusionDir.y);
+            dir.val[2] = vdupq_n_f32(extrusionDir.z);
+
+            for (size_t i = 0; i < numIterations; ++i)
+            {
+                float32x4x3_t v = vld3q_f32(pSrcPos);
+                v.val[0] = vaddq_f32(v.val[0], dir.val[0]);
+                v.val[1] = vaddq_f32(v.val[1], dir.val[1]);
+                v.val[2] = vaddq_f32(v.val[2], dir.val[2]);
+                vst3q_f32(pDestPos, v);
+
+                pSrcPos += 12;
+                pDestPos += 12;
+            }
+        }
+        else
+        {
+            // Point light, calculate extrusionDir for every vertex
+            assert(lightPos.w == 1.0f);
+
+            for (size_t i = 0; i < numIterations; ++i)
+            {
+                float32x4x3_t v = vld3q_f32(pSrcPos);
+                float32x4x3_t dir;
+                dir.val[0] = vsubq_f32(v.val[0], vdupq_n_f32(lightPos.x));
+                dir.val[1] = vsubq_f32(v.val[1], vdupq_n_f32(lightPos.y));
+                dir.val[2] = vsubq_f32(v.val[2], vdupq_n_f32(lightPos.z));
+                normaliseVector3x4(dir);
+                v.val[0] = vmlaq_n_f32(v.val[0], dir.val[0], extrudeDist);
+                v.val[1] = vmlaq_n_f32(v.val[1], dir.val[1], extrudeDist);
+                v.val[2] = vmlaq_n_f32(v.val[2], dir.val[2], extrudeDist);
+                vst3q_f32(pDestPos, v);
+
+                pSrcPos += 12;
+                pDestPos += 12;
+            }
+        }
+
+        if (numVertices)
+        {
+            mFallback->extrudeVertices(lightPos, extrudeDist, pSrcPos, pDestPos, numVertices);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::cullBoxes(
+        const Plane* planes, size_t numPlanes,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+        uint8* results, size_t numBoxes)
+    {
+        size_t numIterations = numBoxes / 4;
+        numBoxes &= 3;
+
+        // Four boxes per iteration, against one plane at a time
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            float32x4_t cx = vld1q_f32(centreX);
+            float32x4_t cy = vld1q_f32(centreY);
+            float32x4_t cz = vld1q_f32(centreZ);
+            float32x4_t hx = vld1q_f32(halfSizeX);
+            float32x4_t hy = vld1q_f32(halfSizeY);
+            float32x4_t hz = vld1q_f32(halfSizeZ);
+
+            uint32x4_t inside = vdupq_n_u32(~0u);
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                const Plane& plane = planes[p];
+
+                // dist = n . centre + d
+                float32x4_t dist = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(plane.d),
+                    cx, plane.normal.x), cy, plane.normal.y), cz, plane.normal.z);
+                // maxAbsDist = |n| . halfSize, half sizes are never negative
+                float32x4_t maxAbsDist = vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(
+                    hx, Math::Abs(plane.normal.x)), hy, Math::Abs(plane.normal.y)),
+                    hz, Math::Abs(plane.normal.z));
+
+                inside = vandq_u32(inside, vcgeq_f32(dist, vnegq_f32(maxAbsDist)));
+            }
+
+            storeMask4(inside, results);
+
+            centreX += 4; centreY += 4; centreZ += 4;
+            halfSizeX += 4; halfSizeY += 4; halfSizeZ += 4;
+            results += 4;
+        }
+
+        // Left over boxes
+        if (numBoxes)
+        {
+            mFallback->cullBoxes(planes, numPlanes,
+                centreX, centreY, centreZ, halfSizeX, halfSizeY, halfSizeZ,
+                results, numBoxes);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::cullSpheres(
+        const Plane* planes, size_t numPlanes,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* radius,
+        uint8* results, size_t numSpheres)
+    {
+        size_t numIterations = numSpheres / 4;
+        numSpheres &= 3;
+
+        // Four spheres per iteration, against one plane at a time
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            float32x4_t cx = vld1q_f32(centreX);
+            float32x4_t cy = vld1q_f32(centreY);
+            float32x4_t cz = vld1q_f32(centreZ);
+            float32x4_t negRadius = vnegq_f32(vld1q_f32(radius));
+
+            uint32x4_t inside = vdupq_n_u32(~0u);
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                const Plane& plane = planes[p];
+
+                // dist = n . centre + d
+                float32x4_t dist = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(plane.d),
+                    cx, plane.normal.x), cy, plane.normal.y), cz, plane.normal.z);
+
+                inside = vandq_u32(inside, vcgeq_f32(dist, negRadius));
+            }
+
+            storeMask4(inside, results);
+
+            centreX += 4; centreY += 4; centreZ += 4;
+            radius += 4;
+            results += 4;
+        }
+
+        // Left over spheres
+        if (numSpheres)
+        {
+            mFallback->cullSpheres(planes, numPlanes,
+                centreX, centreY, centreZ, radius, results, numSpheres);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::intersectBoxes(
+        const AxisAlignedBox& box,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+        uint8* results, size_t numBoxes)
+    {
+        const Vector3 centre = box.getCenter();
+        const Vector3 halfSize = box.getHalfSize();
+
+        size_t numIterations = numBoxes / 4;
+        numBoxes &= 3;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            // Separated on no axis
+            uint32x4_t overlap = vcleq_f32(
+                vabdq_f32(vld1q_f32(centreX), vdupq_n_f32(centre.x)),
+                vaddq_f32(vld1q_f32(halfSizeX), vdupq_n_f32(halfSize.x)));
+            overlap = vandq_u32(overlap, vcleq_f32(
+                vabdq_f32(vld1q_f32(centreY), vdupq_n_f32(centre.y)),
+                vaddq_f32(vld1q_f32(halfSizeY), vdupq_n_f32(halfSize.y))));
+            overlap = vandq_u32(overlap, vcleq_f32(
+                vabdq_f32(vld1q_f32(centreZ), vdupq_n_f32(centre.z)),
+                vaddq_f32(vld1q_f32(halfSizeZ), vdupq_n_f32(halfSize.z))));
+
+            storeMask4(overlap, results);
+
+            centreX += 4; centreY += 4; centreZ += 4;
+            halfSizeX += 4; halfSizeY += 4; halfSizeZ += 4;
+            results += 4;
+        }
+
+        // Left over boxes
+        if (numBoxes)
+        {
+            mFallback->intersectBoxes(box,
+                centreX, centreY, centreZ, halfSizeX, halfSizeY, halfSizeZ,
+                results, numBoxes);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::intersectBoxes(
+        const Sphere& sphere,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+        uint8* results, size_t numBoxes)
+    {
+        const Vector3& centre = sphere.getCenter();
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        const float32x4_t radiusSq = vdupq_n_f32(Math::Sqr(sphere.getRadius()));
+
+        size_t numIterations = numBoxes / 4;
+        numBoxes &= 3;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            // Distance from the sphere centre to the box along each axis
+            float32x4_t dx = vmaxq_f32(vsubq_f32(
+                vabdq_f32(vld1q_f32(centreX), vdupq_n_f32(centre.x)), vld1q_f32(halfSizeX)), zero);
+            float32x4_t dy = vmaxq_f32(vsubq_f32(
+                vabdq_f32(vld1q_f32(centreY), vdupq_n_f32(centre.y)), vld1q_f32(halfSizeY)), zero);
+            float32x4_t dz = vmaxq_f32(vsubq_f32(
+                vabdq_f32(vld1q_f32(centreZ), vdupq_n_f32(centre.z)), vld1q_f32(halfSizeZ)), zero);
+            float32x4_t distSq = vmlaq_f32(vmlaq_f32(vmulq_f32(dx, dx), dy, dy), dz, dz);
+
+            storeMask4(vcleq_f32(distSq, radiusSq), results);
+
+            centreX += 4; centreY += 4; centreZ += 4;
+            halfSizeX += 4; halfSizeY += 4; halfSizeZ += 4;
+            results += 4;
+        }
+
+        // Left over boxes
+        if (numBoxes)
+        {
+            mFallback->intersectBoxes(sphere,
+                centreX, centreY, centreZ, halfSizeX, halfSizeY, halfSizeZ,
+                results, numBoxes);
+        }
+    }
+    //---------------------------------------------------------------------
+    /// Clip four ray intervals [tNear, tFar] against one slab of four boxes
+    static OGRE_FORCE_INLINE void clipRaySlab4(const float* centre, const float* halfSize,
+        float origin, float invDir, float32x4_t& tNear, float32x4_t& tFar)
+    {
+        float32x4_t c = vsubq_f32(vld1q_f32(centre), vdupq_n_f32(origin));
+        float32x4_t h = vld1q_f32(halfSize);
+        float32x4_t t1 = vmulq_n_f32(vsubq_f32(c, h), invDir);
+        float32x4_t t2 = vmulq_n_f32(vaddq_f32(c, h), invDir);
+        float32x4_t tMin = vminq_f32(t1, t2);
+        float32x4_t tMax = vmaxq_f32(t1, t2);
+        // A ray lying in a slab face gives NaN, which fails both comparisons
+        tNear = vbslq_f32(vcgtq_f32(tMin, tNear), tMin, tNear);
+        tFar = vbslq_f32(vcltq_f32(tMax, tFar), tMax, tFar);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::intersectBoxes(
+        const Ray& ray,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+        float* distances, uint8* results, size_t numBoxes)
+    {
+        const Vector3& origin = ray.getOrigin();
+        const Vector3& dir = ray.getDirection();
+        // Axes the ray is parallel to give infinities, which the slab test handles
+        const Vector3 invDir(1 / dir.x, 1 / dir.y, 1 / dir.z);
+        const float32x4_t infinity = vdupq_n_f32(std::numeric_limits<float>::infinity());
+
+        size_t numIterations = numBoxes / 4;
+        numBoxes &= 3;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            float32x4_t tNear = vdupq_n_f32(0.0f);
+            float32x4_t tFar = infinity;
+            clipRaySlab4(centreX, halfSizeX, origin.x, invDir.x, tNear, tFar);
+            clipRaySlab4(centreY, halfSizeY, origin.y, invDir.y, tNear, tFar);
+            clipRaySlab4(centreZ, halfSizeZ, origin.z, invDir.z, tNear, tFar);
+
+            vst1q_f32(distances, tNear);
+            storeMask4(vcleq_f32(tNear, tFar), results);
+
+            centreX += 4; centreY += 4; centreZ += 4;
+            halfSizeX += 4; halfSizeY += 4; halfSizeZ += 4;
+            distances += 4;
+            results += 4;
+        }
+
+        // Left over boxes
+        if (numBoxes)
+        {
+            mFallback->intersectBoxes(ray,
+                centreX, centreY, centreZ, halfSizeX, halfSizeY, halfSizeZ,
+                distances, results, numBoxes);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::intersectSpheres(
+        const Sphere& sphere,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* radius,
+        uint8* results, size_t numSpheres)
+    {
+        const Vector3& centre = sphere.getCenter();
+
+        size_t numIterations = numSpheres / 4;
+        numSpheres &= 3;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            float32x4_t dx = vsubq_f32(vld1q_f32(centreX), vdupq_n_f32(centre.x));
+            float32x4_t dy = vsubq_f32(vld1q_f32(centreY), vdupq_n_f32(centre.y));
+            float32x4_t dz = vsubq_f32(vld1q_f32(centreZ), vdupq_n_f32(centre.z));
+            float32x4_t r = vaddq_f32(vld1q_f32(radius), vdupq_n_f32(sphere.getRadius()));
+            float32x4_t distSq = vmlaq_f32(vmlaq_f32(vmulq_f32(dx, dx), dy, dy), dz, dz);
+
+            storeMask4(vcleq_f32(distSq, vmulq_f32(r, r)), results);
+
+            centreX += 4; centreY += 4; centreZ += 4;
+            radius += 4;
+            results += 4;
+        }
+
+        // Left over spheres
+        if (numSpheres)
+        {
+            mFallback->intersectSpheres(sphere,
+                centreX, centreY, centreZ, radius, results, numSpheres);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::nlerpQuaternions(
+        const float* t,
+        const float* src1, const float* src2,
+        float* dest, size_t numQuaternions)
+    {
+        size_t numIterations = numQuaternions / 4;
+        numQuaternions &= 3;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            // De-interleaving loads give one register per component
+            float32x4x4_t q1 = vld4q_f32(src1);
+            float32x4x4_t q2 = vld4q_f32(src2);
+
+            // Flip the second to the nearest rotation, when the dot product is negative
+            float32x4_t dot = vmulq_f32(q1.val[0], q2.val[0]);
+            dot = vmlaq_f32(dot, q1.val[1], q2.val[1]);
+            dot = vmlaq_f32(dot, q1.val[2], q2.val[2]);
+            dot = vmlaq_f32(dot, q1.val[3], q2.val[3]);
+            uint32x4_t flip = vcltq_f32(dot, vdupq_n_f32(0.0f));
+
+            float32x4_t f = vld1q_f32(t);
+            float32x4x4_t q;
+            for (int c = 0; c < 4; ++c)
+            {
+                float32x4_t to = vbslq_f32(flip, vnegq_f32(q2.val[c]), q2.val[c]);
+                q.val[c] = vmlaq_f32(q1.val[c], f, vsubq_f32(to, q1.val[c]));
+            }
+
+            float32x4_t lengthSq = vmulq_f32(q.val[0], q.val[0]);
+            lengthSq = vmlaq_f32(lengthSq, q.val[1], q.val[1]);
+            lengthSq = vmlaq_f32(lengthSq, q.val[2], q.val[2]);
+            lengthSq = vmlaq_f32(lengthSq, q.val[3], q.val[3]);
+
+            // Reciprocal square root estimate refined by two Newton-Raphson steps
+            float32x4_t rsqrt = vrsqrteq_f32(lengthSq);
+            rsqrt = vmulq_f32(rsqrt, vrsqrtsq_f32(vmulq_f32(lengthSq, rsqrt), rsqrt));
+            rsqrt = vmulq_f32(rsqrt, vrsqrtsq_f32(vmulq_f32(lengthSq, rsqrt), rsqrt));
+            for (int c = 0; c < 4; ++c)
+                q.val[c] = vmulq_f32(q.val[c], rsqrt);
+
+            vst4q_f32(dest, q);
+
+            t += 4;
+            src1 += 16;
+            src2 += 16;
+            dest += 16;
+        }
+
+        // Left over quaternions
+        if (numQuaternions)
+        {
+            mFallback->nlerpQuaternions(t, src1, src2, dest, numQuaternions);
+        }
+    }
+    //---------------------------------------------------------------------
+    /// Load sixteen pixels of 1 to 4 bytes into one register per byte of the pixel
+    static OGRE_FORCE_INLINE void loadPixels16(const uint8* p, size_t pixelSize, uint8x16_t* v)
+    {
+        switch (pixelSize)
+        {
+        case 1:
+            v[0] = vld1q_u8(p);
+            break;
+        case 2:
+            {
+                uint8x16x2_t t = vld2q_u8(p);
+                v[0] = t.val[0]; v[1] = t.val[1];
+            }
+            break;
+        case 3:
+            {
+                uint8x16x3_t t = vld3q_u8(p);
+                v[0] = t.val[0]; v[1] = t.val[1]; v[2] = t.val[2];
+            }
+            break;
+        default:
+            {
+                uint8x16x4_t t = vld4q_u8(p);
+                v[0] = t.val[0]; v[1] = t.val[1]; v[2] = t.val[2]; v[3] = t.val[3];
+            }
+            break;
+        }
+    }
+    //---------------------------------------------------------------------
+    /// Store sixteen pixels of 1 to 4 bytes held one register per byte of the pixel
+    static OGRE_FORCE_INLINE void storePixels16(uint8* p, size_t pixelSize, const uint8x16_t* v)
+    {
+        switch (pixelSize)
+        {
+        case 1:
+            vst1q_u8(p, v[0]);
+            break;
+        case 2:
+            {
+                uint8x16x2_t t = { { v[0], v[1] } };
+                vst2q_u8(p, t);
+            }
+            break;
+        case 3:
+            {
+                uint8x16x3_t t = { { v[0], v[1], v[2] } };
+                vst3q_u8(p, t);
+            }
+            break;
+        default:
+            {
+                uint8x16x4_t t = { { v[0], v[1], v[2], v[3] } };
+                vst4q_u8(p, t);
+            }
+            break;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::shufflePixels(
+        const uint8* src, size_t srcPixelSize,
+        uint8* dest, size_t destPixelSize,
+        const int8* shuffle, size_t numPixels)
+    {
+        const uint8x16_t full = vdupq_n_u8(0xFF);
+
+        size_t numIterations = numPixels / 16;
+        numPixels &= 15;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            uint8x16_t in[4], out[4];
+            loadPixels16(src, srcPixelSize, in);
+            for (size_t b = 0; b < destPixelSize; ++b)
+                out[b] = shuffle[b] < 0 ? full : in[shuffle[b]];
+            storePixels16(dest, destPixelSize, out);
+
+            src += 16 * srcPixelSize;
+            dest += 16 * destPixelSize;
+        }
+
+        // Left over pixels
+        if (numPixels)
+        {
+            mFallback->shufflePixels(src, srcPixelSize,
+                dest, destPixelSize, shuffle, numPixels);
+        }
+    }
+    //---------------------------------------------------------------------
+    /// Convert four half floats, zero extended to 32 bits, to floats
+    static OGRE_FORCE_INLINE float32x4_t halfToFloat4(uint32x4_t h)
+    {
+        uint32x4_t expMant = vandq_u32(h, vdupq_n_u32(0x7FFF));
+        uint32x4_t sign = vshlq_n_u32(veorq_u32(h, expMant), 16);
+
+        // Normal numbers, infinities and NaNs just need the exponent rebiasing
+        uint32x4_t normal = vaddq_u32(vshlq_n_u32(expMant, 13), vdupq_n_u32(112 << 23));
+        uint32x4_t infNaN = vcgtq_u32(expMant, vdupq_n_u32(0x7BFF));
+        normal = vorrq_u32(normal, vandq_u32(infNaN, vdupq_n_u32(0x7F800000)));
+
+        // Denormals are the mantissa scaled by 2^-24, which is exact
+        float32x4_t denormal = vmulq_n_f32(vcvtq_f32_u32(expMant), 1.0f / 16777216.0f);
+        uint32x4_t isDenormal = vcltq_u32(expMant, vdupq_n_u32(0x0400));
+
+        uint32x4_t result = vbslq_u32(isDenormal, vreinterpretq_u32_f32(denormal), normal);
+        return vreinterpretq_f32_u32(vorrq_u32(result, sign));
+    }
+    //---------------------------------------------------------------------
+    /** Convert four floats to half floats in the lower 16 bits of each element,
+        following Bitwise::floatToHalfI case by case, truncating.
+    */
+    static OGRE_FORCE_INLINE uint32x4_t floatToHalf4(float32x4_t f)
+    {
+        uint32x4_t x = vreinterpretq_u32_f32(f);
+        uint32x4_t absX = vandq_u32(x, vdupq_n_u32(0x7FFFFFFF));
+        uint32x4_t sign = vandq_u32(vshrq_n_u32(x, 16), vdupq_n_u32(0x8000));
+        uint32x4_t mant = vandq_u32(x, vdupq_n_u32(0x007FFFFF));
+
+        // Denormal halves, the value scaled by 2^24 and truncated
+        uint32x4_t result = vcvtq_u32_f32(
+            vmulq_n_f32(vreinterpretq_f32_u32(absX), 16777216.0f));
+        // Normal halves, rebias the exponent and truncate the mantissa
+        result = vbslq_u32(vcgtq_u32(absX, vdupq_n_u32((113 << 23) - 1)),
+            vsubq_u32(vshrq_n_u32(absX, 13), vdupq_n_u32(112 << 10)), result);
+        // Overflow to infinity
+        result = vbslq_u32(vcgtq_u32(absX, vdupq_n_u32((143 << 23) - 1)),
+            vdupq_n_u32(0x7C00), result);
+        // Infinity and NaN, keeping a mantissa bit so NaNs stay NaNs
+        uint32x4_t halfMant = vshrq_n_u32(mant, 13);
+        uint32x4_t keepNaN = vandq_u32(vandq_u32(vtstq_u32(mant, mant),
+            vceqq_u32(halfMant, vdupq_n_u32(0))), vdupq_n_u32(1));
+        result = vbslq_u32(vcgtq_u32(absX, vdupq_n_u32(0x7F7FFFFF)),
+            vorrq_u32(vdupq_n_u32(0x7C00), vorrq_u32(halfMant, keepNaN)), result);
+
+        // Values too small even for a denormal become zero, without the sign
+        return vorrq_u32(result,
+            vandq_u32(vcgtq_u32(absX, vdupq_n_u32((102 << 23) - 1)), sign));
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::convertHalfToFloat(
+        const uint16* src, float* dest, size_t count)
+    {
+        size_t numIterations = count / 4;
+        count &= 3;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            vst1q_f32(dest, halfToFloat4(vmovl_u16(vld1_u16(src))));
+            src += 4;
+            dest += 4;
+        }
+
+        // Left over values
+        if (count)
+        {
+            mFallback->convertHalfToFloat(src, dest, count);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::convertFloatToHalf(
+        const float* src, uint16* dest, size_t count)
+    {
+        size_t numIterations = count / 4;
+        count &= 3;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            vst1_u16(dest, vmovn_u32(floatToHalf4(vld1q_f32(src))));
+            src += 4;
+            dest += 4;
+        }
+
+        // Left over values
+        if (count)
+        {
+            mFallback->convertFloatToHalf(src, dest, count);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::sumWeightedRows(
+        const float* const* rows, const float* weights, size_t numRows,
+        float* dest, size_t count)
+    {
+        size_t numIterations = count / 8;
+        size_t i = 0;
+
+        for (size_t n = 0; n < numIterations; ++n, i += 8)
+        {
+            float32x4_t w = vdupq_n_f32(weights[0]);
+            float32x4_t sum0 = vmulq_f32(w, vld1q_f32(rows[0] + i));
+            float32x4_t sum1 = vmulq_f32(w, vld1q_f32(rows[0] + i + 4));
+            for (size_t k = 1; k < numRows; ++k)
+            {
+                w = vdupq_n_f32(weights[k]);
+                sum0 = vmlaq_f32(sum0, w, vld1q_f32(rows[k] + i));
+                sum1 = vmlaq_f32(sum1, w, vld1q_f32(rows[k] + i + 4));
+            }
+            vst1q_f32(dest + i, sum0);
+            vst1q_f32(dest + i + 4, sum1);
+        }
+
+        // Left over values, the rows can't be offset for the fallback
+        for (; i < count; ++i)
+        {
+            float sum = weights[0] * rows[0][i];
+            for (size_t k = 1; k < numRows; ++k)
+                sum += weights[k] * rows[k][i];
+            dest[i] = sum;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::convertFloatToByte(
+        const float* src, uint8* dest, size_t count)
+    {
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        const float32x4_t maximum = vdupq_n_f32(255.0f);
+        const float32x4_t half = vdupq_n_f32(0.5f);
+
+        size_t numIterations = count / 8;
+        count &= 7;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            uint16x4_t shorts[2];
+            for (size_t j = 0; j < 2; ++j)
+            {
+                // vmaxq passes NaNs through, a compare doesn't
+                float32x4_t f = vld1q_f32(src + j * 4);
+                f = vbslq_f32(vcgtq_f32(f, zero), f, zero);
+                f = vaddq_f32(vminq_f32(f, maximum), half);
+                shorts[j] = vmovn_u32(vcvtq_u32_f32(f));
+            }
+            vst1_u8(dest, vmovn_u16(vcombine_u16(shorts[0], shorts[1])));
+
+            src += 8;
+            dest += 8;
+        }
+
+        // Left over values
+        if (count)
+        {
+            mFallback->convertFloatToByte(src, dest, count);
+        }
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    extern OptimisedUtil* _getOptimisedUtilNEON(void)
+    {
+        static OptimisedUtilNEON msOptimisedUtilNEON;
+        return &msOptimisedUtilNEON;
+    }
+
+}
+
+#endif // __OGRE_HAVE_NEON
@@ -33,11 +33,23 @@ THE SOFTWARE.
 #if __OGRE_HAVE_SSE
 
 #include "OgreMatrix4.h"
+#include "OgreDualQuaternion.h"
+#include "OgrePlane.h"
+#include "OgreAxisAlignedBox.h"
+#include "OgreSphere.h"
+#include "OgreRay.h"
 
 // Should keep this includes at latest to avoid potential "xmmintrin.h" included by
 // other header file on some platform for some reason.
 #include "OgreSIMDHelper.h"
 
+// The pixel conversions need the integer instructions of SSE2, which gcc only
+// allows when they are enabled for the whole file (always so on x86-64).
+#if defined(__SSE2__) || OGRE_COMPILER == OGRE_COMPILER_MSVC
+#   define __OGRE_HAVE_SSE2 1
+#   include <emmintrin.h>
+#endif
+
 // I'd like to merge this file with OgreOptimisedUtil.cpp, but it's
 // impossible when compile with gcc, due SSE instructions can only
 // enable/disable at file level.
@@ -65,6 +77,8 @@ THE SOFTWARE.
 
 namespace Ogre {
 
+    extern OptimisedUtil* _getOptimisedUtilGeneral(void);
+
 //-------------------------------------------------------------------------
 // Local classes
 //-------------------------------------------------------------------------
@@ -78,6 +92,8 @@ namespace Ogre {
     protected:
         /// Do we prefer to use a general SSE version for position/normal shared buffers?
         bool mPreferGeneralVersionForSharedBuffers;
+        /// Does the CPU support the SSE2 instructions used by the pixel conversions?
+        bool mHasSSE2;
 
     public:
         /// Constructor
@@ -95,6 +111,18 @@ namespace Ogre {
             size_t numWeightsPerVertex,
             size_t numVertices);
 
+        /// @copydoc OptimisedUtil::softwareVertexSkinningDualQuaternion
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE softwareVertexSkinningDualQuaternion(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const DualQuaternion* const* blendDualQuaternions,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices);
+
         /// @copydoc OptimisedUtil::softwareVertexMorph
         virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE softwareVertexMorph(
             Real t,
@@ -111,6 +139,20 @@ namespace Ogre {
             Matrix4* dstMatrices,
             size_t numMatrices);
 
+        /// @copydoc OptimisedUtil::transformPoints
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE transformPoints(
+            const Matrix4& matrix,
+            const float* srcPtr, float* destPtr,
+            size_t srcStride, size_t destStride,
+            size_t numPoints);
+
+        /// @copydoc OptimisedUtil::transformDirections
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE transformDirections(
+            const Matrix4& matrix,
+            const float* srcPtr, float* destPtr,
+            size_t srcStride, size_t destStride,
+            size_t numDirections, bool normalise);
+
         /// @copydoc OptimisedUtil::calculateFaceNormals
         virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE calculateFaceNormals(
             const float *positions,
@@ -132,6 +174,77 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::cullBoxes
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE cullBoxes(
+            const Plane* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::cullSpheres
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE cullSpheres(
+            const Plane* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* radius,
+            uint8* results, size_t numSpheres);
+
+        /// @copydoc OptimisedUtil::intersectBoxes(const AxisAlignedBox&,const float*,const float*,const float*,const float*,const float*,const float*,uint8*,size_t)
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE intersectBoxes(
+            const AxisAlignedBox& box,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::intersectBoxes(const Sphere&,const float*,const float*,const float*,const float*,const float*,const float*,uint8*,size_t)
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE intersectBoxes(
+            const Sphere& sphere,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::intersectBoxes(const Ray&,const float*,const float*,const float*,const float*,const float*,const float*,float*,uint8*,size_t)
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE intersectBoxes(
+            const Ray& ray,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            float* distances, uint8* results, size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::intersectSpheres
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE intersectSpheres(
+            const Sphere& sphere,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* radius,
+            uint8* results, size_t numSpheres);
+
+        /// @copydoc OptimisedUtil::nlerpQuaternions
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE nlerpQuaternions(
+            const float* t,
+            const float* src1, const float* src2,
+            float* dest, size_t numQuaternions);
+
+        /// @copydoc OptimisedUtil::shufflePixels
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE shufflePixels(
+            const uint8* src, size_t srcPixelSize,
+            uint8* dest, size_t destPixelSize,
+            const int8* shuffle, size_t numPixels);
+
+        /// @copydoc OptimisedUtil::convertHalfToFloat
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE convertHalfToFloat(
+            const uint16* src, float* dest, size_t count);
+
+        /// @copydoc OptimisedUtil::convertFloatToHalf
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE convertFloatToHalf(
+            const float* src, uint16* dest, size_t count);
+
+        /// @copydoc OptimisedUtil::sumWeightedRows
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE sumWeightedRows(
+            const float* const* rows, const float* weights, size_t numRows,
+            float* dest, size_t count);
+
+        /// @copydoc OptimisedUtil::convertFloatToByte
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE convertFloatToByte(
+            const float* src, uint8* dest, size_t count);
     };
 
 #if defined(__OGRE_SIMD_ALIGN_STACK)
@@ -186,6 +299,32 @@ namespace Ogre {
                 numVertices);
         }
 
+        /// @copydoc OptimisedUtil::softwareVertexSkinningDualQuaternion
+        virtual void softwareVertexSkinningDualQuaternion(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const DualQuaternion* const* blendDualQuaternions,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->softwareVertexSkinningDualQuaternion(
+                srcPosPtr, destPosPtr,
+                srcNormPtr, destNormPtr,
+                blendWeightPtr, blendIndexPtr,
+                blendDualQuaternions,
+                srcPosStride, destPosStride,
+                srcNormStride, destNormStride,
+                blendWeightStride, blendIndexStride,
+                numWeightsPerVertex,
+                numVertices);
+        }
+
         /// @copydoc OptimisedUtil::softwareVertexMorph
         virtual void softwareVertexMorph(
             Real t,
@@ -222,6 +361,38 @@ namespace Ogre {
                 numMatrices);
         }
 
+        /// @copydoc OptimisedUtil::transformPoints
+        virtual void transformPoints(
+            const Matrix4& matrix,
+            const float* srcPtr, float* destPtr,
+            size_t srcStride, size_t destStride,
+            size_t numPoints)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->transformPoints(
+                matrix,
+                srcPtr, destPtr,
+                srcStride, destStride,
+                numPoints);
+        }
+
+        /// @copydoc OptimisedUtil::transformDirections
+        virtual void transformDirections(
+            const Matrix4& matrix,
+            const float* srcPtr, float* destPtr,
+            size_t srcStride, size_t destStride,
+            size_t numDirections, bool normalise)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->transformDirections(
+                matrix,
+                srcPtr, destPtr,
+                srcStride, destStride,
+                numDirections, normalise);
+        }
+
         /// @copydoc OptimisedUtil::calculateFaceNormals
         virtual void calculateFaceNormals(
             const float *positions,
@@ -271,6 +442,167 @@ namespace Ogre {
                 destPositions,
                 numVertices);
         }
+
+        /// @copydoc OptimisedUtil::cullBoxes
+        virtual void cullBoxes(
+            const Plane* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->cullBoxes(
+                planes, numPlanes,
+                centreX, centreY, centreZ,
+                halfSizeX, halfSizeY, halfSizeZ,
+                results, numBoxes);
+        }
+
+        /// @copydoc OptimisedUtil::cullSpheres
+        virtual void cullSpheres(
+            const Plane* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* radius,
+            uint8* results, size_t numSpheres)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->cullSpheres(
+                planes, numPlanes,
+                centreX, centreY, centreZ,
+                radius,
+                results, numSpheres);
+        }
+
+        /// @copydoc OptimisedUtil::intersectBoxes(const AxisAlignedBox&,const float*,const float*,const float*,const float*,const float*,const float*,uint8*,size_t)
+        virtual void intersectBoxes(
+            const AxisAlignedBox& box,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->intersectBoxes(
+                box,
+                centreX, centreY, centreZ,
+                halfSizeX, halfSizeY, halfSizeZ,
+                results, numBoxes);
+        }
+
+        /// @copydoc OptimisedUtil::intersectBoxes(const Sphere&,const float*,const float*,const float*,const float*,const float*,const float*,uint8*,size_t)
+        virtual void intersectBoxes(
+            const Sphere& sphere,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->intersectBoxes(
+                sphere,
+                centreX, centreY, centreZ,
+                halfSizeX, halfSizeY, halfSizeZ,
+                results, numBoxes);
+        }
+
+        /// @copydoc OptimisedUtil::intersectBoxes(const Ray&,const float*,const float*,const float*,const float*,const float*,const float*,float*,uint8*,size_t)
+        virtual void intersectBoxes(
+            const Ray& ray,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            float* distances, uint8* results, size_t numBoxes)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->intersectBoxes(
+                ray,
+                centreX, centreY, centreZ,
+                halfSizeX, halfSizeY, halfSizeZ,
+                distances, results, numBoxes);
+        }
+
+        /// @copydoc OptimisedUtil::intersectSpheres
+        virtual void intersectSpheres(
+            const Sphere& sphere,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* radius,
+            uint8* results, size_t numSpheres)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->intersectSpheres(
+                sphere,
+                centreX, centreY, centreZ,
+                radius,
+                results, numSpheres);
+        }
+
+        /// @copydoc OptimisedUtil::nlerpQuaternions
+        virtual void nlerpQuaternions(
+            const float* t,
+            const float* src1, const float* src2,
+            float* dest, size_t numQuaternions)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->nlerpQuaternions(
+                t,
+                src1, src2,
+                dest, numQuaternions);
+        }
+
+        /// @copydoc OptimisedUtil::shufflePixels
+        virtual void shufflePixels(
+            const uint8* src, size_t srcPixelSize,
+            uint8* dest, size_t destPixelSize,
+            const int8* shuffle, size_t numPixels)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->shufflePixels(
+                src, srcPixelSize,
+                dest, destPixelSize,
+                shuffle, numPixels);
+        }
+
+        /// @copydoc OptimisedUtil::convertHalfToFloat
+        virtual void convertHalfToFloat(
+            const uint16* src, float* dest, size_t count)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->convertHalfToFloat(src, dest, count);
+        }
+
+        /// @copydoc OptimisedUtil::convertFloatToHalf
+        virtual void convertFloatToHalf(
+            const float* src, uint16* dest, size_t count)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->convertFloatToHalf(src, dest, count);
+        }
+
+        /// @copydoc OptimisedUtil::sumWeightedRows
+        virtual void sumWeightedRows(
+            const float* const* rows, const float* weights, size_t numRows,
+            float* dest, size_t count)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->sumWeightedRows(rows, weights, numRows, dest, count);
+        }
+
+        /// @copydoc OptimisedUtil::convertFloatToByte
+        virtual void convertFloatToByte(
+            const float* src, uint8* dest, size_t count)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->convertFloatToByte(src, dest, count);
+        }
     };
 #endif  // !defined(__OGRE_SIMD_ALIGN_STACK)
 
@@ -1041,6 +1373,7 @@ namespace Ogre {
     //---------------------------------------------------------------------
     OptimisedUtilSSE::OptimisedUtilSSE(void)
         : mPreferGeneralVersionForSharedBuffers(false)
+        , mHasSSE2(PlatformInformation::hasCpuFeature(PlatformInformation::CPU_FEATURE_SSE2))
     {
         // For AMD Athlon XP (but not that for Althon 64), it's prefer to never use
         // unrolled version for shared buffers at all, I guess because that version
@@ -1282,6 +1615,181 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilSSE::softwareVertexSkinningDualQuaternion(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const DualQuaternion* const* blendDualQuaternions,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        const __m128 minLengthSq = _mm_set1_ps(1e-30f);
+        const __m128 one = _mm_set1_ps(1.0f);
+
+        // Blended real and dual parts, then positions and normals, of four
+        // vertices. The remaining vertices are padded rather than handed to
+        // the general version, so every vertex gets an identical result.
+        float blended[32];
+        float positions[12];
+        float normals[12];
+        memset(blended, 0, sizeof(blended));
+        memset(positions, 0, sizeof(positions));
+        memset(normals, 0, sizeof(normals));
+
+        while (numVertices)
+        {
+            size_t count = std::min(numVertices, size_t(4));
+            numVertices -= count;
+
+            const float* srcPos = pSrcPos;
+            const float* srcNorm = pSrcNorm;
+            for (size_t i = 0; i < count; ++i)
+            {
+                // Blend the dual quaternions, flipping those in the opposite
+                // hemisphere to the first so the shortest rotation is taken
+                const DualQuaternion& first = *blendDualQuaternions[pBlendIndex[0]];
+                __m128 real = _mm_setzero_ps();
+                __m128 dual = _mm_setzero_ps();
+                for (size_t blendIdx = 0; blendIdx < numWeightsPerVertex; ++blendIdx)
+                {
+                    // NB weights must be normalised!!
+                    float weight = pBlendWeight[blendIdx];
+                    if (weight)
+                    {
+                        const DualQuaternion& dq = *blendDualQuaternions[pBlendIndex[blendIdx]];
+                        if (dq.w * first.w + dq.x * first.x + dq.y * first.y + dq.z * first.z < 0)
+                            weight = -weight;
+                        __m128 w = _mm_set1_ps(weight);
+                        real = __MM_MADD_PS(_mm_loadu_ps(&dq.w), w, real);
+                        dual = __MM_MADD_PS(_mm_loadu_ps(&dq.dw), w, dual);
+                    }
+                }
+                _mm_storeu_ps(blended + i * 4, real);
+                _mm_storeu_ps(blended + 16 + i * 4, dual);
+
+                positions[i * 3 + 0] = srcPos[0];
+                positions[i * 3 + 1] = srcPos[1];
+                positions[i * 3 + 2] = srcPos[2];
+                advanceRawPointer(srcPos, srcPosStride);
+                if (srcNorm)
+                {
+                    normals[i * 3 + 0] = srcNorm[0];
+                    normals[i * 3 + 1] = srcNorm[1];
+                    normals[i * 3 + 2] = srcNorm[2];
+                    advanceRawPointer(srcNorm, srcNormStride);
+                }
+
+                advanceRawPointer(pBlendWeight, blendWeightStride);
+                advanceRawPointer(pBlendIndex, blendIndexStride);
+            }
+
+            // Transpose to real w, x, y, z and dual w, x, y, z of four vertices
+            __m128 rw = _mm_loadu_ps(blended + 0);
+            __m128 rx = _mm_loadu_ps(blended + 4);
+            __m128 ry = _mm_loadu_ps(blended + 8);
+            __m128 rz = _mm_loadu_ps(blended + 12);
+            __MM_TRANSPOSE4x4_PS(rw, rx, ry, rz);
+            __m128 dw = _mm_loadu_ps(blended + 16);
+            __m128 dx = _mm_loadu_ps(blended + 20);
+            __m128 dy = _mm_loadu_ps(blended + 24);
+            __m128 dz = _mm_loadu_ps(blended + 28);
+            __MM_TRANSPOSE4x4_PS(dw, dx, dy, dz);
+
+            // Normalise by the length of the rotation part, at full precision
+            // like the general version
+            __m128 invLength = _mm_div_ps(one, _mm_sqrt_ps(
+                _mm_max_ps(__MM_DOT4x4_PS(rw, rx, ry, rz, rw, rx, ry, rz), minLengthSq)));
+            rw = _mm_mul_ps(rw, invLength);
+            rx = _mm_mul_ps(rx, invLength);
+            ry = _mm_mul_ps(ry, invLength);
+            rz = _mm_mul_ps(rz, invLength);
+            dw = _mm_mul_ps(dw, invLength);
+            dx = _mm_mul_ps(dx, invLength);
+            dy = _mm_mul_ps(dy, invLength);
+            dz = _mm_mul_ps(dz, invLength);
+
+            // Rotate the position, p + 2 r x (r x p + w p), then translate
+            // by 2 (w d - dw r + r x d)
+            __m128 px = _mm_loadu_ps(positions + 0);
+            __m128 py = _mm_loadu_ps(positions + 4);
+            __m128 pz = _mm_loadu_ps(positions + 8);
+            __MM_TRANSPOSE4x3_PS(px, py, pz);
+
+            __m128 tx = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(ry, pz), _mm_mul_ps(rz, py)), _mm_mul_ps(rw, px));
+            __m128 ty = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(rz, px), _mm_mul_ps(rx, pz)), _mm_mul_ps(rw, py));
+            __m128 tz = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(rx, py), _mm_mul_ps(ry, px)), _mm_mul_ps(rw, pz));
+            __m128 ox = _mm_add_ps(
+                _mm_sub_ps(_mm_mul_ps(ry, tz), _mm_mul_ps(rz, ty)),
+                _mm_add_ps(
+                    _mm_sub_ps(_mm_mul_ps(rw, dx), _mm_mul_ps(dw, rx)),
+                    _mm_sub_ps(_mm_mul_ps(ry, dz), _mm_mul_ps(rz, dy))));
+            __m128 oy = _mm_add_ps(
+                _mm_sub_ps(_mm_mul_ps(rz, tx), _mm_mul_ps(rx, tz)),
+                _mm_add_ps(
+                    _mm_sub_ps(_mm_mul_ps(rw, dy), _mm_mul_ps(dw, ry)),
+                    _mm_sub_ps(_mm_mul_ps(rz, dx), _mm_mul_ps(rx, dz))));
+            __m128 oz = _mm_add_ps(
+                _mm_sub_ps(_mm_mul_ps(rx, ty), _mm_mul_ps(ry, tx)),
+                _mm_add_ps(
+                    _mm_sub_ps(_mm_mul_ps(rw, dz), _mm_mul_ps(dw, rz)),
+                    _mm_sub_ps(_mm_mul_ps(rx, dy), _mm_mul_ps(ry, dx))));
+            px = _mm_add_ps(px, _mm_add_ps(ox, ox));
+            py = _mm_add_ps(py, _mm_add_ps(oy, oy));
+            pz = _mm_add_ps(pz, _mm_add_ps(oz, oz));
+
+            __MM_TRANSPOSE3x4_PS(px, py, pz);
+            _mm_storeu_ps(positions + 0, px);
+            _mm_storeu_ps(positions + 4, py);
+            _mm_storeu_ps(positions + 8, pz);
+
+            if (pSrcNorm)
+            {
+                // Rotation only, which keeps unit normals unit length
+                __m128 nx = _mm_loadu_ps(normals + 0);
+                __m128 ny = _mm_loadu_ps(normals + 4);
+                __m128 nz = _mm_loadu_ps(normals + 8);
+                __MM_TRANSPOSE4x3_PS(nx, ny, nz);
+
+                tx = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(ry, nz), _mm_mul_ps(rz, ny)), _mm_mul_ps(rw, nx));
+                ty = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(rz, nx), _mm_mul_ps(rx, nz)), _mm_mul_ps(rw, ny));
+                tz = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(rx, ny), _mm_mul_ps(ry, nx)), _mm_mul_ps(rw, nz));
+                ox = _mm_sub_ps(_mm_mul_ps(ry, tz), _mm_mul_ps(rz, ty));
+                oy = _mm_sub_ps(_mm_mul_ps(rz, tx), _mm_mul_ps(rx, tz));
+                oz = _mm_sub_ps(_mm_mul_ps(rx, ty), _mm_mul_ps(ry, tx));
+                nx = _mm_add_ps(nx, _mm_add_ps(ox, ox));
+                ny = _mm_add_ps(ny, _mm_add_ps(oy, oy));
+                nz = _mm_add_ps(nz, _mm_add_ps(oz, oz));
+
+                __MM_TRANSPOSE3x4_PS(nx, ny, nz);
+                _mm_storeu_ps(normals + 0, nx);
+                _mm_storeu_ps(normals + 4, ny);
+                _mm_storeu_ps(normals + 8, nz);
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                pDestPos[0] = positions[i * 3 + 0];
+                pDestPos[1] = positions[i * 3 + 1];
+                pDestPos[2] = positions[i * 3 + 2];
+                advanceRawPointer(pSrcPos, srcPosStride);
+                advanceRawPointer(pDestPos, destPosStride);
+                if (pSrcNorm)
+                {
+                    pDestNorm[0] = normals[i * 3 + 0];
+                    pDestNorm[1] = normals[i * 3 + 1];
+                    pDestNorm[2] = normals[i * 3 + 2];
+                    advanceRawPointer(pSrcNorm, srcNormStride);
+                    advanceRawPointer(pDestNorm, destNormStride);
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
     void OptimisedUtilSSE::softwareVertexMorph(
         Real t,
         const float *pSrc1, const float *pSrc2,
@@ -1583,6 +2091,147 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    /// Load four xyz vectors with the given stride in bytes into one register per component
+    static OGRE_FORCE_INLINE void loadVector3x4(const float* p, size_t stride,
+        __m128& x, __m128& y, __m128& z)
+    {
+        if (stride == 3 * sizeof(float))
+        {
+            x = _mm_loadu_ps(p + 0);
+            y = _mm_loadu_ps(p + 4);
+            z = _mm_loadu_ps(p + 8);
+        }
+        else
+        {
+            // Loading four floats of each vector might read past the buffer
+            float packed[12];
+            for (size_t i = 0; i < 12; i += 3)
+            {
+                packed[i + 0] = p[0];
+                packed[i + 1] = p[1];
+                packed[i + 2] = p[2];
+                advanceRawPointer(p, stride);
+            }
+            x = _mm_loadu_ps(packed + 0);
+            y = _mm_loadu_ps(packed + 4);
+            z = _mm_loadu_ps(packed + 8);
+        }
+        __MM_TRANSPOSE4x3_PS(x, y, z);
+    }
+    //---------------------------------------------------------------------
+    /// Store four xyz vectors held one register per component with the given stride in bytes
+    static OGRE_FORCE_INLINE void storeVector3x4(float* p, size_t stride,
+        __m128 x, __m128 y, __m128 z)
+    {
+        __MM_TRANSPOSE3x4_PS(x, y, z);
+        if (stride == 3 * sizeof(float))
+        {
+            _mm_storeu_ps(p + 0, x);
+            _mm_storeu_ps(p + 4, y);
+            _mm_storeu_ps(p + 8, z);
+            return;
+        }
+
+        float packed[12];
+        _mm_storeu_ps(packed + 0, x);
+        _mm_storeu_ps(packed + 4, y);
+        _mm_storeu_ps(packed + 8, z);
+        for (size_t i = 0; i < 12; i += 3)
+        {
+            p[0] = packed[i + 0];
+            p[1] = packed[i + 1];
+            p[2] = packed[i + 2];
+            advanceRawPointer(p, stride);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::transformPoints(
+        const Matrix4& m,
+        const float* pSrc, float* pDest,
+        size_t srcStride, size_t destStride,
+        size_t numPoints)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        const __m128 m00 = _mm_set1_ps(m[0][0]), m01 = _mm_set1_ps(m[0][1]),
+            m02 = _mm_set1_ps(m[0][2]), m03 = _mm_set1_ps(m[0][3]);
+        const __m128 m10 = _mm_set1_ps(m[1][0]), m11 = _mm_set1_ps(m[1][1]),
+            m12 = _mm_set1_ps(m[1][2]), m13 = _mm_set1_ps(m[1][3]);
+        const __m128 m20 = _mm_set1_ps(m[2][0]), m21 = _mm_set1_ps(m[2][1]),
+            m22 = _mm_set1_ps(m[2][2]), m23 = _mm_set1_ps(m[2][3]);
+
+        size_t numIterations = numPoints / 4;
+        numPoints &= 3;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m128 x, y, z;
+            loadVector3x4(pSrc, srcStride, x, y, z);
+            storeVector3x4(pDest, destStride,
+                __MM_DOT4x3_PS(m00, m01, m02, m03, x, y, z),
+                __MM_DOT4x3_PS(m10, m11, m12, m13, x, y, z),
+                __MM_DOT4x3_PS(m20, m21, m22, m23, x, y, z));
+
+            advanceRawPointer(pSrc, 4 * srcStride);
+            advanceRawPointer(pDest, 4 * destStride);
+        }
+
+        // Left over points
+        if (numPoints)
+        {
+            _getOptimisedUtilGeneral()->transformPoints(m,
+                pSrc, pDest, srcStride, destStride, numPoints);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::transformDirections(
+        const Matrix4& m,
+        const float* pSrc, float* pDest,
+        size_t srcStride, size_t destStride,
+        size_t numDirections, bool normalise)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        const __m128 m00 = _mm_set1_ps(m[0][0]), m01 = _mm_set1_ps(m[0][1]), m02 = _mm_set1_ps(m[0][2]);
+        const __m128 m10 = _mm_set1_ps(m[1][0]), m11 = _mm_set1_ps(m[1][1]), m12 = _mm_set1_ps(m[1][2]);
+        const __m128 m20 = _mm_set1_ps(m[2][0]), m21 = _mm_set1_ps(m[2][1]), m22 = _mm_set1_ps(m[2][2]);
+        const __m128 one = _mm_set1_ps(1.0f);
+
+        size_t numIterations = numDirections / 4;
+        numDirections &= 3;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m128 x, y, z;
+            loadVector3x4(pSrc, srcStride, x, y, z);
+            __m128 dx = __MM_DOT3x3_PS(m00, m01, m02, x, y, z);
+            __m128 dy = __MM_DOT3x3_PS(m10, m11, m12, x, y, z);
+            __m128 dz = __MM_DOT3x3_PS(m20, m21, m22, x, y, z);
+            if (normalise)
+            {
+                // Full precision, leaving zero length directions alone
+                __m128 length = _mm_sqrt_ps(__MM_DOT3x3_PS(dx, dy, dz, dx, dy, dz));
+                __m128 mask = _mm_cmpgt_ps(length, _mm_setzero_ps());
+                __m128 scale = _mm_or_ps(
+                    _mm_and_ps(mask, _mm_div_ps(one, length)), _mm_andnot_ps(mask, one));
+                dx = _mm_mul_ps(dx, scale);
+                dy = _mm_mul_ps(dy, scale);
+                dz = _mm_mul_ps(dz, scale);
+            }
+            storeVector3x4(pDest, destStride, dx, dy, dz);
+
+            advanceRawPointer(pSrc, 4 * srcStride);
+            advanceRawPointer(pDest, 4 * destStride);
+        }
+
+        // Left over directions
+        if (numDirections)
+        {
+            _getOptimisedUtilGeneral()->transformDirections(m,
+                pSrc, pDest, srcStride, destStride, numDirections, normalise);
+        }
+    }
+    //---------------------------------------------------------------------
     void OptimisedUtilSSE::calculateFaceNormals(
         const float *positions,
         const EdgeData::Triangle *triangles,
@@ -2136,6 +2785,685 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilSSE::cullBoxes(
+        const Plane* planes, size_t numPlanes,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+        uint8* results, size_t numBoxes)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        // Mask clearing the sign bit, for absolute values
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+        size_t numIterations = numBoxes / 4;
+        numBoxes &= 3;
+
+        // Four boxes per iteration, against one plane at a time
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m128 cx = _mm_loadu_ps(centreX);
+            __m128 cy = _mm_loadu_ps(centreY);
+            __m128 cz = _mm_loadu_ps(centreZ);
+            __m128 hx = _mm_loadu_ps(halfSizeX);
+            __m128 hy = _mm_loadu_ps(halfSizeY);
+            __m128 hz = _mm_loadu_ps(halfSizeZ);
+
+            __m128 outside = _mm_setzero_ps();
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                const Plane& plane = planes[p];
+                __m128 nx = _mm_set1_ps(plane.normal.x);
+                __m128 ny = _mm_set1_ps(plane.normal.y);
+                __m128 nz = _mm_set1_ps(plane.normal.z);
+
+                // dist = n . centre + d
+                __m128 dist = _mm_add_ps(__MM_DOT3x3_PS(nx, ny, nz, cx, cy, cz),
+                    _mm_set1_ps(plane.d));
+                // maxAbsDist = |n| . halfSize, half sizes are never negative
+                __m128 maxAbsDist = __MM_DOT3x3_PS(
+                    _mm_and_ps(nx, absMask), _mm_and_ps(ny, absMask), _mm_and_ps(nz, absMask),
+                    hx, hy, hz);
+
+                outside = _mm_or_ps(outside,
+                    _mm_cmplt_ps(dist, _mm_sub_ps(_mm_setzero_ps(), maxAbsDist)));
+            }
+
+            int mask = _mm_movemask_ps(outside);
+            results[0] = !(mask & 1);
+            results[1] = !(mask & 2);
+            results[2] = !(mask & 4);
+            results[3] = !(mask & 8);
+
+            centreX += 4; centreY += 4; centreZ += 4;
+            halfSizeX += 4; halfSizeY += 4; halfSizeZ += 4;
+            results += 4;
+        }
+
+        // Left over boxes
+        if (numBoxes)
+        {
+            _getOptimisedUtilGeneral()->cullBoxes(planes, numPlanes,
+                centreX, centreY, centreZ, halfSizeX, halfSizeY, halfSizeZ,
+                results, numBoxes);
+        }
+    }
+    //---------------------------------------------------------------------
+    /// Store the four lanes of a comparison result as 0 or 1 bytes
+    static OGRE_FORCE_INLINE void storeMaskResults(__m128 mask, uint8* results)
+    {
+        int bits = _mm_movemask_ps(mask);
+        results[0] = (bits & 1) != 0;
+        results[1] = (bits & 2) != 0;
+        results[2] = (bits & 4) != 0;
+        results[3] = (bits & 8) != 0;
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::cullSpheres(
+        const Plane* planes, size_t numPlanes,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* radius,
+        uint8* results, size_t numSpheres)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        size_t numIterations = numSpheres / 4;
+        numSpheres &= 3;
+
+        // Four spheres per iteration, against one plane at a time
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m128 cx = _mm_loadu_ps(centreX);
+            __m128 cy = _mm_loadu_ps(centreY);
+            __m128 cz = _mm_loadu_ps(centreZ);
+            __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius));
+
+            __m128 outside = _mm_setzero_ps();
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                const Plane& plane = planes[p];
+
+                // dist = n . centre + d
+                __m128 dist = _mm_add_ps(__MM_DOT3x3_PS(
+                    _mm_set1_ps(plane.normal.x), _mm_set1_ps(plane.normal.y), _mm_set1_ps(plane.normal.z),
+                    cx, cy, cz), _mm_set1_ps(plane.d));
+
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, negRadius));
+            }
+
+            int mask = _mm_movemask_ps(outside);
+            results[0] = !(mask & 1);
+            results[1] = !(mask & 2);
+            results[2] = !(mask & 4);
+            results[3] = !(mask & 8);
+
+            centreX += 4; centreY += 4; centreZ += 4;
+            radius += 4;
+            results += 4;
+        }
+
+        // Left over spheres
+        if (numSpheres)
+        {
+            _getOptimisedUtilGeneral()->cullSpheres(planes, numPlanes,
+                centreX, centreY, centreZ, radius, results, numSpheres);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::intersectBoxes(
+        const AxisAlignedBox& box,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+        uint8* results, size_t numBoxes)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const Vector3 centre = box.getCenter();
+        const Vector3 halfSize = box.getHalfSize();
+        const __m128 bcx = _mm_set1_ps(centre.x);
+        const __m128 bcy = _mm_set1_ps(centre.y);
+        const __m128 bcz = _mm_set1_ps(centre.z);
+        const __m128 bhx = _mm_set1_ps(halfSize.x);
+        const __m128 bhy = _mm_set1_ps(halfSize.y);
+        const __m128 bhz = _mm_set1_ps(halfSize.z);
+
+        size_t numIterations = numBoxes / 4;
+        numBoxes &= 3;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            // Separated on no axis
+            __m128 overlap = _mm_cmple_ps(
+                _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(centreX), bcx), absMask),
+                _mm_add_ps(_mm_loadu_ps(halfSizeX), bhx));
+            overlap = _mm_and_ps(overlap, _mm_cmple_ps(
+                _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(centreY), bcy), absMask),
+                _mm_add_ps(_mm_loadu_ps(halfSizeY), bhy)));
+            overlap = _mm_and_ps(overlap, _mm_cmple_ps(
+                _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(centreZ), bcz), absMask),
+                _mm_add_ps(_mm_loadu_ps(halfSizeZ), bhz)));
+
+            storeMaskResults(overlap, results);
+
+            centreX += 4; centreY += 4; centreZ += 4;
+            halfSizeX += 4; halfSizeY += 4; halfSizeZ += 4;
+            results += 4;
+        }
+
+        // Left over boxes
+        if (numBoxes)
+        {
+            _getOptimisedUtilGeneral()->intersectBoxes(box,
+                centreX, centreY, centreZ, halfSizeX, halfSizeY, halfSizeZ,
+                results, numBoxes);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::intersectBoxes(
+        const Sphere& sphere,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+        uint8* results, size_t numBoxes)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const __m128 zero = _mm_setzero_ps();
+        const Vector3& centre = sphere.getCenter();
+        const __m128 scx = _mm_set1_ps(centre.x);
+        const __m128 scy = _mm_set1_ps(centre.y);
+        const __m128 scz = _mm_set1_ps(centre.z);
+        const __m128 radiusSq = _mm_set1_ps(Math::Sqr(sphere.getRadius()));
+
+        size_t numIterations = numBoxes / 4;
+        numBoxes &= 3;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            // Distance from the sphere centre to the box along each axis
+            __m128 dx = _mm_max_ps(_mm_sub_ps(
+                _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(centreX), scx), absMask),
+                _mm_loadu_ps(halfSizeX)), zero);
+            __m128 dy = _mm_max_ps(_mm_sub_ps(
+                _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(centreY), scy), absMask),
+                _mm_loadu_ps(halfSizeY)), zero);
+            __m128 dz = _mm_max_ps(_mm_sub_ps(
+                _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(centreZ), scz), absMask),
+                _mm_loadu_ps(halfSizeZ)), zero);
+
+            storeMaskResults(
+                _mm_cmple_ps(__MM_DOT3x3_PS(dx, dy, dz, dx, dy, dz), radiusSq), results);
+
+            centreX += 4; centreY += 4; centreZ += 4;
+            halfSizeX += 4; halfSizeY += 4; halfSizeZ += 4;
+            results += 4;
+        }
+
+        // Left over boxes
+        if (numBoxes)
+        {
+            _getOptimisedUtilGeneral()->intersectBoxes(sphere,
+                centreX, centreY, centreZ, halfSizeX, halfSizeY, halfSizeZ,
+                results, numBoxes);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::intersectBoxes(
+        const Ray& ray,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+        float* distances, uint8* results, size_t numBoxes)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        const Vector3& origin = ray.getOrigin();
+        const Vector3& dir = ray.getDirection();
+        const __m128 ox = _mm_set1_ps(origin.x);
+        const __m128 oy = _mm_set1_ps(origin.y);
+        const __m128 oz = _mm_set1_ps(origin.z);
+        // Axes the ray is parallel to give infinities, which the slab test handles
+        const __m128 ix = _mm_set1_ps(1 / dir.x);
+        const __m128 iy = _mm_set1_ps(1 / dir.y);
+        const __m128 iz = _mm_set1_ps(1 / dir.z);
+        const __m128 infinity = _mm_set1_ps(std::numeric_limits<float>::infinity());
+
+        size_t numIterations = numBoxes / 4;
+        numBoxes &= 3;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m128 tNear = _mm_setzero_ps();
+            __m128 tFar = infinity;
+
+            // Clip against each slab in turn. min/max return their second
+            // operand when either is NaN, which a ray lying in a slab face
+            // gives, so those are ignored.
+#define __CLIP_RAY_SLAB(centre, halfSize, origin, invDir)                       \
+            {                                                                   \
+                __m128 c = _mm_sub_ps(_mm_loadu_ps(centre), origin);            \
+                __m128 h = _mm_loadu_ps(halfSize);                              \
+                __m128 t1 = _mm_mul_ps(_mm_sub_ps(c, h), invDir);               \
+                __m128 t2 = _mm_mul_ps(_mm_add_ps(c, h), invDir);               \
+                tNear = _mm_max_ps(_mm_min_ps(t1, t2), tNear);                  \
+                tFar = _mm_min_ps(_mm_max_ps(t1, t2), tFar);                    \
+            }
+
+            __CLIP_RAY_SLAB(centreX, halfSizeX, ox, ix);
+            __CLIP_RAY_SLAB(centreY, halfSizeY, oy, iy);
+            __CLIP_RAY_SLAB(centreZ, halfSizeZ, oz, iz);
+
+#undef __CLIP_RAY_SLAB
+
+            _mm_storeu_ps(distances, tNear);
+            storeMaskResults(_mm_cmple_ps(tNear, tFar), results);
+
+            centreX += 4; centreY += 4; centreZ += 4;
+            halfSizeX += 4; halfSizeY += 4; halfSizeZ += 4;
+            distances += 4;
+            results += 4;
+        }
+
+        // Left over boxes
+        if (numBoxes)
+        {
+            _getOptimisedUtilGeneral()->intersectBoxes(ray,
+                centreX, centreY, centreZ, halfSizeX, halfSizeY, halfSizeZ,
+                distances, results, numBoxes);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::intersectSpheres(
+        const Sphere& sphere,
+        const float* centreX, const float* centreY, const float* centreZ,
+        const float* radius,
+        uint8* results, size_t numSpheres)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        const Vector3& centre = sphere.getCenter();
+        const __m128 scx = _mm_set1_ps(centre.x);
+        const __m128 scy = _mm_set1_ps(centre.y);
+        const __m128 scz = _mm_set1_ps(centre.z);
+        const __m128 sr = _mm_set1_ps(sphere.getRadius());
+
+        size_t numIterations = numSpheres / 4;
+        numSpheres &= 3;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(centreX), scx);
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(centreY), scy);
+            __m128 dz = _mm_sub_ps(_mm_loadu_ps(centreZ), scz);
+            __m128 r = _mm_add_ps(_mm_loadu_ps(radius), sr);
+
+            storeMaskResults(
+                _mm_cmple_ps(__MM_DOT3x3_PS(dx, dy, dz, dx, dy, dz), _mm_mul_ps(r, r)), results);
+
+            centreX += 4; centreY += 4; centreZ += 4;
+            radius += 4;
+            results += 4;
+        }
+
+        // Left over spheres
+        if (numSpheres)
+        {
+            _getOptimisedUtilGeneral()->intersectSpheres(sphere,
+                centreX, centreY, centreZ, radius, results, numSpheres);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::nlerpQuaternions(
+        const float* t,
+        const float* src1, const float* src2,
+        float* dest, size_t numQuaternions)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+
+        size_t numIterations = numQuaternions / 4;
+        numQuaternions &= 3;
+
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            // Load 4 quaternions of each and transpose to w, x, y, z
+            __m128 w1 = _mm_loadu_ps(src1 + 0);
+            __m128 x1 = _mm_loadu_ps(src1 + 4);
+            __m128 y1 = _mm_loadu_ps(src1 + 8);
+            __m128 z1 = _mm_loadu_ps(src1 + 12);
+            __MM_TRANSPOSE4x4_PS(w1, x1, y1, z1);
+
+            __m128 w2 = _mm_loadu_ps(src2 + 0);
+            __m128 x2 = _mm_loadu_ps(src2 + 4);
+            __m128 y2 = _mm_loadu_ps(src2 + 8);
+            __m128 z2 = _mm_loadu_ps(src2 + 12);
+            __MM_TRANSPOSE4x4_PS(w2, x2, y2, z2);
+
+            // Flip the second to the nearest rotation, by the sign of the dot product
+            __m128 flip = _mm_and_ps(__MM_DOT4x4_PS(w1, x1, y1, z1, w2, x2, y2, z2), signMask);
+            w2 = _mm_xor_ps(w2, flip);
+            x2 = _mm_xor_ps(x2, flip);
+            y2 = _mm_xor_ps(y2, flip);
+            z2 = _mm_xor_ps(z2, flip);
+
+            __m128 f = _mm_loadu_ps(t);
+            __m128 w = __MM_LERP_PS(f, w1, w2);
+            __m128 x = __MM_LERP_PS(f, x1, x2);
+            __m128 y = __MM_LERP_PS(f, y1, y2);
+            __m128 z = __MM_LERP_PS(f, z1, z2);
+
+            // Bone orientations need more precision than rsqrt alone gives normals
+            __m128 factor = __mm_rsqrt_nr_ps(__MM_DOT4x4_PS(w, x, y, z, w, x, y, z));
+            w = _mm_mul_ps(w, factor);
+            x = _mm_mul_ps(x, factor);
+            y = _mm_mul_ps(y, factor);
+            z = _mm_mul_ps(z, factor);
+
+            __MM_TRANSPOSE4x4_PS(w, x, y, z);
+            _mm_storeu_ps(dest + 0, w);
+            _mm_storeu_ps(dest + 4, x);
+            _mm_storeu_ps(dest + 8, y);
+            _mm_storeu_ps(dest + 12, z);
+
+            t += 4;
+            src1 += 16;
+            src2 += 16;
+            dest += 16;
+        }
+
+        // Left over quaternions
+        if (numQuaternions)
+        {
+            _getOptimisedUtilGeneral()->nlerpQuaternions(t,
+                src1, src2, dest, numQuaternions);
+        }
+    }
+#if __OGRE_HAVE_SSE2
+    //---------------------------------------------------------------------
+    /** Reorder the bytes of four 4 byte pixels, one term per destination byte
+        taken from the source, each a right shift, a mask and a left shift.
+    */
+    static OGRE_FORCE_INLINE __m128i shuffleBytes4(__m128i x,
+        const __m128i* rightShifts, const __m128i* leftShifts, size_t numTerms,
+        __m128i fill)
+    {
+        const __m128i byteMask = _mm_set1_epi32(0xFF);
+        __m128i result = fill;
+        for (size_t t = 0; t < numTerms; ++t)
+        {
+            result = _mm_or_si128(result, _mm_sll_epi32(
+                _mm_and_si128(_mm_srl_epi32(x, rightShifts[t]), byteMask), leftShifts[t]));
+        }
+        return result;
+    }
+    //---------------------------------------------------------------------
+    /// Convert four half floats, zero extended to 32 bits, to floats
+    static OGRE_FORCE_INLINE __m128 halfToFloat4(__m128i h)
+    {
+        __m128i expMant = _mm_and_si128(h, _mm_set1_epi32(0x7FFF));
+        __m128i sign = _mm_slli_epi32(_mm_xor_si128(h, expMant), 16);
+
+        // Normal numbers, infinities and NaNs just need the exponent rebiasing
+        __m128i normal = _mm_add_epi32(_mm_slli_epi32(expMant, 13), _mm_set1_epi32(112 << 23));
+        __m128i infNaN = _mm_cmpgt_epi32(expMant, _mm_set1_epi32(0x7BFF));
+        normal = _mm_or_si128(normal, _mm_and_si128(infNaN, _mm_set1_epi32(0x7F800000)));
+
+        // Denormals are the mantissa scaled by 2^-24, which is exact
+        __m128 denormal = _mm_mul_ps(_mm_cvtepi32_ps(expMant), _mm_set1_ps(1.0f / 16777216.0f));
+        __m128i isDenormal = _mm_cmplt_epi32(expMant, _mm_set1_epi32(0x0400));
+
+        __m128i result = _mm_or_si128(
+            _mm_and_si128(isDenormal, _mm_castps_si128(denormal)),
+            _mm_andnot_si128(isDenormal, normal));
+        return _mm_castsi128_ps(_mm_or_si128(result, sign));
+    }
+    //---------------------------------------------------------------------
+    /// Select b where mask is set, a elsewhere
+    static OGRE_FORCE_INLINE __m128i selectInt(__m128i mask, __m128i a, __m128i b)
+    {
+        return _mm_or_si128(_mm_andnot_si128(mask, a), _mm_and_si128(mask, b));
+    }
+    //---------------------------------------------------------------------
+    /** Convert four floats to half floats in the lower 16 bits of each element,
+        following Bitwise::floatToHalfI case by case, truncating.
+    */
+    static OGRE_FORCE_INLINE __m128i floatToHalf4(__m128 f)
+    {
+        __m128i x = _mm_castps_si128(f);
+        __m128i absX = _mm_and_si128(x, _mm_set1_epi32(0x7FFFFFFF));
+        __m128i sign = _mm_and_si128(_mm_srli_epi32(x, 16), _mm_set1_epi32(0x8000));
+        __m128i mant = _mm_and_si128(x, _mm_set1_epi32(0x007FFFFF));
+
+        // Denormal halves, the value scaled by 2^24 and truncated
+        __m128i result = _mm_cvttps_epi32(
+            _mm_mul_ps(_mm_castsi128_ps(absX), _mm_set1_ps(16777216.0f)));
+        // Normal halves, rebias the exponent and truncate the mantissa
+        result = selectInt(_mm_cmpgt_epi32(absX, _mm_set1_epi32((113 << 23) - 1)),
+            result, _mm_sub_epi32(_mm_srli_epi32(absX, 13), _mm_set1_epi32(112 << 10)));
+        // Overflow to infinity
+        result = selectInt(_mm_cmpgt_epi32(absX, _mm_set1_epi32((143 << 23) - 1)),
+            result, _mm_set1_epi32(0x7C00));
+        // Infinity and NaN, keeping a mantissa bit so NaNs stay NaNs
+        __m128i halfMant = _mm_srli_epi32(mant, 13);
+        __m128i keepNaN = _mm_andnot_si128(_mm_cmpeq_epi32(mant, _mm_setzero_si128()),
+            _mm_and_si128(_mm_cmpeq_epi32(halfMant, _mm_setzero_si128()), _mm_set1_epi32(1)));
+        result = selectInt(_mm_cmpgt_epi32(absX, _mm_set1_epi32(0x7F7FFFFF)),
+            result, _mm_or_si128(_mm_set1_epi32(0x7C00), _mm_or_si128(halfMant, keepNaN)));
+
+        // Values too small even for a denormal become zero, without the sign
+        return _mm_or_si128(result,
+            _mm_and_si128(_mm_cmpgt_epi32(absX, _mm_set1_epi32((102 << 23) - 1)), sign));
+    }
+#endif // __OGRE_HAVE_SSE2
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::shufflePixels(
+        const uint8* src, size_t srcPixelSize,
+        uint8* dest, size_t destPixelSize,
+        const int8* shuffle, size_t numPixels)
+    {
+#if __OGRE_HAVE_SSE2
+        // Without byte shuffles, only the conversions to 4 byte pixels from 4 or
+        // 1 byte ones can be done as whole elements
+        if (mHasSSE2 && destPixelSize == 4 && (srcPixelSize == 4 || srcPixelSize == 1))
+        {
+            __m128i rightShifts[4], leftShifts[4];
+            size_t numTerms = 0;
+            uint32 fill = 0;
+            for (int b = 0; b < 4; ++b)
+            {
+                if (shuffle[b] < 0)
+                {
+                    fill |= 0xFFu << (b * 8);
+                }
+                else
+                {
+                    rightShifts[numTerms] = _mm_cvtsi32_si128(shuffle[b] * 8);
+                    leftShifts[numTerms] = _mm_cvtsi32_si128(b * 8);
+                    ++numTerms;
+                }
+            }
+            const __m128i fillBytes = _mm_set1_epi32(static_cast<int>(fill));
+
+            if (srcPixelSize == 4)
+            {
+                size_t numIterations = numPixels / 4;
+                numPixels &= 3;
+
+                for (size_t i = 0; i < numIterations; ++i)
+                {
+                    __m128i x = _mm_loadu_si128((const __m128i*)src);
+                    _mm_storeu_si128((__m128i*)dest,
+                        shuffleBytes4(x, rightShifts, leftShifts, numTerms, fillBytes));
+                    src += 16;
+                    dest += 16;
+                }
+            }
+            else
+            {
+                const __m128i zero = _mm_setzero_si128();
+                size_t numIterations = numPixels / 16;
+                numPixels &= 15;
+
+                for (size_t i = 0; i < numIterations; ++i)
+                {
+                    // Widen sixteen bytes to four registers of 32 bit elements
+                    __m128i x = _mm_loadu_si128((const __m128i*)src);
+                    __m128i lo = _mm_unpacklo_epi8(x, zero);
+                    __m128i hi = _mm_unpackhi_epi8(x, zero);
+                    _mm_storeu_si128((__m128i*)dest + 0, shuffleBytes4(
+                        _mm_unpacklo_epi16(lo, zero), rightShifts, leftShifts, numTerms, fillBytes));
+                    _mm_storeu_si128((__m128i*)dest + 1, shuffleBytes4(
+                        _mm_unpackhi_epi16(lo, zero), rightShifts, leftShifts, numTerms, fillBytes));
+                    _mm_storeu_si128((__m128i*)dest + 2, shuffleBytes4(
+                        _mm_unpacklo_epi16(hi, zero), rightShifts, leftShifts, numTerms, fillBytes));
+                    _mm_storeu_si128((__m128i*)dest + 3, shuffleBytes4(
+                        _mm_unpackhi_epi16(hi, zero), rightShifts, leftShifts, numTerms, fillBytes));
+                    src += 16;
+                    dest += 64;
+                }
+            }
+        }
+#endif // __OGRE_HAVE_SSE2
+
+        // Left over pixels, or other pixel sizes
+        if (numPixels)
+        {
+            _getOptimisedUtilGeneral()->shufflePixels(src, srcPixelSize,
+                dest, destPixelSize, shuffle, numPixels);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::convertHalfToFloat(
+        const uint16* src, float* dest, size_t count)
+    {
+#if __OGRE_HAVE_SSE2
+        if (mHasSSE2)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            size_t numIterations = count / 8;
+            count &= 7;
+
+            for (size_t i = 0; i < numIterations; ++i)
+            {
+                __m128i h = _mm_loadu_si128((const __m128i*)src);
+                _mm_storeu_ps(dest + 0, halfToFloat4(_mm_unpacklo_epi16(h, zero)));
+                _mm_storeu_ps(dest + 4, halfToFloat4(_mm_unpackhi_epi16(h, zero)));
+                src += 8;
+                dest += 8;
+            }
+        }
+#endif // __OGRE_HAVE_SSE2
+
+        // Left over values
+        if (count)
+        {
+            _getOptimisedUtilGeneral()->convertHalfToFloat(src, dest, count);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::convertFloatToHalf(
+        const float* src, uint16* dest, size_t count)
+    {
+#if __OGRE_HAVE_SSE2
+        if (mHasSSE2)
+        {
+            size_t numIterations = count / 8;
+            count &= 7;
+
+            for (size_t i = 0; i < numIterations; ++i)
+            {
+                __m128i lo = floatToHalf4(_mm_loadu_ps(src + 0));
+                __m128i hi = floatToHalf4(_mm_loadu_ps(src + 4));
+                // Sign extend, so the saturating pack keeps all 16 bits
+                lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+                hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+                _mm_storeu_si128((__m128i*)dest, _mm_packs_epi32(lo, hi));
+                src += 8;
+                dest += 8;
+            }
+        }
+#endif // __OGRE_HAVE_SSE2
+
+        // Left over values
+        if (count)
+        {
+            _getOptimisedUtilGeneral()->convertFloatToHalf(src, dest, count);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::sumWeightedRows(
+        const float* const* rows, const float* weights, size_t numRows,
+        float* dest, size_t count)
+    {
+        size_t numIterations = count / 8;
+        size_t i = 0;
+
+        for (size_t n = 0; n < numIterations; ++n, i += 8)
+        {
+            __m128 w = _mm_load_ps1(weights);
+            __m128 sum0 = _mm_mul_ps(w, _mm_loadu_ps(rows[0] + i));
+            __m128 sum1 = _mm_mul_ps(w, _mm_loadu_ps(rows[0] + i + 4));
+            for (size_t k = 1; k < numRows; ++k)
+            {
+                w = _mm_load_ps1(weights + k);
+                sum0 = _mm_add_ps(sum0, _mm_mul_ps(w, _mm_loadu_ps(rows[k] + i)));
+                sum1 = _mm_add_ps(sum1, _mm_mul_ps(w, _mm_loadu_ps(rows[k] + i + 4)));
+            }
+            _mm_storeu_ps(dest + i, sum0);
+            _mm_storeu_ps(dest + i + 4, sum1);
+        }
+
+        // Left over values, the rows can't be offset for the general version
+        for (; i < count; ++i)
+        {
+            float sum = weights[0] * rows[0][i];
+            for (size_t k = 1; k < numRows; ++k)
+                sum += weights[k] * rows[k][i];
+            dest[i] = sum;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::convertFloatToByte(
+        const float* src, uint8* dest, size_t count)
+    {
+#if __OGRE_HAVE_SSE2
+        if (mHasSSE2)
+        {
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 maximum = _mm_set1_ps(255.0f);
+            const __m128 half = _mm_set1_ps(0.5f);
+
+            size_t numIterations = count / 16;
+            count &= 15;
+
+            for (size_t i = 0; i < numIterations; ++i)
+            {
+                __m128i v[4];
+                for (size_t j = 0; j < 4; ++j)
+                {
+                    // max returns its second operand for NaNs, so they become zero
+                    __m128 f = _mm_max_ps(_mm_loadu_ps(src + j * 4), zero);
+                    f = _mm_add_ps(_mm_min_ps(f, maximum), half);
+                    v[j] = _mm_cvttps_epi32(f);
+                }
+                __m128i shorts0 = _mm_packs_epi32(v[0], v[1]);
+                __m128i shorts1 = _mm_packs_epi32(v[2], v[3]);
+                _mm_storeu_si128((__m128i*)dest, _mm_packus_epi16(shorts0, shorts1));
+
+                src += 16;
+                dest += 16;
+            }
+        }
+#endif  // __OGRE_HAVE_SSE2
+
+        // Left over values
+        if (count)
+        {
+            _getOptimisedUtilGeneral()->convertFloatToByte(src, dest, count);
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilSSE(void)
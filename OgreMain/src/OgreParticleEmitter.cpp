@@ -345,6 +345,22 @@ namespace Ogre
 
     }
     //-----------------------------------------------------------------------
+    void ParticleEmitter::genEmissionAttributes(Particle** particles, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            Particle* p = particles[i];
+
+            // Generate complex data by reference
+            genEmissionColour(p->mColour);
+            genEmissionDirection( p->mPosition, p->mDirection );
+            genEmissionVelocity(p->mDirection);
+
+            // Generate simpler data
+            p->mTimeToLive = p->mTotalTimeToLive = genEmissionTTL();
+        }
+    }
+    //-----------------------------------------------------------------------
     void ParticleEmitter::genEmissionColour(ColourValue& destColour)
     {
         if (mColourRangeStart != mColourRangeEnd)
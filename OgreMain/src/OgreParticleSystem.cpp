@@ -72,7 +72,14 @@ namespace Ogre {
 
         Real getValue(void) const { return 0; } // N/A
 
-        void setValue(Real value) { mTarget->_update(value); }
+        void setValue(Real value)
+        {
+            ParticleSystemManager& mgr = ParticleSystemManager::getSingleton();
+            if (mgr.getParallelUpdate())
+                mgr._queueUpdate(mTarget, value);
+            else
+                mTarget->_update(value);
+        }
 
     };
     //-----------------------------------------------------------------------
@@ -96,6 +103,8 @@ namespace Ogre {
         mTimeController(0),
         mEmittedEmitterPoolInitialised(false),
         mIsEmitting(true),
+        mConcurrentUpdateTime(0),
+        mConcurrentBoundsChanged(false),
         mRenderer(0),
         mCullIndividual(false),
         mPoolSize(0),
@@ -129,6 +138,8 @@ namespace Ogre {
         mTimeController(0),
         mEmittedEmitterPoolInitialised(false),
         mIsEmitting(true),
+        mConcurrentUpdateTime(0),
+        mConcurrentBoundsChanged(false),
         mRenderer(0), 
         mCullIndividual(false),
         mPoolSize(0),
@@ -152,6 +163,7 @@ namespace Ogre {
             // Destroy controller
             ControllerManager::getSingleton().destroyController(mTimeController);
             mTimeController = 0;
+            ParticleSystemManager::getSingleton()._cancelUpdate(this);
         }
 
         // Arrange for the deletion of emitters & affectors
@@ -162,10 +174,10 @@ namespace Ogre {
         // Deallocate all particles
         destroyVisualParticles(0, mParticlePool.size());
         // Free pool items
-        ParticlePool::iterator i;
-        for (i = mParticlePool.begin(); i != mParticlePool.end(); ++i)
+        ParticleBlockList::iterator i;
+        for (i = mParticleBlocks.begin(); i != mParticleBlocks.end(); ++i)
         {
-            OGRE_DELETE *i;
+            OGRE_DELETE [] *i;
         }
 
         if (mRenderer)
@@ -366,10 +378,47 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::_update(Real timeElapsed)
+    {
+        if (!prepareUpdate(timeElapsed))
+            return;
+
+        // Scale incoming speed for the rest of the calculation
+        updateParticles(timeElapsed * mSpeedFactor);
+        _updateBounds();
+    }
+    //-----------------------------------------------------------------------
+    bool ParticleSystem::_prepareConcurrentUpdate(Real timeElapsed)
+    {
+        if (!prepareUpdate(timeElapsed))
+            return false;
+
+        // Bring the cached node transforms up to date while nothing else runs,
+        // emission and bounds only read them afterwards
+        mParentNode->_getFullTransform();
+
+        mConcurrentUpdateTime = timeElapsed * mSpeedFactor;
+        mConcurrentBoundsChanged = false;
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::_updateConcurrent(void)
+    {
+        updateParticles(mConcurrentUpdateTime);
+        mConcurrentBoundsChanged = calculateBounds();
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::_finishConcurrentUpdate(void)
+    {
+        if (mConcurrentBoundsChanged && mParentNode)
+            mParentNode->needUpdate();
+        mConcurrentBoundsChanged = false;
+    }
+    //-----------------------------------------------------------------------
+    bool ParticleSystem::prepareUpdate(Real timeElapsed)
     {
         // Only update if attached to a node
         if (!mParentNode)
-            return;
+            return false;
 
         Real nonvisibleTimeout = mNonvisibleTimeoutSet ?
             mNonvisibleTimeout : msDefaultNonvisibleTimeout;
@@ -385,20 +434,29 @@ namespace Ogre {
                 if (mTimeSinceLastVisible >= nonvisibleTimeout)
                 {
                     // No update
-                    return;
+                    return false;
                 }
             }
         }
 
-        // Scale incoming speed for the rest of the calculation
-        timeElapsed *= mSpeedFactor;
-
         // Init renderer if not done already
         configureRenderer();
 
         // Initialise emitted emitters list if not done already
         initialiseEmittedEmitters();
 
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::updateParticles(Real timeElapsed)
+    {
+        if (mRenderer && mRenderer->_simulatesParticles())
+        {
+            // The renderer keeps its own particles
+            mRenderer->_simulateParticles(this, timeElapsed);
+            return;
+        }
+
         Real iterationInterval = mIterationIntervalSet ? 
             mIterationInterval : msDefaultIterationInterval;
         if (iterationInterval > 0)
@@ -437,21 +495,26 @@ namespace Ogre {
 
         if (!mBoundsAutoUpdate && mBoundsUpdateTime > 0.0f)
             mBoundsUpdateTime -= timeElapsed; // count down 
-        _updateBounds();
-
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::_expire(Real timeElapsed)
     {
-        ActiveParticleList::iterator i, itEnd;
+        ActiveParticleList::iterator i, itEnd, itLive;
         Particle* pParticle;
         ParticleEmitter* pParticleEmitter;
 
         itEnd = mActiveParticles.end();
 
-        for (i = mActiveParticles.begin(); i != itEnd; )
+        // Active emitted emitters are collected again from the survivors below,
+        // rather than searched for and erased one by one
+        bool hasEmittedEmitters = !mActiveEmittedEmitters.empty();
+        mActiveEmittedEmitters.clear();
+
+        // Compact the surviving particles to the front of the list in one pass,
+        // keeping their order
+        for (i = itLive = mActiveParticles.begin(); i != itEnd; ++i)
         {
-            pParticle = static_cast<Particle*>(*i);
+            pParticle = *i;
             if (pParticle->mTimeToLive < timeElapsed)
             {
                 // Notify renderer
@@ -461,37 +524,36 @@ namespace Ogre {
                 if (pParticle->mParticleType == Particle::Visual)
                 {
                     // Destroy this one
-                    mFreeParticles.splice(mFreeParticles.end(), mActiveParticles, i++);
+                    mFreeParticles.push_back(pParticle);
                 }
                 else
                 {
                     // For now, it can only be an emitted emitter
-                    pParticleEmitter = static_cast<ParticleEmitter*>(*i);
-                    list<ParticleEmitter*>::type* fee = findFreeEmittedEmitter(pParticleEmitter->getName());
+                    pParticleEmitter = static_cast<ParticleEmitter*>(pParticle);
+                    FreeEmittedEmitterList* fee = findFreeEmittedEmitter(pParticleEmitter->getName());
                     fee->push_back(pParticleEmitter);
-
-                    // Also erase from mActiveEmittedEmitters
-                    removeFromActiveEmittedEmitters (pParticleEmitter);
-
-                    // And erase from mActiveParticles
-                    i = mActiveParticles.erase( i );
                 }
             }
             else
             {
                 // Decrement TTL
                 pParticle->mTimeToLive -= timeElapsed;
-                ++i;
+                *itLive++ = pParticle;
+
+                if (hasEmittedEmitters && pParticle->mParticleType == Particle::Emitter)
+                    mActiveEmittedEmitters.push_back(static_cast<ParticleEmitter*>(pParticle));
             }
 
         }
+
+        mActiveParticles.erase(itLive, itEnd);
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::_triggerEmitters(Real timeElapsed)
     {
         // Add up requests for emission
-        static vector<unsigned>::type requested;
-        static vector<unsigned>::type emittedRequested;
+        vector<unsigned>::type& requested = mEmitterRequests;
+        vector<unsigned>::type& emittedRequested = mEmittedEmitterRequests;
 
         if( requested.size() != mEmitters.size() )
             requested.resize( mEmitters.size() );
@@ -572,22 +634,35 @@ namespace Ogre {
 
         Real timeInc = timeElapsed / requested;
 
+        // Create the new particles first, then init them all at once using the emitter
+        // The particles are visual particles if the emit_emitter property of the emitter isn't set 
+        const String& emitterName = emitter->getEmittedEmitter();
+        FreeEmittedEmitterList* fee = 0;
+        if (emitterName != BLANKSTRING)
+        {
+            fee = findFreeEmittedEmitter(emitterName);
+            if (!fee)
+                return;
+        }
+
+        mEmitBatch.clear();
         for (unsigned int j = 0; j < requested; ++j)
         {
-            // Create a new particle & init using emitter
-            // The particle is a visual particle if the emit_emitter property of the emitter isn't set 
-            Particle* p = 0;
-            String  emitterName = emitter->getEmittedEmitter();
-            if (emitterName == BLANKSTRING)
-                p = createParticle();
-            else
-                p = createEmitterParticle(emitterName);
+            Particle* p = fee ? popFreeEmittedEmitter(fee) : createParticle();
 
             // Only continue if the particle was really created (not null)
             if (!p)
-                return;
+                break;
+            mEmitBatch.push_back(p);
+        }
+        if (mEmitBatch.empty())
+            return;
+
+        emitter->_initParticles(&mEmitBatch[0], mEmitBatch.size());
 
-            emitter->_initParticle(p);
+        for (size_t j = 0; j < mEmitBatch.size(); ++j)
+        {
+            Particle* p = mEmitBatch[j];
 
             // Translate position & direction into world space
             if (!mLocalSpace)
@@ -662,15 +737,20 @@ namespace Ogre {
     void ParticleSystem::increasePool(size_t size)
     {
         size_t oldSize = mParticlePool.size();
+        if (size <= oldSize)
+            return;
 
         // Increase size
-        mParticlePool.reserve(size);
         mParticlePool.resize(size);
+        mActiveParticles.reserve(size);
+        mFreeParticles.reserve(size);
 
-        // Create new particles
+        // Create new particles in one contiguous block
+        Particle* block = OGRE_NEW Particle[size - oldSize];
+        mParticleBlocks.push_back(block);
         for( size_t i = oldSize; i < size; i++ )
         {
-            mParticlePool[i] = OGRE_NEW Particle();
+            mParticlePool[i] = block + (i - oldSize);
         }
 
         if (mIsRendererConfigured)
@@ -689,9 +769,7 @@ namespace Ogre {
     Particle* ParticleSystem::getParticle(size_t index) 
     {
         assert (index < mActiveParticles.size() && "Index out of bounds!");
-        ActiveParticleList::iterator i = mActiveParticles.begin();
-        std::advance(i, index);
-        return *i;
+        return mActiveParticles[index];
     }
     //-----------------------------------------------------------------------
     Particle* ParticleSystem::createParticle(void)
@@ -700,8 +778,9 @@ namespace Ogre {
         if (!mFreeParticles.empty())
         {
             // Fast creation (don't use superclass since emitter will init)
-            p = mFreeParticles.front();
-            mActiveParticles.splice(mActiveParticles.end(), mFreeParticles, mFreeParticles.begin());
+            p = mFreeParticles.back();
+            mFreeParticles.pop_back();
+            mActiveParticles.push_back(p);
 
             p->_notifyOwner(this);
         }
@@ -713,13 +792,18 @@ namespace Ogre {
     Particle* ParticleSystem::createEmitterParticle(const String& emitterName)
     {
         // Get the appropriate list and retrieve an emitter 
+        FreeEmittedEmitterList* fee = findFreeEmittedEmitter(emitterName);
+        return fee ? popFreeEmittedEmitter(fee) : 0;
+    }
+    //-----------------------------------------------------------------------
+    Particle* ParticleSystem::popFreeEmittedEmitter(FreeEmittedEmitterList* fee)
+    {
         Particle* p = 0;
-        list<ParticleEmitter*>::type* fee = findFreeEmittedEmitter(emitterName);
-        if (fee && !fee->empty())
+        if (!fee->empty())
         {
-            p = fee->front();
+            p = fee->back();
             p->mParticleType = Particle::Emitter;
-            fee->pop_front();
+            fee->pop_back();
             mActiveParticles.push_back(p);
 
             // Also add to mActiveEmittedEmitters. This is needed to traverse through all active emitters
@@ -818,6 +902,15 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void ParticleSystem::_updateBounds()
     {
+        if (calculateBounds())
+            mParentNode->needUpdate();
+    }
+    //-----------------------------------------------------------------------
+    bool ParticleSystem::calculateBounds()
+    {
+        // Renderers simulating their own particles set the bounds themselves
+        if (mRenderer && mRenderer->_simulatesParticles())
+            return false;
 
         if (mParentNode && (mBoundsAutoUpdate || mBoundsUpdateTime > 0.0f))
         {
@@ -866,6 +959,8 @@ namespace Ogre {
                 }
                 mWorldAABB.setExtents(min, max);
             }
+            // mWorldAABB no longer matches the cached local box
+            invalidateWorldBoundingBox();
 
 
             if (mLocalSpace)
@@ -885,8 +980,9 @@ namespace Ogre {
                 mAABB.merge(newAABB);
             }
 
-            mParentNode->needUpdate();
+            return true;
         }
+        return false;
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::fastForward(Real time, Real interval)
@@ -1020,6 +1116,7 @@ namespace Ogre {
             // Destroy controller
             ControllerManager::getSingleton().destroyController(mTimeController);
             mTimeController = 0;
+            ParticleSystemManager::getSingleton()._cancelUpdate(this);
         }
     }
     //-----------------------------------------------------------------------
@@ -1047,8 +1144,14 @@ namespace Ogre {
             mRenderer->_notifyParticleCleared(mActiveParticles);
         }
 
-        // Move actives to free list
-        mFreeParticles.splice(mFreeParticles.end(), mActiveParticles);
+        // Move visual actives to free list, emitted emitters are returned below
+        ActiveParticleList::iterator i, itEnd = mActiveParticles.end();
+        for (i = mActiveParticles.begin(); i != itEnd; ++i)
+        {
+            if ((*i)->mParticleType == Particle::Visual)
+                mFreeParticles.push_back(*i);
+        }
+        mActiveParticles.clear();
 
         // Add active emitted emitters to free list
         addActiveEmittedEmittersToFreeList();
@@ -1079,9 +1182,10 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void ParticleSystem::configureRenderer(void)
     {
-        // Actual allocate particles
+        // Actual allocate particles, unless the renderer simulates its own
+        bool simulated = mRenderer && mRenderer->_simulatesParticles();
         size_t currSize = mParticlePool.size();
-        size_t size = mPoolSize;
+        size_t size = simulated ? 0 : mPoolSize;
         if( currSize < size )
         {
             this->increasePool(size);
@@ -1101,7 +1205,7 @@ namespace Ogre {
 
         if (mRenderer && !mIsRendererConfigured)
         {
-            mRenderer->_notifyParticleQuota(mParticlePool.size());
+            mRenderer->_notifyParticleQuota(simulated ? mPoolSize : mParticlePool.size());
             mRenderer->_notifyAttached(mParentNode, mParentIsTagPoint);
             mRenderer->_notifyDefaultDimensions(mDefaultWidth, mDefaultHeight);
             createVisualParticles(0, mParticlePool.size());
@@ -1397,7 +1501,7 @@ namespace Ogre {
         EmittedEmitterPool::iterator emittedEmitterPoolIterator;
         EmittedEmitterList::iterator emittedEmitterIterator;
         EmittedEmitterList* emittedEmitters = 0;
-        list<ParticleEmitter*>::type* fee = 0;
+        FreeEmittedEmitterList* fee = 0;
         String name = BLANKSTRING;
 
         // Run through the emittedEmitterPool map
@@ -1448,7 +1552,7 @@ namespace Ogre {
         mActiveEmittedEmitters.clear();
     }
     //-----------------------------------------------------------------------
-    list<ParticleEmitter*>::type* ParticleSystem::findFreeEmittedEmitter (const String& name)
+    ParticleSystem::FreeEmittedEmitterList* ParticleSystem::findFreeEmittedEmitter (const String& name)
     {
         FreeEmittedEmitterMap::iterator it;
         it = mFreeEmittedEmitters.find (name);
@@ -1480,7 +1584,7 @@ namespace Ogre {
         ActiveEmittedEmitterList::iterator itActiveEmit;
         for (itActiveEmit = mActiveEmittedEmitters.begin(); itActiveEmit != mActiveEmittedEmitters.end(); ++itActiveEmit)
         {
-            list<ParticleEmitter*>::type* fee = findFreeEmittedEmitter ((*itActiveEmit)->getName());
+            FreeEmittedEmitterList* fee = findFreeEmittedEmitter ((*itActiveEmit)->getName());
             if (fee)
                 fee->push_back(*itActiveEmit);
         }
@@ -37,12 +37,30 @@ THE SOFTWARE.
 #include "OgreBillboardParticleRenderer.h"
 #include "OgreScriptCompiler.h"
 #include "OgreParticleSystem.h"
+#include "OgreWorkQueue.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
     // Shortcut to set up billboard particle renderer
     BillboardParticleRendererFactory* mBillboardRendererFactory = 0;
     //-----------------------------------------------------------------------
+    namespace
+    {
+        /// Updates a range of prepared particle systems, for parallelFor
+        class ParticleSystemUpdateTask : public WorkQueue::ParallelTask
+        {
+            ParticleSystem** mSystems;
+        public:
+            ParticleSystemUpdateTask(ParticleSystem** systems) : mSystems(systems) {}
+
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                    mSystems[i]->_updateConcurrent();
+            }
+        };
+    }
+    //-----------------------------------------------------------------------
     template<> ParticleSystemManager* Singleton<ParticleSystemManager>::msSingleton = 0;
     ParticleSystemManager* ParticleSystemManager::getSingletonPtr(void)
     {
@@ -54,6 +72,7 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     ParticleSystemManager::ParticleSystemManager()
+        : mParallelUpdate(false)
     {
         OGRE_LOCK_AUTO_MUTEX;
         mFactory = OGRE_NEW ParticleSystemFactory();
@@ -358,6 +377,58 @@ namespace Ogre {
         pFact->second->destroyInstance(renderer);
     }
     //-----------------------------------------------------------------------
+    void ParticleSystemManager::setParallelUpdate(bool parallel)
+    {
+        if (!parallel)
+            _updateQueuedSystems();
+        mParallelUpdate = parallel;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_queueUpdate(ParticleSystem* sys, Real timeElapsed)
+    {
+        mQueuedUpdates.push_back(std::make_pair(sys, timeElapsed));
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_cancelUpdate(ParticleSystem* sys)
+    {
+        QueuedUpdateList::iterator i = mQueuedUpdates.begin();
+        while (i != mQueuedUpdates.end())
+        {
+            if (i->first == sys)
+                i = mQueuedUpdates.erase(i);
+            else
+                ++i;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_updateQueuedSystems(void)
+    {
+        if (mQueuedUpdates.empty())
+            return;
+
+        // Renderer setup, material loading and node transforms stay on this thread
+        mUpdatingSystems.clear();
+        QueuedUpdateList::iterator i, iend = mQueuedUpdates.end();
+        for (i = mQueuedUpdates.begin(); i != iend; ++i)
+        {
+            if (i->first->_prepareConcurrentUpdate(i->second))
+                mUpdatingSystems.push_back(i->first);
+        }
+        mQueuedUpdates.clear();
+
+        if (mUpdatingSystems.empty())
+            return;
+
+        // Most systems are small, so hand a few out at once
+        ParticleSystemUpdateTask task(&mUpdatingSystems[0]);
+        Root::getSingleton().getWorkQueue()->parallelFor(mUpdatingSystems.size(), 4, &task);
+
+        vector<ParticleSystem*>::type::iterator s, send = mUpdatingSystems.end();
+        for (s = mUpdatingSystems.begin(); s != send; ++s)
+            (*s)->_finishConcurrentUpdate();
+        mUpdatingSystems.clear();
+    }
+    //-----------------------------------------------------------------------
     void ParticleSystemManager::_initialise(void)
     {
         OGRE_LOCK_AUTO_MUTEX;
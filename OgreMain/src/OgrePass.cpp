@@ -146,6 +146,7 @@ namespace Ogre {
         : mParent(parent)
         , mIndex(index)
         , mHash(0)
+        , mSortKey(0)
         , mHashDirtyQueued(false)
         , mAmbient(ColourValue::White)
         , mDiffuse(ColourValue::White)
@@ -259,6 +260,7 @@ namespace Ogre {
     {
         mName = oth.mName;
         mHash = oth.mHash;
+        mSortKey = oth.mSortKey;
         mAmbient = oth.mAmbient;
         mDiffuse = oth.mDiffuse;
         mSpecular = oth.mSpecular;
@@ -907,6 +909,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Pass::setSceneBlending(SceneBlendFactor sourceFactor, SceneBlendFactor destFactor)
     {
+        if (mSourceBlendFactor != sourceFactor || mDestBlendFactor != destFactor)
+            _dirtyHash();
         mSourceBlendFactor = sourceFactor;
         mDestBlendFactor = destFactor;
 
@@ -915,6 +919,9 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Pass::setSeparateSceneBlending( const SceneBlendFactor sourceFactor, const SceneBlendFactor destFactor, const SceneBlendFactor sourceFactorAlpha, const SceneBlendFactor destFactorAlpha )
     {
+        if (mSourceBlendFactor != sourceFactor || mDestBlendFactor != destFactor ||
+            mSourceBlendFactorAlpha != sourceFactorAlpha || mDestBlendFactorAlpha != destFactorAlpha)
+            _dirtyHash();
         mSourceBlendFactor = sourceFactor;
         mDestBlendFactor = destFactor;
         mSourceBlendFactorAlpha = sourceFactorAlpha;
@@ -950,12 +957,16 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Pass::setSceneBlendingOperation(SceneBlendOperation op)
     {
+        if (mBlendOperation != op)
+            _dirtyHash();
         mBlendOperation = op;
         mSeparateBlendOperation = false;
     }
     //-----------------------------------------------------------------------
     void Pass::setSeparateSceneBlendingOperation(SceneBlendOperation op, SceneBlendOperation alphaOp)
     {
+        if (mBlendOperation != op || mAlphaBlendOperation != alphaOp)
+            _dirtyHash();
         mBlendOperation = op;
         mAlphaBlendOperation = alphaOp;
         mSeparateBlendOperation = true;
@@ -995,6 +1006,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Pass::setDepthCheckEnabled(bool enabled)
     {
+        if (mDepthCheck != enabled)
+            _dirtyHash();
         mDepthCheck = enabled;
     }
     //-----------------------------------------------------------------------
@@ -1005,6 +1018,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Pass::setDepthWriteEnabled(bool enabled)
     {
+        if (mDepthWrite != enabled)
+            _dirtyHash();
         mDepthWrite = enabled;
     }
     //-----------------------------------------------------------------------
@@ -1015,6 +1030,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Pass::setDepthFunction( CompareFunction func)
     {
+        if (mDepthFunc != func)
+            _dirtyHash();
         mDepthFunc = func;
     }
     //-----------------------------------------------------------------------
@@ -1463,10 +1480,8 @@ namespace Ogre {
             // Needs recompilation
             mParent->_notifyNeedsRecompile();
 
-            if( Pass::getHashFunction() == Pass::getBuiltinHashFunction( Pass::MIN_GPU_PROGRAM_CHANGE ) )
-            {
-                _dirtyHash();
-            }
+            // Programs are part of the sort key whichever hash function is used
+            _dirtyHash();
 
         }
     }
@@ -1506,10 +1521,8 @@ namespace Ogre {
             // Needs recompilation
             mParent->_notifyNeedsRecompile();
 
-            if( Pass::getHashFunction() == Pass::getBuiltinHashFunction( Pass::MIN_GPU_PROGRAM_CHANGE ) )
-            {
-                _dirtyHash();
-            }
+            // Programs are part of the sort key whichever hash function is used
+            _dirtyHash();
         }
     }
     //-----------------------------------------------------------------------
@@ -1548,10 +1561,8 @@ namespace Ogre {
             // Needs recompilation
             mParent->_notifyNeedsRecompile();
 
-            if( Pass::getHashFunction() == Pass::getBuiltinHashFunction( Pass::MIN_GPU_PROGRAM_CHANGE ) )
-            {
-                _dirtyHash();
-            }
+            // Programs are part of the sort key whichever hash function is used
+            _dirtyHash();
         }
     }
     //-----------------------------------------------------------------------
@@ -1590,10 +1601,8 @@ namespace Ogre {
             // Needs recompilation
             mParent->_notifyNeedsRecompile();
 
-            if( Pass::getHashFunction() == Pass::getBuiltinHashFunction( Pass::MIN_GPU_PROGRAM_CHANGE ) )
-            {
-                _dirtyHash();
-            }
+            // Programs are part of the sort key whichever hash function is used
+            _dirtyHash();
         }
     }
     //-----------------------------------------------------------------------
@@ -1632,10 +1641,8 @@ namespace Ogre {
             // Needs recompilation
             mParent->_notifyNeedsRecompile();
 
-            if( Pass::getHashFunction() == Pass::getBuiltinHashFunction( Pass::MIN_GPU_PROGRAM_CHANGE ) )
-            {
-                _dirtyHash();
-            }
+            // Programs are part of the sort key whichever hash function is used
+            _dirtyHash();
         }
     }
     //-----------------------------------------------------------------------
@@ -1674,10 +1681,8 @@ namespace Ogre {
             // Needs recompilation
             mParent->_notifyNeedsRecompile();
 
-            if( Pass::getHashFunction() == Pass::getBuiltinHashFunction( Pass::MIN_GPU_PROGRAM_CHANGE ) )
-            {
-                _dirtyHash();
-            }
+            // Programs are part of the sort key whichever hash function is used
+            _dirtyHash();
         }
     }
     //-----------------------------------------------------------------------
@@ -1887,6 +1892,44 @@ namespace Ogre {
            the first 2 gives us the most benefit for now.
        */
         mHash = (*msHashFunc)(this);
+
+        uint32 programHash = 0;
+        {
+            OGRE_LOCK_MUTEX(mGpuProgramChangeMutex);
+            const GpuProgramUsage* usages[] = { mVertexProgramUsage, mFragmentProgramUsage,
+                mGeometryProgramUsage, mTessellationHullProgramUsage,
+                mTessellationDomainProgramUsage, mComputeProgramUsage };
+            for (size_t i = 0; i < sizeof(usages) / sizeof(usages[0]); ++i)
+            {
+                const String& name = usages[i] ? usages[i]->getProgramName() : BLANKSTRING;
+                programHash = FastHash(name.c_str(), static_cast<int>(name.size()),
+                    HashCombine(programHash, i));
+            }
+        }
+        uint32 textureHash = 0;
+        {
+            OGRE_LOCK_MUTEX(mTexUnitChangeMutex);
+            for (size_t i = 0; i < mTextureUnitStates.size(); ++i)
+            {
+                const String& name = mTextureUnitStates[i]->getTextureName();
+                textureHash = FastHash(name.c_str(), static_cast<int>(name.size()),
+                    HashCombine(textureHash, i));
+            }
+        }
+        uint32 blendHash = HashCombine(0, mSourceBlendFactor);
+        blendHash = HashCombine(blendHash, mDestBlendFactor);
+        blendHash = HashCombine(blendHash, mSourceBlendFactorAlpha);
+        blendHash = HashCombine(blendHash, mDestBlendFactorAlpha);
+        blendHash = HashCombine(blendHash, mBlendOperation);
+        blendHash = HashCombine(blendHash, mAlphaBlendOperation);
+        uint32 depthState = (mDepthCheck ? 0x10 : 0) | (mDepthWrite ? 0x8 : 0) |
+            (static_cast<uint32>(mDepthFunc) & 0x7);
+
+        mSortKey = (static_cast<uint64>(std::min<unsigned short>(mIndex, 15)) << 60) |
+            (static_cast<uint64>(programHash & 0xFFFF) << 44) |
+            (static_cast<uint64>(textureHash & 0xFFFF) << 28) |
+            (static_cast<uint64>(blendHash & 0x7F) << 21) |
+            (static_cast<uint64>(depthState) << 16);
     }
     //-----------------------------------------------------------------------
     void Pass::_dirtyHash(void)
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgreColourValue.h"
 #include "OgreException.h"
 #include "OgrePixelFormatDescriptions.h"
+#include "OgreOptimisedUtil.h"
 
 namespace {
 #include "OgrePixelConversions.h"
@@ -133,17 +134,45 @@ namespace Ogre {
                 case PF_PVRTC2_4BPP:
                     return (std::max((int)width, 8) * std::max((int)height, 8) * 4 + 7) / 8;
 
+                // ETC works on 4x4 blocks too, of 64 bits, with another 64 bits
+                // of alpha for RGBA8
                 case PF_ETC1_RGB8:
                 case PF_ETC2_RGB8:
-                case PF_ETC2_RGBA8:
                 case PF_ETC2_RGB8A1:
-                    return ((width * height) >> 1);
+                    return ((width + 3) / 4) * ((height + 3) / 4) * 8 * depth;
+                case PF_ETC2_RGBA8:
+                    return ((width + 3) / 4) * ((height + 3) / 4) * 16 * depth;
                 case PF_ATC_RGB:
                     return ((width + 3) / 4) * ((height + 3) / 4) * 8;
                 case PF_ATC_RGBA_EXPLICIT_ALPHA:
                 case PF_ATC_RGBA_INTERPOLATED_ALPHA:
                     return ((width + 3) / 4) * ((height + 3) / 4) * 16;
 
+                // ASTC blocks are always 128 bits, only their footprint varies
+                case PF_ASTC_RGBA_4X4_LDR:
+                case PF_ASTC_RGBA_5X4_LDR:
+                case PF_ASTC_RGBA_5X5_LDR:
+                case PF_ASTC_RGBA_6X5_LDR:
+                case PF_ASTC_RGBA_6X6_LDR:
+                case PF_ASTC_RGBA_8X5_LDR:
+                case PF_ASTC_RGBA_8X6_LDR:
+                case PF_ASTC_RGBA_8X8_LDR:
+                case PF_ASTC_RGBA_10X5_LDR:
+                case PF_ASTC_RGBA_10X6_LDR:
+                case PF_ASTC_RGBA_10X8_LDR:
+                case PF_ASTC_RGBA_10X10_LDR:
+                case PF_ASTC_RGBA_12X10_LDR:
+                case PF_ASTC_RGBA_12X12_LDR:
+                {
+                    static const uint32 blockSizes[][2] = {
+                        {4, 4}, {5, 4}, {5, 5}, {6, 5}, {6, 6}, {8, 5}, {8, 6},
+                        {8, 8}, {10, 5}, {10, 6}, {10, 8}, {10, 10}, {12, 10}, {12, 12}
+                    };
+                    const uint32* block = blockSizes[format - PF_ASTC_RGBA_4X4_LDR];
+                    return ((width + block[0] - 1) / block[0]) *
+                        ((height + block[1] - 1) / block[1]) * 16 * depth;
+                }
+
                 default:
                 OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid compressed pixel format",
                     "PixelUtil::getMemorySize");
@@ -680,6 +709,177 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    /**
+    * Work out the byte of a pixel holding a channel, returning false if the
+    * channel isn't a whole byte.
+    */
+    static bool getChannelByte(unsigned char bits, uint64 mask, unsigned char shift, int8 &byte)
+    {
+        if(bits != 8 || mask != ((uint64)0xFF << shift))
+            return false;
+        byte = (int8)(shift / 8);
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    /**
+    * Whether a format is made up only of whole native endian bytes, so that
+    * conversion between two of them is just a shuffle of bytes.
+    */
+    static bool isByteShuffleFormat(const PixelFormatDescription &des)
+    {
+        if(!(des.flags & PFF_NATIVEENDIAN) ||
+            (des.flags & (PFF_FLOAT | PFF_COMPRESSED | PFF_DEPTH | PFF_INTEGER)) ||
+            des.componentType != PCT_BYTE ||
+            des.elemBytes < 1 || des.elemBytes > 4)
+            return false;
+
+        const unsigned char bits[4] = { des.rbits, des.gbits, des.bbits, des.abits };
+        for(int i = 0; i < 4; ++i)
+        {
+            if(bits[i] != 0 && bits[i] != 8)
+                return false;
+        }
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    /**
+    * Convert between the formats OptimisedUtil has SIMD routines for: half and
+    * full float formats with the same channels, and formats made of whole bytes
+    * on little endian machines. Results match the brute force conversion
+    * exactly. Returns false if the pair of formats isn't handled.
+    */
+    static bool doSIMDConversion(const PixelBox &src, const PixelBox &dst)
+    {
+        enum { CONVERT_HALF_TO_FLOAT, CONVERT_FLOAT_TO_HALF, CONVERT_SHUFFLE } mode;
+        size_t numChannels = 0;
+        int8 shuffle[4];
+
+        const PixelFormatDescription &srcDes = getDescriptionFor(src.format);
+        const PixelFormatDescription &dstDes = getDescriptionFor(dst.format);
+
+        switch(FMTCONVERTERID(src.format, dst.format))
+        {
+        case FMTCONVERTERID(PF_FLOAT16_R, PF_FLOAT32_R):
+        case FMTCONVERTERID(PF_FLOAT16_GR, PF_FLOAT32_GR):
+        case FMTCONVERTERID(PF_FLOAT16_RGB, PF_FLOAT32_RGB):
+        case FMTCONVERTERID(PF_FLOAT16_RGBA, PF_FLOAT32_RGBA):
+            mode = CONVERT_HALF_TO_FLOAT;
+            numChannels = srcDes.componentCount;
+            break;
+        case FMTCONVERTERID(PF_FLOAT32_R, PF_FLOAT16_R):
+        case FMTCONVERTERID(PF_FLOAT32_GR, PF_FLOAT16_GR):
+        case FMTCONVERTERID(PF_FLOAT32_RGB, PF_FLOAT16_RGB):
+        case FMTCONVERTERID(PF_FLOAT32_RGBA, PF_FLOAT16_RGBA):
+            mode = CONVERT_FLOAT_TO_HALF;
+            numChannels = srcDes.componentCount;
+            break;
+        default:
+            {
+#if OGRE_ENDIAN == OGRE_ENDIAN_BIG
+                // Byte indices below are for little endian layouts
+                return false;
+#else
+                // The shuffle routines can't work in place
+                if(!isByteShuffleFormat(srcDes) || !isByteShuffleFormat(dstDes) ||
+                    src.data == dst.data)
+                    return false;
+
+                const unsigned char dstBits[4] = { dstDes.rbits, dstDes.gbits, dstDes.bbits, dstDes.abits };
+                const unsigned char dstShift[4] = { dstDes.rshift, dstDes.gshift, dstDes.bshift, dstDes.ashift };
+                const uint64 dstMask[4] = { dstDes.rmask, dstDes.gmask, dstDes.bmask, dstDes.amask };
+                const unsigned char srcBits[4] = { srcDes.rbits, srcDes.gbits, srcDes.bbits, srcDes.abits };
+                const uint64 srcMask[4] = { srcDes.rmask, srcDes.gmask, srcDes.bmask, srcDes.amask };
+                const unsigned char srcShift[4] = { srcDes.rshift, srcDes.gshift, srcDes.bshift, srcDes.ashift };
+
+                // Every destination byte must be written by exactly one channel
+                bool covered[4] = { false, false, false, false };
+                // Luminance destinations only store the red channel
+                const int numDstChannels = (dstDes.flags & PFF_LUMINANCE) ? 1 : 4;
+                for(int c = 0; c < numDstChannels; ++c)
+                {
+                    if(dstBits[c] == 0)
+                        continue;
+                    int8 dstByte;
+                    if(!getChannelByte(dstBits[c], dstMask[c], dstShift[c], dstByte) ||
+                        (size_t)dstByte >= dstDes.elemBytes || covered[dstByte])
+                        return false;
+                    covered[dstByte] = true;
+
+                    if(c < 3 && (srcDes.flags & PFF_LUMINANCE))
+                    {
+                        // Luminance provides all the colour channels
+                        if(!getChannelByte(srcBits[0], srcMask[0], srcShift[0], shuffle[dstByte]))
+                            return false;
+                    }
+                    else if(c == 3 && srcBits[3] == 0)
+                    {
+                        // Missing alpha reads as opaque
+                        shuffle[dstByte] = -1;
+                    }
+                    else if(!getChannelByte(srcBits[c], srcMask[c], srcShift[c], shuffle[dstByte]))
+                    {
+                        return false;
+                    }
+                }
+                for(size_t b = 0; b < dstDes.elemBytes; ++b)
+                {
+                    if(!covered[b])
+                        return false;
+                }
+                mode = CONVERT_SHUFFLE;
+#endif
+            }
+            break;
+        }
+
+        const size_t srcPixelSize = srcDes.elemBytes;
+        const size_t dstPixelSize = dstDes.elemBytes;
+        OptimisedUtil* util = OptimisedUtil::getImplementation();
+
+        const uint8 *srcptr = static_cast<const uint8*>(src.getTopLeftFrontPixelPtr());
+        uint8 *dstptr = static_cast<uint8*>(dst.getTopLeftFrontPixelPtr());
+
+        // Everything in one go when consecutive, otherwise row by row
+        size_t numPixels, numRows, numSlices;
+        if(src.isConsecutive() && dst.isConsecutive())
+        {
+            numPixels = src.getWidth() * src.getHeight() * src.getDepth();
+            numRows = numSlices = 1;
+        }
+        else
+        {
+            numPixels = src.getWidth();
+            numRows = src.getHeight();
+            numSlices = src.getDepth();
+        }
+
+        for(size_t z = 0; z < numSlices; ++z)
+        {
+            const uint8 *srcrow = srcptr + z * src.slicePitch * srcPixelSize;
+            uint8 *dstrow = dstptr + z * dst.slicePitch * dstPixelSize;
+            for(size_t y = 0; y < numRows; ++y)
+            {
+                switch(mode)
+                {
+                case CONVERT_HALF_TO_FLOAT:
+                    util->convertHalfToFloat(reinterpret_cast<const uint16*>(srcrow),
+                        reinterpret_cast<float*>(dstrow), numPixels * numChannels);
+                    break;
+                case CONVERT_FLOAT_TO_HALF:
+                    util->convertFloatToHalf(reinterpret_cast<const float*>(srcrow),
+                        reinterpret_cast<uint16*>(dstrow), numPixels * numChannels);
+                    break;
+                case CONVERT_SHUFFLE:
+                    util->shufflePixels(srcrow, srcPixelSize, dstrow, dstPixelSize, shuffle, numPixels);
+                    break;
+                }
+                srcrow += src.rowPitch * srcPixelSize;
+                dstrow += dst.rowPitch * dstPixelSize;
+            }
+        }
+        return true;
+    }
+    //-----------------------------------------------------------------------
     /* Convert pixels from one format to another */
     void PixelUtil::bulkPixelConversion(void *srcp, PixelFormat srcFormat,
         void *destp, PixelFormat dstFormat, unsigned int count)
@@ -782,6 +982,12 @@ namespace Ogre {
 
 // NB VC6 can't handle the templates required for optimised conversion, tough
 #if OGRE_COMPILER != OGRE_COMPILER_MSVC || OGRE_COMP_VER >= 1300
+        // Can the conversion be done with SIMD routines?
+        if(doSIMDConversion(src, dst))
+        {
+            return;
+        }
+
         // Is there a specialized, inlined, conversion?
         if(doOptimizedConversion(src, dst))
         {
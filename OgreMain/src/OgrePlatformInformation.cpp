@@ -154,7 +154,15 @@ namespace Ogre {
     static uint _performCpuid(int query, CpuidResult& result)
     {
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
-    #if _MSC_VER >= 1400 
+    #if _MSC_VER >= 1500
+        int CPUInfo[4];
+        __cpuidex(CPUInfo, query, 0);
+        result._eax = CPUInfo[0];
+        result._ebx = CPUInfo[1];
+        result._ecx = CPUInfo[2];
+        result._edx = CPUInfo[3];
+        return result._eax;
+    #elif _MSC_VER >= 1400
         int CPUInfo[4];
         __cpuid(CPUInfo, query);
         result._eax = CPUInfo[0];
@@ -167,6 +175,7 @@ namespace Ogre {
         {
             mov     edi, result
             mov     eax, query
+            xor     ecx, ecx
             cpuid
             mov     [edi]._eax, eax
             mov     [edi]._ebx, ebx
@@ -179,7 +188,7 @@ namespace Ogre {
         #if OGRE_ARCH_TYPE == OGRE_ARCHITECTURE_64
         __asm__
         (
-            "cpuid": "=a" (result._eax), "=b" (result._ebx), "=c" (result._ecx), "=d" (result._edx) : "a" (query)
+            "cpuid": "=a" (result._eax), "=b" (result._ebx), "=c" (result._ecx), "=d" (result._edx) : "a" (query), "c" (0)
         );
         #else
         __asm__
@@ -189,11 +198,36 @@ namespace Ogre {
             "movl   %%ebx, %%edi    \n\t"
             "popl   %%ebx           \n\t"
             : "=a" (result._eax), "=D" (result._ebx), "=c" (result._ecx), "=d" (result._edx)
-            : "a" (query)
+            : "a" (query), "c" (0)
         );
        #endif // OGRE_ARCHITECTURE_64
         return result._eax;
 
+#else
+        // TODO: Supports other compiler
+        return 0;
+#endif
+    }
+
+    //---------------------------------------------------------------------
+    // Reads extended control register 0, which tells which register states
+    // the operating system saves. Only valid if CPUID reports OSXSAVE.
+    static uint _readXcr0(void)
+    {
+#if OGRE_COMPILER == OGRE_COMPILER_MSVC
+    #if _MSC_FULL_VER >= 160040219
+        return static_cast<uint>(_xgetbv(0));
+    #else
+        return 0;
+    #endif
+#elif (OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG) && OGRE_PLATFORM != OGRE_PLATFORM_NACL && OGRE_PLATFORM != OGRE_PLATFORM_EMSCRIPTEN
+        uint eax, edx;
+        // xgetbv, spelt out for assemblers which don't know it
+        __asm__ __volatile__
+        (
+            ".byte 0x0f, 0x01, 0xd0" : "=a" (eax), "=d" (edx) : "c" (0)
+        );
+        return eax;
 #else
         // TODO: Supports other compiler
         return 0;
@@ -285,6 +319,7 @@ namespace Ogre {
 
 #define CPUID_FUNC_VENDOR_ID                 0x0
 #define CPUID_FUNC_STANDARD_FEATURES         0x1
+#define CPUID_FUNC_STRUCTURED_FEATURES       0x7
 #define CPUID_FUNC_EXTENSION_QUERY           0x80000000
 #define CPUID_FUNC_EXTENDED_FEATURES         0x80000001
 #define CPUID_FUNC_ADVANCED_POWER_MANAGEMENT 0x80000007
@@ -300,6 +335,14 @@ namespace Ogre {
 #define CPUID_STD_SSE3              (1<<0)      // ECX[0]  - Bit 0 of standard function 1 indicate SSE3 supported
 #define CPUID_STD_SSE41             (1<<19)     // ECX[19] - Bit 0 of standard function 1 indicate SSE41 supported
 #define CPUID_STD_SSE42             (1<<20)     // ECX[20] - Bit 0 of standard function 1 indicate SSE42 supported
+#define CPUID_STD_FMA               (1<<12)     // ECX[12] - Bit 12 of standard function 1 indicate FMA3 supported
+#define CPUID_STD_OSXSAVE           (1<<27)     // ECX[27] - Bit 27 of standard function 1 indicate OS uses XSAVE/XRSTOR
+#define CPUID_STD_AVX               (1<<28)     // ECX[28] - Bit 28 of standard function 1 indicate AVX supported
+#define CPUID_STD_F16C              (1<<29)     // ECX[29] - Bit 29 of standard function 1 indicate F16C supported
+
+#define CPUID_SF_AVX2               (1<<5)      // EBX[5]  - Bit 5 of structured function 7 indicate AVX2 supported
+
+#define XCR0_SSE_AVX_STATE          0x6         // XMM and YMM register state saved by the OS
 
 #define CPUID_FAMILY_ID_MASK        0x0F00      // EAX[11:8] - Bit 11 thru 8 contains family  processor id
 #define CPUID_EXT_FAMILY_ID_MASK    0x0F00000   // EAX[23:20] - Bit 23 thru 20 contains extended family processor id
@@ -320,7 +363,8 @@ namespace Ogre {
             CpuidResult result;
 
             // Has standard feature ?
-            if (_performCpuid(CPUID_FUNC_VENDOR_ID, result))
+            const uint maxStandardFunctionSupport = _performCpuid(CPUID_FUNC_VENDOR_ID, result);
+            if (maxStandardFunctionSupport)
             {
                 // Check vendor strings
                 if (memcmp(&result._ebx, "GenuineIntel", 12) == 0)
@@ -416,6 +460,28 @@ namespace Ogre {
                             features |= PlatformInformation::CPU_FEATURE_INVARIANT_TSC;
                     }
                 }
+
+                // AVX family, reported the same way by every vendor. The upper
+                // halves of the YMM registers are only usable if the OS saves them.
+                _performCpuid(CPUID_FUNC_STANDARD_FEATURES, result);
+                if ((result._ecx & CPUID_STD_OSXSAVE) &&
+                    (_readXcr0() & XCR0_SSE_AVX_STATE) == XCR0_SSE_AVX_STATE)
+                {
+                    if (result._ecx & CPUID_STD_AVX)
+                        features |= PlatformInformation::CPU_FEATURE_AVX;
+                    if (result._ecx & CPUID_STD_FMA)
+                        features |= PlatformInformation::CPU_FEATURE_FMA;
+                    if (result._ecx & CPUID_STD_F16C)
+                        features |= PlatformInformation::CPU_FEATURE_F16C;
+
+                    if (maxStandardFunctionSupport >= CPUID_FUNC_STRUCTURED_FEATURES)
+                    {
+                        _performCpuid(CPUID_FUNC_STRUCTURED_FEATURES, result);
+
+                        if (result._ebx & CPUID_SF_AVX2)
+                            features |= PlatformInformation::CPU_FEATURE_AVX2;
+                    }
+                }
             }
         }
 
@@ -431,7 +497,11 @@ namespace Ogre {
             | PlatformInformation::CPU_FEATURE_SSE2
             | PlatformInformation::CPU_FEATURE_SSE3
             | PlatformInformation::CPU_FEATURE_SSE41
-            | PlatformInformation::CPU_FEATURE_SSE42;
+            | PlatformInformation::CPU_FEATURE_SSE42
+            | PlatformInformation::CPU_FEATURE_AVX
+            | PlatformInformation::CPU_FEATURE_AVX2
+            | PlatformInformation::CPU_FEATURE_FMA
+            | PlatformInformation::CPU_FEATURE_F16C;
 
         if ((features & sse_features) && !_checkOperatingSystemSupportSSE())
         {
@@ -518,6 +588,12 @@ namespace Ogre {
     {
         uint features = 0;
         uint64_t cpufeatures = android_getCpuFeatures();
+
+        // ARM64 has its own feature bits, and Advanced SIMD is always there
+        if (android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM64)
+        {
+            return PlatformInformation::CPU_FEATURE_NEON | PlatformInformation::CPU_FEATURE_VFP;
+        }
         
         if (cpufeatures & ANDROID_CPU_ARM_FEATURE_NEON) 
         {
@@ -569,10 +645,10 @@ namespace Ogre {
     {
         // Use preprocessor definitions to determine architecture and CPU features
         uint features = 0;
-#if defined(__ARM_NEON__)
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
 #if OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS
-        int hasNEON;
-        size_t len = sizeof(size_t);
+        int hasNEON = 0;
+        size_t len = sizeof(hasNEON);
         sysctlbyname("hw.optional.neon", &hasNEON, &len, NULL, 0);
 
         if(hasNEON)
@@ -699,6 +775,14 @@ namespace Ogre {
                 " *        SSE41: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_SSE41), true));
             pLog->logMessage(
                 " *        SSE42: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_SSE42), true));
+            pLog->logMessage(
+                " *          AVX: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_AVX), true));
+            pLog->logMessage(
+                " *         AVX2: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_AVX2), true));
+            pLog->logMessage(
+                " *          FMA: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_FMA), true));
+            pLog->logMessage(
+                " *         F16C: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_F16C), true));
             pLog->logMessage(
                 " *          MMX: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_MMX), true));
             pLog->logMessage(
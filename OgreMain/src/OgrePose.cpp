@@ -32,7 +32,7 @@ THE SOFTWARE.
 namespace Ogre {
     //---------------------------------------------------------------------
     Pose::Pose(ushort target, const String& name)
-        : mTarget(target), mName(name)
+        : mTarget(target), mName(name), mTextureOffset(0)
     {
     }
     //---------------------------------------------------------------------
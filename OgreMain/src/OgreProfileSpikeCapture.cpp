@@ -0,0 +1,233 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreProfileSpikeCapture.h"
+#include "OgreGpuProgramManager.h"
+#include "OgreLogManager.h"
+#include "OgreRoot.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    ProfileSpikeCapture::ProfileSpikeCapture(size_t capacity, size_t numFrames)
+        : ProfileTraceListener(capacity)
+        , mFrameCount(0)
+        , mDepth(0)
+        , mThreshold(50000)
+        , mFramesBefore(0)
+        , mFramesAfter(0)
+        , mRenderTarget(0)
+        , mMaxCaptures(10)
+        , mNumSpikes(0)
+        , mPendingFrames(0)
+        , mPendingSpike(0)
+    {
+        assert(numFrames > 1 && "The frame ring buffer needs a capacity");
+        mFrames.resize(numFrames);
+        setFramesAround(30, 10);
+    }
+    //-----------------------------------------------------------------------
+    ProfileSpikeCapture::~ProfileSpikeCapture()
+    {
+    }
+    //-----------------------------------------------------------------------
+    void ProfileSpikeCapture::initializeSession()
+    {
+        ProfileTraceListener::initializeSession();
+        mFrameCount = 0;
+        mDepth = 0;
+        mPendingFrames = 0;
+    }
+    //-----------------------------------------------------------------------
+    void ProfileSpikeCapture::profileStarted(const String& profileName, ulong startTime)
+    {
+        ++mDepth;
+    }
+    //-----------------------------------------------------------------------
+    void ProfileSpikeCapture::profileEnded(const String& profileName, ulong startTime, ulong endTime)
+    {
+        ProfileTraceListener::profileEnded(profileName, startTime, endTime);
+
+        // profiles begun before the session are not counted in mDepth
+        if (mDepth == 0)
+            return;
+        if (--mDepth == 0)
+            frameEnded(startTime, endTime);
+    }
+    //-----------------------------------------------------------------------
+    void ProfileSpikeCapture::setFramesAround(size_t before, size_t after)
+    {
+        // the spike itself is kept too
+        const size_t available = mFrames.size() - 1;
+        mFramesAfter = std::min(after, available);
+        mFramesBefore = std::min(before, available - mFramesAfter);
+    }
+    //-----------------------------------------------------------------------
+    void ProfileSpikeCapture::frameEnded(ulong startTime, ulong endTime)
+    {
+        Frame& frame = mFrames[mFrameCount % mFrames.size()];
+        frame.startTime = startTime;
+        frame.duration = endTime - startTime;
+        frame.frameNumber = Root::getSingletonPtr() ? Root::getSingleton().getNextFrameNumber() : 0;
+        frame.hasStats = mRenderTarget != 0;
+        if (mRenderTarget)
+            frame.stats = mRenderTarget->getStatistics();
+        const size_t number = mFrameCount++;
+
+        if (mPendingFrames && --mPendingFrames == 0)
+            capture(mPendingSpike, mFramesBefore, mFramesAfter);
+
+        // spikes following the pending one are part of its capture
+        if (frame.duration > mThreshold)
+        {
+            ++mNumSpikes;
+            if (!mPendingFrames && mCaptureFiles.size() < mMaxCaptures)
+            {
+                mPendingSpike = number;
+                mPendingFrames = mFramesAfter;
+                if (!mPendingFrames)
+                    capture(number, mFramesBefore, 0);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    String ProfileSpikeCapture::captureNow(void)
+    {
+        if (!mFrameCount)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE, "No frame was recorded yet",
+                "ProfileSpikeCapture::captureNow");
+        }
+        return capture(mFrameCount - 1, mFramesBefore, 0);
+    }
+    //-----------------------------------------------------------------------
+    String ProfileSpikeCapture::capture(size_t spike, size_t before, size_t after)
+    {
+        const size_t oldest = mFrameCount - getNumFrames();
+        const size_t first = spike - std::min(before, spike - oldest);
+        const size_t count = spike + after + 1 - first;
+        const Frame& frame = getFrame(spike);
+
+        StringStream name;
+        name << "spike_" << frame.frameNumber << "_" << frame.duration / 1000 << "ms.json";
+        String filename = mCaptureDirectory.empty() ? name.str() : mCaptureDirectory + "/" + name.str();
+
+        std::ofstream of(filename.c_str());
+        if (!of)
+        {
+            LogManager::getSingleton().logMessage(
+                "ProfileSpikeCapture: cannot open '" + filename + "' for writing", LML_CRITICAL);
+            return BLANKSTRING;
+        }
+        writeFrames(of, first - oldest, count);
+        mCaptureFiles.push_back(filename);
+
+        // the compiles are the usual suspects, so name them in the log too
+        const Frame& last = getFrame(first + count - 1);
+        const ulong begin = getFrame(first).startTime;
+        const ulong end = last.startTime + last.duration;
+        Log::Stream log = LogManager::getSingleton().stream();
+        log << "Frame spike of " << frame.duration / 1000.0f << " ms in frame " << frame.frameNumber
+            << " captured to '" << filename << "'";
+        if (GpuProgramManager::getSingletonPtr())
+        {
+            GpuProgramManager::CompileTimingList timings =
+                GpuProgramManager::getSingleton().getCompileTimings();
+            for (GpuProgramManager::CompileTimingList::iterator i = timings.begin(); i != timings.end(); ++i)
+            {
+                if (i->startTime >= begin && i->startTime <= end)
+                    log << "\n    program " << i->name << ": " << i->microseconds << " us";
+            }
+        }
+        return filename;
+    }
+    //-----------------------------------------------------------------------
+    void ProfileSpikeCapture::writeFrames(std::ostream& stream, size_t first, size_t count) const
+    {
+        const size_t oldest = mFrameCount - getNumFrames();
+        first += oldest;
+        count = std::min(count, mFrameCount - std::min(first, mFrameCount));
+        if (!count)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "No kept frame in the range",
+                "ProfileSpikeCapture::writeFrames");
+        }
+
+        const Frame& last = getFrame(first + count - 1);
+        const ulong begin = getFrame(first).startTime;
+        const ulong end = last.startTime + last.duration;
+        bool firstEvent = true;
+
+        stream << "{\"traceEvents\":[";
+        writeEvents(stream, begin, end, firstEvent);
+
+        // the frames and the programs go to processes of their own
+        stream << (firstEvent ? "\n" : ",\n")
+            << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Frames\"}},\n"
+            << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"args\":{\"name\":\"GPU programs\"}}";
+        for (size_t i = first; i != first + count; ++i)
+        {
+            const Frame& frame = getFrame(i);
+            stream << ",\n{\"name\":\"Frame " << frame.frameNumber
+                << (frame.duration > mThreshold ? " (spike)" : "")
+                << "\",\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":" << frame.startTime
+                << ",\"dur\":" << frame.duration;
+            if (frame.hasStats)
+            {
+                const RenderTarget::FrameStats& stats = frame.stats;
+                stream << ",\"args\":{\"batches\":" << stats.batchCount
+                    << ",\"triangles\":" << stats.triangleCount
+                    << ",\"programBinds\":" << stats.programBinds
+                    << ",\"textureBinds\":" << stats.textureBinds
+                    << ",\"lockedBytes\":" << stats.lockedBytes
+                    << ",\"lockWaitTime\":" << stats.lockWaitTime
+                    << ",\"programsCompiled\":" << stats.programsCompiled
+                    << ",\"programCompileTime\":" << stats.programCompileTime << "}";
+            }
+            stream << "}";
+        }
+
+        if (GpuProgramManager::getSingletonPtr())
+        {
+            static const char* stageNames[] = { "compile", "link", "generate" };
+            GpuProgramManager::CompileTimingList timings =
+                GpuProgramManager::getSingleton().getCompileTimings();
+            for (GpuProgramManager::CompileTimingList::iterator i = timings.begin(); i != timings.end(); ++i)
+            {
+                if (i->startTime < begin || i->startTime > end)
+                    continue;
+                stream << ",\n{\"name\":\"";
+                writeEscaped(stream, i->name.c_str());
+                stream << "\",\"cat\":\"" << stageNames[i->stage]
+                    << "\",\"ph\":\"X\",\"pid\":2,\"tid\":" << i->stage << ",\"ts\":" << i->startTime
+                    << ",\"dur\":" << i->microseconds << "}";
+            }
+        }
+        stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+    //-----------------------------------------------------------------------
+}
@@ -0,0 +1,162 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreProfileTraceListener.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    ProfileTraceListener::ProfileTraceListener(size_t capacity)
+        : mCount(0)
+    {
+        assert(capacity > 0 && "The event ring buffer needs a capacity");
+        mEvents.resize(capacity);
+        clear();
+    }
+    //-----------------------------------------------------------------------
+    ProfileTraceListener::~ProfileTraceListener()
+    {
+    }
+    //-----------------------------------------------------------------------
+    void ProfileTraceListener::initializeSession()
+    {
+        clear();
+    }
+    //-----------------------------------------------------------------------
+    void ProfileTraceListener::finializeSession()
+    {
+        // keep the events, so the timeline can still be written once disabled
+    }
+    //-----------------------------------------------------------------------
+    void ProfileTraceListener::profileEnded(const String& profileName, ulong startTime, ulong endTime)
+    {
+        recordEvent(profileName, startTime, endTime);
+    }
+    //-----------------------------------------------------------------------
+    void ProfileTraceListener::recordEvent(const String& name, ulong startTime, ulong endTime, size_t bytes)
+    {
+        const uint32 index = mCount++;
+        Event& event = mEvents[index % mEvents.size()];
+
+        // mark the slot as being written, so writeTrace skips it until we're done
+        event.sequence = 0;
+        strncpy(event.name, name.c_str(), MAX_NAME_LENGTH - 1);
+        event.name[MAX_NAME_LENGTH - 1] = 0;
+        event.startTime = startTime;
+        event.duration = endTime - startTime;
+        event.bytes = bytes;
+#if OGRE_THREAD_SUPPORT
+        event.threadId = OGRE_THREAD_CURRENT_ID;
+#endif
+        event.sequence = index + 1;
+    }
+    //-----------------------------------------------------------------------
+    void ProfileTraceListener::clear(void)
+    {
+        for (EventList::iterator i = mEvents.begin(); i != mEvents.end(); ++i)
+            i->sequence = 0;
+        mCount.set(0);
+    }
+    //-----------------------------------------------------------------------
+    size_t ProfileTraceListener::getNumEvents(void) const
+    {
+        return std::min(static_cast<size_t>(mCount.get()), mEvents.size());
+    }
+    //-----------------------------------------------------------------------
+    void ProfileTraceListener::writeTrace(std::ostream& stream) const
+    {
+        bool firstEvent = true;
+
+        stream << "{\"traceEvents\":[";
+        writeEvents(stream, 0, std::numeric_limits<ulong>::max(), firstEvent);
+        stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+    //-----------------------------------------------------------------------
+    void ProfileTraceListener::writeEvents(std::ostream& stream, ulong beginTime, ulong endTime,
+        bool& firstEvent) const
+    {
+#if OGRE_THREAD_SUPPORT
+        // the trace format wants small integer thread ids
+        vector<OGRE_THREAD_ID_TYPE>::type threads;
+#endif
+        const uint32 count = mCount.get();
+        const uint32 capacity = static_cast<uint32>(mEvents.size());
+        const uint32 first = count > capacity ? count - capacity : 0;
+
+        for (uint32 index = first; index != count; ++index)
+        {
+            const Event& event = mEvents[index % capacity];
+            // skip events being written, or already overwritten by newer ones
+            if (event.sequence != index + 1)
+                continue;
+            if (event.startTime < beginTime || event.startTime > endTime)
+                continue;
+
+            size_t thread = 0;
+#if OGRE_THREAD_SUPPORT
+            thread = std::find(threads.begin(), threads.end(), event.threadId) - threads.begin();
+            if (thread == threads.size())
+                threads.push_back(event.threadId);
+#endif
+
+            stream << (firstEvent ? "\n" : ",\n") << "{\"name\":\"";
+            writeEscaped(stream, event.name);
+            stream << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread
+                << ",\"ts\":" << event.startTime << ",\"dur\":" << event.duration;
+            if (event.bytes)
+                stream << ",\"args\":{\"bytes\":" << event.bytes << "}";
+            stream << "}";
+            firstEvent = false;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ProfileTraceListener::writeEscaped(std::ostream& stream, const char* str)
+    {
+        for (const char* c = str; *c; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+                stream << '\\' << *c;
+            else if (static_cast<unsigned char>(*c) < 0x20)
+                stream << ' ';
+            else
+                stream << *c;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ProfileTraceListener::writeTrace(const String& filename) const
+    {
+        std::ofstream of(filename.c_str());
+        if (!of)
+        {
+            OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+                "Cannot open '" + filename + "' for writing",
+                "ProfileTraceListener::writeTrace");
+        }
+        writeTrace(of);
+    }
+    //-----------------------------------------------------------------------
+}
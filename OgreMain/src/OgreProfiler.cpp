@@ -44,6 +44,7 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 #include "OgreLogManager.h"
 #include "OgreRoot.h"
 #include "OgreRenderSystem.h"
+#include "OgreAtomicScalar.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -59,16 +60,38 @@ namespace Ogre {
         assert( msSingleton );  return ( *msSingleton );  
     }
     //-----------------------------------------------------------------------
+    ProfileScope::ProfileScope(const String& profileName, uint32 groupID)
+        : mName(profileName)
+        , mGroupID(groupID)
+    {
+        // empty string is reserved for the root
+        assert ((profileName != "") && ("Profile name can't be an empty string"));
+
+        static AtomicScalar<uint32> nextId(0);
+        mId = nextId++;
+    }
+    //-----------------------------------------------------------------------
     Profile::Profile(const String& profileName, uint32 groupID) 
         : mName(profileName)
         , mGroupID(groupID)
+        , mScope(0)
     {
         Ogre::Profiler::getSingleton().beginProfile(profileName, groupID);
     }
     //-----------------------------------------------------------------------
+    Profile::Profile(const ProfileScope& scope)
+        : mGroupID(scope.getGroupID())
+        , mScope(&scope)
+    {
+        Ogre::Profiler::getSingleton().beginProfile(scope);
+    }
+    //-----------------------------------------------------------------------
     Profile::~Profile()
     {
-        Ogre::Profiler::getSingleton().endProfile(mName, mGroupID);
+        if (mScope)
+            Ogre::Profiler::getSingleton().endProfile(*mScope);
+        else
+            Ogre::Profiler::getSingleton().endProfile(mName, mGroupID);
     }
     //-----------------------------------------------------------------------
 
@@ -91,6 +114,7 @@ namespace Ogre {
         , mMaxTotalFrameTime(0)
         , mAverageFrameTime(0)
         , mResetExtents(false)
+        , mGpuFrameNumber(0)
     {
         mRoot.hierarchicalLvl = 0 - 1;
     }
@@ -111,9 +135,17 @@ namespace Ogre {
         history.minTimeMillisecs = 100000;
         history.currentTimePercent = 0;
         history.currentTimeMillisecs = 0;
+        history.currentGpuTimeMillisecs = 0;
+        history.maxGpuTimeMillisecs = 0;
+        history.minGpuTimeMillisecs = 0;
+        history.totalGpuTimeMillisecs = 0;
+        history.totalGpuFrames = 0;
 
         frame.frameTime = 0;
         frame.calls = 0;
+
+        gpuFrame.frameTime = 0;
+        gpuFrame.calls = 0;
     }
     ProfileInstance::~ProfileInstance(void)
     {                                        
@@ -180,6 +212,9 @@ namespace Ogre {
         for( TProfileSessionListener::iterator i = mListeners.begin(); i != mListeners.end(); ++i )
             (*i)->changeEnableState(mNewEnableState);
 
+        if (!mNewEnableState)
+            releaseGpuSamples();
+
         mEnabled = mNewEnableState;
     }
     //-----------------------------------------------------------------------
@@ -222,19 +257,58 @@ namespace Ogre {
         // need a timer to profile!
         assert (mTimer && "Timer not set!");
 
+        startProfile(getCurrentChild(profileName));
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::beginProfile(const ProfileScope& scope)
+    {
+        if (!mEnabled) 
+            return;
+
+        // mask groups
+        if ((scope.getGroupID() & mProfileMask) == 0)
+            return;
+
+        // we only process this profile if isn't disabled
+        if (!mDisabledProfiles.empty() && mDisabledProfiles.find(scope.getName()) != mDisabledProfiles.end()) 
+            return;
+
+        // this would be an internal error.
+        assert (mCurrent);
+
+        // need a timer to profile!
+        assert (mTimer && "Timer not set!");
+
+        // a handful of children at most, so a linear search beats any lookup by name
+        ProfileInstance* instance = 0;
+        ProfileInstance::ProfileScopeChildren& scopeChildren = mCurrent->scopeChildren;
+        ProfileInstance::ProfileScopeChildren::iterator it = scopeChildren.begin(), endit = scopeChildren.end();
+        for(;it != endit; ++it)
+        {
+            if(it->first == scope.getId())
+            {
+                instance = it->second;
+                break;
+            }
+        }
+
+        if(!instance)
+        {   // first time this scope starts under the current profile
+            instance = getCurrentChild(scope.getName());
+            scopeChildren.push_back(std::make_pair(scope.getId(), instance));
+        }
+
+        startProfile(instance);
+    }
+    //-----------------------------------------------------------------------
+    ProfileInstance* Profiler::getCurrentChild(const String& profileName)
+    {
         ProfileInstance*& instance = mCurrent->children[profileName];
         if(instance)
         {   // found existing child.
 
             // Sanity check.
             assert(instance->name == profileName);
-
-            if(instance->frameNumber != mCurrentFrame)
-            {   // new frame, reset stats
-                instance->frame.calls = 0;
-                instance->frame.frameTime = 0;
-                instance->frameNumber = mCurrentFrame;
-            }
         }
         else
         {   // new child!
@@ -243,11 +317,24 @@ namespace Ogre {
             instance->parent = mCurrent;
             instance->hierarchicalLvl = mCurrent->hierarchicalLvl + 1;
         }
+        return instance;
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::startProfile(ProfileInstance* instance)
+    {
+        if(instance->frameNumber != mCurrentFrame)
+        {   // new frame, reset stats
+            instance->frame.calls = 0;
+            instance->frame.frameTime = 0;
+        }
 
         instance->frameNumber = mCurrentFrame;
 
         mCurrent = instance;
 
+        for( TProfileSessionListener::iterator i = mListeners.begin(); i != mListeners.end(); ++i )
+            (*i)->profileStarted(instance->name, mTimer->getMicroseconds());
+
         // we do this at the very end of the function to get the most
         // accurate timing results
         mCurrent->currTime = mTimer->getMicroseconds();
@@ -294,6 +381,18 @@ namespace Ogre {
                         break;
                     }
                 }
+                ProfileInstance::ProfileScopeChildren::iterator sit = mRoot.scopeChildren.begin(), sendit = mRoot.scopeChildren.end();
+                for(;sit != sendit; ++sit)
+                {
+                    if(mLast == sit->second)
+                    {
+                        mRoot.scopeChildren.erase(sit);
+                        break;
+                    }
+                }
+
+                // GPU timers may belong to the bogus profile's children
+                releaseGpuSamples();
 
                 // with mLast == NULL we won't reach this code, in case this isn't the end of the top level profile
                 ProfileInstance* last = mLast;
@@ -325,7 +424,7 @@ namespace Ogre {
 
         // we only process this profile if isn't disabled
         // we check the current instance name against the provided profileName as a guard against disabling a profile name /after/ said profile began
-        if(mCurrent->name != profileName && mDisabledProfiles.find(profileName) != mDisabledProfiles.end()) 
+        if(!mDisabledProfiles.empty() && mCurrent->name != profileName && mDisabledProfiles.find(profileName) != mDisabledProfiles.end()) 
             return;
 
         // calculate the elapsed time of this profile
@@ -341,6 +440,9 @@ namespace Ogre {
         mCurrent->frame.frameTime += timeElapsed;
         ++mCurrent->frame.calls;
 
+        for( TProfileSessionListener::iterator i = mListeners.begin(); i != mListeners.end(); ++i )
+            (*i)->profileEnded(mCurrent->name, mCurrent->currTime, endTime);
+
         mLast = mCurrent;
         mCurrent = mCurrent->parent;
 
@@ -364,14 +466,59 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void Profiler::endProfile(const ProfileScope& scope)
+    {
+        // the name is only compared when profiles are disabled, and needs no copy
+        endProfile(scope.getName(), scope.getGroupID());
+    }
+    //-----------------------------------------------------------------------
     void Profiler::beginGPUEvent(const String& event)
     {
-        Root::getSingleton().getRenderSystem()->beginProfileEvent(event);
+        RenderSystem* rs = Root::getSingleton().getRenderSystem();
+        rs->beginProfileEvent(event);
+
+        GpuSample sample = { 0, 0, mCurrentFrame };
+
+        // only events inside a profile are timed, so they can never end the frame
+        if (mEnabled && &mRoot != mCurrent && (OGREPROF_RENDERING & mProfileMask) &&
+            (mDisabledProfiles.empty() || mDisabledProfiles.find(event) == mDisabledProfiles.end()))
+        {
+            sample.timer = rs->_beginGpuTimer();
+            if (sample.timer)
+            {
+                sample.instance = getCurrentChild(event);
+                startProfile(sample.instance);
+            }
+        }
+
+        // untimed events are tracked as well, to match begins and ends
+        mGpuEvents.push_back(sample);
     }
     //-----------------------------------------------------------------------
     void Profiler::endGPUEvent(const String& event)
     {
-        Root::getSingleton().getRenderSystem()->endProfileEvent();
+        RenderSystem* rs = Root::getSingleton().getRenderSystem();
+
+        if (!mGpuEvents.empty())
+        {
+            const GpuSample sample = mGpuEvents.back();
+            mGpuEvents.pop_back();
+
+            if (sample.timer)
+            {
+                rs->_endGpuTimer(sample.timer);
+
+                // the profile is gone if the profiler got disabled meanwhile
+                if (mEnabled)
+                    mPendingGpuSamples.push_back(sample);
+                else
+                    rs->_releaseGpuTimer(sample.timer);
+
+                endProfile(event, OGREPROF_RENDERING);
+            }
+        }
+
+        rs->endProfileEvent();
     }
     //-----------------------------------------------------------------------
     void Profiler::markGPUEvent(const String& event)
@@ -436,10 +583,100 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void Profiler::processGpuSamples(void)
+    {
+        if (mPendingGpuSamples.empty())
+            return;
+
+        RenderSystem* rs = Root::getSingleton().getRenderSystem();
+
+        // timers complete in issue order, so stop at the first one still pending
+        while (!mPendingGpuSamples.empty())
+        {
+            const GpuSample& sample = mPendingGpuSamples.front();
+
+            uint64 elapsedNanosecs = 0;
+            const RenderSystem::GpuTimerStatus status = rs->_getGpuTimerResult(sample.timer, elapsedNanosecs);
+            if (status == RenderSystem::GTS_PENDING)
+                break;
+
+            if (sample.frameNumber != mGpuFrameNumber)
+            {   // every timer of the previous frame has been collected
+                commitGpuFrame();
+                mGpuFrameNumber = sample.frameNumber;
+            }
+
+            if (status == RenderSystem::GTS_AVAILABLE)
+            {
+                ProfileInstance* instance = sample.instance;
+                if (instance->gpuFrame.calls == 0)
+                    mGpuFrameInstances.push_back(instance);
+
+                instance->gpuFrame.frameTime += (ulong)elapsedNanosecs;
+                ++instance->gpuFrame.calls;
+            }
+
+            mPendingGpuSamples.pop_front();
+        }
+
+        // this runs at the end of a frame, so nothing else is to come for mGpuFrameNumber
+        // unless some of its timers are still pending
+        if (mPendingGpuSamples.empty() || mPendingGpuSamples.front().frameNumber != mGpuFrameNumber)
+            commitGpuFrame();
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::commitGpuFrame(void)
+    {
+        vector<ProfileInstance*>::type::iterator it = mGpuFrameInstances.begin(), endit = mGpuFrameInstances.end();
+        for(;it != endit; ++it)
+        {
+            ProfileInstance* instance = *it;
+            ProfileHistory& history = instance->history;
+
+            const Real gpuTimeMillisecs = (Real) instance->gpuFrame.frameTime / 1000000.0f;
+
+            history.currentGpuTimeMillisecs = gpuTimeMillisecs;
+            if (gpuTimeMillisecs < history.minGpuTimeMillisecs || history.totalGpuFrames == 0)
+                history.minGpuTimeMillisecs = gpuTimeMillisecs;
+            if (gpuTimeMillisecs > history.maxGpuTimeMillisecs)
+                history.maxGpuTimeMillisecs = gpuTimeMillisecs;
+            history.totalGpuTimeMillisecs += gpuTimeMillisecs;
+            ++history.totalGpuFrames;
+
+            instance->gpuFrame.frameTime = 0;
+            instance->gpuFrame.calls = 0;
+        }
+        mGpuFrameInstances.clear();
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::releaseGpuSamples(void)
+    {
+        if (!mPendingGpuSamples.empty())
+        {
+            RenderSystem* rs = Root::getSingleton().getRenderSystem();
+
+            GpuSampleList::iterator it = mPendingGpuSamples.begin(), endit = mPendingGpuSamples.end();
+            for(;it != endit; ++it)
+                rs->_releaseGpuTimer(it->timer);
+            mPendingGpuSamples.clear();
+        }
+
+        vector<ProfileInstance*>::type::iterator it = mGpuFrameInstances.begin(), endit = mGpuFrameInstances.end();
+        for(;it != endit; ++it)
+        {
+            (*it)->gpuFrame.frameTime = 0;
+            (*it)->gpuFrame.calls = 0;
+        }
+        mGpuFrameInstances.clear();
+    }
+    //-----------------------------------------------------------------------
     void Profiler::processFrameStats(void) 
     {
         Real maxFrameTime = 0;
 
+        // GPU results of earlier frames that have come in meanwhile
+        processGpuSamples();
+
         ProfileChildren::iterator it = mRoot.children.begin(), endit = mRoot.children.end();
         for(;it != endit; ++it)
         {
@@ -563,7 +800,8 @@ namespace Ogre {
         LogManager::getSingleton().logMessage(indent + "Name " + name + 
                         " | Min " + StringConverter::toString(history.minTimePercent) + 
                         " | Max " + StringConverter::toString(history.maxTimePercent) + 
-                        " | Avg "+ StringConverter::toString(history.totalTimePercent / history.totalCalls));   
+                        " | Avg "+ StringConverter::toString(history.totalTimePercent / history.totalCalls) +
+                        (history.totalGpuFrames ? " | GPU Avg ms " + StringConverter::toString(history.totalGpuTimeMillisecs / history.totalGpuFrames) : String()));
 
         for(ProfileChildren::iterator it = children.begin(); it != children.end(); ++it)
         {
@@ -585,6 +823,10 @@ namespace Ogre {
 
         history.minTimePercent = 1;
         history.minTimeMillisecs = 100000;
+
+        history.currentGpuTimeMillisecs = history.maxGpuTimeMillisecs = history.minGpuTimeMillisecs = 0;
+        history.totalGpuTimeMillisecs = 0;
+        history.totalGpuFrames = 0;
         for(ProfileChildren::iterator it = children.begin(); it != children.end(); ++it)
         {
             it->second->reset();
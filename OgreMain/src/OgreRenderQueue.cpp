@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "OgreMovableObject.h"
 #include "OgreSceneManagerEnumerator.h"
 #include "OgreTechnique.h"
+#include "OgreSoftwareOcclusionCuller.h"
 
 
 namespace Ogre {
@@ -299,11 +300,21 @@ namespace Ogre {
         mo->_notifyCurrentCamera(cam);
         if (mo->isVisible())
         {
+            SoftwareOcclusionCuller* culler = cam->getSceneManager()->getOcclusionCuller();
+            if (culler && culler->isOccluded(mo->getWorldBoundingBox(true), cam))
+                return;
+
             bool receiveShadows = getQueueGroup(mo->getRenderQueueGroup())->getShadowsEnabled()
                 && mo->getReceivesShadows();
 
             if (!onlyShadowCasters || mo->getCastShadows())
             {
+                // Leave out casters whose shadows cannot fall on a visible receiver
+                const PlaneBoundedVolume* casterVolume = onlyShadowCasters ?
+                    cam->getSceneManager()->_getShadowCasterCullVolume() : 0;
+                if (casterVolume && !casterVolume->intersects(mo->getWorldBoundingBox(true)))
+                    return;
+
                 mo -> _updateRenderQueue( this );
                 if (visibleBounds)
                 {
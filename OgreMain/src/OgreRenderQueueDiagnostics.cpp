@@ -0,0 +1,209 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreRenderQueueDiagnostics.h"
+#include "OgreRenderQueue.h"
+#include "OgreRenderQueueSortingGrouping.h"
+#include "OgreRenderOperation.h"
+#include "OgreRenderable.h"
+#include "OgreTechnique.h"
+#include "OgreMaterial.h"
+#include "OgreLogManager.h"
+
+namespace Ogre {
+    namespace
+    {
+        /// Counts the renderables and distinct passes of queued renderable collections
+        class CountingVisitor : public QueuedRenderableVisitor
+        {
+        public:
+            size_t renderables;
+            set<const Pass*>::type passes;
+
+            CountingVisitor() : renderables(0) {}
+
+            void visit(RenderablePass* rp)
+            {
+                ++renderables;
+                passes.insert(rp->pass);
+            }
+            bool visit(const Pass* p)
+            {
+                passes.insert(p);
+                return true;
+            }
+            void visit(Renderable* r)
+            {
+                ++renderables;
+            }
+        };
+
+        bool worseMaterial(const RenderQueueDiagnostics::MaterialStats& a,
+            const RenderQueueDiagnostics::MaterialStats& b)
+        {
+            if (a.instanceableDraws != b.instanceableDraws)
+                return a.instanceableDraws > b.instanceableDraws;
+            return a.passSwitches > b.passSwitches;
+        }
+    }
+    //-----------------------------------------------------------------------
+    RenderQueueDiagnostics::RenderQueueDiagnostics()
+        : mFrameNumber(0)
+    {
+        clear();
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueueDiagnostics::clear(void)
+    {
+        mPriorityStats.clear();
+        mMaterialStats.clear();
+        mUniquePasses.clear();
+        mDraws = 0;
+        mPassSwitches = 0;
+        mInstanceableDraws = 0;
+        mAutoInstanced = 0;
+        mLastPass = 0;
+        mLastVertexData = 0;
+        mLastIndexData = 0;
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueueDiagnostics::_countQueue(RenderQueue* queue, unsigned long frameNumber)
+    {
+        if (frameNumber != mFrameNumber)
+        {
+            clear();
+            mFrameNumber = frameNumber;
+        }
+        // Draws of another camera don't follow the last one
+        mLastPass = 0;
+
+        RenderQueue::QueueGroupIterator groupIt = queue->_getQueueGroupIterator();
+        while (groupIt.hasMoreElements())
+        {
+            uint8 groupId = groupIt.peekNextKey();
+            RenderQueueGroup::PriorityMapIterator priorityIt = groupIt.getNext()->getIterator();
+            while (priorityIt.hasMoreElements())
+            {
+                ushort priority = priorityIt.peekNextKey();
+                RenderPriorityGroup* group = priorityIt.getNext();
+
+                CountingVisitor visitor;
+                QueuedRenderableCollection::OrganisationMode om = QueuedRenderableCollection::OM_PASS_GROUP;
+                group->getSolidsBasic().acceptVisitor(&visitor, om);
+                group->getSolidsDiffuseSpecular().acceptVisitor(&visitor, om);
+                group->getSolidsDecal().acceptVisitor(&visitor, om);
+                group->getSolidsNoShadowReceive().acceptVisitor(&visitor, om);
+                group->getTransparentsUnsorted().acceptVisitor(&visitor, om);
+                group->getTransparents().acceptVisitor(&visitor, om);
+                if (!visitor.renderables)
+                    continue;
+
+                uint32 key = (static_cast<uint32>(groupId) << 16) | priority;
+                PriorityStatsMap::iterator i = mPriorityStats.find(key);
+                if (i == mPriorityStats.end())
+                {
+                    PriorityStats stats = { groupId, priority, 0, 0 };
+                    i = mPriorityStats.insert(PriorityStatsMap::value_type(key, stats)).first;
+                }
+                i->second.renderables += visitor.renderables;
+                i->second.passes += visitor.passes.size();
+                mUniquePasses.insert(visitor.passes.begin(), visitor.passes.end());
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueueDiagnostics::_notifyDraw(const Pass* pass, Renderable* rend)
+    {
+        RenderOperation op;
+        rend->getRenderOperation(op);
+
+        const Material* mat = pass->getParent()->getParent();
+        MaterialStatsMap::iterator i = mMaterialStats.find(mat);
+        if (i == mMaterialStats.end())
+        {
+            MaterialStats stats = { mat->getName(), 0, 0, 0 };
+            i = mMaterialStats.insert(MaterialStatsMap::value_type(mat, stats)).first;
+        }
+        MaterialStats& stats = i->second;
+
+        ++mDraws;
+        ++stats.draws;
+        if (pass != mLastPass)
+        {
+            ++mPassSwitches;
+            ++stats.passSwitches;
+        }
+        else if (op.vertexData == mLastVertexData && op.indexData == mLastIndexData &&
+            op.numberOfInstances <= 1)
+        {
+            ++mInstanceableDraws;
+            ++stats.instanceableDraws;
+        }
+
+        mLastPass = pass;
+        mLastVertexData = op.vertexData;
+        mLastIndexData = op.indexData;
+    }
+    //-----------------------------------------------------------------------
+    RenderQueueDiagnostics::PriorityStatsList RenderQueueDiagnostics::getPriorityStats(void) const
+    {
+        PriorityStatsList ret;
+        ret.reserve(mPriorityStats.size());
+        for (PriorityStatsMap::const_iterator i = mPriorityStats.begin(); i != mPriorityStats.end(); ++i)
+            ret.push_back(i->second);
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    RenderQueueDiagnostics::MaterialStatsList RenderQueueDiagnostics::getMaterialStats(void) const
+    {
+        MaterialStatsList ret;
+        ret.reserve(mMaterialStats.size());
+        for (MaterialStatsMap::const_iterator i = mMaterialStats.begin(); i != mMaterialStats.end(); ++i)
+            ret.push_back(i->second);
+        std::stable_sort(ret.begin(), ret.end(), worseMaterial);
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueueDiagnostics::logWorstMaterials(size_t count) const
+    {
+        Log::Stream log = LogManager::getSingleton().stream();
+        log << "Render queue: " << mDraws << " draws, " << mPassSwitches << " pass switches, "
+            << mUniquePasses.size() << " distinct passes, " << mInstanceableDraws
+            << " instanceable draws, " << mAutoInstanced << " automatically instanced";
+
+        MaterialStatsList materials = getMaterialStats();
+        count = std::min(count, materials.size());
+        for (size_t i = 0; i < count; ++i)
+        {
+            const MaterialStats& stats = materials[i];
+            log << "\n  " << stats.material << ": " << stats.draws << " draws, "
+                << stats.instanceableDraws << " instanceable, "
+                << stats.passSwitches << " pass switches";
+        }
+    }
+}
@@ -36,6 +36,8 @@ namespace Ogre {
         RenderablePass, uint32> QueuedRenderableCollection::msRadixSorter1;
     RadixSort<QueuedRenderableCollection::RenderablePassList,
         RenderablePass, float> QueuedRenderableCollection::msRadixSorter2;
+    RadixSort<QueuedRenderableCollection::RenderablePassList,
+        RenderablePass, uint64> QueuedRenderableCollection::msRadixSorterKey;
 
 
     //-----------------------------------------------------------------------
@@ -306,8 +308,9 @@ namespace Ogre {
             i->second->clear();
         }
 
-        // Clear sorted list
+        // Clear sorted lists
         mSortedDescending.clear();
+        mSortedByKey.clear();
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::removePassGroup(Pass* p)
@@ -358,6 +361,12 @@ namespace Ogre {
             }
         }
 
+        if (mOrganisationMode & OM_SORT_KEY)
+        {
+            // Single radix sort on the packed pass / depth key
+            msRadixSorterKey.sort(mSortedByKey, RadixSortFunctorKey(cam));
+        }
+
         // Nothing needs to be done for pass groups, they auto-organise
 
     }
@@ -370,6 +379,11 @@ namespace Ogre {
             mSortedDescending.push_back(RenderablePass(rend, pass));
         }
 
+        if (mOrganisationMode & OM_SORT_KEY)
+        {
+            mSortedByKey.push_back(RenderablePass(rend, pass));
+        }
+
         if (mOrganisationMode & OM_PASS_GROUP)
         {
             PassGroupRenderableMap::iterator i = mGrouped.find(pass);
@@ -402,6 +416,8 @@ namespace Ogre {
             // try to fall back
             if (OM_PASS_GROUP & mOrganisationMode)
                 om = OM_PASS_GROUP;
+            else if (OM_SORT_KEY & mOrganisationMode)
+                om = OM_SORT_KEY;
             else if (OM_SORT_ASCENDING & mOrganisationMode)
                 om = OM_SORT_ASCENDING;
             else if (OM_SORT_DESCENDING & mOrganisationMode)
@@ -424,6 +440,9 @@ namespace Ogre {
         case OM_SORT_ASCENDING:
             acceptVisitorAscending(visitor);
             break;
+        case OM_SORT_KEY:
+            acceptVisitorSortKey(visitor);
+            break;
         }
         
     }
@@ -481,9 +500,32 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void QueuedRenderableCollection::acceptVisitorSortKey(
+        QueuedRenderableVisitor* visitor) const
+    {
+        // List is sorted by pass, so visit each pass when it changes
+        RenderablePassList::const_iterator i, iend;
+        const Pass* currentPass = 0;
+        bool skip = false;
+
+        iend = mSortedByKey.end();
+        for (i = mSortedByKey.begin(); i != iend; ++i)
+        {
+            if (i->pass != currentPass)
+            {
+                currentPass = i->pass;
+                // Visit Pass - allow skip
+                skip = !visitor->visit(currentPass);
+            }
+            if (!skip)
+                visitor->visit(i->renderable);
+        }
+    }
+    //-----------------------------------------------------------------------
     void QueuedRenderableCollection::merge( const QueuedRenderableCollection& rhs )
     {
         mSortedDescending.insert( mSortedDescending.end(), rhs.mSortedDescending.begin(), rhs.mSortedDescending.end() );
+        mSortedByKey.insert( mSortedByKey.end(), rhs.mSortedByKey.begin(), rhs.mSortedByKey.end() );
 
         PassGroupRenderableMap::const_iterator srcGroup;
         for( srcGroup = rhs.mGrouped.begin(); srcGroup != rhs.mGrouped.end(); ++srcGroup )
@@ -42,6 +42,9 @@ THE SOFTWARE.
 #include "OgreTextureManager.h"
 #include "OgreMaterialManager.h"
 #include "OgreHardwareOcclusionQuery.h"
+#include "OgreViewport.h"
+#include "OgreCamera.h"
+#include "OgreSceneManager.h"
 
 namespace Ogre {
 
@@ -61,6 +64,9 @@ namespace Ogre {
         , mBatchCount(0)
         , mFaceCount(0)
         , mVertexCount(0)
+        , mDrawCategory(DC_SCENE)
+        , mLastDrawDeclaration(0)
+        , mLastDrawTarget(0)
         , mInvertVertexWinding(false)
         , mDisabledTexUnitsFrom(0)
         , mCurrentPassIterationCount(0)
@@ -72,6 +78,8 @@ namespace Ogre {
         , mGlobalInstanceVertexBufferVertexDeclaration(NULL)
         , mGlobalNumberOfInstances(1)
         , mEnableFixedPipeline(true)
+        , mMaxFrameLatency(0)
+        , mParallelTargetPreparation(false)
         , mVertexProgramBound(false)
         , mGeometryProgramBound(false)
         , mFragmentProgramBound(false)
@@ -115,6 +123,9 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void RenderSystem::_updateAllRenderTargets(bool swapBuffers)
     {
+        if (mParallelTargetPreparation)
+            prepareRenderTargets();
+
         // Update all in order of priority
         // This ensures render-to-texture targets get updated before render windows
         RenderTargetPriorityMap::iterator itarg, itargend;
@@ -126,6 +137,32 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void RenderSystem::prepareRenderTargets(void)
+    {
+        typedef map<SceneManager*, vector<Camera*>::type>::type CamerasBySceneManager;
+        CamerasBySceneManager cameras;
+
+        RenderTargetPriorityMap::iterator itarg, itargend;
+        itargend = mPrioritisedRenderTargets.end();
+        for( itarg = mPrioritisedRenderTargets.begin(); itarg != itargend; ++itarg )
+        {
+            RenderTarget* target = itarg->second;
+            if (!target->isActive() || !target->isAutoUpdated())
+                continue;
+
+            for (unsigned short i = 0; i < target->getNumViewports(); ++i)
+            {
+                Viewport* vp = target->getViewport(i);
+                Camera* cam = vp->getCamera();
+                if (vp->isAutoUpdated() && cam && cam->getSceneManager())
+                    cameras[cam->getSceneManager()].push_back(cam);
+            }
+        }
+
+        for (CamerasBySceneManager::iterator i = cameras.begin(); i != cameras.end(); ++i)
+            i->first->_prepareCameras(i->second);
+    }
+    //-----------------------------------------------------------------------
     void RenderSystem::_swapAllRenderTargetBuffers()
     {
         // Update all in order of priority
@@ -137,6 +174,8 @@ namespace Ogre {
             if( itarg->second->isActive() && itarg->second->isAutoUpdated())
                 itarg->second->swapBuffers();
         }
+
+        limitFrameLatency();
     }
     //-----------------------------------------------------------------------
     RenderWindow* RenderSystem::_initialise(bool autoCreateWindow, const String& windowTitle)
@@ -315,9 +354,18 @@ namespace Ogre {
     {
         // This method is only ever called to set a texture unit to valid details
         // The method _disableTextureUnit is called to turn a unit off
+        ++mStatistics.textureBinds;
 
         const TexturePtr& tex = tl._getTexturePtr();
         bool isValidBinding = false;
+
+        // Reload the texture if the memory budget evicted it, and record the use
+        if (!tex.isNull())
+        {
+            if (!tex->isLoaded() && tex->isReloadable())
+                tex->load();
+            tex->_notifyUsed();
+        }
         
         if (mCurrentCapabilities->hasCapability(RSC_COMPLETE_TEXTURE_BINDING))
             _setBindingType(tl.getBindingType());
@@ -754,14 +802,28 @@ namespace Ogre {
     {
         // Update stats
         size_t val;
+        size_t trueInstanceNum;
 
-        if (op.useIndexes)
-            val = op.indexData->indexCount;
+        if (op.numIndirectCommands)
+        {
+            val = 0;
+            trueInstanceNum = 0;
+            for (size_t i = 0; i < op.numIndirectCommands; ++i)
+            {
+                val += op.indirectCommands[i].indexCount * op.indirectCommands[i].instanceCount;
+                trueInstanceNum += op.indirectCommands[i].instanceCount;
+            }
+        }
         else
-            val = op.vertexData->vertexCount;
+        {
+            if (op.useIndexes)
+                val = op.indexData->indexCount;
+            else
+                val = op.vertexData->vertexCount;
 
-        size_t trueInstanceNum = std::max<size_t>(op.numberOfInstances,1);
-        val *= trueInstanceNum;
+            trueInstanceNum = std::max<size_t>(op.numberOfInstances,1);
+            val *= trueInstanceNum;
+        }
 
         // account for a pass having multiple iterations
         if (mCurrentPassIterationCount > 1)
@@ -818,6 +880,18 @@ namespace Ogre {
         mVertexCount += op.vertexData->vertexCount * trueInstanceNum;
         mBatchCount += mCurrentPassIterationCount;
 
+        mStatistics.categoryBatches[mDrawCategory] += mCurrentPassIterationCount;
+        if (op.vertexData->vertexDeclaration != mLastDrawDeclaration)
+        {
+            mLastDrawDeclaration = op.vertexData->vertexDeclaration;
+            ++mStatistics.vertexDeclarationChanges;
+        }
+        if (mActiveRenderTarget != mLastDrawTarget)
+        {
+            mLastDrawTarget = mActiveRenderTarget;
+            ++mStatistics.renderTargetChanges;
+        }
+
         // sort out clip planes
         // have to do it here in case of matrix issues
         if (mClipPlanesDirty)
@@ -972,6 +1046,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void RenderSystem::bindGpuProgram(GpuProgram* prg)
     {
+        ++mStatistics.programBinds;
         switch(prg->getType())
         {
         case GPT_VERTEX_PROGRAM:
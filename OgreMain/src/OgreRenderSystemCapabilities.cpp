@@ -205,6 +205,9 @@ namespace Ogre {
             pLog->logMessage(
                  "   - BC6H/BC7: "
                  + StringConverter::toString(hasCapability(RSC_TEXTURE_COMPRESSION_BC6H_BC7), true));
+            pLog->logMessage(
+                 "   - ASTC: "
+                 + StringConverter::toString(hasCapability(RSC_TEXTURE_COMPRESSION_ASTC), true));
         }
 
         pLog->logMessage(
@@ -286,6 +289,9 @@ namespace Ogre {
         pLog->logMessage(
             " * Hardware Atomic Counters: "
             + StringConverter::toString(hasCapability(RSC_ATOMIC_COUNTERS), true));
+        pLog->logMessage(
+            " * Multi-draw indirect: "
+            + StringConverter::toString(hasCapability(RSC_MULTI_DRAW_INDIRECT), true));
 
         if (mCategoryRelevant[CAPS_CATEGORY_GL])
         {
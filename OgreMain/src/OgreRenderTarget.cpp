@@ -36,10 +36,39 @@ THE SOFTWARE.
 #include "OgreDepthBuffer.h"
 #include "OgreProfiler.h"
 #include "OgreTimer.h"
+#include "OgrePixelReadback.h"
+#include "OgreRenderSystem.h"
+#include "OgreGpuProgramManager.h"
 #include <iomanip>
 
 namespace Ogre {
 
+    /// Reads the running totals of the render system work into the fields of FrameStats
+    static void readRenderCounters(RenderTarget::FrameStats& stats)
+    {
+        const RenderSystem::RenderStatistics& rs =
+            Root::getSingleton().getRenderSystem()->getRenderStatistics();
+        stats.programBinds = rs.programBinds;
+        stats.textureBinds = rs.textureBinds;
+        stats.blendChanges = rs.blendChanges;
+        stats.depthChanges = rs.depthChanges;
+        stats.vertexDeclarationChanges = rs.vertexDeclarationChanges;
+        stats.renderTargetChanges = rs.renderTargetChanges;
+        stats.constantBytes = rs.constantBytes;
+        stats.lockedBytes = HardwareBuffer::getTotalLockedBytes();
+        stats.lockStalls = HardwareBuffer::getTotalLockStalls();
+        stats.lockWaitTime = HardwareBuffer::getTotalLockWaitTime();
+        stats.lockWaits = HardwareBuffer::getTotalLockWaits();
+        GpuProgramManager& gpuProgramMgr = GpuProgramManager::getSingleton();
+        stats.programsCompiled = gpuProgramMgr.getTotalCompileCount(GpuProgramManager::CS_COMPILE);
+        stats.programCompileTime = gpuProgramMgr.getTotalCompileTime(GpuProgramManager::CS_COMPILE) +
+            gpuProgramMgr.getTotalCompileTime(GpuProgramManager::CS_LINK) +
+            gpuProgramMgr.getTotalCompileTime(GpuProgramManager::CS_GENERATE);
+        stats.shadowBatchCount = rs.categoryBatches[DC_SHADOW];
+        stats.compositorBatchCount = rs.categoryBatches[DC_COMPOSITOR];
+        stats.overlayBatchCount = rs.categoryBatches[DC_OVERLAY];
+    }
+
     RenderTarget::RenderTarget()
         : mPriority(OGRE_DEFAULT_RT_GROUP)
         , mDepthBufferPoolId(DepthBuffer::POOL_DEFAULT)
@@ -166,6 +195,8 @@ namespace Ogre {
 
     void RenderTarget::_beginUpdate()
     {
+        readRenderCounters(mUpdateStartStats);
+
         // notify listeners (pre)
         firePreUpdate();
 
@@ -194,6 +225,26 @@ namespace Ogre {
          // notify listeners (post)
         firePostUpdate();
 
+        FrameStats end;
+        readRenderCounters(end);
+        mStats.programBinds = end.programBinds - mUpdateStartStats.programBinds;
+        mStats.textureBinds = end.textureBinds - mUpdateStartStats.textureBinds;
+        mStats.blendChanges = end.blendChanges - mUpdateStartStats.blendChanges;
+        mStats.depthChanges = end.depthChanges - mUpdateStartStats.depthChanges;
+        mStats.vertexDeclarationChanges =
+            end.vertexDeclarationChanges - mUpdateStartStats.vertexDeclarationChanges;
+        mStats.renderTargetChanges = end.renderTargetChanges - mUpdateStartStats.renderTargetChanges;
+        mStats.constantBytes = end.constantBytes - mUpdateStartStats.constantBytes;
+        mStats.lockedBytes = end.lockedBytes - mUpdateStartStats.lockedBytes;
+        mStats.lockStalls = end.lockStalls - mUpdateStartStats.lockStalls;
+        mStats.lockWaitTime = end.lockWaitTime - mUpdateStartStats.lockWaitTime;
+        mStats.lockWaits = end.lockWaits - mUpdateStartStats.lockWaits;
+        mStats.programsCompiled = end.programsCompiled - mUpdateStartStats.programsCompiled;
+        mStats.programCompileTime = end.programCompileTime - mUpdateStartStats.programCompileTime;
+        mStats.shadowBatchCount = end.shadowBatchCount - mUpdateStartStats.shadowBatchCount;
+        mStats.compositorBatchCount = end.compositorBatchCount - mUpdateStartStats.compositorBatchCount;
+        mStats.overlayBatchCount = end.overlayBatchCount - mUpdateStartStats.overlayBatchCount;
+
         // Update statistics (always on top)
         updateStats();
     }
@@ -346,6 +397,23 @@ namespace Ogre {
         mStats.bestFrameTime = 999999;
         mStats.worstFrameTime = 0;
         mStats.vBlankMissCount = -1;
+        mStats.programBinds = 0;
+        mStats.textureBinds = 0;
+        mStats.blendChanges = 0;
+        mStats.depthChanges = 0;
+        mStats.vertexDeclarationChanges = 0;
+        mStats.renderTargetChanges = 0;
+        mStats.constantBytes = 0;
+        mStats.lockedBytes = 0;
+        mStats.lockStalls = 0;
+        mStats.lockWaitTime = 0;
+        mStats.lockWaits = 0;
+        mStats.programsCompiled = 0;
+        mStats.programCompileTime = 0;
+        mStats.shadowBatchCount = 0;
+        mStats.compositorBatchCount = 0;
+        mStats.overlayBatchCount = 0;
+        mUpdateStartStats = mStats;
 
         mLastTime = mTimer->getMilliseconds();
         mLastSecond = mLastTime;
@@ -583,6 +651,53 @@ namespace Ogre {
         OGRE_FREE(data, MEMCATEGORY_RENDERSYS);
     }
     //-----------------------------------------------------------------------
+    namespace {
+        /// Readback of a copy already done, used when the render system can't read back asynchronously
+        class MemoryPixelReadback : public PixelReadback
+        {
+        public:
+            MemoryPixelReadback(uint32 width, uint32 height, PixelFormat format)
+                : PixelReadback(width, height, format)
+            {
+                mData = OGRE_ALLOC_T(uchar, PixelUtil::getMemorySize(width, height, 1, format), MEMCATEGORY_RENDERSYS);
+            }
+            ~MemoryPixelReadback()
+            {
+                OGRE_FREE(mData, MEMCATEGORY_RENDERSYS);
+            }
+
+            bool isReady(void) { return true; }
+
+            void read(const PixelBox& dst)
+            {
+                PixelUtil::bulkPixelConversion(getPixelBox(), dst);
+            }
+
+            PixelBox getPixelBox(void) const { return PixelBox(mWidth, mHeight, 1, mFormat, mData); }
+
+        private:
+            uchar* mData;
+        };
+    }
+    //-----------------------------------------------------------------------
+    PixelReadbackPtr RenderTarget::copyContentsToMemoryAsync(const Box& src, PixelFormat format, FrameBuffer buffer)
+    {
+        if (src.right > mWidth || src.bottom > mHeight || src.front != 0 || src.back != 1)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid box.", "RenderTarget::copyContentsToMemoryAsync");
+        }
+
+        PixelReadbackPtr readback = Root::getSingleton().getRenderSystem()->_copyContentsToMemoryAsync(
+            this, src, format, buffer);
+        if (!readback)
+        {
+            MemoryPixelReadback* copy = OGRE_NEW MemoryPixelReadback(src.getWidth(), src.getHeight(), format);
+            readback.bind(copy);
+            copyContentsToMemory(src, copy->getPixelBox(), buffer);
+        }
+        return readback;
+    }
+    //-----------------------------------------------------------------------
     void RenderTarget::_notifyCameraRemoved(const Camera* cam)
     {
         ViewportList::iterator i, iend;
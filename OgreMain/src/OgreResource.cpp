@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreResourceManager.h"
 #include "OgreLogManager.h"
 #include "OgreException.h"
+#include "OgreResourceLoadTrace.h"
 
 namespace Ogre 
 {
@@ -40,7 +41,8 @@ namespace Ogre
         const String& group, bool isManual, ManualResourceLoader* loader)
         : mCreator(creator), mName(name), mGroup(group), mHandle(handle), 
         mLoadingState(LOADSTATE_UNLOADED), mIsBackgroundLoaded(false),
-        mSize(0), mIsManual(isManual), mLoader(loader), mStateCount(0)
+        mSize(0), mGpuSize(0), mIsManual(isManual), mLoader(loader), mStateCount(0),
+        mLastUsedFrame(0), mSharedPtrInfo(this)
     {
     }
     //-----------------------------------------------------------------------
@@ -85,6 +87,7 @@ namespace Ogre
         {
 
                     OGRE_LOCK_AUTO_MUTEX;
+            ResourceLoadTraceScope trace(RLP_PREPARE, mName);
 
             if (mIsManual)
             {
@@ -199,6 +202,7 @@ namespace Ogre
         {
 
                     OGRE_LOCK_AUTO_MUTEX;
+            ResourceLoadTraceScope trace(RLP_LOAD, mName);
 
 
 
@@ -244,6 +248,8 @@ namespace Ogre
 
             // Calculate resource size
             mSize = calculateSize();
+            mGpuSize = calculateGpuSize();
+            trace.setBytes(mSize);
 
         }
         catch (...)
@@ -358,11 +364,19 @@ namespace Ogre
     {
         // make sure loaded
         load();
+        _notifyUsed();
 
         if(mCreator)
             mCreator->_notifyResourceTouched(this);
     }
     //-----------------------------------------------------------------------
+    void Resource::_notifyUsed(void)
+    {
+        ResourceGroupManager* rgm = ResourceGroupManager::getSingletonPtr();
+        if (rgm)
+            mLastUsedFrame = rgm->_getFrameNumber();
+    }
+    //-----------------------------------------------------------------------
     void Resource::addListener(Resource::Listener* lis)
     {
             OGRE_LOCK_MUTEX(mListenerListMutex);
@@ -30,6 +30,8 @@ THE SOFTWARE.
 #include "OgreException.h"
 #include "OgreResourceManager.h"
 #include "OgreRoot.h"
+#include "OgreTimer.h"
+#include "OgreResourceLoadTrace.h"
 
 namespace Ogre {
 
@@ -48,7 +50,11 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------   
     //------------------------------------------------------------------------
-    ResourceBackgroundQueue::ResourceBackgroundQueue() : mWorkQueueChannel(0)
+    ResourceBackgroundQueue::ResourceBackgroundQueue()
+        : mWorkQueueChannel(0)
+        , mNextTicket(1)
+        , mMaxRequestsInFlight(0)
+        , mFinaliseTimeBudget(0)
     {
     }
     //------------------------------------------------------------------------
@@ -71,6 +77,16 @@ namespace Ogre {
         wq->abortRequestsByChannel(mWorkQueueChannel);
         wq->removeRequestHandler(mWorkQueueChannel, this);
         wq->removeResponseHandler(mWorkQueueChannel, this);
+
+        for (PendingRequestList::iterator i = mPendingRequests.begin(); i != mPendingRequests.end(); ++i)
+        {
+            destroyLoadParams(*i);
+            mOutstandingRequestSet.erase(i->ticket);
+        }
+        mPendingRequests.clear();
+        for (ResourceResponseQueue::iterator i = mCompletedResponses.begin(); i != mCompletedResponses.end(); ++i)
+            mOutstandingRequestSet.erase(i->request.ticket);
+        mCompletedResponses.clear();
     }
     //------------------------------------------------------------------------
     BackgroundProcessTicket ResourceBackgroundQueue::initialiseResourceGroup(
@@ -267,24 +283,99 @@ namespace Ogre {
     //------------------------------------------------------------------------
     void ResourceBackgroundQueue::abortRequest( BackgroundProcessTicket ticket )
     {
-        WorkQueue* queue = Root::getSingleton().getWorkQueue();
+        InFlightRequestMap::iterator f = mInFlightRequests.find(ticket);
+        if (f != mInFlightRequests.end())
+        {
+            // The worker checks the aborted flag before doing any work, and the
+            // response is dropped in handleResponse
+            WorkQueue* queue = Root::getSingleton().getWorkQueue();
+            queue->abortRequest(f->second);
+            return;
+        }
 
-        queue->abortRequest( ticket );
+        for (PendingRequestList::iterator i = mPendingRequests.begin(); i != mPendingRequests.end(); ++i)
+        {
+            if (i->ticket == ticket)
+            {
+                destroyLoadParams(*i);
+                mPendingRequests.erase(i);
+                mOutstandingRequestSet.erase(ticket);
+                return;
+            }
+        }
+
+        for (ResourceResponseQueue::iterator i = mCompletedResponses.begin(); i != mCompletedResponses.end(); ++i)
+        {
+            if (i->request.ticket == ticket)
+            {
+                mCompletedResponses.erase(i);
+                mOutstandingRequestSet.erase(ticket);
+                return;
+            }
+        }
+    }
+    //------------------------------------------------------------------------
+    void ResourceBackgroundQueue::setRequestPriority(BackgroundProcessTicket ticket, Real priority)
+    {
+        for (PendingRequestList::iterator i = mPendingRequests.begin(); i != mPendingRequests.end(); ++i)
+        {
+            if (i->ticket == ticket)
+            {
+                i->priority = priority;
+                break;
+            }
+        }
+    }
+    //------------------------------------------------------------------------
+    void ResourceBackgroundQueue::setMaxRequestsInFlight(size_t count)
+    {
+        mMaxRequestsInFlight = count;
+        startPendingRequests();
     }
     //------------------------------------------------------------------------
     BackgroundProcessTicket ResourceBackgroundQueue::addRequest(ResourceRequest& req)
     {
-        WorkQueue* queue = Root::getSingleton().getWorkQueue();
-
-        Any data(req);
-
-        WorkQueue::RequestID requestID = 
-            queue->addRequest(mWorkQueueChannel, (uint16)req.type, data);
+        req.ticket = mNextTicket++;
+        req.priority = 0;
+        ResourceLoadTrace* trace = ResourceGroupManager::getSingleton().getLoadTrace();
+        req.queueTime = trace ? trace->getTime() : 0;
+        mOutstandingRequestSet.insert(req.ticket);
 
+        mPendingRequests.push_back(req);
+        startPendingRequests();
 
-        mOutstandingRequestSet.insert(requestID);
+        return req.ticket;
+    }
+    //------------------------------------------------------------------------
+    void ResourceBackgroundQueue::startPendingRequests(void)
+    {
+        WorkQueue* queue = Root::getSingleton().getWorkQueue();
+        while (!mPendingRequests.empty() &&
+            (!mMaxRequestsInFlight || mInFlightRequests.size() < mMaxRequestsInFlight))
+        {
+            // Highest priority first, oldest first among equals
+            PendingRequestList::iterator next = mPendingRequests.begin();
+            for (PendingRequestList::iterator i = next + 1; i != mPendingRequests.end(); ++i)
+            {
+                if (i->priority > next->priority)
+                    next = i;
+            }
+            ResourceRequest req = *next;
+            mPendingRequests.erase(next);
 
-        return requestID;
+            WorkQueue::RequestID requestID =
+                queue->addRequest(mWorkQueueChannel, (uint16)req.type, Any(req));
+            mInFlightRequests[req.ticket] = requestID;
+        }
+    }
+    //------------------------------------------------------------------------
+    void ResourceBackgroundQueue::destroyLoadParams(ResourceRequest& req)
+    {
+        if( req.type == RT_PREPARE_RESOURCE || req.type == RT_LOAD_RESOURCE )
+        {
+            OGRE_DELETE_T(req.loadParams, NameValuePairList, MEMCATEGORY_GENERAL);
+            req.loadParams = 0;
+        }
     }
     //-----------------------------------------------------------------------
     bool ResourceBackgroundQueue::canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
@@ -297,13 +388,17 @@ namespace Ogre {
 
         ResourceRequest resreq = any_cast<ResourceRequest>(req->getData());
 
+        ResourceLoadTrace* trace = ResourceGroupManager::getSingleton().getLoadTrace();
+        if (trace && resreq.queueTime)
+        {
+            trace->recordEvent(RLP_QUEUE,
+                resreq.resourceName.empty() ? resreq.groupName : resreq.resourceName, 0,
+                resreq.queueTime, trace->getTime());
+        }
+
         if( req->getAborted() )
         {
-            if( resreq.type == RT_PREPARE_RESOURCE || resreq.type == RT_LOAD_RESOURCE )
-            {
-                OGRE_DELETE_T(resreq.loadParams, NameValuePairList, MEMCATEGORY_GENERAL);
-                resreq.loadParams = 0;
-            }
+            destroyLoadParams(resreq);
             resreq.result.error = false;
             ResourceResponse resresp(ResourcePtr(), resreq);
             return OGRE_NEW WorkQueue::Response(req, true, Any(resresp));
@@ -369,11 +464,7 @@ namespace Ogre {
         }
         catch (Exception& e)
         {
-            if( resreq.type == RT_PREPARE_RESOURCE || resreq.type == RT_LOAD_RESOURCE )
-            {
-                OGRE_DELETE_T(resreq.loadParams, NameValuePairList, MEMCATEGORY_GENERAL);
-                resreq.loadParams = 0;
-            }
+            destroyLoadParams(resreq);
             resreq.result.error = true;
             resreq.result.message = e.getFullDescription();
 
@@ -384,11 +475,7 @@ namespace Ogre {
 
 
         // success
-        if( resreq.type == RT_PREPARE_RESOURCE || resreq.type == RT_LOAD_RESOURCE )
-        {
-            OGRE_DELETE_T(resreq.loadParams, NameValuePairList, MEMCATEGORY_GENERAL);
-            resreq.loadParams = 0;
-        }
+        destroyLoadParams(resreq);
         resreq.result.error = false;
         ResourceResponse resresp(resource, resreq);
         return OGRE_NEW WorkQueue::Response(req, true, Any(resresp));
@@ -402,18 +489,49 @@ namespace Ogre {
     //------------------------------------------------------------------------
     void ResourceBackgroundQueue::handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
     {
+        ResourceResponse resresp = any_cast<ResourceResponse>(res->getData());
+        const BackgroundProcessTicket ticket = resresp.request.ticket;
+        mInFlightRequests.erase(ticket);
+
         if( res->getRequest()->getAborted() )
         {
-            mOutstandingRequestSet.erase(res->getRequest()->getID());
-            return ;
+            mOutstandingRequestSet.erase(ticket);
+        }
+        else if (mFinaliseTimeBudget)
+        {
+            mCompletedResponses.push_back(resresp);
+        }
+        else
+        {
+            finaliseResponse(resresp);
         }
 
-        ResourceResponse resresp = any_cast<ResourceResponse>(res->getData());
+        startPendingRequests();
+    }
+    //------------------------------------------------------------------------
+    void ResourceBackgroundQueue::_update(void)
+    {
+        if (mCompletedResponses.empty())
+            return;
 
+        Timer* timer = Root::getSingleton().getTimer();
+        unsigned long msStart = timer->getMilliseconds();
+        do
+        {
+            ResourceResponse resresp = mCompletedResponses.front();
+            mCompletedResponses.pop_front();
+            finaliseResponse(resresp);
+        }
+        while (!mCompletedResponses.empty() &&
+            (!mFinaliseTimeBudget || timer->getMilliseconds() - msStart < mFinaliseTimeBudget));
+    }
+    //------------------------------------------------------------------------
+    void ResourceBackgroundQueue::finaliseResponse(ResourceResponse& resresp)
+    {
         // Complete full loading in main thread if semithreading
         const ResourceRequest& req = resresp.request;
 
-        if (res->succeeded())
+        if (!req.result.error)
         {
 #if OGRE_THREAD_SUPPORT == 2
             // These load commands would have been downgraded to prepare() for the background
@@ -428,7 +546,7 @@ namespace Ogre {
                 ResourceGroupManager::getSingleton().loadResourceGroup(req.groupName);
             }
 #endif
-            mOutstandingRequestSet.erase(res->getRequest()->getID());
+            mOutstandingRequestSet.erase(req.ticket);
 
             // Call resource listener
             if (!resresp.resource.isNull()) 
@@ -446,7 +564,7 @@ namespace Ogre {
         }
         // Call queue listener
         if (req.listener)
-            req.listener->operationCompleted(res->getRequest()->getID(), req.result);
+            req.listener->operationCompleted(req.ticket, req.result);
     }
     //------------------------------------------------------------------------
 
@@ -34,6 +34,10 @@ THE SOFTWARE.
 #include "OgreScriptLoader.h"
 #include "OgreSceneManager.h"
 #include "OgreResourceManager.h"
+#include "OgreResourceLoadTrace.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
+#include "OgreScriptCompiler.h"
 
 namespace Ogre {
 
@@ -56,7 +60,9 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     ResourceGroupManager::ResourceGroupManager()
-        : mLoadingListener(0), mCurrentGroup(0)
+        : mLoadingListener(0), mCurrentGroup(0), mFrameNumber(0), mMemoryBudget(0)
+        , mEvictionIdleFrames(3), mMaxEvictionPerFrame(0), mParallelPrepare(false)
+        , mParallelScriptParsing(false), mLoadTrace(0)
     {
         // Create the 'General' group
         createResourceGroup(DEFAULT_RESOURCE_GROUP_NAME);
@@ -96,6 +102,8 @@ namespace Ogre {
         grp->name = name;
         grp->inGlobalPool = inGlobalPool;
         grp->worldGeometrySceneManager = 0;
+
+        OGRE_LOCK_RW_MUTEX_WRITE(mResourceGroupMapMutex);
         mResourceGroupMap.insert(
             ResourceGroupMap::value_type(name, grp));
     }
@@ -160,6 +168,9 @@ namespace Ogre {
     void ResourceGroupManager::prepareResourceGroup(const String& name, 
         bool prepareMainResources, bool prepareWorldGeom)
     {
+        if (mParallelPrepare && prepareMainResources)
+            prepareResourcesParallel(name);
+
         // Can only bulk-load one group at a time (reasonable limitation I think)
         OGRE_LOCK_AUTO_MUTEX;
 
@@ -254,9 +265,86 @@ namespace Ogre {
         LogManager::getSingleton().logMessage("Finished preparing resource group " + name);
     }
     //-----------------------------------------------------------------------
+    namespace {
+        /// Prepares a range of resources, leaving the failed ones unprepared
+        class ResourcePrepareTask : public WorkQueue::ParallelTask
+        {
+            ResourcePtr* mResources;
+        public:
+            ResourcePrepareTask(ResourcePtr* resources) : mResources(resources) {}
+
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    try
+                    {
+                        mResources[i]->prepare(true);
+                    }
+                    catch (...)
+                    {
+                        // Prepared again by the serial pass, which reports it
+                    }
+                }
+            }
+        };
+    }
+    void ResourceGroupManager::prepareResourcesParallel(const String& name)
+    {
+        typedef vector<ResourcePtr>::type ResourceVector;
+        typedef vector<ResourceVector>::type ResourcesByOrder;
+        ResourcesByOrder resources;
+        {
+            OGRE_LOCK_AUTO_MUTEX;
+            ResourceGroup* grp = getResourceGroup(name);
+            if (!grp)
+                return;
+
+            OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME);
+            ResourceGroup::LoadResourceOrderMap::iterator oi;
+            for (oi = grp->loadResourceOrderMap.begin(); oi != grp->loadResourceOrderMap.end(); ++oi)
+            {
+                resources.push_back(ResourceVector());
+                LoadUnloadResourceList::iterator l;
+                for (l = oi->second->begin(); l != oi->second->end(); ++l)
+                {
+                    const ResourcePtr& res = *l;
+                    // Loaders are user code, and autodetect changes the group lists
+                    if (res->getLoadingState() == Resource::LOADSTATE_UNLOADED &&
+                        !res->isManuallyLoaded() && res->getGroup() != AUTODETECT_RESOURCE_GROUP_NAME)
+                    {
+                        resources.back().push_back(res);
+                    }
+                }
+            }
+        }
+
+        // Locks released, the workers open the resources through this class
+        WorkQueue* queue = Root::getSingleton().getWorkQueue();
+        for (ResourcesByOrder::iterator i = resources.begin(); i != resources.end(); ++i)
+        {
+            if (i->empty())
+                continue;
+
+            ResourcePrepareTask task(&(*i)[0]);
+            // Resources vary a lot in size, hand them out one at a time
+            queue->parallelFor(i->size(), 1, &task);
+
+            // Prepared as background, so notify the resource listeners from here
+            for (ResourceVector::iterator r = i->begin(); r != i->end(); ++r)
+            {
+                if ((*r)->getLoadingState() == Resource::LOADSTATE_PREPARED)
+                    (*r)->_firePreparingComplete(false);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
     void ResourceGroupManager::loadResourceGroup(const String& name, 
         bool loadMainResources, bool loadWorldGeom)
     {
+        if (mParallelPrepare && loadMainResources)
+            prepareResourcesParallel(name);
+
         // Can only bulk-load one group at a time (reasonable limitation I think)
         OGRE_LOCK_AUTO_MUTEX;
 
@@ -480,8 +568,11 @@ namespace Ogre {
         mCurrentGroup = grp;
         unloadResourceGroup(name, false); // will throw an exception if name not valid
         dropGroupContents(grp);
+        {
+            OGRE_LOCK_RW_MUTEX_WRITE(mResourceGroupMapMutex);
+            mResourceGroupMap.erase(mResourceGroupMap.find(name));
+        }
         deleteGroup(grp);
-        mResourceGroupMap.erase(mResourceGroupMap.find(name));
         // reset current group
         mCurrentGroup = 0;
     }
@@ -670,6 +761,7 @@ namespace Ogre {
         const String& resourceName, const String& groupName, 
         bool searchGroupsIfNotFound, Resource* resourceBeingLoaded)
     {
+        ResourceLoadTraceScope trace(RLP_OPEN, resourceName);
         OGRE_LOCK_AUTO_MUTEX;
 
         if(mLoadingListener)
@@ -700,6 +792,7 @@ namespace Ogre {
             DataStreamPtr stream = pArch->open(resourceName);
             if (mLoadingListener)
                 mLoadingListener->resourceStreamOpened(resourceName, groupName, resourceBeingLoaded, stream);
+            trace.setBytes(stream.isNull() ? 0 : stream->size());
             return stream;
         }
         else 
@@ -715,6 +808,7 @@ namespace Ogre {
                 DataStreamPtr stream = pArch->open(resourceName);
                 if (mLoadingListener)
                     mLoadingListener->resourceStreamOpened(resourceName, groupName, resourceBeingLoaded, stream);
+                trace.setBytes(stream.isNull() ? 0 : stream->size());
                 return stream;
             }
             else
@@ -730,6 +824,7 @@ namespace Ogre {
                         DataStreamPtr ptr = arch->open(resourceName);
                         if (mLoadingListener)
                             mLoadingListener->resourceStreamOpened(resourceName, groupName, resourceBeingLoaded, ptr);
+                        trace.setBytes(ptr.isNull() ? 0 : ptr->size());
                         return ptr;
                     }
                 }
@@ -1017,6 +1112,44 @@ namespace Ogre {
         return 0; // No loader was found
     }
     //-----------------------------------------------------------------------
+    namespace {
+        /// A script read and parsed ahead of compiling it
+        struct ParsedScript
+        {
+            DataStreamPtr stream;
+            ConcreteNodeListPtr nodes;
+        };
+        typedef map<const FileInfo*, ParsedScript>::type ParsedScriptMap;
+
+        /// Reads and parses a range of scripts, leaving the nodes of the failed ones null
+        class ScriptParseTask : public WorkQueue::ParallelTask
+        {
+            ParsedScript** mScripts;
+        public:
+            ScriptParseTask(ParsedScript** scripts) : mScripts(scripts) {}
+
+            void execute(size_t begin, size_t end)
+            {
+                ScriptCompilerManager& compilerMgr = ScriptCompilerManager::getSingleton();
+                for (size_t i = begin; i < end; ++i)
+                {
+                    ParsedScript* script = mScripts[i];
+                    ResourceLoadTraceScope trace(RLP_PARSE, script->stream->getName(),
+                        script->stream->size());
+                    try
+                    {
+                        script->nodes = compilerMgr._parseScriptNodes(
+                            script->stream->getAsString(), script->stream->getName());
+                    }
+                    catch (...)
+                    {
+                        // Parsed again by the serial pass, which reports it
+                        script->nodes.setNull();
+                    }
+                }
+            }
+        };
+    }
     void ResourceGroupManager::parseResourceGroupScripts(ResourceGroup* grp)
     {
 
@@ -1050,6 +1183,44 @@ namespace Ogre {
             scriptLoaderFileList.push_back(
                 LoaderFileListPair(su, fileListList));
         }
+        // Parse the scripts of the compiler manager ahead, in parallel. Only the file
+        // system archives support reading several files at once
+        ParsedScriptMap parsedScripts;
+        ScriptLoader* compilerMgr = ScriptCompilerManager::getSingletonPtr();
+        if (mParallelScriptParsing && compilerMgr)
+        {
+            vector<ParsedScript*>::type toParse;
+            for (ScriptLoaderFileList::iterator slfli = scriptLoaderFileList.begin();
+                slfli != scriptLoaderFileList.end(); ++slfli)
+            {
+                if (slfli->first != compilerMgr)
+                    continue;
+                for (FileListList::iterator flli = slfli->second->begin(); flli != slfli->second->end(); ++flli)
+                {
+                    for (FileInfoList::iterator fii = (*flli)->begin(); fii != (*flli)->end(); ++fii)
+                    {
+                        if (fii->archive->getType() != "FileSystem")
+                            continue;
+                        DataStreamPtr stream = fii->archive->open(fii->filename);
+                        if (stream.isNull())
+                            continue;
+                        if (mLoadingListener)
+                            mLoadingListener->resourceStreamOpened(fii->filename, grp->name, 0, stream);
+
+                        ParsedScript& script = parsedScripts[&*fii];
+                        script.stream = stream;
+                        toParse.push_back(&script);
+                    }
+                }
+            }
+
+            if (!toParse.empty())
+            {
+                ScriptParseTask task(&toParse[0]);
+                Root::getSingleton().getWorkQueue()->parallelFor(toParse.size(), 1, &task);
+            }
+        }
+
         // Fire scripting event
         fireResourceGroupScriptingStarted(grp->name, scriptCount);
 
@@ -1065,6 +1236,8 @@ namespace Ogre {
                 // Iterate over each item in the list
                 for (FileInfoList::iterator fii = (*flli)->begin(); fii != (*flli)->end(); ++fii)
                 {
+                    ParsedScriptMap::iterator parsed = parsedScripts.find(&*fii);
+                    ResourceLoadTraceScope trace(RLP_PARSE, fii->filename, fii->uncompressedSize);
                     bool skipScript = false;
                     fireScriptStarted(fii->filename, skipScript);
                     if(skipScript)
@@ -1072,6 +1245,13 @@ namespace Ogre {
                         LogManager::getSingleton().logMessage(
                             "Skipping script " + fii->filename);
                     }
+                    else if (parsed != parsedScripts.end() && !parsed->second.nodes.isNull())
+                    {
+                        LogManager::getSingleton().logMessage(
+                            "Parsing script " + fii->filename);
+                        ScriptCompilerManager::getSingleton()._compileScriptNodes(
+                            parsed->second.nodes, grp->name);
+                    }
                     else
                     {
                         LogManager::getSingleton().logMessage(
@@ -1082,7 +1262,8 @@ namespace Ogre {
                             if (mLoadingListener)
                                 mLoadingListener->resourceStreamOpened(fii->filename, grp->name, 0, stream);
 
-                            if(fii->archive->getType() == "FileSystem" && stream->size() <= 1024 * 1024)
+                            if(fii->archive->getType() == "FileSystem" && stream->size() <= 1024 * 1024 &&
+                               !dynamic_cast<MemoryDataStream*>(stream.get()))
                             {
                                 DataStreamPtr cachedCopy;
                                 cachedCopy.bind(OGRE_NEW MemoryDataStream(stream->getName(), stream));
@@ -1276,7 +1457,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     ResourceGroupManager::ResourceGroup* ResourceGroupManager::getResourceGroup(const String& name)
     {
-            OGRE_LOCK_AUTO_MUTEX;
+        OGRE_LOCK_RW_MUTEX_READ(mResourceGroupMapMutex);
 
         ResourceGroupMap::iterator i = mResourceGroupMap.find(name);
         if (i != mResourceGroupMap.end())
@@ -1534,6 +1715,158 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    size_t ResourceGroupManager::getMemoryUsage(void)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+
+        size_t usage = 0;
+        ResourceManagerMap::iterator i, iend;
+        iend = mResourceManagerMap.end();
+        for (i = mResourceManagerMap.begin(); i != iend; ++i)
+        {
+            usage += i->second->getMemoryUsage();
+        }
+        return usage;
+    }
+    //-----------------------------------------------------------------------
+    size_t ResourceGroupManager::getResourceGroupMemoryUsage(const String& name)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+
+        ResourceGroup* grp = getResourceGroup(name);
+        if (!grp)
+        {
+            OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, 
+                "Cannot find a group named " + name, 
+                "ResourceGroupManager::getResourceGroupMemoryUsage");
+        }
+
+        OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME);
+        size_t usage = 0;
+        ResourceGroup::LoadResourceOrderMap::iterator oi;
+        for (oi = grp->loadResourceOrderMap.begin(); oi != grp->loadResourceOrderMap.end(); ++oi)
+        {
+            for (LoadUnloadResourceList::iterator l = oi->second->begin();
+                l != oi->second->end(); ++l)
+            {
+                if ((*l)->isLoaded())
+                    usage += (*l)->getSize();
+            }
+        }
+        return usage;
+    }
+    //-----------------------------------------------------------------------
+    ResourceGroupManager::ResourceMemoryUsageList ResourceGroupManager::getMemoryUsageSnapshot(void)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+
+        // Keyed by group then resource type, which also sorts the result
+        typedef map<std::pair<String, String>, ResourceMemoryUsage>::type UsageMap;
+        UsageMap usageMap;
+        for (ResourceGroupMap::iterator gi = mResourceGroupMap.begin(); gi != mResourceGroupMap.end(); ++gi)
+        {
+            ResourceGroup* grp = gi->second;
+            OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME);
+            ResourceGroup::LoadResourceOrderMap::iterator oi;
+            for (oi = grp->loadResourceOrderMap.begin(); oi != grp->loadResourceOrderMap.end(); ++oi)
+            {
+                for (LoadUnloadResourceList::iterator l = oi->second->begin();
+                    l != oi->second->end(); ++l)
+                {
+                    Resource* res = l->get();
+                    if (!res->isLoaded())
+                        continue;
+
+                    const String& type = res->getCreator()->getResourceType();
+                    std::pair<UsageMap::iterator, bool> ins = usageMap.insert(
+                        UsageMap::value_type(std::make_pair(grp->name, type), ResourceMemoryUsage()));
+                    ResourceMemoryUsage& usage = ins.first->second;
+                    if (ins.second)
+                    {
+                        usage.group = grp->name;
+                        usage.resourceType = type;
+                        usage.count = usage.cpuBytes = usage.gpuBytes = 0;
+                    }
+                    ++usage.count;
+                    usage.gpuBytes += res->getGpuSize();
+                    usage.cpuBytes += res->getSize() - res->getGpuSize();
+                }
+            }
+        }
+
+        ResourceMemoryUsageList result;
+        result.reserve(usageMap.size());
+        for (UsageMap::iterator i = usageMap.begin(); i != usageMap.end(); ++i)
+            result.push_back(i->second);
+        return result;
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::exportMemoryUsage(const ResourceMemoryUsageList& usage, std::ostream& os)
+    {
+        os << "group,type,count,cpu_bytes,gpu_bytes\n";
+        for (ResourceMemoryUsageList::const_iterator i = usage.begin(); i != usage.end(); ++i)
+        {
+            os << i->group << ',' << i->resourceType << ',' << i->count << ','
+                << i->cpuBytes << ',' << i->gpuBytes << '\n';
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::_updateResidency(void)
+    {
+        ++mFrameNumber;
+
+        if (mMemoryBudget == 0)
+            return;
+
+        size_t usage = getMemoryUsage();
+        if (usage <= mMemoryBudget)
+            return;
+
+        OGRE_LOCK_AUTO_MUTEX;
+
+        // Gather eviction candidates from every group, least recently used first
+        typedef std::pair<unsigned long, Resource*> Candidate;
+        vector<Candidate>::type candidates;
+        for (ResourceGroupMap::iterator gi = mResourceGroupMap.begin(); gi != mResourceGroupMap.end(); ++gi)
+        {
+            ResourceGroup* grp = gi->second;
+            OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME);
+            ResourceGroup::LoadResourceOrderMap::iterator oi;
+            for (oi = grp->loadResourceOrderMap.begin(); oi != grp->loadResourceOrderMap.end(); ++oi)
+            {
+                for (LoadUnloadResourceList::iterator l = oi->second->begin();
+                    l != oi->second->end(); ++l)
+                {
+                    Resource* res = l->get();
+                    if (!res->isLoaded() || !res->isReloadable() ||
+                        res->getLastUsedFrame() + mEvictionIdleFrames > mFrameNumber)
+                        continue;
+
+                    // See unloadUnreferencedResourcesInGroup for the reference count
+                    if (l->useCount() != RESOURCE_SYSTEM_NUM_REFERENCE_COUNTS &&
+                        !res->getCreator()->getEvictReferenced())
+                        continue;
+
+                    candidates.push_back(Candidate(res->getLastUsedFrame(), res));
+                }
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        size_t evicted = 0;
+        vector<Candidate>::type::iterator ci;
+        for (ci = candidates.begin(); ci != candidates.end() && usage > mMemoryBudget; ++ci)
+        {
+            if (mMaxEvictionPerFrame && evicted >= mMaxEvictionPerFrame)
+                break;
+
+            size_t size = ci->second->getSize();
+            ci->second->unload();
+            usage -= std::min(size, usage);
+            evicted += size;
+        }
+    }
+    //-----------------------------------------------------------------------
     StringVectorPtr ResourceGroupManager::listResourceNames(const String& groupName, bool dirs)
     {
         OGRE_LOCK_AUTO_MUTEX;
@@ -1909,8 +2242,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     bool ResourceGroupManager::isResourceGroupInGlobalPool(const String& name)
     {
-        OGRE_LOCK_AUTO_MUTEX;
-
+        // Only reads the group map and a flag set at creation, so no exclusive lock
         ResourceGroup* grp = getResourceGroup(name);
         if (!grp)
         {
@@ -0,0 +1,150 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreResourceLoadTrace.h"
+#include "OgreProfileTraceListener.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreRoot.h"
+#include "OgreTimer.h"
+#include "OgreLogManager.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    static bool compareTotalTime(const ResourceLoadTrace::ResourceTiming& a,
+        const ResourceLoadTrace::ResourceTiming& b)
+    {
+        return a.getTotalTime() > b.getTotalTime();
+    }
+    //-----------------------------------------------------------------------
+    ResourceLoadTrace::ResourceLoadTrace(ProfileTraceListener* traceListener)
+        : mTraceListener(traceListener), mTimer(Root::getSingleton().getTimer())
+    {
+    }
+    //-----------------------------------------------------------------------
+    ResourceLoadTrace::~ResourceLoadTrace()
+    {
+    }
+    //-----------------------------------------------------------------------
+    ulong ResourceLoadTrace::getTime(void) const
+    {
+        return mTimer->getMicroseconds();
+    }
+    //-----------------------------------------------------------------------
+    void ResourceLoadTrace::recordEvent(ResourceLoadPhase phase, const String& resource,
+        size_t bytes, ulong startTime, ulong endTime)
+    {
+        if (mTraceListener)
+        {
+            mTraceListener->recordEvent(String(getPhaseName(phase)) + " " + resource,
+                startTime, endTime, bytes);
+        }
+
+        OGRE_LOCK_MUTEX(mTimingsMutex);
+        ResourceTimingMap::iterator i = mTimings.find(resource);
+        if (i == mTimings.end())
+        {
+            ResourceTiming timing;
+            timing.name = resource;
+            std::fill(timing.time, timing.time + RLP_COUNT, 0);
+            timing.bytes = 0;
+            i = mTimings.insert(ResourceTimingMap::value_type(resource, timing)).first;
+        }
+        i->second.time[phase] += endTime - startTime;
+        i->second.bytes = std::max(i->second.bytes, bytes);
+    }
+    //-----------------------------------------------------------------------
+    ResourceLoadTrace::ResourceTimingList ResourceLoadTrace::getSlowestResources(size_t count) const
+    {
+        ResourceTimingList result;
+        {
+            OGRE_LOCK_MUTEX(mTimingsMutex);
+            result.reserve(mTimings.size());
+            for (ResourceTimingMap::const_iterator i = mTimings.begin(); i != mTimings.end(); ++i)
+                result.push_back(i->second);
+        }
+
+        count = std::min(count, result.size());
+        std::partial_sort(result.begin(), result.begin() + count, result.end(), compareTotalTime);
+        result.resize(count);
+        return result;
+    }
+    //-----------------------------------------------------------------------
+    void ResourceLoadTrace::logSlowestResources(size_t count) const
+    {
+        ResourceTimingList slowest = getSlowestResources(count);
+
+        LogManager::getSingleton().logMessage("Slowest resources to load (ms):");
+        for (ResourceTimingList::iterator i = slowest.begin(); i != slowest.end(); ++i)
+        {
+            Log::Stream stream = LogManager::getSingleton().stream();
+            stream << "  " << i->name << ": " << i->getTotalTime() / 1000.0f;
+            for (int phase = 0; phase < RLP_COUNT; ++phase)
+            {
+                if (i->time[phase] && phase != RLP_PREPARE && phase != RLP_LOAD)
+                {
+                    stream << " " << getPhaseName(static_cast<ResourceLoadPhase>(phase)) << " "
+                        << i->time[phase] / 1000.0f;
+                }
+            }
+            if (i->bytes)
+                stream << " (" << i->bytes << " bytes)";
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ResourceLoadTrace::clear(void)
+    {
+        OGRE_LOCK_MUTEX(mTimingsMutex);
+        mTimings.clear();
+    }
+    //-----------------------------------------------------------------------
+    const char* ResourceLoadTrace::getPhaseName(ResourceLoadPhase phase)
+    {
+        static const char* names[RLP_COUNT] =
+            { "queue", "open", "decode", "parse", "prepare", "load", "upload", "compile" };
+        return names[phase];
+    }
+    //-----------------------------------------------------------------------
+    ResourceLoadTraceScope::ResourceLoadTraceScope(ResourceLoadPhase phase, const String& resource,
+        size_t bytes)
+        : mTrace(0), mPhase(phase), mBytes(bytes), mStartTime(0)
+    {
+        ResourceGroupManager* rgm = ResourceGroupManager::getSingletonPtr();
+        if (rgm && (mTrace = rgm->getLoadTrace()))
+        {
+            mResource = resource;
+            mStartTime = mTrace->getTime();
+        }
+    }
+    //-----------------------------------------------------------------------
+    ResourceLoadTraceScope::~ResourceLoadTraceScope()
+    {
+        if (mTrace)
+            mTrace->recordEvent(mPhase, mResource, mBytes, mStartTime, mTrace->getTime());
+    }
+    //-----------------------------------------------------------------------
+}
@@ -33,9 +33,38 @@ THE SOFTWARE.
 
 namespace Ogre {
 
+    namespace
+    {
+        /// Returns the key and entry under which a resource is kept in mResourcesById
+        ResourceManager::ResourceIdMap::value_type makeResourceIdEntry(Resource* res, bool inGlobalPool)
+        {
+            IdString name(res->getName());
+            ResourceManager::ResourceIdEntry entry = { res, name.mHash, 0 };
+            if (inGlobalPool)
+                return ResourceManager::ResourceIdMap::value_type(name.mHash, entry);
+
+            IdString group(res->getGroup());
+            entry.groupHash = group.mHash;
+            return ResourceManager::ResourceIdMap::value_type((group + name).mHash, entry);
+        }
+
+        /// Finds the entry under idKey for the given name, as keys may collide
+        Resource* findResourceById(const ResourceManager::ResourceIdMap& index,
+            uint32 idKey, uint32 nameHash, uint32 groupHash)
+        {
+            std::pair<ResourceManager::ResourceIdMap::const_iterator, ResourceManager::ResourceIdMap::const_iterator>
+                range = index.equal_range(idKey);
+            for (ResourceManager::ResourceIdMap::const_iterator it = range.first; it != range.second; ++it)
+            {
+                if (it->second.nameHash == nameHash && it->second.groupHash == groupHash)
+                    return it->second.resource;
+            }
+            return 0;
+        }
+    }
     //-----------------------------------------------------------------------
     ResourceManager::ResourceManager()
-        : mNextHandle(1), mMemoryUsage(0), mVerbose(true), mLoadOrder(0)
+        : mNextHandle(1), mMemoryUsage(0), mGpuMemoryUsage(0), mVerbose(true), mEvictReferenced(false), mLoadOrder(0)
     {
         // Init memory limit & usage
         mMemoryBudget = std::numeric_limits<unsigned long>::max();
@@ -50,9 +79,9 @@ namespace Ogre {
     ResourcePtr ResourceManager::createResource(const String& name, const String& group,
         bool isManual, ManualResourceLoader* loader, const NameValuePairList* params)
     {
-        // Call creation implementation
-        ResourcePtr ret = ResourcePtr(
-            createImpl(name, getNextHandle(), group, isManual, loader, params));
+        // Call creation implementation, the resource holds its own reference count
+        Resource* res = createImpl(name, getNextHandle(), group, isManual, loader, params);
+        ResourcePtr ret = ResourcePtr(res, res->_getSharedPtrInfo());
         if (params)
             ret->setParameterList(*params);
 
@@ -108,27 +137,14 @@ namespace Ogre {
     {
             OGRE_LOCK_AUTO_MUTEX;
 
-            std::pair<ResourceMap::iterator, bool> result;
-        if(ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup()))
-        {
-            result = mResources.insert( ResourceMap::value_type( res->getName(), res ) );
-        }
-        else
-        {
-            ResourceWithGroupMap::iterator itGroup = mResourcesWithGroup.find(res->getGroup());
+        // getResourceById hands out pointers sharing the resource's own count
+        assert(res.useCount() == res->_getSharedPtrInfo()->useCount.get() &&
+            "Resources must be added through ResourcePtr(res, res->_getSharedPtrInfo())");
 
-            // we will create the group if it doesn't exists in our list
-            if( itGroup == mResourcesWithGroup.end())
-            {
-                ResourceMap dummy;
-                mResourcesWithGroup.insert( ResourceWithGroupMap::value_type( res->getGroup(), dummy ) );
-                itGroup = mResourcesWithGroup.find(res->getGroup());
-            }
-            result = itGroup->second.insert( ResourceMap::value_type( res->getName(), res ) );
-
-        }
+        // Asked before taking mResourcesMutex, which is never held while calling out
+        bool inGlobalPool = ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup());
 
-        if (!result.second)
+        if (!insertResource(res, inGlobalPool))
         {
             // Attempt to resolve the collision
             if(ResourceGroupManager::getSingleton().getLoadingListener())
@@ -136,30 +152,11 @@ namespace Ogre {
                 if(ResourceGroupManager::getSingleton().getLoadingListener()->resourceCollision(res.get(), this))
                 {
                     // Try to do the addition again, no seconds attempts to resolve collisions are allowed
-                    std::pair<ResourceMap::iterator, bool> insertResult;
-                    if(ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup()))
-                    {
-                        insertResult = mResources.insert( ResourceMap::value_type( res->getName(), res ) );
-                    }
-                    else
-                    {
-                        ResourceWithGroupMap::iterator itGroup = mResourcesWithGroup.find(res->getGroup());
-                        insertResult = itGroup->second.insert( ResourceMap::value_type( res->getName(), res ) );
-                    }
-                    if (!insertResult.second)
+                    if (!insertResource(res, inGlobalPool))
                     {
                         OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM, "Resource with the name " + res->getName() + 
                             " already exists.", "ResourceManager::add");
                     }
-
-                    std::pair<ResourceHandleMap::iterator, bool> resultHandle = 
-                        mResourcesByHandle.insert( ResourceHandleMap::value_type( res->getHandle(), res ) );
-                    if (!resultHandle.second)
-                    {
-                        OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM, "Resource with the handle " + 
-                            StringConverter::toString((long) (res->getHandle())) + 
-                            " already exists.", "ResourceManager::add");
-                    }
                 }
             }
             else
@@ -168,55 +165,101 @@ namespace Ogre {
                     " already exists.", "ResourceManager::add");
             }
         }
+    }
+    //-----------------------------------------------------------------------
+    bool ResourceManager::insertResource(ResourcePtr& res, bool inGlobalPool)
+    {
+        OGRE_LOCK_RW_MUTEX_WRITE(mResourcesMutex);
+
+        std::pair<ResourceMap::iterator, bool> result;
+        if (inGlobalPool)
+        {
+            result = mResources.insert( ResourceMap::value_type( res->getName(), res ) );
+        }
         else
         {
-            // Insert the handle
-            std::pair<ResourceHandleMap::iterator, bool> resultHandle = 
-                mResourcesByHandle.insert( ResourceHandleMap::value_type( res->getHandle(), res ) );
-            if (!resultHandle.second)
+            ResourceWithGroupMap::iterator itGroup = mResourcesWithGroup.find(res->getGroup());
+
+            // we will create the group if it doesn't exists in our list
+            if( itGroup == mResourcesWithGroup.end())
             {
-                OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM, "Resource with the handle " + 
-                    StringConverter::toString((long) (res->getHandle())) + 
-                    " already exists.", "ResourceManager::add");
+                ResourceMap dummy;
+                mResourcesWithGroup.insert( ResourceWithGroupMap::value_type( res->getGroup(), dummy ) );
+                itGroup = mResourcesWithGroup.find(res->getGroup());
             }
+            result = itGroup->second.insert( ResourceMap::value_type( res->getName(), res ) );
+        }
+
+        if (!result.second)
+            return false;
+
+        // Insert the handle
+        std::pair<ResourceHandleMap::iterator, bool> resultHandle = 
+            mResourcesByHandle.insert( ResourceHandleMap::value_type( res->getHandle(), res ) );
+        if (!resultHandle.second)
+        {
+            OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM, "Resource with the handle " + 
+                StringConverter::toString((long) (res->getHandle())) + 
+                " already exists.", "ResourceManager::add");
         }
+
+        mResourcesById.insert(makeResourceIdEntry(res.get(), inGlobalPool));
+        return true;
     }
     //-----------------------------------------------------------------------
     void ResourceManager::removeImpl(const ResourcePtr& res )
     {
             OGRE_LOCK_AUTO_MUTEX;
 
-        if(ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup()))
+        bool inGlobalPool = ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup());
+        uint32 idKey = makeResourceIdEntry(res.get(), inGlobalPool).first;
+
         {
-            ResourceMap::iterator nameIt = mResources.find(res->getName());
-            if (nameIt != mResources.end())
+            OGRE_LOCK_RW_MUTEX_WRITE(mResourcesMutex);
+
+            if (inGlobalPool)
             {
-                mResources.erase(nameIt);
+                ResourceMap::iterator nameIt = mResources.find(res->getName());
+                if (nameIt != mResources.end())
+                {
+                    mResources.erase(nameIt);
+                }
             }
-        }
-        else
-        {
-            ResourceWithGroupMap::iterator groupIt = mResourcesWithGroup.find(res->getGroup());
-            if (groupIt != mResourcesWithGroup.end())
+            else
             {
-                ResourceMap::iterator nameIt = groupIt->second.find(res->getName());
-                if (nameIt != groupIt->second.end())
+                ResourceWithGroupMap::iterator groupIt = mResourcesWithGroup.find(res->getGroup());
+                if (groupIt != mResourcesWithGroup.end())
                 {
-                    groupIt->second.erase(nameIt);
+                    ResourceMap::iterator nameIt = groupIt->second.find(res->getName());
+                    if (nameIt != groupIt->second.end())
+                    {
+                        groupIt->second.erase(nameIt);
+                    }
+
+                    if (groupIt->second.empty())
+                    {
+                        mResourcesWithGroup.erase(groupIt);
+                    }
                 }
+            }
 
-                if (groupIt->second.empty())
+            ResourceHandleMap::iterator handleIt = mResourcesByHandle.find(res->getHandle());
+            if (handleIt != mResourcesByHandle.end())
+            {
+                mResourcesByHandle.erase(handleIt);
+            }
+
+            // Only drop our own entry; colliding names may share the key
+            std::pair<ResourceIdMap::iterator, ResourceIdMap::iterator> idRange = mResourcesById.equal_range(idKey);
+            for (ResourceIdMap::iterator idIt = idRange.first; idIt != idRange.second; ++idIt)
+            {
+                if (idIt->second.resource == res.get())
                 {
-                    mResourcesWithGroup.erase(groupIt);
+                    mResourcesById.erase(idIt);
+                    break;
                 }
             }
         }
-
-        ResourceHandleMap::iterator handleIt = mResourcesByHandle.find(res->getHandle());
-        if (handleIt != mResourcesByHandle.end())
-        {
-            mResourcesByHandle.erase(handleIt);
-        }
         // Tell resource group manager
         ResourceGroupManager::getSingleton()._notifyResourceRemoved(res);
     }
@@ -334,9 +377,13 @@ namespace Ogre {
     {
             OGRE_LOCK_AUTO_MUTEX;
 
-        mResources.clear();
-        mResourcesWithGroup.clear();
-        mResourcesByHandle.clear();
+        {
+            OGRE_LOCK_RW_MUTEX_WRITE(mResourcesMutex);
+            mResources.clear();
+            mResourcesWithGroup.clear();
+            mResourcesByHandle.clear();
+            mResourcesById.clear();
+        }
         // Notify resource group manager
         ResourceGroupManager::getSingleton()._notifyAllResourcesRemoved(this);
     }
@@ -373,7 +420,7 @@ namespace Ogre {
         // if not in the global pool - get it from the grouped pool 
         if(!ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(groupName))
         {
-                    OGRE_LOCK_AUTO_MUTEX;
+            OGRE_LOCK_RW_MUTEX_READ(mResourcesMutex);
             ResourceWithGroupMap::iterator itGroup = mResourcesWithGroup.find(groupName);
 
             if( itGroup != mResourcesWithGroup.end())
@@ -390,7 +437,7 @@ namespace Ogre {
         // if didn't find it the grouped pool - get it from the global pool 
         if (res.isNull())
         {
-                    OGRE_LOCK_AUTO_MUTEX;
+            OGRE_LOCK_RW_MUTEX_READ(mResourcesMutex);
 
             ResourceMap::iterator it = mResources.find(name);
 
@@ -422,9 +469,23 @@ namespace Ogre {
         return res;
     }
     //-----------------------------------------------------------------------
+    ResourcePtr ResourceManager::getResourceById(IdString name, IdString groupName)
+    {
+        OGRE_LOCK_RW_MUTEX_READ(mResourcesMutex);
+
+        Resource* res = 0;
+        if (groupName.mHash != 0)
+            res = findResourceById(mResourcesById, (groupName + name).mHash, name.mHash, groupName.mHash);
+
+        if (!res)
+            res = findResourceById(mResourcesById, name.mHash, name.mHash, 0);
+
+        return res ? ResourcePtr(res, res->_getSharedPtrInfo()) : ResourcePtr();
+    }
+    //-----------------------------------------------------------------------
     ResourcePtr ResourceManager::getByHandle(ResourceHandle handle)
     {
-        OGRE_LOCK_AUTO_MUTEX;
+        OGRE_LOCK_RW_MUTEX_READ(mResourcesMutex);
 
         ResourceHandleMap::iterator it = mResourcesByHandle.find(handle);
         if (it == mResourcesByHandle.end())
@@ -475,12 +536,14 @@ namespace Ogre {
     void ResourceManager::_notifyResourceLoaded(Resource* res)
     {
         mMemoryUsage += res->getSize();
+        mGpuMemoryUsage += res->getGpuSize();
         checkUsage();
     }
     //-----------------------------------------------------------------------
     void ResourceManager::_notifyResourceUnloaded(Resource* res)
     {
         mMemoryUsage -= res->getSize();
+        mGpuMemoryUsage -= res->getGpuSize();
     }
     //---------------------------------------------------------------------
     ResourceManager::ResourcePool* ResourceManager::getResourcePool(const String& name)
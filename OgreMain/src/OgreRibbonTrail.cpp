@@ -385,6 +385,7 @@ namespace Ogre
                 // Move existing head to mElemLength
                 Vector3 scaledDiff = diff * (mElemLength / Math::Sqrt(sqlen));
                 headElem.position = nextElem.position + scaledDiff;
+                markElementDirty(index, seg.head);
                 // Add a new element to be the new head
                 Element newElem( newPos, mInitialWidth[index], 0.0f,
                                  mInitialColour[index], node->_getDerivedOrientation() );
@@ -400,6 +401,7 @@ namespace Ogre
             {
                 // Extend existing head
                 headElem.position = newPos;
+                markElementDirty(index, seg.head);
                 done = true;
             }
 
@@ -423,6 +425,7 @@ namespace Ogre
                     Real tailsize = mElemLength - diff.length();
                     taildiff *= tailsize / taillen;
                     tailElem.position = preTailElem.position + taildiff;
+                    markElementDirty(index, seg.tail);
                 }
 
             }
@@ -446,9 +449,11 @@ namespace Ogre
         for (size_t s = 0; s < mChainSegmentList.size(); ++s)
         {
             ChainSegment& seg = mChainSegmentList[s];
-            if (seg.head != SEGMENT_EMPTY && seg.head != seg.tail)
+            if (seg.head != SEGMENT_EMPTY && seg.head != seg.tail &&
+                (mDeltaWidth[s] != 0 || mDeltaColour[s] != ColourValue::ZERO))
             {
-                
+                markChainDirty(s);
+
                 for(size_t e = seg.head + 1;; ++e) // until break
                 {
                     e = e % mMaxElementsPerChain;
@@ -464,7 +469,6 @@ namespace Ogre
                 }
             }
         }
-        mVertexContentDirty = true;
     }
     //-----------------------------------------------------------------------
     void RibbonTrail::resetTrail(size_t index, const Node* node)
@@ -64,6 +64,7 @@ THE SOFTWARE.
 #include "OgreFrameListener.h"
 #include "OgreLodStrategyManager.h"
 #include "Threading/OgreDefaultWorkQueue.h"
+#include "Threading/OgreThreads.h"
 
 #if OGRE_NO_FREEIMAGE == 0
 #include "OgreFreeImageCodec.h"
@@ -94,6 +95,9 @@ THE SOFTWARE.
 #if OGRE_NO_ETC_CODEC == 0
 #  include "OgreETCCodec.h"
 #endif
+#if OGRE_NO_ASTC_CODEC == 0
+#  include "OgreASTCCodec.h"
+#endif
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -120,6 +124,11 @@ namespace Ogre {
       , mRenderSystemCapabilitiesManager(0)
       , mNextFrame(0)
       , mFrameSmoothingTime(0.0f)
+      , mFramePipelining(false)
+      , mSwapPending(false)
+      , mTargetFrameTime(0)
+      , mNextFrameStart(0)
+      , mSleepOvershoot(0)
       , mRemoveQueueStructuresOnClear(false)
       , mDefaultMinPixelSize(0)
       , mFreqUpdatedBuffersUploadOption(HardwareBuffer::HBU_DEFAULT)
@@ -245,6 +254,9 @@ namespace Ogre {
 #if OGRE_NO_ETC_CODEC == 0
         ETCCodec::startup();
 #endif
+#if OGRE_NO_ASTC_CODEC == 0
+        ASTCCodec::startup();
+#endif
 #if OGRE_NO_STBI_CODEC == 0
         STBIImageCodec::startup();
 #endif
@@ -311,6 +323,9 @@ namespace Ogre {
 #if OGRE_NO_ETC_CODEC == 0
         ETCCodec::shutdown();
 #endif
+#if OGRE_NO_ASTC_CODEC == 0
+        ASTCCodec::shutdown();
+#endif
 #if OGRE_NO_STBI_CODEC == 0
         STBIImageCodec::shutdown();
 #endif
@@ -349,6 +364,8 @@ namespace Ogre {
         OGRE_DELETE mRibbonTrailFactory;
 
         OGRE_DELETE mWorkQueue;
+        // No more requests or responses can be alive
+        SmallObjectAllocImpl::_freeCaches();
 
         OGRE_DELETE mTimer;
 
@@ -368,6 +385,8 @@ namespace Ogre {
 
 
         StringInterface::cleanupDictionary ();
+
+        FrameAllocImpl::_release();
     }
 
     //-----------------------------------------------------------------------
@@ -621,6 +640,7 @@ namespace Ogre {
         // If so, disable it and init the new one
         if( mActiveRenderer && mActiveRenderer != system )
         {
+            _swapPendingBuffers();
             mActiveRenderer->shutdown();
         }
 
@@ -897,6 +917,14 @@ namespace Ogre {
 
         // Tell the queue to process responses
         mWorkQueue->processResponses();
+        mResourceBackgroundQueue->_update();
+        mMaterialManager->_updateWarmUp();
+
+        // Evict least recently used resources if over the global memory budget
+        mResourceGroupManager->_updateResidency();
+
+        // Reclaim the memory of containers used during this frame
+        FrameAllocImpl::_reset();
 
         OgreProfileEndGroup("Frame", OGREPROF_GENERAL);
 
@@ -996,10 +1024,71 @@ namespace Ogre {
             if (!renderOneFrame())
                 break;
         }
+
+        _swapPendingBuffers();
+    }
+    //-----------------------------------------------------------------------
+    void Root::setFramePipelining(bool enabled)
+    {
+        mFramePipelining = enabled;
+        if (!enabled)
+            _swapPendingBuffers();
+    }
+    //-----------------------------------------------------------------------
+    void Root::_swapPendingBuffers(void)
+    {
+        if (mSwapPending && mActiveRenderer)
+            mActiveRenderer->_swapAllRenderTargetBuffers();
+        mSwapPending = false;
+    }
+    //-----------------------------------------------------------------------
+    void Root::setTargetFrameTime(Real seconds)
+    {
+        mTargetFrameTime = std::max(seconds, Real(0));
+        mNextFrameStart = mTimer->getMicroseconds();
+    }
+    //-----------------------------------------------------------------------
+    void Root::_paceFrame(void)
+    {
+        if (mTargetFrameTime <= 0)
+            return;
+
+        const long frameTime = static_cast<long>(mTargetFrameTime * 1000000);
+        unsigned long now = mTimer->getMicroseconds();
+        long remaining = static_cast<long>(mNextFrameStart - now);
+
+        if (remaining < -frameTime)
+        {
+            // More than a frame late, start again from now
+            mNextFrameStart = now;
+        }
+        else if (remaining > 0)
+        {
+            // Sleep for whole milliseconds while that is not expected to overrun
+            long sleepTime = remaining - mSleepOvershoot;
+            if (sleepTime >= 1000)
+            {
+                uint32 ms = static_cast<uint32>(sleepTime / 1000);
+                unsigned long sleepStart = now;
+                Threads::Sleep(ms);
+                now = mTimer->getMicroseconds();
+
+                long overshoot = static_cast<long>(now - sleepStart) - static_cast<long>(ms) * 1000;
+                mSleepOvershoot = (mSleepOvershoot * 7 + std::max(overshoot, 0L)) / 8;
+            }
+
+            // Spin for the rest
+            while (static_cast<long>(mNextFrameStart - now) > 0)
+                now = mTimer->getMicroseconds();
+        }
+
+        mNextFrameStart += frameTime;
     }
     //-----------------------------------------------------------------------
     bool Root::renderOneFrame(void)
     {
+        _paceFrame();
+
         if(!_fireFrameStarted())
             return false;
 
@@ -1011,6 +1100,8 @@ namespace Ogre {
     //---------------------------------------------------------------------
     bool Root::renderOneFrame(Real timeSinceLastFrame)
     {
+        _paceFrame();
+
         FrameEvent evt;
         evt.timeSinceLastFrame = timeSinceLastFrame;
 
@@ -1031,6 +1122,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Root::shutdown(void)
     {
+        _swapPendingBuffers();
+
         if(mActiveRenderer)
             mActiveRenderer->_setViewport(NULL);
 
@@ -1441,12 +1534,17 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     bool Root::_updateAllRenderTargets(void)
     {
+        // present the previous frame, its update overlapped with the GPU
+        _swapPendingBuffers();
         // update all targets but don't swap buffers
         mActiveRenderer->_updateAllRenderTargets(false);
         // give client app opportunity to use queued GPU time
         bool ret = _fireFrameRenderingQueued();
-        // block for final swap
-        mActiveRenderer->_swapAllRenderTargetBuffers();
+        // block for final swap, or leave it for the next frame
+        if (mFramePipelining)
+            mSwapPending = true;
+        else
+            mActiveRenderer->_swapAllRenderTargetBuffers();
 
         // This belongs here, as all render targets must be updated before events are
         // triggered, otherwise targets could be mismatched.  This could produce artifacts,
@@ -1459,12 +1557,17 @@ namespace Ogre {
     //---------------------------------------------------------------------
     bool Root::_updateAllRenderTargets(FrameEvent& evt)
     {
+        // present the previous frame, its update overlapped with the GPU
+        _swapPendingBuffers();
         // update all targets but don't swap buffers
         mActiveRenderer->_updateAllRenderTargets(false);
         // give client app opportunity to use queued GPU time
         bool ret = _fireFrameRenderingQueued(evt);
-        // block for final swap
-        mActiveRenderer->_swapAllRenderTargetBuffers();
+        // block for final swap, or leave it for the next frame
+        if (mFramePipelining)
+            mSwapPending = true;
+        else
+            mActiveRenderer->_swapAllRenderTargetBuffers();
 
         // This belongs here, as all render targets must be updated before events are
         // triggered, otherwise targets could be mismatched.  This could produce artifacts,
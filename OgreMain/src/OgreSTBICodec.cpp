@@ -131,12 +131,23 @@ namespace Ogre {
     //---------------------------------------------------------------------
     Codec::DecodeResult STBIImageCodec::decode(DataStreamPtr& input) const
     {
-        // Buffer stream into memory (TODO: override IO functions instead?)
-        MemoryDataStream memStream(input, true);
+        // Buffer stream into memory (TODO: override IO functions instead?),
+        // unless already there (e.g. memory mapped)
+        MemoryDataStreamPtr memStream;
+        if (MemoryDataStream* inMemory = dynamic_cast<MemoryDataStream*>(input.get()))
+        {
+            // Just the remainder of the stream, like copying it would
+            memStream.bind(OGRE_NEW MemoryDataStream(inMemory->getCurrentPtr(),
+                inMemory->size() - inMemory->tell(), false, true));
+        }
+        else
+        {
+            memStream.bind(OGRE_NEW MemoryDataStream(input, true));
+        }
 
         int width, height, components;
-        stbi_uc* pixelData = stbi_load_from_memory(memStream.getPtr(),
-                static_cast<int>(memStream.size()), &width, &height, &components, 0);
+        stbi_uc* pixelData = stbi_load_from_memory(memStream->getPtr(),
+                static_cast<int>(memStream->size()), &width, &height, &components, 0);
 
         if (!pixelData)
         {
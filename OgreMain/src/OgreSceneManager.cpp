@@ -64,6 +64,11 @@ THE SOFTWARE.
 #include "OgreLodListener.h"
 #include "OgreInstancedGeometry.h"
 #include "OgreUnifiedHighLevelGpuProgram.h"
+#include "OgreWorkQueue.h"
+#include "OgreOptimisedUtil.h"
+#include "OgreSkeletonInstance.h"
+#include "OgreSoftwareOcclusionCuller.h"
+#include "OgreRenderQueueDiagnostics.h"
 
 // This class implements the most basic scene manager
 
@@ -109,6 +114,18 @@ mResetIdentityProj(false),
 mNormaliseNormalsOnScale(true),
 mFlipCullingOnNegativeScale(true),
 mLightsDirtyCounter(0),
+mLightGridThreshold(16),
+mShadowCasterCaching(false),
+mShadowCasterCacheCounter(0),
+mStaticShadowCaching(false),
+mStaticShadowCasterMask(0),
+mStaticShadowCacheMargin(0.1f),
+mShadowCasterCompositing(false),
+mShadowTextureUpdateBudget(0),
+mShadowCasterReceiverCulling(false),
+mShadowCasterCullVolumeActive(false),
+mShadowAtlasSize(0),
+mShadowAtlasMinTileSize(64),
 mMovableNameGenerator("Ogre/MO"),
 mShadowCasterPlainBlackPass(0),
 mShadowReceiverPass(0),
@@ -145,13 +162,42 @@ mShadowTextureCustomCasterPass(0),
 mShadowTextureCustomReceiverPass(0),
 mVisibilityMask(0xFFFFFFFF),
 mFindVisibleObjects(true),
+mParallelUpdateSceneGraph(false),
+mLinearUpdateSceneGraph(false),
+mLinearUpdateNodesDirty(true),
+mBatchCulling(false),
+mSceneGraphVersion(0),
+mParallelUpdateSkeletons(false),
+mSkeletonPoseSharing(false),
+mSkeletonPoseTimeStep(0.001f),
+mSkeletonPoseWeightStep(0.01f),
+mSkeletonPosesFrame(0),
 mSuppressRenderStateChanges(false),
 mSuppressShadows(false),
 mCameraRelativeRendering(false),
+mShareLodAcrossCameras(false),
+mAutoInstancing(false),
+mAutoInstancingMinCount(4),
+mDepthPrePass(false),
+mDepthPrePassStage(DPS_NONE),
+mDepthPrePassPass(0),
+mNumAutoInstanceGroups(0),
+mAutoInstanceSourcePass(0),
+mAutoInstanceTargetPass(0),
+mAutoInstanceUsedPass(0),
+mOcclusionCuller(0),
+mRenderQueueDiagnostics(0),
+mSharedQueueCamera(0),
+mSharedQueueFrame(0),
 mLastLightHash(0),
 mLastLightLimit(0),
 mLastLightHashGpuProgram(0),
-mGpuParamsDirty((uint16)GPV_ALL)
+mGpuParamsDirty((uint16)GPV_ALL),
+mRedundantStateFiltering(false),
+mRenderStateCacheValid(false),
+mRenderStateChangesIssued(0),
+mRenderStateChangesSkipped(0),
+mPassChanges(0)
 {
 
     // init sky
@@ -160,6 +206,16 @@ mGpuParamsDirty((uint16)GPV_ALL)
         mSkyDomeEntity[i] = 0;
     }
 
+    for (size_t i = 0; i < OGRE_MAX_TEXTURE_LAYERS; ++i)
+    {
+        mRenderStateCache.textureUnits[i].valid = false;
+    }
+
+    mLightGrid.dirtyCounter = 0;
+    mLightGrid.lightCount = 0;
+    mLightGrid.built = false;
+    mLightGrid.currentStamp = 0;
+
     mShadowCasterQueryListener = OGRE_NEW ShadowCasterSceneQueryListener(this);
 
     Root *root = Root::getSingletonPtr();
@@ -191,6 +247,9 @@ SceneManager::~SceneManager()
     destroyShadowTextures();
     clearScene();
     destroyAllCameras();
+    clearAutoInstanceVertexData();
+    OGRE_DELETE mOcclusionCuller;
+    OGRE_DELETE mRenderQueueDiagnostics;
 
     // clear down movable object collection map
     {
@@ -336,6 +395,8 @@ void SceneManager::destroyCamera(const String& name)
         CamVisibleObjectsMap::iterator camVisObjIt = mCamVisibleObjectsMap.find( i->second );
         if ( camVisObjIt != mCamVisibleObjectsMap.end() )
             mCamVisibleObjectsMap.erase( camVisObjIt );
+        mPreparedCulling.erase(i->second);
+        removeCameraGroup(i->second);
 
         // Remove light-shadow cam mapping entry
         ShadowCamLightMapping::iterator camLightIt = mShadowCamLightMapping.find( i->second );
@@ -441,10 +502,20 @@ void SceneManager::_populateLightList(const Vector3& position, Real radius,
     destList.clear();
     destList.reserve(candidateLights.size());
 
-    LightList::const_iterator it;
-    for (it = candidateLights.begin(); it != candidateLights.end(); ++it)
+    // With many lights only test those sharing a grid cell with the object,
+    // still in frustum list order so the sorting below gives the same result
+    const vector<uint32>::type* gridLights = 0;
+    if (mLightGridThreshold && candidateLights.size() >= mLightGridThreshold)
     {
-        Light* lt = *it;
+        updateLightGrid();
+        queryLightGrid(position, radius);
+        gridLights = &mLightGrid.results;
+    }
+
+    size_t numCandidates = gridLights ? gridLights->size() : candidateLights.size();
+    for (size_t i = 0; i < numCandidates; ++i)
+    {
+        Light* lt = candidateLights[gridLights ? (*gridLights)[i] : i];
         // check whether or not this light is suppose to be taken into consideration for the current light mask set for this operation
         if(!(lt->getLightMask() & lightMask))
             continue; //skip this light
@@ -501,6 +572,161 @@ void SceneManager::_populateLightList(const SceneNode* sn, Real radius, LightLis
     _populateLightList(sn->_getDerivedPosition(), radius, destList, lightMask);
 }
 //-----------------------------------------------------------------------
+void SceneManager::updateLightGrid(void)
+{
+    const LightList& lights = _getLightsAffectingFrustum();
+    LightGrid& grid = mLightGrid;
+    if (grid.built && grid.dirtyCounter == mLightsDirtyCounter && grid.lightCount == lights.size())
+        return;
+
+    // Maximum number of cells along an axis, and covered by a single light
+    const int maxDim = 64;
+    const size_t maxLightCells = 64;
+
+    grid.built = true;
+    grid.dirtyCounter = mLightsDirtyCounter;
+    grid.lightCount = lights.size();
+    grid.globalLights.clear();
+    grid.cellLights.clear();
+    grid.stamps.assign(lights.size(), 0);
+    grid.currentStamp = 0;
+
+    // Bounds of the light positions, and the median range to size the cells
+    Vector3 minPos(Math::POS_INFINITY, Math::POS_INFINITY, Math::POS_INFINITY);
+    Vector3 maxPos(Math::NEG_INFINITY, Math::NEG_INFINITY, Math::NEG_INFINITY);
+    vector<Real>::type ranges;
+    ranges.reserve(lights.size());
+    for (size_t i = 0; i < lights.size(); ++i)
+    {
+        Light* lt = lights[i];
+        if (lt->getType() == Light::LT_DIRECTIONAL)
+            continue;
+        const Vector3& pos = lt->getDerivedPosition();
+        minPos.makeFloor(pos);
+        maxPos.makeCeil(pos);
+        ranges.push_back(lt->getAttenuationRange());
+    }
+
+    if (ranges.empty())
+    {
+        // Nothing to index
+        grid.dims[0] = grid.dims[1] = grid.dims[2] = 1;
+        grid.origin = Vector3::ZERO;
+        grid.invCellSize = 0;
+        grid.cellStart.assign(2, 0);
+        for (size_t i = 0; i < lights.size(); ++i)
+            grid.globalLights.push_back(static_cast<uint32>(i));
+        return;
+    }
+
+    std::nth_element(ranges.begin(), ranges.begin() + ranges.size() / 2, ranges.end());
+    Vector3 extent = maxPos - minPos;
+    Real cellSize = std::max(ranges[ranges.size() / 2] * 2, std::max(extent.x, std::max(extent.y, extent.z)) / maxDim);
+    if (cellSize <= 0)
+        cellSize = 1;
+    grid.origin = minPos;
+    grid.invCellSize = 1 / cellSize;
+    size_t numCells = 1;
+    for (int a = 0; a < 3; ++a)
+    {
+        grid.dims[a] = Math::Clamp(static_cast<int>(Math::Ceil(extent[a] * grid.invCellSize)), 1, maxDim);
+        numCells *= grid.dims[a];
+    }
+
+    // Cell range of each light, lights covering too many cells are always tested
+    vector<int>::type lightCells(lights.size() * 6);
+    grid.cellStart.assign(numCells + 1, 0);
+    for (size_t i = 0; i < lights.size(); ++i)
+    {
+        Light* lt = lights[i];
+        if (lt->getType() == Light::LT_DIRECTIONAL)
+        {
+            grid.globalLights.push_back(static_cast<uint32>(i));
+            continue;
+        }
+        const Vector3& pos = lt->getDerivedPosition();
+        Real range = lt->getAttenuationRange();
+        int* c = &lightCells[i * 6];
+        size_t count = 1;
+        for (int a = 0; a < 3; ++a)
+        {
+            c[a] = getLightGridCell(pos[a] - range, a);
+            c[a + 3] = getLightGridCell(pos[a] + range, a);
+            count *= c[a + 3] - c[a] + 1;
+        }
+        if (count > maxLightCells)
+        {
+            grid.globalLights.push_back(static_cast<uint32>(i));
+            c[0] = -1;
+            continue;
+        }
+        for (int z = c[2]; z <= c[5]; ++z)
+            for (int y = c[1]; y <= c[4]; ++y)
+                for (int x = c[0]; x <= c[3]; ++x)
+                    ++grid.cellStart[(z * grid.dims[1] + y) * grid.dims[0] + x + 1];
+    }
+    for (size_t cell = 0; cell < numCells; ++cell)
+        grid.cellStart[cell + 1] += grid.cellStart[cell];
+
+    // Fill the cells, in ascending light order
+    grid.cellLights.resize(grid.cellStart[numCells]);
+    vector<uint32>::type cursor(grid.cellStart.begin(), grid.cellStart.end() - 1);
+    for (size_t i = 0; i < lights.size(); ++i)
+    {
+        const int* c = &lightCells[i * 6];
+        if (lights[i]->getType() == Light::LT_DIRECTIONAL || c[0] < 0)
+            continue;
+        for (int z = c[2]; z <= c[5]; ++z)
+            for (int y = c[1]; y <= c[4]; ++y)
+                for (int x = c[0]; x <= c[3]; ++x)
+                    grid.cellLights[cursor[(z * grid.dims[1] + y) * grid.dims[0] + x]++] = static_cast<uint32>(i);
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::queryLightGrid(const Vector3& position, Real radius)
+{
+    LightGrid& grid = mLightGrid;
+    grid.results.assign(grid.globalLights.begin(), grid.globalLights.end());
+    if (grid.cellLights.empty())
+        return;
+
+    if (++grid.currentStamp == 0)
+    {
+        // Wrapped around, forget the old stamps
+        std::fill(grid.stamps.begin(), grid.stamps.end(), 0);
+        grid.currentStamp = 1;
+    }
+
+    int c[6];
+    for (int a = 0; a < 3; ++a)
+    {
+        c[a] = getLightGridCell(position[a] - radius, a);
+        c[a + 3] = getLightGridCell(position[a] + radius, a);
+    }
+    for (int z = c[2]; z <= c[5]; ++z)
+    {
+        for (int y = c[1]; y <= c[4]; ++y)
+        {
+            for (int x = c[0]; x <= c[3]; ++x)
+            {
+                size_t cell = (z * grid.dims[1] + y) * grid.dims[0] + x;
+                for (uint32 j = grid.cellStart[cell]; j < grid.cellStart[cell + 1]; ++j)
+                {
+                    uint32 light = grid.cellLights[j];
+                    if (grid.stamps[light] != grid.currentStamp)
+                    {
+                        grid.stamps[light] = grid.currentStamp;
+                        grid.results.push_back(light);
+                    }
+                }
+            }
+        }
+    }
+
+    // Back to frustum list order
+    std::sort(grid.results.begin(), grid.results.end());
+}
+//-----------------------------------------------------------------------
 Entity* SceneManager::createEntity(const String& entityName, PrefabType ptype)
 {
     switch (ptype)
@@ -777,6 +1003,10 @@ void SceneManager::destroyAllParticleSystems(void)
 //-----------------------------------------------------------------------
 void SceneManager::clearScene(void)
 {
+    mShadowCasterCache.clear();
+    clearAutoInstanceVertexData();
+    if (mOcclusionCuller)
+        mOcclusionCuller->removeAllOccluders();
     destroyAllStaticGeometry();
     destroyAllInstanceManagers();
     destroyAllMovableObjects();
@@ -956,6 +1186,12 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
         {
             pass = deriveShadowReceiverPass(pass);
         }
+        else if (mDepthPrePassStage == DPS_DEPTH && shadowDerivation)
+        {
+            pass = deriveDepthPrePass(pass);
+        }
+
+        ++mPassChanges;
 
         // Tell params about current pass
         mAutoParamDataSource->setCurrentPass(pass);
@@ -976,6 +1212,7 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
             if (mDestRenderSystem->isGpuProgramBound(GPT_VERTEX_PROGRAM))
             {
                 mDestRenderSystem->unbindGpuProgram(GPT_VERTEX_PROGRAM);
+                mRenderStateCache.programs[GPT_VERTEX_PROGRAM] = 0;
             }
             // Set fixed-function vertex parameters
         }
@@ -991,6 +1228,7 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
             if (mDestRenderSystem->isGpuProgramBound(GPT_GEOMETRY_PROGRAM))
             {
                 mDestRenderSystem->unbindGpuProgram(GPT_GEOMETRY_PROGRAM);
+                mRenderStateCache.programs[GPT_GEOMETRY_PROGRAM] = 0;
             }
             // Set fixed-function vertex parameters
         }
@@ -1005,6 +1243,7 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
             if (mDestRenderSystem->isGpuProgramBound(GPT_HULL_PROGRAM))
             {
                 mDestRenderSystem->unbindGpuProgram(GPT_HULL_PROGRAM);
+                mRenderStateCache.programs[GPT_HULL_PROGRAM] = 0;
             }
             // Set fixed-function tessellation control parameters
         }
@@ -1020,6 +1259,7 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
             if (mDestRenderSystem->isGpuProgramBound(GPT_DOMAIN_PROGRAM))
             {
                 mDestRenderSystem->unbindGpuProgram(GPT_DOMAIN_PROGRAM);
+                mRenderStateCache.programs[GPT_DOMAIN_PROGRAM] = 0;
             }
             // Set fixed-function tessellation evaluation parameters
         }
@@ -1035,6 +1275,7 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
                     if (mDestRenderSystem->isGpuProgramBound(GPT_COMPUTE_PROGRAM))
                     {
                         mDestRenderSystem->unbindGpuProgram(GPT_COMPUTE_PROGRAM);
+                        mRenderStateCache.programs[GPT_COMPUTE_PROGRAM] = 0;
                     }
                     // Set fixed-function compute parameters
         }
@@ -1054,7 +1295,12 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
             }
 
             // Dynamic lighting enabled?
-            mDestRenderSystem->setLightingEnabled(pass->getLightingEnabled());
+            bool lightingEnabled = pass->getLightingEnabled();
+            if (isRenderStateChangeNeeded(mRenderStateCache.lightingEnabled == lightingEnabled))
+            {
+                mDestRenderSystem->setLightingEnabled(lightingEnabled);
+                mRenderStateCache.lightingEnabled = lightingEnabled;
+            }
         }
 
         // Using a fragment program?
@@ -1070,6 +1316,7 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
             if (mDestRenderSystem->isGpuProgramBound(GPT_FRAGMENT_PROGRAM))
             {
                 mDestRenderSystem->unbindGpuProgram(GPT_FRAGMENT_PROGRAM);
+                mRenderStateCache.programs[GPT_FRAGMENT_PROGRAM] = 0;
             }
 
             // Set fixed-function fragment settings
@@ -1117,28 +1364,59 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
         // The rest of the settings are the same no matter whether we use programs or not
 
         // Set scene blending
-        if ( pass->hasSeparateSceneBlending( ) )
+        RenderStateCache blend;
+        blend.sourceFactor = pass->getSourceBlendFactor();
+        blend.destFactor = pass->getDestBlendFactor();
+        blend.blendOperation = pass->getSceneBlendingOperation();
+        if (mShadowCasterCompositing)
         {
-            mDestRenderSystem->_setSeparateSceneBlending(
-                pass->getSourceBlendFactor(), pass->getDestBlendFactor(),
-                pass->getSourceBlendFactorAlpha(), pass->getDestBlendFactorAlpha(),
-                pass->getSceneBlendingOperation(), 
-                pass->hasSeparateSceneBlendingOperations() ? pass->getSceneBlendingOperation() : pass->getSceneBlendingOperationAlpha() );
+            // Dynamic casters over cached static casters, keep the nearest
+            blend.sourceFactor = blend.destFactor = blend.sourceFactorAlpha =
+                blend.destFactorAlpha = SBF_ONE;
+            blend.blendOperation = blend.blendOperationAlpha = SBO_MIN;
+        }
+        else if ( pass->hasSeparateSceneBlending( ) )
+        {
+            blend.sourceFactorAlpha = pass->getSourceBlendFactorAlpha();
+            blend.destFactorAlpha = pass->getDestBlendFactorAlpha();
+            blend.blendOperationAlpha = pass->hasSeparateSceneBlendingOperations() ? 
+                pass->getSceneBlendingOperation() : pass->getSceneBlendingOperationAlpha();
         }
         else
         {
-            if(pass->hasSeparateSceneBlendingOperations( ) )
+            blend.sourceFactorAlpha = blend.sourceFactor;
+            blend.destFactorAlpha = blend.destFactor;
+            blend.blendOperationAlpha = pass->hasSeparateSceneBlendingOperations() ? 
+                pass->getSceneBlendingOperationAlpha() : blend.blendOperation;
+        }
+        if (isRenderStateChangeNeeded(
+            mRenderStateCache.sourceFactor == blend.sourceFactor &&
+            mRenderStateCache.destFactor == blend.destFactor &&
+            mRenderStateCache.sourceFactorAlpha == blend.sourceFactorAlpha &&
+            mRenderStateCache.destFactorAlpha == blend.destFactorAlpha &&
+            mRenderStateCache.blendOperation == blend.blendOperation &&
+            mRenderStateCache.blendOperationAlpha == blend.blendOperationAlpha))
+        {
+            if ( !mShadowCasterCompositing &&
+                (pass->hasSeparateSceneBlending( ) || pass->hasSeparateSceneBlendingOperations( )) )
             {
                 mDestRenderSystem->_setSeparateSceneBlending(
-                    pass->getSourceBlendFactor(), pass->getDestBlendFactor(),
-                    pass->getSourceBlendFactor(), pass->getDestBlendFactor(),
-                    pass->getSceneBlendingOperation(), pass->getSceneBlendingOperationAlpha() );
+                    blend.sourceFactor, blend.destFactor,
+                    blend.sourceFactorAlpha, blend.destFactorAlpha,
+                    blend.blendOperation, blend.blendOperationAlpha );
             }
             else
             {
                 mDestRenderSystem->_setSceneBlending(
-                    pass->getSourceBlendFactor(), pass->getDestBlendFactor(), pass->getSceneBlendingOperation() );
+                    blend.sourceFactor, blend.destFactor, blend.blendOperation );
             }
+            mRenderStateCache.sourceFactor = blend.sourceFactor;
+            mRenderStateCache.destFactor = blend.destFactor;
+            mRenderStateCache.sourceFactorAlpha = blend.sourceFactorAlpha;
+            mRenderStateCache.destFactorAlpha = blend.destFactorAlpha;
+            mRenderStateCache.blendOperation = blend.blendOperation;
+            mRenderStateCache.blendOperationAlpha = blend.blendOperationAlpha;
+            ++mDestRenderSystem->_getRenderStatistics().blendChanges;
         }
 
         // Set point parameters
@@ -1187,11 +1465,12 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
                 {
                     shadowTex = getShadowTexture(shadowTexIndex);
                     // Hook up projection frustum
-                    Camera *cam = shadowTex->getBuffer()->getRenderTarget()->getViewport(0)->getCamera();
+                    Camera *cam = mShadowTextureCameras[shadowTexIndex];
                     // Enable projective texturing if fixed-function, but also need to
                     // disable it explicitly for program pipeline.
                     pTex->setProjectiveTexturing(!pass->hasVertexProgram(), cam);
-                    mAutoParamDataSource->setTextureProjector(cam, shadowTexUnitIndex);
+                    mAutoParamDataSource->setTextureProjector(cam, shadowTexUnitIndex,
+                        getShadowTextureTile(shadowTexIndex));
                 }
                 else
                 {
@@ -1245,26 +1524,66 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
                 }
                 pTex->_setTexturePtr(refTex);
             }
-            mDestRenderSystem->_setTextureUnitSettings(unit, *pTex);
+            setTextureUnitSettings(unit, *pTex);
             ++unit;
         }
         // Disable remaining texture units
         mDestRenderSystem->_disableTextureUnitsFrom(pass->getNumTextureUnitStates());
+        for (size_t i = unit; i < OGRE_MAX_TEXTURE_LAYERS; ++i)
+        {
+            mRenderStateCache.textureUnits[i].valid = false;
+        }
 
         // Set up non-texture related material settings
         // Depth buffer settings
-        mDestRenderSystem->_setDepthBufferFunction(pass->getDepthFunction());
-        mDestRenderSystem->_setDepthBufferCheckEnabled(pass->getDepthCheckEnabled());
-        mDestRenderSystem->_setDepthBufferWriteEnabled(pass->getDepthWriteEnabled());
+        CompareFunction depthFunction = pass->getDepthFunction();
+        bool depthWrite = pass->getDepthWriteEnabled();
+        if (mDepthPrePassStage == DPS_EQUAL && isDepthPrePassCandidate(pass))
+        {
+            // The depth was laid down by the pre-pass
+            depthFunction = CMPF_EQUAL;
+            depthWrite = false;
+        }
+        if (isRenderStateChangeNeeded(mRenderStateCache.depthFunction == depthFunction))
+        {
+            mDestRenderSystem->_setDepthBufferFunction(depthFunction);
+            mRenderStateCache.depthFunction = depthFunction;
+            ++mDestRenderSystem->_getRenderStatistics().depthChanges;
+        }
+        if (isRenderStateChangeNeeded(mRenderStateCache.depthCheck == pass->getDepthCheckEnabled()))
+        {
+            mDestRenderSystem->_setDepthBufferCheckEnabled(pass->getDepthCheckEnabled());
+            mRenderStateCache.depthCheck = pass->getDepthCheckEnabled();
+            ++mDestRenderSystem->_getRenderStatistics().depthChanges;
+        }
+        if (isRenderStateChangeNeeded(mRenderStateCache.depthWrite == depthWrite))
+        {
+            mDestRenderSystem->_setDepthBufferWriteEnabled(depthWrite);
+            mRenderStateCache.depthWrite = depthWrite;
+            ++mDestRenderSystem->_getRenderStatistics().depthChanges;
+        }
         mDestRenderSystem->_setDepthBias(pass->getDepthBiasConstant(), 
             pass->getDepthBiasSlopeScale());
         // Alpha-reject settings
-        mDestRenderSystem->_setAlphaRejectSettings(
-            pass->getAlphaRejectFunction(), pass->getAlphaRejectValue(), pass->isAlphaToCoverageEnabled());
+        if (isRenderStateChangeNeeded(
+            mRenderStateCache.alphaRejectFunction == pass->getAlphaRejectFunction() &&
+            mRenderStateCache.alphaRejectValue == pass->getAlphaRejectValue() &&
+            mRenderStateCache.alphaToCoverage == pass->isAlphaToCoverageEnabled()))
+        {
+            mDestRenderSystem->_setAlphaRejectSettings(
+                pass->getAlphaRejectFunction(), pass->getAlphaRejectValue(), pass->isAlphaToCoverageEnabled());
+            mRenderStateCache.alphaRejectFunction = pass->getAlphaRejectFunction();
+            mRenderStateCache.alphaRejectValue = pass->getAlphaRejectValue();
+            mRenderStateCache.alphaToCoverage = pass->isAlphaToCoverageEnabled();
+        }
         // Set colour write mode
         // Right now we only use on/off, not per-channel
         bool colWrite = pass->getColourWriteEnabled();
-        mDestRenderSystem->_setColourBufferWriteEnabled(colWrite, colWrite, colWrite, colWrite);
+        if (isRenderStateChangeNeeded(mRenderStateCache.colourWrite == colWrite))
+        {
+            mDestRenderSystem->_setColourBufferWriteEnabled(colWrite, colWrite, colWrite, colWrite);
+            mRenderStateCache.colourWrite = colWrite;
+        }
         // Culling mode
         if (isShadowTechniqueTextureBased() 
             && mIlluminationStage == IRS_RENDER_TO_TEXTURE
@@ -1281,7 +1600,11 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
         mDestRenderSystem->_setCullingMode(mPassCullingMode);
         
         // Shading
-        mDestRenderSystem->setShadingType(pass->getShadingMode());
+        if (isRenderStateChangeNeeded(mRenderStateCache.shading == pass->getShadingMode()))
+        {
+            mDestRenderSystem->setShadingType(pass->getShadingMode());
+            mRenderStateCache.shading = pass->getShadingMode();
+        }
         // Polygon mode
         mDestRenderSystem->_setPolygonMode(pass->getPolygonMode());
 
@@ -1291,6 +1614,9 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
         // mark global params as dirty
         mGpuParamsDirty |= (uint16)GPV_GLOBAL;
 
+        // All cached states have now been applied
+        mRenderStateCacheValid = mRedundantStateFiltering;
+
     }
 
     return pass;
@@ -1301,6 +1627,7 @@ void SceneManager::prepareRenderQueue(void)
     RenderQueue* q = getRenderQueue();
     // Clear the render queue
     q->clear(Root::getSingleton().getRemoveRenderQueueStructuresOnClear());
+    mSharedQueueCamera = 0;
 
     // Prep the ordering options
 
@@ -1360,10 +1687,92 @@ void SceneManager::prepareRenderQueue(void)
 
 }
 //-----------------------------------------------------------------------
+bool SceneManager::TextureUnitCache::set(const TextureUnitState& tus)
+{
+    const TexturePtr& tex = tus._getTexturePtr();
+    texture = tex.get();
+    bindingType = tus.getBindingType();
+    coordSet = tus.getTextureCoordSet();
+    compareEnabled = tus.getTextureCompareEnabled();
+    compareFunction = tus.getTextureCompareFunction();
+    minFilter = tus.getTextureFiltering(FT_MIN);
+    magFilter = tus.getTextureFiltering(FT_MAG);
+    mipFilter = tus.getTextureFiltering(FT_MIP);
+    anisotropy = tus.getTextureAnisotropy();
+    mipmapBias = tus.getTextureMipmapBias();
+    colourBlend = tus.getColourBlendMode();
+    alphaBlend = tus.getAlphaBlendMode();
+    addressing = tus.getTextureAddressingMode();
+    borderColour = tus.getTextureBorderColour();
+    transform = tus.getTextureTransform();
+
+    // An unloaded texture is reloaded on bind, so let the render system see it
+    if (texture && !texture->isLoaded())
+        return false;
+
+    // Texture coordinate generation depends on the view and projector state
+    const TextureUnitState::EffectMap& effects = tus.getEffects();
+    for (TextureUnitState::EffectMap::const_iterator i = effects.begin(); i != effects.end(); ++i)
+    {
+        if (i->second.type == TextureUnitState::ET_ENVIRONMENT_MAP ||
+            i->second.type == TextureUnitState::ET_PROJECTIVE_TEXTURE)
+            return false;
+    }
+    return true;
+}
+//-----------------------------------------------------------------------
+bool SceneManager::TextureUnitCache::operator==(const TextureUnitCache& rhs) const
+{
+    return texture == rhs.texture &&
+        bindingType == rhs.bindingType &&
+        coordSet == rhs.coordSet &&
+        compareEnabled == rhs.compareEnabled &&
+        compareFunction == rhs.compareFunction &&
+        minFilter == rhs.minFilter &&
+        magFilter == rhs.magFilter &&
+        mipFilter == rhs.mipFilter &&
+        anisotropy == rhs.anisotropy &&
+        mipmapBias == rhs.mipmapBias &&
+        colourBlend == rhs.colourBlend &&
+        alphaBlend == rhs.alphaBlend &&
+        addressing.u == rhs.addressing.u &&
+        addressing.v == rhs.addressing.v &&
+        addressing.w == rhs.addressing.w &&
+        borderColour == rhs.borderColour &&
+        transform == rhs.transform;
+}
+//-----------------------------------------------------------------------
+void SceneManager::setTextureUnitSettings(size_t unit, TextureUnitState& tus)
+{
+    if (unit >= OGRE_MAX_TEXTURE_LAYERS)
+    {
+        mDestRenderSystem->_setTextureUnitSettings(unit, tus);
+        return;
+    }
+
+    TextureUnitCache& cached = mRenderStateCache.textureUnits[unit];
+    TextureUnitCache state;
+    bool cacheable = state.set(tus);
+    if (!isRenderStateChangeNeeded(cacheable && cached.valid && cached == state))
+    {
+        // Still bound, but the texture budget needs to know it is in use
+        if (state.texture)
+            state.texture->_notifyUsed();
+        return;
+    }
+
+    mDestRenderSystem->_setTextureUnitSettings(unit, tus);
+    cached = state;
+    cached.valid = cacheable;
+}
+//-----------------------------------------------------------------------
 void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverlays)
 {
     OgreProfileGroup("_renderScene", OGREPROF_GENERAL);
 
+    // Render system state may have been changed since the last render
+    _invalidateRenderStateCache();
+
     Root::getSingleton()._pushCurrentSceneManager(this);
     mActiveQueuedRenderableVisitor->targetSceneMgr = this;
     mAutoParamDataSource->setCurrentSceneManager(this);
@@ -1400,20 +1809,23 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
     mCameraInProgress = camera;
 
-
-    // Update controllers 
-    ControllerManager::getSingleton().updateAllControllers();
-
-    // Update the scene, only do this once per frame
-    unsigned long thisFrameNumber = Root::getSingleton().getNextFrameNumber();
-    if (thisFrameNumber != mLastFrameNumber)
+    // Cameras of a group rendered after its first one reuse the render queue built for it
+    CameraGroup* cameraGroup = 0;
+    bool sharedQueue = false;
+    if (!mCameraGroups.empty() && mIlluminationStage != IRS_RENDER_TO_TEXTURE && mFindVisibleObjects)
     {
-        // Update animations
-        _applySceneAnimations();
-        updateDirtyInstanceManagers();
-        mLastFrameNumber = thisFrameNumber;
+        CameraGroupMap::iterator groupIt = mCameraGroups.find(camera);
+        if (groupIt != mCameraGroups.end())
+        {
+            cameraGroup = groupIt->second;
+            sharedQueue = camera != cameraGroup->cameras.front() &&
+                mSharedQueueCamera == cameraGroup->cameras.front() &&
+                mSharedQueueFrame == Root::getSingleton().getNextFrameNumber();
+        }
     }
 
+    updateSceneForFrame();
+
     {
         // Lock scene graph mutex, no more changes until we're ready to render
             OGRE_LOCK_MUTEX(sceneGraphMutex);
@@ -1434,10 +1846,28 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
             camera->_autoTrack();
         }
 
-        if (mIlluminationStage != IRS_RENDER_TO_TEXTURE && mFindVisibleObjects)
+        // The first camera of a group culls for all of them
+        Frustum* groupCullFrustum = 0;
+        if (cameraGroup && camera == cameraGroup->cameras.front() &&
+            updateCameraGroupFrustum(cameraGroup))
+        {
+            groupCullFrustum = cameraGroup->cullFrustum;
+        }
+        Frustum* cameraCullFrustum = camera->getCullingFrustum();
+
+        if (mParallelUpdateSkeletons && mFindVisibleObjects && !sharedQueue)
+        {
+            OgreProfileGroup("updateSkeletonsParallel", OGREPROF_GENERAL);
+            updateSkeletonsParallel(camera);
+        }
+
+        if (mIlluminationStage != IRS_RENDER_TO_TEXTURE && mFindVisibleObjects && !sharedQueue)
         {
             // Locate any lights which could be affecting the frustum
+            if (groupCullFrustum)
+                camera->setCullingFrustum(groupCullFrustum);
             findLightsAffectingFrustum(camera);
+            camera->setCullingFrustum(cameraCullFrustum);
 
             // Are we using any shadows at all?
             if (isShadowTechniqueInUse() && vp->getShadowsEnabled())
@@ -1504,12 +1934,13 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
         }
 
         // Prepare render queue for receiving new objects
+        if (!sharedQueue)
         {
             OgreProfileGroup("prepareRenderQueue", OGREPROF_GENERAL);
             prepareRenderQueue();
         }
 
-        if (mFindVisibleObjects)
+        if (mFindVisibleObjects && !sharedQueue)
         {
             OgreProfileGroup("_findVisibleObjects", OGREPROF_CULLING);
 
@@ -1526,14 +1957,30 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
             // Parse the scene and tag visibles
             firePreFindVisibleObjects(vp);
+            // Its depth buffer would hide what only the other cameras of a group see
+            if (mOcclusionCuller && mIlluminationStage != IRS_RENDER_TO_TEXTURE && !groupCullFrustum)
+            {
+                OgreProfileGroup("updateOcclusionCuller", OGREPROF_CULLING);
+                mOcclusionCuller->update(camera);
+            }
+            if (groupCullFrustum)
+                camera->setCullingFrustum(groupCullFrustum);
             _findVisibleObjects(camera, &(camVisObjIt->second),
                 mIlluminationStage == IRS_RENDER_TO_TEXTURE? true : false);
+            camera->setCullingFrustum(cameraCullFrustum);
             firePostFindVisibleObjects(vp);
 
+            if (groupCullFrustum)
+            {
+                mSharedQueueCamera = camera;
+                mSharedQueueFrame = Root::getSingleton().getNextFrameNumber();
+            }
+
             mAutoParamDataSource->setMainCamBoundsInfo(&(camVisObjIt->second));
         }
         // Queue skies, if viewport seems it
-        if (vp->getSkiesEnabled() && mFindVisibleObjects && mIlluminationStage != IRS_RENDER_TO_TEXTURE)
+        if (vp->getSkiesEnabled() && mFindVisibleObjects && mIlluminationStage != IRS_RENDER_TO_TEXTURE &&
+            !sharedQueue)
         {
             _queueSkiesForRendering(camera);
         }
@@ -1569,10 +2016,17 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
     
     setViewMatrix(mCachedViewMatrix);
 
+    if (mRenderQueueDiagnostics)
+        mRenderQueueDiagnostics->_countQueue(getRenderQueue(), Root::getSingleton().getNextFrameNumber());
+
     // Render scene content
     {
         OgreProfileGroup("_renderVisibleObjects", OGREPROF_RENDERING);
+        DrawCategory prevCategory = mDestRenderSystem->_getDrawCategory();
+        mDestRenderSystem->_setDrawCategory(
+            mIlluminationStage == IRS_RENDER_TO_TEXTURE ? DC_SHADOW : DC_SCENE);
         _renderVisibleObjects();
+        mDestRenderSystem->_setDrawCategory(prevCategory);
     }
 
     // End frame
@@ -1590,6 +2044,7 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 void SceneManager::_setDestinationRenderSystem(RenderSystem* sys)
 {
     mDestRenderSystem = sys;
+    _invalidateRenderStateCache();
 
     if(sys)
     {
@@ -2278,114 +2733,627 @@ MeshPtr SceneManager::createSkydomePlane(
 }
 
 
+//-----------------------------------------------------------------------
+void SceneManager::updateSceneForFrame(void)
+{
+    // Update controllers 
+    ControllerManager::getSingleton().updateAllControllers();
+    // Run the particle system updates the controllers queued, if parallel
+    ParticleSystemManager::getSingleton()._updateQueuedSystems();
+
+    // Update the scene, only do this once per frame
+    unsigned long thisFrameNumber = Root::getSingleton().getNextFrameNumber();
+    if (thisFrameNumber != mLastFrameNumber)
+    {
+        // Update animations
+        _applySceneAnimations();
+        updateDirtyInstanceManagers();
+        mLastFrameNumber = thisFrameNumber;
+    }
+}
 //-----------------------------------------------------------------------
 void SceneManager::_updateSceneGraph(Camera* cam)
 {
     firePreUpdateSceneGraph(cam);
 
+    // Entities with bounds from their skeleton queue their node when their bones move
+    updateSkeletonBounds();
+
     // Process queued needUpdate calls 
     Node::processQueuedUpdates();
 
+    // Culling done ahead can only be reused if no bounds move
+    if (getRootSceneNode()->_isUpdatePending())
+        ++mSceneGraphVersion;
+
     // Cascade down the graph updating transforms & world bounds
     // In this implementation, just update from the root
     // Smarter SceneManager subclasses may choose to update only
     //   certain scene graph branches
-    getRootSceneNode()->_update(true, false);
+    if (mParallelUpdateSceneGraph)
+        updateSceneGraphParallel();
+    else if (mLinearUpdateSceneGraph)
+        updateSceneGraphLinear();
+    else
+        getRootSceneNode()->_update(true, false);
 
     firePostUpdateSceneGraph(cam);
 }
 //-----------------------------------------------------------------------
-void SceneManager::_findVisibleObjects(
-    Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
-{
-    // Tell nodes to find, cascade down all nodes
-    getRootSceneNode()->_findVisibleObjects(cam, getRenderQueue(), visibleBounds, true, 
-        mDisplayNodes, onlyShadowCasters);
+namespace {
+    /// Updates a range of gathered root node children
+    class SceneGraphUpdateTask : public WorkQueue::ParallelTask
+    {
+        const Node::ChildUpdateList& mChildren;
+    public:
+        SceneGraphUpdateTask(const Node::ChildUpdateList& children) : mChildren(children) {}
 
+        void execute(size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                mChildren[i].first->_update(true, mChildren[i].second);
+        }
+    };
 }
-//-----------------------------------------------------------------------
-void SceneManager::_renderVisibleObjects(void)
+void SceneManager::updateSceneGraphParallel(void)
 {
-    RenderQueueInvocationSequence* invocationSequence = 
-        mCurrentViewport->_getRenderQueueInvocationSequence();
-    // Use custom sequence only if we're not doing the texture shadow render
-    // since texture shadow render should not be interfered with by suppressing
-    // render state changes for example
-    if (invocationSequence && mIlluminationStage != IRS_RENDER_TO_TEXTURE)
+    SceneNode* root = getRootSceneNode();
+
+    Node::ChildUpdateList children;
+    root->_updateAndGetChildren(false, children);
+
+    Node::_setDeferListenerCallbacks(true);
+    try
     {
-        renderVisibleObjectsCustomSequence(invocationSequence);
+        SceneGraphUpdateTask task(children);
+        // Subtrees vary in size, so hand them out in small chunks
+        Root::getSingleton().getWorkQueue()->parallelFor(children.size(), 4, &task);
     }
-    else
+    catch (...)
     {
-        renderVisibleObjectsDefaultSequence();
+        Node::_setDeferListenerCallbacks(false);
+        throw;
     }
+    Node::_setDeferListenerCallbacks(false);
+    Node::_processDeferredListenerCallbacks();
+
+    // Root bounds depend on all its children, so merge them last
+    root->_updateBounds();
 }
 //-----------------------------------------------------------------------
-void SceneManager::renderVisibleObjectsCustomSequence(RenderQueueInvocationSequence* seq)
+void SceneManager::setLinearUpdateSceneGraph(bool linear)
 {
-    firePreRenderQueues();
-
-    RenderQueueInvocationIterator invocationIt = seq->iterator();
-    while (invocationIt.hasMoreElements())
+    mLinearUpdateSceneGraph = linear;
+    if (!linear)
     {
-        RenderQueueInvocation* invocation = invocationIt.getNext();
-        uint8 qId = invocation->getRenderQueueGroupID();
-        // Skip this one if not to be processed
-        if (!isRenderQueueToBeProcessed(qId))
-            continue;
-
+        // Release the arrays, they are rebuilt when turned on again
+        LinearUpdateNodeList().swap(mLinearUpdateNodes);
+        vector<uint32>::type().swap(mLinearUpdateParents);
+        vector<uint8>::type().swap(mLinearUpdateFlags);
+    }
+    mLinearUpdateNodesDirty = true;
+}
+//-----------------------------------------------------------------------
+void SceneManager::buildLinearUpdateNodes(void)
+{
+    // Culling results are indexed like the nodes
+    ++mSceneGraphVersion;
+    mLinearUpdateNodes.clear();
+    mLinearUpdateParents.clear();
 
-        bool repeatQueue = false;
-        const String& invocationName = invocation->getInvocationName();
-        RenderQueueGroup* queueGroup = getRenderQueue()->getQueueGroup(qId);
-        do // for repeating queues
+    // Breadth first walk, which keeps parents ahead of their children and
+    // also keeps siblings together
+    mLinearUpdateNodes.push_back(getRootSceneNode());
+    mLinearUpdateParents.push_back(0);
+    for (size_t i = 0; i < mLinearUpdateNodes.size(); ++i)
+    {
+        SceneNode* node = mLinearUpdateNodes[i];
+        SceneNode::ChildNodeIterator it = node->getChildIterator();
+        while (it.hasMoreElements())
         {
-            // Fire queue started event
-            if (fireRenderQueueStarted(qId, invocationName))
-            {
-                // Someone requested we skip this queue
-                break;
-            }
-
-            // Invoke it
-            invocation->invoke(queueGroup, this);
+            mLinearUpdateNodes.push_back(static_cast<SceneNode*>(it.getNext()));
+            mLinearUpdateParents.push_back(static_cast<uint32>(i));
+        }
+    }
 
-            // Fire queue ended event
-            if (fireRenderQueueEnded(qId, invocationName))
-            {
-                // Someone requested we repeat this queue
-                repeatQueue = true;
-            }
-            else
-            {
-                repeatQueue = false;
-            }
-        } while (repeatQueue);
+    mLinearUpdateFlags.resize(mLinearUpdateNodes.size());
+    mLinearUpdateNodesDirty = false;
+}
+//-----------------------------------------------------------------------
+void SceneManager::updateSceneGraphLinear(void)
+{
+    if (mLinearUpdateNodesDirty)
+        buildLinearUpdateNodes();
 
+    const size_t count = mLinearUpdateNodes.size();
+    SceneNode* const* nodes = &mLinearUpdateNodes[0];
+    const uint32* parents = &mLinearUpdateParents[0];
+    uint8* flags = &mLinearUpdateFlags[0];
 
+    // Transforms, parents first. A node is visited under the same conditions
+    // as the recursive Node::_update would reach it.
+    flags[0] = LUF_VISITED | (nodes[0]->_updateSelf(false) ? LUF_UPDATE_CHILDREN : 0);
+    for (size_t i = 1; i < count; ++i)
+    {
+        uint8 parentFlags = flags[parents[i]];
+        SceneNode* node = nodes[i];
+        if ((parentFlags & LUF_UPDATE_CHILDREN) ||
+            ((parentFlags & LUF_VISITED) && node->_isParentNotified()))
+        {
+            bool updateChildren = node->_updateSelf((parentFlags & LUF_UPDATE_CHILDREN) != 0);
+            flags[i] = LUF_VISITED | (updateChildren ? LUF_UPDATE_CHILDREN : 0);
+        }
+        else
+        {
+            flags[i] = 0;
+        }
     }
 
-    firePostRenderQueues();
+    // Bounds, children first
+    for (size_t i = count; i--; )
+    {
+        if (flags[i] & LUF_VISITED)
+            nodes[i]->_updateBounds();
+    }
 }
 //-----------------------------------------------------------------------
-void SceneManager::renderVisibleObjectsDefaultSequence(void)
+void SceneManager::_findVisibleObjects(
+    Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
 {
-    firePreRenderQueues();
-
-    // Render each separate queue
-    RenderQueue::QueueGroupIterator queueIt = getRenderQueue()->_getQueueGroupIterator();
+    if (mBatchCulling)
+    {
+        findVisibleObjectsBatched(cam, visibleBounds, onlyShadowCasters);
+        return;
+    }
 
-    // NB only queues which have been created are rendered, no time is wasted
-    //   parsing through non-existent queues (even though there are 10 available)
+    // Tell nodes to find, cascade down all nodes
+    getRootSceneNode()->_findVisibleObjects(cam, getRenderQueue(), visibleBounds, true, 
+        mDisplayNodes, onlyShadowCasters);
 
-    while (queueIt.hasMoreElements())
+}
+//-----------------------------------------------------------------------
+namespace {
+    /// Tests a range of scene node bounds against a set of planes
+    class BatchCullTask : public WorkQueue::ParallelTask
     {
-        // Get queue group id
-        uint8 qId = queueIt.peekNextKey();
-        RenderQueueGroup* pGroup = queueIt.getNext();
-        // Skip this one if not to be processed
-        if (!isRenderQueueToBeProcessed(qId))
-            continue;
+        SceneNode* const* mNodes;
+        uint8* mResults;
+        const Plane* mPlanes;
+        size_t mNumPlanes;
+    public:
+        BatchCullTask(SceneNode* const* nodes, uint8* results, const Plane* planes, size_t numPlanes)
+            : mNodes(nodes), mResults(results), mPlanes(planes), mNumPlanes(numPlanes) {}
+
+        void execute(size_t begin, size_t end)
+        {
+            // Pack a block of bounds at a time on the stack
+            const size_t blockSize = 64;
+            float centreX[blockSize], centreY[blockSize], centreZ[blockSize];
+            float halfX[blockSize], halfY[blockSize], halfZ[blockSize];
+            size_t boxIndex[blockSize];
+
+            OptimisedUtil* util = OptimisedUtil::getImplementation();
+            while (begin < end)
+            {
+                size_t numBoxes = 0;
+                for (; begin < end && numBoxes < blockSize; ++begin)
+                {
+                    const AxisAlignedBox& box = mNodes[begin]->_getWorldAABB();
+                    if (box.isFinite())
+                    {
+                        Vector3 centre = box.getCenter();
+                        Vector3 half = box.getHalfSize();
+                        centreX[numBoxes] = centre.x;
+                        centreY[numBoxes] = centre.y;
+                        centreZ[numBoxes] = centre.z;
+                        halfX[numBoxes] = half.x;
+                        halfY[numBoxes] = half.y;
+                        halfZ[numBoxes] = half.z;
+                        boxIndex[numBoxes++] = begin;
+                    }
+                    else
+                    {
+                        // Null boxes are never visible, infinite ones always
+                        mResults[begin] = box.isInfinite();
+                    }
+                }
+
+                uint8 results[blockSize];
+                util->cullBoxes(mPlanes, mNumPlanes, centreX, centreY, centreZ,
+                    halfX, halfY, halfZ, results, numBoxes);
+                for (size_t i = 0; i < numBoxes; ++i)
+                    mResults[boxIndex[i]] = results[i];
+            }
+        }
+    };
+
+    /// Runs the BatchCullTasks of several cameras as one range
+    class MultiBatchCullTask : public WorkQueue::ParallelTask
+    {
+        vector<BatchCullTask>::type& mTasks;
+        size_t mNodeCount;
+    public:
+        MultiBatchCullTask(vector<BatchCullTask>::type& tasks, size_t nodeCount)
+            : mTasks(tasks), mNodeCount(nodeCount) {}
+
+        void execute(size_t begin, size_t end)
+        {
+            while (begin < end)
+            {
+                size_t first = begin % mNodeCount;
+                size_t last = std::min(mNodeCount, first + (end - begin));
+                mTasks[begin / mNodeCount].execute(first, last);
+                begin += last - first;
+            }
+        }
+    };
+}
+size_t SceneManager::getBatchCullPlanes(Camera* cam, bool onlyShadowCasters, Plane* planes)
+{
+    // Same planes as Camera::isVisible would use
+    const Frustum* frustum = cam->getCullingFrustum() ? cam->getCullingFrustum() : cam;
+    const Plane* frustumPlanes = frustum->getFrustumPlanes();
+    size_t numPlanes = 0;
+    for (int i = 0; i < 6; ++i)
+    {
+        // Skip far plane if infinite view frustum
+        if (i == FRUSTUM_PLANE_FAR && frustum->getFarClipDistance() == 0)
+            continue;
+        planes[numPlanes++] = frustumPlanes[i];
+    }
+    const PlaneBoundedVolume* casterVolume = _getShadowCasterCullVolume();
+    if (onlyShadowCasters && casterVolume)
+    {
+        // Nodes outside it hold no caster whose shadow can be seen
+        for (size_t i = 0; i < casterVolume->planes.size() && numPlanes < 18; ++i)
+            planes[numPlanes++] = casterVolume->planes[i];
+    }
+    return numPlanes;
+}
+//-----------------------------------------------------------------------
+void SceneManager::findVisibleObjectsBatched(
+    Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
+{
+    if (mLinearUpdateNodesDirty)
+        buildLinearUpdateNodes();
+
+    // The hull of the shadow caster cull volume has at most 6 faces and 6 silhouette edges
+    Plane planes[18];
+    size_t numPlanes = getBatchCullPlanes(cam, onlyShadowCasters, planes);
+
+    const size_t count = mLinearUpdateNodes.size();
+    const uint8* results = 0;
+
+    // Reuse the results of _prepareCameras if nothing moved since
+    PreparedCullingMap::const_iterator prepared = mPreparedCulling.find(cam);
+    if (prepared != mPreparedCulling.end() &&
+        prepared->second.frameNumber == Root::getSingleton().getNextFrameNumber() &&
+        prepared->second.sceneGraphVersion == mSceneGraphVersion &&
+        prepared->second.numPlanes == numPlanes &&
+        std::equal(planes, planes + numPlanes, prepared->second.planes) &&
+        count && prepared->second.results.size() == count)
+    {
+        results = &prepared->second.results[0];
+    }
+    else
+    {
+        mBatchCullResults.resize(count);
+
+        BatchCullTask task(&mLinearUpdateNodes[0], &mBatchCullResults[0], planes, numPlanes);
+        Root::getSingleton().getWorkQueue()->parallelFor(count, 256, &task);
+        results = count ? &mBatchCullResults[0] : 0;
+    }
+
+    RenderQueue* queue = getRenderQueue();
+    const bool debugNodes = mDisplayNodes || mShowBoundingBoxes;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!results[i])
+            continue;
+
+        SceneNode* node = mLinearUpdateNodes[i];
+        if (debugNodes || node->getShowBoundingBox())
+        {
+            // Let the node queue its debug renderables too
+            node->_findVisibleObjects(cam, queue, visibleBounds, false,
+                mDisplayNodes, onlyShadowCasters);
+            continue;
+        }
+
+        SceneNode::ObjectIterator it = node->getAttachedObjectIterator();
+        while (it.hasMoreElements())
+        {
+            queue->processVisibleObject(it.getNext(), cam, onlyShadowCasters, visibleBounds);
+        }
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::_prepareCameras(const vector<Camera*>::type& cameras)
+{
+    if (!mBatchCulling || cameras.empty())
+        return;
+
+    OgreProfileGroup("_prepareCameras", OGREPROF_CULLING);
+
+    // Bring the bounds to where _renderScene will find them
+    updateSceneForFrame();
+    {
+        OGRE_LOCK_MUTEX(sceneGraphMutex);
+        _updateSceneGraph(cameras.front());
+    }
+    if (mLinearUpdateNodesDirty)
+        buildLinearUpdateNodes();
+
+    const size_t count = mLinearUpdateNodes.size();
+    if (!count)
+        return;
+
+    const unsigned long frameNumber = Root::getSingleton().getNextFrameNumber();
+    vector<BatchCullTask>::type tasks;
+    tasks.reserve(cameras.size());
+    for (vector<Camera*>::type::const_iterator i = cameras.begin(); i != cameras.end(); ++i)
+    {
+        PreparedCulling& prepared = mPreparedCulling[*i];
+        // A camera may be in several viewports
+        if (prepared.frameNumber == frameNumber && prepared.sceneGraphVersion == mSceneGraphVersion &&
+            prepared.results.size() == count)
+            continue;
+
+        prepared.frameNumber = frameNumber;
+        prepared.sceneGraphVersion = mSceneGraphVersion;
+        prepared.numPlanes = getBatchCullPlanes(*i, false, prepared.planes);
+        prepared.results.resize(count);
+        tasks.push_back(BatchCullTask(&mLinearUpdateNodes[0], &prepared.results[0],
+            prepared.planes, prepared.numPlanes));
+    }
+
+    // One parallelFor for all of them rather than one per camera
+    MultiBatchCullTask task(tasks, count);
+    Root::getSingleton().getWorkQueue()->parallelFor(tasks.size() * count, 256, &task);
+}
+//-----------------------------------------------------------------------
+namespace {
+    /// Caches the bone matrices of a range of gathered entities
+    class SkeletonUpdateTask : public WorkQueue::ParallelTask
+    {
+        Entity* const* mEntities;
+    public:
+        SkeletonUpdateTask(Entity* const* entities) : mEntities(entities) {}
+
+        void execute(size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                mEntities[i]->_updateBoneMatrices();
+        }
+    };
+}
+void SceneManager::updateSkeletonsParallel(Camera* cam)
+{
+    mParallelSkeletonEntities.clear();
+    {
+        MovableObjectCollection* entities = getMovableObjectCollection(EntityFactory::FACTORY_TYPE_NAME);
+        OGRE_LOCK_MUTEX(entities->mutex);
+
+        MovableObjectMap::iterator i, iend = entities->map.end();
+        for (i = entities->map.begin(); i != iend; ++i)
+        {
+            Entity* entity = static_cast<Entity*>(i->second);
+            if (entity->isInScene() && entity->isVisible() &&
+                (entity->getVisibilityFlags() & mVisibilityMask) &&
+                cam->isVisible(entity->getWorldBoundingBox(true)) &&
+                entity->_prepareConcurrentBoneUpdate())
+            {
+                mParallelSkeletonEntities.push_back(entity);
+            }
+        }
+    }
+
+    if (mParallelSkeletonEntities.empty())
+        return;
+
+    // Pick the OptimisedUtil implementation here rather than racing on it
+    OptimisedUtil::getImplementation();
+
+    SkeletonUpdateTask task(&mParallelSkeletonEntities[0]);
+    // Each skeleton is a sizeable piece of work, so hand them out one at a time
+    Root::getSingleton().getWorkQueue()->parallelFor(mParallelSkeletonEntities.size(), 1, &task);
+}
+//-----------------------------------------------------------------------
+bool SceneManager::SkeletonPoseKey::State::operator<(const State& rhs) const
+{
+    if (animation != rhs.animation)
+        return animation < rhs.animation;
+    if (time != rhs.time)
+        return time < rhs.time;
+    return weight < rhs.weight;
+}
+//-----------------------------------------------------------------------
+bool SceneManager::SkeletonPoseKey::operator<(const SkeletonPoseKey& rhs) const
+{
+    if (skeleton != rhs.skeleton)
+        return skeleton < rhs.skeleton;
+    if (blendMode != rhs.blendMode)
+        return blendMode < rhs.blendMode;
+    return std::lexicographical_compare(states.begin(), states.end(),
+        rhs.states.begin(), rhs.states.end());
+}
+//-----------------------------------------------------------------------
+void SceneManager::setSkeletonPoseSharing(bool enabled, Real timeStep, Real weightStep)
+{
+    assert(timeStep > 0 && weightStep > 0 && "Quantisation steps must be positive");
+    mSkeletonPoseSharing = enabled;
+    mSkeletonPoseTimeStep = timeStep;
+    mSkeletonPoseWeightStep = weightStep;
+    mSkeletonPoses.clear();
+}
+//-----------------------------------------------------------------------
+Entity* SceneManager::_claimSkeletonPose(Entity* entity)
+{
+    if (!mSkeletonPoseSharing)
+        return 0;
+
+    // Bones of an entity reusing another's pose are left untouched, so anything
+    // reading them, or moving them by hand, rules the entity out
+    SkeletonInstance* skeleton = entity->getSkeleton();
+    if (!skeleton || entity->sharesSkeletonInstance() || skeleton->hasManualBones() ||
+        entity->getSkipAnimationStateUpdate() || entity->getUpdateBoundingBoxFromSkeleton() ||
+        entity->getAttachedObjectIterator().hasMoreElements())
+    {
+        return 0;
+    }
+
+    SkeletonPoseKey key;
+    key.skeleton = entity->getMesh()->getSkeleton().get();
+    key.blendMode = skeleton->getBlendMode();
+
+    ConstEnabledAnimationStateIterator it =
+        entity->getAllAnimationStates()->getEnabledAnimationStateIterator();
+    while (it.hasMoreElements())
+    {
+        const AnimationState* state = it.getNext();
+        if (state->hasBlendMask())
+            return 0;
+
+        // Vertex animations don't affect the pose
+        const Animation* anim = skeleton->_getAnimationImpl(state->getAnimationName());
+        if (!anim)
+            continue;
+
+        SkeletonPoseKey::State poseState;
+        poseState.animation = anim;
+        poseState.time = static_cast<long>(Math::Floor(state->getTimePosition() / mSkeletonPoseTimeStep + 0.5f));
+        poseState.weight = static_cast<long>(Math::Floor(state->getWeight() / mSkeletonPoseWeightStep + 0.5f));
+        key.states.push_back(poseState);
+    }
+    // The same states enabled in a different order still give the same pose
+    std::sort(key.states.begin(), key.states.end());
+
+    // Poses are only valid for the frame they were evaluated in
+    unsigned long frameNumber = Root::getSingleton().getNextFrameNumber();
+    if (mSkeletonPosesFrame != frameNumber)
+    {
+        mSkeletonPoses.clear();
+        mSkeletonPosesFrame = frameNumber;
+    }
+
+    return mSkeletonPoses.insert(SkeletonPoseMap::value_type(key, entity)).first->second;
+}
+//-----------------------------------------------------------------------
+void SceneManager::_notifySkeletonPoseOwnerDestroyed(Entity* entity)
+{
+    SkeletonPoseMap::iterator i = mSkeletonPoses.begin();
+    while (i != mSkeletonPoses.end())
+    {
+        if (i->second == entity)
+            mSkeletonPoses.erase(i++);
+        else
+            ++i;
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::_notifySkeletonBoundsEntity(Entity* entity, bool fromSkeleton)
+{
+    if (fromSkeleton)
+        mSkeletonBoundsEntities.insert(entity);
+    else
+        mSkeletonBoundsEntities.erase(entity);
+}
+//-----------------------------------------------------------------------
+void SceneManager::updateSkeletonBounds(void)
+{
+    set<Entity*>::type::iterator i, iend = mSkeletonBoundsEntities.end();
+    for (i = mSkeletonBoundsEntities.begin(); i != iend; ++i)
+    {
+        (*i)->_updateSkeletonBounds();
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::_renderVisibleObjects(void)
+{
+    RenderQueueInvocationSequence* invocationSequence = 
+        mCurrentViewport->_getRenderQueueInvocationSequence();
+    // Use custom sequence only if we're not doing the texture shadow render
+    // since texture shadow render should not be interfered with by suppressing
+    // render state changes for example
+    if (invocationSequence && mIlluminationStage != IRS_RENDER_TO_TEXTURE)
+    {
+        renderVisibleObjectsCustomSequence(invocationSequence);
+    }
+    else
+    {
+        renderVisibleObjectsDefaultSequence();
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::renderVisibleObjectsCustomSequence(RenderQueueInvocationSequence* seq)
+{
+    firePreRenderQueues();
+
+    RenderQueueInvocationIterator invocationIt = seq->iterator();
+    while (invocationIt.hasMoreElements())
+    {
+        RenderQueueInvocation* invocation = invocationIt.getNext();
+        uint8 qId = invocation->getRenderQueueGroupID();
+        // Skip this one if not to be processed
+        if (!isRenderQueueToBeProcessed(qId))
+            continue;
+
+
+        bool repeatQueue = false;
+        const String& invocationName = invocation->getInvocationName();
+        RenderQueueGroup* queueGroup = getRenderQueue()->getQueueGroup(qId);
+        do // for repeating queues
+        {
+            // Fire queue started event
+            if (fireRenderQueueStarted(qId, invocationName))
+            {
+                // Someone requested we skip this queue
+                break;
+            }
+
+            // Invoke it
+            DrawCategory prevCategory = mDestRenderSystem->_getDrawCategory();
+            if (qId == RENDER_QUEUE_OVERLAY)
+                mDestRenderSystem->_setDrawCategory(DC_OVERLAY);
+            invocation->invoke(queueGroup, this);
+            mDestRenderSystem->_setDrawCategory(prevCategory);
+
+            // Fire queue ended event
+            if (fireRenderQueueEnded(qId, invocationName))
+            {
+                // Someone requested we repeat this queue
+                repeatQueue = true;
+            }
+            else
+            {
+                repeatQueue = false;
+            }
+        } while (repeatQueue);
+
+
+    }
+
+    firePostRenderQueues();
+}
+//-----------------------------------------------------------------------
+void SceneManager::renderVisibleObjectsDefaultSequence(void)
+{
+    firePreRenderQueues();
+
+    // Render each separate queue
+    RenderQueue::QueueGroupIterator queueIt = getRenderQueue()->_getQueueGroupIterator();
+
+    // NB only queues which have been created are rendered, no time is wasted
+    //   parsing through non-existent queues (even though there are 10 available)
+
+    while (queueIt.hasMoreElements())
+    {
+        // Get queue group id
+        uint8 qId = queueIt.peekNextKey();
+        RenderQueueGroup* pGroup = queueIt.getNext();
+        // Skip this one if not to be processed
+        if (!isRenderQueueToBeProcessed(qId))
+            continue;
 
 
         bool repeatQueue = false;
@@ -2401,7 +3369,20 @@ void SceneManager::renderVisibleObjectsDefaultSequence(void)
                 break;
             }
 
+            bool depthPrePass = mDepthPrePass && mIlluminationStage == IRS_NONE &&
+                !mSuppressRenderStateChanges && !isShadowTechniqueAdditive();
+            if (depthPrePass)
+            {
+                renderDepthPrePass(pGroup);
+                mDepthPrePassStage = DPS_EQUAL;
+            }
+
+            DrawCategory prevCategory = mDestRenderSystem->_getDrawCategory();
+            if (qId == RENDER_QUEUE_OVERLAY)
+                mDestRenderSystem->_setDrawCategory(DC_OVERLAY);
             _renderQueueGroupObjects(pGroup, QueuedRenderableCollection::OM_PASS_GROUP);
+            mDestRenderSystem->_setDrawCategory(prevCategory);
+            mDepthPrePassStage = DPS_NONE;
 
             // Fire queue ended event
             if (fireRenderQueueEnded(qId, 
@@ -2424,6 +3405,26 @@ void SceneManager::renderVisibleObjectsDefaultSequence(void)
 
 }
 //-----------------------------------------------------------------------
+void SceneManager::renderDepthPrePass(RenderQueueGroup* pGroup)
+{
+    mDepthPrePassStage = DPS_DEPTH;
+
+    RenderQueueGroup::PriorityMapIterator groupIt = pGroup->getIterator();
+    while (groupIt.hasMoreElements())
+    {
+        RenderPriorityGroup* pPriorityGrp = groupIt.getNext();
+
+        // Sort the queue first
+        pPriorityGrp->sort(mCameraInProgress);
+
+        // Only the basic solids, additive techniques are not pre-passed
+        renderObjects(pPriorityGrp->getSolidsBasic(), QueuedRenderableCollection::OM_PASS_GROUP,
+            false, false);
+    }
+
+    mDepthPrePassStage = DPS_NONE;
+}
+//-----------------------------------------------------------------------
 void SceneManager::renderAdditiveStencilShadowedQueueGroupObjects(
     RenderQueueGroup* pGroup, 
     QueuedRenderableCollection::OrganisationMode om)
@@ -2489,6 +3490,7 @@ void SceneManager::renderAdditiveStencilShadowedQueueGroupObjects(
             mDestRenderSystem->setStencilBufferParams();
             mDestRenderSystem->setStencilCheckEnabled(false);
             mDestRenderSystem->_setDepthBufferParams();
+            _invalidateRenderStateCache();
 
             if (scissored == CLIPPED_SOME)
                 resetScissor();
@@ -2573,6 +3575,7 @@ void SceneManager::renderModulativeStencilShadowedQueueGroupObjects(
             mDestRenderSystem->setStencilBufferParams();
             mDestRenderSystem->setStencilCheckEnabled(false);
             mDestRenderSystem->_setDepthBufferParams();
+            _invalidateRenderStateCache();
         }
 
     }// for each light
@@ -2967,6 +3970,17 @@ void SceneManager::SceneMgrQueuedRenderableVisitor::visit(Renderable* r)
     // Give SM a chance to eliminate
     if (targetSceneMgr->validateRenderableForRendering(mUsedPass, r))
     {
+        // Draw later together with identical ones, if automatic instancing allows
+        if (targetSceneMgr->queueAutoInstance(mSourcePass, mUsedPass, r))
+        {
+            if (targetSceneMgr->mRenderQueueDiagnostics)
+                targetSceneMgr->mRenderQueueDiagnostics->_notifyAutoInstanced();
+            return;
+        }
+
+        if (targetSceneMgr->mRenderQueueDiagnostics)
+            targetSceneMgr->mRenderQueueDiagnostics->_notifyDraw(mUsedPass, r);
+
         // Render a single object, this will set up auto params if required
         targetSceneMgr->renderSingleObject(r, mUsedPass, scissoring, autoLights, manualLightList);
     }
@@ -2974,11 +3988,15 @@ void SceneManager::SceneMgrQueuedRenderableVisitor::visit(Renderable* r)
 //-----------------------------------------------------------------------
 bool SceneManager::SceneMgrQueuedRenderableVisitor::visit(const Pass* p)
 {
+    // Draw what was collected with the previous pass
+    targetSceneMgr->flushAutoInstances(scissoring, autoLights, manualLightList);
+
     // Give SM a chance to eliminate this pass
     if (!targetSceneMgr->validatePassForRendering(p))
         return false;
 
     // Set pass, store the actual one used
+    mSourcePass = p;
     mUsedPass = targetSceneMgr->_setPass(p);
 
 
@@ -2998,6 +4016,8 @@ void SceneManager::SceneMgrQueuedRenderableVisitor::visit(RenderablePass* rp)
     if (targetSceneMgr->validateRenderableForRendering(rp->pass, rp->renderable))
     {
         mUsedPass = targetSceneMgr->_setPass(rp->pass);
+        if (targetSceneMgr->mRenderQueueDiagnostics)
+            targetSceneMgr->mRenderQueueDiagnostics->_notifyDraw(mUsedPass, rp->renderable);
         targetSceneMgr->renderSingleObject(rp->renderable, mUsedPass, scissoring, 
             autoLights, manualLightList);
     }
@@ -3005,6 +4025,10 @@ void SceneManager::SceneMgrQueuedRenderableVisitor::visit(RenderablePass* rp)
 //-----------------------------------------------------------------------
 bool SceneManager::validatePassForRendering(const Pass* pass)
 {
+    // Only the qualifying passes lay down depth in the pre-pass
+    if (mDepthPrePassStage == DPS_DEPTH && !isDepthPrePassCandidate(pass))
+        return false;
+
     // Bypass if we're doing a texture shadow render and 
     // this pass is after the first (only 1 pass needed for shadow texture render, and 
     // one pass for shadow texture receive for modulative technique)
@@ -3054,22 +4078,467 @@ bool SceneManager::validateRenderableForRendering(const Pass* pass, const Render
         }
     }
 
-    return true;
-
-}
-//-----------------------------------------------------------------------
-void SceneManager::renderObjects(const QueuedRenderableCollection& objs, 
-                                 QueuedRenderableCollection::OrganisationMode om, 
-                                 bool lightScissoringClipping,
-                                 bool doLightIteration, 
-                                 const LightList* manualLightList)
-{
-    mActiveQueuedRenderableVisitor->autoLights = doLightIteration;
-    mActiveQueuedRenderableVisitor->manualLightList = manualLightList;
-    mActiveQueuedRenderableVisitor->transparentShadowCastersMode = false;
-    mActiveQueuedRenderableVisitor->scissoring = lightScissoringClipping;
-    // Use visitor
-    objs.acceptVisitor(mActiveQueuedRenderableVisitor, om);
+    return true;
+
+}
+//-----------------------------------------------------------------------
+void SceneManager::renderObjects(const QueuedRenderableCollection& objs, 
+                                 QueuedRenderableCollection::OrganisationMode om, 
+                                 bool lightScissoringClipping,
+                                 bool doLightIteration, 
+                                 const LightList* manualLightList)
+{
+    mActiveQueuedRenderableVisitor->autoLights = doLightIteration;
+    mActiveQueuedRenderableVisitor->manualLightList = manualLightList;
+    mActiveQueuedRenderableVisitor->transparentShadowCastersMode = false;
+    mActiveQueuedRenderableVisitor->scissoring = lightScissoringClipping;
+    // Use visitor
+    objs.acceptVisitor(mActiveQueuedRenderableVisitor, om);
+    flushAutoInstances(lightScissoringClipping, doLightIteration, manualLightList);
+}
+//-----------------------------------------------------------------------
+void SceneManager::setAutoInstancingEnabled(bool enabled, const String& schemeName)
+{
+    mAutoInstancing = enabled;
+    mAutoInstancingScheme = schemeName;
+    if (!enabled)
+    {
+        clearAutoInstanceVertexData();
+        mAutoInstanceBuffer.setNull();
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::setOcclusionCullingEnabled(bool enabled)
+{
+    if (enabled && !mOcclusionCuller)
+    {
+        mOcclusionCuller = OGRE_NEW SoftwareOcclusionCuller();
+    }
+    else if (!enabled)
+    {
+        OGRE_DELETE mOcclusionCuller;
+        mOcclusionCuller = 0;
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::addCameraGroup(const vector<Camera*>::type& cameras)
+{
+    if (cameras.size() < 2)
+    {
+        OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "A camera group needs at least two cameras.",
+            "SceneManager::addCameraGroup");
+    }
+
+    for (vector<Camera*>::type::const_iterator i = cameras.begin(); i != cameras.end(); ++i)
+        removeCameraGroup(*i);
+
+    CameraGroup* group = OGRE_NEW_T(CameraGroup, MEMCATEGORY_SCENE_CONTROL)();
+    group->cameras = cameras;
+    group->cullFrustum = OGRE_NEW Frustum();
+    for (vector<Camera*>::type::const_iterator i = cameras.begin(); i != cameras.end(); ++i)
+        mCameraGroups[*i] = group;
+}
+//-----------------------------------------------------------------------
+void SceneManager::removeCameraGroup(Camera* camera)
+{
+    CameraGroupMap::iterator groupIt = mCameraGroups.find(camera);
+    if (groupIt == mCameraGroups.end())
+        return;
+
+    CameraGroup* group = groupIt->second;
+    for (vector<Camera*>::type::const_iterator i = group->cameras.begin(); i != group->cameras.end(); ++i)
+        mCameraGroups.erase(*i);
+    if (mSharedQueueCamera == group->cameras.front())
+        mSharedQueueCamera = 0;
+
+    OGRE_DELETE group->cullFrustum;
+    OGRE_DELETE_T(group, CameraGroup, MEMCATEGORY_SCENE_CONTROL);
+}
+//-----------------------------------------------------------------------
+Camera* SceneManager::getCameraGroupLeader(const Camera* camera) const
+{
+    CameraGroupMap::const_iterator groupIt = mCameraGroups.find(camera);
+    return groupIt != mCameraGroups.end() ? groupIt->second->cameras.front() : 0;
+}
+//-----------------------------------------------------------------------
+bool SceneManager::updateCameraGroupFrustum(CameraGroup* group)
+{
+    // Work in the view space of the first camera, without its position
+    const Quaternion orientation = group->cameras.front()->getDerivedOrientation();
+    const Quaternion toView = orientation.Inverse();
+
+    // Widest slopes of the frustum edges, as x / -z and y / -z
+    Real left = 0, right = 0, bottom = 0, top = 0;
+    bool infiniteFar = false;
+    vector<Camera*>::type::const_iterator i, iend = group->cameras.end();
+    for (i = group->cameras.begin(); i != iend; ++i)
+    {
+        Camera* cam = *i;
+        if (cam->getProjectionType() != PT_PERSPECTIVE || cam->isReflected())
+            return false;
+        infiniteFar = infiniteFar || cam->getFarClipDistance() == 0;
+
+        // Near corners, then far corners in the same order
+        const Vector3* corners = cam->getWorldSpaceCorners();
+        for (int k = 0; k < 4; ++k)
+        {
+            Vector3 edge = toView * (corners[k + 4] - corners[k]);
+            // Not looking forward enough
+            if (edge.z > -1e-3f * edge.length())
+                return false;
+            left = std::min(left, edge.x / -edge.z);
+            right = std::max(right, edge.x / -edge.z);
+            bottom = std::min(bottom, edge.y / -edge.z);
+            top = std::max(top, edge.y / -edge.z);
+        }
+    }
+    if (left >= 0 || right <= 0 || bottom >= 0 || top <= 0)
+        return false;
+
+    // Centre the apex on the near corners, and move it back until they all lie within
+    // the widest slopes, so that the frustums of all the cameras are inside
+    Real minX = Math::POS_INFINITY, maxX = Math::NEG_INFINITY;
+    Real minY = Math::POS_INFINITY, maxY = Math::NEG_INFINITY;
+    for (i = group->cameras.begin(); i != iend; ++i)
+    {
+        const Vector3* corners = (*i)->getWorldSpaceCorners();
+        for (int k = 0; k < 4; ++k)
+        {
+            Vector3 v = toView * corners[k];
+            minX = std::min(minX, v.x);
+            maxX = std::max(maxX, v.x);
+            minY = std::min(minY, v.y);
+            maxY = std::max(maxY, v.y);
+        }
+    }
+    const Real apexX = (minX + maxX) * 0.5f;
+    const Real apexY = (minY + maxY) * 0.5f;
+    Real apexZ = Math::NEG_INFINITY;
+    for (i = group->cameras.begin(); i != iend; ++i)
+    {
+        const Vector3* corners = (*i)->getWorldSpaceCorners();
+        for (int k = 0; k < 4; ++k)
+        {
+            Vector3 v = toView * corners[k];
+            Real dx = v.x - apexX, dy = v.y - apexY;
+            Real depth = std::max(dx > 0 ? dx / right : dx / left, dy > 0 ? dy / top : dy / bottom);
+            apexZ = std::max(apexZ, v.z + depth);
+        }
+    }
+
+    // Near plane through the nearest near corner, far plane beyond the farthest far corner
+    Real nearDist = Math::POS_INFINITY, farDist = 0;
+    for (i = group->cameras.begin(); i != iend; ++i)
+    {
+        const Vector3* corners = (*i)->getWorldSpaceCorners();
+        for (int k = 0; k < 4; ++k)
+        {
+            nearDist = std::min(nearDist, apexZ - (toView * corners[k]).z);
+            farDist = std::max(farDist, apexZ - (toView * corners[k + 4]).z);
+        }
+    }
+    const Real minNearDist = group->cameras.front()->getNearClipDistance() * 0.01f;
+    if (nearDist < minNearDist)
+    {
+        apexZ += minNearDist - nearDist;
+        farDist += minNearDist - nearDist;
+        nearDist = minNearDist;
+    }
+
+    Frustum* frustum = group->cullFrustum;
+    frustum->setCustomViewMatrix(true,
+        Math::makeViewMatrix(orientation * Vector3(apexX, apexY, apexZ), orientation));
+    frustum->setNearClipDistance(nearDist);
+    frustum->setFarClipDistance(infiniteFar ? 0 : farDist);
+    frustum->setFrustumExtents(left * nearDist, right * nearDist, top * nearDist, bottom * nearDist);
+    return true;
+}
+//-----------------------------------------------------------------------
+void SceneManager::setRenderQueueDiagnosticsEnabled(bool enabled)
+{
+    if (enabled && !mRenderQueueDiagnostics)
+    {
+        mRenderQueueDiagnostics = OGRE_NEW RenderQueueDiagnostics();
+    }
+    else if (!enabled)
+    {
+        OGRE_DELETE mRenderQueueDiagnostics;
+        mRenderQueueDiagnostics = 0;
+    }
+}
+//-----------------------------------------------------------------------
+const SceneManager::AutoInstanceVertexData* SceneManager::getAutoInstanceVertexData(
+    const VertexData* vertexData)
+{
+    const VertexBufferBinding::VertexBufferBindingMap& bindings =
+        vertexData->vertexBufferBinding->getBindings();
+
+    AutoInstanceVertexDataMap::iterator it = mAutoInstanceVertexData.find(vertexData);
+    if (it != mAutoInstanceVertexData.end())
+    {
+        // The copy holds references to the buffers, so matching buffers mean a match
+        // even if the vertex data was destroyed and another created at its address
+        const AutoInstanceVertexData& inst = it->second;
+        bool valid = inst.data &&
+            inst.data->vertexBufferBinding->getBufferCount() == bindings.size() + 1;
+        for (VertexBufferBinding::VertexBufferBindingMap::const_iterator b = bindings.begin();
+            valid && b != bindings.end(); ++b)
+        {
+            valid = inst.data->vertexBufferBinding->isBufferBound(b->first) &&
+                inst.data->vertexBufferBinding->getBuffer(b->first) == b->second;
+        }
+        if (valid)
+        {
+            inst.data->vertexStart = vertexData->vertexStart;
+            inst.data->vertexCount = vertexData->vertexCount;
+            return &inst;
+        }
+        if (!inst.data)
+            return 0;
+        OGRE_DELETE inst.data;
+        mAutoInstanceVertexData.erase(it);
+    }
+
+    // Keep the copies, and the buffers they reference, bounded
+    if (mAutoInstanceVertexData.size() >= 256)
+        clearAutoInstanceVertexData();
+
+    AutoInstanceVertexData inst;
+    inst.data = 0;
+    inst.instanceBinding = bindings.empty() ? 0 : bindings.rbegin()->first + 1;
+
+    // The instance matrix rows go to texture coordinates the vertex data must not use
+    const VertexDeclaration::VertexElementList& elems =
+        vertexData->vertexDeclaration->getElements();
+    bool usable = true;
+    for (VertexDeclaration::VertexElementList::const_iterator e = elems.begin(); e != elems.end(); ++e)
+    {
+        if (e->getSemantic() == VES_TEXTURE_COORDINATES &&
+            e->getIndex() >= AUTO_INSTANCING_TEXCOORD_INDEX)
+        {
+            usable = false;
+            break;
+        }
+    }
+
+    if (usable)
+    {
+        inst.data = OGRE_NEW VertexData();
+        inst.data->vertexStart = vertexData->vertexStart;
+        inst.data->vertexCount = vertexData->vertexCount;
+        for (VertexDeclaration::VertexElementList::const_iterator e = elems.begin(); e != elems.end(); ++e)
+        {
+            inst.data->vertexDeclaration->addElement(
+                e->getSource(), e->getOffset(), e->getType(), e->getSemantic(), e->getIndex());
+        }
+        for (unsigned short row = 0; row < 3; ++row)
+        {
+            inst.data->vertexDeclaration->addElement(inst.instanceBinding,
+                row * VertexElement::getTypeSize(VET_FLOAT4), VET_FLOAT4,
+                VES_TEXTURE_COORDINATES, AUTO_INSTANCING_TEXCOORD_INDEX + row);
+        }
+        for (VertexBufferBinding::VertexBufferBindingMap::const_iterator b = bindings.begin();
+            b != bindings.end(); ++b)
+        {
+            inst.data->vertexBufferBinding->setBinding(b->first, b->second);
+        }
+        // The instance buffer is bound when drawing, it may have been recreated by then
+        inst.data->vertexBufferBinding->setBinding(inst.instanceBinding, mAutoInstanceBuffer);
+    }
+
+    // Unusable vertex data are remembered as well, to not check them again
+    it = mAutoInstanceVertexData.insert(AutoInstanceVertexDataMap::value_type(vertexData, inst)).first;
+    return inst.data ? &it->second : 0;
+}
+//-----------------------------------------------------------------------
+void SceneManager::clearAutoInstanceVertexData(void)
+{
+    for (AutoInstanceVertexDataMap::iterator i = mAutoInstanceVertexData.begin();
+        i != mAutoInstanceVertexData.end(); ++i)
+    {
+        OGRE_DELETE i->second.data;
+    }
+    mAutoInstanceVertexData.clear();
+}
+//-----------------------------------------------------------------------
+const Pass* SceneManager::findAutoInstancePass(const Pass* pass) const
+{
+    Technique* tech = pass->getParent();
+    Material* mat = tech->getParent();
+    for (unsigned short i = 0; i < mat->getNumSupportedTechniques(); ++i)
+    {
+        Technique* instTech = mat->getSupportedTechnique(i);
+        if (instTech->getSchemeName() == mAutoInstancingScheme &&
+            instTech->getLodIndex() == tech->getLodIndex() &&
+            instTech->getNumPasses() > pass->getIndex())
+        {
+            Pass* instPass = instTech->getPass(pass->getIndex());
+            return instPass->hasVertexProgram() ? instPass : 0;
+        }
+    }
+    return 0;
+}
+//-----------------------------------------------------------------------
+bool SceneManager::queueAutoInstance(const Pass* pass, const Pass* usedPass, Renderable* rend)
+{
+    bool casters = mIlluminationStage == IRS_RENDER_TO_TEXTURE;
+    if (!mAutoInstancing || (mIlluminationStage != IRS_NONE && !casters) ||
+        mSuppressRenderStateChanges ||
+        mDepthPrePassStage != DPS_NONE ||
+        !mDestRenderSystem->getCapabilities()->hasCapability(RSC_VERTEX_BUFFER_INSTANCE_DATA))
+        return false;
+
+    // Only plain, unanimated sub entities
+    SubEntity* subEntity = dynamic_cast<SubEntity*>(rend);
+    if (!subEntity)
+        return false;
+    Entity* entity = subEntity->getParent();
+    if (entity->hasSkeleton() || entity->hasVertexAnimation() ||
+        rend->getNumWorldTransforms() != 1 ||
+        rend->getUseIdentityView() || rend->getUseIdentityProjection())
+        return false;
+
+    if (pass != mAutoInstanceSourcePass)
+    {
+        // Normally flushed on the pass change already, unless a custom visitor is used
+        if (mNumAutoInstanceGroups)
+            return false;
+        mAutoInstanceSourcePass = pass;
+        mAutoInstanceUsedPass = usedPass;
+        mAutoInstanceTargetPass = findAutoInstancePass(pass);
+        // Casters are drawn with the caster pass derived from the instanced pass,
+        // which only instances if it has a caster program or material of its own
+        if (casters && mAutoInstanceTargetPass &&
+            mAutoInstanceTargetPass->getShadowCasterVertexProgramName().empty() &&
+            mAutoInstanceTargetPass->getParent()->getShadowCasterMaterial().isNull())
+        {
+            mAutoInstanceTargetPass = 0;
+        }
+    }
+    if (!mAutoInstanceTargetPass)
+        return false;
+
+    Matrix4 xform;
+    rend->getWorldTransforms(&xform);
+    // Culling would have to be flipped for these
+    if (xform.hasNegativeScale())
+        return false;
+
+    RenderOperation op;
+    rend->getRenderOperation(op);
+    if (!op.vertexData || op.numberOfInstances != 1 || !getAutoInstanceVertexData(op.vertexData))
+        return false;
+
+    // Find the group of identical renderables, lit by the same lights
+    const IndexData* indexData = op.useIndexes ? op.indexData : 0;
+    const LightList& lights = rend->getLights();
+    AutoInstanceGroup* group = 0;
+    for (size_t i = 0; i < mNumAutoInstanceGroups && !group; ++i)
+    {
+        AutoInstanceGroup& g = mAutoInstanceGroups[i];
+        if (g.vertexData == op.vertexData && g.indexData == indexData &&
+            g.operationType == op.operationType)
+        {
+            const LightList& groupLights = g.first->getLights();
+            if (groupLights.size() == lights.size() &&
+                std::equal(lights.begin(), lights.end(), groupLights.begin()))
+            {
+                group = &g;
+            }
+        }
+    }
+    if (!group)
+    {
+        if (mNumAutoInstanceGroups == mAutoInstanceGroups.size())
+            mAutoInstanceGroups.push_back(AutoInstanceGroup());
+        group = &mAutoInstanceGroups[mNumAutoInstanceGroups++];
+        group->first = rend;
+        group->vertexData = op.vertexData;
+        group->indexData = indexData;
+        group->operationType = op.operationType;
+        group->renderables.clear();
+        group->transforms.clear();
+    }
+
+    group->renderables.push_back(rend);
+    for (int row = 0; row < 3; ++row)
+    {
+        for (int col = 0; col < 4; ++col)
+            group->transforms.push_back(static_cast<float>(xform[row][col]));
+    }
+    return true;
+}
+//-----------------------------------------------------------------------
+void SceneManager::flushAutoInstances(bool lightScissoringClipping, bool doLightIteration,
+    const LightList* manualLightList)
+{
+    if (!mNumAutoInstanceGroups)
+    {
+        mAutoInstanceSourcePass = 0;
+        return;
+    }
+
+    // Too few to instance, render these with the pass still set
+    bool anyInstanced = false;
+    for (size_t i = 0; i < mNumAutoInstanceGroups; ++i)
+    {
+        AutoInstanceGroup& group = mAutoInstanceGroups[i];
+        if (group.renderables.size() < mAutoInstancingMinCount)
+        {
+            for (size_t r = 0; r < group.renderables.size(); ++r)
+            {
+                renderSingleObject(group.renderables[r], mAutoInstanceUsedPass,
+                    lightScissoringClipping, doLightIteration, manualLightList);
+            }
+        }
+        else
+        {
+            anyInstanced = true;
+        }
+    }
+
+    if (anyInstanced)
+    {
+        // Derives the caster pass when rendering shadow textures
+        const Pass* usedPass = _setPass(mAutoInstanceTargetPass);
+        for (size_t i = 0; i < mNumAutoInstanceGroups; ++i)
+        {
+            AutoInstanceGroup& group = mAutoInstanceGroups[i];
+            size_t count = group.renderables.size();
+            if (count < mAutoInstancingMinCount)
+                continue;
+
+            // Grow the instance buffer to the largest group
+            if (mAutoInstanceBuffer.isNull() || mAutoInstanceBuffer->getNumVertices() < count)
+            {
+                size_t numInstances = std::max(count,
+                    mAutoInstanceBuffer.isNull() ? 0 : mAutoInstanceBuffer->getNumVertices() * 2);
+                mAutoInstanceBuffer = HardwareBufferManager::getSingleton().createVertexBuffer(
+                    3 * VertexElement::getTypeSize(VET_FLOAT4), numInstances,
+                    HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+                mAutoInstanceBuffer->setIsInstanceData(true);
+                mAutoInstanceBuffer->setInstanceDataStepRate(1);
+            }
+            mAutoInstanceBuffer->writeData(0, group.transforms.size() * sizeof(float),
+                &group.transforms[0], true);
+
+            const AutoInstanceVertexData* inst = getAutoInstanceVertexData(group.vertexData);
+            inst->data->vertexBufferBinding->setBinding(inst->instanceBinding, mAutoInstanceBuffer);
+
+            mAutoInstanceBatch.mFirst = group.first;
+            group.first->getRenderOperation(mAutoInstanceBatch.mRenderOp);
+            mAutoInstanceBatch.mRenderOp.vertexData = inst->data;
+            mAutoInstanceBatch.mRenderOp.numberOfInstances = count;
+            mAutoInstanceBatch.mRenderOp.useGlobalInstancingVertexBufferIsAvailable = false;
+            mAutoInstanceBatch.mRenderOp.srcRenderable = &mAutoInstanceBatch;
+
+            renderSingleObject(&mAutoInstanceBatch, usedPass,
+                lightScissoringClipping, doLightIteration, manualLightList);
+        }
+    }
+
+    mNumAutoInstanceGroups = 0;
+    mAutoInstanceSourcePass = 0;
 }
 //-----------------------------------------------------------------------
 void SceneManager::_renderQueueGroupObjects(RenderQueueGroup* pGroup, 
@@ -3395,14 +4864,15 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
                                         pass->getTextureUnitState(tuindex));
                                 const TexturePtr& shadowTex = mShadowTextures[shadowTexIndex];
                                 tu->_setTexturePtr(shadowTex);
-                                Camera *cam = shadowTex->getBuffer()->getRenderTarget()->getViewport(0)->getCamera();
+                                Camera *cam = mShadowTextureCameras[shadowTexIndex];
                                 tu->setProjectiveTexturing(!pass->hasVertexProgram(), cam);
-                                mAutoParamDataSource->setTextureProjector(cam, numShadowTextureLights);
+                                mAutoParamDataSource->setTextureProjector(cam, numShadowTextureLights,
+                                    getShadowTextureTile(shadowTexIndex));
                                 ++numShadowTextureLights;
                                 ++shadowTexIndex;
                                 // Have to set TU on rendersystem right now, although
                                 // autoparams will be set later
-                                mDestRenderSystem->_setTextureUnitSettings(tuindex, *tu);
+                                setTextureUnitSettings(tuindex, *tu);
                             }
                         }
 
@@ -4127,6 +5597,9 @@ bool SceneManager::fireRenderQueueStarted(uint8 id, const String& invocation)
     {
         (*i)->renderQueueStarted(id, invocation, skip);
     }
+    // Listeners may have changed render state
+    if (!mRenderQueueListeners.empty())
+        _invalidateRenderStateCache();
     return skip;
 }
 //---------------------------------------------------------------------
@@ -4140,6 +5613,9 @@ bool SceneManager::fireRenderQueueEnded(uint8 id, const String& invocation)
     {
         (*i)->renderQueueEnded(id, invocation, repeat);
     }
+    // Listeners may have changed render state
+    if (!mRenderQueueListeners.empty())
+        _invalidateRenderStateCache();
     return repeat;
 }
 //---------------------------------------------------------------------
@@ -4154,12 +5630,15 @@ void SceneManager::fireRenderSingleObject(Renderable* rend, const Pass* pass,
     {
         (*i)->notifyRenderSingleObject(rend, pass, source, pLightList, suppressRenderStateChanges);
     }
+    // Listeners may have changed render state
+    if (!mRenderObjectListeners.empty())
+        _invalidateRenderStateCache();
 }
 //---------------------------------------------------------------------
 void SceneManager::fireShadowTexturesUpdated(size_t numberOfShadowTextures)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    ListenerListCopy listenersCopy(mListeners.begin(), mListeners.end());
+    ListenerListCopy::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -4170,8 +5649,8 @@ void SceneManager::fireShadowTexturesUpdated(size_t numberOfShadowTextures)
 //---------------------------------------------------------------------
 void SceneManager::fireShadowTexturesPreCaster(Light* light, Camera* camera, size_t iteration)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    ListenerListCopy listenersCopy(mListeners.begin(), mListeners.end());
+    ListenerListCopy::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -4182,8 +5661,8 @@ void SceneManager::fireShadowTexturesPreCaster(Light* light, Camera* camera, siz
 //---------------------------------------------------------------------
 void SceneManager::fireShadowTexturesPreReceiver(Light* light, Frustum* f)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    ListenerListCopy listenersCopy(mListeners.begin(), mListeners.end());
+    ListenerListCopy::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -4194,8 +5673,8 @@ void SceneManager::fireShadowTexturesPreReceiver(Light* light, Frustum* f)
 //---------------------------------------------------------------------
 void SceneManager::firePreUpdateSceneGraph(Camera* camera)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    ListenerListCopy listenersCopy(mListeners.begin(), mListeners.end());
+    ListenerListCopy::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -4206,8 +5685,8 @@ void SceneManager::firePreUpdateSceneGraph(Camera* camera)
 //---------------------------------------------------------------------
 void SceneManager::firePostUpdateSceneGraph(Camera* camera)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    ListenerListCopy listenersCopy(mListeners.begin(), mListeners.end());
+    ListenerListCopy::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -4219,8 +5698,8 @@ void SceneManager::firePostUpdateSceneGraph(Camera* camera)
 //---------------------------------------------------------------------
 void SceneManager::firePreFindVisibleObjects(Viewport* v)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    ListenerListCopy listenersCopy(mListeners.begin(), mListeners.end());
+    ListenerListCopy::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -4232,8 +5711,8 @@ void SceneManager::firePreFindVisibleObjects(Viewport* v)
 //---------------------------------------------------------------------
 void SceneManager::firePostFindVisibleObjects(Viewport* v)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    ListenerListCopy listenersCopy(mListeners.begin(), mListeners.end());
+    ListenerListCopy::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -4246,8 +5725,8 @@ void SceneManager::firePostFindVisibleObjects(Viewport* v)
 //---------------------------------------------------------------------
 void SceneManager::fireSceneManagerDestroyed()
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    ListenerListCopy listenersCopy(mListeners.begin(), mListeners.end());
+    ListenerListCopy::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -4519,8 +5998,8 @@ void SceneManager::findLightsAffectingFrustum(const Camera* camera)
             // Allow a Listener to override light sorting
             // Reverse iterate so last takes precedence
             bool overridden = false;
-            ListenerList listenersCopy = mListeners;
-            for (ListenerList::reverse_iterator ri = listenersCopy.rbegin();
+            ListenerListCopy listenersCopy(mListeners.begin(), mListeners.end());
+            for (ListenerListCopy::reverse_iterator ri = listenersCopy.rbegin();
                 ri != listenersCopy.rend(); ++ri)
             {
                 overridden = (*ri)->sortLightsAffectingFrustum(mLightsAffectingFrustum);
@@ -4644,7 +6123,7 @@ const SceneManager::ShadowCasterList& SceneManager::findShadowCastersForLight(
         mShadowCasterQueryListener->prepare(false, 
             &(light->_getFrustumClipVolumes(camera)), 
             light, camera, &mShadowCasterList, light->getShadowFarDistanceSquared());
-        mShadowCasterAABBQuery->execute(mShadowCasterQueryListener);
+        executeShadowCasterQuery(light, mShadowCasterAABBQuery, 0, &aabb);
 
 
     }
@@ -4672,7 +6151,7 @@ const SceneManager::ShadowCasterList& SceneManager::findShadowCastersForLight(
             // Execute, use callback
             mShadowCasterQueryListener->prepare(lightInFrustum, 
                 volList, light, camera, &mShadowCasterList, light->getShadowFarDistanceSquared());
-            mShadowCasterSphereQuery->execute(mShadowCasterQueryListener);
+            executeShadowCasterQuery(light, mShadowCasterSphereQuery, &s, 0);
 
         }
 
@@ -4682,6 +6161,200 @@ const SceneManager::ShadowCasterList& SceneManager::findShadowCastersForLight(
     return mShadowCasterList;
 }
 //---------------------------------------------------------------------
+void SceneManager::executeShadowCasterQuery(const Light* light, RegionSceneQuery* query,
+    const Sphere* sphere, const AxisAlignedBox* box)
+{
+    if (!mShadowCasterCaching)
+    {
+        query->execute(mShadowCasterQueryListener);
+        return;
+    }
+
+    ShadowCasterCache::iterator it = mShadowCasterCache.find(light);
+    if (it == mShadowCasterCache.end())
+    {
+        it = mShadowCasterCache.insert(ShadowCasterCache::value_type(light, ShadowCasterCacheEntry())).first;
+        it->second.counter = mShadowCasterCacheCounter.get() - 1;
+    }
+    ShadowCasterCacheEntry& entry = it->second;
+
+    bool upToDate = entry.counter == mShadowCasterCacheCounter.get() && entry.isSphere == (sphere != 0);
+    if (upToDate)
+    {
+        upToDate = sphere ?
+            entry.sphere.getCenter() == sphere->getCenter() && entry.sphere.getRadius() == sphere->getRadius() :
+            entry.box == *box;
+    }
+
+    if (!upToDate)
+    {
+        entry.counter = mShadowCasterCacheCounter.get();
+        entry.isSphere = sphere != 0;
+        if (sphere)
+            entry.sphere = *sphere;
+        else
+            entry.box = *box;
+        entry.objects.clear();
+        ShadowCasterGatherListener gatherListener(&entry.objects);
+        query->execute(&gatherListener);
+    }
+
+    // The caster tests depend on the camera and the object states, so always redo them
+    vector<MovableObject*>::type::iterator i, iend = entry.objects.end();
+    for (i = entry.objects.begin(); i != iend; ++i)
+    {
+        if (!mShadowCasterQueryListener->queryResult(*i))
+            break;
+    }
+}
+//---------------------------------------------------------------------
+void SceneManager::setShadowCasterCaching(bool caching)
+{
+    mShadowCasterCaching = caching;
+    // Nothing was tracked while disabled
+    mShadowCasterCache.clear();
+}
+//---------------------------------------------------------------------
+void SceneManager::setStaticShadowCaching(bool caching)
+{
+    mStaticShadowCaching = caching;
+    if (!caching)
+        destroyStaticShadowCaches();
+}
+//---------------------------------------------------------------------
+void SceneManager::setStaticShadowCasterMask(uint32 mask)
+{
+    mStaticShadowCasterMask = mask;
+    invalidateStaticShadowCache();
+}
+//---------------------------------------------------------------------
+void SceneManager::setStaticShadowCacheMargin(Real margin)
+{
+    mStaticShadowCacheMargin = std::max(margin, Real(0));
+    invalidateStaticShadowCache();
+}
+//---------------------------------------------------------------------
+void SceneManager::invalidateStaticShadowCache(void)
+{
+    for (StaticShadowCacheList::iterator i = mStaticShadowCaches.begin();
+        i != mStaticShadowCaches.end(); ++i)
+    {
+        i->valid = false;
+    }
+}
+//---------------------------------------------------------------------
+void SceneManager::setShadowAtlasSize(unsigned int size)
+{
+    mShadowAtlasSize = size ? Bitwise::firstPO2From(size + 1) / 2 : 0;
+    mShadowTextureConfigDirty = true;
+}
+//---------------------------------------------------------------------
+void SceneManager::setShadowAtlasMinTileSize(unsigned int size)
+{
+    mShadowAtlasMinTileSize = Bitwise::firstPO2From(std::max(size, 1u) + 1) / 2;
+    mShadowTextureConfigDirty = true;
+}
+//---------------------------------------------------------------------
+Viewport* SceneManager::getShadowTextureViewport(size_t index) const
+{
+    RenderTarget* shadowRTT = mShadowTextures[index]->getBuffer()->getRenderTarget();
+    return mShadowAtlas.isNull() ? shadowRTT->getViewport(0) :
+        shadowRTT->getViewportByZOrder(static_cast<int>(index));
+}
+//---------------------------------------------------------------------
+void SceneManager::allocateShadowAtlasTiles(const Camera* cam, const LightList* lightList)
+{
+    size_t numTextures = mShadowTextures.size();
+    size_t atlasUnits = mShadowAtlasSize / mShadowAtlasMinTileSize;
+    mShadowAtlasTileUnits.assign(numTextures, 1);
+
+    // Size the tiles of each light by how much of the screen it covers
+    size_t index = 0;
+    LightList::const_iterator i, iend = lightList->end();
+    for (i = lightList->begin(); i != iend && index < numTextures; ++i)
+    {
+        const Light* light = *i;
+        if (!light->getCastShadows())
+            continue;
+
+        Real coverage = 1;
+        if (light->getType() != Light::LT_DIRECTIONAL)
+        {
+            Real range = light->getAttenuationRange();
+            Real dist = cam->getDerivedPosition().distance(light->getDerivedPosition());
+            if (dist > range)
+                coverage = range / dist;
+        }
+
+        size_t textureCountPerLight = mShadowTextureCountPerType[light->getType()];
+        for (size_t j = 0; j < textureCountPerLight && index < numTextures; ++j, ++index)
+        {
+            size_t maxUnits = std::min(atlasUnits, std::max((size_t)1,
+                (size_t)mShadowTextureConfigList[index].width / mShadowAtlasMinTileSize));
+            size_t units = 1;
+            while (units * 2 <= maxUnits && units < maxUnits * coverage)
+                units *= 2;
+            mShadowAtlasTileUnits[index] = units;
+        }
+    }
+
+    // Shrink the largest tiles, those of the lights sorted last first, until all fit
+    size_t area = 0;
+    for (index = 0; index < numTextures; ++index)
+        area += mShadowAtlasTileUnits[index] * mShadowAtlasTileUnits[index];
+    while (area > atlasUnits * atlasUnits)
+    {
+        size_t largest = 0;
+        for (index = 1; index < numTextures; ++index)
+        {
+            if (mShadowAtlasTileUnits[index] >= mShadowAtlasTileUnits[largest])
+                largest = index;
+        }
+        size_t& units = mShadowAtlasTileUnits[largest];
+        area -= units * units * 3 / 4;
+        units /= 2;
+    }
+
+    // Place the tiles from the largest down in Morton order, which keeps
+    // every tile aligned to its own size
+    Real unit = (Real)mShadowAtlasMinTileSize / (Real)mShadowAtlasSize;
+    size_t cursor = 0;
+    for (size_t units = atlasUnits; units > 0; units /= 2)
+    {
+        for (index = 0; index < numTextures; ++index)
+        {
+            if (mShadowAtlasTileUnits[index] != units)
+                continue;
+            size_t x = 0, y = 0;
+            for (size_t bit = 0; (cursor >> (2 * bit)) != 0; ++bit)
+            {
+                x |= ((cursor >> (2 * bit)) & 1) << bit;
+                y |= ((cursor >> (2 * bit + 1)) & 1) << bit;
+            }
+            cursor += units * units;
+
+            RealRect& tile = mShadowAtlasTiles[index];
+            tile.left = x * unit;
+            tile.top = y * unit;
+            tile.right = (x + units) * unit;
+            tile.bottom = (y + units) * unit;
+            getShadowTextureViewport(index)->setDimensions(
+                tile.left, tile.top, tile.width(), tile.height());
+        }
+    }
+}
+//---------------------------------------------------------------------
+void SceneManager::destroyStaticShadowCaches(void)
+{
+    for (StaticShadowCacheList::iterator i = mStaticShadowCaches.begin();
+        i != mStaticShadowCaches.end(); ++i)
+    {
+        if (!i->texture.isNull())
+            TextureManager::getSingleton().remove(i->texture->getHandle());
+    }
+    mStaticShadowCaches.clear();
+}
+//---------------------------------------------------------------------
 void SceneManager::initShadowVolumeMaterials(void)
 {
     /* This should have been set in the SceneManager constructor, but if you
@@ -5076,6 +6749,63 @@ const Pass* SceneManager::deriveShadowCasterPass(const Pass* pass)
 
 }
 //---------------------------------------------------------------------
+bool SceneManager::isDepthPrePassCandidate(const Pass* pass) const
+{
+    return pass->getIndex() == 0 &&
+        pass->getDepthCheckEnabled() && pass->getDepthWriteEnabled() &&
+        (pass->getDepthFunction() == CMPF_LESS || pass->getDepthFunction() == CMPF_LESS_EQUAL) &&
+        pass->getColourWriteEnabled() && !pass->isTransparent() &&
+        pass->getAlphaRejectFunction() == CMPF_ALWAYS_PASS && !pass->isAlphaToCoverageEnabled() &&
+        !pass->getIteratePerLight() && pass->getPolygonMode() == PM_SOLID &&
+        !pass->hasGeometryProgram() && !pass->hasTessellationHullProgram() &&
+        !pass->hasTessellationDomainProgram();
+}
+//---------------------------------------------------------------------
+const Pass* SceneManager::deriveDepthPrePass(const Pass* pass)
+{
+    if (!mDepthPrePassPass)
+    {
+        MaterialPtr mat = MaterialManager::getSingleton().getByName("Ogre/DepthPrePass");
+        if (mat.isNull())
+        {
+            mat = MaterialManager::getSingleton().create("Ogre/DepthPrePass",
+                ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+            Pass* depthPass = mat->getTechnique(0)->getPass(0);
+            depthPass->setLightingEnabled(false);
+            depthPass->setColourWriteEnabled(false);
+            depthPass->setFog(true, FOG_NONE);
+        }
+        mDepthPrePassPass = mat->getTechnique(0)->getPass(0);
+    }
+    Pass* retPass = mDepthPrePassPass;
+
+    // Keep whatever decides the depth
+    retPass->setCullingMode(pass->getCullingMode());
+    retPass->setManualCullingMode(pass->getManualCullingMode());
+    retPass->setDepthFunction(pass->getDepthFunction());
+    retPass->setDepthBias(pass->getDepthBiasConstant(), pass->getDepthBiasSlopeScale());
+    if (pass->hasVertexProgram())
+    {
+        retPass->setVertexProgram(pass->getVertexProgramName(), false);
+        const GpuProgramPtr& prg = retPass->getVertexProgram();
+        // Load this program if not done already
+        if (!prg->isLoaded())
+            prg->load();
+        retPass->setVertexProgramParameters(pass->getVertexProgramParameters());
+    }
+    else if (retPass->hasVertexProgram())
+    {
+        retPass->setVertexProgram(BLANKSTRING);
+    }
+
+    // The technique is kept even without fixed pipeline support, since the
+    // vertex program has to be the one of the original pass
+    if (retPass->getParent()->getParent()->getCompilationRequired())
+        retPass->getParent()->getParent()->compile();
+
+    return retPass;
+}
+//---------------------------------------------------------------------
 const Pass* SceneManager::deriveShadowReceiverPass(const Pass* pass)
 {
 
@@ -5544,6 +7274,9 @@ void SceneManager::renderShadowVolumesToStencil(const Light* light,
             return; // nothing to do
     }
 
+    DrawCategory prevCategory = mDestRenderSystem->_getDrawCategory();
+    mDestRenderSystem->_setDrawCategory(DC_SHADOW);
+
     mDestRenderSystem->unbindGpuProgram(GPT_FRAGMENT_PROGRAM);
 
     // Can we do a 2-sided stencil?
@@ -5616,6 +7349,7 @@ void SceneManager::renderShadowVolumesToStencil(const Light* light,
     mDestRenderSystem->_setColourBufferWriteEnabled(false, false, false, false);
     mDestRenderSystem->_disableTextureUnitsFrom(0);
     mDestRenderSystem->_setDepthBufferParams(true, false, CMPF_LESS);
+    _invalidateRenderStateCache();
     mDestRenderSystem->setStencilCheckEnabled(true);
 
     // Calculate extrusion distance
@@ -5725,6 +7459,7 @@ void SceneManager::renderShadowVolumesToStencil(const Light* light,
             mShadowDebugPass->getTextureUnitState(0)->
                 setColourOperationEx(LBX_MODULATE, LBS_MANUAL, LBS_CURRENT,
                 zfailAlgo ? ColourValue(0.7, 0.0, 0.2) : ColourValue(0.0, 0.7, 0.2));
+            _invalidateRenderStateCache();
             _setPass(mShadowDebugPass);
             renderShadowVolumeObjects(iShadowRenderables, mShadowDebugPass, &lightList, flags,
                 true, false, false);
@@ -5737,6 +7472,7 @@ void SceneManager::renderShadowVolumesToStencil(const Light* light,
     mDestRenderSystem->_setColourBufferWriteEnabled(true, true, true, true);
     // revert depth state
     mDestRenderSystem->_setDepthBufferParams();
+    _invalidateRenderStateCache();
 
     mDestRenderSystem->setStencilCheckEnabled(false);
 
@@ -5748,6 +7484,7 @@ void SceneManager::renderShadowVolumesToStencil(const Light* light,
         resetScissor();
     }
 
+    mDestRenderSystem->_setDrawCategory(prevCategory);
 }
 //---------------------------------------------------------------------
 void SceneManager::renderShadowVolumeObjects(ShadowCaster::ShadowRenderableListIterator iShadowRenderables,
@@ -6193,8 +7930,31 @@ void SceneManager::ensureShadowTexturesCreated()
     if (mShadowTextureConfigDirty)
     {
         destroyShadowTextures();
-        ShadowTextureManager::getSingleton().getShadowTextures(
-            mShadowTextureConfigList, mShadowTextures);
+        if (mShadowAtlasSize && !mShadowTextureConfigList.empty())
+        {
+            size_t atlasUnits = mShadowAtlasSize / mShadowAtlasMinTileSize;
+            if (atlasUnits * atlasUnits < mShadowTextureConfigList.size())
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                    "The shadow atlas cannot hold a tile of the minimum size for each shadow texture",
+                    "SceneManager::ensureShadowTexturesCreated");
+            }
+            // Every shadow texture is a tile of the same texture
+            const ShadowTextureConfig& config = mShadowTextureConfigList[0];
+            mShadowAtlas = TextureManager::getSingleton().createManual(
+                "Ogre/ShadowAtlas/" + getName(),
+                ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME,
+                TEX_TYPE_2D, mShadowAtlasSize, mShadowAtlasSize, 0, config.format,
+                TU_RENDERTARGET, NULL, false, config.fsaa);
+            mShadowAtlas->load();
+            mShadowTextures.assign(mShadowTextureConfigList.size(), mShadowAtlas);
+            mShadowAtlasTiles.assign(mShadowTextureConfigList.size(), RealRect(0, 0, 1, 1));
+        }
+        else
+        {
+            ShadowTextureManager::getSingleton().getShadowTextures(
+                mShadowTextureConfigList, mShadowTextures);
+        }
 
         // clear shadow cam - light mapping
         mShadowCamLightMapping.clear();
@@ -6207,11 +7967,14 @@ void SceneManager::ensureShadowTexturesCreated()
             i != mShadowTextures.end(); ++i, ++__i) 
         {
             const TexturePtr& shadowTex = *i;
+            // Tiles of an atlas share their texture, so are told apart by index
+            String texName = mShadowAtlas.isNull() ? shadowTex->getName() :
+                shadowTex->getName() + StringConverter::toString(__i);
 
             // Camera names are local to SM 
-            String camName = shadowTex->getName() + "Cam";
+            String camName = texName + "Cam";
             // Material names are global to SM, make specific
-            String matName = shadowTex->getName() + "Mat" + getName();
+            String matName = texName + "Mat" + getName();
 
             RenderTexture *shadowRTT = shadowTex->getBuffer()->getRenderTarget();
 
@@ -6224,8 +7987,15 @@ void SceneManager::ensureShadowTexturesCreated()
             cam->setAspectRatio((Real)shadowTex->getWidth() / (Real)shadowTex->getHeight());
             mShadowTextureCameras.push_back(cam);
 
+            if (!mShadowAtlas.isNull())
+            {
+                // A viewport per tile, placed every frame
+                Viewport *v = shadowRTT->addViewport(cam, static_cast<int>(__i));
+                v->setClearEveryFrame(true);
+                v->setOverlaysEnabled(false);
+            }
             // Create a viewport, if not there already
-            if (shadowRTT->getNumViewports() == 0)
+            else if (shadowRTT->getNumViewports() == 0)
             {
                 // Note camera assignment is transient when multiple SMs
                 Viewport *v = shadowRTT->addViewport(cam);
@@ -6291,9 +8061,11 @@ void SceneManager::destroyShadowTextures(void)
     for (i = mShadowTextures.begin(); i != iend; ++i)
     {
         TexturePtr &shadowTex = *i;
+        String texName = mShadowAtlas.isNull() ? shadowTex->getName() :
+            shadowTex->getName() + StringConverter::toString(i - mShadowTextures.begin());
 
         // Cleanup material that references this texture
-        String matName = shadowTex->getName() + "Mat" + getName();
+        String matName = texName + "Mat" + getName();
         MaterialPtr mat = MaterialManager::getSingleton().getByName(matName);
         if (!mat.isNull())
         {
@@ -6313,6 +8085,13 @@ void SceneManager::destroyShadowTextures(void)
     }
     mShadowTextures.clear();
     mShadowTextureCameras.clear();
+    mShadowTextureUpdates.clear();
+    destroyStaticShadowCaches();
+    if (!mShadowAtlas.isNull())
+    {
+        TextureManager::getSingleton().remove(mShadowAtlas->getHandle());
+        mShadowAtlas.setNull();
+    }
 
     // Will destroy if no other scene managers referencing
     ShadowTextureManager::getSingleton().clearUnused();
@@ -6374,6 +8153,12 @@ void SceneManager::prepareShadowTextures(Camera* cam, Viewport* vp, const LightL
         ci = mShadowTextureCameras.begin();
         mShadowTextureIndexLightList.clear();
         size_t shadowTextureIndex = 0;
+        if (!mShadowAtlas.isNull())
+            allocateShadowAtlasTiles(cam, lightList);
+        scheduleShadowTextureUpdates(cam, lightList);
+        if (mShadowCasterReceiverCulling)
+            findShadowReceiverBounds(cam);
+        unsigned long frame = Root::getSingleton().getNextFrameNumber();
         for (i = lightList->begin(), si = mShadowTextures.begin();
             i != iend && si != siend; ++i)
         {
@@ -6388,14 +8173,27 @@ void SceneManager::prepareShadowTextures(Camera* cam, Viewport* vp, const LightL
             else
                 mShadowTextureCurrentCasterLightList[0] = light;
 
+            if (mShadowCasterReceiverCulling)
+                setupShadowCasterCullVolume(light);
 
             // texture iteration per light.
             size_t textureCountPerLight = mShadowTextureCountPerType[light->getType()];
             for (size_t j = 0; j < textureCountPerLight && si != siend; ++j)
             {
-                TexturePtr &shadowTex = *si;
-                RenderTarget *shadowRTT = shadowTex->getBuffer()->getRenderTarget();
-                Viewport *shadowView = shadowRTT->getViewport(0);
+                // Keep what the texture was last rendered with
+                ShadowTextureUpdate& update = mShadowTextureUpdates[si - mShadowTextures.begin()];
+                if (!update.scheduled)
+                {
+                    ++si;
+                    ++ci;
+                    continue;
+                }
+                update.light = light;
+                update.lightTextureIndex = j;
+                update.camera = cam;
+                update.frame = frame;
+
+                Viewport *shadowView = getShadowTextureViewport(si - mShadowTextures.begin());
                 Camera *texCam = *ci;
                 // rebind camera, incase another SM in use which has switched to its cam
                 shadowView->setCamera(texCam);
@@ -6412,6 +8210,13 @@ void SceneManager::prepareShadowTextures(Camera* cam, Viewport* vp, const LightL
                 // This is required to pick up the correct shadow_caster_material and similar properties.
                 shadowView->setMaterialScheme(vp->getMaterialScheme());
 
+                // The matrices of cached static casters may have been set last frame
+                if (mStaticShadowCaching)
+                {
+                    texCam->setCustomViewMatrix(false);
+                    texCam->setCustomProjectionMatrix(false);
+                }
+
                 // update shadow cam - light mapping
                 ShadowCamLightMapping::iterator camLightIt = mShadowCamLightMapping.find( texCam );
                 assert(camLightIt != mShadowCamLightMapping.end());
@@ -6429,7 +8234,7 @@ void SceneManager::prepareShadowTextures(Camera* cam, Viewport* vp, const LightL
                 fireShadowTexturesPreCaster(light, texCam, j);
 
                 // Update target
-                shadowRTT->update();
+                updateShadowTexture(si - mShadowTextures.begin(), light, j);
 
                 ++si; // next shadow texture
                 ++ci; // next camera
@@ -6444,10 +8249,13 @@ void SceneManager::prepareShadowTextures(Camera* cam, Viewport* vp, const LightL
     {
         // we must reset the illumination stage if an exception occurs
         mIlluminationStage = savedStage;
+        mShadowCasterCompositing = false;
+        mShadowCasterCullVolumeActive = false;
         throw;
     }
     // Set the illumination stage, prevents recursive calls
     mIlluminationStage = savedStage;
+    mShadowCasterCullVolumeActive = false;
 
     fireShadowTexturesUpdated(
         std::min(lightList->size(), mShadowTextures.size()));
@@ -6456,6 +8264,293 @@ void SceneManager::prepareShadowTextures(Camera* cam, Viewport* vp, const LightL
 
 }
 //---------------------------------------------------------------------
+namespace
+{
+    /// Merges the bounds of the visible shadow receivers below a node
+    void mergeShadowReceivers(SceneNode* node, Camera* cam, RenderQueue* queue,
+        AxisAlignedBox& bounds)
+    {
+        if (!cam->isVisible(node->_getWorldAABB()))
+            return;
+
+        SceneNode::ObjectIterator it = node->getAttachedObjectIterator();
+        while (it.hasMoreElements())
+        {
+            MovableObject* mo = it.getNext();
+            mo->_notifyCurrentCamera(cam);
+            if (mo->isVisible() && mo->getReceivesShadows() &&
+                queue->getQueueGroup(mo->getRenderQueueGroup())->getShadowsEnabled())
+            {
+                bounds.merge(mo->getWorldBoundingBox(true));
+            }
+        }
+
+        SceneNode::ChildNodeIterator children = node->getChildIterator();
+        while (children.hasMoreElements())
+        {
+            mergeShadowReceivers(static_cast<SceneNode*>(children.getNext()), cam, queue, bounds);
+        }
+    }
+}
+//---------------------------------------------------------------------
+void SceneManager::findShadowReceiverBounds(Camera* cam)
+{
+    mShadowReceiverBounds.setNull();
+    mergeShadowReceivers(getRootSceneNode(), cam, getRenderQueue(), mShadowReceiverBounds);
+}
+//---------------------------------------------------------------------
+void SceneManager::setupShadowCasterCullVolume(const Light* light)
+{
+    // Nothing to go by, or nothing to cull
+    mShadowCasterCullVolumeActive = false;
+    if (!mShadowReceiverBounds.isFinite())
+        return;
+
+    // The light as a homogeneous point, at infinity for directional lights
+    Vector3 lightPos;
+    Real lightW;
+    if (light->getType() == Light::LT_DIRECTIONAL)
+    {
+        lightPos = -light->getDerivedDirection();
+        lightW = 0;
+    }
+    else
+    {
+        lightPos = light->getDerivedPosition();
+        lightW = 1;
+    }
+
+    const Vector3& bmin = mShadowReceiverBounds.getMinimum();
+    const Vector3& bmax = mShadowReceiverBounds.getMaximum();
+    Vector3 centre = mShadowReceiverBounds.getCenter();
+    PlaneList& planes = mShadowCasterCullVolume.planes;
+    planes.clear();
+
+    // Faces are numbered axis * 2 + side, side 1 being the maximum; the faces
+    // the light is outside of are open, the others bound the hull
+    bool facing[6];
+    for (int f = 0; f < 6; ++f)
+    {
+        int axis = f / 2;
+        Vector3 normal = Vector3::ZERO;
+        normal[axis] = (f & 1) ? 1.0f : -1.0f;
+        Real d = (f & 1) ? -bmax[axis] : bmin[axis];
+        facing[f] = normal.dotProduct(lightPos) + d * lightW > 0;
+        if (!facing[f])
+            planes.push_back(Plane(-normal, d));
+    }
+
+    // Edges between an open face and a closed one are on the silhouette, and
+    // bound the hull with the plane through them and the light
+    for (int a = 0; a < 3; ++a)
+    {
+        int b = (a + 1) % 3, c = (a + 2) % 3;
+        for (int sb = 0; sb < 2; ++sb)
+        {
+            for (int sc = 0; sc < 2; ++sc)
+            {
+                if (facing[b * 2 + sb] == facing[c * 2 + sc])
+                    continue;
+
+                Vector3 p0, p1;
+                p0[a] = bmin[a];
+                p1[a] = bmax[a];
+                p0[b] = p1[b] = sb ? bmax[b] : bmin[b];
+                p0[c] = p1[c] = sc ? bmax[c] : bmin[c];
+                Vector3 normal = (p1 - p0).crossProduct(lightPos - p0 * lightW);
+                if (normal.normalise() < 1e-6f)
+                    continue;
+                if (normal.dotProduct(centre - p0) < 0)
+                    normal = -normal;
+                planes.push_back(Plane(normal, p0));
+            }
+        }
+    }
+    mShadowCasterCullVolumeActive = true;
+}
+//---------------------------------------------------------------------
+namespace
+{
+    /// Orders shadow textures due for an update, most overdue first then by index
+    struct OverdueLess
+    {
+        bool operator()(const std::pair<unsigned long, size_t>& a,
+            const std::pair<unsigned long, size_t>& b) const
+        {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+        }
+    };
+}
+//---------------------------------------------------------------------
+void SceneManager::scheduleShadowTextureUpdates(const Camera* cam, const LightList* lightList)
+{
+    size_t count = mShadowTextures.size();
+    if (mShadowTextureUpdates.size() != count)
+    {
+        ShadowTextureUpdate never;
+        never.light = 0;
+        never.lightTextureIndex = 0;
+        never.camera = 0;
+        never.frame = 0;
+        never.scheduled = true;
+        mShadowTextureUpdates.assign(count, never);
+    }
+
+    unsigned long frame = Root::getSingleton().getNextFrameNumber();
+    // Atlas tiles are packed again every frame, so nothing can be kept
+    bool keep = mShadowAtlas.isNull();
+    size_t renamed = 0;
+    vector<std::pair<unsigned long, size_t> >::type due;
+
+    // Same assignment of textures to lights as prepareShadowTextures
+    size_t index = 0;
+    for (LightList::const_iterator i = lightList->begin(); i != lightList->end() && index < count; ++i)
+    {
+        Light* light = *i;
+        if (!light->getCastShadows())
+            continue;
+
+        size_t textureCountPerLight = mShadowTextureCountPerType[light->getType()];
+        for (size_t j = 0; j < textureCountPerLight && index < count; ++j, ++index)
+        {
+            ShadowTextureUpdate& update = mShadowTextureUpdates[index];
+            update.scheduled = false;
+            if (!keep || update.light != light || update.lightTextureIndex != j ||
+                update.camera != cam)
+            {
+                update.scheduled = true;
+                ++renamed;
+                continue;
+            }
+
+            unsigned long interval = light->getShadowUpdateInterval();
+            unsigned long age = frame - update.frame;
+            if (interval == 1 || age >= interval)
+                due.push_back(std::make_pair(age >= interval ? age - interval : 0, index));
+        }
+    }
+
+    size_t budget = due.size();
+    if (mShadowTextureUpdateBudget && keep)
+    {
+        budget = mShadowTextureUpdateBudget > renamed ? mShadowTextureUpdateBudget - renamed : 0;
+        budget = std::min(budget, due.size());
+        std::sort(due.begin(), due.end(), OverdueLess());
+    }
+    for (size_t d = 0; d < budget; ++d)
+        mShadowTextureUpdates[due[d].second].scheduled = true;
+}
+//---------------------------------------------------------------------
+void SceneManager::updateShadowTexture(size_t index, const Light* light, size_t lightTextureIndex)
+{
+    const TexturePtr& shadowTex = mShadowTextures[index];
+    RenderTarget* shadowRTT = shadowTex->getBuffer()->getRenderTarget();
+
+    if (!mShadowAtlas.isNull())
+    {
+        // Only the tile of this texture
+        shadowRTT->_beginUpdate();
+        shadowRTT->_updateViewport(getShadowTextureViewport(index));
+        shadowRTT->_endUpdate();
+        return;
+    }
+
+    if (!mStaticShadowCaching || !mStaticShadowCasterMask ||
+        !mDestRenderSystem->getCapabilities()->hasCapability(RSC_ADVANCED_BLEND_OPERATIONS))
+    {
+        shadowRTT->update();
+        return;
+    }
+
+    Viewport* shadowView = shadowRTT->getViewport(0);
+    Camera* texCam = mShadowTextureCameras[index];
+
+    if (mStaticShadowCaches.size() < mShadowTextures.size())
+    {
+        StaticShadowCache empty;
+        empty.valid = false;
+        empty.light = 0;
+        empty.lightTextureIndex = 0;
+        mStaticShadowCaches.resize(mShadowTextures.size(), empty);
+    }
+    StaticShadowCache& cache = mStaticShadowCaches[index];
+    if (cache.texture.isNull())
+    {
+        cache.texture = TextureManager::getSingleton().createManual(
+            shadowTex->getName() + "Static" + getName(),
+            ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME, TEX_TYPE_2D,
+            shadowTex->getWidth(), shadowTex->getHeight(), 0, shadowTex->getFormat(),
+            TU_RENDERTARGET);
+        cache.valid = false;
+    }
+
+    Matrix4 viewMatrix = texCam->getViewMatrix();
+    Matrix4 projMatrix = texCam->getProjectionMatrix();
+
+    // Reuse the static casters if the shadow camera sees nothing that the one
+    // they were rendered with did not
+    bool reuse = cache.valid && cache.light == light &&
+        cache.lightTextureIndex == lightTextureIndex;
+    if (reuse)
+    {
+        Matrix4 toCached = cache.projMatrix * cache.viewMatrix *
+            (projMatrix * viewMatrix).inverse();
+        for (int c = 0; c < 8 && reuse; ++c)
+        {
+            Vector4 corner = toCached * Vector4(
+                (c & 1) ? 1.0f : -1.0f, (c & 2) ? 1.0f : -1.0f, (c & 4) ? 1.0f : -1.0f, 1.0f);
+            reuse = corner.w > 0 && Math::Abs(corner.x) <= corner.w &&
+                Math::Abs(corner.y) <= corner.w && Math::Abs(corner.z) <= corner.w;
+        }
+    }
+
+    uint32 visibilityMask = shadowView->getVisibilityMask();
+    if (!reuse)
+    {
+        // Widen the shadow camera, so that it keeps fitting for a while
+        Matrix4 widen = Matrix4::getScale(Vector3(1 / (1 + mStaticShadowCacheMargin)));
+        projMatrix = widen * projMatrix;
+        if (light->getType() == Light::LT_DIRECTIONAL && projMatrix.isAffine())
+        {
+            // Move by whole texels, so the static shadows do not shimmer as the cascade scrolls
+            Real texelX = 2 / (Real)shadowTex->getWidth();
+            Real texelY = 2 / (Real)shadowTex->getHeight();
+            Vector3 origin = (projMatrix * viewMatrix) * Vector3::ZERO;
+            projMatrix = Matrix4::getTrans(
+                Math::Floor(origin.x / texelX + 0.5f) * texelX - origin.x,
+                Math::Floor(origin.y / texelY + 0.5f) * texelY - origin.y, 0) * projMatrix;
+        }
+        cache.valid = true;
+        cache.light = light;
+        cache.lightTextureIndex = lightTextureIndex;
+        cache.viewMatrix = viewMatrix;
+        cache.projMatrix = projMatrix;
+    }
+    texCam->setCustomViewMatrix(true, cache.viewMatrix);
+    texCam->setCustomProjectionMatrix(true, cache.projMatrix);
+
+    if (reuse)
+    {
+        shadowTex->getBuffer()->blit(cache.texture->getBuffer());
+    }
+    else
+    {
+        shadowView->setVisibilityMask(visibilityMask & mStaticShadowCasterMask);
+        shadowRTT->update();
+        cache.texture->getBuffer()->blit(shadowTex->getBuffer());
+    }
+
+    // Blend the dynamic casters over the static ones
+    unsigned int clearBuffers = shadowView->getClearBuffers();
+    shadowView->setVisibilityMask(visibilityMask & ~mStaticShadowCasterMask);
+    shadowView->setClearEveryFrame(true, FBT_DEPTH);
+    mShadowCasterCompositing = true;
+    shadowRTT->update();
+    mShadowCasterCompositing = false;
+    shadowView->setClearEveryFrame(true, clearBuffers);
+    shadowView->setVisibilityMask(visibilityMask);
+}
+//---------------------------------------------------------------------
 SceneManager::RenderContext* SceneManager::_pauseRendering()
 {
     RenderContext* context = new RenderContext;
@@ -6931,6 +9026,8 @@ void SceneManager::destroyMovableObject(const String& name, const String& typeNa
         MovableObjectMap::iterator mi = objectMap->map.find(name);
         if (mi != objectMap->map.end())
         {
+            if (typeName == LightFactory::FACTORY_TYPE_NAME)
+                mShadowCasterCache.erase(static_cast<Light*>(mi->second));
             factory->destroyInstance(mi->second);
             objectMap->map.erase(mi);
         }
@@ -6945,6 +9042,8 @@ void SceneManager::destroyAllMovableObjectsByType(const String& typeName)
         destroyAllCameras();
         return;
     }
+    if (typeName == LightFactory::FACTORY_TYPE_NAME)
+        mShadowCasterCache.clear();
     MovableObjectCollection* objectMap = getMovableObjectCollection(typeName);
     MovableObjectFactory* factory = 
         Root::getSingleton().getMovableObjectFactory(typeName);
@@ -7102,8 +9201,11 @@ void SceneManager::_injectRenderWithPass(Pass *pass, Renderable *rend, bool shad
     bool doLightIteration, const LightList* manualLightList)
 {
     // render something as if it came from the current queue
+    DrawCategory prevCategory = mDestRenderSystem->_getDrawCategory();
+    mDestRenderSystem->_setDrawCategory(DC_COMPOSITOR);
     const Pass *usedPass = _setPass(pass, false, shadowDerivation);
     renderSingleObject(rend, usedPass, false, doLightIteration, manualLightList);
+    mDestRenderSystem->_setDrawCategory(prevCategory);
 }
 //---------------------------------------------------------------------
 RenderSystem *SceneManager::getDestinationRenderSystem()
@@ -7304,12 +9406,35 @@ void SceneManager::bindGpuProgram(GpuProgram* prog)
     // Hash == 1 is almost impossible to achieve otherwise
     mLastLightHashGpuProgram = 1;
     mGpuParamsDirty = (uint16)GPV_ALL;
-    mDestRenderSystem->bindGpuProgram(prog);
+
+    GpuProgramType gptype = prog->getType();
+    if (isRenderStateChangeNeeded(mRenderStateCache.programs[gptype] == prog && 
+        mDestRenderSystem->isGpuProgramBound(gptype)))
+    {
+        mDestRenderSystem->bindGpuProgram(prog);
+        mRenderStateCache.programs[gptype] = prog;
+    }
+}
+//---------------------------------------------------------------------
+void SceneManager::setRedundantStateFiltering(bool filter)
+{
+    mRedundantStateFiltering = filter;
+    _invalidateRenderStateCache();
 }
 //---------------------------------------------------------------------
 void SceneManager::_markGpuParamsDirty(uint16 mask)
 {
     mGpuParamsDirty |= mask;
+    // the data behind these params changed without the data source noticing
+    mAutoParamDataSource->_invalidateVersions(mask);
+}
+//---------------------------------------------------------------------
+/// Size of the constants of a parameter set, as counted in the render statistics
+static size_t getConstantBytes(const GpuProgramParametersSharedPtr& params)
+{
+    return params->getFloatConstantList().size() * sizeof(float) +
+        params->getDoubleConstantList().size() * sizeof(double) +
+        params->getIntConstantList().size() * sizeof(int);
 }
 //---------------------------------------------------------------------
 void SceneManager::updateGpuProgramParameters(const Pass* pass)
@@ -7323,34 +9448,40 @@ void SceneManager::updateGpuProgramParameters(const Pass* pass)
         if (mGpuParamsDirty)
             pass->_updateAutoParams(mAutoParamDataSource, mGpuParamsDirty);
 
+        RenderSystem::RenderStatistics& stats = mDestRenderSystem->_getRenderStatistics();
         if (pass->hasVertexProgram())
         {
             mDestRenderSystem->bindGpuProgramParameters(GPT_VERTEX_PROGRAM, 
                 pass->getVertexProgramParameters(), mGpuParamsDirty);
+            stats.constantBytes += getConstantBytes(pass->getVertexProgramParameters());
         }
 
         if (pass->hasGeometryProgram())
         {
             mDestRenderSystem->bindGpuProgramParameters(GPT_GEOMETRY_PROGRAM,
                 pass->getGeometryProgramParameters(), mGpuParamsDirty);
+            stats.constantBytes += getConstantBytes(pass->getGeometryProgramParameters());
         }
 
         if (pass->hasFragmentProgram())
         {
             mDestRenderSystem->bindGpuProgramParameters(GPT_FRAGMENT_PROGRAM, 
                 pass->getFragmentProgramParameters(), mGpuParamsDirty);
+            stats.constantBytes += getConstantBytes(pass->getFragmentProgramParameters());
         }
 
         if (pass->hasTessellationHullProgram())
         {
             mDestRenderSystem->bindGpuProgramParameters(GPT_HULL_PROGRAM, 
                 pass->getTessellationHullProgramParameters(), mGpuParamsDirty);
+            stats.constantBytes += getConstantBytes(pass->getTessellationHullProgramParameters());
         }
 
         if (pass->hasTessellationDomainProgram())
         {
             mDestRenderSystem->bindGpuProgramParameters(GPT_DOMAIN_PROGRAM, 
                 pass->getTessellationDomainProgramParameters(), mGpuParamsDirty);
+            stats.constantBytes += getConstantBytes(pass->getTessellationDomainProgramParameters());
         }
 
                 // if (pass->hasComputeProgram())
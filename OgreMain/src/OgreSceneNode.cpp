@@ -73,6 +73,8 @@ namespace Ogre {
             MovableObject* ret = itr->second;
             ret->_notifyAttached((SceneNode*)0);
         }
+        if (mCreator && !mObjectsByName.empty())
+            mCreator->_notifyShadowCastersChanged();
         mObjectsByName.clear();
 
         OGRE_DELETE mWireBoundingBox;
@@ -88,6 +90,12 @@ namespace Ogre {
     {
         Node::setParent(parent);
 
+        if (mCreator)
+        {
+            mCreator->_notifySceneGraphChanged();
+            mCreator->_notifyShadowCastersChanged();
+        }
+
         if (parent)
         {
             SceneNode* sceneParent = static_cast<SceneNode*>(parent);
@@ -134,6 +142,8 @@ namespace Ogre {
         
         // Make sure bounds get updated (must go right to the top)
         needUpdate();
+        if (mCreator)
+            mCreator->_notifyShadowCastersChanged();
     }
     //-----------------------------------------------------------------------
     unsigned short SceneNode::numAttachedObjects(void) const
@@ -187,6 +197,8 @@ namespace Ogre {
 
             // Make sure bounds get updated (must go right to the top)
             needUpdate();
+            if (mCreator)
+                mCreator->_notifyShadowCastersChanged();
 
             return ret;
         }
@@ -210,6 +222,8 @@ namespace Ogre {
         ret->_notifyAttached((SceneNode*)0);
         // Make sure bounds get updated (must go right to the top)
         needUpdate();
+        if (mCreator)
+            mCreator->_notifyShadowCastersChanged();
         
         return ret;
 
@@ -231,6 +245,8 @@ namespace Ogre {
 
         // Make sure bounds get updated (must go right to the top)
         needUpdate();
+        if (mCreator)
+            mCreator->_notifyShadowCastersChanged();
 
     }
     //-----------------------------------------------------------------------
@@ -245,6 +261,8 @@ namespace Ogre {
         mObjectsByName.clear();
         // Make sure bounds get updated (must go right to the top)
         needUpdate();
+        if (mCreator)
+            mCreator->_notifyShadowCastersChanged();
     }
     //-----------------------------------------------------------------------
     void SceneNode::_updateBounds(void)
@@ -354,12 +372,18 @@ namespace Ogre {
         Node::updateFromParentImpl();
 
         // Notify objects that it has been moved
+        bool castersMoved = false;
         ObjectMap::const_iterator i;
         for (i = mObjectsByName.begin(); i != mObjectsByName.end(); ++i)
         {
             MovableObject* object = i->second;
             object->_notifyMoved();
+            // Shadow caster queries never return lights
+            castersMoved |= object->getTypeFlags() != SceneManager::LIGHT_TYPE_MASK;
         }
+
+        if (mCreator && castersMoved)
+            mCreator->_notifyShadowCastersChanged();
     }
     //-----------------------------------------------------------------------
     Node* SceneNode::createChildImpl(void)
@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include "OgreSceneQuery.h"
 #include "OgreException.h"
 #include "OgreSceneManager.h"
+#include "OgreEntity.h"
+#include "OgreMeshBVH.h"
 
 namespace Ogre {
 
@@ -196,6 +198,7 @@ namespace Ogre {
     {
         mSortByDistance = false;
         mMaxResults = 0;
+        mTriangleAccurate = false;
     }
     //-----------------------------------------------------------------------
     RaySceneQuery::~RaySceneQuery()
@@ -228,6 +231,40 @@ namespace Ogre {
         return mMaxResults;
     }
     //-----------------------------------------------------------------------
+    void RaySceneQuery::setTriangleAccurate(bool accurate)
+    {
+        mTriangleAccurate = accurate;
+    }
+    //-----------------------------------------------------------------------
+    bool RaySceneQuery::getTriangleAccurate(void) const
+    {
+        return mTriangleAccurate;
+    }
+    //-----------------------------------------------------------------------
+    bool RaySceneQuery::getTriangleHit(const Ray& ray, Entity* entity, RaySceneQueryResultEntry& result)
+    {
+        const MeshBVH* bvh = entity->getBVH();
+
+        // Test in the space of the entity; the direction is not normalised so the
+        // distances along both rays are the same
+        Matrix4 inv = entity->_getParentNodeFullTransform().inverseAffine();
+        Matrix3 invLinear;
+        inv.extract3x3Matrix(invLinear);
+        Ray localRay(inv.transformAffine(ray.getOrigin()), invLinear * ray.getDirection());
+        MeshBVH::Hit hit;
+        if (!bvh || !bvh->intersects(localRay, hit))
+            return false;
+
+        result.distance = hit.distance;
+        result.movable = entity;
+        result.worldFragment = NULL;
+        result.triangleHit = true;
+        result.subMesh = hit.subMesh;
+        result.triangle = hit.triangle;
+        result.barycentric = hit.barycentric;
+        return true;
+    }
+    //-----------------------------------------------------------------------
     RaySceneQueryResult& RaySceneQuery::execute(void)
     {
         // Clear without freeing the vector buffer
@@ -267,6 +304,14 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     bool RaySceneQuery::queryResult(MovableObject* obj, Real distance)
     {
+        if (mTriangleAccurate && (obj->getTypeFlags() & SceneManager::ENTITY_TYPE_MASK))
+        {
+            RaySceneQueryResultEntry dets;
+            if (getTriangleHit(mRay, static_cast<Entity*>(obj), dets))
+                mResult.push_back(dets);
+            return true;
+        }
+
         // Add to internal list
         RaySceneQueryResultEntry dets;
         dets.distance = distance;
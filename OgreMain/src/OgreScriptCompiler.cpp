@@ -1284,6 +1284,9 @@ namespace Ogre
 
         mIds["subroutine"] = ID_SUBROUTINE;
 
+        mIds["update_interval"] = ID_UPDATE_INTERVAL;
+        mIds["only_when_dirty"] = ID_ONLY_WHEN_DIRTY;
+
 		mLargestRegisteredWordId = ID_END_BUILTIN_IDS;
 	}
 
@@ -1587,6 +1590,7 @@ namespace Ogre
     //-----------------------------------------------------------------------
     ScriptCompilerManager::ScriptCompilerManager()
         :mListener(0), OGRE_THREAD_POINTER_INIT(mScriptCompiler)
+        , mSaveParsedScriptsToCache(false), mParsedScriptCacheDirty(false)
     {
             OGRE_LOCK_AUTO_MUTEX;
         mScriptPatterns.push_back("*.program");
@@ -1698,7 +1702,170 @@ namespace Ogre
                     OGRE_LOCK_AUTO_MUTEX;
             OGRE_THREAD_POINTER_GET(mScriptCompiler)->setListener(mListener);
         }
-        OGRE_THREAD_POINTER_GET(mScriptCompiler)->compile(stream->getAsString(), stream->getName(), groupName);
+        OGRE_THREAD_POINTER_GET(mScriptCompiler)->compile(
+            parseScriptNodes(stream->getAsString(), stream->getName()), groupName);
+    }
+    //-----------------------------------------------------------------------
+    ConcreteNodeListPtr ScriptCompilerManager::_parseScriptNodes(const String& script, const String& source)
+    {
+        return parseScriptNodes(script, source);
+    }
+    //-----------------------------------------------------------------------
+    ConcreteNodeListPtr ScriptCompilerManager::parseScriptNodes(const String& script, const String& source)
+    {
+        uint32 hash = FastHash(script.c_str(), static_cast<int>(script.size()));
+        {
+                    OGRE_LOCK_MUTEX(mParsedScriptCacheMutex);
+            ParsedScriptCache::const_iterator i = mParsedScriptCache.find(source);
+            if (i != mParsedScriptCache.end() && i->second.hash == hash)
+                return i->second.nodes;
+        }
+
+        ScriptLexer lexer;
+        ScriptParser parser;
+        ConcreteNodeListPtr nodes = parser.parse(lexer.tokenize(script, source));
+
+        if (mSaveParsedScriptsToCache)
+        {
+                    OGRE_LOCK_MUTEX(mParsedScriptCacheMutex);
+            ParsedScript& parsed = mParsedScriptCache[source];
+            parsed.hash = hash;
+            parsed.nodes = nodes;
+            mParsedScriptCacheDirty = true;
+        }
+        return nodes;
+    }
+    //-----------------------------------------------------------------------
+    namespace {
+        /// Bump when the layout of the saved nodes changes
+        const uint32 PARSED_SCRIPT_CACHE_VERSION = 1;
+
+        void writeString(const String& str, const DataStreamPtr& stream)
+        {
+            uint32 length = static_cast<uint32>(str.size());
+            stream->write(&length, sizeof(uint32));
+            if (length)
+                stream->write(&str[0], length);
+        }
+
+        void readString(String& str, const DataStreamPtr& stream)
+        {
+            uint32 length = 0;
+            stream->read(&length, sizeof(uint32));
+            str.resize(length);
+            if (length)
+                stream->read(&str[0], length);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::writeNodes(const ConcreteNodeList& nodes, const DataStreamPtr& stream)
+    {
+        uint32 count = static_cast<uint32>(nodes.size());
+        stream->write(&count, sizeof(uint32));
+        for (ConcreteNodeList::const_iterator i = nodes.begin(); i != nodes.end(); ++i)
+        {
+            const ConcreteNode* node = i->get();
+            writeString(node->token, stream);
+            writeString(node->file, stream);
+            uint32 line = node->line, type = node->type;
+            stream->write(&line, sizeof(uint32));
+            stream->write(&type, sizeof(uint32));
+            writeNodes(node->children, stream);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::readNodes(ConcreteNodeList& nodes, ConcreteNode* parent, const DataStreamPtr& stream)
+    {
+        uint32 count = 0;
+        stream->read(&count, sizeof(uint32));
+        for (uint32 i = 0; i < count && !stream->eof(); ++i)
+        {
+            ConcreteNodePtr node(OGRE_NEW ConcreteNode());
+            readString(node->token, stream);
+            readString(node->file, stream);
+            uint32 line = 0, type = 0;
+            stream->read(&line, sizeof(uint32));
+            stream->read(&type, sizeof(uint32));
+            node->line = line;
+            node->type = static_cast<ConcreteNodeType>(type);
+            node->parent = parent;
+            readNodes(node->children, node.get(), stream);
+            nodes.push_back(node);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::saveParsedScriptCache(DataStreamPtr stream) const
+    {
+        if (!mParsedScriptCacheDirty)
+            return;
+
+        if (!stream->isWriteable())
+        {
+            OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+                "Unable to write to stream " + stream->getName(),
+                "ScriptCompilerManager::saveParsedScriptCache");
+        }
+
+                OGRE_LOCK_MUTEX(mParsedScriptCacheMutex);
+        stream->write(&PARSED_SCRIPT_CACHE_VERSION, sizeof(uint32));
+        uint32 count = static_cast<uint32>(mParsedScriptCache.size());
+        stream->write(&count, sizeof(uint32));
+        for (ParsedScriptCache::const_iterator i = mParsedScriptCache.begin(); i != mParsedScriptCache.end(); ++i)
+        {
+            writeString(i->first, stream);
+            stream->write(&i->second.hash, sizeof(uint32));
+            writeNodes(*i->second.nodes, stream);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::loadParsedScriptCache(DataStreamPtr stream)
+    {
+                OGRE_LOCK_MUTEX(mParsedScriptCacheMutex);
+        mParsedScriptCache.clear();
+        mParsedScriptCacheDirty = false;
+
+        uint32 version = 0;
+        stream->read(&version, sizeof(uint32));
+        if (version != PARSED_SCRIPT_CACHE_VERSION)
+        {
+            LogManager::getSingleton().logMessage(
+                "Ignoring parsed script cache " + stream->getName() + " saved by another version");
+            return;
+        }
+
+        uint32 count = 0;
+        stream->read(&count, sizeof(uint32));
+        for (uint32 i = 0; i < count && !stream->eof(); ++i)
+        {
+            String source;
+            readString(source, stream);
+            ParsedScript& parsed = mParsedScriptCache[source];
+            stream->read(&parsed.hash, sizeof(uint32));
+            parsed.nodes.bind(OGRE_NEW_T(ConcreteNodeList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+            readNodes(*parsed.nodes, 0, stream);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::clearParsedScriptCache(void)
+    {
+                OGRE_LOCK_MUTEX(mParsedScriptCacheMutex);
+        mParsedScriptCache.clear();
+        mParsedScriptCacheDirty = false;
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::_compileScriptNodes(const ConcreteNodeListPtr& nodes, const String& groupName)
+    {
+#if OGRE_THREAD_SUPPORT
+        if (!OGRE_THREAD_POINTER_GET(mScriptCompiler))
+        {
+            OGRE_THREAD_POINTER_SET(mScriptCompiler, OGRE_NEW ScriptCompiler());
+        }
+#endif
+        {
+                    OGRE_LOCK_AUTO_MUTEX;
+            OGRE_THREAD_POINTER_GET(mScriptCompiler)->setListener(mListener);
+        }
+        OGRE_THREAD_POINTER_GET(mScriptCompiler)->compile(nodes, groupName);
     }
 
     //-------------------------------------------------------------------------
@@ -45,14 +45,16 @@ namespace Ogre {
         : Resource(),
         mBlendState(ANIMBLEND_AVERAGE),
         mNextAutoHandle(0),
-        mManualBonesDirty(false)
+        mManualBonesDirty(false),
+        mAnimationSampleCaching(false)
     {
     }
     //---------------------------------------------------------------------
     Skeleton::Skeleton(ResourceManager* creator, const String& name, ResourceHandle handle,
         const String& group, bool isManual, ManualResourceLoader* loader) 
         : Resource(creator, name, handle, group, isManual, loader), 
-        mBlendState(ANIMBLEND_AVERAGE), mNextAutoHandle(0)
+        mBlendState(ANIMBLEND_AVERAGE), mNextAutoHandle(0),
+        mManualBonesDirty(false), mAnimationSampleCaching(false)
         // set animation blending to weighted, not cumulative
     {
         if (createParamDictionary("Skeleton"))
@@ -105,6 +107,7 @@ namespace Ogre {
         mRootBones.clear();
         mManualBones.clear();
         mManualBonesDirty = false;
+        mAnimationSamples.clear();
 
         // Destroy animations
         AnimationList::iterator ai;
@@ -238,6 +241,9 @@ namespace Ogre {
             }
         }
 
+        for (AnimationSampleCache::iterator i = mAnimationSamples.begin(); i != mAnimationSamples.end(); ++i)
+            i->second.used = false;
+
         // Per enabled animation state
         ConstEnabledAnimationStateIterator stateIt = 
             animSet.getEnabledAnimationStateIterator();
@@ -247,7 +253,21 @@ namespace Ogre {
             const LinkedSkeletonAnimationSource* linked = 0;
             Animation* anim = _getAnimationImpl(animState->getAnimationName(), &linked);
             // tolerate state entries for animations we're not aware of
-            if (anim)
+            if (anim && mAnimationSampleCaching)
+            {
+                // Only sample again the animations which moved
+                CachedAnimationSample& cached = mAnimationSamples[animState->getAnimationName()];
+                if (cached.animation != anim || cached.sample.timePos != animState->getTimePosition())
+                {
+                    cached.animation = anim;
+                    anim->_sampleSkeleton(animState->getTimePosition(), cached.sample);
+                }
+                cached.used = true;
+                anim->_applySkeletonSample(this, cached.sample, animState->getWeight() * weightFactor,
+                    animState->hasBlendMask() ? animState->getBlendMask() : 0,
+                    linked ? linked->scale : 1.0f);
+            }
+            else if (anim)
             {
               if(animState->hasBlendMask())
               {
@@ -262,7 +282,22 @@ namespace Ogre {
             }
         }
 
-
+        // Drop the samples of the animations no longer enabled
+        AnimationSampleCache::iterator i = mAnimationSamples.begin();
+        while (i != mAnimationSamples.end())
+        {
+            if (i->second.used)
+                ++i;
+            else
+                mAnimationSamples.erase(i++);
+        }
+    }
+    //---------------------------------------------------------------------
+    void Skeleton::setAnimationSampleCaching(bool enabled)
+    {
+        mAnimationSampleCaching = enabled;
+        if (!enabled)
+            mAnimationSamples.clear();
     }
     //---------------------------------------------------------------------
     void Skeleton::setBindingPose(void)
@@ -599,11 +634,11 @@ namespace Ogre {
 
                 for (unsigned short ki = 0; ki < track->getNumKeyFrames(); ++ki)
                 {
-                    TransformKeyFrame* key = track->getNodeKeyFrame(ki);
+                    Vector3 translate, scale;
+                    track->getKeyTransform(ki, q, translate, scale);
                     of << "    -- KeyFrame " << ki << " --" << std::endl;
-                    of << "    Time index: " << key->getTime(); 
-                    of << "    Translation: " << key->getTranslate() << std::endl;
-                    q = key->getRotation();
+                    of << "    Time index: " << track->getKeyTime(ki); 
+                    of << "    Translation: " << translate << std::endl;
                     of << "    Rotation: " << q;
                     q.ToAngleAxis(angle, axis);
                     of << " = " << angle.valueRadians() << " radians around axis " << axis << std::endl;
@@ -954,21 +989,24 @@ namespace Ogre {
                     ushort numKeyFrames = srcTrack->getNumKeyFrames();
                     for (ushort k = 0; k < numKeyFrames; ++k)
                     {
-                        const TransformKeyFrame* srcKeyFrame = srcTrack->getNodeKeyFrame(k);
-                        TransformKeyFrame* dstKeyFrame = dstTrack->createNodeKeyFrame(srcKeyFrame->getTime());
+                        // Read through the track, which may be compressed
+                        Quaternion srcRotate;
+                        Vector3 srcTranslate, srcScale;
+                        srcTrack->getKeyTransform(k, srcRotate, srcTranslate, srcScale);
+                        TransformKeyFrame* dstKeyFrame = dstTrack->createNodeKeyFrame(srcTrack->getKeyTime(k));
 
                         // Adjust keyframes to match target binding pose
                         if (deltaTransform.isIdentity)
                         {
-                            dstKeyFrame->setTranslate(srcKeyFrame->getTranslate());
-                            dstKeyFrame->setRotation(srcKeyFrame->getRotation());
-                            dstKeyFrame->setScale(srcKeyFrame->getScale());
+                            dstKeyFrame->setTranslate(srcTranslate);
+                            dstKeyFrame->setRotation(srcRotate);
+                            dstKeyFrame->setScale(srcScale);
                         }
                         else
                         {
-                            dstKeyFrame->setTranslate(deltaTransform.translate + srcKeyFrame->getTranslate());
-                            dstKeyFrame->setRotation(deltaTransform.rotate * srcKeyFrame->getRotation());
-                            dstKeyFrame->setScale(deltaTransform.scale * srcKeyFrame->getScale());
+                            dstKeyFrame->setTranslate(deltaTransform.translate + srcTranslate);
+                            dstKeyFrame->setRotation(deltaTransform.rotate * srcRotate);
+                            dstKeyFrame->setScale(deltaTransform.scale * srcScale);
                         }
                     }
                 }
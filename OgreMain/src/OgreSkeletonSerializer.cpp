@@ -35,12 +35,25 @@ THE SOFTWARE.
 #include "OgreKeyFrame.h"
 #include "OgreBone.h"
 #include "OgreLogManager.h"
+#include "OgreResourceLoadTrace.h"
 
 namespace Ogre {
     /// stream overhead = ID + size
     const long SSTREAM_OVERHEAD_SIZE = sizeof(uint16) + sizeof(uint32);
     const uint16 HEADER_STREAM_ID_EXT = 0x1000;
     //---------------------------------------------------------------------
+    /// Fills a keyframe with the key at the index given, also for compressed tracks
+    static void copyKeyFrame(const NodeAnimationTrack* track, unsigned short index,
+        TransformKeyFrame& key)
+    {
+        Quaternion rotate;
+        Vector3 translate, scale;
+        track->getKeyTransform(index, rotate, translate, scale);
+        key.setRotation(rotate);
+        key.setTranslate(translate);
+        key.setScale(scale);
+    }
+    //---------------------------------------------------------------------
     SkeletonSerializer::SkeletonSerializer()
     {
         // Version number
@@ -116,6 +129,7 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void SkeletonSerializer::importSkeleton(DataStreamPtr& stream, Skeleton* pSkel)
     {
+        ResourceLoadTraceScope trace(RLP_PARSE, pSkel->getName(), stream->size());
         // Determine endianness (must be the first thing we do!)
         determineEndianness(stream);
 
@@ -165,7 +179,9 @@ namespace Ogre {
     {
         if (ver == SKELETON_VERSION_1_0)
             mVersion = "[Serializer_v1.10]";
-        else mVersion = "[Serializer_v1.80]";
+        else if (ver == SKELETON_VERSION_1_8)
+            mVersion = "[Serializer_v1.80]";
+        else mVersion = "[Serializer_v1.100]";
     }
     //---------------------------------------------------------------------
     void SkeletonSerializer::writeSkeleton(const Skeleton* pSkel, SkeletonVersion ver)
@@ -273,7 +289,7 @@ namespace Ogre {
         Animation::NodeTrackIterator trackIt = anim->getNodeTrackIterator();
         while(trackIt.hasMoreElements())
         {
-            writeAnimationTrack(pSkel, trackIt.getNext());
+            writeAnimationTrack(pSkel, trackIt.getNext(), ver);
         }
         }
         popInnerChunk(mStream);
@@ -281,19 +297,28 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     void SkeletonSerializer::writeAnimationTrack(const Skeleton* pSkel, 
-        const NodeAnimationTrack* track)
+        const NodeAnimationTrack* track, SkeletonVersion ver)
     {
-        writeChunkHeader(SKELETON_ANIMATION_TRACK, calcAnimationTrackSize(pSkel, track));
+        writeChunkHeader(SKELETON_ANIMATION_TRACK, calcAnimationTrackSize(pSkel, track, ver));
 
         // unsigned short boneIndex     : Index of bone to apply to
         Bone* bone = static_cast<Bone*>(track->getAssociatedNode());
         unsigned short boneid = bone->getHandle();
         writeShorts(&boneid, 1);
         pushInnerChunk(mStream);
-        // Write all keyframes
-        for (unsigned short i = 0; i < track->getNumKeyFrames(); ++i)
+        if (track->isCompressed() && (int)ver >= (int)SKELETON_VERSION_1_10)
+        {
+            writeCompressedKeyFrames(pSkel, track);
+        }
+        else
         {
-            writeKeyFrame(pSkel, track->getNodeKeyFrame(i));
+            // Write all keyframes, older versions get those of compressed tracks too
+            for (unsigned short i = 0; i < track->getNumKeyFrames(); ++i)
+            {
+                TransformKeyFrame key(track, track->getKeyTime(i));
+                copyKeyFrame(track, i, key);
+                writeKeyFrame(pSkel, &key);
+            }
         }
         popInnerChunk(mStream);
     }
@@ -318,6 +343,38 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void SkeletonSerializer::writeCompressedKeyFrames(const Skeleton* pSkel,
+        const NodeAnimationTrack* track)
+    {
+        writeChunkHeader(SKELETON_ANIMATION_TRACK_COMPRESSED,
+            calcCompressedKeyFramesSize(pSkel, track));
+
+        const NodeAnimationTrack::CompressedKeyFrames* keys = track->_getCompressedKeyFrames();
+        // unsigned short numKeyFrames
+        uint16 numKeyFrames = static_cast<uint16>(keys->times.size());
+        writeShorts(&numKeyFrames, 1);
+        // unsigned short flags         : 1 if translations follow, 2 if scales follow
+        uint16 flags = (keys->translates.empty() ? 0 : 1) | (keys->scales.empty() ? 0 : 2);
+        writeShorts(&flags, 1);
+        if (!numKeyFrames)
+            return;
+
+        // float times[numKeyFrames]
+        writeFloats(&keys->times[0], numKeyFrames);
+        // unsigned short rotations[numKeyFrames * 3]
+        writeShorts(&keys->rotations[0], numKeyFrames * 3);
+        // Vector3 translates[numKeyFrames]
+        for (size_t i = 0; i < keys->translates.size(); ++i)
+        {
+            writeObject(keys->translates[i]);
+        }
+        // Vector3 scales[numKeyFrames]
+        for (size_t i = 0; i < keys->scales.size(); ++i)
+        {
+            writeObject(keys->scales[i]);
+        }
+    }
+    //---------------------------------------------------------------------
     size_t SkeletonSerializer::calcBoneSize(const Skeleton* pSkel, 
         const Bone* pBone)
     {
@@ -391,29 +448,54 @@ namespace Ogre {
         Animation::NodeTrackIterator trackIt = pAnim->getNodeTrackIterator();
         while(trackIt.hasMoreElements())
         {
-            size += calcAnimationTrackSize(pSkel, trackIt.getNext());
+            size += calcAnimationTrackSize(pSkel, trackIt.getNext(), ver);
         }
 
         return size;
     }
     //---------------------------------------------------------------------
     size_t SkeletonSerializer::calcAnimationTrackSize(const Skeleton* pSkel, 
-        const NodeAnimationTrack* pTrack)
+        const NodeAnimationTrack* pTrack, SkeletonVersion ver)
     {
         size_t size = SSTREAM_OVERHEAD_SIZE;
 
         // unsigned short boneIndex     : Index of bone to apply to
         size += sizeof(unsigned short);
 
+        if (pTrack->isCompressed() && (int)ver >= (int)SKELETON_VERSION_1_10)
+        {
+            return size + calcCompressedKeyFramesSize(pSkel, pTrack);
+        }
+
         // Nested keyframes
         for (unsigned short i = 0; i < pTrack->getNumKeyFrames(); ++i)
         {
-            size += calcKeyFrameSize(pSkel, pTrack->getNodeKeyFrame(i));
+            TransformKeyFrame key(pTrack, pTrack->getKeyTime(i));
+            copyKeyFrame(pTrack, i, key);
+            size += calcKeyFrameSize(pSkel, &key);
         }
 
         return size;
     }
     //---------------------------------------------------------------------
+    size_t SkeletonSerializer::calcCompressedKeyFramesSize(const Skeleton* pSkel,
+        const NodeAnimationTrack* pTrack)
+    {
+        const NodeAnimationTrack::CompressedKeyFrames* keys = pTrack->_getCompressedKeyFrames();
+        size_t size = SSTREAM_OVERHEAD_SIZE;
+
+        // unsigned short numKeyFrames, flags
+        size += sizeof(uint16) * 2;
+        // float times[numKeyFrames]
+        size += sizeof(float) * keys->times.size();
+        // unsigned short rotations[numKeyFrames * 3]
+        size += sizeof(uint16) * keys->rotations.size();
+        // Vector3 translates, scales
+        size += sizeof(float) * 3 * (keys->translates.size() + keys->scales.size());
+
+        return size;
+    }
+    //---------------------------------------------------------------------
     size_t SkeletonSerializer::calcKeyFrameSize(const Skeleton* pSkel, 
         const TransformKeyFrame* pKey)
     {
@@ -455,7 +537,8 @@ namespace Ogre {
             // Read version
             String ver = readString(stream);
             if ((ver != "[Serializer_v1.10]") &&
-                (ver != "[Serializer_v1.80]"))
+                (ver != "[Serializer_v1.80]") &&
+                (ver != "[Serializer_v1.100]"))
             {
                 OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, 
                     "Invalid file: version incompatible, file reports " + String(ver),
@@ -596,6 +679,16 @@ namespace Ogre {
         {
             pushInnerChunk(stream);
             unsigned short streamID = readChunk(stream);
+            if (streamID == SKELETON_ANIMATION_TRACK_COMPRESSED)
+            {
+                readCompressedKeyFrames(stream, pTrack, pSkel);
+
+                if (!stream->eof())
+                {
+                    // Get next stream
+                    streamID = readChunk(stream);
+                }
+            }
             while(streamID == SKELETON_ANIMATION_TRACK_KEYFRAME && !stream->eof())
             {
                 readKeyFrame(stream, pTrack, pSkel);
@@ -643,6 +736,44 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void SkeletonSerializer::readCompressedKeyFrames(DataStreamPtr& stream,
+        NodeAnimationTrack* track, Skeleton* pSkel)
+    {
+        NodeAnimationTrack::CompressedKeyFrames keys;
+        // unsigned short numKeyFrames
+        uint16 numKeyFrames;
+        readShorts(stream, &numKeyFrames, 1);
+        // unsigned short flags         : 1 if translations follow, 2 if scales follow
+        uint16 flags;
+        readShorts(stream, &flags, 1);
+
+        if (numKeyFrames)
+        {
+            // float times[numKeyFrames]
+            keys.times.resize(numKeyFrames);
+            readFloats(stream, &keys.times[0], numKeyFrames);
+            // unsigned short rotations[numKeyFrames * 3]
+            keys.rotations.resize(numKeyFrames * 3);
+            readShorts(stream, &keys.rotations[0], numKeyFrames * 3);
+            // Vector3 translates[numKeyFrames]
+            if (flags & 1)
+            {
+                keys.translates.resize(numKeyFrames);
+                for (uint16 i = 0; i < numKeyFrames; ++i)
+                    readObject(stream, keys.translates[i]);
+            }
+            // Vector3 scales[numKeyFrames]
+            if (flags & 2)
+            {
+                keys.scales.resize(numKeyFrames);
+                for (uint16 i = 0; i < numKeyFrames; ++i)
+                    readObject(stream, keys.scales[i]);
+            }
+        }
+
+        track->_setCompressedKeyFrames(keys);
+    }
+    //---------------------------------------------------------------------
     void SkeletonSerializer::writeSkeletonAnimationLink(const Skeleton* pSkel, 
         const LinkedSkeletonAnimationSource& link)
     {
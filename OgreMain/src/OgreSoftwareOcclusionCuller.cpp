@@ -0,0 +1,501 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreSoftwareOcclusionCuller.h"
+#include "OgreEntity.h"
+#include "OgreSubMesh.h"
+#include "OgreCamera.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
+#include "OgreException.h"
+#include "OgreStringConverter.h"
+
+namespace Ogre {
+    namespace
+    {
+        /// Rasterises bands of rows of the depth buffer
+        class OcclusionRasteriseTask : public WorkQueue::ParallelTask
+        {
+        public:
+            OcclusionRasteriseTask(SoftwareOcclusionCuller* culler, uint32 rowsPerBand, uint32 height)
+                : mCuller(culler), mRowsPerBand(rowsPerBand), mHeight(height) {}
+
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t band = begin; band < end; ++band)
+                {
+                    uint32 beginRow = static_cast<uint32>(band) * mRowsPerBand;
+                    mCuller->_rasteriseRows(beginRow, std::min(beginRow + mRowsPerBand, mHeight));
+                }
+            }
+        private:
+            SoftwareOcclusionCuller* mCuller;
+            uint32 mRowsPerBand;
+            uint32 mHeight;
+        };
+
+        const uint32 OCCLUSION_ROWS_PER_BAND = 8;
+    }
+    //---------------------------------------------------------------------
+    SoftwareOcclusionCuller::SoftwareOcclusionCuller(uint32 width, uint32 height)
+        : mWidth(0), mHeight(0), mCamera(0), mFrameNumber(0), mFlipWinding(false)
+    {
+        setResolution(width, height);
+    }
+    //---------------------------------------------------------------------
+    SoftwareOcclusionCuller::~SoftwareOcclusionCuller()
+    {
+        removeAllOccluders();
+    }
+    //---------------------------------------------------------------------
+    void SoftwareOcclusionCuller::setResolution(uint32 width, uint32 height)
+    {
+        if (!width || !height)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "The depth buffer can't be empty",
+                "SoftwareOcclusionCuller::setResolution");
+        }
+        mWidth = width;
+        mHeight = height;
+
+        // Each level halves the previous one, rounding up, down to a single pixel
+        mLevels.clear();
+        while (true)
+        {
+            Level level;
+            level.width = width;
+            level.height = height;
+            level.depths.resize(width * height, 1.0f);
+            mLevels.push_back(level);
+            if (width == 1 && height == 1)
+                break;
+            width = (width + 1) / 2;
+            height = (height + 1) / 2;
+        }
+        mCamera = 0;
+    }
+    //---------------------------------------------------------------------
+    void SoftwareOcclusionCuller::addOccluder(MovableObject* object, const MeshPtr& mesh)
+    {
+        MeshPtr occluderMesh = mesh;
+        ushort lod = 0;
+        if (occluderMesh.isNull())
+        {
+            Entity* entity = dynamic_cast<Entity*>(object);
+            if (!entity)
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Occluder '" + object->getName() +
+                    "' needs a mesh, since it isn't an entity",
+                    "SoftwareOcclusionCuller::addOccluder");
+            }
+            // The coarsest LOD is the cheapest to rasterise
+            occluderMesh = entity->getMesh();
+            lod = occluderMesh->getNumLodLevels() - 1;
+            if (lod > 0 && occluderMesh->hasManualLodLevel())
+            {
+                const MeshLodUsage& usage = occluderMesh->getLodLevel(lod);
+                if (!usage.manualMesh.isNull())
+                    occluderMesh = usage.manualMesh;
+                lod = 0;
+            }
+        }
+        occluderMesh->load();
+
+        String key = occluderMesh->getName() + "#" + StringConverter::toString(lod);
+        OccluderGeometryMap::iterator i = mGeometries.find(key);
+        if (i == mGeometries.end())
+            i = mGeometries.insert(OccluderGeometryMap::value_type(key, createGeometry(occluderMesh, lod))).first;
+
+        removeOccluder(object);
+        Occluder occluder;
+        occluder.object = object;
+        occluder.geometry = i->second;
+        mOccluders.push_back(occluder);
+    }
+    //---------------------------------------------------------------------
+    void SoftwareOcclusionCuller::removeOccluder(MovableObject* object)
+    {
+        for (OccluderList::iterator i = mOccluders.begin(); i != mOccluders.end(); ++i)
+        {
+            if (i->object == object)
+            {
+                mOccluders.erase(i);
+                return;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void SoftwareOcclusionCuller::removeAllOccluders(void)
+    {
+        mOccluders.clear();
+        for (OccluderGeometryMap::iterator i = mGeometries.begin(); i != mGeometries.end(); ++i)
+        {
+            OGRE_DELETE_T(i->second, OccluderGeometry, MEMCATEGORY_SCENE_CONTROL);
+        }
+        mGeometries.clear();
+        mCamera = 0;
+    }
+    //---------------------------------------------------------------------
+    SoftwareOcclusionCuller::OccluderGeometry* SoftwareOcclusionCuller::createGeometry(
+        const MeshPtr& mesh, ushort lod)
+    {
+        OccluderGeometry* geom = OGRE_NEW_T(OccluderGeometry, MEMCATEGORY_SCENE_CONTROL)();
+        map<const VertexData*, uint32>::type vertexStarts;
+
+        for (ushort s = 0; s < mesh->getNumSubMeshes(); ++s)
+        {
+            SubMesh* sm = mesh->getSubMesh(s);
+            if (sm->operationType != RenderOperation::OT_TRIANGLE_LIST)
+                continue;
+            const VertexData* vdata = sm->useSharedVertices ? mesh->sharedVertexData : sm->vertexData;
+            const IndexData* idata = lod == 0 ? sm->indexData : sm->mLodFaceList[lod - 1];
+            if (!vdata || !idata || !idata->indexCount)
+                continue;
+
+            // Copy the positions of each vertex data once
+            uint32 vertexStart;
+            map<const VertexData*, uint32>::type::iterator vi = vertexStarts.find(vdata);
+            if (vi != vertexStarts.end())
+            {
+                vertexStart = vi->second;
+            }
+            else
+            {
+                vertexStart = static_cast<uint32>(geom->positions.size());
+                vertexStarts[vdata] = vertexStart;
+
+                const VertexElement* posElem =
+                    vdata->vertexDeclaration->findElementBySemantic(VES_POSITION);
+                HardwareVertexBufferSharedPtr vbuf =
+                    vdata->vertexBufferBinding->getBuffer(posElem->getSource());
+                unsigned char* pVertex = static_cast<unsigned char*>(
+                    vbuf->lock(HardwareBuffer::HBL_READ_ONLY));
+                pVertex += vdata->vertexStart * vbuf->getVertexSize();
+                for (size_t v = 0; v < vdata->vertexCount; ++v)
+                {
+                    float* pReal;
+                    posElem->baseVertexPointerToElement(pVertex, &pReal);
+                    Vector3 pos(pReal[0], pReal[1], pReal[2]);
+                    geom->positions.push_back(pos);
+                    geom->bounds.merge(pos);
+                    pVertex += vbuf->getVertexSize();
+                }
+                vbuf->unlock();
+            }
+
+            HardwareIndexBufferSharedPtr ibuf = idata->indexBuffer;
+            bool use32 = ibuf->getType() == HardwareIndexBuffer::IT_32BIT;
+            const void* pIndex = ibuf->lock(idata->indexStart * ibuf->getIndexSize(),
+                idata->indexCount * ibuf->getIndexSize(), HardwareBuffer::HBL_READ_ONLY);
+            for (size_t n = 0; n < idata->indexCount; ++n)
+            {
+                uint32 index = use32 ? static_cast<const uint32*>(pIndex)[n] :
+                    static_cast<const uint16*>(pIndex)[n];
+                geom->indices.push_back(vertexStart + index);
+            }
+            ibuf->unlock();
+        }
+
+        return geom;
+    }
+    //---------------------------------------------------------------------
+    void SoftwareOcclusionCuller::update(const Camera* cam)
+    {
+        mCamera = cam;
+        mFrameNumber = Root::getSingleton().getNextFrameNumber();
+        mViewProj = cam->getProjectionMatrix() * cam->getViewMatrix();
+        mFlipWinding = cam->isReflected();
+
+        // Set up the triangles of the occluders in view
+        mTriangles.clear();
+        for (OccluderList::const_iterator i = mOccluders.begin(); i != mOccluders.end(); ++i)
+        {
+            MovableObject* object = i->object;
+            if (!object->isInScene() || !object->isVisible())
+                continue;
+
+            const Matrix4& world = object->_getParentNodeFullTransform();
+            AxisAlignedBox bounds = i->geometry->bounds;
+            bounds.transformAffine(world);
+            if (!cam->isVisible(bounds))
+                continue;
+
+            addTriangles(*i->geometry, mViewProj * world);
+        }
+
+        Level& target = mLevels[0];
+        std::fill(target.depths.begin(), target.depths.end(), 1.0f);
+        if (!mTriangles.empty())
+        {
+            uint32 numBands = (mHeight + OCCLUSION_ROWS_PER_BAND - 1) / OCCLUSION_ROWS_PER_BAND;
+            OcclusionRasteriseTask task(this, OCCLUSION_ROWS_PER_BAND, mHeight);
+            Root::getSingleton().getWorkQueue()->parallelFor(numBands, 1, &task);
+        }
+
+        buildLevels();
+    }
+    //---------------------------------------------------------------------
+    void SoftwareOcclusionCuller::addTriangles(const OccluderGeometry& geom, const Matrix4& worldViewProj)
+    {
+        mClipPositions.resize(geom.positions.size());
+        for (size_t v = 0; v < geom.positions.size(); ++v)
+        {
+            mClipPositions[v] = worldViewProj * Vector4(geom.positions[v]);
+        }
+
+        for (size_t n = 0; n + 2 < geom.indices.size(); n += 3)
+        {
+            Vector4 clip[3] = {
+                mClipPositions[geom.indices[n]],
+                mClipPositions[geom.indices[n + 1]],
+                mClipPositions[geom.indices[n + 2]] };
+
+            // Clip against the near plane, z >= -w, which gives up to 2 triangles
+            Real d[3];
+            int numInside = 0;
+            for (int k = 0; k < 3; ++k)
+            {
+                d[k] = clip[k].z + clip[k].w;
+                if (d[k] >= 0)
+                    ++numInside;
+            }
+            if (numInside == 3)
+            {
+                addClippedTriangle(clip);
+            }
+            else if (numInside > 0)
+            {
+                Vector4 poly[4];
+                int numPoly = 0;
+                for (int k = 0; k < 3; ++k)
+                {
+                    int next = (k + 1) % 3;
+                    if (d[k] >= 0)
+                        poly[numPoly++] = clip[k];
+                    if ((d[k] >= 0) != (d[next] >= 0))
+                    {
+                        Real t = d[k] / (d[k] - d[next]);
+                        poly[numPoly++] = clip[k] + (clip[next] - clip[k]) * t;
+                    }
+                }
+                addClippedTriangle(poly);
+                if (numPoly == 4)
+                {
+                    Vector4 second[3] = { poly[0], poly[2], poly[3] };
+                    addClippedTriangle(second);
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void SoftwareOcclusionCuller::addClippedTriangle(const Vector4* clip)
+    {
+        Triangle tri;
+        for (int k = 0; k < 3; ++k)
+        {
+            // Clipping leaves w > 0 apart from the degenerate case of a vertex
+            // on the camera plane
+            if (clip[k].w <= 1e-6f)
+                return;
+            Real invW = 1 / clip[k].w;
+            tri.x[k] = static_cast<float>((clip[k].x * invW * 0.5f + 0.5f) * mWidth);
+            tri.y[k] = static_cast<float>((0.5f - clip[k].y * invW * 0.5f) * mHeight);
+            tri.z[k] = static_cast<float>(clip[k].z * invW);
+        }
+
+        // Front faces are anticlockwise in view, which is clockwise once y points
+        // down the depth buffer. Keep them, ordered so that their area is positive
+        float area = (tri.x[1] - tri.x[0]) * (tri.y[2] - tri.y[0]) -
+            (tri.x[2] - tri.x[0]) * (tri.y[1] - tri.y[0]);
+        if (mFlipWinding)
+            area = -area;
+        if (area >= 0)
+            return;
+        if (!mFlipWinding)
+        {
+            std::swap(tri.x[1], tri.x[2]);
+            std::swap(tri.y[1], tri.y[2]);
+            std::swap(tri.z[1], tri.z[2]);
+        }
+
+        // Entirely off screen
+        float minX = std::min(tri.x[0], std::min(tri.x[1], tri.x[2]));
+        float maxX = std::max(tri.x[0], std::max(tri.x[1], tri.x[2]));
+        float minY = std::min(tri.y[0], std::min(tri.y[1], tri.y[2]));
+        float maxY = std::max(tri.y[0], std::max(tri.y[1], tri.y[2]));
+        if (maxX < 0 || maxY < 0 || minX > mWidth || minY > mHeight)
+            return;
+
+        mTriangles.push_back(tri);
+    }
+    //---------------------------------------------------------------------
+    void SoftwareOcclusionCuller::_rasteriseRows(uint32 beginRow, uint32 endRow)
+    {
+        float* depths = &mLevels[0].depths[0];
+        const int width = static_cast<int>(mWidth);
+
+        for (TriangleList::const_iterator t = mTriangles.begin(); t != mTriangles.end(); ++t)
+        {
+            const float* x = t->x;
+            const float* y = t->y;
+            const float* z = t->z;
+
+            // Rows and columns whose pixel centres may be covered
+            float minY = std::min(y[0], std::min(y[1], y[2]));
+            float maxY = std::max(y[0], std::max(y[1], y[2]));
+            int rowStart = std::max(static_cast<int>(beginRow), static_cast<int>(std::ceil(minY - 0.5f)));
+            int rowEnd = std::min(static_cast<int>(endRow), static_cast<int>(std::ceil(maxY - 0.5f)));
+            if (rowStart >= rowEnd)
+                continue;
+            float minX = std::min(x[0], std::min(x[1], x[2]));
+            float maxX = std::max(x[0], std::max(x[1], x[2]));
+            int colStart = std::max(0, static_cast<int>(std::ceil(minX - 0.5f)));
+            int colEnd = std::min(width, static_cast<int>(std::ceil(maxX - 0.5f)));
+            if (colStart >= colEnd)
+                continue;
+
+            // Edge functions, each weighting the vertex opposite its edge, and
+            // the depth plane over the triangle
+            float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+            float invArea = 1.0f / area;
+            float dzdx = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) * invArea;
+            float dzdy = ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) * invArea;
+
+            float px0 = colStart + 0.5f;
+            for (int row = rowStart; row < rowEnd; ++row)
+            {
+                float py = row + 0.5f;
+                float e0 = (x[2] - x[1]) * (py - y[1]) - (y[2] - y[1]) * (px0 - x[1]);
+                float e1 = (x[0] - x[2]) * (py - y[2]) - (y[0] - y[2]) * (px0 - x[2]);
+                float e2 = (x[1] - x[0]) * (py - y[0]) - (y[1] - y[0]) * (px0 - x[0]);
+                const float s0 = -(y[2] - y[1]), s1 = -(y[0] - y[2]), s2 = -(y[1] - y[0]);
+                float depth = z[0] + dzdx * (px0 - x[0]) + dzdy * (py - y[0]);
+
+                float* rowDepths = depths + row * width;
+                for (int col = colStart; col < colEnd; ++col)
+                {
+                    if (e0 >= 0 && e1 >= 0 && e2 >= 0 && depth < rowDepths[col])
+                        rowDepths[col] = depth;
+                    e0 += s0;
+                    e1 += s1;
+                    e2 += s2;
+                    depth += dzdx;
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void SoftwareOcclusionCuller::buildLevels(void)
+    {
+        for (size_t l = 1; l < mLevels.size(); ++l)
+        {
+            const Level& src = mLevels[l - 1];
+            Level& dst = mLevels[l];
+            for (uint32 y = 0; y < dst.height; ++y)
+            {
+                uint32 y0 = y * 2, y1 = std::min(y * 2 + 1, src.height - 1);
+                for (uint32 x = 0; x < dst.width; ++x)
+                {
+                    uint32 x0 = x * 2, x1 = std::min(x * 2 + 1, src.width - 1);
+                    dst.depths[y * dst.width + x] = std::max(
+                        std::max(src.depths[y0 * src.width + x0], src.depths[y0 * src.width + x1]),
+                        std::max(src.depths[y1 * src.width + x0], src.depths[y1 * src.width + x1]));
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    bool SoftwareOcclusionCuller::isOccluded(const AxisAlignedBox& box, const Camera* cam) const
+    {
+        if (!box.isFinite() || !isUpToDate(cam))
+            return false;
+
+        // Screen rectangle and nearest depth of the box
+        const Vector3* corners = box.getAllCorners();
+        float minX = Math::POS_INFINITY, maxX = Math::NEG_INFINITY;
+        float minY = Math::POS_INFINITY, maxY = Math::NEG_INFINITY;
+        float minZ = Math::POS_INFINITY;
+        for (int k = 0; k < 8; ++k)
+        {
+            Vector4 clip = mViewProj * Vector4(corners[k]);
+            // Crossing the near plane, so at least partly in front of everything
+            if (clip.w <= 1e-6f || clip.z < -clip.w)
+                return false;
+            Real invW = 1 / clip.w;
+            float x = static_cast<float>((clip.x * invW * 0.5f + 0.5f) * mWidth);
+            float y = static_cast<float>((0.5f - clip.y * invW * 0.5f) * mHeight);
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+            minZ = std::min(minZ, static_cast<float>(clip.z * invW));
+        }
+
+        int x0 = std::max(0, static_cast<int>(std::floor(minX)));
+        int x1 = std::min(static_cast<int>(mWidth) - 1, static_cast<int>(std::floor(maxX)));
+        int y0 = std::max(0, static_cast<int>(std::floor(minY)));
+        int y1 = std::min(static_cast<int>(mHeight) - 1, static_cast<int>(std::floor(maxY)));
+        if (x0 > x1 || y0 > y1)
+            return false;
+
+        // Coarsest level at which the rectangle spans at most 4x4 pixels
+        size_t level = 0;
+        while (level + 1 < mLevels.size() &&
+            ((x1 >> level) - (x0 >> level) > 3 || (y1 >> level) - (y0 >> level) > 3))
+        {
+            ++level;
+        }
+
+        const Level& l = mLevels[level];
+        for (int y = y0 >> level; y <= (y1 >> level); ++y)
+        {
+            const float* row = &l.depths[y * l.width];
+            for (int x = x0 >> level; x <= (x1 >> level); ++x)
+            {
+                if (row[x] >= minZ)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+    //---------------------------------------------------------------------
+    bool SoftwareOcclusionCuller::isUpToDate(const Camera* cam) const
+    {
+        return cam == mCamera && !mTriangles.empty() &&
+            mFrameNumber == Root::getSingleton().getNextFrameNumber();
+    }
+    //---------------------------------------------------------------------
+    const float* SoftwareOcclusionCuller::getDepthLevel(size_t level, uint32& width, uint32& height) const
+    {
+        assert(level < mLevels.size());
+        width = mLevels[level].width;
+        height = mLevels[level].height;
+        return &mLevels[level].depths[0];
+    }
+}
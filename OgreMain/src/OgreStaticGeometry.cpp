@@ -43,6 +43,9 @@ THE SOFTWARE.
 #include "OgreTechnique.h"
 #include "OgreLodStrategy.h"
 #include "OgreIteratorWrappers.h"
+#include "OgreOptimisedUtil.h"
+#include "OgreWorkQueue.h"
+#include "OgreGpuDrawCuller.h"
 
 namespace Ogre {
 
@@ -65,7 +68,9 @@ namespace Ogre {
         mVisible(true),
         mRenderQueueID(RENDER_QUEUE_MAIN),
         mRenderQueueIDSet(false),
-        mVisibilityFlags(Ogre::MovableObject::getDefaultVisibilityFlags())
+        mVisibilityFlags(Ogre::MovableObject::getDefaultVisibilityFlags()),
+        mSubRangeCulling(false),
+        mGpuCulling(false)
     {
     }
     //--------------------------------------------------------------------------
@@ -252,32 +257,39 @@ namespace Ogre {
             static_cast<unsigned char*>(
                 vbuf->lock(HardwareBuffer::HBL_READ_ONLY));
         float* pFloat;
+        size_t vertexSize = vbuf->getVertexSize();
 
         Vector3 min = Vector3::ZERO, max = Vector3::UNIT_SCALE;
         bool first = true;
 
-        for(size_t j = 0; j < vertexData->vertexCount; ++j, vertex += vbuf->getVertexSize())
+        // Transform to world (scale, rotate, translate) a batch at a time
+        Matrix4 xform;
+        xform.makeTransform(position, scale, orientation);
+        const size_t batchSize = 256;
+        float transformed[batchSize * 3];
+
+        for(size_t j = 0; j < vertexData->vertexCount; j += batchSize)
         {
+            size_t count = std::min(batchSize, vertexData->vertexCount - j);
             posElem->baseVertexPointerToElement(vertex, &pFloat);
+            OptimisedUtil::getImplementation()->transformPoints(xform,
+                pFloat, transformed, vertexSize, 3 * sizeof(float), count);
+            vertex += count * vertexSize;
 
-            Vector3 pt;
-
-            pt.x = (*pFloat++);
-            pt.y = (*pFloat++);
-            pt.z = (*pFloat++);
-            // Transform to world (scale, rotate, translate)
-            pt = (orientation * (pt * scale)) + position;
-            if (first)
-            {
-                min = max = pt;
-                first = false;
-            }
-            else
+            for (size_t k = 0; k < count; ++k)
             {
-                min.makeFloor(pt);
-                max.makeCeil(pt);
+                Vector3 pt(transformed[k * 3 + 0], transformed[k * 3 + 1], transformed[k * 3 + 2]);
+                if (first)
+                {
+                    min = max = pt;
+                    first = false;
+                }
+                else
+                {
+                    min.makeFloor(pt);
+                    max.makeCeil(pt);
+                }
             }
-
         }
         vbuf->unlock();
         return AxisAlignedBox(min, max);
@@ -546,6 +558,28 @@ namespace Ogre {
         }
     }
     //--------------------------------------------------------------------------
+    namespace
+    {
+        /// Fills the locked buffers of a range of geometry buckets
+        class GeometryBucketFillTask : public WorkQueue::ParallelTask
+        {
+        public:
+            GeometryBucketFillTask(StaticGeometry::GeometryBucket** buckets,
+                const StaticGeometry::BufferLockMap& sourceLocks, bool keepSubRanges)
+                : mBuckets(buckets), mSourceLocks(sourceLocks), mKeepSubRanges(keepSubRanges) {}
+
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                    mBuckets[i]->_fillBuffers(mSourceLocks, mKeepSubRanges);
+            }
+        private:
+            StaticGeometry::GeometryBucket** mBuckets;
+            const StaticGeometry::BufferLockMap& mSourceLocks;
+            bool mKeepSubRanges;
+        };
+    }
+    //--------------------------------------------------------------------------
     void StaticGeometry::build(void)
     {
         // Make sure there's nothing from previous builds
@@ -565,7 +599,9 @@ namespace Ogre {
             stencilShadows = true;
         }
 
-        // Now tell each region to build itself
+        // Now tell each region to build itself, which creates and locks the
+        // buffers of every geometry bucket
+        vector<GeometryBucket*>::type buckets;
         for (RegionMap::iterator ri = mRegionMap.begin();
             ri != mRegionMap.end(); ++ri)
         {
@@ -573,6 +609,44 @@ namespace Ogre {
             
             // Set the visibility flags on these regions
             ri->second->setVisibilityFlags(mVisibilityFlags);
+
+            Region::LODIterator li = ri->second->getLODIterator();
+            while (li.hasMoreElements())
+            {
+                LODBucket::MaterialIterator mi = li.getNext()->getMaterialIterator();
+                while (mi.hasMoreElements())
+                {
+                    MaterialBucket::GeometryIterator gi = mi.getNext()->getGeometryIterator();
+                    while (gi.hasMoreElements())
+                        buckets.push_back(gi.getNext());
+                }
+            }
+        }
+
+        if (!buckets.empty())
+        {
+            // Buffers are only locked and unlocked on this thread, the copying
+            // and transforming in between is spread over the workers
+            BufferLockMap sourceLocks;
+            for (size_t i = 0; i < buckets.size(); ++i)
+                buckets[i]->_lockSourceBuffers(sourceLocks);
+
+            // Pick the OptimisedUtil implementation here rather than racing on it
+            OptimisedUtil::getImplementation();
+
+            GeometryBucketFillTask task(&buckets[0], sourceLocks, mSubRangeCulling || mGpuCulling);
+            Root::getSingleton().getWorkQueue()->parallelFor(buckets.size(), 1, &task);
+
+            for (BufferLockMap::iterator li = sourceLocks.begin(); li != sourceLocks.end(); ++li)
+                li->first->unlock();
+            for (size_t i = 0; i < buckets.size(); ++i)
+                buckets[i]->_finishBuild(stencilShadows);
+        }
+
+        for (RegionMap::iterator ri = mRegionMap.begin();
+            ri != mRegionMap.end(); ++ri)
+        {
+            ri->second->_finishBuild(stencilShadows);
         }
 
     }
@@ -832,6 +906,14 @@ namespace Ogre {
 
 
 
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::Region::_finishBuild(bool stencilShadows)
+    {
+        for (LODBucketList::iterator i = mLodBucketList.begin(); i != mLodBucketList.end(); ++i)
+        {
+            (*i)->_finishBuild(stencilShadows);
+        }
     }
     //--------------------------------------------------------------------------
     const String& StaticGeometry::Region::getMovableType(void) const
@@ -1104,58 +1186,60 @@ namespace Ogre {
     //--------------------------------------------------------------------------
     void StaticGeometry::LODBucket::build(bool stencilShadows)
     {
+        // Just pass this on to child buckets
+        for (MaterialBucketMap::iterator i = mMaterialBucketMap.begin();
+            i != mMaterialBucketMap.end(); ++i)
+        {
+            i->second->build(stencilShadows);
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::LODBucket::_finishBuild(bool stencilShadows)
+    {
+        if (!stencilShadows)
+            return;
 
         EdgeListBuilder eb;
         size_t vertexSet = 0;
 
-        // Just pass this on to child buckets
         for (MaterialBucketMap::iterator i = mMaterialBucketMap.begin();
             i != mMaterialBucketMap.end(); ++i)
         {
             MaterialBucket* mat = i->second;
 
-            mat->build(stencilShadows);
-
-            if (stencilShadows)
+            MaterialBucket::GeometryIterator geomIt =
+                mat->getGeometryIterator();
+            // Check if we have vertex programs here
+            Technique* t = mat->getMaterial()->getBestTechnique();
+            if (t)
             {
-                MaterialBucket::GeometryIterator geomIt =
-                    mat->getGeometryIterator();
-                // Check if we have vertex programs here
-                Technique* t = mat->getMaterial()->getBestTechnique();
-                if (t)
+                Pass* p = t->getPass(0);
+                if (p)
                 {
-                    Pass* p = t->getPass(0);
-                    if (p)
+                    if (p->hasVertexProgram())
                     {
-                        if (p->hasVertexProgram())
-                        {
-                            mVertexProgramInUse = true;
-                        }
+                        mVertexProgramInUse = true;
                     }
                 }
+            }
 
-                while (geomIt.hasMoreElements())
-                {
-                    GeometryBucket* geom = geomIt.getNext();
-
-                    // Check we're dealing with 16-bit indexes here
-                    // Since stencil shadows can only deal with 16-bit
-                    // More than that and stencil is probably too CPU-heavy
-                    // in any case
-                    assert(geom->getIndexData()->indexBuffer->getType()
-                        == HardwareIndexBuffer::IT_16BIT &&
-                        "Only 16-bit indexes allowed when using stencil shadows");
-                    eb.addVertexData(geom->getVertexData());
-                    eb.addIndexData(geom->getIndexData(), vertexSet++);
-                }
-
+            while (geomIt.hasMoreElements())
+            {
+                GeometryBucket* geom = geomIt.getNext();
+
+                // Check we're dealing with 16-bit indexes here
+                // Since stencil shadows can only deal with 16-bit
+                // More than that and stencil is probably too CPU-heavy
+                // in any case
+                assert(geom->getIndexData()->indexBuffer->getType()
+                    == HardwareIndexBuffer::IT_16BIT &&
+                    "Only 16-bit indexes allowed when using stencil shadows");
+                eb.addVertexData(geom->getVertexData());
+                eb.addIndexData(geom->getIndexData(), vertexSet++);
             }
         }
 
-        if (stencilShadows)
-        {
-            mEdgeList = eb.build();
-        }
+        mEdgeList = eb.build();
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::LODBucket::addRenderables(RenderQueue* queue,
@@ -1353,7 +1437,8 @@ namespace Ogre {
         iend =  mGeometryBucketList.end();
         for (i = mGeometryBucketList.begin(); i != iend; ++i)
         {
-            queue->addRenderable(*i, group);
+            if ((*i)->_updateVisibleRanges(region->mCamera))
+                queue->addRenderable(*i, group);
         }
 
     }
@@ -1425,7 +1510,8 @@ namespace Ogre {
     StaticGeometry::GeometryBucket::GeometryBucket(MaterialBucket* parent,
         const String& formatString, const VertexData* vData,
         const IndexData* iData)
-        : Renderable(), mParent(parent), mFormatString(formatString)
+        : Renderable(), mParent(parent), mFormatString(formatString),
+        mDestIndexLock(0), mVisibleIndexData(0), mGpuCuller(0), mGpuCullerTransformVersion(0)
     {
         // Clone the structure from the example
         mVertexData = vData->clone(false);
@@ -1476,6 +1562,8 @@ namespace Ogre {
     {
         OGRE_DELETE mVertexData;
         OGRE_DELETE mIndexData;
+        OGRE_DELETE mVisibleIndexData;
+        OGRE_DELETE mGpuCuller;
     }
     //--------------------------------------------------------------------------
     const MaterialPtr& StaticGeometry::GeometryBucket::getMaterial(void) const
@@ -1490,11 +1578,14 @@ namespace Ogre {
     //--------------------------------------------------------------------------
     void StaticGeometry::GeometryBucket::getRenderOperation(RenderOperation& op)
     {
-        op.indexData = mIndexData;
+        op.indexData = mVisibleIndexData && !mGpuCuller ? mVisibleIndexData : mIndexData;
         op.operationType = RenderOperation::OT_TRIANGLE_LIST;
         op.srcRenderable = this;
         op.useIndexes = true;
         op.vertexData = mVertexData;
+        op.indirectCommands = mVisibleDraws.empty() ? 0 : &mVisibleDraws[0];
+        op.numIndirectCommands = mVisibleDraws.size();
+        op.gpuDrawCuller = mGpuCuller;
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::GeometryBucket::getWorldTransforms(Matrix4* xform) const
@@ -1543,8 +1634,8 @@ namespace Ogre {
     //--------------------------------------------------------------------------
     void StaticGeometry::GeometryBucket::build(bool stencilShadows)
     {
-        // Ok, here's where we transfer the vertices and indexes to the shared
-        // buffers
+        // Ok, here's where we create the shared buffers the vertices and
+        // indexes are transferred to
         // Shortcuts
         VertexDeclaration* dcl = mVertexData->vertexDeclaration;
         VertexBufferBinding* binds = mVertexData->vertexBufferBinding;
@@ -1553,24 +1644,13 @@ namespace Ogre {
         mIndexData->indexBuffer = HardwareBufferManager::getSingleton()
             .createIndexBuffer(mIndexType, mIndexData->indexCount,
                 HardwareBuffer::HBU_STATIC_WRITE_ONLY);
-        uint32* p32Dest = 0;
-        uint16* p16Dest = 0;
-        if (mIndexType == HardwareIndexBuffer::IT_32BIT)
-        {
-            p32Dest = static_cast<uint32*>(
-                mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
-        }
-        else
-        {
-            p16Dest = static_cast<uint16*>(
-                mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
-        }
+        mDestIndexLock = mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD);
+
         // create all vertex buffers, and lock
         ushort b;
         ushort posBufferIdx = dcl->findElementBySemantic(VES_POSITION)->getSource();
 
-        vector<uchar*>::type destBufferLocks;
-        vector<VertexDeclaration::VertexElementList>::type bufferElements;
+        mDestBufferLocks.clear();
         for (b = 0; b < binds->getBufferCount(); ++b)
         {
             size_t vertexCount = mVertexData->vertexCount;
@@ -1591,14 +1671,61 @@ namespace Ogre {
             binds->setBinding(b, vbuf);
             uchar* pLock = static_cast<uchar*>(
                 vbuf->lock(HardwareBuffer::HBL_DISCARD));
-            destBufferLocks.push_back(pLock);
+            mDestBufferLocks.push_back(pLock);
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::GeometryBucket::_lockSourceBuffers(BufferLockMap& locks) const
+    {
+        QueuedGeometryList::const_iterator gi, giend;
+        giend = mQueuedGeometry.end();
+        for (gi = mQueuedGeometry.begin(); gi != giend; ++gi)
+        {
+            HardwareBuffer* ibuf = (*gi)->geometry->indexData->indexBuffer.get();
+            if (locks.find(ibuf) == locks.end())
+            {
+                locks[ibuf] = static_cast<uchar*>(
+                    ibuf->lock(HardwareBuffer::HBL_READ_ONLY));
+            }
+            VertexBufferBinding* srcBinds = (*gi)->geometry->vertexData->vertexBufferBinding;
+            for (ushort b = 0; b < srcBinds->getBufferCount(); ++b)
+            {
+                HardwareBuffer* vbuf = srcBinds->getBuffer(b).get();
+                if (locks.find(vbuf) == locks.end())
+                {
+                    locks[vbuf] = static_cast<uchar*>(
+                        vbuf->lock(HardwareBuffer::HBL_READ_ONLY));
+                }
+            }
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::GeometryBucket::_fillBuffers(
+        const BufferLockMap& sourceLocks, bool keepSubRanges)
+    {
+        // Transfer the vertices and indexes to the locked shared buffers
+        VertexDeclaration* dcl = mVertexData->vertexDeclaration;
+        VertexBufferBinding* binds = mVertexData->vertexBufferBinding;
+        ushort b;
+        ushort posBufferIdx = dcl->findElementBySemantic(VES_POSITION)->getSource();
+        const VertexElement* posElem = dcl->findElementBySemantic(VES_POSITION);
+
+        uint32* p32Dest = static_cast<uint32*>(mDestIndexLock);
+        uint16* p16Dest = static_cast<uint16*>(mDestIndexLock);
+        vector<VertexDeclaration::VertexElementList>::type bufferElements;
+        for (b = 0; b < binds->getBufferCount(); ++b)
+        {
             // Pre-cache vertex elements per buffer
             bufferElements.push_back(dcl->findElementsBySource(b));
         }
 
+        mSubRanges.clear();
+        if (keepSubRanges)
+            mSubRanges.reserve(mQueuedGeometry.size());
 
         // Iterate over the geometry items
         size_t indexOffset = 0;
+        size_t indexStart = 0;
         QueuedGeometryList::iterator gi, giend;
         giend = mQueuedGeometry.end();
         Vector3 regionCentre = mParent->getParent()->getParent()->getCentre();
@@ -1607,124 +1734,147 @@ namespace Ogre {
             QueuedGeometry* geom = *gi;
             // Copy indexes across with offset
             IndexData* srcIdxData = geom->geometry->indexData;
+            const uchar* pSrcIdx = sourceLocks.find(srcIdxData->indexBuffer.get())->second +
+                srcIdxData->indexStart * srcIdxData->indexBuffer->getIndexSize();
             if (mIndexType == HardwareIndexBuffer::IT_32BIT)
             {
-                // Lock source indexes
-                uint32* pSrc = static_cast<uint32*>(
-                    srcIdxData->indexBuffer->lock(
-                        srcIdxData->indexStart * srcIdxData->indexBuffer->getIndexSize(), 
-                        srcIdxData->indexCount * srcIdxData->indexBuffer->getIndexSize(),
-                        HardwareBuffer::HBL_READ_ONLY));
-
-                copyIndexes(pSrc, p32Dest, srcIdxData->indexCount, indexOffset);
+                copyIndexes(reinterpret_cast<const uint32*>(pSrcIdx), p32Dest,
+                    srcIdxData->indexCount, indexOffset);
                 p32Dest += srcIdxData->indexCount;
-                srcIdxData->indexBuffer->unlock();
             }
             else
             {
-                // Lock source indexes
-                uint16* pSrc = static_cast<uint16*>(
-                    srcIdxData->indexBuffer->lock(
-                    srcIdxData->indexStart * srcIdxData->indexBuffer->getIndexSize(), 
-                    srcIdxData->indexCount * srcIdxData->indexBuffer->getIndexSize(),
-                    HardwareBuffer::HBL_READ_ONLY));
-
-                copyIndexes(pSrc, p16Dest, srcIdxData->indexCount, indexOffset);
+                copyIndexes(reinterpret_cast<const uint16*>(pSrcIdx), p16Dest,
+                    srcIdxData->indexCount, indexOffset);
                 p16Dest += srcIdxData->indexCount;
-                srcIdxData->indexBuffer->unlock();
             }
 
             // Now deal with vertex buffers
             // we can rely on buffer counts / formats being the same
             VertexData* srcVData = geom->geometry->vertexData;
             VertexBufferBinding* srcBinds = srcVData->vertexBufferBinding;
+
+            // Positions are scaled, rotated, translated and adjusted for the
+            // region centre. Directions take the inverse scale and rotation,
+            // then are renormalised.
+            Matrix4 positionMatrix, directionMatrix;
+            positionMatrix.makeTransform(geom->position - regionCentre,
+                geom->scale, geom->orientation);
+            directionMatrix.makeTransform(Vector3::ZERO,
+                Vector3::UNIT_SCALE / geom->scale, geom->orientation);
+
             for (b = 0; b < binds->getBufferCount(); ++b)
             {
-                // lock source
                 HardwareVertexBufferSharedPtr srcBuf =
                     srcBinds->getBuffer(b);
-                uchar* pSrcBase = static_cast<uchar*>(
-                    srcBuf->lock(HardwareBuffer::HBL_READ_ONLY));
+                uchar* pSrcBase = sourceLocks.find(srcBuf.get())->second;
                 // Get buffer lock pointer, we'll update this later
-                uchar* pDstBase = destBufferLocks[b];
+                uchar* pDstBase = mDestBufferLocks[b];
                 size_t bufInc = srcBuf->getVertexSize();
+                size_t bufSize = bufInc * srcVData->vertexCount;
+
+                // Copy all the vertices, then transform the elements which
+                // need it in place, a whole array at a time. This also keeps
+                // the parity of 4 component tangents.
+                memcpy(pDstBase, pSrcBase, bufSize);
 
-                // Iterate over vertices
                 float *pSrcReal, *pDstReal;
-                Vector3 tmp;
-                for (size_t v = 0; v < srcVData->vertexCount; ++v)
+                VertexDeclaration::VertexElementList& elems =
+                    bufferElements[b];
+                VertexDeclaration::VertexElementList::iterator ei;
+                for (ei = elems.begin(); ei != elems.end(); ++ei)
                 {
-                    // Iterate over vertex elements
-                    VertexDeclaration::VertexElementList& elems =
-                        bufferElements[b];
-                    VertexDeclaration::VertexElementList::iterator ei;
-                    for (ei = elems.begin(); ei != elems.end(); ++ei)
+                    VertexElement& elem = *ei;
+                    elem.baseVertexPointerToElement(pSrcBase, &pSrcReal);
+                    elem.baseVertexPointerToElement(pDstBase, &pDstReal);
+                    switch (elem.getSemantic())
                     {
-                        VertexElement& elem = *ei;
-                        elem.baseVertexPointerToElement(pSrcBase, &pSrcReal);
-                        elem.baseVertexPointerToElement(pDstBase, &pDstReal);
-                        switch (elem.getSemantic())
-                        {
-                        case VES_POSITION:
-                            tmp.x = *pSrcReal++;
-                            tmp.y = *pSrcReal++;
-                            tmp.z = *pSrcReal++;
-                            // transform
-                            tmp = (geom->orientation * (tmp * geom->scale)) +
-                                geom->position;
-                            // Adjust for region centre
-                            tmp -= regionCentre;
-                            *pDstReal++ = tmp.x;
-                            *pDstReal++ = tmp.y;
-                            *pDstReal++ = tmp.z;
-                            break;
-                        case VES_NORMAL:
-                        case VES_TANGENT:
-                        case VES_BINORMAL:
-                            tmp.x = *pSrcReal++;
-                            tmp.y = *pSrcReal++;
-                            tmp.z = *pSrcReal++;
-                            // scale (invert)
-                            tmp = tmp / geom->scale;
-                            tmp.normalise();
-                            // rotation
-                            tmp = geom->orientation * tmp;
-                            *pDstReal++ = tmp.x;
-                            *pDstReal++ = tmp.y;
-                            *pDstReal++ = tmp.z;
-                            // copy parity for tangent.
-                            if (elem.getType() == Ogre::VET_FLOAT4)
-                                *pDstReal = *pSrcReal;
-                            break;
-                        default:
-                            // just raw copy
-                            memcpy(pDstReal, pSrcReal,
-                                    VertexElement::getTypeSize(elem.getType()));
-                            break;
-                        };
+                    case VES_POSITION:
+                        OptimisedUtil::getImplementation()->transformPoints(
+                            positionMatrix, pSrcReal, pDstReal,
+                            bufInc, bufInc, srcVData->vertexCount);
+                        break;
+                    case VES_NORMAL:
+                    case VES_TANGENT:
+                    case VES_BINORMAL:
+                        OptimisedUtil::getImplementation()->transformDirections(
+                            directionMatrix, pSrcReal, pDstReal,
+                            bufInc, bufInc, srcVData->vertexCount, true);
+                        break;
+                    default:
+                        // already copied
+                        break;
+                    };
+                }
 
+                if (keepSubRanges && b == posBufferIdx)
+                {
+                    // Bounds of the transformed positions, relative to the
+                    // region centre like the vertices themselves
+                    SubRange range;
+                    range.indexStart = static_cast<uint32>(indexStart);
+                    range.indexCount = static_cast<uint32>(srcIdxData->indexCount);
+                    posElem->baseVertexPointerToElement(pDstBase, &pDstReal);
+                    for (size_t v = 0; v < srcVData->vertexCount; ++v)
+                    {
+                        range.bounds.merge(Vector3(pDstReal[0], pDstReal[1], pDstReal[2]));
+                        pDstReal = reinterpret_cast<float*>(
+                            reinterpret_cast<uchar*>(pDstReal) + bufInc);
                     }
-
-                    // Increment both pointers
-                    pDstBase += bufInc;
-                    pSrcBase += bufInc;
-
+                    mSubRanges.push_back(range);
                 }
 
                 // Update pointer
-                destBufferLocks[b] = pDstBase;
-                srcBuf->unlock();
+                mDestBufferLocks[b] = pDstBase + bufSize;
             }
 
             indexOffset += geom->geometry->vertexData->vertexCount;
+            indexStart += srcIdxData->indexCount;
         }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::GeometryBucket::_finishBuild(bool stencilShadows)
+    {
+        VertexBufferBinding* binds = mVertexData->vertexBufferBinding;
+        ushort posBufferIdx = mVertexData->vertexDeclaration->
+            findElementBySemantic(VES_POSITION)->getSource();
 
         // Unlock everything
         mIndexData->indexBuffer->unlock();
-        for (b = 0; b < binds->getBufferCount(); ++b)
+        mDestIndexLock = 0;
+        for (ushort b = 0; b < binds->getBufferCount(); ++b)
         {
             binds->getBuffer(b)->unlock();
         }
+        mDestBufferLocks.clear();
+
+        if (!mSubRanges.empty())
+        {
+            mVisibleIndexData = OGRE_NEW IndexData();
+            mVisibleIndexData->indexBuffer = mIndexData->indexBuffer;
+            mVisibleIndexData->indexStart = mIndexData->indexStart;
+            mVisibleIndexData->indexCount = mIndexData->indexCount;
+
+            // Cull the sub-ranges on the GPU where the render system can
+            RenderSystem* rend = Root::getSingleton().getRenderSystem();
+            if (mParent->getParent()->getParent()->getParent()->getGpuCulling() && rend &&
+                (mGpuCuller = rend->createGpuDrawCuller()))
+            {
+                vector<IndirectDrawCommand>::type commands(mSubRanges.size());
+                vector<Vector4>::type bounds(mSubRanges.size());
+                for (size_t i = 0; i < mSubRanges.size(); ++i)
+                {
+                    commands[i].indexCount = mSubRanges[i].indexCount;
+                    commands[i].instanceCount = 1;
+                    commands[i].firstIndex = mSubRanges[i].indexStart;
+                    commands[i].baseVertex = 0;
+                    commands[i].baseInstance = 0;
+                }
+                // The bounds are placed in the world on the first cull
+                mGpuCuller->setDraws(&commands[0], &bounds[0], commands.size());
+                mGpuCullerTransformVersion = 0;
+            }
+        }
 
         // If we're dealing with stencil shadows, copy the position data from
         // the early half of the buffer to the latter part
@@ -1764,6 +1914,77 @@ namespace Ogre {
 
     }
     //--------------------------------------------------------------------------
+    bool StaticGeometry::GeometryBucket::_updateVisibleRanges(const Camera* cam)
+    {
+        if (!mVisibleIndexData)
+            return true;
+
+        const Matrix4& xform = mParent->getParent()->getParent()->_getParentNodeFullTransform();
+        if (mGpuCuller)
+        {
+            unsigned long version = mParent->getParent()->getParent()->getParentNode()->_getTransformVersion();
+            if (version != mGpuCullerTransformVersion)
+            {
+                vector<Vector4>::type bounds(mSubRanges.size());
+                for (size_t i = 0; i < mSubRanges.size(); ++i)
+                {
+                    AxisAlignedBox box = mSubRanges[i].bounds;
+                    box.transformAffine(xform);
+                    Vector3 centre = box.getCenter();
+                    bounds[i] = Vector4(centre.x, centre.y, centre.z, box.getHalfSize().length());
+                }
+                mGpuCuller->updateBounds(0, bounds.size(), &bounds[0]);
+                mGpuCullerTransformVersion = version;
+            }
+            mGpuCuller->cull(cam);
+            return true;
+        }
+
+        mVisibleDraws.clear();
+        SubRangeList::const_iterator ri, riend = mSubRanges.end();
+        for (ri = mSubRanges.begin(); ri != riend; ++ri)
+        {
+            AxisAlignedBox bounds = ri->bounds;
+            bounds.transformAffine(xform);
+            if (!cam->isVisible(bounds))
+                continue;
+
+            // Merge with the previous range if they are adjacent
+            if (!mVisibleDraws.empty() &&
+                mVisibleDraws.back().firstIndex + mVisibleDraws.back().indexCount == ri->indexStart)
+            {
+                mVisibleDraws.back().indexCount += ri->indexCount;
+            }
+            else
+            {
+                IndirectDrawCommand cmd;
+                cmd.indexCount = ri->indexCount;
+                cmd.instanceCount = 1;
+                cmd.firstIndex = ri->indexStart;
+                cmd.baseVertex = 0;
+                cmd.baseInstance = 0;
+                mVisibleDraws.push_back(cmd);
+            }
+        }
+
+        if (mVisibleDraws.empty())
+            return false;
+
+        mVisibleIndexData->indexStart = mVisibleDraws.front().firstIndex;
+        mVisibleIndexData->indexCount = mVisibleDraws.back().firstIndex +
+            mVisibleDraws.back().indexCount - mVisibleDraws.front().firstIndex;
+
+        // A single run is drawn normally, as are several if they can't be
+        // submitted at once
+        RenderSystem* rend = Root::getSingleton().getRenderSystem();
+        if (mVisibleDraws.size() == 1 || !rend ||
+            !rend->getCapabilities()->hasCapability(RSC_MULTI_DRAW_INDIRECT))
+        {
+            mVisibleDraws.clear();
+        }
+        return true;
+    }
+    //--------------------------------------------------------------------------
     void StaticGeometry::GeometryBucket::dump(std::ofstream& of) const
     {
         of << "Geometry Bucket" << std::endl;
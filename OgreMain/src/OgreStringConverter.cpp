@@ -30,8 +30,133 @@ THE SOFTWARE.
 #include "OgreException.h"
 #include "OgrePlatform.h"
 
+#include <cctype>
+#include <cerrno>
+#include <clocale>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
 namespace Ogre {
 
+    namespace {
+        /** Whether the C library reads numbers like the classic locale does.
+        @remarks
+            The strto* functions follow the C locale, which is changed along with
+            a named global C++ locale, so only use them while it has a '.'
+            decimal point.
+        */
+        bool isClassicNumericFormat()
+        {
+            return *localeconv()->decimal_point == '.';
+        }
+
+        /// Reads a floating point number from the start of str, without allocating
+        template<typename T>
+        bool readFloat(const char* str, const char** end, T& ret)
+        {
+            // The stream operators read no hexadecimal, only the 0 of a 0x prefix
+            const char* p = str;
+            while (isspace(static_cast<unsigned char>(*p)))
+                ++p;
+            bool negative = *p == '-';
+            if (*p == '-' || *p == '+')
+                ++p;
+            if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X'))
+            {
+                *end = p + 1;
+                ret = negative ? -static_cast<T>(0) : static_cast<T>(0);
+                return true;
+            }
+
+            char* e;
+            errno = 0;
+            double d = strtod(str, &e);
+            *end = e;
+            // Reject what the stream operators do not read: overflow, inf and nan
+            if (e == str || errno == ERANGE || d != d ||
+                d > std::numeric_limits<T>::max() || d < -std::numeric_limits<T>::max())
+                return false;
+            ret = static_cast<T>(d);
+            return true;
+        }
+
+        /// Reads a signed decimal integer from the start of str, without allocating
+        template<typename T>
+        bool readSigned(const char* str, T& ret)
+        {
+            char* e;
+            errno = 0;
+            long l = strtol(str, &e, 10);
+            if (e == str || errno == ERANGE ||
+                l < std::numeric_limits<T>::min() || l > std::numeric_limits<T>::max())
+                return false;
+            ret = static_cast<T>(l);
+            return true;
+        }
+
+        /// Reads an unsigned decimal integer from the start of str, without allocating
+        template<typename T>
+        bool readUnsigned(const char* str, T& ret)
+        {
+            // Negative numbers wrap around within T, as the stream operators read them
+            while (isspace(static_cast<unsigned char>(*str)))
+                ++str;
+            bool negative = *str == '-';
+            if (negative && !isdigit(static_cast<unsigned char>(*++str)))
+                return false;
+
+            char* e;
+            errno = 0;
+            unsigned long l = strtoul(str, &e, 10);
+            if (e == str || errno == ERANGE || l > std::numeric_limits<T>::max())
+                return false;
+            ret = negative ? static_cast<T>(0 - static_cast<T>(l)) : static_cast<T>(l);
+            return true;
+        }
+
+        /** Reads whitespace separated floating point numbers, as split by
+            StringUtil::split.
+        @param ret Receives the first count numbers; entries for tokens which
+            are not numbers are left unchanged
+        @param fast Whether to read with the C library rather than parseReal
+        @return The number of tokens in val
+        */
+        template<typename T>
+        size_t readFloats(const String& val, T* ret, size_t count, bool fast)
+        {
+            static const char* delims = "\t\n ";
+            size_t numTokens = 0;
+            const char* p = val.c_str();
+            while (true)
+            {
+                p += strspn(p, delims);
+                if (!*p)
+                    break;
+                size_t len = strcspn(p, delims);
+                if (numTokens < count)
+                {
+                    if (fast)
+                    {
+                        const char* end;
+                        T v;
+                        // Do not let leading whitespace the split keeps carry on into the next token
+                        if (readFloat(p, &end, v) && end <= p + len)
+                            ret[numTokens] = v;
+                    }
+                    else
+                    {
+                        ret[numTokens] = static_cast<T>(
+                            StringConverter::parseReal(String(p, len), static_cast<Real>(ret[numTokens])));
+                    }
+                }
+                ++numTokens;
+                p += len;
+            }
+            return numTokens;
+        }
+    }
+
     String StringConverter::msDefaultStringLocale = OGRE_DEFAULT_LOCALE;
     std::locale StringConverter::msLocale = std::locale(msDefaultStringLocale.c_str());
     bool StringConverter::msUseLocale = false;
@@ -258,6 +383,12 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     Real StringConverter::parseReal(const String& val, Real defaultValue)
     {
+        if (!msUseLocale && isClassicNumericFormat())
+        {
+            const char* end;
+            Real ret;
+            return readFloat(val.c_str(), &end, ret) ? ret : defaultValue;
+        }
         // Use iStringStream for direct correspondence with toString
         StringStream str(val);
         if (msUseLocale)
@@ -271,6 +402,11 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     int StringConverter::parseInt(const String& val, int defaultValue)
     {
+        if (!msUseLocale && isClassicNumericFormat())
+        {
+            int ret;
+            return readSigned(val.c_str(), ret) ? ret : defaultValue;
+        }
         // Use iStringStream for direct correspondence with toString
         StringStream str(val);
         if (msUseLocale)
@@ -284,6 +420,11 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     unsigned int StringConverter::parseUnsignedInt(const String& val, unsigned int defaultValue)
     {
+        if (!msUseLocale && isClassicNumericFormat())
+        {
+            unsigned int ret;
+            return readUnsigned(val.c_str(), ret) ? ret : defaultValue;
+        }
         // Use iStringStream for direct correspondence with toString
         StringStream str(val);
         if (msUseLocale)
@@ -297,6 +438,11 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     long StringConverter::parseLong(const String& val, long defaultValue)
     {
+        if (!msUseLocale && isClassicNumericFormat())
+        {
+            long ret;
+            return readSigned(val.c_str(), ret) ? ret : defaultValue;
+        }
         // Use iStringStream for direct correspondence with toString
         StringStream str(val);
         if (msUseLocale)
@@ -310,6 +456,11 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     unsigned long StringConverter::parseUnsignedLong(const String& val, unsigned long defaultValue)
     {
+        if (!msUseLocale && isClassicNumericFormat())
+        {
+            unsigned long ret;
+            return readUnsigned(val.c_str(), ret) ? ret : defaultValue;
+        }
         // Use iStringStream for direct correspondence with toString
         StringStream str(val);
         if (msUseLocale)
@@ -323,6 +474,12 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     size_t StringConverter::parseSizeT(const String& val, size_t defaultValue)
     {
+        if (!msUseLocale && isClassicNumericFormat() &&
+            sizeof(size_t) <= sizeof(unsigned long))
+        {
+            size_t ret;
+            return readUnsigned(val.c_str(), ret) ? ret : defaultValue;
+        }
         // Use iStringStream for direct correspondence with toString
         StringStream str(val);
         if (msUseLocale)
@@ -351,153 +508,58 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     Vector2 StringConverter::parseVector2(const String& val, const Vector2& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() != 2)
-        {
-            return defaultValue;
-        }
-        else
-        {
-            return Vector2(parseReal(vec[0], defaultValue[0]), parseReal(vec[1], defaultValue[1]));
-        }
+        Vector2 ret = defaultValue;
+        bool fast = !msUseLocale && isClassicNumericFormat();
+        return readFloats(val, ret.ptr(), 2, fast) == 2 ? ret : defaultValue;
     }
     //-----------------------------------------------------------------------
     Vector3 StringConverter::parseVector3(const String& val, const Vector3& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() != 3)
-        {
-            return defaultValue;
-        }
-        else
-        {
-            return Vector3(parseReal(vec[0], defaultValue[0]),
-                           parseReal(vec[1], defaultValue[1]),
-                           parseReal(vec[2], defaultValue[2]));
-        }
+        Vector3 ret = defaultValue;
+        bool fast = !msUseLocale && isClassicNumericFormat();
+        return readFloats(val, ret.ptr(), 3, fast) == 3 ? ret : defaultValue;
     }
     //-----------------------------------------------------------------------
     Vector4 StringConverter::parseVector4(const String& val, const Vector4& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() != 4)
-        {
-            return defaultValue;
-        }
-        else
-        {
-            return Vector4(parseReal(vec[0], defaultValue[0]),
-                           parseReal(vec[1], defaultValue[1]),
-                           parseReal(vec[2], defaultValue[2]),
-                           parseReal(vec[3], defaultValue[3]));
-        }
+        Vector4 ret = defaultValue;
+        bool fast = !msUseLocale && isClassicNumericFormat();
+        return readFloats(val, ret.ptr(), 4, fast) == 4 ? ret : defaultValue;
     }
     //-----------------------------------------------------------------------
     Matrix3 StringConverter::parseMatrix3(const String& val, const Matrix3& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() != 9)
-        {
-            return defaultValue;
-        }
-        else
-        {
-            return Matrix3(parseReal(vec[0], defaultValue[0][0]),
-                           parseReal(vec[1], defaultValue[0][1]),
-                           parseReal(vec[2], defaultValue[0][2]),
-
-                           parseReal(vec[3], defaultValue[1][0]),
-                           parseReal(vec[4], defaultValue[1][1]),
-                           parseReal(vec[5], defaultValue[1][2]),
-
-                           parseReal(vec[6], defaultValue[2][0]),
-                           parseReal(vec[7], defaultValue[2][1]),
-                           parseReal(vec[8], defaultValue[2][2]));
-        }
+        // Rows are stored contiguously
+        Matrix3 ret = defaultValue;
+        bool fast = !msUseLocale && isClassicNumericFormat();
+        return readFloats(val, ret[0], 9, fast) == 9 ? ret : defaultValue;
     }
     //-----------------------------------------------------------------------
     Matrix4 StringConverter::parseMatrix4(const String& val, const Matrix4& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() != 16)
-        {
-            return defaultValue;
-        }
-        else
-        {
-            return Matrix4(parseReal(vec[0], defaultValue[0][0]),
-                           parseReal(vec[1], defaultValue[0][1]),
-                           parseReal(vec[2], defaultValue[0][2]),
-                           parseReal(vec[3], defaultValue[0][3]),
-                           
-                           parseReal(vec[4], defaultValue[1][0]),
-                           parseReal(vec[5], defaultValue[1][1]),
-                           parseReal(vec[6], defaultValue[1][2]),
-                           parseReal(vec[7], defaultValue[1][3]),
-                           
-                           parseReal(vec[8], defaultValue[2][0]),
-                           parseReal(vec[9], defaultValue[2][1]),
-                           parseReal(vec[10], defaultValue[2][2]),
-                           parseReal(vec[11], defaultValue[2][3]),
-                           
-                           parseReal(vec[12], defaultValue[3][0]),
-                           parseReal(vec[13], defaultValue[3][1]),
-                           parseReal(vec[14], defaultValue[3][2]),
-                           parseReal(vec[15], defaultValue[3][3]));
-        }
+        // Rows are stored contiguously
+        Matrix4 ret = defaultValue;
+        bool fast = !msUseLocale && isClassicNumericFormat();
+        return readFloats(val, ret[0], 16, fast) == 16 ? ret : defaultValue;
     }
     //-----------------------------------------------------------------------
     Quaternion StringConverter::parseQuaternion(const String& val, const Quaternion& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() != 4)
-        {
-            return defaultValue;
-        }
-        else
-        {
-            return Quaternion(parseReal(vec[0], defaultValue[0]),
-                              parseReal(vec[1], defaultValue[1]),
-                              parseReal(vec[2], defaultValue[2]),
-                              parseReal(vec[3], defaultValue[3]));
-        }
+        Quaternion ret = defaultValue;
+        bool fast = !msUseLocale && isClassicNumericFormat();
+        return readFloats(val, ret.ptr(), 4, fast) == 4 ? ret : defaultValue;
     }
     //-----------------------------------------------------------------------
     ColourValue StringConverter::parseColourValue(const String& val, const ColourValue& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() == 4)
-        {
-            return ColourValue(parseReal(vec[0], defaultValue[0]),
-                               parseReal(vec[1], defaultValue[1]),
-                               parseReal(vec[2], defaultValue[2]),
-                               parseReal(vec[3], defaultValue[3]));
-        }
-        else if (vec.size() == 3)
-        {
-            return ColourValue(parseReal(vec[0], defaultValue[0]),
-                               parseReal(vec[1], defaultValue[1]),
-                               parseReal(vec[2], defaultValue[2]),
-                               1.0f);
-        }
-        else
-        {
+        ColourValue ret = defaultValue;
+        bool fast = !msUseLocale && isClassicNumericFormat();
+        size_t count = readFloats(val, ret.ptr(), 4, fast);
+        if (count == 3)
+            ret.a = 1.0f;
+        else if (count != 4)
             return defaultValue;
-        }
+        return ret;
     }
     //-----------------------------------------------------------------------
     StringVector StringConverter::parseStringVector(const String& val)
@@ -507,6 +569,13 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     bool StringConverter::isNumber(const String& val)
     {
+        if (!msUseLocale && isClassicNumericFormat())
+        {
+            // Leading whitespace is skipped, trailing characters are not allowed
+            const char* end;
+            float tst;
+            return readFloat(val.c_str(), &end, tst) && end == val.c_str() + val.size();
+        }
         StringStream str(val);
         if (msUseLocale)
             str.imbue(msLocale);
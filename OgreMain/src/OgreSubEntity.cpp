@@ -34,12 +34,19 @@ THE SOFTWARE.
 #include "OgreLogManager.h"
 #include "OgreMesh.h"
 #include "OgreException.h"
+#include "OgreCamera.h"
+#include "OgreTechnique.h"
+#include "OgreSceneManager.h"
+#include "OgreSoftwareOcclusionCuller.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
     SubEntity::SubEntity (Entity* parent, SubMesh* subMeshBasis)
         : Renderable(), mParentEntity(parent),
-        mSubMesh(subMeshBasis), mMaterialLodIndex(0), mCachedCamera(0)
+        mSubMesh(subMeshBasis), mMaterialLodIndex(0), mCachedCamera(0),
+        mClusterDrawsUsed(false), mClusterDrawIndirect(false), mClusterSpanIndexData(0)
     {
         mVisible = true;
         mRenderQueueID = 0;
@@ -60,6 +67,7 @@ namespace Ogre {
         OGRE_DELETE mSkelAnimVertexData;
         OGRE_DELETE mHardwareVertexAnimVertexData;
         OGRE_DELETE mSoftwareVertexAnimVertexData;
+        OGRE_DELETE mClusterSpanIndexData;
     }
     //-----------------------------------------------------------------------
     SubMesh* SubEntity::getSubMesh(void)
@@ -149,6 +157,106 @@ namespace Ogre {
             op.indexData->indexStart = mIndexStart;
             op.indexData->indexCount = mIndexEnd;
         }
+        else if (mClusterDrawsUsed && mParentEntity->mMeshLodIndex == 0)
+        {
+            if (mClusterDrawIndirect)
+            {
+                const uint32 instances = static_cast<uint32>(std::max<size_t>(op.numberOfInstances, 1));
+                for (vector<IndirectDrawCommand>::type::iterator i = mClusterDraws.begin();
+                     i != mClusterDraws.end(); ++i)
+                {
+                    i->baseVertex = static_cast<int32>(op.vertexData->vertexStart);
+                    i->instanceCount = instances;
+                }
+                op.indirectCommands = &mClusterDraws[0];
+                op.numIndirectCommands = mClusterDraws.size();
+            }
+            else
+            {
+                mClusterSpanIndexData->indexBuffer = op.indexData->indexBuffer;
+                op.indexData = mClusterSpanIndexData;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool SubEntity::_cullClusters(const Camera* cam, bool cullBackFacing)
+    {
+        mClusterDrawsUsed = false;
+        const SubMesh::TriangleClusterList& clusters = mSubMesh->clusters;
+        if (clusters.empty() || mParentEntity->mMeshLodIndex != 0 || mIndexStart != mIndexEnd)
+            return true;
+
+        const Matrix4& world = mParentEntity->_getParentNodeFullTransform();
+        Real scale2[3];
+        for (int c = 0; c < 3; ++c)
+            scale2[c] = Vector3(world[0][c], world[1][c], world[2][c]).squaredLength();
+        const Real maxScale = Math::Sqrt(std::max(scale2[0], std::max(scale2[1], scale2[2])));
+        const Real minScale = Math::Sqrt(std::min(scale2[0], std::min(scale2[1], scale2[2])));
+
+        // the cone of the normals only holds under a uniform scale
+        Vector3 localCamera;
+        if (cullBackFacing && !cam->isReflected() && maxScale - minScale <= maxScale * 1e-3f)
+        {
+            localCamera = world.inverseAffine().transformAffine(cam->getDerivedPosition());
+            Technique* tech = getTechnique();
+            for (ushort p = 0; tech && p < tech->getNumPasses(); ++p)
+                cullBackFacing = cullBackFacing && tech->getPass(p)->getCullingMode() == CULL_CLOCKWISE;
+            cullBackFacing = cullBackFacing && tech;
+        }
+        else
+        {
+            cullBackFacing = false;
+        }
+
+        const SoftwareOcclusionCuller* occlusion = mParentEntity->_getManager() ?
+            mParentEntity->_getManager()->getOcclusionCuller() : 0;
+        const size_t indexStart = mSubMesh->indexData->indexStart;
+
+        mClusterDraws.clear();
+        for (SubMesh::TriangleClusterList::const_iterator i = clusters.begin(); i != clusters.end(); ++i)
+        {
+            if (cullBackFacing && SubMesh::isClusterBackFacing(*i, localCamera))
+                continue;
+            const Vector3 centre = world.transformAffine(i->centre);
+            const Real radius = i->radius * maxScale;
+            if (!cam->isVisible(Sphere(centre, radius)))
+                continue;
+            if (occlusion && occlusion->isOccluded(
+                AxisAlignedBox(centre - Vector3(radius), centre + Vector3(radius)), cam))
+                continue;
+
+            const uint32 first = static_cast<uint32>(indexStart + i->indexStart);
+            if (!mClusterDraws.empty() &&
+                mClusterDraws.back().firstIndex + mClusterDraws.back().indexCount == first)
+            {
+                mClusterDraws.back().indexCount += i->indexCount;
+            }
+            else
+            {
+                IndirectDrawCommand draw = { i->indexCount, 1, first, 0, 0 };
+                mClusterDraws.push_back(draw);
+            }
+        }
+
+        if (mClusterDraws.empty())
+            return false;
+        // nothing culled, so draw the submesh as usual
+        if (mClusterDraws.size() == 1 && mClusterDraws[0].indexCount == mSubMesh->indexData->indexCount)
+            return true;
+
+        RenderSystem* rs = Root::getSingleton().getRenderSystem();
+        mClusterDrawIndirect = rs && rs->getCapabilities() &&
+            rs->getCapabilities()->hasCapability(RSC_MULTI_DRAW_INDIRECT);
+        if (!mClusterDrawIndirect)
+        {
+            if (!mClusterSpanIndexData)
+                mClusterSpanIndexData = OGRE_NEW IndexData();
+            mClusterSpanIndexData->indexStart = mClusterDraws.front().firstIndex;
+            mClusterSpanIndexData->indexCount = mClusterDraws.back().firstIndex +
+                mClusterDraws.back().indexCount - mClusterDraws.front().firstIndex;
+        }
+        mClusterDrawsUsed = true;
+        return true;
     }
     //-----------------------------------------------------------------------
     void SubEntity::setIndexDataStartIndex(size_t start_index)
@@ -406,13 +514,26 @@ namespace Ogre {
             Vector4 val(0.0f,0.0f,0.0f,0.0f);
             const VertexData* vd = mHardwareVertexAnimVertexData ? mHardwareVertexAnimVertexData : mParentEntity->mHardwareVertexAnimVertexData;
             
-            size_t animIndex = constantEntry.data * 4;
-            for (size_t i = 0; i < 4 && 
-                animIndex < vd->hwAnimationDataList.size();
-                ++i, ++animIndex)
+            if (vd->hwPoseTexture)
+            {
+                // Pose texture offset and influence pairs, 2 poses per constant
+                size_t poseIndex = constantEntry.data * 2;
+                for (size_t i = 0; i < 4 && poseIndex < vd->hwPoseWeights.size(); i += 2, ++poseIndex)
+                {
+                    val[i] = vd->hwPoseWeights[poseIndex].first;
+                    val[i + 1] = vd->hwPoseWeights[poseIndex].second;
+                }
+            }
+            else
             {
-                val[i] = 
-                    vd->hwAnimationDataList[animIndex].parametric;
+                size_t animIndex = constantEntry.data * 4;
+                for (size_t i = 0; i < 4 && 
+                    animIndex < vd->hwAnimationDataList.size();
+                    ++i, ++animIndex)
+                {
+                    val[i] = 
+                        vd->hwAnimationDataList[animIndex].parametric;
+                }
             }
             // set the parametric morph value
             params->_writeRawConstant(constantEntry.physicalIndex, val);
@@ -445,6 +445,87 @@ namespace Ogre {
         vbuf->unlock ();
     }
     //---------------------------------------------------------------------
+    void SubMesh::buildClusters(size_t maxTriangles)
+    {
+        clusters.clear();
+
+        VertexData* vert = useSharedVertices ? parent->sharedVertexData : vertexData;
+        if (operationType != RenderOperation::OT_TRIANGLE_LIST || !vert || !vert->vertexCount ||
+            !indexData->indexCount || maxTriangles == 0)
+            return;
+
+        const VertexElement* poselem = vert->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        HardwareVertexBufferSharedPtr vbuf = vert->vertexBufferBinding->getBuffer(poselem->getSource());
+        const uint8* vdata = static_cast<const uint8*>(vbuf->lock(HardwareBuffer::HBL_READ_ONLY));
+        const size_t vsz = vbuf->getVertexSize();
+
+        HardwareIndexBufferSharedPtr ibuf = indexData->indexBuffer;
+        const bool use32 = ibuf->getType() == HardwareIndexBuffer::IT_32BIT;
+        const void* idata = ibuf->lock(indexData->indexStart * ibuf->getIndexSize(),
+            indexData->indexCount * ibuf->getIndexSize(), HardwareBuffer::HBL_READ_ONLY);
+
+        const size_t numTriangles = indexData->indexCount / 3;
+        vector<Vector3>::type corners;
+        vector<Vector3>::type normals;
+        for (size_t first = 0; first < numTriangles; first += maxTriangles)
+        {
+            const size_t count = std::min(maxTriangles, numTriangles - first);
+            corners.clear();
+            normals.clear();
+            AxisAlignedBox box;
+            Vector3 normalSum = Vector3::ZERO;
+            for (size_t t = first; t < first + count; ++t)
+            {
+                Vector3 v[3];
+                for (int c = 0; c < 3; ++c)
+                {
+                    size_t index = use32 ? static_cast<const uint32*>(idata)[t * 3 + c] :
+                        static_cast<const uint16*>(idata)[t * 3 + c];
+                    float* p;
+                    poselem->baseVertexPointerToElement(
+                        const_cast<uint8*>(vdata) + (vert->vertexStart + index) * vsz, &p);
+                    v[c] = Vector3(p[0], p[1], p[2]);
+                    box.merge(v[c]);
+                    corners.push_back(v[c]);
+                }
+                // degenerate triangles are not drawn, so don't widen the cone
+                Vector3 normal = (v[1] - v[0]).crossProduct(v[2] - v[0]);
+                if (normal.normalise() > 0)
+                {
+                    normals.push_back(normal);
+                    normalSum += normal;
+                }
+            }
+
+            TriangleCluster cluster;
+            cluster.indexStart = static_cast<uint32>(first * 3);
+            cluster.indexCount = static_cast<uint32>(count * 3);
+            cluster.centre = box.getCenter();
+            Real radius2 = 0;
+            for (vector<Vector3>::type::iterator i = corners.begin(); i != corners.end(); ++i)
+                radius2 = std::max(radius2, cluster.centre.squaredDistance(*i));
+            cluster.radius = Math::Sqrt(radius2);
+
+            // the normals of a cluster should be close to each other, so their
+            // average is a good enough axis
+            cluster.coneAxis = normalSum;
+            cluster.coneCos = -1;
+            cluster.coneSin = 0;
+            if (cluster.coneAxis.normalise() > 0)
+            {
+                Real minDot = 1;
+                for (vector<Vector3>::type::iterator i = normals.begin(); i != normals.end(); ++i)
+                    minDot = std::min(minDot, cluster.coneAxis.dotProduct(*i));
+                cluster.coneCos = minDot;
+                cluster.coneSin = Math::Sqrt(std::max(Real(0), 1 - minDot * minDot));
+            }
+            clusters.push_back(cluster);
+        }
+
+        ibuf->unlock();
+        vbuf->unlock();
+    }
+    //---------------------------------------------------------------------
     void SubMesh::setBuildEdgesEnabled(bool b)
     {
         mBuildEdgesEnabled = b;
@@ -471,6 +552,7 @@ namespace Ogre {
         newSub->operationType = this->operationType;
         newSub->useSharedVertices = this->useSharedVertices;
         newSub->extremityPoints = this->extremityPoints;
+        newSub->clusters = this->clusters;
 
         if (!this->useSharedVertices)
         {
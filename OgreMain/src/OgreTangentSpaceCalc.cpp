@@ -600,6 +600,10 @@ namespace Ogre
             OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, 
             "No vertex normals found", 
             "TangentSpaceCalc::build");
+        if (normElem->getType() != VET_FLOAT3)
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, 
+            "Vertex normals must be VET_FLOAT3, build tangents before quantising", 
+            "TangentSpaceCalc::build");
 
         if (normElem->getSource() == uvElem->getSource())
         {
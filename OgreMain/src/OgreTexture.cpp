@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreTexture.h"
 #include "OgreException.h"
 #include "OgreTextureManager.h"
+#include "OgreResourceLoadTrace.h"
 
 namespace Ogre {
     //--------------------------------------------------------------------------
@@ -45,6 +46,7 @@ namespace Ogre {
             mDepth(1),
             mNumRequestedMipmaps(0),
             mNumMipmaps(0),
+            mMipSkip(0),
             mMipmapsHardwareGenerated(false),
             mGamma(1.0f),
             mHwGamma(false),
@@ -75,6 +77,7 @@ namespace Ogre {
         {
             TextureManager& tmgr = TextureManager::getSingleton();
             setNumMipmaps(tmgr.getDefaultNumMipmaps());
+            setMipSkip(tmgr.getDefaultMipSkip());
             setDesiredBitDepths(tmgr.getPreferredIntegerBitDepth(), tmgr.getPreferredFloatBitDepth());
         }
 
@@ -175,7 +178,13 @@ namespace Ogre {
     //--------------------------------------------------------------------------
     size_t Texture::calculateSize(void) const
     {
-        return getNumFaces() * PixelUtil::getMemorySize(mWidth, mHeight, mDepth, mFormat);
+        return Resource::calculateSize() + calculateGpuSize();
+    }
+    //--------------------------------------------------------------------------
+    size_t Texture::calculateGpuSize(void) const
+    {
+        // Every face with its whole mip chain; the source images are freed once loaded
+        return Image::calculateSize(getNumMipmaps(), getNumFaces(), mWidth, mHeight, mDepth, mFormat);
     }
     //--------------------------------------------------------------------------
     size_t Texture::getNumFaces(void) const
@@ -183,16 +192,47 @@ namespace Ogre {
         return getTextureType() == TEX_TYPE_CUBE_MAP ? 6 : 1;
     }
     //--------------------------------------------------------------------------
-    void Texture::_loadImages( const ConstImagePtrList& images )
+    void Texture::_loadImages( const ConstImagePtrList& srcImages )
     {
-        if(images.size() < 1)
+        if(srcImages.size() < 1)
             OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Cannot load empty vector of images",
              "Texture::loadImages");
+
+        // Compress on the CPU if the manager is set to; the compressed images
+        // carry their own mipmaps and are loaded like any others
+        vector<Image>::type compressed(srcImages.size());
+        ConstImagePtrList compressedPtrs;
+        TextureManager& texMgr = TextureManager::getSingleton();
+        if (texMgr.getCompressOnLoad() && mDesiredFormat == PF_UNKNOWN &&
+            mGamma == 1.0f && !mTreatLuminanceAsAlpha)
+        {
+            for (size_t i = 0; i < srcImages.size(); ++i)
+            {
+                if (!texMgr._compressImage(*srcImages[i], mTextureType, mUsage,
+                    mNumRequestedMipmaps, compressed[i]))
+                    break;
+                compressedPtrs.push_back(&compressed[i]);
+            }
+            if (compressedPtrs.size() != srcImages.size())
+                compressedPtrs.clear();
+        }
+        const ConstImagePtrList& images = compressedPtrs.empty() ? srcImages : compressedPtrs;
+
+        ResourceLoadTraceScope trace(RLP_UPLOAD, mName);
         
+        // The custom mipmaps in the image have priority over everything
+        uint32 imageMips = images[0]->getNumMipmaps();
+        // Leave out the top levels if asked to, but always keep the smallest
+        uint32 mipSkip = std::min(mMipSkip, imageMips);
+
         // Set desired texture size and properties from images[0]
-        mSrcWidth = mWidth = images[0]->getWidth();
-        mSrcHeight = mHeight = images[0]->getHeight();
-        mSrcDepth = mDepth = images[0]->getDepth();
+        mSrcWidth = images[0]->getWidth();
+        mSrcHeight = images[0]->getHeight();
+        mSrcDepth = images[0]->getDepth();
+        PixelBox topLevel = images[0]->getPixelBox(0, mipSkip);
+        mWidth = static_cast<uint32>(topLevel.getWidth());
+        mHeight = static_cast<uint32>(topLevel.getHeight());
+        mDepth = static_cast<uint32>(topLevel.getDepth());
 
         // Get source image format and adjust if required
         mSrcFormat = images[0]->getFormat();
@@ -212,12 +252,9 @@ namespace Ogre {
             mFormat = PixelUtil::getFormatForBitDepths(mSrcFormat, mDesiredIntegerBitDepth, mDesiredFloatBitDepth);
         }
 
-        // The custom mipmaps in the image have priority over everything
-        uint32 imageMips = images[0]->getNumMipmaps();
-
         if(imageMips > 0)
         {
-            mNumMipmaps = mNumRequestedMipmaps = images[0]->getNumMipmaps();
+            mNumMipmaps = mNumRequestedMipmaps = imageMips - mipSkip;
             // Disable flag for auto mip generation
             mUsage &= ~TU_AUTOMIPMAP;
         }
@@ -284,7 +321,7 @@ namespace Ogre {
         
         // Main loading loop
         // imageMips == 0 if the image has no custom mipmaps, otherwise contains the number of custom mips
-        for(size_t mip = 0; mip <= std::min(mNumMipmaps, imageMips); ++mip)
+        for(size_t mip = 0; mip <= std::min(mNumMipmaps, imageMips - mipSkip); ++mip)
         {
             for(size_t i = 0; i < faces; ++i)
             {
@@ -292,12 +329,12 @@ namespace Ogre {
                 if(multiImage)
                 {
                     // Load from multiple images
-                    src = images[i]->getPixelBox(0, mip);
+                    src = images[i]->getPixelBox(0, mip + mipSkip);
                 }
                 else
                 {
                     // Load from faces of images[0]
-                    src = images[0]->getPixelBox(i, mip);
+                    src = images[0]->getPixelBox(i, mip + mipSkip);
                 }
     
                 // Sets to treated format in case is difference
@@ -331,10 +368,46 @@ namespace Ogre {
             }
         }
         // Update size (the final size, not including temp space)
-        mSize = getNumFaces() * PixelUtil::getMemorySize(mWidth, mHeight, mDepth, mFormat);
+        mSize = calculateSize();
+        mGpuSize = calculateGpuSize();
+        trace.setBytes(mGpuSize);
 
     }
     //-----------------------------------------------------------------------------
+    bool Texture::_hasSingleSourceImage(void) const
+    {
+        if (isManuallyLoaded())
+            return false;
+        // Cube maps other than DDS are loaded from one file per face
+        return getTextureType() != TEX_TYPE_CUBE_MAP || getSourceFileType() == "dds";
+    }
+    //-----------------------------------------------------------------------------
+    void Texture::_readSourceImage(Image& dest) const
+    {
+        DataStreamPtr stream = ResourceGroupManager::getSingleton().openResource(
+            mName, mGroup, true, const_cast<Texture*>(this));
+        dest.load(stream, getSourceFileType());
+    }
+    //-----------------------------------------------------------------------------
+    void Texture::_applyMipSkip(const Image& img, uint32 mipSkip)
+    {
+        if (!isLoaded())
+            return;
+
+        OGRE_LOCK_AUTO_MUTEX;
+        // Memory usage changes with the size
+        if (mCreator)
+            mCreator->_notifyResourceUnloaded(this);
+
+        mMipSkip = mipSkip;
+        freeInternalResources();
+        ConstImagePtrList imagePtrs(1, &img);
+        _loadImages(imagePtrs);
+
+        if (mCreator)
+            mCreator->_notifyResourceLoaded(this);
+    }
+    //-----------------------------------------------------------------------------
     void Texture::createInternalResources(void)
     {
         if (!mInternalResourcesCreated)
@@ -30,8 +30,18 @@ THE SOFTWARE.
 #include "OgrePixelFormat.h"
 #include "OgreRoot.h"
 #include "OgreRenderSystem.h"
+#include "OgreLogManager.h"
+#include "OgreImageCompressor.h"
+#include "OgreFileSystemLayer.h"
+#include "Hash/MurmurHash3.h"
+#include <fstream>
+#include <iomanip>
 
 namespace Ogre {
+    /// Identifies texture compression cache files
+    static const uint32 COMPRESSION_CACHE_MAGIC = 0x4354474F; // 'OGTC'
+    /// Bump when the encoders change, so stale cache entries are not used
+    static const uint32 COMPRESSION_CACHE_VERSION = 1;
     //-----------------------------------------------------------------------
     template<> TextureManager* Singleton<TextureManager>::msSingleton = 0;
     TextureManager* TextureManager::getSingletonPtr(void)
@@ -47,9 +57,17 @@ namespace Ogre {
          : mPreferredIntegerBitDepth(0)
          , mPreferredFloatBitDepth(0)
          , mDefaultNumMipmaps(MIP_UNLIMITED)
+        , mCompressOnLoad(false)
+        , mDefaultMipSkip(0)
+        , mMaxMipStreamRequests(2)
+        , mMipStreamRequestsInFlight(0)
+        , mMipStreamChannel(0)
+        , mMipStreamHandlersAdded(false)
     {
         mResourceType = "Texture";
         mLoadOrder = 75.0f;
+        // RenderSystem::_setTextureUnitSettings reloads evicted textures on bind
+        mEvictReferenced = true;
 
         // Subclasses should register (when this is fully constructed)
     }
@@ -58,6 +76,109 @@ namespace Ogre {
     {
         // subclasses should unregister with resource group manager
 
+        if (mMipStreamHandlersAdded)
+        {
+            WorkQueue* wq = Root::getSingleton().getWorkQueue();
+            wq->abortRequestsByChannel(mMipStreamChannel);
+            wq->removeRequestHandler(mMipStreamChannel, this);
+            wq->removeResponseHandler(mMipStreamChannel, this);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void TextureManager::requestMipSkip(const TexturePtr& tex, uint32 mipSkip, Real priority)
+    {
+        // The levels are decoded again from the file named after the texture
+        if (!tex->_hasSingleSourceImage())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Texture " + tex->getName() + " is manual or not loaded from a single file, "
+                "its mip levels cannot be streamed",
+                "TextureManager::requestMipSkip");
+        }
+
+        if (!mMipStreamHandlersAdded)
+        {
+            WorkQueue* wq = Root::getSingleton().getWorkQueue();
+            mMipStreamChannel = wq->getChannel("Ogre/TextureMipStream");
+            wq->addRequestHandler(mMipStreamChannel, this);
+            wq->addResponseHandler(mMipStreamChannel, this);
+            mMipStreamHandlersAdded = true;
+        }
+
+        MipStreamRequestList::iterator i = mPendingMipStreams.begin();
+        while (i != mPendingMipStreams.end() && i->texture != tex)
+            ++i;
+        if (i == mPendingMipStreams.end())
+        {
+            mPendingMipStreams.push_back(MipStreamRequest());
+            i = mPendingMipStreams.end() - 1;
+            i->texture = tex;
+        }
+        i->mipSkip = mipSkip;
+        i->priority = priority;
+
+        startMipStreamRequests();
+    }
+    //-----------------------------------------------------------------------
+    void TextureManager::startMipStreamRequests()
+    {
+        WorkQueue* wq = Root::getSingleton().getWorkQueue();
+        while (mMipStreamRequestsInFlight < mMaxMipStreamRequests && !mPendingMipStreams.empty())
+        {
+            MipStreamRequestList::iterator next = mPendingMipStreams.begin();
+            for (MipStreamRequestList::iterator i = next + 1; i != mPendingMipStreams.end(); ++i)
+            {
+                if (i->priority > next->priority)
+                    next = i;
+            }
+            MipStreamRequest req = *next;
+            mPendingMipStreams.erase(next);
+
+            // Nothing to do if the texture is gone or already has these levels
+            if (!req.texture->isLoaded() || req.texture->getMipSkip() == req.mipSkip)
+                continue;
+
+            ++mMipStreamRequestsInFlight;
+            wq->addRequest(mMipStreamChannel, 0, Any(req));
+        }
+    }
+    //-----------------------------------------------------------------------
+    WorkQueue::Response* TextureManager::handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+    {
+        MipStreamRequest streamReq = any_cast<MipStreamRequest>(req->getData());
+        if (req->getAborted())
+            return OGRE_NEW WorkQueue::Response(req, false, Any(streamReq));
+
+        try
+        {
+            streamReq.image.bind(OGRE_NEW Image());
+            streamReq.texture->_readSourceImage(*streamReq.image);
+        }
+        catch (Exception& e)
+        {
+            return OGRE_NEW WorkQueue::Response(req, false, Any(streamReq), e.getFullDescription());
+        }
+        return OGRE_NEW WorkQueue::Response(req, true, Any(streamReq));
+    }
+    //-----------------------------------------------------------------------
+    void TextureManager::handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
+    {
+        --mMipStreamRequestsInFlight;
+        if (res->getRequest()->getAborted())
+            return;
+
+        MipStreamRequest streamReq = any_cast<MipStreamRequest>(res->getData());
+        if (res->succeeded())
+        {
+            streamReq.texture->_applyMipSkip(*streamReq.image, streamReq.mipSkip);
+        }
+        else
+        {
+            LogManager::getSingleton().logMessage("Texture: " + streamReq.texture->getName() +
+                ": Unable to stream mip levels: " + res->getMessages(), LML_CRITICAL);
+        }
+
+        startMipStreamRequests();
     }
     //-----------------------------------------------------------------------
     TexturePtr TextureManager::getByName(const String& name, const String& groupName)
@@ -290,4 +411,144 @@ namespace Ogre {
         return PixelUtil::getNumElemBits(supportedFormat) >= PixelUtil::getNumElemBits(format);
         
     }
+    //-----------------------------------------------------------------------
+    void TextureManager::setCompressOnLoad(bool compress)
+    {
+        mCompressOnLoad = compress;
+    }
+    //-----------------------------------------------------------------------
+    void TextureManager::setCompressionCacheDirectory(const String& path)
+    {
+        mCompressionCacheDirectory = path;
+    }
+    //-----------------------------------------------------------------------
+    PixelFormat TextureManager::getCompressedFormat(TextureType ttype, PixelFormat srcFormat, int usage)
+    {
+        // Only plain 8 bit colour, which the encoders treat as RGBA
+        switch (srcFormat)
+        {
+        case PF_L8:
+        case PF_BYTE_LA:
+        case PF_R8G8B8:
+        case PF_B8G8R8:
+        case PF_A8R8G8B8:
+        case PF_A8B8G8R8:
+        case PF_B8G8R8A8:
+        case PF_R8G8B8A8:
+        case PF_X8R8G8B8:
+        case PF_X8B8G8R8:
+            break;
+        default:
+            return PF_UNKNOWN;
+        }
+
+        static const PixelFormat alphaFormats[] = { PF_DXT5, PF_ETC2_RGBA8 };
+        static const PixelFormat opaqueFormats[] = { PF_DXT1, PF_ETC2_RGB8, PF_ETC1_RGB8 };
+        const bool alpha = PixelUtil::hasAlpha(srcFormat);
+        const PixelFormat* formats = alpha ? alphaFormats : opaqueFormats;
+        const size_t count = alpha ? 2 : 3;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (isFormatSupported(ttype, formats[i], usage))
+                return formats[i];
+        }
+        return PF_UNKNOWN;
+    }
+    //-----------------------------------------------------------------------
+    String TextureManager::getCompressionCachePath(const Image& src, PixelFormat format, uint32 numMipmaps) const
+    {
+        uint64 key[6];
+        MurmurHash3_x64_128(src.getData(), static_cast<int>(src.getSize()), 0, key);
+        uint32* params = reinterpret_cast<uint32*>(key + 2);
+        params[0] = COMPRESSION_CACHE_VERSION;
+        params[1] = src.getWidth();
+        params[2] = src.getHeight();
+        params[3] = src.getDepth();
+        params[4] = static_cast<uint32>(src.getNumFaces());
+        params[5] = src.getFormat();
+        params[6] = format;
+        params[7] = numMipmaps;
+
+        uint64 hash[2];
+        MurmurHash3_x64_128(key, sizeof(key), 0, hash);
+        StringStream name;
+        name << mCompressionCacheDirectory << "/" << std::hex << std::setfill('0')
+             << std::setw(16) << hash[0] << std::setw(16) << hash[1] << ".texcache";
+        return name.str();
+    }
+    //-----------------------------------------------------------------------
+    bool TextureManager::_compressImage(const Image& src, TextureType ttype, int usage,
+        uint32 numMipmaps, Image& dest)
+    {
+        // Block formats can't be rendered to, and the top level must be whole blocks
+        if (!mCompressOnLoad || (usage & TU_RENDERTARGET) ||
+            src.getWidth() % 4 != 0 || src.getHeight() % 4 != 0)
+            return false;
+
+        const PixelFormat format = getCompressedFormat(ttype, src.getFormat(), usage);
+        if (format == PF_UNKNOWN)
+            return false;
+
+        // Keep the image's own mipmaps, otherwise make as many as were asked for
+        uint32 mips = src.getNumMipmaps();
+        if (mips == 0)
+        {
+            uint32 maxMips = 0;
+            for (uint32 size = std::max(std::max(src.getWidth(), src.getHeight()), src.getDepth());
+                size > 1; size /= 2)
+                ++maxMips;
+            mips = std::min(numMipmaps, maxMips);
+        }
+
+        const size_t faces = src.getNumFaces();
+        const size_t size = Image::calculateSize(mips, faces, src.getWidth(), src.getHeight(),
+            src.getDepth(), format);
+        dest.loadDynamicImage(OGRE_ALLOC_T(uchar, size, MEMCATEGORY_GENERAL), src.getWidth(),
+            src.getHeight(), src.getDepth(), format, true, faces, mips);
+
+        String cachePath;
+        if (!mCompressionCacheDirectory.empty())
+        {
+            cachePath = getCompressionCachePath(src, format, mips);
+            std::ifstream in(cachePath.c_str(), std::ios_base::binary | std::ios_base::in);
+            uint32 header[4] = { 0, 0, 0, 0 };
+            if (in.read(reinterpret_cast<char*>(header), sizeof(header)) &&
+                header[0] == COMPRESSION_CACHE_MAGIC && header[1] == COMPRESSION_CACHE_VERSION &&
+                header[2] == static_cast<uint32>(format) && header[3] == size &&
+                in.read(reinterpret_cast<char*>(dest.getData()), size))
+            {
+                return true;
+            }
+        }
+
+        const Image* levels = &src;
+        Image generated;
+        if (src.getNumMipmaps() == 0 && mips > 0)
+        {
+            generated = src;
+            generated.generateMipmaps();
+            levels = &generated;
+        }
+        for (size_t face = 0; face < faces; ++face)
+        {
+            for (uint32 mip = 0; mip <= mips; ++mip)
+                ImageCompressor::compress(levels->getPixelBox(face, mip), dest.getPixelBox(face, mip));
+        }
+
+        if (!cachePath.empty())
+        {
+            // Write under a temporary name so a partial file is never picked up
+            FileSystemLayer::createDirectory(mCompressionCacheDirectory);
+            String tempPath = cachePath + ".tmp";
+            const uint32 header[4] = { COMPRESSION_CACHE_MAGIC, COMPRESSION_CACHE_VERSION,
+                static_cast<uint32>(format), static_cast<uint32>(size) };
+            std::ofstream out(tempPath.c_str(), std::ios_base::binary | std::ios_base::out);
+            out.write(reinterpret_cast<const char*>(header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(dest.getData()), size);
+            out.close();
+            if (!out || !FileSystemLayer::renameFile(tempPath, cachePath))
+                FileSystemLayer::removeFile(tempPath);
+        }
+        return true;
+    }
 }
@@ -44,7 +44,9 @@ namespace Ogre {
         mDeleteDclBinding = true;
         vertexCount = 0;
         vertexStart = 0;
+        subAllocated = false;
         hwAnimDataItemsUsed = 0;
+        hwPoseTexture = false;
 
     }
     //---------------------------------------------------------------------
@@ -57,11 +59,16 @@ namespace Ogre {
         mDeleteDclBinding = false;
         vertexCount = 0;
         vertexStart = 0;
+        subAllocated = false;
         hwAnimDataItemsUsed = 0;
+        hwPoseTexture = false;
     }
     //-----------------------------------------------------------------------
     VertexData::~VertexData()
     {
+        if (subAllocated)
+            mMgr->_freeSubAllocatedVertexData(this);
+
         if (mDeleteDclBinding)
         {
             mMgr->destroyVertexBufferBinding(vertexBufferBinding);
@@ -128,11 +135,41 @@ namespace Ogre {
         // copy anim data
         dest->hwAnimationDataList = hwAnimationDataList;
         dest->hwAnimDataItemsUsed = hwAnimDataItemsUsed;
+        dest->hwPoseTexture = hwPoseTexture;
+        dest->hwPoseWeights = hwPoseWeights;
 
         
         return dest;
     }
     //-----------------------------------------------------------------------
+    void VertexData::releaseSubAllocation(void)
+    {
+        if (!subAllocated)
+            return;
+
+        typedef map<unsigned short, HardwareVertexBufferSharedPtr>::type BufferMap;
+        BufferMap ownBuffers;
+        const VertexBufferBinding::VertexBufferBindingMap& bindings = vertexBufferBinding->getBindings();
+        VertexBufferBinding::VertexBufferBindingMap::const_iterator i;
+        for (i = bindings.begin(); i != bindings.end(); ++i)
+        {
+            const HardwareVertexBufferSharedPtr& shared = i->second;
+            size_t vertexSize = shared->getVertexSize();
+            HardwareVertexBufferSharedPtr own = mMgr->createVertexBuffer(
+                vertexSize, vertexCount, shared->getUsage(), shared->hasShadowBuffer());
+            own->copyData(*shared, vertexStart * vertexSize, 0, vertexCount * vertexSize, true);
+            ownBuffers[i->first] = own;
+        }
+
+        // Give the range back while the shared buffers are still bound
+        mMgr->_freeSubAllocatedVertexData(this);
+        for (BufferMap::iterator b = ownBuffers.begin(); b != ownBuffers.end(); ++b)
+        {
+            vertexBufferBinding->setBinding(b->first, b->second);
+        }
+        vertexStart = 0;
+    }
+    //-----------------------------------------------------------------------
     void VertexData::prepareForShadowVolume(void)
     {
         /* NOTE
@@ -665,6 +702,168 @@ namespace Ogre {
         } // each buffer
 
 
+    }
+    //-----------------------------------------------------------------------
+    void VertexData::quantise(bool normals, bool texCoords)
+    {
+        // Copy, the declaration is modified in place at the end
+        const VertexDeclaration::VertexElementList oldElems = 
+            vertexDeclaration->getElements();
+
+        // Work out the target type of each element, and the new layout of every buffer
+        vector<VertexElementType>::type newTypes;
+        map<unsigned short, size_t>::type newVertexSizes;
+        set<unsigned short>::type changedSources;
+        VertexDeclaration::VertexElementList::const_iterator ai;
+        for (ai = oldElems.begin(); ai != oldElems.end(); ++ai)
+        {
+            const VertexElement& elem = *ai;
+            VertexElementType newType = elem.getType();
+            switch (elem.getSemantic())
+            {
+            case VES_NORMAL:
+            case VES_TANGENT:
+            case VES_BINORMAL:
+                if (normals && (newType == VET_FLOAT3 || newType == VET_FLOAT4))
+                    newType = VET_SHORT4_NORM;
+                break;
+            case VES_TEXTURE_COORDINATES:
+                if (texCoords && newType == VET_FLOAT2)
+                    newType = VET_HALF2;
+                else if (texCoords && newType == VET_FLOAT4)
+                    newType = VET_HALF4;
+                break;
+            default:
+                break;
+            }
+
+            newTypes.push_back(newType);
+            newVertexSizes[elem.getSource()] += VertexElement::getTypeSize(newType);
+            if (newType != elem.getType())
+                changedSources.insert(elem.getSource());
+        }
+
+        if (changedSources.empty())
+            return;
+
+        // Pack the elements of rebuilt buffers in declaration order
+        VertexDeclaration::VertexElementList newElems;
+        map<unsigned short, size_t>::type offsets;
+        unsigned short elemIndex = 0;
+        for (ai = oldElems.begin(); ai != oldElems.end(); ++ai, ++elemIndex)
+        {
+            const VertexElement& elem = *ai;
+            if (changedSources.find(elem.getSource()) == changedSources.end())
+            {
+                newElems.push_back(elem);
+                continue;
+            }
+
+            size_t& offset = offsets[elem.getSource()];
+            newElems.push_back(VertexElement(elem.getSource(), offset,
+                newTypes[elemIndex], elem.getSemantic(), elem.getIndex()));
+            offset += VertexElement::getTypeSize(newTypes[elemIndex]);
+        }
+
+        HardwareBufferManagerBase* pManager = mMgr ? mMgr :
+            HardwareBufferManager::getSingletonPtr();
+        set<unsigned short>::type::iterator si;
+        for (si = changedSources.begin(); si != changedSources.end(); ++si)
+        {
+            unsigned short source = *si;
+            HardwareVertexBufferSharedPtr oldBuf = vertexBufferBinding->getBuffer(source);
+            HardwareVertexBufferSharedPtr newBuf = pManager->createVertexBuffer(
+                newVertexSizes[source], oldBuf->getNumVertices(), oldBuf->getUsage(),
+                oldBuf->hasShadowBuffer());
+
+            const unsigned char* pSrc = static_cast<const unsigned char*>(
+                oldBuf->lock(HardwareBuffer::HBL_READ_ONLY));
+            unsigned char* pDst = static_cast<unsigned char*>(
+                newBuf->lock(HardwareBuffer::HBL_DISCARD));
+
+            for (size_t v = 0; v < oldBuf->getNumVertices(); ++v)
+            {
+                VertexDeclaration::VertexElementList::const_iterator ni = newElems.begin();
+                for (ai = oldElems.begin(); ai != oldElems.end(); ++ai, ++ni)
+                {
+                    const VertexElement& srcElem = *ai;
+                    const VertexElement& dstElem = *ni;
+                    if (srcElem.getSource() != source)
+                        continue;
+
+                    const unsigned char* pSrcElem = pSrc + srcElem.getOffset();
+                    unsigned char* pDstElem = pDst + dstElem.getOffset();
+                    unsigned short count = VertexElement::getTypeCount(srcElem.getType());
+                    if (dstElem.getType() == VET_SHORT4_NORM && srcElem.getType() != VET_SHORT4_NORM)
+                    {
+                        const float* pf = reinterpret_cast<const float*>(pSrcElem);
+                        int16* ps = reinterpret_cast<int16*>(pDstElem);
+                        for (unsigned short c = 0; c < 4; ++c)
+                        {
+                            float f = c < count ? Math::Clamp(pf[c], -1.0f, 1.0f) : 0.0f;
+                            ps[c] = static_cast<int16>(Math::Floor(f * 32767.0f + 0.5f));
+                        }
+                    }
+                    else if ((dstElem.getType() == VET_HALF2 || dstElem.getType() == VET_HALF4) &&
+                        dstElem.getType() != srcElem.getType())
+                    {
+                        const float* pf = reinterpret_cast<const float*>(pSrcElem);
+                        uint16* ph = reinterpret_cast<uint16*>(pDstElem);
+                        for (unsigned short c = 0; c < count; ++c)
+                            ph[c] = Bitwise::floatToHalf(pf[c]);
+                    }
+                    else
+                    {
+                        memcpy(pDstElem, pSrcElem, srcElem.getSize());
+                    }
+                }
+                pSrc += oldBuf->getVertexSize();
+                pDst += newBuf->getVertexSize();
+            }
+
+            newBuf->unlock();
+            oldBuf->unlock();
+            vertexBufferBinding->setBinding(source, newBuf);
+        }
+
+        // Modify the elements to reflect the new types and offsets
+        VertexDeclaration::VertexElementList::const_iterator ni;
+        elemIndex = 0;
+        for (ni = newElems.begin(); ni != newElems.end(); ++ni, ++elemIndex)
+        {
+            vertexDeclaration->modifyElement(elemIndex, ni->getSource(), ni->getOffset(),
+                ni->getType(), ni->getSemantic(), ni->getIndex());
+        }
+    }
+    //-----------------------------------------------------------------------
+    void VertexData::reorderVertices(const vector<uint32>::type& vertexRemap)
+    {
+        assert(vertexRemap.size() == vertexCount && "Remap must cover every vertex");
+
+        // The same buffer may be bound more than once
+        set<HardwareVertexBuffer*>::type done;
+        vector<unsigned char>::type scratch;
+        const VertexBufferBinding::VertexBufferBindingMap& bindings =
+            vertexBufferBinding->getBindings();
+        VertexBufferBinding::VertexBufferBindingMap::const_iterator i, iend;
+        iend = bindings.end();
+        for (i = bindings.begin(); i != iend; ++i)
+        {
+            HardwareVertexBuffer* buf = i->second.get();
+            if (!done.insert(buf).second)
+                continue;
+
+            size_t vertexSize = buf->getVertexSize();
+            size_t length = vertexCount * vertexSize;
+            unsigned char* pData = static_cast<unsigned char*>(
+                buf->lock(vertexStart * vertexSize, length, HardwareBuffer::HBL_NORMAL));
+            scratch.assign(pData, pData + length);
+            for (size_t v = 0; v < vertexCount; ++v)
+            {
+                memcpy(pData + vertexRemap[v] * vertexSize, &scratch[v * vertexSize], vertexSize);
+            }
+            buf->unlock();
+        }
     }
     //-----------------------------------------------------------------------
     ushort VertexData::allocateHardwareAnimationElements(ushort count, bool animateNormals)
@@ -701,11 +900,13 @@ namespace Ogre {
     {
         indexCount = 0;
         indexStart = 0;
-        
+        subAllocated = false;
     }
     //-----------------------------------------------------------------------
     IndexData::~IndexData()
     {
+        if (subAllocated)
+            HardwareBufferManager::getSingleton()._freeSubAllocatedIndexData(this);
     }
     //-----------------------------------------------------------------------
     IndexData* IndexData::clone(bool copyData, HardwareBufferManagerBase* mgr) const
@@ -932,6 +1133,312 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
+    // Local utilities for the vertex cache and overdraw optimisers, which
+    // work on a copy of the indexes in 32-bit form
+    static void readIndexes(const IndexData* indexData, vector<uint32>::type& indexes)
+    {
+        indexes.resize(indexData->indexCount);
+        const HardwareIndexBufferSharedPtr& buf = indexData->indexBuffer;
+        size_t indexSize = buf->getIndexSize();
+        void* pData = buf->lock(indexData->indexStart * indexSize,
+            indexData->indexCount * indexSize, HardwareBuffer::HBL_READ_ONLY);
+        if (buf->getType() == HardwareIndexBuffer::IT_16BIT)
+        {
+            const uint16* pShort = static_cast<const uint16*>(pData);
+            for (size_t i = 0; i < indexData->indexCount; ++i)
+                indexes[i] = pShort[i];
+        }
+        else
+        {
+            memcpy(&indexes[0], pData, indexData->indexCount * sizeof(uint32));
+        }
+        buf->unlock();
+    }
+    //-----------------------------------------------------------------------
+    static void writeIndexes(IndexData* indexData, const vector<uint32>::type& indexes)
+    {
+        const HardwareIndexBufferSharedPtr& buf = indexData->indexBuffer;
+        size_t indexSize = buf->getIndexSize();
+        void* pData = buf->lock(indexData->indexStart * indexSize,
+            indexData->indexCount * indexSize, HardwareBuffer::HBL_NORMAL);
+        if (buf->getType() == HardwareIndexBuffer::IT_16BIT)
+        {
+            uint16* pShort = static_cast<uint16*>(pData);
+            for (size_t i = 0; i < indexData->indexCount; ++i)
+                pShort[i] = static_cast<uint16>(indexes[i]);
+        }
+        else
+        {
+            memcpy(pData, &indexes[0], indexData->indexCount * sizeof(uint32));
+        }
+        buf->unlock();
+    }
+    //-----------------------------------------------------------------------
+    // Vertex score from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+    static float forsythVertexScore(int cachePosition, uint32 remainingTriangles, unsigned int cacheSize)
+    {
+        // No triangles left to use this vertex
+        if (remainingTriangles == 0)
+            return -1.0f;
+
+        float score = 0.0f;
+        if (cachePosition >= 0)
+        {
+            if (cachePosition < 3)
+            {
+                // Vertices of the last triangle get a fixed score, so that
+                // the next triangle doesn't simply reuse them all
+                score = 0.75f;
+            }
+            else
+            {
+                float scaler = 1.0f / (cacheSize - 3);
+                score = std::pow(1.0f - (cachePosition - 3) * scaler, 1.5f);
+            }
+        }
+        // Boost vertices with few triangles left, so that isolated
+        // triangles get finished instead of being left until the end
+        score += 2.0f / std::sqrt(static_cast<float>(remainingTriangles));
+        return score;
+    }
+    //-----------------------------------------------------------------------
+    void IndexData::optimiseVertexCache(unsigned int cacheSize)
+    {
+        if (indexBuffer->isLocked() || indexCount < 3) return;
+        cacheSize = std::max(cacheSize, 4u);
+
+        vector<uint32>::type indexes;
+        readIndexes(this, indexes);
+
+        size_t nTriangles = indexCount / 3;
+        uint32 nVertices = *std::max_element(indexes.begin(), indexes.begin() + nTriangles * 3) + 1;
+
+        // Build the vertex to triangle adjacency; the first liveTriangles[v]
+        // entries of each vertex's range are the triangles not yet emitted
+        vector<uint32>::type liveTriangles(nVertices, 0);
+        vector<uint32>::type adjacencyStart(nVertices + 1, 0);
+        vector<uint32>::type adjacency(nTriangles * 3);
+        size_t i, j;
+        for (i = 0; i < nTriangles * 3; ++i)
+            ++liveTriangles[indexes[i]];
+        for (i = 0; i < nVertices; ++i)
+            adjacencyStart[i + 1] = adjacencyStart[i] + liveTriangles[i];
+        vector<uint32>::type fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+        for (i = 0; i < nTriangles * 3; ++i)
+            adjacency[fill[indexes[i]]++] = static_cast<uint32>(i / 3);
+
+        vector<int>::type cachePosition(nVertices, -1);
+        vector<float>::type vertexScore(nVertices);
+        for (i = 0; i < nVertices; ++i)
+            vertexScore[i] = forsythVertexScore(-1, liveTriangles[i], cacheSize);
+
+        vector<unsigned char>::type emitted(nTriangles, 0);
+
+        vector<uint32>::type cache, newCache;
+        cache.reserve(cacheSize + 3);
+        newCache.reserve(cacheSize + 3);
+        vector<uint32>::type output;
+        output.reserve(nTriangles * 3);
+
+        size_t scanPos = 0;
+        long bestTriangle = -1;
+        while (output.size() < nTriangles * 3)
+        {
+            if (bestTriangle < 0)
+            {
+                // Nothing adjacent to the cache is left, start somewhere new
+                while (emitted[scanPos])
+                    ++scanPos;
+                bestTriangle = static_cast<long>(scanPos);
+            }
+
+            const uint32* tri = &indexes[bestTriangle * 3];
+            emitted[bestTriangle] = 1;
+            newCache.clear();
+            for (j = 0; j < 3; ++j)
+            {
+                uint32 v = tri[j];
+                output.push_back(v);
+
+                // Remove the triangle from the vertex's live adjacency
+                uint32* adj = &adjacency[adjacencyStart[v]];
+                uint32 live = liveTriangles[v];
+                for (uint32 k = 0; k < live; ++k)
+                {
+                    if (adj[k] == static_cast<uint32>(bestTriangle))
+                    {
+                        std::swap(adj[k], adj[live - 1]);
+                        --liveTriangles[v];
+                        break;
+                    }
+                }
+                if (std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+                    newCache.push_back(v);
+            }
+            for (j = 0; j < cache.size(); ++j)
+            {
+                if (std::find(newCache.begin(), newCache.end(), cache[j]) == newCache.end())
+                    newCache.push_back(cache[j]);
+            }
+
+            // Rescore everything which was or is in the cache
+            for (j = 0; j < newCache.size(); ++j)
+            {
+                uint32 v = newCache[j];
+                cachePosition[v] = j < cacheSize ? static_cast<int>(j) : -1;
+                vertexScore[v] = forsythVertexScore(cachePosition[v], liveTriangles[v], cacheSize);
+            }
+
+            float bestScore = -1.0f;
+            bestTriangle = -1;
+            for (j = 0; j < newCache.size(); ++j)
+            {
+                uint32 v = newCache[j];
+                const uint32* adj = &adjacency[adjacencyStart[v]];
+                for (uint32 k = 0; k < liveTriangles[v]; ++k)
+                {
+                    uint32 t = adj[k];
+                    float score = vertexScore[indexes[t * 3]] +
+                        vertexScore[indexes[t * 3 + 1]] + vertexScore[indexes[t * 3 + 2]];
+                    if (score > bestScore)
+                    {
+                        bestScore = score;
+                        bestTriangle = static_cast<long>(t);
+                    }
+                }
+            }
+
+            if (newCache.size() > cacheSize)
+                newCache.resize(cacheSize);
+            cache.swap(newCache);
+        }
+
+        // Any trailing indexes which don't form a triangle are kept as they are
+        std::copy(output.begin(), output.end(), indexes.begin());
+        writeIndexes(this, indexes);
+    }
+    //-----------------------------------------------------------------------
+    void IndexData::optimiseOverdraw(const VertexData* vertexData, unsigned int cacheSize)
+    {
+        if (indexBuffer->isLocked() || indexCount < 3) return;
+
+        const VertexElement* posElem =
+            vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        if (!posElem || posElem->getType() != VET_FLOAT3)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Overdraw optimisation requires VET_FLOAT3 positions",
+                "IndexData::optimiseOverdraw");
+        }
+
+        vector<uint32>::type indexes;
+        readIndexes(this, indexes);
+        size_t nTriangles = indexCount / 3;
+        size_t i, j;
+        for (i = 0; i < nTriangles * 3; ++i)
+        {
+            if (indexes[i] >= vertexData->vertexCount)
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                    "Index out of range of the vertex data",
+                    "IndexData::optimiseOverdraw");
+            }
+        }
+
+        // Fetch positions
+        vector<Vector3>::type positions(vertexData->vertexCount);
+        HardwareVertexBufferSharedPtr vbuf =
+            vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+        unsigned char* pVertex = static_cast<unsigned char*>(
+            vbuf->lock(vertexData->vertexStart * vbuf->getVertexSize(),
+                vertexData->vertexCount * vbuf->getVertexSize(), HardwareBuffer::HBL_READ_ONLY));
+        for (i = 0; i < vertexData->vertexCount; ++i, pVertex += vbuf->getVertexSize())
+        {
+            float* pFloat;
+            posElem->baseVertexPointerToElement(pVertex, &pFloat);
+            positions[i] = Vector3(pFloat[0], pFloat[1], pFloat[2]);
+        }
+        vbuf->unlock();
+
+        // Split into clusters wherever a triangle misses the cache with every
+        // vertex. A vertex is in the FIFO if fewer than cacheSize misses have
+        // happened since it was last loaded.
+        vector<size_t>::type clusterStart;
+        vector<size_t>::type loadTime(vertexData->vertexCount, 0);
+        size_t time = cacheSize + 1;
+        for (i = 0; i < nTriangles; ++i)
+        {
+            unsigned int misses = 0;
+            for (j = 0; j < 3; ++j)
+            {
+                uint32 v = indexes[i * 3 + j];
+                if (time - loadTime[v] > cacheSize)
+                {
+                    loadTime[v] = time++;
+                    ++misses;
+                }
+            }
+            if (i == 0 || misses == 3)
+                clusterStart.push_back(i);
+        }
+        clusterStart.push_back(nTriangles);
+        size_t nClusters = clusterStart.size() - 1;
+        if (nClusters < 2) return;
+
+        // Area weighted centroid and summed normal of each cluster
+        vector<Vector3>::type clusterCentroid(nClusters, Vector3::ZERO);
+        vector<Vector3>::type clusterNormal(nClusters, Vector3::ZERO);
+        vector<Real>::type clusterArea(nClusters, 0);
+        Vector3 meshCentroid = Vector3::ZERO;
+        Real meshArea = 0;
+        for (size_t c = 0; c < nClusters; ++c)
+        {
+            for (i = clusterStart[c]; i < clusterStart[c + 1]; ++i)
+            {
+                const Vector3& p0 = positions[indexes[i * 3]];
+                const Vector3& p1 = positions[indexes[i * 3 + 1]];
+                const Vector3& p2 = positions[indexes[i * 3 + 2]];
+                Vector3 normal = (p1 - p0).crossProduct(p2 - p0);
+                Real area = normal.length();
+                Vector3 centre = (p0 + p1 + p2) / 3;
+                clusterCentroid[c] += centre * area;
+                clusterNormal[c] += normal;
+                clusterArea[c] += area;
+            }
+            meshCentroid += clusterCentroid[c];
+            meshArea += clusterArea[c];
+        }
+        if (meshArea <= 0) return;
+        meshCentroid /= meshArea;
+
+        // Sort clusters facing away from the centre to the front
+        typedef std::pair<Real, size_t> ClusterSortKey;
+        vector<ClusterSortKey>::type order(nClusters);
+        for (size_t c = 0; c < nClusters; ++c)
+        {
+            Real sortKey = 0;
+            if (clusterArea[c] > 0)
+            {
+                Vector3 centroid = clusterCentroid[c] / clusterArea[c];
+                sortKey = (centroid - meshCentroid).dotProduct(clusterNormal[c].normalisedCopy());
+            }
+            order[c] = ClusterSortKey(-sortKey, c);
+        }
+        std::stable_sort(order.begin(), order.end());
+
+        vector<uint32>::type output;
+        output.reserve(indexCount);
+        for (size_t c = 0; c < nClusters; ++c)
+        {
+            size_t cluster = order[c].second;
+            output.insert(output.end(), indexes.begin() + clusterStart[cluster] * 3,
+                indexes.begin() + clusterStart[cluster + 1] * 3);
+        }
+        std::copy(output.begin(), output.end(), indexes.begin());
+        writeIndexes(this, indexes);
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
     void VertexCacheProfiler::profile(const HardwareIndexBufferSharedPtr& indexBuffer)
     {
         if (indexBuffer->isLocked()) return;
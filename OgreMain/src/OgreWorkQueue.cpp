@@ -30,8 +30,326 @@ THE SOFTWARE.
 #include "OgreLogManager.h"
 #include "OgreRoot.h"
 #include "OgreTimer.h"
+#include "OgreAtomicScalar.h"
+#include "OgreProfiler.h"
 
 namespace Ogre {
+    namespace {
+        /** Shared state of a single parallelFor call.
+        @remarks
+            Held by SharedPtr so that a worker which only picks up its request
+            after the calling thread has returned still sees valid state; such a
+            worker finds no chunks left and never touches the task.
+        */
+        struct ParallelForJob : public UtilityAlloc
+        {
+            WorkQueue::ParallelTask* task;
+            size_t count;
+            size_t grainSize;
+            size_t numChunks;
+            AtomicScalar<size_t> nextChunk;
+            AtomicScalar<size_t> chunksDone;
+            String error; // Guarded by mutex
+            OGRE_MUTEX(mutex);
+            OGRE_THREAD_SYNCHRONISER(sync);
+
+            ParallelForJob(WorkQueue::ParallelTask* t, size_t c, size_t grain)
+                : task(t), count(c), grainSize(grain)
+                , numChunks((c + grain - 1) / grain), nextChunk(0), chunksDone(0)
+            {
+            }
+
+            /// Process chunks until none are left to claim
+            void run()
+            {
+                while (true)
+                {
+                    size_t chunk = nextChunk++;
+                    if (chunk >= numChunks)
+                        return;
+
+                    size_t begin = chunk * grainSize;
+                    try
+                    {
+                        task->execute(begin, std::min(begin + grainSize, count));
+                    }
+                    catch (std::exception& e)
+                    {
+                        OGRE_LOCK_MUTEX(mutex);
+                        error = e.what();
+                    }
+
+                    if (++chunksDone == numChunks)
+                    {
+                        OGRE_LOCK_MUTEX(mutex);
+                        OGRE_THREAD_NOTIFY_ALL(sync);
+                    }
+                }
+            }
+
+            /// Block until every chunk has been processed
+            void wait()
+            {
+#if OGRE_THREAD_SUPPORT
+                OGRE_LOCK_MUTEX_NAMED(mutex, lock);
+                while (chunksDone.get() < numChunks)
+                {
+                    OGRE_THREAD_WAIT(sync, mutex, lock);
+                }
+#endif
+            }
+        };
+        typedef SharedPtr<ParallelForJob> ParallelForJobPtr;
+
+        /// Request data for the worker side of parallelFor
+        struct ParallelForRequest
+        {
+            ParallelForJobPtr job;
+
+            ParallelForRequest(const ParallelForJobPtr& j) : job(j) {}
+
+            friend std::ostream& operator<<(std::ostream& o, const ParallelForRequest&)
+            { return o; }
+        };
+
+        /// Request data for addTask
+        struct TaskRequest
+        {
+            WorkQueue::TaskPtr task;
+
+            TaskRequest(const WorkQueue::TaskPtr& t) : task(t) {}
+
+            friend std::ostream& operator<<(std::ostream& o, const TaskRequest&)
+            { return o; }
+        };
+    }
+    //---------------------------------------------------------------------
+    struct WorkQueue::TaskGroup::State : public UtilityAlloc
+    {
+        struct Node
+        {
+            Task* task;
+            size_t numPrerequisites;
+            size_t pending; // Guarded by mutex
+            vector<TaskID>::type successors;
+        };
+        vector<Node>::type nodes;
+        deque<TaskID>::type ready; // Guarded by mutex
+        size_t remaining; // Guarded by mutex
+        String error; // Guarded by mutex
+        OGRE_MUTEX(mutex);
+        OGRE_THREAD_SYNCHRONISER(sync);
+
+        State() : remaining(0) {}
+
+        /** Run one ready task, if any.
+        @param newReady Receives the number of tasks the finished task started
+        */
+        bool runOne(size_t& newReady)
+        {
+            TaskID id;
+            {
+                OGRE_LOCK_MUTEX(mutex);
+                if (ready.empty())
+                    return false;
+                id = ready.front();
+                ready.pop_front();
+            }
+
+            Node& node = nodes[id];
+            try
+            {
+                node.task->execute();
+            }
+            catch (std::exception& e)
+            {
+                OGRE_LOCK_MUTEX(mutex);
+                if (error.empty())
+                    error = e.what();
+            }
+
+            OGRE_LOCK_MUTEX(mutex);
+            newReady = 0;
+            for (size_t i = 0; i < node.successors.size(); ++i)
+            {
+                if (--nodes[node.successors[i]].pending == 0)
+                {
+                    ready.push_back(node.successors[i]);
+                    ++newReady;
+                }
+            }
+            if (--remaining == 0 || newReady)
+                OGRE_THREAD_NOTIFY_ALL(sync);
+            return true;
+        }
+    };
+    //---------------------------------------------------------------------
+    namespace {
+        /// Runs the ready tasks of a TaskGroup on a worker, until there are none left
+        class TaskGroupHelper : public WorkQueue::Task, public UtilityAlloc
+        {
+            SharedPtr<WorkQueue::TaskGroup::State> mState;
+            WorkQueue* mQueue;
+        public:
+            TaskGroupHelper(const SharedPtr<WorkQueue::TaskGroup::State>& state, WorkQueue* queue)
+                : mState(state), mQueue(queue) {}
+
+            /// Queue helpers for tasks which just became ready, keeping one for the calling thread
+            static void queueHelpers(const SharedPtr<WorkQueue::TaskGroup::State>& state,
+                WorkQueue* queue, size_t count)
+            {
+                for (size_t i = 1; i < count; ++i)
+                    queue->addTask(WorkQueue::TaskPtr(OGRE_NEW TaskGroupHelper(state, queue)));
+            }
+
+            void execute()
+            {
+                size_t newReady;
+                while (mState->runOne(newReady))
+                    queueHelpers(mState, mQueue, newReady);
+            }
+        };
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::TaskGroup::TaskGroup(WorkQueue* queue)
+        : mQueue(queue), mState(OGRE_NEW State()), mRunning(false)
+    {
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::TaskGroup::~TaskGroup()
+    {
+        if (mRunning)
+        {
+            try
+            {
+                wait();
+            }
+            catch (Exception&)
+            {
+                // already reported through the log
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::TaskGroup::TaskID WorkQueue::TaskGroup::add(Task* task)
+    {
+        assert(!mRunning && "Cannot add tasks to a running TaskGroup");
+        State::Node node;
+        node.task = task;
+        node.numPrerequisites = 0;
+        node.pending = 0;
+        mState->nodes.push_back(node);
+        return mState->nodes.size() - 1;
+    }
+    //---------------------------------------------------------------------
+    void WorkQueue::TaskGroup::addDependency(TaskID task, TaskID prerequisite)
+    {
+        assert(!mRunning && "Cannot add dependencies to a running TaskGroup");
+        if (task >= mState->nodes.size() || prerequisite >= mState->nodes.size() ||
+            task == prerequisite)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid task dependency",
+                "WorkQueue::TaskGroup::addDependency");
+        }
+        mState->nodes[prerequisite].successors.push_back(task);
+        ++mState->nodes[task].numPrerequisites;
+    }
+    //---------------------------------------------------------------------
+    void WorkQueue::TaskGroup::clear()
+    {
+        assert(!mRunning && "Cannot clear a running TaskGroup");
+        mState->nodes.clear();
+    }
+    //---------------------------------------------------------------------
+    size_t WorkQueue::TaskGroup::getNumTasks() const
+    {
+        return mState->nodes.size();
+    }
+    //---------------------------------------------------------------------
+    void WorkQueue::TaskGroup::run()
+    {
+        if (mRunning)
+            return;
+
+        State& state = *mState;
+        size_t numTasks = state.nodes.size();
+
+        // Check that every task can be reached from the ones without prerequisites
+        vector<size_t>::type pending(numTasks);
+        deque<TaskID>::type ready;
+        for (TaskID i = 0; i < numTasks; ++i)
+        {
+            pending[i] = state.nodes[i].numPrerequisites;
+            if (!pending[i])
+                ready.push_back(i);
+        }
+        size_t reached = 0;
+        for (deque<TaskID>::type::iterator i = ready.begin(); i != ready.end(); ++i, ++reached)
+        {
+            const vector<TaskID>::type& successors = state.nodes[*i].successors;
+            for (size_t j = 0; j < successors.size(); ++j)
+            {
+                if (--pending[successors[j]] == 0)
+                    ready.push_back(successors[j]);
+            }
+        }
+        if (reached != numTasks)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "The task dependencies form a cycle",
+                "WorkQueue::TaskGroup::run");
+        }
+
+        size_t numReady = 0;
+        {
+            OGRE_LOCK_MUTEX(state.mutex);
+            state.ready.clear();
+            state.error.clear();
+            state.remaining = numTasks;
+            for (TaskID i = 0; i < numTasks; ++i)
+            {
+                state.nodes[i].pending = state.nodes[i].numPrerequisites;
+                if (!state.nodes[i].pending)
+                {
+                    state.ready.push_back(i);
+                    ++numReady;
+                }
+            }
+        }
+        mRunning = true;
+
+        // The thread calling wait() takes one of them
+        TaskGroupHelper::queueHelpers(mState, mQueue, numReady);
+    }
+    //---------------------------------------------------------------------
+    void WorkQueue::TaskGroup::wait()
+    {
+        run();
+
+        State& state = *mState;
+        while (true)
+        {
+            size_t newReady;
+            if (state.runOne(newReady))
+            {
+                TaskGroupHelper::queueHelpers(mState, mQueue, newReady);
+                continue;
+            }
+
+            OGRE_LOCK_MUTEX_NAMED(state.mutex, lock);
+            if (!state.remaining)
+                break;
+            if (state.ready.empty())
+                OGRE_THREAD_WAIT(state.sync, state.mutex, lock);
+        }
+        mRunning = false;
+
+        if (!state.error.empty())
+        {
+            LogManager::getSingleton().stream() << "A task failed: " << state.error;
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, "A task failed: " + state.error,
+                "WorkQueue::TaskGroup::wait");
+        }
+    }
     //---------------------------------------------------------------------
     uint16 WorkQueue::getChannel(const String& channelName)
     {
@@ -45,8 +363,20 @@ namespace Ogre {
         return i->second;
     }
     //---------------------------------------------------------------------
+    void WorkQueue::parallelFor(size_t count, size_t grainSize, ParallelTask* task)
+    {
+        if (count)
+            task->execute(0, count);
+    }
+    //---------------------------------------------------------------------
+    void WorkQueue::addTask(const TaskPtr& task)
+    {
+        task->execute();
+    }
+    //---------------------------------------------------------------------
     WorkQueue::Request::Request(uint16 channel, uint16 rtype, const Any& rData, uint8 retry, RequestID rid)
         : mChannel(channel), mType(rtype), mData(rData), mRetryCount(retry), mID(rid), mAborted(false)
+        , mQueueTime(0)
     {
 
     }
@@ -58,7 +388,7 @@ namespace Ogre {
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     WorkQueue::Response::Response(const Request* rq, bool success, const Any& data, const String& msg)
-        : mRequest(rq), mSuccess(success), mMessages(msg), mData(data)
+        : mRequest(rq), mSuccess(success), mMessages(msg), mData(data), mNext(0)
     {
         
     }
@@ -76,13 +406,29 @@ namespace Ogre {
         , mIsRunning(false)
         , mResposeTimeLimitMS(8)
         , mWorkerFunc(0)
+        , mNextShard(0)
+        , mNextWorkerShard(0)
+        , mWorkStealing(false)
+        , mHasChannelSettings(false)
         , mRequestCount(0)
         , mPaused(false)
         , mAcceptRequests(true)
         , mShuttingDown(false)
         , mIdleThreadRunning(false)
         , mIdleProcessed(0)
+        , mStatisticsEnabled(false)
+        , mStatisticsTimer(0)
+        , mStatisticsStart(0)
     {
+        for (int p = 0; p < RP_COUNT; ++p)
+            mQueuedRequests[p].set(0);
+        mFinishedResponses.set(0);
+        mRequestShards.push_back(OGRE_NEW RequestShard());
+
+        mParallelForChannel = getChannel("Ogre/ParallelFor");
+        addRequestHandler(mParallelForChannel, &mParallelForHandler);
+        mTaskChannel = getChannel("Ogre/Task");
+        addRequestHandler(mTaskChannel, &mTaskHandler);
     }
     //---------------------------------------------------------------------
     const String& DefaultWorkQueueBase::getName() const
@@ -114,12 +460,23 @@ namespace Ogre {
     {
         //shutdown(); // can't call here; abstract function
 
-        for (RequestQueue::iterator i = mRequestQueue.begin(); i != mRequestQueue.end(); ++i)
+        OGRE_DELETE mStatisticsTimer;
+
+        for (RequestShardList::iterator s = mRequestShards.begin(); s != mRequestShards.end(); ++s)
         {
-            OGRE_DELETE (*i);
+            for (int p = 0; p < RP_COUNT; ++p)
+            {
+                RequestQueue& requests = (*s)->requests[p];
+                for (RequestQueue::iterator i = requests.begin(); i != requests.end(); ++i)
+                {
+                    OGRE_DELETE (*i);
+                }
+            }
+            OGRE_DELETE *s;
         }
-        mRequestQueue.clear();
+        mRequestShards.clear();
 
+        collectResponses();
         for (ResponseQueue::iterator i = mResponseQueue.begin(); i != mResponseQueue.end(); ++i)
         {
             OGRE_DELETE (*i);
@@ -127,6 +484,145 @@ namespace Ogre {
         mResponseQueue.clear();
     }
     //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::setChannelPriority(uint16 channel, RequestPriority priority)
+    {
+        OGRE_LOCK_RW_MUTEX_WRITE(mChannelSettingsMutex);
+
+        ChannelSettingsMap::iterator i = mChannelSettings.find(channel);
+        if (i == mChannelSettings.end())
+        {
+            ChannelSettings settings;
+            settings.priority = RP_NORMAL;
+            settings.affinity = (size_t)-1;
+            i = mChannelSettings.insert(ChannelSettingsMap::value_type(channel, settings)).first;
+        }
+        i->second.priority = priority;
+        mHasChannelSettings = true;
+    }
+    //---------------------------------------------------------------------
+    DefaultWorkQueueBase::RequestPriority DefaultWorkQueueBase::getChannelPriority(uint16 channel) const
+    {
+        OGRE_LOCK_RW_MUTEX_READ(mChannelSettingsMutex);
+
+        ChannelSettingsMap::const_iterator i = mChannelSettings.find(channel);
+        return i == mChannelSettings.end() ? RP_NORMAL : i->second.priority;
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::setChannelAffinity(uint16 channel, size_t worker)
+    {
+        OGRE_LOCK_RW_MUTEX_WRITE(mChannelSettingsMutex);
+
+        ChannelSettingsMap::iterator i = mChannelSettings.find(channel);
+        if (i == mChannelSettings.end())
+        {
+            ChannelSettings settings;
+            settings.priority = RP_NORMAL;
+            settings.affinity = (size_t)-1;
+            i = mChannelSettings.insert(ChannelSettingsMap::value_type(channel, settings)).first;
+        }
+        i->second.affinity = worker;
+        mHasChannelSettings = true;
+    }
+    //---------------------------------------------------------------------
+    size_t DefaultWorkQueueBase::getChannelAffinity(uint16 channel) const
+    {
+        OGRE_LOCK_RW_MUTEX_READ(mChannelSettingsMutex);
+
+        ChannelSettingsMap::const_iterator i = mChannelSettings.find(channel);
+        return i == mChannelSettings.end() ? (size_t)-1 : i->second.affinity;
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::setupRequestShards()
+    {
+        size_t count = mWorkStealing ? std::max<size_t>(mWorkerThreadCount, 1) : 1;
+        if (count == mRequestShards.size())
+            return;
+
+        RequestShardList shards;
+        for (size_t i = 0; i < count; ++i)
+            shards.push_back(OGRE_NEW RequestShard());
+
+        // Keep the requests queued before startup, in order
+        for (RequestShardList::iterator s = mRequestShards.begin(); s != mRequestShards.end(); ++s)
+        {
+            for (int p = 0; p < RP_COUNT; ++p)
+            {
+                RequestQueue& requests = (*s)->requests[p];
+                shards[0]->requests[p].insert(shards[0]->requests[p].end(),
+                    requests.begin(), requests.end());
+            }
+            OGRE_DELETE *s;
+        }
+        mRequestShards.swap(shards);
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::pushRequest(Request* req)
+    {
+        RequestPriority priority = RP_NORMAL;
+        size_t affinity = (size_t)-1;
+        if (mHasChannelSettings)
+        {
+            OGRE_LOCK_RW_MUTEX_READ(mChannelSettingsMutex);
+            ChannelSettingsMap::const_iterator i = mChannelSettings.find(req->getChannel());
+            if (i != mChannelSettings.end())
+            {
+                priority = i->second.priority;
+                affinity = i->second.affinity;
+            }
+        }
+
+        size_t numShards = mRequestShards.size();
+        size_t index = 0;
+        if (numShards > 1)
+            index = (affinity != (size_t)-1 ? affinity : mNextShard++) % numShards;
+
+        RequestShard* shard = mRequestShards[index];
+        {
+            OGRE_LOCK_MUTEX(shard->mutex);
+            shard->requests[priority].push_back(req);
+            ++mQueuedRequests[priority];
+        }
+        notifyWorkers();
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::Request* DefaultWorkQueueBase::popRequest(size_t home, RequestShard*& shard)
+    {
+        size_t numShards = mRequestShards.size();
+        for (int p = RP_COUNT - 1; p >= 0; --p)
+        {
+            if (!mQueuedRequests[p].get())
+                continue;
+
+            // Own shard first, then steal from the others
+            for (size_t i = 0; i < numShards; ++i)
+            {
+                RequestShard* s = mRequestShards[(home + i) % numShards];
+                OGRE_LOCK_MUTEX(s->mutex);
+                RequestQueue& requests = s->requests[p];
+                if (requests.empty())
+                    continue;
+
+                Request* req = requests.front();
+                requests.pop_front();
+                --mQueuedRequests[p];
+                s->processing.push_back(req);
+                shard = s;
+                return req;
+            }
+        }
+        return 0;
+    }
+    //---------------------------------------------------------------------
+    bool DefaultWorkQueueBase::hasQueuedRequests() const
+    {
+        for (int p = 0; p < RP_COUNT; ++p)
+        {
+            if (mQueuedRequests[p].get())
+                return true;
+        }
+        return false;
+    }
+    //---------------------------------------------------------------------
     void DefaultWorkQueueBase::addRequestHandler(uint16 channel, RequestHandler* rh)
     {
             OGRE_LOCK_RW_MUTEX_WRITE(mRequestHandlerMutex);
@@ -176,21 +672,19 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::addResponseHandler(uint16 channel, ResponseHandler* rh)
     {
-        ResponseHandlerListByChannel::iterator i = mResponseHandlers.find(channel);
-        if (i == mResponseHandlers.end())
-            i = mResponseHandlers.insert(ResponseHandlerListByChannel::value_type(channel, ResponseHandlerList())).first;
+        if (mResponseHandlers.size() <= channel)
+            mResponseHandlers.resize(channel + 1);
 
-        ResponseHandlerList& handlers = i->second;
+        ResponseHandlerList& handlers = mResponseHandlers[channel];
         if (std::find(handlers.begin(), handlers.end(), rh) == handlers.end())
             handlers.push_back(rh);
     }
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::removeResponseHandler(uint16 channel, ResponseHandler* rh)
     {
-        ResponseHandlerListByChannel::iterator i = mResponseHandlers.find(channel);
-        if (i != mResponseHandlers.end())
+        if (channel < mResponseHandlers.size())
         {
-            ResponseHandlerList& handlers = i->second;
+            ResponseHandlerList& handlers = mResponseHandlers[channel];
             ResponseHandlerList::iterator j = std::find(
                 handlers.begin(), handlers.end(), rh);
             if (j != handlers.end())
@@ -202,37 +696,30 @@ namespace Ogre {
     WorkQueue::RequestID DefaultWorkQueueBase::addRequest(uint16 channel, uint16 requestType, 
         const Any& rData, uint8 retryCount, bool forceSynchronous, bool idleThread)
     {
-        Request* req = 0;
-        RequestID rid = 0;
-
-        {
-            // lock to acquire rid and push request to the queue
-                    OGRE_LOCK_MUTEX(mRequestMutex);
-
-            if (!mAcceptRequests || mShuttingDown)
-                return 0;
+        if (!mAcceptRequests || mShuttingDown)
+            return 0;
 
-            rid = ++mRequestCount;
-            req = OGRE_NEW Request(channel, requestType, rData, retryCount, rid);
+        RequestID rid = ++mRequestCount;
+        Request* req = OGRE_NEW Request(channel, requestType, rData, retryCount, rid);
+        if (mStatisticsEnabled)
+            statisticsRequestQueued(req);
 
-            LogManager::getSingleton().stream(LML_TRIVIAL) << 
-                "DefaultWorkQueueBase('" << mName << "') - QUEUED(thread:" <<
+        LogManager::getSingleton().stream(LML_TRIVIAL) << 
+            "DefaultWorkQueueBase('" << mName << "') - QUEUED(thread:" <<
 #if OGRE_THREAD_SUPPORT
-                OGRE_THREAD_CURRENT_ID
+            OGRE_THREAD_CURRENT_ID
 #else
-                "main"
+            "main"
 #endif
-                << "): ID=" << rid
-                << " channel=" << channel << " requestType=" << requestType;
+            << "): ID=" << rid
+            << " channel=" << channel << " requestType=" << requestType;
 #if OGRE_THREAD_SUPPORT
-            if (!forceSynchronous&& !idleThread)
-            {
-                mRequestQueue.push_back(req);
-                notifyWorkers();
-                return rid;
-            }
-#endif
+        if (!forceSynchronous&& !idleThread)
+        {
+            pushRequest(req);
+            return rid;
         }
+#endif
         if(OGRE_THREAD_SUPPORT && idleThread){
             OGRE_LOCK_MUTEX(mIdleMutex);
             mIdleRequestQueue.push_back(req);
@@ -250,13 +737,12 @@ namespace Ogre {
     void DefaultWorkQueueBase::addRequestWithRID(WorkQueue::RequestID rid, uint16 channel, 
         uint16 requestType, const Any& rData, uint8 retryCount)
     {
-        // lock to push request to the queue
-            OGRE_LOCK_MUTEX(mRequestMutex);
-
         if (mShuttingDown)
             return;
 
         Request* req = OGRE_NEW Request(channel, requestType, rData, retryCount, rid);
+        if (mStatisticsEnabled)
+            statisticsRequestQueued(req);
 
         LogManager::getSingleton().stream(LML_TRIVIAL) << 
             "DefaultWorkQueueBase('" << mName << "') - REQUEUED(thread:" <<
@@ -268,41 +754,72 @@ namespace Ogre {
             << "): ID=" << rid
                    << " channel=" << channel << " requestType=" << requestType;
 #if OGRE_THREAD_SUPPORT
-        mRequestQueue.push_back(req);
-        notifyWorkers();
+        pushRequest(req);
 #else
         processRequestResponse(req, true);
 #endif
     }
     //---------------------------------------------------------------------
-    void DefaultWorkQueueBase::abortRequest(RequestID id)
+    namespace
     {
-            OGRE_LOCK_MUTEX(mProcessMutex);
+        struct MatchRequestID
+        {
+            WorkQueue::RequestID id;
+            MatchRequestID(WorkQueue::RequestID i) : id(i) {}
+            bool operator()(const WorkQueue::Request* r) const { return r->getID() == id; }
+        };
+        struct MatchRequestChannel
+        {
+            uint16 channel;
+            MatchRequestChannel(uint16 c) : channel(c) {}
+            bool operator()(const WorkQueue::Request* r) const { return r->getChannel() == channel; }
+        };
+        struct MatchAllRequests
+        {
+            bool operator()(const WorkQueue::Request*) const { return true; }
+        };
 
-        // NOTE: Pending requests are exist any of RequestQueue, ProcessQueue and
-        // ResponseQueue when keeping ProcessMutex, so we check all of these queues.
+        template <typename Queue>
+        void removeFromQueue(Queue& queue, const WorkQueue::Request* r)
+        {
+            typename Queue::iterator i = std::find(queue.begin(), queue.end(), r);
+            if (i != queue.end())
+                queue.erase(i);
+        }
 
-        for (RequestQueue::iterator i = mProcessQueue.begin(); i != mProcessQueue.end(); ++i)
+        template <typename Queue, typename Match>
+        void abortInQueue(Queue& queue, const Match& match)
         {
-            if ((*i)->getID() == id)
+            for (typename Queue::iterator i = queue.begin(); i != queue.end(); ++i)
             {
-                (*i)->abortRequest();
-                break;
+                if (match(*i))
+                    (*i)->abortRequest();
             }
         }
 
+        template <typename Shards, typename Match>
+        void abortInShards(Shards& shards, const Match& match, bool includeProcessing)
         {
-                    OGRE_LOCK_MUTEX(mRequestMutex);
-
-            for (RequestQueue::iterator i = mRequestQueue.begin(); i != mRequestQueue.end(); ++i)
+            for (typename Shards::iterator s = shards.begin(); s != shards.end(); ++s)
             {
-                if ((*i)->getID() == id)
-                {
-                    (*i)->abortRequest();
-                    break;
-                }
+                OGRE_LOCK_MUTEX((*s)->mutex);
+                if (includeProcessing)
+                    abortInQueue((*s)->processing, match);
+                for (int p = 0; p < DefaultWorkQueueBase::RP_COUNT; ++p)
+                    abortInQueue((*s)->requests[p], match);
             }
         }
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::abortRequest(RequestID id)
+    {
+            OGRE_LOCK_MUTEX(mProcessMutex);
+
+        // NOTE: A request moves between the queues of its shard and the response
+        // queue while the shard is locked, so checking each shard and then the
+        // ResponseQueue cannot miss it.
+
+        abortInShards(mRequestShards, MatchRequestID(id), true);
 
         {
             if(mIdleProcessed)
@@ -320,6 +837,7 @@ namespace Ogre {
         {
                     OGRE_LOCK_MUTEX(mResponseMutex);
 
+            collectResponses();
             for (ResponseQueue::iterator i = mResponseQueue.begin(); i != mResponseQueue.end(); ++i)
             {
                 if( (*i)->getRequest()->getID() == id )
@@ -335,25 +853,8 @@ namespace Ogre {
     {
             OGRE_LOCK_MUTEX(mProcessMutex);
 
-        for (RequestQueue::iterator i = mProcessQueue.begin(); i != mProcessQueue.end(); ++i)
-        {
-            if ((*i)->getChannel() == channel)
-            {
-                (*i)->abortRequest();
-            }
-        }
-
-        {
-                    OGRE_LOCK_MUTEX(mRequestMutex);
+        abortInShards(mRequestShards, MatchRequestChannel(channel), true);
 
-            for (RequestQueue::iterator i = mRequestQueue.begin(); i != mRequestQueue.end(); ++i)
-            {
-                if ((*i)->getChannel() == channel)
-                {
-                    (*i)->abortRequest();
-                }
-            }
-        }
         {
             if (mIdleProcessed && mIdleProcessed->getChannel() == channel)
             {
@@ -374,6 +875,7 @@ namespace Ogre {
         {
                     OGRE_LOCK_MUTEX(mResponseMutex);
 
+            collectResponses();
             for (ResponseQueue::iterator i = mResponseQueue.begin(); i != mResponseQueue.end(); ++i)
             {
                 if( (*i)->getRequest()->getChannel() == channel )
@@ -386,16 +888,8 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::abortPendingRequestsByChannel(uint16 channel)
     {
-        {
-                    OGRE_LOCK_MUTEX(mRequestMutex);
-            for (RequestQueue::iterator i = mRequestQueue.begin(); i != mRequestQueue.end(); ++i)
-            {
-                if ((*i)->getChannel() == channel)
-                {
-                    (*i)->abortRequest();
-                }
-            }
-        }
+        abortInShards(mRequestShards, MatchRequestChannel(channel), false);
+
         {
                     OGRE_LOCK_MUTEX(mIdleMutex);
 
@@ -412,22 +906,8 @@ namespace Ogre {
     void DefaultWorkQueueBase::abortAllRequests()
     {
             OGRE_LOCK_MUTEX(mProcessMutex);
-        {
-            for (RequestQueue::iterator i = mProcessQueue.begin(); i != mProcessQueue.end(); ++i)
-            {
-                (*i)->abortRequest();
-            }
-        }
-        
 
-        {
-                    OGRE_LOCK_MUTEX(mRequestMutex);
-
-            for (RequestQueue::iterator i = mRequestQueue.begin(); i != mRequestQueue.end(); ++i)
-            {
-                (*i)->abortRequest();
-            }
-        }
+        abortInShards(mRequestShards, MatchAllRequests(), true);
 
         {
 
@@ -447,6 +927,7 @@ namespace Ogre {
         {
                     OGRE_LOCK_MUTEX(mResponseMutex);
 
+            collectResponses();
             for (ResponseQueue::iterator i = mResponseQueue.begin(); i != mResponseQueue.end(); ++i)
             {
                 (*i)->abortRequest();
@@ -481,73 +962,87 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::_processNextRequest()
     {
-        if(processIdleRequests()){
-            // Found idle requests.
-            return;
+        _processNextRequest(mNextWorkerShard++);
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::_processNextRequest(size_t worker)
+    {
+        unsigned long start = 0;
+        if (mStatisticsEnabled)
+        {
+            OGRE_LOCK_MUTEX(mStatisticsMutex);
+            start = getStatisticsTime();
         }
-        Request* request = 0;
+
+        bool processed = processIdleRequests();
+        if (!processed)
         {
-            // scoped to only lock while retrieving the next request
-                    OGRE_LOCK_MUTEX(mProcessMutex);
+            RequestShard* shard = 0;
+            Request* request = popRequest(worker, shard);
+            if (request)
             {
-                            OGRE_LOCK_MUTEX(mRequestMutex);
-
-                if (!mRequestQueue.empty())
-                {
-                    request = mRequestQueue.front();
-                    mRequestQueue.pop_front();
-                    mProcessQueue.push_back( request );
-                }
+                processRequestResponse(request, false, shard);
+                processed = true;
             }
         }
 
-        if (request)
+        if (processed && start)
         {
-            processRequestResponse(request, false);
+            OGRE_LOCK_MUTEX(mStatisticsMutex);
+            size_t index = worker % std::max(mWorkerThreadCount, (size_t)1);
+            if (mWorkerBusyTime.size() <= index)
+                mWorkerBusyTime.resize(index + 1, 0);
+            mWorkerBusyTime[index] += getStatisticsTime() - start;
         }
-
-
     }
     //---------------------------------------------------------------------
-    void DefaultWorkQueueBase::processRequestResponse(Request* r, bool synchronous)
+    void DefaultWorkQueueBase::processRequestResponse(Request* r, bool synchronous, RequestShard* shard)
     {
+        unsigned long start = statisticsRequestStarted(r);
         Response* response = processRequest(r);
+        if (start)
+            statisticsRequestProcessed(r, start);
 
-        OGRE_LOCK_MUTEX(mProcessMutex);
-
-        RequestQueue::iterator it;
-        for( it = mProcessQueue.begin(); it != mProcessQueue.end(); ++it )
+        if (response && !response->succeeded() && r->getRetryCount())
         {
-            if( (*it) == r )
+            // Failed, retry
             {
-                mProcessQueue.erase( it );
-                break;
+                OGRE_LOCK_MUTEX(shard ? shard->mutex : mProcessMutex);
+                if (shard)
+                    removeFromQueue(shard->processing, r);
+                else if (mIdleProcessed == r)
+                    mIdleProcessed = 0;
             }
+            addRequestWithRID(r->getID(), r->getChannel(), r->getType(), r->getData(), 
+                r->getRetryCount() - 1);
+            // discard response (this also deletes request)
+            OGRE_DELETE response;
+            return;
+        }
+
+        // Requests in a shard are removed from it and queued as responses atomically
+        OGRE_LOCK_MUTEX(shard ? shard->mutex : mProcessMutex);
+
+        if (shard)
+        {
+            removeFromQueue(shard->processing, r);
         }
-        if( mIdleProcessed == r )
+        else if( mIdleProcessed == r )
         {
             mIdleProcessed = 0;
         }
         if (response)
         {
-            if (!response->succeeded())
-            {
-                // Failed, should we retry?
-                const Request* req = response->getRequest();
-                if (req->getRetryCount())
-                {
-                    addRequestWithRID(req->getID(), req->getChannel(), req->getType(), req->getData(), 
-                        req->getRetryCount() - 1);
-                    // discard response (this also deletes request)
-                    OGRE_DELETE response;
-                    return;
-                }
-            }
             if (synchronous)
             {
                 processResponse(response);
                 OGRE_DELETE response;
             }
+            else if (isInternalChannel(r->getChannel()))
+            {
+                // nobody waits for these
+                OGRE_DELETE response;
+            }
             else
             {
                 if( response->getRequest()->getAborted() )
@@ -556,15 +1051,19 @@ namespace Ogre {
                     response->abortRequest();
                 }
                 // Queue response
-                OGRE_LOCK_MUTEX(mResponseMutex);
-                mResponseQueue.push_back(response);
+                pushResponse(response);
                 // no need to wake thread, this is processed by the main thread
             }
 
         }
         else
         {
-            if (!r->getAborted())
+            if (r->getAborted())
+            {
+                if (mStatisticsEnabled)
+                    statisticsRequestAborted(r);
+            }
+            else
             {
             // no response, delete request
             LogManager::getSingleton().stream() << 
@@ -579,16 +1078,35 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::processResponses() 
     {
+        OgreProfileGroup("DefaultWorkQueue::processResponses", OGREPROF_GENERAL);
+
         unsigned long msStart = Root::getSingleton().getTimer()->getMilliseconds();
         unsigned long msCurrent = 0;
 
+        unsigned long start = 0;
+        if (mStatisticsEnabled)
+        {
+            size_t backlog;
+            {
+                OGRE_LOCK_MUTEX(mResponseMutex);
+                collectResponses();
+                backlog = mResponseQueue.size();
+            }
+            OGRE_LOCK_MUTEX(mStatisticsMutex);
+            start = getStatisticsTime();
+            mResponseStatistics.lastResponseBacklog = backlog;
+        }
+
         // keep going until we run out of responses or out of time
         while(true)
         {
             Response* response = 0;
             {
-                            OGRE_LOCK_MUTEX(mResponseMutex);
+                // Nobody but aborts contends for this, the workers don't lock it
+                OGRE_LOCK_MUTEX(mResponseMutex);
 
+                if (mResponseQueue.empty())
+                    collectResponses();
                 if (mResponseQueue.empty())
                     break; // exit loop
                 else
@@ -614,6 +1132,17 @@ namespace Ogre {
                     break;
             }
         }
+
+        if (start)
+        {
+            OGRE_LOCK_MUTEX(mStatisticsMutex);
+            unsigned long elapsed = getStatisticsTime() - start;
+            Statistics& stats = mResponseStatistics;
+            ++stats.processResponsesCalls;
+            stats.lastProcessResponsesTime = elapsed;
+            stats.maxProcessResponsesTime = std::max(stats.maxProcessResponsesTime, elapsed);
+            stats.totalProcessResponsesTime += elapsed;
+        }
     }
     //---------------------------------------------------------------------
     WorkQueue::Response* DefaultWorkQueueBase::processRequest(Request* r)
@@ -666,6 +1195,9 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::processResponse(Response* r)
     {
+        if (mStatisticsEnabled && r->getRequest()->getAborted())
+            statisticsRequestAborted(r->getRequest());
+
         StringStream dbgMsg;
         dbgMsg << "thread:" <<
 #if OGRE_THREAD_SUPPORT
@@ -680,10 +1212,10 @@ namespace Ogre {
         LogManager::getSingleton().stream(LML_TRIVIAL) << 
             "DefaultWorkQueueBase('" << mName << "') - PROCESS_RESPONSE_START(" << dbgMsg.str();
 
-        ResponseHandlerListByChannel::iterator i = mResponseHandlers.find(r->getRequest()->getChannel());
-        if (i != mResponseHandlers.end())
+        uint16 channel = r->getRequest()->getChannel();
+        if (channel < mResponseHandlers.size())
         {
-            ResponseHandlerList& handlers = i->second;
+            ResponseHandlerList& handlers = mResponseHandlers[channel];
             for (ResponseHandlerList::reverse_iterator j = handlers.rbegin(); j != handlers.rend(); ++j)
             {
                 if ((*j)->canHandleResponse(r, this))
@@ -697,6 +1229,32 @@ namespace Ogre {
 
     }
 
+    void DefaultWorkQueueBase::pushResponse(Response* r)
+    {
+        size_t head;
+        do
+        {
+            head = mFinishedResponses.get();
+            r->mNext = reinterpret_cast<Response*>(head);
+        } while (!mFinishedResponses.cas(head, reinterpret_cast<size_t>(r)));
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::collectResponses()
+    {
+        // Take the whole list; workers only ever push, so this is safe from ABA
+        size_t head;
+        do
+        {
+            head = mFinishedResponses.get();
+        } while (head && !mFinishedResponses.cas(head, 0));
+
+        size_t first = mResponseQueue.size();
+        for (Response* r = reinterpret_cast<Response*>(head); r; r = r->mNext)
+            mResponseQueue.push_back(r);
+        // newest first, restore the order they finished in
+        std::reverse(mResponseQueue.begin() + first, mResponseQueue.end());
+    }
+    //---------------------------------------------------------------------
     bool DefaultWorkQueueBase::processIdleRequests()
     {
         {
@@ -745,6 +1303,199 @@ namespace Ogre {
     }
 
 
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::parallelFor(size_t count, size_t grainSize, ParallelTask* task)
+    {
+        grainSize = std::max<size_t>(grainSize, 1);
+        if (count <= grainSize || !mIsRunning || mPaused || !mWorkerThreadCount)
+        {
+            WorkQueue::parallelFor(count, grainSize, task);
+            return;
+        }
+
+        ParallelForJobPtr job(OGRE_NEW ParallelForJob(task, count, grainSize));
+
+#if OGRE_THREAD_SUPPORT
+        // The calling thread takes one share of the work itself
+        size_t helpers = std::min(mWorkerThreadCount, job->numChunks - 1);
+        for (size_t i = 0; i < helpers; ++i)
+        {
+            addRequest(mParallelForChannel, 0, Any(ParallelForRequest(job)));
+        }
+#endif
+
+        job->run();
+        job->wait();
+
+        if (!job->error.empty())
+        {
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                "A parallel task failed: " + job->error,
+                "DefaultWorkQueueBase::parallelFor");
+        }
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::Response* DefaultWorkQueueBase::ParallelForHandler::handleRequest(
+        const Request* req, const WorkQueue* srcQ)
+    {
+        any_cast<ParallelForRequest>(req->getData()).job->run();
+        return OGRE_NEW Response(req, true, Any());
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::addTask(const TaskPtr& task)
+    {
+#if OGRE_THREAD_SUPPORT
+        if (mIsRunning && !mPaused && mWorkerThreadCount)
+        {
+            addRequest(mTaskChannel, 0, Any(TaskRequest(task)));
+            return;
+        }
+#endif
+        WorkQueue::addTask(task);
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::Response* DefaultWorkQueueBase::TaskHandler::handleRequest(
+        const Request* req, const WorkQueue* srcQ)
+    {
+        const TaskPtr& task = any_cast<TaskRequest>(req->getData()).task;
+        try
+        {
+            task->execute();
+        }
+        catch (std::exception& e)
+        {
+            LogManager::getSingleton().stream() << "A task failed: " << e.what();
+        }
+        return OGRE_NEW Response(req, true, Any());
+    }
+    //---------------------------------------------------------------------
+    DefaultWorkQueueBase::TimeHistogram::TimeHistogram()
+        : count(0), total(0), max(0)
+    {
+        std::fill(buckets, buckets + NUM_BUCKETS, 0);
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::TimeHistogram::add(unsigned long us)
+    {
+        size_t bucket = 0;
+        for (unsigned long t = us >> 1; t && bucket < NUM_BUCKETS - 1; t >>= 1)
+            ++bucket;
+        ++buckets[bucket];
+        ++count;
+        total += us;
+        max = std::max(max, us);
+    }
+    //---------------------------------------------------------------------
+    DefaultWorkQueueBase::ChannelStatistics::ChannelStatistics()
+        : queued(0), inFlight(0), processed(0), aborted(0)
+    {
+    }
+    //---------------------------------------------------------------------
+    DefaultWorkQueueBase::Statistics::Statistics()
+        : responseBacklog(0), lastResponseBacklog(0), processResponsesCalls(0)
+        , lastProcessResponsesTime(0), maxProcessResponsesTime(0), totalProcessResponsesTime(0)
+    {
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::setStatisticsEnabled(bool enabled)
+    {
+        OGRE_LOCK_MUTEX(mStatisticsMutex);
+        if (enabled && !mStatisticsTimer)
+        {
+            mStatisticsTimer = OGRE_NEW Timer();
+            mStatisticsStart = getStatisticsTime();
+        }
+        mStatisticsEnabled = enabled;
+    }
+    //---------------------------------------------------------------------
+    unsigned long DefaultWorkQueueBase::getStatisticsTime() const
+    {
+        // 0 marks requests which are not measured
+        return std::max(mStatisticsTimer->getMicroseconds(), 1UL);
+    }
+    //---------------------------------------------------------------------
+    DefaultWorkQueueBase::Statistics DefaultWorkQueueBase::getStatistics() const
+    {
+        size_t backlog;
+        {
+            OGRE_LOCK_MUTEX(mResponseMutex);
+            backlog = mResponseQueue.size();
+            // Only collectResponses removes from the list, and it locks the mutex too
+            for (Response* r = reinterpret_cast<Response*>(mFinishedResponses.get()); r; r = r->mNext)
+                ++backlog;
+        }
+
+        OGRE_LOCK_MUTEX(mStatisticsMutex);
+        Statistics stats = mResponseStatistics;
+        stats.channels = mChannelStatistics;
+        stats.responseBacklog = backlog;
+        if (mStatisticsTimer)
+        {
+            Real elapsed = Real(getStatisticsTime() - mStatisticsStart);
+            for (vector<uint64>::type::const_iterator i = mWorkerBusyTime.begin();
+                i != mWorkerBusyTime.end(); ++i)
+            {
+                stats.workerUtilisation.push_back(
+                    elapsed > 0 ? std::min(Real(*i) / elapsed, Real(1)) : 0);
+            }
+        }
+        return stats;
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::resetStatistics()
+    {
+        OGRE_LOCK_MUTEX(mStatisticsMutex);
+        // Keep the current counts of queued and in flight requests
+        for (ChannelStatisticsMap::iterator i = mChannelStatistics.begin();
+            i != mChannelStatistics.end(); ++i)
+        {
+            ChannelStatistics current;
+            current.queued = i->second.queued;
+            current.inFlight = i->second.inFlight;
+            i->second = current;
+        }
+        mWorkerBusyTime.clear();
+        mResponseStatistics = Statistics();
+        if (mStatisticsTimer)
+            mStatisticsStart = getStatisticsTime();
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::statisticsRequestQueued(Request* r)
+    {
+        OGRE_LOCK_MUTEX(mStatisticsMutex);
+        r->_setQueueTime(getStatisticsTime());
+        ++mChannelStatistics[r->getChannel()].queued;
+    }
+    //---------------------------------------------------------------------
+    unsigned long DefaultWorkQueueBase::statisticsRequestStarted(const Request* r)
+    {
+        // Requests queued while statistics were disabled are not measured
+        if (!r->getQueueTime())
+            return 0;
+
+        OGRE_LOCK_MUTEX(mStatisticsMutex);
+        unsigned long start = getStatisticsTime();
+        ChannelStatistics& stats = mChannelStatistics[r->getChannel()];
+        --stats.queued;
+        ++stats.inFlight;
+        stats.waitTime.add(start - r->getQueueTime());
+        return start;
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::statisticsRequestProcessed(const Request* r, unsigned long start)
+    {
+        OGRE_LOCK_MUTEX(mStatisticsMutex);
+        ChannelStatistics& stats = mChannelStatistics[r->getChannel()];
+        --stats.inFlight;
+        ++stats.processed;
+        stats.processTime.add(getStatisticsTime() - start);
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::statisticsRequestAborted(const Request* r)
+    {
+        OGRE_LOCK_MUTEX(mStatisticsMutex);
+        ++mChannelStatistics[r->getChannel()].aborted;
+    }
     //---------------------------------------------------------------------
 
     void DefaultWorkQueueBase::WorkerFunc::operator()()
@@ -33,9 +33,11 @@ THE SOFTWARE.
 
 #include "OgreLogManager.h"
 #include "OgreException.h"
+#include "OgreFileSystem.h"
 
 #include <zzip/zzip.h>
 #include <zzip/plugin.h>
+#include <zlib.h>
 
 
 namespace Ogre {
@@ -77,6 +79,34 @@ namespace Ogre {
         return errorMsg;
     }
     //-----------------------------------------------------------------------
+    namespace {
+        /// Zip headers are little endian whatever the platform
+        uint16 readZipUint16(const uchar* p)
+        {
+            return static_cast<uint16>(p[0] | (p[1] << 8));
+        }
+        uint32 readZipUint32(const uchar* p)
+        {
+            return static_cast<uint32>(p[0]) | (static_cast<uint32>(p[1]) << 8) |
+                (static_cast<uint32>(p[2]) << 16) | (static_cast<uint32>(p[3]) << 24);
+        }
+
+        /// Stream over a stored file inside a mapped archive, keeps the mapping alive
+        class ZipMappedDataStream : public MemoryDataStream
+        {
+            MemoryDataStreamPtr mMapping;
+        public:
+            ZipMappedDataStream(const String& name, const MemoryDataStreamPtr& mapping,
+                size_t offset, size_t size)
+                : MemoryDataStream(name, mapping->getPtr() + offset, size, false, true)
+                , mMapping(mapping)
+            {
+            }
+        };
+    }
+    //-----------------------------------------------------------------------
+    bool ZipArchive::msUseMemoryMapping = false;
+    //-----------------------------------------------------------------------
     ZipArchive::ZipArchive(const String& name, const String& archType, zzip_plugin_io_handlers* pluginIo)
         : Archive(name, archType), mZzipDir(0), mPluginIo(pluginIo)
     {
@@ -125,7 +155,129 @@ namespace Ogre {
 
             }
 
+            if (msUseMemoryMapping && !mPluginIo)
+                indexMappedEntries();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ZipArchive::indexMappedEntries()
+    {
+        MappedFileDataStream* mapped = MappedFileDataStream::open(mName, mName);
+        if (!mapped)
+            return;
+        MemoryDataStreamPtr mapping(mapped);
+
+        const uchar* base = mapping->getPtr();
+        size_t size = mapping->size();
+        if (size < 22)
+            return;
+
+        // The end of central directory record is followed by a comment of up to 64k
+        size_t eocd = size - 22;
+        size_t lowest = eocd > 0xFFFF ? eocd - 0xFFFF : 0;
+        while (readZipUint32(base + eocd) != 0x06054b50)
+        {
+            if (eocd == lowest)
+                return;
+            --eocd;
+        }
+
+        uint16 entryCount = readZipUint16(base + eocd + 10);
+        size_t dirEnd = static_cast<size_t>(readZipUint32(base + eocd + 16)) +
+            readZipUint32(base + eocd + 12);
+        if (dirEnd > eocd)
+            return;
+
+        size_t pos = readZipUint32(base + eocd + 16);
+        for (uint16 e = 0; e < entryCount; ++e)
+        {
+            const uchar* hdr = base + pos;
+            if (pos + 46 > dirEnd || readZipUint32(hdr) != 0x02014b50)
+                break;
+
+            uint16 flags = readZipUint16(hdr + 8);
+            uint16 method = readZipUint16(hdr + 10);
+            uint32 compressedSize = readZipUint32(hdr + 20);
+            uint32 uncompressedSize = readZipUint32(hdr + 24);
+            uint16 nameLen = readZipUint16(hdr + 28);
+            uint32 localOffset = readZipUint32(hdr + 42);
+            pos += 46 + nameLen + readZipUint16(hdr + 30) + readZipUint16(hdr + 32);
+            if (pos > dirEnd)
+                break;
+
+            // Leave encrypted, zip64, empty and otherwise compressed files to zziplib
+            if ((flags & 1) || (method != 0 && method != 8) || uncompressedSize == 0 ||
+                compressedSize == 0xFFFFFFFF || uncompressedSize == 0xFFFFFFFF ||
+                (method == 0 && compressedSize != uncompressedSize))
+                continue;
+
+            // The local header can have a different extra field to the central one
+            const uchar* local = base + localOffset;
+            if (static_cast<size_t>(localOffset) + 30 > size || readZipUint32(local) != 0x04034b50)
+                continue;
+            MappedEntry entry;
+            entry.offset = static_cast<size_t>(localOffset) + 30 +
+                readZipUint16(local + 26) + readZipUint16(local + 28);
+            entry.compressedSize = compressedSize;
+            entry.uncompressedSize = uncompressedSize;
+            entry.deflated = method == 8;
+            if (entry.offset + entry.compressedSize > size)
+                continue;
+
+            String name(reinterpret_cast<const char*>(hdr + 46), nameLen);
+            StringUtil::toLowerCase(name);
+            mMappedEntries[name] = entry;
         }
+
+        if (!mMappedEntries.empty())
+            mMapping = mapping;
+    }
+    //-----------------------------------------------------------------------
+    DataStreamPtr ZipArchive::openMapped(const String& filename)
+    {
+        MemoryDataStreamPtr mapping;
+        MappedEntry entry;
+        {
+            OGRE_LOCK_AUTO_MUTEX;
+            if (mMapping.isNull())
+                return DataStreamPtr();
+            String key = filename;
+            StringUtil::toLowerCase(key);
+            MappedEntryMap::const_iterator i = mMappedEntries.find(key);
+            if (i == mMappedEntries.end())
+                return DataStreamPtr();
+            mapping = mMapping;
+            entry = i->second;
+        }
+
+        if (!entry.deflated)
+            return DataStreamPtr(OGRE_NEW ZipMappedDataStream(filename, mapping,
+                entry.offset, entry.uncompressedSize));
+
+        // Zip files hold raw deflate data, without the zlib header
+        uchar* data = OGRE_ALLOC_T(uchar, entry.uncompressedSize, MEMCATEGORY_GENERAL);
+        z_stream zs;
+        memset(&zs, 0, sizeof(zs));
+        zs.next_in = mapping->getPtr() + entry.offset;
+        zs.avail_in = static_cast<uInt>(entry.compressedSize);
+        zs.next_out = data;
+        zs.avail_out = static_cast<uInt>(entry.uncompressedSize);
+        int err = inflateInit2(&zs, -MAX_WBITS);
+        if (err == Z_OK)
+        {
+            err = inflate(&zs, Z_FINISH);
+            inflateEnd(&zs);
+        }
+
+        if (err != Z_STREAM_END || zs.total_out != entry.uncompressedSize)
+        {
+            // Let zziplib have a go, it reports the error if there is one
+            OGRE_FREE(data, MEMCATEGORY_GENERAL);
+            return DataStreamPtr();
+        }
+
+        return DataStreamPtr(OGRE_NEW MemoryDataStream(filename, data,
+            entry.uncompressedSize, true, true));
     }
     //-----------------------------------------------------------------------
     void ZipArchive::unload()
@@ -136,12 +288,18 @@ namespace Ogre {
             zzip_dir_close(mZzipDir);
             mZzipDir = 0;
             mFileList.clear();
+            mMappedEntries.clear();
+            mMapping.setNull();
         }
     
     }
     //-----------------------------------------------------------------------
     DataStreamPtr ZipArchive::open(const String& filename, bool readOnly)
     {
+        DataStreamPtr mapped = openMapped(filename);
+        if (!mapped.isNull())
+            return mapped;
+
         // zziplib is not threadsafe
         OGRE_LOCK_AUTO_MUTEX;
         String lookUpFileName = filename;
@@ -35,7 +35,7 @@ namespace Ogre
 {
     //---------------------------------------------------------------------
     DefaultWorkQueue::DefaultWorkQueue(const String& name)
-    : DefaultWorkQueueBase(name), mNumThreadsRegisteredWithRS(0)
+    : DefaultWorkQueueBase(name), mNumThreadsRegisteredWithRS(0), mSleepingWorkers(0)
     {
     }
     //---------------------------------------------------------------------
@@ -58,6 +58,9 @@ namespace Ogre
 
         mWorkerFunc = OGRE_NEW_T(WorkerFunc(this), MEMCATEGORY_GENERAL);
 
+        setupRequestShards();
+        mNextWorkerShard = 0;
+
         LogManager::getSingleton().stream() <<
             "DefaultWorkQueue('" << mName << "') initialising on thread " <<
 #if OGRE_THREAD_SUPPORT
@@ -122,7 +125,10 @@ namespace Ogre
         abortAllRequests();
 #if OGRE_THREAD_SUPPORT
         // wake all threads (they should check shutting down as first thing after wait)
-        OGRE_THREAD_NOTIFY_ALL(mRequestCondition);
+        {
+            OGRE_LOCK_MUTEX(mRequestMutex);
+            OGRE_THREAD_NOTIFY_ALL(mRequestCondition);
+        }
 
         // all our threads should have been woken now, so join
         for (WorkerThreadList::iterator i = mWorkers.begin(); i != mWorkers.end(); ++i)
@@ -141,8 +147,12 @@ namespace Ogre
     //---------------------------------------------------------------------
     void DefaultWorkQueue::notifyWorkers()
     {
-        // wake up waiting thread
+        // wake up waiting thread, if there is one
+        if (mSleepingWorkers.get())
+        {
+            OGRE_LOCK_MUTEX(mRequestMutex);
             OGRE_THREAD_NOTIFY_ONE(mRequestCondition);
+        }
     }
 
     //---------------------------------------------------------------------
@@ -151,11 +161,15 @@ namespace Ogre
 #if OGRE_THREAD_SUPPORT
         // Lock; note that OGRE_THREAD_WAIT will free the lock
             OGRE_LOCK_MUTEX_NAMED(mRequestMutex, queueLock);
-        if (mRequestQueue.empty())
+        // Counted before checking the queues, so that a request added meanwhile
+        // either is seen here or sees this thread sleeping and notifies it
+        ++mSleepingWorkers;
+        if (!hasQueuedRequests() && !mShuttingDown)
         {
             // frees lock and suspends the thread
             OGRE_THREAD_WAIT(mRequestCondition, mRequestMutex, queueLock);
         }
+        --mSleepingWorkers;
         // When we get back here, it's because we've been notified 
         // and thus the thread has been woken up. Lock has also been
         // re-acquired, but we won't use it. It's safe to try processing and fail
@@ -179,13 +193,19 @@ namespace Ogre
             notifyThreadRegistered();
         }
 
+        // The shard this thread takes requests from first
+        size_t worker = mNextWorkerShard++;
+
         // Spin forever until we're told to shut down
         while (!isShuttingDown())
         {
             waitForNextRequest();
-            _processNextRequest();
+            _processNextRequest(worker);
         }
 
+        // Let the next thread reuse the blocks of this one
+        SmallObjectAllocImpl::_releaseThreadCache();
+
         LogManager::getSingleton().stream() << 
             "DefaultWorkQueue('" << getName() << "')::WorkerFunc - thread " 
             << OGRE_THREAD_CURRENT_ID << " stopped.";
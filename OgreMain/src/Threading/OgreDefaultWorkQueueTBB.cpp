@@ -65,12 +65,15 @@ namespace Ogre
         
         mWorkerFunc = OGRE_NEW_T(WorkerFunc(this), MEMCATEGORY_GENERAL);
 
+        setupRequestShards();
+
         LogManager::getSingleton().stream() <<
             "DefaultWorkQueue('" << mName << "') initialising.";
 
 #if OGRE_NO_TBB_SCHEDULER == 0
         mTaskScheduler.initialize(mWorkerThreadCount);
 #endif
+        mCacheReleaseObserver.observe(true);
 
         if (mWorkerRenderSystemAccess)
         {
@@ -140,6 +143,13 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
+    void DefaultWorkQueue::CacheReleaseObserver::on_scheduler_exit(bool isWorker)
+    {
+        // Let the next thread reuse the blocks of this one
+        if (isWorker)
+            SmallObjectAllocImpl::_releaseThreadCache();
+    }
+    //---------------------------------------------------------------------
     void DefaultWorkQueue::_threadMain()
     {
         //// Initialise the thread for RS if necessary
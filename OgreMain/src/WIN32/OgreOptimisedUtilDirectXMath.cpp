@@ -99,6 +99,8 @@ namespace DirectX
 
 namespace Ogre {
 
+    extern OptimisedUtil* _getOptimisedUtilGeneral(void);
+
 //-------------------------------------------------------------------------
 // Local classes
 //-------------------------------------------------------------------------
@@ -122,6 +124,30 @@ namespace Ogre {
             size_t numWeightsPerVertex,
             size_t numVertices);
 
+        /// @copydoc OptimisedUtil::softwareVertexSkinningDualQuaternion
+        virtual void softwareVertexSkinningDualQuaternion(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const DualQuaternion* const* blendDualQuaternions,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices)
+        {
+            _getOptimisedUtilGeneral()->softwareVertexSkinningDualQuaternion(
+                srcPosPtr, destPosPtr,
+                srcNormPtr, destNormPtr,
+                blendWeightPtr, blendIndexPtr,
+                blendDualQuaternions,
+                srcPosStride, destPosStride,
+                srcNormStride, destNormStride,
+                blendWeightStride, blendIndexStride,
+                numWeightsPerVertex,
+                numVertices);
+        }
+
         /// @copydoc OptimisedUtil::softwareVertexMorph
         virtual void softwareVertexMorph(
             Real t,
@@ -138,6 +164,28 @@ namespace Ogre {
             Matrix4* dstMatrices,
             size_t numMatrices);
 
+        /// @copydoc OptimisedUtil::transformPoints
+        virtual void transformPoints(
+            const Matrix4& matrix,
+            const float* srcPtr, float* destPtr,
+            size_t srcStride, size_t destStride,
+            size_t numPoints)
+        {
+            _getOptimisedUtilGeneral()->transformPoints(matrix,
+                srcPtr, destPtr, srcStride, destStride, numPoints);
+        }
+
+        /// @copydoc OptimisedUtil::transformDirections
+        virtual void transformDirections(
+            const Matrix4& matrix,
+            const float* srcPtr, float* destPtr,
+            size_t srcStride, size_t destStride,
+            size_t numDirections, bool normalise)
+        {
+            _getOptimisedUtilGeneral()->transformDirections(matrix,
+                srcPtr, destPtr, srcStride, destStride, numDirections, normalise);
+        }
+
         /// @copydoc OptimisedUtil::calculateFaceNormals
         virtual void calculateFaceNormals(
             const float *positions,
@@ -159,6 +207,126 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        // The bounding volume tests use the general implementation
+
+        /// @copydoc OptimisedUtil::cullBoxes
+        virtual void cullBoxes(
+            const Plane* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes)
+        {
+            _getOptimisedUtilGeneral()->cullBoxes(planes, numPlanes,
+                centreX, centreY, centreZ, halfSizeX, halfSizeY, halfSizeZ,
+                results, numBoxes);
+        }
+
+        /// @copydoc OptimisedUtil::cullSpheres
+        virtual void cullSpheres(
+            const Plane* planes, size_t numPlanes,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* radius,
+            uint8* results, size_t numSpheres)
+        {
+            _getOptimisedUtilGeneral()->cullSpheres(planes, numPlanes,
+                centreX, centreY, centreZ, radius, results, numSpheres);
+        }
+
+        /// @copydoc OptimisedUtil::intersectBoxes(const AxisAlignedBox&,const float*,const float*,const float*,const float*,const float*,const float*,uint8*,size_t)
+        virtual void intersectBoxes(
+            const AxisAlignedBox& box,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes)
+        {
+            _getOptimisedUtilGeneral()->intersectBoxes(box,
+                centreX, centreY, centreZ, halfSizeX, halfSizeY, halfSizeZ,
+                results, numBoxes);
+        }
+
+        /// @copydoc OptimisedUtil::intersectBoxes(const Sphere&,const float*,const float*,const float*,const float*,const float*,const float*,uint8*,size_t)
+        virtual void intersectBoxes(
+            const Sphere& sphere,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            uint8* results, size_t numBoxes)
+        {
+            _getOptimisedUtilGeneral()->intersectBoxes(sphere,
+                centreX, centreY, centreZ, halfSizeX, halfSizeY, halfSizeZ,
+                results, numBoxes);
+        }
+
+        /// @copydoc OptimisedUtil::intersectBoxes(const Ray&,const float*,const float*,const float*,const float*,const float*,const float*,float*,uint8*,size_t)
+        virtual void intersectBoxes(
+            const Ray& ray,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* halfSizeX, const float* halfSizeY, const float* halfSizeZ,
+            float* distances, uint8* results, size_t numBoxes)
+        {
+            _getOptimisedUtilGeneral()->intersectBoxes(ray,
+                centreX, centreY, centreZ, halfSizeX, halfSizeY, halfSizeZ,
+                distances, results, numBoxes);
+        }
+
+        /// @copydoc OptimisedUtil::intersectSpheres
+        virtual void intersectSpheres(
+            const Sphere& sphere,
+            const float* centreX, const float* centreY, const float* centreZ,
+            const float* radius,
+            uint8* results, size_t numSpheres)
+        {
+            _getOptimisedUtilGeneral()->intersectSpheres(sphere,
+                centreX, centreY, centreZ, radius, results, numSpheres);
+        }
+
+        /// @copydoc OptimisedUtil::nlerpQuaternions
+        virtual void nlerpQuaternions(
+            const float* t,
+            const float* src1, const float* src2,
+            float* dest, size_t numQuaternions)
+        {
+            _getOptimisedUtilGeneral()->nlerpQuaternions(t, src1, src2, dest, numQuaternions);
+        }
+
+        /// @copydoc OptimisedUtil::shufflePixels
+        virtual void shufflePixels(
+            const uint8* src, size_t srcPixelSize,
+            uint8* dest, size_t destPixelSize,
+            const int8* shuffle, size_t numPixels)
+        {
+            _getOptimisedUtilGeneral()->shufflePixels(src, srcPixelSize,
+                dest, destPixelSize, shuffle, numPixels);
+        }
+
+        /// @copydoc OptimisedUtil::convertHalfToFloat
+        virtual void convertHalfToFloat(
+            const uint16* src, float* dest, size_t count)
+        {
+            _getOptimisedUtilGeneral()->convertHalfToFloat(src, dest, count);
+        }
+
+        /// @copydoc OptimisedUtil::convertFloatToHalf
+        virtual void convertFloatToHalf(
+            const float* src, uint16* dest, size_t count)
+        {
+            _getOptimisedUtilGeneral()->convertFloatToHalf(src, dest, count);
+        }
+
+        /// @copydoc OptimisedUtil::sumWeightedRows
+        virtual void sumWeightedRows(
+            const float* const* rows, const float* weights, size_t numRows,
+            float* dest, size_t count)
+        {
+            _getOptimisedUtilGeneral()->sumWeightedRows(rows, weights, numRows, dest, count);
+        }
+
+        /// @copydoc OptimisedUtil::convertFloatToByte
+        virtual void convertFloatToByte(
+            const float* src, uint8* dest, size_t count)
+        {
+            _getOptimisedUtilGeneral()->convertFloatToByte(src, dest, count);
+        }
     };
 
 //---------------------------------------------------------------------
@@ -138,6 +138,11 @@ namespace Ogre {
         */
         bool isLeafVisible(const BspNode* leaf) const;
 
+        /** Returns the PVS cluster of this leaf node, or -1 if it is outside the level.
+            Should only be called on a leaf node.
+        */
+        int getVisCluster(void) const { return mVisCluster; }
+
         friend std::ostream& operator<< (std::ostream& o, BspNode& n);
 
         /// Internal method for telling the node that a movable intersects it
@@ -73,13 +73,39 @@ namespace Ogre {
         /// World geometry
         BspLevelPtr mLevel;
 
-        // State variables for rendering WIP
-        // Set of face groups (by index) already included
-        typedef set<int>::type FaceGroupSet;
-        FaceGroupSet mFaceGroupSet;
-        // Material -> face group hashmap
-        typedef map<Material*, vector<StaticFaceGroup*>::type, materialLess >::type MaterialFaceGroupMap;
-        MaterialFaceGroupMap mMatFaceGroupMap;
+        /// The face groups of one material, rendered with a single call
+        struct MaterialBucket
+        {
+            Material* material;
+            /// Face groups tagged as visible by the last walk of the tree
+            vector<int>::type faceGroups;
+            /// Face groups whose indexes are currently in the index buffer
+            vector<int>::type uploadedFaceGroups;
+            /// Range of the uploaded indexes in the index buffer
+            size_t indexStart;
+            size_t indexCount;
+        };
+        typedef vector<MaterialBucket>::type MaterialBucketList;
+        /// One bucket per material used by the level, sorted with materialLess
+        MaterialBucketList mMaterialBuckets;
+        /// Bucket of each face group of the level, or -1 if it is never rendered
+        vector<int>::type mFaceGroupBucket;
+        /// Walk in which each face group was last tagged, so it is tagged only once
+        vector<unsigned long>::type mFaceGroupWalk;
+        unsigned long mWalkCount;
+        /// Indexes of the face lists of the level, already offset by their vertex start
+        vector<unsigned int>::type mFaceListIndexes;
+        /// Start of each face list in mFaceListIndexes
+        vector<size_t>::type mFaceListIndexStart;
+
+        /// The leaves in the PVS of the cluster a camera was last found in
+        struct ClusterLeaves
+        {
+            int cluster;
+            vector<BspNode*>::type leaves;
+        };
+        typedef map<const Camera*, ClusterLeaves>::type ClusterLeavesMap;
+        ClusterLeavesMap mClusterLeaves;
 
         RenderOperation mRenderOp;
 
@@ -98,8 +124,17 @@ namespace Ogre {
         void processVisibleLeaf(BspNode* leaf, Camera* cam, 
             VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters);
 
+        /** Gets the leaves in the PVS of the camera leaf, which are only
+            looked up again when the camera moves to another cluster. */
+        const vector<BspNode*>::type& getPVSLeaves(const Camera* camera, const BspNode* cameraNode);
+
+        /** Sorts the face groups of the level by material and prepares the
+            index data used to render them. */
+        void initStaticGeometry(void);
+
         /** Caches a face group for imminent rendering. */
-        unsigned int cacheGeometry(unsigned int* pIndexes, const StaticFaceGroup* faceGroup);
+        unsigned int cacheGeometry(unsigned int* pIndexes, const unsigned int* pSrc,
+            int faceGroupIndex);
 
         /** Frees up allocated memory for geometry caches. */
         void freeMemory(void);
@@ -56,6 +56,7 @@ namespace Ogre {
     {
         // Set features for debugging render
         mShowNodeAABs = false;
+        mWalkCount = 0;
 
         // No sky by default
         mSkyPlaneEnabled = false;
@@ -132,23 +133,7 @@ namespace Ogre {
             setSkyDome(false, BLANKSTRING);
         }
 
-        // Init static render operation
-        mRenderOp.vertexData = mLevel->mVertexData;
-        // index data is per-frame
-        mRenderOp.indexData = OGRE_NEW IndexData();
-        mRenderOp.indexData->indexStart = 0;
-        mRenderOp.indexData->indexCount = 0;
-        // Create enough index space to render whole level
-        mRenderOp.indexData->indexBuffer = HardwareBufferManager::getSingleton()
-            .createIndexBuffer(
-                HardwareIndexBuffer::IT_32BIT, // always 32-bit
-                mLevel->mNumIndexes, 
-                HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, false);
-
-        mRenderOp.operationType = RenderOperation::OT_TRIANGLE_LIST;
-        mRenderOp.useIndexes = true;
-
-
+        initStaticGeometry();
     }
     //-----------------------------------------------------------------------
     void BspSceneManager::setWorldGeometry(DataStreamPtr& stream, 
@@ -174,23 +159,7 @@ namespace Ogre {
             setSkyDome(false, BLANKSTRING);
         }
 
-        // Init static render operation
-        mRenderOp.vertexData = mLevel->mVertexData;
-        // index data is per-frame
-        mRenderOp.indexData = OGRE_NEW IndexData();
-        mRenderOp.indexData->indexStart = 0;
-        mRenderOp.indexData->indexCount = 0;
-        // Create enough index space to render whole level
-        mRenderOp.indexData->indexBuffer = HardwareBufferManager::getSingleton()
-            .createIndexBuffer(
-                HardwareIndexBuffer::IT_32BIT, // always 32-bit
-                mLevel->mNumIndexes, 
-                HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, false);
-
-        mRenderOp.operationType = RenderOperation::OT_TRIANGLE_LIST;
-        mRenderOp.useIndexes = true;
-
-
+        initStaticGeometry();
     }
     //-----------------------------------------------------------------------
     void BspSceneManager::_findVisibleObjects(Camera* cam, 
@@ -221,50 +190,167 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void BspSceneManager::initStaticGeometry(void)
+    {
+        freeMemory();
+
+        // Find the material of each face group which is rendered
+        int numFaceGroups = mLevel->mNumFaceGroups;
+        vector<Material*>::type faceGroupMaterials(numFaceGroups, (Material*)0);
+        typedef map<Material*, int, materialLess>::type MaterialIndexMap;
+        MaterialIndexMap materialIndexes;
+        mFaceListIndexStart.assign(numFaceGroups, 0);
+        size_t maxIndexes = 0;
+
+        const unsigned int* pSrc = static_cast<const unsigned int*>(
+            mLevel->mIndexes->lock(HardwareBuffer::HBL_READ_ONLY));
+        for (int i = 0; i < numFaceGroups; ++i)
+        {
+            const StaticFaceGroup* faceGroup = mLevel->mFaceGroups + i;
+            // Skip sky always
+            if (faceGroup->isSky)
+                continue;
+
+            if (faceGroup->fType == FGT_FACE_LIST)
+            {
+                // Offset the indexes once here, since face lists never change
+                // (the indexes are sometimes reused to address different vertex chunks)
+                mFaceListIndexStart[i] = mFaceListIndexes.size();
+                const unsigned int* pElem = pSrc + faceGroup->elementStart;
+                for (int elem = 0; elem < faceGroup->numElements; ++elem)
+                {
+                    mFaceListIndexes.push_back(
+                        *pElem++ + static_cast<unsigned int>(faceGroup->vertexStart));
+                }
+                maxIndexes += faceGroup->numElements;
+            }
+            else if (faceGroup->fType == FGT_PATCH)
+            {
+                maxIndexes += faceGroup->patchSurf->getRequiredIndexCount();
+            }
+            else
+            {
+                // Unsupported face type
+                continue;
+            }
+
+            // Get Material pointer by handle
+            Material* mat = static_cast<Material*>(MaterialManager::getSingleton()
+                .getByHandle(faceGroup->materialHandle).getPointer());
+            assert(mat);
+            faceGroupMaterials[i] = mat;
+            materialIndexes.insert(MaterialIndexMap::value_type(mat, 0));
+        }
+        mLevel->mIndexes->unlock();
+
+        // One bucket per material, in the order materials were rendered before
+        mMaterialBuckets.resize(materialIndexes.size());
+        int bucket = 0;
+        for (MaterialIndexMap::iterator mi = materialIndexes.begin(); mi != materialIndexes.end(); ++mi)
+        {
+            MaterialBucket& mb = mMaterialBuckets[bucket];
+            mb.material = mi->first;
+            mb.indexStart = 0;
+            mb.indexCount = 0;
+            mi->second = bucket++;
+        }
+        mFaceGroupBucket.assign(numFaceGroups, -1);
+        for (int i = 0; i < numFaceGroups; ++i)
+        {
+            if (faceGroupMaterials[i])
+                mFaceGroupBucket[i] = materialIndexes[faceGroupMaterials[i]];
+        }
+        mFaceGroupWalk.assign(numFaceGroups, 0);
+
+        // Init static render operation
+        mRenderOp.vertexData = mLevel->mVertexData;
+        // index data is only uploaded when the visible face groups change
+        mRenderOp.indexData = OGRE_NEW IndexData();
+        mRenderOp.indexData->indexStart = 0;
+        mRenderOp.indexData->indexCount = 0;
+        // Create enough index space to render every face group at full detail
+        mRenderOp.indexData->indexBuffer = HardwareBufferManager::getSingleton()
+            .createIndexBuffer(
+                HardwareIndexBuffer::IT_32BIT, // always 32-bit
+                std::max(maxIndexes, (size_t)1), 
+                HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY, false);
+
+        mRenderOp.operationType = RenderOperation::OT_TRIANGLE_LIST;
+        mRenderOp.useIndexes = true;
+    }
+    //-----------------------------------------------------------------------
     void BspSceneManager::renderStaticGeometry(void)
     {
         // Check we should be rendering
-        if (!isRenderQueueToBeProcessed(mWorldGeometryRenderQueue))
+        if (!isRenderQueueToBeProcessed(mWorldGeometryRenderQueue) || mMaterialBuckets.empty())
             return;
 
-        // Cache vertex/face data first
-        vector<StaticFaceGroup*>::type::const_iterator faceGrpi;
-        static RenderOperation patchOp;
-        
-        // no world transform required
-        mDestRenderSystem->_setWorldMatrix(Matrix4::IDENTITY);
-        // Set view / proj
-        setViewMatrix(mCachedViewMatrix);
-        mDestRenderSystem->_setProjectionMatrix(mCameraInProgress->getProjectionMatrixRS());
+        MaterialBucketList::iterator mbi, mbend = mMaterialBuckets.end();
 
-        // For each material in turn, cache rendering data & render
-        MaterialFaceGroupMap::const_iterator mati;
+        // Upload the indexes again only if the visible face groups have changed,
+        // or a patch has been subdivided differently
+        bool upload = false;
+        for (mbi = mMaterialBuckets.begin(); mbi != mbend && !upload; ++mbi)
+        {
+            if (mbi->faceGroups != mbi->uploadedFaceGroups)
+            {
+                upload = true;
+                break;
+            }
+            size_t indexCount = 0;
+            vector<int>::type::const_iterator fgi, fgend = mbi->faceGroups.end();
+            for (fgi = mbi->faceGroups.begin(); fgi != fgend; ++fgi)
+            {
+                const StaticFaceGroup* faceGroup = mLevel->mFaceGroups + *fgi;
+                indexCount += faceGroup->fType == FGT_PATCH ?
+                    faceGroup->patchSurf->getCurrentIndexCount() : faceGroup->numElements;
+            }
+            upload = indexCount != mbi->indexCount;
+        }
 
-        for (mati = mMatFaceGroupMap.begin(); mati != mMatFaceGroupMap.end(); ++mati)
+        if (upload)
         {
-            // Get Material
-            Material* thisMaterial = mati->first;
-            thisMaterial->touch();
-            // Empty existing cache
-            mRenderOp.indexData->indexCount = 0;
-            // lock index buffer ready to receive data
+            // Cache the face groups of all materials one after the other
             unsigned int* pIdx = static_cast<unsigned int*>(
                 mRenderOp.indexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
-
-            for (faceGrpi = mati->second.begin(); faceGrpi != mati->second.end(); ++faceGrpi)
+            const unsigned int* pSrc = static_cast<const unsigned int*>(
+                mLevel->mIndexes->lock(HardwareBuffer::HBL_READ_ONLY));
+            size_t indexStart = 0;
+            for (mbi = mMaterialBuckets.begin(); mbi != mbend; ++mbi)
             {
-                // Cache each
-                unsigned int numelems = cacheGeometry(pIdx, *faceGrpi);
-                mRenderOp.indexData->indexCount += numelems;
-                pIdx += numelems;
+                mbi->indexStart = indexStart;
+                vector<int>::type::const_iterator fgi, fgend = mbi->faceGroups.end();
+                for (fgi = mbi->faceGroups.begin(); fgi != fgend; ++fgi)
+                {
+                    unsigned int numelems = cacheGeometry(pIdx, pSrc, *fgi);
+                    indexStart += numelems;
+                    pIdx += numelems;
+                }
+                mbi->indexCount = indexStart - mbi->indexStart;
+                mbi->uploadedFaceGroups = mbi->faceGroups;
             }
-            // Unlock the buffer
+            mLevel->mIndexes->unlock();
             mRenderOp.indexData->indexBuffer->unlock();
+        }
+        
+        // no world transform required
+        mDestRenderSystem->_setWorldMatrix(Matrix4::IDENTITY);
+        // Set view / proj
+        setViewMatrix(mCachedViewMatrix);
+        mDestRenderSystem->_setProjectionMatrix(mCameraInProgress->getProjectionMatrixRS());
 
+        // For each material in turn, render its range of the cache
+        for (mbi = mMaterialBuckets.begin(); mbi != mbend; ++mbi)
+        {
             // Skip if no faces to process (we're not doing flare types yet)
-            if (mRenderOp.indexData->indexCount == 0)
+            if (mbi->indexCount == 0)
                 continue;
 
+            Material* thisMaterial = mbi->material;
+            thisMaterial->touch();
+            mRenderOp.indexData->indexStart = mbi->indexStart;
+            mRenderOp.indexData->indexCount = mbi->indexCount;
+
             Technique::PassIterator pit = thisMaterial->getBestTechnique()->getPassIterator();
 
             while (pit.hasMoreElements())
@@ -301,7 +387,29 @@ namespace Ogre {
     bool firstTime = true;
     std::ofstream of;
     //-----------------------------------------------------------------------
-    //-----------------------------------------------------------------------
+    const vector<BspNode*>::type& BspSceneManager::getPVSLeaves(const Camera* camera,
+        const BspNode* cameraNode)
+    {
+        std::pair<ClusterLeavesMap::iterator, bool> inserted =
+            mClusterLeaves.insert(ClusterLeavesMap::value_type(camera, ClusterLeaves()));
+        ClusterLeaves& cache = inserted.first->second;
+        int cluster = cameraNode->getVisCluster();
+        if (inserted.second || cache.cluster != cluster)
+        {
+            // Scan through all the leaf nodes looking for those in the PVS
+            cache.cluster = cluster;
+            cache.leaves.clear();
+            int i = mLevel->mNumNodes - mLevel->mLeafStart;
+            BspNode* nd = mLevel->mRootNode + mLevel->mLeafStart;
+            while (i--)
+            {
+                if (mLevel->isLeafVisible(cameraNode, nd))
+                    cache.leaves.push_back(nd);
+                nd++;
+            }
+        }
+        return cache.leaves;
+    }
     //-----------------------------------------------------------------------
     BspNode* BspSceneManager::walkTree(Camera* camera, 
         VisibleObjectsBoundsInfo *visibleBounds, bool onlyShadowCasters)
@@ -311,66 +419,26 @@ namespace Ogre {
         // Locate the leaf node where the camera is located
         BspNode* cameraNode = mLevel->findLeaf(camera->getDerivedPosition());
 
-        mMatFaceGroupMap.clear();
-        mFaceGroupSet.clear();
-
-        // Scan through all the other leaf nodes looking for visibles
-        int i = mLevel->mNumNodes - mLevel->mLeafStart;
-        BspNode* nd = mLevel->mRootNode + mLevel->mLeafStart;
-
-        /*
-        if (firstTime)
-        {
-            camera->getViewMatrix(); // Force update view before report
-            of.open("BspSceneManager.log");
-            of << *camera << std::endl;
-            of << "Camera Node: " << *cameraNode << std::endl;
-            of << "Vertex Data: " << std::endl;
-            for (int testi = 0; testi < mLevel->mNumVertices; ++testi)
-            {
-                of << " " << testi << ": pos(" <<
-                  mLevel->mVertices[testi].position[0] << ", " <<
-                    mLevel->mVertices[testi].position[1] << ", " << mLevel->mVertices[testi].position[2] << ")" <<
-                    " uv(" << mLevel->mVertices[testi].texcoords[0] << ", " << mLevel->mVertices[testi].texcoords[1] << ")" <<
-                    " lm(" << mLevel->mVertices[testi].lightmap[0] << ", " << mLevel->mVertices[testi].lightmap[1] << ")" << std::endl;
-            }
-            of << "Element data:" << std::endl;
-            for (testi = 0; testi < mLevel->mNumElements; ++testi)
-            {
-                of << " " << testi << ": " << mLevel->mElements[testi] << std::endl;
-
-            }
-        }
-        */
+        // Start a new walk, keeping the memory of the buckets
+        ++mWalkCount;
+        MaterialBucketList::iterator mbi, mbend = mMaterialBuckets.end();
+        for (mbi = mMaterialBuckets.begin(); mbi != mbend; ++mbi)
+            mbi->faceGroups.clear();
 
-        while (i--)
+        // Only the leaves visible according to PVS need checking against the frustum
+        const vector<BspNode*>::type& leaves = getPVSLeaves(camera, cameraNode);
+        vector<BspNode*>::type::const_iterator li, liend = leaves.end();
+        for (li = leaves.begin(); li != liend; ++li)
         {
-            if (mLevel->isLeafVisible(cameraNode, nd))
+            BspNode* nd = *li;
+            if (camera->isVisible(nd->getBoundingBox()))
             {
-
-                // Visible according to PVS, check bounding box against frustum
-                FrustumPlane plane;
-                if (camera->isVisible(nd->getBoundingBox(), &plane))
-                {
-                    //if (firstTime)
-                    //{
-                    //    of << "Visible Node: " << *nd << std::endl;
-                    //}
-                    processVisibleLeaf(nd, camera, visibleBounds, onlyShadowCasters);
-                    if (mShowNodeAABs)
-                        addBoundingBox(nd->getBoundingBox(), true);
-                }
+                processVisibleLeaf(nd, camera, visibleBounds, onlyShadowCasters);
+                if (mShowNodeAABs)
+                    addBoundingBox(nd->getBoundingBox(), true);
             }
-            nd++;
         }
 
-
-        // TEST
-        //if (firstTime)
-        //{
-        //    of.close();
-        //    firstTime = false;
-        //}
         return cameraNode;
 
     }
@@ -378,12 +446,11 @@ namespace Ogre {
     void BspSceneManager::processVisibleLeaf(BspNode* leaf, Camera* cam, 
         VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
     {
-        MaterialPtr pMat;
         // Skip world geometry if we're only supposed to process shadow casters
         // World is pre-lit
         if (!onlyShadowCasters)
         {
-            // Parse the leaf node's faces, add face groups to material map
+            // Parse the leaf node's faces, add face groups to material buckets
             int numGroups = leaf->getNumFaceGroups();
             int idx = leaf->getFaceGroupStart();
 
@@ -391,35 +458,23 @@ namespace Ogre {
             {
                 int realIndex = mLevel->mLeafFaceGroups[idx++];
                 // Check not already included
-                if (mFaceGroupSet.find(realIndex) != mFaceGroupSet.end())
+                if (mFaceGroupWalk[realIndex] == mWalkCount)
                     continue;
-                StaticFaceGroup* faceGroup = mLevel->mFaceGroups + realIndex;
-                // Get Material pointer by handle
-                pMat = MaterialManager::getSingleton().getByHandle(faceGroup->materialHandle).staticCast<Material>();
-                assert (!pMat.isNull());
+                mFaceGroupWalk[realIndex] = mWalkCount;
+                int bucket = mFaceGroupBucket[realIndex];
+                if (bucket < 0)
+                    continue;
+                MaterialBucket& mb = mMaterialBuckets[bucket];
                 // Check normal (manual culling)
-                ManualCullingMode cullMode = pMat->getTechnique(0)->getPass(0)->getManualCullingMode();
+                ManualCullingMode cullMode = mb.material->getTechnique(0)->getPass(0)->getManualCullingMode();
                 if (cullMode != MANUAL_CULL_NONE)
                 {
-                    Real dist = faceGroup->plane.getDistance(cam->getDerivedPosition());
+                    Real dist = mLevel->mFaceGroups[realIndex].plane.getDistance(cam->getDerivedPosition());
                     if ( (dist < 0 && cullMode == MANUAL_CULL_BACK) ||
                         (dist > 0 && cullMode == MANUAL_CULL_FRONT) )
                         continue; // skip
                 }
-                mFaceGroupSet.insert(realIndex);
-                // Try to insert, will find existing if already there
-                std::pair<MaterialFaceGroupMap::iterator, bool> matgrpi;
-                matgrpi = mMatFaceGroupMap.insert(
-                    MaterialFaceGroupMap::value_type(pMat.getPointer(), vector<StaticFaceGroup*>::type())
-                    );
-                // Whatever happened, matgrpi.first is map iterator
-                // Need to get second part of that to get vector
-                matgrpi.first->second.push_back(faceGroup);
-
-                //if (firstTime)
-                //{
-                //    of << "  Emitting faceGroup: index=" << realIndex << ", " << *faceGroup << std::endl;
-                //}
+                mb.faceGroups.push_back(realIndex);
             }
         }
 
@@ -443,48 +498,29 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     unsigned int BspSceneManager::cacheGeometry(unsigned int* pIndexes, 
-        const StaticFaceGroup* faceGroup)
+        const unsigned int* pSrc, int faceGroupIndex)
     {
-        // Skip sky always
-        if (faceGroup->isSky)
-            return 0;
-
-        size_t idxStart, numIdx, vertexStart;
+        const StaticFaceGroup* faceGroup = mLevel->mFaceGroups + faceGroupIndex;
 
         if (faceGroup->fType == FGT_FACE_LIST)
         {
-            idxStart = faceGroup->elementStart;
-            numIdx = faceGroup->numElements;
-            vertexStart = faceGroup->vertexStart;
+            // Already offset when the level was loaded
+            size_t numIdx = faceGroup->numElements;
+            memcpy(pIndexes, &mFaceListIndexes[mFaceListIndexStart[faceGroupIndex]],
+                numIdx * sizeof(unsigned int));
+            return static_cast<unsigned int>(numIdx);
         }
-        else if (faceGroup->fType == FGT_PATCH)
-        {
 
-            idxStart = faceGroup->patchSurf->getIndexOffset();
-            numIdx = faceGroup->patchSurf->getCurrentIndexCount();
-            vertexStart = faceGroup->patchSurf->getVertexOffset();
-        }
-        else
-        {
-            // Unsupported face type
-            return 0;
-        }
-
-
-        // Copy index data
-        unsigned int* pSrc = static_cast<unsigned int*>(
-            mLevel->mIndexes->lock(
-                idxStart * sizeof(unsigned int),
-                numIdx * sizeof(unsigned int), 
-                HardwareBuffer::HBL_READ_ONLY));
-        // Offset the indexes here
-        // we have to do this now rather than up-front because the 
-        // indexes are sometimes reused to address different vertex chunks
+        // Patches are triangulated again when their subdivision changes, so
+        // their indexes are copied as they are now
+        size_t idxStart = faceGroup->patchSurf->getIndexOffset();
+        size_t numIdx = faceGroup->patchSurf->getCurrentIndexCount();
+        unsigned int vertexStart = static_cast<unsigned int>(faceGroup->patchSurf->getVertexOffset());
+        pSrc += idxStart;
         for (size_t elem = 0; elem < numIdx; ++elem)
         {
-            *pIndexes++ = *pSrc++ + static_cast<unsigned int>(vertexStart);
+            *pIndexes++ = *pSrc++ + vertexStart;
         }
-        mLevel->mIndexes->unlock();
 
         // return number of elements
         return static_cast<unsigned int>(numIdx);
@@ -498,6 +534,13 @@ namespace Ogre {
         // no need to delete index buffer, will be handled by shared pointer
         OGRE_DELETE mRenderOp.indexData;
         mRenderOp.indexData = 0;
+
+        mMaterialBuckets.clear();
+        mFaceGroupBucket.clear();
+        mFaceGroupWalk.clear();
+        mFaceListIndexes.clear();
+        mFaceListIndexStart.clear();
+        mClusterLeaves.clear();
     }
     //-----------------------------------------------------------------------
     void BspSceneManager::showNodeBoxes(bool show)
@@ -0,0 +1,90 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef _BasisImageCodec_H__
+#define _BasisImageCodec_H__
+
+#include "OgreImageCodec.h"
+
+namespace Ogre {
+    /** \addtogroup Plugins Plugins
+    *  @{
+    */
+    /** \defgroup BasisCodec BasisCodec
+    * Codec transcoding Basis Universal supercompressed images.
+    *  @{
+    */
+    /** Codec transcoding Basis Universal supercompressed images, from .basis
+        or KTX2 files.
+    @remarks
+        Images are transcoded straight to the best compressed format the
+        render system supports, see getTargetFormat, so a single file serves
+        every GPU. The levels, cube map faces and array slices are transcoded
+        in parallel on the workers of the WorkQueue of Root.
+    @par
+        Cube map arrays, videos and volumes are not supported. Texture arrays
+        keep their first level only, since Image halves the depth of each
+        level; let the hardware generate their mipmaps.
+    */
+    class BasisCodec : public ImageCodec
+    {
+    public:
+        /** Constructor.
+        @param type "basis" or "ktx2"
+        */
+        BasisCodec(const String& type);
+        virtual ~BasisCodec();
+
+        /// @copydoc Codec::encode
+        DataStreamPtr encode(MemoryDataStreamPtr& input, CodecDataPtr& pData) const;
+        /// @copydoc Codec::encodeToFile
+        void encodeToFile(MemoryDataStreamPtr& input, const String& outFileName, CodecDataPtr& pData) const;
+        /// @copydoc Codec::decode
+        DecodeResult decode(DataStreamPtr& input) const;
+        /// @copydoc Codec::magicNumberToFileExt
+        String magicNumberToFileExt(const char* magicNumberPtr, size_t maxbytes) const;
+
+        String getType() const;
+
+        /** Gets the pixel format images are transcoded to.
+        @remarks
+            From the capabilities of the current render system, in order of
+            preference BC7, ASTC 4x4, ETC2, DXT and ETC1 for opaque images.
+            Images are transcoded to PF_BYTE_RGBA when none is supported, or
+            when there is no render system yet.
+        @param hasAlpha Whether the image has an alpha channel
+        */
+        static PixelFormat getTargetFormat(bool hasAlpha);
+
+    protected:
+        String mType;
+    };
+    /** @} */
+    /** @} */
+} // namespace
+
+#endif
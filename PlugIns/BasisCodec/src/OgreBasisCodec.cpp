@@ -0,0 +1,350 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreStableHeaders.h"
+
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
+#include "OgreWorkQueue.h"
+#include "OgreImage.h"
+#include "OgreException.h"
+
+#include "OgreBasisCodec.h"
+
+#include <basisu_transcoder.h>
+
+namespace Ogre {
+namespace {
+    /// A level of a face or slice, and where it goes in the image
+    struct TranscodeJob
+    {
+        uint32 level;
+        uint32 layer;
+        uint32 face;
+        size_t offset;
+        size_t size;
+    };
+
+    /// Transcodes the levels of a .basis or KTX2 file, whichever transcoder is given
+    class TranscodeTask : public WorkQueue::ParallelTask
+    {
+        const basist::basisu_transcoder* mBasis;
+        basist::ktx2_transcoder* mKTX2;
+        const uchar* mData;
+        uint32 mDataSize;
+        uint32 mNumFaces;
+        basist::transcoder_texture_format mFormat;
+        uchar* mDest;
+        const TranscodeJob* mJobs;
+        // Per job, so the workers never write the same element
+        vector<uchar>::type mFailed;
+    public:
+        TranscodeTask(const basist::basisu_transcoder* basis, basist::ktx2_transcoder* ktx2,
+            const uchar* data, uint32 dataSize, uint32 numFaces,
+            basist::transcoder_texture_format format, uchar* dest,
+            const vector<TranscodeJob>::type& jobs)
+            : mBasis(basis), mKTX2(ktx2), mData(data), mDataSize(dataSize), mNumFaces(numFaces)
+            , mFormat(format), mDest(dest), mJobs(&jobs[0]), mFailed(jobs.size(), 0)
+        {
+        }
+
+        void execute(size_t begin, size_t end)
+        {
+            const uint32 blockSize = basist::basis_get_bytes_per_block_or_pixel(mFormat);
+            for (size_t i = begin; i < end; ++i)
+            {
+                const TranscodeJob& job = mJobs[i];
+                const uint32 numBlocks = static_cast<uint32>(job.size / blockSize);
+                bool ok;
+                if (mBasis)
+                {
+                    // Images are the faces of each slice in turn
+                    basist::basisu_transcoder_state state;
+                    ok = mBasis->transcode_image_level(mData, mDataSize, job.layer * mNumFaces + job.face,
+                        job.level, mDest + job.offset, numBlocks, mFormat, 0, 0, &state);
+                }
+                else
+                {
+                    basist::ktx2_transcoder_state state;
+                    ok = mKTX2->transcode_image_level(job.level, job.layer, job.face,
+                        mDest + job.offset, numBlocks, mFormat, 0, 0, 0, -1, -1, &state);
+                }
+                mFailed[i] = !ok;
+            }
+        }
+
+        /// Index of the first job which failed, or -1 if all succeeded
+        int getFirstFailure(void) const
+        {
+            for (size_t i = 0; i < mFailed.size(); ++i)
+            {
+                if (mFailed[i])
+                    return static_cast<int>(i);
+            }
+            return -1;
+        }
+    };
+
+    basist::transcoder_texture_format getTranscoderFormat(PixelFormat format)
+    {
+        switch (format)
+        {
+        case PF_BC7_UNORM:
+            return basist::transcoder_texture_format::cTFBC7_RGBA;
+        case PF_ASTC_RGBA_4X4_LDR:
+            return basist::transcoder_texture_format::cTFASTC_4x4_RGBA;
+        case PF_ETC2_RGBA8:
+            return basist::transcoder_texture_format::cTFETC2_RGBA;
+        case PF_ETC2_RGB8:
+        case PF_ETC1_RGB8:
+            // ETC1 is a subset of ETC2
+            return basist::transcoder_texture_format::cTFETC1_RGB;
+        case PF_DXT5:
+            return basist::transcoder_texture_format::cTFBC3_RGBA;
+        case PF_DXT1:
+            return basist::transcoder_texture_format::cTFBC1_RGB;
+        default:
+            return basist::transcoder_texture_format::cTFRGBA32;
+        }
+    }
+}
+    //---------------------------------------------------------------------
+    BasisCodec::BasisCodec(const String& type) : mType(type)
+    {
+        // Builds the transcoder tables, only the first call does anything
+        basist::basisu_transcoder_init();
+    }
+    //---------------------------------------------------------------------
+    BasisCodec::~BasisCodec()
+    {
+    }
+    //---------------------------------------------------------------------
+    DataStreamPtr BasisCodec::encode(MemoryDataStreamPtr& input, Codec::CodecDataPtr& pData) const
+    {
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+                    "Basis encoding not supported, use the basisu tool",
+                    "BasisCodec::encode" ) ;
+    }
+    //---------------------------------------------------------------------
+    void BasisCodec::encodeToFile(MemoryDataStreamPtr& input,
+        const String& outFileName, Codec::CodecDataPtr& pData) const
+    {
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+                    "Basis encoding not supported, use the basisu tool",
+                    "BasisCodec::encodeToFile" ) ;
+    }
+    //---------------------------------------------------------------------
+    PixelFormat BasisCodec::getTargetFormat(bool hasAlpha)
+    {
+        Root* root = Root::getSingletonPtr();
+        RenderSystem* rs = root ? root->getRenderSystem() : 0;
+        const RenderSystemCapabilities* caps = rs ? rs->getCapabilities() : 0;
+        if (caps)
+        {
+            if (caps->hasCapability(RSC_TEXTURE_COMPRESSION_BC6H_BC7))
+                return PF_BC7_UNORM;
+            if (caps->hasCapability(RSC_TEXTURE_COMPRESSION_ASTC))
+                return PF_ASTC_RGBA_4X4_LDR;
+            if (caps->hasCapability(RSC_TEXTURE_COMPRESSION_ETC2))
+                return hasAlpha ? PF_ETC2_RGBA8 : PF_ETC2_RGB8;
+            if (caps->hasCapability(RSC_TEXTURE_COMPRESSION_DXT))
+                return hasAlpha ? PF_DXT5 : PF_DXT1;
+            if (caps->hasCapability(RSC_TEXTURE_COMPRESSION_ETC1) && !hasAlpha)
+                return PF_ETC1_RGB8;
+        }
+        return PF_BYTE_RGBA;
+    }
+    //---------------------------------------------------------------------
+    Codec::DecodeResult BasisCodec::decode(DataStreamPtr& input) const
+    {
+        // The transcoders work on the whole file in memory
+        MemoryDataStreamPtr memStream;
+        if (MemoryDataStream* inMemory = dynamic_cast<MemoryDataStream*>(input.get()))
+        {
+            memStream.bind(OGRE_NEW MemoryDataStream(inMemory->getCurrentPtr(),
+                inMemory->size() - inMemory->tell(), false, true));
+        }
+        else
+        {
+            memStream.bind(OGRE_NEW MemoryDataStream(input, true));
+        }
+        const uchar* data = memStream->getPtr();
+        const uint32 dataSize = static_cast<uint32>(memStream->size());
+
+        basist::basisu_transcoder basis;
+        basist::ktx2_transcoder ktx2;
+        uint32 width, height, numLevels, numFaces, numLayers;
+        bool hasAlpha;
+        bool ok;
+        if (mType == "ktx2")
+        {
+            ok = ktx2.init(data, dataSize);
+            width = ktx2.get_width();
+            height = ktx2.get_height();
+            numLevels = ktx2.get_levels();
+            numFaces = ktx2.get_faces();
+            numLayers = std::max(ktx2.get_layers(), 1u);
+            hasAlpha = ktx2.get_has_alpha();
+            ok = ok && ktx2.start_transcoding();
+        }
+        else
+        {
+            basist::basisu_file_info fileInfo;
+            basist::basisu_image_info imageInfo;
+            if (!basis.validate_header(data, dataSize) ||
+                !basis.get_file_info(data, dataSize, fileInfo) ||
+                !basis.get_image_info(data, dataSize, imageInfo, 0))
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                    "Invalid basis file: " + input->getName(),
+                    "BasisCodec::decode");
+            }
+            width = imageInfo.m_orig_width;
+            height = imageInfo.m_orig_height;
+            numLevels = imageInfo.m_total_levels;
+            hasAlpha = imageInfo.m_alpha_flag;
+            switch (fileInfo.m_tex_type)
+            {
+            case basist::cBASISTexType2D:
+                numFaces = 1;
+                numLayers = 1;
+                break;
+            case basist::cBASISTexType2DArray:
+                numFaces = 1;
+                numLayers = fileInfo.m_total_images;
+                break;
+            case basist::cBASISTexTypeCubemapArray:
+                numFaces = 6;
+                numLayers = fileInfo.m_total_images / 6;
+                break;
+            default:
+                OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+                    "Basis videos and volumes are not supported: " + input->getName(),
+                    "BasisCodec::decode");
+            }
+            ok = basis.start_transcoding(data, dataSize);
+        }
+
+        if (!ok || !numLevels)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Invalid " + mType + " file: " + input->getName(),
+                "BasisCodec::decode");
+        }
+        if ((numFaces != 1 && numFaces != 6) || (numFaces == 6 && numLayers > 1))
+        {
+            OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+                "Cube map arrays are not supported: " + input->getName(),
+                "BasisCodec::decode");
+        }
+        // Image halves the depth with each level, which arrays must not do
+        if (numLayers > 1)
+            numLevels = 1;
+
+        ImageData* imgData = OGRE_NEW ImageData();
+        imgData->width = width;
+        imgData->height = height;
+        imgData->depth = numLayers;
+        imgData->num_mipmaps = static_cast<uint8>(numLevels - 1);
+        imgData->format = getTargetFormat(hasAlpha);
+        imgData->flags = 0;
+        if (PixelUtil::isCompressed(imgData->format))
+            imgData->flags |= IF_COMPRESSED;
+        if (numFaces == 6)
+            imgData->flags |= IF_CUBEMAP;
+
+        // All mips for a face, then each face, with the slices of each level together
+        vector<TranscodeJob>::type jobs;
+        size_t offset = 0;
+        for (uint32 face = 0; face < numFaces; ++face)
+        {
+            for (uint32 level = 0; level < numLevels; ++level)
+            {
+                size_t sliceSize = PixelUtil::getMemorySize(std::max(width >> level, 1u),
+                    std::max(height >> level, 1u), 1, imgData->format);
+                for (uint32 layer = 0; layer < numLayers; ++layer)
+                {
+                    TranscodeJob job = { level, layer, face, offset, sliceSize };
+                    jobs.push_back(job);
+                    offset += sliceSize;
+                }
+            }
+        }
+        imgData->size = offset;
+
+        MemoryDataStreamPtr output;
+        output.bind(OGRE_NEW MemoryDataStream(imgData->size));
+
+        TranscodeTask task(mType == "ktx2" ? 0 : &basis, mType == "ktx2" ? &ktx2 : 0,
+            data, dataSize, numFaces, getTranscoderFormat(imgData->format), output->getPtr(), jobs);
+        Root* root = Root::getSingletonPtr();
+        WorkQueue* queue = root ? root->getWorkQueue() : 0;
+        if (queue)
+            queue->parallelFor(jobs.size(), 1, &task);
+        else
+            task.execute(0, jobs.size());
+
+        int failed = task.getFirstFailure();
+        if (failed >= 0)
+        {
+            String msg = "Failed to transcode level " + StringConverter::toString(jobs[failed].level) +
+                " of " + input->getName() + " to " + PixelUtil::getFormatName(imgData->format);
+            OGRE_DELETE imgData;
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, msg, "BasisCodec::decode");
+        }
+
+        DecodeResult ret;
+        ret.first = output;
+        ret.second = CodecDataPtr(imgData);
+        return ret;
+    }
+    //---------------------------------------------------------------------    
+    String BasisCodec::getType() const 
+    {
+        return mType;
+    }
+    //---------------------------------------------------------------------
+    String BasisCodec::magicNumberToFileExt(const char* magicNumberPtr, size_t maxbytes) const
+    {
+        if (mType == "ktx2")
+        {
+            const uchar KTX2FileIdentifier[12] =
+                { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+            if (maxbytes >= sizeof(KTX2FileIdentifier) &&
+                memcmp(magicNumberPtr, KTX2FileIdentifier, sizeof(KTX2FileIdentifier)) == 0)
+                return mType;
+        }
+        // The signature of the basis header, 'B' << 8 | 's' in little endian
+        else if (maxbytes >= 2 && magicNumberPtr[0] == 's' && magicNumberPtr[1] == 'B')
+        {
+            return mType;
+        }
+
+        return BLANKSTRING;
+    }
+}
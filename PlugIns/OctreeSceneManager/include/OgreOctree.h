@@ -54,10 +54,12 @@ class OctreeNode;
 
 /** Octree datastructure for managing scene nodes.
 @remarks
-This is a loose octree implementation, meaning that each
-octant child of the octree actually overlaps it's siblings by a factor
-of .5.  This guarantees that any thing that is half the size of the parent will
-fit completely into a child, with no splitting necessary.
+This is a loose octree implementation, meaning that the culling bounds
+of each octant are its box scaled by the looseness factor, so that octant
+children overlap their siblings. With the default factor of 2, any thing that
+is half the size of the parent will fit completely into a child, with no
+splitting necessary. Octants are stored in a pool owned by the
+OctreeSceneManager, so an octant doesn't delete its children.
 */
 
 class Octree : public NodeAlloc
@@ -66,6 +68,12 @@ public:
     Octree( Octree * p );
     ~Octree();
 
+    /** Resets this octant to an empty child of the given octant, for reuse.
+    @remarks
+    The looseness is inherited from the parent.
+    */
+    void _reset( Octree * p );
+
     /** Adds an Octree scene node to this octree level.
     @remarks
     This is called by the OctreeSceneManager after
@@ -106,6 +114,21 @@ public:
     */
     Octree * mChildren[ 2 ][ 2 ][ 2 ];
 
+    /** Factor by which the culling bounds are larger than the box, greater than 1
+    */
+    Real mLooseness;
+
+    /** Depth of this octant, 0 for the root
+    */
+    int mDepth;
+
+    /** Returns the parent octant, or 0 for the root
+    */
+    Octree * getParent() const
+    {
+        return mParent;
+    }
+
     /** Determines if this octree is twice as big as the given box.
     @remarks
     This method is used by the OctreeSceneManager to determine if the given
@@ -113,6 +136,14 @@ public:
     */
     bool _isTwiceSize( const AxisAlignedBox &box ) const;
 
+    /** Determines if the given box belongs in this octant or one of its children.
+    @remarks
+    This is the case when its center is in the box of this octant, and it is
+    small enough to fit in the culling bounds. Used by the OctreeSceneManager to
+    relocate moving nodes from their current octant upward.
+    */
+    bool _fits( const AxisAlignedBox &box ) const;
+
     /**  Returns the appropriate indexes for the child of this octree into which the box will fit.
     @remarks
     This is used by the OctreeSceneManager to determine which child to traverse next when
@@ -133,6 +164,17 @@ public:
     */
     NodeList mNodes;
 
+    /** Hardware occlusion culling state, maintained by the OctreeSceneManager.
+    */
+    /// Whether the last occlusion query found this octant hidden
+    bool mOccluded;
+    /// Whether a query including this octant is still waiting for its result
+    bool mQueryPending;
+    /// Frame in which this octant was last found in the frustum
+    unsigned long mLastVisitedFrame;
+    /// Frame from which a visible octant is queried again
+    unsigned long mNextQueryFrame;
+
 protected:
 
     /** Increments the overall node count of this octree and all its parents
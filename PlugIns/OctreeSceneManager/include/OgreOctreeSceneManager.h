@@ -98,6 +98,12 @@ public:
     /** Deletes a scene node */
     virtual void destroySceneNode( const String &name );
 
+    using SceneManager::destroyCamera;
+    /** Overridden to stop occlusion culling for a destroyed camera */
+    virtual void destroyCamera( const String &name );
+    /** Overridden to stop occlusion culling for a destroyed camera */
+    virtual void destroyAllCameras( void );
+
 
 
     /** Does nothing more */
@@ -106,6 +112,9 @@ public:
     virtual void _findVisibleObjects ( Camera * cam, 
         VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters );
 
+    /** Overridden to issue the occlusion queries after the scene is rendered. */
+    virtual void _renderVisibleObjects( void );
+
     /** Alerts each unculled object, notifying it that it will be drawn.
      * Useful for doing calculations only on nodes that will be drawn, prior
      * to drawing them...
@@ -121,6 +130,41 @@ public:
         VisibleObjectsBoundsInfo* visibleBounds, bool foundvisible, 
         bool onlyShadowCasters);
 
+    /// What a traversal of part of the octree found visible, in traversal order
+    struct CullResult
+    {
+        vector< OctreeNode * >::type nodes;
+        /// Octants whose boxes are to be shown
+        vector< Octree * >::type boxOctants;
+        /// Octants to occlusion query, visible and hidden ones
+        vector< Octree * >::type visibleQueryOctants;
+        vector< Octree * >::type occludedQueryOctants;
+    };
+
+    /** Culls an octant and, if recurse is set, its children, collecting what is visible.
+    @remarks
+    Doesn't touch the render queue or any other state shared between octants, so
+    separate subtrees may be culled in parallel.
+    */
+    void _cullOctree( OctreeCamera *camera, Octree *octant, bool foundvisible, bool recurse,
+        CullResult &result );
+
+    /** Sets the number of scene nodes in the octree from which camera culling and
+    scene queries traverse the subtrees of the root's children in parallel (default 1024).
+    @remarks
+    The tasks run on the WorkQueue of Root. The results are the same, in the same
+    order, as for a serial traversal.
+    */
+    void setParallelThreshold( size_t nodes )
+    {
+        mParallelThreshold = nodes;
+    }
+    /** Gets the number of scene nodes from which traversals run in parallel */
+    size_t getParallelThreshold( void ) const
+    {
+        return mParallelThreshold;
+    }
+
     /** Checks the given OctreeNode, and determines if it needs to be moved
     * to a different octant.
     */
@@ -157,15 +201,109 @@ public:
         mShowBoxes = b;
     };
 
+    /** Enables hardware occlusion culling of the octants for a camera.
+    @remarks
+    Octants in the frustum of the camera are tested with hardware occlusion
+    queries against the depth buffer of the rendered scene, and octants found
+    hidden are skipped along with their children until a query finds them
+    visible again. Queries are issued after the scene is rendered and their
+    results are read in a later frame, so rendering never waits on the GPU
+    unless a result is more than getOcclusionQueryLatency() frames late.
+    @par
+    Following coherent hierarchical culling, visible octants are queried
+    again only every getOcclusionQueryInterval() frames, at a randomised
+    offset to spread the queries over frames, and hidden octants are
+    queried together in batches of getOcclusionQueryBatchSize(), being
+    tested individually once a batch is found visible. Octants are treated
+    as visible until a query says otherwise, so an object may be rendered
+    for a few frames after it becomes hidden, and may appear a frame or two
+    late when it is revealed.
+    @par
+    The query boxes are rendered with the "OctreeSceneManager/OcclusionQuery"
+    material, created with colour and depth writes disabled if it does not
+    exist yet. Render systems without fixed function support need it to
+    have programs, for example from the RTShader system. Only the regular
+    render of the camera is culled, not shadow texture renders.
+    @param cam The camera to cull for, or 0 to disable occlusion culling
+    */
+    void setOcclusionCamera( Camera *cam );
+    /** Gets the camera octants are occlusion culled for, or 0 if disabled */
+    Camera *getOcclusionCamera( void ) const
+    {
+        return mOcclusionCamera;
+    }
+
+    /** Sets the number of frames after which an occlusion query result is
+    waited for (default 3). */
+    void setOcclusionQueryLatency( unsigned long frames )
+    {
+        mOcclusionQueryLatency = frames;
+    }
+    /** Gets the number of frames after which an occlusion query result is waited for */
+    unsigned long getOcclusionQueryLatency( void ) const
+    {
+        return mOcclusionQueryLatency;
+    }
+
+    /** Sets the average number of frames between queries of a visible octant (default 8). */
+    void setOcclusionQueryInterval( unsigned long frames )
+    {
+        mOcclusionQueryInterval = std::max( frames, 1ul );
+    }
+    /** Gets the average number of frames between queries of a visible octant */
+    unsigned long getOcclusionQueryInterval( void ) const
+    {
+        return mOcclusionQueryInterval;
+    }
+
+    /** Sets the maximum number of hidden octants tested by a single query (default 8). */
+    void setOcclusionQueryBatchSize( size_t count )
+    {
+        mOcclusionQueryBatchSize = std::max( count, ( size_t ) 1 );
+    }
+    /** Gets the maximum number of hidden octants tested by a single query */
+    size_t getOcclusionQueryBatchSize( void ) const
+    {
+        return mOcclusionQueryBatchSize;
+    }
+
+    /** Sets the number of pixels up to which an octant counts as hidden (default 0). */
+    void setOcclusionThreshold( unsigned int pixels )
+    {
+        mOcclusionThreshold = pixels;
+    }
+    /** Gets the number of pixels up to which an octant counts as hidden */
+    unsigned int getOcclusionThreshold( void ) const
+    {
+        return mOcclusionThreshold;
+    }
+
     /** Resizes the octree to the given size */
     void resize( const AxisAlignedBox &box );
 
+    /** Sets the looseness factor of the octree, rebuilding it (default 2).
+    @remarks
+    The culling bounds of each octant are its box scaled by this factor, which
+    must be greater than 1. Lower factors give tighter culling bounds, higher
+    ones let larger nodes go deeper into the tree instead of staying in the
+    octants above, where they are tested for visibility more often.
+    */
+    void setLooseness( Real looseness );
+    /** Gets the looseness factor of the octree */
+    Real getLooseness( void ) const
+    {
+        return mLooseness;
+    }
+
     /** Sets the given option for the SceneManager
                @remarks
         Options are:
         "Size", AxisAlignedBox *;
         "Depth", int *;
         "ShowOctree", bool *;
+        "OcclusionCamera", Camera **;
+        "Looseness", Real *;
+        "ParallelThreshold", size_t *;
     */
 
     virtual bool setOption( const String &, const void * );
@@ -214,6 +352,70 @@ protected:
 
     Matrix4 mScaleFactor;
 
+    /// Storage of the octants, which are reused when the octree is rebuilt
+    deque< Octree >::type mOctantPool;
+    /// Number of octants of the pool in use
+    size_t mNumOctants;
+    /// Looseness factor of the octree
+    Real mLooseness;
+    /// Number of nodes from which traversals run in parallel
+    size_t mParallelThreshold;
+
+    /** Adds the nodes found by _cullOctree to the render queue */
+    void _queueCullResult( const CullResult &result, OctreeCamera *camera, RenderQueue *queue,
+        VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters );
+
+    /** Takes an empty octant from the pool */
+    Octree *_createOctant( Octree *parent );
+    /** Returns all the octants to the pool and creates an empty root for the given box */
+    void _resetOctree( const AxisAlignedBox &box );
+
+    /// Octants tested by a single occlusion query
+    struct OcclusionQueryBatch
+    {
+        HardwareOcclusionQuery* query;
+        vector< Octree * >::type octants;
+        /// Whether the octants were hidden when queried
+        bool occluded;
+        unsigned long frame;
+    };
+    typedef list< OcclusionQueryBatch >::type OcclusionQueryBatchList;
+    typedef vector< HardwareOcclusionQuery * >::type OcclusionQueryList;
+
+    Camera *mOcclusionCamera;
+    unsigned long mOcclusionQueryLatency;
+    unsigned long mOcclusionQueryInterval;
+    size_t mOcclusionQueryBatchSize;
+    unsigned int mOcclusionThreshold;
+    /// Whether the octants are being occlusion culled in this traversal
+    bool mOcclusionActive;
+    unsigned long mOcclusionFrame;
+    /// Distance from the camera within which octants are never queried
+    Real mOcclusionNearRadius;
+    /// Octants to query after rendering, visible and hidden ones
+    vector< Octree * >::type mVisibleQueryOctants;
+    vector< Octree * >::type mOccludedQueryOctants;
+    OcclusionQueryBatchList mPendingQueries;
+    OcclusionQueryList mFreeQueries;
+    /// Every query created, for destruction
+    OcclusionQueryList mAllQueries;
+    /// Boxes of the queried octants, 8 corners each
+    HardwareVertexBufferSharedPtr mQueryVertexBuffer;
+    HardwareIndexBufferSharedPtr mQueryIndexBuffer;
+    VertexData* mQueryVertexData;
+    IndexData* mQueryIndexData;
+    size_t mQueryBoxCapacity;
+    MaterialPtr mQueryMaterial;
+
+    /** Reads the results of the occlusion queries which are available, or too late */
+    void _readOcclusionQueries( void );
+    /** Renders the boxes of the octants found by the last traversal in occlusion queries */
+    void _issueOcclusionQueries( void );
+    /** Forgets the occlusion state, as the octree or camera changes */
+    void _resetOcclusionQueries( void );
+    /** Destroys the occlusion queries and the box buffers */
+    void _destroyOcclusionQueries( void );
+
 };
 
 /// Factory for OctreeSceneManager
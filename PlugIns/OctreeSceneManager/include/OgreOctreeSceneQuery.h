@@ -49,7 +49,11 @@ namespace Ogre
 * Octree datastructure for managing scene nodes.
 *  @{
 */
-/** Octree implementation of IntersectionSceneQuery. */
+/** Octree implementation of IntersectionSceneQuery.
+@remarks
+Finds the intersecting pairs with a sweep and prune along the x axis, so only
+pairs of objects overlapping along x are tested.
+*/
 class _OgreOctreePluginExport OctreeIntersectionSceneQuery :  public DefaultIntersectionSceneQuery
 {
 public:
@@ -49,12 +49,27 @@ bool Octree::_isTwiceSize( const AxisAlignedBox &box ) const
     if (box.isInfinite())
         return false;
 
-    Vector3 halfMBoxSize = mBox.getHalfSize();
+    // children overlap their siblings by the looseness of the octree
+    Vector3 childSpace = mBox.getHalfSize() * ( mLooseness - 1 );
     Vector3 boxSize = box.getSize();
-    return ((boxSize.x <= halfMBoxSize.x) && (boxSize.y <= halfMBoxSize.y) && (boxSize.z <= halfMBoxSize.z));
+    return ((boxSize.x <= childSpace.x) && (boxSize.y <= childSpace.y) && (boxSize.z <= childSpace.z));
 
 }
 
+bool Octree::_fits( const AxisAlignedBox &box ) const
+{
+    if ( box.isNull() || box.isInfinite() )
+        return false;
+
+    Vector3 center = box.getCenter();
+    if ( !mBox.contains( center ) )
+        return false;
+
+    Vector3 space = mBox.getSize() * ( mLooseness - 1 );
+    Vector3 boxSize = box.getSize();
+    return ((boxSize.x <= space.x) && (boxSize.y <= space.y) && (boxSize.z <= space.z));
+}
+
 /** It's assumed the the given box has already been proven to fit into
 * a child.  Since it's a loose octree, only the centers need to be
 * compared to find the appropriate node.
@@ -83,27 +98,25 @@ void Octree::_getChildIndexes( const AxisAlignedBox &box, int *x, int *y, int *z
 }
 
 Octree::Octree( Octree * parent ) 
-    : mWireBoundingBox(0),
-      mHalfSize( 0, 0, 0 )
+    : mWireBoundingBox(0)
 {
-    //initialize all children to null.
-    for ( int i = 0; i < 2; i++ )
-    {
-        for ( int j = 0; j < 2; j++ )
-        {
-            for ( int k = 0; k < 2; k++ )
-            {
-                mChildren[ i ][ j ][ k ] = 0;
-            }
-        }
-    }
-
-    mParent = parent;
-    mNumNodes = 0;
+    _reset( parent );
 }
 
 Octree::~Octree()
 {
+    // children belong to the pool of the scene manager
+    if(mWireBoundingBox)
+        OGRE_DELETE mWireBoundingBox;
+
+    mParent = 0;
+}
+
+void Octree::_reset( Octree * parent )
+{
+    mBox.setNull();
+    mHalfSize = Vector3::ZERO;
+
     //initialize all children to null.
     for ( int i = 0; i < 2; i++ )
     {
@@ -111,16 +124,21 @@ Octree::~Octree()
         {
             for ( int k = 0; k < 2; k++ )
             {
-                if ( mChildren[ i ][ j ][ k ] != 0 )
-                    OGRE_DELETE mChildren[ i ][ j ][ k ];
+                mChildren[ i ][ j ][ k ] = 0;
             }
         }
     }
 
-    if(mWireBoundingBox)
-        OGRE_DELETE mWireBoundingBox;
+    mLooseness = parent ? parent -> mLooseness : 2;
+    mDepth = parent ? parent -> mDepth + 1 : 0;
+    mNodes.clear();
+    mOccluded = false;
+    mQueryPending = false;
+    mLastVisitedFrame = 0;
+    mNextQueryFrame = 0;
 
-    mParent = 0;
+    mParent = parent;
+    mNumNodes = 0;
 }
 
 void Octree::_addNode( OctreeNode * n )
@@ -144,7 +162,8 @@ void Octree::_removeNode( OctreeNode * n )
 
 void Octree::_getCullBounds( AxisAlignedBox *b ) const
 {
-    b -> setExtents( mBox.getMinimum() - mHalfSize, mBox.getMaximum() + mHalfSize );
+    Vector3 margin = mHalfSize * ( mLooseness - 1 );
+    b -> setExtents( mBox.getMinimum() - margin, mBox.getMaximum() + margin );
 }
 
 WireBoundingBox* Octree::getWireBoundingBox()
@@ -39,6 +39,15 @@ email                : janders@users.sf.net
 #include "OgreOctreeNode.h"
 #include "OgreOctreeCamera.h"
 #include "OgreWireBoundingBox.h"
+#include "OgreOptimisedUtil.h"
+#include "OgreRoot.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreHardwareBufferManager.h"
+#include "OgreHardwareOcclusionQuery.h"
+#include "OgreRenderSystem.h"
+#include "OgreWorkQueue.h"
 
 extern "C"
 {
@@ -70,7 +79,6 @@ int OctreeSceneManager::intersect_call = 0;
 
 Intersection intersect( const Ray &one, const AxisAlignedBox &two )
 {
-    OctreeSceneManager::intersect_call++;
     // Null box?
     if (two.isNull()) return OUTSIDE;
     // Infinite box?
@@ -141,7 +149,6 @@ Intersection intersect( const Ray &one, const AxisAlignedBox &two )
 */
 Intersection intersect( const PlaneBoundedVolume &one, const AxisAlignedBox &two )
 {
-    OctreeSceneManager::intersect_call++;
     // Null box?
     if (two.isNull()) return OUTSIDE;
     // Infinite box?
@@ -182,7 +189,6 @@ Intersection intersect( const PlaneBoundedVolume &one, const AxisAlignedBox &two
 */
 Intersection intersect( const AxisAlignedBox &one, const AxisAlignedBox &two )
 {
-    OctreeSceneManager::intersect_call++;
     // Null box?
     if (one.isNull() || two.isNull()) return OUTSIDE;
     if (one.isInfinite()) return INSIDE;
@@ -223,7 +229,6 @@ Intersection intersect( const AxisAlignedBox &one, const AxisAlignedBox &two )
 */
 Intersection intersect( const Sphere &one, const AxisAlignedBox &two )
 {
-    OctreeSceneManager::intersect_call++;
     // Null box?
     if (two.isNull()) return OUTSIDE;
     if (two.isInfinite()) return INTERSECT;
@@ -281,6 +286,140 @@ Intersection intersect( const Sphere &one, const AxisAlignedBox &two )
 
 }
 
+/** Bounds of a block of the nodes attached to an octant, in the layout
+    OptimisedUtil tests. Null and infinite boxes aren't packed, their result
+    is known up front.
+*/
+struct OctantNodeBlock
+{
+    enum { SIZE = 64 };
+
+    OctreeNode* nodes[SIZE];
+    uint8 results[SIZE];
+    size_t count;
+
+    float centreX[SIZE], centreY[SIZE], centreZ[SIZE];
+    float halfX[SIZE], halfY[SIZE], halfZ[SIZE];
+    float distances[SIZE];
+    uint8 boxResults[SIZE];
+    size_t boxIndex[SIZE];
+    size_t numBoxes;
+
+    /// Fill the block from the node list, returns the iterator to carry on from
+    Octree::NodeList::iterator fill( Octree::NodeList::iterator it, Octree::NodeList::iterator end,
+        SceneNode *exclude )
+    {
+        count = numBoxes = 0;
+        for ( ; it != end && count < SIZE; ++it )
+        {
+            if ( *it == exclude )
+                continue;
+
+            const AxisAlignedBox& box = ( *it ) -> _getWorldAABB();
+            if ( box.isFinite() )
+            {
+                Vector3 centre = box.getCenter();
+                Vector3 half = box.getHalfSize();
+                centreX[ numBoxes ] = centre.x;
+                centreY[ numBoxes ] = centre.y;
+                centreZ[ numBoxes ] = centre.z;
+                halfX[ numBoxes ] = half.x;
+                halfY[ numBoxes ] = half.y;
+                halfZ[ numBoxes ] = half.z;
+                boxIndex[ numBoxes++ ] = count;
+            }
+            // Null boxes never intersect, infinite ones always do
+            results[ count ] = box.isInfinite();
+            nodes[ count++ ] = *it;
+        }
+        return it;
+    }
+
+    /// Copy the results of the packed boxes back
+    void scatter( void )
+    {
+        for ( size_t i = 0; i < numBoxes; ++i )
+            results[ boxIndex[ i ] ] = boxResults[ i ];
+    }
+
+    void test( const AxisAlignedBox &t )
+    {
+        OptimisedUtil::getImplementation() -> intersectBoxes( t,
+            centreX, centreY, centreZ, halfX, halfY, halfZ, boxResults, numBoxes );
+        scatter();
+    }
+
+    void test( const Sphere &t )
+    {
+        OptimisedUtil::getImplementation() -> intersectBoxes( t,
+            centreX, centreY, centreZ, halfX, halfY, halfZ, boxResults, numBoxes );
+        scatter();
+    }
+
+    void test( const Ray &t )
+    {
+        OptimisedUtil::getImplementation() -> intersectBoxes( t,
+            centreX, centreY, centreZ, halfX, halfY, halfZ, distances, boxResults, numBoxes );
+        scatter();
+    }
+
+    /// No batched test for plane volumes, the packed boxes are tested one by one
+    void test( const PlaneBoundedVolume &t )
+    {
+        for ( size_t i = 0; i < numBoxes; ++i )
+        {
+            Vector3 centre( centreX[ i ], centreY[ i ], centreZ[ i ] );
+            Vector3 half( halfX[ i ], halfY[ i ], halfZ[ i ] );
+            boxResults[ i ] = intersect( t, AxisAlignedBox( centre - half, centre + half ) ) != OUTSIDE;
+        }
+        scatter();
+    }
+
+    /// Same planes as Camera::isVisible uses
+    void test( const Camera *camera )
+    {
+        const Frustum* frustum = camera -> getCullingFrustum() ? camera -> getCullingFrustum() : camera;
+        const Plane* frustumPlanes = frustum -> getFrustumPlanes();
+        Plane planes[ 6 ];
+        size_t numPlanes = 0;
+        for ( int i = 0; i < 6; ++i )
+        {
+            // Skip far plane if infinite view frustum
+            if ( i == FRUSTUM_PLANE_FAR && frustum -> getFarClipDistance() == 0 )
+                continue;
+            planes[ numPlanes++ ] = frustumPlanes[ i ];
+        }
+
+        OptimisedUtil::getImplementation() -> cullBoxes( planes, numPlanes,
+            centreX, centreY, centreZ, halfX, halfY, halfZ, boxResults, numBoxes );
+        for ( size_t i = 0; i < numBoxes; ++i )
+            results[ boxIndex[ i ] ] = boxResults[ i ];
+    }
+};
+
+/** Add the nodes attached directly to a partially intersected octant which
+    intersect the volume, a block at a time. Returns the number of boxes tested.
+*/
+template <class T>
+int _findOctantNodes( const T &t, list< SceneNode * >::type &list, SceneNode *exclude, Octree *octant )
+{
+    int calls = 0;
+    OctantNodeBlock block;
+    Octree::NodeList::iterator it = octant -> mNodes.begin();
+    while ( it != octant -> mNodes.end() )
+    {
+        it = block.fill( it, octant -> mNodes.end(), exclude );
+        block.test( t );
+        calls += static_cast<int>( block.numBoxes );
+        for ( size_t i = 0; i < block.count; ++i )
+        {
+            if ( block.results[ i ] )
+                list.push_back( block.nodes[ i ] );
+        }
+    }
+    return calls;
+}
+
 unsigned long white = 0xFFFFFFFF;
 
 unsigned short OctreeSceneManager::mIndexes[ 24 ] = {0, 1, 1, 2, 2, 3, 3, 0,       //back
@@ -290,7 +429,22 @@ unsigned short OctreeSceneManager::mIndexes[ 24 ] = {0, 1, 1, 2, 2, 3, 3, 0,
 unsigned long OctreeSceneManager::mColors[ 8 ] = {white, white, white, white, white, white, white, white };
 
 
-OctreeSceneManager::OctreeSceneManager(const String& name) : SceneManager(name)
+OctreeSceneManager::OctreeSceneManager(const String& name) 
+: SceneManager(name),
+  mOcclusionCamera( 0 ),
+  mOcclusionQueryLatency( 3 ),
+  mOcclusionQueryInterval( 8 ),
+  mOcclusionQueryBatchSize( 8 ),
+  mOcclusionThreshold( 0 ),
+  mOcclusionActive( false ),
+  mOcclusionFrame( 0 ),
+  mOcclusionNearRadius( 0 ),
+  mQueryVertexData( 0 ),
+  mQueryIndexData( 0 ),
+  mQueryBoxCapacity( 0 ),
+  mNumOctants( 0 ),
+  mLooseness( 2 ),
+  mParallelThreshold( 1024 )
 {
     AxisAlignedBox b( -10000, -10000, -10000, 10000, 10000, 10000 );
     int depth = 8; 
@@ -299,7 +453,21 @@ OctreeSceneManager::OctreeSceneManager(const String& name) : SceneManager(name)
 }
 
 OctreeSceneManager::OctreeSceneManager(const String& name, AxisAlignedBox &box, int max_depth ) 
-: SceneManager(name)
+: SceneManager(name),
+  mOcclusionCamera( 0 ),
+  mOcclusionQueryLatency( 3 ),
+  mOcclusionQueryInterval( 8 ),
+  mOcclusionQueryBatchSize( 8 ),
+  mOcclusionThreshold( 0 ),
+  mOcclusionActive( false ),
+  mOcclusionFrame( 0 ),
+  mOcclusionNearRadius( 0 ),
+  mQueryVertexData( 0 ),
+  mQueryIndexData( 0 ),
+  mQueryBoxCapacity( 0 ),
+  mNumOctants( 0 ),
+  mLooseness( 2 ),
+  mParallelThreshold( 1024 )
 {
     mOctree = 0;
     init( box, max_depth );
@@ -312,23 +480,14 @@ const String& OctreeSceneManager::getTypeName(void) const
 
 void OctreeSceneManager::init( AxisAlignedBox &box, int depth )
 {
+    // queries in flight refer to the octants about to be deleted
+    _resetOcclusionQueries();
 
-    if ( mOctree != 0 )
-        OGRE_DELETE mOctree;
-
-    mOctree = OGRE_NEW Octree( 0 );
+    _resetOctree( box );
 
     mMaxDepth = depth;
     mBox = box;
 
-    mOctree -> mBox = box;
-
-    Vector3 min = box.getMinimum();
-
-    Vector3 max = box.getMaximum();
-
-    mOctree -> mHalfSize = ( max - min ) / 2;
-
 
     mShowBoxes = false;
 
@@ -350,12 +509,45 @@ void OctreeSceneManager::init( AxisAlignedBox &box, int depth )
 
 OctreeSceneManager::~OctreeSceneManager()
 {
+    _destroyOcclusionQueries();
 
-    if ( mOctree )
+    mOctree = 0;
+    mOctantPool.clear();
+    mNumOctants = 0;
+}
+
+Octree *OctreeSceneManager::_createOctant( Octree *parent )
+{
+    if ( mNumOctants == mOctantPool.size() )
+        mOctantPool.push_back( Octree( parent ) );
+    else
+        mOctantPool[ mNumOctants ]._reset( parent );
+
+    return &mOctantPool[ mNumOctants++ ];
+}
+
+void OctreeSceneManager::_resetOctree( const AxisAlignedBox &box )
+{
+    mNumOctants = 0;
+    mOctree = _createOctant( 0 );
+    mOctree -> mLooseness = mLooseness;
+    mOctree -> mBox = box;
+    mOctree -> mHalfSize = ( box.getMaximum() - box.getMinimum() ) / 2;
+}
+
+void OctreeSceneManager::setLooseness( Real looseness )
+{
+    if ( looseness <= 1 )
     {
-        OGRE_DELETE mOctree;
-        mOctree = 0;
+        OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+            "The looseness of the octree must be greater than 1",
+            "OctreeSceneManager::setLooseness" );
     }
+
+    mLooseness = looseness;
+    // copy the box since resize resets the root octant
+    AxisAlignedBox box = mOctree->mBox;
+    resize( box );
 }
 
 Camera * OctreeSceneManager::createCamera( const String &name )
@@ -388,6 +580,21 @@ void OctreeSceneManager::destroySceneNode( const String &name )
     SceneManager::destroySceneNode( name );
 }
 
+void OctreeSceneManager::destroyCamera( const String &name )
+{
+    if ( mOcclusionCamera && mOcclusionCamera->getName() == name )
+        setOcclusionCamera( 0 );
+
+    SceneManager::destroyCamera( name );
+}
+
+void OctreeSceneManager::destroyAllCameras( void )
+{
+    setOcclusionCamera( 0 );
+
+    SceneManager::destroyAllCameras();
+}
+
 bool OctreeSceneManager::getOptionValues( const String & key, StringVector  &refValueList )
 {
     return SceneManager::getOptionValues( key, refValueList );
@@ -399,6 +606,9 @@ bool OctreeSceneManager::getOptionKeys( StringVector & refKeys )
     refKeys.push_back( "Size" );
     refKeys.push_back( "ShowOctree" );
     refKeys.push_back( "Depth" );
+    refKeys.push_back( "OcclusionCamera" );
+    refKeys.push_back( "Looseness" );
+    refKeys.push_back( "ParallelThreshold" );
 
     return true;
 }
@@ -415,7 +625,9 @@ void OctreeSceneManager::_updateOctreeNode( OctreeNode * onode )
     if (!mOctree)
         return;
 
-    if ( onode -> getOctant() == 0 )
+    Octree * octant = onode -> getOctant();
+
+    if ( octant == 0 )
     {
         //if outside the octree, force into the root node.
         if ( ! onode -> _isIn( mOctree -> mBox ) )
@@ -425,16 +637,31 @@ void OctreeSceneManager::_updateOctreeNode( OctreeNode * onode )
         return ;
     }
 
-    if ( ! onode -> _isIn( onode -> getOctant() -> mBox ) )
+    if ( octant == mOctree )
     {
-        _removeOctreeNode( onode );
-
-        //if outside the octree, force into the root node.
-        if ( ! onode -> _isIn( mOctree -> mBox ) )
-            mOctree->_addNode( onode );
-        else
-            _addOctreeNode( onode, mOctree );
+        // stays in the root unless it can now go into a child
+        if ( mMaxDepth == 0 || ! onode -> _isIn( mOctree -> mBox ) || ! mOctree -> _isTwiceSize( box ) )
+            return ;
     }
+    else if ( octant -> _fits( box ) )
+    {
+        return ;
+    }
+
+    _removeOctreeNode( onode );
+
+    // relocate from the current octant upward, rather than from the root
+    while ( octant != mOctree && ! octant -> _fits( box ) )
+        octant = octant -> getParent();
+
+    if ( octant != mOctree )
+        _addOctreeNode( onode, octant, octant -> mDepth );
+
+    //if outside the octree, force into the root node.
+    else if ( ! onode -> _isIn( mOctree -> mBox ) )
+        mOctree->_addNode( onode );
+    else
+        _addOctreeNode( onode, mOctree );
 }
 
 /** Only removes the node from the octree.  It leaves the octree, even if it's empty.
@@ -475,7 +702,7 @@ void OctreeSceneManager::_addOctreeNode( OctreeNode * n, Octree *octant, int dep
 
         if ( octant -> mChildren[ x ][ y ][ z ] == 0 )
         {
-            octant -> mChildren[ x ][ y ][ z ] = OGRE_NEW Octree( octant );
+            octant -> mChildren[ x ][ y ][ z ] = _createOctant( octant );
             const Vector3& octantMin = octant -> mBox.getMinimum();
             const Vector3& octantMax = octant -> mBox.getMaximum();
             Vector3 min, max;
@@ -562,6 +789,29 @@ void OctreeSceneManager::_alertVisibleObjects( void )
 //    }
 }
 
+/** Culls the subtrees of a set of octants, each into its own result. The
+    last result is left for the caller.
+*/
+class CullOctreeTask : public WorkQueue::ParallelTask
+{
+public:
+    CullOctreeTask( OctreeSceneManager *sceneMgr, OctreeCamera *camera, const vector< Octree * >::type &octants )
+        : mSceneMgr( sceneMgr ), mCamera( camera ), mOctants( octants ), mResults( octants.size() + 1 )
+    {
+    }
+
+    void execute( size_t begin, size_t end )
+    {
+        for ( size_t i = begin; i < end; ++i )
+            mSceneMgr -> _cullOctree( mCamera, mOctants[ i ], false, true, mResults[ i ] );
+    }
+
+    OctreeSceneManager *mSceneMgr;
+    OctreeCamera *mCamera;
+    const vector< Octree * >::type &mOctants;
+    vector< OctreeSceneManager::CullResult >::type mResults;
+};
+
 void OctreeSceneManager::_findVisibleObjects(Camera * cam, 
     VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters )
 {
@@ -572,9 +822,55 @@ void OctreeSceneManager::_findVisibleObjects(Camera * cam,
 
     mNumObjects = 0;
 
+    // only the regular render of the chosen camera is occlusion culled
+    mOcclusionActive = cam == mOcclusionCamera && !onlyShadowCasters &&
+        mIlluminationStage == IRS_NONE &&
+        mDestRenderSystem->getCapabilities()->hasCapability( RSC_HWOCCLUSION );
+    if ( mOcclusionActive )
+    {
+        mOcclusionFrame = Root::getSingleton().getNextFrameNumber();
+        mVisibleQueryOctants.clear();
+        mOccludedQueryOctants.clear();
+        _readOcclusionQueries();
+
+        // boxes reaching the near plane would be clipped rather than occluded
+        const Vector3* corners = cam->getWorldSpaceCorners();
+        const Vector3& pos = cam->getDerivedPosition();
+        mOcclusionNearRadius = 0;
+        for ( int i = 0; i < 4; ++i )
+            mOcclusionNearRadius = std::max( mOcclusionNearRadius, corners[ i ].distance( pos ) );
+    }
+
     //walk the octree, adding all visible Octreenodes nodes to the render queue.
-    walkOctree( static_cast < OctreeCamera * > ( cam ), getRenderQueue(), mOctree, 
-                visibleBounds, false, onlyShadowCasters );
+    OctreeCamera *octreeCam = static_cast < OctreeCamera * > ( cam );
+    if ( static_cast < size_t > ( mOctree -> numNodes() ) < mParallelThreshold )
+    {
+        walkOctree( octreeCam, getRenderQueue(), mOctree, visibleBounds, false, onlyShadowCasters );
+    }
+    else
+    {
+        // the root is only ever partially visible, so its nodes are culled here
+        // and the subtrees of its children in parallel
+        vector< Octree * >::type children;
+        for ( int i = 0; i < 8; ++i )
+        {
+            Octree *child = mOctree -> mChildren[ i & 1 ][ ( i >> 1 ) & 1 ][ ( i >> 2 ) & 1 ];
+            if ( child && child -> numNodes() > 0 )
+                children.push_back( child );
+        }
+
+        CullOctreeTask task( this, octreeCam, children );
+        _cullOctree( octreeCam, mOctree, false, false, task.mResults.back() );
+
+        // bring the frustum planes up to date before they are shared
+        octreeCam -> getFrustumPlane( 0 );
+        OptimisedUtil::getImplementation();
+        Root::getSingleton().getWorkQueue() -> parallelFor( children.size(), 1, &task );
+
+        _queueCullResult( task.mResults.back(), octreeCam, getRenderQueue(), visibleBounds, onlyShadowCasters );
+        for ( size_t i = 0; i < children.size(); ++i )
+            _queueCullResult( task.mResults[ i ], octreeCam, getRenderQueue(), visibleBounds, onlyShadowCasters );
+    }
 
     // Show the octree boxes & cull camera if required
     if ( mShowBoxes )
@@ -590,6 +886,14 @@ void OctreeSceneManager::walkOctree( OctreeCamera *camera, RenderQueue *queue,
     Octree *octant, VisibleObjectsBoundsInfo* visibleBounds, 
     bool foundvisible, bool onlyShadowCasters )
 {
+    CullResult result;
+    _cullOctree( camera, octant, foundvisible, true, result );
+    _queueCullResult( result, camera, queue, visibleBounds, onlyShadowCasters );
+}
+
+void OctreeSceneManager::_cullOctree( OctreeCamera *camera, Octree *octant, bool foundvisible,
+    bool recurse, CullResult &result )
+{
 
     //return immediately if nothing is in the node.
     if ( octant -> numNodes() == 0 )
@@ -619,387 +923,569 @@ void OctreeSceneManager::walkOctree( OctreeCamera *camera, RenderQueue *queue,
     if ( v != OctreeCamera::NONE )
     {
 
+        if ( mOcclusionActive && octant != mOctree )
+        {
+            // octants which were out of view last frame have no valid state
+            if ( octant -> mLastVisitedFrame != mOcclusionFrame &&
+                octant -> mLastVisitedFrame + 1 != mOcclusionFrame )
+            {
+                octant -> mOccluded = false;
+                octant -> mNextQueryFrame = mOcclusionFrame;
+            }
+            octant -> mLastVisitedFrame = mOcclusionFrame;
+
+            AxisAlignedBox box;
+            octant -> _getCullBounds( &box );
+            Real nearRadius = mOcclusionNearRadius;
+            if ( box.squaredDistance( camera -> getDerivedPosition() ) <= nearRadius * nearRadius )
+            {
+                octant -> mOccluded = false;
+            }
+            else if ( octant -> mOccluded )
+            {
+                // hidden, along with all the children
+                if ( !octant -> mQueryPending )
+                    result.occludedQueryOctants.push_back( octant );
+                return;
+            }
+            else if ( !octant -> mQueryPending && octant -> mNextQueryFrame <= mOcclusionFrame )
+            {
+                result.visibleQueryOctants.push_back( octant );
+            }
+        }
+
         //Add stuff to be rendered;
         Octree::NodeList::iterator it = octant -> mNodes.begin();
 
         if ( mShowBoxes )
         {
-            mBoxes.push_back( octant->getWireBoundingBox() );
+            result.boxOctants.push_back( octant );
         }
 
-        bool vis = true;
+        // if this octree is partially visible, manually cull all
+        // scene nodes attached directly to this level, a block at a time.
+        OctantNodeBlock block;
+        size_t blockIndex = 0;
+        block.count = 0;
 
         while ( it != octant -> mNodes.end() )
         {
             OctreeNode * sn = *it;
 
-            // if this octree is partially visible, manually cull all
-            // scene nodes attached directly to this level.
-
+            bool vis = true;
             if ( v == OctreeCamera::PARTIAL )
-                vis = camera -> isVisible( sn -> _getWorldAABB() );
-
-            if ( vis )
             {
-
-                mNumObjects++;
-                sn -> _addToRenderQueue(camera, queue, onlyShadowCasters, visibleBounds );
-
-                mVisible.push_back( sn );
-
-                if ( mDisplayNodes )
-                    queue -> addRenderable( sn->getDebugRenderable() );
-
-                // check if the scene manager or this node wants the bounding box shown.
-                if (sn->getShowBoundingBox() || mShowBoundingBoxes)
-                    sn->_addBoundingBoxToQueue(queue);
+                if ( blockIndex == block.count )
+                {
+                    block.fill( it, octant -> mNodes.end(), 0 );
+                    block.test( camera );
+                    blockIndex = 0;
+                }
+                vis = block.results[ blockIndex++ ] != 0;
             }
 
+            if ( vis )
+                result.nodes.push_back( sn );
+
             ++it;
         }
 
+        if ( !recurse )
+            return ;
+
         Octree* child;
         bool childfoundvisible = (v == OctreeCamera::FULL);
         if ( (child = octant -> mChildren[ 0 ][ 0 ][ 0 ]) != 0 )
-            walkOctree( camera, queue, child, visibleBounds, childfoundvisible, onlyShadowCasters );
+            _cullOctree( camera, child, childfoundvisible, true, result );
 
         if ( (child = octant -> mChildren[ 1 ][ 0 ][ 0 ]) != 0 )
-            walkOctree( camera, queue, child, visibleBounds, childfoundvisible, onlyShadowCasters );
+            _cullOctree( camera, child, childfoundvisible, true, result );
 
         if ( (child = octant -> mChildren[ 0 ][ 1 ][ 0 ]) != 0 )
-            walkOctree( camera, queue, child, visibleBounds, childfoundvisible, onlyShadowCasters );
+            _cullOctree( camera, child, childfoundvisible, true, result );
 
         if ( (child = octant -> mChildren[ 1 ][ 1 ][ 0 ]) != 0 )
-            walkOctree( camera, queue, child, visibleBounds, childfoundvisible, onlyShadowCasters );
+            _cullOctree( camera, child, childfoundvisible, true, result );
 
         if ( (child = octant -> mChildren[ 0 ][ 0 ][ 1 ]) != 0 )
-            walkOctree( camera, queue, child, visibleBounds, childfoundvisible, onlyShadowCasters );
+            _cullOctree( camera, child, childfoundvisible, true, result );
 
         if ( (child = octant -> mChildren[ 1 ][ 0 ][ 1 ]) != 0 )
-            walkOctree( camera, queue, child, visibleBounds, childfoundvisible, onlyShadowCasters );
+            _cullOctree( camera, child, childfoundvisible, true, result );
 
         if ( (child = octant -> mChildren[ 0 ][ 1 ][ 1 ]) != 0 )
-            walkOctree( camera, queue, child, visibleBounds, childfoundvisible, onlyShadowCasters );
+            _cullOctree( camera, child, childfoundvisible, true, result );
 
         if ( (child = octant -> mChildren[ 1 ][ 1 ][ 1 ]) != 0 )
-            walkOctree( camera, queue, child, visibleBounds, childfoundvisible, onlyShadowCasters );
+            _cullOctree( camera, child, childfoundvisible, true, result );
 
     }
 
 }
 
-// --- non template versions
-void _findNodes( const AxisAlignedBox &t, list< SceneNode * >::type &list, SceneNode *exclude, bool full, Octree *octant )
+void OctreeSceneManager::_queueCullResult( const CullResult &result, OctreeCamera *camera,
+    RenderQueue *queue, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters )
 {
+    // wire boxes are set up here, as that writes to hardware buffers
+    for ( size_t i = 0; i < result.boxOctants.size(); ++i )
+        mBoxes.push_back( result.boxOctants[ i ]->getWireBoundingBox() );
 
-    if ( !full )
+    for ( size_t i = 0; i < result.nodes.size(); ++i )
     {
-        AxisAlignedBox obox;
-        octant -> _getCullBounds( &obox );
+        OctreeNode * sn = result.nodes[ i ];
 
-        Intersection isect = intersect( t, obox );
+        mNumObjects++;
+        sn -> _addToRenderQueue(camera, queue, onlyShadowCasters, visibleBounds );
 
-        if ( isect == OUTSIDE )
-            return ;
+        mVisible.push_back( sn );
 
-        full = ( isect == INSIDE );
+        if ( mDisplayNodes )
+            queue -> addRenderable( sn->getDebugRenderable() );
+
+        // check if the scene manager or this node wants the bounding box shown.
+        if (sn->getShowBoundingBox() || mShowBoundingBoxes)
+            sn->_addBoundingBoxToQueue(queue);
     }
 
+    mVisibleQueryOctants.insert( mVisibleQueryOctants.end(),
+        result.visibleQueryOctants.begin(), result.visibleQueryOctants.end() );
+    mOccludedQueryOctants.insert( mOccludedQueryOctants.end(),
+        result.occludedQueryOctants.begin(), result.occludedQueryOctants.end() );
+}
 
-    Octree::NodeList::iterator it = octant -> mNodes.begin();
+void OctreeSceneManager::_renderVisibleObjects( void )
+{
+    SceneManager::_renderVisibleObjects();
 
-    while ( it != octant -> mNodes.end() )
+    // the depth buffer now holds the scene the queries are tested against
+    if ( mOcclusionActive && mCameraInProgress == mOcclusionCamera &&
+        mIlluminationStage == IRS_NONE )
     {
-        OctreeNode * on = ( *it );
-
-        if ( on != exclude )
-        {
-            if ( full )
-            {
-                list.push_back( on );
-            }
-
-            else
-            {
-                Intersection nsect = intersect( t, on -> _getWorldAABB() );
-
-                if ( nsect != OUTSIDE )
-                {
-                    list.push_back( on );
-                }
-            }
-
-        }
-
-        ++it;
+        _issueOcclusionQueries();
     }
+}
 
-    Octree* child;
-
-    if ( (child=octant -> mChildren[ 0 ][ 0 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 1 ][ 0 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 0 ][ 1 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 1 ][ 1 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 0 ][ 0 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 1 ][ 0 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 0 ][ 1 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+void OctreeSceneManager::setOcclusionCamera( Camera *cam )
+{
+    if ( cam == mOcclusionCamera )
+        return;
 
-    if ( (child=octant -> mChildren[ 1 ][ 1 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+    if ( cam )
+        _resetOcclusionQueries();
+    else
+        _destroyOcclusionQueries();
 
+    mOcclusionCamera = cam;
 }
 
-void _findNodes( const Sphere &t, list< SceneNode * >::type &list, SceneNode *exclude, bool full, Octree *octant )
+void OctreeSceneManager::_readOcclusionQueries( void )
 {
-
-    if ( !full )
+    OcclusionQueryBatchList::iterator it = mPendingQueries.begin();
+    while ( it != mPendingQueries.end() )
     {
-        AxisAlignedBox obox;
-        octant -> _getCullBounds( &obox );
+        // wait for results that are too late rather than keep culling with stale ones
+        if ( mOcclusionFrame < it -> frame + mOcclusionQueryLatency &&
+            it -> query -> isStillOutstanding() )
+        {
+            ++it;
+            continue;
+        }
 
-        Intersection isect = intersect( t, obox );
+        unsigned int pixels = 0;
+        it -> query -> pullOcclusionQuery( &pixels );
+        bool occluded = pixels <= mOcclusionThreshold;
 
-        if ( isect == OUTSIDE )
-            return ;
+        // a visible batch of hidden octants is shown whole, and its octants are
+        // queried one by one in this frame to find out which are really visible
+        bool split = !occluded && it -> octants.size() > 1;
+        for ( size_t i = 0; i < it -> octants.size(); ++i )
+        {
+            Octree *octant = it -> octants[ i ];
+            octant -> mQueryPending = false;
+            octant -> mOccluded = occluded;
+            if ( split )
+            {
+                octant -> mNextQueryFrame = mOcclusionFrame;
+            }
+            else if ( !occluded )
+            {
+                // randomised so the queries of coherent octants spread over frames
+                octant -> mNextQueryFrame = mOcclusionFrame + mOcclusionQueryInterval / 2 + 1 +
+                    static_cast < unsigned long > ( Math::UnitRandom() * mOcclusionQueryInterval );
+            }
+        }
 
-        full = ( isect == INSIDE );
+        mFreeQueries.push_back( it -> query );
+        it = mPendingQueries.erase( it );
     }
+}
 
+void OctreeSceneManager::_issueOcclusionQueries( void )
+{
+    size_t numBoxes = mVisibleQueryOctants.size() + mOccludedQueryOctants.size();
+    if ( numBoxes == 0 )
+        return;
 
-    Octree::NodeList::iterator it = octant -> mNodes.begin();
-
-    while ( it != octant -> mNodes.end() )
+    if ( numBoxes > mQueryBoxCapacity )
     {
-        OctreeNode * on = ( *it );
+        mQueryBoxCapacity = std::max( numBoxes, mQueryBoxCapacity * 2 );
 
-        if ( on != exclude )
+        if ( !mQueryVertexData )
         {
-            if ( full )
+            mQueryVertexData = OGRE_NEW VertexData();
+            mQueryVertexData -> vertexDeclaration -> addElement( 0, 0, VET_FLOAT3, VES_POSITION );
+            mQueryIndexData = OGRE_NEW IndexData();
+        }
+        mQueryVertexBuffer = HardwareBufferManager::getSingleton().createVertexBuffer(
+            3 * sizeof( float ), 8 * mQueryBoxCapacity, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE );
+        mQueryVertexData -> vertexBufferBinding -> setBinding( 0, mQueryVertexBuffer );
+
+        // corner i is at the maximum of x, y and z for bits 0, 1 and 2
+        static const uint32 boxIndexes[ 36 ] = {
+            0, 2, 6, 0, 6, 4,   1, 3, 7, 1, 7, 5,
+            0, 1, 5, 0, 5, 4,   2, 3, 7, 2, 7, 6,
+            0, 1, 3, 0, 3, 2,   4, 5, 7, 4, 7, 6 };
+        bool use32 = 8 * mQueryBoxCapacity > 0xFFFF;
+        mQueryIndexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+            use32 ? HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT,
+            36 * mQueryBoxCapacity, HardwareBuffer::HBU_STATIC_WRITE_ONLY );
+        void *indexes = mQueryIndexBuffer -> lock( HardwareBuffer::HBL_DISCARD );
+        for ( size_t b = 0; b < mQueryBoxCapacity; ++b )
+        {
+            for ( size_t i = 0; i < 36; ++i )
             {
-                list.push_back( on );
+                uint32 index = static_cast < uint32 > ( b * 8 ) + boxIndexes[ i ];
+                if ( use32 )
+                    static_cast < uint32 * > ( indexes )[ b * 36 + i ] = index;
+                else
+                    static_cast < uint16 * > ( indexes )[ b * 36 + i ] = static_cast < uint16 > ( index );
             }
+        }
+        mQueryIndexBuffer -> unlock();
+        mQueryIndexData -> indexBuffer = mQueryIndexBuffer;
+    }
 
-            else
-            {
-                Intersection nsect = intersect( t, on -> _getWorldAABB() );
-
-                if ( nsect != OUTSIDE )
-                {
-                    list.push_back( on );
-                }
-            }
+    // boxes of the visible octants first, then the hidden ones
+    float *pos = static_cast < float * > ( mQueryVertexBuffer -> lock(
+        0, 8 * numBoxes * mQueryVertexBuffer -> getVertexSize(), HardwareBuffer::HBL_DISCARD ) );
+    for ( size_t b = 0; b < numBoxes; ++b )
+    {
+        Octree *octant = b < mVisibleQueryOctants.size() ? mVisibleQueryOctants[ b ] :
+            mOccludedQueryOctants[ b - mVisibleQueryOctants.size() ];
+        AxisAlignedBox box;
+        octant -> _getCullBounds( &box );
+        Vector3 corners[ 2 ] = { box.getMinimum(), box.getMaximum() };
+        if ( mCameraRelativeRendering )
+        {
+            corners[ 0 ] -= mCameraRelativePosition;
+            corners[ 1 ] -= mCameraRelativePosition;
+        }
+        for ( int i = 0; i < 8; ++i )
+        {
+            *pos++ = static_cast < float > ( corners[ i & 1 ].x );
+            *pos++ = static_cast < float > ( corners[ ( i >> 1 ) & 1 ].y );
+            *pos++ = static_cast < float > ( corners[ ( i >> 2 ) & 1 ].z );
+        }
+    }
+    mQueryVertexBuffer -> unlock();
+    mQueryVertexData -> vertexStart = 0;
+    mQueryVertexData -> vertexCount = 8 * numBoxes;
 
+    if ( mQueryMaterial.isNull() )
+    {
+        static const String materialName = "OctreeSceneManager/OcclusionQuery";
+        mQueryMaterial = MaterialManager::getSingleton().getByName( materialName );
+        if ( mQueryMaterial.isNull() )
+        {
+            mQueryMaterial = MaterialManager::getSingleton().create( materialName,
+                ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME );
+            Pass *pass = mQueryMaterial -> getTechnique( 0 ) -> getPass( 0 );
+            pass -> setLightingEnabled( false );
+            pass -> setColourWriteEnabled( false );
+            pass -> setDepthWriteEnabled( false );
+            pass -> setCullingMode( CULL_NONE );
+            pass -> setManualCullingMode( MANUAL_CULL_NONE );
+            pass -> setFog( true );
         }
+        mQueryMaterial -> load();
+    }
+    Technique *tech = mQueryMaterial -> getBestTechnique();
+    if ( !tech )
+        return;
 
-        ++it;
+    mDestRenderSystem -> _setWorldMatrix( Matrix4::IDENTITY );
+    setViewMatrix( mCachedViewMatrix );
+    mDestRenderSystem -> _setProjectionMatrix( mCameraInProgress -> getProjectionMatrixRS() );
+    const Pass *pass = _setPass( tech -> getPass( 0 ) );
+    if ( pass -> isProgrammable() )
+    {
+        mAutoParamDataSource -> setCurrentRenderable( 0 );
+        mAutoParamDataSource -> setWorldMatrices( &Matrix4::IDENTITY, 1 );
+        updateGpuProgramParameters( pass );
     }
 
-    Octree* child;
+    RenderOperation op;
+    op.operationType = RenderOperation::OT_TRIANGLE_LIST;
+    op.vertexData = mQueryVertexData;
+    op.indexData = mQueryIndexData;
+    op.useIndexes = true;
 
-    if ( (child=octant -> mChildren[ 0 ][ 0 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+    size_t first = 0;
+    while ( first < numBoxes )
+    {
+        // visible octants are queried one by one, hidden ones in batches
+        size_t count = 1;
+        if ( first >= mVisibleQueryOctants.size() )
+            count = std::min( mOcclusionQueryBatchSize, numBoxes - first );
 
-    if ( (child=octant -> mChildren[ 1 ][ 0 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+        OcclusionQueryBatch batch;
+        if ( mFreeQueries.empty() )
+        {
+            batch.query = mDestRenderSystem -> createHardwareOcclusionQuery();
+            mAllQueries.push_back( batch.query );
+        }
+        else
+        {
+            batch.query = mFreeQueries.back();
+            mFreeQueries.pop_back();
+        }
+        batch.occluded = first >= mVisibleQueryOctants.size();
+        batch.frame = mOcclusionFrame;
+        for ( size_t b = first; b < first + count; ++b )
+        {
+            Octree *octant = batch.occluded ? mOccludedQueryOctants[ b - mVisibleQueryOctants.size() ] :
+                mVisibleQueryOctants[ b ];
+            octant -> mQueryPending = true;
+            batch.octants.push_back( octant );
+        }
 
-    if ( (child=octant -> mChildren[ 0 ][ 1 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+        mQueryIndexData -> indexStart = 36 * first;
+        mQueryIndexData -> indexCount = 36 * count;
+        batch.query -> beginOcclusionQuery();
+        mDestRenderSystem -> _render( op );
+        batch.query -> endOcclusionQuery();
+        mPendingQueries.push_back( batch );
 
-    if ( (child=octant -> mChildren[ 1 ][ 1 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+        first += count;
+    }
 
-    if ( (child=octant -> mChildren[ 0 ][ 0 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+    mVisibleQueryOctants.clear();
+    mOccludedQueryOctants.clear();
+}
 
-    if ( (child=octant -> mChildren[ 1 ][ 0 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+/** Clears the occlusion state of an octant and its children */
+static void resetOcclusionState( Octree *octant )
+{
+    octant -> mOccluded = false;
+    octant -> mQueryPending = false;
+    octant -> mLastVisitedFrame = 0;
+    octant -> mNextQueryFrame = 0;
 
-    if ( (child=octant -> mChildren[ 0 ][ 1 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+    for ( int i = 0; i < 8; ++i )
+    {
+        Octree *child = octant -> mChildren[ i & 1 ][ ( i >> 1 ) & 1 ][ ( i >> 2 ) & 1 ];
+        if ( child )
+            resetOcclusionState( child );
+    }
+}
 
-    if ( (child=octant -> mChildren[ 1 ][ 1 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+void OctreeSceneManager::_resetOcclusionQueries( void )
+{
+    // the results are of no use any more, but the queries must complete before reuse
+    for ( OcclusionQueryBatchList::iterator it = mPendingQueries.begin(); it != mPendingQueries.end(); ++it )
+    {
+        unsigned int pixels;
+        it -> query -> pullOcclusionQuery( &pixels );
+        mFreeQueries.push_back( it -> query );
+    }
+    mPendingQueries.clear();
+    mVisibleQueryOctants.clear();
+    mOccludedQueryOctants.clear();
 
+    if ( mOctree )
+        resetOcclusionState( mOctree );
 }
 
+void OctreeSceneManager::_destroyOcclusionQueries( void )
+{
+    _resetOcclusionQueries();
+
+    for ( OcclusionQueryList::iterator it = mAllQueries.begin(); it != mAllQueries.end(); ++it )
+        mDestRenderSystem -> destroyHardwareOcclusionQuery( *it );
+    mAllQueries.clear();
+    mFreeQueries.clear();
+
+    OGRE_DELETE mQueryVertexData;
+    mQueryVertexData = 0;
+    OGRE_DELETE mQueryIndexData;
+    mQueryIndexData = 0;
+    mQueryVertexBuffer.setNull();
+    mQueryIndexBuffer.setNull();
+    mQueryBoxCapacity = 0;
+    mQueryMaterial.setNull();
+}
 
-void _findNodes( const PlaneBoundedVolume &t, list< SceneNode * >::type &list, SceneNode *exclude, bool full, Octree *octant )
+/** Adds the nodes of an octant and, if recurse is set, of its children which
+    intersect the volume. Returns the number of intersection tests made.
+*/
+template <class T>
+int _findNodes( const T &t, list< SceneNode * >::type &list, SceneNode *exclude, bool full, Octree *octant,
+    bool recurse = true )
 {
+    int calls = 0;
 
     if ( !full )
     {
         AxisAlignedBox obox;
         octant -> _getCullBounds( &obox );
 
+        ++calls;
         Intersection isect = intersect( t, obox );
 
         if ( isect == OUTSIDE )
-            return ;
+            return calls;
 
         full = ( isect == INSIDE );
     }
 
 
-    Octree::NodeList::iterator it = octant -> mNodes.begin();
-
-    while ( it != octant -> mNodes.end() )
+    if ( full )
     {
-        OctreeNode * on = ( *it );
+        Octree::NodeList::iterator it = octant -> mNodes.begin();
 
-        if ( on != exclude )
+        while ( it != octant -> mNodes.end() )
         {
-            if ( full )
-            {
-                list.push_back( on );
-            }
-
-            else
-            {
-                Intersection nsect = intersect( t, on -> _getWorldAABB() );
+            OctreeNode * on = ( *it );
 
-                if ( nsect != OUTSIDE )
-                {
-                    list.push_back( on );
-                }
-            }
+            if ( on != exclude )
+                list.push_back( on );
 
+            ++it;
         }
-
-        ++it;
+    }
+    else
+    {
+        calls += _findOctantNodes( t, list, exclude, octant );
     }
 
+    if ( !recurse )
+        return calls;
+
     Octree* child;
 
     if ( (child=octant -> mChildren[ 0 ][ 0 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+        calls += _findNodes( t, list, exclude, full, child );
 
     if ( (child=octant -> mChildren[ 1 ][ 0 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+        calls += _findNodes( t, list, exclude, full, child );
 
     if ( (child=octant -> mChildren[ 0 ][ 1 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+        calls += _findNodes( t, list, exclude, full, child );
 
     if ( (child=octant -> mChildren[ 1 ][ 1 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+        calls += _findNodes( t, list, exclude, full, child );
 
     if ( (child=octant -> mChildren[ 0 ][ 0 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+        calls += _findNodes( t, list, exclude, full, child );
 
     if ( (child=octant -> mChildren[ 1 ][ 0 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+        calls += _findNodes( t, list, exclude, full, child );
 
     if ( (child=octant -> mChildren[ 0 ][ 1 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+        calls += _findNodes( t, list, exclude, full, child );
 
     if ( (child=octant -> mChildren[ 1 ][ 1 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+        calls += _findNodes( t, list, exclude, full, child );
 
+    return calls;
 }
 
-void _findNodes( const Ray &t, list< SceneNode * >::type &list, SceneNode *exclude, bool full, Octree *octant )
+/** Finds the nodes in the subtrees of a set of octants, each into its own list */
+template <class T>
+class FindNodesTask : public WorkQueue::ParallelTask
 {
-
-    if ( !full )
+public:
+    FindNodesTask( const T &t, SceneNode *exclude, bool full, const vector< Octree * >::type &octants )
+        : mVolume( t ), mExclude( exclude ), mFull( full ), mOctants( octants ),
+          mLists( octants.size() ), mCalls( octants.size(), 0 )
     {
-        AxisAlignedBox obox;
-        octant -> _getCullBounds( &obox );
-
-        Intersection isect = intersect( t, obox );
-
-        if ( isect == OUTSIDE )
-            return ;
-
-        full = ( isect == INSIDE );
     }
 
-
-    Octree::NodeList::iterator it = octant -> mNodes.begin();
-
-    while ( it != octant -> mNodes.end() )
+    void execute( size_t begin, size_t end )
     {
-        OctreeNode * on = ( *it );
-
-        if ( on != exclude )
-        {
-            if ( full )
-            {
-                list.push_back( on );
-            }
-
-            else
-            {
-                Intersection nsect = intersect( t, on -> _getWorldAABB() );
-
-                if ( nsect != OUTSIDE )
-                {
-                    list.push_back( on );
-                }
-            }
-
-        }
-
-        ++it;
+        for ( size_t i = begin; i < end; ++i )
+            mCalls[ i ] = _findNodes( mVolume, mLists[ i ], mExclude, mFull, mOctants[ i ] );
     }
 
-    Octree* child;
-
-    if ( (child=octant -> mChildren[ 0 ][ 0 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 1 ][ 0 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 0 ][ 1 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+    const T &mVolume;
+    SceneNode *mExclude;
+    bool mFull;
+    const vector< Octree * >::type &mOctants;
+    vector< list< SceneNode * >::type >::type mLists;
+    vector< int >::type mCalls;
+};
 
-    if ( (child=octant -> mChildren[ 1 ][ 1 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+/** Adds the nodes of the octree which intersect the volume, searching the
+    subtrees of the children of the root in parallel for large trees. The
+    nodes are found in the same order either way.
+*/
+template <class T>
+void _findNodesIn( const T &t, list< SceneNode * >::type &list, SceneNode *exclude, Octree *root,
+    size_t parallelThreshold )
+{
+    if ( static_cast < size_t > ( root -> numNodes() ) < parallelThreshold )
+    {
+        OctreeSceneManager::intersect_call += _findNodes( t, list, exclude, false, root );
+        return;
+    }
 
-    if ( (child=octant -> mChildren[ 0 ][ 0 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+    AxisAlignedBox obox;
+    root -> _getCullBounds( &obox );
+    ++OctreeSceneManager::intersect_call;
+    Intersection isect = intersect( t, obox );
+    if ( isect == OUTSIDE )
+        return;
 
-    if ( (child=octant -> mChildren[ 1 ][ 0 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+    bool full = ( isect == INSIDE );
+    OctreeSceneManager::intersect_call += _findNodes( t, list, exclude, full, root, false );
 
-    if ( (child=octant -> mChildren[ 0 ][ 1 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+    vector< Octree * >::type children;
+    for ( int i = 0; i < 8; ++i )
+    {
+        Octree *child = root -> mChildren[ i & 1 ][ ( i >> 1 ) & 1 ][ ( i >> 2 ) & 1 ];
+        if ( child && child -> numNodes() > 0 )
+            children.push_back( child );
+    }
 
-    if ( (child=octant -> mChildren[ 1 ][ 1 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+    FindNodesTask< T > task( t, exclude, full, children );
+    OptimisedUtil::getImplementation();
+    Root::getSingleton().getWorkQueue() -> parallelFor( children.size(), 1, &task );
 
+    for ( size_t i = 0; i < children.size(); ++i )
+    {
+        list.splice( list.end(), task.mLists[ i ] );
+        OctreeSceneManager::intersect_call += task.mCalls[ i ];
+    }
 }
 
 void OctreeSceneManager::findNodesIn( const AxisAlignedBox &box, list< SceneNode * >::type &list, SceneNode *exclude )
 {
-    _findNodes( box, list, exclude, false, mOctree );
+    _findNodesIn( box, list, exclude, mOctree, mParallelThreshold );
 }
 
 void OctreeSceneManager::findNodesIn( const Sphere &sphere, list< SceneNode * >::type &list, SceneNode *exclude )
 {
-    _findNodes( sphere, list, exclude, false, mOctree );
+    _findNodesIn( sphere, list, exclude, mOctree, mParallelThreshold );
 }
 
 void OctreeSceneManager::findNodesIn( const PlaneBoundedVolume &volume, list< SceneNode * >::type &list, SceneNode *exclude )
 {
-    _findNodes( volume, list, exclude, false, mOctree );
+    _findNodesIn( volume, list, exclude, mOctree, mParallelThreshold );
 }
 
 void OctreeSceneManager::findNodesIn( const Ray &r, list< SceneNode * >::type &list, SceneNode *exclude )
 {
-    _findNodes( r, list, exclude, false, mOctree );
+    _findNodesIn( r, list, exclude, mOctree, mParallelThreshold );
 }
 
 void OctreeSceneManager::resize( const AxisAlignedBox &box )
@@ -1009,14 +1495,10 @@ void OctreeSceneManager::resize( const AxisAlignedBox &box )
 
     _findNodes( mOctree->mBox, nodes, 0, true, mOctree );
 
-    OGRE_DELETE mOctree;
+    // queries in flight refer to the octants about to be reused
+    _resetOcclusionQueries();
 
-    mOctree = OGRE_NEW Octree( 0 );
-    mOctree->mBox = box;
-
-    const Vector3 &min = box.getMinimum();
-    const Vector3 &max = box.getMaximum();
-    mOctree->mHalfSize = ( max - min ) * 0.5f;
+    _resetOctree( box );
 
     it = nodes.begin();
 
@@ -1053,6 +1535,24 @@ bool OctreeSceneManager::setOption( const String & key, const void * val )
         return true;
     }
 
+    else if ( key == "OcclusionCamera" )
+    {
+        setOcclusionCamera( * static_cast < Camera * const * > ( val ) );
+        return true;
+    }
+
+    else if ( key == "Looseness" )
+    {
+        setLooseness( * static_cast < const Real * > ( val ) );
+        return true;
+    }
+
+    else if ( key == "ParallelThreshold" )
+    {
+        mParallelThreshold = * static_cast < const size_t * > ( val );
+        return true;
+    }
+
 
     return SceneManager::setOption( key, val );
 
@@ -1081,6 +1581,24 @@ bool OctreeSceneManager::getOption( const String & key, void *val )
         return true;
     }
 
+    else if ( key == "OcclusionCamera" )
+    {
+        * static_cast < Camera ** > ( val ) = mOcclusionCamera;
+        return true;
+    }
+
+    else if ( key == "Looseness" )
+    {
+        * static_cast < Real * > ( val ) = mLooseness;
+        return true;
+    }
+
+    else if ( key == "ParallelThreshold" )
+    {
+        * static_cast < size_t * > ( val ) = mParallelThreshold;
+        return true;
+    }
+
 
     return SceneManager::getOption( key, val );
 
@@ -1136,10 +1654,8 @@ IntersectionSceneQuery*
 OctreeSceneManager::createIntersectionQuery(uint32 mask)
 {
 
-    // Octree implementation performs WORSE for < 500 objects
-    // TODO: optimise it so it's better in all cases
-    //OctreeIntersectionSceneQuery* q = OGRE_NEW OctreeIntersectionSceneQuery(this);
-    DefaultIntersectionSceneQuery* q = OGRE_NEW DefaultIntersectionSceneQuery(this);
+    // Sweep and prune, rather than testing every pair like the default query
+    OctreeIntersectionSceneQuery* q = OGRE_NEW OctreeIntersectionSceneQuery(this);
     q->setQueryMask(mask);
     return q;
 }
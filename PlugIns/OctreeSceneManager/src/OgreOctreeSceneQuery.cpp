@@ -55,13 +55,55 @@ OctreeIntersectionSceneQuery::OctreeIntersectionSceneQuery(SceneManager* creator
 OctreeIntersectionSceneQuery::~OctreeIntersectionSceneQuery()
 {}
 //---------------------------------------------------------------------
-void OctreeIntersectionSceneQuery::execute(IntersectionSceneQueryListener* listener)
+namespace
 {
-    typedef std::pair<MovableObject *, MovableObject *> MovablePair;
-    typedef std::set
-        < std::pair<MovableObject *, MovableObject *> > MovableSet;
+    /// A queried object and the extent of its box along the sweep axis
+    struct SweepEntry
+    {
+        Real min, max;
+        MovableObject* object;
+
+        bool operator<( const SweepEntry& rhs ) const { return min < rhs.min; }
+    };
 
-    MovableSet set;
+    /// Report a pair, and the objects attached to entities of the pair
+    bool reportPair( IntersectionSceneQueryListener* listener, uint32 queryMask,
+        MovableObject* a, MovableObject* b )
+    {
+        if ( !listener -> queryResult( a, b ) )
+            return false;
+
+        // deal with attached objects, since they are not directly attached to nodes
+        MovableObject* pair[ 2 ] = { a, b };
+        for ( int i = 0; i < 2; ++i )
+        {
+            if ( pair[ i ] -> getMovableType() != "Entity" )
+                continue;
+
+            MovableObject* other = pair[ 1 - i ];
+            Entity* e = static_cast<Entity*>( pair[ i ] );
+            Entity::ChildObjectListIterator childIt = e->getAttachedObjectIterator();
+            while(childIt.hasMoreElements())
+            {
+                MovableObject* c = childIt.getNext();
+                if (c->getQueryFlags() & queryMask &&
+                    other->getWorldBoundingBox().intersects( c->getWorldBoundingBox() ))
+                {
+                    if ( !listener->queryResult(other, c) )
+                        return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+//---------------------------------------------------------------------
+void OctreeIntersectionSceneQuery::execute(IntersectionSceneQueryListener* listener)
+{
+    // Sweep and prune: the boxes are sorted by their minimum along x, and only
+    // the pairs which overlap along x are tested fully
+    vector<SweepEntry>::type entries;
+    vector<MovableObject*>::type infinite;
 
     // Iterate over all movable types
     Root::MovableObjectFactoryIterator factIt = 
@@ -73,52 +115,50 @@ void OctreeIntersectionSceneQuery::execute(IntersectionSceneQueryListener* liste
             factIt.getNext()->getType());
         while( it.hasMoreElements() )
         {
+            MovableObject * m = it.getNext();
+            if ( !(m->getQueryFlags() & mQueryMask) ||
+                !(m->getTypeFlags() & mQueryTypeMask) ||
+                !m->isInScene() )
+                continue;
 
-            MovableObject * e = it.getNext();
-
-            Ogre::list< SceneNode * >::type list;
-            //find the nodes that intersect the AAB
-            static_cast<OctreeSceneManager*>( mParentSceneMgr ) -> findNodesIn( e->getWorldBoundingBox(), list, 0 );
-            //grab all moveables from the node that intersect...
-            Ogre::list< SceneNode * >::type::iterator nit = list.begin();
-            while( nit != list.end() )
+            const AxisAlignedBox& box = m->getWorldBoundingBox();
+            if ( box.isInfinite() )
             {
-                SceneNode::ObjectIterator oit = (*nit) -> getAttachedObjectIterator();
-                while( oit.hasMoreElements() )
-                {
-                    MovableObject * m = oit.getNext();
-
-                    if( m != e &&
-                            set.find( MovablePair(e,m)) == set.end() &&
-                            set.find( MovablePair(m,e)) == set.end() &&
-                            (m->getQueryFlags() & mQueryMask) &&
-                            (m->getTypeFlags() & mQueryTypeMask) &&
-                            m->isInScene() && 
-                            e->getWorldBoundingBox().intersects( m->getWorldBoundingBox() ) )
-                    {
-                        listener -> queryResult( e, m );
-                        // deal with attached objects, since they are not directly attached to nodes
-                        if (m->getMovableType() == "Entity")
-                        {
-                            Entity* e2 = static_cast<Entity*>(m);
-                            Entity::ChildObjectListIterator childIt = e2->getAttachedObjectIterator();
-                            while(childIt.hasMoreElements())
-                            {
-                                MovableObject* c = childIt.getNext();
-                                if (c->getQueryFlags() & mQueryMask && 
-                                    e->getWorldBoundingBox().intersects( c->getWorldBoundingBox() ))
-                                {
-                                    listener->queryResult(e, c);
-                                }
-                            }
-                        }
-                    }
-                    set.insert( MovablePair(e,m) );
-
-                }
-                ++nit;
+                infinite.push_back( m );
             }
+            else if ( box.isFinite() )
+            {
+                SweepEntry entry = { box.getMinimum().x, box.getMaximum().x, m };
+                entries.push_back( entry );
+            }
+        }
+    }
+
+    std::sort( entries.begin(), entries.end() );
 
+    for ( size_t i = 0; i < entries.size(); ++i )
+    {
+        const AxisAlignedBox& box = entries[ i ].object->getWorldBoundingBox();
+        for ( size_t j = i + 1; j < entries.size() && entries[ j ].min <= entries[ i ].max; ++j )
+        {
+            if ( box.intersects( entries[ j ].object->getWorldBoundingBox() ) &&
+                !reportPair( listener, mQueryMask, entries[ i ].object, entries[ j ].object ) )
+                return;
+        }
+    }
+
+    // infinite boxes intersect everything
+    for ( size_t i = 0; i < infinite.size(); ++i )
+    {
+        for ( size_t j = i + 1; j < infinite.size(); ++j )
+        {
+            if ( !reportPair( listener, mQueryMask, infinite[ i ], infinite[ j ] ) )
+                return;
+        }
+        for ( size_t j = 0; j < entries.size(); ++j )
+        {
+            if ( !reportPair( listener, mQueryMask, infinite[ i ], entries[ j ].object ) )
+                return;
         }
     }
 }
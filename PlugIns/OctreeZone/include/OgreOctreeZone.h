@@ -125,6 +125,18 @@ namespace Ogre
                                       bool displayNodes,
                                       bool showBoundingBoxes);
 
+        /** Find and add the visible objects of this zone alone to the render queue */
+        virtual void findVisibleNodesInZone(PCZCamera *,
+                                            NodeList & visibleNodeList,
+                                            RenderQueue * queue,
+                                            VisibleObjectsBoundsInfo* visibleBounds,
+                                            bool onlyShadowCasters,
+                                            bool displayNodes,
+                                            bool showBoundingBoxes);
+
+        /** The portal traversal of octree zones can be cached */
+        virtual bool supportsVisibilityCache(void) const { return true; }
+
         /** Functions for finding Nodes that intersect various shapes */
         virtual void _findNodes(const AxisAlignedBox &t, 
                                 PCZSceneNodeList &list,
@@ -545,27 +545,17 @@ namespace Ogre
     }
 
     /*
-    // Recursively walk the zones, adding all visible SceneNodes to the list of visible nodes.
+    // Add the visible SceneNodes of this zone to the list of visible nodes, without
+    // going through portals.
     */
-    void OctreeZone::findVisibleNodes(PCZCamera *camera, 
+    void OctreeZone::findVisibleNodesInZone(PCZCamera *camera,
                                   NodeList & visibleNodeList,
                                   RenderQueue * queue,
-                                  VisibleObjectsBoundsInfo* visibleBounds, 
+                                  VisibleObjectsBoundsInfo* visibleBounds,
                                   bool onlyShadowCasters,
                                   bool displayNodes,
                                   bool showBoundingBoxes)
     {
-
-        //return immediately if nothing is in the zone.
-        if (mHomeNodeList.empty() &&
-            mVisitorNodeList.empty() &&
-            mPortals.empty())
-            return ;
-
-        // Else, the zone is automatically assumed to be visible since either
-        // it is the camera the zone is in, or it was reached because
-        // a connecting portal was deemed visible to the camera.  
-
         // enable sky if called to do so for this zone
         if (mHasSky)
         {
@@ -583,6 +573,41 @@ namespace Ogre
                    onlyShadowCasters,
                    displayNodes,
                    showBoundingBoxes);
+    }
+
+    /*
+    // Recursively walk the zones, adding all visible SceneNodes to the list of visible nodes.
+    */
+    void OctreeZone::findVisibleNodes(PCZCamera *camera, 
+                                  NodeList & visibleNodeList,
+                                  RenderQueue * queue,
+                                  VisibleObjectsBoundsInfo* visibleBounds, 
+                                  bool onlyShadowCasters,
+                                  bool displayNodes,
+                                  bool showBoundingBoxes)
+    {
+
+        // report the zone in case the portal traversal is being cached
+        mPCZSM->_notifyZoneVisible(this, camera);
+
+        //return immediately if nothing is in the zone.
+        if (mHomeNodeList.empty() &&
+            mVisitorNodeList.empty() &&
+            mPortals.empty())
+            return ;
+
+        // Else, the zone is automatically assumed to be visible since either
+        // it is the camera the zone is in, or it was reached because
+        // a connecting portal was deemed visible to the camera.  
+
+        // find visible nodes in the zone
+        findVisibleNodesInZone(camera,
+                               visibleNodeList,
+                               queue,
+                               visibleBounds,
+                               onlyShadowCasters,
+                               displayNodes,
+                               showBoundingBoxes);
 
         // Here we merge both portal and antiportal visible to the camera into one list.
         // Then we sort them in the order from nearest to furthest from camera.
@@ -105,6 +105,18 @@ namespace Ogre
                               bool displayNodes,
                               bool showBoundingBoxes);
 
+        /** Find and add the visible objects of this zone alone to the render queue */
+        void findVisibleNodesInZone(PCZCamera *,
+                                    NodeList & visibleNodeList,
+                                    RenderQueue * queue,
+                                    VisibleObjectsBoundsInfo* visibleBounds,
+                                    bool onlyShadowCasters,
+                                    bool displayNodes,
+                                    bool showBoundingBoxes);
+
+        /** The portal traversal of default zones can be cached */
+        bool supportsVisibilityCache(void) const { return true; }
+
         /* Functions for finding Nodes that intersect various shapes */
         void _findNodes( const AxisAlignedBox &t, 
                          PCZSceneNodeList &list, 
@@ -100,6 +100,12 @@ namespace Ogre
         void removePortalCullingPlanes(PortalBase* portal);
         /// Remove all extra culling planes
         void removeAllExtraCullingPlanes(void);
+        /// Get the extra culling planes currently in use
+        const PCPlaneList& getExtraCullingPlanes(void) const
+        { return mExtraCullingFrustum.getActiveCullingPlanes(); }
+        /// Add a copy of an extra culling plane (used to restore cached portal culling planes)
+        void addExtraCullingPlane(const PCPlane& plane)
+        { mExtraCullingFrustum.addCullingPlane(plane); }
     protected:
         AxisAlignedBox mBox;
         PCZFrustum mExtraCullingFrustum;
@@ -104,6 +104,10 @@ namespace Ogre
         void removePortalCullingPlanes(PortalBase* portal);
         /// Remove all  culling planes
         void removeAllCullingPlanes(void);
+        /// Get the culling planes currently in use
+        const PCPlaneList& getActiveCullingPlanes(void) const { return mActiveCullingPlanes; }
+        /// Add a copy of a culling plane, keeping the portal it was created from
+        void addCullingPlane(const PCPlane& plane);
         /// Set the origin value
         void setOrigin(const Vector3 & newOrigin) {mOrigin = newOrigin;}
         /// Set the origin plane
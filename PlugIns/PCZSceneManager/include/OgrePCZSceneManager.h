@@ -40,6 +40,7 @@ Code Style Update    :
 #include "OgrePCZPrerequisites.h"
 #include "OgreSceneManager.h"
 #include "OgrePCZone.h"
+#include "OgrePCPlane.h"
 
 namespace Ogre
 {
@@ -126,6 +127,12 @@ namespace Ogre
         /** Creates a specialized PCZCamera */
         virtual Camera * createCamera( const String &name );
 
+        using SceneManager::destroyCamera;
+        /** Overridden to drop the cached portal visibility of the camera */
+        virtual void destroyCamera(const String& name);
+        /** Overridden to drop the cached portal visibility of all cameras */
+        virtual void destroyAllCameras(void);
+
         /** Deletes a scene node by name & corresponding PCZSceneNode */
         virtual void destroySceneNode( const String &name );
 
@@ -297,11 +304,48 @@ namespace Ogre
             mShowPortals = b;
         };
 
+        /** Enable or disable caching of the portal traversal (default on).
+        @remarks
+            The zones reached through portals by a camera, with the culling planes
+            of the portals on the way, are remembered per camera. While the camera
+            stays in the same zone, its frustum is unchanged (see
+            setVisibilityCacheQuantisation) and no portal of the scene moves, is
+            enabled, disabled or reconnected, the zones are culled directly without
+            testing and clipping portals again. Objects inside the zones are still
+            culled every time. Only used when every zone type in the scene supports
+            it (see PCZone::supportsVisibilityCache).
+        */
+        void setVisibilityCacheEnabled(bool enabled);
+        /// Returns true if the portal traversal is cached
+        bool isVisibilityCacheEnabled(void) const { return mVisibilityCacheEnabled; }
+
+        /** Set how coarsely the camera frustum is compared when looking up the
+            cached portal traversal.
+        @remarks
+            By default (0, 0) the cache is only reused while the camera is exactly
+            static. With a position step in world units and an angle step in radians,
+            camera movements which stay in the same step are treated as static, so
+            the culling planes of portals can lag behind the camera by up to a step.
+        */
+        void setVisibilityCacheQuantisation(Real positionStep, Radian angleStep);
+        /// Get the position step used to compare cached camera frustums
+        Real getVisibilityCachePositionStep(void) const { return mVisibilityCachePositionStep; }
+        /// Get the angle step used to compare cached camera frustums
+        Radian getVisibilityCacheAngleStep(void) const { return mVisibilityCacheAngleStep; }
+
+        /// Forget the cached portal traversal of all cameras
+        void clearVisibilityCache(void);
+
+        /** Called by zones when findVisibleNodes reaches them, to record the
+            portal traversal of the camera. */
+        void _notifyZoneVisible(PCZone * zone, PCZCamera * camera);
+
         /** Sets the given option for the SceneManager
                 @remarks
             Options are:
             "ShowPortals", bool *;
             "ShowBoundingBoxes", bool *;
+            "VisibilityCache", bool *;
         */
         virtual bool setOption( const String &, const void * );
         /** Gets the given option for the Scene Manager.
@@ -367,6 +411,40 @@ namespace Ogre
         /// The zone of the active camera (for shadow texture casting use);
         PCZone* mActiveCameraZone;
 
+        /// A zone reached by a cached portal traversal
+        struct CachedZone
+        {
+            PCZone* zone;
+            /// Extra culling planes of the camera on reaching the zone
+            vector<PCPlane>::type planes;
+        };
+        typedef vector<CachedZone>::type CachedZoneList;
+
+        /// The portal traversal of a camera
+        struct VisibilityCache
+        {
+            /// Home zone of the camera
+            PCZone* homeZone;
+            /// Quantised camera position and frustum planes
+            vector<Real>::type key;
+            /// Zones reached, in traversal order
+            CachedZoneList zones;
+        };
+        typedef map<const Camera*, VisibilityCache>::type VisibilityCacheMap;
+
+        /// Cached portal traversal per camera
+        VisibilityCacheMap mVisibilityCache;
+        /// Traversal being recorded by _notifyZoneVisible, if any
+        CachedZoneList* mRecordedZones;
+        bool mVisibilityCacheEnabled;
+        Real mVisibilityCachePositionStep;
+        Radian mVisibilityCacheAngleStep;
+
+        /// Builds the key of the camera frustum to look up the cached portal traversal
+        void getVisibilityCacheKey(PCZCamera* cam, vector<Real>::type& key) const;
+        /// Returns true if every zone of the scene supports caching its portal traversal
+        bool isVisibilityCacheSupported(void) const;
+
         /** Internal method for locating a list of lights which could be affecting the frustum. 
         @remarks
             Custom scene managers are encouraged to override this method to make use of their
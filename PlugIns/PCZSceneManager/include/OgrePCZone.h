@@ -200,6 +200,26 @@ namespace Ogre
                                       bool displayNodes,
                                       bool showBoundingBoxes) = 0;
 
+        /** Find and add the visible objects of this zone alone to the render queue,
+            without going through its portals.
+        @remarks
+        Used by PCZSceneManager to replay a cached portal traversal, with the extra
+        culling planes of the camera already set up for the zone. Zone types which
+        implement this must return true from supportsVisibilityCache, and report
+        the zone to PCZSceneManager::_notifyZoneVisible at the start of findVisibleNodes.
+        */
+        virtual void findVisibleNodesInZone(PCZCamera *,
+                                            NodeList & visibleNodeList,
+                                            RenderQueue * queue,
+                                            VisibleObjectsBoundsInfo* visibleBounds,
+                                            bool onlyShadowCasters,
+                                            bool displayNodes,
+                                            bool showBoundingBoxes) {}
+
+        /** Returns true if the portal traversal of this zone type can be cached
+            (see findVisibleNodesInZone) */
+        virtual bool supportsVisibilityCache(void) const { return false; }
+
         /* Functions for finding Nodes that intersect various shapes */
         virtual void _findNodes( const AxisAlignedBox &t, 
                                  PCZSceneNodeList &list, 
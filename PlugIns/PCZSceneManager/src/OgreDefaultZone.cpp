@@ -501,6 +501,9 @@ namespace Ogre
                                   bool showBoundingBoxes)
     {
 
+        // report the zone in case the portal traversal is being cached
+        mPCZSM->_notifyZoneVisible(this, camera);
+
         //return immediately if nothing is in the zone.
         if (mHomeNodeList.empty() &&
             mVisitorNodeList.empty() &&
@@ -511,82 +514,14 @@ namespace Ogre
         // it is the camera the zone is in, or it was reached because
         // a connecting portal was deemed visible to the camera.  
 
-        // enable sky if called to do so for this zone
-        if (mHasSky)
-        {
-            // enable sky 
-            mPCZSM->enableSky(true);
-        }
-
-        // find visible nodes at home in the zone
-        bool vis;
-        PCZSceneNodeList::iterator it = mHomeNodeList.begin();
-        while ( it != mHomeNodeList.end() )
-        {
-            PCZSceneNode * pczsn = *it;
-            // if the scene node is already visible, then we can skip it
-            if (pczsn->getLastVisibleFrame() != mLastVisibleFrame ||
-                pczsn->getLastVisibleFromCamera() != camera)
-            {
-                // for a scene node, check visibility using AABB
-                vis = camera ->isVisible( pczsn -> _getWorldAABB() );
-                if ( vis )
-                {
-                    // add it to the list of visible nodes
-                    visibleNodeList.push_back( pczsn );
-                    // add the node to the render queue
-                    pczsn -> _addToRenderQueue(camera, queue, onlyShadowCasters, visibleBounds );
-                    // if we are displaying nodes, add the node renderable to the queue
-                    if ( displayNodes )
-                    {
-                        queue -> addRenderable( pczsn->getDebugRenderable() );
-                    }
-                    // if the scene manager or the node wants the bounding box shown, add it to the queue
-                    if (pczsn->getShowBoundingBox() || showBoundingBoxes)
-                    {
-                        pczsn->_addBoundingBoxToQueue(queue);
-                    }
-                    // flag the node as being visible this frame
-                    pczsn->setLastVisibleFrame(mLastVisibleFrame);
-                    pczsn->setLastVisibleFromCamera(camera);
-                }
-            }
-            ++it;
-        }
-        // find visible visitor nodes
-        it = mVisitorNodeList.begin();
-        while ( it != mVisitorNodeList.end() )
-        {
-            PCZSceneNode * pczsn = *it;
-            // if the scene node is already visible, then we can skip it
-            if (pczsn->getLastVisibleFrame() != mLastVisibleFrame ||
-                pczsn->getLastVisibleFromCamera() != camera)
-            {
-                // for a scene node, check visibility using AABB
-                vis = camera ->isVisible( pczsn -> _getWorldAABB() );
-                if ( vis )
-                {
-                    // add it to the list of visible nodes
-                    visibleNodeList.push_back( pczsn );
-                    // add the node to the render queue
-                    pczsn->_addToRenderQueue(camera, queue, onlyShadowCasters, visibleBounds );
-                    // if we are displaying nodes, add the node renderable to the queue
-                    if ( displayNodes )
-                    {
-                        queue -> addRenderable( pczsn->getDebugRenderable() );
-                    }
-                    // if the scene manager or the node wants the bounding box shown, add it to the queue
-                    if (pczsn->getShowBoundingBox() || showBoundingBoxes)
-                    {
-                        pczsn->_addBoundingBoxToQueue(queue);
-                    }
-                    // flag the node as being visible this frame
-                    pczsn->setLastVisibleFrame(mLastVisibleFrame);
-                    pczsn->setLastVisibleFromCamera(camera);
-                }
-            }
-            ++it;
-        }
+        // find visible nodes at home and visiting in the zone
+        findVisibleNodesInZone(camera,
+                               visibleNodeList,
+                               queue,
+                               visibleBounds,
+                               onlyShadowCasters,
+                               displayNodes,
+                               showBoundingBoxes);
 
         // Here we merge both portal and antiportal visible to the camera into one list.
         // Then we sort them in the order from nearest to furthest from camera.
@@ -674,6 +609,96 @@ namespace Ogre
         }
     }
 
+    /*
+    // Add the visible SceneNodes of this zone to the list of visible nodes, without
+    // going through portals.
+    */
+    void DefaultZone::findVisibleNodesInZone(PCZCamera *camera,
+                                  NodeList & visibleNodeList,
+                                  RenderQueue * queue,
+                                  VisibleObjectsBoundsInfo* visibleBounds,
+                                  bool onlyShadowCasters,
+                                  bool displayNodes,
+                                  bool showBoundingBoxes)
+    {
+        // enable sky if called to do so for this zone
+        if (mHasSky)
+        {
+            // enable sky 
+            mPCZSM->enableSky(true);
+        }
+
+        // find visible nodes at home in the zone
+        bool vis;
+        PCZSceneNodeList::iterator it = mHomeNodeList.begin();
+        while ( it != mHomeNodeList.end() )
+        {
+            PCZSceneNode * pczsn = *it;
+            // if the scene node is already visible, then we can skip it
+            if (pczsn->getLastVisibleFrame() != mLastVisibleFrame ||
+                pczsn->getLastVisibleFromCamera() != camera)
+            {
+                // for a scene node, check visibility using AABB
+                vis = camera ->isVisible( pczsn -> _getWorldAABB() );
+                if ( vis )
+                {
+                    // add it to the list of visible nodes
+                    visibleNodeList.push_back( pczsn );
+                    // add the node to the render queue
+                    pczsn -> _addToRenderQueue(camera, queue, onlyShadowCasters, visibleBounds );
+                    // if we are displaying nodes, add the node renderable to the queue
+                    if ( displayNodes )
+                    {
+                        queue -> addRenderable( pczsn->getDebugRenderable() );
+                    }
+                    // if the scene manager or the node wants the bounding box shown, add it to the queue
+                    if (pczsn->getShowBoundingBox() || showBoundingBoxes)
+                    {
+                        pczsn->_addBoundingBoxToQueue(queue);
+                    }
+                    // flag the node as being visible this frame
+                    pczsn->setLastVisibleFrame(mLastVisibleFrame);
+                    pczsn->setLastVisibleFromCamera(camera);
+                }
+            }
+            ++it;
+        }
+        // find visible visitor nodes
+        it = mVisitorNodeList.begin();
+        while ( it != mVisitorNodeList.end() )
+        {
+            PCZSceneNode * pczsn = *it;
+            // if the scene node is already visible, then we can skip it
+            if (pczsn->getLastVisibleFrame() != mLastVisibleFrame ||
+                pczsn->getLastVisibleFromCamera() != camera)
+            {
+                // for a scene node, check visibility using AABB
+                vis = camera ->isVisible( pczsn -> _getWorldAABB() );
+                if ( vis )
+                {
+                    // add it to the list of visible nodes
+                    visibleNodeList.push_back( pczsn );
+                    // add the node to the render queue
+                    pczsn->_addToRenderQueue(camera, queue, onlyShadowCasters, visibleBounds );
+                    // if we are displaying nodes, add the node renderable to the queue
+                    if ( displayNodes )
+                    {
+                        queue -> addRenderable( pczsn->getDebugRenderable() );
+                    }
+                    // if the scene manager or the node wants the bounding box shown, add it to the queue
+                    if (pczsn->getShowBoundingBox() || showBoundingBoxes)
+                    {
+                        pczsn->_addBoundingBoxToQueue(queue);
+                    }
+                    // flag the node as being visible this frame
+                    pczsn->setLastVisibleFrame(mLastVisibleFrame);
+                    pczsn->setLastVisibleFromCamera(camera);
+                }
+            }
+            ++it;
+        }
+    }
+
     // --- find nodes which intersect various types of BV's ---
     void DefaultZone::_findNodes( const AxisAlignedBox &t, 
                                   PCZSceneNodeList &list, 
@@ -509,35 +509,36 @@ namespace Ogre
         // For portal Quads: Up to 4 planes can be added by the sides of a portal quad.
         // Each plane is created from 2 corners (world space) of the portal and the
         // frustum origin (world space).
+        // First find the edges which have both corners outside of one of the
+        // existing planes. Each corner is classified once per plane, and bit i
+        // of culledEdges is set when the edge from corner i to corner i+1 is culled.
+        // (planes added below for this portal never cull its other edges, since
+        // the portal is convex)
         int i,j;
-        Plane::Side pt0_side, pt1_side;
-        bool visible;
-        PCPlaneList::iterator pit;
+        unsigned int culledEdges = 0;
+        PCPlaneList::iterator pit = mActiveCullingPlanes.begin();
+        while ( pit != mActiveCullingPlanes.end() && culledEdges != 0xF )
+        {
+            PCPlane * plane = *pit;
+            unsigned int outside = 0;
+            for (i=0;i<4;i++)
+            {
+                if (plane->getSide(portal->getDerivedCorner(i)) == Plane::NEGATIVE_SIDE)
+                {
+                    outside |= 1 << i;
+                }
+            }
+            culledEdges |= outside & ((outside >> 1) | ((outside & 1) << 3));
+            pit++;
+        }
         for (i=0;i<4;i++)
         {
-            // first check if both corners are outside of one of the existing planes
             j = i+1;
             if (j > 3)
             {
                 j = 0;
             }
-            visible = true;
-            pit = mActiveCullingPlanes.begin();
-            while ( pit != mActiveCullingPlanes.end() )
-            {
-                PCPlane * plane = *pit;
-                pt0_side = plane->getSide(portal->getDerivedCorner(i));
-                pt1_side = plane->getSide(portal->getDerivedCorner(j));
-                if (pt0_side == Plane::NEGATIVE_SIDE &&
-                    pt1_side == Plane::NEGATIVE_SIDE)
-                {
-                    // the portal edge was actually completely culled by one of  culling planes
-                    visible = false;
-                    break;
-                }
-                pit++;
-            }
-            if (visible)
+            if ((culledEdges & (1 << i)) == 0)
             {
                 // add the plane created from the two portal corner points and the frustum location
                 // to the  culling plane
@@ -603,6 +604,14 @@ namespace Ogre
         return addedcullingplanes;
     }
 
+    // add a copy of a culling plane (used to restore cached portal culling planes)
+    void PCZFrustum::addCullingPlane(const PCPlane& plane)
+    {
+        PCPlane * newPlane = getUnusedCullingPlane();
+        *newPlane = plane;
+        mActiveCullingPlanes.push_back(newPlane);
+    }
+
     // remove culling planes created from the given portal
     void PCZFrustum::removePortalCullingPlanes(PortalBase* portal)
     {
@@ -54,7 +54,10 @@ namespace Ogre
     mDefaultZone(0),
     mShowPortals(false),
     mZoneFactoryManager(0),
-    mActiveCameraZone(0)
+    mActiveCameraZone(0),
+    mRecordedZones(0),
+    mVisibilityCacheEnabled(true),
+    mVisibilityCachePositionStep(0)
     { }
 
     PCZSceneManager::~PCZSceneManager()
@@ -108,6 +111,7 @@ namespace Ogre
             OGRE_DELETE j->second;
         }
         mZones.clear();
+        clearVisibilityCache();
 
         mFrameCount = 0;
 
@@ -280,6 +284,7 @@ namespace Ogre
         newZone = mZoneFactoryManager->createPCZone(this, zoneTypeName, zoneName);
         // add to the global list of zones
         mZones[newZone->getName()] = newZone;
+        clearVisibilityCache();
         if (filename != "none")
         {
             // set the zone geometry
@@ -387,6 +392,22 @@ namespace Ogre
         return c;
     }
 
+    void PCZSceneManager::destroyCamera(const String& name)
+    {
+        CameraList::iterator i = mCameras.find(name);
+        if (i != mCameras.end())
+        {
+            mVisibilityCache.erase(i->second);
+        }
+        SceneManager::destroyCamera(name);
+    }
+
+    void PCZSceneManager::destroyAllCameras(void)
+    {
+        mVisibilityCache.clear();
+        SceneManager::destroyAllCameras();
+    }
+
     // Destroy a Scene Node by name.
     void PCZSceneManager::destroySceneNode( const String &name )
     {
@@ -552,6 +573,15 @@ namespace Ogre
         _updatePCZSceneNodes();
         // calculate zones affected by each light
         _calcZonesAffectedByLights(cam);
+        // forget cached portal traversals if any portal changed
+        for (ZoneMap::iterator i = mZones.begin(); i != mZones.end(); ++i)
+        {
+            if (i->second->getPortalsUpdated())
+            {
+                clearVisibilityCache();
+                break;
+            }
+        }
         // clear update flags at end so user triggered updated are 
         // not cleared prematurely 
         _clearAllZonesPortalUpdateFlag(); 
@@ -723,6 +753,7 @@ namespace Ogre
             {
                 createZoneSpecificNodeData(newZone);
             }
+            clearVisibilityCache();
         }
         return newZone;
     }
@@ -781,6 +812,7 @@ namespace Ogre
         {
             mZones.erase(zone->getName());
         }
+        clearVisibilityCache();
         OGRE_DELETE zone;
     }
 
@@ -1218,25 +1250,152 @@ namespace Ogre
         // turn off sky 
         enableSky(false);
 
+        PCZCamera* pczCam = (PCZCamera*)cam;
+
         // remove all extra culling planes
-        ((PCZCamera*)cam)->removeAllExtraCullingPlanes();
+        pczCam->removeAllExtraCullingPlanes();
 
         // update the camera
-        ((PCZCamera*)cam)->update();
+        pczCam->update();
 
         // get the home zone of the camera
         PCZone* cameraHomeZone = ((PCZSceneNode*)(cam->getParentSceneNode()))->getHomeZone();
-
-        // walk the zones, starting from the camera home zone,
-        // adding all visible scene nodes to the mVisibles list
         cameraHomeZone->setLastVisibleFrame(mFrameCount);
-        cameraHomeZone->findVisibleNodes((PCZCamera*)cam, 
-                                          mVisible, 
-                                          getRenderQueue(),
-                                          visibleBounds, 
-                                          onlyShadowCasters,
-                                          mDisplayNodes,
-                                          mShowBoundingBoxes);
+
+        if (!mVisibilityCacheEnabled || !isVisibilityCacheSupported())
+        {
+            // walk the zones, starting from the camera home zone,
+            // adding all visible scene nodes to the mVisibles list
+            cameraHomeZone->findVisibleNodes(pczCam,
+                                             mVisible,
+                                             getRenderQueue(),
+                                             visibleBounds,
+                                             onlyShadowCasters,
+                                             mDisplayNodes,
+                                             mShowBoundingBoxes);
+            return;
+        }
+
+        vector<Real>::type key;
+        getVisibilityCacheKey(pczCam, key);
+        VisibilityCacheMap::iterator ci = mVisibilityCache.find(cam);
+        if (ci != mVisibilityCache.end() &&
+            ci->second.homeZone == cameraHomeZone && ci->second.key == key)
+        {
+            // the camera and portals are static, so visit the same zones through
+            // the same culling planes without testing any portal
+            CachedZoneList& zones = ci->second.zones;
+            for (size_t i = 0; i < zones.size(); ++i)
+            {
+                CachedZone& cached = zones[i];
+                pczCam->removeAllExtraCullingPlanes();
+                for (size_t p = 0; p < cached.planes.size(); ++p)
+                {
+                    pczCam->addExtraCullingPlane(cached.planes[p]);
+                }
+                if (cached.zone != cameraHomeZone)
+                {
+                    // tell target zone it's visible this frame
+                    cached.zone->setLastVisibleFrame(mFrameCount);
+                    cached.zone->setLastVisibleFromCamera(pczCam);
+                }
+                cached.zone->findVisibleNodesInZone(pczCam,
+                                                    mVisible,
+                                                    getRenderQueue(),
+                                                    visibleBounds,
+                                                    onlyShadowCasters,
+                                                    mDisplayNodes,
+                                                    mShowBoundingBoxes);
+            }
+            pczCam->removeAllExtraCullingPlanes();
+            return;
+        }
+
+        // walk the zones, recording the traversal for the next frames
+        VisibilityCache& cache = mVisibilityCache[cam];
+        cache.homeZone = cameraHomeZone;
+        cache.key.swap(key);
+        cache.zones.clear();
+        mRecordedZones = &cache.zones;
+        cameraHomeZone->findVisibleNodes(pczCam,
+                                         mVisible,
+                                         getRenderQueue(),
+                                         visibleBounds,
+                                         onlyShadowCasters,
+                                         mDisplayNodes,
+                                         mShowBoundingBoxes);
+        mRecordedZones = 0;
+    }
+
+    void PCZSceneManager::_notifyZoneVisible(PCZone * zone, PCZCamera * camera)
+    {
+        if (!mRecordedZones)
+            return;
+
+        mRecordedZones->push_back(CachedZone());
+        CachedZone& cached = mRecordedZones->back();
+        cached.zone = zone;
+        const PCPlaneList& planes = camera->getExtraCullingPlanes();
+        cached.planes.reserve(planes.size());
+        for (PCPlaneList::const_iterator i = planes.begin(); i != planes.end(); ++i)
+        {
+            cached.planes.push_back(**i);
+        }
+    }
+
+    void PCZSceneManager::getVisibilityCacheKey(PCZCamera* cam, vector<Real>::type& key) const
+    {
+        // the frustum planes include the projection, orientation and any reflection
+        // of the camera, and the position is the origin of the portal culling planes
+        Real posStep = mVisibilityCachePositionStep;
+        Real angleStep = mVisibilityCacheAngleStep.valueRadians();
+        key.reserve(27);
+        const Vector3& pos = cam->getDerivedPosition();
+        for (int i = 0; i < 3; ++i)
+        {
+            key.push_back(posStep > 0 ? Math::Floor(pos[i] / posStep) : pos[i]);
+        }
+        const Plane* planes = cam->getFrustumPlanes();
+        for (int p = 0; p < 6; ++p)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                key.push_back(angleStep > 0 ?
+                    Math::Floor(planes[p].normal[i] / angleStep) : planes[p].normal[i]);
+            }
+            key.push_back(posStep > 0 ? Math::Floor(planes[p].d / posStep) : planes[p].d);
+        }
+    }
+
+    bool PCZSceneManager::isVisibilityCacheSupported(void) const
+    {
+        for (ZoneMap::const_iterator i = mZones.begin(); i != mZones.end(); ++i)
+        {
+            if (!i->second->supportsVisibilityCache())
+                return false;
+        }
+        return true;
+    }
+
+    void PCZSceneManager::setVisibilityCacheEnabled(bool enabled)
+    {
+        mVisibilityCacheEnabled = enabled;
+        if (!enabled)
+        {
+            clearVisibilityCache();
+        }
+    }
+
+    void PCZSceneManager::setVisibilityCacheQuantisation(Real positionStep, Radian angleStep)
+    {
+        mVisibilityCachePositionStep = positionStep;
+        mVisibilityCacheAngleStep = angleStep;
+        clearVisibilityCache();
+    }
+
+    void PCZSceneManager::clearVisibilityCache(void)
+    {
+        mVisibilityCache.clear();
     }
 
     void PCZSceneManager::findNodesIn( const AxisAlignedBox &box, 
@@ -1346,6 +1505,7 @@ namespace Ogre
         SceneManager::getOptionKeys( refKeys );
         refKeys.push_back( "ShowBoundingBoxes" );
         refKeys.push_back( "ShowPortals" );
+        refKeys.push_back( "VisibilityCache" );
 
         return true;
     }
@@ -1363,6 +1523,12 @@ namespace Ogre
             mShowPortals = * static_cast < const bool * > ( val );
             return true;
         }
+
+        else if ( key == "VisibilityCache" )
+        {
+            setVisibilityCacheEnabled( * static_cast < const bool * > ( val ) );
+            return true;
+        }
         // send option to each zone
         ZoneMap::iterator i;
         PCZone * zone;
@@ -1395,6 +1561,12 @@ namespace Ogre
             * static_cast < bool * > ( val ) = mShowPortals;
             return true;
         }
+        if ( key == "VisibilityCache" )
+        {
+
+            * static_cast < bool * > ( val ) = mVisibilityCacheEnabled;
+            return true;
+        }
         return SceneManager::getOption( key, val );
 
     }
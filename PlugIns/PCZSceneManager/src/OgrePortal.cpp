@@ -34,6 +34,7 @@ current TODO's       : none known
 */
 
 #include "OgrePortal.h"
+#include "OgrePCZone.h"
 
 using namespace Ogre;
 
@@ -51,6 +52,11 @@ Portal::~Portal()
 // Set the 1st Zone the Portal connects to
 void Portal::setTargetZone(PCZone* zone)
 {
+    if (mTargetZone != zone && mCurrentHomeZone)
+    {
+        // inform home zone that a portal has been updated
+        mCurrentHomeZone->setPortalsUpdated(true);
+    }
     mTargetZone = zone;
 }
 
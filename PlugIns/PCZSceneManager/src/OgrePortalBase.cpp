@@ -378,6 +378,17 @@ void PortalBase::updateDerivedValues(void) const
     mDerivedUpToDate = true;
 }
 
+// enable or disable the portal
+void PortalBase::setEnabled(bool value)
+{
+    if (mEnabled != value && mCurrentHomeZone)
+    {
+        // inform home zone that a portal has been updated
+        mCurrentHomeZone->setPortalsUpdated(true);
+    }
+    mEnabled = value;
+}
+
 // Adjust the portal so that it is centered and oriented on the given node
 // NOTE: This function will move/rotate the node as well!
 // NOTE: The node will become the portal's "associated" node (mParentNode).
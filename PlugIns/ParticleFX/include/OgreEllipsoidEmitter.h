@@ -56,6 +56,8 @@ namespace Ogre {
 
         /** See ParticleEmitter. */
         void _initParticle(Particle* pParticle);
+        /** See ParticleEmitter. */
+        void _initParticles(Particle** particles, size_t count);
     };
     /** @} */
     /** @} */
@@ -0,0 +1,190 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __GpuParticleRenderer_H__
+#define __GpuParticleRenderer_H__
+
+#include "OgreParticleFXPrerequisites.h"
+#include "OgreParticleSystemRenderer.h"
+#include "OgreRenderable.h"
+#include "OgreMaterial.h"
+#include "OgreHardwareIndexBuffer.h"
+
+namespace Ogre {
+    /** \addtogroup Plugins
+    *  @{
+    */
+    /** \addtogroup ParticleFX
+    *  @{
+    */
+
+    /** Particle system renderer which simulates the particles on the GPU.
+    @remarks
+        A particle script opts in with <tt>renderer gpu</tt>. The system then keeps
+        no particles on the CPU: each particle slot is a camera facing quad in a
+        static vertex buffer, and the vertex program works out the whole life of
+        the particle in the slot from the slot index and the system time. The
+        standard emitters and affectors are translated into program parameters,
+        which makes the cost of a system independent of its particle count apart
+        from the vertex work, so the quota can run into the millions.
+    @par
+        Slot i of an emitter is reborn every quota / rate seconds, with random
+        values hashed from the slot and the number of rebirths, and its
+        position, colour, size and rotation follow from the closed form of the
+        affectors. The Point, Box, Ellipsoid, Cylinder, Ring and HollowEllipsoid
+        emitters are supported, without emitter durations, repeat delays or
+        emitted emitters, and so are the LinearForce (add), ColourFader, Scaler
+        and Rotator affectors; any other affector is ignored with a warning.
+        Particles always move with the node of the system, as if kept in local
+        space, and are never sorted. The bounds are estimated from the emitters
+        and affectors.
+    @par
+        Each pass of the material of the system gets a vertex and fragment
+        program, which modulate the first texture unit of the pass with the
+        particle colour. GLSL 1.50 or Shader Model 4 HLSL is required, see
+        isSupported().
+    */
+    class _OgreParticleFXExport GpuParticleRenderer : public ParticleSystemRenderer
+    {
+    public:
+        GpuParticleRenderer();
+        ~GpuParticleRenderer();
+
+        /** Whether the current render system can run GPU particle systems. */
+        static bool isSupported(void);
+
+        /// @copydoc ParticleSystemRenderer::getType
+        const String& getType(void) const;
+        /// @copydoc ParticleSystemRenderer::_updateRenderQueue
+        void _updateRenderQueue(RenderQueue* queue, 
+            vector<Particle*>::type& currentParticles, bool cullIndividually);
+        /// @copydoc ParticleSystemRenderer::visitRenderables
+        void visitRenderables(Renderable::Visitor* visitor, 
+            bool debugRenderables = false);
+        /// @copydoc ParticleSystemRenderer::_setMaterial
+        void _setMaterial(MaterialPtr& mat);
+        /// @copydoc ParticleSystemRenderer::_notifyCurrentCamera
+        void _notifyCurrentCamera(Camera* cam) {}
+        /// @copydoc ParticleSystemRenderer::_notifyAttached
+        void _notifyAttached(Node* parent, bool isTagPoint = false);
+        /// @copydoc ParticleSystemRenderer::_notifyParticleQuota
+        void _notifyParticleQuota(size_t quota) {}
+        /// @copydoc ParticleSystemRenderer::_notifyDefaultDimensions
+        void _notifyDefaultDimensions(Real width, Real height) {}
+        /// @copydoc ParticleSystemRenderer::setRenderQueueGroup
+        void setRenderQueueGroup(uint8 queueID);
+        /// @copydoc ParticleSystemRenderer::setRenderQueueGroupAndPriority
+        void setRenderQueueGroupAndPriority(uint8 queueID, ushort priority);
+        /// @copydoc ParticleSystemRenderer::setKeepParticlesInLocalSpace
+        void setKeepParticlesInLocalSpace(bool keepLocal) {}
+        /// @copydoc ParticleSystemRenderer::_getSortMode
+        SortMode _getSortMode(void) const { return SM_DISTANCE; }
+        /// @copydoc ParticleSystemRenderer::_simulatesParticles
+        bool _simulatesParticles(void) const { return true; }
+        /// @copydoc ParticleSystemRenderer::_simulateParticles
+        void _simulateParticles(ParticleSystem* sys, Real timeElapsed);
+
+        /// Get the number of particle slots rendered, over all emitters
+        size_t getSlotCount(void) const { return mSlotCount; }
+
+    protected:
+        /// Number of float4 program parameters describing one emitter
+        static const size_t PARAM_COUNT = 15;
+
+        /// Simulation parameters of one emitter, written by _simulateParticles
+        struct EmitterParams
+        {
+            Vector4 values[PARAM_COUNT];
+            size_t slots;
+        };
+        typedef vector<EmitterParams>::type EmitterParamsList;
+
+        /// The slots of one emitter, drawn in one call
+        class _OgreParticleFXExport Batch : public Renderable, public FXAlloc
+        {
+        public:
+            Batch(GpuParticleRenderer* parent);
+            ~Batch();
+
+            const MaterialPtr& getMaterial(void) const { return mParent->mMaterial; }
+            void getRenderOperation(RenderOperation& op);
+            void getWorldTransforms(Matrix4* xform) const;
+            Real getSquaredViewDepth(const Camera* cam) const;
+            const LightList& getLights(void) const { return mParent->mLights; }
+            bool getCastsShadows(void) const { return false; }
+
+            GpuParticleRenderer* mParent;
+            /// Indexes of the slots of this batch in the shared index buffer
+            IndexData* mIndexData;
+        };
+        typedef vector<Batch*>::type BatchList;
+
+        /// Emitter parameters, copied to the batches on the render thread
+        EmitterParamsList mEmitterParams;
+        BatchList mBatches;
+        /// Slots allocated in mVertexData and mIndexData
+        size_t mSlotCount;
+        VertexData* mVertexData;
+        HardwareIndexBufferSharedPtr mIndexBuffer;
+        /// Material of the system, with the simulation programs
+        MaterialPtr mMaterial;
+        Node* mParentNode;
+        LightList mLights;
+        uint8 mQueueID;
+        ushort mQueuePriority;
+        bool mQueueSet;
+        /// Time since the system started, and since it last started and stopped emitting
+        Real mTime;
+        Real mStartTime;
+        Real mStopTime;
+        bool mEmitting;
+        bool mSupported;
+
+        /// Number of affectors of the system last checked for support
+        size_t mCheckedAffectors;
+
+        /// (Re)build the slot geometry for a number of slots
+        void createGeometry(size_t slots);
+        void destroyGeometry(void);
+    };
+
+    /** Factory class for GpuParticleRenderer */
+    class _OgreParticleFXExport GpuParticleRendererFactory : public ParticleSystemRendererFactory
+    {
+    public:
+        /// @copydoc FactoryObj::getType
+        const String& getType() const;
+        /// @copydoc FactoryObj::createInstance
+        ParticleSystemRenderer* createInstance( const String& name );
+        /// @copydoc FactoryObj::destroyInstance
+        void destroyInstance(ParticleSystemRenderer* ptr);
+    };
+    /** @} */
+    /** @} */
+}
+
+#endif
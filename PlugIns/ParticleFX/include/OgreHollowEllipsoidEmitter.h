@@ -77,6 +77,7 @@ namespace Ogre {
         HollowEllipsoidEmitter(ParticleSystem* psys);
 
         void _initParticle(Particle* pParticle);
+        void _initParticles(Particle** particles, size_t count);
 
         /** Sets the size of the clear space inside the area from where NO particles are emitted.
         @param x,y,z
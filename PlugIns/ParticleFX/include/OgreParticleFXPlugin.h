@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgrePlugin.h"
 #include "OgreParticleAffectorFactory.h"
 #include "OgreParticleEmitterFactory.h"
+#include "OgreParticleSystemRenderer.h"
 
 namespace Ogre
 {
@@ -59,6 +60,7 @@ namespace Ogre
     protected:
         vector<ParticleEmitterFactory*>::type mEmitterFactories;
         vector<ParticleAffectorFactory*>::type mAffectorFactories;
+        vector<ParticleSystemRendererFactory*>::type mRendererFactories;
 
     };
 }
@@ -53,6 +53,8 @@ namespace Ogre {
 
         /** See ParticleEmitter. */
         void _initParticle(Particle* pParticle);
+        /** See ParticleEmitter. */
+        void _initParticles(Particle** particles, size_t count);
 
         /** See ParticleEmitter. */
         unsigned short _getEmissionCount(Real timeElapsed);
@@ -73,6 +73,8 @@ namespace Ogre {
 
         /// @see ParticleEmitter
         void _initParticle(Particle* pParticle);
+        /// @see ParticleEmitter
+        void _initParticles(Particle** particles, size_t count);
 
         /** Sets the size of the clear space inside the area from where NO particles are emitted.
         @param x, y
@@ -44,26 +44,26 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void BoxEmitter::_initParticle(Particle* pParticle)
     {
-        Vector3 xOff, yOff, zOff;
-
-        // Call superclass
-        ParticleEmitter::_initParticle(pParticle);
-
-        xOff = Math::SymmetricRandom() * mXRange;
-        yOff = Math::SymmetricRandom() * mYRange;
-        zOff = Math::SymmetricRandom() * mZRange;
+        _initParticles(&pParticle, 1);
+    }
+    //-----------------------------------------------------------------------
+    void BoxEmitter::_initParticles(Particle** particles, size_t count)
+    {
+        // Positions of the whole batch first, then the attributes common to all emitters
+        for (size_t i = 0; i < count; ++i)
+        {
+            Particle* p = particles[i];
 
-        pParticle->mPosition = mPosition + xOff + yOff + zOff;
-        
+            // Initialise size in case it's been altered
+            p->resetDimensions();
 
-        // Generate complex data by reference
-        genEmissionColour(pParticle->mColour);
-        genEmissionDirection( pParticle->mPosition, pParticle->mDirection );
-        genEmissionVelocity(pParticle->mDirection);
+            p->mPosition = mPosition +
+                Math::SymmetricRandom() * mXRange +
+                Math::SymmetricRandom() * mYRange +
+                Math::SymmetricRandom() * mZRange;
+        }
 
-        // Generate simpler data
-        pParticle->mTimeToLive = pParticle->mTotalTimeToLive = genEmissionTTL();
-        
+        genEmissionAttributes(particles, count);
     }
 
 
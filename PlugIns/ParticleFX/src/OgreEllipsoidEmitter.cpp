@@ -53,46 +53,37 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void EllipsoidEmitter::_initParticle(Particle* pParticle)
     {
-        Real x, y, z;
-
-        // Call superclass
-        AreaEmitter::_initParticle(pParticle);
-        // First we create a random point inside a bounding sphere with a
-        // radius of 1 (this is easy to do). The distance of the point from
-        // 0,0,0 must be <= 1 (== 1 means on the surface and we count this as
-        // inside, too).
-
-        while (true)
+        _initParticles(&pParticle, 1);
+    }
+    //-----------------------------------------------------------------------
+    void EllipsoidEmitter::_initParticles(Particle** particles, size_t count)
+    {
+        // Positions of the whole batch first, then the attributes common to all emitters
+        for (size_t i = 0; i < count; ++i)
         {
-            // three random values for one random point in 3D space
-
-            x = Math::SymmetricRandom();
-            y = Math::SymmetricRandom();
-            z = Math::SymmetricRandom();
-
-            // the distance of x,y,z from 0,0,0 is sqrt(x*x+y*y+z*z), but
-            // as usual we can omit the sqrt(), since sqrt(1) == 1 and we
-            // use the 1 as boundary:
-            if ( x*x + y*y + z*z <= 1)
-                {
-                        break;          // found one valid point inside
-                }
-        }       
-
-        // scale the found point to the ellipsoid's size and move it
-        // relatively to the center of the emitter point
-
-        pParticle->mPosition = mPosition +
-         + x * mXRange + y * mYRange + z * mZRange;
-
-        // Generate complex data by reference
-        genEmissionColour(pParticle->mColour);
-        genEmissionDirection( pParticle->mPosition, pParticle->mDirection );
-        genEmissionVelocity(pParticle->mDirection);
-
-        // Generate simpler data
-        pParticle->mTimeToLive = pParticle->mTotalTimeToLive = genEmissionTTL();
-        
+            Particle* p = particles[i];
+
+            // Initialise size in case it's been altered
+            p->resetDimensions();
+
+            // First we create a random point inside a bounding sphere with a
+            // radius of 1 (this is easy to do). The distance of the point from
+            // 0,0,0 must be <= 1 (== 1 means on the surface and we count this as
+            // inside, too).
+            Real x, y, z;
+            do
+            {
+                x = Math::SymmetricRandom();
+                y = Math::SymmetricRandom();
+                z = Math::SymmetricRandom();
+            } while (x*x + y*y + z*z > 1);
+
+            // scale the found point to the ellipsoid's size and move it
+            // relatively to the center of the emitter point
+            p->mPosition = mPosition + x * mXRange + y * mYRange + z * mZRange;
+        }
+
+        genEmissionAttributes(particles, count);
     }
 
 }
@@ -0,0 +1,713 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreGpuParticleRenderer.h"
+#include "OgreParticleSystem.h"
+#include "OgreParticleEmitter.h"
+#include "OgreParticleAffector.h"
+#include "OgreAreaEmitter.h"
+#include "OgreRingEmitter.h"
+#include "OgreHollowEllipsoidEmitter.h"
+#include "OgreLinearForceAffector.h"
+#include "OgreColourFaderAffector.h"
+#include "OgreScaleAffector.h"
+#include "OgreRotationAffector.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
+#include "OgreRenderQueue.h"
+#include "OgreNode.h"
+#include "OgreCamera.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreHardwareBufferManager.h"
+#include "OgreHighLevelGpuProgram.h"
+#include "OgreHighLevelGpuProgramManager.h"
+#include "OgreGpuProgramManager.h"
+#include "OgreLogManager.h"
+#include "OgreStringConverter.h"
+
+namespace Ogre {
+
+    namespace
+    {
+        const String rendererTypeName = "gpu";
+
+        /// Names of the per emitter vertex program parameters, by custom parameter index
+        const char* PARAM_NAMES[] = {
+            "emitPos", "areaX", "areaY", "areaZ", "emitDir", "emitUp", "emitRight",
+            "colourStart", "colourEnd", "life", "force", "colourFade", "rotation",
+            "timing", "rate" };
+
+        /// Emitter shapes, as understood by the vertex program
+        enum Shape
+        {
+            SHAPE_POINT = 0,
+            SHAPE_BOX = 1,
+            SHAPE_ELLIPSOID = 2,
+            SHAPE_CYLINDER = 3,
+            SHAPE_RING = 4,
+            SHAPE_HOLLOW_ELLIPSOID = 5
+        };
+
+        /// The system time wraps after this many seconds, to keep float precision
+        const Real TIME_WRAP = 4096;
+        /// Stop time of emitters which are emitting
+        const Real NEVER = 1e30f;
+
+        const char* GLSL_PREFIX =
+            "#version 150\n"
+            "#define float2 vec2\n"
+            "#define float3 vec3\n"
+            "#define float4 vec4\n"
+            "#define float4x4 mat4\n"
+            "#define lerp mix\n"
+            "#define saturate(x) clamp(x, 0.0, 1.0)\n"
+            "#define TO_UINT(x) uint(x)\n"
+            "#define TO_FLOAT(x) float(x)\n";
+
+        const char* HLSL_PREFIX =
+            "#define TO_UINT(x) ((uint)(x))\n"
+            "#define TO_FLOAT(x) ((float)(x))\n";
+
+        // Shared by both languages through the prefixes above
+        const char* SIMULATION =
+            "uniform float4x4 worldView;\n"
+            "uniform float4x4 projection;\n"
+            "uniform float4 emitPos;\n"     // xyz position, w shape
+            "uniform float4 areaX;\n"       // xyz half width axis, w inner size
+            "uniform float4 areaY;\n"       // xyz half height axis, w inner size
+            "uniform float4 areaZ;\n"       // xyz half depth axis, w inner size
+            "uniform float4 emitDir;\n"     // xyz direction, w angle
+            "uniform float4 emitUp;\n"      // xyz up, w minimum speed
+            "uniform float4 emitRight;\n"   // xyz right, w maximum speed
+            "uniform float4 colourStart;\n"
+            "uniform float4 colourEnd;\n"
+            "uniform float4 life;\n"        // minimum and maximum time to live, width, height
+            "uniform float4 force;\n"       // xyz acceleration, w size change per second
+            "uniform float4 colourFade;\n"  // colour change per second
+            "uniform float4 rotation;\n"    // start range, speed range
+            "uniform float4 timing;\n"      // time, emission start and stop, first slot
+            "uniform float4 rate;\n"        // emission rate, rebirth period, seed
+            "uint hashUint(uint x)\n"
+            "{\n"
+            "    x ^= x >> 16u;\n"
+            "    x *= 0x7feb352du;\n"
+            "    x ^= x >> 15u;\n"
+            "    x *= 0x846ca68bu;\n"
+            "    x ^= x >> 16u;\n"
+            "    return x;\n"
+            "}\n"
+            "float random01(uint seed, uint channel)\n"
+            "{\n"
+            "    return TO_FLOAT(hashUint(seed + channel * 0x9e3779b9u) >> 8u) / 16777216.0;\n"
+            "}\n"
+            "bool simulate(float slot, out float3 pos, out float4 colour, out float2 size, out float rot)\n"
+            "{\n"
+            "    pos = float3(0.0, 0.0, 0.0);\n"
+            "    colour = float4(0.0, 0.0, 0.0, 0.0);\n"
+            "    size = float2(0.0, 0.0);\n"
+            "    rot = 0.0;\n"
+            // The slot is reborn every period, starting at slot / rate
+            "    float local = timing.x - slot / rate.x;\n"
+            "    float cycle = floor(local / rate.y);\n"
+            "    float age = local - cycle * rate.y;\n"
+            "    float birth = timing.x - age;\n"
+            "    uint seed = hashUint(TO_UINT(slot) ^ hashUint(TO_UINT(cycle + 1048576.0) ^ TO_UINT(rate.z)));\n"
+            "    float ttl = lerp(life.x, life.y, random01(seed, 0u));\n"
+            "    if (local < 0.0 || age >= ttl || birth < timing.y || birth > timing.z)\n"
+            "        return false;\n"
+            "    float3 r = float3(random01(seed, 1u), random01(seed, 2u), random01(seed, 3u));\n"
+            "    float z = 2.0 * r.x - 1.0;\n"
+            "    float a = 6.2831853 * r.y;\n"
+            "    float s = sqrt(max(1.0 - z * z, 0.0));\n"
+            "    float3 sphere = float3(s * cos(a), s * sin(a), z);\n"
+            "    float3 p = float3(0.0, 0.0, 0.0);\n"
+            "    if (emitPos.w > 4.5)\n"
+            "        p = sphere * lerp(float3(areaX.w, areaY.w, areaZ.w), float3(1.0, 1.0, 1.0), r.z);\n"
+            "    else if (emitPos.w > 3.5)\n"
+            "        p = float3(lerp(areaX.w, 1.0, r.x) * sin(a), lerp(areaY.w, 1.0, r.z) * cos(a),\n"
+            "            2.0 * random01(seed, 4u) - 1.0);\n"
+            "    else if (emitPos.w > 2.5)\n"
+            "        p = float3(sqrt(r.x) * cos(a), sqrt(r.x) * sin(a), 2.0 * r.z - 1.0);\n"
+            "    else if (emitPos.w > 1.5)\n"
+            "        p = sphere * pow(r.z, 1.0 / 3.0);\n"
+            "    else if (emitPos.w > 0.5)\n"
+            "        p = r * 2.0 - 1.0;\n"
+            "    float3 start = emitPos.xyz + p.x * areaX.xyz + p.y * areaY.xyz + p.z * areaZ.xyz;\n"
+            "    float theta = emitDir.w * random01(seed, 5u);\n"
+            "    float phi = 6.2831853 * random01(seed, 6u);\n"
+            "    float3 dir = emitDir.xyz * cos(theta) +\n"
+            "        (emitUp.xyz * cos(phi) + emitRight.xyz * sin(phi)) * sin(theta);\n"
+            "    float speed = lerp(emitUp.w, emitRight.w, random01(seed, 7u));\n"
+            "    pos = start + dir * (speed * age) + force.xyz * (0.5 * age * age);\n"
+            "    float4 c = float4(random01(seed, 8u), random01(seed, 9u), random01(seed, 10u), random01(seed, 11u));\n"
+            "    colour = saturate(lerp(colourStart, colourEnd, c) + colourFade * age);\n"
+            "    size = max(life.zw + force.w * age, float2(0.0, 0.0));\n"
+            "    rot = lerp(rotation.x, rotation.y, random01(seed, 12u)) +\n"
+            "        lerp(rotation.z, rotation.w, random01(seed, 13u)) * age;\n"
+            "    return true;\n"
+            "}\n";
+
+        const char* GLSL_VP =
+            "in vec4 vertex;\n"
+            "out vec4 oColour;\n"
+            "out vec2 oUv;\n"
+            "void main()\n"
+            "{\n"
+            "    vec3 pos;\n"
+            "    vec2 size;\n"
+            "    float rot;\n"
+            "    oUv = vertex.xy * vec2(0.5, -0.5) + 0.5;\n"
+            "    if (!simulate(vertex.z - timing.w, pos, oColour, size, rot))\n"
+            "    {\n"
+            // Outside the clip volume, so the quad is culled
+            "        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);\n"
+            "        return;\n"
+            "    }\n"
+            "    vec4 viewPos = worldView * vec4(pos, 1.0);\n"
+            "    vec2 c = vertex.xy * size * 0.5;\n"
+            "    float cr = cos(rot);\n"
+            "    float sr = sin(rot);\n"
+            "    viewPos.xy += vec2(c.x * cr - c.y * sr, c.x * sr + c.y * cr);\n"
+            "    gl_Position = projection * viewPos;\n"
+            "}\n";
+
+        const char* HLSL_VP =
+            "void main_vp(float4 vertex : POSITION,\n"
+            "    out float4 oPos : SV_POSITION, out float4 oColour : COLOR0, out float2 oUv : TEXCOORD0)\n"
+            "{\n"
+            "    float3 pos;\n"
+            "    float2 size;\n"
+            "    float rot;\n"
+            "    oUv = vertex.xy * float2(0.5, -0.5) + 0.5;\n"
+            "    if (!simulate(vertex.z - timing.w, pos, oColour, size, rot))\n"
+            "    {\n"
+            "        oPos = float4(2.0, 2.0, 2.0, 1.0);\n"
+            "        return;\n"
+            "    }\n"
+            "    float4 viewPos = mul(worldView, float4(pos, 1.0));\n"
+            "    float2 c = vertex.xy * size * 0.5;\n"
+            "    float cr = cos(rot);\n"
+            "    float sr = sin(rot);\n"
+            "    viewPos.xy += float2(c.x * cr - c.y * sr, c.x * sr + c.y * cr);\n"
+            "    oPos = mul(projection, viewPos);\n"
+            "}\n";
+
+        const char* GLSL_FP =
+            "#version 150\n"
+            "in vec4 oColour;\n"
+            "in vec2 oUv;\n"
+            "out vec4 fragColour;\n"
+            "void main()\n"
+            "{\n"
+            "    fragColour = oColour;\n"
+            "}\n";
+
+        const char* GLSL_FP_TEXTURED =
+            "#version 150\n"
+            "in vec4 oColour;\n"
+            "in vec2 oUv;\n"
+            "out vec4 fragColour;\n"
+            "uniform sampler2D diffuseMap;\n"
+            "void main()\n"
+            "{\n"
+            "    fragColour = texture(diffuseMap, oUv) * oColour;\n"
+            "}\n";
+
+        const char* HLSL_FP =
+            "float4 main_fp(float4 pos : SV_POSITION, float4 colour : COLOR0, float2 uv : TEXCOORD0) : SV_Target\n"
+            "{\n"
+            "    return colour;\n"
+            "}\n";
+
+        const char* HLSL_FP_TEXTURED =
+            "Texture2D diffuseMap : register(t0);\n"
+            "SamplerState diffuseSampler : register(s0);\n"
+            "float4 main_fp(float4 pos : SV_POSITION, float4 colour : COLOR0, float2 uv : TEXCOORD0) : SV_Target\n"
+            "{\n"
+            "    return diffuseMap.Sample(diffuseSampler, uv) * colour;\n"
+            "}\n";
+
+        String getShaderLanguage(void)
+        {
+            HighLevelGpuProgramManager& hmgr = HighLevelGpuProgramManager::getSingleton();
+            RenderSystem* rsys = Root::getSingleton().getRenderSystem();
+            if (!rsys)
+                return BLANKSTRING;
+            if (hmgr.isLanguageSupported("hlsl") &&
+                GpuProgramManager::getSingleton().isSyntaxSupported("vs_4_0"))
+                return "hlsl";
+            else if (hmgr.isLanguageSupported("glsl") &&
+                rsys->getNativeShadingLanguageVersion() >= 150)
+                return "glsl";
+            return BLANKSTRING;
+        }
+
+        HighLevelGpuProgramPtr createProgram(const String& name, GpuProgramType type, 
+            const String& glslSource, const String& hlslSource, const char* target, const char* entry)
+        {
+            String lang = getShaderLanguage();
+            HighLevelGpuProgramManager& hmgr = HighLevelGpuProgramManager::getSingleton();
+            String group = ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME;
+
+            HighLevelGpuProgramPtr prog = hmgr.getByName(name, group);
+            if (prog.isNull())
+            {
+                prog = hmgr.createProgram(name, group, lang, type);
+                if (lang == "hlsl")
+                {
+                    prog->setSource(hlslSource);
+                    prog->setParameter("target", target);
+                    prog->setParameter("entry_point", entry);
+                }
+                else
+                    prog->setSource(glslSource);
+
+                if (type == GPT_VERTEX_PROGRAM)
+                {
+                    GpuProgramParametersSharedPtr params = prog->getDefaultParameters();
+                    params->setNamedAutoConstant("worldView", GpuProgramParameters::ACT_WORLDVIEW_MATRIX);
+                    params->setNamedAutoConstant("projection", GpuProgramParameters::ACT_PROJECTION_MATRIX);
+                    for (size_t i = 0; i < sizeof(PARAM_NAMES) / sizeof(PARAM_NAMES[0]); ++i)
+                        params->setNamedAutoConstant(PARAM_NAMES[i], GpuProgramParameters::ACT_CUSTOM, i);
+                }
+                else if (lang == "glsl" && String(glslSource).find("diffuseMap") != String::npos)
+                    prog->getDefaultParameters()->setNamedConstant("diffuseMap", 0);
+            }
+            return prog;
+        }
+    }
+    //-----------------------------------------------------------------------
+    GpuParticleRenderer::Batch::Batch(GpuParticleRenderer* parent)
+        : mParent(parent)
+    {
+        mIndexData = OGRE_NEW IndexData();
+    }
+    //-----------------------------------------------------------------------
+    GpuParticleRenderer::Batch::~Batch()
+    {
+        OGRE_DELETE mIndexData;
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::Batch::getRenderOperation(RenderOperation& op)
+    {
+        op.operationType = RenderOperation::OT_TRIANGLE_LIST;
+        op.useIndexes = true;
+        op.vertexData = mParent->mVertexData;
+        op.indexData = mIndexData;
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::Batch::getWorldTransforms(Matrix4* xform) const
+    {
+        *xform = mParent->mParentNode ? mParent->mParentNode->_getFullTransform() : Matrix4::IDENTITY;
+    }
+    //-----------------------------------------------------------------------
+    Real GpuParticleRenderer::Batch::getSquaredViewDepth(const Camera* cam) const
+    {
+        return mParent->mParentNode ? mParent->mParentNode->getSquaredViewDepth(cam) : 0;
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    GpuParticleRenderer::GpuParticleRenderer()
+        : mSlotCount(0)
+        , mVertexData(0)
+        , mParentNode(0)
+        , mQueueID(RENDER_QUEUE_MAIN)
+        , mQueuePriority(0)
+        , mQueueSet(false)
+        , mTime(0)
+        , mStartTime(0)
+        , mStopTime(NEVER)
+        , mEmitting(true)
+        , mSupported(isSupported())
+        , mCheckedAffectors(0)
+    {
+        if (!mSupported)
+        {
+            LogManager::getSingleton().logMessage(
+                "GpuParticleRenderer: GLSL 1.50 or Shader Model 4 HLSL is not supported "
+                "by the render system, particle systems using it will not be visible.");
+        }
+    }
+    //-----------------------------------------------------------------------
+    GpuParticleRenderer::~GpuParticleRenderer()
+    {
+        for (BatchList::iterator i = mBatches.begin(); i != mBatches.end(); ++i)
+            OGRE_DELETE *i;
+        destroyGeometry();
+        if (!mMaterial.isNull())
+            MaterialManager::getSingleton().remove(mMaterial->getHandle());
+    }
+    //-----------------------------------------------------------------------
+    bool GpuParticleRenderer::isSupported(void)
+    {
+        return !getShaderLanguage().empty();
+    }
+    //-----------------------------------------------------------------------
+    const String& GpuParticleRenderer::getType(void) const
+    {
+        return rendererTypeName;
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::_simulateParticles(ParticleSystem* sys, Real timeElapsed)
+    {
+        mTime += timeElapsed;
+        if (sys->getEmitting() != mEmitting)
+        {
+            mEmitting = sys->getEmitting();
+            if (mEmitting)
+            {
+                mStartTime = mTime;
+                mStopTime = NEVER;
+            }
+            else
+                mStopTime = mTime;
+        }
+        if (mTime > TIME_WRAP)
+        {
+            mTime -= TIME_WRAP;
+            mStartTime -= TIME_WRAP;
+            if (mStopTime != NEVER)
+                mStopTime -= TIME_WRAP;
+        }
+
+        // Affectors apply to all emitters alike
+        Vector4 force(Vector4::ZERO);
+        Vector4 colourFade(Vector4::ZERO);
+        Vector4 rotation(Vector4::ZERO);
+        bool warn = sys->getNumAffectors() != mCheckedAffectors;
+        mCheckedAffectors = sys->getNumAffectors();
+        for (unsigned short i = 0; i < sys->getNumAffectors(); ++i)
+        {
+            ParticleAffector* affector = sys->getAffector(i);
+            const String& type = affector->getType();
+            if (type == "LinearForce" && static_cast<LinearForceAffector*>(affector)->
+                getForceApplication() == LinearForceAffector::FA_ADD)
+            {
+                Vector3 f = static_cast<LinearForceAffector*>(affector)->getForceVector();
+                force += Vector4(f.x, f.y, f.z, 0);
+            }
+            else if (type == "ColourFader")
+            {
+                ColourFaderAffector* fader = static_cast<ColourFaderAffector*>(affector);
+                colourFade += Vector4(fader->getRedAdjust(), fader->getGreenAdjust(),
+                    fader->getBlueAdjust(), fader->getAlphaAdjust());
+            }
+            else if (type == "Scaler")
+                force.w += static_cast<ScaleAffector*>(affector)->getAdjust();
+            else if (type == "Rotator")
+            {
+                RotationAffector* rotator = static_cast<RotationAffector*>(affector);
+                rotation = Vector4(rotator->getRotationRangeStart().valueRadians(),
+                    rotator->getRotationRangeEnd().valueRadians(),
+                    rotator->getRotationSpeedRangeStart().valueRadians(),
+                    rotator->getRotationSpeedRangeEnd().valueRadians());
+            }
+            else if (warn)
+            {
+                LogManager::getSingleton().logMessage("GpuParticleRenderer: the " + type +
+                    " affector is not supported on the GPU and is ignored.");
+            }
+        }
+
+        // Share the quota between the emitters by the number of particles each
+        // keeps alive, so no emitter has more slots than it can fill
+        Real totalWeight = 0;
+        for (unsigned short i = 0; i < sys->getNumEmitters(); ++i)
+        {
+            ParticleEmitter* emitter = sys->getEmitter(i);
+            if (!emitter->isEmitted() && emitter->getEnabled())
+                totalWeight += emitter->getEmissionRate() * emitter->getMaxTimeToLive();
+        }
+
+        AxisAlignedBox bounds;
+        mEmitterParams.resize(sys->getNumEmitters());
+        for (unsigned short i = 0; i < sys->getNumEmitters(); ++i)
+        {
+            ParticleEmitter* emitter = sys->getEmitter(i);
+            EmitterParams& params = mEmitterParams[i];
+            params.slots = 0;
+            Real rate = emitter->getEmissionRate();
+            Real maxTTL = emitter->getMaxTimeToLive();
+            Real alive = rate * maxTTL;
+            if (emitter->isEmitted() || !emitter->getEnabled() || alive <= 0)
+                continue;
+
+            params.slots = std::min(static_cast<size_t>(Math::Ceil(alive)),
+                static_cast<size_t>(sys->getParticleQuota() * alive / totalWeight));
+            if (params.slots == 0)
+                continue;
+            // Emit more slowly if the quota is too small to let particles live out their lives
+            rate = std::min(rate, params.slots / maxTTL);
+
+            Shape shape = SHAPE_POINT;
+            Vector3 inner(Vector3::ZERO);
+            Vector3 size(Vector3::ZERO);
+            const String& type = emitter->getType();
+            if (type == "Box")
+                shape = SHAPE_BOX;
+            else if (type == "Ellipsoid")
+                shape = SHAPE_ELLIPSOID;
+            else if (type == "Cylinder")
+                shape = SHAPE_CYLINDER;
+            else if (type == "Ring")
+            {
+                shape = SHAPE_RING;
+                RingEmitter* ring = static_cast<RingEmitter*>(emitter);
+                inner = Vector3(ring->getInnerSizeX(), ring->getInnerSizeY(), 0);
+            }
+            else if (type == "HollowEllipsoid")
+            {
+                shape = SHAPE_HOLLOW_ELLIPSOID;
+                HollowEllipsoidEmitter* hollow = static_cast<HollowEllipsoidEmitter*>(emitter);
+                inner = Vector3(hollow->getInnerSizeX(), hollow->getInnerSizeY(), hollow->getInnerSizeZ());
+            }
+            if (shape != SHAPE_POINT)
+            {
+                AreaEmitter* area = static_cast<AreaEmitter*>(emitter);
+                size = Vector3(area->getWidth(), area->getHeight(), area->getDepth()) * 0.5f;
+            }
+
+            // Same axes as AreaEmitter
+            const Vector3& pos = emitter->getPosition();
+            const Vector3& dir = emitter->getDirection();
+            const Vector3& up = emitter->getUp();
+            Vector3 left = up.crossProduct(dir);
+            Vector3 right = dir.crossProduct(up);
+            const ColourValue& cs = emitter->getColourRangeStart();
+            const ColourValue& ce = emitter->getColourRangeEnd();
+
+            params.values[0] = Vector4(pos.x, pos.y, pos.z, (Real)shape);
+            params.values[1] = Vector4(left.x * size.x, left.y * size.x, left.z * size.x, inner.x);
+            params.values[2] = Vector4(up.x * size.y, up.y * size.y, up.z * size.y, inner.y);
+            params.values[3] = Vector4(dir.x * size.z, dir.y * size.z, dir.z * size.z, inner.z);
+            params.values[4] = Vector4(dir.x, dir.y, dir.z, emitter->getAngle().valueRadians());
+            params.values[5] = Vector4(up.x, up.y, up.z, emitter->getMinParticleVelocity());
+            params.values[6] = Vector4(right.x, right.y, right.z, emitter->getMaxParticleVelocity());
+            params.values[7] = Vector4(cs.r, cs.g, cs.b, cs.a);
+            params.values[8] = Vector4(ce.r, ce.g, ce.b, ce.a);
+            params.values[9] = Vector4(emitter->getMinTimeToLive(), maxTTL,
+                sys->getDefaultWidth(), sys->getDefaultHeight());
+            params.values[10] = force;
+            params.values[11] = colourFade;
+            params.values[12] = rotation;
+            // The first slot is filled in when the batches are laid out
+            params.values[13] = Vector4(mTime, mStartTime, mStopTime, 0);
+            params.values[14] = Vector4(rate, params.slots / rate, (Real)(i * 7919), 0);
+
+            // Furthest a particle can get from the emitter
+            Real reach = size.length() + emitter->getMaxParticleVelocity() * maxTTL +
+                Vector3(force.x, force.y, force.z).length() * 0.5f * maxTTL * maxTTL +
+                std::max(sys->getDefaultWidth(), sys->getDefaultHeight()) +
+                std::max(force.w, (Real)0) * maxTTL;
+            bounds.merge(AxisAlignedBox(pos - reach, pos + reach));
+        }
+
+        if (!bounds.isNull())
+            sys->setBounds(bounds);
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::_updateRenderQueue(RenderQueue* queue, 
+        vector<Particle*>::type& currentParticles, bool cullIndividually)
+    {
+        if (mMaterial.isNull())
+            return;
+
+        size_t slots = 0;
+        for (EmitterParamsList::iterator i = mEmitterParams.begin(); i != mEmitterParams.end(); ++i)
+            slots += i->slots;
+        if (slots > mSlotCount)
+            createGeometry(slots);
+        while (mBatches.size() < mEmitterParams.size())
+            mBatches.push_back(OGRE_NEW Batch(this));
+
+        size_t firstSlot = 0;
+        for (size_t i = 0; i < mEmitterParams.size(); ++i)
+        {
+            EmitterParams& params = mEmitterParams[i];
+            if (params.slots == 0)
+                continue;
+
+            Batch* batch = mBatches[i];
+            batch->mIndexData->indexBuffer = mIndexBuffer;
+            batch->mIndexData->indexStart = firstSlot * 6;
+            batch->mIndexData->indexCount = params.slots * 6;
+            params.values[13].w = (Real)firstSlot;
+            for (size_t p = 0; p < PARAM_COUNT; ++p)
+                batch->setCustomParameter(p, params.values[p]);
+            firstSlot += params.slots;
+
+            if (mQueueSet)
+                queue->addRenderable(batch, mQueueID, mQueuePriority);
+            else
+                queue->addRenderable(batch);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::visitRenderables(Renderable::Visitor* visitor, 
+        bool debugRenderables)
+    {
+        for (size_t i = 0; i < mBatches.size() && i < mEmitterParams.size(); ++i)
+        {
+            if (mEmitterParams[i].slots > 0)
+                visitor->visit(mBatches[i], 0, false);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::_setMaterial(MaterialPtr& mat)
+    {
+        if (!mMaterial.isNull())
+        {
+            MaterialManager::getSingleton().remove(mMaterial->getHandle());
+            mMaterial.setNull();
+        }
+        if (!mSupported || mat.isNull())
+            return;
+
+        String glslVp = String(GLSL_PREFIX) + SIMULATION + GLSL_VP;
+        String hlslVp = String(HLSL_PREFIX) + SIMULATION + HLSL_VP;
+        HighLevelGpuProgramPtr vp = createProgram("ParticleFX/GpuParticle/VP", GPT_VERTEX_PROGRAM,
+            glslVp, hlslVp, "vs_4_0", "main_vp");
+        HighLevelGpuProgramPtr fp = createProgram("ParticleFX/GpuParticle/FP", GPT_FRAGMENT_PROGRAM,
+            GLSL_FP, HLSL_FP, "ps_4_0", "main_fp");
+        HighLevelGpuProgramPtr texturedFp = createProgram("ParticleFX/GpuParticle/TexturedFP",
+            GPT_FRAGMENT_PROGRAM, GLSL_FP_TEXTURED, HLSL_FP_TEXTURED, "ps_4_0", "main_fp");
+
+        // The programs replace the vertex processing of every pass
+        static uint32 count = 0;
+        mMaterial = mat->clone(mat->getName() + "/GpuParticles/" + StringConverter::toString(count++));
+        for (unsigned short t = 0; t < mMaterial->getNumTechniques(); ++t)
+        {
+            Technique* tech = mMaterial->getTechnique(t);
+            for (unsigned short p = 0; p < tech->getNumPasses(); ++p)
+            {
+                Pass* pass = tech->getPass(p);
+                pass->setLightingEnabled(false);
+                pass->setVertexProgram(vp->getName());
+                pass->setFragmentProgram(pass->getNumTextureUnitStates() > 0 ?
+                    texturedFp->getName() : fp->getName());
+            }
+        }
+        mMaterial->load();
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::_notifyAttached(Node* parent, bool isTagPoint)
+    {
+        mParentNode = parent;
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::setRenderQueueGroup(uint8 queueID)
+    {
+        assert(queueID <= RENDER_QUEUE_MAX && "Render queue out of range!");
+        mQueueID = queueID;
+        mQueuePriority = 0;
+        mQueueSet = true;
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::setRenderQueueGroupAndPriority(uint8 queueID, ushort priority)
+    {
+        assert(queueID <= RENDER_QUEUE_MAX && "Render queue out of range!");
+        mQueueID = queueID;
+        mQueuePriority = priority;
+        mQueueSet = true;
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::createGeometry(size_t slots)
+    {
+        destroyGeometry();
+
+        // One quad per slot, with the corner in xy and the slot index in z
+        mSlotCount = slots;
+        mVertexData = OGRE_NEW VertexData();
+        mVertexData->vertexStart = 0;
+        mVertexData->vertexCount = slots * 4;
+        mVertexData->vertexDeclaration->addElement(0, 0, VET_FLOAT3, VES_POSITION);
+        HardwareVertexBufferSharedPtr vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+            sizeof(float) * 3, mVertexData->vertexCount, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        mVertexData->vertexBufferBinding->setBinding(0, vbuf);
+        static const float corners[] = { -1, -1, 1, -1, 1, 1, -1, 1 };
+        float* pVert = static_cast<float*>(vbuf->lock(HardwareBuffer::HBL_DISCARD));
+        for (size_t s = 0; s < slots; ++s)
+        {
+            for (size_t c = 0; c < 4; ++c)
+            {
+                *pVert++ = corners[c * 2];
+                *pVert++ = corners[c * 2 + 1];
+                *pVert++ = static_cast<float>(s);
+            }
+        }
+        vbuf->unlock();
+
+        bool use32 = mVertexData->vertexCount > 0xFFFF;
+        mIndexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+            use32 ? HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT,
+            slots * 6, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        void* pIndexes = mIndexBuffer->lock(HardwareBuffer::HBL_DISCARD);
+        static const uint32 quad[] = { 0, 1, 2, 0, 2, 3 };
+        for (size_t s = 0; s < slots; ++s)
+        {
+            for (size_t i = 0; i < 6; ++i)
+            {
+                uint32 index = static_cast<uint32>(s * 4 + quad[i]);
+                if (use32)
+                    static_cast<uint32*>(pIndexes)[s * 6 + i] = index;
+                else
+                    static_cast<uint16*>(pIndexes)[s * 6 + i] = static_cast<uint16>(index);
+            }
+        }
+        mIndexBuffer->unlock();
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::destroyGeometry(void)
+    {
+        OGRE_DELETE mVertexData;
+        mVertexData = 0;
+        mIndexBuffer.setNull();
+        for (BatchList::iterator i = mBatches.begin(); i != mBatches.end(); ++i)
+            (*i)->mIndexData->indexBuffer.setNull();
+        mSlotCount = 0;
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    const String& GpuParticleRendererFactory::getType() const
+    {
+        return rendererTypeName;
+    }
+    //-----------------------------------------------------------------------
+    ParticleSystemRenderer* GpuParticleRendererFactory::createInstance( 
+        const String& name )
+    {
+        return OGRE_NEW GpuParticleRenderer();
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRendererFactory::destroyInstance( 
+        ParticleSystemRenderer* inst)
+    {
+        OGRE_DELETE  inst;
+    }
+}
@@ -70,47 +70,40 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void HollowEllipsoidEmitter::_initParticle(Particle* pParticle)
     {
-        Real a, b, c, x, y, z;
-
-        // Init dimensions
-        pParticle->resetDimensions();
-
-        // create two random angles alpha and beta
-        // with these two angles, we are able to select any point on an
-        // ellipsoid's surface
-        Radian alpha ( Math::RangeRandom(0,Math::TWO_PI) );
-        Radian beta  ( Math::RangeRandom(0,Math::PI) );
-
-        // create three random radius values that are bigger than the inner
-        // size, but smaller/equal than/to the outer size 1.0 (inner size is
-        // between 0 and 1)
-        a = Math::RangeRandom(mInnerSize.x,1.0);
-        b = Math::RangeRandom(mInnerSize.y,1.0);
-        c = Math::RangeRandom(mInnerSize.z,1.0);
-
-        // with a,b,c we have defined a random ellipsoid between the inner
-        // ellipsoid and the outer sphere (radius 1.0)
-        // with alpha and beta we select on point on this random ellipsoid
-        // and calculate the 3D coordinates of this point
-        Real sinbeta ( Math::Sin(beta) );
-        x = a * Math::Cos(alpha) * sinbeta;
-        y = b * Math::Sin(alpha) * sinbeta;
-        z = c * Math::Cos(beta);
-
-        // scale the found point to the ellipsoid's size and move it
-        // relatively to the center of the emitter point
-
-        pParticle->mPosition = mPosition +
-         + x * mXRange + y * mYRange + z * mZRange;
-
-        // Generate complex data by reference
-        genEmissionColour(pParticle->mColour);
-        genEmissionDirection( pParticle->mPosition, pParticle->mDirection );
-        genEmissionVelocity(pParticle->mDirection);
-
-        // Generate simpler data
-        pParticle->mTimeToLive = pParticle->mTotalTimeToLive = genEmissionTTL();
-        
+        _initParticles(&pParticle, 1);
+    }
+    //-----------------------------------------------------------------------
+    void HollowEllipsoidEmitter::_initParticles(Particle** particles, size_t count)
+    {
+        // Positions of the whole batch first, then the attributes common to all emitters
+        for (size_t i = 0; i < count; ++i)
+        {
+            Particle* p = particles[i];
+
+            // Initialise size in case it's been altered
+            p->resetDimensions();
+
+            // two random angles alpha and beta select any point on an
+            // ellipsoid's surface, and three random radius values between the
+            // inner size and 1.0 a random ellipsoid between the inner
+            // ellipsoid and the outer sphere
+            Radian alpha ( Math::RangeRandom(0,Math::TWO_PI) );
+            Radian beta  ( Math::RangeRandom(0,Math::PI) );
+            Real a = Math::RangeRandom(mInnerSize.x,1.0);
+            Real b = Math::RangeRandom(mInnerSize.y,1.0);
+            Real c = Math::RangeRandom(mInnerSize.z,1.0);
+
+            Real sinbeta ( Math::Sin(beta) );
+            Real x = a * Math::Cos(alpha) * sinbeta;
+            Real y = b * Math::Sin(alpha) * sinbeta;
+            Real z = c * Math::Cos(beta);
+
+            // scale the found point to the ellipsoid's size and move it
+            // relatively to the center of the emitter point
+            p->mPosition = mPosition + x * mXRange + y * mYRange + z * mZRange;
+        }
+
+        genEmissionAttributes(particles, count);
     }
     //-----------------------------------------------------------------------
     void HollowEllipsoidEmitter::setInnerSize(Real x, Real y, Real z)
@@ -69,27 +69,24 @@ namespace Ogre {
     void LinearForceAffector::_affectParticles(ParticleSystem* pSystem, Real timeElapsed)
     {
         ParticleIterator pi = pSystem->_getIterator();
-        Particle *p;
 
-        Vector3 scaledVector = Vector3::ZERO;
-
-        // Precalc scaled force for optimisation
+        // Choose the loop once rather than per particle
         if (mForceApplication == FA_ADD)
         {
-            // Scale force by time
-            scaledVector = mForceVector * timeElapsed;
-        }
-
-        while (!pi.end())
-        {
-            p = pi.getNext();
-            if (mForceApplication == FA_ADD)
+            // Precalc force scaled by time for optimisation
+            const Vector3 scaledVector = mForceVector * timeElapsed;
+            while (!pi.end())
             {
-                p->mDirection += scaledVector;
+                pi.getNext()->mDirection += scaledVector;
             }
-            else // FA_AVERAGE
+        }
+        else // FA_AVERAGE
+        {
+            const Vector3 halfForce = mForceVector * 0.5f;
+            while (!pi.end())
             {
-                p->mDirection = (p->mDirection + mForceVector) / 2;
+                Particle* p = pi.getNext();
+                p->mDirection = p->mDirection * 0.5f + halfForce;
             }
         }
         
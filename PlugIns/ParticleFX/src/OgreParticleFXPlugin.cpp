@@ -45,6 +45,7 @@ THE SOFTWARE.
 #include "OgreRotationAffectorFactory.h"
 #include "OgreDirectionRandomiserAffectorFactory.h"
 #include "OgreDeflectorPlaneAffectorFactory.h"
+#include "OgreGpuParticleRenderer.h"
 
 namespace Ogre 
 {
@@ -143,6 +144,14 @@ namespace Ogre
         pAffFact = OGRE_NEW DeflectorPlaneAffectorFactory();
         ParticleSystemManager::getSingleton().addAffectorFactory(pAffFact);
         mAffectorFactories.push_back(pAffFact);
+
+        // Renderers
+        ParticleSystemRendererFactory* pRendFact;
+
+        // GpuParticleRenderer
+        pRendFact = OGRE_NEW GpuParticleRendererFactory();
+        ParticleSystemManager::getSingleton().addRendererFactory(pRendFact);
+        mRendererFactories.push_back(pRendFact);
     }
     //---------------------------------------------------------------------
     void ParticleFXPlugin::initialise()
@@ -160,6 +169,7 @@ namespace Ogre
         // destroy 
         vector<ParticleEmitterFactory*>::type::iterator ei;
         vector<ParticleAffectorFactory*>::type::iterator ai;
+        vector<ParticleSystemRendererFactory*>::type::iterator ri;
 
         for (ei = mEmitterFactories.begin(); ei != mEmitterFactories.end(); ++ei)
         {
@@ -171,6 +181,11 @@ namespace Ogre
             OGRE_DELETE (*ai);
         }
 
+        for (ri = mRendererFactories.begin(); ri != mRendererFactories.end(); ++ri)
+        {
+            OGRE_DELETE (*ri);
+        }
+
 
     }
 
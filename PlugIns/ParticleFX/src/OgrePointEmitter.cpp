@@ -47,22 +47,24 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void PointEmitter::_initParticle(Particle* pParticle)
     {
-        // Very simple emitter, uses default implementations with no modification
-
-        // Call superclass
-        ParticleEmitter::_initParticle(pParticle);
+        _initParticles(&pParticle, 1);
+    }
+    //-----------------------------------------------------------------------
+    void PointEmitter::_initParticles(Particle** particles, size_t count)
+    {
+        // Positions of the whole batch first, then the attributes common to all emitters
+        for (size_t i = 0; i < count; ++i)
+        {
+            Particle* p = particles[i];
 
-        // Point emitter emits from own position
-        pParticle->mPosition = mPosition;
+            // Initialise size in case it's been altered
+            p->resetDimensions();
 
-        // Generate complex data by reference
-        genEmissionColour(pParticle->mColour);
-        genEmissionDirection( pParticle->mPosition, pParticle->mDirection );
-        genEmissionVelocity(pParticle->mDirection);
+            // Point emitter emits from own position
+            p->mPosition = mPosition;
+        }
 
-        // Generate simpler data
-        pParticle->mTimeToLive = pParticle->mTotalTimeToLive = genEmissionTTL();
-        
+        genEmissionAttributes(particles, count);
     }
     //-----------------------------------------------------------------------
     unsigned short PointEmitter::_getEmissionCount(Real timeElapsed)
@@ -60,40 +60,36 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void RingEmitter::_initParticle(Particle* pParticle)
     {
-        Real a, b, x, y, z;
-
-        // Call superclass
-        AreaEmitter::_initParticle(pParticle);
-        // create a random angle from 0 .. PI*2
-        Radian alpha ( Math::RangeRandom(0,Math::TWO_PI) );
-  
-        // create two random radius values that are bigger than the inner size
-        a = Math::RangeRandom(mInnerSizex,1.0);
-        b = Math::RangeRandom(mInnerSizey,1.0);
-
-        // with a and b we have defined a random ellipse inside the inner
-        // ellipse and the outer circle (radius 1.0)
-        // with alpha, and a and b we select a random point on this ellipse
-        // and calculate it's coordinates
-        x = a * Math::Sin(alpha);
-        y = b * Math::Cos(alpha);
-        // the height is simple -1 to 1
-        z = Math::SymmetricRandom();     
-
-        // scale the found point to the ring's size and move it
-        // relatively to the center of the emitter point
-
-        pParticle->mPosition = mPosition +
-         + x * mXRange + y * mYRange + z * mZRange;
-
-        // Generate complex data by reference
-        genEmissionColour(pParticle->mColour);
-        genEmissionDirection( pParticle->mPosition, pParticle->mDirection );
-        genEmissionVelocity(pParticle->mDirection);
-
-        // Generate simpler data
-        pParticle->mTimeToLive = pParticle->mTotalTimeToLive = genEmissionTTL();
-        
+        _initParticles(&pParticle, 1);
+    }
+    //-----------------------------------------------------------------------
+    void RingEmitter::_initParticles(Particle** particles, size_t count)
+    {
+        // Positions of the whole batch first, then the attributes common to all emitters
+        for (size_t i = 0; i < count; ++i)
+        {
+            Particle* p = particles[i];
+
+            // Initialise size in case it's been altered
+            p->resetDimensions();
+
+            // a random angle from 0 .. PI*2, and two random radius values that
+            // are bigger than the inner size select a point on an ellipse between
+            // the inner ellipse and the outer circle (radius 1.0)
+            Radian alpha ( Math::RangeRandom(0,Math::TWO_PI) );
+            Real a = Math::RangeRandom(mInnerSizex,1.0);
+            Real b = Math::RangeRandom(mInnerSizey,1.0);
+            Real x = a * Math::Sin(alpha);
+            Real y = b * Math::Cos(alpha);
+            // the height is simple -1 to 1
+            Real z = Math::SymmetricRandom();
+
+            // scale the found point to the ring's size and move it
+            // relatively to the center of the emitter point
+            p->mPosition = mPosition + x * mXRange + y * mYRange + z * mZRange;
+        }
+
+        genEmissionAttributes(particles, count);
     }
     //-----------------------------------------------------------------------
     void RingEmitter::setInnerSize(Real x, Real y)
@@ -64,6 +64,8 @@ namespace Ogre {
         ds = mScaleAdj * timeElapsed;
 
         Real NewWide, NewHigh;
+        const Real defaultWide = pSystem->getDefaultWidth() + ds;
+        const Real defaultHigh = pSystem->getDefaultHeight() + ds;
 
         while (!pi.end())
         {
@@ -71,8 +73,8 @@ namespace Ogre {
 
             if( p->hasOwnDimensions() == false )
             {
-                NewWide = pSystem->getDefaultWidth() + ds;
-                NewHigh = pSystem->getDefaultHeight() + ds;
+                NewWide = defaultWide;
+                NewHigh = defaultHigh;
 
             }
             else
@@ -38,6 +38,9 @@ namespace Ogre
     private:
         ComPtr<ID3D11DeviceN>           mD3D11Device;
         ComPtr<ID3D11DeviceContextN>    mImmediateContext;
+        ComPtr<ID3D11DeviceContextN>    mDeferredContext;
+        ID3D11DeviceContextN*           mCurrentContext;
+        vector<ComPtr<ID3D11CommandList> >::type mPendingCommandLists;
         ComPtr<ID3D11ClassLinkage>      mClassLinkage;
         ComPtr<ID3D11InfoQueue>         mInfoQueue;
         LARGE_INTEGER                   mDriverVersion;
@@ -60,6 +63,9 @@ namespace Ogre
         bool isNull()                                { return !mD3D11Device; }
         ID3D11DeviceN* get()                         { return mD3D11Device.Get(); }
         ID3D11DeviceContextN* GetImmediateContext()  { return mImmediateContext.Get(); }
+        /// Context rendering commands go to: the deferred one while recording, the immediate one otherwise
+        ID3D11DeviceContextN* GetCurrentContext()    { return mCurrentContext; }
+        bool IsRecordingDeferred() const             { return mCurrentContext != mImmediateContext.Get(); }
         ID3D11ClassLinkage* GetClassLinkage()        { return mClassLinkage.Get(); }
         IDXGIFactoryN* GetDXGIFactory()              { return mDXGIFactory.Get(); }
         LARGE_INTEGER GetDriverVersion()             { return mDriverVersion; }
@@ -77,6 +83,18 @@ namespace Ogre
             return mD3D11Device.Get();
         }
 
+        /** Redirects the current context to a deferred context. Commands issued until
+            EndDeferredRecording() are recorded into a command list instead of being submitted.
+        @remarks
+            A deferred context starts from the default pipeline state, callers have to
+            bind everything again.
+        */
+        void BeginDeferredRecording();
+        /// Closes the command list being recorded, queuing it for ExecuteDeferredCommandLists()
+        void EndDeferredRecording();
+        /// Plays back the queued command lists on the immediate context, in recording order
+        void ExecuteDeferredCommandLists();
+
         void throwIfFailed(HRESULT hr, const char* desc, const char* src);
         void throwIfFailed(const char* desc, const char* src) { throwIfFailed(NO_ERROR, desc, src); }
 
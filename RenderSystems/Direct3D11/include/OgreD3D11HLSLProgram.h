@@ -139,12 +139,17 @@ namespace Ogre {
             mutable String name;
             size_t size;
             size_t startOffset;
-            
+            // Resolved definition, cached so updates don't look up the name every time
+            mutable const GpuConstantDefinition* def;
+
+            ShaderVarWithPosInBuf() : size(0), startOffset(0), def(0) {}
+
             ShaderVarWithPosInBuf& operator=(const ShaderVarWithPosInBuf& var)
             {
                 name = var.name;
                 size = var.size;
                 startOffset = var.startOffset;
+                def = var.def;
                 return *this;
             }
         };
@@ -169,11 +174,23 @@ namespace Ogre {
             String mName;
             mutable HardwareUniformBufferSharedPtr mUniformBuffer;
             mutable ShaderVars mShaderVars;
+            // CPU copy of the buffer contents; the GPU buffer is discarded on every
+            // map, so only changed variables are rewritten here and the whole
+            // shadow is uploaded once, and only when something changed
+            mutable vector<uint8>::type mShadow;
+            // Parameters last written into mShadow, and the constant definitions
+            // the cached ShaderVarWithPosInBuf::def pointers were resolved against
+            mutable const GpuProgramParameters* mLastParams;
+            mutable const GpuNamedConstants* mResolvedConstants;
+            // Shared parameter set this buffer is named after, if any; its buffer is
+            // then shared by every program declaring it and filled from the set
+            mutable GpuSharedParametersPtr mSharedParams;
+            mutable unsigned long mSharedVersion;
                 
             // Default constructor
-            BufferInfo() : mIdx(0), mName("") { mUniformBuffer.setNull(); }
+            BufferInfo() : mIdx(0), mName(""), mLastParams(0), mResolvedConstants(0), mSharedVersion(0) { mUniformBuffer.setNull(); }
             BufferInfo(unsigned int index, const String& name)
-                : mIdx(index), mName(name)
+                : mIdx(index), mName(name), mLastParams(0), mResolvedConstants(0), mSharedVersion(0)
             {
                 mUniformBuffer.setNull();
             }
@@ -184,6 +201,11 @@ namespace Ogre {
                 , mName(info.mName)
                 , mUniformBuffer(info.mUniformBuffer)
                 , mShaderVars(info.mShaderVars)
+                , mShadow(info.mShadow)
+                , mLastParams(info.mLastParams)
+                , mResolvedConstants(info.mResolvedConstants)
+                , mSharedParams(info.mSharedParams)
+                , mSharedVersion(info.mSharedVersion)
             {
 
             }
@@ -195,12 +217,17 @@ namespace Ogre {
                 this->mName = info.mName;
                 mUniformBuffer = info.mUniformBuffer;
                 mShaderVars = info.mShaderVars;
+                mShadow = info.mShadow;
+                mLastParams = info.mLastParams;
+                mResolvedConstants = info.mResolvedConstants;
+                mSharedParams = info.mSharedParams;
+                mSharedVersion = info.mSharedVersion;
                 return *this;
             }
             
             // Constructors and operators used for search
-            BufferInfo(unsigned int index) : mIdx(index), mName("") { }
-            BufferInfo(const String& name) : mIdx(INVALID_IDX), mName(name) { }
+            BufferInfo(unsigned int index) : mIdx(index), mName(""), mLastParams(0), mResolvedConstants(0), mSharedVersion(0) { }
+            BufferInfo(const String& name) : mIdx(INVALID_IDX), mName(name), mLastParams(0), mResolvedConstants(0), mSharedVersion(0) { }
             BufferInfo& operator=(unsigned int index) { this->mIdx = index; return *this; }
             BufferInfo& operator=(const String& name) { this->mName = name; return *this; } 
             
@@ -237,6 +264,10 @@ namespace Ogre {
         typedef std::set<BufferInfo>::iterator BufferInfoIterator;
         BufferInfoMap mBufferInfoMap;
 
+        // Refresh a constant buffer from the program parameters or its shared parameter set
+        void updateConstantBuffer(const BufferInfo& info, const GpuProgramParameters* params, uint16 variabilityMask);
+        void updateSharedConstantBuffer(const BufferInfo& info);
+
         // Map to store interface slot position. 
         // Number of interface slots is size of this map.
         typedef std::map<String, unsigned int> SlotMap;
@@ -335,12 +366,19 @@ namespace Ogre {
         ID3D11ComputeShader* getComputeShader(void) const;
         const MicroCode &  getMicroCode(void) const;  
 
-        ID3D11Buffer* getConstantBuffer(GpuProgramParametersSharedPtr params, uint16 variabilityMask);
-
+        /** Updates the constant buffers of this program and returns them in slot order.
+        @remarks
+            A constant buffer named after a shared parameter set is backed by a single
+            buffer used by every program that declares it. It is uploaded once whenever
+            the set is dirty, instead of being copied into each program's parameters.
+            Programs sharing a set must declare the buffer with the same layout.
+        */
         void getConstantBuffers(ID3D11Buffer** buffers, unsigned int& numBuffers,
-                                ID3D11ClassInstance** classes, unsigned int& numInstances,
                                 GpuProgramParametersSharedPtr params, uint16 variabilityMask);
 
+        /// Returns whether the shared parameter set is bound as its own constant buffer
+        bool hasSharedParamsBuffer(const GpuSharedParameters* sharedParams) const;
+
         // Get slot for a specific interface
         unsigned int getSubroutineSlot(const String& subroutineSlotName) const;
 
@@ -53,6 +53,8 @@ namespace Ogre {
         bool mStagingUploadNeeded;
         BufferType mBufferType;
         D3D11Device & mDevice;
+        /// Context the buffer is mapped on, so unlock unmaps on the same one
+        ID3D11DeviceContextN* mMappedContext;
         D3D11_BUFFER_DESC mDesc;
 
 
@@ -76,8 +78,8 @@ namespace Ogre {
             size_t dstOffset, size_t length, bool discardWholeBuffer = false);
 		void copyDataImpl(HardwareBuffer& srcBuffer, size_t srcOffset,
 			size_t dstOffset, size_t length, bool discardWholeBuffer = false);
-		/// Updates the real buffer from the shadow buffer, if required
-		virtual void _updateFromShadow(void);
+		/// Uploads one dirty range of the shadow buffer with a hardware copy
+		virtual void uploadFromShadow(size_t offset, size_t length);
 
         /// Get the D3D-specific buffer
         ID3D11Buffer* getD3DBuffer(void) { return mlpD3DBuffer.Get(); }
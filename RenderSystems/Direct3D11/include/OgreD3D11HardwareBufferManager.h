@@ -43,6 +43,8 @@ namespace Ogre {
         VertexDeclaration* createVertexDeclarationImpl(void);
         /// Internal method for destroys a vertex declaration, may be overridden by certain rendering APIs
         void destroyVertexDeclarationImpl(VertexDeclaration* decl);
+        /// Creates a staging buffer, which can be mapped for reading and writing
+        HardwareBuffer* createStagingBufferImpl(size_t sizeInBytes);
 
     public:
         D3D11HardwareBufferManagerBase(D3D11Device & device);
@@ -58,6 +58,7 @@ namespace Ogre {
         void copyData(HardwareBuffer& srcBuffer, size_t srcOffset, 
             size_t dstOffset, size_t length, bool discardWholeBuffer = false);
         bool isLocked(void) const;
+        void setOwnerName(const String& name);
 
         /// Get the D3D-specific vertex buffer
         ID3D11Buffer * getD3DConstantBuffer(void) const;
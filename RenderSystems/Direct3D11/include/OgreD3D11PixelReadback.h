@@ -0,0 +1,61 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __D3D11PIXELREADBACK_H__
+#define __D3D11PIXELREADBACK_H__
+
+#include "OgreD3D11Prerequisites.h"
+#include "OgrePixelReadback.h"
+
+namespace Ogre {
+    /** Asynchronous readback of a render target through a staging texture.
+    @remarks
+        The copy into the staging texture is queued on the immediate context, and
+        polled by mapping the staging texture with D3D11_MAP_FLAG_DO_NOT_WAIT.
+    */
+    class _OgreD3D11Export D3D11PixelReadback : public PixelReadback
+    {
+    protected:
+        D3D11Device& mDevice;
+        ComPtr<ID3D11Texture2D> mStagingTexture;
+        DXGI_FORMAT mStagingFormat;
+        bool mReady;
+
+    public:
+        /** Copies a box of a subresource of source, resolving it first if multisampled. */
+        D3D11PixelReadback(D3D11Device& device, ID3D11Texture2D* source, UINT subresource,
+                           const Box& src, PixelFormat format);
+        ~D3D11PixelReadback();
+
+        /// @copydoc PixelReadback::isReady
+        bool isReady(void);
+
+        /// @copydoc PixelReadback::read
+        void read(const PixelBox& dst);
+    };
+}
+#endif
@@ -78,6 +78,8 @@ namespace Ogre
         D3D11Driver mActiveD3DDriver;
         /// NVPerfHUD allowed?
         bool mUseNVPerfHUD;
+        /// Record each viewport render on a deferred context (see "Use Deferred Contexts" option)
+        bool mUseDeferredContexts;
 		int mSwitchingFullscreenCounter;	// Are we switching from windowed to fullscreen 
 
         static ID3D11DeviceN* createD3D11Device(D3D11Driver* d3dDriver, D3D_DRIVER_TYPE driverType,
@@ -155,6 +157,56 @@ namespace Ogre
         ComPtr<ID3D11SamplerState> mBoundSamplerStates[OGRE_MAX_TEXTURE_LAYERS];
         size_t mBoundSamplerStatesCount;
 
+        /// Argument buffer the commands of multi-draw indirect render operations are written to
+        ComPtr<ID3D11Buffer> mIndirectBuffer;
+        /// Size in bytes of mIndirectBuffer
+        size_t mIndirectBufferSize;
+
+        /// Uploads op's indirect commands, growing the argument buffer when needed
+        void uploadIndirectCommands(const RenderOperation& op);
+
+        /// The timestamp queries at the beginning and end of a GPU timer
+        struct GpuTimer
+        {
+            ComPtr<ID3D11Query> begin;
+            ComPtr<ID3D11Query> end;
+            /// The disjoint query giving the frequency of the timestamps
+            size_t disjointQuery;
+        };
+        /// A disjoint query, bracketing the outermost GPU timer and all the ones nested in it
+        struct GpuDisjointQuery
+        {
+            ComPtr<ID3D11Query> query;
+            /// Number of timers not released yet which depend on it
+            size_t refCount;
+        };
+        /// Pool of GPU timers, a timer handle being its index + 1
+        vector<GpuTimer>::type mGpuTimers;
+        /// Handles of the pooled GPU timers not in use
+        vector<uint32>::type mFreeGpuTimers;
+        vector<GpuDisjointQuery>::type mGpuDisjointQueries;
+        vector<size_t>::type mFreeGpuDisjointQueries;
+        /// Number of GPU timers begun but not ended yet
+        size_t mOpenGpuTimers;
+        /// The disjoint query open while mOpenGpuTimers isn't 0
+        size_t mCurrentGpuDisjointQuery;
+
+        /// Deletes the pooled GPU timers, pending ones become invalid
+        void destroyGpuTimers();
+
+        /// Event queries at the end of the frames queued to the GPU, oldest first
+        deque<ComPtr<ID3D11Query> >::type mFrameQueries;
+        /// Event queries of finished frames, for reuse
+        vector<ComPtr<ID3D11Query> >::type mFreeFrameQueries;
+
+        /// Passes the frame latency limit on to DXGI
+        void applyMaxFrameLatency();
+        /// @copydoc RenderSystem::limitFrameLatency
+        void limitFrameLatency(void);
+
+        /// Forgets the cached pipeline states, after the context they were bound to got reset
+        void invalidateBoundStates();
+
         ID3D11ShaderResourceView * mBoundTextures[OGRE_MAX_TEXTURE_LAYERS];
         size_t mBoundTexturesCount;
 
@@ -415,6 +467,21 @@ namespace Ogre
 
         /// @copydoc RenderSystem::markProfileEvent
         virtual void markProfileEvent( const String &eventName );
+
+        /// @copydoc RenderSystem::setMaxFrameLatency
+        virtual void setMaxFrameLatency(uint16 frames);
+
+        /// @copydoc RenderSystem::_beginGpuTimer
+        virtual uint32 _beginGpuTimer(void);
+
+        /// @copydoc RenderSystem::_endGpuTimer
+        virtual void _endGpuTimer(uint32 timer);
+
+        /// @copydoc RenderSystem::_getGpuTimerResult
+        virtual GpuTimerStatus _getGpuTimerResult(uint32 timer, uint64& elapsedNanosecs);
+
+        /// @copydoc RenderSystem::_releaseGpuTimer
+        virtual void _releaseGpuTimer(uint32 timer);
 		
 		/// @copydoc RenderSystem::setDrawBuffer
 		virtual bool setDrawBuffer(ColourBufferType colourBuffer);
@@ -66,6 +66,8 @@ namespace Ogre
         void getCustomAttribute( const String& name, void* pData );
         /** Overridden - see RenderTarget. */
         virtual void copyContentsToMemory(const Box& src, const PixelBox &dst, FrameBuffer buffer);
+        /** Overridden - see RenderTarget. */
+        virtual PixelReadbackPtr copyContentsToMemoryAsync(const Box& src, PixelFormat format, FrameBuffer buffer = FB_AUTO);
         bool requiresTextureFlipping() const                    { return false; }
 
         virtual bool _shouldRebindBackBuffer()                  { return false; }
@@ -202,6 +202,9 @@ namespace Ogre {
 
         virtual void getCustomAttribute( const String& name, void *pData );
 
+        /** Overridden - see RenderTarget. */
+        virtual PixelReadbackPtr copyContentsToMemoryAsync(const Box& src, PixelFormat format, FrameBuffer buffer = FB_AUTO);
+
         bool requiresTextureFlipping() const { return false; }
 
     protected:
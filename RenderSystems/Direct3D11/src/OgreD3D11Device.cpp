@@ -34,6 +34,7 @@ namespace Ogre
     D3D11Device::eExceptionsErrorLevel D3D11Device::mExceptionsErrorLevel = D3D11Device::D3D_NO_EXCEPTION;
     //---------------------------------------------------------------------
     D3D11Device::D3D11Device()
+        : mCurrentContext(NULL)
     {
         mDriverVersion.QuadPart = 0;
     }
@@ -56,12 +57,52 @@ namespace Ogre
 #endif
         mInfoQueue.Reset();
         mClassLinkage.Reset();
+        mPendingCommandLists.clear();
+        mDeferredContext.Reset();
+        mCurrentContext = NULL;
         mImmediateContext.Reset();
         mD3D11Device.Reset();
         mDXGIFactory.Reset();
         mDriverVersion.QuadPart = 0;
     }
     //---------------------------------------------------------------------
+    void D3D11Device::BeginDeferredRecording()
+    {
+        assert(!IsRecordingDeferred() && "Already recording on a deferred context");
+
+        if (!mDeferredContext)
+        {
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+            HRESULT hr = mD3D11Device->CreateDeferredContext(0, mDeferredContext.ReleaseAndGetAddressOf());
+#elif OGRE_PLATFORM == OGRE_PLATFORM_WINRT
+            HRESULT hr = mD3D11Device->CreateDeferredContext1(0, mDeferredContext.ReleaseAndGetAddressOf());
+#endif
+            throwIfFailed(hr, "Cannot create D3D11 deferred context", "D3D11Device::BeginDeferredRecording");
+        }
+
+        mCurrentContext = mDeferredContext.Get();
+    }
+    //---------------------------------------------------------------------
+    void D3D11Device::EndDeferredRecording()
+    {
+        assert(IsRecordingDeferred() && "Not recording on a deferred context");
+
+        ComPtr<ID3D11CommandList> commandList;
+        HRESULT hr = mDeferredContext->FinishCommandList(FALSE, commandList.GetAddressOf());
+        mCurrentContext = mImmediateContext.Get();
+        throwIfFailed(hr, "Cannot finish D3D11 command list", "D3D11Device::EndDeferredRecording");
+
+        mPendingCommandLists.push_back(commandList);
+    }
+    //---------------------------------------------------------------------
+    void D3D11Device::ExecuteDeferredCommandLists()
+    {
+        for (size_t i = 0; i < mPendingCommandLists.size(); ++i)
+            mImmediateContext->ExecuteCommandList(mPendingCommandLists[i].Get(), FALSE);
+
+        mPendingCommandLists.clear();
+    }
+    //---------------------------------------------------------------------
     void D3D11Device::TransferOwnership(ID3D11DeviceN* d3d11device)
     {
         assert(mD3D11Device.Get() != d3d11device);
@@ -93,6 +134,7 @@ namespace Ogre
 #elif OGRE_PLATFORM == OGRE_PLATFORM_WINRT
             mD3D11Device->GetImmediateContext1(mImmediateContext.ReleaseAndGetAddressOf());
 #endif
+            mCurrentContext = mImmediateContext.Get();
 
 #if OGRE_D3D11_PROFILING
             hr = mImmediateContext.As(&mPerf);
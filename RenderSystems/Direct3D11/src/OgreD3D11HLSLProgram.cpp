@@ -1081,6 +1081,9 @@ namespace Ogre {
         UINT memberCount = 0;
         UINT interCount = 0;
         UINT nameCount = 0;
+        // Without explicit register bindings the compiler assigns constant
+        // buffer slots in the order they are reflected
+        UINT cbufferSlot = 0;
 
         for(UINT b = 0; b < mConstantBufferNr; b++)
         {           
@@ -1125,8 +1128,32 @@ namespace Ogre {
             case D3D_CT_CBUFFER:
             case D3D_CT_TBUFFER:
                 {
-                    // Insert buffer info
-                    BufferInfoIterator it = mBufferInfoMap.insert(BufferInfo(0, mD3d11ShaderBufferDescs[b].Name)).first;
+                    // Insert buffer info, texture buffers don't take a constant buffer slot
+                    unsigned int slot = mD3d11ShaderBufferDescs[b].Type == D3D_CT_CBUFFER ? cbufferSlot++ : INVALID_IDX;
+                    const String bufferName = mD3d11ShaderBufferDescs[b].Name;
+                    BufferInfoIterator it = mBufferInfoMap.insert(BufferInfo(slot, bufferName)).first;
+
+                    // A constant buffer named after a shared parameter set uses the
+                    // buffer stored in the set, so it is only created and uploaded once
+                    const GpuProgramManager::SharedParametersMap& sharedParamsMap =
+                        GpuProgramManager::getSingleton().getAvailableSharedParameters();
+                    GpuProgramManager::SharedParametersMap::const_iterator sharedi = sharedParamsMap.find(bufferName);
+                    if (slot != INVALID_IDX && sharedi != sharedParamsMap.end() && it->mUniformBuffer.isNull())
+                    {
+                        it->mSharedParams = sharedi->second;
+                        const Any& sharedData = it->mSharedParams->_getRenderSystemData();
+                        if (sharedData.isEmpty())
+                        {
+                            it->mUniformBuffer = HardwareBufferManager::getSingleton().createUniformBuffer(mD3d11ShaderBufferDescs[b].Size, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, false, bufferName);
+                            it->mSharedParams->_setRenderSystemData(Any(it->mUniformBuffer));
+                            // Make sure the first program to use it uploads the contents
+                            it->mSharedParams->_markDirty();
+                        }
+                        else
+                        {
+                            it->mUniformBuffer = any_cast<HardwareUniformBufferSharedPtr>(sharedData);
+                        }
+                    }
 
                     // Guard to create uniform buffer only once
                     if (it->mUniformBuffer.isNull())
@@ -1295,32 +1322,6 @@ namespace Ogre {
     {
         // Call superclass method
         HighLevelGpuProgram::populateParameterNames(params);
-        
-        /*
-        // Construct uniform buffers for shared parameters, if any
-        // Also, construct uniform buffers for non-shared parameters (will be hosted inside program)
-        const GpuProgramParameters::GpuSharedParamUsageList& sharedParams = params->getSharedParameters();
-        GpuProgramParameters::GpuSharedParamUsageList::const_iterator it, end = sharedParams.end();
-        for (it = sharedParams.begin(); it != end; ++it)
-        {
-            ID3D11ShaderReflectionConstantBuffer* bufferInfo = mIShaderReflection->GetConstantBufferByName(it->getName().c_str());
-            if (!bufferInfo)
-            {
-
-            }
-
-            D3D11_SHADER_BUFFER_DESC bufferDesc;
-            bufferInfo->GetDesc(&bufferDesc);
-
-            HardwareUniformBufferSharedPtr uniformBuffer = 
-                        HardwareBufferManager::getSingleton()
-                                              .createUniformBuffer(bufferDesc.Size, 
-                                                                   HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, 
-                                                                   false, it->getName());
-            it->_setRenderSystemData(Any(uniformBuffer));
-        }
-        */
-
     }
     //-----------------------------------------------------------------------
     void D3D11HLSLProgram::processParamElement(String prefix, LPCSTR pName, ID3D11ShaderReflectionType* varRefType)
@@ -1937,124 +1938,182 @@ namespace Ogre {
         return it->second;
     }
     //-----------------------------------------------------------------------------
-    ID3D11Buffer* D3D11HLSLProgram::getConstantBuffer(GpuProgramParametersSharedPtr params, uint16 variabilityMask)
+    void D3D11HLSLProgram::getConstantBuffers(ID3D11Buffer** buffers, unsigned int& numBuffers,
+                                              GpuProgramParametersSharedPtr params, uint16 variabilityMask)
     {
-        // Update the Constant Buffer
-        
-		if(!mBufferInfoMap.empty())
+        numBuffers = 0;
+
+        // Update the Constant Buffers
+        BufferInfoIterator it = mBufferInfoMap.begin();
+        BufferInfoIterator end = mBufferInfoMap.end();
+        for (; it != end; ++it)
         {
-			BufferInfoIterator it = mBufferInfoMap.begin();
-            
-            if (!it->mUniformBuffer.isNull())
-            {
-                void* pMappedData = it->mUniformBuffer->lock(HardwareBuffer::HBL_DISCARD);
+            if (it->mUniformBuffer.isNull() || it->mIdx == INVALID_IDX)
+                continue;
 
-                // Only iterate through parsed variables (getting size of list)
-                void* src = 0;
-                ShaderVarWithPosInBuf* iter = &(it->mShaderVars[0]);
-                unsigned int lSize = it->mShaderVars.size();
-                for (size_t i = 0 ; i < lSize; i++, iter++)
-                {
-                    const GpuConstantDefinition& def = params->getConstantDefinition(iter->name);
-                    // Since we are mapping with write discard, contents of the buffer are undefined.
-                    // We must set every variable, even if it has not changed.
-                    //if (def.variability & variabilityMask)
-                    {
-                        if(def.isFloat())
-                        {
-                            src = (void *)&(*(params->getFloatConstantList().begin() + def.physicalIndex));
-                        }
-                        else if (def.isInt())
-                        {
-                            src = (void *)&(*(params->getIntConstantList().begin() + def.physicalIndex));
-                        }
+            if (it->mSharedParams.isNull())
+                updateConstantBuffer(*it, params.get(), variabilityMask);
+            else
+                updateSharedConstantBuffer(*it);
 
-                        else if (def.isUnsignedInt())
-                        {
-                            src = (void *)&(*(params->getUnsignedIntConstantList().begin() + def.physicalIndex));
-                        }
-                        else
-                        {
-                            OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
-                                        "Currently the only supported variables for Direct3D11 hlsl program are: 'float', 'int' and ' unsigned int'", 
-                                        "D3D11HLSLProgram::getConstantBuffer");
-                        }
-                        
+            // Add buffer to list at its slot
+            buffers[it->mIdx] = static_cast<D3D11HardwareUniformBuffer*>(it->mUniformBuffer.get())->getD3DConstantBuffer();
+            if (it->mIdx >= numBuffers)
+                numBuffers = it->mIdx + 1;
+        }
+    }
+    //-----------------------------------------------------------------------------
+    void D3D11HLSLProgram::updateConstantBuffer(const BufferInfo& info, const GpuProgramParameters* params, uint16 variabilityMask)
+    {
+        // Definitions are shared by all parameters created from this program,
+        // so only resolve the variable names again if they change
+        const GpuNamedConstants* namedConstants = &params->getConstantDefinitions();
+        if (info.mResolvedConstants != namedConstants)
+        {
+            ShaderVarsIter vi = info.mShaderVars.begin();
+            ShaderVarsIter viend = info.mShaderVars.end();
+            for (; vi != viend; ++vi)
+                vi->def = &params->getConstantDefinition(vi->name);
+            info.mResolvedConstants = namedConstants;
+            info.mLastParams = 0;
+        }
 
+        // The shadow only holds what was last written for the same parameters,
+        // anything else needs every variable rewritten
+        const size_t bufferSize = info.mUniformBuffer->getSizeInBytes();
+        if (info.mLastParams != params || info.mShadow.size() != bufferSize)
+        {
+            info.mShadow.resize(bufferSize);
+            info.mLastParams = params;
+            variabilityMask = (uint16)GPV_ALL;
+        }
 
-                        memcpy( &(((char *)(pMappedData))[iter->startOffset]), src , iter->size);
-                    }
+        // Only iterate through parsed variables (getting size of list)
+        bool dirty = false;
+        void* src = 0;
+        uint8* pShadow = &info.mShadow[0];
+        ShaderVarsIter iter = info.mShaderVars.begin();
+        ShaderVarsIter iterEnd = info.mShaderVars.end();
+        for (; iter != iterEnd; ++iter)
+        {
+            const GpuConstantDefinition& def = *iter->def;
+            if (def.variability & variabilityMask)
+            {
+                if(def.isFloat())
+                {
+                    src = (void *)&(*(params->getFloatConstantList().begin() + def.physicalIndex));
+                }
+                else if (def.isInt())
+                {
+                    src = (void *)&(*(params->getIntConstantList().begin() + def.physicalIndex));
                 }
 
-                it->mUniformBuffer->unlock();
+                else if (def.isUnsignedInt())
+                {
+                    src = (void *)&(*(params->getUnsignedIntConstantList().begin() + def.physicalIndex));
+                }
+                else
+                {
+                    OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+                                "Currently the only supported variables for Direct3D11 hlsl program are: 'float', 'int' and ' unsigned int'", 
+                                "D3D11HLSLProgram::updateConstantBuffer");
+                }
 
-                return static_cast<D3D11HardwareUniformBuffer*>(it->mUniformBuffer.get())->getD3DConstantBuffer();
+                if (memcmp(pShadow + iter->startOffset, src, iter->size) != 0)
+                {
+                    memcpy(pShadow + iter->startOffset, src, iter->size);
+                    dirty = true;
+                }
             }
         }
 
-        return NULL;
+        // Since we are mapping with write discard, contents of the buffer are undefined,
+        // so upload the whole shadow - but only when something actually changed.
+        // Command lists don't inherit dynamic buffer contents, so always upload there.
+        if (dirty || variabilityMask == (uint16)GPV_ALL || mDevice.IsRecordingDeferred())
+            info.mUniformBuffer->writeData(0, bufferSize, pShadow, true);
     }
     //-----------------------------------------------------------------------------
-    void D3D11HLSLProgram::getConstantBuffers(ID3D11Buffer** buffers, unsigned int& numBuffers,
-                                              ID3D11ClassInstance** classes, unsigned int& numClasses,
-                                              GpuProgramParametersSharedPtr params, uint16 variabilityMask)
+    void D3D11HLSLProgram::updateSharedConstantBuffer(const BufferInfo& info)
     {
-        // Update the Constant Buffers
-        BufferInfoIterator it = mBufferInfoMap.begin();
-        BufferInfoIterator end = mBufferInfoMap.end();
-        while (it != end)
+        GpuSharedParameters* sharedParams = info.mSharedParams.get();
+
+        // The buffer is shared by every program declaring it, so whichever
+        // program is bound first after a change does the upload.
+        // Command lists don't inherit dynamic buffer contents, so always upload there.
+        const bool resolved = info.mResolvedConstants && info.mSharedVersion == sharedParams->getVersion();
+        if (resolved && !sharedParams->isDirty() && !mDevice.IsRecordingDeferred())
+            return;
+
+        if (!resolved)
         {
-            if (!it->mUniformBuffer.isNull())
+            const GpuConstantDefinitionMap& sharedDefs = sharedParams->getConstantDefinitions().map;
+            ShaderVarsIter vi = info.mShaderVars.begin();
+            ShaderVarsIter viend = info.mShaderVars.end();
+            for (; vi != viend; ++vi)
             {
-                void* pMappedData = it->mUniformBuffer->lock(HardwareBuffer::HBL_DISCARD);
+                GpuConstantDefinitionMap::const_iterator defi = sharedDefs.find(vi->name);
+                vi->def = defi != sharedDefs.end() ? &defi->second : 0;
+            }
+            info.mResolvedConstants = &sharedParams->getConstantDefinitions();
+            info.mSharedVersion = sharedParams->getVersion();
+        }
 
-                // Only iterate through parsed variables (getting size of list)
-                void* src = 0;
-                ShaderVarWithPosInBuf* iter = &(it->mShaderVars[0]);
-                unsigned int lSize = it->mShaderVars.size();
-                for (size_t i = 0 ; i < lSize; i++, iter++)
+        const size_t bufferSize = info.mUniformBuffer->getSizeInBytes();
+        info.mShadow.resize(bufferSize);
+        uint8* pShadow = &info.mShadow[0];
+
+        const GpuSharedParameters& src = *sharedParams;
+        ShaderVarsConstIter iter = info.mShaderVars.begin();
+        ShaderVarsConstIter iterEnd = info.mShaderVars.end();
+        for (; iter != iterEnd; ++iter)
+        {
+            const GpuConstantDefinition* def = iter->def;
+            if (!def)
+                continue;
+
+            if (def->isFloat())
+            {
+                const float* pSrc = src.getFloatPointer(def->physicalIndex);
+                if (mColumnMajorMatrices && def->constType == GCT_MATRIX_4X4)
                 {
-                    const GpuConstantDefinition& def = params->getConstantDefinition(iter->name);
-                    // Since we are mapping with write discard, contents of the buffer are undefined.
-                    // We must set every variable, even if it has not changed.
-                    //if (def.variability & variabilityMask)
+                    // Shared parameters are never transposed, do it here like
+                    // GpuSharedParametersUsage would for the program's own parameters
+                    float* pDst = (float*)(pShadow + iter->startOffset);
+                    for (size_t i = 0; i < iter->size / (16 * sizeof(float)); ++i, pSrc += 16, pDst += 16)
                     {
-                        if(def.isFloat())
-                        {
-                            src = (void *)&(*(params->getFloatConstantList().begin() + def.physicalIndex));
-                        }
-                        else
-                        {
-                            src = (void *)&(*(params->getIntConstantList().begin() + def.physicalIndex));
-                        }
-
-                        memcpy( &(((char *)(pMappedData))[iter->startOffset]), src , iter->size);
+                        for (int row = 0; row < 4; ++row)
+                            for (int col = 0; col < 4; ++col)
+                                pDst[row * 4 + col] = pSrc[col * 4 + row];
                     }
+                    continue;
                 }
-
-                it->mUniformBuffer->unlock();
-
-                // Add buffer to list
-                buffers[numBuffers] = static_cast<D3D11HardwareUniformBuffer*>(it->mUniformBuffer.get())->getD3DConstantBuffer();
-                // Increment number of buffers
-                numBuffers++;
+                memcpy(pShadow + iter->startOffset, pSrc, iter->size);
+            }
+            else if (def->isInt())
+            {
+                memcpy(pShadow + iter->startOffset, src.getIntPointer(def->physicalIndex), iter->size);
+            }
+            else if (def->isUnsignedInt())
+            {
+                memcpy(pShadow + iter->startOffset, src.getUnsignedIntPointer(def->physicalIndex), iter->size);
             }
         }
 
-        // Update class instances
-        SlotIterator sit = mSlotMap.begin();
-        SlotIterator send = mSlotMap.end();
-        while (sit != send)
+        info.mUniformBuffer->writeData(0, bufferSize, pShadow, true);
+        sharedParams->_markClean();
+    }
+    //-----------------------------------------------------------------------------
+    bool D3D11HLSLProgram::hasSharedParamsBuffer(const GpuSharedParameters* sharedParams) const
+    {
+        BufferInfoMap::const_iterator it = mBufferInfoMap.begin();
+        BufferInfoMap::const_iterator end = mBufferInfoMap.end();
+        for (; it != end; ++it)
         {
-            // Get constant name
-            const GpuConstantDefinition& def = params->getConstantDefinition(sit->first);
-
-            // Set to correct slot
-            //classes[sit->second] = 
-            
-            // Increment class count
-            numClasses++;
+            if (it->mSharedParams.get() == sharedParams)
+                return true;
         }
+        return false;
     }
     //-----------------------------------------------------------------------------
     ID3D11VertexShader* D3D11HLSLProgram::getVertexShader(void) const 
@@ -2124,7 +2183,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     String D3D11HLSLProgram::getNameForMicrocodeCache()
     {
-        return mName + "_" + mTarget;
+        return mName + "_" + mTarget + "_" + StringConverter::toString(_getHash());
     }
 
 
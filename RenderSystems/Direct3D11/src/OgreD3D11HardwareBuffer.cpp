@@ -26,6 +26,7 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreD3D11HardwareBuffer.h"
+#include "OgreHardwareBufferManager.h"
 #include "OgreD3D11Mappings.h"
 #include "OgreD3D11Device.h"
 #include "OgreException.h"
@@ -40,7 +41,8 @@ namespace Ogre {
         mpTempStagingBuffer(0),
         mUseTempStagingBuffer(false),
         mBufferType(btype),
-        mDevice(device)
+        mDevice(device),
+        mMappedContext(NULL)
     {
         mSizeInBytes = sizeBytes;
         mDesc.ByteWidth = static_cast<UINT>(sizeBytes);
@@ -112,6 +114,10 @@ namespace Ogre {
     void* D3D11HardwareBuffer::lockImpl(size_t offset, 
         size_t length, LockOptions options)
     {
+        // Mapping, or copying to a staging buffer and mapping it, waits for the GPU
+        // if it is still using the buffer
+        LockWaitTimer waitTimer(this, length, options);
+
         if (length > mSizeInBytes)
         {
             // need to realloc
@@ -164,7 +170,10 @@ namespace Ogre {
             void * pRet = NULL;
             D3D11_MAPPED_SUBRESOURCE mappedSubResource;
             mappedSubResource.pData = NULL;
-            HRESULT hr = mDevice.GetImmediateContext()->Map(mlpD3DBuffer.Get(), 0, mapType, 0, &mappedSubResource);
+            // Discarding maps are allowed on deferred contexts, and must be recorded there
+            // to keep their order relative to the draws. Anything else needs the immediate one
+            mMappedContext = mapType == D3D11_MAP_WRITE_DISCARD ? mDevice.GetCurrentContext() : mDevice.GetImmediateContext();
+            HRESULT hr = mMappedContext->Map(mlpD3DBuffer.Get(), 0, mapType, 0, &mappedSubResource);
             if (FAILED(hr) || mDevice.isError())
             {
                 String msg = mDevice.getErrorDescription(hr);
@@ -181,21 +190,18 @@ namespace Ogre {
         else
         {
             mUseTempStagingBuffer = true;
-            if (!mpTempStagingBuffer)
-            {
-                // create another buffer instance but use system memory
-                mpTempStagingBuffer = new D3D11HardwareBuffer(mBufferType, 
-                    mSizeInBytes, mUsage, mDevice, true, false, false);
-            }
+            // staging buffers are pooled by the manager, and only hold the locked range
+            mpTempStagingBuffer = static_cast<D3D11HardwareBuffer*>(
+                HardwareBufferManager::getSingleton().allocateStagingBuffer(length));
 
             // schedule a copy to the staging
             if (options != HBL_DISCARD)
-                mpTempStagingBuffer->copyData(*this, 0, 0, mSizeInBytes, true);
+                mpTempStagingBuffer->copyData(*this, offset, 0, length, true);
 
             // register whether we'll need to upload on unlock
             mStagingUploadNeeded = (options != HBL_READ_ONLY);
 
-            return mpTempStagingBuffer->lock(offset, length, options);
+            return mpTempStagingBuffer->lock(0, length, options);
 
 
         }
@@ -214,16 +220,17 @@ namespace Ogre {
             // copy data if needed
             // this is async but driver should keep reference
             if (mStagingUploadNeeded)
-                copyData(*mpTempStagingBuffer, 0, 0, mSizeInBytes, true);
+                copyData(*mpTempStagingBuffer, 0, mLockStart, mLockSize, mLockSize == mSizeInBytes);
 
-            // delete
-            // not that efficient, but we should not be locking often
-            SAFE_DELETE(mpTempStagingBuffer);
+            // give it back to the pool, mapping it again waits for the copy if need be
+            HardwareBufferManager::getSingleton().releaseStagingBuffer(mpTempStagingBuffer);
+            mpTempStagingBuffer = 0;
         }
         else
         {
             // unmap
-            mDevice.GetImmediateContext()->Unmap(mlpD3DBuffer.Get(), 0);
+            mMappedContext->Unmap(mlpD3DBuffer.Get(), 0);
+            mMappedContext = NULL;
         }
     }
     //---------------------------------------------------------------------
@@ -277,15 +284,11 @@ namespace Ogre {
 		}
 	}
 	//---------------------------------------------------------------------
-	void D3D11HardwareBuffer::_updateFromShadow(void)
+	void D3D11HardwareBuffer::uploadFromShadow(size_t offset, size_t length)
 	{
-		if(mUseShadowBuffer && mShadowUpdated && !mSuppressHardwareUpdate)
-		{
-			bool discardWholeBuffer = mLockStart == 0 && mLockSize == mSizeInBytes;
-			copyDataImpl(*static_cast<D3D11HardwareBuffer*>(mShadowBuffer), mLockStart, mLockStart, mLockSize, discardWholeBuffer);
-			mShadowUpdated = false;
-        }
-    }
+		bool discardWholeBuffer = offset == 0 && length == mSizeInBytes;
+		copyDataImpl(*static_cast<D3D11HardwareBuffer*>(mShadowBuffer), offset, offset, length, discardWholeBuffer);
+	}
     //---------------------------------------------------------------------
     void D3D11HardwareBuffer::readData(size_t offset, size_t length, 
         void* pDest)
@@ -26,6 +26,7 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreD3D11HardwareBufferManager.h"
+#include "OgreD3D11HardwareBuffer.h"
 #include "OgreD3D11HardwareVertexBuffer.h"
 #include "OgreD3D11HardwareIndexBuffer.h"
 #include "OgreD3D11VertexDeclaration.h"
@@ -48,6 +49,12 @@ namespace Ogre {
 		destroyAllBindings();
 	}
 	//-----------------------------------------------------------------------
+	HardwareBuffer* D3D11HardwareBufferManagerBase::createStagingBufferImpl(size_t sizeInBytes)
+	{
+		return new D3D11HardwareBuffer(D3D11HardwareBuffer::VERTEX_BUFFER, sizeInBytes,
+			HardwareBuffer::HBU_DYNAMIC, mlpD3DDevice, true, false, false);
+	}
+	//-----------------------------------------------------------------------
 	HardwareVertexBufferSharedPtr
 		D3D11HardwareBufferManagerBase::
 		createVertexBuffer(size_t vertexSize, size_t numVerts, HardwareBuffer::Usage usage,
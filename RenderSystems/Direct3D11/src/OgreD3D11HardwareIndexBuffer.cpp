@@ -91,6 +91,12 @@ namespace Ogre {
         return mBufferImpl->isLocked();
     }
     //---------------------------------------------------------------------
+    void D3D11HardwareIndexBuffer::setOwnerName(const String& name)
+    {
+        HardwareIndexBuffer::setOwnerName(name);
+        mBufferImpl->setOwnerName(name);
+    }
+    //---------------------------------------------------------------------
     ID3D11Buffer * D3D11HardwareIndexBuffer::getD3DIndexBuffer( void ) const
     {
         return mBufferImpl->getD3DBuffer();
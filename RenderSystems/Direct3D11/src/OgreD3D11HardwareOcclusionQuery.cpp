@@ -74,14 +74,14 @@ namespace Ogre {
     //--
     void D3D11HardwareOcclusionQuery::beginOcclusionQuery() 
     {           
-        mDevice.GetImmediateContext()->Begin(mQuery.Get());//Issue(D3DISSUE_BEGIN); 
+        mDevice.GetCurrentContext()->Begin(mQuery.Get());//Issue(D3DISSUE_BEGIN); 
         mIsQueryResultStillOutstanding = true;
         mPixelCount = 0;
     }
 
     void D3D11HardwareOcclusionQuery::endOcclusionQuery() 
     { 
-        mDevice.GetImmediateContext()->End(mQuery.Get());//Issue(D3DISSUE_END); 
+        mDevice.GetCurrentContext()->End(mQuery.Get());//Issue(D3DISSUE_END); 
     }
 
     //------------------------------------------------------------------
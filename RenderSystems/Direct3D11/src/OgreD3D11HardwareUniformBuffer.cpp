@@ -92,6 +92,12 @@ namespace Ogre {
 		return mBufferImpl->isLocked();
 	}
 	//---------------------------------------------------------------------
+	void D3D11HardwareUniformBuffer::setOwnerName(const String& name)
+	{
+		HardwareUniformBuffer::setOwnerName(name);
+		mBufferImpl->setOwnerName(name);
+	}
+	//---------------------------------------------------------------------
 	ID3D11Buffer * D3D11HardwareUniformBuffer::getD3DConstantBuffer( void ) const
 	{
 		return mBufferImpl->getD3DBuffer();
@@ -94,6 +94,12 @@ namespace Ogre {
 		return mBufferImpl->isLocked();
 	}
 	//---------------------------------------------------------------------
+	void D3D11HardwareVertexBuffer::setOwnerName(const String& name)
+	{
+		HardwareVertexBuffer::setOwnerName(name);
+		mBufferImpl->setOwnerName(name);
+	}
+	//---------------------------------------------------------------------
     //---------------------------------------------------------------------
     ID3D11Buffer * D3D11HardwareVertexBuffer::getD3DVertexBuffer( void ) const
     {
@@ -0,0 +1,132 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreD3D11PixelReadback.h"
+#include "OgreD3D11Device.h"
+#include "OgreD3D11Mappings.h"
+#include "OgreException.h"
+
+namespace Ogre {
+    //---------------------------------------------------------------------
+    D3D11PixelReadback::D3D11PixelReadback(D3D11Device& device, ID3D11Texture2D* source, UINT subresource,
+                                           const Box& src, PixelFormat format)
+        : PixelReadback(src.getWidth(), src.getHeight(), format)
+        , mDevice(device)
+        , mReady(false)
+    {
+        D3D11_TEXTURE2D_DESC desc;
+        source->GetDesc( &desc );
+        mStagingFormat = desc.Format;
+
+        // Staging textures can't be multisampled
+        ComPtr<ID3D11Texture2D> sourceNoMSAA;
+        if(desc.SampleDesc.Count > 1)
+        {
+            D3D11_TEXTURE2D_DESC resolvedDesc = desc;
+            resolvedDesc.MipLevels = 1;
+            resolvedDesc.ArraySize = 1;
+            resolvedDesc.SampleDesc.Count = 1;
+            resolvedDesc.SampleDesc.Quality = 0;
+            resolvedDesc.Usage = D3D11_USAGE_DEFAULT;
+            resolvedDesc.BindFlags = 0;
+            resolvedDesc.CPUAccessFlags = 0;
+            resolvedDesc.MiscFlags = 0;
+
+            HRESULT hr = mDevice->CreateTexture2D(&resolvedDesc, NULL, sourceNoMSAA.ReleaseAndGetAddressOf());
+            mDevice.throwIfFailed(hr, "Error creating texture without MSAA", "D3D11PixelReadback::D3D11PixelReadback");
+
+            mDevice.GetImmediateContext()->ResolveSubresource(sourceNoMSAA.Get(), 0, source, subresource, desc.Format);
+            mDevice.throwIfFailed("Error resolving MSAA subresource", "D3D11PixelReadback::D3D11PixelReadback");
+
+            source = sourceNoMSAA.Get();
+            subresource = 0;
+        }
+
+        // Staging texture of the size of the copied box
+        D3D11_TEXTURE2D_DESC stagingDesc = desc;
+        stagingDesc.Width = mWidth;
+        stagingDesc.Height = mHeight;
+        stagingDesc.MipLevels = 1;
+        stagingDesc.ArraySize = 1;
+        stagingDesc.SampleDesc.Count = 1;
+        stagingDesc.SampleDesc.Quality = 0;
+        stagingDesc.Usage = D3D11_USAGE_STAGING;
+        stagingDesc.BindFlags = 0;
+        stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+        stagingDesc.MiscFlags = 0;
+
+        HRESULT hr = mDevice->CreateTexture2D(&stagingDesc, NULL, mStagingTexture.ReleaseAndGetAddressOf());
+        mDevice.throwIfFailed(hr, "Error creating staging texture", "D3D11PixelReadback::D3D11PixelReadback");
+
+        D3D11_BOX srcBoxDx11 = { src.left, src.top, 0, src.right, src.bottom, 1 };
+        mDevice.GetImmediateContext()->CopySubresourceRegion(
+            mStagingTexture.Get(), 0, 0, 0, 0, source, subresource, &srcBoxDx11);
+        mDevice.throwIfFailed("Error while copying to staging texture", "D3D11PixelReadback::D3D11PixelReadback");
+    }
+    //---------------------------------------------------------------------
+    D3D11PixelReadback::~D3D11PixelReadback()
+    {
+    }
+    //---------------------------------------------------------------------
+    bool D3D11PixelReadback::isReady(void)
+    {
+        if(mReady)
+            return true;
+
+        // Fails with DXGI_ERROR_WAS_STILL_DRAWING instead of waiting for the copy
+        D3D11_MAPPED_SUBRESOURCE mapped = {0};
+        HRESULT hr = mDevice.GetImmediateContext()->Map(mStagingTexture.Get(), 0, D3D11_MAP_READ,
+                                                        D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+        if(hr == DXGI_ERROR_WAS_STILL_DRAWING)
+            return false;
+        mDevice.throwIfFailed(hr, "Error while mapping staging texture", "D3D11PixelReadback::isReady");
+
+        mDevice.GetImmediateContext()->Unmap(mStagingTexture.Get(), 0);
+        mReady = true;
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void D3D11PixelReadback::read(const PixelBox& dst)
+    {
+        if(dst.getWidth() != mWidth || dst.getHeight() != mHeight || dst.getDepth() != 1)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid box.", "D3D11PixelReadback::read");
+        }
+
+        // Waits for the copy if it isn't done yet
+        D3D11_MAPPED_SUBRESOURCE mapped = {0};
+        HRESULT hr = mDevice.GetImmediateContext()->Map(mStagingTexture.Get(), 0, D3D11_MAP_READ, 0, &mapped);
+        mDevice.throwIfFailed(hr, "Error while mapping staging texture", "D3D11PixelReadback::read");
+
+        D3D11_BOX box = { 0, 0, 0, mWidth, mHeight, 1 };
+        PixelBox locked = D3D11Mappings::getPixelBoxWithMapping(box, mStagingFormat, mapped);
+        PixelUtil::bulkPixelConversion(locked, dst);
+
+        mDevice.GetImmediateContext()->Unmap(mStagingTexture.Get(), 0);
+        mReady = true;
+    }
+}
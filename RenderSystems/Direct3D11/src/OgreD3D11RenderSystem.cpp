@@ -133,6 +133,9 @@ namespace Ogre
         mRenderSystemWasInited = false;
         mSwitchingFullscreenCounter = 0;
         mDriverType = D3D_DRIVER_TYPE_HARDWARE;
+        mIndirectBufferSize = 0;
+        mOpenGpuTimers = 0;
+        mCurrentGpuDisjointQuery = 0;
 
         initRenderSystem();
 
@@ -310,6 +313,7 @@ namespace Ogre
         ConfigOption optAA;
         ConfigOption optFPUMode;
         ConfigOption optNVPerfHUD;
+        ConfigOption optDeferredContexts;
         ConfigOption optSRGB;
         ConfigOption optMinFeatureLevels;
         ConfigOption optMaxFeatureLevels;
@@ -384,6 +388,13 @@ namespace Ogre
         optNVPerfHUD.possibleValues.push_back( "Yes" );
         optNVPerfHUD.possibleValues.push_back( "No" );
 
+        // Record each _beginFrame / _endFrame span on a deferred context
+        optDeferredContexts.currentValue = "No";
+        optDeferredContexts.immutable = false;
+        optDeferredContexts.name = "Use Deferred Contexts";
+        optDeferredContexts.possibleValues.push_back( "Yes" );
+        optDeferredContexts.possibleValues.push_back( "No" );
+
         // SRGB on auto window
         optSRGB.name = "sRGB Gamma Conversion";
         optSRGB.possibleValues.push_back("Yes");
@@ -471,6 +482,7 @@ namespace Ogre
         mOptions[optAA.name] = optAA;
         mOptions[optFPUMode.name] = optFPUMode;
         mOptions[optNVPerfHUD.name] = optNVPerfHUD;
+        mOptions[optDeferredContexts.name] = optDeferredContexts;
         mOptions[optSRGB.name] = optSRGB;
         mOptions[optMinFeatureLevels.name] = optMinFeatureLevels;
         mOptions[optMaxFeatureLevels.name] = optMaxFeatureLevels;
@@ -581,6 +593,11 @@ namespace Ogre
                 mUseNVPerfHUD = false;
         }
 
+        if( name == "Use Deferred Contexts" )
+        {
+            mUseDeferredContexts = (value == "Yes");
+        }
+
         if (viewModeChanged || name == "Video Mode")
         {
             refreshFSAAOptions();
@@ -843,6 +860,15 @@ namespace Ogre
         mDevice.ReleaseAll();
         LogManager::getSingleton().logMessage("D3D11: Shutting down cleanly.");
         SAFE_DELETE( mTextureManager );
+
+        // Shared parameter sets outlive the buffer manager, release their constant buffers first
+        if (mGpuProgramManager)
+        {
+            const GpuProgramManager::SharedParametersMap& sharedParamsMap = mGpuProgramManager->getAvailableSharedParameters();
+            GpuProgramManager::SharedParametersMap::const_iterator i, iend = sharedParamsMap.end();
+            for (i = sharedParamsMap.begin(); i != iend; ++i)
+                i->second->_setRenderSystemData(Any());
+        }
         SAFE_DELETE( mHardwareBufferManager );
         SAFE_DELETE( mGpuProgramManager );
 
@@ -1121,6 +1147,10 @@ namespace Ogre
         rsc->setCapability(RSC_VERTEX_BUFFER_INSTANCE_DATA);
         rsc->setCapability(RSC_CAN_GET_COMPILED_SHADER_BUFFER);
 
+        // DrawIndexedInstancedIndirect with StartInstanceLocation needs feature level 11
+        if (mFeatureLevel >= D3D_FEATURE_LEVEL_11_0)
+            rsc->setCapability(RSC_MULTI_DRAW_INDIRECT);
+
         return rsc;
 
     }
@@ -1551,6 +1581,11 @@ namespace Ogre
                 HRESULT hr = mDevice->SetStreamSource(i, NULL, 0, 0);
             }
             */
+            mIndirectBuffer.Reset();
+            mIndirectBufferSize = 0;
+            destroyGpuTimers();
+            mFrameQueries.clear();
+            mFreeFrameQueries.clear();
             // Clean up depth stencil surfaces
             mDevice.ReleaseAll();
         }
@@ -1573,6 +1608,9 @@ namespace Ogre
         ID3D11DeviceN * device = createD3D11Device(d3dDriver, mDriverType, mMinRequestedFeatureLevel, mMaxRequestedFeatureLevel, &mFeatureLevel);
         mDevice.TransferOwnership(device);
 
+        if (mMaxFrameLatency)
+            applyMaxFrameLatency();
+
         LARGE_INTEGER driverVersion = mDevice.GetDriverVersion();
         mDriverVersion.major = HIWORD(driverVersion.HighPart);
         mDriverVersion.minor = LOWORD(driverVersion.HighPart);
@@ -2159,7 +2197,7 @@ namespace Ogre
         if (mActiveRenderTarget)
         {
             // we need to clear the state 
-            mDevice.GetImmediateContext()->ClearState();
+            mDevice.GetCurrentContext()->ClearState();
 
             if (mDevice.isError())
             {
@@ -2202,7 +2240,7 @@ namespace Ogre
             depthBuffer = static_cast<D3D11DepthBuffer*>(target->getDepthBuffer());
 
             // now switch to the new render target
-            mDevice.GetImmediateContext()->OMSetRenderTargets(
+            mDevice.GetCurrentContext()->OMSetRenderTargets(
                 numberOfViews,
                 pRTView,
                 depthBuffer ? depthBuffer->getDepthStencilView() : 0 );
@@ -2253,7 +2291,7 @@ namespace Ogre
             d3dvp.MinDepth = 0.0f;
             d3dvp.MaxDepth = 1.0f;
 
-            mDevice.GetImmediateContext()->RSSetViewports(1, &d3dvp);
+            mDevice.GetCurrentContext()->RSSetViewports(1, &d3dvp);
             if (mDevice.isError())
             {
                 String errorDescription = mDevice.getErrorDescription();
@@ -2284,10 +2322,42 @@ namespace Ogre
     
         if( !mActiveViewport )
             OGRE_EXCEPT( Exception::ERR_INTERNAL_ERROR, "Cannot begin frame - no viewport selected.", "D3D11RenderSystem::_beginFrame" );
+
+        if( mUseDeferredContexts && !mDevice.IsRecordingDeferred() )
+        {
+            mDevice.BeginDeferredRecording();
+
+            // The deferred context starts from the default state: forget the cached
+            // states and bind the render target & viewport again
+            invalidateBoundStates();
+            Viewport* vp = mActiveViewport;
+            mActiveViewport = NULL;
+            _setViewport( vp );
+        }
     }
     //---------------------------------------------------------------------
     void D3D11RenderSystem::_endFrame()
     {
+        if( mDevice.IsRecordingDeferred() )
+        {
+            mDevice.EndDeferredRecording();
+
+            // Executing the command list resets the immediate context state as well
+            mDevice.ExecuteDeferredCommandLists();
+            invalidateBoundStates();
+        }
+    }
+    //---------------------------------------------------------------------
+    void D3D11RenderSystem::invalidateBoundStates()
+    {
+        // Have _render create & bind every state object again on the next draw
+        mBoundBlendState.Reset();
+        mBoundRasterizer.Reset();
+        mBoundDepthStencilState.Reset();
+        mBlendDescChanged = true;
+        mRasterizerDescChanged = true;
+        mDepthStencilDescChanged = true;
+        mSamplerStatesChanged = true;
     }
     //---------------------------------------------------------------------
     void D3D11RenderSystem::setVertexDeclaration(VertexDeclaration* decl)
@@ -2320,7 +2390,7 @@ namespace Ogre
             UINT offset = 0; // no stream offset, this is handled in _render instead
             UINT slot = static_cast<UINT>(i->first);
             ID3D11Buffer * pVertexBuffers = d3d11buf->getD3DVertexBuffer();
-            mDevice.GetImmediateContext()->IASetVertexBuffers(
+            mDevice.GetCurrentContext()->IASetVertexBuffers(
                 slot, // The first input slot for binding.
                 1, // The number of vertex buffers in the array.
                 &pVertexBuffers,
@@ -2491,7 +2561,7 @@ namespace Ogre
         if (opState->mBlendState != mBoundBlendState)
         {
             mBoundBlendState = opState->mBlendState ;
-            mDevice.GetImmediateContext()->OMSetBlendState(opState->mBlendState.Get(), 0, 0xffffffff); // TODO - find out where to get the parameters
+            mDevice.GetCurrentContext()->OMSetBlendState(opState->mBlendState.Get(), 0, 0xffffffff); // TODO - find out where to get the parameters
             if (mDevice.isError())
             {
                 String errorDescription = mDevice.getErrorDescription();
@@ -2502,7 +2572,7 @@ namespace Ogre
             if (mSamplerStatesChanged && mBoundGeometryProgram && mBindingType == TextureUnitState::BT_GEOMETRY)
             {
                 {
-                    mDevice.GetImmediateContext()->GSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
+                    mDevice.GetCurrentContext()->GSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -2511,7 +2581,7 @@ namespace Ogre
                             "D3D11RenderSystem::_render");
                     }
                 }
-                mDevice.GetImmediateContext()->GSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
+                mDevice.GetCurrentContext()->GSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
                 if (mDevice.isError())
                 {
                     String errorDescription = mDevice.getErrorDescription();
@@ -2526,7 +2596,7 @@ namespace Ogre
         {
             mBoundRasterizer = opState->mRasterizer ;
 
-            mDevice.GetImmediateContext()->RSSetState(opState->mRasterizer.Get());
+            mDevice.GetCurrentContext()->RSSetState(opState->mRasterizer.Get());
             if (mDevice.isError())
             {
                 String errorDescription = mDevice.getErrorDescription();
@@ -2541,7 +2611,7 @@ namespace Ogre
         {
             mBoundDepthStencilState = opState->mDepthStencilState ;
 
-            mDevice.GetImmediateContext()->OMSetDepthStencilState(opState->mDepthStencilState.Get(), mStencilRef);
+            mDevice.GetCurrentContext()->OMSetDepthStencilState(opState->mDepthStencilState.Get(), mStencilRef);
             if (mDevice.isError())
             {
                 String errorDescription = mDevice.getErrorDescription();
@@ -2557,7 +2627,7 @@ namespace Ogre
             /// Pixel Shader binding
             {
                 {
-                    mDevice.GetImmediateContext()->PSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
+                    mDevice.GetCurrentContext()->PSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -2567,7 +2637,7 @@ namespace Ogre
                     }
                 }
 
-                mDevice.GetImmediateContext()->PSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
+                mDevice.GetCurrentContext()->PSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
                 if (mDevice.isError())
                 {
                     String errorDescription = mDevice.getErrorDescription();
@@ -2582,7 +2652,7 @@ namespace Ogre
             {
                 if (mFeatureLevel >= D3D_FEATURE_LEVEL_10_0)
                 {
-                    mDevice.GetImmediateContext()->VSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
+                    mDevice.GetCurrentContext()->VSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -2594,7 +2664,7 @@ namespace Ogre
 
                 if (mFeatureLevel >= D3D_FEATURE_LEVEL_10_0)
                 {
-                    mDevice.GetImmediateContext()->VSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
+                    mDevice.GetCurrentContext()->VSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -2610,7 +2680,7 @@ namespace Ogre
             {
                 if (mFeatureLevel >= D3D_FEATURE_LEVEL_10_0)
                 {
-                    mDevice.GetImmediateContext()->CSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
+                    mDevice.GetCurrentContext()->CSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -2622,7 +2692,7 @@ namespace Ogre
                 
                 if (mFeatureLevel >= D3D_FEATURE_LEVEL_10_0)
                 {
-                    mDevice.GetImmediateContext()->CSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
+                    mDevice.GetCurrentContext()->CSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -2638,7 +2708,7 @@ namespace Ogre
             {
                 if (mFeatureLevel >= D3D_FEATURE_LEVEL_10_0)
                 {
-                    mDevice.GetImmediateContext()->HSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
+                    mDevice.GetCurrentContext()->HSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -2650,7 +2720,7 @@ namespace Ogre
                 
                 if (mFeatureLevel >= D3D_FEATURE_LEVEL_10_0)
                 {
-                    mDevice.GetImmediateContext()->HSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
+                    mDevice.GetCurrentContext()->HSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -2666,7 +2736,7 @@ namespace Ogre
             {
                 if (mFeatureLevel >= D3D_FEATURE_LEVEL_10_0)
                 {
-                    mDevice.GetImmediateContext()->DSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
+                    mDevice.GetCurrentContext()->DSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -2678,7 +2748,7 @@ namespace Ogre
 
                 if (mFeatureLevel >= D3D_FEATURE_LEVEL_10_0)
                 {
-                    mDevice.GetImmediateContext()->DSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
+                    mDevice.GetCurrentContext()->DSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -2692,7 +2762,7 @@ namespace Ogre
 
         ComPtr<ID3D11Buffer> pSOTarget;
         // Mustn't bind a emulated vertex, pixel shader (see below), if we are rendering to a stream out buffer
-        mDevice.GetImmediateContext()->SOGetTargets(1, pSOTarget.GetAddressOf());
+        mDevice.GetCurrentContext()->SOGetTargets(1, pSOTarget.GetAddressOf());
 
         //check consistency of vertex-fragment shaders
         if (!mBoundVertexProgram ||
@@ -2734,7 +2804,7 @@ namespace Ogre
         // Also, bind shader resources
         if (mBoundVertexProgram)
         {
-            mDevice.GetImmediateContext()->VSSetShader(mBoundVertexProgram->getVertexShader(), 
+            mDevice.GetCurrentContext()->VSSetShader(mBoundVertexProgram->getVertexShader(), 
                                                        mClassInstances[GPT_VERTEX_PROGRAM], 
                                                        mNumClassInstances[GPT_VERTEX_PROGRAM]);
             if (mDevice.isError())
@@ -2747,7 +2817,7 @@ namespace Ogre
         }
         if (mBoundFragmentProgram)
         {
-            mDevice.GetImmediateContext()->PSSetShader(mBoundFragmentProgram->getPixelShader(),
+            mDevice.GetCurrentContext()->PSSetShader(mBoundFragmentProgram->getPixelShader(),
                                                        mClassInstances[GPT_FRAGMENT_PROGRAM], 
                                                        mNumClassInstances[GPT_FRAGMENT_PROGRAM]);
             if (mDevice.isError())
@@ -2760,7 +2830,7 @@ namespace Ogre
         }
         if (mBoundGeometryProgram)
         {
-            mDevice.GetImmediateContext()->GSSetShader(mBoundGeometryProgram->getGeometryShader(),
+            mDevice.GetCurrentContext()->GSSetShader(mBoundGeometryProgram->getGeometryShader(),
                                                        mClassInstances[GPT_GEOMETRY_PROGRAM], 
                                                        mNumClassInstances[GPT_GEOMETRY_PROGRAM]);
             if (mDevice.isError())
@@ -2773,7 +2843,7 @@ namespace Ogre
         }
         if (mBoundTessellationHullProgram)
         {
-            mDevice.GetImmediateContext()->HSSetShader(mBoundTessellationHullProgram->getHullShader(),
+            mDevice.GetCurrentContext()->HSSetShader(mBoundTessellationHullProgram->getHullShader(),
                                                        mClassInstances[GPT_HULL_PROGRAM], 
                                                        mNumClassInstances[GPT_HULL_PROGRAM]);
             if (mDevice.isError())
@@ -2786,7 +2856,7 @@ namespace Ogre
         }
         if (mBoundTessellationDomainProgram)
         {
-            mDevice.GetImmediateContext()->DSSetShader(mBoundTessellationDomainProgram->getDomainShader(),
+            mDevice.GetCurrentContext()->DSSetShader(mBoundTessellationDomainProgram->getDomainShader(),
                                                        mClassInstances[GPT_DOMAIN_PROGRAM], 
                                                        mNumClassInstances[GPT_DOMAIN_PROGRAM]);
             if (mDevice.isError())
@@ -2799,7 +2869,7 @@ namespace Ogre
         }
         if (mBoundComputeProgram)
         {
-            mDevice.GetImmediateContext()->CSSetShader(mBoundComputeProgram->getComputeShader(),
+            mDevice.GetCurrentContext()->CSSetShader(mBoundComputeProgram->getComputeShader(),
                                                        mClassInstances[GPT_COMPUTE_PROGRAM], 
                                                        mNumClassInstances[GPT_COMPUTE_PROGRAM]);
             if (mDevice.isError())
@@ -2824,13 +2894,13 @@ namespace Ogre
         if(mBoundComputeProgram)
         {
             // Bound unordered access views
-            mDevice.GetImmediateContext()->Dispatch(1, 1, 1);
+            mDevice.GetCurrentContext()->Dispatch(1, 1, 1);
 
             ID3D11UnorderedAccessView* views[] = { 0 };
             ID3D11ShaderResourceView* srvs[] = { 0 };
-            mDevice.GetImmediateContext()->CSSetShaderResources( 0, 1, srvs );
-            mDevice.GetImmediateContext()->CSSetUnorderedAccessViews( 0, 1, views, NULL );
-            mDevice.GetImmediateContext()->CSSetShader( NULL, NULL, 0 );
+            mDevice.GetCurrentContext()->CSSetShaderResources( 0, 1, srvs );
+            mDevice.GetCurrentContext()->CSSetUnorderedAccessViews( 0, 1, views, NULL );
+            mDevice.GetCurrentContext()->CSSetShader( NULL, NULL, 0 );
 
             return;
         }
@@ -2907,7 +2977,7 @@ namespace Ogre
             {
                 D3D11HardwareIndexBuffer* d3dIdxBuf = 
                     static_cast<D3D11HardwareIndexBuffer*>(op.indexData->indexBuffer.get());
-                mDevice.GetImmediateContext()->IASetIndexBuffer( d3dIdxBuf->getD3DIndexBuffer(), D3D11Mappings::getFormat(d3dIdxBuf->getType()), 0 );
+                mDevice.GetCurrentContext()->IASetIndexBuffer( d3dIdxBuf->getD3DIndexBuffer(), D3D11Mappings::getFormat(d3dIdxBuf->getType()), 0 );
                 if (mDevice.isError())
                 {
                     String errorDescription = mDevice.getErrorDescription();
@@ -2917,7 +2987,7 @@ namespace Ogre
                 }
             }
 
-            mDevice.GetImmediateContext()->IASetPrimitiveTopology( primType );
+            mDevice.GetCurrentContext()->IASetPrimitiveTopology( primType );
             if (mDevice.isError())
             {
                 String errorDescription = mDevice.getErrorDescription();
@@ -2926,13 +2996,27 @@ namespace Ogre
                     "D3D11RenderSystem::_render");
             }
 
+            if( op.numIndirectCommands )
+                uploadIndirectCommands( op );
+
             do
             {
                 if(op.useIndexes)
                 {
-                    if(hasInstanceData)
+                    if(op.numIndirectCommands)
                     {
-                        mDevice.GetImmediateContext()->DrawIndexedInstanced(
+                        // D3D11 has no multi-draw, but each draw still reads its arguments
+                        // from the GPU buffer uploaded once for the whole operation
+                        for(size_t i = 0; i < op.numIndirectCommands; ++i)
+                        {
+                            mDevice.GetCurrentContext()->DrawIndexedInstancedIndirect(
+                                mIndirectBuffer.Get(),
+                                static_cast<UINT>(i * sizeof(IndirectDrawCommand)));
+                        }
+                    }
+                    else if(hasInstanceData)
+                    {
+                        mDevice.GetCurrentContext()->DrawIndexedInstanced(
                             static_cast<UINT>(op.indexData->indexCount), 
                             static_cast<UINT>(numberOfInstances), 
                             static_cast<UINT>(op.indexData->indexStart), 
@@ -2941,7 +3025,7 @@ namespace Ogre
                     }
                     else
                     {
-                        mDevice.GetImmediateContext()->DrawIndexed(
+                        mDevice.GetCurrentContext()->DrawIndexed(
                             static_cast<UINT>(op.indexData->indexCount),
                             static_cast<UINT>(op.indexData->indexStart),
                             static_cast<INT>(op.vertexData->vertexStart));
@@ -2951,11 +3035,11 @@ namespace Ogre
                 {
                     if(op.vertexData->vertexCount == -1) // -1 is a sign to use DrawAuto
                     {
-                        mDevice.GetImmediateContext()->DrawAuto();
+                        mDevice.GetCurrentContext()->DrawAuto();
                     }
                     else if(hasInstanceData)
                     {
-                        mDevice.GetImmediateContext()->DrawInstanced(
+                        mDevice.GetCurrentContext()->DrawInstanced(
                             static_cast<UINT>(op.vertexData->vertexCount),
                             static_cast<UINT>(numberOfInstances),
                             static_cast<UINT>(op.vertexData->vertexStart),
@@ -2963,7 +3047,7 @@ namespace Ogre
                     }
                     else
                     {
-                        mDevice.GetImmediateContext()->Draw(
+                        mDevice.GetCurrentContext()->Draw(
                             static_cast<UINT>(op.vertexData->vertexCount),
                             static_cast<UINT>(op.vertexData->vertexStart));
                     }
@@ -2995,9 +3079,9 @@ namespace Ogre
         // Crashy : commented this, 99% sure it's useless but really time consuming
         /*if (true) // for now - clear the render state
         {
-            mDevice.GetImmediateContext()->OMSetBlendState(0, 0, 0xffffffff); 
-            mDevice.GetImmediateContext()->RSSetState(0);
-            mDevice.GetImmediateContext()->OMSetDepthStencilState(0, 0); 
+            mDevice.GetCurrentContext()->OMSetBlendState(0, 0, 0xffffffff); 
+            mDevice.GetCurrentContext()->RSSetState(0);
+            mDevice.GetCurrentContext()->OMSetDepthStencilState(0, 0); 
 //          mDevice->PSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(0), 0);
             
             // Clear class instance storage
@@ -3007,6 +3091,44 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
+    void D3D11RenderSystem::uploadIndirectCommands(const RenderOperation& op)
+    {
+        const size_t commandsSize = op.numIndirectCommands * sizeof(IndirectDrawCommand);
+
+        if (!mIndirectBuffer || mIndirectBufferSize < commandsSize)
+        {
+            D3D11_BUFFER_DESC desc;
+            ZeroMemory( &desc, sizeof(desc) );
+            desc.ByteWidth      = static_cast<UINT>(commandsSize);
+            desc.Usage          = D3D11_USAGE_DYNAMIC;
+            desc.BindFlags      = 0;
+            desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+            desc.MiscFlags      = D3D11_RESOURCE_MISC_DRAWINDIRECT_ARGS;
+
+            HRESULT hr = mDevice->CreateBuffer( &desc, NULL, mIndirectBuffer.ReleaseAndGetAddressOf() );
+            if (FAILED(hr) || mDevice.isError())
+            {
+                String msg = mDevice.getErrorDescription(hr);
+                OGRE_EXCEPT_EX(Exception::ERR_RENDERINGAPI_ERROR, hr,
+                    "Cannot create D3D11 indirect argument buffer: " + msg,
+                    "D3D11RenderSystem::uploadIndirectCommands");
+            }
+            mIndirectBufferSize = commandsSize;
+        }
+
+        D3D11_MAPPED_SUBRESOURCE mappedSubResource;
+        HRESULT hr = mDevice.GetCurrentContext()->Map(mIndirectBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSubResource);
+        if (FAILED(hr) || mDevice.isError())
+        {
+            String msg = mDevice.getErrorDescription(hr);
+            OGRE_EXCEPT_EX(Exception::ERR_RENDERINGAPI_ERROR, hr,
+                "Error calling Map: " + msg,
+                "D3D11RenderSystem::uploadIndirectCommands");
+        }
+        memcpy(mappedSubResource.pData, op.indirectCommands, commandsSize);
+        mDevice.GetCurrentContext()->Unmap(mIndirectBuffer.Get(), 0);
+    }
+    //---------------------------------------------------------------------
     void D3D11RenderSystem::_renderUsingReadBackAsTexture(unsigned int passNr, Ogre::String variableName, unsigned int StartSlot)
     {
         RenderTarget *target = mActiveRenderTarget;
@@ -3027,7 +3149,7 @@ namespace Ogre
                 D3D11DepthBuffer *depthBuffer = static_cast<D3D11DepthBuffer*>(target->getDepthBuffer());
 
                 // now switch to the new render target
-                mDevice.GetImmediateContext()->OMSetRenderTargets(
+                mDevice.GetCurrentContext()->OMSetRenderTargets(
                     numberOfViews,
                     pRTView,
                     depthBuffer->getDepthStencilView());
@@ -3040,18 +3162,18 @@ namespace Ogre
                         "D3D11RenderSystem::_renderUsingReadBackAsTexture");
                 }
                 
-                mDevice.GetImmediateContext()->ClearDepthStencilView(depthBuffer->getDepthStencilView(), D3D11_CLEAR_DEPTH, 1.0f, 0);
+                mDevice.GetCurrentContext()->ClearDepthStencilView(depthBuffer->getDepthStencilView(), D3D11_CLEAR_DEPTH, 1.0f, 0);
 
                 float ClearColor[4];
                 //D3D11Mappings::get(colour, ClearColor);
                 // Clear all views
                 mActiveRenderTarget->getCustomAttribute( "numberOfViews", &numberOfViews );
                 if( numberOfViews == 1 )
-                    mDevice.GetImmediateContext()->ClearRenderTargetView( pRTView[0], ClearColor );
+                    mDevice.GetCurrentContext()->ClearRenderTargetView( pRTView[0], ClearColor );
                 else
                 {
                     for( uint i = 0; i < numberOfViews; ++i )
-                        mDevice.GetImmediateContext()->ClearRenderTargetView( pRTView[i], ClearColor );
+                        mDevice.GetCurrentContext()->ClearRenderTargetView( pRTView[i], ClearColor );
                 }
 
             }
@@ -3074,12 +3196,12 @@ namespace Ogre
                 D3D11DepthBuffer *depthBuffer = static_cast<D3D11DepthBuffer*>(target->getDepthBuffer());
 
                 // now switch to the new render target
-                mDevice.GetImmediateContext()->OMSetRenderTargets(
+                mDevice.GetCurrentContext()->OMSetRenderTargets(
                     numberOfViews,
                     pRTView,
                     NULL);
 
-                mDevice.GetImmediateContext()->PSSetShaderResources(static_cast<UINT>(StartSlot), 1, mDSTResView.GetAddressOf());
+                mDevice.GetCurrentContext()->PSSetShaderResources(static_cast<UINT>(StartSlot), 1, mDSTResView.GetAddressOf());
                 if (mDevice.isError())
                 {
                     String errorDescription = mDevice.getErrorDescription();
@@ -3102,7 +3224,7 @@ namespace Ogre
                 uint numberOfViews;
                 target->getCustomAttribute( "numberOfViews", &numberOfViews );
 
-                mDevice.GetImmediateContext()->PSSetShaderResources(static_cast<UINT>(StartSlot), static_cast<UINT>(numberOfViews), NULL);
+                mDevice.GetCurrentContext()->PSSetShaderResources(static_cast<UINT>(StartSlot), static_cast<UINT>(numberOfViews), NULL);
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -3138,7 +3260,7 @@ namespace Ogre
 /*              ID3D11VertexShader * vsShaderToSet = mBoundVertexProgram->getVertexShader();
 
                 // set the shader
-                mDevice.GetImmediateContext()->VSSetShader(vsShaderToSet, NULL, 0);
+                mDevice.GetCurrentContext()->VSSetShader(vsShaderToSet, NULL, 0);
                 if (mDevice.isError())
                 {
                     String errorDescription = mDevice.getErrorDescription();
@@ -3153,7 +3275,7 @@ namespace Ogre
                 mBoundFragmentProgram = static_cast<D3D11HLSLProgram*>(prg);
 /*              ID3D11PixelShader* psShaderToSet = mBoundFragmentProgram->getPixelShader();
 
-                mDevice.GetImmediateContext()->PSSetShader(psShaderToSet, NULL, 0);
+                mDevice.GetCurrentContext()->PSSetShader(psShaderToSet, NULL, 0);
                 if (mDevice.isError())
                 {
                     String errorDescription = mDevice.getErrorDescription();
@@ -3168,7 +3290,7 @@ namespace Ogre
                 mBoundGeometryProgram = static_cast<D3D11HLSLProgram*>(prg);
 /*              ID3D11GeometryShader* gsShaderToSet = mBoundGeometryProgram->getGeometryShader();
 
-                mDevice.GetImmediateContext()->GSSetShader(gsShaderToSet, NULL, 0);
+                mDevice.GetCurrentContext()->GSSetShader(gsShaderToSet, NULL, 0);
                 if (mDevice.isError())
                 {
                     String errorDescription = mDevice.getErrorDescription();
@@ -3184,7 +3306,7 @@ namespace Ogre
                 mBoundTessellationHullProgram = static_cast<D3D11HLSLProgram*>(prg);
 /*              ID3D11HullShader* gsShaderToSet = mBoundTessellationHullProgram->getHullShader();
 
-                mDevice.GetImmediateContext()->HSSetShader(gsShaderToSet, NULL, 0);
+                mDevice.GetCurrentContext()->HSSetShader(gsShaderToSet, NULL, 0);
                 if (mDevice.isError())
                 {
                     String errorDescription = mDevice.getErrorDescription();
@@ -3200,7 +3322,7 @@ namespace Ogre
                 mBoundTessellationDomainProgram = static_cast<D3D11HLSLProgram*>(prg);
 /*              ID3D11DomainShader* gsShaderToSet = mBoundTessellationDomainProgram->getDomainShader();
 
-                mDevice.GetImmediateContext()->DSSetShader(gsShaderToSet, NULL, 0);
+                mDevice.GetCurrentContext()->DSSetShader(gsShaderToSet, NULL, 0);
                 if (mDevice.isError())
                 {
                     String errorDescription = mDevice.getErrorDescription();
@@ -3216,7 +3338,7 @@ namespace Ogre
                 mBoundComputeProgram = static_cast<D3D11HLSLProgram*>(prg);
 /*              ID3D11ComputeShader* gsShaderToSet = mBoundComputeProgram->getComputeShader();
 
-                mDevice.GetImmediateContext()->CSSetShader(gsShaderToSet, NULL, 0);
+                mDevice.GetCurrentContext()->CSSetShader(gsShaderToSet, NULL, 0);
                 if (mDevice.isError())
                 {
                     String errorDescription = mDevice.getErrorDescription();
@@ -3242,7 +3364,7 @@ namespace Ogre
                 mActiveVertexGpuProgramParameters.setNull();
                 mBoundVertexProgram = NULL;
                 //mDevice->VSSetShader(NULL);
-                mDevice.GetImmediateContext()->VSSetShader(NULL, NULL, 0);
+                mDevice.GetCurrentContext()->VSSetShader(NULL, NULL, 0);
             }
             break;
         case GPT_FRAGMENT_PROGRAM:
@@ -3250,7 +3372,7 @@ namespace Ogre
                 mActiveFragmentGpuProgramParameters.setNull();
                 mBoundFragmentProgram = NULL;
                 //mDevice->PSSetShader(NULL);
-                mDevice.GetImmediateContext()->PSSetShader(NULL, NULL, 0);
+                mDevice.GetCurrentContext()->PSSetShader(NULL, NULL, 0);
             }
 
             break;
@@ -3258,28 +3380,28 @@ namespace Ogre
             {
                 mActiveGeometryGpuProgramParameters.setNull();
                 mBoundGeometryProgram = NULL;
-                mDevice.GetImmediateContext()->GSSetShader( NULL, NULL, 0 );
+                mDevice.GetCurrentContext()->GSSetShader( NULL, NULL, 0 );
             }
             break;
         case GPT_HULL_PROGRAM:
             {
                 mActiveTessellationHullGpuProgramParameters.setNull();
                 mBoundTessellationHullProgram = NULL;
-                mDevice.GetImmediateContext()->HSSetShader( NULL, NULL, 0 );
+                mDevice.GetCurrentContext()->HSSetShader( NULL, NULL, 0 );
             }
             break;
         case GPT_DOMAIN_PROGRAM:
             {
                 mActiveTessellationDomainGpuProgramParameters.setNull();
                 mBoundTessellationDomainProgram = NULL;
-                mDevice.GetImmediateContext()->DSSetShader( NULL, NULL, 0 );
+                mDevice.GetCurrentContext()->DSSetShader( NULL, NULL, 0 );
             }
             break;
         case GPT_COMPUTE_PROGRAM:
             {
                 mActiveComputeGpuProgramParameters.setNull();
                 mBoundComputeProgram = NULL;
-                mDevice.GetImmediateContext()->CSSetShader( NULL, NULL, 0 );
+                mDevice.GetCurrentContext()->CSSetShader( NULL, NULL, 0 );
             }
             break;
         default:
@@ -3292,15 +3414,32 @@ namespace Ogre
     {
         if (mask & (uint16)GPV_GLOBAL)
         {
-            // TODO: Dx11 supports shared constant buffers, so use them
-            // check the match to constant buffers & use rendersystem data hooks to store
-            // for now, just copy
-            params->_copySharedParams();
+            D3D11HLSLProgram* program = NULL;
+            switch(gptype)
+            {
+            case GPT_VERTEX_PROGRAM: program = mBoundVertexProgram; break;
+            case GPT_FRAGMENT_PROGRAM: program = mBoundFragmentProgram; break;
+            case GPT_GEOMETRY_PROGRAM: program = mBoundGeometryProgram; break;
+            case GPT_HULL_PROGRAM: program = mBoundTessellationHullProgram; break;
+            case GPT_DOMAIN_PROGRAM: program = mBoundTessellationDomainProgram; break;
+            case GPT_COMPUTE_PROGRAM: program = mBoundComputeProgram; break;
+            }
+
+            // Shared sets the program declares as a constant buffer are uploaded once
+            // into that buffer, only copy the others into the program's own parameters
+            const GpuProgramParameters::GpuSharedParamUsageList& sharedParams = params->getSharedParameters();
+            GpuProgramParameters::GpuSharedParamUsageList::const_iterator i, iend = sharedParams.end();
+            for (i = sharedParams.begin(); i != iend; ++i)
+            {
+                if (!program || !program->hasSharedParamsBuffer(i->getSharedParams().get()))
+                    i->_copySharedParamsToTargetParams();
+            }
         }
 
         // Do everything here in Dx11, since deal with via buffers anyway so number of calls
         // is actually the same whether we categorise the updates or not
-        ID3D11Buffer* pBuffers[1] ;
+        ID3D11Buffer* pBuffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT] = { NULL };
+        unsigned int numBuffers = 0;
         switch(gptype)
         {
         case GPT_VERTEX_PROGRAM:
@@ -3309,8 +3448,8 @@ namespace Ogre
                 //{
                 if (mBoundVertexProgram)
                 {
-                    pBuffers[0] = mBoundVertexProgram->getConstantBuffer(params, mask);
-                    mDevice.GetImmediateContext()->VSSetConstantBuffers( 0, 1, pBuffers );
+                    mBoundVertexProgram->getConstantBuffers(pBuffers, numBuffers, params, mask);
+                    mDevice.GetCurrentContext()->VSSetConstantBuffers( 0, numBuffers, pBuffers );
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -3328,8 +3467,8 @@ namespace Ogre
                 //{
                 if (mBoundFragmentProgram)
                 {
-                    pBuffers[0] = mBoundFragmentProgram->getConstantBuffer(params, mask);
-                    mDevice.GetImmediateContext()->PSSetConstantBuffers( 0, 1, pBuffers );
+                    mBoundFragmentProgram->getConstantBuffers(pBuffers, numBuffers, params, mask);
+                    mDevice.GetCurrentContext()->PSSetConstantBuffers( 0, numBuffers, pBuffers );
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -3345,8 +3484,8 @@ namespace Ogre
             {
                 if (mBoundGeometryProgram)
                 {
-                    pBuffers[0] = mBoundGeometryProgram->getConstantBuffer(params, mask);
-                    mDevice.GetImmediateContext()->GSSetConstantBuffers( 0, 1, pBuffers );
+                    mBoundGeometryProgram->getConstantBuffers(pBuffers, numBuffers, params, mask);
+                    mDevice.GetCurrentContext()->GSSetConstantBuffers( 0, numBuffers, pBuffers );
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -3362,8 +3501,8 @@ namespace Ogre
             {
                 if (mBoundTessellationHullProgram)
                 {
-                    pBuffers[0] = mBoundTessellationHullProgram->getConstantBuffer(params, mask);
-                    mDevice.GetImmediateContext()->HSSetConstantBuffers( 0, 1, pBuffers );
+                    mBoundTessellationHullProgram->getConstantBuffers(pBuffers, numBuffers, params, mask);
+                    mDevice.GetCurrentContext()->HSSetConstantBuffers( 0, numBuffers, pBuffers );
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -3379,8 +3518,8 @@ namespace Ogre
             {
                 if (mBoundTessellationDomainProgram)
                 {
-                    pBuffers[0] = mBoundTessellationDomainProgram->getConstantBuffer(params, mask);
-                    mDevice.GetImmediateContext()->DSSetConstantBuffers( 0, 1, pBuffers );
+                    mBoundTessellationDomainProgram->getConstantBuffers(pBuffers, numBuffers, params, mask);
+                    mDevice.GetCurrentContext()->DSSetConstantBuffers( 0, numBuffers, pBuffers );
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -3396,8 +3535,8 @@ namespace Ogre
             {
                 if (mBoundComputeProgram)
                 {
-                    pBuffers[0] = mBoundComputeProgram->getConstantBuffer(params, mask);
-                    mDevice.GetImmediateContext()->CSSetConstantBuffers( 0, 1, pBuffers );
+                    mBoundComputeProgram->getConstantBuffers(pBuffers, numBuffers, params, mask);
+                    mDevice.GetCurrentContext()->CSSetConstantBuffers( 0, numBuffers, pBuffers );
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -3557,7 +3696,7 @@ namespace Ogre
         mScissorRect.right = static_cast<LONG>(right);
         mScissorRect.bottom =static_cast<LONG>( bottom);
 
-        mDevice.GetImmediateContext()->RSSetScissorRects(1, &mScissorRect);
+        mDevice.GetCurrentContext()->RSSetScissorRects(1, &mScissorRect);
         if (mDevice.isError())
         {
             String errorDescription = mDevice.getErrorDescription();
@@ -3587,11 +3726,11 @@ namespace Ogre
                 uint numberOfViews;
                 mActiveRenderTarget->getCustomAttribute( "numberOfViews", &numberOfViews );
                 if( numberOfViews == 1 )
-                    mDevice.GetImmediateContext()->ClearRenderTargetView( pRTView[0], ClearColor );
+                    mDevice.GetCurrentContext()->ClearRenderTargetView( pRTView[0], ClearColor );
                 else
                 {
                     for( uint i = 0; i < numberOfViews; ++i )
-                        mDevice.GetImmediateContext()->ClearRenderTargetView( pRTView[i], ClearColor );
+                        mDevice.GetCurrentContext()->ClearRenderTargetView( pRTView[i], ClearColor );
                 }
 
             }
@@ -3611,7 +3750,7 @@ namespace Ogre
                                                                                         getDepthBuffer());
                 if( depthBuffer )
                 {
-                    mDevice.GetImmediateContext()->ClearDepthStencilView(
+                    mDevice.GetCurrentContext()->ClearDepthStencilView(
                                                         depthBuffer->getDepthStencilView(),
                                                         ClearFlags, depth, static_cast<UINT8>(stencil) );
                 }
@@ -3860,6 +3999,7 @@ namespace Ogre
         mMaxRequestedFeatureLevel = D3D_FEATURE_LEVEL_11_0;
 #endif
         mUseNVPerfHUD = false;
+        mUseDeferredContexts = false;
         mHLSLProgramFactory = NULL;
 
 #if OGRE_NO_QUAD_BUFFER_STEREO == 0
@@ -3992,6 +4132,193 @@ namespace Ogre
 #endif
     }
     //---------------------------------------------------------------------
+    uint32 D3D11RenderSystem::_beginGpuTimer(void)
+    {
+        if (mDevice.isNull())
+            return 0;
+
+        D3D11_QUERY_DESC queryDesc;
+        queryDesc.MiscFlags = 0;
+
+        uint32 timer;
+        if (mFreeGpuTimers.empty())
+        {
+            GpuTimer newTimer;
+            queryDesc.Query = D3D11_QUERY_TIMESTAMP;
+            if (FAILED(mDevice->CreateQuery(&queryDesc, newTimer.begin.ReleaseAndGetAddressOf())) ||
+                FAILED(mDevice->CreateQuery(&queryDesc, newTimer.end.ReleaseAndGetAddressOf())))
+                return 0;
+            newTimer.disjointQuery = 0;
+            mGpuTimers.push_back(newTimer);
+            timer = static_cast<uint32>(mGpuTimers.size());
+        }
+        else
+        {
+            timer = mFreeGpuTimers.back();
+            mFreeGpuTimers.pop_back();
+        }
+
+        ID3D11DeviceContextN* context = mDevice.GetCurrentContext();
+
+        // Timestamps are only meaningful along with the frequency given by a disjoint query,
+        // which can't be nested. The outermost timer brackets one for all the timers within.
+        if (mOpenGpuTimers == 0)
+        {
+            if (mFreeGpuDisjointQueries.empty())
+            {
+                GpuDisjointQuery newQuery;
+                queryDesc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+                if (FAILED(mDevice->CreateQuery(&queryDesc, newQuery.query.ReleaseAndGetAddressOf())))
+                {
+                    mFreeGpuTimers.push_back(timer);
+                    return 0;
+                }
+                newQuery.refCount = 0;
+                mGpuDisjointQueries.push_back(newQuery);
+                mCurrentGpuDisjointQuery = mGpuDisjointQueries.size() - 1;
+            }
+            else
+            {
+                mCurrentGpuDisjointQuery = mFreeGpuDisjointQueries.back();
+                mFreeGpuDisjointQueries.pop_back();
+            }
+
+            context->Begin(mGpuDisjointQueries[mCurrentGpuDisjointQuery].query.Get());
+        }
+
+        ++mOpenGpuTimers;
+        ++mGpuDisjointQueries[mCurrentGpuDisjointQuery].refCount;
+
+        GpuTimer& gpuTimer = mGpuTimers[timer - 1];
+        gpuTimer.disjointQuery = mCurrentGpuDisjointQuery;
+        context->End(gpuTimer.begin.Get());
+        return timer;
+    }
+    //---------------------------------------------------------------------
+    void D3D11RenderSystem::_endGpuTimer(uint32 timer)
+    {
+        // The pool is dropped along with a lost device
+        if (timer > mGpuTimers.size() || mOpenGpuTimers == 0)
+            return;
+
+        ID3D11DeviceContextN* context = mDevice.GetCurrentContext();
+        context->End(mGpuTimers[timer - 1].end.Get());
+
+        if (--mOpenGpuTimers == 0)
+            context->End(mGpuDisjointQueries[mCurrentGpuDisjointQuery].query.Get());
+    }
+    //---------------------------------------------------------------------
+    RenderSystem::GpuTimerStatus D3D11RenderSystem::_getGpuTimerResult(uint32 timer, uint64& elapsedNanosecs)
+    {
+        if (timer > mGpuTimers.size())
+            return GTS_INVALID;
+
+        const GpuTimer& gpuTimer = mGpuTimers[timer - 1];
+        ID3D11DeviceContextN* context = mDevice.GetImmediateContext();
+
+        // Never flush, the queries get submitted along with the frame anyway
+        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjointData;
+        UINT64 begin = 0, end = 0;
+        if (context->GetData(mGpuDisjointQueries[gpuTimer.disjointQuery].query.Get(), &disjointData,
+                             sizeof(disjointData), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            context->GetData(gpuTimer.begin.Get(), &begin, sizeof(begin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            context->GetData(gpuTimer.end.Get(), &end, sizeof(end), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+            return GTS_PENDING;
+
+        _releaseGpuTimer(timer);
+
+        // The GPU changed clocks meanwhile
+        if (disjointData.Disjoint || disjointData.Frequency == 0)
+            return GTS_INVALID;
+
+        elapsedNanosecs = end > begin ? (uint64)((double)(end - begin) * 1000000000.0 / (double)disjointData.Frequency) : 0;
+        return GTS_AVAILABLE;
+    }
+    //---------------------------------------------------------------------
+    void D3D11RenderSystem::_releaseGpuTimer(uint32 timer)
+    {
+        if (timer > mGpuTimers.size())
+            return;
+
+        const size_t disjointQuery = mGpuTimers[timer - 1].disjointQuery;
+        if (--mGpuDisjointQueries[disjointQuery].refCount == 0)
+            mFreeGpuDisjointQueries.push_back(disjointQuery);
+
+        mFreeGpuTimers.push_back(timer);
+    }
+    //---------------------------------------------------------------------
+    void D3D11RenderSystem::setMaxFrameLatency(uint16 frames)
+    {
+        RenderSystem::setMaxFrameLatency(frames);
+        applyMaxFrameLatency();
+    }
+    //---------------------------------------------------------------------
+    void D3D11RenderSystem::applyMaxFrameLatency()
+    {
+        if (mDevice.isNull())
+            return;
+
+        // 0 restores the DXGI default of 3 frames
+        ComPtr<IDXGIDeviceN> pDXGIDevice;
+        if (SUCCEEDED(mDevice->QueryInterface(pDXGIDevice.GetAddressOf())))
+            pDXGIDevice->SetMaximumFrameLatency(mMaxFrameLatency);
+    }
+    //---------------------------------------------------------------------
+    void D3D11RenderSystem::limitFrameLatency(void)
+    {
+        if (mDevice.isNull())
+            return;
+
+        // DXGI only limits the frames queued by Present, the event queries
+        // also cover the frames of windows and targets which do not present.
+        if (mMaxFrameLatency)
+        {
+            ComPtr<ID3D11Query> query;
+            if (mFreeFrameQueries.empty())
+            {
+                D3D11_QUERY_DESC queryDesc;
+                queryDesc.Query = D3D11_QUERY_EVENT;
+                queryDesc.MiscFlags = 0;
+                if (FAILED(mDevice->CreateQuery(&queryDesc, query.ReleaseAndGetAddressOf())))
+                    return;
+            }
+            else
+            {
+                query = mFreeFrameQueries.back();
+                mFreeFrameQueries.pop_back();
+            }
+
+            mDevice.GetImmediateContext()->End(query.Get());
+            mFrameQueries.push_back(query);
+        }
+
+        // Wait until the GPU finished the frames beyond the limit
+        while (mFrameQueries.size() > mMaxFrameLatency)
+        {
+            if (mMaxFrameLatency)
+            {
+                BOOL done = FALSE;
+                HRESULT hr;
+                do
+                {
+                    hr = mDevice.GetImmediateContext()->GetData(mFrameQueries.front().Get(), &done, sizeof(done), 0);
+                } while (hr == S_FALSE);
+            }
+
+            mFreeFrameQueries.push_back(mFrameQueries.front());
+            mFrameQueries.pop_front();
+        }
+    }
+    //---------------------------------------------------------------------
+    void D3D11RenderSystem::destroyGpuTimers()
+    {
+        mGpuTimers.clear();
+        mFreeGpuTimers.clear();
+        mGpuDisjointQueries.clear();
+        mFreeGpuDisjointQueries.clear();
+        mOpenGpuTimers = 0;
+    }
+    //---------------------------------------------------------------------
     void D3D11RenderSystem::markProfileEvent( const String &eventName )
     {
 #if OGRE_D3D11_PROFILING
@@ -140,7 +140,7 @@ namespace Ogre {
         UINT offset[1] = { 0 };
         ID3D11Buffer* iBuffer[1];
         iBuffer[0] = vertexBuffer->getD3DVertexBuffer();
-        mDevice.GetImmediateContext()->SOSetTargets( 1, iBuffer, offset );
+        mDevice.GetCurrentContext()->SOSetTargets( 1, iBuffer, offset );
 
         if (r2vbPass->hasVertexProgram())
         {
@@ -154,7 +154,7 @@ namespace Ogre {
         }
 
         // Remove fragment program
-        mDevice.GetImmediateContext()->PSSetShader(NULL, NULL, 0);
+        mDevice.GetCurrentContext()->PSSetShader(NULL, NULL, 0);
 
         targetRenderSystem->_render(renderOp);  
 
@@ -168,7 +168,7 @@ namespace Ogre {
 
         // Remove stream output buffer 
         iBuffer[0]=NULL;
-        mDevice.GetImmediateContext()->SOSetTargets( 1, iBuffer, offset );
+        mDevice.GetCurrentContext()->SOSetTargets( 1, iBuffer, offset );
         //Clear the reset flag
         mResetRequested = false;
 
@@ -38,6 +38,7 @@ THE SOFTWARE.
 #include "OgreHardwarePixelBuffer.h"
 #if OGRE_NO_QUAD_BUFFER_STEREO == 0
 #include "OgreD3D11StereoDriverBridge.h"
+#include "OgreD3D11PixelReadback.h"
 #endif
 #include <iomanip>
 
@@ -404,6 +405,30 @@ namespace Ogre
 
         // Release the staging texture
         mDevice.GetImmediateContext()->Unmap(stagingTexture.Get(), srcSubresource);
+    }
+    //---------------------------------------------------------------------
+    PixelReadbackPtr D3D11RenderWindowBase::copyContentsToMemoryAsync(const Box& src, PixelFormat format, FrameBuffer buffer)
+    {
+        if(src.right > mWidth || src.bottom > mHeight || src.front != 0 || src.back != 1)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid box.", "D3D11RenderWindowBase::copyContentsToMemoryAsync");
+        }
+
+        if(!mpBackBuffer)
+            return RenderWindow::copyContentsToMemoryAsync(src, format, buffer);
+
+        // Resolve into mpBackBufferNoMSAA if there is one, the readback resolves otherwise
+        ID3D11Texture2D* source = mpBackBuffer.Get();
+        D3D11_TEXTURE2D_DESC BBDesc;
+        mpBackBuffer->GetDesc( &BBDesc );
+        if(BBDesc.SampleDesc.Count > 1 && mpBackBufferNoMSAA)
+        {
+            mDevice.GetImmediateContext()->ResolveSubresource(mpBackBufferNoMSAA.Get(), 0, mpBackBuffer.Get(), 0, BBDesc.Format);
+            mDevice.throwIfFailed("Error resolving MSAA subresource", "D3D11RenderWindowBase::copyContentsToMemoryAsync");
+            source = mpBackBufferNoMSAA.Get();
+        }
+
+        return PixelReadbackPtr(OGRE_NEW D3D11PixelReadback(mDevice, source, 0, src, format));
     }
 	//---------------------------------------------------------------------
 #if OGRE_NO_QUAD_BUFFER_STEREO == 0
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "OgreD3D11Mappings.h"
 #include "OgreD3D11Device.h"
 #include "OgreD3D11RenderSystem.h"
+#include "OgreD3D11PixelReadback.h"
 #include "OgreRoot.h"
 #include "OgreLogManager.h"
 #include "OgreException.h"
@@ -186,23 +187,16 @@ namespace Ogre
             
             //  if ( pos != String::npos )
             //      ext = mName.substr(pos+1);
-            vector<Image>::type images(6);
+            vector<Image>::type images;
             ConstImagePtrList imagePtrs;
-            static const String suffixes[6] = {"_rt", "_lf", "_up", "_dn", "_fr", "_bk"};
 
             assert(loadedStreams->size()==6);
+            // The faces are independent, decode them in parallel
+            vector<DataStreamPtr>::type streams(loadedStreams->begin(), loadedStreams->end());
+            Image::loadParallel(images, streams, ext);
+
             for(size_t i = 0; i < 6; i++)
             {
-                String fullName = baseName + suffixes[i];
-                if (!ext.empty())
-                    fullName = fullName + "." + ext;
-
-                // find & load resource data intro stream to allow resource
-                // group changes if required
-                DataStreamPtr stream((*loadedStreams)[i]);
-
-                images[i].load(stream, ext);
-
                 uint32 imageMips = images[i].getNumMipmaps();
 
                 if(imageMips < mNumMipmaps) {
@@ -1115,6 +1109,24 @@ namespace Ogre
         RenderTexture::getCustomAttribute(name, pData);
     }
     //---------------------------------------------------------------------
+    PixelReadbackPtr D3D11RenderTexture::copyContentsToMemoryAsync(const Box& src, PixelFormat format, FrameBuffer buffer)
+    {
+        if(src.right > mWidth || src.bottom > mHeight || src.front != 0 || src.back != 1)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid box.", "D3D11RenderTexture::copyContentsToMemoryAsync");
+        }
+
+        D3D11HardwarePixelBuffer* pixelBuffer = static_cast<D3D11HardwarePixelBuffer*>(mBuffer);
+        ID3D11Texture2D* source = pixelBuffer->getParentTexture()->GetTex2D();
+
+        // Slices of volume textures are copied synchronously
+        if(!source)
+            return RenderTexture::copyContentsToMemoryAsync(src, format, buffer);
+
+        return PixelReadbackPtr(OGRE_NEW D3D11PixelReadback(mDevice, source,
+            pixelBuffer->getSubresourceIndex(mZOffset), src, format));
+    }
+    //---------------------------------------------------------------------
     D3D11RenderTexture::D3D11RenderTexture( const String &name, D3D11HardwarePixelBuffer *buffer, uint32 zoffset, D3D11Device & device )
         : RenderTexture(buffer, zoffset)
         , mDevice(device)
@@ -106,6 +106,8 @@ namespace Ogre {
 
         void getMicrocodeFromCache( IDirect3DDevice9* d3d9Device );
         void compileMicrocode( IDirect3DDevice9* d3d9Device );
+        /** Gets the name of the program in the microcode cache. */
+        String getNameForMicrocodeCache();
     };
 
     /** Direct3D implementation of low-level vertex programs. */
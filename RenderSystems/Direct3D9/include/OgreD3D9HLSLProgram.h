@@ -167,6 +167,8 @@ namespace Ogre {
         /** Compiles the microcode from the program source. */
         void compileMicrocode(void);
         void addMicrocodeToCache();
+        /** Gets the name of the program in the microcode cache. */
+        String getNameForMicrocodeCache();
     public:
         D3D9HLSLProgram(ResourceManager* creator, const String& name, ResourceHandle handle,
             const String& group, bool isManual, ManualResourceLoader* loader);
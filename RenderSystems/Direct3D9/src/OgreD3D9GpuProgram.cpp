@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgreResourceGroupManager.h"
 #include "OgreD3D9RenderSystem.h"
 #include "OgreGpuProgramManager.h"
+#include "OgreStringConverter.h"
 
 namespace Ogre {
 
@@ -167,7 +168,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
    void D3D9GpuProgram::loadFromSource( IDirect3DDevice9* d3d9Device )
     {
-        if ( GpuProgramManager::getSingleton().isMicrocodeAvailableInCache(mName) )
+        if ( GpuProgramManager::getSingleton().isMicrocodeAvailableInCache(getNameForMicrocodeCache()) )
         {
             getMicrocodeFromCache( d3d9Device );
         }
@@ -177,10 +178,15 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    String D3D9GpuProgram::getNameForMicrocodeCache()
+    {
+        return mName + "_" + StringConverter::toString(_getHash());
+    }
+    //-----------------------------------------------------------------------------
     void D3D9GpuProgram::getMicrocodeFromCache( IDirect3DDevice9* d3d9Device )
     {
         GpuProgramManager::Microcode cacheMicrocode = 
-            GpuProgramManager::getSingleton().getMicrocodeFromCache(mName);
+            GpuProgramManager::getSingleton().getMicrocodeFromCache(getNameForMicrocodeCache());
         
         LPD3DXBUFFER microcode;
         HRESULT hr=D3DXCreateBuffer(cacheMicrocode->size(), &microcode); 
@@ -234,7 +240,7 @@ namespace Ogre {
                 memcpy(newMicrocode->getPtr(), microcode->GetBufferPointer(), microcode->GetBufferSize());
 
                 // add to the microcode to the cache
-                GpuProgramManager::getSingleton().addMicrocodeToCache(mName, newMicrocode);
+                GpuProgramManager::getSingleton().addMicrocodeToCache(getNameForMicrocodeCache(), newMicrocode);
             }
         }
 
@@ -88,7 +88,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void D3D9HLSLProgram::loadFromSource(void)
     {
-        if ( GpuProgramManager::getSingleton().isMicrocodeAvailableInCache(String("D3D9_HLSL_") + mName) )
+        if ( GpuProgramManager::getSingleton().isMicrocodeAvailableInCache(getNameForMicrocodeCache()) )
         {
             getMicrocodeFromCache();
         }
@@ -101,7 +101,7 @@ namespace Ogre {
     void D3D9HLSLProgram::getMicrocodeFromCache(void)
     {
         GpuProgramManager::Microcode cacheMicrocode = 
-            GpuProgramManager::getSingleton().getMicrocodeFromCache(String("D3D9_HLSL_") + mName);
+            GpuProgramManager::getSingleton().getMicrocodeFromCache(getNameForMicrocodeCache());
         
         cacheMicrocode->seek(0);
 
@@ -316,10 +316,15 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    String D3D9HLSLProgram::getNameForMicrocodeCache()
+    {
+        return "D3D9_HLSL_" + mName + "_" + StringConverter::toString(_getHash());
+    }
+    //-----------------------------------------------------------------------
     void D3D9HLSLProgram::addMicrocodeToCache()
     {
         // add to the microcode to the cache
-        String name = String("D3D9_HLSL_") + mName;
+        String name = getNameForMicrocodeCache();
 
         size_t sizeOfBuffer = sizeof(size_t) + mMicroCode->GetBufferSize() + sizeof(size_t) + mParametersMapSizeAsBuffer;
         
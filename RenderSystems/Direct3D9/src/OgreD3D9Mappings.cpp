@@ -568,6 +568,18 @@ namespace Ogre
         case VET_UBYTE4:
             return D3DDECLTYPE_UBYTE4;
             break;
+        case VET_HALF2:
+            return D3DDECLTYPE_FLOAT16_2;
+            break;
+        case VET_HALF4:
+            return D3DDECLTYPE_FLOAT16_4;
+            break;
+        case VET_SHORT2_NORM:
+            return D3DDECLTYPE_SHORT2N;
+            break;
+        case VET_SHORT4_NORM:
+            return D3DDECLTYPE_SHORT4N;
+            break;
         }
         // to keep compiler happy
         return D3DDECLTYPE_FLOAT3;
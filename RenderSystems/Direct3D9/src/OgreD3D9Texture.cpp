@@ -609,14 +609,15 @@ namespace Ogre
             if ( pos != String::npos )
                 ext = mName.substr(pos+1);
 
-            vector<Image>::type images(6);
+            vector<Image>::type images;
             ConstImagePtrList imagePtrs;
 
+            // The faces are independent, decode them in parallel
+            vector<DataStreamPtr>::type streams(loadedStreams->begin(), loadedStreams->end());
+            Image::loadParallel(images, streams, ext);
+
             for(size_t i = 0; i < 6; i++)
             {
-                DataStreamPtr stream((*loadedStreams)[i]);
-                images[i].load(stream, ext);
-
                 imagePtrs.push_back(&images[i]);
             }
 
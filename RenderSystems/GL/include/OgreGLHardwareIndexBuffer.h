@@ -59,7 +59,7 @@ namespace Ogre {
         void writeData(size_t offset, size_t length, 
             const void* pSource, bool discardWholeBuffer = false);
         /** See HardwareBuffer. */
-        void _updateFromShadow(void);
+        void uploadFromShadow(size_t offset, size_t length);
 
         GLuint getGLBufferId(void) const { return mBufferId; }
     };
@@ -100,6 +100,8 @@ namespace Ogre {
         static CustomAttribute msCustomAttributes[];
 
         String getCombinedName();       
+        /// Name of the linked program in the microcode cache
+        String getNameForMicrocodeCache();
         /// Compiles and links the the vertex and fragment programs
         void compileAndLink();
         /// Get the the binary data of a program from the microcode cache
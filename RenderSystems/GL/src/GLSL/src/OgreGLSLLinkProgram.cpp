@@ -148,7 +148,7 @@ namespace Ogre {
             }
 
             if ( GpuProgramManager::getSingleton().canGetCompiledShaderBuffer() &&
-                 GpuProgramManager::getSingleton().isMicrocodeAvailableInCache(getCombinedName()) )
+                 GpuProgramManager::getSingleton().isMicrocodeAvailableInCache(getNameForMicrocodeCache()) )
             {
                 getMicrocodeFromCache();
             }
@@ -183,7 +183,7 @@ namespace Ogre {
     void GLSLLinkProgram::getMicrocodeFromCache(void)
     {
         GpuProgramManager::Microcode cacheMicrocode = 
-            GpuProgramManager::getSingleton().getMicrocodeFromCache(getCombinedName());
+            GpuProgramManager::getSingleton().getMicrocodeFromCache(getNameForMicrocodeCache());
         
         GLenum binaryFormat = *((GLenum *)(cacheMicrocode->getPtr()));
         uint8 * programBuffer = cacheMicrocode->getPtr() + sizeof(GLenum);
@@ -485,8 +485,23 @@ namespace Ogre {
         return name;
     }
     //-----------------------------------------------------------------------
+    String GLSLLinkProgram::getNameForMicrocodeCache()
+    {
+        // Changed programs must not be given an old binary
+        uint32 hash = 0;
+        if (mVertexProgram)
+            hash = mVertexProgram->getGLSLProgram()->_getHash(hash);
+        if (mFragmentProgram)
+            hash = mFragmentProgram->getGLSLProgram()->_getHash(hash);
+        if (mGeometryProgram)
+            hash = mGeometryProgram->getGLSLProgram()->_getHash(hash);
+        return getCombinedName() + "_" + StringConverter::toString(hash);
+    }
+    //-----------------------------------------------------------------------
     void GLSLLinkProgram::compileAndLink()
     {
+        GpuProgramManager::CompileTimer timer(GpuProgramManager::CS_LINK, getCombinedName());
+
         if (mVertexProgram)
         {
             // compile and attach Vertex Program
@@ -605,7 +620,7 @@ namespace Ogre {
             {
                 // add to the microcode to the cache
                 String name;
-                name = getCombinedName();
+                name = getNameForMicrocodeCache();
 
                 // get buffer size
                 GLint binaryLength = 0;
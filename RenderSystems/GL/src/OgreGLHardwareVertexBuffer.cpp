@@ -240,28 +240,24 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
-    void GLHardwareVertexBuffer::_updateFromShadow(void)
+    void GLHardwareVertexBuffer::uploadFromShadow(size_t offset, size_t length)
     {
-        if (mUseShadowBuffer && mShadowUpdated && !mSuppressHardwareUpdate)
-        {
-            const void *srcData = mShadowBuffer->lock(
-                mLockStart, mLockSize, HBL_READ_ONLY);
-
-            static_cast<GLHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_ARRAY_BUFFER_ARB, mBufferId);
+        const void *srcData = mShadowBuffer->lock(
+            offset, length, HBL_READ_ONLY);
 
-            // Update whole buffer if possible, otherwise normal
-            if (mLockStart == 0 && mLockSize == mSizeInBytes)
-            {
-                glBufferDataARB(GL_ARRAY_BUFFER_ARB, mSizeInBytes, srcData,
-                    GLHardwareBufferManager::getGLUsage(mUsage));
-            }
-            else
-            {
-                glBufferSubDataARB(GL_ARRAY_BUFFER_ARB, mLockStart, mLockSize, srcData);
-            }
+        static_cast<GLHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_ARRAY_BUFFER_ARB, mBufferId);
 
-            mShadowBuffer->unlock();
-            mShadowUpdated = false;
+        // Update whole buffer if possible, otherwise normal
+        if (offset == 0 && length == mSizeInBytes)
+        {
+            glBufferDataARB(GL_ARRAY_BUFFER_ARB, mSizeInBytes, srcData,
+                GLHardwareBufferManager::getGLUsage(mUsage));
         }
+        else
+        {
+            glBufferSubDataARB(GL_ARRAY_BUFFER_ARB, offset, length, srcData);
+        }
+
+        mShadowBuffer->unlock();
     }
 }
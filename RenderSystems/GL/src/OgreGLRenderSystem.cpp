@@ -3586,6 +3586,10 @@ namespace Ogre {
                 typeCount = 4;
                 normalised = GL_TRUE;
                 break;
+            case VET_SHORT2_NORM:
+            case VET_SHORT4_NORM:
+                normalised = GL_TRUE;
+                break;
             default:
                 break;
             };
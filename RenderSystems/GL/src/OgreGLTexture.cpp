@@ -324,8 +324,7 @@ namespace Ogre {
             }
             else
             {
-                vector<Image>::type images(6);
-                ConstImagePtrList imagePtrs;
+                vector<DataStreamPtr>::type streams;
                 static const String suffixes[6] = {"_rt", "_lf", "_up", "_dn", "_fr", "_bk"};
 
                 for(size_t i = 0; i < 6; i++)
@@ -335,8 +334,11 @@ namespace Ogre {
                         fullName = fullName + "." + ext;
                     // find & load resource data intro stream to allow resource
                     // group changes if required
-                    do_image_io(fullName,mGroup,ext,*loadedImages,this);
+                    streams.push_back(ResourceGroupManager::getSingleton().openResource(
+                        fullName, mGroup, true, this));
                 }
+                // The faces are independent, decode them in parallel
+                Image::loadParallel(*loadedImages, streams, ext);
             }
         }
         else
@@ -51,6 +51,17 @@ namespace Ogre {
     protected:
         /// Compiles and links the vertex and fragment programs
         void compileAndLink(void);
+        /** Submits the shaders for compilation and the program for linking,
+            without waiting for the driver to finish.
+        */
+        void startCompileAndLink(void);
+        /// Whether the driver finished compiling and linking
+        bool isLinkComplete(void) const;
+        /// Checks the results of startCompileAndLink
+        void finishCompileAndLink(void);
+
+        /// Whether the program was submitted for linking and is not checked yet
+        bool mLinkPending;
         /// Put a program in use
         void _useProgram(void);
 
@@ -71,18 +82,21 @@ namespace Ogre {
         */
         void activate(void);
 
+        /** Whether the program is still being compiled in parallel.
+        @remarks
+            Programs are only compiled in parallel when
+            GLSLMonolithicProgramManager::setParallelCompile is on. Until
+            then, activate() polls the driver instead of waiting, and
+            nothing should be drawn with the program.
+        */
+        bool isLinkPending(void) const { return mLinkPending; }
+
         /** Updates program object uniforms using data from
             GpuProgramParameters.  normally called by
             GLSLShader::bindParameters() just before rendering
             occurs.
         */
         void updateUniforms(GpuProgramParametersSharedPtr params, uint16 mask, GpuProgramType fromProgType);
-        /** Updates program object uniform blocks using data from
-            GpuProgramParameters.  normally called by
-            GLSLShader::bindParameters() just before rendering
-            occurs.
-        */
-        void updateUniformBlocks(GpuProgramParametersSharedPtr params, uint16 mask, GpuProgramType fromProgType);
         /** Updates program object uniforms using data from pass
             iteration GpuProgramParameters.  normally called by
             GLSLShader::bindMultiPassParameters() just before multi
@@ -69,6 +69,9 @@ namespace Ogre {
         typedef map<String, GLenum>::type StringToEnumMap;
         StringToEnumMap mTypeEnumMap;
 
+        /// whether new program objects are compiled and linked in parallel
+        bool mParallelCompile;
+
     public:
 
         GLSLMonolithicProgramManager(const GL3PlusSupport& support);
@@ -118,6 +121,17 @@ namespace Ogre {
         */
         void setActiveComputeShader(GLSLShader* computeGpuProgram);
 
+        /** Set whether new program objects are compiled and linked
+            without waiting for the driver, which requires
+            GL_KHR_parallel_shader_compile or
+            GL_ARB_parallel_shader_compile. Draws using a program
+            are skipped until it is ready, see
+            GLSLMonolithicProgram::isLinkPending.
+        */
+        void setParallelCompile(bool enabled) { mParallelCompile = enabled; }
+        /// Get whether new program objects are compiled and linked in parallel
+        bool getParallelCompile(void) const { return mParallelCompile; }
+
         static GLSLMonolithicProgramManager& getSingleton(void);
         static GLSLMonolithicProgramManager* getSingletonPtr(void);
     };
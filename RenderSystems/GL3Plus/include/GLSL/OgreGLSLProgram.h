@@ -102,8 +102,12 @@ namespace Ogre {
         virtual void updateUniforms(GpuProgramParametersSharedPtr params, uint16 mask, GpuProgramType fromProgType) = 0;
         /** Updates program object uniform blocks using data from GpuProgramParameters.
             Normally called by GLSLShader::bindParameters() just before rendering occurs.
+            @remarks
+            The buffer of a shared parameter set is shared by every program declaring a
+            block of that name, so it is only uploaded by the first program bound after
+            the set changed.
         */
-        virtual void updateUniformBlocks(GpuProgramParametersSharedPtr params, uint16 mask, GpuProgramType fromProgType) = 0;
+        virtual void updateUniformBlocks(GpuProgramParametersSharedPtr params, uint16 mask, GpuProgramType fromProgType);
         /** Updates program object uniforms using data from pass iteration GpuProgramParameters.
             Normally called by GLSLShader::bindMultiPassParameters() just before multi pass rendering occurs.
         */
@@ -191,6 +195,8 @@ namespace Ogre {
 #define NOT_FOUND_CUSTOM_ATTRIBUTES_INDEX -1
 
         Ogre::String getCombinedName(void);
+        /// Name of the linked program in the microcode cache, validated by the shader sources
+        Ogre::String getNameForMicrocodeCache(void);
         /// Get the the binary data of a program from the microcode cache
         void getMicrocodeFromCache(void);
         /// Compiles and links the vertex and fragment programs
@@ -62,6 +62,9 @@ namespace Ogre {
 
         const GL3PlusSupport& mGLSupport;
 
+        /// Next uniform buffer binding point to hand out to a shared parameter set
+        GLint mSharedParamsBufferBindings;
+
         typedef map<String, GLenum>::type StringToEnumMap;
         /// 
         StringToEnumMap mTypeEnumMap;
@@ -85,6 +85,12 @@ namespace Ogre {
         /// Compile source into shader object
         bool compile( bool checkErrors = false);
 
+        /** Submit the source for compilation without waiting for the result.
+            The following call to compile() checks the result, which
+            lets the driver compile several shaders in parallel.
+        */
+        void compileAsync(void);
+
 
         /// Bind the shader in OpenGL.
         void bind(void);
@@ -158,6 +164,9 @@ namespace Ogre {
             linked.
             Only used for separable programs. */
         GLint mLinked;
+
+        /// Whether the source was submitted and the result not checked yet.
+        bool mCompilePending;
     };
 }
 
@@ -0,0 +1,89 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __GL3PlusGpuDrawCuller_H__
+#define __GL3PlusGpuDrawCuller_H__
+
+#include "OgreGL3PlusPrerequisites.h"
+#include "OgreGpuDrawCuller.h"
+
+namespace Ogre {
+    /** Culls draws or instances with a compute program.
+    @remarks
+        The bounds and the source draw arguments or instance data live in
+        storage buffers. Each invocation tests one bounding sphere, and either
+        writes the command of its draw with no instance when culled, or
+        appends its instance data to the instance buffer and counts it with
+        an atomic add to the single command. The buffers are bound to the last
+        storage buffer binding points, so as not to disturb those of materials.
+    */
+    class _OgreGL3PlusExport GL3PlusGpuDrawCuller : public GpuDrawCuller
+    {
+    public:
+        GL3PlusGpuDrawCuller(GL3PlusRenderSystem* renderSystem);
+        ~GL3PlusGpuDrawCuller();
+
+        /// @copydoc GpuDrawCuller::setDraws
+        void setDraws(const IndirectDrawCommand* commands, const Vector4* bounds, size_t count);
+        /// @copydoc GpuDrawCuller::setInstances
+        void setInstances(const IndirectDrawCommand& command, const Vector4* bounds,
+            const void* instanceData, size_t count, const HardwareVertexBufferSharedPtr& instanceBuffer);
+        /// @copydoc GpuDrawCuller::updateBounds
+        void updateBounds(size_t first, size_t count, const Vector4* bounds);
+
+        /** Runs the culling against the camera last given to cull, unless done
+            already. Called by the render system before a program is activated.
+        @param firstIndexOffset Added to the first index of the commands, for
+            index data placed further in its buffer
+        */
+        void _dispatch(uint32 firstIndexOffset);
+        /** Draws from the culled arguments. */
+        void _draw(GLenum primType, GLenum indexType);
+
+        /** Compiles and links the culling program. */
+        static GLuint _createProgram(void);
+
+    protected:
+        GL3PlusRenderSystem* mRenderSystem;
+        GLuint mBoundsBuffer;
+        /// The commands of the draws, or the data of the instances
+        GLuint mSourceBuffer;
+        /// The draw arguments written by the culling
+        GLuint mCommandBuffer;
+        /// The draw of the instances
+        IndirectDrawCommand mCommand;
+        HardwareVertexBufferSharedPtr mInstanceBuffer;
+
+        /// Allocates a buffer if needed and fills it
+        void upload(GLuint& buffer, const void* data, size_t size, GLenum usage);
+        /// The first of the 5 binding points used
+        static GLuint getFirstBinding(void);
+    };
+}
+
+#endif
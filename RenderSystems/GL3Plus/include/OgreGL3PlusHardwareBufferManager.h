@@ -33,6 +33,9 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreHardwareBufferManager.h"
 
 namespace Ogre {
+    class GL3PlusStateCacheManager;
+    class GL3PlusPixelUploadPool;
+
     // Default threshold at which glMapBuffer becomes more efficient than glBufferSubData (32k?)
     //TODO Double check that this still holds.
 #       define OGRE_GL_DEFAULT_MAP_BUFFER_THRESHOLD (1024 * 32)
@@ -41,9 +44,12 @@ namespace Ogre {
     class _OgreGL3PlusExport GL3PlusHardwareBufferManagerBase : public HardwareBufferManagerBase
     {
     protected:
-        char* mScratchBufferPool;
-        OGRE_MUTEX(mScratchMutex);
         size_t mMapBufferThreshold;
+        GL3PlusStateCacheManager* mStateCacheManager;
+        /// Whether GL 4.4 or ARB_buffer_storage allows persistently mapped buffers
+        bool mSupportsPersistentMapping;
+        /// Staging buffers of texture uploads, null without sync objects
+        GL3PlusPixelUploadPool* mPixelUploadPool;
 
         UniformBufferList mShaderStorageBuffers;
 
@@ -76,17 +82,19 @@ namespace Ogre {
         /// Utility function to get the correct GL type based on VET's
         static GLenum getGLType(VertexElementType type);
 
-        /** Allocator method to allow us to use a pool of memory as a scratch
-            area for hardware buffers. This is because glMapBuffer is incredibly
-            inefficient, seemingly no matter what options we give it. So for the
-            period of lock/unlock, we will instead allocate a section of a local
-            memory pool, and use glBufferSubDataARB / glGetBufferSubDataARB
-            instead.
-        */
-        void* allocateScratch(uint32 size);
+        GL3PlusStateCacheManager * getStateCacheManager() { return mStateCacheManager; }
 
-        /// @see allocateScratch
-        void deallocateScratch(void* ptr);
+        /// Pool texture uploads are staged in, null if unsupported
+        GL3PlusPixelUploadPool* getPixelUploadPool() { return mPixelUploadPool; }
+
+        /** Whether a vertex or index buffer with the given usage is backed by a
+            GL3PlusPersistentBufferRing rather than a regular buffer object.
+        */
+        bool usePersistentBufferRing(HardwareBuffer::Usage usage) const
+        {
+            return mSupportsPersistentMapping &&
+                (usage & HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE) == HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE;
+        }
 
         /** Threshold after which glMapBuffer is used and not glBufferSubData
          */
@@ -120,24 +128,6 @@ namespace Ogre {
         static GLenum getGLType(VertexElementType type)
         { return GL3PlusHardwareBufferManagerBase::getGLType(type); }
 
-        /** Allocator method to allow us to use a pool of memory as a scratch
-            area for hardware buffers. This is because glMapBuffer is incredibly
-            inefficient, seemingly no matter what options we give it. So for the
-            period of lock/unlock, we will instead allocate a section of a local
-            memory pool, and use glBufferSubDataARB / glGetBufferSubDataARB
-            instead.
-        */
-        void* allocateScratch(uint32 size)
-        {
-            return static_cast<GL3PlusHardwareBufferManagerBase*>(mImpl)->allocateScratch(size);
-        }
-
-        /// @see allocateScratch
-        void deallocateScratch(void* ptr)
-        {
-            static_cast<GL3PlusHardwareBufferManagerBase*>(mImpl)->deallocateScratch(ptr);
-        }
-
         /** Threshold after which glMapBuffer is used and not glBufferSubData.
          */
         size_t getGLMapBufferThreshold() const
@@ -156,6 +146,12 @@ namespace Ogre {
             return static_cast<GL3PlusHardwareBufferManagerBase*>(mImpl)->createShaderStorageBuffer(sizeBytes, usage, useShadowBuffer, name);
         }
 
+        /// @copydoc GL3PlusHardwareBufferManagerBase::getPixelUploadPool
+        GL3PlusPixelUploadPool* getPixelUploadPool()
+        {
+            return static_cast<GL3PlusHardwareBufferManagerBase*>(mImpl)->getPixelUploadPool();
+        }
+
     };
 
 }
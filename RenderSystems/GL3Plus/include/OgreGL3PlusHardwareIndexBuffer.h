@@ -30,6 +30,7 @@ THE SOFTWARE.
 #define __GL3PlusHardwareIndexBuffer_H__
 
 #include "OgreGL3PlusPrerequisites.h"
+#include "OgreGL3PlusPersistentBufferRing.h"
 #include "OgreHardwareIndexBuffer.h"
 
 namespace Ogre {
@@ -42,7 +43,11 @@ namespace Ogre {
             size_t mScratchOffset;
             size_t mScratchSize;
             void* mScratchPtr;
+            /// Staging buffer mScratchPtr points into
+            HardwareBuffer* mScratchBuffer;
             bool mScratchUploadOnUnlock;
+            /// Persistently mapped storage, only for HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE buffers
+            GL3PlusPersistentBufferRing* mRing;
 
         protected:
             /** See HardwareBuffer. */
@@ -64,9 +69,12 @@ namespace Ogre {
             void copyData(HardwareBuffer& srcBuffer, size_t srcOffset, 
                   size_t dstOffset, size_t length, bool discardWholeBuffer = false);
             /** See HardwareBuffer. */
-            void _updateFromShadow(void);
+            void uploadFromShadow(size_t offset, size_t length);
 
             GLuint getGLBufferId(void) const { return mBufferId; }
+
+            /// Offset to add to GL buffer offsets when drawing from this buffer
+            size_t getGLBufferOffset(void) const { return mRing ? mRing->getCurrentOffset() : 0; }
     };
 }
 
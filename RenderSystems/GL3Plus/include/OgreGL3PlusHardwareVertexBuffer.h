@@ -29,6 +29,7 @@ THE SOFTWARE.
 #define __GL3PlusHARDWAREVERTEXBUFFER_H__
 
 #include "OgreGL3PlusPrerequisites.h"
+#include "OgreGL3PlusPersistentBufferRing.h"
 #include "OgreHardwareVertexBuffer.h"
 
 namespace Ogre {
@@ -43,7 +44,11 @@ namespace Ogre {
         size_t mScratchOffset;
         size_t mScratchSize;
         void* mScratchPtr;
+        /// Staging buffer mScratchPtr points into
+        HardwareBuffer* mScratchBuffer;
         bool mScratchUploadOnUnlock;
+        /// Persistently mapped storage, only for HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE buffers
+        GL3PlusPersistentBufferRing* mRing;
 
     protected:
         /** See HardwareBuffer. */
@@ -68,9 +73,12 @@ namespace Ogre {
                       size_t dstOffset, size_t length, bool discardWholeBuffer = false);
 
         /** See HardwareBuffer. */
-        void _updateFromShadow(void);
+        void uploadFromShadow(size_t offset, size_t length);
 
         inline GLuint getGLBufferId(void) const { return mBufferId; }
+
+        /// Offset to add to GL buffer offsets when drawing from this buffer
+        inline size_t getGLBufferOffset(void) const { return mRing ? mRing->getCurrentOffset() : 0; }
     };
 }
 #endif // __GL3PlusHARDWAREVERTEXBUFFER_H__
@@ -0,0 +1,84 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __GL3PlusPersistentBufferRing_H__
+#define __GL3PlusPersistentBufferRing_H__
+
+#include "OgreGL3PlusPrerequisites.h"
+#include "OgreHardwareBuffer.h"
+
+namespace Ogre {
+    class GL3PlusStateCacheManager;
+
+    /// Number of copies of the buffer data kept in flight by a GL3PlusPersistentBufferRing
+#       define OGRE_GL_PERSISTENT_BUFFER_REGIONS 3
+
+    /** Persistently mapped ring of buffer regions, used as backing storage for
+        HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE vertex and index buffers.
+    @remarks
+        The buffer is created once with glBufferStorage, holding
+        OGRE_GL_PERSISTENT_BUFFER_REGIONS regions of the buffer's size, and
+        stays mapped (persistent and coherent) for its whole lifetime.
+        Locking with HBL_DISCARD fences the region the GPU may still be
+        reading and moves on to the next one, so a lock never maps, unmaps
+        or orphans the buffer; HBL_NO_OVERWRITE returns the current region
+        directly. Draw calls must add getCurrentOffset() to their buffer
+        offsets.
+    */
+    class _OgreGL3PlusExport GL3PlusPersistentBufferRing : public BufferAlloc
+    {
+    protected:
+        GL3PlusStateCacheManager* mStateCacheManager;
+        GLenum mTarget;
+        GLuint mBufferId;
+        /// Distance between two regions, the buffer size rounded up for alignment
+        size_t mRegionStride;
+        size_t mCurrentRegion;
+        uint8* mMappedPtr;
+        /// Fences guarding the GPU reads of each region
+        GLsync mFences[OGRE_GL_PERSISTENT_BUFFER_REGIONS];
+
+        void fenceRegion(size_t region);
+        void waitForRegion(size_t region);
+
+    public:
+        GL3PlusPersistentBufferRing(GL3PlusStateCacheManager* stateCacheManager, GLenum target, size_t sizeInBytes);
+        ~GL3PlusPersistentBufferRing();
+
+        /** Returns a pointer to the requested range of the current region,
+            switching or synchronising regions according to the lock options.
+        */
+        void* lock(size_t offset, size_t length, HardwareBuffer::LockOptions options);
+
+        GLuint getGLBufferId(void) const { return mBufferId; }
+
+        /// Offset in bytes of the current region within the GL buffer
+        size_t getCurrentOffset(void) const { return mCurrentRegion * mRegionStride; }
+    };
+}
+
+#endif // __GL3PlusPersistentBufferRing_H__
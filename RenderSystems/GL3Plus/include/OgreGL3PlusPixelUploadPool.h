@@ -0,0 +1,94 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __GL3PlusPixelUploadPool_H__
+#define __GL3PlusPixelUploadPool_H__
+
+#include "OgreGL3PlusPrerequisites.h"
+
+namespace Ogre {
+    class GL3PlusStateCacheManager;
+
+    /// Number of bytes of idle staging buffers kept by a GL3PlusPixelUploadPool
+#       define OGRE_GL_PIXEL_UPLOAD_POOL_SIZE (32 * 1024 * 1024)
+
+    /** Pool of pixel unpack buffers staging texture uploads.
+    @remarks
+        Texture data is copied into a staging buffer and glTexSubImage reads
+        from there, so the call returns as soon as the copy is done and the
+        transfer to the texture overlaps with rendering. Each buffer is fenced
+        once the uploads reading from it are issued, and only handed out again
+        when the fence has signalled, so mapping it never waits for the GPU
+        and buffers aren't created and destroyed for every upload.
+    @par
+        Buffers and fences are shared between contexts, so textures loaded by
+        background threads use the same pool.
+    */
+    class _OgreGL3PlusExport GL3PlusPixelUploadPool : public BufferAlloc
+    {
+    protected:
+        struct StagingBuffer
+        {
+            GLuint bufferId;
+            size_t size;
+            /// Guards the GPU reads of the last upload, 0 if there are none pending
+            GLsync fence;
+            bool inUse;
+        };
+        typedef vector<StagingBuffer>::type StagingBufferList;
+
+        GL3PlusStateCacheManager* mStateCacheManager;
+        StagingBufferList mBuffers;
+        /// Total size of the buffers in mBuffers
+        size_t mPooledBytes;
+        OGRE_MUTEX(mMutex);
+
+        /// Whether the GPU is done with the buffer, releasing its fence if so
+        static bool isIdle(StagingBuffer& buffer);
+
+    public:
+        GL3PlusPixelUploadPool(GL3PlusStateCacheManager* stateCacheManager);
+        ~GL3PlusPixelUploadPool();
+
+        /** Hands out a staging buffer of at least sizeInBytes, bound to GL_PIXEL_UNPACK_BUFFER
+            and mapped for writing.
+        @param bufferId Receives the buffer, to be given back with unmap
+        */
+        void* map(size_t sizeInBytes, GLuint& bufferId);
+
+        /** Unmaps a buffer obtained with map, leaving it bound to GL_PIXEL_UNPACK_BUFFER
+            so uploads can be issued from it.
+        */
+        void unmap(GLuint bufferId);
+
+        /** Returns a buffer to the pool, once all the uploads reading from it are issued. */
+        void release(GLuint bufferId);
+    };
+}
+
+#endif // __GL3PlusPixelUploadPool_H__
@@ -45,6 +45,7 @@ namespace Ogre {
     class GL3PlusHardwarePixelBuffer;
     class GL3PlusRenderBuffer;
     class GL3PlusDepthBuffer;
+    class GL3PlusStateCacheManager;
     
     class GLSLShader;
 
@@ -92,6 +93,8 @@ namespace Ogre {
 // Convenience macro from ARB_vertex_buffer_object spec
 #define GL_BUFFER_OFFSET(i) ((char *)NULL + (i))
 
+#define getGL3PlusSupportRef() static_cast<GL3PlusRenderSystem*>(Root::getSingleton().getRenderSystem())->getGLSupportRef()
+
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
 #   define __PRETTY_FUNCTION__ __FUNCTION__
 #endif
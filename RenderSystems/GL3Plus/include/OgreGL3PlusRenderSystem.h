@@ -35,6 +35,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreGLSLShader.h"
 #include "OgreRenderWindow.h"
 #include "OgreGLRenderSystemCommon.h"
+#include "OgreGL3PlusVertexArrayObject.h"
 
 namespace Ogre {
     /** \addtogroup RenderSystems RenderSystems
@@ -59,8 +60,6 @@ namespace Ogre {
         /// Rendering loop control
         bool mStopRendering;
 
-        typedef OGRE_HashMap<GLenum, GLuint>  BindBufferMap;
-
         /// View matrix to set world against
         Matrix4 mViewMatrix;
         Matrix4 mWorldMatrix;
@@ -109,6 +108,9 @@ namespace Ogre {
         /// GL support class, used for creating windows etc.
         GL3PlusSupport *mGLSupport;
 
+        /// State cache manager which responsible to reduce redundant state changes
+        GL3PlusStateCacheManager* mStateCacheManager;
+
         /* The main GL context - main thread only */
         GL3PlusContext *mMainContext;
 
@@ -130,13 +132,6 @@ namespace Ogre {
         */
         GL3PlusRTTManager *mRTTManager;
 
-        /** These variables are used for caching RenderSystem state.
-            They are cached because OpenGL state changes can be quite expensive,
-            which is especially important on mobile or embedded systems.
-        */
-        GLenum mActiveTextureUnit;
-        BindBufferMap mActiveBufferMap;
-
         /// Check if the GL system has already been initialised
         bool mGLInitialised;
 
@@ -146,10 +141,45 @@ namespace Ogre {
         // check if GL 3.2 is supported
         bool mHasGL32;
 
+        // check if timestamp queries are supported
+        bool mHasTimerQuery;
+
+        /// The timestamp queries at the beginning and end of a GPU timer
+        struct GpuTimer
+        {
+            GLuint queries[2];
+        };
+        /// Pool of GPU timers, a timer handle being its index + 1
+        vector<GpuTimer>::type mGpuTimers;
+        /// Handles of the pooled GPU timers not in use
+        vector<uint32>::type mFreeGpuTimers;
+
+        /// Buffer the commands of multi-draw indirect render operations are streamed into
+        GLuint mIndirectBuffer;
+        /// Size in bytes of mIndirectBuffer's storage
+        size_t mIndirectBufferSize;
+
+        /// Uploads op's indirect commands and issues them with a single multi-draw call
+        void renderIndirect(const RenderOperation& op, GLenum primType, GLenum indexType);
+
+        /// Program of the GpuDrawCullers, compiled on first use
+        GLuint mGpuDrawCullProgram;
+        /// Storage buffer the depth hierarchy of the occlusion culler is uploaded to
+        GLuint mGpuCullDepthBuffer;
+        /// Occlusion culler, frame and view projection mGpuCullDepthBuffer holds
+        const SoftwareOcclusionCuller* mGpuCullDepthSource;
+        unsigned long mGpuCullDepthFrame;
+        Matrix4 mGpuCullDepthViewProj;
+
+        /// Fences at the end of the frames queued to the GPU, oldest first
+        deque<GLsync>::type mFrameFences;
+
+        /// @copydoc RenderSystem::limitFrameLatency
+        void limitFrameLatency(void);
+
         // local data members of _render that were moved here to improve performance
         // (save allocations)
-        vector<GLuint>::type mRenderAttribsBound;
-        vector<GLuint>::type mRenderInstanceAttribsBound;
+        GL3PlusVertexArrayObjectCache::AttribBindingList mVertexAttribBindings;
 
 #if OGRE_NO_QUAD_BUFFER_STEREO == 0
 		/// @copydoc RenderSystem::setDrawBuffer
@@ -173,12 +203,9 @@ namespace Ogre {
         GLint getTextureAddressingMode(TextureUnitState::TextureAddressingMode tam) const;
         GLenum getBlendMode(SceneBlendFactor ogreBlend) const;
 
-        bool activateGLTextureUnit(size_t unit);
+        /// Records the attribute setup of elem in mVertexAttribBindings, if the program uses it
         void bindVertexElementToGpu( const VertexElement &elem, HardwareVertexBufferSharedPtr vertexBuffer,
-                                     const size_t vertexStart,
-                                     vector<GLuint>::type &attribsBound,
-                                     vector<GLuint>::type &instanceAttribsBound,
-                                     bool updateVAO);
+                                     const size_t vertexStart);
 
     public:
         // Default constructor / destructor
@@ -363,6 +390,15 @@ namespace Ogre {
                               const ColourValue& colour = ColourValue::Black,
                               Real depth = 1.0f, unsigned short stencil = 0);
         HardwareOcclusionQuery* createHardwareOcclusionQuery(void);
+        /// @copydoc RenderSystem::createGpuDrawCuller
+        GpuDrawCuller* createGpuDrawCuller(void);
+        /// Gets the program of the GpuDrawCullers
+        GLuint _getGpuDrawCullProgram(void);
+        /** Uploads the levels of the depth hierarchy of an occlusion culler one
+            after the other, once per frame and view.
+        @return The storage buffer holding them
+        */
+        GLuint _uploadGpuCullDepth(const SoftwareOcclusionCuller* occlusion, const Matrix4& viewProj);
         OGRE_MUTEX(mThreadInitMutex);
         void registerThread();
         void unregisterThread();
@@ -375,6 +411,10 @@ namespace Ogre {
         // ----------------------------------
         /** Returns the main context */
         GL3PlusContext* _getMainContext() { return mMainContext; }
+        /** Returns the GL support class */
+        GL3PlusSupport* getGLSupportRef() { return mGLSupport; }
+        /** Returns the state cache of the current context */
+        GL3PlusStateCacheManager* _getStateCacheManager() { return mStateCacheManager; }
         /** Unregister a render target->context mapping. If the context of target
             is the current context, change the context to the main context so it
             can be destroyed safely.
@@ -432,8 +472,24 @@ namespace Ogre {
         /// @copydoc RenderSystem::markProfileEvent
         virtual void markProfileEvent( const String &eventName );
 
+        /// @copydoc RenderSystem::_beginGpuTimer
+        virtual uint32 _beginGpuTimer(void);
+
+        /// @copydoc RenderSystem::_endGpuTimer
+        virtual void _endGpuTimer(uint32 timer);
+
+        /// @copydoc RenderSystem::_getGpuTimerResult
+        virtual GpuTimerStatus _getGpuTimerResult(uint32 timer, uint64& elapsedNanosecs);
+
+        /// @copydoc RenderSystem::_releaseGpuTimer
+        virtual void _releaseGpuTimer(uint32 timer);
+
         /** @copydoc RenderTarget::copyContentsToMemory */
         void _copyContentsToMemory(Viewport* vp, const Box& src, const PixelBox &dst, RenderWindow::FrameBuffer buffer);
+
+        /// @copydoc RenderSystem::_copyContentsToMemoryAsync
+        virtual PixelReadbackPtr _copyContentsToMemoryAsync(RenderTarget* target, const Box& src,
+            PixelFormat format, RenderTarget::FrameBuffer buffer);
     };
     /** @} */
     /** @} */
@@ -0,0 +1,289 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __GL3PlusStateCacheManager_H__
+#define __GL3PlusStateCacheManager_H__
+
+#include "OgreGL3PlusPrerequisites.h"
+#include "OgreStdHeaders.h"
+
+typedef Ogre::GeneralAllocatedObject StateCacheAlloc;
+
+namespace Ogre
+{
+    class GL3PlusStateCacheManagerImp;
+    class GL3PlusVertexArrayObjectCache;
+
+    /** An in memory cache of the OpenGL state.
+     @remarks
+     State changes can be particularly expensive time wise. This is because
+     a change requires OpenGL to re-evaluate and update the state machine.
+     Because of the general purpose nature of OGRE we often set the state for
+     a specific texture, material, buffer, etc. But this may be the same as the
+     current status of the state machine and is therefore redundant and causes
+     unnecessary work to be performed by OpenGL.
+     @par
+     Instead we are caching the state so that we can check whether it actually
+     does need to be updated. Every bind and state change made by the GL3Plus
+     render system has to go through this class, otherwise the cached values
+     no longer match what the driver holds.
+     @par
+     When OGRE_CONFIG_ENABLE_GL_STATE_CACHE_SUPPORT is disabled the calls are
+     passed straight through to OpenGL.
+     */
+    class _OgreGL3PlusExport GL3PlusStateCacheManager : public StateCacheAlloc
+    {
+    private:
+        GL3PlusStateCacheManagerImp* mImp;
+        typedef map<intptr_t, GL3PlusStateCacheManagerImp*>::type CachesMap;
+
+        CachesMap mCaches;
+
+        /// Vertex array object caches, also per context
+        GL3PlusVertexArrayObjectCache* mVertexArrayObjectCache;
+        typedef map<intptr_t, GL3PlusVertexArrayObjectCache*>::type VertexArrayObjectCachesMap;
+
+        VertexArrayObjectCachesMap mVertexArrayObjectCaches;
+
+    public:
+        GL3PlusStateCacheManager(void);
+        ~GL3PlusStateCacheManager(void);
+
+        /**
+         * GL state is tracked per context, so call this function to drop all
+         * recorded state for a given context before you destroy it.
+         */
+        void unregisterContext(intptr_t id);
+
+        /**
+         * @param id new context to switch to for state tracking
+         */
+        void switchContext(intptr_t id);
+
+        /** Clears all cached values
+        */
+        void clearCache();
+
+        /** Bind an OpenGL buffer of any type.
+         @param target The buffer target.
+         @param buffer The buffer ID.
+         @param force Optional parameter to force an update.
+         */
+        void bindGLBuffer(GLenum target, GLuint buffer, bool force = false);
+
+        /** Bind an OpenGL buffer to an indexed binding point.
+         @remarks
+         glBindBufferBase also replaces the generic binding of the target,
+         so the cached value is updated accordingly.
+         @param target The indexed buffer target.
+         @param index The binding point index.
+         @param buffer The buffer ID.
+         */
+        void bindGLBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+        /** Delete an OpenGL buffer of any type.
+         @remarks
+         Any cached binding of the buffer is reset to 0, as the driver does,
+         and cached vertex array objects reading from it are dropped.
+         @param buffer The buffer ID.
+         */
+        void deleteGLBuffer(GLuint buffer);
+
+        /** Bind an OpenGL vertex array object.
+         @remarks
+         The element array buffer binding is part of the vertex array object
+         state, so its cached value is dropped whenever the binding changes.
+         @param vao The vertex array object ID.
+         */
+        void bindGLVertexArray(GLuint vao);
+
+        /** Delete an OpenGL vertex array object.
+         @param vao The vertex array object ID.
+         */
+        void deleteGLVertexArray(GLuint vao);
+
+        /** Gets the vertex array object cache of the current context.
+         */
+        GL3PlusVertexArrayObjectCache* getVertexArrayObjectCache(void) const { return mVertexArrayObjectCache; }
+
+        /** Bind an OpenGL texture of any type to the active texture unit.
+         @param target The texture target.
+         @param texture The texture ID.
+         */
+        void bindGLTexture(GLenum target, GLuint texture);
+
+        /** Invalidates the state associated with a particular texture ID.
+         @remarks
+         Call this before deleting a texture, so the ID can safely be reused.
+         @param texture The texture ID.
+         */
+        void invalidateStateForTexture(GLuint texture);
+
+        /** Sets an integer parameter value of the texture bound to the
+            active texture unit.
+         @param target The texture target.
+         @param pname The parameter name.
+         @param param The parameter value.
+         */
+        void setTexParameteri(GLenum target, GLenum pname, GLint param);
+
+        /** Activate an OpenGL texture unit.
+         @param unit The texture unit to activate.
+         @return Whether or not the texture unit was successfully activated.
+         */
+        bool activateGLTextureUnit(size_t unit);
+
+        /** Bind an OpenGL sampler object to a texture unit.
+         @param unit The texture unit.
+         @param sampler The sampler ID, 0 to use the texture's own parameters.
+         */
+        void bindGLSampler(GLuint unit, GLuint sampler);
+
+        /** Make a linked program object part of the current rendering state.
+         @param program The program ID.
+         */
+        void bindGLProgram(GLuint program);
+
+        /** Bind a program pipeline object.
+         @param pipeline The program pipeline ID.
+         */
+        void bindGLProgramPipeline(GLuint pipeline);
+
+        /** Sets the blend equation for RGB and alpha separately.
+         @param eqRGB The blend equation for the colour components.
+         @param eqAlpha The blend equation for the alpha component.
+         */
+        void setBlendEquation(GLenum eqRGB, GLenum eqAlpha);
+
+        /** Sets the blending function for RGB and alpha separately.
+         @param source The blend mode for the source.
+         @param dest The blend mode for the destination.
+         @param sourceA The blend mode for the source alpha.
+         @param destA The blend mode for the destination alpha.
+         */
+        void setBlendFunc(GLenum source, GLenum dest, GLenum sourceA, GLenum destA);
+
+        /** Gets the current depth mask setting.
+         @return The current depth mask.
+         */
+        GLboolean getDepthMask(void) const;
+
+        /** Sets the current depth mask setting.
+         @param mask The depth mask to use.
+         */
+        void setDepthMask(GLboolean mask);
+
+        /** Gets the current depth test function.
+         @return The current depth test function.
+         */
+        GLenum getDepthFunc(void) const;
+
+        /** Sets the current depth test function.
+         @param func The depth test function to use.
+         */
+        void setDepthFunc(GLenum func);
+
+        /** Gets the clear depth in the range from [0..1].
+         @return The current clearing depth.
+         */
+        GLclampf getClearDepth(void) const;
+
+        /** Sets the clear depth in the range from [0..1].
+         @param depth The clear depth to use.
+         */
+        void setClearDepth(GLclampf depth);
+
+        /** Sets the color to clear to.
+         @param red The red component.
+         @param green The green component.
+         @param blue The blue component.
+         @param alpha The alpha component.
+         */
+        void setClearColour(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha);
+
+        /** Gets the current colour mask setting.
+         @return An array containing the mask in RGBA order.
+         */
+        const GLboolean* getColourMask(void) const;
+
+        /** Sets the current colour mask.
+         @param red The red component.
+         @param green The green component.
+         @param blue The blue component.
+         @param alpha The alpha component.
+         */
+        void setColourMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
+
+        /** Gets the current stencil mask.
+         @return The stencil mask.
+         */
+        GLuint getStencilMask(void) const;
+
+        /** Sets the stencil mask.
+         @param mask The stencil mask to use
+         */
+        void setStencilMask(GLuint mask);
+
+        /** Enables or disables a piece of OpenGL functionality.
+         @param flag The function to enable.
+         @param enabled Whether to enable or disable it.
+         */
+        void setEnabled(GLenum flag, bool enabled);
+
+        /** Gets the current polygon rendering mode, fill, wireframe, points, etc.
+         @return The current polygon rendering mode.
+         */
+        GLenum getPolygonMode(void) const;
+
+        /** Sets the current polygon rendering mode.
+         @param mode The polygon mode to use.
+         */
+        void setPolygonMode(GLenum mode);
+
+        /** Gets the face culling mode.
+         @return The current face culling mode
+         */
+        GLenum getCullFace(void) const;
+
+        /** Sets the face culling setting.
+         @param face The face culling mode to use.
+         */
+        void setCullFace(GLenum face);
+
+        /** Sets the viewport origin and size.
+         */
+        void setViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+        /** Gets the viewport origin and size.
+         @param array Receives x, y, width and height.
+         */
+        void getViewport(int* array) const;
+    };
+}
+
+#endif
@@ -38,10 +38,12 @@ THE SOFTWARE.
 
 namespace Ogre
 {
+    class GL3PlusStateCacheManager;
+
     class _OgreGL3PlusExport GL3PlusSupport
     {
         public:
-            GL3PlusSupport(GLNativeSupport* native) : mNative(native) { }
+            GL3PlusSupport(GLNativeSupport* native) : mStateCacheManager(0), mNative(native) { }
             virtual ~GL3PlusSupport() {
                 delete mNative;
             }
@@ -133,6 +135,22 @@ namespace Ogre
                 mShaderLibraryPath = path;
             }
 
+            /**
+            * Get the state cache of the render system
+            */
+            GL3PlusStateCacheManager* getStateCacheManager() const
+            {
+                return mStateCacheManager;
+            }
+
+            /**
+            * Set the state cache of the render system
+            */
+            void setStateCacheManager(GL3PlusStateCacheManager* stateCacheMgr)
+            {
+                mStateCacheManager = stateCacheMgr;
+            }
+
             /**
             * Check if GL Version is supported
             */
@@ -181,6 +199,8 @@ namespace Ogre
             String mShaderCachePath;
             String mShaderLibraryPath;
 
+            GL3PlusStateCacheManager* mStateCacheManager;
+
             GLNativeSupport* mNative;
 
             // This contains the complete list of supported extensions
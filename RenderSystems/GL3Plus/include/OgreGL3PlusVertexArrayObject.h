@@ -29,6 +29,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #define __GL3PlusVERTEXARRAYOBJECT_H__
 
 #include "OgreGL3PlusPrerequisites.h"
+#include "OgreGL3PlusStateCacheManager.h"
 #include "OgreHardwareVertexBuffer.h"
 
 namespace Ogre {
@@ -51,6 +52,82 @@ namespace Ogre {
         void setInitialised(bool flag) { mInitialised = flag; }
     };
 
+    /** Setup of one vertex attribute as recorded in a vertex array object */
+    struct GL3PlusVertexAttribBinding
+    {
+        GLuint attrib;
+        GLuint buffer;
+        GLint size;
+        GLenum type;
+        GLboolean normalised;
+        /// Specified with glVertexAttribLPointer
+        bool isDouble;
+        GLsizei stride;
+        size_t offset;
+        GLuint divisor;
+
+        bool operator==(const GL3PlusVertexAttribBinding& rhs) const
+        {
+            return attrib == rhs.attrib && buffer == rhs.buffer && size == rhs.size &&
+                type == rhs.type && normalised == rhs.normalised && isDouble == rhs.isDouble &&
+                stride == rhs.stride && offset == rhs.offset && divisor == rhs.divisor;
+        }
+    };
+
+    /** Cache of vertex array objects keyed by the attribute setup they hold.
+    @remarks
+        Instead of respecifying every vertex attribute on each draw, the render
+        system looks up the complete attribute setup (declaration, bound buffers
+        and the program's attribute locations) here. In the common case drawing
+        then only needs a single glBindVertexArray. A vertex array object is
+        created on a miss, and the least recently used one is destroyed once the
+        cache is full.
+    @par
+        Vertex array objects are not shared between contexts, so the state cache
+        manager keeps one cache per context.
+    */
+    class _OgreGL3PlusExport GL3PlusVertexArrayObjectCache : public StateCacheAlloc
+    {
+    public:
+        typedef vector<GL3PlusVertexAttribBinding>::type AttribBindingList;
+
+        GL3PlusVertexArrayObjectCache(GL3PlusStateCacheManager* stateCacheManager, size_t maxSize = 1024);
+        /// Does not delete the objects, they go away with their context
+        ~GL3PlusVertexArrayObjectCache();
+
+        /** Binds a vertex array object holding exactly the given attribute setup,
+            creating and specifying it if there is none yet.
+        */
+        void bind(const AttribBindingList& bindings);
+
+        /** Drops every vertex array object reading from a buffer about to be deleted,
+            so the buffer name can safely be reused.
+        @param buffer The buffer ID.
+        @param isCurrent Whether this cache's context is current. If not, the objects
+            are only deleted the next time the cache is used.
+        */
+        void _notifyBufferDestroyed(GLuint buffer, bool isCurrent);
+
+    protected:
+        struct Entry
+        {
+            GLuint vao;
+            AttribBindingList bindings;
+            unsigned long lastUsed;
+        };
+        typedef map<uint32, Entry>::type EntryMap;
+
+        GL3PlusStateCacheManager* mStateCacheManager;
+        EntryMap mEntries;
+        /// Objects dropped while the context wasn't current
+        vector<GLuint>::type mPendingDeletes;
+        size_t mMaxSize;
+        unsigned long mUseCount;
+
+        static uint32 hashBindings(const AttribBindingList& bindings);
+        void evictLeastRecentlyUsed(void);
+    };
+
 }
 
 #endif
@@ -31,11 +31,19 @@
 #include "OgreGLSLShader.h"
 #include "OgreGLSLMonolithicProgramManager.h"
 #include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusStateCacheManager.h"
+#include "OgreGL3PlusSupport.h"
 #include "OgreGL3PlusVertexArrayObject.h"
 #include "OgreStringVector.h"
 #include "OgreLogManager.h"
 #include "OgreGpuProgramManager.h"
 #include "OgreStringConverter.h"
+#include "OgreRoot.h"
+
+// From KHR_parallel_shader_compile, which glcorearb.h may predate.
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
 
 namespace Ogre {
 
@@ -91,6 +99,7 @@ namespace Ogre {
                       geometryProgram,
                       fragmentProgram,
                       computeProgram)
+        , mLinkPending(false)
     {
     }
 
@@ -105,22 +114,37 @@ namespace Ogre {
     {
         if (mLinked)
         {
-            OGRE_CHECK_GL_ERROR(glUseProgram(mGLProgramHandle));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLProgram(mGLProgramHandle);
         }
     }
 
 
     void GLSLMonolithicProgram::activate(void)
     {
-        if (!mLinked && !mTriedToLinkAndFailed)
+        if (mLinkPending)
+        {
+            if (!isLinkComplete())
+                return;
+
+            finishCompileAndLink();
+            extractLayoutQualifiers();
+            buildGLUniformReferences();
+        }
+        else if (!mLinked && !mTriedToLinkAndFailed)
         {
             OGRE_CHECK_GL_ERROR(mGLProgramHandle = glCreateProgram());
 
             if ( GpuProgramManager::getSingleton().canGetCompiledShaderBuffer() &&
-                 GpuProgramManager::getSingleton().isMicrocodeAvailableInCache(getCombinedName()) )
+                 GpuProgramManager::getSingleton().isMicrocodeAvailableInCache(getNameForMicrocodeCache()) )
             {
                 getMicrocodeFromCache();
             }
+            else if (GLSLMonolithicProgramManager::getSingleton().getParallelCompile())
+            {
+                // Check back on the next activation.
+                startCompileAndLink();
+                return;
+            }
             else
             {
                 compileAndLink();
@@ -135,79 +159,68 @@ namespace Ogre {
 
 
     void GLSLMonolithicProgram::compileAndLink()
+    {
+        GpuProgramManager::CompileTimer timer(GpuProgramManager::CS_LINK, getCombinedName());
+
+        startCompileAndLink();
+        finishCompileAndLink();
+    }
+
+
+    void GLSLMonolithicProgram::startCompileAndLink()
     {
         mVertexArrayObject = new GL3PlusVertexArrayObject();
         mVertexArrayObject->bind();
 
-        // Compile and attach Vertex Program
-        if (mVertexShader)
+        GLSLShader* shaders[] = { mVertexShader, mFragmentShader, mGeometryShader,
+                                  mHullShader, mDomainShader, mComputeShader };
+        const size_t numShaders = sizeof(shaders) / sizeof(shaders[0]);
+
+        // Submit all the shaders before checking any of them, so the
+        // driver can compile them in parallel.
+        for (size_t i = 0; i < numShaders; ++i)
         {
-            if (!mVertexShader->compile(true))
-            {
-                mTriedToLinkAndFailed = true;
-                return;
-            }
-            mVertexShader->attachToProgramObject(mGLProgramHandle);
-            setSkeletalAnimationIncluded(mVertexShader->isSkeletalAnimationIncluded());
+            if (shaders[i])
+                shaders[i]->compileAsync();
         }
-
-        // Compile and attach Fragment Program
-        if (mFragmentShader)
+        for (size_t i = 0; i < numShaders; ++i)
         {
-            if (!mFragmentShader->compile(true))
-            {
-                mTriedToLinkAndFailed = true;
-                return;
-            }
-            mFragmentShader->attachToProgramObject(mGLProgramHandle);
+            if (shaders[i])
+                shaders[i]->attachToProgramObject(mGLProgramHandle);
         }
 
-        // Compile and attach Geometry Program
-        if (mGeometryShader)
-        {
-            if (!mGeometryShader->compile(true))
-            {
-                return;
-            }
+        if (mVertexShader)
+            setSkeletalAnimationIncluded(mVertexShader->isSkeletalAnimationIncluded());
 
-            mGeometryShader->attachToProgramObject(mGLProgramHandle);
-        }
+        // the link
+        OGRE_CHECK_GL_ERROR(glLinkProgram( mGLProgramHandle ));
+        mLinkPending = true;
+    }
 
-        // Compile and attach Tessellation Control Program
-        if (mHullShader)
-        {
-            if (!mHullShader->compile(true))
-            {
-                return;
-            }
 
-            mHullShader->attachToProgramObject(mGLProgramHandle);
-        }
+    bool GLSLMonolithicProgram::isLinkComplete(void) const
+    {
+        GLint complete = GL_TRUE;
+        OGRE_CHECK_GL_ERROR(glGetProgramiv(mGLProgramHandle, GL_COMPLETION_STATUS_KHR, &complete));
+        return complete == GL_TRUE;
+    }
 
-        // Compile and attach Tessellation Evaluation Program
-        if (mDomainShader)
-        {
-            if (!mDomainShader->compile(true))
-            {
-                return;
-            }
 
-            mDomainShader->attachToProgramObject(mGLProgramHandle);
-        }
+    void GLSLMonolithicProgram::finishCompileAndLink()
+    {
+        mLinkPending = false;
 
-        // Compile and attach Compute Program
-        if (mComputeShader)
+        GLSLShader* shaders[] = { mVertexShader, mFragmentShader, mGeometryShader,
+                                  mHullShader, mDomainShader, mComputeShader };
+        for (size_t i = 0; i < sizeof(shaders) / sizeof(shaders[0]); ++i)
         {
-            if (!mComputeShader->compile(true))
+            if (shaders[i] && !shaders[i]->compile(true))
             {
+                mTriedToLinkAndFailed = true;
                 return;
             }
-
-            mComputeShader->attachToProgramObject(mGLProgramHandle);
         }
 
-        // the link
-        OGRE_CHECK_GL_ERROR(glLinkProgram( mGLProgramHandle ));
         OGRE_CHECK_GL_ERROR(glGetProgramiv( mGLProgramHandle, GL_LINK_STATUS, &mLinked ));
 
         mTriedToLinkAndFailed = !mLinked;
@@ -226,7 +239,7 @@ namespace Ogre {
             {
                 // add to the microcode to the cache
                 String name;
-                name = getCombinedName();
+                name = getNameForMicrocodeCache();
 
                 // get buffer size
                 GLint binaryLength = 0;
@@ -490,34 +503,6 @@ namespace Ogre {
     }
 
 
-    void GLSLMonolithicProgram::updateUniformBlocks(GpuProgramParametersSharedPtr params,
-                                                    uint16 mask, GpuProgramType fromProgType)
-    {
-        // Iterate through the list of uniform buffers and update them as needed
-        GLUniformBufferIterator currentBuffer = mGLUniformBufferReferences.begin();
-        GLUniformBufferIterator endBuffer = mGLUniformBufferReferences.end();
-
-        const GpuProgramParameters::GpuSharedParamUsageList& sharedParams = params->getSharedParameters();
-
-        GpuProgramParameters::GpuSharedParamUsageList::const_iterator it, end = sharedParams.end();
-        for (it = sharedParams.begin(); it != end; ++it)
-        {
-            for (;currentBuffer != endBuffer; ++currentBuffer)
-            {
-                GL3PlusHardwareUniformBuffer* hwGlBuffer = static_cast<GL3PlusHardwareUniformBuffer*>(currentBuffer->get());
-                GpuSharedParametersPtr paramsPtr = it->getSharedParams();
-
-                // Block name is stored in mSharedParams->mName of GpuSharedParamUsageList items
-                GLint UniformTransform;
-                OGRE_CHECK_GL_ERROR(UniformTransform = glGetUniformBlockIndex(mGLProgramHandle, it->getName().c_str()));
-                OGRE_CHECK_GL_ERROR(glUniformBlockBinding(mGLProgramHandle, UniformTransform, hwGlBuffer->getGLBufferBinding()));
-
-                hwGlBuffer->writeData(0, hwGlBuffer->getSizeInBytes(), &paramsPtr->getFloatConstantList().front());
-            }
-        }
-    }
-
-
     void GLSLMonolithicProgram::updatePassIterationUniforms(GpuProgramParametersSharedPtr params)
     {
         if (params->hasPassIterationNumber())
@@ -57,7 +57,8 @@ namespace Ogre {
 
     GLSLMonolithicProgramManager::GLSLMonolithicProgramManager(const GL3PlusSupport& support) :
         GLSLProgramManager(support),
-        mActiveMonolithicProgram(NULL)
+        mActiveMonolithicProgram(NULL),
+        mParallelCompile(false)
     {
     }
 
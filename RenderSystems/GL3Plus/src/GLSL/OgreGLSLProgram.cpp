@@ -31,6 +31,7 @@
 #include "OgreGpuProgramManager.h"
 #include "OgreGLSLShader.h"
 #include "OgreRoot.h"
+#include "OgreStringConverter.h"
 
 namespace Ogre {
 
@@ -127,6 +128,22 @@ namespace Ogre {
     }
 
 
+    Ogre::String GLSLProgram::getNameForMicrocodeCache()
+    {
+        // Key the binary on the shader sources as well, so an edited shader
+        // does not pick up a stale program from the cache.
+        GLSLShader* shaders[] = { mVertexShader, mHullShader, mDomainShader,
+                                  mGeometryShader, mFragmentShader, mComputeShader };
+        uint32 hash = 0;
+        for (size_t i = 0; i < sizeof(shaders) / sizeof(shaders[0]); ++i)
+        {
+            if (shaders[i])
+                hash = shaders[i]->_getHash(hash);
+        }
+        return getCombinedName() + StringConverter::toString(hash);
+    }
+
+
     VertexElementSemantic GLSLProgram::getAttributeSemanticEnum(String type)
     {
         VertexElementSemantic semantic = mSemanticTypeMap[type];
@@ -194,7 +211,7 @@ namespace Ogre {
     void GLSLProgram::getMicrocodeFromCache(void)
     {
         GpuProgramManager::Microcode cacheMicrocode =
-            GpuProgramManager::getSingleton().getMicrocodeFromCache(getCombinedName());
+            GpuProgramManager::getSingleton().getMicrocodeFromCache(getNameForMicrocodeCache());
 
         cacheMicrocode->seek(0);
 
@@ -299,5 +316,75 @@ namespace Ogre {
             }
         }
     }
+    //-----------------------------------------------------------------------
+    void GLSLProgram::updateUniformBlocks(GpuProgramParametersSharedPtr params,
+                                          uint16 mask, GpuProgramType fromProgType)
+    {
+        //TODO Support uniform block arrays - need to figure how to do this via material.
+
+        // Iterate through the list of uniform blocks and update them as needed.
+        SharedParamsBufferMap::const_iterator currentPair = mSharedParamsBufferMap.begin();
+        SharedParamsBufferMap::const_iterator endPair = mSharedParamsBufferMap.end();
+
+        for (; currentPair != endPair; ++currentPair)
+        {
+            // Another program sharing the buffer may already have uploaded it.
+            const GpuSharedParameters& sharedParams = *currentPair->first;
+            if (!sharedParams.isDirty()) continue;
+
+            HardwareUniformBuffer* hwGlBuffer = currentPair->second.get();
+
+            // Write the whole set in one lock. Uniform buffers are fully rewritten, so
+            // their old contents can be discarded; shader storage buffers may hold
+            // results written by the GPU and are locked normally.
+            HardwareBuffer::LockOptions lockOptions =
+                (hwGlBuffer->getUsage() & HardwareBuffer::HBU_DISCARDABLE) ? HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL;
+            uint8* pDest = static_cast<uint8*>(hwGlBuffer->lock(lockOptions));
+
+            GpuConstantDefinitionIterator parami = sharedParams.getConstantDefinitionIterator();
+            for (; parami.current() != parami.end(); parami.moveNext())
+            {
+                const GpuConstantDefinition* param = &parami.current()->second;
+
+                const void* dataPtr;
+
+                // NOTE: the naming is backward. this is the logical index
+                size_t index = param->physicalIndex;
+
+                switch (GpuConstantDefinition::getBaseType(param->constType))
+                {
+                case BCT_FLOAT:
+                    dataPtr = sharedParams.getFloatPointer(index);
+                    break;
+                case BCT_INT:
+                    dataPtr = sharedParams.getIntPointer(index);
+                    break;
+                case BCT_DOUBLE:
+                    dataPtr = sharedParams.getDoublePointer(index);
+                    break;
+                case BCT_UINT:
+                case BCT_BOOL:
+                    dataPtr = sharedParams.getUnsignedIntPointer(index);
+                    break;
+                case BCT_SAMPLER:
+                case BCT_SUBROUTINE:
+                    //TODO implement me!
+                default:
+                    //TODO error handling
+                    continue;
+                }
+
+                // in bytes
+                size_t length = param->arraySize * param->elementSize * 4;
+
+                // NOTE: the naming is backward. this is the physical offset in bytes
+                size_t offset = param->logicalIndex;
+                memcpy(pDest + offset, dataPtr, length);
+            }
+
+            hwGlBuffer->unlock();
+            currentPair->first->_markClean();
+        }
+    }
 
 } // namespace Ogre
@@ -47,7 +47,8 @@ namespace Ogre {
         mActiveGeometryShader(NULL),
         mActiveFragmentShader(NULL),
         mActiveComputeShader(NULL),
-        mGLSupport(support)
+        mGLSupport(support),
+        mSharedParamsBufferBindings(0)
     {
         // Fill in the relationship between type names and enums
         mTypeEnumMap.insert(StringToEnumMap::value_type("float", GL_FLOAT));
@@ -699,11 +700,15 @@ namespace Ogre {
             //TODO error handling for when buffer has no associated shared parameter?
             //if (bufferi == mSharedParamGLBufferMap.end()) continue;
 
+            // The buffer is kept with the shared parameters so that every program
+            // declaring the block binds the same buffer and it is uploaded once.
             GL3PlusHardwareUniformBuffer* hwGlBuffer;
-            SharedParamsBufferMap::const_iterator bufferMapi = sharedParamsBufferMap.find(blockSharedParams);
-            if (bufferMapi != sharedParamsBufferMap.end())
+            const Any& sharedData = blockSharedParams->_getRenderSystemData();
+            if (!sharedData.isEmpty())
             {
-                hwGlBuffer = static_cast<GL3PlusHardwareUniformBuffer*>(bufferMapi->second.get());
+                HardwareUniformBufferSharedPtr uniformBuffer = any_cast<HardwareUniformBufferSharedPtr>(sharedData);
+                hwGlBuffer = static_cast<GL3PlusHardwareUniformBuffer*>(uniformBuffer.get());
+                sharedParamsBufferMap.insert(std::make_pair(blockSharedParams, uniformBuffer));
             }
             else
             {
@@ -711,12 +716,14 @@ namespace Ogre {
                 GLint blockSize;
                 OGRE_CHECK_GL_ERROR(glGetActiveUniformBlockiv(programObject, index, GL_UNIFORM_BLOCK_DATA_SIZE, &blockSize));
                 HardwareUniformBufferSharedPtr newUniformBuffer = HardwareBufferManager::getSingleton().createUniformBuffer(blockSize, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, false, uniformName);
-                // bufferMapi->second() = newUniformBuffer;
                 hwGlBuffer = static_cast<GL3PlusHardwareUniformBuffer*>(newUniformBuffer.get());
-                GLint bufferBinding = sharedParamsBufferMap.size();
-                hwGlBuffer->setGLBufferBinding(bufferBinding);
+                // Binding points are global, give each shared buffer its own
+                hwGlBuffer->setGLBufferBinding(mSharedParamsBufferBindings++);
+                blockSharedParams->_setRenderSystemData(Any(newUniformBuffer));
                 std::pair<GpuSharedParametersPtr, HardwareUniformBufferSharedPtr> newPair (blockSharedParams, newUniformBuffer);
                 sharedParamsBufferMap.insert(newPair);
+                // Make sure the first program to use it uploads the contents
+                blockSharedParams->_markDirty();
 
                 // Get active block parameter properties.
                 GpuConstantDefinitionIterator sharedParamDef = blockSharedParams->getConstantDefinitionIterator();
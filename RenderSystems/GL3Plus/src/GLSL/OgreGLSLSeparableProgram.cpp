@@ -33,6 +33,10 @@
 #include "OgreGpuProgramManager.h"
 #include "OgreGLUtil.h"
 #include "OgreLogManager.h"
+#include "OgreRoot.h"
+#include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusStateCacheManager.h"
+#include "OgreGL3PlusSupport.h"
 
 namespace Ogre
 {
@@ -59,8 +63,10 @@ namespace Ogre
 
     void GLSLSeparableProgram::compileAndLink()
     {
+        GpuProgramManager::CompileTimer timer(GpuProgramManager::CS_LINK, getCombinedName());
+
         // Ensure no monolithic programs are in use.
-        OGRE_CHECK_GL_ERROR(glUseProgram(0));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLProgram(0);
 
         OGRE_CHECK_GL_ERROR(glGenProgramPipelines(1, &mGLProgramPipelineHandle));
         //OGRE_CHECK_GL_ERROR(glBindProgramPipeline(mGLProgramPipelineHandle));
@@ -142,7 +148,7 @@ namespace Ogre
             {
                 GLint linkStatus = 0;
 
-                String programName = program->getName();
+                String programName = program->getName() + "_" + StringConverter::toString(program->_getHash());
 
                 GLuint programHandle = program->getGLProgramHandle();
 
@@ -300,7 +306,7 @@ namespace Ogre
 
         if (mLinked)
         {
-            OGRE_CHECK_GL_ERROR(glBindProgramPipeline(mGLProgramPipelineHandle));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLProgramPipeline(mGLProgramPipelineHandle);
         }
     }
 
@@ -639,85 +645,6 @@ namespace Ogre
         // }
     }
 
-    void GLSLSeparableProgram::updateUniformBlocks(GpuProgramParametersSharedPtr params,
-                                                   uint16 mask, GpuProgramType fromProgType)
-    {
-        //TODO Support uniform block arrays - need to figure how to do this via material.
-
-        // Iterate through the list of uniform blocks and update them as needed.
-        SharedParamsBufferMap::const_iterator currentPair = mSharedParamsBufferMap.begin();
-        SharedParamsBufferMap::const_iterator endPair = mSharedParamsBufferMap.end();
-
-        // const GpuProgramParameters::GpuSharedParamUsageList& sharedParams = params->getSharedParameters();
-
-        // const GpuProgramParameters::GpuSharedParamUsageList& sharedParams = params->getSharedParameters();
-        // GpuProgramParameters::GpuSharedParamUsageList::const_iterator it, end = sharedParams.end();
-
-        for (; currentPair != endPair; ++currentPair)
-        {
-            GpuSharedParametersPtr paramsPtr = currentPair->first;
-
-            //FIXME Possible buffer does not exist if no associated uniform block.
-            HardwareUniformBuffer* hwGlBuffer = currentPair->second.get();
-
-            if (!paramsPtr->isDirty()) continue;
-
-            //FIXME does not check if current progrtype, or if shared param is active
-
-            GpuConstantDefinitionIterator parami = paramsPtr->getConstantDefinitionIterator();
-
-            for (int i = 0; parami.current() != parami.end(); parami.moveNext(), i++)
-            {
-                //String name = parami->;
-                //GpuConstantDefinition * param = GpuConstantConstantDefinition(name);
-
-                //const String* name = &parami.current()->first;
-                const GpuConstantDefinition* param = &parami.current()->second;
-
-                BaseConstantType baseType = GpuConstantDefinition::getBaseType(param->constType);
-
-                void* dataPtr;
-
-                // NOTE: the naming is backward. this is the logical index
-                size_t index =  param->physicalIndex;
-
-                //TODO Maybe move to GpuSharedParams?  Otherwise create bool buffer.
-                switch (baseType)
-                {
-                case BCT_FLOAT:
-                    dataPtr = paramsPtr->getFloatPointer(index);
-                    break;
-                case BCT_INT:
-                    dataPtr = paramsPtr->getIntPointer(index);
-                    break;
-                case BCT_DOUBLE:
-                    dataPtr = paramsPtr->getDoublePointer(index);
-                    break;
-                case BCT_UINT:
-                case BCT_BOOL:
-                    dataPtr = paramsPtr->getUnsignedIntPointer(index);
-                    break;
-                case BCT_SAMPLER:
-                case BCT_SUBROUTINE:
-                    //TODO implement me!
-                default:
-                    //TODO error handling
-                    continue;
-                }
-
-                // in bytes
-                size_t length = param->arraySize * param->elementSize * 4;
-
-                // NOTE: the naming is backward. this is the physical offset in bytes
-                size_t offset = param->logicalIndex;
-                hwGlBuffer->writeData(offset, length, dataPtr);
-            }
-
-            paramsPtr->_markClean();
-        }
-    }
-
-
     void GLSLSeparableProgram::updatePassIterationUniforms(GpuProgramParametersSharedPtr params)
     {
         if (params->hasPassIterationNumber())
@@ -90,6 +90,7 @@ namespace Ogre {
         mSyntaxCode = "glsl" + StringConverter::toString(Root::getSingleton().getRenderSystem()->getNativeShadingLanguageVersion());
 
         mLinked = 0;
+        mCompilePending = false;
         // Increase shader counter and use as ID
         mShaderID = ++mShaderCount;        
         
@@ -113,11 +114,11 @@ namespace Ogre {
         }
     }
 
-    bool GLSLShader::compile(bool checkErrors)
+    void GLSLShader::compileAsync(void)
     {
-        if (mCompiled == 1)
+        if (mCompiled == 1 || mCompilePending)
         {
-            return true;
+            return;
         }
 
         // Create shader object.
@@ -189,6 +190,20 @@ namespace Ogre {
         }
 
         OGRE_CHECK_GL_ERROR(glCompileShader(mGLShaderHandle));
+        mCompilePending = true;
+    }
+
+    bool GLSLShader::compile(bool checkErrors)
+    {
+        if (mCompiled == 1)
+        {
+            return true;
+        }
+
+        // Submit the source unless compileAsync already did, and wait
+        // for the result.
+        compileAsync();
+        mCompilePending = false;
 
         // Check for compile errors
         OGRE_CHECK_GL_ERROR(glGetShaderiv(mGLShaderHandle, GL_COMPILE_STATUS, &mCompiled));
@@ -236,6 +251,7 @@ namespace Ogre {
         mGLShaderHandle = 0;
         mGLProgramHandle = 0;
         mCompiled = 0;
+        mCompilePending = false;
     }
 
     void GLSLShader::buildConstantDefinitions() const
@@ -32,6 +32,10 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreLogManager.h"
 #include "OgreGL3PlusHardwarePixelBuffer.h"
 #include "OgreGL3PlusFBOMultiRenderTarget.h"
+#include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusStateCacheManager.h"
+#include "OgreGL3PlusSupport.h"
+#include "OgreRoot.h"
 
 namespace Ogre {
     static const size_t TEMP_FBOS = 2;
@@ -158,19 +162,22 @@ namespace Ogre {
         if (fmt != GL_NONE)
         {
             if (tid)
+            {
+                getGL3PlusSupportRef()->getStateCacheManager()->invalidateStateForTexture(tid);
                 OGRE_CHECK_GL_ERROR(glDeleteTextures(1, &tid));
+            }
 
             // Create and attach texture
             OGRE_CHECK_GL_ERROR(glGenTextures(1, &tid));
-            OGRE_CHECK_GL_ERROR(glBindTexture(GL_TEXTURE_2D, tid));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLTexture(GL_TEXTURE_2D, tid);
 
             // Set some default parameters
-            OGRE_CHECK_GL_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0));
-            OGRE_CHECK_GL_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
-            OGRE_CHECK_GL_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-            OGRE_CHECK_GL_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
-            OGRE_CHECK_GL_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-            OGRE_CHECK_GL_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+            getGL3PlusSupportRef()->getStateCacheManager()->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+            getGL3PlusSupportRef()->getStateCacheManager()->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+            getGL3PlusSupportRef()->getStateCacheManager()->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            getGL3PlusSupportRef()->getStateCacheManager()->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            getGL3PlusSupportRef()->getStateCacheManager()->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            getGL3PlusSupportRef()->getStateCacheManager()->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
             OGRE_CHECK_GL_ERROR(glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, PROBE_SIZE, PROBE_SIZE, 0, fmt, dataType, 0));
 
@@ -413,6 +420,7 @@ namespace Ogre {
                 OGRE_CHECK_GL_ERROR(glDeleteFramebuffers(1, &fb));
 
                 if (internalFormat != GL_NONE) {
+                    getGL3PlusSupportRef()->getStateCacheManager()->invalidateStateForTexture(tid);
                     OGRE_CHECK_GL_ERROR(glDeleteTextures(1, &tid));
                     tid = 0;
                 }
@@ -0,0 +1,369 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreGL3PlusGpuDrawCuller.h"
+#include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusStateCacheManager.h"
+#include "OgreGL3PlusHardwareVertexBuffer.h"
+#include "OgreSoftwareOcclusionCuller.h"
+#include "OgreException.h"
+
+namespace Ogre {
+    namespace
+    {
+        const GLuint CULL_GROUP_SIZE = 64;
+        /// Levels of the depth hierarchy the program can address
+        const size_t CULL_MAX_DEPTH_LEVELS = 16;
+
+        enum CullBinding
+        {
+            CB_BOUNDS,
+            CB_SOURCE,
+            CB_COMMANDS,
+            CB_DEPTHS,
+            CB_INSTANCES,
+            CB_COUNT
+        };
+
+        const char* const CULL_PROGRAM_SOURCE =
+            "#version 430\n"
+            "layout(local_size_x = 64) in;\n"
+            "layout(std430) readonly buffer Bounds { vec4 bounds[]; };\n"
+            "layout(std430) readonly buffer Source { uint source[]; };\n"
+            "layout(std430) buffer Commands { uint commands[]; };\n"
+            "layout(std430) readonly buffer Depths { float depths[]; };\n"
+            "layout(std430) writeonly buffer Instances { uint instances[]; };\n"
+            "uniform vec4 planes[6];\n"
+            "uniform mat4 viewProj;\n"
+            "uniform uint numItems;\n"
+            "uniform uint instanceSize;\n"
+            "uniform uint firstIndexOffset;\n"
+            "uniform int numDepthLevels;\n"
+            // Offset, width and height of each level
+            "uniform ivec4 depthLevels[16];\n"
+            // Same test as SoftwareOcclusionCuller::isOccluded, on the box of the sphere
+            "bool isOccluded(vec4 sphere)\n"
+            "{\n"
+            "    vec2 size = vec2(depthLevels[0].yz);\n"
+            "    vec2 minXY = vec2(1e30);\n"
+            "    vec2 maxXY = vec2(-1e30);\n"
+            "    float minZ = 1e30;\n"
+            "    for (int k = 0; k < 8; ++k)\n"
+            "    {\n"
+            "        vec3 corner = sphere.xyz + sphere.w * vec3((k & 1) != 0 ? 1.0 : -1.0,\n"
+            "            (k & 2) != 0 ? 1.0 : -1.0, (k & 4) != 0 ? 1.0 : -1.0);\n"
+            "        vec4 clip = viewProj * vec4(corner, 1.0);\n"
+            "        if (clip.w <= 1e-6 || clip.z < -clip.w)\n"
+            "            return false;\n"
+            "        vec3 ndc = clip.xyz / clip.w;\n"
+            "        vec2 p = vec2(ndc.x * 0.5 + 0.5, 0.5 - ndc.y * 0.5) * size;\n"
+            "        minXY = min(minXY, p);\n"
+            "        maxXY = max(maxXY, p);\n"
+            "        minZ = min(minZ, ndc.z);\n"
+            "    }\n"
+            "    ivec2 p0 = max(ivec2(floor(minXY)), ivec2(0));\n"
+            "    ivec2 p1 = min(ivec2(floor(maxXY)), depthLevels[0].yz - 1);\n"
+            "    if (p0.x > p1.x || p0.y > p1.y)\n"
+            "        return false;\n"
+            "    int level = 0;\n"
+            "    while (level + 1 < numDepthLevels &&\n"
+            "        ((p1.x >> level) - (p0.x >> level) > 3 || (p1.y >> level) - (p0.y >> level) > 3))\n"
+            "        ++level;\n"
+            "    ivec4 l = depthLevels[level];\n"
+            "    for (int y = p0.y >> level; y <= (p1.y >> level); ++y)\n"
+            "        for (int x = p0.x >> level; x <= (p1.x >> level); ++x)\n"
+            "            if (depths[l.x + y * l.y + x] >= minZ)\n"
+            "                return false;\n"
+            "    return true;\n"
+            "}\n"
+            "void main()\n"
+            "{\n"
+            "    uint i = gl_GlobalInvocationID.x;\n"
+            "    if (i >= numItems)\n"
+            "        return;\n"
+            "    vec4 sphere = bounds[i];\n"
+            "    bool visible = true;\n"
+            "    for (int p = 0; p < 6; ++p)\n"
+            "        if (dot(planes[p].xyz, sphere.xyz) + planes[p].w < -sphere.w)\n"
+            "            visible = false;\n"
+            "    if (visible && numDepthLevels > 0 && isOccluded(sphere))\n"
+            "        visible = false;\n"
+            "    if (instanceSize == 0u)\n"
+            "    {\n"
+            "        uint c = i * 5u;\n"
+            "        commands[c] = source[c];\n"
+            "        commands[c + 1u] = visible ? source[c + 1u] : 0u;\n"
+            "        commands[c + 2u] = source[c + 2u] + firstIndexOffset;\n"
+            "        commands[c + 3u] = source[c + 3u];\n"
+            "        commands[c + 4u] = source[c + 4u];\n"
+            "    }\n"
+            "    else if (visible)\n"
+            "    {\n"
+            "        uint slot = atomicAdd(commands[1], 1u);\n"
+            "        for (uint k = 0u; k < instanceSize; ++k)\n"
+            "            instances[slot * instanceSize + k] = source[i * instanceSize + k];\n"
+            "    }\n"
+            "}\n";
+    }
+    //---------------------------------------------------------------------
+    GL3PlusGpuDrawCuller::GL3PlusGpuDrawCuller(GL3PlusRenderSystem* renderSystem)
+        : mRenderSystem(renderSystem), mBoundsBuffer(0), mSourceBuffer(0), mCommandBuffer(0)
+    {
+        memset(&mCommand, 0, sizeof(mCommand));
+    }
+    //---------------------------------------------------------------------
+    GL3PlusGpuDrawCuller::~GL3PlusGpuDrawCuller()
+    {
+        GL3PlusStateCacheManager* stateCacheManager = mRenderSystem->_getStateCacheManager();
+        stateCacheManager->deleteGLBuffer(mBoundsBuffer);
+        stateCacheManager->deleteGLBuffer(mSourceBuffer);
+        stateCacheManager->deleteGLBuffer(mCommandBuffer);
+    }
+    //---------------------------------------------------------------------
+    GLuint GL3PlusGpuDrawCuller::getFirstBinding(void)
+    {
+        GLint maxBindings = 0;
+        OGRE_CHECK_GL_ERROR(glGetIntegerv(GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS, &maxBindings));
+        return static_cast<GLuint>(maxBindings) - CB_COUNT;
+    }
+    //---------------------------------------------------------------------
+    GLuint GL3PlusGpuDrawCuller::_createProgram(void)
+    {
+        GLuint shader;
+        OGRE_CHECK_GL_ERROR(shader = glCreateShader(GL_COMPUTE_SHADER));
+        OGRE_CHECK_GL_ERROR(glShaderSource(shader, 1, &CULL_PROGRAM_SOURCE, NULL));
+        OGRE_CHECK_GL_ERROR(glCompileShader(shader));
+
+        GLint status = 0;
+        OGRE_CHECK_GL_ERROR(glGetShaderiv(shader, GL_COMPILE_STATUS, &status));
+        if (!status)
+        {
+            char log[1024];
+            OGRE_CHECK_GL_ERROR(glGetShaderInfoLog(shader, sizeof(log), NULL, log));
+            OGRE_CHECK_GL_ERROR(glDeleteShader(shader));
+            OGRE_EXCEPT(Exception::ERR_RENDERINGAPI_ERROR,
+                "Failed to compile the GPU culling program: " + String(log),
+                "GL3PlusGpuDrawCuller::_createProgram");
+        }
+
+        GLuint program;
+        OGRE_CHECK_GL_ERROR(program = glCreateProgram());
+        OGRE_CHECK_GL_ERROR(glAttachShader(program, shader));
+        OGRE_CHECK_GL_ERROR(glLinkProgram(program));
+        OGRE_CHECK_GL_ERROR(glDeleteShader(shader));
+
+        OGRE_CHECK_GL_ERROR(glGetProgramiv(program, GL_LINK_STATUS, &status));
+        if (!status)
+        {
+            char log[1024];
+            OGRE_CHECK_GL_ERROR(glGetProgramInfoLog(program, sizeof(log), NULL, log));
+            OGRE_CHECK_GL_ERROR(glDeleteProgram(program));
+            OGRE_EXCEPT(Exception::ERR_RENDERINGAPI_ERROR,
+                "Failed to link the GPU culling program: " + String(log),
+                "GL3PlusGpuDrawCuller::_createProgram");
+        }
+
+        const char* const blocks[CB_COUNT] = { "Bounds", "Source", "Commands", "Depths", "Instances" };
+        GLuint firstBinding = getFirstBinding();
+        for (GLuint b = 0; b < CB_COUNT; ++b)
+        {
+            GLuint index;
+            OGRE_CHECK_GL_ERROR(index = glGetProgramResourceIndex(program, GL_SHADER_STORAGE_BLOCK, blocks[b]));
+            if (index != GL_INVALID_INDEX)
+                OGRE_CHECK_GL_ERROR(glShaderStorageBlockBinding(program, index, firstBinding + b));
+        }
+        return program;
+    }
+    //---------------------------------------------------------------------
+    void GL3PlusGpuDrawCuller::upload(GLuint& buffer, const void* data, size_t size, GLenum usage)
+    {
+        GL3PlusStateCacheManager* stateCacheManager = mRenderSystem->_getStateCacheManager();
+        if (!buffer)
+            OGRE_CHECK_GL_ERROR(glGenBuffers(1, &buffer));
+        stateCacheManager->bindGLBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+        OGRE_CHECK_GL_ERROR(glBufferData(GL_SHADER_STORAGE_BUFFER, size, data, usage));
+    }
+    //---------------------------------------------------------------------
+    void GL3PlusGpuDrawCuller::setDraws(const IndirectDrawCommand* commands, const Vector4* bounds,
+        size_t count)
+    {
+        vector<float>::type spheres(count * 4);
+        for (size_t i = 0; i < count; ++i)
+            for (int k = 0; k < 4; ++k)
+                spheres[i * 4 + k] = static_cast<float>(bounds[i][k]);
+
+        upload(mBoundsBuffer, count ? &spheres[0] : 0, spheres.size() * sizeof(float), GL_DYNAMIC_DRAW);
+        upload(mSourceBuffer, commands, count * sizeof(IndirectDrawCommand), GL_STATIC_DRAW);
+        upload(mCommandBuffer, 0, count * sizeof(IndirectDrawCommand), GL_DYNAMIC_COPY);
+        mInstanceBuffer.setNull();
+        mNumItems = count;
+        mInstanced = false;
+    }
+    //---------------------------------------------------------------------
+    void GL3PlusGpuDrawCuller::setInstances(const IndirectDrawCommand& command, const Vector4* bounds,
+        const void* instanceData, size_t count, const HardwareVertexBufferSharedPtr& instanceBuffer)
+    {
+        size_t instanceSize = instanceBuffer->getVertexSize();
+        if (instanceSize % 4 || count > instanceBuffer->getNumVertices())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "The instance buffer must hold all the instances, in multiples of 4 bytes",
+                "GL3PlusGpuDrawCuller::setInstances");
+        }
+
+        vector<float>::type spheres(count * 4);
+        for (size_t i = 0; i < count; ++i)
+            for (int k = 0; k < 4; ++k)
+                spheres[i * 4 + k] = static_cast<float>(bounds[i][k]);
+
+        upload(mBoundsBuffer, count ? &spheres[0] : 0, spheres.size() * sizeof(float), GL_DYNAMIC_DRAW);
+        upload(mSourceBuffer, instanceData, count * instanceSize, GL_STATIC_DRAW);
+        upload(mCommandBuffer, 0, sizeof(IndirectDrawCommand), GL_DYNAMIC_COPY);
+        mCommand = command;
+        mInstanceBuffer = instanceBuffer;
+        mNumItems = count;
+        mInstanced = true;
+    }
+    //---------------------------------------------------------------------
+    void GL3PlusGpuDrawCuller::updateBounds(size_t first, size_t count, const Vector4* bounds)
+    {
+        if (first + count > mNumItems)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Bounds out of range",
+                "GL3PlusGpuDrawCuller::updateBounds");
+        }
+        if (!count)
+            return;
+
+        vector<float>::type spheres(count * 4);
+        for (size_t i = 0; i < count; ++i)
+            for (int k = 0; k < 4; ++k)
+                spheres[i * 4 + k] = static_cast<float>(bounds[i][k]);
+
+        mRenderSystem->_getStateCacheManager()->bindGLBuffer(GL_SHADER_STORAGE_BUFFER, mBoundsBuffer);
+        OGRE_CHECK_GL_ERROR(glBufferSubData(GL_SHADER_STORAGE_BUFFER, first * 4 * sizeof(float),
+                                            spheres.size() * sizeof(float), &spheres[0]));
+    }
+    //---------------------------------------------------------------------
+    void GL3PlusGpuDrawCuller::_dispatch(uint32 firstIndexOffset)
+    {
+        if (!mCullPending || !mNumItems)
+            return;
+        mCullPending = false;
+
+        GL3PlusStateCacheManager* stateCacheManager = mRenderSystem->_getStateCacheManager();
+        GLuint program = mRenderSystem->_getGpuDrawCullProgram();
+        GLuint firstBinding = getFirstBinding();
+
+        if (mInstanced)
+        {
+            // Restart the count of the visible instances
+            IndirectDrawCommand command = mCommand;
+            command.instanceCount = 0;
+            command.firstIndex += firstIndexOffset;
+            stateCacheManager->bindGLBuffer(GL_SHADER_STORAGE_BUFFER, mCommandBuffer);
+            OGRE_CHECK_GL_ERROR(glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(command), &command));
+        }
+
+        // Layout of the depth hierarchy in the buffer the render system uploaded it to
+        GLint depthLevels[CULL_MAX_DEPTH_LEVELS * 4] = { 0 };
+        GLint numDepthLevels = 0;
+        GLuint depthBuffer = 0;
+        if (mOcclusion)
+        {
+            depthBuffer = mRenderSystem->_uploadGpuCullDepth(mOcclusion, mViewProj);
+            numDepthLevels = static_cast<GLint>(std::min(mOcclusion->getNumDepthLevels(), CULL_MAX_DEPTH_LEVELS));
+            GLint offset = 0;
+            for (GLint l = 0; l < numDepthLevels; ++l)
+            {
+                uint32 width, height;
+                mOcclusion->getDepthLevel(l, width, height);
+                depthLevels[l * 4] = offset;
+                depthLevels[l * 4 + 1] = static_cast<GLint>(width);
+                depthLevels[l * 4 + 2] = static_cast<GLint>(height);
+                offset += static_cast<GLint>(width * height);
+            }
+        }
+
+        stateCacheManager->bindGLProgram(program);
+
+        GLfloat planes[24];
+        for (int i = 0; i < 6; ++i)
+            for (int k = 0; k < 4; ++k)
+                planes[i * 4 + k] = static_cast<GLfloat>(mPlanes[i][k]);
+        GLfloat viewProj[16];
+        for (int i = 0; i < 16; ++i)
+            viewProj[i] = static_cast<GLfloat>(mViewProj[0][i]);
+
+        OGRE_CHECK_GL_ERROR(glUniform4fv(glGetUniformLocation(program, "planes"), 6, planes));
+        // Ogre matrices are row major
+        OGRE_CHECK_GL_ERROR(glUniformMatrix4fv(glGetUniformLocation(program, "viewProj"), 1, GL_TRUE, viewProj));
+        OGRE_CHECK_GL_ERROR(glUniform1ui(glGetUniformLocation(program, "numItems"), static_cast<GLuint>(mNumItems)));
+        OGRE_CHECK_GL_ERROR(glUniform1ui(glGetUniformLocation(program, "instanceSize"),
+            mInstanced ? static_cast<GLuint>(mInstanceBuffer->getVertexSize() / 4) : 0));
+        OGRE_CHECK_GL_ERROR(glUniform1ui(glGetUniformLocation(program, "firstIndexOffset"), firstIndexOffset));
+        OGRE_CHECK_GL_ERROR(glUniform1i(glGetUniformLocation(program, "numDepthLevels"), numDepthLevels));
+        OGRE_CHECK_GL_ERROR(glUniform4iv(glGetUniformLocation(program, "depthLevels"),
+            static_cast<GLsizei>(CULL_MAX_DEPTH_LEVELS), depthLevels));
+
+        // Unused blocks still get a buffer bound
+        stateCacheManager->bindGLBufferBase(GL_SHADER_STORAGE_BUFFER, firstBinding + CB_BOUNDS, mBoundsBuffer);
+        stateCacheManager->bindGLBufferBase(GL_SHADER_STORAGE_BUFFER, firstBinding + CB_SOURCE, mSourceBuffer);
+        stateCacheManager->bindGLBufferBase(GL_SHADER_STORAGE_BUFFER, firstBinding + CB_COMMANDS, mCommandBuffer);
+        stateCacheManager->bindGLBufferBase(GL_SHADER_STORAGE_BUFFER, firstBinding + CB_DEPTHS,
+            depthBuffer ? depthBuffer : mBoundsBuffer);
+        if (mInstanced)
+        {
+            const GL3PlusHardwareVertexBuffer* instanceBuffer =
+                static_cast<const GL3PlusHardwareVertexBuffer*>(mInstanceBuffer.get());
+            OGRE_CHECK_GL_ERROR(glBindBufferRange(GL_SHADER_STORAGE_BUFFER, firstBinding + CB_INSTANCES,
+                instanceBuffer->getGLBufferId(), instanceBuffer->getGLBufferOffset(),
+                instanceBuffer->getSizeInBytes()));
+            // Keep the cached generic binding right
+            stateCacheManager->bindGLBuffer(GL_SHADER_STORAGE_BUFFER, instanceBuffer->getGLBufferId(), true);
+        }
+        else
+        {
+            stateCacheManager->bindGLBufferBase(GL_SHADER_STORAGE_BUFFER, firstBinding + CB_INSTANCES, mCommandBuffer);
+        }
+
+        OGRE_CHECK_GL_ERROR(glDispatchCompute(static_cast<GLuint>((mNumItems + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE), 1, 1));
+        OGRE_CHECK_GL_ERROR(glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT));
+
+        // The pass programs are activated next, don't let this one hide them
+        stateCacheManager->bindGLProgram(0);
+    }
+    //---------------------------------------------------------------------
+    void GL3PlusGpuDrawCuller::_draw(GLenum primType, GLenum indexType)
+    {
+        mRenderSystem->_getStateCacheManager()->bindGLBuffer(GL_DRAW_INDIRECT_BUFFER, mCommandBuffer);
+        OGRE_CHECK_GL_ERROR(glMultiDrawElementsIndirect(primType, indexType, 0,
+                                                        static_cast<GLsizei>(mInstanced ? 1 : mNumItems),
+                                                        sizeof(IndirectDrawCommand)));
+    }
+}
@@ -32,34 +32,24 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreGL3PlusHardwareUniformBuffer.h"
 #include "OgreGL3PlusHardwareShaderStorageBuffer.h"
 #include "OgreGL3PlusHardwareVertexBuffer.h"
+#include "OgreGL3PlusPixelUploadPool.h"
 #include "OgreGL3PlusRenderToVertexBuffer.h"
+#include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusSupport.h"
 #include "OgreRoot.h"
 
 namespace Ogre {
 
-    // Scratch pool management (32 bit structure)
-    struct GL3PlusScratchBufferAlloc
-    {
-        /// Size in bytes
-        uint32 size: 31;
-        /// Free? (pack with size)
-        uint32 free: 1;
-    };
-#define SCRATCH_POOL_SIZE 1 * 1024 * 1024
-#define SCRATCH_ALIGNMENT 32
-
     GL3PlusHardwareBufferManagerBase::GL3PlusHardwareBufferManagerBase()
-        : mScratchBufferPool(NULL), mMapBufferThreshold(OGRE_GL_DEFAULT_MAP_BUFFER_THRESHOLD)
+        : mMapBufferThreshold(OGRE_GL_DEFAULT_MAP_BUFFER_THRESHOLD), mPixelUploadPool(0)
     {
-        // Init scratch pool
-        // TODO make it a configurable size?
-        // 32-bit aligned buffer
-        mScratchBufferPool = static_cast<char*>(OGRE_MALLOC_ALIGN(SCRATCH_POOL_SIZE,
-                                                                  MEMCATEGORY_GEOMETRY,
-                                                                  SCRATCH_ALIGNMENT));
-        GL3PlusScratchBufferAlloc* ptrAlloc = (GL3PlusScratchBufferAlloc*)mScratchBufferPool;
-        ptrAlloc->size = SCRATCH_POOL_SIZE - sizeof(GL3PlusScratchBufferAlloc);
-        ptrAlloc->free = 1;
+        mStateCacheManager = getGL3PlusSupportRef()->getStateCacheManager();
+        mSupportsPersistentMapping = getGL3PlusSupportRef()->hasMinGLVersion(4, 4) ||
+            getGL3PlusSupportRef()->checkExtension("GL_ARB_buffer_storage");
+
+        // The pool tracks the GPU's use of the staging buffers with fences
+        if (getGL3PlusSupportRef()->hasMinGLVersion(3, 2) || getGL3PlusSupportRef()->checkExtension("GL_ARB_sync"))
+            mPixelUploadPool = OGRE_NEW GL3PlusPixelUploadPool(mStateCacheManager);
     }
 
     GL3PlusHardwareBufferManagerBase::~GL3PlusHardwareBufferManagerBase()
@@ -69,7 +59,7 @@ namespace Ogre {
         destroyAllDeclarations();
         destroyAllBindings();
 
-        OGRE_FREE_ALIGN(mScratchBufferPool, MEMCATEGORY_GEOMETRY, SCRATCH_ALIGNMENT);
+        OGRE_DELETE mPixelUploadPool;
     }
 
     HardwareVertexBufferSharedPtr
@@ -190,7 +180,12 @@ namespace Ogre {
         case VET_SHORT2:
         case VET_SHORT3:
         case VET_SHORT4:
+        case VET_SHORT2_NORM:
+        case VET_SHORT4_NORM:
             return GL_SHORT;
+        case VET_HALF2:
+        case VET_HALF4:
+            return GL_HALF_FLOAT;
         case VET_USHORT1:
         case VET_USHORT2:
         case VET_USHORT3:
@@ -207,106 +202,6 @@ namespace Ogre {
         return 0;
     }
 
-    void* GL3PlusHardwareBufferManagerBase::allocateScratch(uint32 size)
-    {
-        // simple forward link search based on alloc sizes
-        // not that fast but the list should never get that long since not many
-        // locks at once (hopefully)
-        OGRE_LOCK_MUTEX(mScratchMutex);
-
-        // Alignment - round up the size to 32 bits
-        // control blocks are 32 bits too so this packs nicely
-        if (size % 4 != 0)
-        {
-            size += 4 - (size % 4);
-        }
-
-        uint32 bufferPos = 0;
-        while (bufferPos < SCRATCH_POOL_SIZE)
-        {
-            GL3PlusScratchBufferAlloc* pNext = (GL3PlusScratchBufferAlloc*)(mScratchBufferPool + bufferPos);
-            // Big enough?
-            if (pNext->free && pNext->size >= size)
-            {
-                // split? And enough space for control block
-                if(pNext->size > size + sizeof(GL3PlusScratchBufferAlloc))
-                {
-                    uint32 offset = (uint32)sizeof(GL3PlusScratchBufferAlloc) + size;
-
-                    GL3PlusScratchBufferAlloc* pSplitAlloc = (GL3PlusScratchBufferAlloc*)
-                        (mScratchBufferPool + bufferPos + offset);
-                    pSplitAlloc->free = 1;
-                    // split size is remainder minus new control block
-                    pSplitAlloc->size = pNext->size - size - sizeof(GL3PlusScratchBufferAlloc);
-
-                    // New size of current
-                    pNext->size = size;
-                }
-                // allocate and return
-                pNext->free = 0;
-
-                // return pointer just after this control block (++ will do that for us)
-                return ++pNext;
-            }
-
-            bufferPos += (uint32)sizeof(GL3PlusScratchBufferAlloc) + pNext->size;
-        }
-
-        // no available alloc
-        return 0;
-    }
-
-    void GL3PlusHardwareBufferManagerBase::deallocateScratch(void* ptr)
-    {
-        OGRE_LOCK_MUTEX(mScratchMutex);
-
-        // Simple linear search dealloc
-        uint32 bufferPos = 0;
-        GL3PlusScratchBufferAlloc* pLast = 0;
-        while (bufferPos < SCRATCH_POOL_SIZE)
-        {
-            GL3PlusScratchBufferAlloc* pCurrent = (GL3PlusScratchBufferAlloc*)(mScratchBufferPool + bufferPos);
-
-            // Pointers match?
-            if ((mScratchBufferPool + bufferPos + sizeof(GL3PlusScratchBufferAlloc)) == ptr)
-            {
-                // dealloc
-                pCurrent->free = 1;
-                // merge with previous
-                if (pLast && pLast->free)
-                {
-                    // adjust buffer pos
-                    bufferPos -= (pLast->size + (uint32)sizeof(GL3PlusScratchBufferAlloc));
-                    // merge free space
-                    pLast->size += pCurrent->size + sizeof(GL3PlusScratchBufferAlloc);
-                    pCurrent = pLast;
-                }
-
-                // merge with next
-                uint32 offset = bufferPos + pCurrent->size + (uint32)sizeof(GL3PlusScratchBufferAlloc);
-                if (offset < SCRATCH_POOL_SIZE)
-                {
-                    GL3PlusScratchBufferAlloc* pNext = (GL3PlusScratchBufferAlloc*)(
-                        mScratchBufferPool + offset);
-                    if (pNext->free)
-                    {
-                        pCurrent->size += pNext->size + sizeof(GL3PlusScratchBufferAlloc);
-                    }
-                }
-
-                // done
-                return;
-            }
-
-            bufferPos += (uint32)sizeof(GL3PlusScratchBufferAlloc) + pCurrent->size;
-            pLast = pCurrent;
-
-        }
-
-        // Should never get here unless there's a corruption
-        assert(false && "Memory deallocation error");
-    }
-
     size_t GL3PlusHardwareBufferManagerBase::getGLMapBufferThreshold() const
     {
         return mMapBufferThreshold;
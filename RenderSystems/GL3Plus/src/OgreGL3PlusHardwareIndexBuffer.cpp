@@ -29,6 +29,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreGL3PlusHardwareIndexBuffer.h"
 #include "OgreGL3PlusHardwareBufferManager.h"
 #include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusStateCacheManager.h"
 #include "OgreRoot.h"
 
 namespace Ogre {
@@ -40,8 +41,16 @@ namespace Ogre {
         HardwareBuffer::Usage usage,
         bool useShadowBuffer)
     : HardwareIndexBuffer(mgr, idxType, numIndexes, usage, false, false), mLockedToScratch(false),
-        mScratchOffset(0), mScratchSize(0), mScratchPtr(0), mScratchUploadOnUnlock(false)
+        mScratchOffset(0), mScratchSize(0), mScratchPtr(0), mScratchBuffer(0), mScratchUploadOnUnlock(false), mRing(0)
     {
+        GL3PlusHardwareBufferManagerBase* glManager = static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr);
+        if (glManager->usePersistentBufferRing(usage))
+        {
+            mRing = OGRE_NEW GL3PlusPersistentBufferRing(glManager->getStateCacheManager(), GL_ELEMENT_ARRAY_BUFFER, mSizeInBytes);
+            mBufferId = mRing->getGLBufferId();
+            return;
+        }
+
         OGRE_CHECK_GL_ERROR(glGenBuffers(1, &mBufferId));
 
         if (!mBufferId)
@@ -51,7 +60,7 @@ namespace Ogre {
                         "GL3PlusHardwareIndexBuffer::GL3PlusHardwareIndexBuffer");
         }
 
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId));
+        static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
 
         OGRE_CHECK_GL_ERROR(glBufferData(GL_ELEMENT_ARRAY_BUFFER, mSizeInBytes, NULL,
                                          GL3PlusHardwareBufferManager::getGLUsage(usage)));
@@ -60,7 +69,13 @@ namespace Ogre {
 
     GL3PlusHardwareIndexBuffer::~GL3PlusHardwareIndexBuffer()
     {
-        OGRE_CHECK_GL_ERROR(glDeleteBuffers(1, &mBufferId));
+        if (mRing)
+        {
+            OGRE_DELETE mRing;
+            return;
+        }
+
+        static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->deleteGLBuffer(mBufferId);
     }
 
     void* GL3PlusHardwareIndexBuffer::lockImpl(size_t offset,
@@ -74,10 +89,49 @@ namespace Ogre {
                         "GL3PlusHardwareIndexBuffer::lock");
         }
 
+        // Mapping waits for the GPU if it is still using the buffer
+        LockWaitTimer waitTimer(this, length, options);
+
+        if (mRing)
+        {
+            if (options == HBL_READ_ONLY)
+            {
+                // The persistent mapping is write-only, read back through scratch memory
+                mScratchBuffer = HardwareBufferManager::getSingleton().allocateStagingBuffer(length);
+                mScratchPtr = mScratchBuffer->lock(0, length, HBL_DISCARD);
+                readData(offset, length, mScratchPtr);
+                mScratchOffset = offset;
+                mScratchSize = length;
+                mScratchUploadOnUnlock = false;
+                mLockedToScratch = true;
+                mIsLocked = true;
+                return mScratchPtr;
+            }
+
+            // A pointer into the mapped region, no driver round-trip
+            mLockedToScratch = false;
+            mIsLocked = true;
+            return mRing->lock(offset, length, options);
+        }
+
+        if (!(mUsage & HBU_DYNAMIC) && (options == HBL_DISCARD || options == HBL_WRITE_ONLY))
+        {
+            // Static buffers are likely still read by the GPU, mapping them would stall
+            // (or race, if unsynchronised), so stage the data and upload it on unlock
+            mScratchBuffer = HardwareBufferManager::getSingleton().allocateStagingBuffer(length);
+            mScratchPtr = mScratchBuffer->lock(0, length, HBL_DISCARD);
+            mScratchOffset = offset;
+            mScratchSize = length;
+            mScratchUploadOnUnlock = true;
+            mLockedToScratch = true;
+            mIsLocked = true;
+            return mScratchPtr;
+        }
+
         void* retPtr = 0;
         GLenum access = 0;
 
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId));
+        static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
 
         // Use glMapBuffer
         if (mUsage & HBU_WRITE_ONLY)
@@ -129,14 +183,17 @@ namespace Ogre {
                           mScratchOffset == 0 && mScratchSize == getSizeInBytes());
             }
 
-            static_cast<GL3PlusHardwareBufferManager*>(
-                HardwareBufferManager::getSingletonPtr())->deallocateScratch(mScratchPtr);
+            // give the staging buffer back to the pool
+            mScratchBuffer->unlock();
+            HardwareBufferManager::getSingleton().releaseStagingBuffer(mScratchBuffer);
+            mScratchBuffer = 0;
+            mScratchPtr = 0;
 
             mLockedToScratch = false;
         }
-        else
+        else if (!mRing)
         {
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId));
+            static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
 
             if (mUsage & HBU_WRITE_ONLY)
             {
@@ -151,7 +208,6 @@ namespace Ogre {
                             "Buffer data corrupted, please reload",
                             "GL3PlusHardwareIndexBuffer::unlock");
             }
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
         }
         mIsLocked = false;
     }
@@ -169,8 +225,8 @@ namespace Ogre {
         }
         else
         {
-            OGRE_CHECK_GL_ERROR(glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, mBufferId ));
-            OGRE_CHECK_GL_ERROR(glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset, length, pDest));
+            static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
+            OGRE_CHECK_GL_ERROR(glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, getGLBufferOffset() + offset, length, pDest));
         }
     }
 
@@ -178,7 +234,7 @@ namespace Ogre {
                                                const void* pSource,
                                                bool discardWholeBuffer)
     {
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId));
+        static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
 
         // Update the shadow buffer
         if (mUseShadowBuffer)
@@ -189,6 +245,13 @@ namespace Ogre {
             mShadowBuffer->unlock();
         }
 
+        if (mRing)
+        {
+            void* destData = mRing->lock(offset, length, discardWholeBuffer ? HBL_DISCARD : HBL_NORMAL);
+            memcpy(destData, pSource, length);
+            return;
+        }
+
         if (offset == 0 && length == mSizeInBytes)
         {
             OGRE_CHECK_GL_ERROR(glBufferData(GL_ELEMENT_ARRAY_BUFFER, mSizeInBytes, pSource,
@@ -211,55 +274,46 @@ namespace Ogre {
                                               size_t dstOffset, size_t length, bool discardWholeBuffer)
     {
         // If the buffer is not in system memory we can use ARB_copy_buffers to do an optimised copy.
-        if (srcBuffer.isSystemMemory())
+        if (srcBuffer.isSystemMemory() || mRing)
         {
             HardwareBuffer::copyData(srcBuffer, srcOffset, dstOffset, length, discardWholeBuffer);
         }
         else
         {
-            // Unbind the current buffer
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
-
             // Zero out this(destination) buffer
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId));
+            static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
             OGRE_CHECK_GL_ERROR(glBufferData(GL_ELEMENT_ARRAY_BUFFER, length, 0, GL3PlusHardwareBufferManager::getGLUsage(mUsage)));
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 
             // Do it the fast way.
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_READ_BUFFER, static_cast<GL3PlusHardwareIndexBuffer &>(srcBuffer).getGLBufferId()));
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_WRITE_BUFFER, mBufferId));
+            static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_COPY_READ_BUFFER, static_cast<GL3PlusHardwareIndexBuffer &>(srcBuffer).getGLBufferId());
+            static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_COPY_WRITE_BUFFER, mBufferId);
 
-            OGRE_CHECK_GL_ERROR(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, srcOffset, dstOffset, length));
-
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_READ_BUFFER, 0));
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+            OGRE_CHECK_GL_ERROR(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                                    static_cast<GL3PlusHardwareIndexBuffer &>(srcBuffer).getGLBufferOffset() + srcOffset,
+                                                    dstOffset, length));
         }
     }
 
-    void GL3PlusHardwareIndexBuffer::_updateFromShadow(void)
+    void GL3PlusHardwareIndexBuffer::uploadFromShadow(size_t offset, size_t length)
     {
-        if (mUseShadowBuffer && mShadowUpdated && !mSuppressHardwareUpdate)
-        {
-            const void *srcData = mShadowBuffer->lock(mLockStart, mLockSize,
-                                                      HBL_READ_ONLY);
+        const void *srcData = mShadowBuffer->lock(offset, length,
+                                                  HBL_READ_ONLY);
 
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId));
+        static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
 
-            // Update whole buffer if possible, otherwise normal
-            if (mLockStart == 0 && mLockSize == mSizeInBytes)
-            {
-                OGRE_CHECK_GL_ERROR(glBufferData(GL_ELEMENT_ARRAY_BUFFER, mSizeInBytes, srcData,
-                                                 GL3PlusHardwareBufferManager::getGLUsage(mUsage)));
-            }
-            else
-            {
-                OGRE_CHECK_GL_ERROR(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER,
-                                                    mLockStart, mLockSize, srcData));
-            }
-
-            mShadowBuffer->unlock();
-            mShadowUpdated = false;
+        // Update whole buffer if possible, otherwise normal
+        if (offset == 0 && length == mSizeInBytes)
+        {
+            OGRE_CHECK_GL_ERROR(glBufferData(GL_ELEMENT_ARRAY_BUFFER, mSizeInBytes, srcData,
+                                             GL3PlusHardwareBufferManager::getGLUsage(mUsage)));
         }
+        else
+        {
+            OGRE_CHECK_GL_ERROR(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER,
+                                                offset, length, srcData));
+        }
+
+        mShadowBuffer->unlock();
     }
 
 
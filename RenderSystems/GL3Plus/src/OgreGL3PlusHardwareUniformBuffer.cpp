@@ -30,6 +30,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreGL3PlusHardwareUniformBuffer.h"
 #include "OgreRoot.h"
 #include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusStateCacheManager.h"
 
 namespace Ogre {
     GL3PlusHardwareUniformBuffer::GL3PlusHardwareUniformBuffer(
@@ -48,7 +49,7 @@ namespace Ogre {
                         "GL3PlusHardwareUniformBuffer::GL3PlusHardwareUniformBuffer");
         }
 
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_UNIFORM_BUFFER, mBufferId));
+        static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_UNIFORM_BUFFER, mBufferId);
         OGRE_CHECK_GL_ERROR(glBufferData(GL_UNIFORM_BUFFER, mSizeInBytes, NULL,
                                          GL3PlusHardwareBufferManager::getGLUsage(usage)));
 
@@ -57,7 +58,7 @@ namespace Ogre {
 
     GL3PlusHardwareUniformBuffer::~GL3PlusHardwareUniformBuffer()
     {
-        OGRE_CHECK_GL_ERROR(glDeleteBuffers(1, &mBufferId));
+        static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->deleteGLBuffer(mBufferId);
     }
 
     void GL3PlusHardwareUniformBuffer::setGLBufferBinding(GLint binding)
@@ -65,7 +66,7 @@ namespace Ogre {
         mBinding = binding;
 
         // Attach the entire buffer to the UBO binding index.
-        OGRE_CHECK_GL_ERROR(glBindBufferBase(GL_UNIFORM_BUFFER, mBinding, mBufferId));
+        static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBufferBase(GL_UNIFORM_BUFFER, mBinding, mBufferId);
     }
 
     void* GL3PlusHardwareUniformBuffer::lockImpl(size_t offset,
@@ -79,11 +80,14 @@ namespace Ogre {
                         "GL3PlusHardwareUniformBuffer::lock");
         }
 
+        // Mapping waits for the GPU if it is still using the buffer
+        LockWaitTimer waitTimer(this, length, options);
+
         GLenum access = 0;
         void* retPtr = 0;
 
         // Use glMapBuffer
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_UNIFORM_BUFFER, mBufferId));
+        static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_UNIFORM_BUFFER, mBufferId);
 
         if (mUsage & HBU_WRITE_ONLY)
         {
@@ -121,7 +125,7 @@ namespace Ogre {
 
     void GL3PlusHardwareUniformBuffer::unlockImpl(void)
     {
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_UNIFORM_BUFFER, mBufferId));
+        static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_UNIFORM_BUFFER, mBufferId);
 
         if (mUsage & HBU_WRITE_ONLY)
         {
@@ -136,7 +140,6 @@ namespace Ogre {
                         "Buffer data corrupted, please reload",
                         "GL3PlusHardwareUniformBuffer::unlock");
         }
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_UNIFORM_BUFFER, 0));
 
         mIsLocked = false;
     }
@@ -144,7 +147,7 @@ namespace Ogre {
     void GL3PlusHardwareUniformBuffer::readData(size_t offset, size_t length, void* pDest)
     {
         // Get data from the real buffer
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_UNIFORM_BUFFER, mBufferId));
+        static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_UNIFORM_BUFFER, mBufferId);
 
         OGRE_CHECK_GL_ERROR(glGetBufferSubData(GL_UNIFORM_BUFFER, offset, length, pDest));
     }
@@ -154,7 +157,7 @@ namespace Ogre {
                                                  const void* pSource,
                                                  bool discardWholeBuffer)
     {
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_UNIFORM_BUFFER, mBufferId));
+        static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_UNIFORM_BUFFER, mBufferId);
 
         if (offset == 0 && length == mSizeInBytes)
         {
@@ -183,22 +186,15 @@ namespace Ogre {
         }
         else
         {
-            // Unbind the current buffer
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_UNIFORM_BUFFER, 0));
-
             // Zero out this(destination) buffer
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_UNIFORM_BUFFER, mBufferId));
+            static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_UNIFORM_BUFFER, mBufferId);
             OGRE_CHECK_GL_ERROR(glBufferData(GL_UNIFORM_BUFFER, length, 0, GL3PlusHardwareBufferManager::getGLUsage(mUsage)));
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_UNIFORM_BUFFER, 0));
 
             // Do it the fast way.
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_READ_BUFFER, static_cast<GL3PlusHardwareUniformBuffer &>(srcBuffer).getGLBufferId()));
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_WRITE_BUFFER, mBufferId));
+            static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_COPY_READ_BUFFER, static_cast<GL3PlusHardwareUniformBuffer &>(srcBuffer).getGLBufferId());
+            static_cast<GL3PlusHardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_COPY_WRITE_BUFFER, mBufferId);
 
             OGRE_CHECK_GL_ERROR(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, srcOffset, dstOffset, length));
-
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_READ_BUFFER, 0));
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
         }
     }
 
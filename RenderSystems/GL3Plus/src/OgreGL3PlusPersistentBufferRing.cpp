@@ -0,0 +1,134 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreGL3PlusPersistentBufferRing.h"
+#include "OgreGL3PlusStateCacheManager.h"
+
+namespace Ogre {
+
+    // Keeps each region aligned well beyond GL_MIN_MAP_BUFFER_ALIGNMENT and any
+    // vertex attribute or index alignment requirement.
+#define PERSISTENT_REGION_ALIGNMENT 256
+    // Time to wait in a single glClientWaitSync call, in nanoseconds
+#define PERSISTENT_FENCE_TIMEOUT 1000000
+
+    GL3PlusPersistentBufferRing::GL3PlusPersistentBufferRing(GL3PlusStateCacheManager* stateCacheManager,
+                                                             GLenum target, size_t sizeInBytes)
+        : mStateCacheManager(stateCacheManager), mTarget(target), mBufferId(0),
+          mRegionStride(0), mCurrentRegion(0), mMappedPtr(0)
+    {
+        memset(mFences, 0, sizeof(mFences));
+
+        mRegionStride = (sizeInBytes + PERSISTENT_REGION_ALIGNMENT - 1) & ~(size_t)(PERSISTENT_REGION_ALIGNMENT - 1);
+        GLsizeiptr totalSize = mRegionStride * OGRE_GL_PERSISTENT_BUFFER_REGIONS;
+
+        OGRE_CHECK_GL_ERROR(glGenBuffers(1, &mBufferId));
+
+        if (!mBufferId)
+        {
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                        "Cannot create GL persistent buffer",
+                        "GL3PlusPersistentBufferRing::GL3PlusPersistentBufferRing");
+        }
+
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        mStateCacheManager->bindGLBuffer(mTarget, mBufferId);
+        OGRE_CHECK_GL_ERROR(glBufferStorage(mTarget, totalSize, NULL, flags));
+        OGRE_CHECK_GL_ERROR(mMappedPtr = static_cast<uint8*>(glMapBufferRange(mTarget, 0, totalSize, flags)));
+
+        if (!mMappedPtr)
+        {
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                        "Persistent buffer: Out of memory",
+                        "GL3PlusPersistentBufferRing::GL3PlusPersistentBufferRing");
+        }
+    }
+
+    GL3PlusPersistentBufferRing::~GL3PlusPersistentBufferRing()
+    {
+        for (size_t i = 0; i < OGRE_GL_PERSISTENT_BUFFER_REGIONS; ++i)
+        {
+            if (mFences[i])
+                OGRE_CHECK_GL_ERROR(glDeleteSync(mFences[i]));
+        }
+
+        mStateCacheManager->bindGLBuffer(mTarget, mBufferId);
+        OGRE_CHECK_GL_ERROR(glUnmapBuffer(mTarget));
+        mStateCacheManager->deleteGLBuffer(mBufferId);
+    }
+
+    void GL3PlusPersistentBufferRing::fenceRegion(size_t region)
+    {
+        if (mFences[region])
+            OGRE_CHECK_GL_ERROR(glDeleteSync(mFences[region]));
+
+        OGRE_CHECK_GL_ERROR(mFences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    }
+
+    void GL3PlusPersistentBufferRing::waitForRegion(size_t region)
+    {
+        if (!mFences[region])
+            return;
+
+        GLenum result;
+        do
+        {
+            OGRE_CHECK_GL_ERROR(result = glClientWaitSync(mFences[region], GL_SYNC_FLUSH_COMMANDS_BIT,
+                                                          PERSISTENT_FENCE_TIMEOUT));
+        } while (result == GL_TIMEOUT_EXPIRED);
+
+        OGRE_CHECK_GL_ERROR(glDeleteSync(mFences[region]));
+        mFences[region] = 0;
+    }
+
+    void* GL3PlusPersistentBufferRing::lock(size_t offset, size_t length, HardwareBuffer::LockOptions options)
+    {
+        assert(offset + length <= mRegionStride);
+
+        switch (options)
+        {
+        case HardwareBuffer::HBL_DISCARD:
+            // Everything queued so far may read the current region, fence it
+            // and write into the next region instead.
+            fenceRegion(mCurrentRegion);
+            mCurrentRegion = (mCurrentRegion + 1) % OGRE_GL_PERSISTENT_BUFFER_REGIONS;
+            waitForRegion(mCurrentRegion);
+            break;
+        case HardwareBuffer::HBL_NO_OVERWRITE:
+            // The caller promises not to touch data the GPU is using
+            break;
+        default:
+            // Writing in place, wait for the pending reads of the current region
+            fenceRegion(mCurrentRegion);
+            waitForRegion(mCurrentRegion);
+            break;
+        }
+
+        return mMappedPtr + getCurrentOffset() + offset;
+    }
+}
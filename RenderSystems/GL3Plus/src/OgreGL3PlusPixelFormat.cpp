@@ -205,6 +205,34 @@ namespace Ogre  {
             return GL_COMPRESSED_RGBA8_ETC2_EAC;
         case PF_ETC2_RGB8A1:
             return GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2;
+        case PF_ASTC_RGBA_4X4_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
+        case PF_ASTC_RGBA_5X4_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_5x4_KHR;
+        case PF_ASTC_RGBA_5X5_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_5x5_KHR;
+        case PF_ASTC_RGBA_6X5_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_6x5_KHR;
+        case PF_ASTC_RGBA_6X6_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_6x6_KHR;
+        case PF_ASTC_RGBA_8X5_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_8x5_KHR;
+        case PF_ASTC_RGBA_8X6_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_8x6_KHR;
+        case PF_ASTC_RGBA_8X8_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_8x8_KHR;
+        case PF_ASTC_RGBA_10X5_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_10x5_KHR;
+        case PF_ASTC_RGBA_10X6_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_10x6_KHR;
+        case PF_ASTC_RGBA_10X8_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_10x8_KHR;
+        case PF_ASTC_RGBA_10X10_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_10x10_KHR;
+        case PF_ASTC_RGBA_12X10_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_12x10_KHR;
+        case PF_ASTC_RGBA_12X12_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_12x12_KHR;
 
         default:
             return 0;
@@ -493,6 +521,34 @@ namespace Ogre  {
             return GL_COMPRESSED_RGBA8_ETC2_EAC;
         case PF_ETC2_RGB8A1:
             return GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2;
+        case PF_ASTC_RGBA_4X4_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
+        case PF_ASTC_RGBA_5X4_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_5x4_KHR;
+        case PF_ASTC_RGBA_5X5_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_5x5_KHR;
+        case PF_ASTC_RGBA_6X5_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_6x5_KHR;
+        case PF_ASTC_RGBA_6X6_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_6x6_KHR;
+        case PF_ASTC_RGBA_8X5_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_8x5_KHR;
+        case PF_ASTC_RGBA_8X6_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_8x6_KHR;
+        case PF_ASTC_RGBA_8X8_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_8x8_KHR;
+        case PF_ASTC_RGBA_10X5_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_10x5_KHR;
+        case PF_ASTC_RGBA_10X6_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_10x6_KHR;
+        case PF_ASTC_RGBA_10X8_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_10x8_KHR;
+        case PF_ASTC_RGBA_10X10_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_10x10_KHR;
+        case PF_ASTC_RGBA_12X10_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_12x10_KHR;
+        case PF_ASTC_RGBA_12X12_LDR:
+            return GL_COMPRESSED_RGBA_ASTC_12x12_KHR;
 
         default:
             return GL_NONE;
@@ -770,6 +826,34 @@ namespace Ogre  {
             return PF_ETC2_RGBA8;
         case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
             return PF_ETC2_RGB8A1;
+        case GL_COMPRESSED_RGBA_ASTC_4x4_KHR:
+            return PF_ASTC_RGBA_4X4_LDR;
+        case GL_COMPRESSED_RGBA_ASTC_5x4_KHR:
+            return PF_ASTC_RGBA_5X4_LDR;
+        case GL_COMPRESSED_RGBA_ASTC_5x5_KHR:
+            return PF_ASTC_RGBA_5X5_LDR;
+        case GL_COMPRESSED_RGBA_ASTC_6x5_KHR:
+            return PF_ASTC_RGBA_6X5_LDR;
+        case GL_COMPRESSED_RGBA_ASTC_6x6_KHR:
+            return PF_ASTC_RGBA_6X6_LDR;
+        case GL_COMPRESSED_RGBA_ASTC_8x5_KHR:
+            return PF_ASTC_RGBA_8X5_LDR;
+        case GL_COMPRESSED_RGBA_ASTC_8x6_KHR:
+            return PF_ASTC_RGBA_8X6_LDR;
+        case GL_COMPRESSED_RGBA_ASTC_8x8_KHR:
+            return PF_ASTC_RGBA_8X8_LDR;
+        case GL_COMPRESSED_RGBA_ASTC_10x5_KHR:
+            return PF_ASTC_RGBA_10X5_LDR;
+        case GL_COMPRESSED_RGBA_ASTC_10x6_KHR:
+            return PF_ASTC_RGBA_10X6_LDR;
+        case GL_COMPRESSED_RGBA_ASTC_10x8_KHR:
+            return PF_ASTC_RGBA_10X8_LDR;
+        case GL_COMPRESSED_RGBA_ASTC_10x10_KHR:
+            return PF_ASTC_RGBA_10X10_LDR;
+        case GL_COMPRESSED_RGBA_ASTC_12x10_KHR:
+            return PF_ASTC_RGBA_12X10_LDR;
+        case GL_COMPRESSED_RGBA_ASTC_12x12_KHR:
+            return PF_ASTC_RGBA_12X12_LDR;
 
         default:
             return PF_A8R8G8B8;
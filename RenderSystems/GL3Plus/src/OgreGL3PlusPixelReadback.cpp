@@ -0,0 +1,129 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreGL3PlusPixelReadback.h"
+#include "OgreGL3PlusPixelFormat.h"
+#include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusSupport.h"
+#include "OgreGL3PlusStateCacheManager.h"
+#include "OgreRoot.h"
+#include "OgreException.h"
+
+namespace Ogre {
+    GL3PlusPixelReadback::GL3PlusPixelReadback(GLint x, GLint y, uint32 width, uint32 height,
+                                               PixelFormat format, bool flipped)
+        : PixelReadback(width, height, format), mBufferId(0), mFence(0), mFlipped(flipped)
+    {
+        GLenum glFormat = GL3PlusPixelUtil::getGLOriginFormat(format);
+        GLenum glType = GL3PlusPixelUtil::getGLOriginDataType(format);
+
+        if ((glFormat == GL_NONE) || (glType == 0))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Unsupported format", "GL3PlusPixelReadback::GL3PlusPixelReadback");
+        }
+
+        GL3PlusStateCacheManager* stateCacheManager = getGL3PlusSupportRef()->getStateCacheManager();
+
+        OGRE_CHECK_GL_ERROR(glGenBuffers(1, &mBufferId));
+        if (!mBufferId)
+        {
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                        "Cannot create GL pixel pack buffer",
+                        "GL3PlusPixelReadback::GL3PlusPixelReadback");
+        }
+
+        stateCacheManager->bindGLBuffer(GL_PIXEL_PACK_BUFFER, mBufferId);
+        OGRE_CHECK_GL_ERROR(glBufferData(GL_PIXEL_PACK_BUFFER, PixelUtil::getMemorySize(width, height, 1, format),
+                                         NULL, GL_STREAM_READ));
+
+        // Must change the packing to ensure no overruns!
+        OGRE_CHECK_GL_ERROR(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+        OGRE_CHECK_GL_ERROR(glReadPixels(x, y, (GLsizei)width, (GLsizei)height, glFormat, glType, 0));
+        OGRE_CHECK_GL_ERROR(glPixelStorei(GL_PACK_ALIGNMENT, 4));
+
+        OGRE_CHECK_GL_ERROR(mFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+        // Later reads to client memory mustn't land in the buffer
+        stateCacheManager->bindGLBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    GL3PlusPixelReadback::~GL3PlusPixelReadback()
+    {
+        if (mFence)
+            OGRE_CHECK_GL_ERROR(glDeleteSync(mFence));
+        getGL3PlusSupportRef()->getStateCacheManager()->deleteGLBuffer(mBufferId);
+    }
+
+    bool GL3PlusPixelReadback::isReady(void)
+    {
+        if (!mFence)
+            return true;
+
+        // Flush, or the fence might never reach the GPU
+        GLenum result;
+        OGRE_CHECK_GL_ERROR(result = glClientWaitSync(mFence, GL_SYNC_FLUSH_COMMANDS_BIT, 0));
+        if (result == GL_TIMEOUT_EXPIRED)
+            return false;
+
+        OGRE_CHECK_GL_ERROR(glDeleteSync(mFence));
+        mFence = 0;
+        return true;
+    }
+
+    void GL3PlusPixelReadback::read(const PixelBox& dst)
+    {
+        if (dst.getWidth() != mWidth || dst.getHeight() != mHeight || dst.getDepth() != 1)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid box.", "GL3PlusPixelReadback::read");
+        }
+
+        GL3PlusStateCacheManager* stateCacheManager = getGL3PlusSupportRef()->getStateCacheManager();
+        stateCacheManager->bindGLBuffer(GL_PIXEL_PACK_BUFFER, mBufferId);
+
+        // Mapping waits for the copy if it isn't done yet
+        void* pBuffer = 0;
+        OGRE_CHECK_GL_ERROR(pBuffer = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+            PixelUtil::getMemorySize(mWidth, mHeight, 1, mFormat), GL_MAP_READ_BIT));
+
+        if (pBuffer == 0)
+        {
+            stateCacheManager->bindGLBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                        "Pixel pack buffer: Out of memory",
+                        "GL3PlusPixelReadback::read");
+        }
+
+        PixelUtil::bulkPixelConversion(PixelBox(mWidth, mHeight, 1, mFormat, pBuffer), dst);
+
+        OGRE_CHECK_GL_ERROR(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+        stateCacheManager->bindGLBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        if (mFlipped)
+            PixelUtil::bulkPixelVerticalFlip(dst);
+    }
+}
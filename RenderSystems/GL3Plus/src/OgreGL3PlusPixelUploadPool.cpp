@@ -0,0 +1,165 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreGL3PlusPixelUploadPool.h"
+#include "OgreGL3PlusStateCacheManager.h"
+#include "OgreException.h"
+
+namespace Ogre {
+
+    // Staging buffers are allocated in steps of this size, so that they fit
+    // later uploads of similar sizes
+#define PIXEL_UPLOAD_GRANULARITY (64 * 1024)
+
+    GL3PlusPixelUploadPool::GL3PlusPixelUploadPool(GL3PlusStateCacheManager* stateCacheManager)
+        : mStateCacheManager(stateCacheManager), mPooledBytes(0)
+    {
+    }
+
+    GL3PlusPixelUploadPool::~GL3PlusPixelUploadPool()
+    {
+        for (StagingBufferList::iterator i = mBuffers.begin(); i != mBuffers.end(); ++i)
+        {
+            if (i->fence)
+                OGRE_CHECK_GL_ERROR(glDeleteSync(i->fence));
+            mStateCacheManager->deleteGLBuffer(i->bufferId);
+        }
+    }
+
+    bool GL3PlusPixelUploadPool::isIdle(StagingBuffer& buffer)
+    {
+        if (!buffer.fence)
+            return true;
+
+        GLenum result;
+        OGRE_CHECK_GL_ERROR(result = glClientWaitSync(buffer.fence, 0, 0));
+        if (result == GL_TIMEOUT_EXPIRED)
+            return false;
+
+        OGRE_CHECK_GL_ERROR(glDeleteSync(buffer.fence));
+        buffer.fence = 0;
+        return true;
+    }
+
+    void* GL3PlusPixelUploadPool::map(size_t sizeInBytes, GLuint& bufferId)
+    {
+        OGRE_LOCK_MUTEX(mMutex);
+
+        // Smallest idle buffer large enough
+        StagingBuffer* buffer = 0;
+        for (StagingBufferList::iterator i = mBuffers.begin(); i != mBuffers.end(); ++i)
+        {
+            if (!i->inUse && i->size >= sizeInBytes && (!buffer || i->size < buffer->size) && isIdle(*i))
+                buffer = &*i;
+        }
+
+        if (!buffer)
+        {
+            StagingBuffer newBuffer;
+            newBuffer.size = (sizeInBytes + PIXEL_UPLOAD_GRANULARITY - 1) & ~(size_t)(PIXEL_UPLOAD_GRANULARITY - 1);
+            newBuffer.fence = 0;
+            newBuffer.inUse = false;
+            OGRE_CHECK_GL_ERROR(glGenBuffers(1, &newBuffer.bufferId));
+            if (!newBuffer.bufferId)
+            {
+                OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                            "Cannot create GL pixel unpack buffer",
+                            "GL3PlusPixelUploadPool::map");
+            }
+
+            mStateCacheManager->bindGLBuffer(GL_PIXEL_UNPACK_BUFFER, newBuffer.bufferId);
+            OGRE_CHECK_GL_ERROR(glBufferData(GL_PIXEL_UNPACK_BUFFER, newBuffer.size, NULL, GL_STREAM_DRAW));
+
+            mBuffers.push_back(newBuffer);
+            mPooledBytes += newBuffer.size;
+            buffer = &mBuffers.back();
+        }
+        else
+        {
+            mStateCacheManager->bindGLBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->bufferId);
+        }
+
+        buffer->inUse = true;
+        bufferId = buffer->bufferId;
+
+        // The GPU is done with the buffer, no need for the driver to synchronise
+        void* pBuffer = 0;
+        OGRE_CHECK_GL_ERROR(pBuffer = glMapBufferRange(
+            GL_PIXEL_UNPACK_BUFFER, 0, sizeInBytes,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+
+        if (pBuffer == 0)
+        {
+            buffer->inUse = false;
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                        "Pixel upload buffer: Out of memory",
+                        "GL3PlusPixelUploadPool::map");
+        }
+
+        return pBuffer;
+    }
+
+    void GL3PlusPixelUploadPool::unmap(GLuint bufferId)
+    {
+        mStateCacheManager->bindGLBuffer(GL_PIXEL_UNPACK_BUFFER, bufferId);
+
+        GLboolean mapped = false;
+        OGRE_CHECK_GL_ERROR(mapped = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+        if (!mapped)
+        {
+            release(bufferId);
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                        "Buffer data corrupted, please reload",
+                        "GL3PlusPixelUploadPool::unmap");
+        }
+    }
+
+    void GL3PlusPixelUploadPool::release(GLuint bufferId)
+    {
+        OGRE_LOCK_MUTEX(mMutex);
+
+        for (StagingBufferList::iterator i = mBuffers.begin(); i != mBuffers.end(); ++i)
+        {
+            if (i->bufferId != bufferId)
+                continue;
+
+            if (mPooledBytes > OGRE_GL_PIXEL_UPLOAD_POOL_SIZE)
+            {
+                // Over budget, GL keeps the storage alive until the pending uploads are done
+                mPooledBytes -= i->size;
+                mStateCacheManager->deleteGLBuffer(i->bufferId);
+                mBuffers.erase(i);
+                return;
+            }
+
+            OGRE_CHECK_GL_ERROR(i->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+            i->inUse = false;
+            return;
+        }
+    }
+}
@@ -46,6 +46,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreException.h"
 #include "OgreGLSLExtSupport.h"
 #include "OgreGL3PlusHardwareOcclusionQuery.h"
+#include "OgreGL3PlusGpuDrawCuller.h"
 #include "OgreGL3PlusDepthBuffer.h"
 #include "OgreGL3PlusHardwarePixelBuffer.h"
 #include "OgreGLContext.h"
@@ -58,8 +59,11 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreGL3PlusVertexArrayObject.h"
 #include "OgreRoot.h"
 #include "OgreConfig.h"
+#include "OgreSoftwareOcclusionCuller.h"
 #include "OgreViewport.h"
 #include "OgreGL3PlusPixelFormat.h"
+#include "OgreGL3PlusPixelReadback.h"
+#include "OgreGL3PlusStateCacheManager.h"
 
 #ifndef GL_EXT_texture_filter_anisotropic
 #define GL_TEXTURE_MAX_ANISOTROPY_EXT     0x84FE
@@ -131,17 +135,25 @@ namespace Ogre {
           mGLSLShaderFactory(0),
           mHardwareBufferManager(0),
           mRTTManager(0),
-          mActiveTextureUnit(0)
+          mHasTimerQuery(false),
+          mIndirectBuffer(0),
+          mIndirectBufferSize(0),
+          mGpuDrawCullProgram(0),
+          mGpuCullDepthBuffer(0),
+          mGpuCullDepthSource(0),
+          mGpuCullDepthFrame(0)
     {
         size_t i;
 
         LogManager::getSingleton().logMessage(getName() + " created.");
 
-        mRenderAttribsBound.reserve(100);
-        mRenderInstanceAttribsBound.reserve(100);
+        mVertexAttribBindings.reserve(16);
+
+        mStateCacheManager = OGRE_NEW GL3PlusStateCacheManager();
 
         // Get our GLSupport
         mGLSupport = new GL3PlusSupport(getGLSupport());
+        mGLSupport->setStateCacheManager(mStateCacheManager);
         glsupport = mGLSupport;
 
         mWorldMatrix = Matrix4::IDENTITY;
@@ -201,6 +213,14 @@ namespace Ogre {
     void GL3PlusRenderSystem::initConfigOptions(void)
     {
         mGLSupport->addConfig();
+
+        ConfigOption optParallelCompile;
+        optParallelCompile.name = "Parallel Shader Compilation";
+        optParallelCompile.immutable = false;
+        optParallelCompile.possibleValues.push_back("No");
+        optParallelCompile.possibleValues.push_back("Yes");
+        optParallelCompile.currentValue = optParallelCompile.possibleValues[0];
+        mGLSupport->getConfigOptions()[optParallelCompile.name] = optParallelCompile;
     }
 
     ConfigOptionMap& GL3PlusRenderSystem::getConfigOptions(void)
@@ -224,6 +244,11 @@ namespace Ogre {
     {
         mGLSupport->start();
 
+        if (!mStateCacheManager)
+            mStateCacheManager = OGRE_NEW GL3PlusStateCacheManager();
+
+        mGLSupport->setStateCacheManager(mStateCacheManager);
+
         RenderWindow *autoWindow = mGLSupport->createWindow(autoCreateWindow,
                                                             this, windowTitle);
         RenderSystem::_initialise(autoCreateWindow, windowTitle);
@@ -291,6 +316,12 @@ namespace Ogre {
         // Vertex Array Objects are supported in 3.0
         rsc->setCapability(RSC_VAO);
 
+        // Multi-draw indirect needs base instance too, so that each command can
+        // address its own range of per instance data
+        if ((mHasGL43 || mGLSupport->checkExtension("GL_ARB_multi_draw_indirect")) &&
+            (hasGL42 || mGLSupport->checkExtension("GL_ARB_base_instance")))
+            rsc->setCapability(RSC_MULTI_DRAW_INDIRECT);
+
         // Check for texture compression
         rsc->setCapability(RSC_TEXTURE_COMPRESSION);
 
@@ -321,6 +352,12 @@ namespace Ogre {
             rsc->setCapability(RSC_TEXTURE_COMPRESSION_BC6H_BC7);
         }
 
+        // ASTC is only available through the extension, mostly on mobile GPUs
+        if (mGLSupport->checkExtension("GL_KHR_texture_compression_astc_ldr"))
+        {
+            rsc->setCapability(RSC_TEXTURE_COMPRESSION_ASTC);
+        }
+
         rsc->setCapability(RSC_FBO);
         rsc->setCapability(RSC_HWRENDER_TO_TEXTURE);
         // Probe number of draw buffers
@@ -552,6 +589,27 @@ namespace Ogre {
             mShaderManager->setSaveMicrocodesToCache(true);
         }
 
+        // Compile programs without waiting for the driver, if allowed
+        ConfigOptionMap::iterator parallelCompile = getConfigOptions().find("Parallel Shader Compilation");
+        if (parallelCompile != getConfigOptions().end() && parallelCompile->second.currentValue == "Yes" &&
+            !caps->hasCapability(RSC_SEPARATE_SHADER_OBJECTS))
+        {
+            typedef void (APIENTRYP MaxShaderCompilerThreadsProc)(GLuint count);
+            MaxShaderCompilerThreadsProc maxThreads = 0;
+            if (mGLSupport->checkExtension("GL_KHR_parallel_shader_compile"))
+                maxThreads = (MaxShaderCompilerThreadsProc)get_proc("glMaxShaderCompilerThreadsKHR");
+            else if (mGLSupport->checkExtension("GL_ARB_parallel_shader_compile"))
+                maxThreads = (MaxShaderCompilerThreadsProc)get_proc("glMaxShaderCompilerThreadsARB");
+
+            if (maxThreads)
+            {
+                // Let the driver pick the number of threads
+                maxThreads(0xFFFFFFFF);
+                GLSLMonolithicProgramManager::getSingleton().setParallelCompile(true);
+                LogManager::getSingleton().logMessage("GL3+: Compiling GLSL programs in parallel");
+            }
+        }
+
         mGLInitialised = true;
     }
 
@@ -569,6 +627,15 @@ namespace Ogre {
             mGLSLShaderFactory = 0;
         }
 
+        // Shared parameter sets may outlive the buffer manager, release their uniform buffers first
+        if (mShaderManager)
+        {
+            const GpuProgramManager::SharedParametersMap& sharedParamsMap = mShaderManager->getAvailableSharedParameters();
+            GpuProgramManager::SharedParametersMap::const_iterator i, iend = sharedParamsMap.end();
+            for (i = sharedParamsMap.begin(); i != iend; ++i)
+                i->second->_setRenderSystemData(Any());
+        }
+
         // Deleting the GPU program manager and hardware buffer manager.  Has to be done before the mGLSupport->stop().
         OGRE_DELETE mShaderManager;
         mShaderManager = 0;
@@ -582,6 +649,32 @@ namespace Ogre {
         OGRE_DELETE mTextureManager;
         mTextureManager = 0;
 
+        if (mIndirectBuffer)
+        {
+            mStateCacheManager->deleteGLBuffer(mIndirectBuffer);
+            mIndirectBuffer = 0;
+            mIndirectBufferSize = 0;
+        }
+
+        if (mGpuDrawCullProgram)
+        {
+            mStateCacheManager->bindGLProgram(0);
+            OGRE_CHECK_GL_ERROR(glDeleteProgram(mGpuDrawCullProgram));
+            mGpuDrawCullProgram = 0;
+        }
+        mStateCacheManager->deleteGLBuffer(mGpuCullDepthBuffer);
+        mGpuCullDepthBuffer = 0;
+        mGpuCullDepthSource = 0;
+
+        for (size_t i = 0; i < mGpuTimers.size(); ++i)
+            OGRE_CHECK_GL_ERROR(glDeleteQueries(2, mGpuTimers[i].queries));
+        mGpuTimers.clear();
+        mFreeGpuTimers.clear();
+
+        for (size_t i = 0; i < mFrameFences.size(); ++i)
+            OGRE_CHECK_GL_ERROR(glDeleteSync(mFrameFences[i]));
+        mFrameFences.clear();
+
         // Delete extra threads contexts
         for (GL3PlusContextList::iterator i = mBackgroundContextList.begin();
              i != mBackgroundContextList.end(); ++i)
@@ -600,6 +693,10 @@ namespace Ogre {
         // delete mTextureManager;
         // mTextureManager = 0;
 
+        OGRE_DELETE mStateCacheManager;
+        mStateCacheManager = 0;
+        mGLSupport->setStateCacheManager(0);
+
         mGLInitialised = 0;
 
         // RenderSystem::shutdown();
@@ -864,11 +961,11 @@ namespace Ogre {
             // val[2] = quadratic * correction;
             // val[3] = 1;
 
-            OGRE_CHECK_GL_ERROR(glEnable(GL_PROGRAM_POINT_SIZE));
+            mStateCacheManager->setEnabled(GL_PROGRAM_POINT_SIZE, true);
         }
         else
         {
-            OGRE_CHECK_GL_ERROR(glDisable(GL_PROGRAM_POINT_SIZE));
+            mStateCacheManager->setEnabled(GL_PROGRAM_POINT_SIZE, false);
         }
 
         OGRE_CHECK_GL_ERROR(glPointSize(size));
@@ -884,7 +981,7 @@ namespace Ogre {
     {
         GL3PlusTexturePtr tex = texPtr.staticCast<GL3PlusTexture>();
 
-        if (!activateGLTextureUnit(stage))
+        if (!mStateCacheManager->activateGLTextureUnit(stage))
             return;
 
         if (enabled)
@@ -904,20 +1001,18 @@ namespace Ogre {
 
             if (!tex.isNull())
             {
-                OGRE_CHECK_GL_ERROR(glBindTexture( mTextureTypes[stage], tex->getGLID() ));
+                mStateCacheManager->bindGLTexture( mTextureTypes[stage], tex->getGLID() );
             }
             else
             {
-                OGRE_CHECK_GL_ERROR(glBindTexture( mTextureTypes[stage], static_cast<GL3PlusTextureManager*>(mTextureManager)->getWarningTextureID() ));
+                mStateCacheManager->bindGLTexture( mTextureTypes[stage], static_cast<GL3PlusTextureManager*>(mTextureManager)->getWarningTextureID() );
             }
         }
         else
         {
             // Bind zero texture.
-            OGRE_CHECK_GL_ERROR(glBindTexture(GL_TEXTURE_2D, 0));
+            mStateCacheManager->bindGLTexture(GL_TEXTURE_2D, 0);
         }
-
-        activateGLTextureUnit(0);
     }
 
     void GL3PlusRenderSystem::_setVertexTexture( size_t unit, const TexturePtr &tex )
@@ -968,31 +1063,27 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::_setTextureAddressingMode(size_t stage, const TextureUnitState::UVWAddressingMode& uvw)
     {
-        if (!activateGLTextureUnit(stage))
+        if (!mStateCacheManager->activateGLTextureUnit(stage))
             return;
-        OGRE_CHECK_GL_ERROR(glTexParameteri( mTextureTypes[stage], GL_TEXTURE_WRAP_S, getTextureAddressingMode(uvw.u)));
-        OGRE_CHECK_GL_ERROR(glTexParameteri( mTextureTypes[stage], GL_TEXTURE_WRAP_T, getTextureAddressingMode(uvw.v)));
-        OGRE_CHECK_GL_ERROR(glTexParameteri( mTextureTypes[stage], GL_TEXTURE_WRAP_R, getTextureAddressingMode(uvw.w)));
-
-        activateGLTextureUnit(0);
+        mStateCacheManager->setTexParameteri(mTextureTypes[stage], GL_TEXTURE_WRAP_S, getTextureAddressingMode(uvw.u));
+        mStateCacheManager->setTexParameteri(mTextureTypes[stage], GL_TEXTURE_WRAP_T, getTextureAddressingMode(uvw.v));
+        mStateCacheManager->setTexParameteri(mTextureTypes[stage], GL_TEXTURE_WRAP_R, getTextureAddressingMode(uvw.w));
     }
 
     void GL3PlusRenderSystem::_setTextureBorderColour(size_t stage, const ColourValue& colour)
     {
         GLfloat border[4] = { colour.r, colour.g, colour.b, colour.a };
-        if (activateGLTextureUnit(stage))
+        if (mStateCacheManager->activateGLTextureUnit(stage))
         {
             OGRE_CHECK_GL_ERROR(glTexParameterfv( mTextureTypes[stage], GL_TEXTURE_BORDER_COLOR, border));
-            activateGLTextureUnit(0);
         }
     }
 
     void GL3PlusRenderSystem::_setTextureMipmapBias(size_t stage, float bias)
     {
-        if (activateGLTextureUnit(stage))
+        if (mStateCacheManager->activateGLTextureUnit(stage))
         {
             OGRE_CHECK_GL_ERROR(glTexParameterf(mTextureTypes[stage], GL_TEXTURE_LOD_BIAS, bias));
-            activateGLTextureUnit(0);
         }
     }
 
@@ -1032,12 +1123,12 @@ namespace Ogre {
         GLenum destBlend = getBlendMode(destFactor);
         if (sourceFactor == SBF_ONE && destFactor == SBF_ZERO)
         {
-            OGRE_CHECK_GL_ERROR(glDisable(GL_BLEND));
+            mStateCacheManager->setEnabled(GL_BLEND, false);
         }
         else
         {
-            OGRE_CHECK_GL_ERROR(glEnable(GL_BLEND));
-            OGRE_CHECK_GL_ERROR(glBlendFunc(sourceBlend, destBlend));
+            mStateCacheManager->setEnabled(GL_BLEND, true);
+            mStateCacheManager->setBlendFunc(sourceBlend, destBlend, sourceBlend, destBlend);
         }
 
         GLint func = GL_FUNC_ADD;
@@ -1060,7 +1151,7 @@ namespace Ogre {
             break;
         }
 
-        OGRE_CHECK_GL_ERROR(glBlendEquation(func));
+        mStateCacheManager->setBlendEquation(func, func);
     }
 
     void GL3PlusRenderSystem::_setSeparateSceneBlending(
@@ -1076,12 +1167,12 @@ namespace Ogre {
         if (sourceFactor == SBF_ONE && destFactor == SBF_ZERO &&
             sourceFactorAlpha == SBF_ONE && destFactorAlpha == SBF_ZERO)
         {
-            OGRE_CHECK_GL_ERROR(glDisable(GL_BLEND));
+            mStateCacheManager->setEnabled(GL_BLEND, false);
         }
         else
         {
-            OGRE_CHECK_GL_ERROR(glEnable(GL_BLEND));
-            OGRE_CHECK_GL_ERROR(glBlendFuncSeparate(sourceBlend, destBlend, sourceBlendAlpha, destBlendAlpha));
+            mStateCacheManager->setEnabled(GL_BLEND, true);
+            mStateCacheManager->setBlendFunc(sourceBlend, destBlend, sourceBlendAlpha, destBlendAlpha);
         }
 
         GLint func = GL_FUNC_ADD, alphaFunc = GL_FUNC_ADD;
@@ -1124,32 +1215,19 @@ namespace Ogre {
             break;
         }
 
-        OGRE_CHECK_GL_ERROR(glBlendEquationSeparate(func, alphaFunc));
+        mStateCacheManager->setBlendEquation(func, alphaFunc);
     }
 
     void GL3PlusRenderSystem::_setAlphaRejectSettings(CompareFunction func, unsigned char value, bool alphaToCoverage)
     {
         bool a2c = false;
-        static bool lasta2c = false;
 
         if (func != CMPF_ALWAYS_PASS)
         {
             a2c = alphaToCoverage;
         }
 
-        if (a2c != lasta2c)
-        {
-            if (a2c)
-            {
-                OGRE_CHECK_GL_ERROR(glEnable(GL_SAMPLE_ALPHA_TO_COVERAGE));
-            }
-            else
-            {
-                OGRE_CHECK_GL_ERROR(glDisable(GL_SAMPLE_ALPHA_TO_COVERAGE));
-            }
-
-            lasta2c = a2c;
-        }
+        mStateCacheManager->setEnabled(GL_SAMPLE_ALPHA_TO_COVERAGE, a2c);
     }
 
     void GL3PlusRenderSystem::_setViewport(Viewport *vp)
@@ -1183,7 +1261,7 @@ namespace Ogre {
                 y = target->getHeight() - h - y;
             }
 
-            OGRE_CHECK_GL_ERROR(glViewport(x, y, w, h));
+            mStateCacheManager->setViewport(x, y, w, h);
 
             // Configure the viewport clipping
             OGRE_CHECK_GL_ERROR(glScissor(x, y, w, h));
@@ -1200,16 +1278,16 @@ namespace Ogre {
                         "GL3PlusRenderSystem::_beginFrame");
 
         mScissorsEnabled = true;
-        OGRE_CHECK_GL_ERROR(glEnable(GL_SCISSOR_TEST));
+        mStateCacheManager->setEnabled(GL_SCISSOR_TEST, true);
     }
 
     void GL3PlusRenderSystem::_endFrame(void)
     {
         // Deactivate the viewport clipping.
         mScissorsEnabled = false;
-        OGRE_CHECK_GL_ERROR(glDisable(GL_SCISSOR_TEST));
+        mStateCacheManager->setEnabled(GL_SCISSOR_TEST, false);
 
-        OGRE_CHECK_GL_ERROR(glDisable(GL_DEPTH_CLAMP));
+        mStateCacheManager->setEnabled(GL_DEPTH_CLAMP, false);
 
         // unbind GPU programs at end of frame
         // this is mostly to avoid holding bound programs that might get deleted
@@ -1241,7 +1319,7 @@ namespace Ogre {
         switch( mode )
         {
         case CULL_NONE:
-            OGRE_CHECK_GL_ERROR(glDisable(GL_CULL_FACE));
+            mStateCacheManager->setEnabled(GL_CULL_FACE, false);
             return;
 
         default:
@@ -1271,8 +1349,8 @@ namespace Ogre {
             break;
         }
 
-        OGRE_CHECK_GL_ERROR(glEnable(GL_CULL_FACE));
-        OGRE_CHECK_GL_ERROR(glCullFace(cullMode));
+        mStateCacheManager->setEnabled(GL_CULL_FACE, true);
+        mStateCacheManager->setCullFace(cullMode);
     }
 
     void GL3PlusRenderSystem::_setDepthBufferParams(bool depthTest, bool depthWrite, CompareFunction depthFunction)
@@ -1286,19 +1364,14 @@ namespace Ogre {
     {
         if (enabled)
         {
-            OGRE_CHECK_GL_ERROR(glClearDepth(1.0));
-            OGRE_CHECK_GL_ERROR(glEnable(GL_DEPTH_TEST));
-        }
-        else
-        {
-            OGRE_CHECK_GL_ERROR(glDisable(GL_DEPTH_TEST));
+            mStateCacheManager->setClearDepth(1.0f);
         }
+        mStateCacheManager->setEnabled(GL_DEPTH_TEST, enabled);
     }
 
     void GL3PlusRenderSystem::_setDepthBufferWriteEnabled(bool enabled)
     {
-        GLboolean flag = enabled ? GL_TRUE : GL_FALSE;
-        OGRE_CHECK_GL_ERROR(glDepthMask(flag));
+        mStateCacheManager->setDepthMask(enabled ? GL_TRUE : GL_FALSE);
 
         // Store for reference in _beginFrame
         mDepthWrite = enabled;
@@ -1306,30 +1379,25 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::_setDepthBufferFunction(CompareFunction func)
     {
-        OGRE_CHECK_GL_ERROR(glDepthFunc(convertCompareFunction(func)));
+        mStateCacheManager->setDepthFunc(convertCompareFunction(func));
     }
 
     void GL3PlusRenderSystem::_setDepthBias(float constantBias, float slopeScaleBias)
     {
         //FIXME glPolygonOffset currently is buggy in GL3+ RS but not GL RS.
-        if (constantBias != 0 || slopeScaleBias != 0)
+        bool enabled = constantBias != 0 || slopeScaleBias != 0;
+        mStateCacheManager->setEnabled(GL_POLYGON_OFFSET_FILL, enabled);
+        mStateCacheManager->setEnabled(GL_POLYGON_OFFSET_POINT, enabled);
+        mStateCacheManager->setEnabled(GL_POLYGON_OFFSET_LINE, enabled);
+        if (enabled)
         {
-            OGRE_CHECK_GL_ERROR(glEnable(GL_POLYGON_OFFSET_FILL));
-            OGRE_CHECK_GL_ERROR(glEnable(GL_POLYGON_OFFSET_POINT));
-            OGRE_CHECK_GL_ERROR(glEnable(GL_POLYGON_OFFSET_LINE));
             OGRE_CHECK_GL_ERROR(glPolygonOffset(-slopeScaleBias, -constantBias));
         }
-        else
-        {
-            OGRE_CHECK_GL_ERROR(glDisable(GL_POLYGON_OFFSET_FILL));
-            OGRE_CHECK_GL_ERROR(glDisable(GL_POLYGON_OFFSET_POINT));
-            OGRE_CHECK_GL_ERROR(glDisable(GL_POLYGON_OFFSET_LINE));
-        }
     }
 
     void GL3PlusRenderSystem::_setColourBufferWriteEnabled(bool red, bool green, bool blue, bool alpha)
     {
-        OGRE_CHECK_GL_ERROR(glColorMask(red, green, blue, alpha));
+        mStateCacheManager->setColourMask(red, green, blue, alpha);
 
         // record this
         mColourWrite[0] = red;
@@ -1345,6 +1413,56 @@ namespace Ogre {
         return ret;
     }
 
+    GpuDrawCuller* GL3PlusRenderSystem::createGpuDrawCuller(void)
+    {
+        if (!mCurrentCapabilities->hasCapability(RSC_COMPUTE_PROGRAM) ||
+            !mCurrentCapabilities->hasCapability(RSC_MULTI_DRAW_INDIRECT))
+            return 0;
+        return OGRE_NEW GL3PlusGpuDrawCuller(this);
+    }
+
+    GLuint GL3PlusRenderSystem::_getGpuDrawCullProgram(void)
+    {
+        if (!mGpuDrawCullProgram)
+            mGpuDrawCullProgram = GL3PlusGpuDrawCuller::_createProgram();
+        return mGpuDrawCullProgram;
+    }
+
+    GLuint GL3PlusRenderSystem::_uploadGpuCullDepth(const SoftwareOcclusionCuller* occlusion, const Matrix4& viewProj)
+    {
+        unsigned long frame = Root::getSingleton().getNextFrameNumber();
+        if (mGpuCullDepthBuffer && occlusion == mGpuCullDepthSource && frame == mGpuCullDepthFrame &&
+            viewProj == mGpuCullDepthViewProj)
+            return mGpuCullDepthBuffer;
+
+        size_t total = 0;
+        for (size_t l = 0; l < occlusion->getNumDepthLevels(); ++l)
+        {
+            uint32 width, height;
+            occlusion->getDepthLevel(l, width, height);
+            total += width * height;
+        }
+
+        if (!mGpuCullDepthBuffer)
+            OGRE_CHECK_GL_ERROR(glGenBuffers(1, &mGpuCullDepthBuffer));
+        mStateCacheManager->bindGLBuffer(GL_SHADER_STORAGE_BUFFER, mGpuCullDepthBuffer);
+        OGRE_CHECK_GL_ERROR(glBufferData(GL_SHADER_STORAGE_BUFFER, total * sizeof(float), NULL, GL_STREAM_DRAW));
+        size_t offset = 0;
+        for (size_t l = 0; l < occlusion->getNumDepthLevels(); ++l)
+        {
+            uint32 width, height;
+            const float* depths = occlusion->getDepthLevel(l, width, height);
+            OGRE_CHECK_GL_ERROR(glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset * sizeof(float),
+                                                width * height * sizeof(float), depths));
+            offset += width * height;
+        }
+
+        mGpuCullDepthSource = occlusion;
+        mGpuCullDepthFrame = frame;
+        mGpuCullDepthViewProj = viewProj;
+        return mGpuCullDepthBuffer;
+    }
+
     void GL3PlusRenderSystem::_setPolygonMode(PolygonMode level)
     {
         switch(level)
@@ -1362,19 +1480,12 @@ namespace Ogre {
             mPolygonMode = GL_FILL;
             break;
         }
-        OGRE_CHECK_GL_ERROR(glPolygonMode(GL_FRONT_AND_BACK, mPolygonMode));
+        mStateCacheManager->setPolygonMode(mPolygonMode);
     }
 
     void GL3PlusRenderSystem::setStencilCheckEnabled(bool enabled)
     {
-        if (enabled)
-        {
-            OGRE_CHECK_GL_ERROR(glEnable(GL_STENCIL_TEST));
-        }
-        else
-        {
-            OGRE_CHECK_GL_ERROR(glDisable(GL_STENCIL_TEST));
-        }
+        mStateCacheManager->setEnabled(GL_STENCIL_TEST, enabled);
     }
 
     void GL3PlusRenderSystem::setStencilBufferParams(CompareFunction func,
@@ -1398,8 +1509,10 @@ namespace Ogre {
             // culling mode. Therefore, we must take care with two-sided stencil settings.
             flip = (mInvertVertexWinding && !mActiveRenderTarget->requiresTextureFlipping()) ||
                 (!mInvertVertexWinding && mActiveRenderTarget->requiresTextureFlipping());
+            // Both faces share the same write mask
+            mStateCacheManager->setStencilMask(writeMask);
+
             // Back
-            OGRE_CHECK_GL_ERROR(glStencilMaskSeparate(GL_BACK, writeMask));
             OGRE_CHECK_GL_ERROR(glStencilFuncSeparate(GL_BACK, convertCompareFunction(func), refValue, compareMask));
             OGRE_CHECK_GL_ERROR(glStencilOpSeparate(GL_BACK,
                                                     convertStencilOp(stencilFailOp, !flip),
@@ -1407,7 +1520,6 @@ namespace Ogre {
                                                     convertStencilOp(passOp, !flip)));
 
             // Front
-            OGRE_CHECK_GL_ERROR(glStencilMaskSeparate(GL_FRONT, writeMask));
             OGRE_CHECK_GL_ERROR(glStencilFuncSeparate(GL_FRONT, convertCompareFunction(func), refValue, compareMask));
             OGRE_CHECK_GL_ERROR(glStencilOpSeparate(GL_FRONT,
                                                     convertStencilOp(stencilFailOp, flip),
@@ -1417,7 +1529,7 @@ namespace Ogre {
         else
         {
             flip = false;
-            OGRE_CHECK_GL_ERROR(glStencilMask(writeMask));
+            mStateCacheManager->setStencilMask(writeMask);
             OGRE_CHECK_GL_ERROR(glStencilFunc(convertCompareFunction(func), refValue, compareMask));
             OGRE_CHECK_GL_ERROR(glStencilOp(
                 convertStencilOp(stencilFailOp, flip),
@@ -1470,7 +1582,7 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::_setTextureUnitFiltering(size_t unit, FilterType ftype, FilterOptions fo)
     {
-        if (!activateGLTextureUnit(unit))
+        if (!mStateCacheManager->activateGLTextureUnit(unit))
             return;
 
         switch (ftype)
@@ -1479,9 +1591,7 @@ namespace Ogre {
             mMinFilter = fo;
 
             // Combine with existing mip filter
-            OGRE_CHECK_GL_ERROR(glTexParameteri(mTextureTypes[unit],
-                                                GL_TEXTURE_MIN_FILTER,
-                                                getCombinedMinMipFilter()));
+            mStateCacheManager->setTexParameteri(mTextureTypes[unit], GL_TEXTURE_MIN_FILTER, getCombinedMinMipFilter());
             break;
 
         case FT_MAG:
@@ -1489,15 +1599,11 @@ namespace Ogre {
             {
             case FO_ANISOTROPIC: // GL treats linear and aniso the same
             case FO_LINEAR:
-                OGRE_CHECK_GL_ERROR(glTexParameteri(mTextureTypes[unit],
-                                                    GL_TEXTURE_MAG_FILTER,
-                                                    GL_LINEAR));
+                mStateCacheManager->setTexParameteri(mTextureTypes[unit], GL_TEXTURE_MAG_FILTER, GL_LINEAR);
                 break;
             case FO_POINT:
             case FO_NONE:
-                OGRE_CHECK_GL_ERROR(glTexParameteri(mTextureTypes[unit],
-                                                    GL_TEXTURE_MAG_FILTER,
-                                                    GL_NEAREST));
+                mStateCacheManager->setTexParameteri(mTextureTypes[unit], GL_TEXTURE_MAG_FILTER, GL_NEAREST);
                 break;
             }
             break;
@@ -1505,13 +1611,9 @@ namespace Ogre {
             mMipFilter = fo;
 
             // Combine with existing min filter
-            OGRE_CHECK_GL_ERROR(glTexParameteri(mTextureTypes[unit],
-                                                GL_TEXTURE_MIN_FILTER,
-                                                getCombinedMinMipFilter()));
+            mStateCacheManager->setTexParameteri(mTextureTypes[unit], GL_TEXTURE_MIN_FILTER, getCombinedMinMipFilter());
             break;
         }
-
-        activateGLTextureUnit(0);
     }
 
     GLfloat GL3PlusRenderSystem::_getCurrentAnisotropy(size_t unit)
@@ -1541,14 +1643,11 @@ namespace Ogre {
         if (!mCurrentCapabilities->hasCapability(RSC_ANISOTROPY))
             return;
 
-        if (!activateGLTextureUnit(unit))
+        if (!mStateCacheManager->activateGLTextureUnit(unit))
             return;
 
         maxAnisotropy = std::min<uint>(mLargestSupportedAnisotropy, maxAnisotropy);
-        if (_getCurrentAnisotropy(unit) != maxAnisotropy)
-            OGRE_CHECK_GL_ERROR(glTexParameteri(mTextureTypes[unit], GL_TEXTURE_MAX_ANISOTROPY_EXT, maxAnisotropy));
-
-        activateGLTextureUnit(0);
+        mStateCacheManager->setTexParameteri(mTextureTypes[unit], GL_TEXTURE_MAX_ANISOTROPY_EXT, maxAnisotropy);
     }
 
     void GL3PlusRenderSystem::_render(const RenderOperation& op)
@@ -1576,8 +1675,15 @@ namespace Ogre {
         VertexDeclaration::VertexElementList::const_iterator elemIter, elemEnd;
         elemEnd = decl.end();
 
-        // Bind VAO (set of per-vertex attributes: position, normal, etc.).
-        bool updateVAO = true;
+        if (op.gpuDrawCuller)
+        {
+            // Cull before the pass programs are activated, as this binds its own
+            const HardwareIndexBuffer* indexBuffer = op.indexData->indexBuffer.get();
+            static_cast<GL3PlusGpuDrawCuller*>(op.gpuDrawCuller)->_dispatch(static_cast<uint32>(
+                static_cast<const GL3PlusHardwareIndexBuffer*>(indexBuffer)->getGLBufferOffset() /
+                indexBuffer->getIndexSize()));
+        }
+
         if (mCurrentCapabilities->hasCapability(RSC_SEPARATE_SHADER_OBJECTS))
         {
             GLSLSeparableProgram* separableProgram =
@@ -1588,10 +1694,6 @@ namespace Ogre {
                 {
                     separableProgram->activate();
                 }
-
-                updateVAO = !separableProgram->getVertexArrayObject()->isInitialised();
-
-                separableProgram->getVertexArrayObject()->bind();
             }
             else
             {
@@ -1601,21 +1703,32 @@ namespace Ogre {
         }
         else
         {
-            GLSLMonolithicProgram* monolithicProgram = GLSLMonolithicProgramManager::getSingleton().getActiveMonolithicProgram();
-            if (monolithicProgram)
-            {
-                updateVAO = !monolithicProgram->getVertexArrayObject()->isInitialised();
-
-                monolithicProgram->getVertexArrayObject()->bind();
-            }
-            else
+            GLSLMonolithicProgram* monolithicProgram =
+                GLSLMonolithicProgramManager::getSingleton().getActiveMonolithicProgram();
+            if (!monolithicProgram)
             {
                 Ogre::LogManager::getSingleton().logMessage(
                     "ERROR: Failed to create monolithic program.", LML_CRITICAL);
             }
+            else if (monolithicProgram->isLinkPending())
+            {
+                // Still compiling in the driver, skip drawing until it is ready
+                monolithicProgram->activate();
+                return;
+            }
         }
 
-        // Bind the appropriate VBOs to the active attributes of the VAO.
+        // Draws start at vertexStart through their base vertex or first vertex where they can,
+        // so vertex data sub-allocated from shared buffers also shares its attribute setup.
+        // Otherwise vertexStart goes into the attribute offsets.
+        const bool hasBaseVertex = mHasGL32 || mGLSupport->checkExtension("GL_ARB_draw_elements_base_vertex");
+        const bool drawFromVertexStart = !mCurrentDomainShader && !op.numIndirectCommands && !op.gpuDrawCuller &&
+            (!op.useIndexes || hasBaseVertex);
+        const size_t attribVertexStart = drawFromVertexStart ? 0 : op.vertexData->vertexStart;
+        const GLint drawVertexStart = static_cast<GLint>(op.vertexData->vertexStart - attribVertexStart);
+
+        // Gather the attribute setup of the active VBOs (position, normal, etc.).
+        mVertexAttribBindings.clear();
         for (elemIter = decl.begin(); elemIter != elemEnd; ++elemIter)
         {
             const VertexElement & elem = *elemIter;
@@ -1627,8 +1740,7 @@ namespace Ogre {
             HardwareVertexBufferSharedPtr vertexBuffer =
                 op.vertexData->vertexBufferBinding->getBuffer(source);
 
-            bindVertexElementToGpu(elem, vertexBuffer, op.vertexData->vertexStart,
-                                   mRenderAttribsBound, mRenderInstanceAttribsBound, updateVAO);
+            bindVertexElementToGpu(elem, vertexBuffer, attribVertexStart);
         }
 
         if ( !globalInstanceVertexBuffer.isNull() && globalVertexDeclaration != NULL )
@@ -1637,12 +1749,12 @@ namespace Ogre {
             for (elemIter = globalVertexDeclaration->getElements().begin(); elemIter != elemEnd; ++elemIter)
             {
                 const VertexElement & elem = *elemIter;
-                bindVertexElementToGpu(elem, globalInstanceVertexBuffer, 0,
-                                       mRenderAttribsBound, mRenderInstanceAttribsBound, updateVAO);
+                bindVertexElementToGpu(elem, globalInstanceVertexBuffer, 0);
             }
         }
 
-        activateGLTextureUnit(0);
+        // Bind a VAO holding exactly that setup, only specifying attributes on a cache miss.
+        mStateCacheManager->getVertexArrayObjectCache()->bind(mVertexAttribBindings);
 
         // Launch compute shader job(s).
         if (mCurrentComputeShader) // && mComputeProgramPosition == CP_PRERENDER && mComputeProgramExecutions <= compute_execution_cap)
@@ -1743,10 +1855,11 @@ namespace Ogre {
 
             if (op.useIndexes)
             {
-                OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,
-                                                 static_cast<GL3PlusHardwareIndexBuffer*>(op.indexData->indexBuffer.get())->getGLBufferId()));
+                mStateCacheManager->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER,
+                                                 static_cast<GL3PlusHardwareIndexBuffer*>(op.indexData->indexBuffer.get())->getGLBufferId());
                 void *pBufferData = GL_BUFFER_OFFSET(op.indexData->indexStart *
-                                                     op.indexData->indexBuffer->getIndexSize());
+                                                     op.indexData->indexBuffer->getIndexSize() +
+                                                     static_cast<GL3PlusHardwareIndexBuffer*>(op.indexData->indexBuffer.get())->getGLBufferOffset());
                 GLuint indexEnd = op.indexData->indexCount - op.indexData->indexStart;
                 GLenum indexType = (op.indexData->indexBuffer->getType() == HardwareIndexBuffer::IT_32BIT) ? GL_UNSIGNED_BYTE : GL_UNSIGNED_SHORT;
                 OGRE_CHECK_GL_ERROR(glDrawRangeElements(GL_PATCHES, op.indexData->indexStart, indexEnd, op.indexData->indexCount, indexType, pBufferData));
@@ -1762,11 +1875,12 @@ namespace Ogre {
         }
         else if (op.useIndexes)
         {
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,
-                                             static_cast<GL3PlusHardwareIndexBuffer*>(op.indexData->indexBuffer.get())->getGLBufferId()));
+            mStateCacheManager->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER,
+                                             static_cast<GL3PlusHardwareIndexBuffer*>(op.indexData->indexBuffer.get())->getGLBufferId());
 
             void *pBufferData = GL_BUFFER_OFFSET(op.indexData->indexStart *
-                                                 op.indexData->indexBuffer->getIndexSize());
+                                                 op.indexData->indexBuffer->getIndexSize() +
+                                                 static_cast<GL3PlusHardwareIndexBuffer*>(op.indexData->indexBuffer.get())->getGLBufferOffset());
 
             //TODO : GL_UNSIGNED_INT or GL_UNSIGNED_BYTE?  Latter breaks samples.
             GLenum indexType = (op.indexData->indexBuffer->getType() == HardwareIndexBuffer::IT_16BIT) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
@@ -1781,12 +1895,24 @@ namespace Ogre {
                                   mDerivedDepthBiasSlopeScale);
                 }
 
+                if (op.gpuDrawCuller)
+                {
+                    static_cast<GL3PlusGpuDrawCuller*>(op.gpuDrawCuller)->_draw(primType, indexType);
+                    continue;
+                }
+
+                if (op.numIndirectCommands)
+                {
+                    renderIndirect(op, primType, indexType);
+                    continue;
+                }
+
                 GLuint indexEnd = op.indexData->indexCount - op.indexData->indexStart;
                 if (hasInstanceData)
                 {
-                    if (mGLSupport->checkExtension("GL_ARB_draw_elements_base_vertex") || mHasGL32)
+                    if (hasBaseVertex)
                     {
-                        OGRE_CHECK_GL_ERROR(glDrawElementsInstancedBaseVertex(primType, op.indexData->indexCount, indexType, pBufferData, numberOfInstances, op.vertexData->vertexStart));
+                        OGRE_CHECK_GL_ERROR(glDrawElementsInstancedBaseVertex(primType, op.indexData->indexCount, indexType, pBufferData, numberOfInstances, drawVertexStart));
                     }
                     else
                     {
@@ -1795,9 +1921,9 @@ namespace Ogre {
                 }
                 else
                 {
-                    if (mGLSupport->checkExtension("GL_ARB_draw_elements_base_vertex") || mHasGL32)
+                    if (hasBaseVertex)
                     {
-                        OGRE_CHECK_GL_ERROR(glDrawRangeElementsBaseVertex(primType, op.indexData->indexStart, indexEnd, op.indexData->indexCount, indexType, pBufferData, op.vertexData->vertexStart));
+                        OGRE_CHECK_GL_ERROR(glDrawRangeElementsBaseVertex(primType, op.indexData->indexStart, indexEnd, op.indexData->indexCount, indexType, pBufferData, drawVertexStart));
                     }
                     else
                     {
@@ -1820,44 +1946,85 @@ namespace Ogre {
 
                 if (hasInstanceData)
                 {
-                    OGRE_CHECK_GL_ERROR(glDrawArraysInstanced(primType, 0, op.vertexData->vertexCount, numberOfInstances));
+                    OGRE_CHECK_GL_ERROR(glDrawArraysInstanced(primType, drawVertexStart, op.vertexData->vertexCount, numberOfInstances));
                 }
                 else
                 {
-                    OGRE_CHECK_GL_ERROR(glDrawArrays(primType, 0, op.vertexData->vertexCount));
+                    OGRE_CHECK_GL_ERROR(glDrawArrays(primType, drawVertexStart, op.vertexData->vertexCount));
                 }
             } while (updatePassIterationRenderState());
         }
+    }
 
-        // Unbind VAO (if updated).
-        if (updateVAO)
+    void GL3PlusRenderSystem::limitFrameLatency(void)
+    {
+        if (!mGLInitialised || !(mHasGL32 || mGLSupport->checkExtension("GL_ARB_sync")))
+            return;
+
+        if (mMaxFrameLatency)
         {
-            if (mCurrentCapabilities->hasCapability(RSC_SEPARATE_SHADER_OBJECTS))
-            {
-                GLSLSeparableProgram* separableProgram =
-                    GLSLSeparableProgramManager::getSingleton().getCurrentSeparableProgram();
-                if (separableProgram)
-                {
-                    separableProgram->getVertexArrayObject()->setInitialised(true);
-                }
-            }
-            else
+            GLsync fence;
+            OGRE_CHECK_GL_ERROR(fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+            mFrameFences.push_back(fence);
+        }
+
+        // Wait until the GPU finished the frames beyond the limit
+        while (mFrameFences.size() > mMaxFrameLatency)
+        {
+            if (mMaxFrameLatency)
             {
-                GLSLMonolithicProgram* monolithicProgram = GLSLMonolithicProgramManager::getSingleton().getActiveMonolithicProgram();
-                if (monolithicProgram)
+                GLenum result;
+                do
                 {
-                    monolithicProgram->getVertexArrayObject()->setInitialised(true);
-                }
+                    OGRE_CHECK_GL_ERROR(result = glClientWaitSync(mFrameFences.front(), GL_SYNC_FLUSH_COMMANDS_BIT,
+                                                                  1000000000));
+                } while (result == GL_TIMEOUT_EXPIRED);
             }
 
-            // Unbind the vertex array object.
-            // Marks the end of what state will be included.
-            OGRE_CHECK_GL_ERROR(glBindVertexArray(0));
+            OGRE_CHECK_GL_ERROR(glDeleteSync(mFrameFences.front()));
+            mFrameFences.pop_front();
         }
+    }
 
+    void GL3PlusRenderSystem::renderIndirect(const RenderOperation& op, GLenum primType, GLenum indexType)
+    {
+        const GL3PlusHardwareIndexBuffer* indexBuffer =
+            static_cast<GL3PlusHardwareIndexBuffer*>(op.indexData->indexBuffer.get());
+        const size_t commandsSize = op.numIndirectCommands * sizeof(IndirectDrawCommand);
+
+        if (!mIndirectBuffer)
+            OGRE_CHECK_GL_ERROR(glGenBuffers(1, &mIndirectBuffer));
+        mStateCacheManager->bindGLBuffer(GL_DRAW_INDIRECT_BUFFER, mIndirectBuffer);
+
+        // Orphan the previous storage every time, the commands are rebuilt each frame anyway
+        mIndirectBufferSize = std::max(mIndirectBufferSize, commandsSize);
+        OGRE_CHECK_GL_ERROR(glBufferData(GL_DRAW_INDIRECT_BUFFER, mIndirectBufferSize, NULL, GL_STREAM_DRAW));
+
+        size_t ringOffset = indexBuffer->getGLBufferOffset();
+        if (ringOffset)
+        {
+            // Commands address indices from the start of the buffer, fold in where
+            // the index data currently lives inside its persistent ring
+            const uint32 firstIndexOffset = static_cast<uint32>(ringOffset / indexBuffer->getIndexSize());
+            void* pBuffer;
+            OGRE_CHECK_GL_ERROR(pBuffer = glMapBufferRange(GL_DRAW_INDIRECT_BUFFER, 0, commandsSize,
+                                                           GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+            IndirectDrawCommand* pDst = static_cast<IndirectDrawCommand*>(pBuffer);
+            for (size_t i = 0; i < op.numIndirectCommands; ++i)
+            {
+                pDst[i] = op.indirectCommands[i];
+                pDst[i].firstIndex += firstIndexOffset;
+            }
+            OGRE_CHECK_GL_ERROR(glUnmapBuffer(GL_DRAW_INDIRECT_BUFFER));
+        }
+        else
+        {
+            OGRE_CHECK_GL_ERROR(glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, commandsSize, op.indirectCommands));
+        }
 
-        mRenderAttribsBound.clear();
-        mRenderInstanceAttribsBound.clear();
+        OGRE_CHECK_GL_ERROR(glMultiDrawElementsIndirect(primType, indexType, 0,
+                                                        static_cast<GLsizei>(op.numIndirectCommands),
+                                                        sizeof(IndirectDrawCommand)));
     }
 
     void GL3PlusRenderSystem::setScissorTest(bool enabled, size_t left,
@@ -1874,7 +2041,7 @@ namespace Ogre {
 
         if (enabled)
         {
-            OGRE_CHECK_GL_ERROR(glEnable(GL_SCISSOR_TEST));
+            mStateCacheManager->setEnabled(GL_SCISSOR_TEST, true);
             // NB GL uses width / height rather than right / bottom
             x = left;
             if (flipping)
@@ -1890,7 +2057,7 @@ namespace Ogre {
         }
         else
         {
-            OGRE_CHECK_GL_ERROR(glDisable(GL_SCISSOR_TEST));
+            mStateCacheManager->setEnabled(GL_SCISSOR_TEST, false);
             // GL requires you to reset the scissor when disabling
             w = mActiveViewport->getActualWidth();
             h = mActiveViewport->getActualHeight();
@@ -1920,9 +2087,9 @@ namespace Ogre {
             // Enable buffer for writing if it isn't
             if (colourMask)
             {
-                OGRE_CHECK_GL_ERROR(glColorMask(true, true, true, true));
+                mStateCacheManager->setColourMask(true, true, true, true);
             }
-            OGRE_CHECK_GL_ERROR(glClearColor(colour.r, colour.g, colour.b, colour.a));
+            mStateCacheManager->setClearColour(colour.r, colour.g, colour.b, colour.a);
         }
         if (buffers & FBT_DEPTH)
         {
@@ -1930,15 +2097,15 @@ namespace Ogre {
             // Enable buffer for writing if it isn't
             if (!mDepthWrite)
             {
-                OGRE_CHECK_GL_ERROR(glDepthMask(GL_TRUE));
+                mStateCacheManager->setDepthMask(GL_TRUE);
             }
-            OGRE_CHECK_GL_ERROR(glClearDepth(depth));
+            mStateCacheManager->setClearDepth(depth);
         }
         if (buffers & FBT_STENCIL)
         {
             flags |= GL_STENCIL_BUFFER_BIT;
             // Enable buffer for writing if it isn't
-            OGRE_CHECK_GL_ERROR(glStencilMask(0xFFFFFFFF));
+            mStateCacheManager->setStencilMask(0xFFFFFFFF);
             OGRE_CHECK_GL_ERROR(glClearStencil(stencil));
         }
 
@@ -1946,12 +2113,12 @@ namespace Ogre {
         // relied on scissor box bounds.
         if (!mScissorsEnabled)
         {
-            OGRE_CHECK_GL_ERROR(glEnable(GL_SCISSOR_TEST));
+            mStateCacheManager->setEnabled(GL_SCISSOR_TEST, true);
         }
 
         // Sets the scissor box as same as viewport
         GLint viewport[4], scissor[4];
-        OGRE_CHECK_GL_ERROR(glGetIntegerv(GL_VIEWPORT, viewport));
+        mStateCacheManager->getViewport(viewport);
         OGRE_CHECK_GL_ERROR(glGetIntegerv(GL_SCISSOR_BOX, scissor));
         bool scissorBoxDifference =
             viewport[0] != scissor[0] || viewport[1] != scissor[1] ||
@@ -1973,23 +2140,23 @@ namespace Ogre {
         // Restore scissor test
         if (!mScissorsEnabled)
         {
-            OGRE_CHECK_GL_ERROR(glDisable(GL_SCISSOR_TEST));
+            mStateCacheManager->setEnabled(GL_SCISSOR_TEST, false);
         }
 
         // Reset buffer write state
         if (!mDepthWrite && (buffers & FBT_DEPTH))
         {
-            OGRE_CHECK_GL_ERROR(glDepthMask(GL_FALSE));
+            mStateCacheManager->setDepthMask(GL_FALSE);
         }
 
         if (colourMask && (buffers & FBT_COLOUR))
         {
-            OGRE_CHECK_GL_ERROR(glColorMask(mColourWrite[0], mColourWrite[1], mColourWrite[2], mColourWrite[3]));
+            mStateCacheManager->setColourMask(mColourWrite[0], mColourWrite[1], mColourWrite[2], mColourWrite[3]);
         }
 
         if (buffers & FBT_STENCIL)
         {
-            OGRE_CHECK_GL_ERROR(glStencilMask(mStencilWriteMask));
+            mStateCacheManager->setStencilMask(mStencilWriteMask);
         }
     }
 
@@ -2020,6 +2187,8 @@ namespace Ogre {
         mCurrentContext = context;
         mCurrentContext->setCurrent();
 
+        mStateCacheManager->switchContext((intptr_t)mCurrentContext);
+
         // Check if the context has already done one-time initialisation
         if (!mCurrentContext->getInitialized())
         {
@@ -2044,9 +2213,9 @@ namespace Ogre {
         // Must reset depth/colour write mask to according with user desired, otherwise,
         // clearFrameBuffer would be wrong because the value we are recorded may be
         // difference with the really state stored in GL context.
-        OGRE_CHECK_GL_ERROR(glDepthMask(mDepthWrite));
-        OGRE_CHECK_GL_ERROR(glColorMask(mColourWrite[0], mColourWrite[1], mColourWrite[2], mColourWrite[3]));
-        OGRE_CHECK_GL_ERROR(glStencilMask(mStencilWriteMask));
+        mStateCacheManager->setDepthMask(mDepthWrite);
+        mStateCacheManager->setColourMask(mColourWrite[0], mColourWrite[1], mColourWrite[2], mColourWrite[3]);
+        mStateCacheManager->setStencilMask(mStencilWriteMask);
     }
 
     void GL3PlusRenderSystem::_unregisterContext(GL3PlusContext *context)
@@ -2068,6 +2237,9 @@ namespace Ogre {
                 mMainContext = 0;
             }
         }
+
+        if (mStateCacheManager)
+            mStateCacheManager->unregisterContext((intptr_t)context);
     }
 
     void GL3PlusRenderSystem::_oneTimeContextInitialization()
@@ -2130,11 +2302,15 @@ namespace Ogre {
                         "GL3PlusRenderSystem::initialiseContext");
         }
 
+        // Make sure the state cache tracks the primary context
+        mStateCacheManager->switchContext((intptr_t)mCurrentContext);
+
         // Setup GL3PlusSupport
         mGLSupport->initialiseExtensions();
 
         mHasGL32 = mGLSupport->hasMinGLVersion(3, 2);
         mHasGL43 = mGLSupport->hasMinGLVersion(4, 3);
+        mHasTimerQuery = mGLSupport->hasMinGLVersion(3, 3) || mGLSupport->checkExtension("GL_ARB_timer_query");
 
         LogManager::getSingleton().logMessage("**************************************");
         LogManager::getSingleton().logMessage("***   OpenGL 3+ Renderer Started   ***");
@@ -2175,7 +2351,7 @@ namespace Ogre {
             // Enable / disable sRGB states
             if (target->isHardwareGammaEnabled())
             {
-                OGRE_CHECK_GL_ERROR(glEnable(GL_FRAMEBUFFER_SRGB));
+                mStateCacheManager->setEnabled(GL_FRAMEBUFFER_SRGB, true);
 
                 // Note: could test GL_FRAMEBUFFER_SRGB_CAPABLE here before
                 // enabling, but GL spec says incapable surfaces ignore the setting
@@ -2183,7 +2359,7 @@ namespace Ogre {
             }
             else
             {
-                OGRE_CHECK_GL_ERROR(glDisable(GL_FRAMEBUFFER_SRGB));
+                mStateCacheManager->setEnabled(GL_FRAMEBUFFER_SRGB, false);
             }
         }
     }
@@ -2484,7 +2660,7 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::setClipPlanesImpl(const Ogre::PlaneList& planeList)
     {
-        OGRE_CHECK_GL_ERROR(glEnable(GL_DEPTH_CLAMP));
+        mStateCacheManager->setEnabled(GL_DEPTH_CLAMP, true);
     }
 
     void GL3PlusRenderSystem::registerThread()
@@ -2572,133 +2748,124 @@ namespace Ogre {
                                  eventName.c_str());
     }
 
-    bool GL3PlusRenderSystem::activateGLTextureUnit(size_t unit)
+    uint32 GL3PlusRenderSystem::_beginGpuTimer(void)
     {
-        if (mActiveTextureUnit != unit)
-        {
-            if (unit < getCapabilities()->getNumTextureUnits())
-            {
-                OGRE_CHECK_GL_ERROR(glActiveTexture(static_cast<uint32>(GL_TEXTURE0 + unit)));
-                mActiveTextureUnit = static_cast<GLenum>(unit);
-                return true;
-            }
-            else if (!unit)
-            {
-                //FIXME If the above case fails, should this case ever be taken?
-                // Also switch to (unit == number) unless not operation is actually
-                // faster on some architectures.
+        if (!mHasTimerQuery)
+            return 0;
 
-                // Always OK to use the first unit.
-                return true;
-            }
-            else
-            {
-                return false;
-            }
+        uint32 timer;
+        if (mFreeGpuTimers.empty())
+        {
+            GpuTimer newTimer;
+            OGRE_CHECK_GL_ERROR(glGenQueries(2, newTimer.queries));
+            mGpuTimers.push_back(newTimer);
+            timer = static_cast<uint32>(mGpuTimers.size());
         }
         else
         {
-            return true;
+            timer = mFreeGpuTimers.back();
+            mFreeGpuTimers.pop_back();
         }
+
+        // Timestamps rather than GL_TIME_ELAPSED, which can't be nested
+        OGRE_CHECK_GL_ERROR(glQueryCounter(mGpuTimers[timer - 1].queries[0], GL_TIMESTAMP));
+        return timer;
     }
 
-    void GL3PlusRenderSystem::bindVertexElementToGpu( const VertexElement &elem,
-                                                      HardwareVertexBufferSharedPtr vertexBuffer, const size_t vertexStart,
-                                                      vector<GLuint>::type &attribsBound,
-                                                      vector<GLuint>::type &instanceAttribsBound,
-                                                      bool updateVAO)
+    void GL3PlusRenderSystem::_endGpuTimer(uint32 timer)
     {
-        const GL3PlusHardwareVertexBuffer* hwGlBuffer = static_cast<const GL3PlusHardwareVertexBuffer*>(vertexBuffer.get());
+        OGRE_CHECK_GL_ERROR(glQueryCounter(mGpuTimers[timer - 1].queries[1], GL_TIMESTAMP));
+    }
 
-        // FIXME: Having this commented out fixes some rendering issues but leaves VAO's useless
-        // if (updateVAO)
-        {
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ARRAY_BUFFER,
-                                             hwGlBuffer->getGLBufferId()));
-            void* pBufferData = GL_BUFFER_OFFSET(elem.getOffset());
+    RenderSystem::GpuTimerStatus GL3PlusRenderSystem::_getGpuTimerResult(uint32 timer, uint64& elapsedNanosecs)
+    {
+        const GpuTimer& gpuTimer = mGpuTimers[timer - 1];
 
-            if (vertexStart)
-            {
-                pBufferData = static_cast<char*>(pBufferData) + vertexStart * vertexBuffer->getVertexSize();
-            }
+        // The end timestamp is written last
+        GLint available = GL_FALSE;
+        OGRE_CHECK_GL_ERROR(glGetQueryObjectiv(gpuTimer.queries[1], GL_QUERY_RESULT_AVAILABLE, &available));
+        if (!available)
+            return GTS_PENDING;
 
-            VertexElementSemantic sem = elem.getSemantic();
-            unsigned short typeCount = VertexElement::getTypeCount(elem.getType());
-            GLboolean normalised = GL_FALSE;
-            GLuint attrib = 0;
-            unsigned short elemIndex = elem.getIndex();
+        GLuint64 begin = 0, end = 0;
+        OGRE_CHECK_GL_ERROR(glGetQueryObjectui64v(gpuTimer.queries[0], GL_QUERY_RESULT, &begin));
+        OGRE_CHECK_GL_ERROR(glGetQueryObjectui64v(gpuTimer.queries[1], GL_QUERY_RESULT, &end));
+        elapsedNanosecs = end > begin ? end - begin : 0;
 
-            if (mCurrentCapabilities->hasCapability(RSC_SEPARATE_SHADER_OBJECTS))
-            {
-                GLSLSeparableProgram* separableProgram =
-                    GLSLSeparableProgramManager::getSingleton().getCurrentSeparableProgram();
-                if (!separableProgram || !separableProgram->isAttributeValid(sem, elemIndex))
-                {
-                    return;
-                }
+        mFreeGpuTimers.push_back(timer);
+        return GTS_AVAILABLE;
+    }
 
-                attrib = (GLuint)separableProgram->getAttributeIndex(sem, elemIndex);
-            }
-            else
-            {
-                GLSLMonolithicProgram* monolithicProgram = GLSLMonolithicProgramManager::getSingleton().getActiveMonolithicProgram();
-                if (!monolithicProgram || !monolithicProgram->isAttributeValid(sem, elemIndex))
-                {
-                    return;
-                }
+    void GL3PlusRenderSystem::_releaseGpuTimer(uint32 timer)
+    {
+        mFreeGpuTimers.push_back(timer);
+    }
 
-                attrib = (GLuint)monolithicProgram->getAttributeIndex(sem, elemIndex);
-            }
+    void GL3PlusRenderSystem::bindVertexElementToGpu( const VertexElement &elem,
+                                                      HardwareVertexBufferSharedPtr vertexBuffer, const size_t vertexStart)
+    {
+        const GL3PlusHardwareVertexBuffer* hwGlBuffer = static_cast<const GL3PlusHardwareVertexBuffer*>(vertexBuffer.get());
 
-            if (mCurrentVertexShader)
-            {
-                if (hwGlBuffer->getIsInstanceData())
-                {
-                    OGRE_CHECK_GL_ERROR(glVertexAttribDivisor(attrib, hwGlBuffer->getInstanceDataStepRate()));
-                    instanceAttribsBound.push_back(attrib);
-                }
-            }
+        VertexElementSemantic sem = elem.getSemantic();
+        unsigned short elemIndex = elem.getIndex();
 
-            switch(elem.getType())
+        GL3PlusVertexAttribBinding binding;
+        binding.buffer = hwGlBuffer->getGLBufferId();
+        binding.offset = elem.getOffset() + hwGlBuffer->getGLBufferOffset() + vertexStart * vertexBuffer->getVertexSize();
+        binding.stride = static_cast<GLsizei>(vertexBuffer->getVertexSize());
+        binding.size = VertexElement::getTypeCount(elem.getType());
+        binding.type = GL3PlusHardwareBufferManager::getGLType(elem.getType());
+        binding.normalised = GL_FALSE;
+        binding.isDouble = elem.getBaseType(elem.getType()) == VET_DOUBLE1;
+        binding.divisor = 0;
+
+        if (mCurrentCapabilities->hasCapability(RSC_SEPARATE_SHADER_OBJECTS))
+        {
+            GLSLSeparableProgram* separableProgram =
+                GLSLSeparableProgramManager::getSingleton().getCurrentSeparableProgram();
+            if (!separableProgram || !separableProgram->isAttributeValid(sem, elemIndex))
             {
-            case VET_COLOUR:
-            case VET_COLOUR_ABGR:
-            case VET_COLOUR_ARGB:
-                // Because GL takes these as a sequence of single unsigned bytes, count needs to be 4
-                // VertexElement::getTypeCount treats them as 1 (RGBA)
-                // Also need to normalise the fixed-point data
-                typeCount = 4;
-                normalised = GL_TRUE;
-                break;
-            default:
-                break;
-            };
+                return;
+            }
 
-            switch(elem.getBaseType(elem.getType()))
+            binding.attrib = (GLuint)separableProgram->getAttributeIndex(sem, elemIndex);
+        }
+        else
+        {
+            GLSLMonolithicProgram* monolithicProgram = GLSLMonolithicProgramManager::getSingleton().getActiveMonolithicProgram();
+            if (!monolithicProgram || !monolithicProgram->isAttributeValid(sem, elemIndex))
             {
-            default:
-            case VET_FLOAT1:
-                OGRE_CHECK_GL_ERROR(glVertexAttribPointer(attrib,
-                                                          typeCount,
-                                                          GL3PlusHardwareBufferManager::getGLType(elem.getType()),
-                                                          normalised,
-                                                          static_cast<GLsizei>(vertexBuffer->getVertexSize()),
-                                                          pBufferData));
-                break;
-            case VET_DOUBLE1:
-                OGRE_CHECK_GL_ERROR(glVertexAttribLPointer(attrib,
-                                                           typeCount,
-                                                           GL3PlusHardwareBufferManager::getGLType(elem.getType()),
-                                                           static_cast<GLsizei>(vertexBuffer->getVertexSize()),
-                                                           pBufferData));
-                break;
+                return;
             }
 
-            // If this attribute hasn't been enabled, do so and keep a record of it.
-            OGRE_CHECK_GL_ERROR(glEnableVertexAttribArray(attrib));
+            binding.attrib = (GLuint)monolithicProgram->getAttributeIndex(sem, elemIndex);
+        }
 
-            attribsBound.push_back(attrib);
+        if (mCurrentVertexShader && hwGlBuffer->getIsInstanceData())
+        {
+            binding.divisor = static_cast<GLuint>(hwGlBuffer->getInstanceDataStepRate());
         }
+
+        switch(elem.getType())
+        {
+        case VET_COLOUR:
+        case VET_COLOUR_ABGR:
+        case VET_COLOUR_ARGB:
+            // Because GL takes these as a sequence of single unsigned bytes, count needs to be 4
+            // VertexElement::getTypeCount treats them as 1 (RGBA)
+            // Also need to normalise the fixed-point data
+            binding.size = 4;
+            binding.normalised = GL_TRUE;
+            break;
+        case VET_SHORT2_NORM:
+        case VET_SHORT4_NORM:
+            binding.normalised = GL_TRUE;
+            break;
+        default:
+            break;
+        };
+
+        mVertexAttribBindings.push_back(binding);
     }
 #if OGRE_NO_QUAD_BUFFER_STEREO == 0
 	bool GL3PlusRenderSystem::setDrawBuffer(ColourBufferType colourBuffer)
@@ -2755,4 +2922,38 @@ namespace Ogre {
 
         PixelUtil::bulkPixelVerticalFlip(dst);
     }
+
+    PixelReadbackPtr GL3PlusRenderSystem::_copyContentsToMemoryAsync(RenderTarget* target, const Box& src,
+                                                                     PixelFormat format, RenderTarget::FrameBuffer buffer)
+    {
+        // Polling the copy needs fences
+        if (!mHasGL32 && !mGLSupport->checkExtension("GL_ARB_sync"))
+            return PixelReadbackPtr();
+
+        // Multisampled render textures are only resolved when swapped
+        if (target->requiresTextureFlipping() && target->getFSAA() > 0)
+            return PixelReadbackPtr();
+
+        // Switch context if different from current one and bind the target
+        _setRenderTarget(target);
+        // The active viewport may belong to another target, make sure it gets bound again
+        mActiveViewport = 0;
+
+        // Render textures are rendered upside down, so their rows are already top down
+        bool flipped = !target->requiresTextureFlipping();
+        if (flipped)
+        {
+            if (buffer == RenderTarget::FB_AUTO)
+                buffer = static_cast<RenderWindow*>(target)->isFullScreen() ? RenderTarget::FB_FRONT : RenderTarget::FB_BACK;
+            OGRE_CHECK_GL_ERROR(glReadBuffer((buffer == RenderTarget::FB_FRONT) ? GL_FRONT : GL_BACK));
+        }
+        else
+        {
+            OGRE_CHECK_GL_ERROR(glReadBuffer(GL_COLOR_ATTACHMENT0));
+        }
+
+        GLint y = flipped ? (GLint)(target->getHeight() - src.bottom) : (GLint)src.top;
+        return PixelReadbackPtr(OGRE_NEW GL3PlusPixelReadback((GLint)src.left, y,
+            src.getWidth(), src.getHeight(), format, flipped));
+    }
 }
@@ -29,6 +29,9 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreGL3PlusRenderToVertexBuffer.h"
 #include "OgreHardwareBufferManager.h"
 #include "OgreGL3PlusHardwareVertexBuffer.h"
+#include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusStateCacheManager.h"
+#include "OgreGL3PlusSupport.h"
 #include "OgreGL3PlusVertexArrayObject.h"
 #include "OgreRenderable.h"
 #include "OgreSceneManager.h"
@@ -281,7 +284,7 @@ namespace Ogre {
         // Bind source vertex array + target tranform feedback buffer.
         GL3PlusHardwareVertexBuffer* targetVertexBuffer = static_cast<GL3PlusHardwareVertexBuffer*>(mVertexBuffers[mTargetBufferIndex].getPointer());
         // OGRE_CHECK_GL_ERROR(glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, VertexBuffer[mTargetBufferIndex]));
-        OGRE_CHECK_GL_ERROR(glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, targetVertexBuffer->getGLBufferId()));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, targetVertexBuffer->getGLBufferId());
         // OGRE_CHECK_GL_ERROR(glBindVertexArray(VertexArray[mSourceBufferIndex]));
         if (Root::getSingleton().getRenderSystem()->getCapabilities()->hasCapability(RSC_SEPARATE_SHADER_OBJECTS))
         {
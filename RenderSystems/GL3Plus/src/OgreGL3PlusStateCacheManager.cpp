@@ -0,0 +1,281 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreGL3PlusStateCacheManager.h"
+#include "OgreGL3PlusVertexArrayObject.h"
+
+#if OGRE_NO_GL_STATE_CACHE_SUPPORT == 0
+#   include "OgreGL3PlusStateCacheManagerImp.h"
+#else
+#   include "OgreGL3PlusNullStateCacheManagerImp.h"
+#endif
+
+namespace Ogre {
+
+    GL3PlusStateCacheManager::GL3PlusStateCacheManager(void)
+        : mImp(0), mVertexArrayObjectCache(0)
+    {
+    }
+
+    GL3PlusStateCacheManager::~GL3PlusStateCacheManager(void)
+    {
+        for (CachesMap::iterator it = mCaches.begin(); it != mCaches.end(); ++it)
+            OGRE_DELETE it->second;
+        for (VertexArrayObjectCachesMap::iterator it = mVertexArrayObjectCaches.begin(); it != mVertexArrayObjectCaches.end(); ++it)
+            OGRE_DELETE it->second;
+    }
+
+    void GL3PlusStateCacheManager::switchContext(intptr_t id)
+    {
+        CachesMap::iterator it = mCaches.find(id);
+        if (it != mCaches.end())
+        {
+            // Already have a cache for this context
+            mImp = it->second;
+        }
+        else
+        {
+            // No cache for this context yet
+            mImp = OGRE_NEW GL3PlusStateCacheManagerImp();
+            mImp->initializeCache();
+            mCaches[id] = mImp;
+        }
+
+        VertexArrayObjectCachesMap::iterator vaoIt = mVertexArrayObjectCaches.find(id);
+        if (vaoIt != mVertexArrayObjectCaches.end())
+        {
+            mVertexArrayObjectCache = vaoIt->second;
+        }
+        else
+        {
+            mVertexArrayObjectCache = OGRE_NEW GL3PlusVertexArrayObjectCache(this);
+            mVertexArrayObjectCaches[id] = mVertexArrayObjectCache;
+        }
+    }
+
+    void GL3PlusStateCacheManager::unregisterContext(intptr_t id)
+    {
+        CachesMap::iterator it = mCaches.find(id);
+        if (it != mCaches.end())
+        {
+            if (mImp == it->second)
+                mImp = NULL;
+            OGRE_DELETE it->second;
+            mCaches.erase(it);
+        }
+
+        // The context's vertex array objects go away with it
+        VertexArrayObjectCachesMap::iterator vaoIt = mVertexArrayObjectCaches.find(id);
+        if (vaoIt != mVertexArrayObjectCaches.end())
+        {
+            if (mVertexArrayObjectCache == vaoIt->second)
+                mVertexArrayObjectCache = NULL;
+            OGRE_DELETE vaoIt->second;
+            mVertexArrayObjectCaches.erase(vaoIt);
+        }
+
+        // Always keep a valid cache, even if no contexts are left.
+        // Buffers and textures destroyed during shutdown still go through
+        // the cache after all contexts have been deleted.
+        if (mImp == NULL)
+        {
+            if (mCaches.empty())
+                mCaches[0] = OGRE_NEW GL3PlusStateCacheManagerImp();
+            mImp = mCaches.begin()->second;
+        }
+    }
+
+    void GL3PlusStateCacheManager::clearCache()
+    {
+        mImp->clearCache();
+    }
+
+    void GL3PlusStateCacheManager::bindGLBuffer(GLenum target, GLuint buffer, bool force)
+    {
+        mImp->bindGLBuffer(target, buffer, force);
+    }
+
+    void GL3PlusStateCacheManager::bindGLBufferBase(GLenum target, GLuint index, GLuint buffer)
+    {
+        mImp->bindGLBufferBase(target, index, buffer);
+    }
+
+    void GL3PlusStateCacheManager::deleteGLBuffer(GLuint buffer)
+    {
+        // The name may be reused, so no cached vertex array object may refer to it
+        for (VertexArrayObjectCachesMap::iterator it = mVertexArrayObjectCaches.begin(); it != mVertexArrayObjectCaches.end(); ++it)
+            it->second->_notifyBufferDestroyed(buffer, it->second == mVertexArrayObjectCache);
+
+        mImp->deleteGLBuffer(buffer);
+    }
+
+    void GL3PlusStateCacheManager::bindGLVertexArray(GLuint vao)
+    {
+        mImp->bindGLVertexArray(vao);
+    }
+
+    void GL3PlusStateCacheManager::deleteGLVertexArray(GLuint vao)
+    {
+        mImp->deleteGLVertexArray(vao);
+    }
+
+    void GL3PlusStateCacheManager::bindGLTexture(GLenum target, GLuint texture)
+    {
+        mImp->bindGLTexture(target, texture);
+    }
+
+    void GL3PlusStateCacheManager::invalidateStateForTexture(GLuint texture)
+    {
+        mImp->invalidateStateForTexture(texture);
+    }
+
+    void GL3PlusStateCacheManager::setTexParameteri(GLenum target, GLenum pname, GLint param)
+    {
+        mImp->setTexParameteri(target, pname, param);
+    }
+
+    bool GL3PlusStateCacheManager::activateGLTextureUnit(size_t unit)
+    {
+        return mImp->activateGLTextureUnit(unit);
+    }
+
+    void GL3PlusStateCacheManager::bindGLSampler(GLuint unit, GLuint sampler)
+    {
+        mImp->bindGLSampler(unit, sampler);
+    }
+
+    void GL3PlusStateCacheManager::bindGLProgram(GLuint program)
+    {
+        mImp->bindGLProgram(program);
+    }
+
+    void GL3PlusStateCacheManager::bindGLProgramPipeline(GLuint pipeline)
+    {
+        mImp->bindGLProgramPipeline(pipeline);
+    }
+
+    void GL3PlusStateCacheManager::setBlendEquation(GLenum eqRGB, GLenum eqAlpha)
+    {
+        mImp->setBlendEquation(eqRGB, eqAlpha);
+    }
+
+    void GL3PlusStateCacheManager::setBlendFunc(GLenum source, GLenum dest, GLenum sourceA, GLenum destA)
+    {
+        mImp->setBlendFunc(source, dest, sourceA, destA);
+    }
+
+    GLboolean GL3PlusStateCacheManager::getDepthMask(void) const
+    {
+        return mImp->getDepthMask();
+    }
+
+    void GL3PlusStateCacheManager::setDepthMask(GLboolean mask)
+    {
+        mImp->setDepthMask(mask);
+    }
+
+    GLenum GL3PlusStateCacheManager::getDepthFunc(void) const
+    {
+        return mImp->getDepthFunc();
+    }
+
+    void GL3PlusStateCacheManager::setDepthFunc(GLenum func)
+    {
+        mImp->setDepthFunc(func);
+    }
+
+    GLclampf GL3PlusStateCacheManager::getClearDepth(void) const
+    {
+        return mImp->getClearDepth();
+    }
+
+    void GL3PlusStateCacheManager::setClearDepth(GLclampf depth)
+    {
+        mImp->setClearDepth(depth);
+    }
+
+    void GL3PlusStateCacheManager::setClearColour(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
+    {
+        mImp->setClearColour(red, green, blue, alpha);
+    }
+
+    const GLboolean* GL3PlusStateCacheManager::getColourMask(void) const
+    {
+        return mImp->getColourMask();
+    }
+
+    void GL3PlusStateCacheManager::setColourMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+    {
+        mImp->setColourMask(red, green, blue, alpha);
+    }
+
+    GLuint GL3PlusStateCacheManager::getStencilMask(void) const
+    {
+        return mImp->getStencilMask();
+    }
+
+    void GL3PlusStateCacheManager::setStencilMask(GLuint mask)
+    {
+        mImp->setStencilMask(mask);
+    }
+
+    void GL3PlusStateCacheManager::setEnabled(GLenum flag, bool enabled)
+    {
+        mImp->setEnabled(flag, enabled);
+    }
+
+    GLenum GL3PlusStateCacheManager::getPolygonMode(void) const
+    {
+        return mImp->getPolygonMode();
+    }
+
+    void GL3PlusStateCacheManager::setPolygonMode(GLenum mode)
+    {
+        mImp->setPolygonMode(mode);
+    }
+
+    GLenum GL3PlusStateCacheManager::getCullFace(void) const
+    {
+        return mImp->getCullFace();
+    }
+
+    void GL3PlusStateCacheManager::setCullFace(GLenum face)
+    {
+        mImp->setCullFace(face);
+    }
+
+    void GL3PlusStateCacheManager::setViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        mImp->setViewport(x, y, width, height);
+    }
+
+    void GL3PlusStateCacheManager::getViewport(int* array) const
+    {
+        mImp->getViewport(array);
+    }
+}
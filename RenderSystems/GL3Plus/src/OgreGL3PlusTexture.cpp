@@ -29,6 +29,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreGL3PlusTexture.h"
 #include "OgreGL3PlusPixelFormat.h"
 #include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusStateCacheManager.h"
 #include "OgreGL3PlusHardwareBufferManager.h"
 #include "OgreGL3PlusHardwarePixelBuffer.h"
 #include "OgreGL3PlusTextureBuffer.h"
@@ -128,20 +129,20 @@ namespace Ogre {
 
         // Bind texture object to its type, making it the active texture object
         // for that type.
-        OGRE_CHECK_GL_ERROR(glBindTexture(texTarget, mTextureID));
+        mGLSupport.getStateCacheManager()->bindGLTexture(texTarget, mTextureID);
 
-        OGRE_CHECK_GL_ERROR(glTexParameteri(texTarget, GL_TEXTURE_BASE_LEVEL, 0));
-        OGRE_CHECK_GL_ERROR(glTexParameteri(texTarget, GL_TEXTURE_MAX_LEVEL, mNumMipmaps));
+        mGLSupport.getStateCacheManager()->setTexParameteri(texTarget, GL_TEXTURE_BASE_LEVEL, 0);
+        mGLSupport.getStateCacheManager()->setTexParameteri(texTarget, GL_TEXTURE_MAX_LEVEL, mNumMipmaps);
 
         // Set some misc default parameters, these can of course be changed later.
-        OGRE_CHECK_GL_ERROR(glTexParameteri(texTarget,
-                                            GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-        OGRE_CHECK_GL_ERROR(glTexParameteri(texTarget,
-                                            GL_TEXTURE_MAG_FILTER, GL_NEAREST));
-        OGRE_CHECK_GL_ERROR(glTexParameteri(texTarget,
-                                            GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-        OGRE_CHECK_GL_ERROR(glTexParameteri(texTarget,
-                                            GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+        mGLSupport.getStateCacheManager()->setTexParameteri(texTarget,
+                                            GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        mGLSupport.getStateCacheManager()->setTexParameteri(texTarget,
+                                            GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        mGLSupport.getStateCacheManager()->setTexParameteri(texTarget,
+                                            GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        mGLSupport.getStateCacheManager()->setTexParameteri(texTarget,
+                                            GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
         bool hasGL33 = mGLSupport.hasMinGLVersion(3, 3);
         bool hasGL42 = mGLSupport.hasMinGLVersion(4, 2);
@@ -151,17 +152,17 @@ namespace Ogre {
         {
             if (PixelUtil::getComponentCount(mFormat) == 2)
             {
-                OGRE_CHECK_GL_ERROR(glTexParameteri(texTarget, GL_TEXTURE_SWIZZLE_R, GL_RED));
-                OGRE_CHECK_GL_ERROR(glTexParameteri(texTarget, GL_TEXTURE_SWIZZLE_G, GL_RED));
-                OGRE_CHECK_GL_ERROR(glTexParameteri(texTarget, GL_TEXTURE_SWIZZLE_B, GL_RED));
-                OGRE_CHECK_GL_ERROR(glTexParameteri(texTarget, GL_TEXTURE_SWIZZLE_A, GL_GREEN));
+                mGLSupport.getStateCacheManager()->setTexParameteri(texTarget, GL_TEXTURE_SWIZZLE_R, GL_RED);
+                mGLSupport.getStateCacheManager()->setTexParameteri(texTarget, GL_TEXTURE_SWIZZLE_G, GL_RED);
+                mGLSupport.getStateCacheManager()->setTexParameteri(texTarget, GL_TEXTURE_SWIZZLE_B, GL_RED);
+                mGLSupport.getStateCacheManager()->setTexParameteri(texTarget, GL_TEXTURE_SWIZZLE_A, GL_GREEN);
             }
             else
             {
-                OGRE_CHECK_GL_ERROR(glTexParameteri(texTarget, GL_TEXTURE_SWIZZLE_R, GL_RED));
-                OGRE_CHECK_GL_ERROR(glTexParameteri(texTarget, GL_TEXTURE_SWIZZLE_G, GL_RED));
-                OGRE_CHECK_GL_ERROR(glTexParameteri(texTarget, GL_TEXTURE_SWIZZLE_B, GL_RED));
-                OGRE_CHECK_GL_ERROR(glTexParameteri(texTarget, GL_TEXTURE_SWIZZLE_A, GL_RED));
+                mGLSupport.getStateCacheManager()->setTexParameteri(texTarget, GL_TEXTURE_SWIZZLE_R, GL_RED);
+                mGLSupport.getStateCacheManager()->setTexParameteri(texTarget, GL_TEXTURE_SWIZZLE_G, GL_RED);
+                mGLSupport.getStateCacheManager()->setTexParameteri(texTarget, GL_TEXTURE_SWIZZLE_B, GL_RED);
+                mGLSupport.getStateCacheManager()->setTexParameteri(texTarget, GL_TEXTURE_SWIZZLE_A, GL_RED);
             }
         }
 
@@ -411,8 +412,7 @@ namespace Ogre {
             }
             else
             {
-                vector<Image>::type images(6);
-                ConstImagePtrList imagePtrs;
+                vector<DataStreamPtr>::type streams;
                 static const String suffixes[6] = {"_rt", "_lf", "_up", "_dn", "_fr", "_bk"};
 
                 for(size_t i = 0; i < 6; i++)
@@ -422,8 +422,11 @@ namespace Ogre {
                         fullName = fullName + "." + ext;
                     // find & load resource data intro stream to allow resource
                     // group changes if required
-                    doImageIO(fullName, mGroup, ext, *loadedImages, this);
+                    streams.push_back(ResourceGroupManager::getSingleton().openResource(
+                        fullName, mGroup, true, this));
                 }
+                // The faces are independent, decode them in parallel
+                Image::loadParallel(*loadedImages, streams, ext);
             }
         }
         else
@@ -476,6 +479,7 @@ namespace Ogre {
     void GL3PlusTexture::freeInternalResourcesImpl()
     {
         mSurfaceList.clear();
+        mGLSupport.getStateCacheManager()->invalidateStateForTexture(mTextureID);
         OGRE_CHECK_GL_ERROR(glDeleteTextures(1, &mTextureID));
     }
 
@@ -31,9 +31,13 @@
 
 #include "OgreGL3PlusHardwareBufferManager.h"
 #include "OgreGL3PlusHardwarePixelBuffer.h"
+#include "OgreGL3PlusPixelUploadPool.h"
 #include "OgreGL3PlusTextureBuffer.h"
 #include "OgreGL3PlusPixelFormat.h"
 #include "OgreGL3PlusFBORenderTexture.h"
+#include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusStateCacheManager.h"
+#include "OgreGL3PlusSupport.h"
 
 #include "OgreGLSLMonolithicProgram.h"
 #include "OgreGLSLMonolithicProgramManager.h"
@@ -51,7 +55,7 @@ namespace Ogre {
         // devise mWidth, mHeight and mDepth and mFormat
         GLint value = 0;
 
-        OGRE_CHECK_GL_ERROR(glBindTexture(mTarget, mTextureID));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLTexture(mTarget, mTextureID);
 
         // Get face identifier
         mFaceTarget = mTarget;
@@ -139,12 +143,12 @@ namespace Ogre {
 
     void GL3PlusTextureBuffer::upload(const PixelBox &data, const Image::Box &dest)
     {
-        OGRE_CHECK_GL_ERROR(glBindTexture(mTarget, mTextureID));
-
-        OGRE_CHECK_GL_ERROR(glGenBuffers(1, &mBufferId));
+        if (PixelUtil::isCompressed(data.format) && (data.format != mFormat || !data.isConsecutive()))
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                        "Compressed images must be consecutive and in the designated source format",
+                        "GL3PlusTextureBuffer::upload");
 
-        // Use PBO as a texture buffer.
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLTexture(mTarget, mTextureID);
 
         // Calculate size for all mip levels of the texture.
         size_t dataSize = 0;
@@ -157,10 +161,6 @@ namespace Ogre {
             dataSize = PixelUtil::getMemorySize(data.getWidth(), data.getHeight(), mDepth, data.format);
         }
 
-        //TODO Is this the correct was to set buffer size in this case?
-        // Fill buffer with NULL values in order to set the buffer size.
-        OGRE_CHECK_GL_ERROR(glBufferData(GL_PIXEL_UNPACK_BUFFER, dataSize, NULL, GL3PlusHardwareBufferManager::getGLUsage(mUsage)));
-
         // std::stringstream str;
         // str << "GL3PlusHardwarePixelBuffer::upload: " << mTextureID
         // << " pixel buffer: " << mBufferId
@@ -173,36 +173,53 @@ namespace Ogre {
         // << " format: " << PixelUtil::getFormatName(mFormat);
         // LogManager::getSingleton().logMessage(LML_NORMAL, str.str());
 
-        void* pBuffer = 0;
-        OGRE_CHECK_GL_ERROR(pBuffer = glMapBufferRange(
-            GL_PIXEL_UNPACK_BUFFER, 0, dataSize,
-            GL_MAP_WRITE_BIT|GL_MAP_INVALIDATE_RANGE_BIT));
-
-        if (pBuffer == 0)
+        // Stage the data in a pooled PBO the GPU is done with, so neither the copy nor
+        // glTexSubImage has to wait for it, and the transfer overlaps with rendering.
+        GL3PlusPixelUploadPool* uploadPool =
+            static_cast<GL3PlusHardwareBufferManager*>(HardwareBufferManager::getSingletonPtr())->getPixelUploadPool();
+        if (uploadPool)
         {
-            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
-                        "Texture Buffer: Out of memory",
-                        "GL3PlusTextureBuffer::upload");
+            void* pBuffer = uploadPool->map(dataSize, mBufferId);
+            memcpy(pBuffer, data.data, dataSize);
+            uploadPool->unmap(mBufferId);
         }
-
-        // Copy texture data to destination buffer.
-        memcpy(pBuffer, data.data, dataSize);
-        GLboolean mapped = false;
-        OGRE_CHECK_GL_ERROR(mapped = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
-        if (!mapped)
+        else
         {
-            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
-                        "Buffer data corrupted, please reload",
-                        "GL3PlusTextureBuffer::upload");
+            OGRE_CHECK_GL_ERROR(glGenBuffers(1, &mBufferId));
+
+            // Use PBO as a texture buffer.
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_PIXEL_UNPACK_BUFFER, mBufferId);
+
+            //TODO Is this the correct was to set buffer size in this case?
+            // Fill buffer with NULL values in order to set the buffer size.
+            OGRE_CHECK_GL_ERROR(glBufferData(GL_PIXEL_UNPACK_BUFFER, dataSize, NULL, GL3PlusHardwareBufferManager::getGLUsage(mUsage)));
+
+            void* pBuffer = 0;
+            OGRE_CHECK_GL_ERROR(pBuffer = glMapBufferRange(
+                GL_PIXEL_UNPACK_BUFFER, 0, dataSize,
+                GL_MAP_WRITE_BIT|GL_MAP_INVALIDATE_RANGE_BIT));
+
+            if (pBuffer == 0)
+            {
+                OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                            "Texture Buffer: Out of memory",
+                            "GL3PlusTextureBuffer::upload");
+            }
+
+            // Copy texture data to destination buffer.
+            memcpy(pBuffer, data.data, dataSize);
+            GLboolean mapped = false;
+            OGRE_CHECK_GL_ERROR(mapped = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+            if (!mapped)
+            {
+                OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                            "Buffer data corrupted, please reload",
+                            "GL3PlusTextureBuffer::upload");
+            }
         }
 
         if (PixelUtil::isCompressed(data.format))
         {
-            if (data.format != mFormat || !data.isConsecutive())
-                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
-                            "Compressed images must be consecutive and in the designated source format",
-                            "GL3PlusTextureBuffer::upload");
-
             GLenum format = GL3PlusPixelUtil::getClosestGLInternalFormat(mFormat);
             // Data must be consecutive and at beginning of buffer as
             // PixelStorei not allowed for compressed formats.
@@ -310,9 +327,12 @@ namespace Ogre {
             }
         }
 
-        // Delete PBO.
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
-        OGRE_CHECK_GL_ERROR(glDeleteBuffers(1, &mBufferId));
+        // Give back or delete PBO.
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (uploadPool)
+            uploadPool->release(mBufferId);
+        else
+            getGL3PlusSupportRef()->getStateCacheManager()->deleteGLBuffer(mBufferId);
         mBufferId = 0;
 
         // Restore defaults.
@@ -333,7 +353,7 @@ namespace Ogre {
 
         // Upload data to PBO
         OGRE_CHECK_GL_ERROR(glGenBuffers(1, &mBufferId));
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_PIXEL_PACK_BUFFER, mBufferId);
 
         OGRE_CHECK_GL_ERROR(glBufferData(GL_PIXEL_PACK_BUFFER, mSizeInBytes, NULL,
                                          GL3PlusHardwareBufferManager::getGLUsage(mUsage)));
@@ -347,7 +367,7 @@ namespace Ogre {
         //        << " format: " << PixelUtil::getFormatName(mFormat);
         //        LogManager::getSingleton().logMessage(LML_NORMAL, str.str());
 
-        OGRE_CHECK_GL_ERROR(glBindTexture(mTarget, mTextureID));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLTexture(mTarget, mTextureID);
         if (PixelUtil::isCompressed(data.format))
         {
             if (data.format != mFormat || !data.isConsecutive())
@@ -422,8 +442,8 @@ namespace Ogre {
         }
 
         // Delete PBO
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
-        OGRE_CHECK_GL_ERROR(glDeleteBuffers(1, &mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        getGL3PlusSupportRef()->getStateCacheManager()->deleteGLBuffer(mBufferId);
         mBufferId = 0;
     }
 
@@ -438,7 +458,7 @@ namespace Ogre {
 
     void GL3PlusTextureBuffer::copyFromFramebuffer(uint32 zoffset)
     {
-        OGRE_CHECK_GL_ERROR(glBindTexture(mTarget, mTextureID));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLTexture(mTarget, mTextureID);
         switch(mTarget)
         {
         case GL_TEXTURE_1D:
@@ -519,9 +539,9 @@ namespace Ogre {
             // If target format not directly supported, create intermediate texture
             GLenum tempFormat = GL3PlusPixelUtil::getClosestGLInternalFormat(fboMan->getSupportedAlternative(mFormat));
             OGRE_CHECK_GL_ERROR(glGenTextures(1, &tempTex));
-            OGRE_CHECK_GL_ERROR(glBindTexture(GL_TEXTURE_2D, tempTex));
-            OGRE_CHECK_GL_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0));
-            OGRE_CHECK_GL_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLTexture(GL_TEXTURE_2D, tempTex);
+            getGL3PlusSupportRef()->getStateCacheManager()->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+            getGL3PlusSupportRef()->getStateCacheManager()->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
 
             // Allocate temporary texture of the size of the destination area
             OGRE_CHECK_GL_ERROR(glTexImage2D(GL_TEXTURE_2D, 0, tempFormat,
@@ -596,13 +616,13 @@ namespace Ogre {
             // Generate mipmaps
             if (mUsage & TU_AUTOMIPMAP)
             {
-                OGRE_CHECK_GL_ERROR(glBindTexture(mTarget, mTextureID));
+                getGL3PlusSupportRef()->getStateCacheManager()->bindGLTexture(mTarget, mTextureID);
                 OGRE_CHECK_GL_ERROR(glGenerateMipmap(mTarget));
             }
         }
 
         // Reset source texture to sane state
-        OGRE_CHECK_GL_ERROR(glBindTexture(src->mTarget, src->mTextureID));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLTexture(src->mTarget, src->mTextureID);
 
         if (mFormat == PF_DEPTH)
         {
@@ -621,6 +641,7 @@ namespace Ogre {
 
         // Restore old framebuffer
         OGRE_CHECK_GL_ERROR(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, oldfb));
+        getGL3PlusSupportRef()->getStateCacheManager()->invalidateStateForTexture(tempTex);
         OGRE_CHECK_GL_ERROR(glDeleteTextures(1, &tempTex));
     }
 
@@ -629,7 +650,7 @@ namespace Ogre {
         assert(zoffset < mDepth);
         assert(which == GL_READ_FRAMEBUFFER || which == GL_DRAW_FRAMEBUFFER || which == GL_FRAMEBUFFER);
 
-        OGRE_CHECK_GL_ERROR(glBindTexture(mTarget, mTextureID));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLTexture(mTarget, mTextureID);
         switch(mTarget)
         {
         case GL_TEXTURE_1D:
@@ -697,11 +718,11 @@ namespace Ogre {
         OGRE_CHECK_GL_ERROR(glGenTextures(1, &id));
 
         // Set texture type
-        OGRE_CHECK_GL_ERROR(glBindTexture(target, id));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLTexture(target, id);
 
         // Set automatic mipmap generation; nice for minimisation
-        OGRE_CHECK_GL_ERROR(glTexParameteri(target, GL_TEXTURE_BASE_LEVEL, 0));
-        OGRE_CHECK_GL_ERROR(glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, 1000));
+        getGL3PlusSupportRef()->getStateCacheManager()->setTexParameteri(target, GL_TEXTURE_BASE_LEVEL, 0);
+        getGL3PlusSupportRef()->getStateCacheManager()->setTexParameteri(target, GL_TEXTURE_MAX_LEVEL, 1000);
 
         GLenum internalFormat = GL3PlusPixelUtil::getGLInternalFormat(src.format);
 
@@ -741,6 +762,7 @@ namespace Ogre {
         blitFromTexture(&tex, tempTarget, dstBox);
 
         // Delete temp texture
+        getGL3PlusSupportRef()->getStateCacheManager()->invalidateStateForTexture(id);
         OGRE_CHECK_GL_ERROR(glDeleteTextures(1, &id));
     }
 
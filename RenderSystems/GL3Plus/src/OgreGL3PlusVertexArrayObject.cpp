@@ -26,7 +26,11 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
   -----------------------------------------------------------------------------
 */
 #include "OgreGL3PlusVertexArrayObject.h"
+#include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusStateCacheManager.h"
+#include "OgreGL3PlusSupport.h"
 #include "OgreLogManager.h"
+#include "OgreRoot.h"
 
 namespace Ogre {
 
@@ -49,7 +53,7 @@ namespace Ogre {
     {
         if (mVAO)
         {
-            OGRE_CHECK_GL_ERROR(glDeleteVertexArrays(1, &mVAO));
+            getGL3PlusSupportRef()->getStateCacheManager()->deleteGLVertexArray(mVAO);
             mVAO = 0;
         }
     }
@@ -59,9 +63,148 @@ namespace Ogre {
     {
         if (mVAO)
         {
-            OGRE_CHECK_GL_ERROR(glBindVertexArray(mVAO));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLVertexArray(mVAO);
         }
     }
 
 
+    GL3PlusVertexArrayObjectCache::GL3PlusVertexArrayObjectCache(GL3PlusStateCacheManager* stateCacheManager, size_t maxSize) :
+        mStateCacheManager(stateCacheManager),
+        mMaxSize(maxSize),
+        mUseCount(0)
+    {
+    }
+
+
+    GL3PlusVertexArrayObjectCache::~GL3PlusVertexArrayObjectCache()
+    {
+    }
+
+
+    uint32 GL3PlusVertexArrayObjectCache::hashBindings(const AttribBindingList& bindings)
+    {
+        uint32 hash = 0;
+        AttribBindingList::const_iterator i, iend = bindings.end();
+        for (i = bindings.begin(); i != iend; ++i)
+        {
+            hash = HashCombine(hash, i->attrib);
+            hash = HashCombine(hash, i->buffer);
+            hash = HashCombine(hash, i->size);
+            hash = HashCombine(hash, i->type);
+            hash = HashCombine(hash, i->normalised);
+            hash = HashCombine(hash, i->isDouble);
+            hash = HashCombine(hash, i->stride);
+            hash = HashCombine(hash, i->offset);
+            hash = HashCombine(hash, i->divisor);
+        }
+        return hash;
+    }
+
+
+    void GL3PlusVertexArrayObjectCache::bind(const AttribBindingList& bindings)
+    {
+        // Delete what was dropped while another context was current
+        vector<GLuint>::type::iterator p, pend = mPendingDeletes.end();
+        for (p = mPendingDeletes.begin(); p != pend; ++p)
+            mStateCacheManager->deleteGLVertexArray(*p);
+        mPendingDeletes.clear();
+
+        uint32 hash = hashBindings(bindings);
+        EntryMap::iterator i = mEntries.find(hash);
+        if (i != mEntries.end())
+        {
+            if (i->second.bindings == bindings)
+            {
+                i->second.lastUsed = ++mUseCount;
+                mStateCacheManager->bindGLVertexArray(i->second.vao);
+                return;
+            }
+
+            // Hash collision, replace the old setup
+            mStateCacheManager->deleteGLVertexArray(i->second.vao);
+            mEntries.erase(i);
+        }
+        else if (mEntries.size() >= mMaxSize)
+        {
+            evictLeastRecentlyUsed();
+        }
+
+        Entry entry;
+        entry.bindings = bindings;
+        entry.lastUsed = ++mUseCount;
+        OGRE_CHECK_GL_ERROR(glGenVertexArrays(1, &entry.vao));
+        if (!entry.vao)
+        {
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                        "Cannot create GL Vertex Array Object",
+                        "GL3PlusVertexArrayObjectCache::bind");
+        }
+        mStateCacheManager->bindGLVertexArray(entry.vao);
+
+        AttribBindingList::const_iterator b, bend = bindings.end();
+        for (b = bindings.begin(); b != bend; ++b)
+        {
+            mStateCacheManager->bindGLBuffer(GL_ARRAY_BUFFER, b->buffer);
+            if (b->isDouble)
+            {
+                OGRE_CHECK_GL_ERROR(glVertexAttribLPointer(b->attrib, b->size, b->type, b->stride,
+                                                           GL_BUFFER_OFFSET(b->offset)));
+            }
+            else
+            {
+                OGRE_CHECK_GL_ERROR(glVertexAttribPointer(b->attrib, b->size, b->type, b->normalised,
+                                                          b->stride, GL_BUFFER_OFFSET(b->offset)));
+            }
+            if (b->divisor)
+                OGRE_CHECK_GL_ERROR(glVertexAttribDivisor(b->attrib, b->divisor));
+            OGRE_CHECK_GL_ERROR(glEnableVertexAttribArray(b->attrib));
+        }
+
+        mEntries.insert(EntryMap::value_type(hash, entry));
+    }
+
+
+    void GL3PlusVertexArrayObjectCache::evictLeastRecentlyUsed(void)
+    {
+        EntryMap::iterator oldest = mEntries.begin();
+        EntryMap::iterator i, iend = mEntries.end();
+        for (i = mEntries.begin(); i != iend; ++i)
+        {
+            if (i->second.lastUsed < oldest->second.lastUsed)
+                oldest = i;
+        }
+
+        if (oldest != iend)
+        {
+            mStateCacheManager->deleteGLVertexArray(oldest->second.vao);
+            mEntries.erase(oldest);
+        }
+    }
+
+
+    void GL3PlusVertexArrayObjectCache::_notifyBufferDestroyed(GLuint buffer, bool isCurrent)
+    {
+        EntryMap::iterator i = mEntries.begin();
+        while (i != mEntries.end())
+        {
+            bool uses = false;
+            AttribBindingList::const_iterator b, bend = i->second.bindings.end();
+            for (b = i->second.bindings.begin(); b != bend && !uses; ++b)
+                uses = b->buffer == buffer;
+
+            if (uses)
+            {
+                if (isCurrent)
+                    mStateCacheManager->deleteGLVertexArray(i->second.vao);
+                else
+                    mPendingDeletes.push_back(i->second.vao);
+                mEntries.erase(i++);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
 }
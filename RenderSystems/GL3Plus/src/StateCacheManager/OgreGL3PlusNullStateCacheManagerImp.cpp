@@ -0,0 +1,247 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreGL3PlusNullStateCacheManagerImp.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
+
+namespace Ogre {
+
+    GL3PlusStateCacheManagerImp::GL3PlusStateCacheManagerImp(void)
+    {
+        clearCache();
+    }
+
+    GL3PlusStateCacheManagerImp::~GL3PlusStateCacheManagerImp(void)
+    {
+    }
+
+    void GL3PlusStateCacheManagerImp::initializeCache()
+    {
+        OGRE_CHECK_GL_ERROR(glBlendEquation(GL_FUNC_ADD));
+
+        OGRE_CHECK_GL_ERROR(glBlendFunc(GL_ONE, GL_ZERO));
+
+        OGRE_CHECK_GL_ERROR(glCullFace(mCullFace));
+
+        OGRE_CHECK_GL_ERROR(glDepthFunc(mDepthFunc));
+
+        OGRE_CHECK_GL_ERROR(glDepthMask(mDepthMask));
+
+        OGRE_CHECK_GL_ERROR(glStencilMask(mStencilMask));
+
+        OGRE_CHECK_GL_ERROR(glClearDepth(mClearDepth));
+
+        OGRE_CHECK_GL_ERROR(glColorMask(mColourMask[0], mColourMask[1], mColourMask[2], mColourMask[3]));
+
+        OGRE_CHECK_GL_ERROR(glPolygonMode(GL_FRONT_AND_BACK, mPolygonMode));
+
+        OGRE_CHECK_GL_ERROR(glActiveTexture(GL_TEXTURE0));
+
+        OGRE_CHECK_GL_ERROR(glGetIntegerv(GL_VIEWPORT, mViewport));
+    }
+
+    void GL3PlusStateCacheManagerImp::clearCache()
+    {
+        mDepthMask = GL_TRUE;
+        mPolygonMode = GL_FILL;
+        mCullFace = GL_BACK;
+        mDepthFunc = GL_LESS;
+        mStencilMask = 0xFFFFFFFF;
+        mActiveTextureUnit = 0;
+        mClearDepth = 1.0f;
+
+        mColourMask[0] = mColourMask[1] = mColourMask[2] = mColourMask[3] = GL_TRUE;
+
+        mViewport[0] = 0;
+        mViewport[1] = 0;
+        mViewport[2] = 0;
+        mViewport[3] = 0;
+    }
+
+    void GL3PlusStateCacheManagerImp::bindGLBuffer(GLenum target, GLuint buffer, bool force)
+    {
+        OGRE_CHECK_GL_ERROR(glBindBuffer(target, buffer));
+    }
+
+    void GL3PlusStateCacheManagerImp::bindGLBufferBase(GLenum target, GLuint index, GLuint buffer)
+    {
+        OGRE_CHECK_GL_ERROR(glBindBufferBase(target, index, buffer));
+    }
+
+    void GL3PlusStateCacheManagerImp::deleteGLBuffer(GLuint buffer)
+    {
+        // Buffer name 0 is reserved and we should never try to delete it
+        if (buffer == 0)
+            return;
+
+        OGRE_CHECK_GL_ERROR(glDeleteBuffers(1, &buffer));
+    }
+
+    void GL3PlusStateCacheManagerImp::bindGLVertexArray(GLuint vao)
+    {
+        OGRE_CHECK_GL_ERROR(glBindVertexArray(vao));
+    }
+
+    void GL3PlusStateCacheManagerImp::deleteGLVertexArray(GLuint vao)
+    {
+        if (vao == 0)
+            return;
+
+        OGRE_CHECK_GL_ERROR(glDeleteVertexArrays(1, &vao));
+    }
+
+    void GL3PlusStateCacheManagerImp::bindGLTexture(GLenum target, GLuint texture)
+    {
+        OGRE_CHECK_GL_ERROR(glBindTexture(target, texture));
+    }
+
+    void GL3PlusStateCacheManagerImp::invalidateStateForTexture(GLuint texture)
+    {
+    }
+
+    void GL3PlusStateCacheManagerImp::setTexParameteri(GLenum target, GLenum pname, GLint param)
+    {
+        OGRE_CHECK_GL_ERROR(glTexParameteri(target, pname, param));
+    }
+
+    bool GL3PlusStateCacheManagerImp::activateGLTextureUnit(size_t unit)
+    {
+        if (unit < Root::getSingleton().getRenderSystem()->getCapabilities()->getNumTextureUnits())
+        {
+            OGRE_CHECK_GL_ERROR(glActiveTexture(static_cast<GLenum>(GL_TEXTURE0 + unit)));
+            mActiveTextureUnit = unit;
+            return true;
+        }
+
+        // Always OK to use the first unit.
+        return unit == 0;
+    }
+
+    void GL3PlusStateCacheManagerImp::bindGLSampler(GLuint unit, GLuint sampler)
+    {
+        OGRE_CHECK_GL_ERROR(glBindSampler(unit, sampler));
+    }
+
+    void GL3PlusStateCacheManagerImp::bindGLProgram(GLuint program)
+    {
+        OGRE_CHECK_GL_ERROR(glUseProgram(program));
+    }
+
+    void GL3PlusStateCacheManagerImp::bindGLProgramPipeline(GLuint pipeline)
+    {
+        OGRE_CHECK_GL_ERROR(glBindProgramPipeline(pipeline));
+    }
+
+    void GL3PlusStateCacheManagerImp::setBlendEquation(GLenum eqRGB, GLenum eqAlpha)
+    {
+        OGRE_CHECK_GL_ERROR(glBlendEquationSeparate(eqRGB, eqAlpha));
+    }
+
+    void GL3PlusStateCacheManagerImp::setBlendFunc(GLenum source, GLenum dest, GLenum sourceA, GLenum destA)
+    {
+        OGRE_CHECK_GL_ERROR(glBlendFuncSeparate(source, dest, sourceA, destA));
+    }
+
+    void GL3PlusStateCacheManagerImp::setDepthMask(GLboolean mask)
+    {
+        mDepthMask = mask;
+        OGRE_CHECK_GL_ERROR(glDepthMask(mask));
+    }
+
+    void GL3PlusStateCacheManagerImp::setDepthFunc(GLenum func)
+    {
+        mDepthFunc = func;
+        OGRE_CHECK_GL_ERROR(glDepthFunc(func));
+    }
+
+    void GL3PlusStateCacheManagerImp::setClearDepth(GLclampf depth)
+    {
+        mClearDepth = depth;
+        OGRE_CHECK_GL_ERROR(glClearDepth(depth));
+    }
+
+    void GL3PlusStateCacheManagerImp::setClearColour(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
+    {
+        OGRE_CHECK_GL_ERROR(glClearColor(red, green, blue, alpha));
+    }
+
+    void GL3PlusStateCacheManagerImp::setColourMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+    {
+        mColourMask[0] = red;
+        mColourMask[1] = green;
+        mColourMask[2] = blue;
+        mColourMask[3] = alpha;
+        OGRE_CHECK_GL_ERROR(glColorMask(red, green, blue, alpha));
+    }
+
+    void GL3PlusStateCacheManagerImp::setStencilMask(GLuint mask)
+    {
+        mStencilMask = mask;
+        OGRE_CHECK_GL_ERROR(glStencilMask(mask));
+    }
+
+    void GL3PlusStateCacheManagerImp::setEnabled(GLenum flag, bool enabled)
+    {
+        if (enabled)
+        {
+            OGRE_CHECK_GL_ERROR(glEnable(flag));
+        }
+        else
+        {
+            OGRE_CHECK_GL_ERROR(glDisable(flag));
+        }
+    }
+
+    void GL3PlusStateCacheManagerImp::setPolygonMode(GLenum mode)
+    {
+        mPolygonMode = mode;
+        OGRE_CHECK_GL_ERROR(glPolygonMode(GL_FRONT_AND_BACK, mode));
+    }
+
+    void GL3PlusStateCacheManagerImp::setCullFace(GLenum face)
+    {
+        mCullFace = face;
+        OGRE_CHECK_GL_ERROR(glCullFace(face));
+    }
+
+    void GL3PlusStateCacheManagerImp::setViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        mViewport[0] = x;
+        mViewport[1] = y;
+        mViewport[2] = width;
+        mViewport[3] = height;
+        OGRE_CHECK_GL_ERROR(glViewport(x, y, width, height));
+    }
+
+    void GL3PlusStateCacheManagerImp::getViewport(int* array) const
+    {
+        for (int i = 0; i < 4; ++i)
+            array[i] = mViewport[i];
+    }
+}
@@ -0,0 +1,467 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreGL3PlusStateCacheManagerImp.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
+
+namespace Ogre {
+
+    GL3PlusStateCacheManagerImp::GL3PlusStateCacheManagerImp(void)
+    {
+        clearCache();
+    }
+
+    GL3PlusStateCacheManagerImp::~GL3PlusStateCacheManagerImp(void)
+    {
+    }
+
+    void GL3PlusStateCacheManagerImp::initializeCache()
+    {
+        OGRE_CHECK_GL_ERROR(glBlendEquationSeparate(mBlendEquationRGB, mBlendEquationAlpha));
+
+        OGRE_CHECK_GL_ERROR(glBlendFuncSeparate(mBlendFuncSource, mBlendFuncDest,
+                                                mBlendFuncSourceAlpha, mBlendFuncDestAlpha));
+
+        OGRE_CHECK_GL_ERROR(glCullFace(mCullFace));
+
+        OGRE_CHECK_GL_ERROR(glDepthFunc(mDepthFunc));
+
+        OGRE_CHECK_GL_ERROR(glDepthMask(mDepthMask));
+
+        OGRE_CHECK_GL_ERROR(glStencilMask(mStencilMask));
+
+        OGRE_CHECK_GL_ERROR(glClearDepth(mClearDepth));
+
+        OGRE_CHECK_GL_ERROR(glClearColor(mClearColour[0], mClearColour[1], mClearColour[2], mClearColour[3]));
+
+        OGRE_CHECK_GL_ERROR(glColorMask(mColourMask[0], mColourMask[1], mColourMask[2], mColourMask[3]));
+
+        OGRE_CHECK_GL_ERROR(glPolygonMode(GL_FRONT_AND_BACK, mPolygonMode));
+
+        OGRE_CHECK_GL_ERROR(glActiveTexture(GL_TEXTURE0));
+
+        OGRE_CHECK_GL_ERROR(glBindTexture(GL_TEXTURE_2D, 0));
+
+        OGRE_CHECK_GL_ERROR(glBindVertexArray(0));
+
+        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ARRAY_BUFFER, 0));
+
+        OGRE_CHECK_GL_ERROR(glUseProgram(0));
+
+        // The default viewport covers the drawable the context was created for
+        OGRE_CHECK_GL_ERROR(glGetIntegerv(GL_VIEWPORT, mViewport));
+    }
+
+    void GL3PlusStateCacheManagerImp::clearCache()
+    {
+        mDepthMask = GL_TRUE;
+        mBlendEquationRGB = GL_FUNC_ADD;
+        mBlendEquationAlpha = GL_FUNC_ADD;
+        mBlendFuncSource = GL_ONE;
+        mBlendFuncDest = GL_ZERO;
+        mBlendFuncSourceAlpha = GL_ONE;
+        mBlendFuncDestAlpha = GL_ZERO;
+        mCullFace = GL_BACK;
+        mDepthFunc = GL_LESS;
+        mStencilMask = 0xFFFFFFFF;
+        mActiveTextureUnit = 0;
+        mClearDepth = 1.0f;
+        mPolygonMode = GL_FILL;
+        mBoundVertexArray = 0;
+        mBoundProgram = 0;
+        mBoundProgramPipeline = 0;
+
+        mClearColour[0] = mClearColour[1] = mClearColour[2] = mClearColour[3] = 0.0f;
+        mColourMask[0] = mColourMask[1] = mColourMask[2] = mColourMask[3] = GL_TRUE;
+
+        mViewport[0] = 0;
+        mViewport[1] = 0;
+        mViewport[2] = 0;
+        mViewport[3] = 0;
+
+        mActiveBufferMap.clear();
+        mBoundTextures.clear();
+        mBoundSamplers.clear();
+        mTexParameteriMaps.clear();
+        mBoolStateMap.clear();
+    }
+
+    void GL3PlusStateCacheManagerImp::bindGLBuffer(GLenum target, GLuint buffer, bool force)
+    {
+        BindBufferMap::iterator i = mActiveBufferMap.find(target);
+        if (i == mActiveBufferMap.end())
+        {
+            // Haven't cached this state yet.  Insert it into the map
+            mActiveBufferMap.insert(BindBufferMap::value_type(target, buffer));
+        }
+        else if (i->second != buffer || force)
+        {
+            // Update the cached value if needed
+            i->second = buffer;
+        }
+        else
+        {
+            return;
+        }
+
+        OGRE_CHECK_GL_ERROR(glBindBuffer(target, buffer));
+    }
+
+    void GL3PlusStateCacheManagerImp::bindGLBufferBase(GLenum target, GLuint index, GLuint buffer)
+    {
+        // Indexed bindings are not filtered, but they replace the generic binding
+        OGRE_CHECK_GL_ERROR(glBindBufferBase(target, index, buffer));
+        mActiveBufferMap[target] = buffer;
+    }
+
+    void GL3PlusStateCacheManagerImp::deleteGLBuffer(GLuint buffer)
+    {
+        // Buffer name 0 is reserved and we should never try to delete it
+        if (buffer == 0)
+            return;
+
+        OGRE_CHECK_GL_ERROR(glDeleteBuffers(1, &buffer));
+
+        // Deleting a buffer reverts every binding of it to 0
+        for (BindBufferMap::iterator i = mActiveBufferMap.begin(); i != mActiveBufferMap.end(); ++i)
+        {
+            if (i->second == buffer)
+                i->second = 0;
+        }
+    }
+
+    void GL3PlusStateCacheManagerImp::bindGLVertexArray(GLuint vao)
+    {
+        if (mBoundVertexArray != vao)
+        {
+            mBoundVertexArray = vao;
+            OGRE_CHECK_GL_ERROR(glBindVertexArray(vao));
+
+            // The element array binding belongs to the vertex array object
+            mActiveBufferMap.erase(GL_ELEMENT_ARRAY_BUFFER);
+        }
+    }
+
+    void GL3PlusStateCacheManagerImp::deleteGLVertexArray(GLuint vao)
+    {
+        if (vao == 0)
+            return;
+
+        OGRE_CHECK_GL_ERROR(glDeleteVertexArrays(1, &vao));
+
+        // Deleting the bound vertex array object reverts the binding to 0
+        if (mBoundVertexArray == vao)
+        {
+            mBoundVertexArray = 0;
+            mActiveBufferMap.erase(GL_ELEMENT_ARRAY_BUFFER);
+        }
+    }
+
+    GLuint GL3PlusStateCacheManagerImp::getBoundTexture(GLenum target) const
+    {
+        if (mActiveTextureUnit >= mBoundTextures.size())
+            return 0;
+
+        const TextureTargetMap& targets = mBoundTextures[mActiveTextureUnit];
+        TextureTargetMap::const_iterator i = targets.find(target);
+        return i != targets.end() ? i->second : 0;
+    }
+
+    void GL3PlusStateCacheManagerImp::bindGLTexture(GLenum target, GLuint texture)
+    {
+        if (mActiveTextureUnit >= mBoundTextures.size())
+            mBoundTextures.resize(mActiveTextureUnit + 1);
+
+        TextureTargetMap& targets = mBoundTextures[mActiveTextureUnit];
+        TextureTargetMap::iterator i = targets.find(target);
+        if (i == targets.end())
+        {
+            targets.insert(TextureTargetMap::value_type(target, texture));
+        }
+        else if (i->second != texture)
+        {
+            i->second = texture;
+        }
+        else
+        {
+            return;
+        }
+
+        OGRE_CHECK_GL_ERROR(glBindTexture(target, texture));
+    }
+
+    void GL3PlusStateCacheManagerImp::invalidateStateForTexture(GLuint texture)
+    {
+        mTexParameteriMaps.erase(texture);
+
+        // Deleting a texture reverts every binding of it to 0
+        for (size_t unit = 0; unit < mBoundTextures.size(); ++unit)
+        {
+            TextureTargetMap& targets = mBoundTextures[unit];
+            for (TextureTargetMap::iterator i = targets.begin(); i != targets.end(); ++i)
+            {
+                if (i->second == texture)
+                    i->second = 0;
+            }
+        }
+    }
+
+    void GL3PlusStateCacheManagerImp::setTexParameteri(GLenum target, GLenum pname, GLint param)
+    {
+        TexParameteriMap& params = mTexParameteriMaps[getBoundTexture(target)];
+        TexParameteriMap::iterator i = params.find(pname);
+        if (i == params.end())
+        {
+            // Haven't cached this state yet.  Insert it into the map
+            params.insert(TexParameteriMap::value_type(pname, param));
+        }
+        else if (i->second != param)
+        {
+            i->second = param;
+        }
+        else
+        {
+            return;
+        }
+
+        OGRE_CHECK_GL_ERROR(glTexParameteri(target, pname, param));
+    }
+
+    bool GL3PlusStateCacheManagerImp::activateGLTextureUnit(size_t unit)
+    {
+        if (mActiveTextureUnit == unit)
+            return true;
+
+        if (unit < Root::getSingleton().getRenderSystem()->getCapabilities()->getNumTextureUnits())
+        {
+            OGRE_CHECK_GL_ERROR(glActiveTexture(static_cast<GLenum>(GL_TEXTURE0 + unit)));
+            mActiveTextureUnit = unit;
+            return true;
+        }
+
+        // Always OK to use the first unit.
+        return unit == 0;
+    }
+
+    void GL3PlusStateCacheManagerImp::bindGLSampler(GLuint unit, GLuint sampler)
+    {
+        if (unit >= mBoundSamplers.size())
+            mBoundSamplers.resize(unit + 1, 0);
+
+        if (mBoundSamplers[unit] != sampler)
+        {
+            mBoundSamplers[unit] = sampler;
+            OGRE_CHECK_GL_ERROR(glBindSampler(unit, sampler));
+        }
+    }
+
+    void GL3PlusStateCacheManagerImp::bindGLProgram(GLuint program)
+    {
+        if (mBoundProgram != program)
+        {
+            mBoundProgram = program;
+            OGRE_CHECK_GL_ERROR(glUseProgram(program));
+        }
+    }
+
+    void GL3PlusStateCacheManagerImp::bindGLProgramPipeline(GLuint pipeline)
+    {
+        if (mBoundProgramPipeline != pipeline)
+        {
+            mBoundProgramPipeline = pipeline;
+            OGRE_CHECK_GL_ERROR(glBindProgramPipeline(pipeline));
+        }
+    }
+
+    void GL3PlusStateCacheManagerImp::setBlendEquation(GLenum eqRGB, GLenum eqAlpha)
+    {
+        if (mBlendEquationRGB != eqRGB || mBlendEquationAlpha != eqAlpha)
+        {
+            mBlendEquationRGB = eqRGB;
+            mBlendEquationAlpha = eqAlpha;
+
+            OGRE_CHECK_GL_ERROR(glBlendEquationSeparate(eqRGB, eqAlpha));
+        }
+    }
+
+    void GL3PlusStateCacheManagerImp::setBlendFunc(GLenum source, GLenum dest, GLenum sourceA, GLenum destA)
+    {
+        if (mBlendFuncSource != source || mBlendFuncDest != dest ||
+            mBlendFuncSourceAlpha != sourceA || mBlendFuncDestAlpha != destA)
+        {
+            mBlendFuncSource = source;
+            mBlendFuncDest = dest;
+            mBlendFuncSourceAlpha = sourceA;
+            mBlendFuncDestAlpha = destA;
+
+            OGRE_CHECK_GL_ERROR(glBlendFuncSeparate(source, dest, sourceA, destA));
+        }
+    }
+
+    void GL3PlusStateCacheManagerImp::setDepthMask(GLboolean mask)
+    {
+        if (mDepthMask != mask)
+        {
+            mDepthMask = mask;
+
+            OGRE_CHECK_GL_ERROR(glDepthMask(mask));
+        }
+    }
+
+    void GL3PlusStateCacheManagerImp::setDepthFunc(GLenum func)
+    {
+        if (mDepthFunc != func)
+        {
+            mDepthFunc = func;
+
+            OGRE_CHECK_GL_ERROR(glDepthFunc(func));
+        }
+    }
+
+    void GL3PlusStateCacheManagerImp::setClearDepth(GLclampf depth)
+    {
+        if (mClearDepth != depth)
+        {
+            mClearDepth = depth;
+
+            OGRE_CHECK_GL_ERROR(glClearDepth(depth));
+        }
+    }
+
+    void GL3PlusStateCacheManagerImp::setClearColour(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
+    {
+        if ((mClearColour[0] != red) ||
+            (mClearColour[1] != green) ||
+            (mClearColour[2] != blue) ||
+            (mClearColour[3] != alpha))
+        {
+            mClearColour[0] = red;
+            mClearColour[1] = green;
+            mClearColour[2] = blue;
+            mClearColour[3] = alpha;
+
+            OGRE_CHECK_GL_ERROR(glClearColor(red, green, blue, alpha));
+        }
+    }
+
+    void GL3PlusStateCacheManagerImp::setColourMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+    {
+        if ((mColourMask[0] != red) ||
+            (mColourMask[1] != green) ||
+            (mColourMask[2] != blue) ||
+            (mColourMask[3] != alpha))
+        {
+            mColourMask[0] = red;
+            mColourMask[1] = green;
+            mColourMask[2] = blue;
+            mColourMask[3] = alpha;
+
+            OGRE_CHECK_GL_ERROR(glColorMask(red, green, blue, alpha));
+        }
+    }
+
+    void GL3PlusStateCacheManagerImp::setStencilMask(GLuint mask)
+    {
+        if (mStencilMask != mask)
+        {
+            mStencilMask = mask;
+
+            OGRE_CHECK_GL_ERROR(glStencilMask(mask));
+        }
+    }
+
+    void GL3PlusStateCacheManagerImp::setEnabled(GLenum flag, bool enabled)
+    {
+        GLbooleanStateMap::iterator i = mBoolStateMap.find(flag);
+        if (i == mBoolStateMap.end())
+        {
+            // Haven't cached this state yet.  Insert it into the map
+            mBoolStateMap.insert(GLbooleanStateMap::value_type(flag, enabled));
+        }
+        else if (i->second != enabled)
+        {
+            i->second = enabled;
+        }
+        else
+        {
+            return;
+        }
+
+        if (enabled)
+        {
+            OGRE_CHECK_GL_ERROR(glEnable(flag));
+        }
+        else
+        {
+            OGRE_CHECK_GL_ERROR(glDisable(flag));
+        }
+    }
+
+    void GL3PlusStateCacheManagerImp::setPolygonMode(GLenum mode)
+    {
+        if (mPolygonMode != mode)
+        {
+            mPolygonMode = mode;
+
+            OGRE_CHECK_GL_ERROR(glPolygonMode(GL_FRONT_AND_BACK, mode));
+        }
+    }
+
+    void GL3PlusStateCacheManagerImp::setCullFace(GLenum face)
+    {
+        if (mCullFace != face)
+        {
+            mCullFace = face;
+
+            OGRE_CHECK_GL_ERROR(glCullFace(face));
+        }
+    }
+
+    void GL3PlusStateCacheManagerImp::setViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        if ((mViewport[0] != x) ||
+            (mViewport[1] != y) ||
+            (mViewport[2] != width) ||
+            (mViewport[3] != height))
+        {
+            mViewport[0] = x;
+            mViewport[1] = y;
+            mViewport[2] = width;
+            mViewport[3] = height;
+
+            OGRE_CHECK_GL_ERROR(glViewport(x, y, width, height));
+        }
+    }
+
+    void GL3PlusStateCacheManagerImp::getViewport(int* array) const
+    {
+        for (int i = 0; i < 4; ++i)
+            array[i] = mViewport[i];
+    }
+}
@@ -0,0 +1,206 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __GL3PlusStateCacheManagerImp_H__
+#define __GL3PlusStateCacheManagerImp_H__
+
+#include "OgreGL3PlusPrerequisites.h"
+
+typedef Ogre::GeneralAllocatedObject StateCacheAlloc;
+
+namespace Ogre
+{
+    /** An in memory cache of the OpenGL state.
+     @see GL3PlusStateCacheManager
+     */
+    class _OgreGL3PlusExport GL3PlusStateCacheManagerImp : public StateCacheAlloc
+    {
+    private:
+        typedef OGRE_HashMap<GLenum, GLuint> BindBufferMap;
+        typedef OGRE_HashMap<GLenum, GLuint> TextureTargetMap;
+        typedef OGRE_HashMap<GLenum, GLint> TexParameteriMap;
+        typedef OGRE_HashMap<GLuint, TexParameteriMap> TexParameteriMaps;
+        typedef OGRE_HashMap<GLenum, bool> GLbooleanStateMap;
+
+        /// A map of different buffer types and the currently bound buffer for each type
+        BindBufferMap mActiveBufferMap;
+        /// Stores the textures bound to each target of every texture unit
+        vector<TextureTargetMap>::type mBoundTextures;
+        /// Stores the sampler objects bound to every texture unit
+        vector<GLuint>::type mBoundSamplers;
+        /// A map of texture parameters for each texture ID
+        TexParameteriMaps mTexParameteriMaps;
+        /// Array of each OpenGL feature that is enabled i.e. blending, depth test, etc.
+        GLbooleanStateMap mBoolStateMap;
+        /// Stores the currently bound vertex array object
+        GLuint mBoundVertexArray;
+        /// Stores the program currently in use
+        GLuint mBoundProgram;
+        /// Stores the currently bound program pipeline
+        GLuint mBoundProgramPipeline;
+        /// Stores the current clear colour
+        GLclampf mClearColour[4];
+        /// Stores the current colour write mask
+        GLboolean mColourMask[4];
+        /// Stores the current depth write mask
+        GLboolean mDepthMask;
+        /// Stores the current polygon rendering mode
+        GLenum mPolygonMode;
+        /// Stores the current blend equations
+        GLenum mBlendEquationRGB;
+        GLenum mBlendEquationAlpha;
+        /// Stores the current blend functions
+        GLenum mBlendFuncSource;
+        GLenum mBlendFuncDest;
+        GLenum mBlendFuncSourceAlpha;
+        GLenum mBlendFuncDestAlpha;
+        /// Stores the current face culling setting
+        GLenum mCullFace;
+        /// Stores the current depth test function
+        GLenum mDepthFunc;
+        /// Stores the current stencil mask
+        GLuint mStencilMask;
+        /// Stores the currently active texture unit
+        size_t mActiveTextureUnit;
+        /// Stores the current depth clearing colour
+        GLclampf mClearDepth;
+        /// Viewport origin and size
+        int mViewport[4];
+
+        /// Returns the texture bound to target on the active texture unit
+        GLuint getBoundTexture(GLenum target) const;
+
+    public:
+        GL3PlusStateCacheManagerImp(void);
+        ~GL3PlusStateCacheManagerImp(void);
+
+        /// Brings the current context in line with the cached values.
+        void initializeCache();
+
+        /// See GL3PlusStateCacheManager.clearCache.
+        void clearCache();
+
+        /// See GL3PlusStateCacheManager.bindGLBuffer.
+        void bindGLBuffer(GLenum target, GLuint buffer, bool force = false);
+
+        /// See GL3PlusStateCacheManager.bindGLBufferBase.
+        void bindGLBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+        /// See GL3PlusStateCacheManager.deleteGLBuffer.
+        void deleteGLBuffer(GLuint buffer);
+
+        /// See GL3PlusStateCacheManager.bindGLVertexArray.
+        void bindGLVertexArray(GLuint vao);
+
+        /// See GL3PlusStateCacheManager.deleteGLVertexArray.
+        void deleteGLVertexArray(GLuint vao);
+
+        /// See GL3PlusStateCacheManager.bindGLTexture.
+        void bindGLTexture(GLenum target, GLuint texture);
+
+        /// See GL3PlusStateCacheManager.invalidateStateForTexture.
+        void invalidateStateForTexture(GLuint texture);
+
+        /// See GL3PlusStateCacheManager.setTexParameteri.
+        void setTexParameteri(GLenum target, GLenum pname, GLint param);
+
+        /// See GL3PlusStateCacheManager.activateGLTextureUnit.
+        bool activateGLTextureUnit(size_t unit);
+
+        /// See GL3PlusStateCacheManager.bindGLSampler.
+        void bindGLSampler(GLuint unit, GLuint sampler);
+
+        /// See GL3PlusStateCacheManager.bindGLProgram.
+        void bindGLProgram(GLuint program);
+
+        /// See GL3PlusStateCacheManager.bindGLProgramPipeline.
+        void bindGLProgramPipeline(GLuint pipeline);
+
+        /// See GL3PlusStateCacheManager.setBlendEquation.
+        void setBlendEquation(GLenum eqRGB, GLenum eqAlpha);
+
+        /// See GL3PlusStateCacheManager.setBlendFunc.
+        void setBlendFunc(GLenum source, GLenum dest, GLenum sourceA, GLenum destA);
+
+        /// See GL3PlusStateCacheManager.getDepthMask.
+        GLboolean getDepthMask(void) const { return mDepthMask; }
+
+        /// See GL3PlusStateCacheManager.setDepthMask.
+        void setDepthMask(GLboolean mask);
+
+        /// See GL3PlusStateCacheManager.getDepthFunc.
+        GLenum getDepthFunc(void) const { return mDepthFunc; }
+
+        /// See GL3PlusStateCacheManager.setDepthFunc.
+        void setDepthFunc(GLenum func);
+
+        /// See GL3PlusStateCacheManager.getClearDepth.
+        GLclampf getClearDepth(void) const { return mClearDepth; }
+
+        /// See GL3PlusStateCacheManager.setClearDepth.
+        void setClearDepth(GLclampf depth);
+
+        /// See GL3PlusStateCacheManager.setClearColour.
+        void setClearColour(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha);
+
+        /// See GL3PlusStateCacheManager.getColourMask.
+        const GLboolean* getColourMask(void) const { return mColourMask; }
+
+        /// See GL3PlusStateCacheManager.setColourMask.
+        void setColourMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
+
+        /// See GL3PlusStateCacheManager.getStencilMask.
+        GLuint getStencilMask(void) const { return mStencilMask; }
+
+        /// See GL3PlusStateCacheManager.setStencilMask.
+        void setStencilMask(GLuint mask);
+
+        /// See GL3PlusStateCacheManager.setEnabled.
+        void setEnabled(GLenum flag, bool enabled);
+
+        /// See GL3PlusStateCacheManager.getPolygonMode.
+        GLenum getPolygonMode(void) const { return mPolygonMode; }
+
+        /// See GL3PlusStateCacheManager.setPolygonMode.
+        void setPolygonMode(GLenum mode);
+
+        /// See GL3PlusStateCacheManager.getCullFace.
+        GLenum getCullFace(void) const { return mCullFace; }
+
+        /// See GL3PlusStateCacheManager.setCullFace.
+        void setCullFace(GLenum face);
+
+        /// See GL3PlusStateCacheManager.setViewport.
+        void setViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+        /// See GL3PlusStateCacheManager.getViewport.
+        void getViewport(int* array) const;
+    };
+}
+
+#endif
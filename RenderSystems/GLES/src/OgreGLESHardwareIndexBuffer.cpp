@@ -96,7 +96,7 @@ namespace Ogre {
     void GLESHardwareIndexBuffer::notifyOnContextReset()
     {
         createBuffer();
-        mShadowUpdated = true;
+        addDirtyRange(0, mSizeInBytes);
         _updateFromShadow();
     }
 #endif
@@ -270,8 +270,8 @@ namespace Ogre {
     {
         if (mUseShadowBuffer && mShadowUpdated && !mSuppressHardwareUpdate)
         {
-            const void *srcData = mShadowBuffer->lock(mLockStart, mLockSize,
-                                                       HBL_READ_ONLY);
+            // Always re-upload the whole buffer, whichever ranges are dirty
+            const void *srcData = mShadowBuffer->lock(0, mSizeInBytes, HBL_READ_ONLY);
 
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
             GL_CHECK_ERROR;
@@ -291,6 +291,7 @@ namespace Ogre {
  //           }
 
             mShadowBuffer->unlock();
+            mDirtyRanges.clear();
             mShadowUpdated = false;
         }
     }
@@ -89,7 +89,7 @@ namespace Ogre {
     void GLESHardwareVertexBuffer::notifyOnContextReset()
     {
         createBuffer();
-        mShadowUpdated = true;
+        addDirtyRange(0, mSizeInBytes);
         _updateFromShadow();
     }
 #endif
@@ -266,9 +266,8 @@ namespace Ogre {
     {
         if (mUseShadowBuffer && mShadowUpdated && !mSuppressHardwareUpdate)
         {
-            const void *srcData = mShadowBuffer->lock(mLockStart,
-                                                       mLockSize,
-                                                       HBL_READ_ONLY);
+            // Always re-upload the whole buffer, whichever ranges are dirty
+            const void *srcData = mShadowBuffer->lock(0, mSizeInBytes, HBL_READ_ONLY);
 
             glBindBuffer(GL_ARRAY_BUFFER, mBufferId);
             GL_CHECK_ERROR;
@@ -287,6 +286,7 @@ namespace Ogre {
 //            }
 
             mShadowBuffer->unlock();
+            mDirtyRanges.clear();
             mShadowUpdated = false;
         }
     }
@@ -348,10 +348,9 @@ namespace Ogre {
             }
             else
             {
-                vector<Image>::type images(6);
-                ConstImagePtrList imagePtrs;
+                vector<DataStreamPtr>::type streams;
                 static const String suffixes[6] = {"_rt", "_lf", "_up", "_dn", "_fr", "_bk"};
-                
+
                 for(size_t i = 0; i < 6; i++)
                 {
                     String fullName = baseName + suffixes[i];
@@ -359,8 +358,11 @@ namespace Ogre {
                         fullName = fullName + "." + ext;
                     // find & load resource data intro stream to allow resource
                     // group changes if required
-                    doImageIO(fullName, mGroup, ext, *loadedImages, this);
+                    streams.push_back(ResourceGroupManager::getSingleton().openResource(
+                        fullName, mGroup, true, this));
                 }
+                // The faces are independent, decode them in parallel
+                Image::loadParallel(*loadedImages, streams, ext);
             }
         }
 #endif
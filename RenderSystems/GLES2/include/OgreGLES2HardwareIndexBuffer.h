@@ -38,6 +38,12 @@ namespace Ogre {
     {
         private:
             GLuint mBufferId;
+#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || OGRE_PLATFORM == OGRE_PLATFORM_EMSCRIPTEN
+            /// Copy of a static buffer without shadow buffer, to restore it after a context loss
+            GLES2RetainedBufferData mRetainedData;
+            /// Locked range to copy to mRetainedData on unlock, NULL if not retained
+            void* mRetainedLockData;
+#endif
         
         protected:
             /** See HardwareBuffer. */
@@ -73,7 +79,7 @@ namespace Ogre {
                       size_t dstOffset, size_t length, bool discardWholeBuffer = false);
 #endif
             /** See HardwareBuffer. */
-            void _updateFromShadow(void);
+            void uploadFromShadow(size_t offset, size_t length);
 
             inline GLuint getGLBufferId(void) const { return mBufferId; }
     };
@@ -59,6 +59,32 @@ namespace Ogre {
         virtual ~GLES2ManagedResource();
     };
 
+    /** Copy of the contents of a static buffer, kept within the retained data
+        budget of the GLES2ManagedResourceManager to restore the buffer after
+        a context loss.
+    */
+    class _OgrePrivate GLES2RetainedBufferData
+    {
+    public:
+        GLES2RetainedBufferData() : mData(0), mSize(0) {}
+        ~GLES2RetainedBufferData() { release(); }
+
+        /** Copies data written to a buffer of bufferSize bytes.
+        @remarks
+            The copy starts with a write of the whole buffer, if the budget allows
+            it; partial writes before that cannot be retained.
+        */
+        void write(size_t bufferSize, size_t offset, size_t length, const void* src);
+        /// Frees the copy
+        void release();
+        /// The copy of the whole buffer, or NULL if none is kept
+        const void* getData() const { return mData; }
+
+    private:
+        uint8* mData;
+        size_t mSize;
+    };
+
 #else
 #   define MANAGED_RESOURCE
 #   define MANAGED_RESOURCE_SINGLE
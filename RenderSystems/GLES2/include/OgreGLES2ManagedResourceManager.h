@@ -47,6 +47,21 @@ namespace Ogre {
         
         // Called immediately after the Android context has been reset.
         void notifyOnContextReset();
+
+        /** Sets how many bytes resources may keep to restore themselves after a
+            context loss without going back to their source, 0 disables it.
+        @remarks
+            Resources keep their data only if it fits when they are loaded or written.
+        */
+        void setRetainedDataBudget(size_t bytes) { mRetainedDataBudget = bytes; }
+        size_t getRetainedDataBudget() const { return mRetainedDataBudget; }
+        /// Number of bytes currently kept by resources
+        size_t getRetainedDataSize() const { return mRetainedDataSize; }
+
+        // Reserves memory for data kept by a resource, returns false if it does not fit the budget.
+        bool _reserveRetainedData(size_t bytes);
+        // Releases memory reserved by _reserveRetainedData.
+        void _releaseRetainedData(size_t bytes);
         
         GLES2ManagedResourceManager();
         ~GLES2ManagedResourceManager();
@@ -72,6 +87,8 @@ namespace Ogre {
     // Attributes.
     protected:      
         ResourceContainer           mResources;
+        size_t                      mRetainedDataBudget;
+        size_t                      mRetainedDataSize;
     };
 
 #endif
@@ -0,0 +1,68 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __GLES2PixelReadback_H__
+#define __GLES2PixelReadback_H__
+
+#include "OgreGLES2Prerequisites.h"
+#include "OgrePixelReadback.h"
+
+#if OGRE_NO_GLES3_SUPPORT == 0
+namespace Ogre {
+    /** Asynchronous readback of a render target through a pixel pack buffer.
+    @remarks
+        glReadPixels writes to the buffer on the GPU timeline, a fence issued right
+        after tells when the copy is done, so polling never stalls. Needs OpenGL ES 3.0.
+    */
+    class _OgreGLES2Export GLES2PixelReadback : public PixelReadback
+    {
+    protected:
+        GLuint mBufferId;
+        /// Guards the copy into mBufferId, 0 once it has signalled
+        GLsync mFence;
+        /// Whether the rows were read bottom up
+        bool mFlipped;
+
+    public:
+        /** Reads back the given rectangle of the framebuffer bound for reading.
+        @param x, y Lower left corner of the rectangle, in GL window coordinates
+        @param flipped Whether the rows are to be flipped as the framebuffer is bottom up
+        */
+        GLES2PixelReadback(GLint x, GLint y, uint32 width, uint32 height, PixelFormat format, bool flipped);
+        ~GLES2PixelReadback();
+
+        /// @copydoc PixelReadback::isReady
+        bool isReady(void);
+
+        /// @copydoc PixelReadback::read
+        void read(const PixelBox& dst);
+    };
+}
+#endif
+
+#endif
@@ -122,6 +122,23 @@ namespace Ogre {
             // check if GLES 3.0 is supported
             bool mHasGLES30;
 
+            /// GL_EXT_disjoint_timer_query entry points, null if unsupported
+            PFNGLQUERYCOUNTEREXTPROC mQueryCounter;
+            PFNGLGETQUERYOBJECTUI64VEXTPROC mGetQueryObjectui64v;
+
+            /// The timestamp queries at the beginning and end of a GPU timer
+            struct GpuTimer
+            {
+                GLuint queries[2];
+            };
+            /// Pool of GPU timers, a timer handle being its index + 1
+            vector<GpuTimer>::type mGpuTimers;
+            /// Handles of the pooled GPU timers not in use
+            vector<uint32>::type mFreeGpuTimers;
+
+            /// Deletes the pooled GPU timers
+            void destroyGpuTimers(void);
+
             // local data member of _render that were moved here to improve performance
             // (save allocations)
             vector<GLuint>::type mRenderAttribsBound;
@@ -376,16 +393,43 @@ namespace Ogre {
             /// @copydoc RenderSystem::markProfileEvent
             virtual void markProfileEvent( const String &eventName );
 
+            /// @copydoc RenderSystem::_beginGpuTimer
+            virtual uint32 _beginGpuTimer(void);
+
+            /// @copydoc RenderSystem::_endGpuTimer
+            virtual void _endGpuTimer(uint32 timer);
+
+            /// @copydoc RenderSystem::_getGpuTimerResult
+            virtual GpuTimerStatus _getGpuTimerResult(uint32 timer, uint64& elapsedNanosecs);
+
+            /// @copydoc RenderSystem::_releaseGpuTimer
+            virtual void _releaseGpuTimer(uint32 timer);
+
 #if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || OGRE_PLATFORM == OGRE_PLATFORM_EMSCRIPTEN
             void resetRenderer(RenderWindow* pRenderWnd);
         
             void notifyOnContextLost();
 
+            /** Sets how many bytes of texture images and static buffer contents may be
+                kept in memory, to restore them after a context loss without loading
+                them from their source again. 0, the default, keeps none.
+            @remarks
+                Resources loaded or written while the budget is full are restored
+                as before.
+            */
+            void setRetainedResourceMemory(size_t bytes);
+            /// Gets the number of bytes allowed by setRetainedResourceMemory
+            size_t getRetainedResourceMemory() const;
+
             static GLES2ManagedResourceManager* getResourceManager();
     private:
             static GLES2ManagedResourceManager* mResourceManager;
 #endif
             void _copyContentsToMemory(Viewport* vp, const Box& src, const PixelBox& dst, RenderWindow::FrameBuffer buffer);
+
+            /// @copydoc RenderSystem::_copyContentsToMemoryAsync
+            virtual PixelReadbackPtr _copyContentsToMemoryAsync(RenderTarget* target, const Box& src,
+                PixelFormat format, RenderTarget::FrameBuffer buffer);
     };
 }
 
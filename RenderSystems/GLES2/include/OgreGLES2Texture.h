@@ -92,6 +92,8 @@ namespace Ogre {
 
             /// Create gl texture
             void _createGLTexResource();
+            /// Create the texture from loaded images
+            void uploadImages(const LoadedImages& images);
         
 #if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || OGRE_PLATFORM == OGRE_PLATFORM_EMSCRIPTEN
             /** See AndroidResource. */
@@ -99,6 +101,17 @@ namespace Ogre {
         
             /** See AndroidResource. */
             virtual void notifyOnContextReset();
+
+            /// @copydoc Resource::unloadImpl
+            void unloadImpl(void);
+            /// Frees mRetainedImages
+            void releaseRetainedImages(void);
+
+            /** Images the texture was loaded from, kept within the retained data budget
+             to restore the texture after a context loss without decoding it again.
+             */
+            LoadedImages mRetainedImages;
+            size_t mRetainedSize;
 #endif
 
         private:
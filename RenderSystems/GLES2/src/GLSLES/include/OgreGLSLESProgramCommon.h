@@ -93,6 +93,10 @@ namespace Ogre {
 #define NOT_FOUND_CUSTOM_ATTRIBUTES_INDEX -1
 
         Ogre::String getCombinedName(void);
+        /// Name of the linked program in the microcode cache, validated by the shader sources
+        Ogre::String getNameForMicrocodeCache(void);
+        /// Name of a single separable program in the microcode cache
+        static Ogre::String getNameForMicrocodeCache(GLSLESGpuProgram* program);
         /// Get the the binary data of a program from the microcode cache
         static bool getMicrocodeFromCache(const String& name, GLuint programHandle);
         /// Compiles and links the vertex and fragment programs
@@ -91,7 +91,7 @@ namespace Ogre {
 
             OGRE_CHECK_GL_ERROR(mGLProgramHandle = glCreateProgram());
 
-            if (!getMicrocodeFromCache(getCombinedName(), mGLProgramHandle))
+            if (!getMicrocodeFromCache(getNameForMicrocodeCache(), mGLProgramHandle))
             {
 #if !OGRE_NO_GLES2_GLSL_OPTIMISER
                 // Check CmdParams for each shader type to see if we should optimize
@@ -140,6 +140,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void GLSLESLinkProgram::compileAndLink()
     {
+        GpuProgramManager::CompileTimer timer(GpuProgramManager::CS_LINK, getCombinedName());
+
         // Compile and attach Vertex Program
         try
         {
@@ -198,7 +200,7 @@ namespace Ogre {
 
         if(mLinked)
         {
-            _writeToCache(getCombinedName(), mGLProgramHandle);
+            _writeToCache(getNameForMicrocodeCache(), mGLProgramHandle);
         }
     }
 
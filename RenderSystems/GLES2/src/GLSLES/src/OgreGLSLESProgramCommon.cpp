@@ -28,11 +28,13 @@
 
 #include "OgreGLSLESProgramCommon.h"
 #include "OgreGLSLESGpuProgram.h"
+#include "OgreGLSLESProgram.h"
 #include "OgreGpuProgramManager.h"
 #include "OgreGLUtil.h"
 #include "OgreGLES2RenderSystem.h"
 #include "OgreRoot.h"
 #include "OgreGLES2Support.h"
+#include "OgreStringConverter.h"
 
 namespace Ogre {
     
@@ -103,6 +105,24 @@ namespace Ogre {
         return name;
     }
 
+    //-----------------------------------------------------------------------
+    Ogre::String GLSLESProgramCommon::getNameForMicrocodeCache()
+    {
+        uint32 hash = 0;
+        if (mVertexProgram)
+            hash = mVertexProgram->getGLSLProgram()->_getHash(hash);
+        if (mFragmentProgram)
+            hash = mFragmentProgram->getGLSLProgram()->_getHash(hash);
+        return getCombinedName() + StringConverter::toString(hash);
+    }
+
+    //-----------------------------------------------------------------------
+    Ogre::String GLSLESProgramCommon::getNameForMicrocodeCache(GLSLESGpuProgram* program)
+    {
+        return program->getName() + "_" +
+            StringConverter::toString(program->getGLSLProgram()->_getHash());
+    }
+
     //-----------------------------------------------------------------------
     VertexElementSemantic GLSLESProgramCommon::getAttributeSemanticEnum(String type)
     {
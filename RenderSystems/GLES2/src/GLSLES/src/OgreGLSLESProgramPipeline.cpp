@@ -55,6 +55,8 @@ namespace Ogre
 
     void GLSLESProgramPipeline::compileAndLink()
     {
+        GpuProgramManager::CompileTimer timer(GpuProgramManager::CS_LINK, getCombinedName());
+
 #if OGRE_PLATFORM != OGRE_PLATFORM_NACL
         GLint linkStatus = 0;
         
@@ -69,7 +71,7 @@ namespace Ogre
                 mLinked |= VERTEX_PROGRAM_LINKED;
             }
             else if(getMicrocodeFromCache(
-                    mVertexProgram->getName(),
+                    getNameForMicrocodeCache(mVertexProgram),
                     mVertexProgram->getGLSLProgram()->createGLProgramHandle()))
             {
                 mVertexProgram->setLinked(true);
@@ -116,7 +118,7 @@ namespace Ogre
                 mLinked |= FRAGMENT_PROGRAM_LINKED;
             }
             else if(getMicrocodeFromCache(
-                    mFragmentProgram->getName(),
+                    getNameForMicrocodeCache(mFragmentProgram),
                     mFragmentProgram->getGLSLProgram()->createGLProgramHandle()))
             {
                 mFragmentProgram->setLinked(true);
@@ -159,12 +161,12 @@ namespace Ogre
             if(mVertexProgram && mVertexProgram->isLinked())
             {
                 OGRE_CHECK_GL_ERROR(glUseProgramStagesEXT(mGLProgramPipelineHandle, GL_VERTEX_SHADER_BIT_EXT, mVertexProgram->getGLSLProgram()->getGLProgramHandle()));
-                _writeToCache(mVertexProgram->getName(), mVertexProgram->getGLSLProgram()->getGLProgramHandle());
+                _writeToCache(getNameForMicrocodeCache(mVertexProgram), mVertexProgram->getGLSLProgram()->getGLProgramHandle());
             }
             if(mFragmentProgram && mFragmentProgram->isLinked())
             {
                 OGRE_CHECK_GL_ERROR(glUseProgramStagesEXT(mGLProgramPipelineHandle, GL_FRAGMENT_SHADER_BIT_EXT, mFragmentProgram->getGLSLProgram()->getGLProgramHandle()));
-                _writeToCache(mFragmentProgram->getName(), mFragmentProgram->getGLSLProgram()->getGLProgramHandle());
+                _writeToCache(getNameForMicrocodeCache(mFragmentProgram), mFragmentProgram->getGLSLProgram()->getGLProgramHandle());
             }
 
             // Validate pipeline
@@ -152,7 +152,18 @@ namespace Ogre {
             case VET_SHORT2:
             case VET_SHORT3:
             case VET_SHORT4:
+            case VET_SHORT2_NORM:
+            case VET_SHORT4_NORM:
                 return GL_SHORT;
+            case VET_HALF2:
+            case VET_HALF4:
+#if OGRE_NO_GLES3_SUPPORT == 0
+                return GL_HALF_FLOAT;
+#elif GL_OES_vertex_half_float
+                return GL_HALF_FLOAT_OES;
+#else
+                return 0;
+#endif
             case VET_COLOUR:
             case VET_COLOUR_ABGR:
             case VET_COLOUR_ARGB:
@@ -50,6 +50,9 @@ namespace Ogre {
                 "GLES2HardwareIndexBuffer");
         }
 
+#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || OGRE_PLATFORM == OGRE_PLATFORM_EMSCRIPTEN
+        mRetainedLockData = 0;
+#endif
         createBuffer();
     }
 
@@ -96,8 +99,16 @@ namespace Ogre {
     void GLES2HardwareIndexBuffer::notifyOnContextReset()
     {
         createBuffer();
-        mShadowUpdated = true;
-        _updateFromShadow();
+        if (mRetainedData.getData())
+        {
+            // Restore the copy kept when the buffer was written
+            OGRE_CHECK_GL_ERROR(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, (GLsizeiptr)mSizeInBytes, mRetainedData.getData()));
+        }
+        else
+        {
+            addDirtyRange(0, mSizeInBytes);
+            _updateFromShadow();
+        }
     }
 #endif
     
@@ -107,6 +118,14 @@ namespace Ogre {
 
         GLES2Support* support = getGLES2SupportRef();
 
+#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || OGRE_PLATFORM == OGRE_PLATFORM_EMSCRIPTEN
+        if (mRetainedLockData)
+        {
+            mRetainedData.write(mSizeInBytes, mLockStart, mLockSize, mRetainedLockData);
+            mRetainedLockData = 0;
+        }
+#endif
+
         bool hasMapBufferRange = !OGRE_NO_GLES3_SUPPORT || support->checkExtension("GL_EXT_map_buffer_range");
         if ((mUsage & HBU_WRITE_ONLY) && hasMapBufferRange)
         {
@@ -137,6 +156,9 @@ namespace Ogre {
                         "GLES2HardwareIndexBuffer::lock");
         }
 
+        // Mapping waits for the GPU if it is still using the buffer
+        LockWaitTimer waitTimer(this, length, options);
+
         GLenum access = 0;
         static_cast<GLES2HardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
 
@@ -190,6 +212,10 @@ namespace Ogre {
 
         // return offsetted
         void* retPtr = static_cast<uint8*>(pBuffer) + offset;
+#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || OGRE_PLATFORM == OGRE_PLATFORM_EMSCRIPTEN
+        // Keep a copy of static buffers, they may not be written again
+        mRetainedLockData = (!mUseShadowBuffer && (mUsage & HBU_STATIC) && options != HBL_READ_ONLY) ? retPtr : 0;
+#endif
         mIsLocked = true;
         return retPtr;
     }
@@ -248,6 +274,12 @@ namespace Ogre {
             memcpy(destData, pSource, length);
             mShadowBuffer->unlock();
         }
+#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || OGRE_PLATFORM == OGRE_PLATFORM_EMSCRIPTEN
+        else if (mUsage & HBU_STATIC)
+        {
+            mRetainedData.write(mSizeInBytes, offset, length, pSource);
+        }
+#endif
 
         if (offset == 0 && length == mSizeInBytes)
         {
@@ -281,6 +313,11 @@ namespace Ogre {
             // Unbind the current buffer
             OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 
+#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || OGRE_PLATFORM == OGRE_PLATFORM_EMSCRIPTEN
+            // The copy is made on the GPU, a retained copy would be out of date
+            mRetainedData.release();
+#endif
+
             // Zero out this(destination) buffer
             OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId));
             OGRE_CHECK_GL_ERROR(glBufferData(GL_ELEMENT_ARRAY_BUFFER, length, 0, GLES2HardwareBufferManager::getGLUsage(mUsage)));
@@ -298,19 +335,23 @@ namespace Ogre {
     }
 #endif
 
-    void GLES2HardwareIndexBuffer::_updateFromShadow(void)
+    void GLES2HardwareIndexBuffer::uploadFromShadow(size_t offset, size_t length)
     {
-        if (mUseShadowBuffer && mShadowUpdated && !mSuppressHardwareUpdate)
-        {
-            const void *srcData = mShadowBuffer->lock(mLockStart, mLockSize, HBL_READ_ONLY);
+        const void *srcData = mShadowBuffer->lock(offset, length, HBL_READ_ONLY);
 
-            static_cast<GLES2HardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
+        static_cast<GLES2HardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
 
+        // Update whole buffer if possible, otherwise normal
+        if (offset == 0 && length == mSizeInBytes)
+        {
             OGRE_CHECK_GL_ERROR(glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)mSizeInBytes, srcData,
                                              GLES2HardwareBufferManager::getGLUsage(mUsage)));
-
-            mShadowBuffer->unlock();
-            mShadowUpdated = false;
         }
+        else
+        {
+            OGRE_CHECK_GL_ERROR(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, (GLintptr)offset, (GLsizeiptr)length, srcData));
+        }
+
+        mShadowBuffer->unlock();
     }
 }
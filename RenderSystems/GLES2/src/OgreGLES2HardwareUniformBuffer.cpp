@@ -87,6 +87,9 @@ namespace Ogre {
                         "Invalid attempt to lock a uniform buffer that has already been locked",
                         "GLES2HardwareUniformBuffer::lock");
         }
+
+        // Mapping waits for the GPU if it is still using the buffer
+        LockWaitTimer waitTimer(this, length, options);
         
         GLenum access = 0;
         void* retPtr = 0;
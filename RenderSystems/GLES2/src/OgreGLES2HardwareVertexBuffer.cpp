@@ -42,6 +42,9 @@ namespace Ogre {
                                                        bool useShadowBuffer)
         : HardwareVertexBuffer(mgr, vertexSize, numVertices, usage, false, useShadowBuffer)
     {
+#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || OGRE_PLATFORM == OGRE_PLATFORM_EMSCRIPTEN
+        mRetainedLockData = 0;
+#endif
         createBuffer();
     }
 
@@ -86,8 +89,16 @@ namespace Ogre {
     void GLES2HardwareVertexBuffer::notifyOnContextReset()
     {
         createBuffer();
-        mShadowUpdated = true;
-        _updateFromShadow();
+        if (mRetainedData.getData())
+        {
+            // Restore the copy kept when the buffer was written
+            OGRE_CHECK_GL_ERROR(glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)mSizeInBytes, mRetainedData.getData()));
+        }
+        else
+        {
+            addDirtyRange(0, mSizeInBytes);
+            _updateFromShadow();
+        }
     }
 #endif
     
@@ -102,6 +113,9 @@ namespace Ogre {
                         "GLES2HardwareVertexBuffer::lock");
         }
 
+        // Mapping waits for the GPU if it is still using the buffer
+        LockWaitTimer waitTimer(this, length, options);
+
         GLenum access = 0;
 
         // Use glMapBuffer
@@ -156,6 +170,10 @@ namespace Ogre {
 
         // return offsetted
         void* retPtr = static_cast<uint8*>(pBuffer) + offset;
+#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || OGRE_PLATFORM == OGRE_PLATFORM_EMSCRIPTEN
+        // Keep a copy of static buffers, they may not be written again
+        mRetainedLockData = (!mUseShadowBuffer && (mUsage & HBU_STATIC) && options != HBL_READ_ONLY) ? retPtr : 0;
+#endif
 
         mIsLocked = true;
         return retPtr;
@@ -167,6 +185,14 @@ namespace Ogre {
 
         GLES2Support* support = getGLES2SupportRef();
 
+#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || OGRE_PLATFORM == OGRE_PLATFORM_EMSCRIPTEN
+        if (mRetainedLockData)
+        {
+            mRetainedData.write(mSizeInBytes, mLockStart, mLockSize, mRetainedLockData);
+            mRetainedLockData = 0;
+        }
+#endif
+
         bool hasMapBufferRange = !OGRE_NO_GLES3_SUPPORT || support->checkExtension("GL_EXT_map_buffer_range");
         if ((mUsage & HBU_WRITE_ONLY) && hasMapBufferRange)
         {
@@ -241,6 +267,12 @@ namespace Ogre {
             memcpy(destData, pSource, length);
             mShadowBuffer->unlock();
         }
+#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || OGRE_PLATFORM == OGRE_PLATFORM_EMSCRIPTEN
+        else if (mUsage & HBU_STATIC)
+        {
+            mRetainedData.write(mSizeInBytes, offset, length, pSource);
+        }
+#endif
 
         if (offset == 0 && length == mSizeInBytes)
         {
@@ -273,6 +305,11 @@ namespace Ogre {
             // Unbind the current buffer
             OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ARRAY_BUFFER, 0));
 
+#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || OGRE_PLATFORM == OGRE_PLATFORM_EMSCRIPTEN
+            // The copy is made on the GPU, a retained copy would be out of date
+            mRetainedData.release();
+#endif
+
             // Zero out this(destination) buffer
             OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ARRAY_BUFFER, mBufferId));
             OGRE_CHECK_GL_ERROR(glBufferData(GL_ARRAY_BUFFER, length, 0, GLES2HardwareBufferManager::getGLUsage(mUsage)));
@@ -289,21 +326,23 @@ namespace Ogre {
         }
     }
 #endif
-    void GLES2HardwareVertexBuffer::_updateFromShadow(void)
+    void GLES2HardwareVertexBuffer::uploadFromShadow(size_t offset, size_t length)
     {
-        if (mUseShadowBuffer && mShadowUpdated && !mSuppressHardwareUpdate)
-        {
-            const void *srcData = mShadowBuffer->lock(mLockStart,
-                                                       mLockSize,
-                                                       HBL_READ_ONLY);
+        const void *srcData = mShadowBuffer->lock(offset, length, HBL_READ_ONLY);
 
-            static_cast<GLES2HardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_ARRAY_BUFFER, mBufferId);
+        static_cast<GLES2HardwareBufferManagerBase*>(mMgr)->getStateCacheManager()->bindGLBuffer(GL_ARRAY_BUFFER, mBufferId);
 
+        // Update whole buffer if possible, otherwise normal
+        if (offset == 0 && length == mSizeInBytes)
+        {
             OGRE_CHECK_GL_ERROR(glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)mSizeInBytes, srcData,
                                              GLES2HardwareBufferManager::getGLUsage(mUsage)));
-
-            mShadowBuffer->unlock();
-            mShadowUpdated = false;
         }
+        else
+        {
+            OGRE_CHECK_GL_ERROR(glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)offset, (GLsizeiptr)length, srcData));
+        }
+
+        mShadowBuffer->unlock();
     }
 }
@@ -45,6 +45,30 @@ namespace Ogre
         GLES2RenderSystem::getResourceManager()->_notifyResourceDestroyed(static_cast<GLES2ManagedResource*>(this));
     }
 
+    void GLES2RetainedBufferData::write(size_t bufferSize, size_t offset, size_t length, const void* src)
+    {
+        if (!mData)
+        {
+            if (offset != 0 || length != bufferSize ||
+                !GLES2RenderSystem::getResourceManager()->_reserveRetainedData(bufferSize))
+                return;
+            mData = OGRE_ALLOC_T(uint8, bufferSize, MEMCATEGORY_GEOMETRY);
+            mSize = bufferSize;
+        }
+        memcpy(mData + offset, src, length);
+    }
+
+    void GLES2RetainedBufferData::release()
+    {
+        if (mData)
+        {
+            OGRE_FREE(mData, MEMCATEGORY_GEOMETRY);
+            GLES2RenderSystem::getResourceManager()->_releaseRetainedData(mSize);
+            mData = 0;
+            mSize = 0;
+        }
+    }
+
  #endif
 
 }
@@ -35,6 +35,7 @@ namespace Ogre
 
     //-----------------------------------------------------------------------
     GLES2ManagedResourceManager::GLES2ManagedResourceManager()
+        : mRetainedDataBudget(0), mRetainedDataSize(0)
     {
     }
     //-----------------------------------------------------------------------
@@ -63,6 +64,20 @@ namespace Ogre
         }   
     }
     //-----------------------------------------------------------------------
+    bool GLES2ManagedResourceManager::_reserveRetainedData(size_t bytes)
+    {
+        if (mRetainedDataSize + bytes > mRetainedDataBudget)
+            return false;
+        mRetainedDataSize += bytes;
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void GLES2ManagedResourceManager::_releaseRetainedData(size_t bytes)
+    {
+        assert(bytes <= mRetainedDataSize);
+        mRetainedDataSize -= bytes;
+    }
+    //-----------------------------------------------------------------------
     void GLES2ManagedResourceManager::_notifyResourceCreated(GLES2ManagedResource* pResource)
     {           
         mResources.push_back(pResource);
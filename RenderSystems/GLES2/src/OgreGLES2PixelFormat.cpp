@@ -114,6 +114,37 @@ namespace Ogre {
                 return GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2;
 #endif
 
+#ifdef GL_KHR_texture_compression_astc_ldr
+            case PF_ASTC_RGBA_4X4_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
+            case PF_ASTC_RGBA_5X4_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_5x4_KHR;
+            case PF_ASTC_RGBA_5X5_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_5x5_KHR;
+            case PF_ASTC_RGBA_6X5_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_6x5_KHR;
+            case PF_ASTC_RGBA_6X6_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_6x6_KHR;
+            case PF_ASTC_RGBA_8X5_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_8x5_KHR;
+            case PF_ASTC_RGBA_8X6_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_8x6_KHR;
+            case PF_ASTC_RGBA_8X8_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_8x8_KHR;
+            case PF_ASTC_RGBA_10X5_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_10x5_KHR;
+            case PF_ASTC_RGBA_10X6_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_10x6_KHR;
+            case PF_ASTC_RGBA_10X8_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_10x8_KHR;
+            case PF_ASTC_RGBA_10X10_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_10x10_KHR;
+            case PF_ASTC_RGBA_12X10_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_12x10_KHR;
+            case PF_ASTC_RGBA_12X12_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_12x12_KHR;
+#endif
+
             case PF_R5G6B5:
             case PF_B5G6R5:
             case PF_R8G8B8:
@@ -365,6 +396,37 @@ namespace Ogre {
                 return GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2;
 #endif
 
+#ifdef GL_KHR_texture_compression_astc_ldr
+            case PF_ASTC_RGBA_4X4_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
+            case PF_ASTC_RGBA_5X4_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_5x4_KHR;
+            case PF_ASTC_RGBA_5X5_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_5x5_KHR;
+            case PF_ASTC_RGBA_6X5_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_6x5_KHR;
+            case PF_ASTC_RGBA_6X6_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_6x6_KHR;
+            case PF_ASTC_RGBA_8X5_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_8x5_KHR;
+            case PF_ASTC_RGBA_8X6_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_8x6_KHR;
+            case PF_ASTC_RGBA_8X8_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_8x8_KHR;
+            case PF_ASTC_RGBA_10X5_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_10x5_KHR;
+            case PF_ASTC_RGBA_10X6_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_10x6_KHR;
+            case PF_ASTC_RGBA_10X8_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_10x8_KHR;
+            case PF_ASTC_RGBA_10X10_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_10x10_KHR;
+            case PF_ASTC_RGBA_12X10_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_12x10_KHR;
+            case PF_ASTC_RGBA_12X12_LDR:
+                return GL_COMPRESSED_RGBA_ASTC_12x12_KHR;
+#endif
+
 #if OGRE_NO_GLES3_SUPPORT == 0
             case PF_A1R5G5B5:
                 return GL_RGB5_A1;
@@ -624,6 +686,37 @@ namespace Ogre {
                 return PF_ETC2_RGB8A1;
 #endif
 
+#ifdef GL_KHR_texture_compression_astc_ldr
+            case GL_COMPRESSED_RGBA_ASTC_4x4_KHR:
+                return PF_ASTC_RGBA_4X4_LDR;
+            case GL_COMPRESSED_RGBA_ASTC_5x4_KHR:
+                return PF_ASTC_RGBA_5X4_LDR;
+            case GL_COMPRESSED_RGBA_ASTC_5x5_KHR:
+                return PF_ASTC_RGBA_5X5_LDR;
+            case GL_COMPRESSED_RGBA_ASTC_6x5_KHR:
+                return PF_ASTC_RGBA_6X5_LDR;
+            case GL_COMPRESSED_RGBA_ASTC_6x6_KHR:
+                return PF_ASTC_RGBA_6X6_LDR;
+            case GL_COMPRESSED_RGBA_ASTC_8x5_KHR:
+                return PF_ASTC_RGBA_8X5_LDR;
+            case GL_COMPRESSED_RGBA_ASTC_8x6_KHR:
+                return PF_ASTC_RGBA_8X6_LDR;
+            case GL_COMPRESSED_RGBA_ASTC_8x8_KHR:
+                return PF_ASTC_RGBA_8X8_LDR;
+            case GL_COMPRESSED_RGBA_ASTC_10x5_KHR:
+                return PF_ASTC_RGBA_10X5_LDR;
+            case GL_COMPRESSED_RGBA_ASTC_10x6_KHR:
+                return PF_ASTC_RGBA_10X6_LDR;
+            case GL_COMPRESSED_RGBA_ASTC_10x8_KHR:
+                return PF_ASTC_RGBA_10X8_LDR;
+            case GL_COMPRESSED_RGBA_ASTC_10x10_KHR:
+                return PF_ASTC_RGBA_10X10_LDR;
+            case GL_COMPRESSED_RGBA_ASTC_12x10_KHR:
+                return PF_ASTC_RGBA_12X10_LDR;
+            case GL_COMPRESSED_RGBA_ASTC_12x12_KHR:
+                return PF_ASTC_RGBA_12X12_LDR;
+#endif
+
             case GL_LUMINANCE:
                 return PF_L8;
             case GL_ALPHA:
@@ -0,0 +1,118 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreGLES2PixelReadback.h"
+
+#if OGRE_NO_GLES3_SUPPORT == 0
+#include "OgreGLES2PixelFormat.h"
+#include "OgreException.h"
+
+namespace Ogre {
+    GLES2PixelReadback::GLES2PixelReadback(GLint x, GLint y, uint32 width, uint32 height,
+                                           PixelFormat format, bool flipped)
+        : PixelReadback(width, height, format), mBufferId(0), mFence(0), mFlipped(flipped)
+    {
+        GLenum glFormat = GLES2PixelUtil::getGLOriginFormat(format);
+        GLenum glType = GLES2PixelUtil::getGLOriginDataType(format);
+
+        if ((glFormat == 0) || (glType == 0))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Unsupported format.", "GLES2PixelReadback::GLES2PixelReadback");
+        }
+
+        OGRE_CHECK_GL_ERROR(glGenBuffers(1, &mBufferId));
+        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, mBufferId));
+        OGRE_CHECK_GL_ERROR(glBufferData(GL_PIXEL_PACK_BUFFER, PixelUtil::getMemorySize(width, height, 1, format),
+                                         NULL, GL_STREAM_READ));
+
+        // Must change the packing to ensure no overruns!
+        OGRE_CHECK_GL_ERROR(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+        OGRE_CHECK_GL_ERROR(glReadPixels(x, y, (GLsizei)width, (GLsizei)height, glFormat, glType, 0));
+        OGRE_CHECK_GL_ERROR(glPixelStorei(GL_PACK_ALIGNMENT, 4));
+
+        OGRE_CHECK_GL_ERROR(mFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+        // Later reads to client memory mustn't land in the buffer
+        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+    }
+
+    GLES2PixelReadback::~GLES2PixelReadback()
+    {
+        if (mFence)
+            OGRE_CHECK_GL_ERROR(glDeleteSync(mFence));
+        OGRE_CHECK_GL_ERROR(glDeleteBuffers(1, &mBufferId));
+    }
+
+    bool GLES2PixelReadback::isReady(void)
+    {
+        if (!mFence)
+            return true;
+
+        // Flush, or the fence might never reach the GPU
+        GLenum result;
+        OGRE_CHECK_GL_ERROR(result = glClientWaitSync(mFence, GL_SYNC_FLUSH_COMMANDS_BIT, 0));
+        if (result == GL_TIMEOUT_EXPIRED)
+            return false;
+
+        OGRE_CHECK_GL_ERROR(glDeleteSync(mFence));
+        mFence = 0;
+        return true;
+    }
+
+    void GLES2PixelReadback::read(const PixelBox& dst)
+    {
+        if (dst.getWidth() != mWidth || dst.getHeight() != mHeight || dst.getDepth() != 1)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid box.", "GLES2PixelReadback::read");
+        }
+
+        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, mBufferId));
+
+        // Mapping waits for the copy if it isn't done yet
+        void* pBuffer = 0;
+        OGRE_CHECK_GL_ERROR(pBuffer = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+            PixelUtil::getMemorySize(mWidth, mHeight, 1, mFormat), GL_MAP_READ_BIT));
+
+        if (pBuffer == 0)
+        {
+            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                        "Pixel pack buffer: Out of memory",
+                        "GLES2PixelReadback::read");
+        }
+
+        PixelUtil::bulkPixelConversion(PixelBox(mWidth, mHeight, 1, mFormat, pBuffer), dst);
+
+        OGRE_CHECK_GL_ERROR(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+        if (mFlipped)
+            PixelUtil::bulkPixelVerticalFlip(dst);
+    }
+}
+#endif
@@ -52,6 +52,7 @@ THE SOFTWARE.
 #include "OgreGLES2StateCacheManager.h"
 #include "OgreRenderWindow.h"
 #include "OgreGLES2PixelFormat.h"
+#include "OgreGLES2PixelReadback.h"
 
 #if OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS
 #include "OgreEAGLES2Context.h"
@@ -85,6 +86,8 @@ namespace Ogre {
           mGLSLESProgramFactory(0),
           mHardwareBufferManager(0),
           mRTTManager(0),
+          mQueryCounter(0),
+          mGetQueryObjectui64v(0),
           mCurTexMipCount(0)
     {
         size_t i;
@@ -258,7 +261,9 @@ namespace Ogre {
             mGLSupport->checkExtension("WEBGL_compressed_texture_s3tc") ||
             mGLSupport->checkExtension("WEBGL_compressed_texture_atc") ||
             mGLSupport->checkExtension("WEBGL_compressed_texture_pvrtc") ||
-            mGLSupport->checkExtension("WEBGL_compressed_texture_etc1"))
+            mGLSupport->checkExtension("WEBGL_compressed_texture_etc1") ||
+            mGLSupport->checkExtension("GL_KHR_texture_compression_astc_ldr") ||
+            mGLSupport->checkExtension("WEBGL_compressed_texture_astc"))
 
         {
             rsc->setCapability(RSC_TEXTURE_COMPRESSION);
@@ -283,6 +288,10 @@ namespace Ogre {
             if(mGLSupport->checkExtension("GL_AMD_compressed_ATC_texture") ||
                mGLSupport->checkExtension("WEBGL_compressed_texture_atc"))
                 rsc->setCapability(RSC_TEXTURE_COMPRESSION_ATC);
+
+            if(mGLSupport->checkExtension("GL_KHR_texture_compression_astc_ldr") ||
+               mGLSupport->checkExtension("WEBGL_compressed_texture_astc"))
+                rsc->setCapability(RSC_TEXTURE_COMPRESSION_ASTC);
         }
 
         if (mGLSupport->checkExtension("GL_EXT_texture_filter_anisotropic"))
@@ -525,6 +534,8 @@ namespace Ogre {
 
         mBackgroundContextList.clear();
 
+        destroyGpuTimers();
+
         RenderSystem::shutdown();
 
         mGLSupport->stop();
@@ -1838,6 +1849,17 @@ namespace Ogre {
 
         mHasGLES30 = mGLSupport->hasMinGLVersion(3, 0);
 
+#if OGRE_PLATFORM != OGRE_PLATFORM_APPLE_IOS
+        // Not part of glesw, resolve the timer query entry points ourselves
+        if (mGLSupport->checkExtension("GL_EXT_disjoint_timer_query"))
+        {
+            mQueryCounter = (PFNGLQUERYCOUNTEREXTPROC)get_proc("glQueryCounterEXT");
+            mGetQueryObjectui64v = (PFNGLGETQUERYOBJECTUI64VEXTPROC)get_proc("glGetQueryObjectui64vEXT");
+            if (!mQueryCounter || !mGetQueryObjectui64v)
+                mQueryCounter = 0;
+        }
+#endif
+
         LogManager::getSingleton().logMessage("**************************************");
         LogManager::getSingleton().logMessage("*** OpenGL ES 2.x Renderer Started ***");
         LogManager::getSingleton().logMessage("**************************************");
@@ -2125,9 +2147,85 @@ namespace Ogre {
            glInsertEventMarkerEXT(0, eventName.c_str());
     }
     //---------------------------------------------------------------------
+    uint32 GLES2RenderSystem::_beginGpuTimer(void)
+    {
+        if (!mQueryCounter)
+            return 0;
+
+        uint32 timer;
+        if (mFreeGpuTimers.empty())
+        {
+            GpuTimer newTimer;
+            OGRE_CHECK_GL_ERROR(glGenQueriesEXT(2, newTimer.queries));
+            mGpuTimers.push_back(newTimer);
+            timer = static_cast<uint32>(mGpuTimers.size());
+        }
+        else
+        {
+            timer = mFreeGpuTimers.back();
+            mFreeGpuTimers.pop_back();
+        }
+
+        OGRE_CHECK_GL_ERROR(mQueryCounter(mGpuTimers[timer - 1].queries[0], GL_TIMESTAMP_EXT));
+        return timer;
+    }
+    //---------------------------------------------------------------------
+    void GLES2RenderSystem::_endGpuTimer(uint32 timer)
+    {
+        if (timer <= mGpuTimers.size())
+            OGRE_CHECK_GL_ERROR(mQueryCounter(mGpuTimers[timer - 1].queries[1], GL_TIMESTAMP_EXT));
+    }
+    //---------------------------------------------------------------------
+    RenderSystem::GpuTimerStatus GLES2RenderSystem::_getGpuTimerResult(uint32 timer, uint64& elapsedNanosecs)
+    {
+        // The pool is dropped along with a lost context
+        if (timer > mGpuTimers.size())
+            return GTS_INVALID;
+
+        const GpuTimer& gpuTimer = mGpuTimers[timer - 1];
+
+        // The end timestamp is written last
+        GLuint available = GL_FALSE;
+        OGRE_CHECK_GL_ERROR(glGetQueryObjectuivEXT(gpuTimer.queries[1], GL_QUERY_RESULT_AVAILABLE_EXT, &available));
+        if (!available)
+            return GTS_PENDING;
+
+        mFreeGpuTimers.push_back(timer);
+
+        // Timestamps are meaningless if the GPU changed clocks or got reset meanwhile
+        GLint disjoint = GL_FALSE;
+        OGRE_CHECK_GL_ERROR(glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint));
+        if (disjoint)
+            return GTS_INVALID;
+
+        GLuint64 begin = 0, end = 0;
+        OGRE_CHECK_GL_ERROR(mGetQueryObjectui64v(gpuTimer.queries[0], GL_QUERY_RESULT_EXT, &begin));
+        OGRE_CHECK_GL_ERROR(mGetQueryObjectui64v(gpuTimer.queries[1], GL_QUERY_RESULT_EXT, &end));
+        elapsedNanosecs = end > begin ? end - begin : 0;
+        return GTS_AVAILABLE;
+    }
+    //---------------------------------------------------------------------
+    void GLES2RenderSystem::_releaseGpuTimer(uint32 timer)
+    {
+        if (timer <= mGpuTimers.size())
+            mFreeGpuTimers.push_back(timer);
+    }
+    //---------------------------------------------------------------------
+    void GLES2RenderSystem::destroyGpuTimers(void)
+    {
+        for (size_t i = 0; i < mGpuTimers.size(); ++i)
+            OGRE_CHECK_GL_ERROR(glDeleteQueriesEXT(2, mGpuTimers[i].queries));
+        mGpuTimers.clear();
+        mFreeGpuTimers.clear();
+    }
+    //---------------------------------------------------------------------
 #if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || OGRE_PLATFORM == OGRE_PLATFORM_EMSCRIPTEN
     void GLES2RenderSystem::notifyOnContextLost() {
         GLES2RenderSystem::mResourceManager->notifyOnContextLost();
+
+        // The queries died with the context, timers still pending are reported invalid
+        mGpuTimers.clear();
+        mFreeGpuTimers.clear();
     }
 
     void GLES2RenderSystem::resetRenderer(RenderWindow* win)
@@ -2157,6 +2255,16 @@ namespace Ogre {
         _setRenderTarget(win);
     }
     
+    void GLES2RenderSystem::setRetainedResourceMemory(size_t bytes)
+    {
+        mResourceManager->setRetainedDataBudget(bytes);
+    }
+
+    size_t GLES2RenderSystem::getRetainedResourceMemory() const
+    {
+        return mResourceManager->getRetainedDataBudget();
+    }
+
     GLES2ManagedResourceManager* GLES2RenderSystem::getResourceManager()
     {
         return GLES2RenderSystem::mResourceManager;
@@ -2249,6 +2357,10 @@ namespace Ogre {
                     typeCount = 4;
                     normalised = GL_TRUE;
                     break;
+                case VET_SHORT2_NORM:
+                case VET_SHORT4_NORM:
+                    normalised = GL_TRUE;
+                    break;
                 default:
                     break;
             };
@@ -2308,4 +2420,34 @@ namespace Ogre {
         PixelUtil::bulkPixelVerticalFlip(dst);
     }
 
+    PixelReadbackPtr GLES2RenderSystem::_copyContentsToMemoryAsync(RenderTarget* target, const Box& src,
+                                                                   PixelFormat format, RenderTarget::FrameBuffer buffer)
+    {
+#if OGRE_NO_GLES3_SUPPORT == 0
+        // Pixel pack buffers and fences are part of OpenGL ES 3.0
+        if (!mHasGLES30)
+            return PixelReadbackPtr();
+
+        // Multisampled render textures are only resolved when swapped
+        if (target->requiresTextureFlipping() && target->getFSAA() > 0)
+            return PixelReadbackPtr();
+
+        // Switch context if different from current one and bind the target
+        _setRenderTarget(target);
+        // The active viewport may belong to another target, make sure it gets bound again
+        mActiveViewport = 0;
+
+        // Render textures are rendered upside down, so their rows are already top down.
+        // Only the back buffer of a window can be read back.
+        bool flipped = !target->requiresTextureFlipping();
+        OGRE_CHECK_GL_ERROR(glReadBuffer(flipped ? GL_BACK : GL_COLOR_ATTACHMENT0));
+
+        GLint y = flipped ? (GLint)(target->getHeight() - src.bottom) : (GLint)src.top;
+        return PixelReadbackPtr(OGRE_NEW GLES2PixelReadback((GLint)src.left, y,
+            src.getWidth(), src.getHeight(), format, flipped));
+#else
+        return PixelReadbackPtr();
+#endif
+    }
+
     }
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreGLES2HardwarePixelBuffer.h"
 #include "OgreGLES2Support.h"
 #include "OgreGLES2StateCacheManager.h"
+#include "OgreGLES2ManagedResourceManager.h"
 #include "OgreRoot.h"
 #include "OgreBitwise.h"
 #include "OgreTextureManager.h"
@@ -75,6 +76,9 @@ namespace Ogre {
         : Texture(creator, name, handle, group, isManual, loader),
           mTextureID(0), mGLSupport(support)
     {
+#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || OGRE_PLATFORM == OGRE_PLATFORM_EMSCRIPTEN
+        mRetainedSize = 0;
+#endif
     }
 
     GLES2Texture::~GLES2Texture()
@@ -89,6 +93,9 @@ namespace Ogre {
         {
             freeInternalResources();
         }
+#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || OGRE_PLATFORM == OGRE_PLATFORM_EMSCRIPTEN
+        releaseRetainedImages();
+#endif
     }
 
     GLenum GLES2Texture::getGLES2TextureTarget(void) const
@@ -429,8 +436,7 @@ namespace Ogre {
             }
             else
             {
-                vector<Image>::type images(6);
-                ConstImagePtrList imagePtrs;
+                vector<DataStreamPtr>::type streams;
                 static const String suffixes[6] = {"_rt", "_lf", "_up", "_dn", "_fr", "_bk"};
 
                 for(size_t i = 0; i < 6; i++)
@@ -440,8 +446,11 @@ namespace Ogre {
                         fullName = fullName + "." + ext;
                     // find & load resource data intro stream to allow resource
                     // group changes if required
-                    doImageIO(fullName, mGroup, ext, *loadedImages, this);
+                    streams.push_back(ResourceGroupManager::getSingleton().openResource(
+                        fullName, mGroup, true, this));
                 }
+                // The faces are independent, decode them in parallel
+                Image::loadParallel(*loadedImages, streams, ext);
             }
         }
         else
@@ -472,13 +481,34 @@ namespace Ogre {
         LoadedImages loadedImages = mLoadedImages;
         mLoadedImages.setNull();
 
+        uploadImages(loadedImages);
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || OGRE_PLATFORM == OGRE_PLATFORM_EMSCRIPTEN
+        // Keep the images if they fit, a context loss then only needs to upload them again
+        if (!mIsManual)
+        {
+            releaseRetainedImages();
+            size_t size = 0;
+            for (size_t i = 0; i < loadedImages->size(); ++i)
+                size += (*loadedImages)[i].getSize();
+            if (GLES2RenderSystem::getResourceManager()->_reserveRetainedData(size))
+            {
+                mRetainedImages = loadedImages;
+                mRetainedSize = size;
+            }
+        }
+#endif
+    }
+
+    void GLES2Texture::uploadImages(const LoadedImages& images)
+    {
         // Call internal _loadImages, not loadImage since that's external and 
         // will determine load status etc again
         ConstImagePtrList imagePtrs;
 
-        for (size_t i = 0; i < loadedImages->size(); ++i)
+        for (size_t i = 0; i < images->size(); ++i)
         {
-            imagePtrs.push_back(&(*loadedImages)[i]);
+            imagePtrs.push_back(&(*images)[i]);
         }
 
         _loadImages(imagePtrs);
@@ -514,7 +544,11 @@ namespace Ogre {
     
     void GLES2Texture::notifyOnContextReset()
     {
-        if (!mIsManual) 
+        if (!mRetainedImages.isNull())
+        {
+            uploadImages(mRetainedImages);
+        }
+        else if (!mIsManual) 
         {
             reload();
         }
@@ -537,6 +571,22 @@ namespace Ogre {
             postLoadImpl();
         }
     }
+
+    void GLES2Texture::unloadImpl()
+    {
+        releaseRetainedImages();
+        Texture::unloadImpl();
+    }
+
+    void GLES2Texture::releaseRetainedImages()
+    {
+        if (!mRetainedImages.isNull())
+        {
+            mRetainedImages.setNull();
+            GLES2RenderSystem::getResourceManager()->_releaseRetainedData(mRetainedSize);
+            mRetainedSize = 0;
+        }
+    }
 #endif
 
     void GLES2Texture::_createSurfaceList()
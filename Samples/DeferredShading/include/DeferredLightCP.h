@@ -21,14 +21,17 @@ same license as the rest of the engine.
 #include "DLight.h"
 #include "MaterialGenerator.h"
 #include "AmbientLight.h"
+#include "TiledLights.h"
 
 //The render operation that will be called each frame in the custom composition pass
 //This is the class that will send the actual render calls of the spheres (point lights),
 //cones (spotlights) and quads (directional lights) after the GBuffer has been constructed
+//When tiled, point and spot lights without shadows are all rendered in one fullscreen pass instead
 class DeferredLightRenderOperation : public Ogre::CompositorInstance::RenderSystemOperation
 {
 public:
-    DeferredLightRenderOperation(Ogre::CompositorInstance* instance, const Ogre::CompositionPass* pass);
+    DeferredLightRenderOperation(Ogre::CompositorInstance* instance, const Ogre::CompositionPass* pass,
+        bool tiled = false);
     
     /** @copydoc CompositorInstance::RenderSystemOperation::execute */
     virtual void execute(Ogre::SceneManager *sm, Ogre::RenderSystem *rs);
@@ -54,6 +57,11 @@ private:
     //The ambient light used to render the scene
     AmbientLight* mAmbientLight;
 
+    //The tiled point and spot lights, 0 if not tiled
+    TiledLights* mTiledLights;
+    //The lights to render tiled this frame
+    Ogre::LightList mTiledLightList;
+
     //The viewport that we are rendering to
     Ogre::Viewport* mViewport;
 };
@@ -63,16 +71,20 @@ private:
 class DeferredLightCompositionPass : public Ogre::CustomCompositionPass
 {
 public:
+    DeferredLightCompositionPass(bool tiled = false) : mTiled(tiled) {}
 
     /** @copydoc CustomCompositionPass::createOperation */
     virtual Ogre::CompositorInstance::RenderSystemOperation* createOperation(
         Ogre::CompositorInstance* instance, const Ogre::CompositionPass* pass)
     {
-        return OGRE_NEW DeferredLightRenderOperation(instance, pass);
+        return OGRE_NEW DeferredLightRenderOperation(instance, pass, mTiled);
     }
 
 protected:
     virtual ~DeferredLightCompositionPass() {}
+
+    //Whether to bin point and spot lights into screen tiles
+    bool mTiled;
 };
 
 #endif
@@ -90,6 +90,13 @@ public:
     
     bool getSSAO() const;
 
+    /** Set whether point and spot lights are binned into screen tiles and
+        rendered in a single pass, rather than one light geometry each
+     */
+    void setTiledLighting(bool tiled);
+
+    bool getTiledLighting() const;
+
     /** Activate or deactivate system
      */
     void setActive(bool active);
@@ -103,10 +110,13 @@ protected:
     // Filters
     Ogre::CompositorInstance *mInstance[DSM_COUNT];
     Ogre::CompositorInstance* mSSAOInstance;
+    // Lit mode with tiled lights, replaces mInstance[DSM_SHOWLIT] when enabled
+    Ogre::CompositorInstance* mTiledInstance;
     // Active/inactive
     bool mActive;
     DSMode mCurrentMode;
     bool mSSAO;
+    bool mTiled;
 
     //Used to unregister compositor logics and free memory
     typedef map<String, CompositorLogic*>::type CompositorLogicMap;
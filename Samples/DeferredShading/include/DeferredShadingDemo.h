@@ -100,6 +100,7 @@ protected:
         mTrayMgr->createCheckBox(TL_TOPLEFT, "SSAO", "Ambient Occlusion", 220)->setChecked(false, false);
         mTrayMgr->createCheckBox(TL_TOPLEFT, "GlobalLight", "Global Light", 220)->setChecked(true, false);
         mTrayMgr->createCheckBox(TL_TOPLEFT, "Shadows", "Shadows", 220)->setChecked(true, false);
+        mTrayMgr->createCheckBox(TL_TOPLEFT, "TiledLighting", "Tiled Lighting", 220)->setChecked(false, false);
         
         // create a menu to choose the model displayed
         mDisplayModeMenu = mTrayMgr->createThickSelectMenu(TL_TOPLEFT, "DisplayMode", "Display Mode", 220, 4);
@@ -133,6 +134,10 @@ protected:
                                           SHADOWTYPE_TEXTURE_ADDITIVE :
                                           SHADOWTYPE_NONE);
         }
+        else if (box->getName() == "TiledLighting")
+        {
+            SharedData::getSingleton().iSystem->setTiledLighting(box->isChecked());
+        }
         else if (box->getName() == "DeferredShading")
         {
             SharedData::getSingleton().iSystem->setActive(box->isChecked());
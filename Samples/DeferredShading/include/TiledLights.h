@@ -0,0 +1,103 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+Also see acknowledgements in Readme.html
+
+You may use this sample code for anything you like, it is not covered by the
+same license as the rest of the engine.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _TILEDLIGHTS_H
+#define _TILEDLIGHTS_H
+
+#include "OgreSimpleRenderable.h"
+#include "OgreTexture.h"
+
+// Renderable for rendering many point and spot lights in a single fullscreen pass
+
+// The lights are binned on the CPU into screen tiles of TILE_SIZE pixels, by the
+// screen rectangle of their bounding sphere. The results are uploaded to three
+// float textures, which the fragment program reads:
+// - the light texture holds the view space parameters of each light, one column
+//   per light and one row per parameter
+// - the tile texture holds the first index and the number of lights of each tile
+// - the index texture holds the light indexes of all the tiles one after the other
+
+// These textures can be bound to other materials too, for example to light
+// forward rendered objects with the same light lists.
+
+class TiledLights : public Ogre::SimpleRenderable
+{
+public:
+    // Size of a tile in pixels
+    static const size_t TILE_SIZE = 16;
+    // Maximum number of lights binned per frame
+    static const size_t MAX_LIGHTS = 1024;
+    // Width of the index texture
+    static const size_t INDEX_TEXTURE_WIDTH = 1024;
+    // Number of parameter rows of the light texture
+    static const size_t LIGHT_TEXTURE_ROWS = 6;
+
+    TiledLights();
+    ~TiledLights();
+
+    /** @copydoc MovableObject::getBoundingRadius */
+    virtual Ogre::Real getBoundingRadius(void) const;
+    /** @copydoc Renderable::getSquaredViewDepth */
+    virtual Ogre::Real getSquaredViewDepth(const Ogre::Camera*) const;
+    /** @copydoc Renderable::getMaterial */
+    virtual const Ogre::MaterialPtr& getMaterial(void) const;
+
+    virtual void getWorldTransforms(Ogre::Matrix4* xform) const;
+
+    // Whether the render system supports the tiled lighting material
+    bool isSupported(void) const;
+
+    // Whether a light can be rendered tiled rather than with its own geometry
+    static bool isTileable(Ogre::Light* light);
+
+    // Bin the lights into the tiles of the viewport and upload the light lists
+    void update(Ogre::Camera* camera, Ogre::Viewport* viewport, const Ogre::LightList& lights);
+
+    const Ogre::TexturePtr& getLightTexture(void) const { return mLightTexture; }
+    const Ogre::TexturePtr& getTileTexture(void) const { return mTileTexture; }
+    const Ogre::TexturePtr& getIndexTexture(void) const { return mIndexTexture; }
+
+    // Number of lights binned by the last update
+    size_t getNumLights(void) const { return mNumLights; }
+
+protected:
+    // Screen tiles covered by a light
+    struct TileRect
+    {
+        size_t left, top, right, bottom;
+    };
+
+    // Create a float texture if it does not exist or is too small
+    void ensureTexture(Ogre::TexturePtr& texture, const Ogre::String& name,
+        size_t width, size_t height, Ogre::PixelFormat format, unsigned short unit);
+    // Find the tiles covered by the bounding sphere of a light, returns false if none
+    bool findTiles(const Ogre::Matrix4& proj, const Ogre::Vector3& centre, Ogre::Real radius,
+        Ogre::Real nearDist, size_t width, size_t height, TileRect& rect) const;
+
+    Ogre::Real mRadius;
+    Ogre::MaterialPtr mMatPtr;
+
+    Ogre::TexturePtr mLightTexture;
+    Ogre::TexturePtr mTileTexture;
+    Ogre::TexturePtr mIndexTexture;
+
+    std::vector<float> mLightData;
+    std::vector<float> mTileData;
+    std::vector<float> mIndexData;
+    std::vector<TileRect> mLightTiles;
+    std::vector<size_t> mTileCounts;
+    size_t mNumLights;
+};
+
+#endif
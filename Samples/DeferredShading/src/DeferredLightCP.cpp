@@ -21,7 +21,8 @@ using namespace Ogre;
 
 //-----------------------------------------------------------------------
 DeferredLightRenderOperation::DeferredLightRenderOperation(
-    CompositorInstance* instance, const CompositionPass* pass)
+    CompositorInstance* instance, const CompositionPass* pass, bool tiled)
+    : mTiledLights(0)
 {
     mViewport = instance->getChain()->getViewport();
     
@@ -38,6 +39,19 @@ DeferredLightRenderOperation::DeferredLightRenderOperation(
     mAmbientLight = new AmbientLight();
     const MaterialPtr& mat = mAmbientLight->getMaterial();
     mat->load();
+
+    // Create the tiled lights, if the render system can render them
+    if (tiled)
+    {
+        mTiledLights = new TiledLights();
+        if (!mTiledLights->isSupported())
+        {
+            LogManager::getSingleton().logMessage(
+                "Tiled deferred lighting is not supported, rendering each light separately");
+            delete mTiledLights;
+            mTiledLights = 0;
+        }
+    }
 }
 //-----------------------------------------------------------------------
 DLight* DeferredLightRenderOperation::createDLight(Ogre::Light* light)
@@ -73,9 +87,15 @@ void DeferredLightRenderOperation::execute(SceneManager *sm, RenderSystem *rs)
     injectTechnique(sm, tech, mAmbientLight, 0);
 
     const LightList& lightList = sm->_getLightsAffectingFrustum();
+    mTiledLightList.clear();
     for (LightList::const_iterator it = lightList.begin(); it != lightList.end(); it++) 
     {
         Light* light = *it;
+        if (mTiledLights && TiledLights::isTileable(light))
+        {
+            mTiledLightList.push_back(light);
+            continue;
+        }
         Ogre::LightList ll;
         ll.push_back(light);
 
@@ -118,6 +138,13 @@ void DeferredLightRenderOperation::execute(SceneManager *sm, RenderSystem *rs)
         
         injectTechnique(sm, tech, dLight, &ll);
     }
+
+    //Render all the other lights in one pass
+    if (mTiledLights && !mTiledLightList.empty())
+    {
+        mTiledLights->update(cam, mViewport, mTiledLightList);
+        injectTechnique(sm, mTiledLights->getMaterial()->getBestTechnique(), mTiledLights, 0);
+    }
 }
 //-----------------------------------------------------------------------
 DeferredLightRenderOperation::~DeferredLightRenderOperation()
@@ -129,6 +156,7 @@ DeferredLightRenderOperation::~DeferredLightRenderOperation()
     mLights.clear();
     
     delete mAmbientLight;
+    delete mTiledLights;
     delete mLightMaterialGenerator;
 }
 //-----------------------------------------------------------------------
@@ -73,6 +73,7 @@ void DeferredShadingSystem::initialize()
     mActive = false;
     
     mSSAO = false;
+    mTiled = false;
     mCurrentMode = DSM_SHOWLIT;
     setActive(true);
 }
@@ -82,6 +83,7 @@ DeferredShadingSystem::~DeferredShadingSystem()
     CompositorChain *chain = CompositorManager::getSingleton().getCompositorChain(mViewport);
     for(int i=0; i<DSM_COUNT; ++i)
         chain->_removeInstance(mInstance[i]);
+    chain->_removeInstance(mTiledInstance);
     CompositorManager::getSingleton().removeCompositorChain(mViewport);
 
     Ogre::CompositorManager& compMgr = Ogre::CompositorManager::getSingleton();
@@ -101,20 +103,22 @@ void DeferredShadingSystem::setMode(DSMode mode)
     assert( 0 <= mode && mode < DSM_COUNT);
 
     // prevent duplicate setups
-    if (mCurrentMode == mode && mInstance[mode]->getEnabled()==mActive)
+    CompositorInstance* modeInstance = (mode == DSM_SHOWLIT && mTiled) ? mTiledInstance : mInstance[mode];
+    if (mCurrentMode == mode && modeInstance->getEnabled()==mActive)
         return;
 
     for(int i=0; i<DSM_COUNT; ++i)
     {
         if(i == mode)
         {
-            mInstance[i]->setEnabled(mActive);
+            mInstance[i]->setEnabled(mActive && !(i == DSM_SHOWLIT && mTiled));
         }
         else
         {
             mInstance[i]->setEnabled(false);
         }
     }
+    mTiledInstance->setEnabled(mActive && mTiled && mode == DSM_SHOWLIT);
 
     mCurrentMode = mode;
 
@@ -137,6 +141,24 @@ bool DeferredShadingSystem::getSSAO() const
 {
     return mSSAO;
 }
+
+void DeferredShadingSystem::setTiledLighting(bool tiled)
+{
+    if (tiled != mTiled)
+    {
+        mTiled = tiled;
+        if (mActive && mCurrentMode == DSM_SHOWLIT)
+        {
+            mInstance[DSM_SHOWLIT]->setEnabled(!tiled);
+            mTiledInstance->setEnabled(tiled);
+        }
+    }
+}
+
+bool DeferredShadingSystem::getTiledLighting() const
+{
+    return mTiled;
+}
 void DeferredShadingSystem::setActive(bool active)
 {
     if (mActive != active)
@@ -167,6 +189,7 @@ void DeferredShadingSystem::createResources(void)
         MaterialManager::getSingleton().addListener(new NullSchemeHandler, "NoGBuffer");
 
         compMan.registerCustomCompositionPass("DeferredLight", new DeferredLightCompositionPass);
+        compMan.registerCustomCompositionPass("TiledDeferredLight", new DeferredLightCompositionPass(true));
 
         firstTime = false;
     }
@@ -182,6 +205,7 @@ void DeferredShadingSystem::createResources(void)
     mInstance[DSM_SHOWNORMALS] = compMan.addCompositor(mViewport, "DeferredShading/ShowNormals");
     mInstance[DSM_SHOWDSP] = compMan.addCompositor(mViewport, "DeferredShading/ShowDepthSpecular");
     mInstance[DSM_SHOWCOLOUR] = compMan.addCompositor(mViewport, "DeferredShading/ShowColour");
+    mTiledInstance = compMan.addCompositor(mViewport, "DeferredShading/ShowLitTiled");
 
     mSSAOInstance =  compMan.addCompositor(mViewport, "DeferredShading/SSAO");
 }
@@ -195,7 +219,7 @@ void DeferredShadingSystem::logCurrentMode(void)
         return;
     }
 
-    CompositorInstance* ci = mInstance[mCurrentMode];
+    CompositorInstance* ci = (mCurrentMode == DSM_SHOWLIT && mTiled) ? mTiledInstance : mInstance[mCurrentMode];
     assert(ci->getEnabled()==true);
 
     LogManager::getSingleton().logMessage("Current Mode: ");
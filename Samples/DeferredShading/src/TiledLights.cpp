@@ -0,0 +1,285 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+Also see acknowledgements in Readme.html
+
+You may use this sample code for anything you like, it is not covered by the
+same license as the rest of the engine.
+-----------------------------------------------------------------------------
+*/
+
+#include "TiledLights.h"
+#include "GeomUtils.h"
+#include "OgreMaterialManager.h"
+#include "OgreTextureManager.h"
+#include "OgreHardwarePixelBuffer.h"
+#include "OgreCamera.h"
+#include "OgreViewport.h"
+#include "OgreLight.h"
+#include "OgreSceneManager.h"
+#include "OgreTechnique.h"
+
+using namespace Ogre;
+
+const size_t TiledLights::TILE_SIZE;
+const size_t TiledLights::MAX_LIGHTS;
+const size_t TiledLights::INDEX_TEXTURE_WIDTH;
+const size_t TiledLights::LIGHT_TEXTURE_ROWS;
+
+TiledLights::TiledLights() : mNumLights(0)
+{
+    setRenderQueueGroup(RENDER_QUEUE_2);
+
+    mRenderOp.vertexData = new VertexData();
+    mRenderOp.indexData = 0;
+
+    GeomUtils::createQuad(mRenderOp.vertexData);
+
+    mRenderOp.operationType = RenderOperation::OT_TRIANGLE_STRIP;
+    mRenderOp.useIndexes = false;
+
+    // Set bounding
+    setBoundingBox(AxisAlignedBox(-10000,-10000,-10000,10000,10000,10000));
+    mRadius = 15000;
+
+    mMatPtr = MaterialManager::getSingleton().getByName("DeferredShading/TiledLights");
+    assert(mMatPtr.isNull()==false);
+    mMatPtr->load();
+
+    mLightData.resize(MAX_LIGHTS * LIGHT_TEXTURE_ROWS * 4, 0.0f);
+    if (isSupported())
+    {
+        ensureTexture(mLightTexture, "DeferredShading/TiledLights/Lights",
+            MAX_LIGHTS, LIGHT_TEXTURE_ROWS, PF_FLOAT32_RGBA, 2);
+    }
+}
+
+TiledLights::~TiledLights()
+{
+    // need to release IndexData and vertexData created for renderable
+    delete mRenderOp.indexData;
+    delete mRenderOp.vertexData;
+
+    TextureManager& texMgr = TextureManager::getSingleton();
+    if (!mLightTexture.isNull())
+        texMgr.remove(mLightTexture->getHandle());
+    if (!mTileTexture.isNull())
+        texMgr.remove(mTileTexture->getHandle());
+    if (!mIndexTexture.isNull())
+        texMgr.remove(mIndexTexture->getHandle());
+}
+
+/** @copydoc MovableObject::getBoundingRadius */
+Real TiledLights::getBoundingRadius(void) const
+{
+    return mRadius;
+}
+/** @copydoc Renderable::getSquaredViewDepth */
+Real TiledLights::getSquaredViewDepth(const Camera*) const
+{
+    return 0.0;
+}
+
+const MaterialPtr& TiledLights::getMaterial(void) const
+{
+    return mMatPtr;
+}
+
+void TiledLights::getWorldTransforms(Ogre::Matrix4* xform) const
+{
+    *xform = Matrix4::IDENTITY;
+}
+
+bool TiledLights::isSupported(void) const
+{
+    return mMatPtr->getNumSupportedTechniques() > 0;
+}
+
+bool TiledLights::isTileable(Light* light)
+{
+    // Directional lights cover every tile, and shadow casting spotlights need
+    // their own shadow texture, so both keep rendering their own geometry
+    switch (light->getType())
+    {
+    case Light::LT_POINT:
+        return true;
+    case Light::LT_SPOTLIGHT:
+        return !(light->_getManager()->isShadowTechniqueInUse() && light->getCastShadows());
+    default:
+        return false;
+    }
+}
+
+void TiledLights::ensureTexture(TexturePtr& texture, const String& name,
+    size_t width, size_t height, PixelFormat format, unsigned short unit)
+{
+    if (!texture.isNull() && texture->getWidth() >= width && texture->getHeight() >= height)
+        return;
+
+    TextureManager& texMgr = TextureManager::getSingleton();
+    if (!texture.isNull())
+        texMgr.remove(texture->getHandle());
+
+    texture = texMgr.createManual(name, ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME,
+        TEX_TYPE_2D, (uint)width, (uint)height, 0, format, TU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+
+    Technique* tech = mMatPtr->getBestTechnique();
+    for (unsigned short i = 0; i < tech->getNumPasses(); ++i)
+    {
+        Pass* pass = tech->getPass(i);
+        if (unit < pass->getNumTextureUnitStates())
+            pass->getTextureUnitState(unit)->setTexture(texture);
+    }
+}
+
+bool TiledLights::findTiles(const Matrix4& proj, const Vector3& centre, Real radius,
+    Real nearDist, size_t width, size_t height, TileRect& rect) const
+{
+    // Screen rectangle in normalised device coordinates, the whole screen if
+    // the sphere crosses the near plane or the projection is orthographic
+    Real minX = -1, maxX = 1, minY = -1, maxY = 1;
+
+    // View space looks down -Z
+    Real dist = -centre.z;
+    if (dist + radius < nearDist)
+        return false;
+
+    if (proj[3][3] == 0 && dist - radius > nearDist)
+    {
+        // Project the corners of the box around the sphere, the nearest and the
+        // furthest depth give the extremes on each side
+        Real zn = dist - radius, zf = dist + radius;
+        Real x0 = centre.x - radius, x1 = centre.x + radius;
+        Real y0 = centre.y - radius, y1 = centre.y + radius;
+        minX = proj[0][0] * std::min(x0 / zn, x0 / zf) - proj[0][2];
+        maxX = proj[0][0] * std::max(x1 / zn, x1 / zf) - proj[0][2];
+        minY = proj[1][1] * std::min(y0 / zn, y0 / zf) - proj[1][2];
+        maxY = proj[1][1] * std::max(y1 / zn, y1 / zf) - proj[1][2];
+        if (minX > 1 || maxX < -1 || minY > 1 || maxY < -1)
+            return false;
+    }
+
+    // Tiles are counted from the top left, as the texture coordinates of the quad
+    size_t tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    size_t tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+    Real left = (Math::Clamp(minX, (Real)-1, (Real)1) * 0.5f + 0.5f) * width / TILE_SIZE;
+    Real right = (Math::Clamp(maxX, (Real)-1, (Real)1) * 0.5f + 0.5f) * width / TILE_SIZE;
+    Real top = (0.5f - Math::Clamp(maxY, (Real)-1, (Real)1) * 0.5f) * height / TILE_SIZE;
+    Real bottom = (0.5f - Math::Clamp(minY, (Real)-1, (Real)1) * 0.5f) * height / TILE_SIZE;
+    rect.left = std::min((size_t)left, tilesX - 1);
+    rect.right = std::min((size_t)right, tilesX - 1);
+    rect.top = std::min((size_t)top, tilesY - 1);
+    rect.bottom = std::min((size_t)bottom, tilesY - 1);
+    return true;
+}
+
+void TiledLights::update(Camera* camera, Viewport* viewport, const LightList& lights)
+{
+    if (!isSupported())
+        return;
+
+    size_t width = std::max(viewport->getActualWidth(), 1);
+    size_t height = std::max(viewport->getActualHeight(), 1);
+    size_t tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    size_t tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+    size_t numTiles = tilesX * tilesY;
+
+    const Matrix4& view = camera->getViewMatrix(true);
+    const Matrix4& proj = camera->getProjectionMatrix();
+    Matrix3 viewRot;
+    view.extract3x3Matrix(viewRot);
+    Real nearDist = camera->getNearClipDistance();
+
+    // Find the tiles of each light and write its view space parameters
+    mTileCounts.assign(numTiles, 0);
+    mLightTiles.clear();
+    mNumLights = 0;
+    for (LightList::const_iterator it = lights.begin(); it != lights.end() && mNumLights < MAX_LIGHTS; ++it)
+    {
+        Light* light = *it;
+        if (!isTileable(light))
+            continue;
+
+        Vector3 pos = view * light->getDerivedPosition();
+        Real range = light->getAttenuationRange();
+        TileRect rect;
+        if (!findTiles(proj, pos, range, nearDist, width, height, rect))
+            continue;
+
+        Vector3 dir = viewRot * light->getDerivedDirection();
+        ColourValue diffuse = light->getDiffuseColour() * light->getPowerScale();
+        ColourValue specular = light->getSpecularColour() * light->getPowerScale();
+        float rows[LIGHT_TEXTURE_ROWS][4] = {
+            { pos.x, pos.y, pos.z, light->getType() == Light::LT_SPOTLIGHT ? 2.0f : 1.0f },
+            { diffuse.r, diffuse.g, diffuse.b, range },
+            { specular.r, specular.g, specular.b, 0 },
+            { light->getAttenuationConstant(), light->getAttenuationLinear(), light->getAttenuationQuadric(), 0 },
+            { dir.x, dir.y, dir.z, 0 },
+            { Math::Cos(light->getSpotlightInnerAngle() * 0.5f), Math::Cos(light->getSpotlightOuterAngle() * 0.5f),
+              light->getSpotlightFalloff(), 0 }
+        };
+        for (size_t r = 0; r < LIGHT_TEXTURE_ROWS; ++r)
+            memcpy(&mLightData[(r * MAX_LIGHTS + mNumLights) * 4], rows[r], sizeof(rows[r]));
+
+        for (size_t y = rect.top; y <= rect.bottom; ++y)
+            for (size_t x = rect.left; x <= rect.right; ++x)
+                ++mTileCounts[y * tilesX + x];
+
+        mLightTiles.push_back(rect);
+        ++mNumLights;
+    }
+
+    // Each tile's lights follow the lights of the tiles before it
+    mTileData.resize(numTiles * 2);
+    size_t numIndexes = 0;
+    for (size_t t = 0; t < numTiles; ++t)
+    {
+        mTileData[t * 2] = (float)numIndexes;
+        mTileData[t * 2 + 1] = (float)mTileCounts[t];
+        // From now on the count is where the next index of the tile goes
+        size_t count = mTileCounts[t];
+        mTileCounts[t] = numIndexes;
+        numIndexes += count;
+    }
+
+    size_t indexRows = std::max((numIndexes + INDEX_TEXTURE_WIDTH - 1) / INDEX_TEXTURE_WIDTH, (size_t)1);
+    mIndexData.resize(indexRows * INDEX_TEXTURE_WIDTH);
+    for (size_t i = 0; i < mNumLights; ++i)
+    {
+        const TileRect& rect = mLightTiles[i];
+        for (size_t y = rect.top; y <= rect.bottom; ++y)
+            for (size_t x = rect.left; x <= rect.right; ++x)
+                mIndexData[mTileCounts[y * tilesX + x]++] = (float)i;
+    }
+
+    // Upload the light lists
+    ensureTexture(mTileTexture, "DeferredShading/TiledLights/Tiles", tilesX, tilesY, PF_FLOAT32_GR, 3);
+    // Grow the index texture by half again, to avoid recreating it every frame
+    if (mIndexTexture.isNull() || mIndexTexture->getHeight() < indexRows)
+        ensureTexture(mIndexTexture, "DeferredShading/TiledLights/Indexes",
+            INDEX_TEXTURE_WIDTH, indexRows + indexRows / 2, PF_FLOAT32_R, 4);
+
+    mLightTexture->getBuffer()->blitFromMemory(
+        PixelBox(MAX_LIGHTS, LIGHT_TEXTURE_ROWS, 1, PF_FLOAT32_RGBA, &mLightData[0]),
+        Image::Box(0, 0, MAX_LIGHTS, LIGHT_TEXTURE_ROWS));
+    mTileTexture->getBuffer()->blitFromMemory(
+        PixelBox(tilesX, tilesY, 1, PF_FLOAT32_GR, &mTileData[0]),
+        Image::Box(0, 0, tilesX, tilesY));
+    mIndexTexture->getBuffer()->blitFromMemory(
+        PixelBox(INDEX_TEXTURE_WIDTH, indexRows, 1, PF_FLOAT32_R, &mIndexData[0]),
+        Image::Box(0, 0, INDEX_TEXTURE_WIDTH, indexRows));
+
+    // Set the camera's far-top-right corner, for the view space rays
+    Technique* tech = getMaterial()->getBestTechnique();
+    Vector3 farCorner = view * camera->getWorldSpaceCorners()[4];
+    for (unsigned short i = 0; i < tech->getNumPasses(); ++i)
+    {
+        GpuProgramParametersSharedPtr params = tech->getPass(i)->getVertexProgramParameters();
+        if (params->_findNamedConstantDefinition("farCorner"))
+            params->setNamedConstant("farCorner", farCorner);
+    }
+}
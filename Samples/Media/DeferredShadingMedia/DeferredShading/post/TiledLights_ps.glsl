@@ -0,0 +1,104 @@
+/******************************************************************************
+Copyright (c) W.J. van der Laan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software  and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to use, 
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so, subject 
+to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies 
+or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A 
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION 
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,OUT OF OR IN CONNECTION WITH THE 
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+/** Deferred shading framework
+	// W.J. :wumpus: van der Laan 2005 //
+	
+	Post shader: Tiled point and spot lights, all in one fullscreen pass
+*/
+
+#version 150
+
+in vec2 oUv0;
+in vec3 oRay;
+
+out vec4 oColour;
+
+uniform sampler2D Tex0;
+uniform sampler2D Tex1;
+// One column per light: position and type, diffuse colour and range, specular
+// colour, attenuation, direction and spotlight parameters
+uniform sampler2D LightTex;
+// First index and number of lights of each tile
+uniform sampler2D TileTex;
+// Light indexes of all the tiles
+uniform sampler2D IndexTex;
+uniform vec4 viewportSize;
+// Tile size and index texture width
+uniform vec4 tileParams;
+uniform float farClipDistance;
+
+void main()
+{
+	vec4 a0 = texture(Tex0, oUv0); // Attribute 0: Diffuse color+shininess
+	vec4 a1 = texture(Tex1, oUv0); // Attribute 1: Normal+depth
+
+	// Nothing was rendered to the GBuffer here
+	if((a1.w - 0.0001) < 0.0)
+		discard;
+
+	vec3 normal = a1.xyz;
+	vec3 viewPos = normalize(oRay) * farClipDistance * a1.w;
+	vec3 viewDir = -normalize(viewPos);
+
+	ivec2 tile = ivec2(oUv0 * viewportSize.xy / tileParams.x);
+	vec2 tileLights = texelFetch(TileTex, tile, 0).xy;
+	int first = int(tileLights.x);
+	int count = int(tileLights.y);
+	int indexWidth = int(tileParams.y);
+
+	vec3 total_light_contrib = vec3(0.0);
+	for(int i = 0; i < count; ++i)
+	{
+		int n = first + i;
+		int light = int(texelFetch(IndexTex, ivec2(n % indexWidth, n / indexWidth), 0).r);
+		vec4 lightPos = texelFetch(LightTex, ivec2(light, 0), 0);
+		vec4 lightDiffuse = texelFetch(LightTex, ivec2(light, 1), 0);
+
+		vec3 objToLightVec = lightPos.xyz - viewPos;
+		float len_sq = dot(objToLightVec, objToLightVec);
+		float len = sqrt(len_sq);
+		if(len > lightDiffuse.w)
+			continue;
+		vec3 objToLightDir = objToLightVec / len;
+
+		vec3 lightSpecular = texelFetch(LightTex, ivec2(light, 2), 0).rgb;
+		vec3 lightAtten = texelFetch(LightTex, ivec2(light, 3), 0).xyz;
+
+		vec3 contrib = max(0.0, dot(objToLightDir, normal)) * lightDiffuse.rgb;
+		vec3 h = normalize(viewDir + objToLightDir);
+		contrib += a0.a * pow(max(dot(normal, h), 0.0), 32.0) * lightSpecular;
+		contrib /= dot(lightAtten, vec3(1.0, len, len_sq));
+
+		// Spotlight
+		if(lightPos.w > 1.5)
+		{
+			vec3 lightDir = texelFetch(LightTex, ivec2(light, 4), 0).xyz;
+			vec3 spotParams = texelFetch(LightTex, ivec2(light, 5), 0).xyz;
+			float spotlightAngle = clamp(dot(lightDir, -objToLightDir), 0.0, 1.0);
+			float spotFalloff = clamp((spotlightAngle - spotParams.x) / (spotParams.y - spotParams.x), 0.0, 1.0);
+			contrib *= (1.0 - spotFalloff);
+		}
+
+		total_light_contrib += contrib;
+	}
+
+	oColour = vec4(total_light_contrib * a0.rgb, 0.0);
+}
@@ -0,0 +1,56 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+//-----------------------------------------------------------------------------
+// Program Name: SGXLib_AutoInstancing
+// Program Desc: Applies the world matrix of automatically instanced entities.
+// Program Type: Vertex shader
+// Language: GLSL
+// Notes: Implements the functions of the AutoInstancing sub render state.
+// Each instance holds the first three rows of its world matrix, the world
+// matrix set by the SceneManager is the identity, so the following stages
+// see world space positions and normals as object space ones.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void SGX_AutoInstancing(in vec4 position,
+                        in vec3 normal,
+                        in vec4 worldRow0,
+                        in vec4 worldRow1,
+                        in vec4 worldRow2,
+                        out vec4 oPosition,
+                        out vec3 oNormal)
+{
+    oPosition = vec4(dot(worldRow0, position),
+                     dot(worldRow1, position),
+                     dot(worldRow2, position),
+                     1.0);
+    // Assumes uniform scale, as the fixed function transform does
+    oNormal = normalize(vec3(dot(worldRow0.xyz, normal),
+                             dot(worldRow1.xyz, normal),
+                             dot(worldRow2.xyz, normal)));
+}
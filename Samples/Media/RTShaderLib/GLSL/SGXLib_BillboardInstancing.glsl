@@ -0,0 +1,86 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+//-----------------------------------------------------------------------------
+// Program Name: SGXLib_BillboardInstancing
+// Program Desc: Expands instanced billboards to quads.
+// Program Type: Vertex shader
+// Language: GLSL
+// Notes: Implements the functions of the BillboardInstancing sub render state.
+// Each instance holds the position and rotation, dimensions, texture
+// rectangle and direction of a BillboardSet billboard, the quad vertices
+// hold their corner. The axes and origin offsets are set by the BillboardSet.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void SGX_BillboardInstancing(in vec4 corner,
+                             in vec4 positionRotation,
+                             in vec2 dimensions,
+                             in vec4 texcoordRect,
+                             in vec3 direction,
+                             in vec4 axisX,
+                             in vec4 axisY,
+                             in vec4 offsets,
+                             out vec4 oPosition,
+                             out vec2 oTexcoord)
+{
+    vec3 x = axisX.xyz;
+    vec3 y = axisY.xyz;
+    if (axisX.w > 1.5)
+    {
+        // Perpendicular to own direction, axisX is the common up vector
+        x = normalize(cross(axisX.xyz, direction));
+        y = cross(direction, x);
+    }
+    else if (axisX.w > 0.5)
+    {
+        // Oriented to own direction, axisX is the camera direction
+        x = normalize(cross(axisX.xyz, direction));
+        y = direction;
+    }
+
+    vec2 offset = vec2(mix(offsets.x, offsets.y, corner.x) * dimensions.x,
+                         mix(offsets.z, offsets.w, corner.y) * dimensions.y);
+    vec2 texcoord = mix(texcoordRect.xy, texcoordRect.zw, corner.xy);
+    float c = cos(positionRotation.w);
+    float s = sin(positionRotation.w);
+    if (axisY.w < 0.5)
+    {
+        // Rotate the vertices around the billboard normal
+        offset = vec2(offset.x * c + offset.y * s, offset.y * c - offset.x * s);
+    }
+    else
+    {
+        // Rotate the texture coordinates around the centre of the rectangle
+        vec2 halfSize = (texcoordRect.zw - texcoordRect.xy) * 0.5;
+        vec2 d = (corner.xy * 2.0 - 1.0) * halfSize;
+        texcoord = texcoordRect.xy + halfSize + vec2(d.x * c - d.y * s, d.x * s + d.y * c);
+    }
+
+    oPosition = vec4(positionRotation.xyz + x * offset.x + y * offset.y, 1.0);
+    oTexcoord = texcoord;
+}
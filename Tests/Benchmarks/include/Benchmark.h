@@ -0,0 +1,130 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __Benchmark_H__
+#define __Benchmark_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreTimer.h"
+
+/** Timing loop of a benchmark.
+@remarks
+    A benchmark repeats the code it measures while next() returns true. The
+    runner calls it with more and more iterations until it takes at least the
+    minimum time, then calls it a few more times with that many iterations
+    and reports the time per iteration.
+*/
+class BenchmarkRun
+{
+public:
+    BenchmarkRun(size_t iterations);
+
+    /// Whether to run the measured code once more, the timer starts on the first call
+    bool next()
+    {
+        if (mDone < mIterations)
+        {
+            if (!mDone++)
+                resumeTiming();
+            return true;
+        }
+        pauseTiming();
+        return false;
+    }
+
+    /// Stop the timer, to leave setup inside the loop out of the measurement
+    void pauseTiming();
+    /// Start the timer again after pauseTiming
+    void resumeTiming();
+
+    /// Set the number of items each iteration processes, to report items per second
+    void setItemsPerIteration(size_t items) { mItemsPerIteration = items; }
+    /// Set the number of bytes each iteration processes, to report bytes per second
+    void setBytesPerIteration(size_t bytes) { mBytesPerIteration = bytes; }
+
+    size_t getIterations() const { return mIterations; }
+    size_t getIterationsDone() const { return mDone; }
+    /// Get the measured time, in microseconds
+    unsigned long getElapsed() const { return mElapsed; }
+    size_t getItemsPerIteration() const { return mItemsPerIteration; }
+    size_t getBytesPerIteration() const { return mBytesPerIteration; }
+
+private:
+    Ogre::Timer mTimer;
+    size_t mIterations;
+    size_t mDone;
+    bool mTiming;
+    unsigned long mStart;
+    unsigned long mElapsed;
+    size_t mItemsPerIteration;
+    size_t mBytesPerIteration;
+};
+
+typedef void (*BenchmarkFunction)(BenchmarkRun& run);
+
+struct BenchmarkInfo
+{
+    const char* name;
+    BenchmarkFunction function;
+};
+typedef std::vector<BenchmarkInfo> BenchmarkList;
+
+/// Get the registered benchmarks, in the order they were registered
+BenchmarkList& getBenchmarks();
+
+/// Registers a benchmark when constructed, see OGRE_BENCHMARK
+struct BenchmarkRegistration
+{
+    BenchmarkRegistration(const char* name, BenchmarkFunction function);
+};
+
+/** Keeps the compiler from optimising away the computation of a value
+    which is otherwise unused. */
+void benchmarkUse(const void* value);
+
+/** Defines and registers a benchmark, followed by its body.
+@remarks
+    The body receives a BenchmarkRun named run, for example:
+@code
+    OGRE_BENCHMARK(Vector3_normalise)
+    {
+        Ogre::Vector3 v(1, 2, 3);
+        while (run.next())
+        {
+            v.normalise();
+            benchmarkUse(&v);
+        }
+    }
+@endcode
+*/
+#define OGRE_BENCHMARK(name) \
+    static void name(BenchmarkRun& run); \
+    static BenchmarkRegistration name##Registration(#name, &name); \
+    static void name(BenchmarkRun& run)
+
+#endif
@@ -0,0 +1,78 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "Benchmark.h"
+
+BenchmarkRun::BenchmarkRun(size_t iterations)
+    : mIterations(iterations)
+    , mDone(0)
+    , mTiming(false)
+    , mStart(0)
+    , mElapsed(0)
+    , mItemsPerIteration(0)
+    , mBytesPerIteration(0)
+{
+}
+//--------------------------------------------------------------------------
+void BenchmarkRun::pauseTiming()
+{
+    if (mTiming)
+    {
+        mElapsed += mTimer.getMicroseconds() - mStart;
+        mTiming = false;
+    }
+}
+//--------------------------------------------------------------------------
+void BenchmarkRun::resumeTiming()
+{
+    if (!mTiming)
+    {
+        mStart = mTimer.getMicroseconds();
+        mTiming = true;
+    }
+}
+//--------------------------------------------------------------------------
+BenchmarkList& getBenchmarks()
+{
+    static BenchmarkList benchmarks;
+    return benchmarks;
+}
+//--------------------------------------------------------------------------
+BenchmarkRegistration::BenchmarkRegistration(const char* name, BenchmarkFunction function)
+{
+    BenchmarkInfo info = { name, function };
+    getBenchmarks().push_back(info);
+}
+//--------------------------------------------------------------------------
+static const void* volatile sBenchmarkSink = 0;
+
+void benchmarkUse(const void* value)
+{
+    // An opaque store the compiler has to assume is read elsewhere
+    sBenchmarkSink = value;
+}
@@ -0,0 +1,132 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "Benchmark.h"
+
+#include "OgrePixelFormat.h"
+#include "OgreImage.h"
+
+using namespace Ogre;
+
+namespace {
+    const uint32 SIZE = 512;
+
+    void fillPattern(std::vector<uint8>& data)
+    {
+        for (size_t i = 0; i < data.size(); ++i)
+            data[i] = (uint8)(i * 31 + (i >> 9));
+    }
+
+    void benchmarkConversion(BenchmarkRun& run, PixelFormat srcFormat, PixelFormat destFormat)
+    {
+        std::vector<uint8> src(PixelUtil::getMemorySize(SIZE, SIZE, 1, srcFormat));
+        std::vector<uint8> dest(PixelUtil::getMemorySize(SIZE, SIZE, 1, destFormat));
+        fillPattern(src);
+        if (PixelUtil::isFloatingPoint(srcFormat))
+        {
+            // Valid values rather than a bit pattern, NaNs could be slower
+            std::vector<uint8> bytes(src);
+            PixelUtil::bulkPixelConversion(PixelBox(SIZE, SIZE, 1, PF_L8, &bytes[0]),
+                PixelBox(SIZE, SIZE, 1, srcFormat, &src[0]));
+        }
+
+        PixelBox srcBox(SIZE, SIZE, 1, srcFormat, &src[0]);
+        PixelBox destBox(SIZE, SIZE, 1, destFormat, &dest[0]);
+        run.setItemsPerIteration(SIZE * SIZE);
+        run.setBytesPerIteration(src.size());
+        while (run.next())
+        {
+            PixelUtil::bulkPixelConversion(srcBox, destBox);
+            benchmarkUse(&dest[0]);
+        }
+    }
+
+    void benchmarkScale(BenchmarkRun& run, PixelFormat format, Image::Filter filter)
+    {
+        std::vector<uint8> src(PixelUtil::getMemorySize(SIZE, SIZE, 1, format));
+        std::vector<uint8> dest(PixelUtil::getMemorySize(SIZE / 2 + 1, SIZE / 2 + 1, 1, format));
+        fillPattern(src);
+
+        PixelBox srcBox(SIZE, SIZE, 1, format, &src[0]);
+        PixelBox destBox(SIZE / 2 + 1, SIZE / 2 + 1, 1, format, &dest[0]);
+        run.setItemsPerIteration(destBox.getWidth() * destBox.getHeight());
+        run.setBytesPerIteration(src.size());
+        while (run.next())
+        {
+            Image::scale(srcBox, destBox, filter);
+            benchmarkUse(&dest[0]);
+        }
+    }
+}
+
+OGRE_BENCHMARK(PixelUtil_bulkPixelConversion_R8G8B8_to_A8R8G8B8)
+{
+    benchmarkConversion(run, PF_R8G8B8, PF_A8R8G8B8);
+}
+
+OGRE_BENCHMARK(PixelUtil_bulkPixelConversion_A8R8G8B8_to_A8B8G8R8)
+{
+    benchmarkConversion(run, PF_A8R8G8B8, PF_A8B8G8R8);
+}
+
+OGRE_BENCHMARK(PixelUtil_bulkPixelConversion_A8R8G8B8_to_R5G6B5)
+{
+    benchmarkConversion(run, PF_A8R8G8B8, PF_R5G6B5);
+}
+
+OGRE_BENCHMARK(PixelUtil_bulkPixelConversion_A8R8G8B8_to_FLOAT32_RGBA)
+{
+    benchmarkConversion(run, PF_A8R8G8B8, PF_FLOAT32_RGBA);
+}
+
+OGRE_BENCHMARK(PixelUtil_bulkPixelConversion_FLOAT16_RGBA_to_A8B8G8R8)
+{
+    benchmarkConversion(run, PF_FLOAT16_RGBA, PF_A8B8G8R8);
+}
+
+// Image::resize allocates and scales, the scale is what is measured here.
+// Odd destination sizes avoid any exact halving shortcut.
+OGRE_BENCHMARK(Image_resize_nearest)
+{
+    benchmarkScale(run, PF_A8R8G8B8, Image::FILTER_NEAREST);
+}
+
+OGRE_BENCHMARK(Image_resize_bilinear)
+{
+    benchmarkScale(run, PF_A8R8G8B8, Image::FILTER_BILINEAR);
+}
+
+OGRE_BENCHMARK(Image_resize_bilinear_float)
+{
+    benchmarkScale(run, PF_FLOAT32_RGBA, Image::FILTER_BILINEAR);
+}
+
+OGRE_BENCHMARK(Image_resize_box)
+{
+    benchmarkScale(run, PF_A8R8G8B8, Image::FILTER_BOX);
+}
@@ -0,0 +1,516 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "Benchmark.h"
+
+#include "OgreMeshManager.h"
+#include "OgreMeshSerializer.h"
+#include "OgreMesh.h"
+#include "OgreSubMesh.h"
+#include "OgrePose.h"
+#include "OgreLodStrategy.h"
+#include "OgreHardwareBufferManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreMaterialSerializer.h"
+#include "OgreScriptCompiler.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreFileSystem.h"
+#include "OgreDataStream.h"
+#include "OgreStringConverter.h"
+#ifdef OGRE_BENCHMARK_XML
+#include "OgreXMLMeshSerializer.h"
+#endif
+
+#include <cstdio>
+
+using namespace Ogre;
+
+// Benchmarks of the asset formats on large synthetic assets, which are
+// generated once and shared by the benchmarks. Reading a file (I/O) and
+// decoding it from memory are timed separately; the files are written to the
+// working directory and usually stay in the OS cache, so the I/O benchmarks
+// measure the copy or mapping cost rather than the disk.
+
+namespace {
+    const char* const GROUP = "LargeAsset";
+    const char* const MATERIAL_GROUP = "LargeAssetMaterials";
+    const char* const MESH_NAME = "LargeAsset/Mesh";
+    const char* const IMPORT_NAME = "LargeAsset/Imported";
+    const char* const MESH_FILE = "OgreBenchmarks_Large.mesh";
+    const char* const XML_FILE = "OgreBenchmarks_Large.mesh.xml";
+    const char* const MATERIAL_SOURCE = "LargeAsset.material";
+
+    /// Vertices along each side of the grid of a submesh, so indices stay 16 bit
+    const size_t GRID_SIZE = 256;
+    /// 16 grids of 256x256 vertices, a million vertices in all
+    const size_t NUM_SUBMESHES = 16;
+    /// Full detail plus generated levels using every 2nd, 4th and 8th row and column
+    const ushort NUM_LODS = 4;
+    /// Poses offsetting all the vertices of the first submesh
+    const size_t NUM_POSES = 4;
+    const size_t NUM_MATERIALS = 2000;
+
+    /// Indices of the triangles of the grid using every step-th row and column
+    IndexData* createGridIndices(size_t step)
+    {
+        const size_t cells = (GRID_SIZE - 1) / step;
+        std::vector<uint16> indices;
+        indices.reserve(cells * cells * 6);
+        for (size_t z = 0; z < cells; ++z)
+        {
+            for (size_t x = 0; x < cells; ++x)
+            {
+                uint16 i0 = static_cast<uint16>(z * step * GRID_SIZE + x * step);
+                uint16 i1 = static_cast<uint16>(i0 + step);
+                uint16 i2 = static_cast<uint16>(i0 + step * GRID_SIZE);
+                uint16 i3 = static_cast<uint16>(i2 + step);
+                indices.push_back(i0); indices.push_back(i2); indices.push_back(i1);
+                indices.push_back(i1); indices.push_back(i2); indices.push_back(i3);
+            }
+        }
+
+        IndexData* data = OGRE_NEW IndexData();
+        data->indexCount = indices.size();
+        data->indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+            HardwareIndexBuffer::IT_16BIT, indices.size(), HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        data->indexBuffer->writeData(0, data->indexBuffer->getSizeInBytes(), &indices[0], true);
+        return data;
+    }
+
+    /// A rippled grid with positions, normals and texture coordinates
+    VertexData* createGridVertices(size_t submesh)
+    {
+        VertexData* data = OGRE_NEW VertexData();
+        VertexDeclaration* decl = data->vertexDeclaration;
+        size_t offset = 0;
+        offset += decl->addElement(0, offset, VET_FLOAT3, VES_POSITION).getSize();
+        offset += decl->addElement(0, offset, VET_FLOAT3, VES_NORMAL).getSize();
+        offset += decl->addElement(0, offset, VET_FLOAT2, VES_TEXTURE_COORDINATES).getSize();
+
+        std::vector<float> vertices;
+        vertices.reserve(GRID_SIZE * GRID_SIZE * 8);
+        for (size_t z = 0; z < GRID_SIZE; ++z)
+        {
+            for (size_t x = 0; x < GRID_SIZE; ++x)
+            {
+                float px = static_cast<float>(submesh * GRID_SIZE + x);
+                float pz = static_cast<float>(z);
+                float u = static_cast<float>(x) / (GRID_SIZE - 1);
+                float v = static_cast<float>(z) / (GRID_SIZE - 1);
+                vertices.push_back(px);
+                vertices.push_back(std::sin(px * 0.1f) * std::cos(pz * 0.1f));
+                vertices.push_back(pz);
+                vertices.push_back(0);
+                vertices.push_back(1);
+                vertices.push_back(0);
+                vertices.push_back(u);
+                vertices.push_back(v);
+            }
+        }
+
+        data->vertexCount = GRID_SIZE * GRID_SIZE;
+        HardwareVertexBufferSharedPtr buffer = HardwareBufferManager::getSingleton().createVertexBuffer(
+            offset, data->vertexCount, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        buffer->writeData(0, buffer->getSizeInBytes(), &vertices[0], true);
+        data->vertexBufferBinding->setBinding(0, buffer);
+        return data;
+    }
+
+    /// Creates the large mesh: submeshes, generated LOD levels, poses and edge lists
+    MeshPtr createLargeMesh()
+    {
+        MeshPtr mesh = MeshManager::getSingleton().createManual(MESH_NAME, GROUP);
+        for (size_t s = 0; s < NUM_SUBMESHES; ++s)
+        {
+            SubMesh* sub = mesh->createSubMesh();
+            sub->useSharedVertices = false;
+            sub->vertexData = createGridVertices(s);
+            OGRE_DELETE sub->indexData;
+            sub->indexData = createGridIndices(1);
+            sub->setMaterialName("LargeAsset/Material" + StringConverter::toString(s));
+        }
+
+#if !OGRE_NO_MESHLOD
+        mesh->_setLodInfo(NUM_LODS);
+        for (ushort level = 1; level < NUM_LODS; ++level)
+        {
+            MeshLodUsage usage;
+            usage.userValue = level * 100.0f;
+            usage.value = mesh->getLodStrategy()->transformUserValue(usage.userValue);
+            mesh->_setLodUsage(level, usage);
+            for (ushort s = 0; s < NUM_SUBMESHES; ++s)
+                mesh->_setSubMeshLodFaceList(s, level, createGridIndices(size_t(1) << level));
+        }
+#endif
+
+        // pose targets are 0 for the shared vertices, submesh index + 1 otherwise
+        for (size_t p = 0; p < NUM_POSES; ++p)
+        {
+            Pose* pose = mesh->createPose(1, "Pose" + StringConverter::toString(p));
+            for (size_t v = 0; v < GRID_SIZE * GRID_SIZE; ++v)
+                pose->addVertex(v, Vector3(0, std::sin(v * 0.01f + p), 0));
+        }
+
+        const Real width = static_cast<Real>(NUM_SUBMESHES * GRID_SIZE);
+        AxisAlignedBox bounds(0, -1, 0, width, 1, static_cast<Real>(GRID_SIZE));
+        mesh->_setBounds(bounds);
+        mesh->_setBoundingSphereRadius(bounds.getHalfSize().length());
+        mesh->buildEdgeList();
+        return mesh;
+    }
+
+    /** The large mesh, created once and kept by the MeshManager until the end
+        of the run, as its buffers must go before the buffer manager does. */
+    MeshPtr getLargeMesh()
+    {
+        ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+        if (!rgm.resourceGroupExists(GROUP))
+            rgm.createResourceGroup(GROUP);
+        MeshPtr mesh = MeshManager::getSingleton().getByName(MESH_NAME, GROUP);
+        if (mesh.isNull())
+            mesh = createLargeMesh();
+        return mesh;
+    }
+
+    /// Removes the files written by the benchmarks at exit
+    struct TemporaryFiles
+    {
+        ~TemporaryFiles()
+        {
+            std::remove(MESH_FILE);
+            std::remove(XML_FILE);
+        }
+    };
+    TemporaryFiles temporaryFiles;
+
+    /// Opens the binary file of the large mesh through a file system archive
+    DataStreamPtr openMeshFile(bool mapped)
+    {
+        FileSystemArchive archive(".", "FileSystem", true);
+        bool previous = FileSystemArchive::getUseMemoryMapping();
+        FileSystemArchive::setUseMemoryMapping(mapped);
+        DataStreamPtr stream = archive.open(MESH_FILE);
+        FileSystemArchive::setUseMemoryMapping(previous);
+        return stream;
+    }
+
+    /** The binary export of the large mesh, held in memory. The export is
+        written to a file first, which the I/O benchmarks read. */
+    DataStreamPtr getLargeMeshData()
+    {
+        static MemoryDataStreamPtr data;
+        if (data.isNull())
+        {
+            MeshSerializer().exportMesh(getLargeMesh().get(), MESH_FILE);
+            DataStreamPtr file = openMeshFile(false);
+            data.bind(OGRE_NEW MemoryDataStream(file));
+        }
+        return DataStreamPtr(OGRE_NEW MemoryDataStream(data->getPtr(), data->size(), false, true));
+    }
+
+    /// Opens the binary file of the large mesh, after writing it if needed
+    DataStreamPtr openLargeMeshFile(bool mapped)
+    {
+        getLargeMeshData();
+        return openMeshFile(mapped);
+    }
+
+    void importLargeMesh(DataStreamPtr& data, BenchmarkRun& run)
+    {
+        run.pauseTiming();
+        MeshPtr imported = MeshManager::getSingleton().createManual(IMPORT_NAME, GROUP);
+        data->seek(0);
+        run.resumeTiming();
+
+        MeshSerializer().importMesh(data, imported.get());
+
+        // Freeing the buffers is not part of the import
+        run.pauseTiming();
+        imported.setNull();
+        MeshManager::getSingleton().remove(IMPORT_NAME);
+        run.resumeTiming();
+    }
+
+    /// A material library with several techniques, passes and texture units each
+    String createMaterialLibrary()
+    {
+        StringStream script;
+        for (size_t i = 0; i < NUM_MATERIALS; ++i)
+        {
+            script << "material LargeAsset/Material" << i << "\n"
+                "{\n"
+                "    lod_values 200 600\n"
+                "    technique\n"
+                "    {\n"
+                "        pass\n"
+                "        {\n"
+                "            ambient 0.2 0.2 0.2\n"
+                "            diffuse " << (i % 10) / 10.0 << " 0.5 0.5 1\n"
+                "            specular 1 1 1 1 " << 10 + i % 50 << "\n"
+                "            alpha_rejection greater_equal " << 64 + i % 128 << "\n"
+                "            cull_hardware " << (i % 2 ? "none" : "clockwise") << "\n"
+                "            texture_unit\n"
+                "            {\n"
+                "                texture LargeAsset/Diffuse" << i % 100 << ".dds\n"
+                "                filtering anisotropic\n"
+                "                max_anisotropy 8\n"
+                "            }\n"
+                "            texture_unit\n"
+                "            {\n"
+                "                texture LargeAsset/Detail" << i % 20 << ".dds\n"
+                "                tex_coord_set 1\n"
+                "                colour_op modulate\n"
+                "                scale 4 4\n"
+                "            }\n"
+                "        }\n"
+                "        pass\n"
+                "        {\n"
+                "            lighting off\n"
+                "            scene_blend add\n"
+                "            depth_write off\n"
+                "            texture_unit\n"
+                "            {\n"
+                "                texture LargeAsset/Glow" << i % 10 << ".dds\n"
+                "                scroll_anim 0.1 0\n"
+                "            }\n"
+                "        }\n"
+                "    }\n"
+                "    technique\n"
+                "    {\n"
+                "        lod_index 1\n"
+                "        pass\n"
+                "        {\n"
+                "            diffuse 0.5 0.5 0.5 1\n"
+                "            texture_unit\n"
+                "            {\n"
+                "                texture LargeAsset/Diffuse" << i % 100 << ".dds\n"
+                "            }\n"
+                "        }\n"
+                "    }\n"
+                "}\n";
+        }
+        return script.str();
+    }
+
+    const String& getMaterialLibrary()
+    {
+        static String library = createMaterialLibrary();
+        return library;
+    }
+
+    void compileMaterialLibrary()
+    {
+        ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+        if (!rgm.resourceGroupExists(MATERIAL_GROUP))
+            rgm.createResourceGroup(MATERIAL_GROUP);
+        DataStreamPtr stream(OGRE_NEW MemoryDataStream(MATERIAL_SOURCE,
+            const_cast<char*>(getMaterialLibrary().c_str()), getMaterialLibrary().size(), false, true));
+        ScriptCompilerManager::getSingleton().parseScript(stream, MATERIAL_GROUP);
+    }
+
+    void destroyMaterialLibrary()
+    {
+        ResourceGroupManager::getSingleton().clearResourceGroup(MATERIAL_GROUP);
+    }
+}
+
+OGRE_BENCHMARK(LargeMesh_exportBinary)
+{
+    MeshPtr mesh = getLargeMesh();
+    const size_t size = getLargeMeshData()->size();
+    MemoryDataStreamPtr scratch(OGRE_NEW MemoryDataStream(size));
+
+    MeshSerializer serializer;
+    run.setBytesPerIteration(size);
+    while (run.next())
+    {
+        scratch->seek(0);
+        serializer.exportMesh(mesh.get(), scratch);
+    }
+}
+
+OGRE_BENCHMARK(LargeMesh_importBinary)
+{
+    DataStreamPtr data = getLargeMeshData();
+
+    run.setBytesPerIteration(data->size());
+    while (run.next())
+        importLargeMesh(data, run);
+}
+
+OGRE_BENCHMARK(LargeMesh_readFile)
+{
+    run.setBytesPerIteration(getLargeMeshData()->size());
+    while (run.next())
+    {
+        DataStreamPtr file = openLargeMeshFile(false);
+        MemoryDataStream data(file);
+        benchmarkUse(data.getPtr());
+    }
+}
+
+OGRE_BENCHMARK(LargeMesh_readFileMapped)
+{
+    run.setBytesPerIteration(getLargeMeshData()->size());
+    while (run.next())
+    {
+        // touch every page, as a mapping is only read when accessed
+        DataStreamPtr file = openLargeMeshFile(true);
+        MemoryDataStream* data = dynamic_cast<MemoryDataStream*>(file.get());
+        if (!data)
+        {
+            OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, "Memory mapping is not available",
+                "LargeMesh_readFileMapped");
+        }
+        uchar sum = 0;
+        for (size_t i = 0; i < data->size(); i += 4096)
+            sum += data->getPtr()[i];
+        benchmarkUse(&sum);
+    }
+}
+
+OGRE_BENCHMARK(LargeMesh_loadFileMapped)
+{
+    run.setBytesPerIteration(getLargeMeshData()->size());
+    while (run.next())
+    {
+        DataStreamPtr file = openLargeMeshFile(true);
+        importLargeMesh(file, run);
+    }
+}
+
+OGRE_BENCHMARK(LargeMesh_buildEdgeList)
+{
+    MeshPtr mesh = getLargeMesh();
+
+    run.setItemsPerIteration(NUM_SUBMESHES * GRID_SIZE * GRID_SIZE);
+    while (run.next())
+    {
+        run.pauseTiming();
+        mesh->freeEdgeList();
+        run.resumeTiming();
+
+        mesh->buildEdgeList();
+    }
+}
+
+#ifdef OGRE_BENCHMARK_XML
+OGRE_BENCHMARK(LargeMesh_exportXML)
+{
+    MeshPtr mesh = getLargeMesh();
+
+    XMLMeshSerializer serializer;
+    run.setItemsPerIteration(NUM_SUBMESHES * GRID_SIZE * GRID_SIZE);
+    while (run.next())
+        serializer.exportMesh(mesh.get(), XML_FILE);
+}
+
+OGRE_BENCHMARK(LargeMesh_importXML)
+{
+    XMLMeshSerializer().exportMesh(getLargeMesh().get(), XML_FILE);
+
+    XMLMeshSerializer serializer;
+    run.setItemsPerIteration(NUM_SUBMESHES * GRID_SIZE * GRID_SIZE);
+    while (run.next())
+    {
+        run.pauseTiming();
+        MeshPtr imported = MeshManager::getSingleton().createManual(IMPORT_NAME, GROUP);
+        run.resumeTiming();
+
+        serializer.importMesh(XML_FILE, VET_COLOUR_ARGB, imported.get());
+
+        run.pauseTiming();
+        imported.setNull();
+        MeshManager::getSingleton().remove(IMPORT_NAME);
+        run.resumeTiming();
+    }
+}
+#endif
+
+OGRE_BENCHMARK(MaterialLibrary_compile)
+{
+    ScriptCompilerManager& manager = ScriptCompilerManager::getSingleton();
+    bool cached = manager.getSaveParsedScriptsToCache();
+    manager.setSaveParsedScriptsToCache(false);
+    manager.clearParsedScriptCache();
+
+    run.setItemsPerIteration(NUM_MATERIALS);
+    run.setBytesPerIteration(getMaterialLibrary().size());
+    while (run.next())
+    {
+        compileMaterialLibrary();
+
+        // Destroying the materials is not part of the compilation
+        run.pauseTiming();
+        destroyMaterialLibrary();
+        run.resumeTiming();
+    }
+    manager.setSaveParsedScriptsToCache(cached);
+}
+
+OGRE_BENCHMARK(MaterialLibrary_compileParsedCache)
+{
+    ScriptCompilerManager& manager = ScriptCompilerManager::getSingleton();
+    bool cached = manager.getSaveParsedScriptsToCache();
+    manager.setSaveParsedScriptsToCache(true);
+    compileMaterialLibrary();
+    destroyMaterialLibrary();
+
+    run.setItemsPerIteration(NUM_MATERIALS);
+    run.setBytesPerIteration(getMaterialLibrary().size());
+    while (run.next())
+    {
+        compileMaterialLibrary();
+
+        run.pauseTiming();
+        destroyMaterialLibrary();
+        run.resumeTiming();
+    }
+    manager.setSaveParsedScriptsToCache(cached);
+    manager.clearParsedScriptCache();
+}
+
+OGRE_BENCHMARK(MaterialLibrary_export)
+{
+    compileMaterialLibrary();
+
+    MaterialSerializer serializer;
+    run.setItemsPerIteration(NUM_MATERIALS);
+    while (run.next())
+    {
+        for (size_t i = 0; i < NUM_MATERIALS; ++i)
+        {
+            MaterialPtr material = MaterialManager::getSingleton().getByName(
+                "LargeAsset/Material" + StringConverter::toString(i), MATERIAL_GROUP);
+            serializer.queueForExport(material, i == 0);
+        }
+        benchmarkUse(serializer.getQueuedAsString().c_str());
+    }
+
+    destroyMaterialLibrary();
+}
@@ -0,0 +1,233 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "Benchmark.h"
+
+#include "OgreMatrix4.h"
+#include "OgreQuaternion.h"
+#include "OgreMath.h"
+
+using namespace Ogre;
+
+namespace {
+    const size_t COUNT = 256;
+
+    Matrix4 randomAffine()
+    {
+        Quaternion q(Radian(Math::RangeRandom(0, Math::TWO_PI)),
+            Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(), 1).normalisedCopy());
+        Matrix4 m;
+        m.makeTransform(Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(), Math::SymmetricRandom()) * 100,
+            Vector3(Math::RangeRandom(0.5, 2), Math::RangeRandom(0.5, 2), Math::RangeRandom(0.5, 2)), q);
+        return m;
+    }
+
+    Quaternion randomRotation()
+    {
+        Quaternion q(Math::SymmetricRandom(), Math::SymmetricRandom(),
+            Math::SymmetricRandom(), Math::SymmetricRandom());
+        q.normalise();
+        return q;
+    }
+}
+
+OGRE_BENCHMARK(Matrix4_multiply)
+{
+    std::vector<Matrix4> a(COUNT), b(COUNT), c(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        a[i] = randomAffine();
+        b[i] = randomAffine();
+    }
+    run.setItemsPerIteration(COUNT);
+    while (run.next())
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+            c[i] = a[i] * b[i];
+        benchmarkUse(&c[0]);
+    }
+}
+
+OGRE_BENCHMARK(Matrix4_concatenateAffine)
+{
+    std::vector<Matrix4> a(COUNT), b(COUNT), c(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        a[i] = randomAffine();
+        b[i] = randomAffine();
+    }
+    run.setItemsPerIteration(COUNT);
+    while (run.next())
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+            c[i] = a[i].concatenateAffine(b[i]);
+        benchmarkUse(&c[0]);
+    }
+}
+
+OGRE_BENCHMARK(Matrix4_inverse)
+{
+    std::vector<Matrix4> a(COUNT), c(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+        a[i] = randomAffine();
+    run.setItemsPerIteration(COUNT);
+    while (run.next())
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+            c[i] = a[i].inverse();
+        benchmarkUse(&c[0]);
+    }
+}
+
+OGRE_BENCHMARK(Matrix4_inverseAffine)
+{
+    std::vector<Matrix4> a(COUNT), c(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+        a[i] = randomAffine();
+    run.setItemsPerIteration(COUNT);
+    while (run.next())
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+            c[i] = a[i].inverseAffine();
+        benchmarkUse(&c[0]);
+    }
+}
+
+OGRE_BENCHMARK(Matrix4_transformAffine)
+{
+    Matrix4 m = randomAffine();
+    std::vector<Vector3> v(COUNT), c(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+        v[i] = Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(), Math::SymmetricRandom());
+    run.setItemsPerIteration(COUNT);
+    while (run.next())
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+            c[i] = m.transformAffine(v[i]);
+        benchmarkUse(&c[0]);
+    }
+}
+
+OGRE_BENCHMARK(Quaternion_multiply)
+{
+    std::vector<Quaternion> a(COUNT), b(COUNT), c(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        a[i] = randomRotation();
+        b[i] = randomRotation();
+    }
+    run.setItemsPerIteration(COUNT);
+    while (run.next())
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+            c[i] = a[i] * b[i];
+        benchmarkUse(&c[0]);
+    }
+}
+
+OGRE_BENCHMARK(Quaternion_rotateVector)
+{
+    std::vector<Quaternion> q(COUNT);
+    std::vector<Vector3> v(COUNT), c(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        q[i] = randomRotation();
+        v[i] = Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(), Math::SymmetricRandom());
+    }
+    run.setItemsPerIteration(COUNT);
+    while (run.next())
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+            c[i] = q[i] * v[i];
+        benchmarkUse(&c[0]);
+    }
+}
+
+OGRE_BENCHMARK(Quaternion_slerp)
+{
+    std::vector<Quaternion> a(COUNT), b(COUNT), c(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        a[i] = randomRotation();
+        b[i] = randomRotation();
+    }
+    run.setItemsPerIteration(COUNT);
+    while (run.next())
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+            c[i] = Quaternion::Slerp(0.3f, a[i], b[i], true);
+        benchmarkUse(&c[0]);
+    }
+}
+
+OGRE_BENCHMARK(Quaternion_nlerp)
+{
+    std::vector<Quaternion> a(COUNT), b(COUNT), c(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        a[i] = randomRotation();
+        b[i] = randomRotation();
+    }
+    run.setItemsPerIteration(COUNT);
+    while (run.next())
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+            c[i] = Quaternion::nlerp(0.3f, a[i], b[i], true);
+        benchmarkUse(&c[0]);
+    }
+}
+
+OGRE_BENCHMARK(Quaternion_toRotationMatrix)
+{
+    std::vector<Quaternion> q(COUNT);
+    std::vector<Matrix3> c(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+        q[i] = randomRotation();
+    run.setItemsPerIteration(COUNT);
+    while (run.next())
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+            q[i].ToRotationMatrix(c[i]);
+        benchmarkUse(&c[0]);
+    }
+}
+
+OGRE_BENCHMARK(Quaternion_fromRotationMatrix)
+{
+    std::vector<Quaternion> c(COUNT);
+    std::vector<Matrix3> m(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+        randomRotation().ToRotationMatrix(m[i]);
+    run.setItemsPerIteration(COUNT);
+    while (run.next())
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+            c[i].FromRotationMatrix(m[i]);
+        benchmarkUse(&c[0]);
+    }
+}
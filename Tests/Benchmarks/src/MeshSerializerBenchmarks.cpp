@@ -0,0 +1,105 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "Benchmark.h"
+
+#include "OgreMeshManager.h"
+#include "OgreMeshSerializer.h"
+#include "OgreMesh.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreDataStream.h"
+
+using namespace Ogre;
+
+namespace {
+    const char* const MESH_NAME = "Benchmark/Plane";
+    const char* const IMPORT_NAME = "Benchmark/Imported";
+
+    /// A plane of 129x129 vertices with normals and texture coordinates
+    MeshPtr createBenchmarkMesh()
+    {
+        return MeshManager::getSingleton().createPlane(MESH_NAME,
+            ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, Plane(Vector3::UNIT_Y, 0),
+            1000, 1000, 128, 128, true, 1, 1, 1, Vector3::UNIT_Z);
+    }
+
+    /// Exports a mesh, returning a stream holding exactly its data
+    DataStreamPtr exportToMemory(const MeshPtr& mesh, MemoryDataStreamPtr& scratch)
+    {
+        scratch.bind(OGRE_NEW MemoryDataStream(16 * 1024 * 1024));
+        MeshSerializer serializer;
+        serializer.exportMesh(mesh.get(), scratch);
+        return DataStreamPtr(OGRE_NEW MemoryDataStream(scratch->getPtr(), scratch->tell(), false, true));
+    }
+}
+
+OGRE_BENCHMARK(MeshSerializer_export)
+{
+    MeshPtr mesh = createBenchmarkMesh();
+    MemoryDataStreamPtr scratch;
+    DataStreamPtr data = exportToMemory(mesh, scratch);
+
+    MeshSerializer serializer;
+    run.setBytesPerIteration(data->size());
+    while (run.next())
+    {
+        scratch->seek(0);
+        serializer.exportMesh(mesh.get(), scratch);
+    }
+
+    mesh.setNull();
+    MeshManager::getSingleton().remove(MESH_NAME);
+}
+
+OGRE_BENCHMARK(MeshSerializer_import)
+{
+    MeshPtr mesh = createBenchmarkMesh();
+    MemoryDataStreamPtr scratch;
+    DataStreamPtr data = exportToMemory(mesh, scratch);
+    mesh.setNull();
+    MeshManager::getSingleton().remove(MESH_NAME);
+
+    MeshSerializer serializer;
+    run.setBytesPerIteration(data->size());
+    while (run.next())
+    {
+        run.pauseTiming();
+        MeshPtr imported = MeshManager::getSingleton().createManual(IMPORT_NAME,
+            ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+        data->seek(0);
+        run.resumeTiming();
+
+        serializer.importMesh(data, imported.get());
+
+        // Freeing the buffers is not part of the import
+        run.pauseTiming();
+        imported.setNull();
+        MeshManager::getSingleton().remove(IMPORT_NAME);
+        run.resumeTiming();
+    }
+}
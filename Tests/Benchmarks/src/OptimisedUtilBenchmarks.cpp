@@ -0,0 +1,223 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "Benchmark.h"
+
+#include "OgreOptimisedUtil.h"
+#include "OgreEdgeListBuilder.h"
+#include "OgreMatrix4.h"
+#include "OgrePlane.h"
+#include "OgreMath.h"
+
+using namespace Ogre;
+
+namespace {
+    const size_t NUM_VERTICES = 8192;
+    const size_t NUM_BONES = 32;
+
+    typedef std::vector<Matrix4, STLAllocator<Matrix4, CategorisedAlignAllocPolicy<MEMCATEGORY_GEOMETRY> > >
+        AlignedMatrixList;
+
+    void fillRandom(std::vector<float>& values, float scale)
+    {
+        for (size_t i = 0; i < values.size(); ++i)
+            values[i] = Math::SymmetricRandom() * scale;
+    }
+
+    Matrix4 randomAffine()
+    {
+        Matrix4 m;
+        m.makeTransform(Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(), Math::SymmetricRandom()),
+            Vector3::UNIT_SCALE, Quaternion(Radian(Math::RangeRandom(0, Math::TWO_PI)), Vector3::UNIT_Y));
+        return m;
+    }
+}
+
+OGRE_BENCHMARK(OptimisedUtil_softwareVertexSkinning)
+{
+    // Positions and normals interleaved, as in a vertex buffer
+    std::vector<float> src(NUM_VERTICES * 6), dest(NUM_VERTICES * 6);
+    fillRandom(src, 10);
+    std::vector<float> weights(NUM_VERTICES * 4);
+    std::vector<unsigned char> indices(NUM_VERTICES * 4);
+    for (size_t v = 0; v < NUM_VERTICES; ++v)
+    {
+        float total = 0;
+        for (size_t w = 0; w < 4; ++w)
+        {
+            weights[v * 4 + w] = Math::UnitRandom() + 0.01f;
+            total += weights[v * 4 + w];
+            indices[v * 4 + w] = (unsigned char)Math::RangeRandom(0, NUM_BONES - 1);
+        }
+        for (size_t w = 0; w < 4; ++w)
+            weights[v * 4 + w] /= total;
+    }
+    AlignedMatrixList bones(NUM_BONES);
+    std::vector<const Matrix4*> bonePointers(NUM_BONES);
+    for (size_t i = 0; i < NUM_BONES; ++i)
+    {
+        bones[i] = randomAffine();
+        bonePointers[i] = &bones[i];
+    }
+
+    OptimisedUtil* util = OptimisedUtil::getImplementation();
+    run.setItemsPerIteration(NUM_VERTICES);
+    while (run.next())
+    {
+        util->softwareVertexSkinning(&src[0], &dest[0], &src[3], &dest[3],
+            &weights[0], &indices[0], &bonePointers[0],
+            24, 24, 24, 24, 16, 4, 4, NUM_VERTICES);
+        benchmarkUse(&dest[0]);
+    }
+}
+
+OGRE_BENCHMARK(OptimisedUtil_concatenateAffineMatrices)
+{
+    AlignedMatrixList src(NUM_BONES * 4), dest(NUM_BONES * 4);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = randomAffine();
+    Matrix4 base = randomAffine();
+
+    OptimisedUtil* util = OptimisedUtil::getImplementation();
+    run.setItemsPerIteration(src.size());
+    while (run.next())
+    {
+        util->concatenateAffineMatrices(base, &src[0], &dest[0], src.size());
+        benchmarkUse(&dest[0]);
+    }
+}
+
+OGRE_BENCHMARK(OptimisedUtil_transformPoints)
+{
+    std::vector<float> src(NUM_VERTICES * 3), dest(NUM_VERTICES * 3);
+    fillRandom(src, 10);
+    Matrix4 m = randomAffine();
+
+    OptimisedUtil* util = OptimisedUtil::getImplementation();
+    run.setItemsPerIteration(NUM_VERTICES);
+    while (run.next())
+    {
+        util->transformPoints(m, &src[0], &dest[0], 12, 12, NUM_VERTICES);
+        benchmarkUse(&dest[0]);
+    }
+}
+
+OGRE_BENCHMARK(OptimisedUtil_calculateFaceNormals)
+{
+    std::vector<float> positions(NUM_VERTICES * 3);
+    fillRandom(positions, 10);
+    const size_t numTriangles = NUM_VERTICES * 2;
+    std::vector<EdgeData::Triangle> triangles(numTriangles);
+    for (size_t i = 0; i < numTriangles; ++i)
+    {
+        for (size_t c = 0; c < 3; ++c)
+        {
+            triangles[i].vertIndex[c] = (size_t)Math::RangeRandom(0, NUM_VERTICES - 1);
+            triangles[i].sharedVertIndex[c] = triangles[i].vertIndex[c];
+        }
+    }
+    EdgeData::TriangleFaceNormalList normals(numTriangles);
+
+    OptimisedUtil* util = OptimisedUtil::getImplementation();
+    run.setItemsPerIteration(numTriangles);
+    while (run.next())
+    {
+        util->calculateFaceNormals(&positions[0], &triangles[0], &normals[0], numTriangles);
+        benchmarkUse(&normals[0]);
+    }
+}
+
+OGRE_BENCHMARK(OptimisedUtil_cullBoxes)
+{
+    const size_t numBoxes = 4096;
+    std::vector<float> centreX(numBoxes), centreY(numBoxes), centreZ(numBoxes);
+    std::vector<float> halfX(numBoxes), halfY(numBoxes), halfZ(numBoxes);
+    fillRandom(centreX, 100);
+    fillRandom(centreY, 100);
+    fillRandom(centreZ, 100);
+    fillRandom(halfX, 5);
+    fillRandom(halfY, 5);
+    fillRandom(halfZ, 5);
+    for (size_t i = 0; i < numBoxes; ++i)
+    {
+        halfX[i] = Math::Abs(halfX[i]);
+        halfY[i] = Math::Abs(halfY[i]);
+        halfZ[i] = Math::Abs(halfZ[i]);
+    }
+    // A frustum-like set of planes around the origin
+    Plane planes[6] = {
+        Plane(Vector3(1, 0, 0.5f).normalisedCopy(), -10), Plane(Vector3(-1, 0, 0.5f).normalisedCopy(), -10),
+        Plane(Vector3(0, 1, 0.5f).normalisedCopy(), -10), Plane(Vector3(0, -1, 0.5f).normalisedCopy(), -10),
+        Plane(Vector3::UNIT_Z, 50), Plane(Vector3::NEGATIVE_UNIT_Z, 50) };
+    std::vector<uint8> results(numBoxes);
+
+    OptimisedUtil* util = OptimisedUtil::getImplementation();
+    run.setItemsPerIteration(numBoxes);
+    while (run.next())
+    {
+        util->cullBoxes(planes, 6, &centreX[0], &centreY[0], &centreZ[0],
+            &halfX[0], &halfY[0], &halfZ[0], &results[0], numBoxes);
+        benchmarkUse(&results[0]);
+    }
+}
+
+OGRE_BENCHMARK(OptimisedUtil_shufflePixels)
+{
+    const size_t numPixels = 256 * 256;
+    std::vector<uint8> src(numPixels * 3), dest(numPixels * 4);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = (uint8)i;
+    // R8G8B8 to A8B8G8R8
+    const int8 shuffle[4] = { 2, 1, 0, -1 };
+
+    OptimisedUtil* util = OptimisedUtil::getImplementation();
+    run.setItemsPerIteration(numPixels);
+    run.setBytesPerIteration(dest.size());
+    while (run.next())
+    {
+        util->shufflePixels(&src[0], 3, &dest[0], 4, shuffle, numPixels);
+        benchmarkUse(&dest[0]);
+    }
+}
+
+OGRE_BENCHMARK(OptimisedUtil_convertHalfToFloat)
+{
+    const size_t count = 256 * 256;
+    std::vector<uint16> src(count);
+    std::vector<float> dest(count);
+    for (size_t i = 0; i < count; ++i)
+        src[i] = (uint16)(i * 7);
+
+    OptimisedUtil* util = OptimisedUtil::getImplementation();
+    run.setItemsPerIteration(count);
+    while (run.next())
+    {
+        util->convertHalfToFloat(&src[0], &dest[0], count);
+        benchmarkUse(&dest[0]);
+    }
+}
@@ -0,0 +1,104 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "Benchmark.h"
+
+#include "OgreRadixSort.h"
+#include "OgreMath.h"
+
+using namespace Ogre;
+
+namespace {
+    const size_t COUNT = 10000;
+
+    struct FloatKey
+    {
+        float operator()(const float& p) const { return p; }
+    };
+
+    struct UnsignedIntKey
+    {
+        uint32 operator()(const uint32& p) const { return p; }
+    };
+
+    /// An element sorted by a key within it, like the render queue sorts renderables
+    struct Entry
+    {
+        float depth;
+        void* data;
+    };
+    struct EntryKey
+    {
+        float operator()(const Entry& p) const { return p.depth; }
+    };
+
+    template <class Container, class Value, class Key, class Function>
+    void benchmarkSort(BenchmarkRun& run, const Container& unsorted, Function key)
+    {
+        RadixSort<Container, Value, Key> sorter;
+        Container values;
+        run.setItemsPerIteration(unsorted.size());
+        while (run.next())
+        {
+            // Sort the same unsorted data each time
+            run.pauseTiming();
+            values = unsorted;
+            run.resumeTiming();
+
+            sorter.sort(values, key);
+            benchmarkUse(&values.front());
+        }
+    }
+}
+
+OGRE_BENCHMARK(RadixSort_float)
+{
+    std::vector<float> values(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+        values[i] = Math::SymmetricRandom() * 1000;
+    benchmarkSort<std::vector<float>, float, float>(run, values, FloatKey());
+}
+
+OGRE_BENCHMARK(RadixSort_uint32)
+{
+    std::vector<uint32> values(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+        values[i] = (uint32)(Math::UnitRandom() * 0xFFFFFFFFu);
+    benchmarkSort<std::vector<uint32>, uint32, uint32>(run, values, UnsignedIntKey());
+}
+
+OGRE_BENCHMARK(RadixSort_structByFloat)
+{
+    std::vector<Entry> values(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        values[i].depth = Math::UnitRandom() * 1000;
+        values[i].data = &values[i];
+    }
+    benchmarkSort<std::vector<Entry>, Entry, float>(run, values, EntryKey());
+}
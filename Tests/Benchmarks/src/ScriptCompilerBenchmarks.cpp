@@ -0,0 +1,112 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "Benchmark.h"
+
+#include "OgreScriptCompiler.h"
+#include "OgreScriptLexer.h"
+#include "OgreScriptParser.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreStringConverter.h"
+
+using namespace Ogre;
+
+namespace {
+    const size_t NUM_MATERIALS = 200;
+    const char* const SOURCE = "Benchmark.material";
+    const char* const GROUP = "Benchmark";
+
+    /// Materials with a few passes of colour and state parameters
+    String createScript()
+    {
+        StringStream script;
+        for (size_t i = 0; i < NUM_MATERIALS; ++i)
+        {
+            script << "material Benchmark/Material" << i << "\n"
+                "{\n"
+                "    technique\n"
+                "    {\n"
+                "        pass\n"
+                "        {\n"
+                "            ambient 0.1 0.1 0.1\n"
+                "            diffuse " << (i % 10) / 10.0 << " 0.5 0.5 1\n"
+                "            specular 1 1 1 1 " << 10 + i % 50 << "\n"
+                "            depth_bias " << i % 4 << "\n"
+                "            cull_hardware anticlockwise\n"
+                "        }\n"
+                "        pass\n"
+                "        {\n"
+                "            lighting off\n"
+                "            scene_blend add\n"
+                "            depth_write off\n"
+                "            emissive 0.2 0.2 " << (i % 5) / 5.0 << "\n"
+                "        }\n"
+                "    }\n"
+                "}\n";
+        }
+        return script.str();
+    }
+}
+
+OGRE_BENCHMARK(ScriptCompiler_parse)
+{
+    String script = createScript();
+
+    run.setItemsPerIteration(NUM_MATERIALS);
+    run.setBytesPerIteration(script.size());
+    while (run.next())
+    {
+        ScriptLexer lexer;
+        ScriptParser parser;
+        ConcreteNodeListPtr nodes = parser.parse(lexer.tokenize(script, SOURCE));
+        benchmarkUse(nodes.get());
+    }
+}
+
+OGRE_BENCHMARK(ScriptCompiler_compile)
+{
+    String script = createScript();
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    if (!rgm.resourceGroupExists(GROUP))
+        rgm.createResourceGroup(GROUP);
+
+    run.setItemsPerIteration(NUM_MATERIALS);
+    run.setBytesPerIteration(script.size());
+    while (run.next())
+    {
+        ScriptCompiler compiler;
+        compiler.compile(script, SOURCE, GROUP);
+
+        // Destroying the materials is not part of the compilation
+        run.pauseTiming();
+        rgm.clearResourceGroup(GROUP);
+        run.resumeTiming();
+    }
+
+    rgm.destroyResourceGroup(GROUP);
+}
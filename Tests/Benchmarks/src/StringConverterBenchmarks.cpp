@@ -0,0 +1,143 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "Benchmark.h"
+
+#include "OgreStringConverter.h"
+#include "OgreMath.h"
+
+using namespace Ogre;
+
+namespace {
+    const size_t COUNT = 1000;
+
+    template <typename Value>
+    std::vector<String> toStrings(const std::vector<Value>& values)
+    {
+        std::vector<String> strings;
+        for (size_t i = 0; i < values.size(); ++i)
+            strings.push_back(StringConverter::toString(values[i]));
+        return strings;
+    }
+}
+
+OGRE_BENCHMARK(StringConverter_parseReal)
+{
+    std::vector<Real> values(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+        values[i] = Math::SymmetricRandom() * 1000;
+    std::vector<String> strings = toStrings(values);
+
+    run.setItemsPerIteration(COUNT);
+    while (run.next())
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+            values[i] = StringConverter::parseReal(strings[i]);
+        benchmarkUse(&values[0]);
+    }
+}
+
+OGRE_BENCHMARK(StringConverter_parseInt)
+{
+    std::vector<int> values(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+        values[i] = (int)(Math::SymmetricRandom() * 100000);
+    std::vector<String> strings = toStrings(values);
+
+    run.setItemsPerIteration(COUNT);
+    while (run.next())
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+            values[i] = StringConverter::parseInt(strings[i]);
+        benchmarkUse(&values[0]);
+    }
+}
+
+OGRE_BENCHMARK(StringConverter_parseBool)
+{
+    std::vector<String> strings(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+        strings[i] = i % 3 ? "true" : "off";
+    std::vector<char> values(COUNT);
+
+    run.setItemsPerIteration(COUNT);
+    while (run.next())
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+            values[i] = StringConverter::parseBool(strings[i]);
+        benchmarkUse(&values[0]);
+    }
+}
+
+OGRE_BENCHMARK(StringConverter_parseVector3)
+{
+    std::vector<Vector3> values(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+        values[i] = Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(), Math::SymmetricRandom()) * 100;
+    std::vector<String> strings = toStrings(values);
+
+    run.setItemsPerIteration(COUNT);
+    while (run.next())
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+            values[i] = StringConverter::parseVector3(strings[i]);
+        benchmarkUse(&values[0]);
+    }
+}
+
+OGRE_BENCHMARK(StringConverter_parseColourValue)
+{
+    std::vector<ColourValue> values(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+        values[i] = ColourValue(Math::UnitRandom(), Math::UnitRandom(), Math::UnitRandom(), Math::UnitRandom());
+    std::vector<String> strings = toStrings(values);
+
+    run.setItemsPerIteration(COUNT);
+    while (run.next())
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+            values[i] = StringConverter::parseColourValue(strings[i]);
+        benchmarkUse(&values[0]);
+    }
+}
+
+OGRE_BENCHMARK(StringConverter_toStringReal)
+{
+    std::vector<Real> values(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+        values[i] = Math::SymmetricRandom() * 1000;
+    std::vector<String> strings(COUNT);
+
+    run.setItemsPerIteration(COUNT);
+    while (run.next())
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+            strings[i] = StringConverter::toString(values[i]);
+        benchmarkUse(&strings[0]);
+    }
+}
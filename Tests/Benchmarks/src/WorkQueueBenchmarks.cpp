@@ -0,0 +1,116 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "Benchmark.h"
+
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
+
+using namespace Ogre;
+
+namespace {
+    const size_t NUM_REQUESTS = 1000;
+
+    /// Echoes the data of each request back, and counts the responses
+    class EchoHandler : public WorkQueue::RequestHandler, public WorkQueue::ResponseHandler
+    {
+    public:
+        size_t mResponses;
+
+        EchoHandler() : mResponses(0) {}
+
+        WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+        {
+            return OGRE_NEW WorkQueue::Response(req, true, req->getData());
+        }
+
+        void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
+        {
+            ++mResponses;
+        }
+    };
+
+    class SumTask : public WorkQueue::ParallelTask
+    {
+    public:
+        const std::vector<float>& mValues;
+        std::vector<float>& mResults;
+
+        SumTask(const std::vector<float>& values, std::vector<float>& results)
+            : mValues(values), mResults(results) {}
+
+        void execute(size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                mResults[i] = mValues[i] * mValues[i] + 1.0f;
+        }
+    };
+}
+
+OGRE_BENCHMARK(WorkQueue_requestResponse)
+{
+    WorkQueue* queue = Root::getSingleton().getWorkQueue();
+    uint16 channel = queue->getChannel("Benchmark");
+    EchoHandler handler;
+    queue->addRequestHandler(channel, &handler);
+    queue->addResponseHandler(channel, &handler);
+
+    // Handle all the responses ready on each call
+    unsigned long timeLimit = queue->getResponseProcessingTimeLimit();
+    queue->setResponseProcessingTimeLimit(0);
+
+    run.setItemsPerIteration(NUM_REQUESTS);
+    while (run.next())
+    {
+        handler.mResponses = 0;
+        for (size_t i = 0; i < NUM_REQUESTS; ++i)
+            queue->addRequest(channel, 0, Any(i));
+        while (handler.mResponses < NUM_REQUESTS)
+            queue->processResponses();
+    }
+
+    queue->setResponseProcessingTimeLimit(timeLimit);
+    queue->removeResponseHandler(channel, &handler);
+    queue->removeRequestHandler(channel, &handler);
+}
+
+OGRE_BENCHMARK(WorkQueue_parallelFor)
+{
+    const size_t count = 1 << 20;
+    std::vector<float> values(count, 2.0f);
+    std::vector<float> results(count);
+    SumTask task(values, results);
+    WorkQueue* queue = Root::getSingleton().getWorkQueue();
+
+    run.setItemsPerIteration(count);
+    while (run.next())
+    {
+        queue->parallelFor(count, 4096, &task);
+        benchmarkUse(&results[0]);
+    }
+}
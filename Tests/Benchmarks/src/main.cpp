@@ -0,0 +1,278 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+// Runs the OgreMain micro-benchmarks and writes their results as JSON.
+//
+// Usage: OgreBenchmarks [--filter text] [--output file] [--min-time seconds]
+//                       [--repetitions count] [--list]
+
+#include "Benchmark.h"
+
+#include "OgreRoot.h"
+#include "OgreLogManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreWorkQueue.h"
+#include "OgreStringConverter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using namespace Ogre;
+
+namespace {
+    struct Options
+    {
+        String filter;
+        String output;
+        double minTime;
+        size_t repetitions;
+        bool list;
+
+        Options() : minTime(0.1), repetitions(5), list(false) {}
+    };
+
+    struct Result
+    {
+        const char* name;
+        size_t iterations;
+        /// Nanoseconds per iteration of each repetition, sorted
+        std::vector<double> times;
+        size_t itemsPerIteration;
+        size_t bytesPerIteration;
+    };
+
+    void usage()
+    {
+        std::cerr << "Usage: OgreBenchmarks [--filter text] [--output file] "
+            "[--min-time seconds] [--repetitions count] [--list]" << std::endl;
+    }
+
+    bool parseOptions(int argc, char* argv[], Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            String arg = argv[i];
+            if (arg == "--list")
+            {
+                options.list = true;
+                continue;
+            }
+            if (i + 1 == argc)
+                return false;
+
+            String value = argv[++i];
+            if (arg == "--filter")
+                options.filter = value;
+            else if (arg == "--output")
+                options.output = value;
+            else if (arg == "--min-time")
+                options.minTime = std::max(StringConverter::parseReal(value), Real(0.001));
+            else if (arg == "--repetitions")
+                options.repetitions = std::max(StringConverter::parseUnsignedInt(value), 1u);
+            else
+                return false;
+        }
+        return true;
+    }
+
+    /// Run a benchmark once with the given number of iterations
+    void runOnce(const BenchmarkInfo& benchmark, size_t iterations, BenchmarkRun& run)
+    {
+        benchmark.function(run);
+        if (run.getIterationsDone() != iterations)
+        {
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                String("Benchmark ") + benchmark.name + " did not loop on BenchmarkRun::next",
+                "runOnce");
+        }
+    }
+
+    Result runBenchmark(const BenchmarkInfo& benchmark, const Options& options)
+    {
+        const double minMicroseconds = options.minTime * 1000000.0;
+
+        // Find how many iterations take the minimum time
+        size_t iterations = 1;
+        while (true)
+        {
+            BenchmarkRun run(iterations);
+            runOnce(benchmark, iterations, run);
+
+            double elapsed = (double)run.getElapsed();
+            if (elapsed >= minMicroseconds || iterations >= 1000000000)
+                break;
+            double scale = elapsed > 0 ? std::min(1.4 * minMicroseconds / elapsed, 10.0) : 10.0;
+            iterations = std::max(iterations + 1, (size_t)(iterations * scale));
+        }
+
+        Result result;
+        result.name = benchmark.name;
+        result.iterations = iterations;
+        result.itemsPerIteration = 0;
+        result.bytesPerIteration = 0;
+        for (size_t r = 0; r < options.repetitions; ++r)
+        {
+            BenchmarkRun run(iterations);
+            runOnce(benchmark, iterations, run);
+            result.times.push_back(run.getElapsed() * 1000.0 / iterations);
+            result.itemsPerIteration = run.getItemsPerIteration();
+            result.bytesPerIteration = run.getBytesPerIteration();
+        }
+        std::sort(result.times.begin(), result.times.end());
+        return result;
+    }
+
+    String formatNumber(double value)
+    {
+        char buffer[64];
+        sprintf(buffer, "%.6g", value);
+        return buffer;
+    }
+
+    void writeJson(std::ostream& out, const Options& options, const std::vector<Result>& results)
+    {
+        out << "{\n";
+        out << "  \"context\": {\n";
+        out << "    \"ogre_version\": \"" << OGRE_VERSION_MAJOR << "." << OGRE_VERSION_MINOR
+            << "." << OGRE_VERSION_PATCH << "\",\n";
+        out << "    \"architecture_bits\": " << (OGRE_ARCH_TYPE == OGRE_ARCHITECTURE_64 ? 64 : 32) << ",\n";
+        out << "    \"debug\": " << (OGRE_DEBUG_MODE ? "true" : "false") << ",\n";
+        out << "    \"double_precision\": " << (OGRE_DOUBLE_PRECISION ? "true" : "false") << ",\n";
+        out << "    \"threads\": " << (OGRE_THREAD_SUPPORT ? "true" : "false") << ",\n";
+        out << "    \"min_time\": " << formatNumber(options.minTime) << ",\n";
+        out << "    \"repetitions\": " << options.repetitions << "\n";
+        out << "  },\n";
+        out << "  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& result = results[i];
+            double mean = 0;
+            for (size_t r = 0; r < result.times.size(); ++r)
+                mean += result.times[r];
+            mean /= result.times.size();
+            double median = result.times[result.times.size() / 2];
+
+            out << (i ? ",\n" : "\n");
+            out << "    {\n";
+            out << "      \"name\": \"" << result.name << "\",\n";
+            out << "      \"iterations\": " << result.iterations << ",\n";
+            out << "      \"ns_per_iteration_min\": " << formatNumber(result.times.front()) << ",\n";
+            out << "      \"ns_per_iteration_median\": " << formatNumber(median) << ",\n";
+            out << "      \"ns_per_iteration_mean\": " << formatNumber(mean) << ",\n";
+            out << "      \"ns_per_iteration_max\": " << formatNumber(result.times.back());
+            // Throughput from the median, which is steadier than the mean
+            if (result.itemsPerIteration && median > 0)
+            {
+                out << ",\n      \"items_per_second\": "
+                    << formatNumber(result.itemsPerIteration * 1e9 / median);
+            }
+            if (result.bytesPerIteration && median > 0)
+            {
+                out << ",\n      \"bytes_per_second\": "
+                    << formatNumber(result.bytesPerIteration * 1e9 / median);
+            }
+            out << "\n    }";
+        }
+        out << "\n  ]\n";
+        out << "}\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        usage();
+        return 1;
+    }
+
+    BenchmarkList& benchmarks = getBenchmarks();
+    if (options.list)
+    {
+        for (BenchmarkList::iterator i = benchmarks.begin(); i != benchmarks.end(); ++i)
+            std::cout << i->name << std::endl;
+        return 0;
+    }
+
+    // Keep the log out of the console, so the JSON can go to stdout
+    LogManager* logManager = OGRE_NEW LogManager();
+    logManager->createLog("OgreBenchmarks.log", true, false, false);
+
+    // No render system is needed, the buffers of meshes live in system memory
+    Root* root = OGRE_NEW Root("", "", "");
+    DefaultHardwareBufferManager* bufferManager = OGRE_NEW DefaultHardwareBufferManager();
+    MaterialManager::getSingleton().initialise();
+    root->getWorkQueue()->startup();
+
+    std::vector<Result> results;
+    int status = 0;
+    try
+    {
+        for (BenchmarkList::iterator i = benchmarks.begin(); i != benchmarks.end(); ++i)
+        {
+            if (!options.filter.empty() && !strstr(i->name, options.filter.c_str()))
+                continue;
+
+            std::cerr << i->name << "... " << std::flush;
+            results.push_back(runBenchmark(*i, options));
+            std::cerr << formatNumber(results.back().times[results.back().times.size() / 2])
+                << " ns" << std::endl;
+        }
+    }
+    catch (Exception& e)
+    {
+        std::cerr << std::endl << e.getFullDescription() << std::endl;
+        status = 1;
+    }
+
+    if (options.output.empty())
+    {
+        writeJson(std::cout, options, results);
+    }
+    else
+    {
+        std::ofstream out(options.output.c_str());
+        writeJson(out, options, results);
+        if (!out)
+        {
+            std::cerr << "Could not write " << options.output << std::endl;
+            status = 1;
+        }
+    }
+
+    root->getWorkQueue()->shutdown();
+    OGRE_DELETE root;
+    OGRE_DELETE bufferManager;
+    OGRE_DELETE logManager;
+    return status;
+}
@@ -46,6 +46,8 @@ class MeshLodTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testLodConfigSerializer);
     CPPUNIT_TEST(testMeshLodGenerator);
     CPPUNIT_TEST(testManualLodLevels);
+    CPPUNIT_TEST(testBatchLodGeneration);
+    CPPUNIT_TEST(testLodCache);
     CPPUNIT_TEST_SUITE_END();
 
 #ifdef OGRE_STATIC_LIB
@@ -59,6 +61,8 @@ public:
     void testLodConfigSerializer();
     void testMeshLodGenerator();
     void testManualLodLevels();
+    void testBatchLodGeneration();
+    void testLodCache();
     void testQuadricError();
     void runMeshLodConfigTests(LodConfig::Advanced& advanced);
     void blockedWaitForLodGeneration(const MeshPtr& mesh);
@@ -17,6 +17,7 @@
 #include "OgreLodCollapseCostQuadric.h"
 #include "OgreRenderWindow.h"
 #include "OgreLodConfigSerializer.h"
+#include "OgreLodCache.h"
 #include "OgreWorkQueue.h"
 
 #include "UnitTestSuite.h"
@@ -234,6 +235,69 @@ void MeshLodTests::testManualLodLevels()
     gen.generateLodLevels(config, LodCollapseCostPtr(new LodCollapseCostQuadric()));
 }
 //--------------------------------------------------------------------------
+void MeshLodTests::testBatchLodGeneration()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    MeshLodGenerator& gen = MeshLodGenerator::getSingleton();
+    LodConfig config;
+    setTestLodConfig(config);
+    gen.generateLodLevels(config);
+
+    MeshLodGenerator::LodConfigList configs(2, config);
+    configs[1].advanced.useCompression = false;
+    gen.generateLodLevelsBatch(configs);
+    CPPUNIT_ASSERT(mMesh->getNumLodLevels() != 1);
+    for (size_t c = 0; c < configs.size(); c++)
+    {
+        CPPUNIT_ASSERT(config.levels.size() == configs[c].levels.size());
+        for (size_t i = 0; i < config.levels.size(); i++)
+        {
+            CPPUNIT_ASSERT(config.levels[i].outSkipped == configs[c].levels[i].outSkipped);
+            CPPUNIT_ASSERT(config.levels[i].outUniqueVertexCount == configs[c].levels[i].outUniqueVertexCount);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void MeshLodTests::testLodCache()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    MeshLodGenerator& gen = MeshLodGenerator::getSingleton();
+    LodCache cache;
+    gen.setLodCache(&cache);
+    LodConfig config;
+    setTestLodConfig(config);
+    gen.generateLodLevels(config);
+    CPPUNIT_ASSERT(cache.getEntryCount() == 1);
+    CPPUNIT_ASSERT(cache.isDirty());
+    ushort lodCount = mMesh->getNumLodLevels();
+
+    // Round trip through a stream, then inject from the loaded cache.
+    MemoryDataStream* memStream = OGRE_NEW MemoryDataStream(1024 * 1024, true);
+    DataStreamPtr stream(memStream);
+    cache.save(stream);
+    CPPUNIT_ASSERT(!cache.isDirty());
+    LodCache loadedCache;
+    DataStreamPtr readStream(OGRE_NEW MemoryDataStream(memStream->getPtr(), memStream->tell(), false, true));
+    loadedCache.load(readStream);
+    CPPUNIT_ASSERT(loadedCache.getEntryCount() == 1);
+
+    gen.setLodCache(&loadedCache);
+    mMesh->removeLodLevels();
+    LodConfig config2;
+    setTestLodConfig(config2);
+    gen.generateLodLevels(config2);
+    gen.setLodCache(NULL);
+    CPPUNIT_ASSERT(!loadedCache.isDirty());
+    CPPUNIT_ASSERT(mMesh->getNumLodLevels() == lodCount);
+    for (size_t i = 0; i < config.levels.size(); i++)
+    {
+        CPPUNIT_ASSERT(config.levels[i].outSkipped == config2.levels[i].outSkipped);
+        CPPUNIT_ASSERT(config.levels[i].outUniqueVertexCount == config2.levels[i].outUniqueVertexCount);
+    }
+}
+//--------------------------------------------------------------------------
 void MeshLodTests::testQuadricError()
 {
     UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
@@ -44,6 +44,7 @@ class MeshSerializerTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testMesh_XML);
     CPPUNIT_TEST(testSkeleton_Version_1_8);
     CPPUNIT_TEST(testSkeleton_Version_1_0);
+    CPPUNIT_TEST(testSkeleton_Compressed);
     CPPUNIT_TEST(testMesh_clone);
     CPPUNIT_TEST(testMesh_Version_1_10);
     CPPUNIT_TEST(testMesh_Version_1_8);
@@ -67,6 +68,7 @@ public:
     void tearDown();
     void testSkeleton_Version_1_8();
     void testSkeleton_Version_1_0();
+    void testSkeleton_Compressed();
     void testMesh_clone();
     void testMesh_Version_1_10();
     void testMesh_Version_1_8();
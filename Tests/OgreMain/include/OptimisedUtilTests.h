@@ -0,0 +1,71 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __OptimisedUtilTests_H__
+#define __OptimisedUtilTests_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class OptimisedUtilTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE(OptimisedUtilTests);
+    CPPUNIT_TEST(testSoftwareVertexSkinningDualQuaternion);
+    CPPUNIT_TEST(testTransformPoints);
+    CPPUNIT_TEST(testTransformDirections);
+    CPPUNIT_TEST(testCullBoxes);
+    CPPUNIT_TEST(testCullSpheres);
+    CPPUNIT_TEST(testIntersectBoxes);
+    CPPUNIT_TEST(testIntersectSpheres);
+    CPPUNIT_TEST(testNlerpQuaternions);
+    CPPUNIT_TEST(testShufflePixels);
+    CPPUNIT_TEST(testHalfConversions);
+    CPPUNIT_TEST(testSumWeightedRows);
+    CPPUNIT_TEST(testConvertFloatToByte);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testSoftwareVertexSkinningDualQuaternion();
+    void testTransformPoints();
+    void testTransformDirections();
+    void testCullBoxes();
+    void testCullSpheres();
+    void testIntersectBoxes();
+    void testIntersectSpheres();
+    void testNlerpQuaternions();
+    void testShufflePixels();
+    void testHalfConversions();
+    void testSumWeightedRows();
+    void testConvertFloatToByte();
+};
+
+#endif
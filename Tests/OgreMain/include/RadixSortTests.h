@@ -42,6 +42,9 @@ class RadixSortTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testIntList);
     CPPUNIT_TEST(testUnsignedIntVector);
     CPPUNIT_TEST(testIntVector);
+    CPPUNIT_TEST(testUInt64Vector);
+    CPPUNIT_TEST(testNearlySortedFloatVector);
+    CPPUNIT_TEST(testSharedBytesIntVector);
     CPPUNIT_TEST_SUITE_END();
 
 protected:
@@ -56,6 +59,9 @@ public:
     void testIntList();
     void testUnsignedIntVector();
     void testIntVector();
+    void testUInt64Vector();
+    void testNearlySortedFloatVector();
+    void testSharedBytesIntVector();
 };
 
 #endif
\ No newline at end of file
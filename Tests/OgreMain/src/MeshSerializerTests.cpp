@@ -45,6 +45,9 @@ THE SOFTWARE.
 #include "OgreMaterialManager.h"
 #include "OgreLodStrategyManager.h"
 #include "OgreSkeleton.h"
+#include "OgreAnimation.h"
+#include "OgreAnimationTrack.h"
+#include "OgreKeyFrame.h"
 
 #include "UnitTestSuite.h"
 
@@ -216,6 +219,38 @@ void MeshSerializerTests::testSkeleton_Version_1_0()
     }
 }
 //--------------------------------------------------------------------------
+void MeshSerializerTests::testSkeleton_Compressed()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    if (!mSkeleton.isNull()) {
+        Animation* anim = mSkeleton->getAnimation(0);
+        NodeAnimationTrack* track = anim->getNodeTrackIterator().getNext();
+        TransformKeyFrame orig(0, 0);
+        track->getInterpolatedKeyFrame(anim->_getTimeIndex(anim->getLength() * 0.3f), &orig);
+
+        // Compressed tracks are only written as such from version 1.10 on
+        SkeletonVersion versions[] = { SKELETON_VERSION_1_8, SKELETON_VERSION_1_10 };
+        for (size_t v = 0; v < sizeof(versions) / sizeof(versions[0]); ++v) {
+            for (unsigned short i = 0; i < mSkeleton->getNumAnimations(); ++i) {
+                mSkeleton->getAnimation(i)->compressNodeTracks();
+            }
+            SkeletonSerializer skeletonSerializer;
+            skeletonSerializer.exportSkeleton(mSkeleton.get(), mSkeletonFullPath, versions[v]);
+            mSkeleton->reload();
+
+            anim = mSkeleton->getAnimation(0);
+            track = anim->getNodeTrack(track->getHandle());
+            CPPUNIT_ASSERT_EQUAL(versions[v] == SKELETON_VERSION_1_10, track->isCompressed());
+            TransformKeyFrame kf(0, 0);
+            track->getInterpolatedKeyFrame(anim->_getTimeIndex(anim->getLength() * 0.3f), &kf);
+            CPPUNIT_ASSERT(kf.getRotation().equals(orig.getRotation(), Radian(1e-3f)));
+            CPPUNIT_ASSERT(kf.getTranslate().positionEquals(orig.getTranslate()));
+            CPPUNIT_ASSERT(kf.getScale().positionEquals(orig.getScale()));
+        }
+    }
+}
+//--------------------------------------------------------------------------
 void MeshSerializerTests::testMesh_Version_1_10()
 {
     UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
@@ -0,0 +1,549 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OptimisedUtilTests.h"
+#include "OgreOptimisedUtil.h"
+#include "OgrePlane.h"
+#include "OgreAxisAlignedBox.h"
+#include "OgreSphere.h"
+#include "OgreRay.h"
+#include "OgreQuaternion.h"
+#include "OgreDualQuaternion.h"
+#include "OgreMatrix4.h"
+#include "OgreMath.h"
+#include "OgreBitwise.h"
+
+#include "UnitTestSuite.h"
+
+#include <limits>
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(OptimisedUtilTests);
+
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::tearDown()
+{
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testSoftwareVertexSkinningDualQuaternion()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const size_t numBones = 6;
+    DualQuaternion bones[numBones];
+    const DualQuaternion* blendDualQuaternions[numBones];
+    for (size_t b = 0; b < numBones; ++b)
+    {
+        Quaternion q(Degree(Math::RangeRandom(-180, 180)),
+            Vector3(Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1), 1).normalisedCopy());
+        bones[b] = DualQuaternion(q, Vector3(Math::RangeRandom(-5, 5),
+            Math::RangeRandom(-5, 5), Math::RangeRandom(-5, 5)));
+        // Both signs are the same transform, blending must bring them together
+        if (b % 2)
+        {
+            for (size_t c = 0; c < 8; ++c)
+                bones[b][c] = -bones[b][c];
+        }
+        blendDualQuaternions[b] = &bones[b];
+    }
+
+    const size_t numVertices = 37;
+    float positions[numVertices * 3], normals[numVertices * 3];
+    float destPositions[numVertices * 3], destNormals[numVertices * 3];
+    float weights[numVertices * 2];
+    unsigned char indices[numVertices * 2];
+    for (size_t i = 0; i < numVertices; ++i)
+    {
+        Vector3 normal(Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1), 1);
+        normal.normalise();
+        for (size_t c = 0; c < 3; ++c)
+        {
+            positions[i * 3 + c] = Math::RangeRandom(-10, 10);
+            normals[i * 3 + c] = normal[c];
+        }
+        weights[i * 2 + 0] = Math::UnitRandom();
+        weights[i * 2 + 1] = 1 - weights[i * 2 + 0];
+        indices[i * 2 + 0] = static_cast<unsigned char>(i % numBones);
+        indices[i * 2 + 1] = static_cast<unsigned char>((i * 7 + 1) % numBones);
+    }
+
+    OptimisedUtil::getImplementation()->softwareVertexSkinningDualQuaternion(
+        positions, destPositions, normals, destNormals,
+        weights, indices, blendDualQuaternions,
+        3 * sizeof(float), 3 * sizeof(float), 3 * sizeof(float), 3 * sizeof(float),
+        2 * sizeof(float), 2, 2, numVertices);
+
+    for (size_t i = 0; i < numVertices; ++i)
+    {
+        // Blend in the hemisphere of the first bone, normalise and convert
+        // to a matrix to check against
+        const DualQuaternion& first = bones[indices[i * 2]];
+        DualQuaternion blended(0, 0, 0, 0, 0, 0, 0, 0);
+        for (size_t k = 0; k < 2; ++k)
+        {
+            const DualQuaternion& dq = bones[indices[i * 2 + k]];
+            Real weight = weights[i * 2 + k];
+            if (dq.w * first.w + dq.x * first.x + dq.y * first.y + dq.z * first.z < 0)
+                weight = -weight;
+            for (size_t c = 0; c < 8; ++c)
+                blended[c] += dq[c] * weight;
+        }
+        Real length = Math::Sqrt(blended.w * blended.w + blended.x * blended.x +
+            blended.y * blended.y + blended.z * blended.z);
+        for (size_t c = 0; c < 8; ++c)
+            blended[c] /= length;
+
+        Matrix4 transform;
+        blended.toTransformationMatrix(transform);
+        Matrix3 rotation;
+        transform.extract3x3Matrix(rotation);
+        Vector3 expectedPosition = transform.transformAffine(Vector3(positions + i * 3));
+        Vector3 expectedNormal = rotation * Vector3(normals + i * 3);
+        for (size_t c = 0; c < 3; ++c)
+        {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedPosition[c], destPositions[i * 3 + c], 1e-3f);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedNormal[c], destNormals[i * 3 + c], 1e-4f);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testTransformPoints()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Matrix4 transform;
+    transform.makeTransform(Vector3(3, -2, 5), Vector3(1, 2, 0.5f),
+        Quaternion(Degree(40), Vector3(1, 1, 0).normalisedCopy()));
+
+    // Interleaved with another 3 floats, like a position and normal buffer
+    const size_t numPoints = 37;
+    const size_t stride = 6 * sizeof(float);
+    float src[numPoints * 6], dest[numPoints * 6];
+    for (size_t i = 0; i < numPoints * 6; ++i)
+    {
+        src[i] = Math::RangeRandom(-10, 10);
+        dest[i] = 0;
+    }
+
+    OptimisedUtil::getImplementation()->transformPoints(transform,
+        src, dest, stride, stride, numPoints);
+
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+        Vector3 expected = transform.transformAffine(
+            Vector3(src[i * 6 + 0], src[i * 6 + 1], src[i * 6 + 2]));
+        for (size_t c = 0; c < 3; ++c)
+        {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[c], dest[i * 6 + c], 1e-4f);
+            // Other data in between is left alone
+            CPPUNIT_ASSERT_EQUAL(0.0f, dest[i * 6 + 3 + c]);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testTransformDirections()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Matrix4 transform;
+    transform.makeTransform(Vector3(3, -2, 5), Vector3(1, 2, 0.5f),
+        Quaternion(Degree(40), Vector3(1, 1, 0).normalisedCopy()));
+    Matrix3 rotationScale;
+    transform.extract3x3Matrix(rotationScale);
+
+    const size_t numDirections = 37;
+    float src[numDirections * 3], dest[numDirections * 3], normalised[numDirections * 3];
+    for (size_t i = 0; i < numDirections * 3; ++i)
+        src[i] = Math::RangeRandom(-1, 1);
+    // Zero length directions are left alone by normalising
+    src[3] = src[4] = src[5] = 0;
+
+    OptimisedUtil::getImplementation()->transformDirections(transform,
+        src, dest, 3 * sizeof(float), 3 * sizeof(float), numDirections, false);
+    OptimisedUtil::getImplementation()->transformDirections(transform,
+        src, normalised, 3 * sizeof(float), 3 * sizeof(float), numDirections, true);
+
+    for (size_t i = 0; i < numDirections; ++i)
+    {
+        Vector3 expected = rotationScale * Vector3(src[i * 3 + 0], src[i * 3 + 1], src[i * 3 + 2]);
+        Vector3 expectedNormalised = expected.normalisedCopy();
+        for (size_t c = 0; c < 3; ++c)
+        {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[c], dest[i * 3 + c], 1e-5f);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedNormalised[c], normalised[i * 3 + c], 1e-5f);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testCullBoxes()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Plane planes[3];
+    planes[0] = Plane(Vector3::UNIT_X, Vector3::ZERO);
+    planes[1] = Plane(Vector3(0, 1, 1).normalisedCopy(), Vector3(0, -5, 0));
+    planes[2] = Plane(Vector3(-1, 0, -2).normalisedCopy(), Vector3(10, 0, 10));
+
+    // Odd count, so that any remainder after the SIMD batches is covered too
+    const size_t numBoxes = 103;
+    float centreX[numBoxes], centreY[numBoxes], centreZ[numBoxes];
+    float halfX[numBoxes], halfY[numBoxes], halfZ[numBoxes];
+    uint8 results[numBoxes];
+    for (size_t i = 0; i < numBoxes; ++i)
+    {
+        centreX[i] = Math::RangeRandom(-20, 20);
+        centreY[i] = Math::RangeRandom(-20, 20);
+        centreZ[i] = Math::RangeRandom(-20, 20);
+        halfX[i] = Math::RangeRandom(0, 5);
+        halfY[i] = Math::RangeRandom(0, 5);
+        halfZ[i] = Math::RangeRandom(0, 5);
+    }
+
+    OptimisedUtil::getImplementation()->cullBoxes(planes, 3,
+        centreX, centreY, centreZ, halfX, halfY, halfZ, results, numBoxes);
+
+    for (size_t i = 0; i < numBoxes; ++i)
+    {
+        Vector3 centre(centreX[i], centreY[i], centreZ[i]);
+        Vector3 halfSize(halfX[i], halfY[i], halfZ[i]);
+        uint8 expected = 1;
+        for (size_t p = 0; p < 3; ++p)
+        {
+            if (planes[p].getSide(centre, halfSize) == Plane::NEGATIVE_SIDE)
+                expected = 0;
+        }
+        CPPUNIT_ASSERT_EQUAL((int)expected, (int)results[i]);
+    }
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testCullSpheres()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Plane planes[3];
+    planes[0] = Plane(Vector3::UNIT_X, Vector3::ZERO);
+    planes[1] = Plane(Vector3(0, 1, 1).normalisedCopy(), Vector3(0, -5, 0));
+    planes[2] = Plane(Vector3(-1, 0, -2).normalisedCopy(), Vector3(10, 0, 10));
+
+    const size_t numSpheres = 103;
+    float centreX[numSpheres], centreY[numSpheres], centreZ[numSpheres];
+    float radius[numSpheres];
+    uint8 results[numSpheres];
+    for (size_t i = 0; i < numSpheres; ++i)
+    {
+        centreX[i] = Math::RangeRandom(-20, 20);
+        centreY[i] = Math::RangeRandom(-20, 20);
+        centreZ[i] = Math::RangeRandom(-20, 20);
+        radius[i] = Math::RangeRandom(0, 5);
+    }
+
+    OptimisedUtil::getImplementation()->cullSpheres(planes, 3,
+        centreX, centreY, centreZ, radius, results, numSpheres);
+
+    for (size_t i = 0; i < numSpheres; ++i)
+    {
+        Vector3 centre(centreX[i], centreY[i], centreZ[i]);
+        uint8 expected = 1;
+        for (size_t p = 0; p < 3; ++p)
+        {
+            if (planes[p].getDistance(centre) < -radius[i])
+                expected = 0;
+        }
+        CPPUNIT_ASSERT_EQUAL((int)expected, (int)results[i]);
+    }
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testIntersectBoxes()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const size_t numBoxes = 103;
+    float centreX[numBoxes], centreY[numBoxes], centreZ[numBoxes];
+    float halfX[numBoxes], halfY[numBoxes], halfZ[numBoxes];
+    float distances[numBoxes];
+    uint8 results[numBoxes];
+    for (size_t i = 0; i < numBoxes; ++i)
+    {
+        centreX[i] = Math::RangeRandom(-20, 20);
+        centreY[i] = Math::RangeRandom(-20, 20);
+        centreZ[i] = Math::RangeRandom(-20, 20);
+        halfX[i] = Math::RangeRandom(0, 5);
+        halfY[i] = Math::RangeRandom(0, 5);
+        halfZ[i] = Math::RangeRandom(0, 5);
+    }
+
+    AxisAlignedBox queryBox(Vector3(-8, -3, -10), Vector3(4, 9, 2));
+    OptimisedUtil::getImplementation()->intersectBoxes(queryBox,
+        centreX, centreY, centreZ, halfX, halfY, halfZ, results, numBoxes);
+    for (size_t i = 0; i < numBoxes; ++i)
+    {
+        Vector3 centre(centreX[i], centreY[i], centreZ[i]);
+        Vector3 halfSize(halfX[i], halfY[i], halfZ[i]);
+        AxisAlignedBox box(centre - halfSize, centre + halfSize);
+        CPPUNIT_ASSERT_EQUAL((int)queryBox.intersects(box), (int)results[i]);
+    }
+
+    Sphere querySphere(Vector3(3, -2, 5), 9);
+    OptimisedUtil::getImplementation()->intersectBoxes(querySphere,
+        centreX, centreY, centreZ, halfX, halfY, halfZ, results, numBoxes);
+    for (size_t i = 0; i < numBoxes; ++i)
+    {
+        Vector3 centre(centreX[i], centreY[i], centreZ[i]);
+        Vector3 halfSize(halfX[i], halfY[i], halfZ[i]);
+        AxisAlignedBox box(centre - halfSize, centre + halfSize);
+        CPPUNIT_ASSERT_EQUAL((int)Math::intersects(querySphere, box), (int)results[i]);
+    }
+
+    // Axis aligned direction, so the parallel slabs are covered too
+    Ray rays[2];
+    rays[0] = Ray(Vector3(-25, 1, -3), Vector3(5, 1, 2).normalisedCopy());
+    rays[1] = Ray(Vector3(0, -25, 0), Vector3::UNIT_Y);
+    for (size_t r = 0; r < 2; ++r)
+    {
+        OptimisedUtil::getImplementation()->intersectBoxes(rays[r],
+            centreX, centreY, centreZ, halfX, halfY, halfZ, distances, results, numBoxes);
+        for (size_t i = 0; i < numBoxes; ++i)
+        {
+            Vector3 centre(centreX[i], centreY[i], centreZ[i]);
+            Vector3 halfSize(halfX[i], halfY[i], halfZ[i]);
+            AxisAlignedBox box(centre - halfSize, centre + halfSize);
+            std::pair<bool, Real> hit = Math::intersects(rays[r], box);
+            CPPUNIT_ASSERT_EQUAL((int)hit.first, (int)results[i]);
+            if (hit.first)
+                CPPUNIT_ASSERT_DOUBLES_EQUAL(hit.second, distances[i], 1e-3f);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testIntersectSpheres()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const size_t numSpheres = 103;
+    float centreX[numSpheres], centreY[numSpheres], centreZ[numSpheres];
+    float radius[numSpheres];
+    uint8 results[numSpheres];
+    for (size_t i = 0; i < numSpheres; ++i)
+    {
+        centreX[i] = Math::RangeRandom(-20, 20);
+        centreY[i] = Math::RangeRandom(-20, 20);
+        centreZ[i] = Math::RangeRandom(-20, 20);
+        radius[i] = Math::RangeRandom(0, 5);
+    }
+
+    Sphere querySphere(Vector3(3, -2, 5), 9);
+    OptimisedUtil::getImplementation()->intersectSpheres(querySphere,
+        centreX, centreY, centreZ, radius, results, numSpheres);
+
+    for (size_t i = 0; i < numSpheres; ++i)
+    {
+        Sphere sphere(Vector3(centreX[i], centreY[i], centreZ[i]), radius[i]);
+        CPPUNIT_ASSERT_EQUAL((int)querySphere.intersects(sphere), (int)results[i]);
+    }
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testNlerpQuaternions()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const size_t numQuaternions = 103;
+    Quaternion from[numQuaternions], to[numQuaternions];
+    float t[numQuaternions];
+    float src1[numQuaternions * 4], src2[numQuaternions * 4], dest[numQuaternions * 4];
+    for (size_t i = 0; i < numQuaternions; ++i)
+    {
+        from[i] = Quaternion(Degree(Math::RangeRandom(-180, 180)),
+            Vector3(Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1), 1).normalisedCopy());
+        to[i] = Quaternion(Degree(Math::RangeRandom(-180, 180)),
+            Vector3(1, Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1)).normalisedCopy());
+        t[i] = Math::UnitRandom();
+        for (size_t c = 0; c < 4; ++c)
+        {
+            src1[i * 4 + c] = from[i][c];
+            src2[i * 4 + c] = to[i][c];
+        }
+    }
+
+    OptimisedUtil::getImplementation()->nlerpQuaternions(t, src1, src2, dest, numQuaternions);
+
+    for (size_t i = 0; i < numQuaternions; ++i)
+    {
+        Quaternion expected = Quaternion::nlerp(t[i], from[i], to[i], true);
+        for (size_t c = 0; c < 4; ++c)
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[c], dest[i * 4 + c], 1e-5f);
+    }
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testShufflePixels()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const size_t numPixels = 77;
+    uint8 src[numPixels * 4], dest[numPixels * 4 + 1];
+    for (size_t i = 0; i < numPixels * 4; ++i)
+        src[i] = (uint8)(i * 37 + 11);
+
+    // Reorders, expansions with opaque alpha and reductions
+    const int8 shuffles[][4] = {
+        { 2, 1, 0, 3 }, { 3, 0, 1, 2 }, { 0, 0, 0, -1 }, { 2, 1, 0, -1 },
+        { 0, 1, 2, 0 }, { 2, 1, 0, 0 }, { 1, 0, 0, 0 }, { 3, 0, 0, 0 }
+    };
+    const size_t pixelSizes[][2] = {
+        { 4, 4 }, { 4, 4 }, { 1, 4 }, { 3, 4 },
+        { 4, 3 }, { 3, 3 }, { 2, 2 }, { 4, 1 }
+    };
+    const size_t numCases = sizeof(shuffles) / sizeof(shuffles[0]);
+
+    for (size_t n = 0; n < numCases; ++n)
+    {
+        const size_t srcPixelSize = pixelSizes[n][0];
+        const size_t destPixelSize = pixelSizes[n][1];
+
+        // Guard byte checks nothing is written past the end
+        memset(dest, 0x5A, sizeof(dest));
+        OptimisedUtil::getImplementation()->shufflePixels(
+            src, srcPixelSize, dest, destPixelSize, shuffles[n], numPixels);
+
+        for (size_t i = 0; i < numPixels; ++i)
+        {
+            for (size_t b = 0; b < destPixelSize; ++b)
+            {
+                const int8 s = shuffles[n][b];
+                const uint8 expected = s < 0 ? 0xFF : src[i * srcPixelSize + s];
+                CPPUNIT_ASSERT_EQUAL((int)expected, (int)dest[i * destPixelSize + b]);
+            }
+        }
+        CPPUNIT_ASSERT_EQUAL(0x5A, (int)dest[numPixels * destPixelSize]);
+    }
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testHalfConversions()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // Every half, including denormals, infinities and NaNs
+    const size_t numHalves = 65536 + 3;
+    vector<uint16>::type halves(numHalves);
+    vector<float>::type floats(numHalves);
+    for (size_t i = 0; i < numHalves; ++i)
+        halves[i] = (uint16)i;
+
+    OptimisedUtil::getImplementation()->convertHalfToFloat(&halves[0], &floats[0], numHalves);
+
+    for (size_t i = 0; i < numHalves; ++i)
+    {
+        union { float f; uint32 i; } expected, actual;
+        expected.f = Bitwise::halfToFloat(halves[i]);
+        actual.f = floats[i];
+        CPPUNIT_ASSERT_EQUAL(expected.i, actual.i);
+    }
+
+    // Floats around every half boundary as well as random bit patterns
+    const size_t numFloats = 4099;
+    vector<float>::type values(numFloats);
+    vector<uint16>::type results(numFloats);
+    const uint32 specials[] = {
+        0x00000000, 0x80000000, 0x00000001, 0x33000000, 0x337FFFFF, 0x38800000,
+        0x387FFFFF, 0x477FE000, 0x477FFFFF, 0x47800000, 0x7F800000, 0xFF800000,
+        0x7F800001, 0x7FC00000, 0xFFFFFFFF, 0x3F800000, 0xC0490FDB
+    };
+    const size_t numSpecials = sizeof(specials) / sizeof(specials[0]);
+    for (size_t i = 0; i < numFloats; ++i)
+    {
+        union { float f; uint32 i; } v;
+        if (i < numSpecials)
+            v.i = specials[i];
+        else
+            v.i = (uint32)(Math::UnitRandom() * 65535) << 16 | (uint32)(Math::UnitRandom() * 65535);
+        values[i] = v.f;
+    }
+
+    OptimisedUtil::getImplementation()->convertFloatToHalf(&values[0], &results[0], numFloats);
+
+    for (size_t i = 0; i < numFloats; ++i)
+        CPPUNIT_ASSERT_EQUAL(Bitwise::floatToHalf(values[i]), results[i]);
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testSumWeightedRows()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const size_t count = 91;
+    const size_t maxRows = 7;
+    float data[maxRows][count], dest[count];
+    const float* rows[maxRows];
+    float weights[maxRows];
+    for (size_t k = 0; k < maxRows; ++k)
+    {
+        for (size_t i = 0; i < count; ++i)
+            data[k][i] = Math::RangeRandom(-10, 10);
+        rows[k] = data[k];
+        weights[k] = Math::RangeRandom(-1, 1);
+    }
+
+    for (size_t numRows = 1; numRows <= maxRows; ++numRows)
+    {
+        OptimisedUtil::getImplementation()->sumWeightedRows(rows, weights, numRows, dest, count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            float expected = 0;
+            for (size_t k = 0; k < numRows; ++k)
+                expected += weights[k] * data[k][i];
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, dest[i], 1e-4f);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testConvertFloatToByte()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // Out of range values, halves, and a NaN which must become zero
+    const size_t count = 1031;
+    vector<float>::type src(count);
+    vector<uint8>::type dest(count);
+    for (size_t i = 0; i < count; ++i)
+        src[i] = i < 600 ? i * 0.5f - 20.0f : Math::RangeRandom(-100, 400);
+    src[count - 3] = std::numeric_limits<float>::quiet_NaN();
+
+    OptimisedUtil::getImplementation()->convertFloatToByte(&src[0], &dest[0], count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        float v = src[i] > 0.0f ? src[i] : 0.0f;
+        v = v < 255.0f ? v : 255.0f;
+        CPPUNIT_ASSERT_EQUAL((int)std::floor(v + 0.5f), (int)dest[i]);
+    }
+}
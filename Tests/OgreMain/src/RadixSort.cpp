@@ -75,6 +75,15 @@ public:
     }
 };
 //--------------------------------------------------------------------------
+class UInt64SortFunctor
+{
+public:
+    uint64 operator()(const uint64& p) const
+    {
+        return p;
+    }
+};
+//--------------------------------------------------------------------------
 void RadixSortTests::testFloatVector()
 {
     UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
@@ -219,5 +228,90 @@ void RadixSortTests::testIntVector()
     }
 }
 //--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+void RadixSortTests::testUInt64Vector()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    std::vector<uint64> container;
+    UInt64SortFunctor func;
+    RadixSort<std::vector<uint64>, uint64, uint64> sorter;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        // Random upper and lower halves, so that all 8 passes matter
+        uint64 high = (uint64)Math::RangeRandom(0, 4e9);
+        uint64 low = (uint64)Math::RangeRandom(0, 4e9);
+        container.push_back((high << 32) | low);
+    }
+
+    sorter.sort(container, func);
+
+    std::vector<uint64>::iterator v = container.begin();
+    uint64 lastValue = *v++;
+    for (;v != container.end(); ++v)
+    {
+        CPPUNIT_ASSERT(*v >= lastValue);
+        lastValue = *v;
+    }
+}
+//--------------------------------------------------------------------------
+void RadixSortTests::testNearlySortedFloatVector()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
 
+    std::vector<float> container;
+    FloatSortFunctor func;
+    RadixSort<std::vector<float>, float, float> sorter;
 
+    for (int i = 0; i < 1000; ++i)
+    {
+        container.push_back((float)i - 500.0f);
+    }
+    // A few neighbours out of order, finished by insertion sort
+    for (int i = 10; i < 1000; i += 100)
+    {
+        std::swap(container[i], container[i + 1]);
+    }
+    // and one key far from its place, which the insertion sort gives up on
+    std::vector<float> farContainer = container;
+    farContainer[0] = 1e6f;
+    farContainer[999] = -1e6f;
+
+    sorter.sort(container, func);
+    sorter.sort(farContainer, func);
+
+    for (size_t i = 1; i < container.size(); ++i)
+    {
+        CPPUNIT_ASSERT(container[i] >= container[i - 1]);
+        CPPUNIT_ASSERT(farContainer[i] >= farContainer[i - 1]);
+    }
+    CPPUNIT_ASSERT_EQUAL(-1e6f, farContainer.front());
+    CPPUNIT_ASSERT_EQUAL(1e6f, farContainer.back());
+}
+//--------------------------------------------------------------------------
+void RadixSortTests::testSharedBytesIntVector()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    std::vector<int> container;
+    IntSortFunctor func;
+    RadixSort<std::vector<int>, int, int> sorter;
+    sorter.setCoherentSorting(false);
+
+    // Only the second byte differs, so the other passes are skipped
+    for (int i = 0; i < 1000; ++i)
+    {
+        container.push_back(0x100 * (int)Math::RangeRandom(0, 255) - 0x10000);
+    }
+
+    sorter.sort(container, func);
+
+    std::vector<int>::iterator v = container.begin();
+    int lastValue = *v++;
+    for (;v != container.end(); ++v)
+    {
+        CPPUNIT_ASSERT(*v >= lastValue);
+        lastValue = *v;
+    }
+}
@@ -0,0 +1,160 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ResourceManagerTests.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreIdString.h"
+
+#include "UnitTestSuite.h"
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(ResourceManagerTests);
+
+namespace {
+    /// Resource with nothing to load, of a fixed size once loaded
+    class TestResource : public Resource
+    {
+    public:
+        TestResource(ResourceManager* creator, const String& name, ResourceHandle handle,
+            const String& group)
+            : Resource(creator, name, handle, group)
+        {
+        }
+        ~TestResource()
+        {
+            unload();
+        }
+
+    protected:
+        void loadImpl(void) {}
+        void unloadImpl(void) {}
+        size_t calculateSize(void) const { return 100; }
+    };
+
+    class TestResourceManager : public ResourceManager
+    {
+    public:
+        TestResourceManager()
+        {
+            mResourceType = "TestResource";
+        }
+        ~TestResourceManager()
+        {
+            removeAll();
+        }
+
+    protected:
+        Resource* createImpl(const String& name, ResourceHandle handle, const String& group,
+            bool isManual, ManualResourceLoader* loader, const NameValuePairList* createParams)
+        {
+            return OGRE_NEW TestResource(this, name, handle, group);
+        }
+    };
+}
+
+//--------------------------------------------------------------------------
+void ResourceManagerTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    OGRE_NEW ResourceGroupManager();
+    mManager = OGRE_NEW TestResourceManager();
+}
+//--------------------------------------------------------------------------
+void ResourceManagerTests::tearDown()
+{
+    OGRE_DELETE mManager;
+    OGRE_DELETE ResourceGroupManager::getSingletonPtr();
+}
+//--------------------------------------------------------------------------
+void ResourceManagerTests::testIdIndexLookup()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    ResourcePtr res = mManager->createResource("indexed", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    const size_t useCount = res.useCount();
+
+    // The index finds the resource without holding a reference to it
+    ResourcePtr found = mManager->getResourceById(IdString("indexed"));
+    CPPUNIT_ASSERT(found == res);
+    CPPUNIT_ASSERT_EQUAL(useCount + 1, static_cast<size_t>(res.useCount()));
+    found.setNull();
+    CPPUNIT_ASSERT_EQUAL(ResourceGroupManager::RESOURCE_SYSTEM_NUM_REFERENCE_COUNTS + 1, static_cast<size_t>(res.useCount()));
+
+    mManager->remove(res);
+    CPPUNIT_ASSERT(mManager->getResourceById(IdString("indexed")).isNull());
+}
+//--------------------------------------------------------------------------
+void ResourceManagerTests::testGroupedIdIndexLookup()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    ResourceGroupManager::getSingleton().createResourceGroup("Grouped", false);
+    ResourcePtr res = mManager->createResource("indexed", "Grouped");
+
+    // Grouped resources are only found together with their own group
+    CPPUNIT_ASSERT(mManager->getResourceById(IdString("indexed"), IdString("Grouped")) == res);
+    CPPUNIT_ASSERT(mManager->getResourceById(IdString("indexed")).isNull());
+    CPPUNIT_ASSERT(mManager->getResourceById(IdString("indexed"), IdString("Other")).isNull());
+
+    mManager->remove(res);
+    CPPUNIT_ASSERT(mManager->getResourceById(IdString("indexed"), IdString("Grouped")).isNull());
+}
+//--------------------------------------------------------------------------
+void ResourceManagerTests::testUnloadUnreferencedWithIdIndex()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    ResourcePtr held = mManager->createResource("held", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    ResourcePtr dropped = mManager->createResource("dropped", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    held->load();
+    dropped->load();
+    Resource* droppedRes = dropped.get();
+    dropped.setNull();
+
+    mManager->unloadUnreferencedResources();
+    CPPUNIT_ASSERT(held->isLoaded());
+    CPPUNIT_ASSERT(!droppedRes->isLoaded());
+}
+//--------------------------------------------------------------------------
+void ResourceManagerTests::testCheckUsageWithIdIndex()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    ResourcePtr held = mManager->createResource("held", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    ResourcePtr dropped = mManager->createResource("dropped", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    held->load();
+    dropped->load();
+    Resource* droppedRes = dropped.get();
+    dropped.setNull();
+
+    // Going over budget unloads the resource only the resource system references
+    mManager->setMemoryBudget(held->getSize());
+    CPPUNIT_ASSERT(held->isLoaded());
+    CPPUNIT_ASSERT(!droppedRes->isLoaded());
+    CPPUNIT_ASSERT_EQUAL(held->getSize(), mManager->getMemoryUsage());
+}
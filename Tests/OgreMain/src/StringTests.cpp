@@ -34,6 +34,8 @@ THE SOFTWARE.
 
 #include "UnitTestSuite.h"
 
+#include <climits>
+
 using namespace Ogre;
 
 // Register the test suite
@@ -182,6 +184,13 @@ void StringTests::testParseReal()
     Real t = StringConverter::parseReal(s);
 
     CPPUNIT_ASSERT_EQUAL(r, t);
+
+    // Like the stream operators, only the 0 of a hexadecimal number is read
+    CPPUNIT_ASSERT_EQUAL(Real(0), StringConverter::parseReal("0x1A", 5));
+    CPPUNIT_ASSERT_EQUAL(Real(0), StringConverter::parseReal("-0X1p3", 5));
+    CPPUNIT_ASSERT(!StringConverter::isNumber("0x1A"));
+    CPPUNIT_ASSERT(StringConverter::isNumber("-2.5e3"));
+    CPPUNIT_ASSERT_EQUAL(Vector3(0, 1, 2), StringConverter::parseVector3("0x1A 1 2"));
 }
 //--------------------------------------------------------------------------
 void StringTests::testParseInt()
@@ -218,6 +227,13 @@ void StringTests::testParseUnsignedLong()
     unsigned long t = StringConverter::parseUnsignedLong(s);
 
     CPPUNIT_ASSERT_EQUAL(r, t);
+
+    // Negative numbers wrap around like the stream operators read them
+    CPPUNIT_ASSERT_EQUAL(ULONG_MAX, StringConverter::parseUnsignedLong("-1"));
+    CPPUNIT_ASSERT_EQUAL(UINT_MAX, StringConverter::parseUnsignedInt("-1"));
+    CPPUNIT_ASSERT_EQUAL(1U, StringConverter::parseUnsignedInt("-4294967295"));
+    CPPUNIT_ASSERT_EQUAL(7U, StringConverter::parseUnsignedInt("-4294967296", 7));
+    CPPUNIT_ASSERT_EQUAL(7U, StringConverter::parseUnsignedInt("- 1", 7));
 }
 //--------------------------------------------------------------------------
 void StringTests::testParseVector3()
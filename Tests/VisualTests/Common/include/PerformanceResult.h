@@ -0,0 +1,231 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __PerformanceResult_H__
+#define __PerformanceResult_H__
+
+#include "Ogre.h"
+#include "OgreConfigFile.h"
+
+#include <algorithm>
+#include <numeric>
+
+struct PerformanceResult;
+typedef std::vector<PerformanceResult> PerformanceResultVector;
+typedef Ogre::SharedPtr<PerformanceResultVector> PerformanceResultVectorPtr;
+
+/** Timings of a single PerformanceTest run
+ *
+ *    Frame times are the CPU time from the start of a frame until its
+ *    rendering is queued, so they don't include waiting for the GPU or vsync. */
+struct PerformanceResult
+{
+    Ogre::String testName;
+
+    // number of frames measured
+    size_t frames;
+
+    // frame time statistics, in milliseconds
+    float mean;
+    float median;
+    float p90;
+    float p99;
+    float worst;
+
+    // render target statistics (FrameStats) over the measured frames
+    float avgFPS;
+    size_t triangleCount;
+    size_t batchCount;
+
+    // average time per frame spent in each profiled phase, in milliseconds
+    std::map<Ogre::String, float> phases;
+
+    PerformanceResult()
+        :frames(0),mean(0),median(0),p90(0),p99(0),worst(0)
+        ,avgFPS(0),triangleCount(0),batchCount(0){}
+
+    /** Computes the frame time statistics from the time of each measured frame */
+    void setFrameTimes(std::vector<float> times)
+    {
+        frames = times.size();
+        if (times.empty())
+            return;
+
+        std::sort(times.begin(), times.end());
+        mean = std::accumulate(times.begin(), times.end(), 0.0f) / frames;
+        median = percentile(times, 0.5f);
+        p90 = percentile(times, 0.9f);
+        p99 = percentile(times, 0.99f);
+        worst = times.back();
+    }
+
+    /** Gets a percentile of sorted values, by the nearest rank method */
+    static float percentile(const std::vector<float>& sorted, float fraction)
+    {
+        size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+        return sorted[std::max<size_t>(rank, 1) - 1];
+    }
+
+    /** Writes a set of results to a config file, one section per test */
+    static void save(const PerformanceResultVector& results, const Ogre::String& filename)
+    {
+        std::ofstream file;
+        file.open(filename.c_str());
+
+        if (file.is_open())
+        {
+            for (size_t i = 0; i < results.size(); ++i)
+            {
+                const PerformanceResult& r = results[i];
+                file<<"["<<r.testName<<"]\n";
+                file<<"Frames="<<r.frames<<"\n";
+                file<<"Mean="<<r.mean<<"\n";
+                file<<"Median="<<r.median<<"\n";
+                file<<"P90="<<r.p90<<"\n";
+                file<<"P99="<<r.p99<<"\n";
+                file<<"Worst="<<r.worst<<"\n";
+                file<<"AverageFPS="<<r.avgFPS<<"\n";
+                file<<"Triangles="<<r.triangleCount<<"\n";
+                file<<"Batches="<<r.batchCount<<"\n";
+
+                // profile names may contain any separator, so they go after the '='
+                std::map<Ogre::String, float>::const_iterator it;
+                for (it = r.phases.begin(); it != r.phases.end(); ++it)
+                    file<<"Phase="<<it->second<<" "<<it->first<<"\n";
+            }
+            file.close();
+        }
+    }
+
+    /** Reads a set of results written by save(), returns a null pointer
+     *    if the file doesn't exist */
+    static PerformanceResultVectorPtr load(const Ogre::String& filename)
+    {
+        PerformanceResultVectorPtr out;
+        Ogre::ConfigFile file;
+        try
+        {
+            file.load(filename, "=", false);
+        }
+        catch (Ogre::FileNotFoundException&)
+        {
+            return out;
+        }
+
+        out.bind(OGRE_NEW_T(PerformanceResultVector, Ogre::MEMCATEGORY_GENERAL)(), Ogre::SPFM_DELETE_T);
+        Ogre::ConfigFile::SectionIterator sections = file.getSectionIterator();
+        for (; sections.hasMoreElements(); sections.moveNext())
+        {
+            if (sections.peekNextKey().empty())
+                continue;
+
+            PerformanceResult r;
+            r.testName = sections.peekNextKey();
+            Ogre::ConfigFile::SettingsMultiMap* settings = sections.peekNextValue();
+            Ogre::ConfigFile::SettingsMultiMap::iterator it;
+            for (it = settings->begin(); it != settings->end(); ++it)
+            {
+                const Ogre::String& key = it->first;
+                const Ogre::String& value = it->second;
+                if (key == "Frames") r.frames = Ogre::StringConverter::parseSizeT(value);
+                else if (key == "Mean") r.mean = Ogre::StringConverter::parseReal(value);
+                else if (key == "Median") r.median = Ogre::StringConverter::parseReal(value);
+                else if (key == "P90") r.p90 = Ogre::StringConverter::parseReal(value);
+                else if (key == "P99") r.p99 = Ogre::StringConverter::parseReal(value);
+                else if (key == "Worst") r.worst = Ogre::StringConverter::parseReal(value);
+                else if (key == "AverageFPS") r.avgFPS = Ogre::StringConverter::parseReal(value);
+                else if (key == "Triangles") r.triangleCount = Ogre::StringConverter::parseSizeT(value);
+                else if (key == "Batches") r.batchCount = Ogre::StringConverter::parseSizeT(value);
+                else if (key == "Phase")
+                {
+                    size_t split = value.find(' ');
+                    if (split != Ogre::String::npos)
+                        r.phases[value.substr(split + 1)] = Ogre::StringConverter::parseReal(value.substr(0, split));
+                }
+            }
+            out->push_back(r);
+        }
+        return out;
+    }
+};
+
+/** A PerformanceResult compared with the result of the same test in a baseline batch */
+struct PerformanceComparison
+{
+    bool passed;
+    // whether the baseline has a result for this test
+    bool hasBaseline;
+    PerformanceResult baseline;
+    PerformanceResult current;
+    // relative change of the median frame time, positive when slower
+    float change;
+};
+
+typedef std::vector<PerformanceComparison> PerformanceComparisonVector;
+
+/** Compares results with a baseline, a test fails if its median frame time
+ *    grew by more than the tolerance (a fraction, 0.1 for 10%)
+ *
+ *    Differences under a tenth of a millisecond are ignored, they are
+ *    within the noise of the timer on most platforms. */
+inline PerformanceComparisonVector comparePerformance(const PerformanceResultVector& baseline,
+    const PerformanceResultVector& current, float tolerance)
+{
+    const float minDifference = 0.1f;
+    PerformanceComparisonVector out;
+
+    for (size_t i = 0; i < current.size(); ++i)
+    {
+        PerformanceComparison c;
+        c.current = current[i];
+        c.hasBaseline = false;
+        c.passed = true;
+        c.change = 0;
+
+        for (size_t j = 0; j < baseline.size(); ++j)
+        {
+            if (baseline[j].testName == current[i].testName)
+            {
+                c.baseline = baseline[j];
+                c.hasBaseline = true;
+                break;
+            }
+        }
+
+        if (c.hasBaseline && c.baseline.median > 0)
+        {
+            float difference = c.current.median - c.baseline.median;
+            c.change = difference / c.baseline.median;
+            c.passed = c.change <= tolerance || difference < minDifference;
+        }
+        out.push_back(c);
+    }
+    return out;
+}
+
+#endif
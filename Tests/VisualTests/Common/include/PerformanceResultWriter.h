@@ -0,0 +1,103 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __PerformanceResultWriter_H__
+#define __PerformanceResultWriter_H__
+
+#include "Ogre.h"
+#include "TestBatch.h"
+#include "TestResultWriter.h"
+#include "PerformanceResult.h"
+
+#include <iomanip>
+
+/** Writes a plain text file with the timings of each performance test
+ *    against its baseline, the pass/fail lines use the same format as
+ *    SimpleResultWriter so CTest can check them */
+class PerformanceResultWriter : public TestResultWriter
+{
+public:
+
+    PerformanceResultWriter(const TestBatch& baseline, const TestBatch& current,
+        const PerformanceComparisonVector& comparisons)
+        :TestResultWriter(baseline, current, ComparisonResultVectorPtr())
+        ,mComparisons(comparisons){}
+
+protected:
+
+    virtual Ogre::String getOutput()
+    {
+        StringStream out;
+        out << std::fixed << std::setprecision(3);
+
+        out << "# Baseline: " << mSet1.name << " (" << mSet1.timestamp << ")\n";
+        out << "# Current: " << mSet2.name << " (" << mSet2.timestamp << ")\n";
+        out << "# Frame times in ms: median/p90/p99/worst\n";
+
+        for (size_t i = 0; i < mComparisons.size(); ++i)
+        {
+            const PerformanceComparison& c = mComparisons[i];
+            out << c.current.testName << "=" << (c.passed ? "Passed" : "Failed") << "\n";
+            out << "    current  ";
+            writeTimes(out, c.current);
+            if (c.hasBaseline)
+            {
+                out << "    baseline ";
+                writeTimes(out, c.baseline);
+                out << "    change   " << std::showpos << c.change * 100 << std::noshowpos << "%\n";
+            }
+            else
+            {
+                out << "    no baseline\n";
+            }
+
+            std::map<Ogre::String, float>::const_iterator it;
+            for (it = c.current.phases.begin(); it != c.current.phases.end(); ++it)
+            {
+                out << "    phase " << it->first << " " << it->second;
+                std::map<Ogre::String, float>::const_iterator base = c.baseline.phases.find(it->first);
+                if (c.hasBaseline && base != c.baseline.phases.end())
+                    out << " (baseline " << base->second << ")";
+                out << "\n";
+            }
+        }
+
+        return out.str();
+    }
+
+    void writeTimes(StringStream& out, const PerformanceResult& r)
+    {
+        out << r.median << "/" << r.p90 << "/" << r.p99 << "/" << r.worst
+            << " over " << r.frames << " frames, "
+            << r.triangleCount << " triangles, " << r.batchCount << " batches\n";
+    }
+
+    const PerformanceComparisonVector& mComparisons;
+};
+
+#endif
@@ -0,0 +1,76 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __PerformanceTest_H__
+#define __PerformanceTest_H__
+
+#include "VisualTest.h"
+
+/** The base class for a performance test scene
+ *
+ *    Instead of taking screenshots, the TestContext runs the scene for a
+ *    number of warm-up frames, then measures the CPU time of each of the
+ *    following frames, see PerformanceResult. Scenes should be deterministic
+ *    and have any resources loaded by the end of the warm-up. */
+class PerformanceTest : public VisualTest
+{
+ public:
+
+    PerformanceTest()
+        :mWarmupFrames(30)
+        ,mMeasuredFrames(300)
+    {
+        mInfo["Category"] = "Performance";
+    }
+
+    /** Sets the number of frames to run before measuring, and to measure */
+    void setFrames(unsigned int warmup, unsigned int measured)
+    {
+        mWarmupFrames = warmup;
+        mMeasuredFrames = measured;
+    }
+
+    unsigned int getWarmupFrames() const { return mWarmupFrames; }
+    unsigned int getMeasuredFrames() const { return mMeasuredFrames; }
+
+    /** Never takes a screenshot, the test is done after the measured frames */
+    virtual bool isScreenshotFrame(unsigned int frame)
+    {
+        if (frame >= mWarmupFrames + mMeasuredFrames)
+            mDone = true;
+        return false;
+    }
+
+ protected:
+
+    unsigned int mWarmupFrames;
+    unsigned int mMeasuredFrames;
+
+};
+
+#endif
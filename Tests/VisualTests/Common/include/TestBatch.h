@@ -123,6 +123,12 @@ public:
         return mDirectory + "/" + images[index] + ".png";
     }
 
+    /** Gets the full path to the results of the performance tests in this set */
+    Ogre::String getPerformancePath() const
+    {
+        return mDirectory + "/performance.cfg";
+    }
+
     /** Does image comparison on all images between these two sets */
     ComparisonResultVectorPtr compare(const TestBatch& other) const
     {
@@ -30,6 +30,8 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #define __TestContext_H__
 
 #include "VisualTest.h"
+#include "PerformanceTest.h"
+#include "PerformanceResult.h"
 #include "SampleContext.h"
 #include "SamplePlugin.h"
 
@@ -69,6 +71,11 @@ class TestContext : public OgreBites::SampleContext
      *        @param evt The frame event (passed in for the framelistener) */
     virtual bool frameEnded(const FrameEvent& evt);
 
+    /** Frame listener callback, ends the measurement of the CPU time of
+     *    a frame when running a PerformanceTest
+     *        @param evt The frame event (passed in for the framelistener) */
+    virtual bool frameRenderingQueued(const FrameEvent& evt);
+
     /** Runs a given test or sample
      *        @param s The OgreBites::Sample to run
      *        @remarks If s is a VisualTest, then timing and rand will be setup for
@@ -95,6 +102,16 @@ class TestContext : public OgreBites::SampleContext
     /** Called after tests successfully complete, generates output */
     virtual void finishedTests();
 
+    /** Starts measuring the running PerformanceTest, after its warm-up frames */
+    void startMeasuring();
+
+    /** Records the result of the running PerformanceTest */
+    void finishMeasuring();
+
+    /** Saves the performance results of this batch, and compares them
+     *    against the reference set or the most recent batch that has some */
+    void finishedPerformanceTests();
+
     /** Sets the timstep value
      *        @param timestep The time to simulate elapsed between each frame
      *        @remarks Use with care! Screenshots produced at different timesteps
@@ -138,6 +155,47 @@ class TestContext : public OgreBites::SampleContext
     /// The current frame of a running test
     unsigned int mCurrentFrame;
 
+    /// The active test if it is a PerformanceTest (0 otherwise)
+    PerformanceTest* mCurrentPerformanceTest;
+
+    /// Whether the frames of the running PerformanceTest are being measured
+    bool mMeasuring;
+
+    /// Times the frames of performance tests
+    Timer mFrameTimer;
+
+    /// When the current frame started, in microseconds
+    unsigned long mFrameStart;
+
+    /// The CPU time of each measured frame of the running test, in milliseconds
+    std::vector<float> mFrameTimes;
+
+    /// Results of the performance tests run so far
+    PerformanceResultVector mPerformanceResults;
+
+#if OGRE_PROFILING
+    /// Keeps the root profile, to read the time of each phase of the frame from
+    class ProfileRecorder : public ProfileSessionListener
+    {
+    public:
+        ProfileRecorder() : mRoot(0) {}
+        void initializeSession() {}
+        void finializeSession() { mRoot = 0; }
+        void displayResults(const ProfileInstance& instance, ulong maxTotalFrameTime) { mRoot = &instance; }
+
+        /// Adds the average time per frame of a profile and its children
+        void getPhases(const ProfileInstance& instance, const String& prefix,
+            size_t frames, std::map<String, float>& phases) const;
+
+        const ProfileInstance* mRoot;
+    };
+
+    ProfileRecorder mProfileRecorder;
+
+    /// Whether the profiler was enabled before a performance test enabled it
+    bool mProfilerWasEnabled;
+#endif
+
     /// Info about the running batch of tests
     TestBatch* mBatch;
 
@@ -153,6 +211,10 @@ class TestContext : public OgreBites::SampleContext
     bool mForceConfig;
     // Do not confine mouse to window
     bool mNoGrabMouse;
+    // Create the render window hidden
+    bool mHidden;
+    // Allowed slowdown of performance tests against their baseline, as a fraction
+    float mPerformanceTolerance;
     // Show usage details
     bool mHelp;
     // Render system to use
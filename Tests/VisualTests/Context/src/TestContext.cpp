@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "TestResultWriter.h"
 #include "HTMLWriter.h"
 #include "CppUnitResultWriter.h"
+#include "PerformanceResultWriter.h"
 #include "OgreConfigFile.h"
 #include "OgrePlatform.h"
 #include "OgreBitesConfigDialog.h"
@@ -49,9 +50,11 @@ static id mAppDelegate;
 #ifdef OGRE_STATIC_LIB
 #include "VTestPlugin.h"
 #include "PlayPenTestPlugin.h"
+#include "PerfTestPlugin.h"
 #endif
 
-TestContext::TestContext(int argc, char** argv) : OgreBites::SampleContext(), mSuccess(true), mTimestep(0.01f), mCurrentTest(0), mBatch(0)
+TestContext::TestContext(int argc, char** argv) : OgreBites::SampleContext(), mSuccess(true), mTimestep(0.01f), mCurrentTest(0),
+    mCurrentPerformanceTest(0), mMeasuring(false), mFrameStart(0), mBatch(0)
 {
     Ogre::UnaryOptionList unOpt;
     Ogre::BinaryOptionList binOpt;
@@ -61,6 +64,7 @@ TestContext::TestContext(int argc, char** argv) : OgreBites::SampleContext(), mS
     unOpt["--no-html"] = false; // whether or not to generate HTML
     unOpt["-d"] = false;        // force config dialog
     unOpt["--nograb"] = false;  // do not grab mouse
+    unOpt["--hidden"] = false;  // create the render window hidden
     unOpt["-h"] = false;        // help, give usage details
     unOpt["--help"] = false;    // help, give usage details
     binOpt["-m"] = "";          // optional comment
@@ -71,6 +75,7 @@ TestContext::TestContext(int argc, char** argv) : OgreBites::SampleContext(), mS
     binOpt["-n"] = "AUTO";      // name for this batch
     binOpt["-rs"] = "SAVED";    // rendersystem to use (default: use name from the config file/dialog)
     binOpt["-o"] = "NONE";      // path to output a summary file to (default: don't output a file)
+    binOpt["-pt"] = "10";       // allowed slowdown of performance tests, in percent
 
     // Parse.
     Ogre::findCommandLineOpts(argc, argv, unOpt, binOpt);
@@ -83,6 +88,8 @@ TestContext::TestContext(int argc, char** argv) : OgreBites::SampleContext(), mS
     mCompareWith = binOpt["-c"];
     mForceConfig = unOpt["-d"];
     mNoGrabMouse = unOpt["--nograb"];
+    mHidden = unOpt["--hidden"];
+    mPerformanceTolerance = StringConverter::parseReal(binOpt["-pt"]) / 100;
     mOutputDir = binOpt["-od"];
     mRenderSystemName = binOpt["-rs"];
     mReferenceSetPath = binOpt["-rp"];
@@ -131,7 +138,10 @@ void TestContext::setup()
     mode >> token; // 'x' as seperator between width and height
     mode >> h; // height
 
-    mWindow = mRoot->createRenderWindow("OGRE Sample Browser", w, h, false);
+    if (mHidden)
+        miscParams["hidden"] = "true";
+
+    mWindow = mRoot->createRenderWindow("OGRE Sample Browser", w, h, false, &miscParams);
 #endif
 
     mWindow->setDeactivateOnFocusChange(false);
@@ -186,6 +196,11 @@ void TestContext::setup()
 #ifdef OGRE_STATIC_LIB
     mPluginNameMap["VTests"]       = (OgreBites::SamplePlugin *) OGRE_NEW VTestPlugin();
     mPluginNameMap["PlayPenTests"] = (OgreBites::SamplePlugin *) OGRE_NEW PlaypenTestPlugin();
+    mPluginNameMap["PerfTests"]    = (OgreBites::SamplePlugin *) OGRE_NEW PerfTestPlugin();
+#endif
+
+#if OGRE_PROFILING
+    Profiler::getSingleton().addListener(&mProfileRecorder);
 #endif
 
     Ogre::String batchName = BLANKSTRING;
@@ -330,6 +345,13 @@ bool TestContext::frameStarted(const Ogre::FrameEvent& evt)
         // track frame number for screenshot purposes
         ++mCurrentFrame;
 
+        if (mCurrentPerformanceTest)
+        {
+            if (mCurrentFrame == mCurrentPerformanceTest->getWarmupFrames() + 1)
+                startMeasuring();
+            mFrameStart = mFrameTimer.getMicroseconds();
+        }
+
         // regular update function
         return mCurrentTest->frameStarted(fixed_evt);
     }
@@ -369,6 +391,9 @@ bool TestContext::frameEnded(const Ogre::FrameEvent& evt)
 
         if (mCurrentTest->isDone())
         {
+            if (mCurrentPerformanceTest)
+                finishMeasuring();
+
 #ifdef INCLUDE_RTSHADER_SYSTEM
             mShaderGenerator->removeAllShaderBasedTechniques(); // clear techniques from the RTSS
 #endif
@@ -397,6 +422,72 @@ bool TestContext::frameEnded(const Ogre::FrameEvent& evt)
 }
 //-----------------------------------------------------------------------
 
+bool TestContext::frameRenderingQueued(const Ogre::FrameEvent& evt)
+{
+    if (mMeasuring)
+        mFrameTimes.push_back((mFrameTimer.getMicroseconds() - mFrameStart) / 1000.f);
+
+    return SampleContext::frameRenderingQueued(evt);
+}
+//-----------------------------------------------------------------------
+
+void TestContext::startMeasuring()
+{
+    mMeasuring = true;
+    mFrameTimes.clear();
+    mWindow->resetStatistics();
+#if OGRE_PROFILING
+    Profiler::getSingleton().reset();
+#endif
+}
+//-----------------------------------------------------------------------
+
+void TestContext::finishMeasuring()
+{
+    PerformanceResult result;
+    result.testName = mCurrentPerformanceTest->getInfo()["Title"];
+    result.setFrameTimes(mFrameTimes);
+
+    const RenderTarget::FrameStats& stats = mWindow->getStatistics();
+    result.avgFPS = stats.avgFPS;
+    result.triangleCount = stats.triangleCount;
+    result.batchCount = stats.batchCount;
+
+#if OGRE_PROFILING
+    if (mProfileRecorder.mRoot && result.frames)
+    {
+        mProfileRecorder.getPhases(*mProfileRecorder.mRoot, BLANKSTRING,
+            result.frames, result.phases);
+    }
+    Profiler::getSingleton().setEnabled(mProfilerWasEnabled);
+#endif
+
+    LogManager::getSingleton().stream() << "Performance test " << result.testName
+        << ": median " << result.median << "ms, p99 " << result.p99 << "ms over "
+        << result.frames << " frames";
+
+    mPerformanceResults.push_back(result);
+    mMeasuring = false;
+    mFrameTimes.clear();
+}
+//-----------------------------------------------------------------------
+
+#if OGRE_PROFILING
+void TestContext::ProfileRecorder::getPhases(const ProfileInstance& instance, const String& prefix,
+    size_t frames, std::map<String, float>& phases) const
+{
+    ProfileInstance::ProfileChildren::const_iterator it;
+    for (it = instance.children.begin(); it != instance.children.end(); ++it)
+    {
+        const ProfileInstance* child = it->second;
+        String name = prefix.empty() ? child->name : prefix + "/" + child->name;
+        phases[name] = child->history.totalTimeMillisecs / frames;
+        getPhases(*child, name, frames, phases);
+    }
+}
+#endif
+//-----------------------------------------------------------------------
+
 void TestContext::runSample(OgreBites::Sample* s)
 {
     // reset frame timing
@@ -418,6 +509,8 @@ void TestContext::runSample(OgreBites::Sample* s)
 
     // Check if this is a VisualTest
     mCurrentTest = static_cast<VisualTest*>(sampleToRun);
+    mCurrentPerformanceTest = dynamic_cast<PerformanceTest*>(sampleToRun);
+    mMeasuring = false;
 
     // Set things up to be deterministic
     if (mCurrentTest)
@@ -430,6 +523,16 @@ void TestContext::runSample(OgreBites::Sample* s)
         LogManager::getSingleton().logMessage("----- Running Visual Test " + mCurrentTest->getInfo()["Title"] + " -----");
     }
 
+#if OGRE_PROFILING
+    // record the time of each phase of the frame, the change applies by the end of the warm-up
+    if (mCurrentPerformanceTest)
+    {
+        mProfilerWasEnabled = Profiler::getSingleton().getEnabled();
+        Profiler::getSingleton().setUpdateDisplayFrequency(1);
+        Profiler::getSingleton().setEnabled(true);
+    }
+#endif
+
 #ifdef INCLUDE_RTSHADER_SYSTEM
     if (sampleToRun) {
         sampleToRun->setShaderGenerator(mShaderGenerator);
@@ -485,6 +588,8 @@ void TestContext::go(OgreBites::Sample* initialSample)
         std::cout<<"\t-n [name]    Name for this result image set.\n";
         std::cout<<"\t-rs [name]   Render system to use.\n";
         std::cout<<"\t-o [path]    Path to output a simple summary file to.\n";
+        std::cout<<"\t-pt [pct]    Slowdown of performance tests allowed against their baseline (default 10).\n";
+        std::cout<<"\t--hidden     Create the render window hidden.\n";
         std::cout<<"\t--nograb     Do not restrict mouse to window (warning: may affect results).\n\n";
     }
 }
@@ -644,11 +749,85 @@ void TestContext::finishedTests()
         OGRE_DELETE ref;
     }
 
+    if (!mPerformanceResults.empty())
+        finishedPerformanceTests();
+
     // write this batch's config file
     mBatch->writeConfig();
 }
 //-----------------------------------------------------------------------
 
+void TestContext::finishedPerformanceTests()
+{
+    PerformanceResult::save(mPerformanceResults, mBatch->getPerformancePath());
+
+    if (mReferenceSet)
+        return;
+
+    // look for the reference set first (either "Reference" or a user-specified set)
+    PerformanceResultVectorPtr baseline;
+    TestBatch* compareTo = 0;
+    Ogre::ConfigFile info;
+    try
+    {
+        info.load(mReferenceSetPath + mCompareWith + "/info.cfg");
+        compareTo = OGRE_NEW TestBatch(info, mReferenceSetPath + mCompareWith);
+        baseline = PerformanceResult::load(compareTo->getPerformancePath());
+    }
+    catch (Ogre::FileNotFoundException&)
+    {
+    }
+
+    // if no luck, grab the most recent set that has performance results
+    if (baseline.isNull())
+    {
+        OGRE_DELETE compareTo;
+        compareTo = 0;
+
+        TestBatchSetPtr batches = TestBatch::loadTestBatches(mOutputDir);
+        for (TestBatchSet::iterator i = batches->begin(); i != batches->end(); ++i)
+        {
+            if (i->name == mBatch->name || i->resolutionX != mBatch->resolutionX ||
+                i->resolutionY != mBatch->resolutionY)
+                continue;
+
+            baseline = PerformanceResult::load(i->getPerformancePath());
+            if (!baseline.isNull())
+            {
+                compareTo = OGRE_NEW TestBatch(*i);
+                break;
+            }
+        }
+    }
+
+    if (compareTo && !baseline.isNull())
+    {
+        PerformanceComparisonVector results = comparePerformance(*baseline,
+            mPerformanceResults, mPerformanceTolerance);
+
+        PerformanceResultWriter writer(*compareTo, *mBatch, results);
+        writer.writeToFile(mOutputDir + "PerformanceResults_" + mBatch->name + ".txt");
+
+        // also save a summary file for CTest to parse, if required
+        if(mSummaryOutputDir != "NONE")
+        {
+            Ogre::String rs;
+            for(size_t j = 0; j < mRenderSystemName.size(); ++j)
+                if(mRenderSystemName[j]!=' ')
+                    rs += mRenderSystemName[j];
+
+            writer.writeToFile(mSummaryOutputDir + "/PerformanceResults_" + rs + ".txt");
+        }
+
+        for(size_t i = 0; i < results.size(); i++) {
+            mSuccess = mSuccess && results[i].passed;
+        }
+    }
+
+    OGRE_DELETE compareTo;
+}
+//-----------------------------------------------------------------------
+
 Ogre::Real TestContext::getTimestep()
 {
     return mTimestep;
@@ -0,0 +1,168 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __PerfTests_H__
+#define __PerfTests_H__
+
+#include "PerformanceTest.h"
+#include "SamplePlugin.h"
+#include "OgreInstanceManager.h"
+
+#ifdef OGRE_BUILD_COMPONENT_TERRAIN
+#include "OgreTerrain.h"
+#include "OgreTerrainGroup.h"
+#endif
+
+using namespace Ogre;
+
+//---------------------------------------------------------------------------
+/** Base of the stress scenes, the camera orbits the origin at a fixed speed
+ *    so culling and sorting see a changing view */
+class _OgreSampleClassExport PerfTest_Orbit : public PerformanceTest
+{
+public:
+
+    PerfTest_Orbit();
+    bool frameStarted(const FrameEvent& evt);
+
+protected:
+
+    /** Sets the distance and height of the camera from the origin */
+    void setOrbit(Real radius, Real height);
+
+    Real mOrbitRadius;
+    Real mOrbitHeight;
+    Radian mOrbitAngle;
+
+};
+
+//---------------------------------------------------------------------------
+/** Many entities, each with its own scene node */
+class _OgreSampleClassExport PerfTest_Entities : public PerfTest_Orbit
+{
+public:
+
+    PerfTest_Entities(size_t count);
+
+protected:
+
+    void setupContent();
+
+    size_t mCount;
+
+};
+
+//---------------------------------------------------------------------------
+/** Many point lights over a field of objects */
+class _OgreSampleClassExport PerfTest_Lights : public PerfTest_Orbit
+{
+public:
+
+    PerfTest_Lights(size_t count);
+
+protected:
+
+    void setupContent();
+
+    size_t mCount;
+
+};
+
+//---------------------------------------------------------------------------
+/** Many particle systems */
+class _OgreSampleClassExport PerfTest_Particles : public PerfTest_Orbit
+{
+public:
+
+    PerfTest_Particles(size_t count);
+
+protected:
+
+    void setupContent();
+
+    size_t mCount;
+
+};
+
+//---------------------------------------------------------------------------
+/** Many animated instanced entities, with one of the instancing techniques */
+class _OgreSampleClassExport PerfTest_Instancing : public PerfTest_Orbit
+{
+public:
+
+    PerfTest_Instancing(InstanceManager::InstancingTechnique technique, size_t count);
+    void testCapabilities(const RenderSystemCapabilities* caps);
+
+protected:
+
+    void setupContent();
+
+    InstanceManager::InstancingTechnique mTechnique;
+    size_t mCount;
+
+};
+
+//---------------------------------------------------------------------------
+/** Shadow casters over a floor, with one of the shadow techniques */
+class _OgreSampleClassExport PerfTest_Shadows : public PerfTest_Orbit
+{
+public:
+
+    PerfTest_Shadows(ShadowTechnique technique);
+
+protected:
+
+    void setupContent();
+
+    ShadowTechnique mTechnique;
+
+};
+
+#ifdef OGRE_BUILD_COMPONENT_TERRAIN
+//---------------------------------------------------------------------------
+/** A square of terrain pages */
+class _OgreSampleClassExport PerfTest_Terrain : public PerfTest_Orbit
+{
+public:
+
+    PerfTest_Terrain(long pagesPerSide);
+    void testCapabilities(const RenderSystemCapabilities* caps);
+
+protected:
+
+    void setupContent();
+    void cleanupContent();
+
+    long mPagesPerSide;
+    TerrainGlobalOptions* mTerrainGlobals;
+    TerrainGroup* mTerrainGroup;
+
+};
+#endif
+
+#endif
@@ -0,0 +1,82 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "PerfTestPlugin.h"
+#include "PerfTests.h"
+
+PerfTestPlugin::PerfTestPlugin()
+    :SamplePlugin("PerfTestPlugin")
+{
+    // each scene at a couple of scales, so the results show how costs grow
+    addSample(new PerfTest_Entities(1000));
+    addSample(new PerfTest_Entities(10000));
+    addSample(new PerfTest_Lights(8));
+    addSample(new PerfTest_Lights(64));
+    addSample(new PerfTest_Particles(10));
+    addSample(new PerfTest_Particles(100));
+    addSample(new PerfTest_Instancing(InstanceManager::ShaderBased, 2500));
+    addSample(new PerfTest_Instancing(InstanceManager::TextureVTF, 2500));
+    addSample(new PerfTest_Instancing(InstanceManager::HWInstancingBasic, 2500));
+    addSample(new PerfTest_Instancing(InstanceManager::HWInstancingVTF, 2500));
+    addSample(new PerfTest_Shadows(SHADOWTYPE_STENCIL_MODULATIVE));
+    addSample(new PerfTest_Shadows(SHADOWTYPE_STENCIL_ADDITIVE));
+    addSample(new PerfTest_Shadows(SHADOWTYPE_TEXTURE_MODULATIVE));
+#ifdef OGRE_BUILD_COMPONENT_TERRAIN
+    addSample(new PerfTest_Terrain(1));
+    addSample(new PerfTest_Terrain(3));
+#endif
+}
+//---------------------------------------------------------------------
+
+PerfTestPlugin::~PerfTestPlugin()
+{
+    for (OgreBites::SampleSet::iterator i = mSamples.begin(); i != mSamples.end(); ++i)
+    {
+        delete *i;
+    }
+    mSamples.clear();
+}
+//---------------------------------------------------------------------
+
+#ifndef OGRE_STATIC_LIB
+
+static PerfTestPlugin* testPlugin = 0;
+
+extern "C" _OgreSampleExport void dllStartPlugin()
+{
+    testPlugin = OGRE_NEW PerfTestPlugin();
+    Ogre::Root::getSingleton().installPlugin(testPlugin);
+}
+
+extern "C" _OgreSampleExport void dllStopPlugin()
+{
+    Ogre::Root::getSingleton().uninstallPlugin(testPlugin); 
+    OGRE_DELETE testPlugin;
+}
+
+#endif
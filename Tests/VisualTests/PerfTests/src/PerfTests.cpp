@@ -0,0 +1,426 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "PerfTests.h"
+#include "OgreInstancedEntity.h"
+#include "OgreParticleSystem.h"
+
+namespace
+{
+    /// Number of rows and columns of a square grid holding count objects
+    size_t gridSide(size_t count)
+    {
+        return static_cast<size_t>(std::ceil(std::sqrt(static_cast<Real>(count))));
+    }
+
+    /// Position of the index-th object of a grid centred on the origin
+    Vector3 gridPosition(size_t index, size_t side, Real spacing)
+    {
+        Real offset = (side - 1) * spacing * 0.5f;
+        return Vector3((index % side) * spacing - offset, 0, (index / side) * spacing - offset);
+    }
+
+    /// Creates a floor plane mesh with a material, and adds it to the scene
+    void createFloor(SceneManager* sceneMgr, Real size)
+    {
+        MeshManager::getSingleton().createPlane("PerfTestFloor", TRANSIENT_RESOURCE_GROUP,
+            Plane(Vector3::UNIT_Y, 0), size, size, 40, 40, true, 1, 20, 20, Vector3::UNIT_Z);
+        Entity* floor = sceneMgr->createEntity("PerfTestFloor");
+        floor->setMaterialName("Examples/Rockwall");
+        floor->setCastShadows(false);
+        sceneMgr->getRootSceneNode()->attachObject(floor);
+    }
+}
+
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+PerfTest_Orbit::PerfTest_Orbit()
+    :mOrbitRadius(500)
+    ,mOrbitHeight(300)
+    ,mOrbitAngle(0)
+{
+}
+//----------------------------------------------------------------------------
+
+void PerfTest_Orbit::setOrbit(Real radius, Real height)
+{
+    mOrbitRadius = radius;
+    mOrbitHeight = height;
+}
+//----------------------------------------------------------------------------
+
+bool PerfTest_Orbit::frameStarted(const FrameEvent& evt)
+{
+    // the context passes a fixed timestep, so every run sees the same views
+    mOrbitAngle += Radian(evt.timeSinceLastFrame * 0.5f);
+    mCamera->setPosition(Math::Cos(mOrbitAngle) * mOrbitRadius, mOrbitHeight,
+        Math::Sin(mOrbitAngle) * mOrbitRadius);
+    mCamera->lookAt(Vector3::ZERO);
+
+    return PerformanceTest::frameStarted(evt);
+}
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+PerfTest_Entities::PerfTest_Entities(size_t count)
+    :mCount(count)
+{
+    mInfo["Title"] = "PerfTest_Entities_" + StringConverter::toString(count);
+    mInfo["Description"] = "Renders many entities, each on its own scene node.";
+}
+//----------------------------------------------------------------------------
+
+void PerfTest_Entities::setupContent()
+{
+    mSceneMgr->setAmbientLight(ColourValue(0.4, 0.4, 0.4));
+    Light* l = mSceneMgr->createLight("Sun");
+    l->setType(Light::LT_DIRECTIONAL);
+    l->setDirection(Vector3(-1, -1, -0.5).normalisedCopy());
+
+    const Real spacing = 80;
+    size_t side = gridSide(mCount);
+    for (size_t i = 0; i < mCount; ++i)
+    {
+        Entity* ent = mSceneMgr->createEntity("ogrehead.mesh");
+        SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(
+            gridPosition(i, side, spacing));
+        node->yaw(Degree(Math::RangeRandom(0, 360)));
+        node->attachObject(ent);
+    }
+
+    setOrbit(side * spacing * 0.5f, side * spacing * 0.25f);
+    mCamera->setFarClipDistance(side * spacing * 2);
+}
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+PerfTest_Lights::PerfTest_Lights(size_t count)
+    :mCount(count)
+{
+    mInfo["Title"] = "PerfTest_Lights_" + StringConverter::toString(count);
+    mInfo["Description"] = "Renders a field of objects lit by many point lights.";
+}
+//----------------------------------------------------------------------------
+
+void PerfTest_Lights::setupContent()
+{
+    const Real size = 2000;
+    mSceneMgr->setAmbientLight(ColourValue(0.1, 0.1, 0.1));
+    createFloor(mSceneMgr, size);
+
+    const size_t numSpheres = 100;
+    size_t side = gridSide(numSpheres);
+    for (size_t i = 0; i < numSpheres; ++i)
+    {
+        Entity* ent = mSceneMgr->createEntity("sphere.mesh");
+        SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(
+            gridPosition(i, side, size / side) + Vector3(0, 20, 0));
+        node->setScale(0.4, 0.4, 0.4);
+        node->attachObject(ent);
+    }
+
+    for (size_t i = 0; i < mCount; ++i)
+    {
+        Light* l = mSceneMgr->createLight();
+        l->setType(Light::LT_POINT);
+        l->setDiffuseColour(Math::UnitRandom(), Math::UnitRandom(), Math::UnitRandom());
+        l->setSpecularColour(ColourValue::White);
+        l->setAttenuation(400, 1, 0.01, 0.0005);
+        SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(
+            Math::RangeRandom(-size, size) * 0.5f, 50, Math::RangeRandom(-size, size) * 0.5f));
+        node->attachObject(l);
+    }
+
+    setOrbit(size * 0.6f, size * 0.3f);
+}
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+PerfTest_Particles::PerfTest_Particles(size_t count)
+    :mCount(count)
+{
+    mInfo["Title"] = "PerfTest_Particles_" + StringConverter::toString(count);
+    mInfo["Description"] = "Updates and renders many particle systems.";
+    // let the systems fill up before measuring
+    setFrames(200, 300);
+}
+//----------------------------------------------------------------------------
+
+void PerfTest_Particles::setupContent()
+{
+    static const char* templates[] =
+    {
+        "Examples/Smoke",
+        "Examples/PurpleFountain",
+        "Examples/GreenyNimbus",
+        "Examples/Fireworks"
+    };
+    const size_t numTemplates = sizeof(templates) / sizeof(templates[0]);
+
+    const Real spacing = 200;
+    size_t side = gridSide(mCount);
+    for (size_t i = 0; i < mCount; ++i)
+    {
+        ParticleSystem* ps = mSceneMgr->createParticleSystem(
+            "PerfTestParticles" + StringConverter::toString(i), templates[i % numTemplates]);
+        SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(
+            gridPosition(i, side, spacing));
+        node->attachObject(ps);
+    }
+
+    setOrbit(side * spacing * 0.6f + 300, 300);
+}
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+PerfTest_Instancing::PerfTest_Instancing(InstanceManager::InstancingTechnique technique, size_t count)
+    :mTechnique(technique)
+    ,mCount(count)
+{
+    static const char* names[] = { "ShaderBased", "TextureVTF", "HWInstancingBasic", "HWInstancingVTF" };
+    mInfo["Title"] = "PerfTest_Instancing_" + String(names[technique]) + "_" + StringConverter::toString(count);
+    mInfo["Description"] = "Renders many animated robots with one of the instancing techniques.";
+}
+//----------------------------------------------------------------------------
+
+void PerfTest_Instancing::testCapabilities(const RenderSystemCapabilities* caps)
+{
+    if (!caps->hasCapability(RSC_VERTEX_PROGRAM) || !caps->hasCapability(RSC_FRAGMENT_PROGRAM))
+    {
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, "Your graphics card does not support vertex and "
+            "fragment programs, so you cannot run this test.", "PerfTest_Instancing::testCapabilities");
+    }
+    if ((mTechnique == InstanceManager::TextureVTF || mTechnique == InstanceManager::HWInstancingVTF) &&
+        !caps->hasCapability(RSC_VERTEX_TEXTURE_FETCH))
+    {
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, "Your graphics card does not support vertex "
+            "texture fetch, so you cannot run this test.", "PerfTest_Instancing::testCapabilities");
+    }
+    if ((mTechnique == InstanceManager::HWInstancingBasic || mTechnique == InstanceManager::HWInstancingVTF) &&
+        !caps->hasCapability(RSC_VERTEX_BUFFER_INSTANCE_DATA))
+    {
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, "Your graphics card does not support hardware "
+            "instancing, so you cannot run this test.", "PerfTest_Instancing::testCapabilities");
+    }
+}
+//----------------------------------------------------------------------------
+
+void PerfTest_Instancing::setupContent()
+{
+    static const char* materials[] =
+    {
+        "Examples/Instancing/ShaderBased/Robot",
+        "Examples/Instancing/VTF/Robot",
+        "Examples/Instancing/HWBasic/Robot",
+        "Examples/Instancing/VTF/HW/Robot"
+    };
+
+    mSceneMgr->setAmbientLight(ColourValue(0.4, 0.4, 0.4));
+    Light* l = mSceneMgr->createLight("Sun");
+    l->setType(Light::LT_DIRECTIONAL);
+    l->setDirection(Vector3(-1, -1, -0.5).normalisedCopy());
+
+    InstanceManager* manager = mSceneMgr->createInstanceManager("PerfTestInstances", "robot.mesh",
+        ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME, mTechnique, mCount, IM_USEALL);
+
+    const Real spacing = 60;
+    size_t side = gridSide(mCount);
+    for (size_t i = 0; i < mCount; ++i)
+    {
+        InstancedEntity* ent = manager->createInstancedEntity(materials[mTechnique]);
+        SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(
+            gridPosition(i, side, spacing));
+        node->yaw(Degree(Math::RangeRandom(0, 360)));
+        node->attachObject(ent);
+
+        // the basic hardware technique can't animate
+        if (ent->hasSkeleton())
+        {
+            AnimationState* anim = ent->getAnimationState("Walk");
+            anim->setEnabled(true);
+            anim->addTime(Math::UnitRandom() * anim->getLength());
+            mAnimStateList.push_back(anim);
+        }
+    }
+
+    setOrbit(side * spacing * 0.5f, side * spacing * 0.25f);
+    mCamera->setFarClipDistance(side * spacing * 2);
+}
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+PerfTest_Shadows::PerfTest_Shadows(ShadowTechnique technique)
+    :mTechnique(technique)
+{
+    String name;
+    switch (technique)
+    {
+    case SHADOWTYPE_STENCIL_MODULATIVE: name = "StencilModulative"; break;
+    case SHADOWTYPE_STENCIL_ADDITIVE: name = "StencilAdditive"; break;
+    case SHADOWTYPE_TEXTURE_MODULATIVE: name = "TextureModulative"; break;
+    case SHADOWTYPE_TEXTURE_ADDITIVE: name = "TextureAdditive"; break;
+    default: name = StringConverter::toString(technique); break;
+    }
+    mInfo["Title"] = "PerfTest_Shadows_" + name;
+    mInfo["Description"] = "Renders shadow casters over a floor with a shadow technique.";
+}
+//----------------------------------------------------------------------------
+
+void PerfTest_Shadows::setupContent()
+{
+    const Real size = 2000;
+    mSceneMgr->setShadowTechnique(mTechnique);
+    mSceneMgr->setShadowTextureSize(1024);
+    mSceneMgr->setShadowFarDistance(size);
+    mSceneMgr->setAmbientLight(ColourValue(0.3, 0.3, 0.3));
+    createFloor(mSceneMgr, size);
+
+    Light* sun = mSceneMgr->createLight("Sun");
+    sun->setType(Light::LT_DIRECTIONAL);
+    sun->setDirection(Vector3(-1, -2, -0.5).normalisedCopy());
+
+    Light* spot = mSceneMgr->createLight("Spot");
+    spot->setType(Light::LT_SPOTLIGHT);
+    spot->setSpotlightRange(Degree(30), Degree(60));
+    spot->setDiffuseColour(0.6, 0.6, 0.4);
+    SceneNode* spotNode = mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(300, 600, 300));
+    spotNode->attachObject(spot);
+    spotNode->setDirection(-spotNode->getPosition().normalisedCopy(), Node::TS_WORLD);
+
+    const size_t numCasters = 100;
+    size_t side = gridSide(numCasters);
+    for (size_t i = 0; i < numCasters; ++i)
+    {
+        Entity* ent = mSceneMgr->createEntity("ogrehead.mesh");
+        SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(
+            gridPosition(i, side, size / (side + 1)) + Vector3(0, 60, 0));
+        node->yaw(Degree(Math::RangeRandom(0, 360)));
+        node->attachObject(ent);
+    }
+
+    setOrbit(size * 0.6f, size * 0.3f);
+}
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+#ifdef OGRE_BUILD_COMPONENT_TERRAIN
+
+PerfTest_Terrain::PerfTest_Terrain(long pagesPerSide)
+    :mPagesPerSide(pagesPerSide)
+    ,mTerrainGlobals(0)
+    ,mTerrainGroup(0)
+{
+    mInfo["Title"] = "PerfTest_Terrain_" + StringConverter::toString(pagesPerSide) + "x" +
+        StringConverter::toString(pagesPerSide);
+    mInfo["Description"] = "Renders a square of terrain pages.";
+}
+//----------------------------------------------------------------------------
+
+void PerfTest_Terrain::testCapabilities(const RenderSystemCapabilities* caps)
+{
+    if (!caps->hasCapability(RSC_VERTEX_PROGRAM) || !caps->hasCapability(RSC_FRAGMENT_PROGRAM))
+    {
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, "Your graphics card does not support vertex and "
+            "fragment programs, so you cannot run this test.", "PerfTest_Terrain::testCapabilities");
+    }
+}
+//----------------------------------------------------------------------------
+
+void PerfTest_Terrain::setupContent()
+{
+    const uint16 terrainSize = 129;
+    const Real worldSize = 2000;
+
+    mSceneMgr->setAmbientLight(ColourValue(0.2, 0.2, 0.2));
+    Light* l = mSceneMgr->createLight("Sun");
+    l->setType(Light::LT_DIRECTIONAL);
+    l->setDirection(Vector3(0.55, -0.3, 0.75).normalisedCopy());
+
+    mTerrainGlobals = OGRE_NEW TerrainGlobalOptions();
+    mTerrainGlobals->setMaxPixelError(8);
+    mTerrainGlobals->setLightMapDirection(l->getDerivedDirection());
+    mTerrainGlobals->setCompositeMapAmbient(mSceneMgr->getAmbientLight());
+    mTerrainGlobals->setCompositeMapDiffuse(l->getDiffuseColour());
+    if (Root::getSingleton().getRenderSystem()->getName() == "Direct3D11 Rendering Subsystem")
+        mTerrainGlobals->setUseVertexCompressionWhenAvailable(false);
+
+    mTerrainGroup = OGRE_NEW TerrainGroup(mSceneMgr, Terrain::ALIGN_X_Z, terrainSize, worldSize);
+    mTerrainGroup->setResourceGroup(TRANSIENT_RESOURCE_GROUP);
+
+    Terrain::ImportData& imp = mTerrainGroup->getDefaultImportSettings();
+    imp.inputScale = 1;
+    imp.minBatchSize = 33;
+    imp.maxBatchSize = 65;
+    imp.layerList.resize(1);
+    imp.layerList[0].worldSize = 100;
+    imp.layerList[0].textureNames.push_back("dirt_grayrocky_diffusespecular.dds");
+    imp.layerList[0].textureNames.push_back("dirt_grayrocky_normalheight.dds");
+
+    // rolling hills, computed from world positions so the pages join up
+    std::vector<float> heights(terrainSize * terrainSize);
+    long first = -(mPagesPerSide / 2);
+    for (long x = first; x < first + mPagesPerSide; ++x)
+    {
+        for (long y = first; y < first + mPagesPerSide; ++y)
+        {
+            Vector3 centre;
+            mTerrainGroup->convertTerrainSlotToWorldPosition(x, y, &centre);
+            for (uint16 row = 0; row < terrainSize; ++row)
+            {
+                for (uint16 col = 0; col < terrainSize; ++col)
+                {
+                    Real wx = centre.x + (col / Real(terrainSize - 1) - 0.5f) * worldSize;
+                    Real wz = centre.z - (row / Real(terrainSize - 1) - 0.5f) * worldSize;
+                    heights[row * terrainSize + col] = 150 * Math::Sin(wx * 0.002f) * Math::Cos(wz * 0.003f) +
+                        40 * Math::Sin(wx * 0.013f + wz * 0.011f);
+                }
+            }
+            mTerrainGroup->defineTerrain(x, y, &heights[0]);
+        }
+    }
+
+    // sync load since we want everything in place before measuring
+    mTerrainGroup->loadAllTerrains(true);
+    mTerrainGroup->freeTemporaryResources();
+
+    setOrbit(mPagesPerSide * worldSize * 0.3f, 400);
+    mCamera->setFarClipDistance(mPagesPerSide * worldSize * 2);
+}
+//----------------------------------------------------------------------------
+
+void PerfTest_Terrain::cleanupContent()
+{
+    OGRE_DELETE mTerrainGroup;
+    mTerrainGroup = 0;
+    OGRE_DELETE mTerrainGlobals;
+    mTerrainGlobals = 0;
+}
+//----------------------------------------------------------------------------
+
+#endif
@@ -70,6 +70,9 @@ void help(void)
     cout << "-srcgl     = Interpret ambiguous colours as GL style" << endl;
     cout << "-E endian  = Set endian mode 'big' 'little' or 'native' (default)" << endl;
     cout << "-b         = Recalculate bounding box (static meshes only)" << endl;
+    cout << "-q         = Quantise normals, tangents (16-bit) and UVs (half float)" << endl;
+    cout << "-o         = Optimise index and vertex order for the vertex cache" << endl;
+    cout << "-c         = Build triangle clusters for per-camera culling" << endl;
     cout << "-V version = Specify OGRE version format to write instead of latest" << endl;
     cout << "             Options are: 1.10, 1.8, 1.7, 1.4, 1.0" << endl;
     cout << "sourcefile = name of file to convert" << endl;
@@ -100,6 +103,9 @@ struct UpgradeOptions {
     bool usePercent;
     Serializer::Endian endian;
     bool recalcBounds;
+    bool quantise;
+    bool optimiseIndexOrder;
+    bool buildClusters;
     MeshVersion targetVersion;
 
 };
@@ -141,6 +147,9 @@ void parseOpts(UnaryOptionList& unOpts, BinaryOptionList& binOpts)
     opts.numLods = 0;
     opts.usePercent = true;
     opts.recalcBounds = false;
+    opts.quantise = false;
+    opts.optimiseIndexOrder = false;
+    opts.buildClusters = false;
     opts.targetVersion = MESH_VERSION_LATEST;
 
 
@@ -184,6 +193,18 @@ void parseOpts(UnaryOptionList& unOpts, BinaryOptionList& binOpts)
     if (ui->second) {
         opts.recalcBounds = true;
     }
+    ui = unOpts.find("-q");
+    if (ui->second) {
+        opts.quantise = true;
+    }
+    ui = unOpts.find("-o");
+    if (ui->second) {
+        opts.optimiseIndexOrder = true;
+    }
+    ui = unOpts.find("-c");
+    if (ui->second) {
+        opts.buildClusters = true;
+    }
 
 
     BinaryOptionList::iterator bi = binOpts.find("-l");
@@ -979,6 +1000,26 @@ void resolveColourAmbiguities(Mesh* mesh)
 
 }
 
+void quantiseVertexData(Mesh* mesh)
+{
+    // Software skinning / morphing reads normals as floats, so leave them alone
+    // on anything which may be animated on the CPU
+    bool normals = !mesh->hasSkeleton() && !mesh->hasVertexAnimation() && mesh->getPoseCount() == 0;
+    if (!normals) {
+        cout << "\nMesh is animated, quantising texture coordinates only." << endl;
+    }
+
+    if (mesh->sharedVertexData) {
+        mesh->sharedVertexData->quantise(normals, true);
+    }
+    for (unsigned short i = 0; i < mesh->getNumSubMeshes(); ++i) {
+        SubMesh* sm = mesh->getSubMesh(i);
+        if (sm->useSharedVertices == false) {
+            sm->vertexData->quantise(normals, true);
+        }
+    }
+}
+
 int main(int numargs, char** args)
 {
     if (numargs < 2) {
@@ -1020,6 +1061,9 @@ int main(int numargs, char** args)
         unOptList["-srcd3d"] = false;
         unOptList["-autogen"] = false;
         unOptList["-b"] = false;
+        unOptList["-q"] = false;
+        unOptList["-o"] = false;
+        unOptList["-c"] = false;
         binOptList["-l"] = "";
         binOptList["-d"] = "";
         binOptList["-p"] = "";
@@ -1156,10 +1200,26 @@ int main(int numargs, char** args)
         }
 
 
+        if (opts.optimiseIndexOrder) {
+            cout << "\nOptimising index order...";
+            mesh->optimiseIndexOrder();
+            cout << "success" << std::endl;
+        }
+
+        if (opts.buildClusters) {
+            cout << "\nBuilding triangle clusters...";
+            mesh->buildClusters();
+            cout << "success" << std::endl;
+        }
+
         if (opts.recalcBounds) {
             recalcBounds(mesh);
         }
 
+        if (opts.quantise) {
+            quantiseVertexData(mesh);
+        }
+
         meshSerializer->exportMesh(mesh, dest, opts.targetVersion, opts.endian);
     
     }
@@ -35,6 +35,8 @@ THE SOFTWARE.
 
 namespace Ogre {
 
+    class XMLStreamReader;
+
     /** Class for serializing a Mesh to/from XML.
     @remarks
         This class behaves the same way as MeshSerializer in the main project,
@@ -53,6 +55,10 @@ namespace Ogre {
         XMLMeshSerializer();
         virtual ~XMLMeshSerializer();
         /** Imports a Mesh from the given XML file.
+        @remarks
+            The geometry, faces and bone assignments are read as the file
+            streams past, see XMLStreamReader, so the whole document is
+            never held in memory.
         @param filename The name of the file to import, expected to be in XML format.
         @param colourElementType The vertex element to use for packed colours
         @param pMesh The pre-created Mesh object to be populated.
@@ -68,6 +74,9 @@ namespace Ogre {
         // State for import
         Mesh* mMesh;
         VertexElementType mColourElementType;
+        // Scratch space for the indices and vertices of a buffer while it is read
+        vector<uint32>::type mIndices;
+        vector<unsigned char>::type mVertices;
 
         // Internal methods
         void writeMesh(const Mesh* pMesh);
@@ -88,12 +97,14 @@ namespace Ogre {
         void writePoseKeyFrames(TiXmlElement* trackNode, const VertexAnimationTrack* track);
         void writeExtremes(TiXmlElement* mMeshNode, const Mesh* m);
 
-        void readSubMeshes(TiXmlElement* mSubmeshesNode);
-        void readGeometry(TiXmlElement* mGeometryNode, VertexData* pData);
+        void readSubMeshes(XMLStreamReader& reader);
+        void readFaces(XMLStreamReader& reader, SubMesh* sm, bool use32BitIndexes);
+        void readGeometry(XMLStreamReader& reader, VertexData* pData);
+        void readVertexElement(XMLStreamReader& reader, const VertexElement& elem, unsigned char* pVert);
         void readSkeletonLink(TiXmlElement* mSkelNode);
-        void readBoneAssignments(TiXmlElement* mBoneAssignmentsNode);
-        void readBoneAssignments(TiXmlElement* mBoneAssignmentsNode, SubMesh* sm);
-        void readTextureAliases(TiXmlElement* mTextureAliasesNode, SubMesh* sm);
+        /// Reads the bone assignments of a submesh, or of the mesh if sm is 0
+        void readBoneAssignments(XMLStreamReader& reader, SubMesh* sm = 0);
+        void readTextureAliases(XMLStreamReader& reader, SubMesh* sm);
         void readLodInfo(TiXmlElement*  lodNode);
         void readLodUsageManual(TiXmlElement* manualNode, unsigned short index);
         void readLodUsageGenerated(TiXmlElement* genNode, unsigned short index);
@@ -0,0 +1,147 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __XMLStreamReader_H__
+#define __XMLStreamReader_H__
+
+#include "OgreXMLPrerequisites.h"
+#include "OgreDataStream.h"
+#include "OgreColourValue.h"
+
+
+namespace Ogre {
+
+    /** Pull parser reading an XML document as a sequence of element events.
+    @remarks
+        TiXmlDocument builds the whole document in memory before anything can
+        be read from it, which for meshes of millions of vertices takes many
+        times the size of the file. This reader instead goes through the
+        document in a window of fixed size, so memory use does not depend on
+        the size of the document.
+    @par
+        Only what the Ogre XML formats use is supported: elements and their
+        attributes, with the predefined and numeric character references.
+        Text, comments, CDATA sections, processing instructions and the
+        document type declaration are skipped. The name and attribute values
+        of the current element point into the window and stay valid until
+        the next call to next(); numeric attributes are parsed where they
+        are, without building strings.
+    */
+    class XMLStreamReader
+    {
+    public:
+        enum Event
+        {
+            START_ELEMENT,
+            END_ELEMENT,
+            END_DOCUMENT
+        };
+
+        /** Constructor.
+        @param stream The stream to read the document from
+        @param bufferSize The initial size of the window; it grows if a
+            single tag does not fit
+        */
+        XMLStreamReader(const DataStreamPtr& stream, size_t bufferSize = 1024 * 1024);
+
+        /** Moves to the next start or end of an element. Self-closing elements
+            report both. */
+        Event next(void);
+
+        /** Moves to the next child of the element at the given depth, skipping
+            whatever is left of the previous child.
+        @param depth The depth of the parent element, as given by getDepth()
+            just after its start
+        @return false once the parent element has ended
+        */
+        bool nextChildElement(size_t depth);
+
+        /** Reads the current element and everything in it into a tree.
+        @remarks
+            For the parts of a document which are small and easier to handle
+            as a tree. The reader is left at the end of the element. The caller
+            owns the returned element.
+        */
+        TiXmlElement* readElement(void);
+
+        /// The number of elements open, including the current one after its start
+        size_t getDepth(void) const { return mDepth; }
+        /// The name of the current element
+        const char* getName(void) const { return mName; }
+
+        /// The value of an attribute of the current element, or 0 if it has none
+        const char* getAttribute(const char* name) const;
+        /** The value of an attribute of the current element as a number.
+        @remarks
+            Throws if the attribute is missing. Values which are not numbers
+            read as 0, like StringConverter does.
+        */
+        Real getRealAttribute(const char* name) const;
+        /// @copydoc getRealAttribute
+        int getIntAttribute(const char* name) const;
+        /// @copydoc getRealAttribute
+        unsigned int getUnsignedIntAttribute(const char* name) const;
+        /** The value of an attribute of the current element as a colour of 3 or 4
+            components, or black if it is not one. Throws if the attribute is
+            missing. */
+        ColourValue getColourAttribute(const char* name) const;
+
+    protected:
+        typedef std::pair<const char*, const char*> Attribute;
+
+        DataStreamPtr mStream;
+        vector<char>::type mBuffer;
+        /// Where the unread part of the window starts and ends in mBuffer
+        size_t mPos, mEnd;
+        /// How far into the document the window starts, for error messages
+        size_t mBufferOffset;
+        size_t mDepth;
+        /// Whether the current element closed itself, so next() ends it
+        bool mPendingEnd;
+        const char* mName;
+        vector<Attribute>::type mAttributes;
+
+        /** Moves the unread data to the start of the window, then reads more
+            data after it, growing the window if it is full.
+        @return false at the end of the stream
+        */
+        bool readMore(void);
+        /** Finds a string in the unread data, reading more as needed.
+        @return The position of the string relative to mPos
+        */
+        size_t find(const char* str, size_t from);
+        /// Parses the start tag mBuffer[mPos, mPos + length), in place
+        void parseStartTag(size_t length);
+        /// Replaces the character references of a null terminated string, in place
+        static void decodeReferences(char* str);
+        const char* getRequiredAttribute(const char* name) const;
+        void malformed(const String& what) const;
+    };
+}
+
+#endif
@@ -28,6 +28,7 @@ THE SOFTWARE.
 
 
 #include "OgreXMLMeshSerializer.h"
+#include "OgreXMLStreamReader.h"
 #include "OgreSubMesh.h"
 #include "OgreLogManager.h"
 #include "OgreSkeleton.h"
@@ -40,9 +41,36 @@ THE SOFTWARE.
 #include "OgreLodStrategyManager.h"
 #include "OgreLodStrategy.h"
 #include <cstddef>
+#include <fstream>
 
 namespace Ogre {
 
+    namespace {
+        /// The XML element holding a vertex element of the given semantic
+        const char* getVertexElementName(VertexElementSemantic semantic)
+        {
+            switch (semantic)
+            {
+            case VES_POSITION:
+                return "position";
+            case VES_NORMAL:
+                return "normal";
+            case VES_TANGENT:
+                return "tangent";
+            case VES_BINORMAL:
+                return "binormal";
+            case VES_DIFFUSE:
+                return "colour_diffuse";
+            case VES_SPECULAR:
+                return "colour_specular";
+            case VES_TEXTURE_COORDINATES:
+                return "texcoord";
+            default:
+                return 0;
+            }
+        }
+    }
+
     //---------------------------------------------------------------------
     XMLMeshSerializer::XMLMeshSerializer()
     {
@@ -58,67 +86,86 @@ namespace Ogre {
         LogManager::getSingleton().logMessage("XMLMeshSerializer reading mesh data from " + filename + "...");
         mMesh = pMesh;
         mColourElementType = colourElementType;
-        mXMLDoc = new TiXmlDocument(filename);
-        mXMLDoc->LoadFile();
 
-        TiXmlElement* elem;
+        std::ifstream ifs(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+        if (!ifs)
+        {
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "Unable to open file " + filename,
+                "XMLMeshSerializer::importMesh");
+        }
+        // pass false for freeOnClose to FileStreamDataStream since ifs is created on stack
+        DataStreamPtr stream(OGRE_NEW FileStreamDataStream(filename, &ifs, false));
+        XMLStreamReader reader(stream);
 
-        TiXmlElement* rootElem = mXMLDoc->RootElement();
+        if (reader.next() != XMLStreamReader::START_ELEMENT || strcmp(reader.getName(), "mesh"))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, filename + " is not a mesh",
+                "XMLMeshSerializer::importMesh");
+        }
 
-        // shared geometry
-        elem = rootElem->FirstChildElement("sharedgeometry");
-        if (elem)
+        // The geometry is read as it streams past. The other sections are small,
+        // so they are kept as trees and read afterwards, in the order they
+        // depend on each other rather than the order of the file.
+        TiXmlElement rootElem("mesh");
+        size_t depth = reader.getDepth();
+        while (reader.nextChildElement(depth))
         {
-            const char *claimedVertexCount_ = elem->Attribute("vertexcount");
-            if(!claimedVertexCount_ || StringConverter::parseInt(claimedVertexCount_) > 0)
+            const char* name = reader.getName();
+            if (!strcmp(name, "sharedgeometry"))
+            {
+                const char *claimedVertexCount_ = reader.getAttribute("vertexcount");
+                if(!claimedVertexCount_ || StringConverter::parseInt(claimedVertexCount_) > 0)
+                {
+                    mMesh->sharedVertexData = new VertexData();
+                    readGeometry(reader, mMesh->sharedVertexData);
+                }
+            }
+            else if (!strcmp(name, "submeshes"))
+            {
+                readSubMeshes(reader);
+            }
+            else if (!strcmp(name, "boneassignments"))
             {
-                mMesh->sharedVertexData = new VertexData();
-                readGeometry(elem, mMesh->sharedVertexData);
+                readBoneAssignments(reader);
+            }
+            else
+            {
+                rootElem.LinkEndChild(reader.readElement());
             }
         }
 
-        // submeshes
-        elem = rootElem->FirstChildElement("submeshes");
-        if (elem)
-            readSubMeshes(elem);
+        TiXmlElement* elem;
 
         // skeleton link
-        elem = rootElem->FirstChildElement("skeletonlink");
+        elem = rootElem.FirstChildElement("skeletonlink");
         if (elem)
             readSkeletonLink(elem);
 
-        // bone assignments
-        elem = rootElem->FirstChildElement("boneassignments");
-        if (elem)
-            readBoneAssignments(elem);
-
         //Lod
-        elem = rootElem->FirstChildElement("levelofdetail");
+        elem = rootElem.FirstChildElement("levelofdetail");
         if (elem)
             readLodInfo(elem);
 
         // submesh names
-        elem = rootElem->FirstChildElement("submeshnames");
+        elem = rootElem.FirstChildElement("submeshnames");
         if (elem)
             readSubMeshNames(elem, mMesh);
 
         // submesh extremes
-        elem = rootElem->FirstChildElement("extremes");
+        elem = rootElem.FirstChildElement("extremes");
         if (elem)
             readExtremes(elem, mMesh);
 
         // poses
-        elem = rootElem->FirstChildElement("poses");
+        elem = rootElem.FirstChildElement("poses");
         if (elem)
             readPoses(elem, mMesh);
 
         // animations
-        elem = rootElem->FirstChildElement("animations");
+        elem = rootElem.FirstChildElement("animations");
         if (elem)
             readAnimations(elem, mMesh);
 
-        delete mXMLDoc;
-
         LogManager::getSingleton().logMessage("XMLMeshSerializer import successful.");
         
     }
@@ -700,23 +747,23 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
-    void XMLMeshSerializer::readSubMeshes(TiXmlElement* mSubmeshesNode)
+    void XMLMeshSerializer::readSubMeshes(XMLStreamReader& reader)
     {
         LogManager::getSingleton().logMessage("Reading submeshes...");
         assert(mMesh->getNumSubMeshes() == 0);
-        for (TiXmlElement* smElem = mSubmeshesNode->FirstChildElement();
-            smElem != 0; smElem = smElem->NextSiblingElement())
+        size_t depth = reader.getDepth();
+        while (reader.nextChildElement(depth))
         {
             // All children should be submeshes 
             SubMesh* sm = mMesh->createSubMesh();
 
-            const char* mat = smElem->Attribute("material");
+            const char* mat = reader.getAttribute("material");
             if (mat)
                 sm->setMaterialName(mat);
 
             // Read operation type
             bool readFaces = true;
-            const char* optype = smElem->Attribute("operationtype");
+            const char* optype = reader.getAttribute("operationtype");
             if (optype)
             {
                 if (!strcmp(optype, "triangle_list"))
@@ -749,151 +796,130 @@ namespace Ogre {
 
             }
 
-            const char* tmp = smElem->Attribute("usesharedvertices");
+            const char* tmp = reader.getAttribute("usesharedvertices");
             if (tmp)
                 sm->useSharedVertices = StringConverter::parseBool(tmp);
-            tmp = smElem->Attribute("use32bitindexes");
+            tmp = reader.getAttribute("use32bitindexes");
             bool use32BitIndexes = false;
             if (tmp)
                 use32BitIndexes = StringConverter::parseBool(tmp);
-            
-            // Faces
-            if (readFaces)
+
+            size_t smDepth = reader.getDepth();
+            while (reader.nextChildElement(smDepth))
             {
-                TiXmlElement* faces = smElem->FirstChildElement("faces");
-                int actualCount = 0;
-                for (TiXmlElement *faceElem = faces->FirstChildElement(); faceElem != 0; faceElem = faceElem->NextSiblingElement())
+                const char* name = reader.getName();
+                if (!strcmp(name, "faces"))
                 {
-                        actualCount++;
+                    if (readFaces)
+                        this->readFaces(reader, sm, use32BitIndexes);
                 }
-                const char *claimedCount_ = faces->Attribute("count");
-                if (claimedCount_ && StringConverter::parseInt(claimedCount_)!=actualCount)
+                else if (!strcmp(name, "geometry"))
                 {
-                    LogManager::getSingleton().stream()
-                        << "WARNING: face count (" << actualCount << ") " <<
-                        "is not as claimed (" << claimedCount_ << ")";
-                }
-
-
-                if (actualCount > 0)
-                {
-                    // Faces
-                    switch(sm->operationType)
-                    {
-                    case RenderOperation::OT_TRIANGLE_LIST:
-                        // tri list
-                        sm->indexData->indexCount = actualCount * 3;
-
-                        break;
-                    case RenderOperation::OT_LINE_LIST:
-                        sm->indexData->indexCount = actualCount * 2;
-
-                        break;
-                    case RenderOperation::OT_TRIANGLE_FAN:
-                    case RenderOperation::OT_TRIANGLE_STRIP:
-                        // triangle fan or triangle strip
-                        sm->indexData->indexCount = actualCount + 2;
-
-                        break;
-                    default:
-                        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, "operationType not implemented", 
-                            __FUNCTION__);
-                    }
-
-                    // Allocate space
-                    HardwareIndexBufferSharedPtr ibuf = HardwareBufferManager::getSingleton().
-                        createIndexBuffer(
-                            use32BitIndexes? HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT, 
-                            sm->indexData->indexCount, 
-                            HardwareBuffer::HBU_DYNAMIC,
-                            false);
-                    sm->indexData->indexBuffer = ibuf;
-                    unsigned int *pInt = 0;
-                    unsigned short *pShort = 0;
-                    if (use32BitIndexes)
+                    if (!sm->useSharedVertices)
                     {
-                        pInt = static_cast<unsigned int*>(
-                            ibuf->lock(HardwareBuffer::HBL_DISCARD));
+                        sm->vertexData = new VertexData();
+                        readGeometry(reader, sm->vertexData);
                     }
-                    else
-                    {
-                        pShort = static_cast<unsigned short*>(
-                            ibuf->lock(HardwareBuffer::HBL_DISCARD));
-                    }
-                    TiXmlElement* faceElem;
-                    bool firstTri = true;
-                    for (faceElem = faces->FirstChildElement();
-                        faceElem != 0; faceElem = faceElem->NextSiblingElement())
-                    {
-                        if (use32BitIndexes)
-                        {
-                            *pInt++ = StringConverter::parseInt(faceElem->Attribute("v1"));
-                            if(sm->operationType == RenderOperation::OT_LINE_LIST)
-                            {
-                                *pInt++ = StringConverter::parseInt(faceElem->Attribute("v2"));
-                            }
-                            // only need all 3 vertices if it's a trilist or first tri
-                            else if (sm->operationType == RenderOperation::OT_TRIANGLE_LIST || firstTri)
-                            {
-                                *pInt++ = StringConverter::parseInt(faceElem->Attribute("v2"));
-                                *pInt++ = StringConverter::parseInt(faceElem->Attribute("v3"));
-                            }
-                        }
-                        else
-                        {
-                            *pShort++ = StringConverter::parseInt(faceElem->Attribute("v1"));
-                            if(sm->operationType == RenderOperation::OT_LINE_LIST)
-                            {
-                                *pShort++ = StringConverter::parseInt(faceElem->Attribute("v2"));
-                            }
-                            // only need all 3 vertices if it's a trilist or first tri
-                            else if (sm->operationType == RenderOperation::OT_TRIANGLE_LIST || firstTri)
-                            {
-                                *pShort++ = StringConverter::parseInt(faceElem->Attribute("v2"));
-                                *pShort++ = StringConverter::parseInt(faceElem->Attribute("v3"));
-                            }
-                        }
-                        firstTri = false;
-                    }
-                    ibuf->unlock();
                 }
-            }
-
-            // Geometry
-            if (!sm->useSharedVertices)
-            {
-                TiXmlElement* geomNode = smElem->FirstChildElement("geometry");
-                if (geomNode)
+                else if (!strcmp(name, "textures"))
                 {
-                    sm->vertexData = new VertexData();
-                    readGeometry(geomNode, sm->vertexData);
+                    readTextureAliases(reader, sm);
+                }
+                else if (!strcmp(name, "boneassignments"))
+                {
+                    readBoneAssignments(reader, sm);
                 }
             }
+        }
+        LogManager::getSingleton().logMessage("Submeshes done.");
+    }
+    //---------------------------------------------------------------------
+    void XMLMeshSerializer::readFaces(XMLStreamReader& reader, SubMesh* sm, bool use32BitIndexes)
+    {
+        const char *claimedCount_ = reader.getAttribute("count");
+        mIndices.clear();
+        if (claimedCount_)
+            mIndices.reserve(StringConverter::parseUnsignedInt(claimedCount_) * 3);
+
+        size_t actualCount = 0;
+        bool firstTri = true;
+        size_t depth = reader.getDepth();
+        while (reader.nextChildElement(depth))
+        {
+            mIndices.push_back(reader.getUnsignedIntAttribute("v1"));
+            if(sm->operationType == RenderOperation::OT_LINE_LIST)
+            {
+                mIndices.push_back(reader.getUnsignedIntAttribute("v2"));
+            }
+            // only need all 3 vertices if it's a trilist or first tri
+            else if (sm->operationType == RenderOperation::OT_TRIANGLE_LIST || firstTri)
+            {
+                mIndices.push_back(reader.getUnsignedIntAttribute("v2"));
+                mIndices.push_back(reader.getUnsignedIntAttribute("v3"));
+            }
+            firstTri = false;
+            ++actualCount;
+        }
+        if (claimedCount_ && StringConverter::parseInt(claimedCount_) != static_cast<int>(actualCount))
+        {
+            LogManager::getSingleton().stream()
+                << "WARNING: face count (" << actualCount << ") " <<
+                "is not as claimed (" << claimedCount_ << ")";
+        }
 
-            // texture aliases
-            TiXmlElement* textureAliasesNode = smElem->FirstChildElement("textures");
-            if(textureAliasesNode)
-                readTextureAliases(textureAliasesNode, sm);
+        if (actualCount == 0)
+            return;
 
-            // Bone assignments
-            TiXmlElement* boneAssigns = smElem->FirstChildElement("boneassignments");
-            if(boneAssigns)
-                readBoneAssignments(boneAssigns, sm);
+        // Faces
+        switch(sm->operationType)
+        {
+        case RenderOperation::OT_TRIANGLE_LIST:
+            // tri list
+            sm->indexData->indexCount = actualCount * 3;
 
+            break;
+        case RenderOperation::OT_LINE_LIST:
+            sm->indexData->indexCount = actualCount * 2;
+
+            break;
+        case RenderOperation::OT_TRIANGLE_FAN:
+        case RenderOperation::OT_TRIANGLE_STRIP:
+            // triangle fan or triangle strip
+            sm->indexData->indexCount = actualCount + 2;
+
+            break;
+        default:
+            OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, "operationType not implemented", 
+                __FUNCTION__);
+        }
+
+        // Allocate space
+        HardwareIndexBufferSharedPtr ibuf = HardwareBufferManager::getSingleton().
+            createIndexBuffer(
+                use32BitIndexes? HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT, 
+                sm->indexData->indexCount, 
+                HardwareBuffer::HBU_DYNAMIC,
+                false);
+        sm->indexData->indexBuffer = ibuf;
+        if (use32BitIndexes)
+        {
+            ibuf->writeData(0, ibuf->getSizeInBytes(), &mIndices[0], true);
+        }
+        else
+        {
+            unsigned short *pShort = static_cast<unsigned short*>(
+                ibuf->lock(HardwareBuffer::HBL_DISCARD));
+            for (vector<uint32>::type::const_iterator i = mIndices.begin(); i != mIndices.end(); ++i)
+                *pShort++ = static_cast<unsigned short>(*i);
+            ibuf->unlock();
         }
-        LogManager::getSingleton().logMessage("Submeshes done.");
     }
     //---------------------------------------------------------------------
-    void XMLMeshSerializer::readGeometry(TiXmlElement* mGeometryNode, VertexData* vertexData)
+    void XMLMeshSerializer::readGeometry(XMLStreamReader& reader, VertexData* vertexData)
     {
         LogManager::getSingleton().logMessage("Reading geometry...");
-        unsigned char *pVert;
-        float *pFloat;
-        uint16 *pShort;
-        uint8 *pChar;
-        ARGB *pCol;
 
-        const char *claimedVertexCount_ = mGeometryNode->Attribute("vertexcount");
+        const char *claimedVertexCount_ = reader.getAttribute("vertexcount");
         ptrdiff_t claimedVertexCount = 0;
         if (claimedVertexCount_)
         {
@@ -915,32 +941,32 @@ namespace Ogre {
         bool first = true;
 
         // Iterate over all children (vertexbuffer entries) 
-        for (TiXmlElement* vbElem = mGeometryNode->FirstChildElement();
-            vbElem != 0; vbElem = vbElem->NextSiblingElement())
+        size_t depth = reader.getDepth();
+        while (reader.nextChildElement(depth))
         {
             size_t offset = 0;
             // Skip non-vertexbuffer elems
-            if (stricmp(vbElem->Value(), "vertexbuffer")) continue;
+            if (stricmp(reader.getName(), "vertexbuffer")) continue;
            
-            const char* attrib = vbElem->Attribute("positions");
+            const char* attrib = reader.getAttribute("positions");
             if (attrib && StringConverter::parseBool(attrib))
             {
                 // Add element
                 decl->addElement(bufCount, offset, VET_FLOAT3, VES_POSITION);
                 offset += VertexElement::getTypeSize(VET_FLOAT3);
             }
-            attrib = vbElem->Attribute("normals");
+            attrib = reader.getAttribute("normals");
             if (attrib && StringConverter::parseBool(attrib))
             {
                 // Add element
                 decl->addElement(bufCount, offset, VET_FLOAT3, VES_NORMAL);
                 offset += VertexElement::getTypeSize(VET_FLOAT3);
             }
-            attrib = vbElem->Attribute("tangents");
+            attrib = reader.getAttribute("tangents");
             if (attrib && StringConverter::parseBool(attrib))
             {
                 VertexElementType tangentType = VET_FLOAT3;
-                attrib = vbElem->Attribute("tangent_dimensions");
+                attrib = reader.getAttribute("tangent_dimensions");
                 if (attrib)
                 {
                     unsigned int dims = StringConverter::parseUnsignedInt(attrib);
@@ -952,38 +978,38 @@ namespace Ogre {
                 decl->addElement(bufCount, offset, tangentType, VES_TANGENT);
                 offset += VertexElement::getTypeSize(tangentType);
             }
-            attrib = vbElem->Attribute("binormals");
+            attrib = reader.getAttribute("binormals");
             if (attrib && StringConverter::parseBool(attrib))
             {
                 // Add element
                 decl->addElement(bufCount, offset, VET_FLOAT3, VES_BINORMAL);
                 offset += VertexElement::getTypeSize(VET_FLOAT3);
             }
-            attrib = vbElem->Attribute("colours_diffuse");
+            attrib = reader.getAttribute("colours_diffuse");
             if (attrib && StringConverter::parseBool(attrib))
             {
                 // Add element
                 decl->addElement(bufCount, offset, mColourElementType, VES_DIFFUSE);
                 offset += VertexElement::getTypeSize(mColourElementType);
             }
-            attrib = vbElem->Attribute("colours_specular");
+            attrib = reader.getAttribute("colours_specular");
             if (attrib && StringConverter::parseBool(attrib))
             {
                 // Add element
                 decl->addElement(bufCount, offset, mColourElementType, VES_SPECULAR);
                 offset += VertexElement::getTypeSize(mColourElementType);
             }
-            attrib = vbElem->Attribute("texture_coords");
+            attrib = reader.getAttribute("texture_coords");
             if (attrib && StringConverter::parseInt(attrib))
             {
-                unsigned short numTexCoords = StringConverter::parseInt(vbElem->Attribute("texture_coords"));
+                unsigned short numTexCoords = StringConverter::parseInt(attrib);
                 for (unsigned short tx = 0; tx < numTexCoords; ++tx)
                 {
                     // NB set is local to this buffer, but will be translated into a 
                     // global set number across all vertex buffers
                     StringStream str;
                     str << "texture_coord_dimensions_" << tx;
-                    attrib = vbElem->Attribute(str.str().c_str());
+                    attrib = reader.getAttribute(str.str().c_str());
                     VertexElementType vtype = VET_FLOAT2; // Default
                     if (attrib)
                     {
@@ -1032,70 +1058,58 @@ namespace Ogre {
                 }
             } 
 
-            // calculate how many vertexes there actually are
-            int actualVertexCount = 0;
-            for (TiXmlElement * vertexElem = vbElem->FirstChildElement(); vertexElem != 0; vertexElem = vertexElem->NextSiblingElement())
+            // Get the element list for this buffer alone, and the XML element of each
+            VertexDeclaration::VertexElementList elemList = decl->findElementsBySource(bufCount);
+            vector<VertexElement>::type elems(elemList.begin(), elemList.end());
+            vector<const char*>::type elemNames;
+            for (size_t e = 0; e < elems.size(); ++e)
+                elemNames.push_back(getVertexElementName(elems[e].getSemantic()));
+            vector<bool>::type found(elems.size());
+
+            // The vertices are gathered in memory, as their number is only known at the end
+            const size_t vertexSize = offset;
+            mVertices.clear();
+            if (claimedVertexCount > 0)
+                mVertices.reserve(claimedVertexCount * vertexSize);
+
+            size_t actualVertexCount = 0;
+            size_t vbDepth = reader.getDepth();
+            while (reader.nextChildElement(vbDepth))
             {
-                    actualVertexCount++;
-            }
-            if (claimedVertexCount_ && actualVertexCount!=claimedVertexCount)
-            {
-                LogManager::getSingleton().stream()
-                    << "WARNING: vertex count (" << actualVertexCount 
-                    << ") is not as claimed (" << claimedVertexCount_ << ")";
-            }
-
-            vertexData->vertexCount = actualVertexCount;
-            // Now create the vertex buffer
-            HardwareVertexBufferSharedPtr vbuf = HardwareBufferManager::getSingleton().
-                createVertexBuffer(offset, vertexData->vertexCount, 
-                    HardwareBuffer::HBU_STATIC_WRITE_ONLY, false);
-            // Bind it
-            bind->setBinding(bufCount, vbuf);
-            // Lock it
-            pVert = static_cast<unsigned char*>(
-                vbuf->lock(HardwareBuffer::HBL_DISCARD));
+                mVertices.resize(mVertices.size() + vertexSize);
+                unsigned char* pVert = &mVertices[mVertices.size() - vertexSize];
+                ++actualVertexCount;
 
-            // Get the element list for this buffer alone
-            VertexDeclaration::VertexElementList elems = decl->findElementsBySource(bufCount);
-            // Now the buffer is set up, parse all the vertices
-            for (TiXmlElement* vertexElem = vbElem->FirstChildElement();
-            vertexElem != 0; vertexElem = vertexElem->NextSiblingElement())
-            {
                 // Now parse the elements, ensure they are all matched
-                VertexDeclaration::VertexElementList::const_iterator ielem, ielemend;
-                TiXmlElement* xmlElem;
-                TiXmlElement* texCoordElem = 0;
-                ielemend = elems.end();
-                for (ielem = elems.begin(); ielem != ielemend; ++ielem)
+                std::fill(found.begin(), found.end(), false);
+                size_t texCoordsRead = 0;
+                size_t vertexDepth = reader.getDepth();
+                while (reader.nextChildElement(vertexDepth))
                 {
-                    const VertexElement& elem = *ielem;
-                    // Find child for this element
-                    switch(elem.getSemantic())
+                    const char* name = reader.getName();
+                    const bool isTexCoord = !strcmp(name, "texcoord");
+                    // The nth <texcoord> holds the nth texture coordinate element
+                    size_t e = 0, texCoord = 0;
+                    for (; e < elems.size(); ++e)
                     {
-                    case VES_POSITION:
-                        xmlElem = vertexElem->FirstChildElement("position");
-                        if (!xmlElem)
-                        {
-                            OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Missing <position> element.",
-                                "XMLSerializer::readGeometry");
-                        }
-                        elem.baseVertexPointerToElement(pVert, &pFloat);
+                        if (elemNames[e] && !strcmp(elemNames[e], name) &&
+                            (!isTexCoord || texCoord++ == texCoordsRead))
+                            break;
+                    }
+                    if (isTexCoord)
+                        ++texCoordsRead;
+                    if (e == elems.size() || found[e])
+                        continue;
+
+                    found[e] = true;
+                    readVertexElement(reader, elems[e], pVert);
+
+                    if (elems[e].getSemantic() == VES_POSITION)
+                    {
+                        pos.x = reader.getRealAttribute("x");
+                        pos.y = reader.getRealAttribute("y");
+                        pos.z = reader.getRealAttribute("z");
 
-                        *pFloat++ = StringConverter::parseReal(
-                            xmlElem->Attribute("x"));
-                        *pFloat++ = StringConverter::parseReal(
-                            xmlElem->Attribute("y"));
-                        *pFloat++ = StringConverter::parseReal(
-                            xmlElem->Attribute("z"));
-
-                        pos.x = StringConverter::parseReal(
-                            xmlElem->Attribute("x"));
-                        pos.y = StringConverter::parseReal(
-                            xmlElem->Attribute("y"));
-                        pos.z = StringConverter::parseReal(
-                            xmlElem->Attribute("z"));
-                        
                         if (first)
                         {
                             min = max = pos;
@@ -1108,236 +1122,37 @@ namespace Ogre {
                             max.makeCeil(pos);
                             maxSquaredRadius = std::max(pos.squaredLength(), maxSquaredRadius);
                         }
-                        break;
-                    case VES_NORMAL:
-                        xmlElem = vertexElem->FirstChildElement("normal");
-                        if (!xmlElem)
-                        {
-                            OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Missing <normal> element.",
-                                "XMLSerializer::readGeometry");
-                        }
-                        elem.baseVertexPointerToElement(pVert, &pFloat);
-
-                        *pFloat++ = StringConverter::parseReal(
-                            xmlElem->Attribute("x"));
-                        *pFloat++ = StringConverter::parseReal(
-                            xmlElem->Attribute("y"));
-                        *pFloat++ = StringConverter::parseReal(
-                            xmlElem->Attribute("z"));
-                        break;
-                    case VES_TANGENT:
-                        xmlElem = vertexElem->FirstChildElement("tangent");
-                        if (!xmlElem)
-                        {
-                            OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Missing <tangent> element.",
-                                "XMLSerializer::readGeometry");
-                        }
-                        elem.baseVertexPointerToElement(pVert, &pFloat);
-
-                        *pFloat++ = StringConverter::parseReal(
-                            xmlElem->Attribute("x"));
-                        *pFloat++ = StringConverter::parseReal(
-                            xmlElem->Attribute("y"));
-                        *pFloat++ = StringConverter::parseReal(
-                            xmlElem->Attribute("z"));
-                        if (elem.getType() == VET_FLOAT4)
-                        {
-                            *pFloat++ = StringConverter::parseReal(
-                                xmlElem->Attribute("w"));
-                        }
-                        break;
-                    case VES_BINORMAL:
-                        xmlElem = vertexElem->FirstChildElement("binormal");
-                        if (!xmlElem)
-                        {
-                            OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Missing <binormal> element.",
-                                "XMLSerializer::readGeometry");
-                        }
-                        elem.baseVertexPointerToElement(pVert, &pFloat);
-
-                        *pFloat++ = StringConverter::parseReal(
-                            xmlElem->Attribute("x"));
-                        *pFloat++ = StringConverter::parseReal(
-                            xmlElem->Attribute("y"));
-                        *pFloat++ = StringConverter::parseReal(
-                            xmlElem->Attribute("z"));
-                        break;
-                    case VES_DIFFUSE:
-                        xmlElem = vertexElem->FirstChildElement("colour_diffuse");
-                        if (!xmlElem)
-                        {
-                            OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Missing <colour_diffuse> element.",
-                                "XMLSerializer::readGeometry");
-                        }
-                        elem.baseVertexPointerToElement(pVert, &pCol);
-                        {
-                            ColourValue cv;
-                            cv = StringConverter::parseColourValue(
-                                xmlElem->Attribute("value"));
-                            *pCol++ = VertexElement::convertColourValue(cv, mColourElementType);
-                        }
-                        break;
-                    case VES_SPECULAR:
-                        xmlElem = vertexElem->FirstChildElement("colour_specular");
-                        if (!xmlElem)
-                        {
-                            OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Missing <colour_specular> element.",
-                                "XMLSerializer::readGeometry");
-                        }
-                        elem.baseVertexPointerToElement(pVert, &pCol);
-                        {
-                            ColourValue cv;
-                            cv = StringConverter::parseColourValue(
-                                xmlElem->Attribute("value"));
-                            *pCol++ = VertexElement::convertColourValue(cv, mColourElementType);
-                        }
-                        break;
-                    case VES_TEXTURE_COORDINATES:
-                        if (!texCoordElem)
-                        {
-                            // Get first texcoord
-                            xmlElem = vertexElem->FirstChildElement("texcoord");
-                        }
-                        else
-                        {
-                            // Get next texcoord
-                            xmlElem = texCoordElem->NextSiblingElement("texcoord");
-                        }
-                        if (!xmlElem)
-                        {
-                            OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Missing <texcoord> element.",
-                                "XMLSerializer::readGeometry");
-                        }
-                        // Record the latest texture coord entry
-                        texCoordElem = xmlElem;
-
-                        if (!xmlElem->Attribute("u"))
-                            OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Texcoord 'u' attribute not found.", "XMLMeshSerializer::readGeometry");
-                        
-                        // depending on type, pack appropriately, can process colour channels separately which is a bonus
-                        switch (elem.getType()) 
-                        {
-                        case VET_FLOAT1:
-                            elem.baseVertexPointerToElement(pVert, &pFloat);
-                            *pFloat++ = StringConverter::parseReal(xmlElem->Attribute("u"));
-                            break;
-
-                        case VET_FLOAT2:
-                            if (!xmlElem->Attribute("v"))
-                                OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Texcoord 'v' attribute not found.", "XMLMeshSerializer::readGeometry");
-                            elem.baseVertexPointerToElement(pVert, &pFloat);
-                            *pFloat++ = StringConverter::parseReal(xmlElem->Attribute("u"));
-                            *pFloat++ = StringConverter::parseReal(xmlElem->Attribute("v"));
-                            break;
-
-                        case VET_FLOAT3:
-                            if (!xmlElem->Attribute("v"))
-                                OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Texcoord 'v' attribute not found.", "XMLMeshSerializer::readGeometry");
-                            if (!xmlElem->Attribute("w"))
-                                OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Texcoord 'w' attribute not found.", "XMLMeshSerializer::readGeometry");
-                            elem.baseVertexPointerToElement(pVert, &pFloat);
-                            *pFloat++ = StringConverter::parseReal(xmlElem->Attribute("u"));
-                            *pFloat++ = StringConverter::parseReal(xmlElem->Attribute("v"));
-                            *pFloat++ = StringConverter::parseReal(xmlElem->Attribute("w"));
-                            break;
-
-                        case VET_FLOAT4:
-                            if (!xmlElem->Attribute("v"))
-                                OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Texcoord 'v' attribute not found.", "XMLMeshSerializer::readGeometry");
-                            if (!xmlElem->Attribute("w"))
-                                OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Texcoord 'w' attribute not found.", "XMLMeshSerializer::readGeometry");
-                            if (!xmlElem->Attribute("x"))
-                                OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Texcoord 'x' attribute not found.", "XMLMeshSerializer::readGeometry");
-                            elem.baseVertexPointerToElement(pVert, &pFloat);
-                            *pFloat++ = StringConverter::parseReal(xmlElem->Attribute("u"));
-                            *pFloat++ = StringConverter::parseReal(xmlElem->Attribute("v"));
-                            *pFloat++ = StringConverter::parseReal(xmlElem->Attribute("w"));
-                            *pFloat++ = StringConverter::parseReal(xmlElem->Attribute("x"));
-                            break;
-
-                        case VET_SHORT1:
-                            elem.baseVertexPointerToElement(pVert, &pShort);
-                            *pShort++ = static_cast<uint16>(65535.0f * StringConverter::parseReal(xmlElem->Attribute("u")));
-                            break;
-
-                        case VET_SHORT2:
-                            if (!xmlElem->Attribute("v"))
-                                OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Texcoord 'v' attribute not found.", "XMLMeshSerializer::readGeometry");
-                            elem.baseVertexPointerToElement(pVert, &pShort);
-                            *pShort++ = static_cast<uint16>(65535.0f * StringConverter::parseReal(xmlElem->Attribute("u")));
-                            *pShort++ = static_cast<uint16>(65535.0f * StringConverter::parseReal(xmlElem->Attribute("v")));
-                            break;
-
-                        case VET_SHORT3:
-                            if (!xmlElem->Attribute("v"))
-                                OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Texcoord 'v' attribute not found.", "XMLMeshSerializer::readGeometry");
-                            if (!xmlElem->Attribute("w"))
-                                OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Texcoord 'w' attribute not found.", "XMLMeshSerializer::readGeometry");
-                            elem.baseVertexPointerToElement(pVert, &pShort);
-                            *pShort++ = static_cast<uint16>(65535.0f * StringConverter::parseReal(xmlElem->Attribute("u")));
-                            *pShort++ = static_cast<uint16>(65535.0f * StringConverter::parseReal(xmlElem->Attribute("v")));
-                            *pShort++ = static_cast<uint16>(65535.0f * StringConverter::parseReal(xmlElem->Attribute("w")));
-                            break;
-
-                        case VET_SHORT4:
-                            if (!xmlElem->Attribute("v"))
-                                OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Texcoord 'v' attribute not found.", "XMLMeshSerializer::readGeometry");
-                            if (!xmlElem->Attribute("w"))
-                                OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Texcoord 'w' attribute not found.", "XMLMeshSerializer::readGeometry");
-                            if (!xmlElem->Attribute("x"))
-                                OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Texcoord 'x' attribute not found.", "XMLMeshSerializer::readGeometry");
-                            elem.baseVertexPointerToElement(pVert, &pShort);
-                            *pShort++ = static_cast<uint16>(65535.0f * StringConverter::parseReal(xmlElem->Attribute("u")));
-                            *pShort++ = static_cast<uint16>(65535.0f * StringConverter::parseReal(xmlElem->Attribute("v")));
-                            *pShort++ = static_cast<uint16>(65535.0f * StringConverter::parseReal(xmlElem->Attribute("w")));
-                            *pShort++ = static_cast<uint16>(65535.0f * StringConverter::parseReal(xmlElem->Attribute("x")));
-                            break;
-
-                        case VET_UBYTE4:
-                            if (!xmlElem->Attribute("v"))
-                                OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Texcoord 'v' attribute not found.", "XMLMeshSerializer::readGeometry");
-                            if (!xmlElem->Attribute("w"))
-                                OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Texcoord 'w' attribute not found.", "XMLMeshSerializer::readGeometry");
-                            if (!xmlElem->Attribute("x"))
-                                OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Texcoord 'x' attribute not found.", "XMLMeshSerializer::readGeometry");
-                            elem.baseVertexPointerToElement(pVert, &pChar);
-                            // round off instead of just truncating -- avoids magnifying rounding errors
-                            *pChar++ = static_cast<uint8>(0.5f + 255.0f * StringConverter::parseReal(xmlElem->Attribute("u")));
-                            *pChar++ = static_cast<uint8>(0.5f + 255.0f * StringConverter::parseReal(xmlElem->Attribute("v")));
-                            *pChar++ = static_cast<uint8>(0.5f + 255.0f * StringConverter::parseReal(xmlElem->Attribute("w")));
-                            *pChar++ = static_cast<uint8>(0.5f + 255.0f * StringConverter::parseReal(xmlElem->Attribute("x")));
-                            break;
-
-                        case VET_COLOUR: 
-                            {
-                                elem.baseVertexPointerToElement(pVert, &pCol);
-                                ColourValue cv = StringConverter::parseColourValue(xmlElem->Attribute("u"));
-                                *pCol++ = VertexElement::convertColourValue(cv, mColourElementType);
-                            }
-                            break;
-
-                        case VET_COLOUR_ARGB:
-                        case VET_COLOUR_ABGR: 
-                            {
-                                elem.baseVertexPointerToElement(pVert, &pCol);
-                                ColourValue cv = StringConverter::parseColourValue(xmlElem->Attribute("u"));
-                                *pCol++ = VertexElement::convertColourValue(cv, elem.getType());
-                            }
-                            break;
-                        default:
-                            OgreAssert(false, "Unsupported VET");
-                            break;
-                        }
+                    }
+                }
 
-                        break;
-                    default:
-                        break;
+                for (size_t e = 0; e < elems.size(); ++e)
+                {
+                    if (!found[e])
+                    {
+                        OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND,
+                            "Missing <" + String(elemNames[e]) + "> element.",
+                            "XMLSerializer::readGeometry");
                     }
-                } // semantic
-                pVert += vbuf->getVertexSize();
+                }
             } // vertex
+
+            if (claimedVertexCount_ && static_cast<ptrdiff_t>(actualVertexCount) != claimedVertexCount)
+            {
+                LogManager::getSingleton().stream()
+                    << "WARNING: vertex count (" << actualVertexCount 
+                    << ") is not as claimed (" << claimedVertexCount_ << ")";
+            }
+
+            vertexData->vertexCount = actualVertexCount;
+            // Now create the vertex buffer
+            HardwareVertexBufferSharedPtr vbuf = HardwareBufferManager::getSingleton().
+                createVertexBuffer(offset, vertexData->vertexCount, 
+                    HardwareBuffer::HBU_STATIC_WRITE_ONLY, false);
+            // Bind it
+            bind->setBinding(bufCount, vbuf);
+            if (!mVertices.empty())
+                vbuf->writeData(0, mVertices.size(), &mVertices[0], true);
             bufCount++;
-            vbuf->unlock();
         } // vertexbuffer
 
         // Set bounds
@@ -1362,48 +1177,123 @@ namespace Ogre {
         LogManager::getSingleton().logMessage("Geometry done...");
     }
     //---------------------------------------------------------------------
+    void XMLMeshSerializer::readVertexElement(XMLStreamReader& reader, const VertexElement& elem,
+        unsigned char* pVert)
+    {
+        static const char* texCoordNames[] = { "u", "v", "w", "x" };
+        float *pFloat;
+        uint16 *pShort;
+        uint8 *pChar;
+        ARGB *pCol;
+        unsigned short count = VertexElement::getTypeCount(elem.getType());
+
+        switch(elem.getSemantic())
+        {
+        case VES_POSITION:
+        case VES_NORMAL:
+        case VES_TANGENT:
+        case VES_BINORMAL:
+            elem.baseVertexPointerToElement(pVert, &pFloat);
+            *pFloat++ = reader.getRealAttribute("x");
+            *pFloat++ = reader.getRealAttribute("y");
+            *pFloat++ = reader.getRealAttribute("z");
+            if (elem.getType() == VET_FLOAT4)
+                *pFloat++ = reader.getRealAttribute("w");
+            break;
+        case VES_DIFFUSE:
+        case VES_SPECULAR:
+            elem.baseVertexPointerToElement(pVert, &pCol);
+            *pCol = VertexElement::convertColourValue(
+                reader.getColourAttribute("value"), mColourElementType);
+            break;
+        case VES_TEXTURE_COORDINATES:
+            // depending on type, pack appropriately, can process colour channels separately which is a bonus
+            switch (elem.getType()) 
+            {
+            case VET_FLOAT1:
+            case VET_FLOAT2:
+            case VET_FLOAT3:
+            case VET_FLOAT4:
+                elem.baseVertexPointerToElement(pVert, &pFloat);
+                for (unsigned short i = 0; i < count; ++i)
+                    *pFloat++ = reader.getRealAttribute(texCoordNames[i]);
+                break;
+
+            case VET_SHORT1:
+            case VET_SHORT2:
+            case VET_SHORT3:
+            case VET_SHORT4:
+                elem.baseVertexPointerToElement(pVert, &pShort);
+                for (unsigned short i = 0; i < count; ++i)
+                    *pShort++ = static_cast<uint16>(65535.0f * reader.getRealAttribute(texCoordNames[i]));
+                break;
+
+            case VET_UBYTE4:
+                elem.baseVertexPointerToElement(pVert, &pChar);
+                // round off instead of just truncating -- avoids magnifying rounding errors
+                for (unsigned short i = 0; i < count; ++i)
+                    *pChar++ = static_cast<uint8>(0.5f + 255.0f * reader.getRealAttribute(texCoordNames[i]));
+                break;
+
+            case VET_COLOUR: 
+                elem.baseVertexPointerToElement(pVert, &pCol);
+                *pCol = VertexElement::convertColourValue(
+                    reader.getColourAttribute("u"), mColourElementType);
+                break;
+
+            case VET_COLOUR_ARGB:
+            case VET_COLOUR_ABGR: 
+                elem.baseVertexPointerToElement(pVert, &pCol);
+                *pCol = VertexElement::convertColourValue(
+                    reader.getColourAttribute("u"), elem.getType());
+                break;
+            default:
+                OgreAssert(false, "Unsupported VET");
+                break;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    //---------------------------------------------------------------------
     void XMLMeshSerializer::readSkeletonLink(TiXmlElement* mSkelNode)
     {
         mMesh->setSkeletonName(mSkelNode->Attribute("name"));
     }
     //---------------------------------------------------------------------
-    void XMLMeshSerializer::readBoneAssignments(TiXmlElement* mBoneAssignmentsNode)
+    void XMLMeshSerializer::readBoneAssignments(XMLStreamReader& reader, SubMesh* sm)
     {
         LogManager::getSingleton().logMessage("Reading bone assignments...");
 
         // Iterate over all children (vertexboneassignment entries)
-        for (TiXmlElement* elem = mBoneAssignmentsNode->FirstChildElement();
-        elem != 0; elem = elem->NextSiblingElement())
+        size_t depth = reader.getDepth();
+        while (reader.nextChildElement(depth))
         {
             VertexBoneAssignment vba;
-            vba.vertexIndex = StringConverter::parseInt(
-                elem->Attribute("vertexindex"));
-            vba.boneIndex = StringConverter::parseInt(
-                elem->Attribute("boneindex"));
-            vba.weight= StringConverter::parseReal(
-                elem->Attribute("weight"));
-
-            mMesh->addBoneAssignment(vba);
+            vba.vertexIndex = reader.getIntAttribute("vertexindex");
+            vba.boneIndex = reader.getIntAttribute("boneindex");
+            vba.weight = reader.getRealAttribute("weight");
+
+            if (sm)
+                sm->addBoneAssignment(vba);
+            else
+                mMesh->addBoneAssignment(vba);
         }
 
         LogManager::getSingleton().logMessage("Bone assignments done.");
     }
     //---------------------------------------------------------------------
-    void XMLMeshSerializer::readTextureAliases(TiXmlElement* mTextureAliasesNode, SubMesh* subMesh)
+    void XMLMeshSerializer::readTextureAliases(XMLStreamReader& reader, SubMesh* subMesh)
     {
         LogManager::getSingleton().logMessage("Reading sub mesh texture aliases...");
 
         // Iterate over all children (texture entries)
-        for (TiXmlElement* elem = mTextureAliasesNode->FirstChildElement();
-             elem != 0; elem = elem->NextSiblingElement())
+        size_t depth = reader.getDepth();
+        while (reader.nextChildElement(depth))
         {
             // pass alias and texture name to submesh
-            // read attribute "alias"
-            String alias = elem->Attribute("alias");
-            // read attribute "name"
-            String name = elem->Attribute("name");
-
-            subMesh->addTextureAlias(alias, name);
+            subMesh->addTextureAlias(reader.getAttribute("alias"), reader.getAttribute("name"));
         }
 
         LogManager::getSingleton().logMessage("Texture aliases done.");
@@ -1426,26 +1316,6 @@ namespace Ogre {
         LogManager::getSingleton().logMessage("Mesh names done.");
     }
     //---------------------------------------------------------------------
-    void XMLMeshSerializer::readBoneAssignments(TiXmlElement* mBoneAssignmentsNode, SubMesh* sm)
-    {
-        LogManager::getSingleton().logMessage("Reading bone assignments...");
-        // Iterate over all children (vertexboneassignment entries)
-        for (TiXmlElement* elem = mBoneAssignmentsNode->FirstChildElement();
-        elem != 0; elem = elem->NextSiblingElement())
-        {
-            VertexBoneAssignment vba;
-            vba.vertexIndex = StringConverter::parseInt(
-                elem->Attribute("vertexindex"));
-            vba.boneIndex = StringConverter::parseInt(
-                elem->Attribute("boneindex"));
-            vba.weight= StringConverter::parseReal(
-                elem->Attribute("weight"));
-
-            sm->addBoneAssignment(vba);
-        }
-        LogManager::getSingleton().logMessage("Bone assignments done.");
-    }
-    //---------------------------------------------------------------------
     void XMLMeshSerializer::writeLodInfo(TiXmlElement* mMeshNode, const Mesh* pMesh)
     {
         TiXmlElement* lodNode = 
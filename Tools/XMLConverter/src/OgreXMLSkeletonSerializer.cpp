@@ -592,7 +592,15 @@ namespace Ogre {
             trackNode->InsertEndChild(TiXmlElement("keyframes"))->ToElement();
         for (unsigned short i = 0; i < track->getNumKeyFrames(); ++i)
         {
-            writeKeyFrame(keysNode, track->getNodeKeyFrame(i));
+            // Copied out, as a compressed track has no keyframe objects
+            Quaternion rotate;
+            Vector3 translate, scale;
+            track->getKeyTransform(i, rotate, translate, scale);
+            TransformKeyFrame key(track, track->getKeyTime(i));
+            key.setRotation(rotate);
+            key.setTranslate(translate);
+            key.setScale(scale);
+            writeKeyFrame(keysNode, &key);
         }
     }
     //---------------------------------------------------------------------
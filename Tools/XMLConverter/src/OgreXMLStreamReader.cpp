@@ -0,0 +1,431 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreXMLStreamReader.h"
+#include "OgreException.h"
+#include <algorithm>
+
+namespace Ogre {
+
+    namespace {
+        const char* WHITESPACE = " \t\r\n";
+    }
+    //---------------------------------------------------------------------
+    XMLStreamReader::XMLStreamReader(const DataStreamPtr& stream, size_t bufferSize)
+        : mStream(stream), mBuffer(std::max<size_t>(bufferSize, 16) + 1), mPos(0), mEnd(0),
+        mBufferOffset(0), mDepth(0), mPendingEnd(false), mName("")
+    {
+        mBuffer[0] = 0;
+    }
+    //---------------------------------------------------------------------
+    XMLStreamReader::Event XMLStreamReader::next(void)
+    {
+        if (mPendingEnd)
+        {
+            mPendingEnd = false;
+            --mDepth;
+            return END_ELEMENT;
+        }
+
+        while (true)
+        {
+            // Skip any text up to the next tag
+            const char* lt = mPos < mEnd ?
+                static_cast<const char*>(memchr(&mBuffer[mPos], '<', mEnd - mPos)) : 0;
+            if (!lt)
+            {
+                mPos = mEnd;
+                if (!readMore())
+                {
+                    if (mDepth)
+                        malformed("unexpected end of document");
+                    return END_DOCUMENT;
+                }
+                continue;
+            }
+            mPos = lt - &mBuffer[0];
+
+            // Enough to tell the kinds of tag apart
+            while (mEnd - mPos < 9 && readMore()) {}
+            const char* tag = &mBuffer[mPos];
+            const size_t avail = mEnd - mPos;
+            if (avail < 2)
+                malformed("unexpected end of document");
+
+            if (avail >= 4 && !memcmp(tag, "<!--", 4))
+            {
+                mPos += find("-->", 4) + 3;
+            }
+            else if (avail >= 9 && !memcmp(tag, "<![CDATA[", 9))
+            {
+                mPos += find("]]>", 9) + 3;
+            }
+            else if (tag[1] == '?')
+            {
+                mPos += find("?>", 2) + 2;
+            }
+            else if (tag[1] == '!')
+            {
+                // Document type declaration, possibly with an internal subset
+                size_t end = find(">", 2);
+                if (memchr(&mBuffer[mPos], '[', end))
+                    end = find(">", find("]", 2));
+                mPos += end + 1;
+            }
+            else if (tag[1] == '/')
+            {
+                size_t end = find(">", 2);
+                char* name = &mBuffer[mPos + 2];
+                mBuffer[mPos + end] = 0;
+                name[strcspn(name, WHITESPACE)] = 0;
+                mName = name;
+                mAttributes.clear();
+                mPos += end + 1;
+                if (!mDepth)
+                    malformed("end tag without a start tag");
+                --mDepth;
+                return END_ELEMENT;
+            }
+            else
+            {
+                // Find the end of the start tag; '>' may appear in attribute values
+                size_t i = 1;
+                char quote = 0;
+                while (true)
+                {
+                    if (mPos + i >= mEnd)
+                    {
+                        if (!readMore())
+                            malformed("unexpected end of document");
+                        continue;
+                    }
+                    char c = mBuffer[mPos + i];
+                    if (quote)
+                    {
+                        if (c == quote)
+                            quote = 0;
+                    }
+                    else if (c == '"' || c == '\'')
+                    {
+                        quote = c;
+                    }
+                    else if (c == '>')
+                    {
+                        break;
+                    }
+                    ++i;
+                }
+                parseStartTag(i);
+                mPos += i + 1;
+                ++mDepth;
+                return START_ELEMENT;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    bool XMLStreamReader::nextChildElement(size_t depth)
+    {
+        while (true)
+        {
+            switch (next())
+            {
+            case START_ELEMENT:
+                if (mDepth == depth + 1)
+                    return true;
+                break;
+            case END_ELEMENT:
+                if (mDepth < depth)
+                    return false;
+                break;
+            case END_DOCUMENT:
+                malformed("unexpected end of document");
+                break;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    TiXmlElement* XMLStreamReader::readElement(void)
+    {
+        const size_t depth = mDepth;
+        TiXmlElement* root = new TiXmlElement(mName);
+        for (vector<Attribute>::type::const_iterator a = mAttributes.begin(); a != mAttributes.end(); ++a)
+            root->SetAttribute(a->first, a->second);
+
+        try
+        {
+            TiXmlElement* parent = root;
+            while (true)
+            {
+                Event event = next();
+                if (event == START_ELEMENT)
+                {
+                    TiXmlElement* elem = new TiXmlElement(mName);
+                    for (vector<Attribute>::type::const_iterator a = mAttributes.begin();
+                         a != mAttributes.end(); ++a)
+                    {
+                        elem->SetAttribute(a->first, a->second);
+                    }
+                    parent->LinkEndChild(elem);
+                    parent = elem;
+                }
+                else if (event == END_ELEMENT)
+                {
+                    if (mDepth < depth)
+                        break;
+                    parent = parent->Parent()->ToElement();
+                }
+                else
+                {
+                    malformed("unexpected end of document");
+                }
+            }
+        }
+        catch (...)
+        {
+            delete root;
+            throw;
+        }
+        return root;
+    }
+    //---------------------------------------------------------------------
+    const char* XMLStreamReader::getAttribute(const char* name) const
+    {
+        for (vector<Attribute>::type::const_iterator a = mAttributes.begin(); a != mAttributes.end(); ++a)
+        {
+            if (!strcmp(a->first, name))
+                return a->second;
+        }
+        return 0;
+    }
+    //---------------------------------------------------------------------
+    const char* XMLStreamReader::getRequiredAttribute(const char* name) const
+    {
+        const char* value = getAttribute(name);
+        if (!value)
+        {
+            OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND,
+                "Attribute '" + String(name) + "' of <" + mName + "> not found in " + mStream->getName(),
+                "XMLStreamReader::getRequiredAttribute");
+        }
+        return value;
+    }
+    //---------------------------------------------------------------------
+    Real XMLStreamReader::getRealAttribute(const char* name) const
+    {
+        return static_cast<Real>(strtod(getRequiredAttribute(name), 0));
+    }
+    //---------------------------------------------------------------------
+    int XMLStreamReader::getIntAttribute(const char* name) const
+    {
+        return static_cast<int>(strtol(getRequiredAttribute(name), 0, 10));
+    }
+    //---------------------------------------------------------------------
+    unsigned int XMLStreamReader::getUnsignedIntAttribute(const char* name) const
+    {
+        return static_cast<unsigned int>(strtoul(getRequiredAttribute(name), 0, 10));
+    }
+    //---------------------------------------------------------------------
+    ColourValue XMLStreamReader::getColourAttribute(const char* name) const
+    {
+        const char* p = getRequiredAttribute(name);
+        ColourValue ret;
+        size_t count = 0;
+        while (true)
+        {
+            char* end;
+            double d = strtod(p, &end);
+            if (end == p)
+                break;
+            if (count < 4)
+                ret.ptr()[count] = static_cast<float>(d);
+            ++count;
+            p = end;
+        }
+        if (count == 3)
+            ret.a = 1.0f;
+        else if (count != 4)
+            return ColourValue::Black;
+        return ret;
+    }
+    //---------------------------------------------------------------------
+    bool XMLStreamReader::readMore(void)
+    {
+        // Keep only the unread data
+        if (mPos)
+        {
+            memmove(&mBuffer[0], &mBuffer[mPos], mEnd - mPos);
+            mBufferOffset += mPos;
+            mEnd -= mPos;
+            mPos = 0;
+        }
+        // One byte is kept for a terminator
+        if (mEnd == mBuffer.size() - 1)
+            mBuffer.resize(mBuffer.size() * 2);
+
+        size_t count = mStream->read(&mBuffer[mEnd], mBuffer.size() - 1 - mEnd);
+        mEnd += count;
+        mBuffer[mEnd] = 0;
+        return count > 0;
+    }
+    //---------------------------------------------------------------------
+    size_t XMLStreamReader::find(const char* str, size_t from)
+    {
+        const size_t len = strlen(str);
+        while (true)
+        {
+            if (mEnd - mPos >= from + len)
+            {
+                const char* begin = &mBuffer[mPos];
+                const char* end = begin + (mEnd - mPos);
+                const char* found = std::search(begin + from, end, str, str + len);
+                if (found != end)
+                    return found - begin;
+                // The string may start in the last few bytes
+                from = mEnd - mPos - len + 1;
+            }
+            if (!readMore())
+                malformed("unexpected end of document");
+        }
+    }
+    //---------------------------------------------------------------------
+    void XMLStreamReader::parseStartTag(size_t length)
+    {
+        char* p = &mBuffer[mPos + 1];
+        char* end = &mBuffer[mPos + length];
+        mPendingEnd = end > p && end[-1] == '/';
+        if (mPendingEnd)
+            --end;
+        *end = 0;
+
+        mAttributes.clear();
+        mName = p;
+        p += strcspn(p, WHITESPACE);
+        if (*p)
+            *p++ = 0;
+        if (!*mName)
+            malformed("element without a name");
+
+        while (true)
+        {
+            p += strspn(p, WHITESPACE);
+            if (!*p)
+                break;
+            char* name = p;
+            p += strcspn(p, " \t\r\n=");
+            char* nameEnd = p;
+            p += strspn(p, WHITESPACE);
+            if (*p != '=')
+                malformed("attribute without a value in <" + String(mName) + ">");
+            ++p;
+            p += strspn(p, WHITESPACE);
+            if (*p != '"' && *p != '\'')
+                malformed("attribute value without quotes in <" + String(mName) + ">");
+            char* value = p + 1;
+            p = strchr(value, *p);
+            if (!p)
+                malformed("unterminated attribute value in <" + String(mName) + ">");
+            *nameEnd = 0;
+            *p++ = 0;
+            if (strchr(value, '&'))
+                decodeReferences(value);
+            mAttributes.push_back(Attribute(name, value));
+        }
+    }
+    //---------------------------------------------------------------------
+    void XMLStreamReader::decodeReferences(char* str)
+    {
+        // Every reference is at least as long as the UTF-8 it stands for
+        char* out = str;
+        const char* in = str;
+        while (*in)
+        {
+            const char* semi = *in == '&' ? strchr(in, ';') : 0;
+            if (!semi)
+            {
+                *out++ = *in++;
+                continue;
+            }
+
+            const char* ref = in + 1;
+            const size_t len = semi - ref;
+            unsigned long code = 0;
+            if (len == 3 && !memcmp(ref, "amp", 3))
+                code = '&';
+            else if (len == 2 && !memcmp(ref, "lt", 2))
+                code = '<';
+            else if (len == 2 && !memcmp(ref, "gt", 2))
+                code = '>';
+            else if (len == 4 && !memcmp(ref, "quot", 4))
+                code = '"';
+            else if (len == 4 && !memcmp(ref, "apos", 4))
+                code = '\'';
+            else if (len > 2 && ref[0] == '#' && ref[1] == 'x')
+                code = strtoul(ref + 2, 0, 16);
+            else if (len > 1 && ref[0] == '#')
+                code = strtoul(ref + 1, 0, 10);
+
+            if (!code || code > 0x10FFFF)
+            {
+                *out++ = *in++;
+                continue;
+            }
+            if (code < 0x80)
+            {
+                *out++ = static_cast<char>(code);
+            }
+            else if (code < 0x800)
+            {
+                *out++ = static_cast<char>(0xC0 | (code >> 6));
+                *out++ = static_cast<char>(0x80 | (code & 0x3F));
+            }
+            else if (code < 0x10000)
+            {
+                *out++ = static_cast<char>(0xE0 | (code >> 12));
+                *out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                *out++ = static_cast<char>(0x80 | (code & 0x3F));
+            }
+            else
+            {
+                *out++ = static_cast<char>(0xF0 | (code >> 18));
+                *out++ = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                *out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                *out++ = static_cast<char>(0x80 | (code & 0x3F));
+            }
+            in = semi + 1;
+        }
+        *out = 0;
+    }
+    //---------------------------------------------------------------------
+    void XMLStreamReader::malformed(const String& what) const
+    {
+        StringStream str;
+        str << "Malformed XML in " << mStream->getName() << " near byte "
+            << mBufferOffset + mPos << ": " << what;
+        OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, str.str(), "XMLStreamReader");
+    }
+}
@@ -33,7 +33,9 @@ THE SOFTWARE.
 #include "OgreXMLSkeletonSerializer.h"
 #include "OgreSkeletonSerializer.h"
 #include "OgreXMLPrerequisites.h"
+#include "OgreXMLStreamReader.h"
 #include "OgreDefaultHardwareBufferManager.h"
+#include "Threading/OgreDefaultWorkQueue.h"
 #include "OgreMeshLodGenerator.h"
 #include "OgreDistanceLodStrategy.h"
 #include "OgreLodStrategyManager.h"
@@ -75,6 +77,9 @@ struct XmlOptions
     bool d3d;
     bool gl;
     Serializer::Endian endian;
+    // Files of a batch conversion, empty for a single conversion
+    StringVector batchSources;
+    size_t numThreads;
 };
 
 void print_version(void)
@@ -91,6 +96,7 @@ void help(void)
     cout << endl << "OgreXMLConvert: Converts data between XML and OGRE binary formats." << endl;
     cout << "Provided for OGRE by Steve Streeting" << endl << endl;
     cout << "Usage: OgreXMLConverter [options] sourcefile [destfile] " << endl;
+    cout << "       OgreXMLConverter [options] -batch sourcefile... " << endl;
     cout << endl << "Available options:" << endl;
     cout << "-v             = Display version information" << endl;
     cout << "-merge [n0,n1] = Merge texcoordn0 with texcoordn1. The , separator must be" << endl;
@@ -104,6 +110,9 @@ void help(void)
     cout << "-x num         = Generate no more than num eXtremes for every submesh (default 0)" << endl;
     cout << "-q             = Quiet mode, less output" << endl;
     cout << "-log filename  = name of the log file (default: 'OgreXMLConverter.log')" << endl;
+    cout << "-batch         = Convert every following file, working out each destfile" << endl;
+    cout << "-j num         = Convert up to num files of a batch at once" << endl;
+    cout << "                 (default: the number of hardware threads)" << endl;
     cout << "sourcefile     = name of file to convert" << endl;
     cout << "destfile       = optional name of file to write to. If you don't" << endl;
     cout << "                 specify this OGRE works it out through the extension " << endl;
@@ -115,6 +124,41 @@ void help(void)
 }
 
 
+/// Sets the source and destination of a conversion, working out the destination if dest is empty
+void setFiles(XmlOptions& opts, const String& source, const String& dest)
+{
+    // Work out what kind of conversion this is
+    opts.source = source;
+    Ogre::vector<String>::type srcparts = StringUtil::split(opts.source, ".");
+    String& ext = srcparts.back();
+    StringUtil::toLowerCase(ext);
+    opts.sourceExt = ext;
+
+    if (dest.empty())
+    {
+        if (opts.sourceExt == "xml")
+        {
+            // dest is source minus .xml
+            opts.dest = opts.source.substr(0, opts.source.size() - 4);
+        }
+        else
+        {
+            // dest is source + .xml
+            opts.dest = opts.source;
+            opts.dest.append(".xml");
+        }
+
+    }
+    else
+    {
+        opts.dest = dest;
+    }
+    Ogre::vector<String>::type dstparts = StringUtil::split(opts.dest, ".");
+    ext = dstparts.back();
+    StringUtil::toLowerCase(ext);
+    opts.destExt = ext;
+}
+
 XmlOptions parseArgs(int numArgs, char **args)
 {
     XmlOptions opts;
@@ -138,6 +182,11 @@ XmlOptions parseArgs(int numArgs, char **args)
     opts.optimiseAnimations = true;
     opts.quietMode = false;
     opts.endian = Serializer::ENDIAN_NATIVE;
+#if OGRE_THREAD_SUPPORT
+    opts.numThreads = OGRE_THREAD_HARDWARE_CONCURRENCY;
+#else
+    opts.numThreads = 1;
+#endif
 
     // ignore program name
     char* source = 0;
@@ -159,6 +208,7 @@ XmlOptions parseArgs(int numArgs, char **args)
     unOpt["-gl"] = false;
     unOpt["-h"] = false;
     unOpt["-v"] = false;
+    unOpt["-batch"] = false;
     //binOpt["-l"] = "";
     //binOpt["-s"] = "Distance";
     //binOpt["-p"] = "";
@@ -169,6 +219,7 @@ XmlOptions parseArgs(int numArgs, char **args)
     binOpt["-td"] = "";
     binOpt["-ts"] = "";
     binOpt["-merge"] = "0,0";
+    binOpt["-j"] = "";
 
     int startIndex = findCommandLineOpts(numArgs, args, unOpt, binOpt);
     UnaryOptionList::iterator ui;
@@ -267,6 +318,37 @@ XmlOptions parseArgs(int numArgs, char **args)
             opts.d3d = false;
         }
 
+        bi = binOpt.find("-j");
+        if (!bi->second.empty())
+        {
+            opts.numThreads = StringConverter::parseUnsignedInt(bi->second);
+        }
+        opts.numThreads = std::max<size_t>(opts.numThreads, 1);
+
+    ui = unOpt.find("-batch");
+    if (ui->second)
+    {
+        for (int i = startIndex; i < numArgs; ++i)
+            opts.batchSources.push_back(args[i]);
+        if (opts.batchSources.empty())
+        {
+            cout << "Missing source files - abort. " << endl;
+            help();
+            exit(1);
+        }
+        if (!opts.quietMode)
+        {
+            cout << endl;
+            cout << "-- OPTIONS --" << endl;
+            cout << "source files     = " << opts.batchSources.size() << endl;
+            cout << "files at once    = " << opts.numThreads << endl;
+            cout << "log file         = " << opts.logFile << endl;
+            cout << "-- END OPTIONS --" << endl;
+            cout << endl;
+        }
+        return opts;
+    }
+
     // Source / dest
     if (numArgs > startIndex)
         source = args[startIndex];
@@ -284,36 +366,7 @@ XmlOptions parseArgs(int numArgs, char **args)
         help();
         exit(1);
     }
-    // Work out what kind of conversion this is
-    opts.source = source;
-    Ogre::vector<String>::type srcparts = StringUtil::split(opts.source, ".");
-    String& ext = srcparts.back();
-    StringUtil::toLowerCase(ext);
-    opts.sourceExt = ext;
-
-    if (!dest)
-    {
-        if (opts.sourceExt == "xml")
-        {
-            // dest is source minus .xml
-            opts.dest = opts.source.substr(0, opts.source.size() - 4);
-        }
-        else
-        {
-            // dest is source + .xml
-            opts.dest = opts.source;
-            opts.dest.append(".xml");
-        }
-
-    }
-    else
-    {
-        opts.dest = dest;
-    }
-    Ogre::vector<String>::type dstparts = StringUtil::split(opts.dest, ".");
-    ext = dstparts.back();
-    StringUtil::toLowerCase(ext);
-    opts.destExt = ext;
+    setFiles(opts, source, dest ? dest : "");
 
     if (!opts.quietMode) 
     {
@@ -345,58 +398,59 @@ Math* mth = 0;
 LodStrategyManager *lodMgr = 0;
 MaterialManager* matMgr = 0;
 SkeletonManager* skelMgr = 0;
-MeshSerializer* meshSerializer = 0;
-XMLMeshSerializer* xmlMeshSerializer = 0;
-SkeletonSerializer* skeletonSerializer = 0;
-XMLSkeletonSerializer* xmlSkeletonSerializer = 0;
 DefaultHardwareBufferManager *bufferManager = 0;
 MeshManager* meshMgr = 0;
 ResourceGroupManager* rgm = 0;
 
+// Each conversion has its own serializers, and names its resources after
+// its source file, so that the files of a batch can be converted at once.
 
-void meshToXML(XmlOptions opts)
+void meshToXML(const XmlOptions& opts)
 {
     std::ifstream ifs;
     ifs.open(opts.source.c_str(), std::ios_base::in | std::ios_base::binary);
 
-    if (ifs.bad())
+    if (!ifs)
     {
-        cout << "Unable to load file " << opts.source << endl;
-        exit(1);
+        OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "Unable to load file " + opts.source, "meshToXML");
     }
 
     // pass false for freeOnClose to FileStreamDataStream since ifs is created on stack
     DataStreamPtr stream(new FileStreamDataStream(opts.source, &ifs, false));
 
-    MeshPtr mesh = MeshManager::getSingleton().create("conversion", 
+    MeshPtr mesh = MeshManager::getSingleton().create(opts.source, 
         ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
     
 
-    meshSerializer->importMesh(stream, mesh.getPointer());
+    MeshSerializer meshSerializer;
+    meshSerializer.importMesh(stream, mesh.getPointer());
    
-    xmlMeshSerializer->exportMesh(mesh.getPointer(), opts.dest);
+    XMLMeshSerializer xmlMeshSerializer;
+    xmlMeshSerializer.exportMesh(mesh.getPointer(), opts.dest);
 
     // Clean up the conversion mesh
-    MeshManager::getSingleton().remove("conversion");
+    MeshManager::getSingleton().remove(opts.source);
 }
 
-void XMLToBinary(XmlOptions opts)
+void XMLToBinary(const XmlOptions& opts)
 {
     // Read root element and decide from there what type
-    String response;
-    TiXmlDocument* doc = new TiXmlDocument(opts.source);
-    // Some double-parsing here but never mind
-    if (!doc->LoadFile())
+    String rootName;
     {
-        cout << "Unable to open file " << opts.source << " - fatal error." << endl;
-        delete doc;
-        exit (1);
+        std::ifstream ifs(opts.source.c_str(), std::ios_base::in | std::ios_base::binary);
+        if (!ifs)
+        {
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND,
+                "Unable to open file " + opts.source + " - fatal error.", "XMLToBinary");
+        }
+        DataStreamPtr stream(new FileStreamDataStream(opts.source, &ifs, false));
+        XMLStreamReader reader(stream, 4096);
+        if (reader.next() == XMLStreamReader::START_ELEMENT)
+            rootName = reader.getName();
     }
-    TiXmlElement* root = doc->RootElement();
-    if (!stricmp(root->Value(), "mesh"))
+    if (!stricmp(rootName.c_str(), "mesh"))
     {
-        delete doc;
-        MeshPtr newMesh = MeshManager::getSingleton().createManual("conversion", 
+        MeshPtr newMesh = MeshManager::getSingleton().createManual(opts.source, 
             ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
         VertexElementType colourElementType;
         if (opts.d3d)
@@ -404,8 +458,8 @@ void XMLToBinary(XmlOptions opts)
         else
             colourElementType = VET_COLOUR_ABGR;
 
-        xmlMeshSerializer->importMesh(opts.source, colourElementType, newMesh.getPointer());
-
+        XMLMeshSerializer xmlMeshSerializer;
+        xmlMeshSerializer.importMesh(opts.source, colourElementType, newMesh.getPointer());
         // Re-jig the buffers?
         // Make sure animation types are up to date first
         newMesh->_determineAnimationTypes();
@@ -469,57 +523,123 @@ void XMLToBinary(XmlOptions opts)
             }
         }
 
-        meshSerializer->exportMesh(newMesh.getPointer(), opts.dest, opts.endian);
+        MeshSerializer meshSerializer;
+        meshSerializer.exportMesh(newMesh.getPointer(), opts.dest, opts.endian);
 
         // Clean up the conversion mesh
-        MeshManager::getSingleton().remove("conversion");
+        MeshManager::getSingleton().remove(opts.source);
     }
-    else if (!stricmp(root->Value(), "skeleton"))
+    else if (!stricmp(rootName.c_str(), "skeleton"))
     {
-        delete doc;
-        SkeletonPtr newSkel = SkeletonManager::getSingleton().create("conversion", 
+        SkeletonPtr newSkel = SkeletonManager::getSingleton().create(opts.source, 
             ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
-        xmlSkeletonSerializer->importSkeleton(opts.source, newSkel.getPointer());
+        XMLSkeletonSerializer xmlSkeletonSerializer;
+        xmlSkeletonSerializer.importSkeleton(opts.source, newSkel.getPointer());
         if (opts.optimiseAnimations)
         {
             newSkel->optimiseAllAnimations();
         }
-        skeletonSerializer->exportSkeleton(newSkel.getPointer(), opts.dest, SKELETON_VERSION_LATEST, opts.endian);
+        SkeletonSerializer skeletonSerializer;
+        skeletonSerializer.exportSkeleton(newSkel.getPointer(), opts.dest, SKELETON_VERSION_LATEST, opts.endian);
 
         // Clean up the conversion skeleton
-        SkeletonManager::getSingleton().remove("conversion");
-    }
-    else
-    {
-        delete doc;
+        SkeletonManager::getSingleton().remove(opts.source);
     }
 
 }
 
-void skeletonToXML(XmlOptions opts)
+void skeletonToXML(const XmlOptions& opts)
 {
 
     std::ifstream ifs;
     ifs.open(opts.source.c_str(), std::ios_base::in | std::ios_base::binary);
-    if (ifs.bad())
+    if (!ifs)
     {
-        cout << "Unable to load file " << opts.source << endl;
-        exit(1);
+        OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "Unable to load file " + opts.source, "skeletonToXML");
     }
 
-    SkeletonPtr skel = SkeletonManager::getSingleton().create("conversion", 
+    SkeletonPtr skel = SkeletonManager::getSingleton().create(opts.source, 
         ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
 
     // pass false for freeOnClose to FileStreamDataStream since ifs is created locally on stack
     DataStreamPtr stream(new FileStreamDataStream(opts.source, &ifs, false));
-    skeletonSerializer->importSkeleton(stream, skel.getPointer());
+    SkeletonSerializer skeletonSerializer;
+    skeletonSerializer.importSkeleton(stream, skel.getPointer());
    
-    xmlSkeletonSerializer->exportSkeleton(skel.getPointer(), opts.dest);
+    XMLSkeletonSerializer xmlSkeletonSerializer;
+    xmlSkeletonSerializer.exportSkeleton(skel.getPointer(), opts.dest);
 
     // Clean up the conversion skeleton
-    SkeletonManager::getSingleton().remove("conversion");
+    SkeletonManager::getSingleton().remove(opts.source);
 }
 
+/// Converts a file, returning false if its type is unknown
+bool convertFile(const XmlOptions& opts)
+{
+    if (opts.sourceExt == "mesh")
+    {
+        meshToXML(opts);
+    }
+    else if (opts.sourceExt == "skeleton")
+    {
+        skeletonToXML(opts);
+    }
+    else if (opts.sourceExt == "xml")
+    {
+        XMLToBinary(opts);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+/// Converts the files of a batch, several at once on the threads of a work queue
+class BatchConversion : public WorkQueue::ParallelTask
+{
+public:
+    BatchConversion(const XmlOptions& opts) : mOpts(opts), mNumFailures(0) {}
+
+    void execute(size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            XmlOptions opts = mOpts;
+            setFiles(opts, mOpts.batchSources[i], "");
+
+            String error;
+            try
+            {
+                if (!convertFile(opts))
+                    error = "Unknown input type.";
+            }
+            catch(Exception& e)
+            {
+                error = e.getDescription();
+            }
+
+            OGRE_LOCK_MUTEX(mMutex);
+            if (!error.empty())
+            {
+                cerr << "ERROR converting " << opts.source << ": " << error << std::endl;
+                ++mNumFailures;
+            }
+            else if (!opts.quietMode)
+            {
+                cout << opts.source << " -> " << opts.dest << std::endl;
+            }
+        }
+    }
+
+    size_t getNumFailures(void) const { return mNumFailures; }
+
+private:
+    const XmlOptions& mOpts;
+    size_t mNumFailures; // Guarded by mMutex
+    OGRE_MUTEX(mMutex);
+};
+
 int main(int numargs, char** args)
 {
     if (numargs < 2)
@@ -551,27 +671,27 @@ int main(int numargs, char** args)
         matMgr = new MaterialManager();
         matMgr->initialise();
         skelMgr = new SkeletonManager();
-        meshSerializer = new MeshSerializer();
-        xmlMeshSerializer = new XMLMeshSerializer();
-        skeletonSerializer = new SkeletonSerializer();
-        xmlSkeletonSerializer = new XMLSkeletonSerializer();
         bufferManager = new DefaultHardwareBufferManager(); // needed because we don't have a rendersystem
 
 
 
-        if (opts.sourceExt == "mesh")
-        {
-            meshToXML(opts);
-        }
-        else if (opts.sourceExt == "skeleton")
+        if (!opts.batchSources.empty())
         {
-            skeletonToXML(opts);
+            // The calling thread converts files too
+            DefaultWorkQueue workQueue("XMLConverter");
+            workQueue.setWorkerThreadCount(opts.numThreads - 1);
+            workQueue.startup();
+
+            BatchConversion batch(opts);
+            workQueue.parallelFor(opts.batchSources.size(), 1, &batch);
+            if (batch.getNumFailures())
+            {
+                cerr << batch.getNumFailures() << " of " << opts.batchSources.size()
+                     << " files failed to convert." << std::endl;
+                retCode = 1;
+            }
         }
-        else if (opts.sourceExt == "xml")
-        {
-            XMLToBinary(opts);
-        }
-        else
+        else if (!convertFile(opts))
         {
             cout << "Unknown input type.\n";
             retCode = 1;
@@ -587,10 +707,6 @@ int main(int numargs, char** args)
 
     Pass::processPendingPassUpdates(); // make sure passes are cleaned up
 
-    delete xmlSkeletonSerializer;
-    delete skeletonSerializer;
-    delete xmlMeshSerializer;
-    delete meshSerializer;
     delete skelMgr;
     delete matMgr;
     delete meshMgr;
@@ -602,5 +718,4 @@ int main(int numargs, char** args)
 
     return retCode;
 
-}
-
+}
\ No newline at end of file